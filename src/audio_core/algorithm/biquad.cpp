@@ -0,0 +1,75 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
+
+#include "audio_core/algorithm/biquad.h"
+
+namespace AudioCore {
+
+BiquadCoefficients BiquadFromFixedPoint(const std::array<s16, 3>& numerator,
+                                        const std::array<s16, 2>& denominator) {
+    constexpr float scale = 1.0f / (1 << 14);
+    return {numerator[0] * scale, numerator[1] * scale, numerator[2] * scale,
+            denominator[0] * scale, denominator[1] * scale};
+}
+
+#ifdef ARCHITECTURE_x86_64
+
+void ApplyBiquad(const BiquadCoefficients& coefficients, BiquadState& state, const s16* input,
+                 s16* output, std::size_t num_frames) {
+    // Both channels are filtered at once, in the two low lanes of each register
+    const __m128 b0 = _mm_set1_ps(coefficients.b0);
+    const __m128 b1 = _mm_set1_ps(coefficients.b1);
+    const __m128 b2 = _mm_set1_ps(coefficients.b2);
+    const __m128 a1 = _mm_set1_ps(coefficients.a1);
+    const __m128 a2 = _mm_set1_ps(coefficients.a2);
+    const __m128 min = _mm_set1_ps(-32768.0f);
+    const __m128 max = _mm_set1_ps(32767.0f);
+    __m128 s1 = _mm_setr_ps(state.s1[0], state.s1[1], 0.0f, 0.0f);
+    __m128 s2 = _mm_setr_ps(state.s2[0], state.s2[1], 0.0f, 0.0f);
+
+    for (std::size_t frame = 0; frame < num_frames; ++frame) {
+        const __m128 x = _mm_setr_ps(input[frame * 2], input[frame * 2 + 1], 0.0f, 0.0f);
+        const __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), s1);
+        s1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(b1, x), s2), _mm_mul_ps(a1, y));
+        s2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+
+        const __m128i result = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(y, min), max));
+        output[frame * 2] = static_cast<s16>(_mm_cvtsi128_si32(result));
+        output[frame * 2 + 1] = static_cast<s16>(_mm_cvtsi128_si32(_mm_srli_si128(result, 4)));
+    }
+
+    alignas(16) std::array<float, 4> lanes;
+    _mm_store_ps(lanes.data(), s1);
+    state.s1 = {lanes[0], lanes[1]};
+    _mm_store_ps(lanes.data(), s2);
+    state.s2 = {lanes[0], lanes[1]};
+}
+
+#else
+
+void ApplyBiquad(const BiquadCoefficients& coefficients, BiquadState& state, const s16* input,
+                 s16* output, std::size_t num_frames) {
+    const auto& [b0, b1, b2, a1, a2] = coefficients;
+    for (std::size_t frame = 0; frame < num_frames; ++frame) {
+        for (std::size_t channel = 0; channel < 2; ++channel) {
+            const float x = input[frame * 2 + channel];
+            const float y = b0 * x + state.s1[channel];
+            state.s1[channel] = b1 * x + state.s2[channel] - a1 * y;
+            state.s2[channel] = b2 * x - a2 * y;
+            output[frame * 2 + channel] =
+                static_cast<s16>(std::clamp(std::nearbyint(y), -32768.0f, 32767.0f));
+        }
+    }
+}
+
+#endif
+
+} // namespace AudioCore
@@ -0,0 +1,38 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "common/common_types.h"
+
+namespace AudioCore {
+
+/// Coefficients of a biquad normalized to a0 = 1:
+/// y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+struct BiquadCoefficients {
+    float b0{1.0f};
+    float b1{};
+    float b2{};
+    float a1{};
+    float a2{};
+};
+
+/// Converts the Q14 fixed point coefficients used by the guest.
+BiquadCoefficients BiquadFromFixedPoint(const std::array<s16, 3>& numerator,
+                                        const std::array<s16, 2>& denominator);
+
+/// Transposed direct form II state of a stereo biquad.
+struct BiquadState {
+    std::array<float, 2> s1{};
+    std::array<float, 2> s2{};
+};
+
+/// Filters interleaved stereo frames with a biquad, saturating the output. Input and output may
+/// be the same buffer.
+void ApplyBiquad(const BiquadCoefficients& coefficients, BiquadState& state, const s16* input,
+                 s16* output, std::size_t num_frames);
+
+} // namespace AudioCore
@@ -0,0 +1,97 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
+
+#include "audio_core/algorithm/mixer.h"
+
+namespace AudioCore {
+
+namespace Scalar {
+
+void MixSamples(float* bus, const s16* samples, std::size_t num_frames, std::size_t num_channels,
+                const float* channel_volumes, float volume, float volume_step) {
+    for (std::size_t frame = 0; frame < num_frames; ++frame) {
+        for (std::size_t channel = 0; channel < num_channels; ++channel) {
+            *bus++ += static_cast<float>(*samples++) * (volume * channel_volumes[channel]);
+        }
+        volume += volume_step;
+    }
+}
+
+void SaturateToS16(s16* output, const float* bus, std::size_t num_samples) {
+    for (std::size_t i = 0; i < num_samples; ++i) {
+        const float sample = std::clamp(std::nearbyint(bus[i]), -32768.0f, 32767.0f);
+        output[i] = static_cast<s16>(sample);
+    }
+}
+
+} // namespace Scalar
+
+#ifdef ARCHITECTURE_x86_64
+
+void MixSamples(float* bus, const s16* samples, std::size_t num_frames, std::size_t num_channels,
+                const float* channel_volumes, float volume, float volume_step) {
+    if (num_channels != 2) {
+        Scalar::MixSamples(bus, samples, num_frames, num_channels, channel_volumes, volume,
+                           volume_step);
+        return;
+    }
+    // Two stereo frames per iteration, the lanes are {L0, R0, L1, R1}
+    const __m128 channels = _mm_setr_ps(channel_volumes[0], channel_volumes[1],
+                                        channel_volumes[0], channel_volumes[1]);
+    const __m128 step = _mm_set1_ps(volume_step * 2.0f);
+    __m128 volumes = _mm_setr_ps(volume, volume, volume + volume_step, volume + volume_step);
+
+    std::size_t frame = 0;
+    for (; frame + 2 <= num_frames; frame += 2) {
+        const __m128i packed =
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(samples + frame * 2));
+        // Sign extends the 16-bit samples by moving them to the upper half of each lane
+        const __m128i extended = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+        const __m128 gain = _mm_mul_ps(volumes, channels);
+        const __m128 mixed =
+            _mm_add_ps(_mm_loadu_ps(bus + frame * 2), _mm_mul_ps(_mm_cvtepi32_ps(extended), gain));
+        _mm_storeu_ps(bus + frame * 2, mixed);
+        volumes = _mm_add_ps(volumes, step);
+    }
+    Scalar::MixSamples(bus + frame * 2, samples + frame * 2, num_frames - frame, 2,
+                       channel_volumes, _mm_cvtss_f32(volumes), volume_step);
+}
+
+void SaturateToS16(s16* output, const float* bus, std::size_t num_samples) {
+    // Clamped before the conversion, out of range values convert to INT_MIN
+    const __m128 min = _mm_set1_ps(-32768.0f);
+    const __m128 max = _mm_set1_ps(32767.0f);
+
+    std::size_t i = 0;
+    for (; i + 8 <= num_samples; i += 8) {
+        const __m128 low = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(bus + i), min), max);
+        const __m128 high = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(bus + i + 4), min), max);
+        const __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(low), _mm_cvtps_epi32(high));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+    }
+    Scalar::SaturateToS16(output + i, bus + i, num_samples - i);
+}
+
+#else
+
+void MixSamples(float* bus, const s16* samples, std::size_t num_frames, std::size_t num_channels,
+                const float* channel_volumes, float volume, float volume_step) {
+    Scalar::MixSamples(bus, samples, num_frames, num_channels, channel_volumes, volume,
+                       volume_step);
+}
+
+void SaturateToS16(s16* output, const float* bus, std::size_t num_samples) {
+    Scalar::SaturateToS16(output, bus, num_samples);
+}
+
+#endif
+
+} // namespace AudioCore
@@ -0,0 +1,36 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include "common/common_types.h"
+
+namespace AudioCore {
+
+/// Adds interleaved samples to a float mix bus with the same channel layout.
+/// @param bus Mix bus, num_frames * num_channels samples.
+/// @param samples Interleaved samples to add.
+/// @param num_frames Number of frames in samples.
+/// @param num_channels Number of channels of a frame.
+/// @param channel_volumes Volume of each channel, the diagonal of the voice's mix matrix.
+/// @param volume Volume of the first frame.
+/// @param volume_step Volume increment between frames, ramps the volume of an update.
+void MixSamples(float* bus, const s16* samples, std::size_t num_frames, std::size_t num_channels,
+                const float* channel_volumes, float volume, float volume_step);
+
+/// Rounds the samples of a mix bus and saturates them to s16.
+void SaturateToS16(s16* output, const float* bus, std::size_t num_samples);
+
+/// Scalar versions of the kernels above, used where no vector version exists and as a reference.
+namespace Scalar {
+
+void MixSamples(float* bus, const s16* samples, std::size_t num_frames, std::size_t num_channels,
+                const float* channel_volumes, float volume, float volume_step);
+
+void SaturateToS16(s16* output, const float* bus, std::size_t num_samples);
+
+} // namespace Scalar
+
+} // namespace AudioCore
@@ -0,0 +1,200 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#define _USE_MATH_DEFINES
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#ifdef ARCHITECTURE_x86_64
+#include <xmmintrin.h>
+#endif
+
+#include "audio_core/algorithm/resampler.h"
+#include "common/logging/log.h"
+
+namespace AudioCore {
+
+namespace {
+
+/// Largest number of phases a filter bank is built for, other ratios use linear interpolation.
+constexpr u32 MAX_PHASES = 512;
+
+/// Output rate of the ratios with shared filter banks.
+constexpr u32 COMMON_OUTPUT_RATE = 48000;
+
+/// Input rates of the ratios with shared filter banks.
+constexpr std::array<u32, 3> COMMON_INPUT_RATES{32000, 44100, 22050};
+
+/// Leaves room under the Nyquist frequency for the transition band of the filter.
+constexpr double CUTOFF_SCALE = 0.9;
+
+double Sinc(double x) {
+    if (x == 0.0) {
+        return 1.0;
+    }
+    const double px = M_PI * x;
+    return std::sin(px) / px;
+}
+
+/// Blackman window of NUM_TAPS frames, x is in (0, NUM_TAPS].
+double Blackman(double x) {
+    const double n = x / static_cast<double>(Resampler::NUM_TAPS);
+    return 0.42 - 0.5 * std::cos(2.0 * M_PI * n) + 0.08 * std::cos(4.0 * M_PI * n);
+}
+
+float DotProduct(const float* history, const float* taps) {
+#ifdef ARCHITECTURE_x86_64
+    static_assert(Resampler::NUM_TAPS % 4 == 0);
+    __m128 sum = _mm_setzero_ps();
+    for (std::size_t i = 0; i < Resampler::NUM_TAPS; i += 4) {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(history + i), _mm_loadu_ps(taps + i)));
+    }
+    // Horizontal sum of the four lanes
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#else
+    float sum = 0.0f;
+    for (std::size_t i = 0; i < Resampler::NUM_TAPS; ++i) {
+        sum += history[i] * taps[i];
+    }
+    return sum;
+#endif
+}
+
+s16 ToS16(float sample) {
+    return static_cast<s16>(std::clamp(std::nearbyint(sample), -32768.0f, 32767.0f));
+}
+
+} // Anonymous namespace
+
+struct FilterBank {
+    FilterBank(u32 num_phases, u32 step);
+
+    u32 num_phases;
+    u32 step;
+    /// NUM_TAPS taps per phase, the first tap applies to the oldest input frame
+    std::vector<float> taps;
+};
+
+FilterBank::FilterBank(u32 num_phases, u32 step)
+    : num_phases{num_phases}, step{step}, taps(num_phases * Resampler::NUM_TAPS) {
+    constexpr std::size_t num_taps = Resampler::NUM_TAPS;
+    // Downsampling moves the cutoff under the Nyquist frequency of the output
+    const double cutoff = std::min(1.0, static_cast<double>(num_phases) / step) * CUTOFF_SCALE;
+    for (u32 phase = 0; phase < num_phases; ++phase) {
+        float* const row = &taps[phase * num_taps];
+        const double offset = static_cast<double>(phase) / num_phases;
+        double sum = 0.0;
+        for (std::size_t tap = 0; tap < num_taps; ++tap) {
+            // Distance from the output frame, half of the taps are delay
+            const double x = static_cast<double>(num_taps / 2 - 1) - tap + offset;
+            const double value =
+                cutoff * Sinc(cutoff * x) * Blackman(x + static_cast<double>(num_taps / 2));
+            row[tap] = static_cast<float>(value);
+            sum += value;
+        }
+        // Unity gain at DC on every phase
+        for (std::size_t tap = 0; tap < num_taps; ++tap) {
+            row[tap] = static_cast<float>(row[tap] / sum);
+        }
+    }
+}
+
+/// Returns a shared filter bank for a ratio games commonly use, null for other ratios.
+static const FilterBank* GetCommonFilterBank(u32 num_phases, u32 step) {
+    static const std::vector<FilterBank> banks = [] {
+        std::vector<FilterBank> result;
+        for (const u32 input_rate : COMMON_INPUT_RATES) {
+            const u32 divisor = std::gcd(input_rate, COMMON_OUTPUT_RATE);
+            result.emplace_back(COMMON_OUTPUT_RATE / divisor, input_rate / divisor);
+        }
+        return result;
+    }();
+    const auto it = std::find_if(banks.begin(), banks.end(), [&](const FilterBank& bank) {
+        return bank.num_phases == num_phases && bank.step == step;
+    });
+    return it != banks.end() ? &*it : nullptr;
+}
+
+Resampler::Resampler() = default;
+
+Resampler::~Resampler() = default;
+
+void Resampler::SetQuality(Quality quality_) {
+    quality = quality_;
+}
+
+void Resampler::Reset() {
+    phase = 0;
+    history_pos = 0;
+    for (auto& channel : history) {
+        channel.fill(0.0f);
+    }
+}
+
+void Resampler::Process(const s16* input, std::size_t num_frames, u32 input_rate_,
+                        u32 output_rate_, std::vector<s16>& output) {
+    if (input_rate_ == 0 || output_rate_ == 0) {
+        LOG_CRITICAL(Audio, "Nonsensical resampling rates {} -> {}", input_rate_, output_rate_);
+        return;
+    }
+    SetRates(input_rate_, output_rate_);
+
+    for (std::size_t frame = 0; frame < num_frames; ++frame) {
+        PushFrame(input + frame * 2);
+        for (; phase < num_phases; phase += step) {
+            EmitFrame(output);
+        }
+        phase -= num_phases;
+    }
+}
+
+void Resampler::SetRates(u32 input_rate_, u32 output_rate_) {
+    if (input_rate_ == input_rate && output_rate_ == output_rate) {
+        return;
+    }
+    input_rate = input_rate_;
+    output_rate = output_rate_;
+
+    const u32 divisor = std::gcd(input_rate, output_rate);
+    num_phases = output_rate / divisor;
+    step = input_rate / divisor;
+    phase = 0;
+
+    bank = GetCommonFilterBank(num_phases, step);
+    if (!bank && num_phases <= MAX_PHASES) {
+        custom_bank = std::make_unique<FilterBank>(num_phases, step);
+        bank = custom_bank.get();
+    }
+}
+
+void Resampler::PushFrame(const s16* frame) {
+    for (std::size_t channel = 0; channel < history.size(); ++channel) {
+        const float sample = static_cast<float>(frame[channel]);
+        history[channel][history_pos] = sample;
+        history[channel][history_pos + NUM_TAPS] = sample;
+    }
+    history_pos = (history_pos + 1) % NUM_TAPS;
+}
+
+void Resampler::EmitFrame(std::vector<s16>& output) const {
+    if (quality == Quality::Polyphase && bank) {
+        const float* const taps = &bank->taps[phase * NUM_TAPS];
+        for (const auto& channel : history) {
+            output.push_back(ToS16(DotProduct(&channel[history_pos], taps)));
+        }
+        return;
+    }
+    const float weight = static_cast<float>(phase) / static_cast<float>(num_phases);
+    for (const auto& channel : history) {
+        const float previous = channel[history_pos + NUM_TAPS - 2];
+        const float current = channel[history_pos + NUM_TAPS - 1];
+        output.push_back(ToS16(previous + (current - previous) * weight));
+    }
+}
+
+} // namespace AudioCore
@@ -0,0 +1,72 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "common/common_types.h"
+
+namespace AudioCore {
+
+/// Filter bank of a polyphase resampler, one row of taps per output phase.
+struct FilterBank;
+
+/**
+ * Stereo sample rate converter. The rate ratio is reduced to output/input = num_phases/step and
+ * every output frame is computed from the last input frames and the phase it falls on.
+ * Polyphase mode convolves the input with a windowed-sinc filter bank, built once per ratio, the
+ * ratios games commonly use are shared between voices. Linear mode interpolates between the two
+ * last input frames.
+ */
+class Resampler {
+public:
+    enum class Quality {
+        Linear,
+        Polyphase,
+    };
+
+    Resampler();
+    ~Resampler();
+
+    /// Sets the quality of the next frames.
+    void SetQuality(Quality quality);
+
+    /// Drops the input history, the next frames start from silence.
+    void Reset();
+
+    /// Resamples stereo frames, appending the result to output. No allocation is made when the
+    /// capacity of output is large enough and the ratio didn't change.
+    void Process(const s16* input, std::size_t num_frames, u32 input_rate, u32 output_rate,
+                 std::vector<s16>& output);
+
+    /// Number of input frames each polyphase output frame is computed from.
+    static constexpr std::size_t NUM_TAPS = 16;
+
+private:
+    void SetRates(u32 input_rate, u32 output_rate);
+
+    void PushFrame(const s16* frame);
+
+    void EmitFrame(std::vector<s16>& output) const;
+
+    Quality quality{Quality::Polyphase};
+    u32 input_rate{};
+    u32 output_rate{};
+    u32 num_phases{1};
+    u32 step{1};
+    u32 phase{};
+
+    const FilterBank* bank{};
+    std::unique_ptr<FilterBank> custom_bank;
+
+    /// Planar input history of each channel, written twice so the last NUM_TAPS frames are
+    /// contiguous at history_pos
+    std::size_t history_pos{};
+    std::array<std::array<float, NUM_TAPS * 2>, 2> history{};
+};
+
+} // namespace AudioCore
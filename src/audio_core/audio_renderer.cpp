@@ -2,21 +2,47 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include "audio_core/algorithm/interpolate.h"
+#include <chrono>
+#include <utility>
+
+#include "audio_core/algorithm/biquad.h"
+#include "audio_core/algorithm/mixer.h"
+#include "audio_core/algorithm/resampler.h"
 #include "audio_core/audio_out.h"
 #include "audio_core/audio_renderer.h"
+#include "audio_core/audio_statistics.h"
 #include "audio_core/codec.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/thread.h"
+#include "common/thread_placement.h"
 #include "core/core.h"
 #include "core/hle/kernel/writable_event.h"
 #include "core/memory.h"
+#include "core/perf_stats.h"
+
+MICROPROFILE_DEFINE(Audio_Mix, "Audio", "Mix Command List", MP_RGB(64, 192, 128));
+MICROPROFILE_DEFINE(Audio_Decode, "Audio", "Decode Wave Buffer", MP_RGB(64, 160, 192));
+MICROPROFILE_DEFINE(Audio_Resample, "Audio", "Resample Wave Buffer", MP_RGB(64, 128, 192));
 
 namespace AudioCore {
 
 constexpr u32 STREAM_SAMPLE_RATE{48000};
 constexpr u32 STREAM_NUM_CHANNELS{2};
 
+/// Number of samples per channel in each buffer queued to the stream.
+constexpr std::size_t MIX_BUFFER_SIZE{512};
+
+/// Voices with a larger priority value, lower priority, are resampled linearly.
+constexpr u32 POLYPHASE_PRIORITY_LIMIT{128};
+
+/// Samples of a voice, a view of its pipeline buffers.
+struct SampleSpan {
+    const s16* data{};
+    std::size_t size{};
+};
+
 class AudioRenderer::VoiceState {
 public:
     bool IsPlaying() const {
@@ -35,8 +61,21 @@ public:
         return info;
     }
 
+    /// Returns the volume the last mixed buffer ended with, the next buffer ramps from it to
+    /// the current volume.
+    float ExchangeVolume() {
+        return std::exchange(last_volume, info.volume);
+    }
+
     void SetWaveIndex(std::size_t index);
-    std::vector<s16> DequeueSamples(std::size_t sample_count);
+
+    /// Returns up to sample_count stereo frames, valid until the next call.
+    SampleSpan DequeueSamples(std::size_t sample_count);
+
+    /// Filters dequeued samples with the enabled biquads of the voice, the result is valid until
+    /// the next call.
+    SampleSpan ApplyBiquadFilters(SampleSpan samples);
+
     void UpdateState();
     void RefreshBuffer();
 
@@ -45,9 +84,19 @@ private:
     bool is_refresh_pending{};
     std::size_t wave_index{};
     std::size_t offset{};
+    float last_volume{};
     Codec::ADPCMState adpcm_state{};
-    InterpolationState interp_state{};
+    Resampler resampler;
+    std::array<BiquadState, 2> biquad_states{};
+
+    // Stages of the sample pipeline. They keep their capacity between wave buffers, so voices
+    // only allocate until they have seen their largest buffer.
+    std::vector<u8> wave_data;
+    std::vector<s16> decoded_samples;
+    std::vector<s16> resampled_samples;
     std::vector<s16> samples;
+    std::vector<s16> filtered_samples;
+
     VoiceOutStatus out_status{};
     VoiceInfo info{};
 };
@@ -81,15 +130,34 @@ AudioRenderer::AudioRenderer(Core::Timing::CoreTiming& core_timing, AudioRendere
     audio_out = std::make_unique<AudioCore::AudioOut>();
     stream = audio_out->OpenStream(core_timing, STREAM_SAMPLE_RATE, STREAM_NUM_CHANNELS,
                                    fmt::format("AudioRenderer-Instance{}", instance_number),
-                                   [=]() { buffer_event->Signal(); });
+                                   [this] {
+                                       QueueMixedBuffers();
+                                       this->buffer_event->Signal();
+                                   });
     audio_out->StartStream(stream);
 
-    QueueMixedBuffer(0);
-    QueueMixedBuffer(1);
-    QueueMixedBuffer(2);
+    // Nothing is playing yet, the first buffers are mixed before the mixing thread starts
+    for (Buffer::Tag tag = 0; tag < 3; ++tag) {
+        MixedBuffer mixed = ExecuteCommandList(GenerateCommandList(tag));
+        audio_out->QueueBuffer(stream, mixed.tag, std::move(mixed.samples));
+    }
+
+    mixing_thread = std::thread(&AudioRenderer::MixingThreadLoop, this);
 }
 
-AudioRenderer::~AudioRenderer() = default;
+AudioRenderer::~AudioRenderer() {
+    {
+        std::lock_guard lock{queue_mutex};
+        is_mixing_thread_running = false;
+    }
+    queue_cv.notify_one();
+    mixing_thread.join();
+
+    const auto statistics = GetAudioStatistics().GetSnapshot();
+    LOG_DEBUG(Audio, "Since boot: {} command lists, {} voices mixed, {} us mixing, {} underruns",
+              statistics[AudioCounter::CommandLists], statistics[AudioCounter::VoicesMixed],
+              statistics[AudioCounter::MixTimeUs], statistics[AudioCounter::SinkUnderruns]);
+}
 
 u32 AudioRenderer::GetSampleRate() const {
     return worker_params.sample_rate;
@@ -107,6 +175,10 @@ Stream::State AudioRenderer::GetStreamState() const {
     return stream->GetState();
 }
 
+std::chrono::microseconds AudioRenderer::GetMixingTime() const {
+    return std::chrono::microseconds{mixing_time_us.load(std::memory_order_relaxed)};
+}
+
 static constexpr u32 VersionFromRevision(u32_le rev) {
     // "REV7" -> 7
     return ((rev >> 24) & 0xff) - 0x30;
@@ -124,7 +196,8 @@ std::vector<u8> AudioRenderer::UpdateAudioRenderer(const std::vector<u8>& input_
                 input_params.data() + sizeof(UpdateDataHeader) + config.behavior_size,
                 memory_pool_count * sizeof(MemoryPoolInfo));
 
-    // Copy VoiceInfo structs
+    // Copy VoiceInfo structs, the mixing thread reads them while it executes a command list
+    std::unique_lock voice_lock{voice_mutex};
     std::size_t voice_offset{sizeof(UpdateDataHeader) + config.behavior_size +
                              config.memory_pools_size + config.voice_resource_size};
     for (auto& voice : voices) {
@@ -161,11 +234,13 @@ std::vector<u8> AudioRenderer::UpdateAudioRenderer(const std::vector<u8>& input_
         }
     }
 
+    voice_lock.unlock();
+
     for (auto& effect : effects) {
         effect.UpdateState();
     }
 
-    // Release previous buffers and queue next ones for playback
+    // Release previous buffers and record the commands mixing the next ones
     ReleaseAndQueueBuffers();
 
     // Copy output header
@@ -184,11 +259,13 @@ std::vector<u8> AudioRenderer::UpdateAudioRenderer(const std::vector<u8>& input_
 
     // Copy output voice status
     std::size_t voice_out_status_offset{sizeof(UpdateDataHeader) + response_data.memory_pools_size};
+    voice_lock.lock();
     for (const auto& voice : voices) {
         std::memcpy(output_params.data() + voice_out_status_offset, &voice.GetOutStatus(),
                     sizeof(VoiceOutStatus));
         voice_out_status_offset += sizeof(VoiceOutStatus);
     }
+    voice_lock.unlock();
 
     std::size_t effect_out_status_offset{
         sizeof(UpdateDataHeader) + response_data.memory_pools_size + response_data.voices_size +
@@ -206,7 +283,7 @@ void AudioRenderer::VoiceState::SetWaveIndex(std::size_t index) {
     is_refresh_pending = true;
 }
 
-std::vector<s16> AudioRenderer::VoiceState::DequeueSamples(std::size_t sample_count) {
+SampleSpan AudioRenderer::VoiceState::DequeueSamples(std::size_t sample_count) {
     if (!IsPlaying()) {
         return {};
     }
@@ -242,7 +319,25 @@ std::vector<s16> AudioRenderer::VoiceState::DequeueSamples(std::size_t sample_co
         }
     }
 
-    return {samples.begin() + dequeue_offset, samples.begin() + dequeue_offset + size};
+    return {samples.data() + dequeue_offset, size};
+}
+
+SampleSpan AudioRenderer::VoiceState::ApplyBiquadFilters(SampleSpan input) {
+    const s16* data = input.data;
+    for (std::size_t index = 0; index < info.biquad_filter.size(); ++index) {
+        const BiquadFilter& filter = info.biquad_filter[index];
+        if (!filter.enable) {
+            continue;
+        }
+        const BiquadCoefficients coefficients = BiquadFromFixedPoint(
+            {filter.numerator[0], filter.numerator[1], filter.numerator[2]},
+            {filter.denominator[0], filter.denominator[1]});
+        filtered_samples.resize(input.size);
+        ApplyBiquad(coefficients, biquad_states[index], data, filtered_samples.data(),
+                    input.size / STREAM_NUM_CHANNELS);
+        data = filtered_samples.data();
+    }
+    return {data, input.size};
 }
 
 void AudioRenderer::VoiceState::UpdateState() {
@@ -251,27 +346,38 @@ void AudioRenderer::VoiceState::UpdateState() {
         is_refresh_pending = true;
         wave_index = 0;
         offset = 0;
+        last_volume = 0.0f;
         out_status = {};
+        resampler.Reset();
+        biquad_states = {};
     }
     is_in_use = info.is_in_use;
+    resampler.SetQuality(info.priority <= POLYPHASE_PRIORITY_LIMIT ? Resampler::Quality::Polyphase
+                                                                   : Resampler::Quality::Linear);
 }
 
 void AudioRenderer::VoiceState::RefreshBuffer() {
-    std::vector<s16> new_samples(info.wave_buffer[wave_index].buffer_sz / sizeof(s16));
-    Memory::ReadBlock(info.wave_buffer[wave_index].buffer_addr, new_samples.data(),
-                      info.wave_buffer[wave_index].buffer_sz);
+    MICROPROFILE_SCOPE(Audio_Decode);
+    const auto& wave_buffer{info.wave_buffer[wave_index]};
+    wave_data.resize(wave_buffer.buffer_sz);
+    Memory::ReadBlock(wave_buffer.buffer_addr, wave_data.data(), wave_data.size());
+
+    // PCM16 is played as-is
+    const s16* pcm = reinterpret_cast<const s16*>(wave_data.data());
+    std::size_t num_samples = wave_data.size() / sizeof(s16);
 
     switch (static_cast<Codec::PcmFormat>(info.sample_format)) {
     case Codec::PcmFormat::Int16: {
-        // PCM16 is played as-is
         break;
     }
     case Codec::PcmFormat::Adpcm: {
         // Decode ADPCM to PCM16
         Codec::ADPCM_Coeff coeffs;
         Memory::ReadBlock(info.additional_params_addr, coeffs.data(), sizeof(Codec::ADPCM_Coeff));
-        new_samples = Codec::DecodeADPCM(reinterpret_cast<u8*>(new_samples.data()),
-                                         new_samples.size() * sizeof(s16), coeffs, adpcm_state);
+        decoded_samples.resize(Codec::GetADPCMSampleCount(wave_data.size()));
+        num_samples = Codec::DecodeADPCM(decoded_samples.data(), wave_data.data(),
+                                         wave_data.size(), coeffs, adpcm_state);
+        pcm = decoded_samples.data();
         break;
     }
     default:
@@ -282,15 +388,15 @@ void AudioRenderer::VoiceState::RefreshBuffer() {
     switch (info.channel_count) {
     case 1:
         // 1 channel is upsampled to 2 channel
-        samples.resize(new_samples.size() * 2);
-        for (std::size_t index = 0; index < new_samples.size(); ++index) {
-            samples[index * 2] = new_samples[index];
-            samples[index * 2 + 1] = new_samples[index];
+        samples.resize(num_samples * 2);
+        for (std::size_t index = 0; index < num_samples; ++index) {
+            samples[index * 2] = pcm[index];
+            samples[index * 2 + 1] = pcm[index];
         }
         break;
     case 2: {
         // 2 channel is played as is
-        samples = std::move(new_samples);
+        samples.assign(pcm, pcm + num_samples);
         break;
     }
     default:
@@ -298,10 +404,18 @@ void AudioRenderer::VoiceState::RefreshBuffer() {
         break;
     }
 
-    // Only interpolate when necessary, expensive.
+    // Only resample when necessary, expensive.
     if (GetInfo().sample_rate != STREAM_SAMPLE_RATE) {
-        samples = Interpolate(interp_state, std::move(samples), GetInfo().sample_rate,
-                              STREAM_SAMPLE_RATE);
+        MICROPROFILE_SCOPE(Audio_Resample);
+        const auto start = std::chrono::steady_clock::now();
+        resampled_samples.clear();
+        resampler.Process(samples.data(), samples.size() / 2, GetInfo().sample_rate,
+                          STREAM_SAMPLE_RATE, resampled_samples);
+        samples.swap(resampled_samples);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        GetAudioStatistics().Add(
+            AudioCounter::ResampleTimeUs,
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
     }
 
     is_refresh_pending = false;
@@ -324,44 +438,136 @@ void AudioRenderer::EffectState::UpdateState() {
     }
 }
 
-static constexpr s16 ClampToS16(s32 value) {
-    return static_cast<s16>(std::clamp(value, -32768, 32767));
+AudioRenderer::CommandList AudioRenderer::GenerateCommandList(Buffer::Tag tag) {
+    CommandList commands;
+    commands.push_back({Command::Type::ClearMixBuffer});
+    for (std::size_t index = 0; index < voices.size(); ++index) {
+        VoiceState& voice = voices[index];
+        if (voice.IsPlaying()) {
+            const float volume_start = voice.ExchangeVolume();
+            commands.push_back(
+                {Command::Type::MixVoice, index, volume_start, voice.GetInfo().volume});
+        }
+    }
+    commands.push_back({Command::Type::Output, 0, 0.0f, 0.0f, tag});
+    return commands;
 }
 
-void AudioRenderer::QueueMixedBuffer(Buffer::Tag tag) {
-    constexpr std::size_t BUFFER_SIZE{512};
-    std::vector<s16> buffer(BUFFER_SIZE * stream->GetNumChannels());
-
-    for (auto& voice : voices) {
-        if (!voice.IsPlaying()) {
-            continue;
+AudioRenderer::MixedBuffer AudioRenderer::ExecuteCommandList(const CommandList& commands) {
+    MICROPROFILE_SCOPE(Audio_Mix);
+    const std::size_t num_channels = stream->GetNumChannels();
+
+    // Voices are mixed to a float bus and saturated once, on output
+    static constexpr std::array<float, STREAM_NUM_CHANNELS> channel_volumes{1.0f, 1.0f};
+
+    MixedBuffer mixed;
+    u32 num_voices{};
+    std::size_t num_samples{};
+    std::lock_guard lock{voice_mutex};
+    for (const Command& command : commands) {
+        switch (command.type) {
+        case Command::Type::ClearMixBuffer:
+            mix_bus.assign(MIX_BUFFER_SIZE * num_channels, 0.0f);
+            break;
+        case Command::Type::MixVoice: {
+            VoiceState& voice = voices[command.voice_index];
+            ++num_voices;
+            const float volume_step =
+                (command.volume_end - command.volume_start) / static_cast<float>(MIX_BUFFER_SIZE);
+            std::size_t frame{};
+            while (frame < MIX_BUFFER_SIZE) {
+                const SampleSpan dequeued{voice.DequeueSamples(MIX_BUFFER_SIZE - frame)};
+                if (dequeued.size == 0) {
+                    break;
+                }
+                const SampleSpan samples{voice.ApplyBiquadFilters(dequeued)};
+                const std::size_t num_frames = samples.size / num_channels;
+                const float volume = command.volume_start + volume_step * frame;
+                MixSamples(mix_bus.data() + frame * num_channels, samples.data, num_frames,
+                           num_channels, channel_volumes.data(), volume, volume_step);
+                frame += num_frames;
+            }
+            num_samples += frame * num_channels;
+            break;
+        }
+        case Command::Type::Output:
+            mixed.tag = command.tag;
+            mixed.samples.resize(mix_bus.size());
+            SaturateToS16(mixed.samples.data(), mix_bus.data(), mix_bus.size());
+            break;
         }
+    }
 
-        std::size_t offset{};
-        s64 samples_remaining{BUFFER_SIZE};
-        while (samples_remaining > 0) {
-            const std::vector<s16> samples{voice.DequeueSamples(samples_remaining)};
+    AudioStatistics& statistics = GetAudioStatistics();
+    statistics.Add(AudioCounter::CommandLists);
+    statistics.Add(AudioCounter::VoicesMixed, num_voices);
+    statistics.Add(AudioCounter::SamplesMixed, num_samples);
+    statistics.SetActiveVoices(num_voices);
+    return mixed;
+}
 
-            if (samples.empty()) {
-                break;
+void AudioRenderer::ReleaseAndQueueBuffers() {
+    const auto released_buffers{audio_out->GetTagsAndReleaseBuffers(stream, 2)};
+    if (!released_buffers.empty()) {
+        std::vector<CommandList> command_lists;
+        {
+            std::lock_guard lock{voice_mutex};
+            for (const auto& tag : released_buffers) {
+                command_lists.push_back(GenerateCommandList(tag));
             }
-
-            samples_remaining -= samples.size() / stream->GetNumChannels();
-
-            for (const auto& sample : samples) {
-                const s32 buffer_sample{buffer[offset]};
-                buffer[offset++] =
-                    ClampToS16(buffer_sample + static_cast<s32>(sample * voice.GetInfo().volume));
+        }
+        {
+            std::lock_guard lock{queue_mutex};
+            for (auto& commands : command_lists) {
+                pending_commands.push_back(std::move(commands));
             }
         }
+        queue_cv.notify_one();
     }
-    audio_out->QueueBuffer(stream, tag, std::move(buffer));
+
+    // Buffers mixed since the last release are handed to the stream here at the latest
+    QueueMixedBuffers();
 }
 
-void AudioRenderer::ReleaseAndQueueBuffers() {
-    const auto released_buffers{audio_out->GetTagsAndReleaseBuffers(stream, 2)};
-    for (const auto& tag : released_buffers) {
-        QueueMixedBuffer(tag);
+void AudioRenderer::QueueMixedBuffers() {
+    std::deque<MixedBuffer> buffers;
+    {
+        std::lock_guard lock{queue_mutex};
+        buffers.swap(mixed_buffers);
+    }
+    for (auto& mixed : buffers) {
+        audio_out->QueueBuffer(stream, mixed.tag, std::move(mixed.samples));
+    }
+}
+
+void AudioRenderer::MixingThreadLoop() {
+    Common::SetCurrentThreadName("yuzu:AudioMixer");
+    Common::ApplyThreadPlacement(Common::ThreadRole::Audio);
+
+    std::unique_lock lock{queue_mutex};
+    while (true) {
+        queue_cv.wait(lock,
+                      [this] { return !is_mixing_thread_running || !pending_commands.empty(); });
+        if (!is_mixing_thread_running) {
+            return;
+        }
+        const CommandList commands = std::move(pending_commands.front());
+        pending_commands.pop_front();
+        lock.unlock();
+
+        const auto start = std::chrono::steady_clock::now();
+        MixedBuffer mixed = ExecuteCommandList(commands);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const auto elapsed_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        Core::System::GetInstance().GetPerfStats().AddTime(
+            Core::PerfCategory::AudioMix,
+            std::chrono::duration_cast<Core::PerfStats::Clock::duration>(elapsed));
+        mixing_time_us.store(elapsed_us, std::memory_order_relaxed);
+        GetAudioStatistics().Add(AudioCounter::MixTimeUs, elapsed_us);
+
+        lock.lock();
+        mixed_buffers.push_back(std::move(mixed));
     }
 }
 
@@ -5,7 +5,13 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "audio_core/stream.h"
@@ -223,23 +229,75 @@ public:
     ~AudioRenderer();
 
     std::vector<u8> UpdateAudioRenderer(const std::vector<u8>& input_params);
-    void QueueMixedBuffer(Buffer::Tag tag);
-    void ReleaseAndQueueBuffers();
     u32 GetSampleRate() const;
     u32 GetSampleCount() const;
     u32 GetMixBufferCount() const;
     Stream::State GetStreamState() const;
 
+    /// Returns the time the mixing thread took to execute the last command list.
+    std::chrono::microseconds GetMixingTime() const;
+
 private:
     class EffectState;
     class VoiceState;
 
+    /// Operation recorded by an update and executed later by the mixing thread.
+    struct Command {
+        enum class Type : u8 {
+            ClearMixBuffer, ///< Clears the mix buffer
+            MixVoice,       ///< Mixes the next samples of a voice into the mix buffer
+            Output,         ///< Hands the mix buffer to the stream with the tag of the command
+        };
+
+        Type type{};
+        std::size_t voice_index{};
+        float volume_start{};
+        float volume_end{};
+        Buffer::Tag tag{};
+    };
+    using CommandList = std::vector<Command>;
+
+    struct MixedBuffer {
+        Buffer::Tag tag{};
+        std::vector<s16> samples;
+    };
+
+    /// Records the commands mixing the playing voices into the buffer with the given tag.
+    CommandList GenerateCommandList(Buffer::Tag tag);
+
+    /// Executes a command list, mixing the voices it references.
+    MixedBuffer ExecuteCommandList(const CommandList& commands);
+
+    /// Generates a command list for each buffer released by the stream and sends them to the
+    /// mixing thread.
+    void ReleaseAndQueueBuffers();
+
+    /// Queues the buffers mixed by the mixing thread into the stream.
+    void QueueMixedBuffers();
+
+    /// Entry point of the mixing thread.
+    void MixingThreadLoop();
+
     AudioRendererParameter worker_params;
     Kernel::SharedPtr<Kernel::WritableEvent> buffer_event;
     std::vector<VoiceState> voices;
     std::vector<EffectState> effects;
     std::unique_ptr<AudioOut> audio_out;
     AudioCore::StreamPtr stream;
+
+    /// Guards the voices, which are updated by the guest and consumed by the mixing thread
+    std::mutex voice_mutex;
+    /// Float bus voices are mixed to, reused by every command list
+    std::vector<float> mix_bus;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<CommandList> pending_commands;
+    std::deque<MixedBuffer> mixed_buffers;
+    bool is_mixing_thread_running{true};
+    std::thread mixing_thread;
+
+    std::atomic<s64> mixing_time_us{};
 };
 
 } // namespace AudioCore
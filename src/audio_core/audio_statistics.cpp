@@ -0,0 +1,55 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "audio_core/audio_statistics.h"
+
+namespace AudioCore {
+
+namespace {
+
+constexpr std::array<const char*, NumAudioCounters> COUNTER_NAMES{
+    "command_lists",
+    "voices_mixed",
+    "samples_mixed",
+    "mix_time_us",
+    "resample_time_us",
+    "buffer_drops",
+    "sink_callbacks",
+    "sink_underruns",
+    "sink_overruns",
+};
+
+} // Anonymous namespace
+
+const char* GetAudioCounterName(AudioCounter counter) {
+    return COUNTER_NAMES[static_cast<std::size_t>(counter)];
+}
+
+void AudioStatistics::RecordCallbackDuration(std::chrono::microseconds duration) {
+    std::size_t bucket = 0;
+    for (u64 us = static_cast<u64>(duration.count()) >> 1;
+         us != 0 && bucket + 1 < NumCallbackDurationBuckets; us >>= 1) {
+        ++bucket;
+    }
+    callback_durations[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+AudioStatistics::Snapshot AudioStatistics::GetSnapshot() const {
+    Snapshot snapshot;
+    for (std::size_t i = 0; i < NumAudioCounters; ++i) {
+        snapshot.values[i] = counters[i].load(std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < NumCallbackDurationBuckets; ++i) {
+        snapshot.callback_durations[i] = callback_durations[i].load(std::memory_order_relaxed);
+    }
+    snapshot.active_voices = active_voices.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+AudioStatistics& GetAudioStatistics() {
+    static AudioStatistics statistics;
+    return statistics;
+}
+
+} // namespace AudioCore
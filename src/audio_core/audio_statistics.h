@@ -0,0 +1,78 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include "common/common_types.h"
+
+namespace AudioCore {
+
+/// Events counted by the audio renderer, the streams and the sinks since boot.
+enum class AudioCounter : std::size_t {
+    CommandLists,
+    VoicesMixed,
+    SamplesMixed,
+    MixTimeUs,
+    ResampleTimeUs,
+    BufferDrops,
+    SinkCallbacks,
+    SinkUnderruns,
+    SinkOverruns,
+    Count,
+};
+
+constexpr std::size_t NumAudioCounters = static_cast<std::size_t>(AudioCounter::Count);
+
+/// Number of buckets of the sink callback duration histogram. Bucket N counts the callbacks
+/// taking less than 2^(N+1) microseconds, the last bucket counts the longer ones.
+constexpr std::size_t NumCallbackDurationBuckets = 12;
+
+/// Returns the name of a counter, as used in logs and benchmark reports.
+const char* GetAudioCounterName(AudioCounter counter);
+
+/**
+ * Registry of the audio counters, shared by every renderer instance and sink stream. Updating it
+ * is thread-safe and lock-free, so the real-time sink callback can record its own timings.
+ */
+class AudioStatistics {
+public:
+    struct Snapshot {
+        std::array<u64, NumAudioCounters> values{};
+        std::array<u64, NumCallbackDurationBuckets> callback_durations{};
+        /// Number of voices mixed by the last command list
+        u32 active_voices{};
+
+        u64 operator[](AudioCounter counter) const {
+            return values[static_cast<std::size_t>(counter)];
+        }
+    };
+
+    void Add(AudioCounter counter, u64 amount = 1) {
+        counters[static_cast<std::size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void SetActiveVoices(u32 count) {
+        active_voices.store(count, std::memory_order_relaxed);
+    }
+
+    /// Records the time a sink callback took in the duration histogram.
+    void RecordCallbackDuration(std::chrono::microseconds duration);
+
+    /// Returns the current values of the counters.
+    Snapshot GetSnapshot() const;
+
+private:
+    std::array<std::atomic<u64>, NumAudioCounters> counters{};
+    std::array<std::atomic<u64>, NumCallbackDurationBuckets> callback_durations{};
+    std::atomic<u32> active_voices{};
+};
+
+/// Returns the audio counters of the process.
+AudioStatistics& GetAudioStatistics();
+
+} // namespace AudioCore
@@ -8,21 +8,32 @@
 
 namespace AudioCore::Codec {
 
+// GC-ADPCM with scale factor and variable coefficients.
+// Frames are 8 bytes long containing 14 samples each.
+// Samples are 4 bits (one nibble) long.
+constexpr std::size_t FRAME_LEN = 8;
+constexpr std::size_t SAMPLES_PER_FRAME = 14;
+
 std::vector<s16> DecodeADPCM(const u8* const data, std::size_t size, const ADPCM_Coeff& coeff,
                              ADPCMState& state) {
-    // GC-ADPCM with scale factor and variable coefficients.
-    // Frames are 8 bytes long containing 14 samples each.
-    // Samples are 4 bits (one nibble) long.
+    std::vector<s16> ret(GetADPCMSampleCount(size));
+    DecodeADPCM(ret.data(), data, size, coeff, state);
+    return ret;
+}
 
-    constexpr std::size_t FRAME_LEN = 8;
-    constexpr std::size_t SAMPLES_PER_FRAME = 14;
+std::size_t GetADPCMSampleCount(std::size_t size) {
+    const std::size_t sample_count = (size / FRAME_LEN) * SAMPLES_PER_FRAME;
+    return sample_count % 2 == 0 ? sample_count : sample_count + 1; // Ensure multiple of two.
+}
+
+std::size_t DecodeADPCM(s16* output, const u8* data, std::size_t size, const ADPCM_Coeff& coeff,
+                        ADPCMState& state) {
     constexpr std::array<int, 16> SIGNED_NIBBLES = {
         {0, 1, 2, 3, 4, 5, 6, 7, -8, -7, -6, -5, -4, -3, -2, -1}};
 
     const std::size_t sample_count = (size / FRAME_LEN) * SAMPLES_PER_FRAME;
-    const std::size_t ret_size =
-        sample_count % 2 == 0 ? sample_count : sample_count + 1; // Ensure multiple of two.
-    std::vector<s16> ret(ret_size);
+    const std::size_t ret_size = GetADPCMSampleCount(size);
+    std::fill(output + sample_count, output + ret_size, s16{0});
 
     int yn1 = state.yn1, yn2 = state.yn2;
 
@@ -57,11 +68,11 @@ std::vector<s16> DecodeADPCM(const u8* const data, std::size_t size, const ADPCM
         std::size_t datai = framei * FRAME_LEN + 1;
         for (std::size_t i = 0; i < SAMPLES_PER_FRAME && outputi < sample_count; i += 2) {
             const s16 sample1 = decode_sample(SIGNED_NIBBLES[data[datai] >> 4]);
-            ret[outputi] = sample1;
+            output[outputi] = sample1;
             outputi++;
 
             const s16 sample2 = decode_sample(SIGNED_NIBBLES[data[datai] & 0xF]);
-            ret[outputi] = sample2;
+            output[outputi] = sample2;
             outputi++;
 
             datai++;
@@ -71,7 +82,7 @@ std::vector<s16> DecodeADPCM(const u8* const data, std::size_t size, const ADPCM
     state.yn1 = static_cast<s16>(yn1);
     state.yn2 = static_cast<s16>(yn2);
 
-    return ret;
+    return ret_size;
 }
 
 } // namespace AudioCore::Codec
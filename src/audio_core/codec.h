@@ -41,4 +41,18 @@ using ADPCM_Coeff = std::array<s16, 16>;
 std::vector<s16> DecodeADPCM(const u8* const data, std::size_t size, const ADPCM_Coeff& coeff,
                              ADPCMState& state);
 
+/// Returns the number of samples DecodeADPCM writes for a buffer of the given size in bytes.
+std::size_t GetADPCMSampleCount(std::size_t size);
+
+/**
+ * @param output Buffer the samples are written to, GetADPCMSampleCount(size) in length
+ * @param data Pointer to buffer that contains ADPCM data to decode
+ * @param size Size of buffer in bytes
+ * @param coeff ADPCM coefficients
+ * @param state ADPCM state, this is updated with new state
+ * @return Number of samples written
+ */
+std::size_t DecodeADPCM(s16* output, const u8* data, std::size_t size, const ADPCM_Coeff& coeff,
+                        ADPCMState& state);
+
 }; // namespace AudioCore::Codec
@@ -4,11 +4,14 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstring>
+#include "audio_core/audio_statistics.h"
 #include "audio_core/cubeb_sink.h"
 #include "audio_core/stream.h"
 #include "audio_core/time_stretch.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "common/ring_buffer.h"
 #include "core/settings.h"
 
@@ -16,6 +19,8 @@
 #include <objbase.h>
 #endif
 
+MICROPROFILE_DEFINE(Audio_SinkEnqueue, "Audio", "Enqueue Sink Samples", MP_RGB(192, 64, 128));
+
 namespace AudioCore {
 
 class CubebSinkStream final : public SinkStream {
@@ -63,20 +68,26 @@ public:
     }
 
     void EnqueueSamples(u32 source_num_channels, const std::vector<s16>& samples) override {
+        MICROPROFILE_SCOPE(Audio_SinkEnqueue);
+        const s16* data = samples.data();
+        std::size_t num_samples = samples.size();
         if (source_num_channels > num_channels) {
             // Downsample 6 channels to 2
-            std::vector<s16> buf;
-            buf.reserve(samples.size() * num_channels / source_num_channels);
+            downmix_buffer.clear();
             for (std::size_t i = 0; i < samples.size(); i += source_num_channels) {
                 for (std::size_t ch = 0; ch < num_channels; ch++) {
-                    buf.push_back(samples[i + ch]);
+                    downmix_buffer.push_back(samples[i + ch]);
                 }
             }
-            queue.Push(buf);
-            return;
+            data = downmix_buffer.data();
+            num_samples = downmix_buffer.size();
         }
 
-        queue.Push(samples);
+        if (Settings::values.enable_audio_stretching) {
+            PushStretched(data, num_samples / num_channels);
+        } else {
+            PushSamples(data, num_samples);
+        }
     }
 
     std::size_t SamplesInQueue(u32 channel_count) const override {
@@ -86,8 +97,24 @@ public:
         return queue.Size() / channel_count;
     }
 
+    std::size_t GetLatency() const override {
+        if (!ctx) {
+            return 0;
+        }
+        u32 latency{};
+        if (cubeb_stream_get_latency(stream_backend, &latency) != CUBEB_OK) {
+            return 0;
+        }
+        return latency;
+    }
+
     void Flush() override {
-        should_flush = true;
+        if (!Settings::values.enable_audio_stretching) {
+            return;
+        }
+        // Drains the samples the stretcher holds back waiting for more input
+        time_stretch.Flush();
+        PushStretched(nullptr, 0);
     }
 
     u32 GetNumChannels() const {
@@ -101,11 +128,46 @@ private:
     cubeb_stream* stream_backend{};
     u32 num_channels{};
 
+    /// Stretches frames to the rate the device consumes them and queues the result. Runs on the
+    /// producer, the real-time callback only copies queued samples.
+    void PushStretched(const s16* frames, std::size_t num_in) {
+        const std::size_t consumed = consumed_frames.exchange(0, std::memory_order_relaxed);
+        const std::size_t queued = queue.Size() / num_channels;
+        // Enough for the largest callback seen plus this batch, so a callback arriving right
+        // before the next batch still finds a full period
+        const std::size_t target = std::min<std::size_t>(
+            max_callback_frames.load(std::memory_order_relaxed) + num_in,
+            queue.Capacity() / num_channels);
+
+        // Replaces what the device consumed and corrects the drift from the target latency
+        std::size_t num_out = consumed + target;
+        num_out = num_out > queued ? num_out - queued : 0;
+
+        stretch_buffer.resize(num_out * num_channels);
+        const std::size_t out_frames =
+            time_stretch.Process(frames, num_in, stretch_buffer.data(), num_out);
+        PushSamples(stretch_buffer.data(), out_frames * num_channels);
+    }
+
+    /// Queues samples for the callback, counting an overrun when the queue is full.
+    void PushSamples(const s16* samples, std::size_t num_samples) {
+        if (queue.Push(samples, num_samples) < num_samples) {
+            GetAudioStatistics().Add(AudioCounter::SinkOverruns);
+        }
+    }
+
     Common::RingBuffer<s16, 0x10000> queue;
     std::array<s16, 2> last_frame{};
-    std::atomic<bool> should_flush{};
     TimeStretcher time_stretch;
 
+    /// Latency measurements written by the callback and read by the producer
+    std::atomic<std::size_t> consumed_frames{};
+    std::atomic<std::size_t> max_callback_frames{};
+
+    /// Producer side scratch buffers, kept to avoid allocating on each batch
+    std::vector<s16> downmix_buffer;
+    std::vector<s16> stretch_buffer;
+
     static long DataCallback(cubeb_stream* stream, void* user_data, const void* input_buffer,
                              void* output_buffer, long num_frames);
     static void StateCallback(cubeb_stream* stream, void* user_data, cubeb_state state);
@@ -175,24 +237,23 @@ long CubebSinkStream::DataCallback(cubeb_stream* stream, void* user_data, const
         return {};
     }
 
+    // No profiler scope here, the callback runs on the real-time thread of the backend
+    const auto start = std::chrono::steady_clock::now();
     const std::size_t num_channels = impl->GetNumChannels();
     const std::size_t samples_to_write = num_channels * num_frames;
-    std::size_t samples_written;
+    const std::size_t samples_written = impl->queue.Pop(buffer, samples_to_write);
 
-    if (Settings::values.enable_audio_stretching) {
-        const std::vector<s16> in{impl->queue.Pop()};
-        const std::size_t num_in{in.size() / num_channels};
-        s16* const out{reinterpret_cast<s16*>(buffer)};
-        const std::size_t out_frames =
-            impl->time_stretch.Process(in.data(), num_in, out, num_frames);
-        samples_written = out_frames * num_channels;
+    // Only this thread writes the maximum, a plain load and store are enough
+    const auto frames = static_cast<std::size_t>(num_frames);
+    impl->consumed_frames.fetch_add(frames, std::memory_order_relaxed);
+    if (frames > impl->max_callback_frames.load(std::memory_order_relaxed)) {
+        impl->max_callback_frames.store(frames, std::memory_order_relaxed);
+    }
 
-        if (impl->should_flush) {
-            impl->time_stretch.Flush();
-            impl->should_flush = false;
-        }
-    } else {
-        samples_written = impl->queue.Pop(buffer, samples_to_write);
+    AudioStatistics& statistics = GetAudioStatistics();
+    statistics.Add(AudioCounter::SinkCallbacks);
+    if (samples_written < samples_to_write) {
+        statistics.Add(AudioCounter::SinkUnderruns);
     }
 
     if (samples_written >= num_channels) {
@@ -205,6 +266,8 @@ long CubebSinkStream::DataCallback(cubeb_stream* stream, void* user_data, const
         std::memcpy(buffer + i * sizeof(s16), &impl->last_frame[0], num_channels * sizeof(s16));
     }
 
+    statistics.RecordCallbackDuration(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start));
     return num_frames;
 }
 
@@ -26,6 +26,10 @@ private:
             return 0;
         }
 
+        std::size_t GetLatency() const override {
+            return 0;
+        }
+
         void Flush() override {}
     } null_sink_stream;
 };
@@ -28,6 +28,9 @@ public:
 
     virtual std::size_t SamplesInQueue(u32 num_channels) const = 0;
 
+    /// Returns the frames the output device buffers after the queue, as reported by the device.
+    virtual std::size_t GetLatency() const = 0;
+
     virtual void Flush() = 0;
 };
 
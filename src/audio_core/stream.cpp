@@ -5,20 +5,31 @@
 #include <algorithm>
 #include <cmath>
 
+#include "audio_core/audio_statistics.h"
 #include "audio_core/sink.h"
 #include "audio_core/sink_details.h"
 #include "audio_core/sink_stream.h"
 #include "audio_core/stream.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "core/core_timing.h"
 #include "core/core_timing_util.h"
 #include "core/settings.h"
 
+MICROPROFILE_DEFINE(Audio_Release, "Audio", "Release Stream Buffer", MP_RGB(192, 128, 64));
+
 namespace AudioCore {
 
 constexpr std::size_t MaxAudioBufferCount{32};
 
+/// Release interval correction per unit of relative queue depth error.
+constexpr double ReleaseRateGain{0.02};
+/// Largest relative change of the release interval, well under audible pitch changes.
+constexpr double MaxReleaseRateCorrection{0.01};
+/// Fraction of the distance to the desired correction moved on each release.
+constexpr double ReleaseRateSmoothing{0.1};
+
 u32 Stream::GetNumChannels() const {
     switch (format) {
     case Format::Mono16:
@@ -59,10 +70,25 @@ Stream::State Stream::GetState() const {
     return state;
 }
 
-s64 Stream::GetBufferReleaseCycles(const Buffer& buffer) const {
+s64 Stream::GetBufferReleaseCycles(const Buffer& buffer) {
     const std::size_t num_samples{buffer.GetSamples().size() / GetNumChannels()};
-    const auto us =
-        std::chrono::microseconds((static_cast<u64>(num_samples) * 1000000) / sample_rate);
+    const double duration_us{static_cast<double>(num_samples) * 1000000.0 / sample_rate};
+
+    // Steers the sink queue towards two buffers plus the device latency by stretching or
+    // shrinking the release interval slightly. The correction is bounded and smoothed so pitch
+    // changes stay inaudible. Sinks without a device report no latency and keep the plain
+    // buffer length.
+    const std::size_t latency{sink_stream.GetLatency()};
+    if (latency != 0) {
+        const double queued{static_cast<double>(sink_stream.SamplesInQueue(GetNumChannels()))};
+        const double target{static_cast<double>(num_samples * 2 + latency)};
+        const double error{(queued - target) / target};
+        const double desired{1.0 + std::clamp(error * ReleaseRateGain, -MaxReleaseRateCorrection,
+                                              MaxReleaseRateCorrection)};
+        release_rate += ReleaseRateSmoothing * (desired - release_rate);
+    }
+
+    const auto us = std::chrono::microseconds(static_cast<s64>(duration_us * release_rate));
     return Core::Timing::usToCycles(us);
 }
 
@@ -109,6 +135,7 @@ void Stream::PlayNextBuffer() {
 }
 
 void Stream::ReleaseActiveBuffer() {
+    MICROPROFILE_SCOPE(Audio_Release);
     ASSERT(active_buffer);
     released_buffers.push(std::move(active_buffer));
     release_callback();
@@ -121,6 +148,7 @@ bool Stream::QueueBuffer(BufferPtr&& buffer) {
         PlayNextBuffer();
         return true;
     }
+    GetAudioStatistics().Add(AudioCounter::BufferDrops);
     return false;
 }
 
@@ -95,12 +95,14 @@ private:
     /// Releases the actively playing buffer, signalling that it has been completed
     void ReleaseActiveBuffer();
 
-    /// Gets the number of core cycles when the specified buffer will be released
-    s64 GetBufferReleaseCycles(const Buffer& buffer) const;
+    /// Gets the number of core cycles when the specified buffer will be released, adjusting the
+    /// release rate to the depth of the sink queue
+    s64 GetBufferReleaseCycles(const Buffer& buffer);
 
     u32 sample_rate;                          ///< Sample rate of the stream
     Format format;                            ///< Format of the stream
     float game_volume = 1.0f;                 ///< The volume the game currently has set
+    double release_rate = 1.0;                ///< Correction applied to release intervals
     ReleaseCallback release_callback;         ///< Buffer release callback for the stream
     State state{State::Stopped};              ///< Playback state of the stream
     Core::Timing::EventType* release_event{}; ///< Core timing release event for the stream
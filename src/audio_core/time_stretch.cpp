@@ -27,6 +27,14 @@ void TimeStretcher::Flush() {
 
 std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
                                    std::size_t num_out) {
+    if (num_out == 0) {
+        // Nothing is requested, the input waits in the backlog without changing the ratio
+        if (num_in > 0) {
+            m_sound_touch.putSamples(in, static_cast<u32>(num_in));
+        }
+        return 0;
+    }
+
     const double time_delta = static_cast<double>(num_out) / m_sample_rate; // seconds
 
     // We were given actual_samples number of samples, and num_samples were requested from us.
@@ -61,7 +69,9 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
     LOG_TRACE(Audio, "{:5}/{:5} ratio:{:0.6f} backlog:{:0.6f}", num_in, num_out, m_stretch_ratio,
               backlog_fullness);
 
-    m_sound_touch.putSamples(in, static_cast<u32>(num_in));
+    if (num_in > 0) {
+        m_sound_touch.putSamples(in, static_cast<u32>(num_in));
+    }
     return m_sound_touch.receiveSamples(out, static_cast<u32>(num_out));
 }
 
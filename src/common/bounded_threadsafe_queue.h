@@ -0,0 +1,203 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "common/common_types.h"
+
+namespace Common {
+
+/// Bounded lock-free queue with multiple writers and a single reader.
+/// Slots are preallocated, pushing never allocates. Writers block while the queue is full and the
+/// reader blocks while it is empty, spinning for a while before parking on a condition variable.
+/// @tparam T         Element type, must be default constructible and move assignable
+/// @tparam capacity  Number of slots in the queue
+template <typename T, std::size_t capacity>
+class BoundedMPSCQueue {
+    static_assert(capacity >= 2, "capacity must hold at least two elements");
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::atomic_size_t::is_always_lock_free);
+
+public:
+    BoundedMPSCQueue() {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// Pushes an element, waiting for the reader to free a slot when the queue is full.
+    /// Safe to call from any number of threads.
+    /// @returns The number of elements pushed up to and including this one, the reader pops
+    ///          elements in this order.
+    template <typename Arg>
+    u64 Push(Arg&& t) {
+        std::size_t pos = write_index.load(std::memory_order_relaxed);
+        Slot* slot;
+        u32 spins = 0;
+        while (true) {
+            slot = &slots[pos & index_mask];
+            const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                // The slot is free, claim it.
+                if (write_index.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // The queue is full, wait for the reader to catch up.
+                WaitForSpace(spins++);
+                pos = write_index.load(std::memory_order_relaxed);
+            } else {
+                // Another writer claimed the slot first.
+                pos = write_index.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::forward<Arg>(t);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        Notify(reader_waiting, reader_cv);
+        return static_cast<u64>(pos) + 1;
+    }
+
+    /// Pushes an element unless the queue is full, never waits for the reader.
+    /// Safe to call from any number of threads.
+    /// @returns True if the element was pushed.
+    template <typename Arg>
+    bool TryPush(Arg&& t) {
+        std::size_t pos = write_index.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[pos & index_mask];
+            const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (write_index.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = write_index.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::forward<Arg>(t);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        Notify(reader_waiting, reader_cv);
+        return true;
+    }
+
+    /// Pops an element if there is one available. Only the reader thread may call this.
+    /// @returns True if an element was popped.
+    bool Pop(T& t) {
+        Slot& slot = slots[read_index & index_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != read_index + 1) {
+            return false;
+        }
+        t = std::move(slot.value);
+        slot.sequence.store(read_index + capacity, std::memory_order_release);
+        ++read_index;
+        Notify(writers_waiting, writer_cv);
+        return true;
+    }
+
+    /// Pops an element, waiting for one to be pushed when the queue is empty.
+    /// Only the reader thread may call this.
+    void PopWait(T& t) {
+        u32 spins = 0;
+        while (!Pop(t)) {
+            if (spins++ < spin_count) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock lock{wait_mutex};
+            reader_waiting.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            reader_cv.wait(lock, [this] { return !Empty(); });
+            reader_waiting.fetch_sub(1);
+        }
+    }
+
+    /// Returns true when there are no elements to pop. Only the reader thread may call this.
+    bool Empty() const {
+        const Slot& slot = slots[read_index & index_mask];
+        return slot.sequence.load(std::memory_order_acquire) != read_index + 1;
+    }
+
+    /// @returns Maximum number of elements in the queue
+    constexpr std::size_t Capacity() const {
+        return capacity;
+    }
+
+private:
+    /// Number of times a thread yields before parking on a condition variable.
+    static constexpr u32 spin_count = 64;
+    static constexpr std::size_t index_mask = capacity - 1;
+
+    struct Slot {
+        /// Equals the write position the slot accepts when free and that position plus one when
+        /// it holds an element.
+        std::atomic_size_t sequence{};
+        T value{};
+    };
+
+    void WaitForSpace(u32 spins) {
+        if (spins < spin_count) {
+            std::this_thread::yield();
+            return;
+        }
+        std::unique_lock lock{wait_mutex};
+        writers_waiting.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::size_t pos = write_index.load(std::memory_order_relaxed);
+        const Slot& slot = slots[pos & index_mask];
+        writer_cv.wait(lock, [&] {
+            return static_cast<std::ptrdiff_t>(slot.sequence.load(std::memory_order_acquire) -
+                                               pos) >= 0;
+        });
+        writers_waiting.fetch_sub(1);
+    }
+
+    void Notify(const std::atomic<u32>& waiting, std::condition_variable& cv) {
+        // Pairs with the fence of the waiting side, either the waiter observes the new state
+        // before sleeping or this observes the waiter and wakes it up.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        std::lock_guard lock{wait_mutex};
+        cv.notify_all();
+    }
+
+    // Keep the indices on separate cache lines, the reader and the writers update them
+    // concurrently and sharing a line would bounce it between cores on every operation.
+    // TODO: Remove this ifdef whenever clang and GCC support
+    //       std::hardware_destructive_interference_size.
+#if defined(_MSC_VER) && _MSC_VER >= 1911
+    alignas(std::hardware_destructive_interference_size) std::atomic_size_t write_index{0};
+    alignas(std::hardware_destructive_interference_size) std::size_t read_index{0};
+#else
+    alignas(128) std::atomic_size_t write_index{0};
+    alignas(128) std::size_t read_index{0};
+#endif
+
+    std::array<Slot, capacity> slots;
+
+    std::mutex wait_mutex;
+    std::condition_variable reader_cv;
+    std::condition_variable writer_cv;
+    std::atomic<u32> reader_waiting{0};
+    std::atomic<u32> writers_waiting{0};
+};
+
+} // namespace Common
@@ -42,8 +42,10 @@
 #include <cstdlib>
 #include <cstring>
 #include <dirent.h>
+#include <fcntl.h>
 #include <pwd.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #endif
 
 #if defined(__APPLE__)
@@ -262,6 +264,21 @@ bool Rename(const std::string& srcFilename, const std::string& destFilename) {
     return false;
 }
 
+bool Replace(const std::string& srcFilename, const std::string& destFilename) {
+    LOG_TRACE(Common_Filesystem, "{} --> {}", srcFilename, destFilename);
+#ifdef _WIN32
+    if (MoveFileExW(Common::UTF8ToUTF16W(srcFilename).c_str(),
+                    Common::UTF8ToUTF16W(destFilename).c_str(), MOVEFILE_REPLACE_EXISTING))
+        return true;
+#else
+    if (rename(srcFilename.c_str(), destFilename.c_str()) == 0)
+        return true;
+#endif
+    LOG_ERROR(Common_Filesystem, "failed {} --> {}: {}", srcFilename, destFilename,
+              GetLastErrorMsg());
+    return false;
+}
+
 bool Copy(const std::string& srcFilename, const std::string& destFilename) {
     LOG_TRACE(Common_Filesystem, "{} --> {}", srcFilename, destFilename);
 #ifdef _WIN32
@@ -963,6 +980,17 @@ bool IOFile::Flush() {
     return IsOpen() && 0 == std::fflush(m_file);
 }
 
+bool IOFile::Sync() {
+    if (!Flush()) {
+        return false;
+    }
+#ifdef _WIN32
+    return 0 == _commit(_fileno(m_file));
+#else
+    return 0 == fsync(fileno(m_file));
+#endif
+}
+
 bool IOFile::Resize(u64 size) {
     return IsOpen() && 0 ==
 #ifdef _WIN32
@@ -976,4 +1004,76 @@ bool IOFile::Resize(u64 size) {
         ;
 }
 
+MappedFile::MappedFile() = default;
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& filename) {
+    Close();
+#ifdef _WIN32
+    // Other handles may keep writing to the file, e.g. when it is also opened as read-write
+    const HANDLE file = CreateFileW(Common::UTF8ToUTF16W(filename).c_str(), GENERIC_READ,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                    nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    // The mapping keeps a reference to the file, the handle is not needed past this point
+    mapping_handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping_handle == nullptr) {
+        return false;
+    }
+    data = static_cast<u8*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr) {
+        CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+        return false;
+    }
+    size = static_cast<std::size_t>(file_size.QuadPart);
+#else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    struct stat file_info;
+    if (fstat(fd, &file_info) != 0 || file_info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    // The mapping keeps a reference to the file, the descriptor is not needed past this point
+    void* const pointer =
+        mmap(nullptr, static_cast<std::size_t>(file_info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pointer == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<u8*>(pointer);
+    size = static_cast<std::size_t>(file_info.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::Close() {
+    if (!IsOpen()) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping_handle);
+    mapping_handle = nullptr;
+#else
+    munmap(data, size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
 } // namespace FileUtil
@@ -77,6 +77,10 @@ bool DeleteDir(const std::string& filename);
 // renames file srcFilename to destFilename, returns true on success
 bool Rename(const std::string& srcFilename, const std::string& destFilename);
 
+// renames file srcFilename to destFilename, atomically replacing destFilename if it exists,
+// returns true on success
+bool Replace(const std::string& srcFilename, const std::string& destFilename);
+
 // copies file srcFilename to destFilename, returns true on success
 bool Copy(const std::string& srcFilename, const std::string& destFilename);
 
@@ -272,6 +276,9 @@ public:
     bool Resize(u64 size);
     bool Flush();
 
+    /// Flushes the file and waits until its contents reach the storage device.
+    bool Sync();
+
     // clear error state
     void Clear() {
         std::clearerr(m_file);
@@ -281,6 +288,37 @@ private:
     std::FILE* m_file = nullptr;
 };
 
+/// Read-only view of the contents of a file mapped into memory. Reads are copies from the page
+/// cache, without a system call. The file must not be truncated while it is mapped.
+class MappedFile : public NonCopyable {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /// Maps the whole file, returns false when it can't be opened or is empty.
+    bool Open(const std::string& filename);
+    void Close();
+
+    bool IsOpen() const {
+        return data != nullptr;
+    }
+
+    const u8* GetData() const {
+        return data;
+    }
+
+    std::size_t GetSize() const {
+        return size;
+    }
+
+private:
+    u8* data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    void* mapping_handle = nullptr;
+#endif
+};
+
 } // namespace FileUtil
 
 // To deal with Windows being dumb at unicode:
@@ -0,0 +1,298 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
+
+#include "common/hash.h"
+#include "common/swap.h"
+#include "common/uint128.h"
+
+namespace Common {
+
+namespace {
+
+// XXH3 as specified by xxHash 0.8, the hashes match the ones of the reference XXH3_64bits.
+
+constexpr u64 PRIME32_1 = 0x9E3779B1U;
+constexpr u64 PRIME32_2 = 0x85EBCA77U;
+constexpr u64 PRIME32_3 = 0xC2B2AE3DU;
+constexpr u64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr u64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr u64 PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr u64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr u64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+constexpr u64 PRIME_MX1 = 0x165667919E3779F9ULL;
+constexpr u64 PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+constexpr std::size_t SECRET_SIZE = 192;
+constexpr std::size_t SECRET_SIZE_MIN = 136;
+constexpr std::size_t STRIPE_LEN = 64;
+constexpr std::size_t SECRET_CONSUME_RATE = 8;
+constexpr std::size_t STRIPES_PER_BLOCK = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+constexpr std::size_t BLOCK_LEN = STRIPE_LEN * STRIPES_PER_BLOCK;
+constexpr std::size_t MIDSIZE_MAX = 240;
+
+alignas(64) constexpr std::array<u8, SECRET_SIZE> DEFAULT_SECRET{
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+u32 Read32(const u8* data) {
+    u32 value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+u64 Read64(const u8* data) {
+    u64 value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+u64 Rotl64(u64 value, int amount) {
+    return (value << amount) | (value >> (64 - amount));
+}
+
+u64 Mul128Fold64(u64 lhs, u64 rhs) {
+    const u128 product = Multiply64Into128(lhs, rhs);
+    return product[0] ^ product[1];
+}
+
+u64 XXH64Avalanche(u64 hash) {
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+u64 Avalanche(u64 hash) {
+    hash ^= hash >> 37;
+    hash *= PRIME_MX1;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+u64 RrmxmxAvalanche(u64 hash, u64 len) {
+    hash ^= Rotl64(hash, 49) ^ Rotl64(hash, 24);
+    hash *= PRIME_MX2;
+    hash ^= (hash >> 35) + len;
+    hash *= PRIME_MX2;
+    return hash ^ (hash >> 28);
+}
+
+u64 Mix16B(const u8* input, const u8* secret, u64 seed) {
+    const u64 input_lo = Read64(input);
+    const u64 input_hi = Read64(input + 8);
+    return Mul128Fold64(input_lo ^ (Read64(secret) + seed), input_hi ^ (Read64(secret + 8) - seed));
+}
+
+u64 HashLen1To3(const u8* input, std::size_t len, const u8* secret, u64 seed) {
+    const u32 c1 = input[0];
+    const u32 c2 = input[len >> 1];
+    const u32 c3 = input[len - 1];
+    const u32 combined = (c1 << 16) | (c2 << 24) | c3 | (static_cast<u32>(len) << 8);
+    const u64 bitflip = (Read32(secret) ^ Read32(secret + 4)) + seed;
+    return XXH64Avalanche(combined ^ bitflip);
+}
+
+u64 HashLen4To8(const u8* input, std::size_t len, const u8* secret, u64 seed) {
+    seed ^= static_cast<u64>(swap32(static_cast<u32>(seed))) << 32;
+    const u64 input1 = Read32(input);
+    const u64 input2 = Read32(input + len - 4);
+    const u64 bitflip = (Read64(secret + 8) ^ Read64(secret + 16)) - seed;
+    const u64 input64 = input2 + (input1 << 32);
+    return RrmxmxAvalanche(input64 ^ bitflip, len);
+}
+
+u64 HashLen9To16(const u8* input, std::size_t len, const u8* secret, u64 seed) {
+    const u64 bitflip1 = (Read64(secret + 24) ^ Read64(secret + 32)) + seed;
+    const u64 bitflip2 = (Read64(secret + 40) ^ Read64(secret + 48)) - seed;
+    const u64 input_lo = Read64(input) ^ bitflip1;
+    const u64 input_hi = Read64(input + len - 8) ^ bitflip2;
+    const u64 acc = len + swap64(input_lo) + input_hi + Mul128Fold64(input_lo, input_hi);
+    return Avalanche(acc);
+}
+
+u64 HashLen0To16(const u8* input, std::size_t len, const u8* secret, u64 seed) {
+    if (len > 8) {
+        return HashLen9To16(input, len, secret, seed);
+    }
+    if (len >= 4) {
+        return HashLen4To8(input, len, secret, seed);
+    }
+    if (len > 0) {
+        return HashLen1To3(input, len, secret, seed);
+    }
+    return XXH64Avalanche(seed ^ Read64(secret + 56) ^ Read64(secret + 64));
+}
+
+u64 HashLen17To128(const u8* input, std::size_t len, const u8* secret, u64 seed) {
+    u64 acc = len * PRIME64_1;
+    if (len > 32) {
+        if (len > 64) {
+            if (len > 96) {
+                acc += Mix16B(input + 48, secret + 96, seed);
+                acc += Mix16B(input + len - 64, secret + 112, seed);
+            }
+            acc += Mix16B(input + 32, secret + 64, seed);
+            acc += Mix16B(input + len - 48, secret + 80, seed);
+        }
+        acc += Mix16B(input + 16, secret + 32, seed);
+        acc += Mix16B(input + len - 32, secret + 48, seed);
+    }
+    acc += Mix16B(input, secret, seed);
+    acc += Mix16B(input + len - 16, secret + 16, seed);
+    return Avalanche(acc);
+}
+
+u64 HashLen129To240(const u8* input, std::size_t len, const u8* secret, u64 seed) {
+    const std::size_t num_rounds = len / 16;
+    u64 acc = len * PRIME64_1;
+    for (std::size_t i = 0; i < 8; ++i) {
+        acc += Mix16B(input + 16 * i, secret + 16 * i, seed);
+    }
+    u64 acc_end = Mix16B(input + len - 16, secret + SECRET_SIZE_MIN - 17, seed);
+    acc = Avalanche(acc);
+    for (std::size_t i = 8; i < num_rounds; ++i) {
+        acc_end += Mix16B(input + 16 * i, secret + 16 * (i - 8) + 3, seed);
+    }
+    return Avalanche(acc + acc_end);
+}
+
+using Accumulators = std::array<u64, STRIPE_LEN / sizeof(u64)>;
+
+#ifdef ARCHITECTURE_x86_64
+
+void Accumulate512(Accumulators& acc, const u8* input, const u8* secret) {
+    auto* const acc_vec = reinterpret_cast<__m128i*>(acc.data());
+    for (std::size_t i = 0; i < STRIPE_LEN / sizeof(__m128i); ++i) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + i);
+        const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+        const __m128i data_key = _mm_xor_si128(data, key);
+        // Multiplies the low and high halves of each 64-bit lane of the keyed data
+        const __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i product = _mm_mul_epu32(data_key, data_key_hi);
+        // The data is added to the other lane of the pair
+        const __m128i data_swap = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        const __m128i sum = _mm_add_epi64(_mm_load_si128(acc_vec + i), data_swap);
+        _mm_store_si128(acc_vec + i, _mm_add_epi64(product, sum));
+    }
+}
+
+void ScrambleAccumulators(Accumulators& acc, const u8* secret) {
+    auto* const acc_vec = reinterpret_cast<__m128i*>(acc.data());
+    const __m128i prime32 = _mm_set1_epi32(static_cast<int>(PRIME32_1));
+    for (std::size_t i = 0; i < STRIPE_LEN / sizeof(__m128i); ++i) {
+        __m128i value = _mm_load_si128(acc_vec + i);
+        value = _mm_xor_si128(value, _mm_srli_epi64(value, 47));
+        const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+        const __m128i data_key = _mm_xor_si128(value, key);
+        // 64-bit multiplication by a 32-bit prime out of two 32x32 multiplications
+        const __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i product_lo = _mm_mul_epu32(data_key, prime32);
+        const __m128i product_hi = _mm_mul_epu32(data_key_hi, prime32);
+        _mm_store_si128(acc_vec + i, _mm_add_epi64(product_lo, _mm_slli_epi64(product_hi, 32)));
+    }
+}
+
+#else
+
+void Accumulate512(Accumulators& acc, const u8* input, const u8* secret) {
+    for (std::size_t i = 0; i < acc.size(); ++i) {
+        const u64 data = Read64(input + 8 * i);
+        const u64 data_key = data ^ Read64(secret + 8 * i);
+        acc[i ^ 1] += data;
+        acc[i] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+    }
+}
+
+void ScrambleAccumulators(Accumulators& acc, const u8* secret) {
+    for (std::size_t i = 0; i < acc.size(); ++i) {
+        u64 value = acc[i];
+        value ^= value >> 47;
+        value ^= Read64(secret + 8 * i);
+        acc[i] = value * PRIME32_1;
+    }
+}
+
+#endif
+
+u64 HashLong(const u8* input, std::size_t len, const u8* secret) {
+    alignas(16) Accumulators acc{PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+                                 PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
+
+    const std::size_t num_blocks = (len - 1) / BLOCK_LEN;
+    for (std::size_t block = 0; block < num_blocks; ++block) {
+        const u8* const block_input = input + block * BLOCK_LEN;
+        for (std::size_t stripe = 0; stripe < STRIPES_PER_BLOCK; ++stripe) {
+            Accumulate512(acc, block_input + stripe * STRIPE_LEN,
+                          secret + stripe * SECRET_CONSUME_RATE);
+        }
+        ScrambleAccumulators(acc, secret + SECRET_SIZE - STRIPE_LEN);
+    }
+
+    // The last partial block, its last stripe is always hashed whole and may overlap the others
+    const std::size_t num_stripes = ((len - 1) - num_blocks * BLOCK_LEN) / STRIPE_LEN;
+    const u8* const block_input = input + num_blocks * BLOCK_LEN;
+    for (std::size_t stripe = 0; stripe < num_stripes; ++stripe) {
+        Accumulate512(acc, block_input + stripe * STRIPE_LEN,
+                      secret + stripe * SECRET_CONSUME_RATE);
+    }
+    Accumulate512(acc, input + len - STRIPE_LEN, secret + SECRET_SIZE - STRIPE_LEN - 7);
+
+    u64 result = len * PRIME64_1;
+    for (std::size_t i = 0; i < acc.size() / 2; ++i) {
+        const u8* const key = secret + 11 + 16 * i;
+        result += Mul128Fold64(acc[2 * i] ^ Read64(key), acc[2 * i + 1] ^ Read64(key + 8));
+    }
+    return Avalanche(result);
+}
+
+} // Anonymous namespace
+
+u64 ComputeXXH3(const void* data, std::size_t len, u64 seed) {
+    const u8* const input = static_cast<const u8*>(data);
+    const u8* const secret = DEFAULT_SECRET.data();
+    if (len <= 16) {
+        return HashLen0To16(input, len, secret, seed);
+    }
+    if (len <= 128) {
+        return HashLen17To128(input, len, secret, seed);
+    }
+    if (len <= MIDSIZE_MAX) {
+        return HashLen129To240(input, len, secret, seed);
+    }
+    if (seed == 0) {
+        return HashLong(input, len, secret);
+    }
+
+    // Long inputs are hashed with a secret derived from the seed instead
+    alignas(16) std::array<u8, SECRET_SIZE> custom_secret;
+    for (std::size_t i = 0; i < SECRET_SIZE; i += 16) {
+        const u64 lo = Read64(secret + i) + seed;
+        const u64 hi = Read64(secret + i + 8) - seed;
+        std::memcpy(custom_secret.data() + i, &lo, sizeof(lo));
+        std::memcpy(custom_secret.data() + i + 8, &hi, sizeof(hi));
+    }
+    return HashLong(input, len, custom_secret.data());
+}
+
+} // namespace Common
@@ -13,6 +13,16 @@
 
 namespace Common {
 
+/**
+ * Computes the XXH3 64-bit hash of a block of data. Large blocks are hashed several times faster
+ * than with CityHash, making it cheap enough to hash guest memory contents on every upload.
+ * @param data Block of data to compute hash over
+ * @param len Length of data (in bytes) to compute hash over
+ * @param seed Seed of the hash, hashes of different seeds are unrelated
+ * @returns 64-bit hash value that was computed over the data block
+ */
+u64 ComputeXXH3(const void* data, std::size_t len, u64 seed = 0);
+
 /**
  * Computes a 64-bit hash over the specified block of data
  * @param data Block of data to compute hash over
@@ -20,7 +30,7 @@ namespace Common {
  * @returns 64-bit hash value that was computed over the data block
  */
 static inline u64 ComputeHash64(const void* data, std::size_t len) {
-    return CityHash64(static_cast<const char*>(data), len);
+    return ComputeXXH3(data, len);
 }
 
 /**
@@ -3,13 +3,16 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <climits>
 #include <condition_variable>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <utility>
 #include <vector>
 #ifdef _WIN32
 #include <share.h>   // For _SH_DENYWR
@@ -18,14 +21,47 @@
 #define _SH_DENYWR 0
 #endif
 #include "common/assert.h"
+#include "common/bounded_threadsafe_queue.h"
 #include "common/logging/backend.h"
 #include "common/logging/log.h"
 #include "common/logging/text_formatter.h"
 #include "common/string_util.h"
-#include "common/threadsafe_queue.h"
+#include "common/thread_placement.h"
 
 namespace Log {
 
+namespace {
+
+/// Number of messages that can wait for the logging thread before the callers have to wait too.
+constexpr std::size_t MESSAGE_QUEUE_SIZE = 2048;
+
+/// A message as queued to the logging thread, which builds its Entry.
+struct QueuedMessage {
+    Class log_class{};
+    Level log_level{};
+    unsigned int line_num{};
+    const char* filename{};
+    const char* function{};
+    const char* format{};
+    std::chrono::steady_clock::time_point time;
+    /// Formats the packed arguments, null when the message was already formatted by the caller.
+    Detail::PackedFormatter formatter{};
+    std::string message;
+    bool final_entry = false;
+    std::array<u8, Detail::PACKED_ARGS_SIZE> packed;
+};
+
+template <std::size_t... indices>
+constexpr Detail::ClassLevels MakeClassLevels(Level level, std::index_sequence<indices...>) {
+    return {{(static_cast<void>(indices), level)...}};
+}
+
+} // Anonymous namespace
+
+// Constant initialized to the level of a default Filter, so it is valid before any constructor ran
+Detail::ClassLevels Detail::class_levels = MakeClassLevels(
+    Level::Info, std::make_index_sequence<std::tuple_size_v<Detail::ClassLevels>>{});
+
 /**
  * Static state as a singleton.
  */
@@ -41,8 +77,22 @@ public:
 
     void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, std::string message) {
-        message_queue.Push(
-            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
+        QueuedMessage queued = CreateMessage(log_class, log_level, filename, line_num, function);
+        queued.message = std::move(message);
+        message_queue.Push(std::move(queued));
+    }
+
+    void PushPackedEntry(Class log_class, Level log_level, const char* filename,
+                         unsigned int line_num, const char* function, const char* format,
+                         Detail::PackedFormatter formatter, const u8* packed,
+                         std::size_t packed_size) {
+        QueuedMessage queued = CreateMessage(log_class, log_level, filename, line_num, function);
+        queued.format = format;
+        queued.formatter = formatter;
+        if (packed_size != 0) {
+            std::memcpy(queued.packed.data(), packed, packed_size);
+        }
+        message_queue.Push(std::move(queued));
     }
 
     void AddBackend(std::unique_ptr<Backend> backend) {
@@ -64,6 +114,10 @@ public:
 
     void SetGlobalFilter(const Filter& f) {
         filter = f;
+        for (std::size_t i = 0; i < Detail::class_levels.size(); ++i) {
+            Detail::class_levels[i].store(filter.GetClassLevel(static_cast<Class>(i)),
+                                          std::memory_order_relaxed);
+        }
     }
 
     Backend* GetBackend(std::string_view backend_name) {
@@ -78,60 +132,80 @@ public:
 private:
     Impl() {
         backend_thread = std::thread([&] {
+            QueuedMessage queued;
             Entry entry;
-            auto write_logs = [&](Entry& e) {
+            auto write_logs = [&](QueuedMessage& message) {
+                CreateEntry(message, entry);
                 std::lock_guard lock{writing_mutex};
                 for (const auto& backend : backends) {
-                    backend->Write(e);
+                    backend->Write(entry);
                 }
             };
             while (true) {
-                entry = message_queue.PopWait();
-                if (entry.final_entry) {
+                message_queue.PopWait(queued);
+                if (queued.final_entry) {
                     break;
                 }
-                write_logs(entry);
+                // The thread starts before the settings are loaded, it is placed once they are
+                Common::UpdateThreadPlacement(Common::ThreadRole::Logging);
+                write_logs(queued);
             }
 
             // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a case
             // where a system is repeatedly spamming logs even on close.
             const int MAX_LOGS_TO_WRITE = filter.IsDebug() ? INT_MAX : 100;
             int logs_written = 0;
-            while (logs_written++ < MAX_LOGS_TO_WRITE && message_queue.Pop(entry)) {
-                write_logs(entry);
+            while (logs_written++ < MAX_LOGS_TO_WRITE && message_queue.Pop(queued)) {
+                write_logs(queued);
             }
         });
     }
 
     ~Impl() {
-        Entry entry;
-        entry.final_entry = true;
-        message_queue.Push(entry);
+        QueuedMessage queued;
+        queued.final_entry = true;
+        message_queue.Push(std::move(queued));
         backend_thread.join();
     }
 
-    Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
-                      const char* function, std::string message) const {
-        using std::chrono::duration_cast;
-        using std::chrono::steady_clock;
+    static QueuedMessage CreateMessage(Class log_class, Level log_level, const char* filename,
+                                       unsigned int line_nr, const char* function) {
+        QueuedMessage queued;
+        queued.log_class = log_class;
+        queued.log_level = log_level;
+        queued.filename = filename;
+        queued.line_num = line_nr;
+        queued.function = function;
+        queued.time = std::chrono::steady_clock::now();
+        return queued;
+    }
 
-        Entry entry;
+    /// Builds the entry of a queued message, formatting it if the caller has not done so.
+    void CreateEntry(QueuedMessage& queued, Entry& entry) const {
         entry.timestamp =
-            duration_cast<std::chrono::microseconds>(steady_clock::now() - time_origin);
-        entry.log_class = log_class;
-        entry.log_level = log_level;
-        entry.filename = Common::TrimSourcePath(filename);
-        entry.line_num = line_nr;
-        entry.function = function;
-        entry.message = std::move(message);
-
-        return entry;
+            std::chrono::duration_cast<std::chrono::microseconds>(queued.time - time_origin);
+        entry.log_class = queued.log_class;
+        entry.log_level = queued.log_level;
+        entry.filename = Common::TrimSourcePath(queued.filename);
+        entry.line_num = queued.line_num;
+        entry.function = queued.function;
+        if (queued.formatter == nullptr) {
+            entry.message = std::move(queued.message);
+            return;
+        }
+
+        try {
+            entry.message = queued.formatter(queued.format, queued.packed.data());
+        } catch (const fmt::format_error& error) {
+            entry.message = fmt::format("Invalid log format \"{}\": {}", queued.format,
+                                        error.what());
+        }
     }
 
     std::mutex writing_mutex;
     std::thread backend_thread;
     std::vector<std::unique_ptr<Backend>> backends;
-    Common::MPSCQueue<Log::Entry> message_queue;
+    Common::BoundedMPSCQueue<QueuedMessage, MESSAGE_QUEUE_SIZE> message_queue;
     Filter filter;
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
 };
@@ -309,6 +383,17 @@ Backend* GetBackend(std::string_view backend_name) {
     return Impl::Instance().GetBackend(backend_name);
 }
 
+namespace Detail {
+
+void PushPackedMessage(Class log_class, Level log_level, const char* filename,
+                       unsigned int line_num, const char* function, const char* format,
+                       PackedFormatter formatter, const u8* packed, std::size_t packed_size) {
+    Impl::Instance().PushPackedEntry(log_class, log_level, filename, line_num, function, format,
+                                     formatter, packed, packed_size);
+}
+
+} // namespace Detail
+
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args) {
@@ -4,6 +4,13 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <fmt/format.h>
 #include "common/common_types.h"
 
@@ -24,6 +31,17 @@ enum class Level : u8 {
     Count ///< Total number of logging levels
 };
 
+#ifndef YUZU_MIN_LOG_LEVEL
+#ifdef _DEBUG
+#define YUZU_MIN_LOG_LEVEL Trace
+#else
+#define YUZU_MIN_LOG_LEVEL Debug
+#endif
+#endif
+
+/// Messages below this level are compiled out, set through the YUZU_MIN_LOG_LEVEL CMake option.
+constexpr Level MIN_LOG_LEVEL = Level::YUZU_MIN_LOG_LEVEL;
+
 typedef u8 ClassType;
 
 /**
@@ -130,35 +148,179 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args);
 
+namespace Detail {
+
+/// Maximum size of the packed arguments of a message that is formatted by the logging thread.
+constexpr std::size_t PACKED_ARGS_SIZE = 0x180;
+
+/// Formats a message from the format string and the arguments packed by PackArg.
+using PackedFormatter = std::string (*)(const char* format, const u8* packed);
+
+template <typename T>
+constexpr bool IsPackedAsString =
+    std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+/// Arguments that can be copied and formatted later by the logging thread. Other types may refer
+/// to memory that is gone by then or are formatted differently once copied, those messages are
+/// still formatted by the calling thread.
+template <typename T>
+constexpr bool IsPackable = std::is_arithmetic_v<std::decay_t<T>> ||
+                            std::is_same_v<std::decay_t<T>, const void*> ||
+                            std::is_same_v<std::decay_t<T>, void*> ||
+                            IsPackedAsString<std::decay_t<T>>;
+
+/// Type an argument is formatted as after it has been unpacked.
+template <typename T>
+using PackedType = std::conditional_t<IsPackedAsString<std::decay_t<T>>, std::string_view,
+                                      std::decay_t<T>>;
+
+using ClassLevels = std::array<std::atomic<Level>, static_cast<std::size_t>(Class::Count)>;
+
+/// Minimum level of each class, a copy of the global filter that is read without locking.
+extern ClassLevels class_levels;
+
+/// Returns true if messages of the class and level pass the global filter.
+inline bool IsLogged(Class log_class, Level log_level) {
+    return log_level >=
+           class_levels[static_cast<std::size_t>(log_class)].load(std::memory_order_relaxed);
+}
+
+/// Queues a message whose arguments are formatted by the logging thread.
+void PushPackedMessage(Class log_class, Level log_level, const char* filename,
+                       unsigned int line_num, const char* function, const char* format,
+                       PackedFormatter formatter, const u8* packed, std::size_t packed_size);
+
+/// Appends the length and the characters of a string to packed, returns false if they do not fit.
+inline bool PackString(std::array<u8, PACKED_ARGS_SIZE>& packed, std::size_t& size,
+                       std::string_view string) {
+    const std::size_t length = string.size();
+    if (length > PACKED_ARGS_SIZE - size || sizeof(length) > PACKED_ARGS_SIZE - size - length) {
+        return false;
+    }
+    std::memcpy(packed.data() + size, &length, sizeof(length));
+    std::memcpy(packed.data() + size + sizeof(length), string.data(), length);
+    size += sizeof(length) + length;
+    return true;
+}
+
+/// Appends a copy of an argument to packed, returns false if it does not fit.
+template <typename T>
+bool PackArg(std::array<u8, PACKED_ARGS_SIZE>& packed, std::size_t& size, const T& arg) {
+    if constexpr (IsPackedAsString<T>) {
+        if constexpr (std::is_pointer_v<T>) {
+            // Left to fmt, which reports null strings as an error on the calling thread
+            if (arg == nullptr) {
+                return false;
+            }
+        }
+        return PackString(packed, size, arg);
+    } else {
+        const PackedType<T> value = arg;
+        if (sizeof(value) > PACKED_ARGS_SIZE - size) {
+            return false;
+        }
+        std::memcpy(packed.data() + size, &value, sizeof(value));
+        size += sizeof(value);
+        return true;
+    }
+}
+
+/// Appends a copy of a character array, which unlike a pointer argument is never null.
+template <std::size_t N>
+bool PackArg(std::array<u8, PACKED_ARGS_SIZE>& packed, std::size_t& size, const char (&arg)[N]) {
+    return PackString(packed, size, arg);
+}
+
+/// Reads back an argument written by PackArg, the returned strings point into packed.
+template <typename T>
+T UnpackArg(const u8* packed, std::size_t& offset) {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+        std::size_t length;
+        std::memcpy(&length, packed + offset, sizeof(length));
+        const std::string_view string{reinterpret_cast<const char*>(packed + offset) +
+                                          sizeof(length),
+                                      length};
+        offset += sizeof(length) + length;
+        return string;
+    } else {
+        T value;
+        std::memcpy(&value, packed + offset, sizeof(value));
+        offset += sizeof(value);
+        return value;
+    }
+}
+
+template <typename... Packed>
+std::string FormatPacked(const char* format, const u8* packed) {
+    if constexpr (sizeof...(Packed) == 0) {
+        // Still formatted for the escaped braces
+        return fmt::vformat(format, fmt::make_format_args());
+    } else {
+        std::size_t offset = 0;
+        // Braced initialization evaluates the arguments in order
+        const std::tuple<Packed...> args{UnpackArg<Packed>(packed, offset)...};
+        return std::apply(
+            [format](const auto&... unpacked) {
+                return fmt::vformat(format, fmt::make_format_args(unpacked...));
+            },
+            args);
+    }
+}
+
+} // namespace Detail
+
+/**
+ * Logs a message to the global logger, the LOG_* macros only call this for messages that pass the
+ * filter. Arithmetic, pointer and string arguments are copied and the message is formatted by the
+ * logging thread, so `format` must stay valid after the call returns, e.g. by being a string
+ * literal. Messages with other arguments are formatted right away.
+ */
 template <typename... Args>
 void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, const char* format, const Args&... args) {
+    if constexpr (sizeof...(Args) == 0) {
+        Detail::PushPackedMessage(log_class, log_level, filename, line_num, function, format,
+                                  &Detail::FormatPacked<>, nullptr, 0);
+        return;
+    } else if constexpr ((Detail::IsPackable<Args> && ...)) {
+        std::array<u8, Detail::PACKED_ARGS_SIZE> packed;
+        std::size_t packed_size = 0;
+        if ((Detail::PackArg(packed, packed_size, args) && ...)) {
+            Detail::PushPackedMessage(log_class, log_level, filename, line_num, function, format,
+                                      &Detail::FormatPacked<Detail::PackedType<Args>...>,
+                                      packed.data(), packed_size);
+            return;
+        }
+    }
+
     FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
                       fmt::make_format_args(args...));
 }
 
 } // namespace Log
 
-#ifdef _DEBUG
-#define LOG_TRACE(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Trace, __FILE__, __LINE__,         \
-                         __func__, __VA_ARGS__)
-#else
-#define LOG_TRACE(log_class, fmt, ...) (void(0))
-#endif
+// The level is checked before the arguments are evaluated, disabled messages cost a load and a
+// compare, and nothing at all below MIN_LOG_LEVEL.
+#define LOG_GENERIC(log_class, log_level, ...)                                                     \
+    do {                                                                                           \
+        if constexpr (log_level >= ::Log::MIN_LOG_LEVEL) {                                         \
+            if (::Log::Detail::IsLogged(log_class, log_level)) {                                   \
+                ::Log::FmtLogMessage(log_class, log_level, __FILE__, __LINE__, __func__,           \
+                                     __VA_ARGS__);                                                 \
+            }                                                                                      \
+        }                                                                                          \
+    } while (0)
 
+#define LOG_TRACE(log_class, ...)                                                                  \
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Trace, __VA_ARGS__)
 #define LOG_DEBUG(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Debug, __FILE__, __LINE__,         \
-                         __func__, __VA_ARGS__)
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Debug, __VA_ARGS__)
 #define LOG_INFO(log_class, ...)                                                                   \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Info, __FILE__, __LINE__,          \
-                         __func__, __VA_ARGS__)
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Info, __VA_ARGS__)
 #define LOG_WARNING(log_class, ...)                                                                \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Warning, __FILE__, __LINE__,       \
-                         __func__, __VA_ARGS__)
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Warning, __VA_ARGS__)
 #define LOG_ERROR(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Error, __FILE__, __LINE__,         \
-                         __func__, __VA_ARGS__)
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Error, __VA_ARGS__)
 #define LOG_CRITICAL(log_class, ...)                                                               \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Critical, __FILE__, __LINE__,      \
-                         __func__, __VA_ARGS__)
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Critical, __VA_ARGS__)
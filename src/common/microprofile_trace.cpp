@@ -0,0 +1,238 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/microprofile.h"
+#include "common/microprofile_trace.h"
+
+namespace Common {
+
+#if MICROPROFILE_ENABLED
+
+namespace {
+
+/// Progress of the capture through the log of one profiled thread.
+struct TraceThread {
+    std::string name;
+    u64 thread_id = 0;
+    u32 get = 0;
+    u32 depth = 0;
+};
+
+struct TraceState {
+    std::mutex mutex;
+    FileUtil::IOFile file;
+    std::array<TraceThread, MICROPROFILE_MAX_THREADS> threads;
+    u64 frame_index = 0;
+    s64 start_tick = 0;
+    s64 last_time = 0;
+    double ticks_per_us = 1.0;
+    bool all_groups_wanted = false;
+    bool force_enable = false;
+};
+
+TraceState state;
+
+/// Appends a string to a JSON document, escaping the characters that need it.
+void AppendJsonString(std::string& out, std::string_view value) {
+    out += '"';
+    for (const char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            fmt::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<int>(c));
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+void AppendScopeEvent(std::string& out, char phase, std::string_view name,
+                      std::string_view category, s64 ticks, std::size_t tid) {
+    out += ",\n{\"name\":";
+    AppendJsonString(out, name);
+    out += ",\"cat\":";
+    AppendJsonString(out, category);
+    fmt::format_to(std::back_inserter(out), ",\"ph\":\"{}\",\"ts\":{:.3f},\"pid\":0,\"tid\":{}}}",
+                   phase, static_cast<double>(ticks) / state.ticks_per_us, tid);
+}
+
+void AppendThreadName(std::string& out, std::string_view name, std::size_t tid) {
+    fmt::format_to(std::back_inserter(out),
+                   ",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{"
+                   "\"name\":",
+                   tid);
+    AppendJsonString(out, name);
+    out += "}}";
+}
+
+/// Ends the scopes a thread still has open at the time of the last written event, so that the
+/// viewer does not stretch them to the end of the trace.
+void CloseScopes(std::string& out, TraceThread& thread, std::size_t tid) {
+    for (; thread.depth > 0; --thread.depth) {
+        AppendScopeEvent(out, 'E', "", "", state.last_time, tid);
+    }
+}
+
+} // Anonymous namespace
+
+bool StartProfileTrace(const std::string& path) {
+    std::lock_guard lock{state.mutex};
+    if (state.file.IsOpen()) {
+        return false;
+    }
+    if (!state.file.Open(path, "w")) {
+        return false;
+    }
+
+    std::lock_guard profile_lock{MicroProfileGetMutex()};
+    const MicroProfile& profile = *MicroProfileGet();
+    // Everything recorded before this point is skipped
+    for (std::size_t i = 0; i < MICROPROFILE_MAX_THREADS; ++i) {
+        const MicroProfileThreadLog* const log = profile.Pool[i];
+        state.threads[i] = {};
+        if (log != nullptr) {
+            state.threads[i].thread_id = log->nThreadId;
+            state.threads[i].get = log->nPut.load(std::memory_order_acquire);
+        }
+    }
+    state.frame_index = profile.nFramePutIndex;
+    state.start_tick = MicroProfileLogGetTick(MP_TICK());
+    state.last_time = 0;
+    state.ticks_per_us = static_cast<double>(MicroProfileTicksPerSecondCpu()) / 1000000.0;
+
+    state.all_groups_wanted = MicroProfileGetEnableAllGroups();
+    state.force_enable = MicroProfileGetForceEnable();
+    MicroProfileSetEnableAllGroups(true);
+    MicroProfileSetForceEnable(true);
+
+    state.file.WriteString("[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{"
+                           "\"name\":\"yuzu\"}}");
+    return true;
+}
+
+void StopProfileTrace() {
+    std::lock_guard lock{state.mutex};
+    if (!state.file.IsOpen()) {
+        return;
+    }
+
+    MicroProfileSetEnableAllGroups(state.all_groups_wanted);
+    MicroProfileSetForceEnable(state.force_enable);
+
+    std::string out;
+    for (std::size_t i = 0; i < state.threads.size(); ++i) {
+        CloseScopes(out, state.threads[i], i);
+    }
+    out += "\n]\n";
+    state.file.WriteString(out);
+    state.file.Close();
+}
+
+bool IsProfileTraceRunning() {
+    std::lock_guard lock{state.mutex};
+    return state.file.IsOpen();
+}
+
+void WriteProfileTrace() {
+    std::lock_guard lock{state.mutex};
+    if (!state.file.IsOpen()) {
+        return;
+    }
+
+    std::lock_guard profile_lock{MicroProfileGetMutex()};
+    const MicroProfile& profile = *MicroProfileGet();
+    if (profile.nFramePutIndex == state.frame_index) {
+        // The flip did not record a frame yet, as the capture started after it
+        return;
+    }
+    state.frame_index = profile.nFramePutIndex;
+
+    // The flip stored the end of the frame that just ended for every thread. The threads keep
+    // logging past it, but never overwrite the frame before they reach the next flip.
+    const MicroProfileFrameState& frame = profile.Frames[profile.nFramePut];
+
+    std::string out;
+    for (std::size_t i = 0; i < MICROPROFILE_MAX_THREADS; ++i) {
+        const MicroProfileThreadLog* const log = profile.Pool[i];
+        if (log == nullptr || !log->nActive) {
+            continue;
+        }
+
+        TraceThread& thread = state.threads[i];
+        if (thread.thread_id != log->nThreadId) {
+            // The log of an exited thread was handed to a new one, which starts it over
+            CloseScopes(out, thread, i);
+            thread = {};
+            thread.thread_id = log->nThreadId;
+        }
+        if (thread.name != log->ThreadName) {
+            thread.name = log->ThreadName;
+            AppendThreadName(out, thread.name, i);
+        }
+
+        const u32 put = frame.nLogStart[i];
+        u32 range[2][2] = {};
+        MicroProfileGetRange(put, thread.get, range);
+        thread.get = put;
+
+        for (const auto& [begin, end] : range) {
+            for (u32 k = begin; k < end; ++k) {
+                const MicroProfileLogEntry entry = log->Log[k];
+                const int type = MicroProfileLogType(entry);
+                if (type == MP_LOG_META) {
+                    continue;
+                }
+                // Scopes entered before the capture started are dropped
+                if (type == MP_LOG_LEAVE && thread.depth == 0) {
+                    continue;
+                }
+
+                const auto timer = MicroProfileLogTimerIndex(entry);
+                const char* const name = profile.TimerInfo[timer].pName;
+                const char* const group = profile.GroupInfo[profile.TimerToGroup[timer]].pName;
+                const s64 time = MicroProfileLogTickDifference(state.start_tick, entry);
+                state.last_time = std::max(state.last_time, time);
+                if (type == MP_LOG_ENTER) {
+                    ++thread.depth;
+                    AppendScopeEvent(out, 'B', name, group, time, i);
+                } else {
+                    --thread.depth;
+                    AppendScopeEvent(out, 'E', name, group, time, i);
+                }
+            }
+        }
+    }
+    state.file.WriteString(out);
+}
+
+#else
+
+bool StartProfileTrace(const std::string& path) {
+    return false;
+}
+
+void StopProfileTrace() {}
+
+bool IsProfileTraceRunning() {
+    return false;
+}
+
+void WriteProfileTrace() {}
+
+#endif
+
+} // namespace Common
@@ -0,0 +1,26 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+namespace Common {
+
+/// Starts writing the scopes MicroProfile records on all threads to a file, as Chrome trace events
+/// that chrome://tracing and Perfetto can show on a timeline. All profiling groups are enabled for
+/// the duration of the capture. Returns false if the file could not be opened.
+bool StartProfileTrace(const std::string& path);
+
+/// Writes the scopes that are still open and finishes the file of the running capture.
+void StopProfileTrace();
+
+/// Whether a capture is running.
+bool IsProfileTraceRunning();
+
+/// Writes the scopes recorded since the previous frame to the running capture. Must be called
+/// right after MicroProfileFlip, on the same thread.
+void WriteProfileTrace();
+
+} // namespace Common
@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <limits>
+#include "common/assert.h"
 #include "common/page_table.h"
 
 namespace Common {
@@ -16,7 +19,13 @@ void PageTable::Resize(std::size_t address_space_width_in_bits) {
 
     pointers.resize(num_page_table_entries);
     attributes.resize(num_page_table_entries);
-    backing_addr.resize(num_page_table_entries);
+    backing_pointers.resize(num_page_table_entries);
+    if (!special_indices.empty()) {
+        for (std::size_t page = num_page_table_entries; page < special_indices.size(); ++page) {
+            ReleaseSpecialHandlers(special_indices[page]);
+        }
+        special_indices.resize(num_page_table_entries);
+    }
 
     // The default is a 39-bit address space, which causes an initial 1GB allocation size. If the
     // vector size is subsequently decreased (via resize), the vector might not automatically
@@ -25,7 +34,109 @@ void PageTable::Resize(std::size_t address_space_width_in_bits) {
 
     pointers.shrink_to_fit();
     attributes.shrink_to_fit();
-    backing_addr.shrink_to_fit();
+    backing_pointers.shrink_to_fit();
+    special_indices.shrink_to_fit();
+}
+
+template <typename Func>
+void PageTable::TransformSpecialRegions(std::size_t base_page, std::size_t num_pages,
+                                        Func&& func) {
+    if (special_indices.empty()) {
+        return;
+    }
+    ASSERT(base_page + num_pages <= special_indices.size());
+
+    // Neighbouring pages almost always share their handlers, remember the last transform so each
+    // run of them is only transformed and interned once
+    u16 last_index = 0;
+    u16 last_result = 0;
+    bool has_last = false;
+    for (std::size_t page = base_page; page < base_page + num_pages; ++page) {
+        const u16 index = special_indices[page];
+        if (!has_last || index != last_index) {
+            std::vector<SpecialRegion> handlers = special_handlers[index];
+            func(handlers);
+            last_index = index;
+            last_result = InternSpecialHandlers(std::move(handlers));
+            has_last = true;
+        } else if (last_result != 0) {
+            ++special_handler_uses[last_result];
+        }
+        // The new set is referenced before the old one is released, so a set shared by both is
+        // never recycled while it is still in use
+        ReleaseSpecialHandlers(index);
+        special_indices[page] = last_result;
+    }
+}
+
+void PageTable::AddSpecialRegion(std::size_t base_page, std::size_t num_pages,
+                                 const SpecialRegion& region) {
+    if (special_indices.empty()) {
+        special_indices.resize(pointers.size());
+    }
+    TransformSpecialRegions(base_page, num_pages, [&region](std::vector<SpecialRegion>& handlers) {
+        const auto it = std::lower_bound(handlers.begin(), handlers.end(), region);
+        if (it == handlers.end() || !(*it == region)) {
+            handlers.insert(it, region);
+        }
+    });
+}
+
+void PageTable::RemoveSpecialRegion(std::size_t base_page, std::size_t num_pages,
+                                    const SpecialRegion& region) {
+    TransformSpecialRegions(base_page, num_pages, [&region](std::vector<SpecialRegion>& handlers) {
+        handlers.erase(std::remove(handlers.begin(), handlers.end(), region), handlers.end());
+    });
+}
+
+void PageTable::ClearSpecialRegions(std::size_t base_page, std::size_t num_pages) {
+    TransformSpecialRegions(base_page, num_pages,
+                            [](std::vector<SpecialRegion>& handlers) { handlers.clear(); });
+}
+
+void PageTable::ClearSpecialRegions() {
+    special_indices.clear();
+    special_indices.shrink_to_fit();
+    special_handlers.resize(1);
+    special_handler_uses.assign(1, 0);
+    free_special_handlers.clear();
+}
+
+u16 PageTable::InternSpecialHandlers(std::vector<SpecialRegion>&& handlers) {
+    if (handlers.empty()) {
+        return 0;
+    }
+    for (std::size_t index = 1; index < special_handlers.size(); ++index) {
+        if (special_handler_uses[index] != 0 && special_handlers[index] == handlers) {
+            ++special_handler_uses[index];
+            return static_cast<u16>(index);
+        }
+    }
+
+    u16 index;
+    if (!free_special_handlers.empty()) {
+        index = free_special_handlers.back();
+        free_special_handlers.pop_back();
+        special_handlers[index] = std::move(handlers);
+    } else {
+        ASSERT_MSG(special_handlers.size() <= std::numeric_limits<u16>::max(),
+                   "Too many distinct special region sets");
+        index = static_cast<u16>(special_handlers.size());
+        special_handlers.push_back(std::move(handlers));
+        special_handler_uses.push_back(0);
+    }
+    special_handler_uses[index] = 1;
+    return index;
+}
+
+void PageTable::ReleaseSpecialHandlers(u16 index) {
+    if (index == 0) {
+        return;
+    }
+    if (--special_handler_uses[index] == 0) {
+        special_handlers[index].clear();
+        free_special_handlers.push_back(index);
+    }
 }
 
 } // namespace Common
@@ -4,8 +4,8 @@
 
 #pragma once
 
+#include <tuple>
 #include <vector>
-#include <boost/icl/interval_map.hpp>
 #include "common/common_types.h"
 #include "common/memory_hook.h"
 
@@ -58,27 +58,75 @@ struct PageTable {
      */
     void Resize(std::size_t address_space_width_in_bits);
 
+    /// Adds a special region to the handlers of every page in the range.
+    void AddSpecialRegion(std::size_t base_page, std::size_t num_pages,
+                          const SpecialRegion& region);
+
+    /// Removes a special region from the handlers of every page in the range.
+    void RemoveSpecialRegion(std::size_t base_page, std::size_t num_pages,
+                             const SpecialRegion& region);
+
+    /// Removes all the special regions of every page in the range.
+    void ClearSpecialRegions(std::size_t base_page, std::size_t num_pages);
+
+    /// Removes all the special regions of the page table.
+    void ClearSpecialRegions();
+
+    /// Returns the special regions of a page, sorted and without duplicates.
+    const std::vector<SpecialRegion>& GetSpecialRegions(std::size_t page) const {
+        if (special_indices.empty()) {
+            return special_handlers.front();
+        }
+        return special_handlers[special_indices[page]];
+    }
+
     /**
      * Vector of memory pointers backing each page. An entry can only be non-null if the
      * corresponding entry in the `attributes` vector is of type `Memory`.
      */
     std::vector<u8*> pointers;
 
-    /**
-     * Contains MMIO handlers that back memory regions whose entries in the `attribute` vector is
-     * of type `Special`.
-     */
-    boost::icl::interval_map<u64, std::set<SpecialRegion>> special_regions;
-
     /**
      * Vector of fine grained page attributes. If it is set to any value other than `Memory`, then
      * the corresponding entry in `pointers` MUST be set to null.
      */
     std::vector<PageType> attributes;
 
-    std::vector<u64> backing_addr;
+    /**
+     * Vector of the host memory backing each page of type `Memory` or `RasterizerCachedMemory`.
+     * Unlike `pointers`, entries stay set while pages are cached by the rasterizer, so that the
+     * accesses taking the slow path find their memory without looking up the VMA.
+     */
+    std::vector<u8*> backing_pointers;
 
     const std::size_t page_size_in_bits{};
+
+private:
+    /// Replaces the handler set of every page in the range with the result of a transform.
+    template <typename Func>
+    void TransformSpecialRegions(std::size_t base_page, std::size_t num_pages, Func&& func);
+
+    /// Returns the index of a handler set, adding it if no page uses it yet.
+    u16 InternSpecialHandlers(std::vector<SpecialRegion>&& handlers);
+
+    /// Drops a page reference to a handler set, recycling its slot once no page uses it.
+    void ReleaseSpecialHandlers(u16 index);
+
+    /**
+     * Index into `special_handlers` of the MMIO handlers and debug hooks of each page, zero when
+     * the page has none. It is only allocated once the first special region is added, as most
+     * processes never map one.
+     */
+    std::vector<u16> special_indices;
+
+    /// Distinct handler sets used by the pages, the first one is always empty.
+    std::vector<std::vector<SpecialRegion>> special_handlers{1};
+
+    /// Number of pages using each handler set.
+    std::vector<std::size_t> special_handler_uses{0};
+
+    /// Slots of `special_handlers` no page uses anymore.
+    std::vector<u16> free_special_handlers;
 };
 
 } // namespace Common
@@ -0,0 +1,28 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace Common {
+
+/// Returns the nearest-rank percentile of count sorted samples, zero when there are none.
+inline double GetPercentile(const double* sorted, std::size_t count, double percentile) {
+    if (count == 0) {
+        return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(std::ceil(percentile * count));
+    return sorted[std::clamp<std::size_t>(index, 1, count) - 1];
+}
+
+/// Returns the nearest-rank percentile of sorted samples, zero when there are none.
+inline double GetPercentile(const std::vector<double>& sorted, double percentile) {
+    return GetPercentile(sorted.data(), sorted.size(), percentile);
+}
+
+} // namespace Common
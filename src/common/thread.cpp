@@ -3,6 +3,9 @@
 // Refer to the license.txt file included.
 
 #include "common/thread.h"
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #ifdef __APPLE__
 #include <mach/mach.h>
 #elif defined(_WIN32)
@@ -18,6 +21,12 @@
 #ifndef _WIN32
 #include <unistd.h>
 #endif
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
 
 #ifdef __FreeBSD__
 #define cpu_set_t cpuset_t
@@ -25,6 +34,115 @@
 
 namespace Common {
 
+namespace {
+
+/// Lets the other hardware thread of the core run while spinning.
+void SpinPause() {
+#ifdef ARCHITECTURE_x86_64
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+#ifdef _WIN32
+
+// Only defined by the Windows 10 1803 SDK onwards
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+/// Waitable timer of the calling thread, created on its first sleep.
+class SleepTimer {
+public:
+    SleepTimer() {
+        handle = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                        TIMER_ALL_ACCESS);
+        if (handle != nullptr) {
+            return;
+        }
+        // Windows before 10 1803 only has timers of the system timer resolution
+        high_resolution = false;
+        handle = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+    }
+
+    ~SleepTimer() {
+        if (handle != nullptr) {
+            CloseHandle(handle);
+        }
+    }
+
+    SleepTimer(const SleepTimer&) = delete;
+    SleepTimer& operator=(const SleepTimer&) = delete;
+
+    HANDLE handle;
+    bool high_resolution = true;
+};
+
+/// Sleeps until shortly before the deadline.
+void CoarseSleepUntil(std::chrono::steady_clock::time_point deadline) {
+    using namespace std::chrono_literals;
+    thread_local SleepTimer timer;
+
+    const auto margin = timer.high_resolution ? 1ms : 2ms;
+    const auto wake_up = deadline - margin;
+    const auto now = std::chrono::steady_clock::now();
+    if (wake_up <= now) {
+        return;
+    }
+    if (timer.handle == nullptr) {
+        std::this_thread::sleep_until(wake_up);
+        return;
+    }
+    // A negative due time is relative to the current time, in units of 100 ns
+    LARGE_INTEGER due_time;
+    const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(wake_up - now);
+    due_time.QuadPart = -remaining.count() / 100;
+    if (SetWaitableTimer(timer.handle, &due_time, 0, nullptr, nullptr, FALSE) != 0) {
+        WaitForSingleObject(timer.handle, INFINITE);
+    }
+}
+
+#elif defined(__linux__)
+
+/// Sleeps until shortly before the deadline.
+void CoarseSleepUntil(std::chrono::steady_clock::time_point deadline) {
+    // Covers the default timer slack of 50 us and the wake up latency of a loaded host
+    constexpr std::chrono::microseconds margin{200};
+
+    // The steady clock of the standard library is CLOCK_MONOTONIC on Linux
+    const auto wake_up = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        (deadline - margin).time_since_epoch());
+    if (wake_up.count() <= 0) {
+        return;
+    }
+    timespec request;
+    request.tv_sec = static_cast<time_t>(wake_up.count() / 1'000'000'000);
+    request.tv_nsec = static_cast<long>(wake_up.count() % 1'000'000'000);
+    // Absolute sleeps resume where they left off when a signal interrupts them
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &request, nullptr) == EINTR) {
+    }
+}
+
+#else
+
+/// Sleeps until shortly before the deadline.
+void CoarseSleepUntil(std::chrono::steady_clock::time_point deadline) {
+    constexpr std::chrono::milliseconds margin{1};
+    std::this_thread::sleep_until(deadline - margin);
+}
+
+#endif
+
+} // Anonymous namespace
+
+void PreciseSleepUntil(std::chrono::steady_clock::time_point deadline) {
+    CoarseSleepUntil(deadline);
+    while (std::chrono::steady_clock::now() < deadline) {
+        SpinPause();
+    }
+}
+
 #ifdef _MSC_VER
 
 // Sets the debugger-visible name of the current thread.
@@ -75,4 +193,75 @@ void SetCurrentThreadName(const char* name) {
 
 #endif
 
+#ifdef _WIN32
+
+bool SetCurrentThreadPriority(ThreadPriority priority) {
+    static constexpr int priorities[] = {THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL,
+                                         THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_HIGHEST};
+    return SetThreadPriority(GetCurrentThread(), priorities[static_cast<int>(priority)]) != 0;
+}
+
+bool SetCurrentThreadAffinity(const std::vector<u32>& processors) {
+    DWORD_PTR process_mask;
+    DWORD_PTR system_mask;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask) == 0) {
+        return false;
+    }
+    DWORD_PTR mask = processors.empty() ? process_mask : 0;
+    for (const u32 processor : processors) {
+        if (processor < sizeof(DWORD_PTR) * 8) {
+            mask |= DWORD_PTR{1} << processor;
+        }
+    }
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
+#elif defined(__linux__)
+
+bool SetCurrentThreadPriority(ThreadPriority priority) {
+    // Threads of the default policy are only ordered by their nice value, which is per thread
+    static constexpr int nice_values[] = {5, 0, -5, -10};
+    const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    return setpriority(PRIO_PROCESS, tid, nice_values[static_cast<int>(priority)]) == 0;
+}
+
+bool SetCurrentThreadAffinity(const std::vector<u32>& processors) {
+    // The processors the process may run on, the user may have restricted them. Read before any
+    // thread is restricted by this function.
+    static const cpu_set_t process_set = [] {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+            for (u32 i = 0; i < CPU_SETSIZE; ++i) {
+                CPU_SET(i, &set);
+            }
+        }
+        return set;
+    }();
+
+    cpu_set_t cpu_set = process_set;
+    if (!processors.empty()) {
+        CPU_ZERO(&cpu_set);
+    }
+    for (const u32 processor : processors) {
+        if (processor < CPU_SETSIZE) {
+            CPU_SET(processor, &cpu_set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+}
+
+#else
+
+bool SetCurrentThreadPriority(ThreadPriority priority) {
+    return false;
+}
+
+bool SetCurrentThreadAffinity(const std::vector<u32>& processors) {
+    // macOS only supports affinity tags, which are hints
+    return false;
+}
+
+#endif
+
 } // namespace Common
@@ -4,11 +4,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <mutex>
 #include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "common/thread_pool.h"
 
 namespace Common {
 
@@ -79,4 +84,57 @@ private:
 
 void SetCurrentThreadName(const char* name);
 
+enum class ThreadPriority {
+    Low,
+    Normal,
+    High,
+    VeryHigh,
+};
+
+/// Sets the scheduling priority of the calling thread. Returns false if the host refused it, on
+/// some hosts raising the priority above normal requires privileges.
+bool SetCurrentThreadPriority(ThreadPriority priority);
+
+/// Restricts the calling thread to the given logical processors of the host, all of them when
+/// empty. Returns false if the host does not support it or refused it.
+bool SetCurrentThreadAffinity(const std::vector<u32>& processors);
+
+/**
+ * Blocks the calling thread until the deadline, returning as close after it as the host allows.
+ * Sleeping alone regularly overshoots by up to a scheduler tick, so this sleeps on the finest timer
+ * of the host until shortly before the deadline and spins for the remainder.
+ */
+void PreciseSleepUntil(std::chrono::steady_clock::time_point deadline);
+
+/**
+ * Calls func(index) for every index in [0, count), spread over the calling thread and the workers
+ * of the shared thread pool, and returns once all the calls are done. Indices are handed out one
+ * at a time so the threads stay balanced when some calls take longer than others.
+ */
+template <typename Func>
+void ParallelFor(std::size_t count, Func&& func) {
+    std::atomic<std::size_t> next_index{0};
+    const auto worker = [&] {
+        std::size_t index;
+        while ((index = next_index.fetch_add(1, std::memory_order_relaxed)) < count) {
+            func(index);
+        }
+    };
+
+    if (count == 0) {
+        return;
+    }
+    ThreadPool& pool = GetThreadPool();
+    const std::size_t num_helpers = std::min(pool.GetNumActiveThreads(), count - 1);
+    std::vector<TaskHandle> helpers;
+    helpers.reserve(num_helpers);
+    for (std::size_t i = 0; i < num_helpers; ++i) {
+        helpers.push_back(pool.Submit(worker));
+    }
+    worker();
+    for (const auto& helper : helpers) {
+        helper.Wait();
+    }
+}
+
 } // namespace Common
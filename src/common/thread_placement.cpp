@@ -0,0 +1,282 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "common/logging/log.h"
+#include "common/param_package.h"
+#include "common/thread.h"
+#include "common/thread_placement.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace Common {
+
+namespace {
+
+enum class PlacementMode {
+    OS,
+    Dedicated,
+    Shared,
+};
+
+struct RolePlacement {
+    PlacementMode mode;
+    ThreadPriority priority;
+};
+
+constexpr std::size_t NUM_ROLES = 5;
+
+constexpr std::array<const char*, NUM_ROLES> ROLE_NAMES{"cpu", "gpu", "audio", "logging", "worker"};
+
+constexpr std::array<RolePlacement, NUM_ROLES> DEFAULT_PLACEMENTS{{
+    {PlacementMode::Dedicated, ThreadPriority::Normal}, // CpuCore
+    {PlacementMode::Dedicated, ThreadPriority::High},   // Gpu
+    {PlacementMode::Shared, ThreadPriority::High},      // Audio
+    {PlacementMode::Shared, ThreadPriority::Low},       // Logging
+    {PlacementMode::Shared, ThreadPriority::Low},       // Worker
+}};
+
+struct PlacementState {
+    std::mutex mutex;
+    bool is_configured = false;
+    std::array<RolePlacement, NUM_ROLES> roles{};
+    /// Processor of each thread of the dedicated roles, by role and index.
+    std::array<std::vector<u32>, NUM_ROLES> dedicated;
+    /// Processors the threads of the shared roles run on.
+    std::vector<u32> shared;
+};
+
+PlacementState state;
+std::atomic<u32> generation{0};
+thread_local u32 thread_generation = 0;
+
+PlacementMode ParseMode(const std::string& value, PlacementMode default_mode) {
+    if (value == "os") {
+        return PlacementMode::OS;
+    }
+    if (value == "dedicated") {
+        return PlacementMode::Dedicated;
+    }
+    if (value == "shared") {
+        return PlacementMode::Shared;
+    }
+    if (!value.empty()) {
+        LOG_WARNING(Common, "Unknown thread placement {}", value);
+    }
+    return default_mode;
+}
+
+ThreadPriority ParsePriority(const std::string& value, ThreadPriority default_priority) {
+    if (value == "low") {
+        return ThreadPriority::Low;
+    }
+    if (value == "normal") {
+        return ThreadPriority::Normal;
+    }
+    if (value == "high") {
+        return ThreadPriority::High;
+    }
+    if (value == "veryhigh") {
+        return ThreadPriority::VeryHigh;
+    }
+    if (!value.empty()) {
+        LOG_WARNING(Common, "Unknown thread priority {}", value);
+    }
+    return default_priority;
+}
+
+std::string FormatProcessors(const std::vector<u32>& processors) {
+    std::string out;
+    for (const u32 processor : processors) {
+        out += fmt::format("{}{}", out.empty() ? "" : " ", processor);
+    }
+    return out.empty() ? "none" : out;
+}
+
+} // Anonymous namespace
+
+std::vector<std::vector<u32>> GetHostCoreTopology() {
+    std::vector<std::vector<u32>> cores;
+#ifdef _WIN32
+    DWORD_PTR process_mask;
+    DWORD_PTR system_mask;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask) == 0) {
+        process_mask = ~DWORD_PTR{0};
+    }
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(
+        length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!infos.empty() && GetLogicalProcessorInformation(infos.data(), &length) != 0) {
+        for (const auto& info : infos) {
+            if (info.Relationship != RelationProcessorCore) {
+                continue;
+            }
+            std::vector<u32> processors;
+            for (u32 i = 0; i < sizeof(ULONG_PTR) * 8; ++i) {
+                if ((info.ProcessorMask & process_mask & (ULONG_PTR{1} << i)) != 0) {
+                    processors.push_back(i);
+                }
+            }
+            if (!processors.empty()) {
+                cores.push_back(std::move(processors));
+            }
+        }
+    }
+#elif defined(__linux__)
+    cpu_set_t cpu_set;
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+        // Logical processors are grouped by the package and the core they belong to
+        std::map<std::pair<int, int>, std::vector<u32>> core_map;
+        for (u32 i = 0; i < CPU_SETSIZE; ++i) {
+            if (!CPU_ISSET(i, &cpu_set)) {
+                continue;
+            }
+            const std::string path = fmt::format("/sys/devices/system/cpu/cpu{}/topology/", i);
+            int package = -1;
+            int core = static_cast<int>(i);
+            std::ifstream package_file{path + "physical_package_id"};
+            std::ifstream core_file{path + "core_id"};
+            if (package_file >> package && core_file >> core) {
+                core_map[{package, core}].push_back(i);
+            } else {
+                core_map[{-1, static_cast<int>(i)}].push_back(i);
+            }
+        }
+        for (auto& [id, processors] : core_map) {
+            cores.push_back(std::move(processors));
+        }
+    }
+#endif
+    if (cores.empty()) {
+        // Without topology each logical processor is taken for a core of its own
+        const u32 num_processors = std::max(std::thread::hardware_concurrency(), 1U);
+        for (u32 i = 0; i < num_processors; ++i) {
+            cores.push_back({i});
+        }
+    }
+    return cores;
+}
+
+void SetThreadPlacement(const std::string& config, std::size_t num_cpu_threads) {
+    const ParamPackage params{config};
+    const auto cores = GetHostCoreTopology();
+
+    std::array<RolePlacement, NUM_ROLES> roles;
+    const std::array<std::size_t, NUM_ROLES> num_dedicated{num_cpu_threads, 1, 1, 1, 0};
+    std::size_t total_dedicated = 0;
+    for (std::size_t i = 0; i < NUM_ROLES; ++i) {
+        const std::string name = ROLE_NAMES[i];
+        roles[i].mode = ParseMode(params.Get(name, ""), DEFAULT_PLACEMENTS[i].mode);
+        roles[i].priority =
+            ParsePriority(params.Get(name + "_priority", ""), DEFAULT_PLACEMENTS[i].priority);
+        if (roles[i].mode == PlacementMode::Dedicated && num_dedicated[i] == 0) {
+            // There are as many workers as logical processors, they can't have a core each
+            roles[i].mode = PlacementMode::Shared;
+        }
+        if (roles[i].mode == PlacementMode::Dedicated) {
+            total_dedicated += num_dedicated[i];
+        }
+    }
+
+    // One physical core is always left to the shared roles
+    if (total_dedicated + 1 > cores.size()) {
+        if (total_dedicated != 0) {
+            LOG_INFO(Common, "The host has {} cores, too few to dedicate {} to threads",
+                     cores.size(), total_dedicated);
+        }
+        for (auto& role : roles) {
+            if (role.mode == PlacementMode::Dedicated) {
+                role.mode = PlacementMode::OS;
+            }
+        }
+    }
+
+    // The first core is shared, it is the one most likely to handle the interrupts of the host
+    std::array<std::vector<u32>, NUM_ROLES> dedicated;
+    std::size_t next_core = 1;
+    for (std::size_t i = 0; i < NUM_ROLES; ++i) {
+        if (roles[i].mode != PlacementMode::Dedicated) {
+            continue;
+        }
+        for (std::size_t index = 0; index < num_dedicated[i]; ++index) {
+            dedicated[i].push_back(cores[next_core++].front());
+        }
+        LOG_INFO(Common, "Dedicated host processors of the {} threads: {}", ROLE_NAMES[i],
+                 FormatProcessors(dedicated[i]));
+    }
+    std::vector<u32> shared;
+    for (std::size_t core = 0; core < cores.size(); ++core) {
+        if (core == 0 || core >= next_core) {
+            shared.insert(shared.end(), cores[core].begin(), cores[core].end());
+        }
+    }
+    if (next_core > 1) {
+        LOG_INFO(Common, "Shared host processors: {}", FormatProcessors(shared));
+    }
+
+    // Nothing is logged with the lock held, the logging thread takes it to place itself
+    {
+        std::lock_guard lock{state.mutex};
+        state.roles = roles;
+        state.dedicated = std::move(dedicated);
+        state.shared = std::move(shared);
+        state.is_configured = true;
+    }
+    generation.fetch_add(1, std::memory_order_release);
+}
+
+void ApplyThreadPlacement(ThreadRole role, std::size_t index) {
+    std::vector<u32> processors;
+    ThreadPriority priority;
+    {
+        std::lock_guard lock{state.mutex};
+        thread_generation = generation.load(std::memory_order_acquire);
+        if (!state.is_configured) {
+            return;
+        }
+        const auto role_index = static_cast<std::size_t>(role);
+        const RolePlacement& placement = state.roles[role_index];
+        priority = placement.priority;
+        switch (placement.mode) {
+        case PlacementMode::OS:
+            break;
+        case PlacementMode::Dedicated:
+            // Threads past the ones that got a core, e.g. CPU cores added later, are shared
+            if (index < state.dedicated[role_index].size()) {
+                processors = {state.dedicated[role_index][index]};
+            } else {
+                processors = state.shared;
+            }
+            break;
+        case PlacementMode::Shared:
+            processors = state.shared;
+            break;
+        }
+    }
+    SetCurrentThreadAffinity(processors);
+    SetCurrentThreadPriority(priority);
+}
+
+void UpdateThreadPlacement(ThreadRole role, std::size_t index) {
+    if (thread_generation != generation.load(std::memory_order_acquire)) {
+        ApplyThreadPlacement(role, index);
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,50 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace Common {
+
+/// Role of a host thread of the emulator, each role is placed on the host cores the same way.
+enum class ThreadRole {
+    CpuCore, ///< Runs an emulated CPU core, the index is the one of the core.
+    Gpu,
+    Audio,
+    Logging,
+    Worker, ///< Worker of the shared thread pool.
+};
+
+/// Logical processors the process may run on, grouped by the physical core they belong to.
+std::vector<std::vector<u32>> GetHostCoreTopology();
+
+/**
+ * Sets how the threads of each role are placed on the host cores. Threads of a "dedicated" role
+ * get a physical core each, whose other logical processors are left idle so that no SMT sibling
+ * competes with them. Threads of a "shared" role run on the logical processors that are left,
+ * threads of an "os" role are left to the OS scheduler.
+ *
+ * The configuration is a ParamPackage string, e.g. "cpu:dedicated,gpu:dedicated,audio:shared,
+ * logging:shared,worker:shared,gpu_priority:high". Roles it omits keep their default: the CPU
+ * cores and the GPU are dedicated, everything else is shared. Dedicated roles fall back to the OS
+ * scheduler when the host does not have a physical core for each of them plus one to share.
+ *
+ * @param config Placement of each role.
+ * @param num_cpu_threads Number of host threads running emulated CPU cores.
+ */
+void SetThreadPlacement(const std::string& config, std::size_t num_cpu_threads);
+
+/// Places the calling thread as configured for its role.
+void ApplyThreadPlacement(ThreadRole role, std::size_t index = 0);
+
+/// Places the calling thread like ApplyThreadPlacement if the placement changed since the calling
+/// thread was last placed. Cheap enough for the loops of long lived threads to call it often.
+void UpdateThreadPlacement(ThreadRole role, std::size_t index = 0);
+
+} // namespace Common
@@ -0,0 +1,298 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <utility>
+
+#include "common/thread.h"
+#include "common/thread_placement.h"
+#include "common/thread_pool.h"
+
+namespace Common {
+
+struct TaskHandle::Task {
+    enum class State {
+        Pending, ///< Waiting for its parent to run.
+        Queued,
+        Running,
+        Done,
+    };
+
+    Task(ThreadPool& pool, ThreadPool::Work work, TaskPriority priority, State state)
+        : pool{pool}, work{std::move(work)}, priority{priority}, state{state} {}
+
+    /// Takes the task to run it, fails if it is not queued or another thread took it first.
+    bool Claim() {
+        State expected = State::Queued;
+        return state.compare_exchange_strong(expected, State::Running, std::memory_order_acquire);
+    }
+
+    ThreadPool& pool;
+    ThreadPool::Work work;
+    const TaskPriority priority;
+    std::atomic<State> state;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::shared_ptr<Task>> continuations;
+};
+
+namespace {
+
+constexpr std::size_t NO_WORKER = ~std::size_t{0};
+
+/// Pool and index of the worker running on the current thread, if any.
+thread_local ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_worker = NO_WORKER;
+
+} // Anonymous namespace
+
+TaskHandle::TaskHandle() = default;
+
+TaskHandle::TaskHandle(std::shared_ptr<Task> task) : task{std::move(task)} {}
+
+TaskHandle::~TaskHandle() = default;
+
+bool TaskHandle::IsDone() const {
+    return task == nullptr || task->state.load(std::memory_order_acquire) == Task::State::Done;
+}
+
+void TaskHandle::Wait() const {
+    if (task == nullptr) {
+        return;
+    }
+    ThreadPool& pool = task->pool;
+    const bool is_worker = current_pool == &pool;
+    while (true) {
+        // A task no worker has started yet runs on the waiting thread, so waiting never depends
+        // on what the workers are busy with
+        if (task->Claim()) {
+            pool.Run(task);
+            return;
+        }
+        if (IsDone()) {
+            return;
+        }
+        // Workers keep the pool going instead of sleeping, a task they wait on may need the
+        // tasks of their own queues to finish
+        if (is_worker && pool.TryRunTask()) {
+            continue;
+        }
+        std::unique_lock lock{task->mutex};
+        task->cv.wait(lock, [this] {
+            const auto state = task->state.load(std::memory_order_acquire);
+            return state == Task::State::Queued || state == Task::State::Done;
+        });
+    }
+}
+
+ThreadPool::ThreadPool(std::size_t num_threads)
+    : num_active{std::max<std::size_t>(num_threads, 1)} {
+    workers.resize(std::max<std::size_t>(num_threads, 1));
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        workers[i] = std::make_unique<Worker>();
+    }
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        workers[i]->thread = std::thread([this, i] { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock{sleep_mutex};
+        is_stopping = true;
+    }
+    sleep_cv.notify_all();
+    park_cv.notify_all();
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+
+    // Tasks still queued are run, something may be waiting on them
+    while (TryRunTask()) {
+    }
+}
+
+TaskHandle ThreadPool::Submit(Work work, TaskPriority priority) {
+    auto task = std::make_shared<TaskHandle::Task>(*this, std::move(work), priority,
+                                                   TaskHandle::Task::State::Queued);
+    Enqueue(task);
+    return TaskHandle{std::move(task)};
+}
+
+TaskHandle ThreadPool::Then(const TaskHandle& parent, Work work, TaskPriority priority) {
+    if (!parent.IsValid()) {
+        return Submit(std::move(work), priority);
+    }
+
+    auto task = std::make_shared<TaskHandle::Task>(*this, std::move(work), priority,
+                                                   TaskHandle::Task::State::Pending);
+    {
+        std::lock_guard lock{parent.task->mutex};
+        if (parent.task->state.load(std::memory_order_relaxed) != TaskHandle::Task::State::Done) {
+            parent.task->continuations.push_back(task);
+            return TaskHandle{std::move(task)};
+        }
+    }
+    task->state.store(TaskHandle::Task::State::Queued, std::memory_order_release);
+    Enqueue(task);
+    return TaskHandle{std::move(task)};
+}
+
+void ThreadPool::SetReservedThreads(std::size_t num_reserved) {
+    const std::size_t num_threads = workers.size();
+    num_active.store(num_threads > num_reserved ? num_threads - num_reserved : 1,
+                     std::memory_order_relaxed);
+    {
+        std::lock_guard lock{sleep_mutex};
+    }
+    sleep_cv.notify_all();
+    park_cv.notify_all();
+}
+
+bool ThreadPool::TryRunTask() {
+    const std::size_t worker_index = current_pool == this ? current_worker : NO_WORKER;
+    while (auto task = Dequeue(worker_index)) {
+        // Tasks run by the thread waiting on them are left in the queues, they are skipped
+        if (task->Claim()) {
+            Run(task);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::Enqueue(std::shared_ptr<TaskHandle::Task> task) {
+    const auto priority = static_cast<std::size_t>(task->priority);
+    if (current_pool == this) {
+        Worker& worker = *workers[current_worker];
+        std::lock_guard lock{worker.mutex};
+        worker.queues[priority].push_back(std::move(task));
+    } else {
+        std::lock_guard lock{shared_mutex};
+        shared_queues[priority].push_back(std::move(task));
+    }
+    num_queued.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders the increment with the check of a worker about to sleep
+    {
+        std::lock_guard lock{sleep_mutex};
+    }
+    sleep_cv.notify_one();
+}
+
+std::shared_ptr<TaskHandle::Task> ThreadPool::Dequeue(std::size_t worker_index) {
+    if (num_queued.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+
+    const auto pop = [this](std::mutex& mutex, auto& queue, bool newest) {
+        std::shared_ptr<TaskHandle::Task> task;
+        std::lock_guard lock{mutex};
+        if (!queue.empty()) {
+            if (newest) {
+                task = std::move(queue.back());
+                queue.pop_back();
+            } else {
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            num_queued.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return task;
+    };
+
+    for (std::size_t priority = 0; priority < shared_queues.size(); ++priority) {
+        // The newest task of the own queue is the most likely to have its data in the cache
+        if (worker_index != NO_WORKER) {
+            Worker& worker = *workers[worker_index];
+            if (auto task = pop(worker.mutex, worker.queues[priority], true)) {
+                return task;
+            }
+        }
+        if (auto task = pop(shared_mutex, shared_queues[priority], false)) {
+            return task;
+        }
+        // Steal the oldest task of another worker, starting from the next one to spread steals
+        const std::size_t start = worker_index == NO_WORKER ? 0 : worker_index + 1;
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            const std::size_t victim = (start + i) % workers.size();
+            if (victim == worker_index) {
+                continue;
+            }
+            Worker& worker = *workers[victim];
+            if (auto task = pop(worker.mutex, worker.queues[priority], false)) {
+                return task;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void ThreadPool::Run(const std::shared_ptr<TaskHandle::Task>& task) {
+    task->work();
+    task->work = nullptr;
+
+    std::vector<std::shared_ptr<TaskHandle::Task>> continuations;
+    {
+        std::lock_guard lock{task->mutex};
+        task->state.store(TaskHandle::Task::State::Done, std::memory_order_release);
+        continuations = std::move(task->continuations);
+    }
+    task->cv.notify_all();
+
+    for (auto& continuation : continuations) {
+        {
+            std::lock_guard lock{continuation->mutex};
+            continuation->state.store(TaskHandle::Task::State::Queued, std::memory_order_release);
+        }
+        continuation->cv.notify_all();
+        Enqueue(std::move(continuation));
+    }
+}
+
+void ThreadPool::WorkerLoop(std::size_t worker_index) {
+    SetCurrentThreadName("yuzu:Worker");
+    current_pool = this;
+    current_worker = worker_index;
+
+    const auto is_parked = [this, worker_index] {
+        return worker_index >= num_active.load(std::memory_order_relaxed);
+    };
+
+    while (true) {
+        UpdateThreadPlacement(ThreadRole::Worker);
+        if (is_parked()) {
+            std::unique_lock lock{sleep_mutex};
+            park_cv.wait(lock, [&] { return is_stopping || !is_parked(); });
+            if (is_stopping) {
+                return;
+            }
+            continue;
+        }
+        if (TryRunTask()) {
+            continue;
+        }
+
+        std::unique_lock lock{sleep_mutex};
+        sleep_cv.wait(lock, [&] {
+            return is_stopping || is_parked() ||
+                   num_queued.load(std::memory_order_acquire) != 0;
+        });
+        if (is_stopping) {
+            return;
+        }
+        if (is_parked()) {
+            // The wakeup may have been meant for a worker that runs tasks
+            sleep_cv.notify_one();
+        }
+    }
+}
+
+ThreadPool& GetThreadPool() {
+    static ThreadPool pool{std::thread::hardware_concurrency()};
+    return pool;
+}
+
+} // namespace Common
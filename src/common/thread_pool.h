@@ -0,0 +1,133 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Common {
+
+class ThreadPool;
+
+/// Order in which queued tasks are picked, tasks of a higher priority run first.
+enum class TaskPriority {
+    High,   ///< Work something is blocked on, e.g. a shader needed by the next draw.
+    Normal, ///< Work needed soon, e.g. decoding a texture.
+    Low,    ///< Work nothing waits for, e.g. filesystem readahead.
+};
+
+/// Handle to a task submitted to a ThreadPool. Copies refer to the same task.
+class TaskHandle {
+public:
+    TaskHandle();
+    ~TaskHandle();
+
+    /// Whether the handle refers to a task.
+    bool IsValid() const {
+        return task != nullptr;
+    }
+
+    /// Whether the task has run.
+    bool IsDone() const;
+
+    /// Blocks until the task has run. Queued tasks of the pool are run on the calling thread in
+    /// the meantime, so tasks can wait on the tasks they submit without starving the pool.
+    void Wait() const;
+
+private:
+    friend class ThreadPool;
+
+    struct Task;
+
+    explicit TaskHandle(std::shared_ptr<Task> task);
+
+    std::shared_ptr<Task> task;
+};
+
+/**
+ * Work-stealing pool of host threads shared by the subsystems for parallel work. Each worker has
+ * its own queues, tasks submitted from a worker go to them and the worker runs its newest task
+ * first, while idle workers steal the oldest tasks of the others. Tasks submitted from other
+ * threads go to a queue shared by the workers.
+ *
+ * Part of the workers can be parked so that the pool does not compete for host cores with the
+ * threads running emulation, see SetReservedThreads.
+ */
+class ThreadPool {
+public:
+    using Work = std::function<void()>;
+
+    /// Creates a pool with num_threads workers, at least one.
+    explicit ThreadPool(std::size_t num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Queues work to run on a worker.
+    TaskHandle Submit(Work work, TaskPriority priority = TaskPriority::Normal);
+
+    /// Queues work to run on a worker once another task has run.
+    TaskHandle Then(const TaskHandle& parent, Work work,
+                    TaskPriority priority = TaskPriority::Normal);
+
+    /**
+     * Lowers the number of workers that run tasks so that, together with the given number of host
+     * threads busy with emulation, the pool does not use more threads than the host has cores. At
+     * least one worker always runs.
+     */
+    void SetReservedThreads(std::size_t num_reserved);
+
+    /// Number of workers that run tasks.
+    std::size_t GetNumActiveThreads() const {
+        return num_active.load(std::memory_order_relaxed);
+    }
+
+    /// Runs a queued task on the calling thread, returns false if none was queued.
+    bool TryRunTask();
+
+private:
+    friend class TaskHandle;
+
+    using Queues = std::array<std::deque<std::shared_ptr<TaskHandle::Task>>, 3>;
+
+    struct Worker {
+        std::mutex mutex;
+        Queues queues;
+        std::thread thread;
+    };
+
+    void Enqueue(std::shared_ptr<TaskHandle::Task> task);
+    std::shared_ptr<TaskHandle::Task> Dequeue(std::size_t worker_index);
+    void Run(const std::shared_ptr<TaskHandle::Task>& task);
+    void WorkerLoop(std::size_t worker_index);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex shared_mutex;
+    Queues shared_queues;
+
+    /// Guards the sleep of idle workers.
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+    /// Wakes the workers parked by SetReservedThreads.
+    std::condition_variable park_cv;
+    std::atomic<std::size_t> num_queued{0};
+    std::atomic<std::size_t> num_active;
+    bool is_stopping = false;
+};
+
+/// Pool shared by all subsystems, it has one worker per host core.
+ThreadPool& GetThreadPool();
+
+} // namespace Common
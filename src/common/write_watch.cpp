@@ -0,0 +1,271 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <csignal>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "common/bounded_threadsafe_queue.h"
+#include "common/logging/log.h"
+#include "common/write_watch.h"
+
+namespace Common::WriteWatch {
+
+namespace {
+
+constexpr std::size_t PAGE_BITS = 12;
+static_assert(PAGE_SIZE == std::size_t{1} << PAGE_BITS);
+
+/// Bits of the host addresses that can be watched, enough for the user space of 64-bit hosts.
+constexpr std::size_t ADDRESS_BITS = 48;
+/// Bits of the page number that index the bitmap of a leaf.
+constexpr std::size_t LEAF_BITS = 18;
+constexpr std::size_t NUM_LEAVES = std::size_t{1} << (ADDRESS_BITS - PAGE_BITS - LEAF_BITS);
+constexpr std::size_t LEAF_WORDS = (std::size_t{1} << LEAF_BITS) / 64;
+
+/// Number of written pages recorded between two calls to TakeWrittenPages.
+constexpr std::size_t WRITTEN_PAGES_CAPACITY = 0x4000;
+
+/// Bitmap of the watched pages of a range of host memory.
+struct Leaf {
+    std::array<std::atomic<u64>, LEAF_WORDS> words{};
+};
+
+// The fault handler may run on any thread at any time, everything it touches is lock-free.
+std::array<std::atomic<Leaf*>, NUM_LEAVES> leaves{};
+std::atomic_flag protect_lock = ATOMIC_FLAG_INIT;
+BoundedMPSCQueue<u8*, WRITTEN_PAGES_CAPACITY> written_pages;
+std::atomic<bool> written_pages_lost{false};
+bool is_supported = false;
+
+/// Serializes the changes of protection with the updates of the bitmap.
+class ProtectLockGuard {
+public:
+    ProtectLockGuard() {
+        while (protect_lock.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+    ~ProtectLockGuard() {
+        protect_lock.clear(std::memory_order_release);
+    }
+};
+
+/// Returns the word of the bitmap that holds the bit of a page, or null if there's none.
+std::atomic<u64>* GetWord(const u8* page, bool create) {
+    const auto page_number = reinterpret_cast<std::uintptr_t>(page) >> PAGE_BITS;
+    const std::size_t leaf_index = page_number >> LEAF_BITS;
+    if (leaf_index >= NUM_LEAVES) {
+        return nullptr;
+    }
+    Leaf* leaf = leaves[leaf_index].load(std::memory_order_acquire);
+    if (leaf == nullptr) {
+        if (!create) {
+            return nullptr;
+        }
+        // Leaves are never released, the fault handler can read them at any time
+        Leaf* const new_leaf = new Leaf{};
+        if (leaves[leaf_index].compare_exchange_strong(leaf, new_leaf,
+                                                       std::memory_order_acq_rel)) {
+            leaf = new_leaf;
+        } else {
+            delete new_leaf;
+        }
+    }
+    const std::size_t bit = page_number & ((std::size_t{1} << LEAF_BITS) - 1);
+    return &leaf->words[bit / 64];
+}
+
+u64 GetMask(const u8* page) {
+    return u64{1} << ((reinterpret_cast<std::uintptr_t>(page) >> PAGE_BITS) % 64);
+}
+
+bool SetWritable(u8* page, bool writable) {
+#ifdef _WIN32
+    DWORD old_protect;
+    return VirtualProtect(page, PAGE_SIZE, writable ? PAGE_READWRITE : PAGE_READONLY,
+                          &old_protect) != 0;
+#else
+    return mprotect(page, PAGE_SIZE, writable ? PROT_READ | PROT_WRITE : PROT_READ) == 0;
+#endif
+}
+
+/**
+ * Handles a write fault, called from the fault handler.
+ * @returns True if the write can be retried, false if the fault isn't caused by a watch.
+ */
+bool HandleWriteFault(const void* address) {
+    // The last page retried by this thread without being watched, see below
+    static thread_local const u8* retried_page = nullptr;
+
+    const auto page = reinterpret_cast<u8*>(reinterpret_cast<std::uintptr_t>(address) &
+                                            ~static_cast<std::uintptr_t>(PAGE_SIZE - 1));
+    std::atomic<u64>* const word = GetWord(page, false);
+    if (word != nullptr) {
+        const u64 mask = GetMask(page);
+        ProtectLockGuard guard;
+        if ((word->fetch_and(~mask) & mask) != 0) {
+            SetWritable(page, true);
+            if (!written_pages.TryPush(page)) {
+                written_pages_lost.store(true, std::memory_order_release);
+            }
+            retried_page = nullptr;
+            return true;
+        }
+    }
+
+    // Another thread may have made the page writable between the fault and taking the lock, so
+    // retry once before treating it as a fault of someone else.
+    if (retried_page == page) {
+        retried_page = nullptr;
+        return false;
+    }
+    retried_page = page;
+    return true;
+}
+
+#ifdef _WIN32
+
+LONG NTAPI ExceptionHandler(PEXCEPTION_POINTERS pointers) {
+    const EXCEPTION_RECORD& record = *pointers->ExceptionRecord;
+    if (record.ExceptionCode != EXCEPTION_ACCESS_VIOLATION || record.NumberParameters < 2 ||
+        record.ExceptionInformation[0] != 1) {
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+    const auto address = reinterpret_cast<const void*>(record.ExceptionInformation[1]);
+    return HandleWriteFault(address) ? EXCEPTION_CONTINUE_EXECUTION : EXCEPTION_CONTINUE_SEARCH;
+}
+
+bool InstallHandler() {
+    return AddVectoredExceptionHandler(1, ExceptionHandler) != nullptr;
+}
+
+#else
+
+struct sigaction old_segv_action;
+#ifdef __APPLE__
+struct sigaction old_bus_action;
+#endif
+
+void SignalHandler(int sig, siginfo_t* info, void* raw_context) {
+    if (HandleWriteFault(info->si_addr)) {
+        return;
+    }
+#ifdef __APPLE__
+    const struct sigaction& old_action = sig == SIGBUS ? old_bus_action : old_segv_action;
+#else
+    const struct sigaction& old_action = old_segv_action;
+#endif
+    if ((old_action.sa_flags & SA_SIGINFO) != 0) {
+        old_action.sa_sigaction(sig, info, raw_context);
+        return;
+    }
+    if (old_action.sa_handler == SIG_DFL || old_action.sa_handler == SIG_IGN) {
+        // Returning retries the access, faulting again with the previous action in place
+        sigaction(sig, &old_action, nullptr);
+        return;
+    }
+    old_action.sa_handler(sig);
+}
+
+bool InstallHandler() {
+    struct sigaction action {};
+    action.sa_sigaction = SignalHandler;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+#ifdef __APPLE__
+    // Write faults on protected pages raise SIGBUS on macOS
+    if (sigaction(SIGBUS, &action, &old_bus_action) != 0) {
+        return false;
+    }
+#endif
+    return sigaction(SIGSEGV, &action, &old_segv_action) == 0;
+}
+
+#endif
+
+std::size_t GetHostPageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<std::size_t>(info.dwPageSize);
+#else
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+bool Install() {
+    if (sizeof(void*) != 8 || GetHostPageSize() != PAGE_SIZE) {
+        LOG_WARNING(Common_Memory, "Host pages are not supported, write watches are disabled");
+        return false;
+    }
+    if (!InstallHandler()) {
+        LOG_ERROR(Common_Memory, "Failed to install the fault handler of write watches");
+        return false;
+    }
+    is_supported = true;
+    return true;
+}
+
+} // Anonymous namespace
+
+bool Initialize() {
+    static const bool supported = Install();
+    return supported;
+}
+
+bool Watch(u8* page) {
+    if (!is_supported || (reinterpret_cast<std::uintptr_t>(page) & (PAGE_SIZE - 1)) != 0) {
+        return false;
+    }
+    std::atomic<u64>* const word = GetWord(page, true);
+    if (word == nullptr) {
+        return false;
+    }
+    const u64 mask = GetMask(page);
+    ProtectLockGuard guard;
+    if ((word->load(std::memory_order_relaxed) & mask) != 0) {
+        return true;
+    }
+    if (!SetWritable(page, false)) {
+        return false;
+    }
+    word->fetch_or(mask);
+    return true;
+}
+
+void Unwatch(u8* page) {
+    if (!is_supported) {
+        return;
+    }
+    std::atomic<u64>* const word = GetWord(page, false);
+    if (word == nullptr) {
+        return;
+    }
+    const u64 mask = GetMask(page);
+    ProtectLockGuard guard;
+    if ((word->load(std::memory_order_relaxed) & mask) == 0) {
+        return;
+    }
+    SetWritable(page, true);
+    word->fetch_and(~mask);
+}
+
+bool TakeWrittenPages(std::vector<u8*>& pages) {
+    const bool is_lost = written_pages_lost.exchange(false, std::memory_order_acquire);
+    u8* page;
+    while (written_pages.Pop(page)) {
+        pages.push_back(page);
+    }
+    return !is_lost;
+}
+
+} // namespace Common::WriteWatch
@@ -0,0 +1,47 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "common/common_types.h"
+
+/**
+ * Detects writes to host pages by write protecting them. The first write to a watched page is
+ * caught by a fault handler that makes the page writable again and records it, so each watch
+ * reports at most one write and the page has to be watched again to detect the next one.
+ * Watches are global to the process.
+ */
+namespace Common::WriteWatch {
+
+/// Size in bytes of the host pages watched, hosts with other page sizes are not supported.
+constexpr std::size_t PAGE_SIZE = 0x1000;
+
+/**
+ * Installs the fault handler, it's safe to call this more than once.
+ * @returns True if the host supports write watches.
+ */
+bool Initialize();
+
+/**
+ * Write protects a page to record the next write to it.
+ * @param page Page aligned pointer to the page.
+ * @returns True if the page is watched, false leaves the page untouched.
+ */
+bool Watch(u8* page);
+
+/// Stops watching a page and makes it writable again, does nothing if the page isn't watched.
+void Unwatch(u8* page);
+
+/**
+ * Appends the pages written since the last call to a list. Only one thread may call this.
+ * @param pages List that receives the pointers to the written pages.
+ * @returns False if too many pages were written to keep track of all of them, every page
+ *          watched since the last call has to be considered written then.
+ */
+bool TakeWrittenPages(std::vector<u8*>& pages);
+
+} // namespace Common::WriteWatch
@@ -54,6 +54,9 @@ public:
     /// Clear all instruction cache
     virtual void ClearInstructionCache() = 0;
 
+    /// Clears the instruction cache of the code in a range of memory, leaving the rest cached
+    virtual void InvalidateCacheRange(VAddr addr, std::size_t size) = 0;
+
     /// Notifies CPU emulation that the current page table has changed.
     ///
     /// @param new_page_table                 The new page table.
@@ -63,6 +66,9 @@ public:
     virtual void PageTableChanged(Common::PageTable& new_page_table,
                                   std::size_t new_address_space_size_in_bits) = 0;
 
+    /// Drops what CPU emulation keeps of a page table that is about to be destroyed or resized.
+    virtual void PageTableDestroyed(Common::PageTable& page_table) = 0;
+
     /**
      * Set the Program Counter to an address
      * @param addr Address to set PC to
@@ -147,6 +153,13 @@ public:
      */
     virtual void LoadContext(const ThreadContext& ctx) = 0;
 
+    /**
+     * Loads a CPU context except for its FP/SIMD registers, FPCR and FPSR, for when the CPU
+     * already holds them
+     * @param ctx Thread context to load
+     */
+    virtual void LoadIntegerContext(const ThreadContext& ctx) = 0;
+
     /// Clears the exclusive monitor's state.
     virtual void ClearExclusiveState() = 0;
 
@@ -18,6 +18,7 @@
 #include "core/hle/kernel/svc.h"
 #include "core/hle/kernel/vm_manager.h"
 #include "core/memory.h"
+#include "core/settings.h"
 
 namespace Core {
 
@@ -133,7 +134,7 @@ public:
     u64 tpidr_el0 = 0;
 };
 
-std::unique_ptr<Dynarmic::A64::Jit> ARM_Dynarmic::MakeJit(Common::PageTable& page_table,
+std::shared_ptr<Dynarmic::A64::Jit> ARM_Dynarmic::MakeJit(Common::PageTable& page_table,
                                                           std::size_t address_space_bits) const {
     Dynarmic::A64::UserConfig config;
 
@@ -141,6 +142,9 @@ std::unique_ptr<Dynarmic::A64::Jit> ARM_Dynarmic::MakeJit(Common::PageTable& pag
     config.callbacks = cb.get();
 
     // Memory
+    // The JIT inlines accesses to pages with a host pointer in the page table, only unmapped and
+    // rasterizer cached pages go through the memory callbacks. Reserving a host mirror of the
+    // guest address space (fastmem) would need fault handling support from dynarmic first.
     config.page_table = reinterpret_cast<void**>(page_table.pointers.data());
     config.page_table_address_space_bits = address_space_bits;
     config.silently_mirror_page_table = false;
@@ -159,7 +163,17 @@ std::unique_ptr<Dynarmic::A64::Jit> ARM_Dynarmic::MakeJit(Common::PageTable& pag
     // Unpredictable instructions
     config.define_unpredictable_behaviour = true;
 
-    return std::make_unique<Dynarmic::A64::Jit>(config);
+    // Accuracy
+    const Kernel::Process* const process = system.CurrentProcess();
+    const Settings::CpuAccuracy accuracy =
+        Settings::GetCpuAccuracy(process != nullptr ? process->GetTitleID() : 0);
+    if (accuracy == Settings::CpuAccuracy::Unsafe) {
+        // Addresses past the end of the address space wrap around in the page table instead of
+        // calling back. Null entries still call back, rasterizer cached pages depend on it.
+        config.silently_mirror_page_table = true;
+    }
+
+    return std::make_shared<Dynarmic::A64::Jit>(config);
 }
 
 MICROPROFILE_DEFINE(ARM_Jit_Dynarmic, "ARM JIT", "Dynarmic", MP_RGB(255, 64, 64));
@@ -168,6 +182,13 @@ void ARM_Dynarmic::Run() {
     MICROPROFILE_SCOPE(ARM_Jit_Dynarmic);
 
     jit->Run();
+
+    // Watchpoints halt the JIT from the memory access, the trap is sent once the block has ended
+    if (GDBStub::IsMemoryBreak()) {
+        Kernel::Thread* thread = Kernel::GetCurrentThread();
+        SaveContext(thread->GetContext());
+        GDBStub::SendTrap(thread, 5);
+    }
 }
 
 void ARM_Dynarmic::Step() {
@@ -251,13 +272,17 @@ void ARM_Dynarmic::SaveContext(ThreadContext& ctx) {
 }
 
 void ARM_Dynarmic::LoadContext(const ThreadContext& ctx) {
+    LoadIntegerContext(ctx);
+    jit->SetVectors(ctx.vector_registers);
+    jit->SetFpcr(ctx.fpcr);
+    jit->SetFpsr(ctx.fpsr);
+}
+
+void ARM_Dynarmic::LoadIntegerContext(const ThreadContext& ctx) {
     jit->SetRegisters(ctx.cpu_registers);
     jit->SetSP(ctx.sp);
     jit->SetPC(ctx.pc);
     jit->SetPstate(ctx.pstate);
-    jit->SetVectors(ctx.vector_registers);
-    jit->SetFpcr(ctx.fpcr);
-    jit->SetFpsr(ctx.fpsr);
     SetTPIDR_EL0(ctx.tpidr);
 }
 
@@ -266,7 +291,16 @@ void ARM_Dynarmic::PrepareReschedule() {
 }
 
 void ARM_Dynarmic::ClearInstructionCache() {
-    jit->ClearCache();
+    // The code of the other page tables may have changed as well
+    for (auto& [key, cached_jit] : jit_cache) {
+        cached_jit->ClearCache();
+    }
+}
+
+void ARM_Dynarmic::InvalidateCacheRange(VAddr addr, std::size_t size) {
+    for (auto& [key, cached_jit] : jit_cache) {
+        cached_jit->InvalidateCacheRange(addr, size);
+    }
 }
 
 void ARM_Dynarmic::ClearExclusiveState() {
@@ -275,7 +309,25 @@ void ARM_Dynarmic::ClearExclusiveState() {
 
 void ARM_Dynarmic::PageTableChanged(Common::PageTable& page_table,
                                     std::size_t new_address_space_size_in_bits) {
+    const JitCacheKey key{&page_table, new_address_space_size_in_bits};
+    const auto iter = jit_cache.find(key);
+    if (iter != jit_cache.end()) {
+        jit = iter->second;
+        return;
+    }
     jit = MakeJit(page_table, new_address_space_size_in_bits);
+    jit_cache.emplace(key, jit);
+}
+
+void ARM_Dynarmic::PageTableDestroyed(Common::PageTable& page_table) {
+    // The current JIT stays alive until the next page table change, it isn't run until then
+    for (auto iter = jit_cache.begin(); iter != jit_cache.end();) {
+        if (iter->first.first == &page_table) {
+            iter = jit_cache.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
 }
 
 DynarmicExclusiveMonitor::DynarmicExclusiveMonitor(std::size_t core_count) : monitor(core_count) {}
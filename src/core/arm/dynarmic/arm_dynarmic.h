@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <utility>
 #include <dynarmic/A64/a64.h>
 #include <dynarmic/A64/exclusive_monitor.h>
 #include "common/common_types.h"
@@ -43,21 +45,29 @@ public:
 
     void SaveContext(ThreadContext& ctx) override;
     void LoadContext(const ThreadContext& ctx) override;
+    void LoadIntegerContext(const ThreadContext& ctx) override;
 
     void PrepareReschedule() override;
     void ClearExclusiveState() override;
 
     void ClearInstructionCache() override;
+    void InvalidateCacheRange(VAddr addr, std::size_t size) override;
     void PageTableChanged(Common::PageTable& new_page_table,
                           std::size_t new_address_space_size_in_bits) override;
+    void PageTableDestroyed(Common::PageTable& page_table) override;
 
 private:
-    std::unique_ptr<Dynarmic::A64::Jit> MakeJit(Common::PageTable& page_table,
+    std::shared_ptr<Dynarmic::A64::Jit> MakeJit(Common::PageTable& page_table,
                                                 std::size_t address_space_bits) const;
 
+    using JitCacheKey = std::pair<Common::PageTable*, std::size_t>;
+    using JitCacheType = std::map<JitCacheKey, std::shared_ptr<Dynarmic::A64::Jit>>;
+
     friend class ARM_Dynarmic_Callbacks;
     std::unique_ptr<ARM_Dynarmic_Callbacks> cb;
-    std::unique_ptr<Dynarmic::A64::Jit> jit;
+    /// JITs of the page tables this core ran, switching back to one keeps its translated code.
+    JitCacheType jit_cache;
+    std::shared_ptr<Dynarmic::A64::Jit> jit;
     ARM_Unicorn inner_unicorn;
 
     std::size_t core_index;
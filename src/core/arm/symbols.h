@@ -0,0 +1,29 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Core::Symbols {
+
+struct Symbol {
+    std::string name;
+    /// Address of the symbol, relative to the start of its module.
+    u64 value;
+    u64 size;
+};
+
+using Symbols = std::vector<Symbol>;
+
+/// Reads the dynamic symbols of the loaded module whose text begins at text_offset.
+Symbols GetSymbols(VAddr text_offset);
+
+/// Returns the name of the symbol containing the module relative address, if any.
+std::optional<std::string> GetSymbolName(const Symbols& symbols, u64 func_address);
+
+} // namespace Core::Symbols
@@ -222,8 +222,21 @@ void ARM_Unicorn::SaveContext(ThreadContext& ctx) {
 }
 
 void ARM_Unicorn::LoadContext(const ThreadContext& ctx) {
+    LoadIntegerContext(ctx);
+
     int uregs[32];
     void* tregs[32];
+    for (auto i = 0; i < 32; ++i) {
+        uregs[i] = UC_ARM64_REG_Q0 + i;
+        tregs[i] = (void*)&ctx.vector_registers[i];
+    }
+
+    CHECKED(uc_reg_write_batch(uc, uregs, tregs, 32));
+}
+
+void ARM_Unicorn::LoadIntegerContext(const ThreadContext& ctx) {
+    int uregs[31];
+    void* tregs[31];
 
     CHECKED(uc_reg_write(uc, UC_ARM64_REG_SP, &ctx.sp));
     CHECKED(uc_reg_write(uc, UC_ARM64_REG_PC, &ctx.pc));
@@ -239,13 +252,6 @@ void ARM_Unicorn::LoadContext(const ThreadContext& ctx) {
     tregs[30] = (void*)&ctx.cpu_registers[30];
 
     CHECKED(uc_reg_write_batch(uc, uregs, tregs, 31));
-
-    for (auto i = 0; i < 32; ++i) {
-        uregs[i] = UC_ARM64_REG_Q0 + i;
-        tregs[i] = (void*)&ctx.vector_registers[i];
-    }
-
-    CHECKED(uc_reg_write_batch(uc, uregs, tregs, 32));
 }
 
 void ARM_Unicorn::PrepareReschedule() {
@@ -256,6 +262,8 @@ void ARM_Unicorn::ClearExclusiveState() {}
 
 void ARM_Unicorn::ClearInstructionCache() {}
 
+void ARM_Unicorn::InvalidateCacheRange(VAddr addr, std::size_t size) {}
+
 void ARM_Unicorn::RecordBreak(GDBStub::BreakpointAddress bkpt) {
     last_bkpt = bkpt;
     last_bkpt_hit = true;
@@ -35,13 +35,16 @@ public:
     u64 GetTPIDR_EL0() const override;
     void SaveContext(ThreadContext& ctx) override;
     void LoadContext(const ThreadContext& ctx) override;
+    void LoadIntegerContext(const ThreadContext& ctx) override;
     void PrepareReschedule() override;
     void ClearExclusiveState() override;
     void ExecuteInstructions(int num_instructions);
     void Run() override;
     void Step() override;
     void ClearInstructionCache() override;
+    void InvalidateCacheRange(VAddr addr, std::size_t size) override;
     void PageTableChanged(Common::PageTable&, std::size_t) override {}
+    void PageTableDestroyed(Common::PageTable&) override {}
     void RecordBreak(GDBStub::BreakpointAddress bkpt);
 
 private:
@@ -9,6 +9,7 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
 #include "core/arm/exclusive_monitor.h"
 #include "core/core.h"
 #include "core/core_cpu.h"
@@ -45,6 +46,8 @@
 #include "core/settings.h"
 #include "core/telemetry_session.h"
 #include "core/tools/freezer.h"
+#include "core/tools/ipc_trace.h"
+#include "core/tools/profiler.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/renderer_base.h"
 #include "video_core/video_core.h"
@@ -130,10 +133,16 @@ struct System::Impl {
     ResultStatus Init(System& system, Frontend::EmuWindow& emu_window) {
         LOG_DEBUG(HW_Memory, "initialized OK");
 
-        core_timing.Initialize();
+        core_timing.Initialize(Settings::values.use_host_timing);
         cpu_core_manager.Initialize();
         kernel.Initialize();
 
+        // The shared thread pool leaves the host cores that run the CPU cores and the GPU alone
+        const std::size_t num_cpu_threads = Settings::values.use_multi_core ? NUM_CPU_CORES : 1;
+        const std::size_t num_gpu_threads =
+            Settings::values.use_asynchronous_gpu_emulation ? 1 : 0;
+        Common::GetThreadPool().SetReservedThreads(num_cpu_threads + num_gpu_threads);
+
         const auto current_time = std::chrono::duration_cast<std::chrono::seconds>(
             std::chrono::system_clock::now().time_since_epoch());
         Settings::values.custom_rtc_differential =
@@ -202,6 +211,20 @@ struct System::Impl {
         AddGlueRegistrationForProcess(*app_loader, *main_process);
         kernel.MakeCurrentProcess(main_process.get());
 
+        // The CPU and GPU threads add their time to the performance statistics from the start
+        u64 title_id{0};
+        if (app_loader->ReadProgramId(title_id) != Loader::ResultStatus::Success) {
+            LOG_ERROR(Core, "Failed to find title id for ROM (Error {})",
+                      static_cast<u32>(load_result));
+        }
+        perf_stats = std::make_unique<PerfStats>(title_id);
+        if (Settings::values.record_guest_profile) {
+            profiler = std::make_unique<Tools::Profiler>(core_timing);
+        }
+        if (Settings::values.record_ipc_trace) {
+            ipc_trace = Tools::IpcTrace::CreateInLogDirectory(title_id);
+        }
+
         // Main process has been loaded and been made current.
         // Begin GPU and CPU execution.
         gpu_core->Start();
@@ -225,12 +248,6 @@ struct System::Impl {
             }
         }
 
-        u64 title_id{0};
-        if (app_loader->ReadProgramId(title_id) != Loader::ResultStatus::Success) {
-            LOG_ERROR(Core, "Failed to find title id for ROM (Error {})",
-                      static_cast<u32>(load_result));
-        }
-        perf_stats = std::make_unique<PerfStats>(title_id);
         // Reset counters and set time origin to current frame
         GetAndResetPerfStats();
         perf_stats->BeginSystemFrame();
@@ -239,6 +256,30 @@ struct System::Impl {
         return status;
     }
 
+    ResultStatus LoadWithoutApplication(System& system, Frontend::EmuWindow& emu_window) {
+        const ResultStatus init_result{Init(system, emu_window)};
+        if (init_result != ResultStatus::Success) {
+            LOG_CRITICAL(Core, "Failed to initialize system (Error {})!",
+                         static_cast<int>(init_result));
+            Shutdown();
+            return init_result;
+        }
+
+        // The process only provides the address space of the guest memory the GPU reads
+        auto process =
+            Kernel::Process::Create(system, "empty", Kernel::Process::ProcessType::Userland);
+        kernel.MakeCurrentProcess(process.get());
+
+        perf_stats = std::make_unique<PerfStats>(0);
+        gpu_core->Start();
+
+        GetAndResetPerfStats();
+        perf_stats->BeginSystemFrame();
+
+        status = ResultStatus::Success;
+        return status;
+    }
+
     void Shutdown() {
         // Log last frame performance stats if game was loded
         if (perf_stats) {
@@ -268,11 +309,20 @@ struct System::Impl {
         service_manager.reset();
         cheat_engine.reset();
         telemetry_session.reset();
-        perf_stats.reset();
         gpu_core.reset();
 
         // Close all CPU/threading state
         cpu_core_manager.Shutdown();
+        perf_stats.reset();
+
+        // The symbols are read from the guest memory, before the kernel frees it
+        if (profiler) {
+            u64 title_id{};
+            app_loader->ReadProgramId(title_id);
+            profiler->WriteToLogDirectory(title_id);
+            profiler.reset();
+        }
+        ipc_trace.reset();
 
         // Shutdown kernel and core timing
         kernel.Shutdown();
@@ -284,6 +334,8 @@ struct System::Impl {
         // Clear all applets
         applet_manager.ClearAll();
 
+        Common::GetThreadPool().SetReservedThreads(0);
+
         LOG_DEBUG(Core, "Shutdown OK");
     }
 
@@ -349,6 +401,8 @@ struct System::Impl {
     Reporter reporter;
     std::unique_ptr<Memory::CheatEngine> cheat_engine;
     std::unique_ptr<Tools::Freezer> memory_freezer;
+    std::unique_ptr<Tools::Profiler> profiler;
+    std::unique_ptr<Tools::IpcTrace> ipc_trace;
     std::array<u8, 0x20> build_id{};
 
     /// Frontend applets
@@ -397,10 +451,18 @@ void System::InvalidateCpuInstructionCaches() {
     impl->cpu_core_manager.InvalidateAllInstructionCaches();
 }
 
+void System::InvalidateCpuInstructionCacheRange(VAddr addr, std::size_t size) {
+    impl->cpu_core_manager.InvalidateInstructionCacheRange(addr, size);
+}
+
 System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::string& filepath) {
     return impl->Load(*this, emu_window, filepath);
 }
 
+System::ResultStatus System::LoadWithoutApplication(Frontend::EmuWindow& emu_window) {
+    return impl->LoadWithoutApplication(*this, emu_window);
+}
+
 bool System::IsPoweredOn() const {
     return impl->is_powered_on;
 }
@@ -578,6 +640,14 @@ Tegra::DebugContext* System::GetGPUDebugContext() const {
     return impl->debug_context.get();
 }
 
+Tools::Profiler* System::GetProfiler() const {
+    return impl->profiler.get();
+}
+
+Tools::IpcTrace* System::GetIpcTrace() const {
+    return impl->ipc_trace.get();
+}
+
 void System::SetFilesystem(std::shared_ptr<FileSys::VfsFilesystem> vfs) {
     impl->virtual_filesystem = std::move(vfs);
 }
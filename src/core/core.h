@@ -68,6 +68,11 @@ class ServiceManager;
 
 } // namespace Service
 
+namespace Tools {
+class IpcTrace;
+class Profiler;
+} // namespace Tools
+
 namespace Tegra {
 class DebugContext;
 class GPU;
@@ -150,13 +155,13 @@ public:
      */
     ResultStatus SingleStep();
 
-    /**
-     * Invalidate the CPU instruction caches
-     * This function should only be used by GDB Stub to support breakpoints, memory updates and
-     * step/continue commands.
-     */
+    /// Invalidate the CPU instruction caches
     void InvalidateCpuInstructionCaches();
 
+    /// Invalidates the code of a range of memory in the CPU instruction caches, for code that was
+    /// mapped, unmapped or patched.
+    void InvalidateCpuInstructionCacheRange(VAddr addr, std::size_t size);
+
     /// Shutdown the emulated system.
     void Shutdown();
 
@@ -169,6 +174,14 @@ public:
      */
     ResultStatus Load(Frontend::EmuWindow& emu_window, const std::string& filepath);
 
+    /**
+     * Initializes the emulated system with an empty process and starts the GPU, without loading
+     * an application or starting the CPU cores. Used to replay GPU captures.
+     * @param emu_window Reference to the host-system window used for video output.
+     * @returns ResultStatus code, indicating if the operation succeeded.
+     */
+    ResultStatus LoadWithoutApplication(Frontend::EmuWindow& emu_window);
+
     /**
      * Indicates if the emulated system is powered on (all subsystems initialized and able to run an
      * application).
@@ -300,6 +313,12 @@ public:
 
     Tegra::DebugContext* GetGPUDebugContext() const;
 
+    /// Provides the guest profiler, null unless the session records a guest profile.
+    Tools::Profiler* GetProfiler() const;
+
+    /// Provides the IPC trace, null unless the session records the requests to the HLE services.
+    Tools::IpcTrace* GetIpcTrace() const;
+
     void SetFilesystem(std::shared_ptr<FileSys::VfsFilesystem> vfs);
 
     std::shared_ptr<FileSys::VfsFilesystem> GetFilesystem() const;
@@ -14,10 +14,12 @@
 #include "core/core.h"
 #include "core/core_cpu.h"
 #include "core/core_timing.h"
+#include "core/perf_stats.h"
+#include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/scheduler.h"
 #include "core/hle/kernel/thread.h"
-#include "core/hle/lock.h"
 #include "core/settings.h"
+#include "core/tools/profiler.h"
 
 namespace Core {
 
@@ -52,7 +54,7 @@ bool CpuBarrier::Rendezvous() {
 
 Cpu::Cpu(System& system, ExclusiveMonitor& exclusive_monitor, CpuBarrier& cpu_barrier,
          std::size_t core_index)
-    : cpu_barrier{cpu_barrier}, global_scheduler{system.GlobalScheduler()},
+    : system{system}, cpu_barrier{cpu_barrier}, global_scheduler{system.GlobalScheduler()},
       core_timing{system.CoreTiming()}, core_index{core_index} {
 #ifdef ARCHITECTURE_x86_64
     arm_interface = std::make_unique<ARM_Dynarmic>(system, exclusive_monitor, core_index);
@@ -105,11 +107,21 @@ void Cpu::RunLoop(bool tight_loop) {
             tight_loop = false;
         }
 
+        const PerfTimer timer{system.GetPerfStats(),
+                              static_cast<PerfCategory>(
+                                  static_cast<std::size_t>(PerfCategory::CpuCore0) + core_index)};
+        Tools::Profiler* const profiler = system.GetProfiler();
+        const auto run_begin = profiler != nullptr ? Tools::Profiler::Clock::now()
+                                                   : Tools::Profiler::Clock::time_point{};
         if (tight_loop) {
             arm_interface->Run();
         } else {
             arm_interface->Step();
         }
+        if (profiler != nullptr) {
+            profiler->OnCoreSlice(core_index, *arm_interface,
+                                  Tools::Profiler::Clock::now() - run_begin);
+        }
     }
     core_timing.Advance();
 
@@ -126,7 +138,7 @@ void Cpu::PrepareReschedule() {
 
 void Cpu::Reschedule() {
     // Lock the global kernel mutex when we manipulate the HLE state
-    std::lock_guard lock(HLE::g_hle_lock);
+    std::lock_guard lock{system.Kernel().HLELock()};
 
     global_scheduler.SelectThread(core_index);
     scheduler->TryDoContextSwitch();
@@ -91,6 +91,7 @@ public:
 private:
     void Reschedule();
 
+    System& system;
     std::unique_ptr<ARM_Interface> arm_interface;
     CpuBarrier& cpu_barrier;
     Kernel::GlobalScheduler& global_scheduler;
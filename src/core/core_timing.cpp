@@ -11,12 +11,16 @@
 
 #include "common/assert.h"
 #include "common/thread.h"
+#include "common/uint128.h"
 #include "core/core_timing_util.h"
 
 namespace Core::Timing {
 
 constexpr int MAX_SLICE_LENGTH = 10000;
 
+/// Longest sleep of WaitForNextEvent, bounds the time to notice a shutdown with no events.
+constexpr std::chrono::milliseconds MAX_IDLE_WAIT{100};
+
 struct CoreTiming::Event {
     s64 time;
     u64 fifo_order;
@@ -37,7 +41,10 @@ struct CoreTiming::Event {
 CoreTiming::CoreTiming() = default;
 CoreTiming::~CoreTiming() = default;
 
-void CoreTiming::Initialize() {
+void CoreTiming::Initialize(bool use_host_timing) {
+    is_host_timing = use_host_timing;
+    host_epoch = std::chrono::steady_clock::now();
+
     downcounts.fill(MAX_SLICE_LENGTH);
     time_slice.fill(MAX_SLICE_LENGTH);
     slice_length = MAX_SLICE_LENGTH;
@@ -96,8 +103,28 @@ void CoreTiming::ScheduleEvent(s64 cycles_into_future, const EventType* event_ty
     std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
 }
 
+void CoreTiming::ScheduleEventThreadsafe(s64 cycles_into_future, const EventType* event_type,
+                                         u64 userdata) {
+    ASSERT(event_type != nullptr);
+    if (ts_queue.TryPush(ThreadsafeEvent{cycles_into_future, userdata, event_type})) {
+        // Pairs with WaitForNextEvent, either it sees the new count or this sees it waiting
+        posted_event_count.fetch_add(1);
+        if (is_waiting.load()) {
+            std::lock_guard guard{inner_mutex};
+            posted_event_cv.notify_one();
+        }
+        return;
+    }
+    // The cores haven't advanced in a long time, insert it directly
+    std::lock_guard guard{inner_mutex};
+    event_queue.emplace_back(
+        Event{global_timer + cycles_into_future, event_fifo_id++, userdata, event_type});
+    std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+}
+
 void CoreTiming::UnscheduleEvent(const EventType* event_type, u64 userdata) {
     std::lock_guard guard{inner_mutex};
+    MoveEvents();
     const auto itr = std::remove_if(event_queue.begin(), event_queue.end(), [&](const Event& e) {
         return e.type == event_type && e.userdata == userdata;
     });
@@ -110,6 +137,9 @@ void CoreTiming::UnscheduleEvent(const EventType* event_type, u64 userdata) {
 }
 
 u64 CoreTiming::GetTicks() const {
+    if (is_host_timing) {
+        return static_cast<u64>(GetHostTicks());
+    }
     u64 ticks = static_cast<u64>(global_timer);
     if (!is_global_timer_sane) {
         ticks += accumulated_ticks;
@@ -127,11 +157,23 @@ void CoreTiming::AddTicks(u64 ticks) {
 }
 
 void CoreTiming::ClearPendingEvents() {
+    std::lock_guard guard{inner_mutex};
+    MoveEvents();
     event_queue.clear();
 }
 
+void CoreTiming::MoveEvents() {
+    ThreadsafeEvent event;
+    while (ts_queue.Pop(event)) {
+        event_queue.emplace_back(Event{global_timer + event.cycles_into_future, event_fifo_id++,
+                                       event.userdata, event.type});
+        std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+    }
+}
+
 void CoreTiming::RemoveEvent(const EventType* event_type) {
     std::lock_guard guard{inner_mutex};
+    MoveEvents();
     const auto itr = std::remove_if(event_queue.begin(), event_queue.end(),
                                     [&](const Event& e) { return e.type == event_type; });
 
@@ -172,10 +214,16 @@ void CoreTiming::Advance() {
 
     const u64 cycles_executed = accumulated_ticks;
     time_slice[current_context] = std::max<s64>(0, time_slice[current_context] - accumulated_ticks);
-    global_timer += cycles_executed;
+    if (is_host_timing) {
+        global_timer = std::max(global_timer, GetHostTicks());
+    } else {
+        global_timer += cycles_executed;
+    }
 
     is_global_timer_sane = true;
 
+    MoveEvents();
+
     while (!event_queue.empty() && event_queue.front().time <= global_timer) {
         Event evt = std::move(event_queue.front());
         std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
@@ -223,6 +271,38 @@ void CoreTiming::Idle() {
     downcounts[current_context] = 0;
 }
 
+void CoreTiming::WaitForNextEvent() {
+    if (!is_host_timing) {
+        return;
+    }
+    std::unique_lock lock{inner_mutex};
+    const u64 posted_count = posted_event_count.load();
+    MoveEvents();
+
+    auto wait_time = std::chrono::duration_cast<std::chrono::nanoseconds>(MAX_IDLE_WAIT);
+    if (!event_queue.empty()) {
+        const s64 ticks_left = event_queue.front().time - GetHostTicks();
+        if (ticks_left <= 0) {
+            return;
+        }
+        // Rounded up, waking before the event is due would only spin again
+        wait_time = std::min(wait_time, CyclesToNs(ticks_left) + std::chrono::nanoseconds{1});
+    }
+
+    is_waiting.store(true);
+    posted_event_cv.wait_for(lock, wait_time,
+                             [&] { return posted_event_count.load() != posted_count; });
+    is_waiting.store(false);
+}
+
+s64 CoreTiming::GetHostTicks() const {
+    const auto elapsed = std::chrono::steady_clock::now() - host_epoch;
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    // Multiplied in 128 bits, the product overflows 64 bits after about nine seconds
+    const u128 product = Common::Multiply64Into128(static_cast<u64>(ns), BASE_CLOCK_RATE);
+    return static_cast<s64>(Common::Divide128On32(product, 1000000000).first);
+}
+
 std::chrono::microseconds CoreTiming::GetGlobalTimeUs() const {
     return std::chrono::microseconds{GetTicks() * 1000000 / BASE_CLOCK_RATE};
 }
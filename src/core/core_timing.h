@@ -4,15 +4,17 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "common/bounded_threadsafe_queue.h"
 #include "common/common_types.h"
-#include "common/threadsafe_queue.h"
 
 namespace Core::Timing {
 
@@ -52,7 +54,10 @@ public:
 
     /// CoreTiming begins at the boundary of timing slice -1. An initial call to Advance() is
     /// required to end slice - 1 and start slice 0 before the first cycle of code is executed.
-    void Initialize();
+    ///
+    /// @param use_host_timing When true, guest time follows the host clock instead of the
+    ///                        cycles executed by the cores, see IsHostTiming().
+    void Initialize(bool use_host_timing = false);
 
     /// Tears down all timing related functionality.
     void Shutdown();
@@ -78,6 +83,12 @@ public:
     /// Scheduling from a callback will not update the downcount until the Advance() completes.
     void ScheduleEvent(s64 cycles_into_future, const EventType* event_type, u64 userdata = 0);
 
+    /// Schedules an event from a host thread other than the emulated cores, e.g. the GPU thread,
+    /// without synchronizing with them. The event is queued until the next Advance(), its cycles
+    /// are counted from there.
+    void ScheduleEventThreadsafe(s64 cycles_into_future, const EventType* event_type,
+                                 u64 userdata = 0);
+
     void UnscheduleEvent(const EventType* event_type, u64 userdata);
 
     /// We only permit one event of each type in the queue at a time.
@@ -103,6 +114,16 @@ public:
     /// Pretend that the main CPU has executed enough cycles to reach the next event.
     void Idle();
 
+    /// Returns true if guest time is derived from the host clock. Cycles executed by the cores
+    /// then only split the slices between them, and events fire once their host time is reached.
+    bool IsHostTiming() const {
+        return is_host_timing;
+    }
+
+    /// With host timing, sleeps until the next event is due or one is posted from another
+    /// thread. Meant to be called when no core has a thread to run. Does nothing otherwise.
+    void WaitForNextEvent();
+
     std::chrono::microseconds GetGlobalTimeUs() const;
 
     void ResetRun();
@@ -122,9 +143,22 @@ public:
 private:
     struct Event;
 
+    /// Event posted by ScheduleEventThreadsafe, not yet in the queue.
+    struct ThreadsafeEvent {
+        s64 cycles_into_future;
+        u64 userdata;
+        const EventType* type;
+    };
+
     /// Clear all pending events. This should ONLY be done on exit.
     void ClearPendingEvents();
 
+    /// Moves the events posted from other threads to the queue, must hold inner_mutex.
+    void MoveEvents();
+
+    /// Returns the guest ticks elapsed on the host clock since Initialize().
+    s64 GetHostTicks() const;
+
     static constexpr u64 num_cpu_cores = 4;
 
     s64 global_timer = 0;
@@ -148,12 +182,23 @@ private:
     std::vector<Event> event_queue;
     u64 event_fifo_id = 0;
 
+    /// Events posted from other threads, only popped while holding inner_mutex.
+    Common::BoundedMPSCQueue<ThreadsafeEvent, 1024> ts_queue;
+
     // Stores each element separately as a linked list node so pointers to elements
     // remain stable regardless of rehashes/resizing.
     std::unordered_map<std::string, EventType> event_types;
 
     EventType* ev_lost = nullptr;
 
+    bool is_host_timing = false;
+    std::chrono::steady_clock::time_point host_epoch;
+
+    // Wakes WaitForNextEvent when events are posted by other threads
+    std::condition_variable posted_event_cv;
+    std::atomic<u64> posted_event_count{0};
+    std::atomic<bool> is_waiting{false};
+
     std::mutex inner_mutex;
 };
 
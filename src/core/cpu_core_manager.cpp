@@ -2,18 +2,27 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "common/assert.h"
+#include "common/thread_placement.h"
 #include "core/arm/exclusive_monitor.h"
 #include "core/core.h"
 #include "core/core_cpu.h"
 #include "core/core_timing.h"
 #include "core/cpu_core_manager.h"
 #include "core/gdbstub/gdbstub.h"
+#include "core/hle/kernel/scheduler.h"
 #include "core/settings.h"
 
 namespace Core {
 namespace {
+/// Core driven by the calling host thread in multicore mode, only set on CPU threads.
+thread_local Cpu* current_thread_core = nullptr;
+
 void RunCpuCore(const System& system, Cpu& cpu_state) {
+    current_thread_core = &cpu_state;
+    Common::ApplyThreadPlacement(Common::ThreadRole::CpuCore, cpu_state.CoreIndex());
     while (system.IsPoweredOn()) {
         cpu_state.RunLoop(true);
     }
@@ -33,9 +42,9 @@ void CpuCoreManager::Initialize() {
 }
 
 void CpuCoreManager::StartThreads() {
-    // Create threads for CPU cores 1-3, and build thread_to_cpu map
-    // CPU core 0 is run on the main thread
-    thread_to_cpu[std::this_thread::get_id()] = cores[0].get();
+    // Create threads for CPU cores 1-3, CPU core 0 is run on the main thread
+    current_thread_core = cores[0].get();
+    Common::ApplyThreadPlacement(Common::ThreadRole::CpuCore, 0);
     if (!Settings::values.use_multi_core) {
         return;
     }
@@ -43,7 +52,6 @@ void CpuCoreManager::StartThreads() {
     for (std::size_t index = 0; index < core_threads.size(); ++index) {
         core_threads[index] = std::make_unique<std::thread>(RunCpuCore, std::cref(system),
                                                             std::ref(*cores[index + 1]));
-        thread_to_cpu[core_threads[index]->get_id()] = cores[index + 1].get();
     }
 }
 
@@ -56,7 +64,7 @@ void CpuCoreManager::Shutdown() {
         }
     }
 
-    thread_to_cpu.clear();
+    current_thread_core = nullptr;
     for (auto& cpu_core : cores) {
         cpu_core->Shutdown();
         cpu_core.reset();
@@ -84,10 +92,8 @@ const ExclusiveMonitor& CpuCoreManager::GetExclusiveMonitor() const {
 
 Cpu& CpuCoreManager::GetCurrentCore() {
     if (Settings::values.use_multi_core) {
-        const auto& search = thread_to_cpu.find(std::this_thread::get_id());
-        ASSERT(search != thread_to_cpu.end());
-        ASSERT(search->second);
-        return *search->second;
+        ASSERT(current_thread_core != nullptr);
+        return *current_thread_core;
     }
 
     // Otherwise, use single-threaded mode active_core variable
@@ -96,10 +102,8 @@ Cpu& CpuCoreManager::GetCurrentCore() {
 
 const Cpu& CpuCoreManager::GetCurrentCore() const {
     if (Settings::values.use_multi_core) {
-        const auto& search = thread_to_cpu.find(std::this_thread::get_id());
-        ASSERT(search != thread_to_cpu.end());
-        ASSERT(search->second);
-        return *search->second;
+        ASSERT(current_thread_core != nullptr);
+        return *current_thread_core;
     }
 
     // Otherwise, use single-threaded mode active_core variable
@@ -107,13 +111,22 @@ const Cpu& CpuCoreManager::GetCurrentCore() const {
 }
 
 void CpuCoreManager::RunLoop(bool tight_loop) {
-    // Update thread_to_cpu in case Core 0 is run from a different host thread
-    thread_to_cpu[std::this_thread::get_id()] = cores[0].get();
+    // Update the current core in case Core 0 is run from a different host thread
+    current_thread_core = cores[0].get();
 
     GDBStub::HandlePacket();
 
     auto& core_timing = system.CoreTiming();
     core_timing.ResetRun();
+    if (Settings::values.use_multi_core) {
+        // Cores 1-3 are driven by their own host threads, running them here as well would make
+        // them enter the barrier twice per slice
+        active_core = 0;
+        core_timing.SwitchContext(active_core);
+        cores[active_core]->RunLoop(tight_loop);
+        return;
+    }
+
     bool keep_running{};
     do {
         keep_running = false;
@@ -127,6 +140,17 @@ void CpuCoreManager::RunLoop(bool tight_loop) {
             }
         }
     } while (keep_running);
+
+    if (!core_timing.IsHostTiming()) {
+        return;
+    }
+    // Nothing happens until the next event when all cores are idle, sleep instead of spinning
+    const bool all_cores_idle = std::all_of(cores.begin(), cores.end(), [](const auto& core) {
+        return core->Scheduler().GetCurrentThread() == nullptr;
+    });
+    if (all_cores_idle) {
+        core_timing.WaitForNextEvent();
+    }
 }
 
 void CpuCoreManager::InvalidateAllInstructionCaches() {
@@ -135,4 +159,10 @@ void CpuCoreManager::InvalidateAllInstructionCaches() {
     }
 }
 
+void CpuCoreManager::InvalidateInstructionCacheRange(VAddr addr, std::size_t size) {
+    for (auto& cpu : cores) {
+        cpu->ArmInterface().InvalidateCacheRange(addr, size);
+    }
+}
+
 } // namespace Core
@@ -5,7 +5,6 @@
 #pragma once
 
 #include <array>
-#include <map>
 #include <memory>
 #include <thread>
 
@@ -43,6 +42,7 @@ public:
     void RunLoop(bool tight_loop);
 
     void InvalidateAllInstructionCaches();
+    void InvalidateInstructionCacheRange(VAddr addr, std::size_t size);
 
 private:
     static constexpr std::size_t NUM_CPU_CORES = 4;
@@ -53,9 +53,6 @@ private:
     std::array<std::unique_ptr<std::thread>, NUM_CPU_CORES - 1> core_threads;
     std::size_t active_core{}; ///< Active core, only used in single thread mode
 
-    /// Map of guest threads to CPU cores
-    std::map<std::thread::id, Cpu*> thread_to_cpu;
-
     System& system;
 };
 
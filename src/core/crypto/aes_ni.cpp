@@ -0,0 +1,290 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/assert.h"
+#include "core/crypto/aes_ni.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include <immintrin.h>
+#include "common/x64/cpu_detect.h"
+#endif
+
+namespace Core::Crypto::AESNI {
+
+#ifdef ARCHITECTURE_x86_64
+
+// The rest of the build targets plain x86-64, only these functions use the AES instructions
+#if defined(__GNUC__) || defined(__clang__)
+#define AESNI_TARGET __attribute__((target("aes,ssse3")))
+#else
+#define AESNI_TARGET
+#endif
+
+namespace {
+
+/// Number of blocks in flight, enough to hide the latency of the AES round instructions.
+constexpr std::size_t NUM_LANES = 8;
+constexpr std::size_t NUM_ROUNDS = 10;
+constexpr std::size_t BLOCK_SIZE = 16;
+
+struct RoundKeys {
+    const __m128i& operator[](std::size_t round) const {
+        return keys[round];
+    }
+
+    __m128i keys[NUM_ROUNDS + 1];
+};
+
+AESNI_TARGET RoundKeys LoadRoundKeys(const std::array<std::array<u8, 16>, 11>& keys) {
+    RoundKeys round_keys;
+    for (std::size_t i = 0; i <= NUM_ROUNDS; ++i) {
+        round_keys.keys[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(keys[i].data()));
+    }
+    return round_keys;
+}
+
+template <int rcon>
+AESNI_TARGET __m128i ExpandStep(__m128i key) {
+    const __m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, rcon), 0xff);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+AESNI_TARGET __m128i EncryptBlock(const RoundKeys& keys, __m128i block) {
+    block = _mm_xor_si128(block, keys[0]);
+    for (std::size_t round = 1; round < NUM_ROUNDS; ++round) {
+        block = _mm_aesenc_si128(block, keys[round]);
+    }
+    return _mm_aesenclast_si128(block, keys[NUM_ROUNDS]);
+}
+
+AESNI_TARGET __m128i DecryptBlock(const RoundKeys& keys, __m128i block) {
+    block = _mm_xor_si128(block, keys[0]);
+    for (std::size_t round = 1; round < NUM_ROUNDS; ++round) {
+        block = _mm_aesdec_si128(block, keys[round]);
+    }
+    return _mm_aesdeclast_si128(block, keys[NUM_ROUNDS]);
+}
+
+/// Runs every round on all the lanes before the next one, the lanes are independent.
+AESNI_TARGET void EncryptLanes(const RoundKeys& keys, __m128i (&blocks)[NUM_LANES]) {
+    for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+        blocks[lane] = _mm_xor_si128(blocks[lane], keys[0]);
+    }
+    for (std::size_t round = 1; round < NUM_ROUNDS; ++round) {
+        for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+            blocks[lane] = _mm_aesenc_si128(blocks[lane], keys[round]);
+        }
+    }
+    for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+        blocks[lane] = _mm_aesenclast_si128(blocks[lane], keys[NUM_ROUNDS]);
+    }
+}
+
+AESNI_TARGET void DecryptLanes(const RoundKeys& keys, __m128i (&blocks)[NUM_LANES]) {
+    for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+        blocks[lane] = _mm_xor_si128(blocks[lane], keys[0]);
+    }
+    for (std::size_t round = 1; round < NUM_ROUNDS; ++round) {
+        for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+            blocks[lane] = _mm_aesdec_si128(blocks[lane], keys[round]);
+        }
+    }
+    for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+        blocks[lane] = _mm_aesdeclast_si128(blocks[lane], keys[NUM_ROUNDS]);
+    }
+}
+
+AESNI_TARGET __m128i Load(const u8* src) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+AESNI_TARGET void Store(u8* dest, __m128i block) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), block);
+}
+
+AESNI_TARGET __m128i ByteSwap(__m128i value) {
+    return _mm_shuffle_epi8(value,
+                            _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+/// Returns the big-endian counter block of a 128-bit counter.
+AESNI_TARGET __m128i MakeCounter(u64 high, u64 low) {
+    return ByteSwap(_mm_set_epi64x(static_cast<s64>(high), static_cast<s64>(low)));
+}
+
+/// Returns the current counter block and increments the counter.
+AESNI_TARGET __m128i NextCounter(u64& high, u64& low) {
+    const __m128i block = MakeCounter(high, low);
+    if (++low == 0) {
+        ++high;
+    }
+    return block;
+}
+
+/// Multiplies an XTS tweak by the primitive element of GF(2^128), x^128 + x^7 + x^2 + x + 1.
+AESNI_TARGET __m128i MultiplyTweak(__m128i tweak) {
+    // The top bit of each dword moves to the next one, the top bit of the tweak folds back
+    const __m128i carries = _mm_and_si128(_mm_srai_epi32(tweak, 31), _mm_set_epi32(0x87, 1, 1, 1));
+    return _mm_xor_si128(_mm_slli_epi32(tweak, 1), _mm_shuffle_epi32(carries, 0x93));
+}
+
+} // Anonymous namespace
+
+bool IsSupported() {
+    return Common::GetCPUCaps().aes && Common::GetCPUCaps().ssse3;
+}
+
+AESNI_TARGET void ExpandKey(const u8* key, KeySchedule& schedule) {
+    __m128i keys[NUM_ROUNDS + 1];
+    keys[0] = Load(key);
+    keys[1] = ExpandStep<0x01>(keys[0]);
+    keys[2] = ExpandStep<0x02>(keys[1]);
+    keys[3] = ExpandStep<0x04>(keys[2]);
+    keys[4] = ExpandStep<0x08>(keys[3]);
+    keys[5] = ExpandStep<0x10>(keys[4]);
+    keys[6] = ExpandStep<0x20>(keys[5]);
+    keys[7] = ExpandStep<0x40>(keys[6]);
+    keys[8] = ExpandStep<0x80>(keys[7]);
+    keys[9] = ExpandStep<0x1b>(keys[8]);
+    keys[10] = ExpandStep<0x36>(keys[9]);
+
+    for (std::size_t i = 0; i <= NUM_ROUNDS; ++i) {
+        Store(schedule.encrypt[i].data(), keys[i]);
+    }
+    // The equivalent inverse cipher uses the round keys backwards, mixed by InvMixColumns
+    Store(schedule.decrypt[0].data(), keys[NUM_ROUNDS]);
+    for (std::size_t i = 1; i < NUM_ROUNDS; ++i) {
+        Store(schedule.decrypt[i].data(), _mm_aesimc_si128(keys[NUM_ROUNDS - i]));
+    }
+    Store(schedule.decrypt[NUM_ROUNDS].data(), keys[0]);
+}
+
+AESNI_TARGET void TranscodeECB(const KeySchedule& schedule, const u8* src, std::size_t size,
+                               u8* dest, bool encrypt) {
+    ASSERT(size % BLOCK_SIZE == 0);
+    const RoundKeys keys = LoadRoundKeys(encrypt ? schedule.encrypt : schedule.decrypt);
+
+    std::size_t offset = 0;
+    for (; offset + NUM_LANES * BLOCK_SIZE <= size; offset += NUM_LANES * BLOCK_SIZE) {
+        __m128i blocks[NUM_LANES];
+        for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+            blocks[lane] = Load(src + offset + lane * BLOCK_SIZE);
+        }
+        if (encrypt) {
+            EncryptLanes(keys, blocks);
+        } else {
+            DecryptLanes(keys, blocks);
+        }
+        for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+            Store(dest + offset + lane * BLOCK_SIZE, blocks[lane]);
+        }
+    }
+    for (; offset < size; offset += BLOCK_SIZE) {
+        const __m128i block = Load(src + offset);
+        Store(dest + offset, encrypt ? EncryptBlock(keys, block) : DecryptBlock(keys, block));
+    }
+}
+
+AESNI_TARGET void TranscodeCTR(const KeySchedule& schedule, const u8* src, std::size_t size,
+                               u8* dest, std::array<u8, 16>& counter) {
+    const RoundKeys keys = LoadRoundKeys(schedule.encrypt);
+    // The counter is incremented as two native halves, byte swapped into each block
+    const __m128i swapped = ByteSwap(Load(counter.data()));
+    u64 low = static_cast<u64>(_mm_cvtsi128_si64(swapped));
+    u64 high = static_cast<u64>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(swapped, swapped)));
+
+    std::size_t offset = 0;
+    for (; offset + NUM_LANES * BLOCK_SIZE <= size; offset += NUM_LANES * BLOCK_SIZE) {
+        __m128i blocks[NUM_LANES];
+        for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+            blocks[lane] = NextCounter(high, low);
+        }
+        EncryptLanes(keys, blocks);
+        for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+            const std::size_t lane_offset = offset + lane * BLOCK_SIZE;
+            Store(dest + lane_offset, _mm_xor_si128(blocks[lane], Load(src + lane_offset)));
+        }
+    }
+    for (; offset + BLOCK_SIZE <= size; offset += BLOCK_SIZE) {
+        const __m128i key_stream = EncryptBlock(keys, NextCounter(high, low));
+        Store(dest + offset, _mm_xor_si128(key_stream, Load(src + offset)));
+    }
+    if (offset < size) {
+        // The last block is partial, the rest of its key stream is dropped
+        alignas(16) std::array<u8, BLOCK_SIZE> key_stream;
+        Store(key_stream.data(), EncryptBlock(keys, NextCounter(high, low)));
+        for (std::size_t i = 0; offset + i < size; ++i) {
+            dest[offset + i] = src[offset + i] ^ key_stream[i];
+        }
+    }
+
+    Store(counter.data(), MakeCounter(high, low));
+}
+
+AESNI_TARGET void TranscodeXTS(const KeySchedule& data_key, const KeySchedule& tweak_key,
+                               const u8* src, std::size_t size, u8* dest,
+                               const std::array<u8, 16>& tweak_input, bool encrypt) {
+    ASSERT(size % BLOCK_SIZE == 0);
+    const RoundKeys keys = LoadRoundKeys(encrypt ? data_key.encrypt : data_key.decrypt);
+    __m128i tweak = EncryptBlock(LoadRoundKeys(tweak_key.encrypt), Load(tweak_input.data()));
+
+    std::size_t offset = 0;
+    for (; offset + NUM_LANES * BLOCK_SIZE <= size; offset += NUM_LANES * BLOCK_SIZE) {
+        __m128i tweaks[NUM_LANES];
+        __m128i blocks[NUM_LANES];
+        for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+            tweaks[lane] = tweak;
+            tweak = MultiplyTweak(tweak);
+            blocks[lane] = _mm_xor_si128(Load(src + offset + lane * BLOCK_SIZE), tweaks[lane]);
+        }
+        if (encrypt) {
+            EncryptLanes(keys, blocks);
+        } else {
+            DecryptLanes(keys, blocks);
+        }
+        for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+            Store(dest + offset + lane * BLOCK_SIZE, _mm_xor_si128(blocks[lane], tweaks[lane]));
+        }
+    }
+    for (; offset < size; offset += BLOCK_SIZE) {
+        const __m128i block = _mm_xor_si128(Load(src + offset), tweak);
+        const __m128i result = encrypt ? EncryptBlock(keys, block) : DecryptBlock(keys, block);
+        Store(dest + offset, _mm_xor_si128(result, tweak));
+        tweak = MultiplyTweak(tweak);
+    }
+}
+
+#undef AESNI_TARGET
+
+#else
+
+bool IsSupported() {
+    return false;
+}
+
+void ExpandKey(const u8* key, KeySchedule& schedule) {
+    UNREACHABLE();
+}
+
+void TranscodeECB(const KeySchedule& schedule, const u8* src, std::size_t size, u8* dest,
+                  bool encrypt) {
+    UNREACHABLE();
+}
+
+void TranscodeCTR(const KeySchedule& schedule, const u8* src, std::size_t size, u8* dest,
+                  std::array<u8, 16>& counter) {
+    UNREACHABLE();
+}
+
+void TranscodeXTS(const KeySchedule& data_key, const KeySchedule& tweak_key, const u8* src,
+                  std::size_t size, u8* dest, const std::array<u8, 16>& tweak, bool encrypt) {
+    UNREACHABLE();
+}
+
+#endif
+
+} // namespace Core::Crypto::AESNI
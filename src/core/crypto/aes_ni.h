@@ -0,0 +1,43 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "common/common_types.h"
+
+namespace Core::Crypto::AESNI {
+
+/// Round keys of AES-128, for encryption and for the equivalent inverse cipher.
+struct KeySchedule {
+    alignas(16) std::array<std::array<u8, 16>, 11> encrypt;
+    alignas(16) std::array<std::array<u8, 16>, 11> decrypt;
+};
+
+/// Returns true when the host supports the AES instructions.
+bool IsSupported();
+
+/// Expands a 128-bit key into its round keys.
+void ExpandKey(const u8* key, KeySchedule& schedule);
+
+/// Transcodes whole blocks in ECB mode, size must be a multiple of 16.
+void TranscodeECB(const KeySchedule& schedule, const u8* src, std::size_t size, u8* dest,
+                  bool encrypt);
+
+/// Transcodes in CTR mode. The counter is a big-endian 128-bit number, it is left past the last
+/// block used so the next call continues the stream with a new block.
+void TranscodeCTR(const KeySchedule& schedule, const u8* src, std::size_t size, u8* dest,
+                  std::array<u8, 16>& counter);
+
+/**
+ * Transcodes a data unit in XTS mode, size must be a multiple of 16.
+ * @param data_key Schedule of the first half of the XTS key
+ * @param tweak_key Schedule of the second half of the XTS key
+ * @param tweak Tweak of the data unit, before encryption with the tweak key
+ */
+void TranscodeXTS(const KeySchedule& data_key, const KeySchedule& tweak_key, const u8* src,
+                  std::size_t size, u8* dest, const std::array<u8, 16>& tweak, bool encrypt);
+
+} // namespace Core::Crypto::AESNI
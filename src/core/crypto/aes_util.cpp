@@ -2,16 +2,19 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <cstring>
 #include <mbedtls/cipher.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "core/crypto/aes_ni.h"
 #include "core/crypto/aes_util.h"
 #include "core/crypto/key_manager.h"
 
 namespace Core::Crypto {
 namespace {
-std::vector<u8> CalculateNintendoTweak(std::size_t sector_id) {
-    std::vector<u8> out(0x10);
+std::array<u8, 0x10> CalculateNintendoTweak(std::size_t sector_id) {
+    std::array<u8, 0x10> out{};
     for (std::size_t i = 0xF; i <= 0xF; --i) {
         out[i] = sector_id & 0xFF;
         sector_id >>= 8;
@@ -34,6 +37,14 @@ static_assert(static_cast<std::size_t>(Mode::XTS) ==
 struct CipherContext {
     mbedtls_cipher_context_t encryption_context;
     mbedtls_cipher_context_t decryption_context;
+
+    // AES-128 in CTR, ECB and XTS modes runs on the AES instructions when the host has them,
+    // mbedtls stays the fallback
+    bool is_native = false;
+    Mode mode{};
+    AESNI::KeySchedule schedule;
+    AESNI::KeySchedule tweak_schedule;
+    std::array<u8, 0x10> iv{};
 };
 
 template <typename Key, std::size_t KeySize>
@@ -55,6 +66,17 @@ Crypto::AESCipher<Key, KeySize>::AESCipher(Key key, Mode mode)
     ASSERT(
         !mbedtls_cipher_setkey(&ctx->decryption_context, key.data(), KeySize * 8, MBEDTLS_DECRYPT));
     //"Failed to set key on mbedtls ciphers.");
+
+    ctx->mode = mode;
+    const bool is_native_mode = KeySize == 0x10 ? mode == Mode::CTR || mode == Mode::ECB
+                                                : mode == Mode::XTS;
+    if (is_native_mode && AESNI::IsSupported()) {
+        ctx->is_native = true;
+        AESNI::ExpandKey(key.data(), ctx->schedule);
+        if (mode == Mode::XTS) {
+            AESNI::ExpandKey(key.data() + 0x10, ctx->tweak_schedule);
+        }
+    }
 }
 
 template <typename Key, std::size_t KeySize>
@@ -64,7 +86,13 @@ AESCipher<Key, KeySize>::~AESCipher() {
 }
 
 template <typename Key, std::size_t KeySize>
-void AESCipher<Key, KeySize>::SetIV(std::vector<u8> iv) {
+void AESCipher<Key, KeySize>::SetIV(const std::vector<u8>& iv) {
+    if (ctx->is_native) {
+        // Applied to the mbedtls contexts only if a transcode has to fall back to them
+        ctx->iv.fill(0);
+        std::memcpy(ctx->iv.data(), iv.data(), std::min(iv.size(), ctx->iv.size()));
+        return;
+    }
     ASSERT_MSG((mbedtls_cipher_set_iv(&ctx->encryption_context, iv.data(), iv.size()) ||
                 mbedtls_cipher_set_iv(&ctx->decryption_context, iv.data(), iv.size())) == 0,
                "Failed to set IV on mbedtls ciphers.");
@@ -72,6 +100,10 @@ void AESCipher<Key, KeySize>::SetIV(std::vector<u8> iv) {
 
 template <typename Key, std::size_t KeySize>
 void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* dest, Op op) const {
+    if (ctx->is_native && TranscodeNative(src, size, dest, op)) {
+        return;
+    }
+
     auto* const context = op == Op::Encrypt ? &ctx->encryption_context : &ctx->decryption_context;
 
     mbedtls_cipher_reset(context);
@@ -113,13 +145,66 @@ void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* des
     mbedtls_cipher_finish(context, nullptr, nullptr);
 }
 
+template <typename Key, std::size_t KeySize>
+bool AESCipher<Key, KeySize>::TranscodeNative(const u8* src, std::size_t size, u8* dest,
+                                              Op op) const {
+    constexpr std::size_t block_size = 0x10;
+    const bool encrypt = op == Op::Encrypt;
+    switch (ctx->mode) {
+    case Mode::CTR:
+        AESNI::TranscodeCTR(ctx->schedule, src, size, dest, ctx->iv);
+        return true;
+    case Mode::ECB: {
+        const std::size_t whole_size = size - size % block_size;
+        AESNI::TranscodeECB(ctx->schedule, src, whole_size, dest, encrypt);
+        if (whole_size != size) {
+            // Partial blocks are padded with zeros, like the mbedtls path does
+            std::array<u8, block_size> block{};
+            std::memcpy(block.data(), src + whole_size, size - whole_size);
+            AESNI::TranscodeECB(ctx->schedule, block.data(), block.size(), block.data(), encrypt);
+            std::memcpy(dest + whole_size, block.data(), size - whole_size);
+        }
+        return true;
+    }
+    case Mode::XTS:
+        if (size % block_size != 0) {
+            // Ciphertext stealing is left to mbedtls
+            SyncIV();
+            return false;
+        }
+        AESNI::TranscodeXTS(ctx->schedule, ctx->tweak_schedule, src, size, dest, ctx->iv,
+                            encrypt);
+        return true;
+    }
+    return false;
+}
+
+template <typename Key, std::size_t KeySize>
+void AESCipher<Key, KeySize>::SyncIV() const {
+    ASSERT_MSG((mbedtls_cipher_set_iv(&ctx->encryption_context, ctx->iv.data(), ctx->iv.size()) ||
+                mbedtls_cipher_set_iv(&ctx->decryption_context, ctx->iv.data(), ctx->iv.size())) ==
+                   0,
+               "Failed to set IV on mbedtls ciphers.");
+}
+
 template <typename Key, std::size_t KeySize>
 void AESCipher<Key, KeySize>::XTSTranscode(const u8* src, std::size_t size, u8* dest,
                                            std::size_t sector_id, std::size_t sector_size, Op op) {
     ASSERT_MSG(size % sector_size == 0, "XTS decryption size must be a multiple of sector size.");
 
+    if (ctx->is_native && sector_size % 0x10 == 0) {
+        // All the sectors in one pass, only the tweak changes between them
+        const bool encrypt = op == Op::Encrypt;
+        for (std::size_t i = 0; i < size; i += sector_size) {
+            AESNI::TranscodeXTS(ctx->schedule, ctx->tweak_schedule, src + i, sector_size,
+                                dest + i, CalculateNintendoTweak(sector_id++), encrypt);
+        }
+        return;
+    }
+
     for (std::size_t i = 0; i < size; i += sector_size) {
-        SetIV(CalculateNintendoTweak(sector_id++));
+        const auto tweak = CalculateNintendoTweak(sector_id++);
+        SetIV(std::vector<u8>(tweak.begin(), tweak.end()));
         Transcode<u8, u8>(src + i, sector_size, dest + i, op);
     }
 }
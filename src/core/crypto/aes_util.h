@@ -35,7 +35,7 @@ public:
 
     ~AESCipher();
 
-    void SetIV(std::vector<u8> iv);
+    void SetIV(const std::vector<u8>& iv);
 
     template <typename Source, typename Dest>
     void Transcode(const Source* src, std::size_t size, Dest* dest, Op op) const {
@@ -59,6 +59,12 @@ public:
                       std::size_t sector_size, Op op);
 
 private:
+    /// Transcodes with the AES instructions, returns false when the request needs mbedtls.
+    bool TranscodeNative(const u8* src, std::size_t size, u8* dest, Op op) const;
+
+    /// Hands the IV of the native path to the mbedtls contexts.
+    void SyncIV() const;
+
     std::unique_ptr<CipherContext> ctx;
 };
 } // namespace Core::Crypto
@@ -2,4 +2,231 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-namespace Crypto {} // namespace Crypto
+#include <algorithm>
+#include <cstring>
+#include "core/crypto/sha_util.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include <immintrin.h>
+#include "common/x64/cpu_detect.h"
+#endif
+
+namespace Core::Crypto {
+
+namespace {
+
+constexpr std::size_t BLOCK_SIZE = 64;
+
+constexpr std::array<u32, 8> INITIAL_STATE{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+alignas(16) constexpr std::array<u32, 64> ROUND_CONSTANTS{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+u32 RotateRight(u32 value, int amount) {
+    return (value >> amount) | (value << (32 - amount));
+}
+
+void CompressBlocksGeneric(std::array<u32, 8>& state, const u8* data, std::size_t num_blocks) {
+    for (std::size_t block = 0; block < num_blocks; ++block, data += BLOCK_SIZE) {
+        std::array<u32, 64> w;
+        for (std::size_t i = 0; i < 16; ++i) {
+            const u8* const word = data + i * 4;
+            w[i] = static_cast<u32>(word[0]) << 24 | static_cast<u32>(word[1]) << 16 |
+                   static_cast<u32>(word[2]) << 8 | static_cast<u32>(word[3]);
+        }
+        for (std::size_t i = 16; i < w.size(); ++i) {
+            const u32 x = w[i - 15];
+            const u32 y = w[i - 2];
+            const u32 s0 = RotateRight(x, 7) ^ RotateRight(x, 18) ^ (x >> 3);
+            const u32 s1 = RotateRight(y, 17) ^ RotateRight(y, 19) ^ (y >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        u32 a = state[0], b = state[1], c = state[2], d = state[3];
+        u32 e = state[4], f = state[5], g = state[6], h = state[7];
+        for (std::size_t i = 0; i < w.size(); ++i) {
+            const u32 s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+            const u32 choice = (e & f) ^ (~e & g);
+            const u32 temp1 = h + s1 + choice + ROUND_CONSTANTS[i] + w[i];
+            const u32 s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+            const u32 majority = (a & b) ^ (a & c) ^ (b & c);
+            const u32 temp2 = s0 + majority;
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+#ifdef ARCHITECTURE_x86_64
+
+// The rest of the build targets plain x86-64, only this function uses the SHA instructions
+#if defined(__GNUC__) || defined(__clang__)
+#define SHANI_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#else
+#define SHANI_TARGET
+#endif
+
+SHANI_TARGET void CompressBlocksSHANI(std::array<u32, 8>& state, const u8* data,
+                                      std::size_t num_blocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    const auto* const constants = reinterpret_cast<const __m128i*>(ROUND_CONSTANTS.data());
+
+    // The round instructions work on the state as ABEF and CDGH
+    const __m128i dcba = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data())), 0xB1);
+    const __m128i efgh = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data() + 4)), 0x1B);
+    __m128i abef = _mm_alignr_epi8(dcba, efgh, 8);
+    __m128i cdgh = _mm_blend_epi16(efgh, dcba, 0xF0);
+
+    for (std::size_t block = 0; block < num_blocks; ++block, data += BLOCK_SIZE) {
+        const __m128i abef_save = abef;
+        const __m128i cdgh_save = cdgh;
+
+        // Four rounds per group, the message schedule of later groups is computed as it goes
+        __m128i messages[4];
+        for (std::size_t group = 0; group < 16; ++group) {
+            __m128i& message = messages[group % 4];
+            if (group < 4) {
+                message = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + group * 16)),
+                    byte_swap);
+            }
+
+            __m128i rounds = _mm_add_epi32(message, _mm_load_si128(constants + group));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, rounds);
+            if (group >= 3 && group < 15) {
+                __m128i& next = messages[(group + 1) % 4];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(message, messages[(group + 3) % 4], 4));
+                next = _mm_sha256msg2_epu32(next, message);
+            }
+            rounds = _mm_shuffle_epi32(rounds, 0x0E);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, rounds);
+            if (group >= 1 && group < 13) {
+                __m128i& previous = messages[(group + 3) % 4];
+                previous = _mm_sha256msg1_epu32(previous, message);
+            }
+        }
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state.data()), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state.data() + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+#undef SHANI_TARGET
+
+#endif
+
+void CompressBlocks(std::array<u32, 8>& state, const u8* data, std::size_t num_blocks) {
+#ifdef ARCHITECTURE_x86_64
+    if (IsSHA256Accelerated()) {
+        CompressBlocksSHANI(state, data, num_blocks);
+        return;
+    }
+#endif
+    CompressBlocksGeneric(state, data, num_blocks);
+}
+
+} // Anonymous namespace
+
+SHA256Hasher::SHA256Hasher() {
+    Reset();
+}
+
+void SHA256Hasher::Update(const u8* data, std::size_t size) {
+    total_size += size;
+
+    if (buffer_size != 0) {
+        const std::size_t length = std::min(size, BLOCK_SIZE - buffer_size);
+        std::memcpy(buffer.data() + buffer_size, data, length);
+        buffer_size += length;
+        data += length;
+        size -= length;
+        if (buffer_size < BLOCK_SIZE) {
+            return;
+        }
+        CompressBlocks(state, buffer.data(), 1);
+        buffer_size = 0;
+    }
+
+    const std::size_t num_blocks = size / BLOCK_SIZE;
+    CompressBlocks(state, data, num_blocks);
+    data += num_blocks * BLOCK_SIZE;
+    size -= num_blocks * BLOCK_SIZE;
+
+    std::memcpy(buffer.data(), data, size);
+    buffer_size = size;
+}
+
+SHA256Hash SHA256Hasher::Finish() {
+    // Padding is a one bit, zeroes up to 8 bytes before a block boundary, then the bit length
+    const u64 bit_size = total_size * 8;
+    buffer[buffer_size++] = 0x80;
+    if (buffer_size > BLOCK_SIZE - 8) {
+        std::fill(buffer.begin() + buffer_size, buffer.end(), u8{0});
+        CompressBlocks(state, buffer.data(), 1);
+        buffer_size = 0;
+    }
+    std::fill(buffer.begin() + buffer_size, buffer.end() - 8, u8{0});
+    for (std::size_t i = 0; i < 8; ++i) {
+        buffer[BLOCK_SIZE - 1 - i] = static_cast<u8>(bit_size >> (i * 8));
+    }
+    CompressBlocks(state, buffer.data(), 1);
+
+    SHA256Hash hash;
+    for (std::size_t i = 0; i < state.size(); ++i) {
+        hash[i * 4] = static_cast<u8>(state[i] >> 24);
+        hash[i * 4 + 1] = static_cast<u8>(state[i] >> 16);
+        hash[i * 4 + 2] = static_cast<u8>(state[i] >> 8);
+        hash[i * 4 + 3] = static_cast<u8>(state[i]);
+    }
+    Reset();
+    return hash;
+}
+
+void SHA256Hasher::Reset() {
+    state = INITIAL_STATE;
+    buffer_size = 0;
+    total_size = 0;
+}
+
+bool IsSHA256Accelerated() {
+#ifdef ARCHITECTURE_x86_64
+    const auto& caps = Common::GetCPUCaps();
+    return caps.sha && caps.sse4_1 && caps.ssse3;
+#else
+    return false;
+#endif
+}
+
+} // namespace Core::Crypto
@@ -4,17 +4,35 @@
 
 #pragma once
 
-#include "common/assert.h"
-#include "core/file_sys/vfs.h"
-#include "key_manager.h"
-#include "mbedtls/cipher.h"
+#include <array>
+#include <cstddef>
+#include "common/common_types.h"
 
-namespace Crypto {
-typedef std::array<u8, 0x20> SHA256Hash;
+namespace Core::Crypto {
 
-inline SHA256Hash operator"" _HASH(const char* data, size_t len) {
-    if (len != 0x40)
-        return {};
-}
+using SHA256Hash = std::array<u8, 0x20>;
 
-} // namespace Crypto
+/// Computes SHA-256 incrementally, with the SHA instructions of the host when it has them.
+class SHA256Hasher {
+public:
+    SHA256Hasher();
+
+    /// Appends data to the message, it may be called any number of times with any size.
+    void Update(const u8* data, std::size_t size);
+
+    /// Returns the hash of everything passed to Update and starts over.
+    SHA256Hash Finish();
+
+private:
+    void Reset();
+
+    std::array<u32, 8> state;
+    std::array<u8, 64> buffer;
+    std::size_t buffer_size;
+    u64 total_size;
+};
+
+/// Returns true when SHA256Hasher uses the SHA instructions of the host.
+bool IsSHA256Accelerated();
+
+} // namespace Core::Crypto
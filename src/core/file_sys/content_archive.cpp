@@ -14,6 +14,7 @@
 #include "core/file_sys/nca_patch.h"
 #include "core/file_sys/partition_filesystem.h"
 #include "core/file_sys/romfs.h"
+#include "core/file_sys/vfs_cached.h"
 #include "core/file_sys/vfs_offset.h"
 #include "core/loader/loader.h"
 
@@ -346,15 +347,19 @@ bool NCA::ReadRomFSSection(const NCASectionHeader& section, const NCASectionTabl
             return false;
         }
 
-        auto bktr = std::make_shared<BKTR>(
+        // Relocated reads pay for the bucket searches and a decryption, keep the result
+        auto bktr = std::make_shared<CachedVfsFile>(std::make_shared<BKTR>(
             bktr_base_romfs, std::make_shared<OffsetVfsFile>(file, romfs_size, base_offset),
             relocation_block, relocation_buckets, subsection_block, subsection_buckets, encrypted,
             encrypted ? *key : Core::Crypto::Key128{}, base_offset, bktr_base_ivfc_offset,
-            section.raw.section_ctr);
+            section.raw.section_ctr));
 
         // BKTR applies to entire IVFC, so make an offset version to level 6
         files.push_back(std::make_shared<OffsetVfsFile>(
             bktr, romfs_size, section.romfs.ivfc.levels[IVFC_MAX_LEVEL - 1].offset));
+    } else if (dec != raw) {
+        // Decrypted sections are cached, this is also the base RomFS a BKTR patch reads from
+        files.push_back(std::make_shared<CachedVfsFile>(std::move(dec)));
     } else {
         files.push_back(std::move(dec));
     }
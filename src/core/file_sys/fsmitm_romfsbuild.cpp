@@ -169,7 +169,7 @@ void RomFSBuildContext::VisitDirectory(VirtualDir root_romfs, VirtualDir ext,
             // Sanity check on path_len
             ASSERT(child->path_len < FS_MAX_PATH);
 
-            child->source = root_romfs->GetFileRelative(child->path);
+            child->source = dir->GetFile(kv.first);
 
             if (ext != nullptr) {
                 const auto ips = ext->GetFileRelative(child->path + ".ips");
@@ -2,7 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+
 #include "common/string_util.h"
+#include "common/thread.h"
 #include "core/file_sys/kernel_executable.h"
 #include "core/file_sys/vfs_offset.h"
 
@@ -95,6 +99,7 @@ KIP::KIP(const VirtualFile& file) : status(Loader::ResultStatus::Success) {
         return;
     }
 
+    std::array<bool, 6> is_compressed{};
     u64 offset = sizeof(KIPHeader);
     for (std::size_t i = 0; i < header.sections.size(); ++i) {
         auto compressed = file->ReadBytes(header.sections[i].compressed_size, offset);
@@ -102,15 +107,24 @@ KIP::KIP(const VirtualFile& file) : status(Loader::ResultStatus::Success) {
 
         if (header.sections[i].compressed_size == 0 && header.sections[i].decompressed_size != 0) {
             decompressed_sections[i] = std::vector<u8>(header.sections[i].decompressed_size);
-        } else if (header.sections[i].compressed_size == header.sections[i].decompressed_size) {
-            decompressed_sections[i] = std::move(compressed);
         } else {
-            decompressed_sections[i] = compressed;
-            if (!DecompressBLZ(decompressed_sections[i])) {
-                status = Loader::ResultStatus::ErrorBLZDecompressionFailed;
-                return;
-            }
+            is_compressed[i] =
+                header.sections[i].compressed_size != header.sections[i].decompressed_size;
+            decompressed_sections[i] = std::move(compressed);
+        }
+    }
+
+    // The sections were read on this thread, only the decompression runs in parallel
+    std::array<bool, 6> is_decompressed;
+    is_decompressed.fill(true);
+    Common::ParallelFor(decompressed_sections.size(), [&](std::size_t i) {
+        if (is_compressed[i]) {
+            is_decompressed[i] = DecompressBLZ(decompressed_sections[i]);
         }
+    });
+    if (std::find(is_decompressed.begin(), is_decompressed.end(), false) !=
+        is_decompressed.end()) {
+        status = Loader::ResultStatus::ErrorBLZDecompressionFailed;
     }
 }
 
@@ -10,7 +10,9 @@
 #include "common/file_util.h"
 #include "common/hex_util.h"
 #include "common/logging/log.h"
+#include "common/thread.h"
 #include "core/crypto/key_manager.h"
+#include "core/crypto/sha_util.h"
 #include "core/file_sys/card_image.h"
 #include "core/file_sys/content_archive.h"
 #include "core/file_sys/nca_metadata.h"
@@ -24,6 +26,11 @@ namespace FileSys {
 // The size of blocks to use when vfs raw copying into nand.
 constexpr size_t VFS_RC_LARGE_COPY_BLOCK = 0x400000;
 
+bool VfsInstallCopy(const VirtualFile& src, const VirtualFile& dest, size_t block_size,
+                    const VfsCopyBlockCallback& on_block) {
+    return VfsPipelinedCopy(src, dest, block_size, on_block);
+}
+
 std::string ContentProviderEntry::DebugInfo() const {
     return fmt::format("title_id={:016X}, content_type={:02X}", title_id, static_cast<u8>(type));
 }
@@ -199,7 +206,7 @@ bool PlaceholderCache::Register(RegisteredCache* cache, const NcaID& placeholder
     if (file == nullptr)
         return false;
 
-    const auto res = cache->RawInstallNCA(NCA{file}, &VfsRawCopy, false, install);
+    const auto res = cache->RawInstallNCA(NCA{file}, &VfsInstallCopy, false, install);
 
     if (res != InstallResult::Success)
         return false;
@@ -402,28 +409,67 @@ std::vector<NcaID> RegisteredCache::AccumulateFiles() const {
     return ids;
 }
 
+struct RegisteredCache::ParsedMeta {
+    u64 title_id{};
+    /// Empty if the NCA is not a meta NCA.
+    std::optional<CNMT> cnmt;
+};
+
 void RegisteredCache::ProcessFiles(const std::vector<NcaID>& ids) {
+    // Opening the files goes through the VFS and the parser, which may update the key files, so
+    // only parsing the NCAs and their CNMTs is spread over threads.
+    std::vector<NcaID> new_ids;
+    std::vector<VirtualFile> new_files;
     for (const auto& id : ids) {
-        const auto file = GetFileAtID(id);
+        if (parsed_meta.find(id) != parsed_meta.end() ||
+            std::find(new_ids.begin(), new_ids.end(), id) != new_ids.end()) {
+            continue;
+        }
 
+        const auto file = GetFileAtID(id);
         if (file == nullptr)
             continue;
-        const auto nca = std::make_shared<NCA>(parser(file, id), nullptr, 0, keys);
-        if (nca->GetStatus() != Loader::ResultStatus::Success ||
-            nca->GetType() != NCAContentType::Meta) {
-            continue;
+        new_ids.push_back(id);
+        new_files.push_back(parser(file, id));
+    }
+
+    std::vector<std::optional<ParsedMeta>> results(new_files.size());
+    Common::ParallelFor(new_files.size(), [this, &new_files, &results](std::size_t index) {
+        const auto nca = std::make_shared<NCA>(new_files[index], nullptr, 0, keys);
+        // NCAs that can't be read yet (e.g. missing keys) aren't cached, so they are tried again
+        if (nca->GetStatus() != Loader::ResultStatus::Success) {
+            return;
         }
 
-        const auto section0 = nca->GetSubdirectories()[0];
+        auto& result = results[index].emplace();
+        if (nca->GetType() != NCAContentType::Meta) {
+            return;
+        }
 
+        const auto section0 = nca->GetSubdirectories()[0];
         for (const auto& section0_file : section0->GetFiles()) {
             if (section0_file->GetExtension() != "cnmt")
                 continue;
 
-            meta.insert_or_assign(nca->GetTitleId(), CNMT(section0_file));
-            meta_id.insert_or_assign(nca->GetTitleId(), id);
+            result.title_id = nca->GetTitleId();
+            result.cnmt.emplace(section0_file);
             break;
         }
+    });
+
+    for (std::size_t i = 0; i < new_ids.size(); ++i) {
+        if (results[i]) {
+            parsed_meta.emplace(new_ids[i], std::move(*results[i]));
+        }
+    }
+
+    for (const auto& id : ids) {
+        const auto iter = parsed_meta.find(id);
+        if (iter == parsed_meta.end() || !iter->second.cnmt)
+            continue;
+
+        meta.insert_or_assign(iter->second.title_id, *iter->second.cnmt);
+        meta_id.insert_or_assign(iter->second.title_id, id);
     }
 }
 
@@ -445,6 +491,19 @@ void RegisteredCache::Refresh() {
     if (dir == nullptr)
         return;
     const auto ids = AccumulateFiles();
+
+    // Drop the NCAs that are gone, the others are only parsed the first time they are seen
+    for (auto iter = parsed_meta.begin(); iter != parsed_meta.end();) {
+        if (std::find(ids.begin(), ids.end(), iter->first) == ids.end()) {
+            iter = parsed_meta.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    meta.clear();
+    meta_id.clear();
+    yuzu_meta.clear();
     ProcessFiles(ids);
     AccumulateYuzuMeta();
 }
@@ -579,12 +638,15 @@ InstallResult RegisteredCache::InstallEntry(const NSP& nsp, bool overwrite_if_ex
         const auto nca = GetNCAFromNSPForID(nsp, record.nca_id);
         if (nca == nullptr)
             return InstallResult::ErrorCopyFailed;
-        const auto res2 = RawInstallNCA(*nca, copy, overwrite_if_exists, record.nca_id);
+        const auto res2 =
+            RawInstallNCA(*nca, copy, overwrite_if_exists, record.nca_id, record.hash);
         if (res2 != InstallResult::Success)
             return res2;
     }
 
-    Refresh();
+    // Only the meta NCA affects the metadata, there is no need to walk the whole directory again
+    parsed_meta.erase(meta_id);
+    ProcessFiles({meta_id});
     return InstallResult::Success;
 }
 
@@ -611,9 +673,9 @@ InstallResult RegisteredCache::InstallEntry(const NCA& nca, TitleType type,
     return RawInstallNCA(nca, copy, overwrite_if_exists, c_rec.nca_id);
 }
 
-InstallResult RegisteredCache::RawInstallNCA(const NCA& nca, const VfsCopyFunction& copy,
-                                             bool overwrite_if_exists,
-                                             std::optional<NcaID> override_id) {
+InstallResult RegisteredCache::RawInstallNCA(
+    const NCA& nca, const VfsCopyFunction& copy, bool overwrite_if_exists,
+    std::optional<NcaID> override_id, std::optional<Core::Crypto::SHA256Hash> expected_hash) {
     const auto in = nca.GetBaseFile();
     Core::Crypto::SHA256Hash hash{};
 
@@ -647,8 +709,24 @@ InstallResult RegisteredCache::RawInstallNCA(const NCA& nca, const VfsCopyFuncti
     auto out = dir->CreateFileRelative(path);
     if (out == nullptr)
         return InstallResult::ErrorCopyFailed;
-    return copy(in, out, VFS_RC_LARGE_COPY_BLOCK) ? InstallResult::Success
-                                                  : InstallResult::ErrorCopyFailed;
+    if (!expected_hash) {
+        return copy(in, out, VFS_RC_LARGE_COPY_BLOCK, {}) ? InstallResult::Success
+                                                          : InstallResult::ErrorCopyFailed;
+    }
+
+    // The NCA is hashed as it is copied rather than read a second time afterwards
+    Core::Crypto::SHA256Hasher hasher;
+    const auto on_block = [&hasher](const u8* data, std::size_t size) {
+        hasher.Update(data, size);
+    };
+    if (!copy(in, out, VFS_RC_LARGE_COPY_BLOCK, on_block))
+        return InstallResult::ErrorCopyFailed;
+    if (hasher.Finish() != *expected_hash) {
+        LOG_WARNING(Loader, "The hash of NCA {} does not match its content record, it may be "
+                            "corrupted.",
+                    Common::HexToString(id, false));
+    }
+    return InstallResult::Success;
 }
 
 bool RegisteredCache::RawInstallYuzuMeta(const CNMT& cnmt) {
@@ -660,6 +738,7 @@ bool RegisteredCache::RawInstallYuzuMeta(const CNMT& cnmt) {
         const auto buffer = cnmt.Serialize();
         out->Resize(buffer.size());
         out->WriteBytes(buffer);
+        yuzu_meta.insert_or_assign(cnmt.GetTitleID(), cnmt);
     } else {
         auto out = dir->GetFile(filename);
         CNMT old_cnmt(out);
@@ -670,8 +749,8 @@ bool RegisteredCache::RawInstallYuzuMeta(const CNMT& cnmt) {
             out->Resize(buffer.size());
             out->WriteBytes(buffer);
         }
+        yuzu_meta.insert_or_assign(old_cnmt.GetTitleID(), std::move(old_cnmt));
     }
-    Refresh();
     return std::find_if(yuzu_meta.begin(), yuzu_meta.end(),
                         [&cnmt](const std::pair<u64, CNMT>& kv) {
                             return kv.second.GetType() == cnmt.GetType() &&
@@ -6,7 +6,9 @@
 
 #include <array>
 #include <functional>
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <boost/container/flat_map.hpp>
@@ -30,7 +32,14 @@ class RegisteredCache;
 
 using NcaID = std::array<u8, 0x10>;
 using ContentProviderParsingFunction = std::function<VirtualFile(const VirtualFile&, const NcaID&)>;
-using VfsCopyFunction = std::function<bool(const VirtualFile&, const VirtualFile&, size_t)>;
+// Copies the file in the first argument to the second one, in blocks of the given size. It has to
+// pass every block copied to the callback in order, the installs use it to hash the data.
+using VfsCopyFunction = std::function<bool(const VirtualFile&, const VirtualFile&, size_t,
+                                           const VfsCopyBlockCallback&)>;
+
+// The copy function of the installs, VfsPipelinedCopy without progress reporting.
+bool VfsInstallCopy(const VirtualFile& src, const VirtualFile& dest, size_t block_size,
+                    const VfsCopyBlockCallback& on_block);
 
 enum class InstallResult {
     Success,
@@ -157,16 +166,16 @@ public:
     // Raw copies all the ncas from the xci/nsp to the csache. Does some quick checks to make sure
     // there is a meta NCA and all of them are accessible.
     InstallResult InstallEntry(const XCI& xci, bool overwrite_if_exists = false,
-                               const VfsCopyFunction& copy = &VfsRawCopy);
+                               const VfsCopyFunction& copy = &VfsInstallCopy);
     InstallResult InstallEntry(const NSP& nsp, bool overwrite_if_exists = false,
-                               const VfsCopyFunction& copy = &VfsRawCopy);
+                               const VfsCopyFunction& copy = &VfsInstallCopy);
 
     // Due to the fact that we must use Meta-type NCAs to determine the existance of files, this
     // poses quite a challenge. Instead of creating a new meta NCA for this file, yuzu will create a
     // dir inside the NAND called 'yuzu_meta' and store the raw CNMT there.
     // TODO(DarkLordZach): Author real meta-type NCAs and install those.
     InstallResult InstallEntry(const NCA& nca, TitleType type, bool overwrite_if_exists = false,
-                               const VfsCopyFunction& copy = &VfsRawCopy);
+                               const VfsCopyFunction& copy = &VfsInstallCopy);
 
 private:
     template <typename T>
@@ -180,7 +189,8 @@ private:
     VirtualFile GetFileAtID(NcaID id) const;
     VirtualFile OpenFileOrDirectoryConcat(const VirtualDir& dir, std::string_view path) const;
     InstallResult RawInstallNCA(const NCA& nca, const VfsCopyFunction& copy,
-                                bool overwrite_if_exists, std::optional<NcaID> override_id = {});
+                                bool overwrite_if_exists, std::optional<NcaID> override_id = {},
+                                std::optional<Core::Crypto::SHA256Hash> expected_hash = {});
     bool RawInstallYuzuMeta(const CNMT& cnmt);
 
     VirtualDir dir;
@@ -192,6 +202,10 @@ private:
     std::map<u64, CNMT> meta;
     // maps tid -> meta for CNMT in yuzu_meta
     std::map<u64, CNMT> yuzu_meta;
+
+    struct ParsedMeta;
+    // maps NcaID -> tid and meta of every readable NCA, so refreshes only parse new NCAs
+    std::map<NcaID, ParsedMeta> parsed_meta;
 };
 
 enum class ContentProviderUnionSlot {
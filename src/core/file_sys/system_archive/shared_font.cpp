@@ -28,6 +28,11 @@ VirtualFile PackBFTTF(const std::array<u8, Size>& data, const std::string& name)
     return std::make_shared<VectorVfsFile>(std::move(bfttf), name);
 }
 
+template <std::size_t Size>
+SharedFontFile MakeSharedFontFile(const std::array<u8, Size>& data) {
+    return {data.data(), data.size()};
+}
+
 } // Anonymous namespace
 
 VirtualDir FontNintendoExtension() {
@@ -75,4 +80,26 @@ VirtualDir FontChineseSimple() {
         std::vector<VirtualDir>{});
 }
 
+std::optional<SharedFontFile> GetSharedFontFile(std::string_view name) {
+    if (name == "nintendo_ext_003.bfttf" || name == "nintendo_ext2_003.bfttf") {
+        return MakeSharedFontFile(SharedFontData::FONT_NINTENDO_EXTENDED);
+    }
+    if (name == "nintendo_udsg-r_std_003.bfttf") {
+        return MakeSharedFontFile(SharedFontData::FONT_STANDARD);
+    }
+    if (name == "nintendo_udsg-r_ko_003.bfttf") {
+        return MakeSharedFontFile(SharedFontData::FONT_KOREAN);
+    }
+    if (name == "nintendo_udjxh-db_zh-tw_003.bfttf") {
+        return MakeSharedFontFile(SharedFontData::FONT_CHINESE_TRADITIONAL);
+    }
+    if (name == "nintendo_udsg-r_org_zh-cn_003.bfttf") {
+        return MakeSharedFontFile(SharedFontData::FONT_CHINESE_SIMPLIFIED);
+    }
+    if (name == "nintendo_udsg-r_ext_zh-cn_003.bfttf") {
+        return MakeSharedFontFile(SharedFontData::FONT_EXTENDED_CHINESE_SIMPLIFIED);
+    }
+    return std::nullopt;
+}
+
 } // namespace FileSys::SystemArchive
@@ -4,14 +4,27 @@
 
 #pragma once
 
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include "common/common_types.h"
 #include "core/file_sys/vfs_types.h"
 
 namespace FileSys::SystemArchive {
 
+/// Unencrypted contents of a bfttf file of the synthesized shared font archives.
+struct SharedFontFile {
+    const u8* data;
+    std::size_t size;
+};
+
 VirtualDir FontNintendoExtension();
 VirtualDir FontStandard();
 VirtualDir FontKorean();
 VirtualDir FontChineseTraditional();
 VirtualDir FontChineseSimple();
 
+/// Returns the contents of the synthesized bfttf file of a name, without building its archive.
+std::optional<SharedFontFile> GetSharedFontFile(std::string_view name);
+
 } // namespace FileSys::SystemArchive
@@ -3,8 +3,12 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <mutex>
 #include <numeric>
 #include <string>
+#include <thread>
 #include "common/common_paths.h"
 #include "common/file_util.h"
 #include "common/logging/backend.h"
@@ -177,6 +181,15 @@ std::optional<u8> VfsFile::ReadByte(std::size_t offset) const {
 }
 
 std::vector<u8> VfsFile::ReadBytes(std::size_t size, std::size_t offset) const {
+    if (const u8* const data = GetData()) {
+        const std::size_t file_size = GetSize();
+        if (offset >= file_size) {
+            return {};
+        }
+        const std::size_t read_size = std::min(size, file_size - offset);
+        return std::vector<u8>(data + offset, data + offset + read_size);
+    }
+
     std::vector<u8> out(size);
     std::size_t read_size = Read(out.data(), size, offset);
     out.resize(read_size);
@@ -187,6 +200,12 @@ std::vector<u8> VfsFile::ReadAllBytes() const {
     return ReadBytes(GetSize());
 }
 
+const u8* VfsFile::GetData() const {
+    return nullptr;
+}
+
+void VfsFile::Prefetch(std::size_t offset, std::size_t length) const {}
+
 bool VfsFile::WriteByte(u8 data, std::size_t offset) {
     return Write(&data, 1, offset) == 1;
 }
@@ -421,6 +440,19 @@ bool VfsDirectory::Copy(std::string_view src, std::string_view dest) {
     return f2->WriteBytes(f1->ReadAllBytes()) == f1->GetSize();
 }
 
+bool VfsDirectory::Replace(std::string_view src, std::string_view dest) {
+    const auto file = GetFile(src);
+    if (file == nullptr) {
+        return false;
+    }
+
+    // A missing dest counts as deleted already, so a retry after a failed rename can finish
+    if (GetFile(dest) != nullptr && !DeleteFile(dest)) {
+        return false;
+    }
+    return file->Rename(dest);
+}
+
 std::map<std::string, VfsEntryType, std::less<>> VfsDirectory::GetEntries() const {
     std::map<std::string, VfsEntryType, std::less<>> out;
     for (const auto& dir : GetSubdirectories())
@@ -430,6 +462,15 @@ std::map<std::string, VfsEntryType, std::less<>> VfsDirectory::GetEntries() cons
     return out;
 }
 
+VfsDirectoryListing VfsDirectory::GetListing() const {
+    auto listing = std::make_shared<std::vector<VfsDirectoryEntry>>();
+    for (const auto& file : GetFiles())
+        listing->push_back({file->GetName(), VfsEntryType::File, file->GetSize()});
+    for (const auto& dir : GetSubdirectories())
+        listing->push_back({dir->GetName(), VfsEntryType::Directory, 0});
+    return listing;
+}
+
 std::string VfsDirectory::GetFullPath() const {
     if (IsRoot())
         return GetName();
@@ -531,6 +572,91 @@ bool VfsRawCopy(const VirtualFile& src, const VirtualFile& dest, std::size_t blo
     return true;
 }
 
+bool VfsPipelinedCopy(const VirtualFile& src, const VirtualFile& dest, std::size_t block_size,
+                      const VfsCopyBlockCallback& on_block,
+                      const VfsCopyProgressCallback& on_progress) {
+    if (src == nullptr || dest == nullptr || !src->IsReadable() || !dest->IsWritable())
+        return false;
+    const std::size_t size = src->GetSize();
+    if (!dest->Resize(size))
+        return false;
+
+    // A block is read again into its buffer once it has been written and passed to on_block
+    constexpr std::size_t NUM_BUFFERS = 4;
+    std::array<std::vector<u8>, NUM_BUFFERS> buffers;
+    block_size = std::max<std::size_t>(block_size, 1);
+    const std::size_t num_blocks = (size + block_size - 1) / block_size;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t num_read = 0;
+    std::size_t num_written = 0;
+    std::size_t num_processed = on_block ? 0 : num_blocks;
+    bool failed = false;
+
+    // Waits for the predicate, returns false if another stage failed in the meantime
+    const auto wait = [&](auto&& predicate) {
+        std::unique_lock lock{mutex};
+        cv.wait(lock, [&] { return failed || predicate(); });
+        return !failed;
+    };
+    const auto finish_block = [&](std::size_t& counter, bool success) {
+        {
+            std::lock_guard lock{mutex};
+            if (success) {
+                ++counter;
+            } else {
+                failed = true;
+            }
+        }
+        cv.notify_all();
+        return success;
+    };
+
+    std::thread reader([&] {
+        for (std::size_t block = 0; block < num_blocks; ++block) {
+            if (!wait([&] { return block - std::min(num_written, num_processed) < NUM_BUFFERS; }))
+                return;
+            auto& buffer = buffers[block % NUM_BUFFERS];
+            buffer.resize(std::min(block_size, size - block * block_size));
+            const bool success =
+                src->Read(buffer.data(), buffer.size(), block * block_size) == buffer.size();
+            if (!finish_block(num_read, success))
+                return;
+        }
+    });
+
+    std::thread processor;
+    if (on_block) {
+        processor = std::thread([&] {
+            for (std::size_t block = 0; block < num_blocks; ++block) {
+                if (!wait([&] { return block < num_read; }))
+                    return;
+                const auto& buffer = buffers[block % NUM_BUFFERS];
+                on_block(buffer.data(), buffer.size());
+                finish_block(num_processed, true);
+            }
+        });
+    }
+
+    for (std::size_t block = 0; block < num_blocks; ++block) {
+        if (!wait([&] { return block < num_read; }))
+            break;
+        const auto& buffer = buffers[block % NUM_BUFFERS];
+        const std::size_t offset = block * block_size;
+        const bool success = dest->Write(buffer.data(), buffer.size(), offset) == buffer.size() &&
+                             (!on_progress || on_progress(offset + buffer.size()));
+        if (!finish_block(num_written, success))
+            break;
+    }
+
+    reader.join();
+    if (processor.joinable()) {
+        processor.join();
+    }
+    return !failed;
+}
+
 bool VfsRawCopyD(const VirtualDir& src, const VirtualDir& dest, std::size_t block_size) {
     if (src == nullptr || dest == nullptr || !src->IsReadable() || !dest->IsWritable())
         return false;
@@ -27,6 +27,17 @@ enum class VfsEntryType {
     Directory,
 };
 
+// An entry of a directory listing, named without opening it
+struct VfsDirectoryEntry {
+    std::string name;
+    VfsEntryType type;
+    // Size of a file, 0 for a directory
+    u64 size;
+};
+
+// The files of a directory followed by its subdirectories, shared by the readers of the directory
+using VfsDirectoryListing = std::shared_ptr<const std::vector<VfsDirectoryEntry>>;
+
 // A class representing an abstract filesystem. A default implementation given the root VirtualDir
 // is provided for convenience, but if the Vfs implementation has any additional state or
 // functionality, they will need to override.
@@ -113,6 +124,16 @@ public:
     // 0)'
     virtual std::vector<u8> ReadAllBytes() const;
 
+    // Returns a pointer to the contents of the file when they are readable in host memory without
+    // a copy, nullptr otherwise. The pointer stays valid until the file is written to, resized or
+    // destroyed.
+    virtual const u8* GetData() const;
+
+    // Hints that length bytes starting at offset are about to be read, so that files keeping their
+    // contents in memory can load them ahead of time. May be called from another host thread than
+    // the one reading the file.
+    virtual void Prefetch(std::size_t offset, std::size_t length) const;
+
     // Reads an array of type T, size number_elements starting at offset.
     // Returns the number of bytes (sizeof(T)*number_elements) read successfully.
     template <typename T>
@@ -266,10 +287,20 @@ public:
     // dest.
     virtual bool Copy(std::string_view src, std::string_view dest);
 
+    // Returns whether or not the file with name src was successfully renamed to dest, replacing the
+    // file with name dest if there is one. Implementations replace it atomically where the host
+    // allows, the default one deletes dest first.
+    virtual bool Replace(std::string_view src, std::string_view dest);
+
     // Gets all of the entries directly in the directory (files and dirs), returning a map between
     // item name -> type.
     virtual std::map<std::string, VfsEntryType, std::less<>> GetEntries() const;
 
+    // Returns the files of this directory followed by its subdirectories, with the sizes of the
+    // files. Implementations that can list the entries without opening them do so, and may keep
+    // the listing until the directory is changed through the VFS.
+    virtual VfsDirectoryListing GetListing() const;
+
     // Returns the full path of this directory as a string, recursively
     virtual std::string GetFullPath() const;
 };
@@ -307,6 +338,19 @@ bool VfsRawCopy(const VirtualFile& src, const VirtualFile& dest, std::size_t blo
 // Copy should always be preferred.
 bool VfsRawCopyD(const VirtualDir& src, const VirtualDir& dest, std::size_t block_size = 0x1000);
 
+// Called by VfsPipelinedCopy with every block copied, in order.
+using VfsCopyBlockCallback = std::function<void(const u8* data, std::size_t size)>;
+
+// Called by VfsPipelinedCopy with the number of bytes written so far, returning false cancels.
+using VfsCopyProgressCallback = std::function<bool(std::size_t written)>;
+
+// Like VfsRawCopy, but reads on one thread while writing on the calling thread, so both overlap.
+// If on_block is set, it runs on a third thread alongside the writes, e.g. to hash the data.
+// on_progress is called on the calling thread after each block written.
+bool VfsPipelinedCopy(const VirtualFile& src, const VirtualFile& dest, std::size_t block_size,
+                      const VfsCopyBlockCallback& on_block = {},
+                      const VfsCopyProgressCallback& on_progress = {});
+
 // Checks if the directory at path relative to rel exists. If it does, returns that. If it does not
 // it attempts to create it and returns the new dir or nullptr on failure.
 VirtualDir GetOrCreateDirectoryRelative(const VirtualDir& rel, std::string_view path);
@@ -0,0 +1,198 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#include "common/logging/log.h"
+#include "core/file_sys/vfs_cached.h"
+
+namespace FileSys {
+
+namespace {
+/// Reads at least this long only use the blocks that are already cached, the rest is read straight
+/// into the output. They are usually streamed once and would evict the blocks that are read again.
+constexpr std::size_t MAX_CACHED_READ = CachedVfsFile::BLOCK_SIZE * 4;
+} // Anonymous namespace
+
+CachedVfsFile::CachedVfsFile(VirtualFile file_, std::size_t max_blocks_)
+    : file(std::move(file_)), size(file->GetSize()),
+      max_blocks(std::max<std::size_t>(max_blocks_, 1)) {}
+
+CachedVfsFile::~CachedVfsFile() {
+    if (hits + misses != 0) {
+        LOG_DEBUG(Service_FS,
+                  "Block cache of {}: {} hits, {} misses ({:.1f}% hit rate), {} prefetched",
+                  file->GetName(), hits, misses, hits * 100.0 / (hits + misses), prefetches);
+    }
+}
+
+std::string CachedVfsFile::GetName() const {
+    return file->GetName();
+}
+
+std::size_t CachedVfsFile::GetSize() const {
+    return size;
+}
+
+bool CachedVfsFile::Resize(std::size_t new_size) {
+    return false;
+}
+
+std::shared_ptr<VfsDirectory> CachedVfsFile::GetContainingDirectory() const {
+    return file->GetContainingDirectory();
+}
+
+bool CachedVfsFile::IsWritable() const {
+    return false;
+}
+
+bool CachedVfsFile::IsReadable() const {
+    return true;
+}
+
+std::size_t CachedVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    if (offset >= size) {
+        return 0;
+    }
+    length = std::min(length, size - offset);
+    const bool is_large = length >= MAX_CACHED_READ;
+
+    std::unique_lock lock{mutex};
+    std::size_t read = 0;
+    while (read < length) {
+        const std::size_t position = offset + read;
+        const std::size_t index = position / BLOCK_SIZE;
+        if (pending_blocks.count(index) != 0) {
+            // Another thread is reading it, likely ahead of this one
+            pending_cv.wait(lock, [&] { return pending_blocks.count(index) == 0; });
+            continue;
+        }
+
+        const Block* block = nullptr;
+        const auto iter = block_map.find(index);
+        if (iter != block_map.end()) {
+            ++hits;
+            blocks.splice(blocks.begin(), blocks, iter->second);
+            block = &blocks.front();
+        } else if (is_large) {
+            // Read up to the next block that is cached or pending straight into the output
+            const std::size_t last_index = (offset + length - 1) / BLOCK_SIZE;
+            std::size_t end_index = index + 1;
+            while (end_index <= last_index && block_map.count(end_index) == 0 &&
+                   pending_blocks.count(end_index) == 0) {
+                ++end_index;
+            }
+            misses += end_index - index;
+            const std::size_t run_size = std::min(length - read, end_index * BLOCK_SIZE - position);
+
+            lock.unlock();
+            std::size_t run_read;
+            {
+                std::lock_guard file_lock{file_mutex};
+                run_read = file->Read(data + read, run_size, position);
+            }
+            lock.lock();
+
+            read += run_read;
+            if (run_read < run_size) {
+                break;
+            }
+            continue;
+        } else {
+            ++misses;
+            pending_blocks.insert(index);
+            lock.unlock();
+            std::vector<u8> block_data = ReadBlock(index);
+            lock.lock();
+            pending_blocks.erase(index);
+            pending_cv.notify_all();
+            block = &InsertBlock(index, std::move(block_data));
+        }
+
+        const std::size_t block_offset = position % BLOCK_SIZE;
+        if (block_offset >= block->data.size()) {
+            break;
+        }
+        const std::size_t copy_size = std::min(length - read, block->data.size() - block_offset);
+        std::memcpy(data + read, block->data.data() + block_offset, copy_size);
+        read += copy_size;
+    }
+    return read;
+}
+
+std::size_t CachedVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
+    return 0;
+}
+
+bool CachedVfsFile::Rename(std::string_view name) {
+    return false;
+}
+
+void CachedVfsFile::Prefetch(std::size_t offset, std::size_t length) const {
+    if (offset >= size || length == 0) {
+        return;
+    }
+    length = std::min(length, size - offset);
+    // Leave room for the blocks that are being read, prefetching the whole cache would evict them
+    const std::size_t num_blocks = std::max<std::size_t>(max_blocks / 2, 1);
+    const std::size_t first_index = offset / BLOCK_SIZE;
+    const std::size_t last_index =
+        std::min((offset + length - 1) / BLOCK_SIZE, first_index + num_blocks - 1);
+
+    for (std::size_t index = first_index; index <= last_index; ++index) {
+        {
+            std::lock_guard lock{mutex};
+            if (block_map.count(index) != 0 || pending_blocks.count(index) != 0) {
+                continue;
+            }
+            pending_blocks.insert(index);
+        }
+        std::vector<u8> block_data = ReadBlock(index);
+        {
+            std::lock_guard lock{mutex};
+            pending_blocks.erase(index);
+            InsertBlock(index, std::move(block_data));
+            ++prefetches;
+        }
+        pending_cv.notify_all();
+    }
+}
+
+u64 CachedVfsFile::GetHits() const {
+    std::lock_guard lock{mutex};
+    return hits;
+}
+
+u64 CachedVfsFile::GetMisses() const {
+    std::lock_guard lock{mutex};
+    return misses;
+}
+
+u64 CachedVfsFile::GetPrefetches() const {
+    std::lock_guard lock{mutex};
+    return prefetches;
+}
+
+std::vector<u8> CachedVfsFile::ReadBlock(std::size_t index) const {
+    std::vector<u8> data(std::min(BLOCK_SIZE, size - index * BLOCK_SIZE));
+    std::lock_guard lock{file_mutex};
+    data.resize(file->Read(data.data(), data.size(), index * BLOCK_SIZE));
+    return data;
+}
+
+const CachedVfsFile::Block& CachedVfsFile::InsertBlock(std::size_t index,
+                                                       std::vector<u8> data) const {
+    if (blocks.size() >= max_blocks) {
+        block_map.erase(blocks.back().index);
+        blocks.pop_back();
+    }
+    blocks.push_front({index, std::move(data)});
+    block_map.emplace(index, blocks.begin());
+    return blocks.front();
+}
+
+} // namespace FileSys
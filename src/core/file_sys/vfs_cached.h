@@ -0,0 +1,83 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/file_sys/vfs.h"
+
+namespace FileSys {
+
+// An implementation of VfsFile that keeps the most recently read blocks of a read-only VfsFile in
+// memory. Used on top of decrypting layers (CTR sections, BKTR patches), where every read of the
+// wrapped file pays for AES and relocation lookups again. Blocks can be loaded ahead of a reader
+// from another thread with Prefetch, the reads of the wrapped file are serialized.
+class CachedVfsFile : public VfsFile {
+public:
+    static constexpr std::size_t BLOCK_SIZE = 0x8000;
+    static constexpr std::size_t DEFAULT_MAX_BLOCKS = 64;
+
+    explicit CachedVfsFile(VirtualFile file, std::size_t max_blocks = DEFAULT_MAX_BLOCKS);
+    ~CachedVfsFile() override;
+
+    std::string GetName() const override;
+    std::size_t GetSize() const override;
+    bool Resize(std::size_t new_size) override;
+    std::shared_ptr<VfsDirectory> GetContainingDirectory() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    bool Rename(std::string_view name) override;
+    void Prefetch(std::size_t offset, std::size_t length) const override;
+
+    /// Number of block lookups served from memory.
+    u64 GetHits() const;
+    /// Number of block lookups that had to read the wrapped file.
+    u64 GetMisses() const;
+    /// Number of blocks loaded by Prefetch.
+    u64 GetPrefetches() const;
+
+private:
+    struct Block {
+        std::size_t index;
+        std::vector<u8> data;
+    };
+
+    /// Reads a block from the wrapped file. Must be called without holding the mutex.
+    std::vector<u8> ReadBlock(std::size_t index) const;
+
+    /// Adds a block as the most recently used one, evicting the least recently used if the cache
+    /// is full. Requires the mutex.
+    const Block& InsertBlock(std::size_t index, std::vector<u8> data) const;
+
+    VirtualFile file;
+    std::size_t size;
+    std::size_t max_blocks;
+
+    mutable std::mutex mutex;
+    /// Notified when blocks stop being pending
+    mutable std::condition_variable pending_cv;
+    // Most recently used first
+    mutable std::list<Block> blocks;
+    mutable std::unordered_map<std::size_t, std::list<Block>::iterator> block_map;
+    /// Blocks being read from the wrapped file by some thread
+    mutable std::unordered_set<std::size_t> pending_blocks;
+    mutable u64 hits = 0;
+    mutable u64 misses = 0;
+    mutable u64 prefetches = 0;
+
+    /// Held while reading the wrapped file, decrypting layers keep state across reads.
+    mutable std::mutex file_mutex;
+};
+
+} // namespace FileSys
@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <string>
+#include <unordered_set>
 #include <utility>
 #include "core/file_sys/vfs_layered.h"
 
@@ -58,13 +60,13 @@ std::string LayeredVfsDirectory::GetFullPath() const {
 }
 
 std::vector<std::shared_ptr<VfsFile>> LayeredVfsDirectory::GetFiles() const {
+    // Files of the upper layers hide the ones with the same name below them
     std::vector<VirtualFile> out;
+    std::unordered_set<std::string> names;
     for (const auto& layer : dirs) {
-        for (const auto& file : layer->GetFiles()) {
-            if (std::find_if(out.begin(), out.end(), [&file](const VirtualFile& comp) {
-                    return comp->GetName() == file->GetName();
-                }) == out.end()) {
-                out.push_back(file);
+        for (auto& file : layer->GetFiles()) {
+            if (names.insert(file->GetName()).second) {
+                out.push_back(std::move(file));
             }
         }
     }
@@ -74,10 +76,12 @@ std::vector<std::shared_ptr<VfsFile>> LayeredVfsDirectory::GetFiles() const {
 
 std::vector<std::shared_ptr<VfsDirectory>> LayeredVfsDirectory::GetSubdirectories() const {
     std::vector<std::string> names;
+    std::unordered_set<std::string> seen_names;
     for (const auto& layer : dirs) {
         for (const auto& sd : layer->GetSubdirectories()) {
-            if (std::find(names.begin(), names.end(), sd->GetName()) == names.end())
-                names.push_back(sd->GetName());
+            auto name = sd->GetName();
+            if (seen_names.insert(name).second)
+                names.push_back(std::move(name));
         }
     }
 
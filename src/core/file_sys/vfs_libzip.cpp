@@ -2,38 +2,308 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <zip.h>
-#include "common/logging/backend.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
 #include "core/file_sys/vfs.h"
 #include "core/file_sys/vfs_libzip.h"
+#include "core/file_sys/vfs_offset.h"
 #include "core/file_sys/vfs_vector.h"
 
 namespace FileSys {
 
-VirtualDir ExtractZIP(VirtualFile file) {
+namespace {
+
+constexpr u32 LOCAL_HEADER_MAGIC = 0x04034B50;
+constexpr u32 CENTRAL_DIRECTORY_MAGIC = 0x02014B50;
+constexpr u32 END_OF_CENTRAL_DIRECTORY_MAGIC = 0x06054B50;
+
+constexpr std::size_t LOCAL_HEADER_SIZE = 30;
+constexpr std::size_t CENTRAL_DIRECTORY_HEADER_SIZE = 46;
+constexpr std::size_t END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+constexpr std::size_t MAX_COMMENT_SIZE = 0xFFFF;
+
+/// Marks the fields that are stored in the zip64 extra field instead.
+constexpr u32 ZIP64_FIELD = 0xFFFFFFFF;
+
+/// Reads a little endian field of a zip header.
+template <typename T>
+T ReadField(const std::vector<u8>& data, std::size_t offset) {
+    T value{};
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+/// Returns the offsets of the local headers in central directory order, the order libzip indexes
+/// the entries in. Returns empty when the archive is not understood, e.g. zip64 archives.
+std::vector<u64> GetLocalHeaderOffsets(const VfsFile& file) {
+    const std::size_t file_size = file.GetSize();
+    if (file_size < END_OF_CENTRAL_DIRECTORY_SIZE) {
+        return {};
+    }
+    const std::size_t tail_size =
+        std::min(file_size, END_OF_CENTRAL_DIRECTORY_SIZE + MAX_COMMENT_SIZE);
+    const std::vector<u8> tail = file.ReadBytes(tail_size, file_size - tail_size);
+    if (tail.size() != tail_size) {
+        return {};
+    }
+
+    // The end of central directory record is followed by a comment of variable size
+    std::size_t end_offset = tail_size - END_OF_CENTRAL_DIRECTORY_SIZE;
+    while (ReadField<u32>(tail, end_offset) != END_OF_CENTRAL_DIRECTORY_MAGIC) {
+        if (end_offset-- == 0) {
+            return {};
+        }
+    }
+
+    const u16 num_entries = ReadField<u16>(tail, end_offset + 10);
+    const u32 directory_size = ReadField<u32>(tail, end_offset + 12);
+    const u32 directory_offset = ReadField<u32>(tail, end_offset + 16);
+    if (num_entries == 0xFFFF || directory_offset == ZIP64_FIELD ||
+        u64{directory_offset} + directory_size > file_size) {
+        return {};
+    }
+
+    const std::vector<u8> directory = file.ReadBytes(directory_size, directory_offset);
+    if (directory.size() != directory_size) {
+        return {};
+    }
+    std::vector<u64> offsets;
+    offsets.reserve(num_entries);
+    std::size_t offset = 0;
+    while (offsets.size() < num_entries) {
+        if (directory.size() - offset < CENTRAL_DIRECTORY_HEADER_SIZE ||
+            ReadField<u32>(directory, offset) != CENTRAL_DIRECTORY_MAGIC) {
+            return {};
+        }
+        const u16 name_size = ReadField<u16>(directory, offset + 28);
+        const u16 extra_size = ReadField<u16>(directory, offset + 30);
+        const u16 comment_size = ReadField<u16>(directory, offset + 32);
+        offsets.push_back(ReadField<u32>(directory, offset + 42));
+        offset += CENTRAL_DIRECTORY_HEADER_SIZE + name_size + extra_size + comment_size;
+    }
+    return offsets;
+}
+
+/// Returns where the data of an entry begins from the offset of its local header, or empty.
+std::optional<u64> GetDataOffset(const VfsFile& file, u64 local_header_offset) {
+    if (local_header_offset == ZIP64_FIELD) {
+        return {};
+    }
+    const std::vector<u8> header = file.ReadBytes(LOCAL_HEADER_SIZE, local_header_offset);
+    if (header.size() != LOCAL_HEADER_SIZE || ReadField<u32>(header, 0) != LOCAL_HEADER_MAGIC) {
+        return {};
+    }
+    const u16 name_size = ReadField<u16>(header, 26);
+    const u16 extra_size = ReadField<u16>(header, 28);
+    return local_header_offset + LOCAL_HEADER_SIZE + name_size + extra_size;
+}
+
+/// Archive shared by the files of an extracted zip. libzip handles are not thread safe, every
+/// use of them is guarded by the mutex.
+struct ZipArchive {
+    ~ZipArchive() {
+        stream.reset();
+        zip.reset();
+        zip_error_fini(&error);
+    }
+
+    /// Source callback of libzip, reads the archive from the backing file on demand.
+    static zip_int64_t ReadSource(void* userdata, void* data, zip_uint64_t length,
+                                  zip_source_cmd_t command) {
+        auto& archive = *static_cast<ZipArchive*>(userdata);
+        switch (command) {
+        case ZIP_SOURCE_OPEN:
+            archive.position = 0;
+            return 0;
+        case ZIP_SOURCE_READ: {
+            const std::size_t read =
+                archive.file->Read(static_cast<u8*>(data), length, archive.position);
+            archive.position += read;
+            return static_cast<zip_int64_t>(read);
+        }
+        case ZIP_SOURCE_CLOSE:
+        case ZIP_SOURCE_FREE:
+            return 0;
+        case ZIP_SOURCE_STAT: {
+            auto* const stat = static_cast<zip_stat_t*>(data);
+            zip_stat_init(stat);
+            stat->size = archive.file->GetSize();
+            stat->valid |= ZIP_STAT_SIZE;
+            return sizeof(zip_stat_t);
+        }
+        case ZIP_SOURCE_ERROR:
+            return zip_error_to_data(&archive.error, data, length);
+        case ZIP_SOURCE_SEEK: {
+            const zip_int64_t position = zip_source_seek_compute_offset(
+                archive.position, archive.file->GetSize(), data, length, &archive.error);
+            if (position < 0) {
+                return -1;
+            }
+            archive.position = static_cast<u64>(position);
+            return 0;
+        }
+        case ZIP_SOURCE_TELL:
+            return static_cast<zip_int64_t>(archive.position);
+        case ZIP_SOURCE_SUPPORTS:
+            return zip_source_make_command_bitmap(
+                ZIP_SOURCE_OPEN, ZIP_SOURCE_READ, ZIP_SOURCE_CLOSE, ZIP_SOURCE_STAT,
+                ZIP_SOURCE_ERROR, ZIP_SOURCE_FREE, ZIP_SOURCE_SEEK, ZIP_SOURCE_TELL,
+                ZIP_SOURCE_SUPPORTS, -1);
+        default:
+            zip_error_set(&archive.error, ZIP_ER_OPNOTSUPP, 0);
+            return -1;
+        }
+    }
+
+    std::mutex mutex;
+    VirtualFile file;
+    u64 position = 0;
     zip_error_t error{};
+    std::unique_ptr<zip_t, decltype(&zip_discard)> zip{nullptr, zip_discard};
+
+    // The last entry read, compressed entries can only be read forward so a single decompression
+    // stream is kept to continue sequential reads. Closed before the archive is.
+    std::unique_ptr<zip_file_t, decltype(&zip_fclose)> stream{nullptr, zip_fclose};
+    u64 stream_index = 0;
+    u64 stream_position = 0;
+};
+
+/// A compressed entry of a zip archive, decompressed when it is read.
+class ZipVfsFile final : public VfsFile {
+public:
+    explicit ZipVfsFile(std::shared_ptr<ZipArchive> archive, u64 index, std::size_t size,
+                        std::string name)
+        : archive{std::move(archive)}, index{index}, size{size}, name{std::move(name)} {}
+
+    ~ZipVfsFile() override = default;
+
+    std::string GetName() const override {
+        return name;
+    }
+
+    std::size_t GetSize() const override {
+        return size;
+    }
+
+    bool Resize(std::size_t new_size) override {
+        return false;
+    }
+
+    std::shared_ptr<VfsDirectory> GetContainingDirectory() const override {
+        return nullptr;
+    }
+
+    bool IsWritable() const override {
+        return false;
+    }
+
+    bool IsReadable() const override {
+        return true;
+    }
 
-    const auto data = file->ReadAllBytes();
-    std::unique_ptr<zip_source_t, decltype(&zip_source_close)> src{
-        zip_source_buffer_create(data.data(), data.size(), 0, &error), zip_source_close};
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override {
+        if (offset >= size) {
+            return 0;
+        }
+        length = std::min(length, size - offset);
+
+        std::lock_guard lock{archive->mutex};
+        if (!SeekStream(offset)) {
+            return 0;
+        }
+        const zip_int64_t read = zip_fread(archive->stream.get(), data, length);
+        if (read < 0) {
+            archive->stream.reset();
+            return 0;
+        }
+        archive->stream_position += static_cast<u64>(read);
+        if (archive->stream_position == size) {
+            // Don't hold the decompression state of entries that were read whole
+            archive->stream.reset();
+        }
+        return static_cast<std::size_t>(read);
+    }
+
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override {
+        return 0;
+    }
+
+    bool Rename(std::string_view new_name) override {
+        return false;
+    }
+
+private:
+    /// Moves the decompression stream of the archive to offset in this entry.
+    bool SeekStream(std::size_t offset) const {
+        if (!archive->stream || archive->stream_index != index ||
+            archive->stream_position > offset) {
+            archive->stream.reset(zip_fopen_index(archive->zip.get(), index, 0));
+            archive->stream_index = index;
+            archive->stream_position = 0;
+            if (!archive->stream) {
+                LOG_ERROR(Service_FS, "Failed to open zip entry {}", name);
+                return false;
+            }
+        }
+        std::array<u8, 0x4000> discarded;
+        while (archive->stream_position < offset) {
+            const std::size_t skip = std::min<std::size_t>(discarded.size(),
+                                                           offset - archive->stream_position);
+            const zip_int64_t read = zip_fread(archive->stream.get(), discarded.data(), skip);
+            if (read <= 0) {
+                archive->stream.reset();
+                return false;
+            }
+            archive->stream_position += static_cast<u64>(read);
+        }
+        return true;
+    }
+
+    std::shared_ptr<ZipArchive> archive;
+    u64 index;
+    std::size_t size;
+    std::string name;
+};
+
+} // Anonymous namespace
+
+VirtualDir ExtractZIP(VirtualFile file) {
+    auto archive = std::make_shared<ZipArchive>();
+    archive->file = file;
+    zip_error_init(&archive->error);
+
+    zip_error_t error{};
+    zip_source_t* const src = zip_source_function_create(&ZipArchive::ReadSource, archive.get(),
+                                                         &error);
     if (src == nullptr)
         return nullptr;
 
-    std::unique_ptr<zip_t, decltype(&zip_close)> zip{zip_open_from_source(src.get(), 0, &error),
-                                                     zip_close};
-    if (zip == nullptr)
+    archive->zip.reset(zip_open_from_source(src, ZIP_RDONLY, &error));
+    if (archive->zip == nullptr) {
+        // The archive only takes the source on success
+        zip_source_free(src);
         return nullptr;
+    }
+    zip_t* const zip = archive->zip.get();
 
     std::shared_ptr<VectorVfsDirectory> out = std::make_shared<VectorVfsDirectory>();
 
-    const auto num_entries = zip_get_num_entries(zip.get(), 0);
+    const auto num_entries = zip_get_num_entries(zip, 0);
+    const std::vector<u64> local_header_offsets = GetLocalHeaderOffsets(*file);
 
     zip_stat_t stat{};
     zip_stat_init(&stat);
 
     for (std::size_t i = 0; i < num_entries; ++i) {
-        const auto stat_res = zip_stat_index(zip.get(), i, 0, &stat);
+        const auto stat_res = zip_stat_index(zip, i, 0, &stat);
         if (stat_res == -1)
             return nullptr;
 
@@ -42,15 +312,21 @@ VirtualDir ExtractZIP(VirtualFile file) {
             continue;
 
         if (name.back() != '/') {
-            std::unique_ptr<zip_file_t, decltype(&zip_fclose)> file{
-                zip_fopen_index(zip.get(), i, 0), zip_fclose};
-
-            std::vector<u8> buf(stat.size);
-            if (zip_fread(file.get(), buf.data(), buf.size()) != buf.size())
-                return nullptr;
-
             const auto parts = FileUtil::SplitPathComponents(stat.name);
-            const auto new_file = std::make_shared<VectorVfsFile>(buf, parts.back());
+
+            // Stored entries are views of the archive, the others are decompressed when read
+            std::optional<u64> data_offset;
+            if (stat.comp_method == ZIP_CM_STORE && stat.encryption_method == ZIP_EM_NONE &&
+                i < local_header_offsets.size()) {
+                data_offset = GetDataOffset(*file, local_header_offsets[i]);
+            }
+            VirtualFile new_file;
+            if (data_offset && *data_offset + stat.size <= file->GetSize()) {
+                new_file = std::make_shared<OffsetVfsFile>(file, stat.size, *data_offset,
+                                                           parts.back());
+            } else {
+                new_file = std::make_shared<ZipVfsFile>(archive, i, stat.size, parts.back());
+            }
 
             std::shared_ptr<VectorVfsDirectory> dtrv = out;
             for (std::size_t j = 0; j < parts.size() - 1; ++j) {
@@ -8,6 +8,8 @@
 
 namespace FileSys {
 
+/// Opens a zip archive as a directory without extracting it. Stored entries are views of the
+/// archive and compressed entries are decompressed from it when they are read.
 VirtualDir ExtractZIP(VirtualFile zip);
 
 } // namespace FileSys
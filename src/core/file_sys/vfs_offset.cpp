@@ -72,6 +72,21 @@ std::vector<u8> OffsetVfsFile::ReadAllBytes() const {
     return file->ReadBytes(size, offset);
 }
 
+const u8* OffsetVfsFile::GetData() const {
+    const u8* const data = file->GetData();
+    // Views reaching past the end of the parent can't expose their full size
+    if (data == nullptr || offset + size > file->GetSize()) {
+        return nullptr;
+    }
+    return data + offset;
+}
+
+void OffsetVfsFile::Prefetch(std::size_t r_offset, std::size_t length) const {
+    if (r_offset < size) {
+        file->Prefetch(offset + r_offset, TrimToFit(length, r_offset));
+    }
+}
+
 bool OffsetVfsFile::WriteByte(u8 data, std::size_t r_offset) {
     if (r_offset < size)
         return file->WriteByte(data, offset + r_offset);
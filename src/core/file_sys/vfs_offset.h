@@ -32,6 +32,8 @@ public:
     std::optional<u8> ReadByte(std::size_t offset) const override;
     std::vector<u8> ReadBytes(std::size_t size, std::size_t offset) const override;
     std::vector<u8> ReadAllBytes() const override;
+    const u8* GetData() const override;
+    void Prefetch(std::size_t offset, std::size_t length) const override;
     bool WriteByte(u8 data, std::size_t offset) override;
     std::size_t WriteBytes(const std::vector<u8>& data, std::size_t offset) override;
 
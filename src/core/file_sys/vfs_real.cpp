@@ -4,7 +4,10 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <iterator>
+#include <map>
+#include <mutex>
 #include <utility>
 #include "common/assert.h"
 #include "common/common_paths.h"
@@ -39,6 +42,93 @@ static std::string ModeFlagsToString(Mode mode) {
     return mode_str;
 }
 
+namespace {
+// Listings of the host directories, keyed by their path without a trailing separator. They are
+// shared by all the filesystems, as these all see the same host directories, and are dropped when
+// an entry is created, deleted, moved or written through the VFS. Changes made to the host
+// directories from outside of the VFS aren't seen until then.
+std::mutex listing_mutex;
+std::map<std::string, VfsDirectoryListing, std::less<>> listings;
+// Incremented on every invalidation, a scan only caches its listing if nothing was invalidated
+// while it ran
+u64 listing_generation = 0;
+} // Anonymous namespace
+
+template <typename SizeGetter>
+static VfsDirectoryListing GetHostListing(const std::string& path, SizeGetter&& get_size) {
+    u64 generation;
+    {
+        std::lock_guard lock{listing_mutex};
+        const auto iter = listings.find(path);
+        if (iter != listings.end())
+            return iter->second;
+        generation = listing_generation;
+    }
+
+    // Listing a directory opens none of its files
+    auto listing = std::make_shared<std::vector<VfsDirectoryEntry>>();
+    std::vector<VfsDirectoryEntry> directories;
+    FileUtil::ForeachDirectoryEntry(
+        nullptr, path,
+        [&](u64* entries_out, const std::string& directory, const std::string& filename) {
+            const std::string full_path = directory + DIR_SEP + filename;
+            if (FileUtil::IsDirectory(full_path))
+                directories.push_back({filename, VfsEntryType::Directory, 0});
+            else
+                listing->push_back({filename, VfsEntryType::File, get_size(full_path)});
+            return true;
+        });
+    listing->insert(listing->end(), std::make_move_iterator(directories.begin()),
+                    std::make_move_iterator(directories.end()));
+
+    std::lock_guard lock{listing_mutex};
+    if (generation == listing_generation)
+        listings.insert_or_assign(path, listing);
+    return listing;
+}
+
+/// Drops the listing of a directory, after the size of one of its files changed.
+static void InvalidateListing(std::string_view path) {
+    std::lock_guard lock{listing_mutex};
+    ++listing_generation;
+    const auto iter = listings.find(path);
+    if (iter != listings.end())
+        listings.erase(iter);
+}
+
+/// Drops the listings of the directories above a path, after an entry was created or removed
+/// there. The parents of a created entry may have been created along with it.
+static void InvalidateParentListings(std::string_view path) {
+    std::lock_guard lock{listing_mutex};
+    ++listing_generation;
+    std::string_view current = FileUtil::RemoveTrailingSlash(path);
+    while (true) {
+        const std::string_view parent = FileUtil::GetParentPath(current);
+        if (parent.size() >= current.size())
+            break;
+        const auto iter = listings.find(parent);
+        if (iter != listings.end())
+            listings.erase(iter);
+        current = parent;
+    }
+}
+
+/// Drops the listings of a directory and of all the directories below it.
+static void InvalidateListingTree(std::string_view path_) {
+    std::lock_guard lock{listing_mutex};
+    ++listing_generation;
+    const std::string_view path = FileUtil::RemoveTrailingSlash(path_);
+    auto iter = listings.lower_bound(path);
+    while (iter != listings.end() && iter->first.compare(0, path.size(), path) == 0) {
+        // Siblings with a longer name share the prefix but not the separator
+        const std::string& key = iter->first;
+        if (key.size() == path.size() || key[path.size()] == '/' || key[path.size()] == '\\')
+            iter = listings.erase(iter);
+        else
+            ++iter;
+    }
+}
+
 RealVfsFilesystem::RealVfsFilesystem() : VfsFilesystem(nullptr) {}
 RealVfsFilesystem::~RealVfsFilesystem() = default;
 
@@ -66,21 +156,59 @@ VfsEntryType RealVfsFilesystem::GetEntryType(std::string_view path_) const {
 
 VirtualFile RealVfsFilesystem::OpenFile(std::string_view path_, Mode perms) {
     const auto path = FileUtil::SanitizePath(path_, FileUtil::DirectorySeparator::PlatformDefault);
+    if ((perms & Mode::WriteAppend) != 0) {
+        // The file may change size, later read-only opens map it again
+        mapped_cache.erase(path);
+    }
+    auto mapping = perms == Mode::Read ? MapFile(path) : nullptr;
+
     if (cache.find(path) != cache.end()) {
         auto weak = cache[path];
         if (!weak.expired()) {
-            return std::shared_ptr<RealVfsFile>(new RealVfsFile(*this, weak.lock(), path, perms));
+            return std::shared_ptr<RealVfsFile>(
+                new RealVfsFile(*this, weak.lock(), std::move(mapping), path, perms));
         }
     }
 
-    if (!FileUtil::Exists(path) && (perms & Mode::WriteAppend) != 0)
+    if (!FileUtil::Exists(path) && (perms & Mode::WriteAppend) != 0) {
         FileUtil::CreateEmptyFile(path);
+        InvalidateParentListings(path);
+    }
 
     auto backing = std::make_shared<FileUtil::IOFile>(path, ModeFlagsToString(perms).c_str());
     cache[path] = backing;
 
     // Cannot use make_shared as RealVfsFile constructor is private
-    return std::shared_ptr<RealVfsFile>(new RealVfsFile(*this, backing, path, perms));
+    return std::shared_ptr<RealVfsFile>(
+        new RealVfsFile(*this, backing, std::move(mapping), path, perms));
+}
+
+std::shared_ptr<FileUtil::MappedFile> RealVfsFilesystem::MapFile(const std::string& path) {
+    const auto iter = mapped_cache.find(path);
+    if (iter != mapped_cache.end()) {
+        if (auto mapping = iter->second.lock()) {
+            return mapping;
+        }
+    }
+
+    auto mapping = std::make_shared<FileUtil::MappedFile>();
+    if (!mapping->Open(path)) {
+        // Empty files and files the host can't map are read through the backing file
+        mapped_cache.erase(path);
+        return nullptr;
+    }
+    mapped_cache[path] = mapping;
+    return mapping;
+}
+
+u64 RealVfsFilesystem::GetFileSize(const std::string& path_) const {
+    const auto path = FileUtil::SanitizePath(path_, FileUtil::DirectorySeparator::PlatformDefault);
+    const auto iter = cache.find(path);
+    if (iter != cache.end()) {
+        if (const auto file = iter->second.lock())
+            return file->GetSize();
+    }
+    return FileUtil::GetSize(path);
 }
 
 VirtualFile RealVfsFilesystem::CreateFile(std::string_view path_, Mode perms) {
@@ -88,6 +216,7 @@ VirtualFile RealVfsFilesystem::CreateFile(std::string_view path_, Mode perms) {
     const auto path_fwd = FileUtil::SanitizePath(path, FileUtil::DirectorySeparator::ForwardSlash);
     if (!FileUtil::Exists(path)) {
         FileUtil::CreateFullPath(path_fwd);
+        InvalidateParentListings(path);
         if (!FileUtil::CreateEmptyFile(path))
             return nullptr;
     }
@@ -103,6 +232,7 @@ VirtualFile RealVfsFilesystem::CopyFile(std::string_view old_path_, std::string_
     if (!FileUtil::Exists(old_path) || FileUtil::Exists(new_path) ||
         FileUtil::IsDirectory(old_path) || !FileUtil::Copy(old_path, new_path))
         return nullptr;
+    InvalidateParentListings(new_path);
     return OpenFile(new_path, Mode::ReadWrite);
 }
 
@@ -115,6 +245,8 @@ VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_
     if (!FileUtil::Exists(old_path) || FileUtil::Exists(new_path) ||
         FileUtil::IsDirectory(old_path) || !FileUtil::Rename(old_path, new_path))
         return nullptr;
+    InvalidateParentListings(old_path);
+    InvalidateParentListings(new_path);
 
     if (cache.find(old_path) != cache.end()) {
         auto cached = cache[old_path];
@@ -125,6 +257,50 @@ VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_
             cache[new_path] = file;
         }
     }
+    mapped_cache.erase(old_path);
+    return OpenFile(new_path, Mode::ReadWrite);
+}
+
+VirtualFile RealVfsFilesystem::ReplaceFile(std::string_view old_path_,
+                                           std::string_view new_path_) {
+    const auto old_path =
+        FileUtil::SanitizePath(old_path_, FileUtil::DirectorySeparator::PlatformDefault);
+    const auto new_path =
+        FileUtil::SanitizePath(new_path_, FileUtil::DirectorySeparator::PlatformDefault);
+
+    if (!FileUtil::Exists(old_path) || FileUtil::IsDirectory(old_path) ||
+        FileUtil::IsDirectory(new_path))
+        return nullptr;
+
+    // Some hosts can't replace a file that is still open
+    std::shared_ptr<FileUtil::IOFile> replaced;
+    const auto replaced_iter = cache.find(new_path);
+    if (replaced_iter != cache.end()) {
+        replaced = replaced_iter->second.lock();
+        if (replaced != nullptr)
+            replaced->Close();
+    }
+
+    if (!FileUtil::Replace(old_path, new_path)) {
+        if (replaced != nullptr)
+            replaced->Open(new_path, "r+b");
+        return nullptr;
+    }
+    InvalidateParentListings(old_path);
+    InvalidateParentListings(new_path);
+    cache.erase(new_path);
+    mapped_cache.erase(new_path);
+
+    if (cache.find(old_path) != cache.end()) {
+        auto cached = cache[old_path];
+        if (!cached.expired()) {
+            auto file = cached.lock();
+            file->Open(new_path, "r+b");
+            cache[new_path] = file;
+        }
+        cache.erase(old_path);
+    }
+    mapped_cache.erase(old_path);
     return OpenFile(new_path, Mode::ReadWrite);
 }
 
@@ -135,6 +311,8 @@ bool RealVfsFilesystem::DeleteFile(std::string_view path_) {
             cache[path].lock()->Close();
         cache.erase(path);
     }
+    mapped_cache.erase(path);
+    InvalidateParentListings(path);
     return FileUtil::Delete(path);
 }
 
@@ -149,6 +327,8 @@ VirtualDir RealVfsFilesystem::CreateDirectory(std::string_view path_, Mode perms
     const auto path_fwd = FileUtil::SanitizePath(path, FileUtil::DirectorySeparator::ForwardSlash);
     if (!FileUtil::Exists(path)) {
         FileUtil::CreateFullPath(path_fwd);
+        InvalidateParentListings(path);
+        InvalidateListingTree(path);
         if (!FileUtil::CreateDir(path))
             return nullptr;
     }
@@ -166,6 +346,8 @@ VirtualDir RealVfsFilesystem::CopyDirectory(std::string_view old_path_,
         !FileUtil::IsDirectory(old_path))
         return nullptr;
     FileUtil::CopyDir(old_path, new_path);
+    InvalidateParentListings(new_path);
+    InvalidateListingTree(new_path);
     return OpenDirectory(new_path, Mode::ReadWrite);
 }
 
@@ -178,6 +360,10 @@ VirtualDir RealVfsFilesystem::MoveDirectory(std::string_view old_path_,
     if (!FileUtil::Exists(old_path) || FileUtil::Exists(new_path) ||
         FileUtil::IsDirectory(old_path) || !FileUtil::Rename(old_path, new_path))
         return nullptr;
+    InvalidateParentListings(old_path);
+    InvalidateParentListings(new_path);
+    InvalidateListingTree(old_path);
+    InvalidateListingTree(new_path);
 
     for (auto& kv : cache) {
         // Path in cache starts with old_path
@@ -197,6 +383,9 @@ VirtualDir RealVfsFilesystem::MoveDirectory(std::string_view old_path_,
         }
     }
 
+    for (auto iter = mapped_cache.begin(); iter != mapped_cache.end();) {
+        iter = iter->first.rfind(old_path, 0) == 0 ? mapped_cache.erase(iter) : std::next(iter);
+    }
     return OpenDirectory(new_path, Mode::ReadWrite);
 }
 
@@ -210,12 +399,18 @@ bool RealVfsFilesystem::DeleteDirectory(std::string_view path_) {
             cache.erase(kv.first);
         }
     }
+    for (auto iter = mapped_cache.begin(); iter != mapped_cache.end();) {
+        iter = iter->first.rfind(path, 0) == 0 ? mapped_cache.erase(iter) : std::next(iter);
+    }
+    InvalidateParentListings(path);
+    InvalidateListingTree(path);
     return FileUtil::DeleteDirRecursively(path);
 }
 
 RealVfsFile::RealVfsFile(RealVfsFilesystem& base_, std::shared_ptr<FileUtil::IOFile> backing_,
-                         const std::string& path_, Mode perms_)
-    : base(base_), backing(std::move(backing_)), path(path_),
+                         std::shared_ptr<FileUtil::MappedFile> mapping_, const std::string& path_,
+                         Mode perms_)
+    : base(base_), backing(std::move(backing_)), mapping(std::move(mapping_)), path(path_),
       parent_path(FileUtil::GetParentPath(path_)),
       path_components(FileUtil::SplitPathComponents(path_)),
       parent_components(FileUtil::SliceVector(path_components, 0, path_components.size() - 1)),
@@ -228,10 +423,14 @@ std::string RealVfsFile::GetName() const {
 }
 
 std::size_t RealVfsFile::GetSize() const {
+    if (mapping) {
+        return mapping->GetSize();
+    }
     return backing->GetSize();
 }
 
 bool RealVfsFile::Resize(std::size_t new_size) {
+    InvalidateListing(parent_path);
     return backing->Resize(new_size);
 }
 
@@ -248,6 +447,14 @@ bool RealVfsFile::IsReadable() const {
 }
 
 std::size_t RealVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    if (mapping) {
+        if (offset >= mapping->GetSize()) {
+            return 0;
+        }
+        const std::size_t read_size = std::min(length, mapping->GetSize() - offset);
+        std::memcpy(data, mapping->GetData() + offset, read_size);
+        return read_size;
+    }
     if (!backing->Seek(offset, SEEK_SET))
         return 0;
     return backing->ReadBytes(data, length);
@@ -256,6 +463,8 @@ std::size_t RealVfsFile::Read(u8* data, std::size_t length, std::size_t offset)
 std::size_t RealVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
     if (!backing->Seek(offset, SEEK_SET))
         return 0;
+    // The write may grow the file
+    InvalidateListing(parent_path);
     return backing->WriteBytes(data, length);
 }
 
@@ -263,6 +472,10 @@ bool RealVfsFile::Rename(std::string_view name) {
     return base.MoveFile(path, parent_path + DIR_SEP + std::string(name)) != nullptr;
 }
 
+const u8* RealVfsFile::GetData() const {
+    return mapping ? mapping->GetData() : nullptr;
+}
+
 bool RealVfsFile::Close() {
     return backing->Close();
 }
@@ -276,14 +489,10 @@ std::vector<VirtualFile> RealVfsDirectory::IterateEntries<RealVfsFile, VfsFile>(
         return {};
 
     std::vector<VirtualFile> out;
-    FileUtil::ForeachDirectoryEntry(
-        nullptr, path,
-        [&out, this](u64* entries_out, const std::string& directory, const std::string& filename) {
-            const std::string full_path = directory + DIR_SEP + filename;
-            if (!FileUtil::IsDirectory(full_path))
-                out.emplace_back(base.OpenFile(full_path, perms));
-            return true;
-        });
+    for (const auto& entry : *GetListing()) {
+        if (entry.type == VfsEntryType::File)
+            out.emplace_back(base.OpenFile(path + DIR_SEP + entry.name, perms));
+    }
 
     return out;
 }
@@ -294,14 +503,10 @@ std::vector<VirtualDir> RealVfsDirectory::IterateEntries<RealVfsDirectory, VfsDi
         return {};
 
     std::vector<VirtualDir> out;
-    FileUtil::ForeachDirectoryEntry(
-        nullptr, path,
-        [&out, this](u64* entries_out, const std::string& directory, const std::string& filename) {
-            const std::string full_path = directory + DIR_SEP + filename;
-            if (FileUtil::IsDirectory(full_path))
-                out.emplace_back(base.OpenDirectory(full_path, perms));
-            return true;
-        });
+    for (const auto& entry : *GetListing()) {
+        if (entry.type == VfsEntryType::Directory)
+            out.emplace_back(base.OpenDirectory(path + DIR_SEP + entry.name, perms));
+    }
 
     return out;
 }
@@ -312,8 +517,11 @@ RealVfsDirectory::RealVfsDirectory(RealVfsFilesystem& base_, const std::string&
       path_components(FileUtil::SplitPathComponents(path)),
       parent_components(FileUtil::SliceVector(path_components, 0, path_components.size() - 1)),
       perms(perms_) {
-    if (!FileUtil::Exists(path) && perms & Mode::WriteAppend)
+    if (!FileUtil::Exists(path) && perms & Mode::WriteAppend) {
         FileUtil::CreateDir(path);
+        InvalidateParentListings(path);
+        InvalidateListingTree(path);
+    }
 }
 
 RealVfsDirectory::~RealVfsDirectory() = default;
@@ -407,6 +615,12 @@ bool RealVfsDirectory::Rename(std::string_view name) {
     return base.MoveFile(path, new_name) != nullptr;
 }
 
+bool RealVfsDirectory::Replace(std::string_view src, std::string_view dest) {
+    const std::string src_path = (path + DIR_SEP).append(src);
+    const std::string dest_path = (path + DIR_SEP).append(dest);
+    return base.ReplaceFile(src_path, dest_path) != nullptr;
+}
+
 std::string RealVfsDirectory::GetFullPath() const {
     auto out = path;
     std::replace(out.begin(), out.end(), '\\', '/');
@@ -418,16 +632,19 @@ std::map<std::string, VfsEntryType, std::less<>> RealVfsDirectory::GetEntries()
         return {};
 
     std::map<std::string, VfsEntryType, std::less<>> out;
-    FileUtil::ForeachDirectoryEntry(
-        nullptr, path,
-        [&out](u64* entries_out, const std::string& directory, const std::string& filename) {
-            const std::string full_path = directory + DIR_SEP + filename;
-            out.emplace(filename, FileUtil::IsDirectory(full_path) ? VfsEntryType::Directory
-                                                                   : VfsEntryType::File);
-            return true;
-        });
+    for (const auto& entry : *GetListing())
+        out.emplace(entry.name, entry.type);
 
     return out;
 }
 
+VfsDirectoryListing RealVfsDirectory::GetListing() const {
+    if (perms == Mode::Append)
+        return std::make_shared<const std::vector<VfsDirectoryEntry>>();
+
+    return GetHostListing(path, [this](const std::string& file_path) {
+        return base.GetFileSize(file_path);
+    });
+}
+
 } // namespace FileSys
@@ -11,11 +11,14 @@
 
 namespace FileUtil {
 class IOFile;
-}
+class MappedFile;
+} // namespace FileUtil
 
 namespace FileSys {
 
 class RealVfsFilesystem : public VfsFilesystem {
+    friend class RealVfsDirectory;
+
 public:
     RealVfsFilesystem();
     ~RealVfsFilesystem() override;
@@ -35,8 +38,18 @@ public:
     VirtualDir MoveDirectory(std::string_view old_path, std::string_view new_path) override;
     bool DeleteDirectory(std::string_view path) override;
 
+    /// Like MoveFile, but atomically replaces the file at new_path if there is one.
+    VirtualFile ReplaceFile(std::string_view old_path, std::string_view new_path);
+
 private:
+    /// Returns a shared mapping of a file opened as read-only, nullptr when it can't be mapped.
+    std::shared_ptr<FileUtil::MappedFile> MapFile(const std::string& path);
+
+    /// Returns the size of a file, including the writes still buffered if the file is open.
+    u64 GetFileSize(const std::string& path) const;
+
     boost::container::flat_map<std::string, std::weak_ptr<FileUtil::IOFile>> cache;
+    boost::container::flat_map<std::string, std::weak_ptr<FileUtil::MappedFile>> mapped_cache;
 };
 
 // An implmentation of VfsFile that represents a file on the user's computer.
@@ -56,15 +69,19 @@ public:
     std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
     std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
     bool Rename(std::string_view name) override;
+    const u8* GetData() const override;
 
 private:
     RealVfsFile(RealVfsFilesystem& base, std::shared_ptr<FileUtil::IOFile> backing,
-                const std::string& path, Mode perms = Mode::Read);
+                std::shared_ptr<FileUtil::MappedFile> mapping, const std::string& path,
+                Mode perms = Mode::Read);
 
     bool Close();
 
     RealVfsFilesystem& base;
     std::shared_ptr<FileUtil::IOFile> backing;
+    /// Contents of the file when it was opened as read-only, reads copy from it
+    std::shared_ptr<FileUtil::MappedFile> mapping;
     std::string path;
     std::string parent_path;
     std::vector<std::string> path_components;
@@ -97,8 +114,10 @@ public:
     bool DeleteSubdirectory(std::string_view name) override;
     bool DeleteFile(std::string_view name) override;
     bool Rename(std::string_view name) override;
+    bool Replace(std::string_view src, std::string_view dest) override;
     std::string GetFullPath() const override;
     std::map<std::string, VfsEntryType, std::less<>> GetEntries() const override;
+    VfsDirectoryListing GetListing() const override;
 
 private:
     RealVfsDirectory(RealVfsFilesystem& base, const std::string& path, Mode perms = Mode::Read);
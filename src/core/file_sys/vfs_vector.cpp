@@ -51,6 +51,10 @@ std::size_t VectorVfsFile::Write(const u8* data_, std::size_t length, std::size_
     return write;
 }
 
+const u8* VectorVfsFile::GetData() const {
+    return data.data();
+}
+
 bool VectorVfsFile::Rename(std::string_view name_) {
     name = name_;
     return true;
@@ -64,7 +68,9 @@ VectorVfsDirectory::VectorVfsDirectory(std::vector<VirtualFile> files_,
                                        std::vector<VirtualDir> dirs_, std::string name_,
                                        VirtualDir parent_)
     : files(std::move(files_)), dirs(std::move(dirs_)), parent(std::move(parent_)),
-      name(std::move(name_)) {}
+      name(std::move(name_)) {
+    RebuildIndices();
+}
 
 VectorVfsDirectory::~VectorVfsDirectory() = default;
 
@@ -76,6 +82,16 @@ std::vector<std::shared_ptr<VfsDirectory>> VectorVfsDirectory::GetSubdirectories
     return dirs;
 }
 
+std::shared_ptr<VfsFile> VectorVfsDirectory::GetFile(std::string_view name) const {
+    const auto iter = file_indices.find(std::string(name));
+    return iter == file_indices.end() ? nullptr : files[iter->second];
+}
+
+std::shared_ptr<VfsDirectory> VectorVfsDirectory::GetSubdirectory(std::string_view name) const {
+    const auto iter = dir_indices.find(std::string(name));
+    return iter == dir_indices.end() ? nullptr : dirs[iter->second];
+}
+
 bool VectorVfsDirectory::IsWritable() const {
     return false;
 }
@@ -104,11 +120,17 @@ static bool FindAndRemoveVectorElement(std::vector<T>& vec, std::string_view nam
 }
 
 bool VectorVfsDirectory::DeleteSubdirectory(std::string_view name) {
-    return FindAndRemoveVectorElement(dirs, name);
+    if (!FindAndRemoveVectorElement(dirs, name))
+        return false;
+    RebuildIndices();
+    return true;
 }
 
 bool VectorVfsDirectory::DeleteFile(std::string_view name) {
-    return FindAndRemoveVectorElement(files, name);
+    if (!FindAndRemoveVectorElement(files, name))
+        return false;
+    RebuildIndices();
+    return true;
 }
 
 bool VectorVfsDirectory::Rename(std::string_view name_) {
@@ -125,10 +147,23 @@ std::shared_ptr<VfsFile> VectorVfsDirectory::CreateFile(std::string_view name) {
 }
 
 void VectorVfsDirectory::AddFile(VirtualFile file) {
+    file_indices.emplace(file->GetName(), files.size());
     files.push_back(std::move(file));
 }
 
 void VectorVfsDirectory::AddDirectory(VirtualDir dir) {
+    dir_indices.emplace(dir->GetName(), dirs.size());
     dirs.push_back(std::move(dir));
 }
+
+void VectorVfsDirectory::RebuildIndices() {
+    file_indices.clear();
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        file_indices.emplace(files[i]->GetName(), i);
+    }
+    dir_indices.clear();
+    for (std::size_t i = 0; i < dirs.size(); ++i) {
+        dir_indices.emplace(dirs[i]->GetName(), i);
+    }
+}
 } // namespace FileSys
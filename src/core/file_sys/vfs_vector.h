@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstring>
+#include <unordered_map>
 #include "core/file_sys/vfs.h"
 
 namespace FileSys {
@@ -77,6 +78,7 @@ public:
     std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
     std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
     bool Rename(std::string_view name) override;
+    const u8* GetData() const override;
 
     virtual void Assign(std::vector<u8> new_data);
 
@@ -97,6 +99,8 @@ public:
 
     std::vector<std::shared_ptr<VfsFile>> GetFiles() const override;
     std::vector<std::shared_ptr<VfsDirectory>> GetSubdirectories() const override;
+    std::shared_ptr<VfsFile> GetFile(std::string_view name) const override;
+    std::shared_ptr<VfsDirectory> GetSubdirectory(std::string_view name) const override;
     bool IsWritable() const override;
     bool IsReadable() const override;
     std::string GetName() const override;
@@ -111,9 +115,16 @@ public:
     virtual void AddDirectory(VirtualDir dir);
 
 private:
+    void RebuildIndices();
+
     std::vector<VirtualFile> files;
     std::vector<VirtualDir> dirs;
 
+    // Positions of the first entry with each name, so path lookups don't scan the vectors. Large
+    // RomFS directories hold thousands of files. Entries are expected not to be renamed once added.
+    std::unordered_map<std::string, std::size_t> file_indices;
+    std::unordered_map<std::string, std::size_t> dir_indices;
+
     VirtualDir parent;
     std::string name;
 };
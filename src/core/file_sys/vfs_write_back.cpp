@@ -0,0 +1,234 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <utility>
+
+#include "common/logging/log.h"
+#include "core/file_sys/vfs_write_back.h"
+
+namespace FileSys {
+
+namespace {
+
+/// Suffix of the file a commit writes before it replaces the original.
+constexpr std::string_view TEMPORARY_SUFFIX = ".yuzu_commit";
+
+} // Anonymous namespace
+
+WriteBackCache::WriteBackCache(std::size_t max_dirty_size) : max_dirty_size(max_dirty_size) {}
+
+WriteBackCache::~WriteBackCache() {
+    Commit();
+}
+
+VirtualFile WriteBackCache::Wrap(VirtualFile file) {
+    if (file == nullptr) {
+        return nullptr;
+    }
+
+    auto path = file->GetFullPath();
+    const auto iter = files.find(path);
+    if (iter != files.end()) {
+        if (auto existing = iter->second.lock()) {
+            // The freshly opened file is used from now on, unless that would drop pending writes
+            // or write access, the old one may have been closed by deleting the path meanwhile.
+            if (!existing->IsDirty() && (file->IsWritable() || !existing->IsWritable())) {
+                existing->file = std::move(file);
+            }
+            return existing;
+        }
+    }
+
+    auto wrapped = std::make_shared<WriteBackVfsFile>(std::move(file), weak_from_this());
+    files.insert_or_assign(std::move(path), wrapped);
+    return wrapped;
+}
+
+bool WriteBackCache::Commit() {
+    // Files that could not be committed stay pending, so the next commit tries again
+    bool success = true;
+    for (auto iter = dirty_files.begin(); iter != dirty_files.end();) {
+        if (iter->second->Commit()) {
+            iter = dirty_files.erase(iter);
+        } else {
+            LOG_ERROR(Service_FS, "Could not commit {}", iter->first);
+            success = false;
+            ++iter;
+        }
+    }
+
+    for (auto iter = files.begin(); iter != files.end();) {
+        iter = iter->second.expired() ? files.erase(iter) : std::next(iter);
+    }
+    return success;
+}
+
+std::size_t WriteBackCache::GetDirtySize() const {
+    return std::accumulate(dirty_files.begin(), dirty_files.end(), std::size_t{0},
+                           [](std::size_t size, const auto& entry) {
+                               return size + entry.second->GetSize();
+                           });
+}
+
+void WriteBackCache::OnModified(const WriteBackVfsFile& file) {
+    const auto path = file.GetFullPath();
+    if (dirty_files.find(path) == dirty_files.end()) {
+        const auto iter = files.find(path);
+        if (iter == files.end() || iter->second.expired()) {
+            return;
+        }
+        dirty_files.emplace(path, iter->second.lock());
+    }
+
+    if (GetDirtySize() > max_dirty_size) {
+        LOG_DEBUG(Service_FS, "Committing early, the pending writes exceed {} bytes",
+                  max_dirty_size);
+        Commit();
+    }
+}
+
+WriteBackVfsFile::WriteBackVfsFile(VirtualFile file, std::weak_ptr<WriteBackCache> cache)
+    : file(std::move(file)), cache(std::move(cache)) {}
+
+WriteBackVfsFile::~WriteBackVfsFile() = default;
+
+std::string WriteBackVfsFile::GetName() const {
+    return file->GetName();
+}
+
+std::size_t WriteBackVfsFile::GetSize() const {
+    return contents ? contents->size() : file->GetSize();
+}
+
+bool WriteBackVfsFile::Resize(std::size_t new_size) {
+    const auto cache_ptr = PrepareModification(new_size);
+    if (cache_ptr == nullptr) {
+        return file->Resize(new_size);
+    }
+
+    contents->resize(new_size);
+    cache_ptr->OnModified(*this);
+    return true;
+}
+
+std::shared_ptr<VfsDirectory> WriteBackVfsFile::GetContainingDirectory() const {
+    return file->GetContainingDirectory();
+}
+
+bool WriteBackVfsFile::IsWritable() const {
+    return file->IsWritable();
+}
+
+bool WriteBackVfsFile::IsReadable() const {
+    return file->IsReadable();
+}
+
+std::size_t WriteBackVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    if (!contents) {
+        return file->Read(data, length, offset);
+    }
+
+    if (offset >= contents->size()) {
+        return 0;
+    }
+    const auto read = std::min(length, contents->size() - offset);
+    std::memcpy(data, contents->data() + offset, read);
+    return read;
+}
+
+std::size_t WriteBackVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
+    const auto end = offset + length;
+    const auto cache_ptr = PrepareModification(std::max(end, GetSize()));
+    if (cache_ptr == nullptr) {
+        return file->Write(data, length, offset);
+    }
+
+    if (end > contents->size()) {
+        contents->resize(end);
+    }
+    std::memcpy(contents->data() + offset, data, length);
+    cache_ptr->OnModified(*this);
+    return length;
+}
+
+bool WriteBackVfsFile::Rename(std::string_view name) {
+    return Commit() && file->Rename(name);
+}
+
+std::string WriteBackVfsFile::GetFullPath() const {
+    return file->GetFullPath();
+}
+
+bool WriteBackVfsFile::IsDirty() const {
+    return contents.has_value();
+}
+
+std::shared_ptr<WriteBackCache> WriteBackVfsFile::PrepareModification(std::size_t new_size) {
+    if (!file->IsWritable()) {
+        return nullptr;
+    }
+    auto cache_ptr = cache.lock();
+    if (cache_ptr == nullptr) {
+        return nullptr;
+    }
+
+    if (contents) {
+        return cache_ptr;
+    }
+    if (std::max(new_size, file->GetSize()) > cache_ptr->max_dirty_size) {
+        return nullptr;
+    }
+
+    contents = file->ReadAllBytes();
+    if (contents->size() != file->GetSize()) {
+        LOG_ERROR(Service_FS, "Could not read {}, writing through", file->GetFullPath());
+        contents.reset();
+        return nullptr;
+    }
+    return cache_ptr;
+}
+
+bool WriteBackVfsFile::Commit() {
+    if (!contents) {
+        return true;
+    }
+
+    const auto dir = file->GetContainingDirectory();
+    if (dir == nullptr) {
+        return false;
+    }
+
+    const auto name = file->GetName();
+    const auto temporary_name = name + std::string(TEMPORARY_SUFFIX);
+    if (dir->GetFile(temporary_name) != nullptr) {
+        dir->DeleteFile(temporary_name);
+    }
+
+    auto temporary = dir->CreateFile(temporary_name);
+    if (temporary == nullptr || !temporary->Resize(contents->size()) ||
+        temporary->Write(contents->data(), contents->size(), 0) != contents->size()) {
+        temporary.reset();
+        dir->DeleteFile(temporary_name);
+        return false;
+    }
+
+    // Closing hands the new contents to the host filesystem before they replace the original
+    temporary.reset();
+    if (!dir->Replace(temporary_name, name)) {
+        return false;
+    }
+
+    auto replaced = dir->GetFile(name);
+    if (replaced == nullptr) {
+        return false;
+    }
+    file = std::move(replaced);
+    contents.reset();
+    return true;
+}
+
+} // namespace FileSys
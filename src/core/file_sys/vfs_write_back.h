@@ -0,0 +1,93 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/file_sys/vfs.h"
+
+namespace FileSys {
+
+class WriteBackVfsFile;
+
+// Keeps the writes to the files of a save data directory in memory until Commit. Games write
+// their saves with many small writes and commit them once, so only the commit has to reach the
+// host filesystem. A modified file is committed by writing it to a temporary file next to it, which
+// then replaces the original in one step where the host allows, so a file is never left half
+// written. Once the modified files add
+// up to more than max_dirty_size, they are committed early.
+class WriteBackCache : public std::enable_shared_from_this<WriteBackCache> {
+public:
+    static constexpr std::size_t DEFAULT_MAX_DIRTY_SIZE = 0x2000000;
+
+    explicit WriteBackCache(std::size_t max_dirty_size = DEFAULT_MAX_DIRTY_SIZE);
+    /// Commits the writes that are still pending.
+    ~WriteBackCache();
+
+    /// Returns a file whose writes are kept by this cache. Opening the same file again while the
+    /// wrapper is in use returns the same wrapper, so all handles see the pending writes.
+    VirtualFile Wrap(VirtualFile file);
+
+    /// Writes the pending data of all files, returns false if any of them failed.
+    bool Commit();
+
+    /// Total size of the files waiting for a commit.
+    std::size_t GetDirtySize() const;
+
+private:
+    friend class WriteBackVfsFile;
+
+    /// Called by a file whenever it is modified in memory.
+    void OnModified(const WriteBackVfsFile& file);
+
+    std::size_t max_dirty_size;
+    // Files by full path, those with pending writes are kept alive until they are committed
+    std::map<std::string, std::weak_ptr<WriteBackVfsFile>, std::less<>> files;
+    std::map<std::string, std::shared_ptr<WriteBackVfsFile>, std::less<>> dirty_files;
+};
+
+// An implementation of VfsFile that applies writes to an in-memory copy of the wrapped file until
+// its WriteBackCache commits it. Files larger than the limit of the cache, or whose cache is gone,
+// are written through.
+class WriteBackVfsFile : public VfsFile {
+public:
+    WriteBackVfsFile(VirtualFile file, std::weak_ptr<WriteBackCache> cache);
+    ~WriteBackVfsFile() override;
+
+    std::string GetName() const override;
+    std::size_t GetSize() const override;
+    bool Resize(std::size_t new_size) override;
+    std::shared_ptr<VfsDirectory> GetContainingDirectory() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    bool Rename(std::string_view name) override;
+    std::string GetFullPath() const override;
+
+    /// Whether the file has writes that are not committed yet.
+    bool IsDirty() const;
+
+private:
+    friend class WriteBackCache;
+
+    /// Returns the cache if the file is modified in memory, loading its contents on first use.
+    /// Returns nullptr if the modification has to be written through instead.
+    std::shared_ptr<WriteBackCache> PrepareModification(std::size_t new_size);
+
+    /// Replaces the wrapped file with the contents in memory.
+    bool Commit();
+
+    VirtualFile file;
+    std::weak_ptr<WriteBackCache> cache;
+    std::optional<std::vector<u8>> contents;
+};
+
+} // namespace FileSys
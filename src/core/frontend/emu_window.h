@@ -75,6 +75,15 @@ public:
         return nullptr;
     }
 
+    /**
+     * Returns whether the frontend presents the frames itself, from a thread of its own calling
+     * VideoCore::RendererBase::TryPresent with the context of the window current. Otherwise the
+     * renderer draws straight to the window and calls SwapBuffers.
+     */
+    virtual bool IsPresentedSeparately() const {
+        return false;
+    }
+
     /**
      * Signal that a touch pressed event has occurred (e.g. mouse click pressed)
      * @param framebuffer_x Framebuffer x-coordinate that was pressed
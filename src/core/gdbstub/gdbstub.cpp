@@ -31,6 +31,7 @@
 #endif
 
 #include "common/logging/log.h"
+#include "common/memory_hook.h"
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "core/arm/arm_interface.h"
@@ -42,6 +43,7 @@
 #include "core/hle/kernel/vm_manager.h"
 #include "core/loader/loader.h"
 #include "core/memory.h"
+#include "core/memory_setup.h"
 
 namespace GDBStub {
 namespace {
@@ -147,6 +149,8 @@ u32 command_length;
 
 u32 latest_signal = 0;
 bool memory_break = false;
+/// Watchpoint and address of the access that made the last memory break.
+BreakpointAddress watch_hit{};
 
 Kernel::Thread* current_thread = nullptr;
 u32 current_core = 0;
@@ -179,12 +183,6 @@ BreakpointMap breakpoints_execute;
 BreakpointMap breakpoints_read;
 BreakpointMap breakpoints_write;
 
-struct Module {
-    std::string name;
-    VAddr beg;
-    VAddr end;
-};
-
 std::vector<Module> modules;
 } // Anonymous namespace
 
@@ -206,6 +204,10 @@ void RegisterModule(std::string name, VAddr beg, VAddr end, bool add_elf_ext) {
     modules.push_back(std::move(module));
 }
 
+const std::vector<Module>& GetModules() {
+    return modules;
+}
+
 static Kernel::Thread* FindThreadById(s64 id) {
     const auto& threads = Core::System::GetInstance().GlobalScheduler().GetThreadList();
     for (auto& thread : threads) {
@@ -494,6 +496,120 @@ static BreakpointMap& GetBreakpointMap(BreakpointType type) {
     }
 }
 
+namespace {
+/**
+ * Watches the accesses to the pages with read or write breakpoints. The pages take the slow path
+ * of the memory while hooked, execution keeps running in the JIT until an access hits one of the
+ * breakpoints, which halts the core at the end of its current block.
+ */
+class WatchpointHook final : public Common::MemoryHook {
+public:
+    std::optional<bool> IsValidAddress(VAddr addr) override {
+        return std::nullopt;
+    }
+
+    std::optional<u8> Read8(VAddr addr) override {
+        OnAccess(addr, sizeof(u8), BreakpointType::Read);
+        return std::nullopt;
+    }
+    std::optional<u16> Read16(VAddr addr) override {
+        OnAccess(addr, sizeof(u16), BreakpointType::Read);
+        return std::nullopt;
+    }
+    std::optional<u32> Read32(VAddr addr) override {
+        OnAccess(addr, sizeof(u32), BreakpointType::Read);
+        return std::nullopt;
+    }
+    std::optional<u64> Read64(VAddr addr) override {
+        OnAccess(addr, sizeof(u64), BreakpointType::Read);
+        return std::nullopt;
+    }
+
+    bool ReadBlock(VAddr src_addr, void* dest_buffer, std::size_t size) override {
+        return false;
+    }
+
+    bool Write8(VAddr addr, u8 data) override {
+        OnAccess(addr, sizeof(u8), BreakpointType::Write);
+        return false;
+    }
+    bool Write16(VAddr addr, u16 data) override {
+        OnAccess(addr, sizeof(u16), BreakpointType::Write);
+        return false;
+    }
+    bool Write32(VAddr addr, u32 data) override {
+        OnAccess(addr, sizeof(u32), BreakpointType::Write);
+        return false;
+    }
+    bool Write64(VAddr addr, u64 data) override {
+        OnAccess(addr, sizeof(u64), BreakpointType::Write);
+        return false;
+    }
+
+    bool WriteBlock(VAddr dest_addr, const void* src_buffer, std::size_t size) override {
+        return false;
+    }
+
+private:
+    static void OnAccess(VAddr addr, std::size_t size, BreakpointType type) {
+        // Accesses after the first hit belong to the same stop
+        if (!IsConnected() || memory_break) {
+            return;
+        }
+        const BreakpointMap& p = GetBreakpointMap(type);
+        for (auto it = p.begin(); it != p.end() && it->first < addr + size; ++it) {
+            const Breakpoint& bp = it->second;
+            if (!bp.active || addr >= bp.addr + bp.len) {
+                continue;
+            }
+            LOG_DEBUG(Debug_GDBStub, "Hit watchpoint type {} @ {:016X}, access {:016X}",
+                      static_cast<int>(type), bp.addr, addr);
+            watch_hit.address = std::max(addr, bp.addr);
+            watch_hit.type = type;
+            Break(true);
+            Core::System::GetInstance().CurrentArmInterface().PrepareReschedule();
+            return;
+        }
+    }
+};
+
+const auto watchpoint_hook = std::make_shared<WatchpointHook>();
+} // Anonymous namespace
+
+/// Returns true if a read or write breakpoint covers part of a page.
+static bool IsPageWatched(VAddr page_addr) {
+    const auto covers_page = [page_addr](const BreakpointMap& p) {
+        return std::any_of(p.begin(), p.end(), [page_addr](const auto& entry) {
+            const Breakpoint& bp = entry.second;
+            return bp.addr < page_addr + Memory::PAGE_SIZE && page_addr < bp.addr + bp.len;
+        });
+    };
+    return covers_page(breakpoints_read) || covers_page(breakpoints_write);
+}
+
+/**
+ * Hooks the pages of a range that are covered by read or write breakpoints, and unhooks the
+ * others.
+ *
+ * @param addr Start address of the range.
+ * @param len Length of the range.
+ */
+static void UpdateWatchedPages(VAddr addr, u64 len) {
+    if (len == 0) {
+        return;
+    }
+    auto& page_table = Core::System::GetInstance().CurrentProcess()->VMManager().page_table;
+    const VAddr first_page = addr & ~Memory::PAGE_MASK;
+    const VAddr last_page = (addr + len - 1) & ~Memory::PAGE_MASK;
+    for (VAddr page = first_page; page <= last_page; page += Memory::PAGE_SIZE) {
+        if (IsPageWatched(page)) {
+            Memory::AddDebugHook(page_table, page, Memory::PAGE_SIZE, watchpoint_hook);
+        } else {
+            Memory::RemoveDebugHook(page_table, page, Memory::PAGE_SIZE, watchpoint_hook);
+        }
+    }
+}
+
 /**
  * Remove the breakpoint from the given address of the specified type.
  *
@@ -513,9 +629,15 @@ static void RemoveBreakpoint(BreakpointType type, VAddr addr) {
 
     if (type == BreakpointType::Execute) {
         Memory::WriteBlock(bp->second.addr, bp->second.inst.data(), bp->second.inst.size());
-        Core::System::GetInstance().InvalidateCpuInstructionCaches();
+        Core::System::GetInstance().InvalidateCpuInstructionCacheRange(bp->second.addr,
+                                                                       bp->second.inst.size());
     }
+    const u64 len = bp->second.len;
     p.erase(addr);
+
+    if (type == BreakpointType::Read || type == BreakpointType::Write) {
+        UpdateWatchedPages(addr, len);
+    }
 }
 
 BreakpointAddress GetNextBreakpointFromAddress(VAddr addr, BreakpointType type) {
@@ -744,6 +866,11 @@ static void SendSignal(Kernel::Thread* thread, u32 signal, bool full = true) {
         buffer = fmt::format("T{:02x}", latest_signal);
     }
 
+    if (full && memory_break && watch_hit.type != BreakpointType::None) {
+        const char* const reason = watch_hit.type == BreakpointType::Write ? "watch" : "rwatch";
+        buffer += fmt::format(";{}:{:x}", reason, watch_hit.address);
+    }
+
     if (thread) {
         buffer += fmt::format(";thread:{:x};", thread->GetThreadID());
     }
@@ -1009,7 +1136,7 @@ static void WriteMemory() {
 
     GdbHexToMem(data.data(), len_pos + 1, len);
     Memory::WriteBlock(addr, data.data(), len);
-    Core::System::GetInstance().InvalidateCpuInstructionCaches();
+    Core::System::GetInstance().InvalidateCpuInstructionCacheRange(addr, len);
     SendReply("OK");
 }
 
@@ -1044,6 +1171,7 @@ bool IsMemoryBreak() {
 /// Tell the CPU to continue executing.
 static void Continue() {
     memory_break = false;
+    watch_hit = {};
     step_loop = false;
     halt_loop = false;
 }
@@ -1067,10 +1195,14 @@ static bool CommitBreakpoint(BreakpointType type, VAddr addr, u64 len) {
     static constexpr std::array<u8, 4> btrap{0x00, 0x7d, 0x20, 0xd4};
     if (type == BreakpointType::Execute) {
         Memory::WriteBlock(addr, btrap.data(), btrap.size());
-        Core::System::GetInstance().InvalidateCpuInstructionCaches();
+        Core::System::GetInstance().InvalidateCpuInstructionCacheRange(addr, btrap.size());
     }
     p.insert({addr, breakpoint});
 
+    if (type == BreakpointType::Read || type == BreakpointType::Write) {
+        UpdateWatchedPages(addr, len);
+    }
+
     LOG_DEBUG(Debug_GDBStub, "gdb: added {} breakpoint: {:016X} bytes at {:016X}",
               static_cast<int>(type), breakpoint.len, breakpoint.addr);
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include "common/common_types.h"
 #include "core/hle/kernel/thread.h"
 
@@ -26,6 +27,12 @@ struct BreakpointAddress {
     BreakpointType type;
 };
 
+struct Module {
+    std::string name;
+    VAddr beg;
+    VAddr end;
+};
+
 /**
  * Set the port the gdbstub should use to listen for connections.
  *
@@ -55,6 +62,9 @@ bool IsConnected();
 /// Register module.
 void RegisterModule(std::string name, VAddr beg, VAddr end, bool add_elf_ext = true);
 
+/// Returns the modules registered by the loaders, in the order they were loaded.
+const std::vector<Module>& GetModules();
+
 /**
  * Signal to the gdbstub server that it should halt CPU execution.
  *
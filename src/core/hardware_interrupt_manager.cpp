@@ -24,7 +24,8 @@ InterruptManager::~InterruptManager() = default;
 
 void InterruptManager::GPUInterruptSyncpt(const u32 syncpoint_id, const u32 value) {
     const u64 msg = (static_cast<u64>(syncpoint_id) << 32ULL) | value;
-    system.CoreTiming().ScheduleEvent(10, gpu_interrupt_event, msg);
+    // Called from the GPU thread
+    system.CoreTiming().ScheduleEventThreadsafe(10, gpu_interrupt_event, msg);
 }
 
 } // namespace Core::Hardware
@@ -0,0 +1,44 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+
+#include "core/hle/kernel/address_wait_table.h"
+#include "core/hle/kernel/thread.h"
+
+namespace Kernel {
+
+AddressWaitTable::AddressWaitTable() = default;
+AddressWaitTable::~AddressWaitTable() = default;
+
+void AddressWaitTable::Add(VAddr address, Thread* thread) {
+    waiters[address].push_back(thread);
+}
+
+void AddressWaitTable::Remove(VAddr address, Thread* thread) {
+    const auto it = waiters.find(address);
+    if (it == waiters.end()) {
+        return;
+    }
+    auto& threads = it->second;
+    threads.erase(std::remove(threads.begin(), threads.end(), thread), threads.end());
+    if (threads.empty()) {
+        waiters.erase(it);
+    }
+}
+
+std::vector<SharedPtr<Thread>> AddressWaitTable::GetWaitingThreads(VAddr address) const {
+    const auto it = waiters.find(address);
+    if (it == waiters.end()) {
+        return {};
+    }
+    std::vector<SharedPtr<Thread>> threads(it->second.begin(), it->second.end());
+    std::stable_sort(threads.begin(), threads.end(),
+                     [](const SharedPtr<Thread>& lhs, const SharedPtr<Thread>& rhs) {
+                         return lhs->GetPriority() < rhs->GetPriority();
+                     });
+    return threads;
+}
+
+} // namespace Kernel
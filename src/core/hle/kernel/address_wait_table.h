@@ -0,0 +1,39 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/hle/kernel/object.h"
+
+namespace Kernel {
+
+class Thread;
+
+/**
+ * Threads of a process waiting on guest addresses, indexed by address so that signaling an address
+ * only visits its own waiters instead of every thread of the system.
+ */
+class AddressWaitTable final {
+public:
+    AddressWaitTable();
+    ~AddressWaitTable();
+
+    /// Adds a thread at the back of the waiters of an address.
+    void Add(VAddr address, Thread* thread);
+
+    /// Removes a thread from the waiters of an address, does nothing if it isn't waiting on it.
+    void Remove(VAddr address, Thread* thread);
+
+    /// Returns the threads waiting on an address, highest priority first and in wait order.
+    std::vector<SharedPtr<Thread>> GetWaitingThreads(VAddr address) const;
+
+private:
+    std::unordered_map<VAddr, std::vector<Thread*>> waiters;
+};
+
+} // namespace Kernel
@@ -66,7 +66,6 @@ SharedPtr<WritableEvent> HLERequestContext::SleepClientThread(
     writable_event->Clear();
     thread->SetStatus(ThreadStatus::WaitHLEEvent);
     thread->SetWaitObjects({readable_event});
-    readable_event->AddWaitingThread(thread);
 
     if (timeout > 0) {
         thread->WakeAfterDelay(timeout);
@@ -83,6 +82,11 @@ HLERequestContext::HLERequestContext(SharedPtr<Kernel::ServerSession> server_ses
 
 HLERequestContext::~HLERequestContext() = default;
 
+std::shared_ptr<SessionRequestHandler> HLERequestContext::GetSessionDomainRequestHandler(
+    std::size_t index) const {
+    return server_session->GetDomainRequestHandler(index);
+}
+
 void HLERequestContext::ParseCommandBuffer(const HandleTable& handle_table, u32_le* src_cmdbuf,
                                            bool incoming) {
     IPC::RequestParser rp(src_cmdbuf);
@@ -294,6 +298,35 @@ std::vector<u8> HLERequestContext::ReadBuffer(int buffer_index) const {
     return buffer;
 }
 
+BufferSpan<const u8> HLERequestContext::ReadBufferSpan(int buffer_index) const {
+    const bool is_buffer_a{BufferDescriptorA().size() && BufferDescriptorA()[buffer_index].Size()};
+    const VAddr address = is_buffer_a ? BufferDescriptorA()[buffer_index].Address()
+                                      : BufferDescriptorX()[buffer_index].Address();
+    const std::size_t size = GetReadBufferSize(buffer_index);
+
+    if (const u8* const pointer = Memory::GetContiguousPointer(address, size)) {
+        return {pointer, size};
+    }
+
+    std::vector<u8>& buffer = span_buffers.emplace_back(size);
+    Memory::ReadBlock(address, buffer.data(), size);
+    return {buffer.data(), size};
+}
+
+BufferSpan<u8> HLERequestContext::WriteBufferSpan(int buffer_index) const {
+    const bool is_buffer_b{BufferDescriptorB().size() && BufferDescriptorB()[buffer_index].Size()};
+    const VAddr address = is_buffer_b ? BufferDescriptorB()[buffer_index].Address()
+                                      : BufferDescriptorC()[buffer_index].Address();
+    const std::size_t size = GetWriteBufferSize(buffer_index);
+
+    if (u8* const pointer = Memory::GetContiguousPointer(address, size)) {
+        return {pointer, size};
+    }
+
+    std::vector<u8>& buffer = span_buffers.emplace_back(size);
+    return {buffer.data(), size};
+}
+
 std::size_t HLERequestContext::WriteBuffer(const void* buffer, std::size_t size,
                                            int buffer_index) const {
     if (size == 0) {
@@ -309,11 +342,14 @@ std::size_t HLERequestContext::WriteBuffer(const void* buffer, std::size_t size,
         size = buffer_size; // TODO(bunnei): This needs to be HW tested
     }
 
-    if (is_buffer_b) {
-        Memory::WriteBlock(BufferDescriptorB()[buffer_index].Address(), buffer, size);
-    } else {
-        Memory::WriteBlock(BufferDescriptorC()[buffer_index].Address(), buffer, size);
+    const VAddr address = is_buffer_b ? BufferDescriptorB()[buffer_index].Address()
+                                      : BufferDescriptorC()[buffer_index].Address();
+    const u8* const in_place = Memory::GetContiguousPointer(address, size);
+    if (in_place != nullptr && buffer == in_place) {
+        // Already written in place through WriteBufferSpan
+        return size;
     }
+    Memory::WriteBlock(address, buffer, size);
 
     return size;
 }
@@ -35,6 +35,38 @@ class WritableEvent;
 
 enum class ThreadWakeupReason;
 
+/// Non owning view of the data of a buffer descriptor, see HLERequestContext::ReadBufferSpan.
+template <typename T>
+class BufferSpan {
+public:
+    constexpr BufferSpan() = default;
+    constexpr BufferSpan(T* data, std::size_t size) : pointer{data}, length{size} {}
+
+    constexpr T* data() const {
+        return pointer;
+    }
+
+    constexpr std::size_t size() const {
+        return length;
+    }
+
+    constexpr bool empty() const {
+        return length == 0;
+    }
+
+    constexpr T* begin() const {
+        return pointer;
+    }
+
+    constexpr T* end() const {
+        return pointer + length;
+    }
+
+private:
+    T* pointer = nullptr;
+    std::size_t length = 0;
+};
+
 /**
  * Interface implemented by HLE Session handlers.
  * This can be provided to a ServerSession in order to hook into several relevant events
@@ -97,6 +129,10 @@ protected:
  */
 class HLERequestContext {
 public:
+    /// Buffer descriptors of a request, requests have few enough of them to store them inline.
+    template <typename T>
+    using DescriptorList = boost::container::small_vector<T, 4>;
+
     explicit HLERequestContext(SharedPtr<ServerSession> session, SharedPtr<Thread> thread);
     ~HLERequestContext();
 
@@ -113,6 +149,11 @@ public:
         return server_session;
     }
 
+    /// Returns the thread that made this request, null for requests replayed without a guest.
+    const SharedPtr<Thread>& GetThread() const {
+        return thread;
+    }
+
     using WakeupCallback = std::function<void(SharedPtr<Thread> thread, HLERequestContext& context,
                                               ThreadWakeupReason reason)>;
 
@@ -152,19 +193,19 @@ public:
         return data_payload_offset;
     }
 
-    const std::vector<IPC::BufferDescriptorX>& BufferDescriptorX() const {
+    const DescriptorList<IPC::BufferDescriptorX>& BufferDescriptorX() const {
         return buffer_x_desciptors;
     }
 
-    const std::vector<IPC::BufferDescriptorABW>& BufferDescriptorA() const {
+    const DescriptorList<IPC::BufferDescriptorABW>& BufferDescriptorA() const {
         return buffer_a_desciptors;
     }
 
-    const std::vector<IPC::BufferDescriptorABW>& BufferDescriptorB() const {
+    const DescriptorList<IPC::BufferDescriptorABW>& BufferDescriptorB() const {
         return buffer_b_desciptors;
     }
 
-    const std::vector<IPC::BufferDescriptorC>& BufferDescriptorC() const {
+    const DescriptorList<IPC::BufferDescriptorC>& BufferDescriptorC() const {
         return buffer_c_desciptors;
     }
 
@@ -179,6 +220,21 @@ public:
     /// Helper function to read a buffer using the appropriate buffer descriptor
     std::vector<u8> ReadBuffer(int buffer_index = 0) const;
 
+    /**
+     * Returns a view of a buffer to read using the appropriate buffer descriptor. The view points
+     * to guest memory when the buffer is contiguous in host memory, avoiding the copy of
+     * ReadBuffer, and to a copy owned by the context otherwise. It's valid until the context is
+     * destroyed and doesn't see the changes made to guest memory after this call.
+     */
+    BufferSpan<const u8> ReadBufferSpan(int buffer_index = 0) const;
+
+    /**
+     * Returns a view of a buffer to write using the appropriate buffer descriptor, see
+     * ReadBufferSpan. Data written to the view has to be passed to WriteBuffer afterwards, which
+     * skips the copy when the view points to guest memory.
+     */
+    BufferSpan<u8> WriteBufferSpan(int buffer_index = 0) const;
+
     /// Helper function to write a buffer using the appropriate buffer descriptor
     std::size_t WriteBuffer(const void* buffer, std::size_t size, int buffer_index = 0) const;
 
@@ -230,14 +286,10 @@ public:
         domain_objects.emplace_back(std::move(object));
     }
 
+    /// Returns a domain object of the session the request was made through.
     template <typename T>
     std::shared_ptr<T> GetDomainRequestHandler(std::size_t index) const {
-        return std::static_pointer_cast<T>(domain_request_handlers.at(index));
-    }
-
-    void SetDomainRequestHandlers(
-        const std::vector<std::shared_ptr<SessionRequestHandler>>& handlers) {
-        domain_request_handlers = handlers;
+        return std::static_pointer_cast<T>(GetSessionDomainRequestHandler(index));
     }
 
     /// Clears the list of objects so that no lingering objects are written accidentally to the
@@ -265,6 +317,8 @@ public:
 private:
     void ParseCommandBuffer(const HandleTable& handle_table, u32_le* src_cmdbuf, bool incoming);
 
+    std::shared_ptr<SessionRequestHandler> GetSessionDomainRequestHandler(std::size_t index) const;
+
     std::array<u32, IPC::COMMAND_BUFFER_LENGTH> cmd_buf;
     SharedPtr<Kernel::ServerSession> server_session;
     SharedPtr<Thread> thread;
@@ -277,17 +331,18 @@ private:
     std::optional<IPC::HandleDescriptorHeader> handle_descriptor_header;
     std::optional<IPC::DataPayloadHeader> data_payload_header;
     std::optional<IPC::DomainMessageHeader> domain_message_header;
-    std::vector<IPC::BufferDescriptorX> buffer_x_desciptors;
-    std::vector<IPC::BufferDescriptorABW> buffer_a_desciptors;
-    std::vector<IPC::BufferDescriptorABW> buffer_b_desciptors;
-    std::vector<IPC::BufferDescriptorABW> buffer_w_desciptors;
-    std::vector<IPC::BufferDescriptorC> buffer_c_desciptors;
+    DescriptorList<IPC::BufferDescriptorX> buffer_x_desciptors;
+    DescriptorList<IPC::BufferDescriptorABW> buffer_a_desciptors;
+    DescriptorList<IPC::BufferDescriptorABW> buffer_b_desciptors;
+    DescriptorList<IPC::BufferDescriptorABW> buffer_w_desciptors;
+    DescriptorList<IPC::BufferDescriptorC> buffer_c_desciptors;
 
     unsigned data_payload_offset{};
     unsigned buffer_c_offset{};
     u32_le command{};
 
-    std::vector<std::shared_ptr<SessionRequestHandler>> domain_request_handlers;
+    /// Copies of the buffer spans that aren't contiguous in host memory.
+    mutable std::vector<std::vector<u8>> span_buffers;
 };
 
 } // namespace Kernel
@@ -22,7 +22,6 @@
 #include "core/hle/kernel/resource_limit.h"
 #include "core/hle/kernel/scheduler.h"
 #include "core/hle/kernel/thread.h"
-#include "core/hle/lock.h"
 #include "core/hle/result.h"
 #include "core/memory.h"
 
@@ -30,20 +29,20 @@ namespace Kernel {
 
 /**
  * Callback that will wake up the thread it was scheduled for
- * @param thread_handle The handle of the thread that's been awoken
+ * @param userdata The wakeup userdata of the thread that's been awoken, see
+ *                 Thread::GetWakeupTimerUserdata
  * @param cycles_late The number of CPU cycles that have passed since the desired wakeup time
  */
-static void ThreadWakeupCallback(u64 thread_handle, [[maybe_unused]] s64 cycles_late) {
-    const auto proper_handle = static_cast<Handle>(thread_handle);
-    const auto& system = Core::System::GetInstance();
+static void ThreadWakeupCallback(KernelCore& kernel, u64 userdata,
+                                 [[maybe_unused]] s64 cycles_late) {
+    const auto proper_handle = static_cast<Handle>(userdata);
 
     // Lock the global kernel mutex when we enter the kernel HLE.
-    std::lock_guard lock{HLE::g_hle_lock};
+    std::lock_guard lock{kernel.HLELock()};
 
-    SharedPtr<Thread> thread =
-        system.Kernel().RetrieveThreadFromWakeupCallbackHandleTable(proper_handle);
-    if (thread == nullptr) {
-        LOG_CRITICAL(Kernel, "Callback fired for invalid thread {:08X}", proper_handle);
+    // Cancelled wakeups are left in the queue, including the ones of threads that have exited
+    SharedPtr<Thread> thread = kernel.RetrieveThreadFromWakeupCallbackHandleTable(proper_handle);
+    if (thread == nullptr || !thread->IsWakeupTimerCurrent(userdata)) {
         return;
     }
 
@@ -52,9 +51,6 @@ static void ThreadWakeupCallback(u64 thread_handle, [[maybe_unused]] s64 cycles_
     if (thread->GetStatus() == ThreadStatus::WaitSynch ||
         thread->GetStatus() == ThreadStatus::WaitHLEEvent) {
         // Remove the thread from each of its waiting objects' waitlists
-        for (const auto& object : thread->GetWaitObjects()) {
-            object->RemoveWaitingThread(thread.get());
-        }
         thread->ClearWaitObjects();
 
         // Invoke the wakeup callback before clearing the wait objects
@@ -97,7 +93,7 @@ struct KernelCore::Impl {
         Shutdown();
 
         InitializeSystemResourceLimit(kernel);
-        InitializeThreads();
+        InitializeThreads(kernel);
         InitializePreemption();
     }
 
@@ -134,9 +130,11 @@ struct KernelCore::Impl {
         ASSERT(system_resource_limit->SetLimitValue(ResourceType::Sessions, 900).IsSuccess());
     }
 
-    void InitializeThreads() {
-        thread_wakeup_event_type =
-            system.CoreTiming().RegisterEvent("ThreadWakeupCallback", ThreadWakeupCallback);
+    void InitializeThreads(KernelCore& kernel) {
+        thread_wakeup_event_type = system.CoreTiming().RegisterEvent(
+            "ThreadWakeupCallback", [&kernel](u64 userdata, s64 cycles_late) {
+                ThreadWakeupCallback(kernel, userdata, cycles_late);
+            });
     }
 
     void InitializePreemption() {
@@ -173,6 +171,8 @@ struct KernelCore::Impl {
     /// the ConnectToPort SVC.
     NamedPortTable named_ports;
 
+    std::recursive_mutex hle_lock;
+
     // System context
     Core::System& system;
 };
@@ -249,6 +249,10 @@ bool KernelCore::IsValidNamedPort(NamedPortTable::const_iterator port) const {
     return port != impl->named_ports.cend();
 }
 
+std::recursive_mutex& KernelCore::HLELock() {
+    return impl->hle_lock;
+}
+
 u32 KernelCore::CreateNewObjectID() {
     return impl->next_object_id++;
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include "core/hle/kernel/object.h"
@@ -94,6 +95,15 @@ public:
     /// Determines whether or not the given port is a valid named port.
     bool IsValidNamedPort(NamedPortTable::const_iterator port) const;
 
+    /**
+     * Synchronizes access to the internal HLE kernel structures, it is acquired when a guest
+     * application thread performs a syscall. It should be acquired by any host threads that read
+     * or modify the HLE kernel state. Note: Any operation that directly or indirectly reads from or
+     * writes to the emulated memory is not protected by this mutex, and should be avoided in any
+     * threads other than the CPU thread.
+     */
+    std::recursive_mutex& HLELock();
+
 private:
     friend class Object;
     friend class Process;
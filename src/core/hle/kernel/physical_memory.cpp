@@ -0,0 +1,125 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "core/hle/kernel/physical_memory.h"
+
+namespace Kernel::HostMemory {
+
+namespace {
+
+bool IsMappedFromHost(std::size_t size) {
+    return size >= HUGE_PAGE_SIZE;
+}
+
+#ifdef _WIN32
+
+void* MapPages(std::size_t size) {
+    // Committed pages are only backed by physical memory once they are touched
+    void* const pointer = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void UnmapPages(void* pointer, std::size_t size) {
+    VirtualFree(pointer, 0, MEM_RELEASE);
+}
+
+#else
+
+void* MapPages(std::size_t size) {
+    // Over-allocates by a huge page to align the block to one, then trims the excess
+    const std::size_t map_size = Common::AlignUp(size, PAGE_ALIGNMENT);
+    const std::size_t reserve_size = map_size + HUGE_PAGE_SIZE;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    void* const base = mmap(nullptr, reserve_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (base == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    u8* const reserve_begin = static_cast<u8*>(base);
+    u8* const reserve_end = reserve_begin + reserve_size;
+    u8* const begin = reinterpret_cast<u8*>(
+        Common::AlignUp(reinterpret_cast<std::uintptr_t>(reserve_begin), HUGE_PAGE_SIZE));
+    u8* const end = begin + map_size;
+    if (begin != reserve_begin) {
+        munmap(reserve_begin, static_cast<std::size_t>(begin - reserve_begin));
+    }
+    if (end != reserve_end) {
+        munmap(end, static_cast<std::size_t>(reserve_end - end));
+    }
+#ifdef __linux__
+    // Transparent huge pages are often only enabled on request, ask for them on the whole huge
+    // pages of the block. This is only a hint, failures leave the block backed by small pages.
+    madvise(begin, Common::AlignDown(size, HUGE_PAGE_SIZE), MADV_HUGEPAGE);
+#endif
+    return begin;
+}
+
+void UnmapPages(void* pointer, std::size_t size) {
+    munmap(pointer, Common::AlignUp(size, PAGE_ALIGNMENT));
+}
+
+#endif
+
+} // Anonymous namespace
+
+void* Allocate(std::size_t size) {
+    if (IsMappedFromHost(size)) {
+        return MapPages(size);
+    }
+    void* const pointer = ::operator new(size, std::align_val_t{PAGE_ALIGNMENT});
+    std::memset(pointer, 0, size);
+    return pointer;
+}
+
+void Free(void* pointer, std::size_t size) {
+    if (IsMappedFromHost(size)) {
+        UnmapPages(pointer, size);
+        return;
+    }
+    ::operator delete(pointer, std::align_val_t{PAGE_ALIGNMENT});
+}
+
+void Discard(void* pointer, std::size_t size) {
+    ASSERT(reinterpret_cast<std::uintptr_t>(pointer) % PAGE_ALIGNMENT == 0);
+    ASSERT(size % PAGE_ALIGNMENT == 0);
+    if (size == 0) {
+        return;
+    }
+#ifdef _WIN32
+    // Pages committed again are demand-zero like fresh ones
+    VirtualFree(pointer, size, MEM_DECOMMIT);
+    if (VirtualAlloc(pointer, size, MEM_COMMIT, PAGE_READWRITE) == nullptr) {
+        throw std::bad_alloc();
+    }
+#elif defined(__linux__)
+    // Private anonymous pages read as zero once their contents are dropped
+    madvise(pointer, size, MADV_DONTNEED);
+#else
+    // Other hosts may keep the contents of dropped pages, replace them with fresh ones instead
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    mmap(pointer, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+#endif
+}
+
+} // namespace Kernel::HostMemory
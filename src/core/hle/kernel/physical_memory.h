@@ -4,16 +4,108 @@
 
 #pragma once
 
-#include "common/alignment.h"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "common/common_types.h"
 
 namespace Kernel {
 
-// This encapsulation serves 2 purposes:
+namespace HostMemory {
+
+/// Size in bytes of the huge pages of the host. Allocations at least this large are mapped from
+/// the host directly, and aligned to it where the host supports huge pages.
+constexpr std::size_t HUGE_PAGE_SIZE = 0x200000;
+
+/// Alignment of every allocation, host pages so guest pages can be protected individually.
+constexpr std::size_t PAGE_ALIGNMENT = 0x1000;
+
+/// Whether the pages of large allocations cost nothing until they are touched. Windows charges
+/// them against the commit limit of the system, so there blocks are better grown when needed.
+#ifdef _WIN32
+constexpr bool LAZY_COMMIT = false;
+#else
+constexpr bool LAZY_COMMIT = true;
+#endif
+
+/**
+ * Allocates zeroed host memory. Large allocations are demand-zero pages of the host, which only
+ * take up physical memory once they are first touched, and are backed with huge pages when the
+ * host allows.
+ */
+void* Allocate(std::size_t size);
+
+/// Frees memory returned by Allocate, size must be the one it was allocated with.
+void Free(void* pointer, std::size_t size);
+
+/**
+ * Returns the physical memory of a page aligned range of an allocation at least HUGE_PAGE_SIZE
+ * large to the host. The range stays accessible and reads as zero afterwards.
+ */
+void Discard(void* pointer, std::size_t size);
+
+} // namespace HostMemory
+
+/// Allocator of the host memory backing guest memory, see HostMemory::Allocate.
+template <typename T>
+class PhysicalMemoryAllocator {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::true_type;
+
+    constexpr PhysicalMemoryAllocator() noexcept = default;
+
+    template <typename T2>
+    constexpr PhysicalMemoryAllocator(const PhysicalMemoryAllocator<T2>&) noexcept {}
+
+    T* allocate(size_type n) {
+        return static_cast<T*>(HostMemory::Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_type n) {
+        HostMemory::Free(p, n * sizeof(T));
+    }
+
+    /// Default initializes instead of value initializing, as allocations are already zeroed.
+    /// Writing the zeros again would commit the host pages of blocks that are never touched.
+    template <typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new (static_cast<void*>(p)) U;
+    }
+
+    template <typename T2>
+    struct rebind {
+        using other = PhysicalMemoryAllocator<T2>;
+    };
+
+    bool operator==(const PhysicalMemoryAllocator&) const noexcept {
+        return true;
+    }
+
+    bool operator!=(const PhysicalMemoryAllocator&) const noexcept {
+        return false;
+    }
+};
+
+// This encapsulation serves 4 purposes:
 // - First, to encapsulate host physical memory under a single type and set an
 // standard for managing it.
-// - Second to ensure all host backing memory used is aligned to 256 bytes due
-// to strict alignment restrictions on GPU memory.
+// - Second to ensure all host backing memory used is aligned to host pages, which satisfies the
+// strict alignment restrictions on GPU memory and lets guest pages be protected individually.
+// - Third to back large blocks, e.g. the heap and the code of processes, with huge pages, cutting
+// down the TLB misses of guest memory accesses.
+// - Fourth to only commit host memory for the pages of large blocks the guest touches. Blocks are
+// zero when allocated, growing a block again after shrinking it doesn't clear the bytes in
+// between.
 
-using PhysicalMemory = std::vector<u8, Common::AlignmentAllocator<u8, 256>>;
+using PhysicalMemory = std::vector<u8, PhysicalMemoryAllocator<u8>>;
 
 } // namespace Kernel
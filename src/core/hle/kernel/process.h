@@ -11,6 +11,7 @@
 #include <vector>
 #include "common/common_types.h"
 #include "core/hle/kernel/address_arbiter.h"
+#include "core/hle/kernel/address_wait_table.h"
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/mutex.h"
 #include "core/hle/kernel/process_capability.h"
@@ -125,6 +126,16 @@ public:
         return address_arbiter;
     }
 
+    /// Gets the threads of the process waiting on address arbiter addresses.
+    AddressWaitTable& GetArbiterWaitTable() {
+        return arbiter_wait_table;
+    }
+
+    /// Gets the threads of the process waiting on condition variables.
+    AddressWaitTable& GetCondVarWaitTable() {
+        return condvar_wait_table;
+    }
+
     /// Gets a reference to the process' mutex lock.
     Mutex& GetMutex() {
         return mutex;
@@ -361,6 +372,10 @@ private:
     /// Per-process address arbiter.
     AddressArbiter address_arbiter;
 
+    /// Threads waiting on address arbiter addresses and condition variables, by address.
+    AddressWaitTable arbiter_wait_table;
+    AddressWaitTable condvar_wait_table;
+
     /// The per-process mutex lock instance used for handling various
     /// forms of services, such as lock arbitration, and condition
     /// variable related facilities.
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "core/hle/kernel/object.h"
+#include "core/hle/kernel/slab_heap.h"
 #include "core/hle/kernel/wait_object.h"
 
 union ResultCode;
@@ -14,7 +15,7 @@ namespace Kernel {
 class KernelCore;
 class WritableEvent;
 
-class ReadableEvent final : public WaitObject {
+class ReadableEvent final : public WaitObject, public SlabAllocated<ReadableEvent> {
     friend class WritableEvent;
 
 public:
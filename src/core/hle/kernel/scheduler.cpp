@@ -6,8 +6,6 @@
 // licensed under GPLv2 or later under exception provided by the author.
 
 #include <algorithm>
-#include <set>
-#include <unordered_set>
 #include <utility>
 
 #include "common/assert.h"
@@ -61,7 +59,8 @@ void GlobalScheduler::SelectThread(u32 core) {
     }
     // Step 2: Try selecting a suggested thread.
     Thread* winner = nullptr;
-    std::set<s32> sug_cores;
+    // Cores whose top thread was suggested, kept as a mask to avoid allocating on each selection
+    u32 sug_cores = 0;
     for (auto thread : suggested_queue[core]) {
         s32 this_core = thread->GetProcessorID();
         Thread* thread_on_core = nullptr;
@@ -72,7 +71,7 @@ void GlobalScheduler::SelectThread(u32 core) {
             winner = thread;
             break;
         }
-        sug_cores.insert(this_core);
+        sug_cores |= 1U << this_core;
     }
     // if we got a suggested thread, select it, else do a second pass.
     if (winner && winner->GetPriority() > 2) {
@@ -84,7 +83,10 @@ void GlobalScheduler::SelectThread(u32 core) {
         return;
     }
     // Step 3: Select a suggested thread from another core
-    for (auto& src_core : sug_cores) {
+    for (u32 src_core = 0; src_core < NUM_CPU_CORES; src_core++) {
+        if ((sug_cores & (1U << src_core)) == 0) {
+            continue;
+        }
         auto it = scheduled_queue[src_core].begin();
         it++;
         if (it != scheduled_queue[src_core].end()) {
@@ -453,9 +455,18 @@ void Scheduler::SwitchContext() {
         auto* const thread_owner_process = current_thread->GetOwnerProcess();
         if (previous_process != thread_owner_process) {
             system.Kernel().MakeCurrentProcess(thread_owner_process);
+            // The CPU state of the other page table is held separately
+            fp_simd_owner_id = 0;
         }
 
-        cpu_core.LoadContext(new_thread->GetContext());
+        // A thread switched back in with no other thread run in between finds its FP/SIMD state
+        // where it left it
+        if (new_thread->GetThreadID() == fp_simd_owner_id) {
+            cpu_core.LoadIntegerContext(new_thread->GetContext());
+        } else {
+            cpu_core.LoadContext(new_thread->GetContext());
+            fp_simd_owner_id = new_thread->GetThreadID();
+        }
         cpu_core.SetTlsAddress(new_thread->GetTLSAddress());
         cpu_core.SetTPIDR_EL0(new_thread->GetTPIDR_EL0());
         cpu_core.ClearExclusiveState();
@@ -222,6 +222,10 @@ private:
     u64 idle_selection_count = 0;
     const u32 core_id;
 
+    /// ID of the thread whose FP/SIMD registers the CPU holds, they were saved to its context
+    /// when it was switched out and can be kept when it is switched back in. Zero when none.
+    u64 fp_simd_owner_id = 0;
+
     bool is_context_switch_pending = false;
 };
 
@@ -86,14 +86,16 @@ std::size_t ServerSession::NumDomainRequestHandlers() const {
     return domain_request_handlers.size();
 }
 
+std::shared_ptr<SessionRequestHandler> ServerSession::GetDomainRequestHandler(
+    std::size_t index) const {
+    return domain_request_handlers.at(index);
+}
+
 ResultCode ServerSession::HandleDomainSyncRequest(Kernel::HLERequestContext& context) {
     if (!context.HasDomainMessageHeader()) {
         return RESULT_SUCCESS;
     }
 
-    // Set domain handlers in HLE context, used for domain objects (IPC interfaces) as inputs
-    context.SetDomainRequestHandlers(domain_request_handlers);
-
     // If there is a DomainMessageHeader, then this is CommandType "Request"
     const auto& domain_message_header = context.GetDomainMessageHeader();
     const u32 object_id{domain_message_header.object_id};
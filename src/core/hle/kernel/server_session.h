@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "core/hle/kernel/object.h"
+#include "core/hle/kernel/slab_heap.h"
 #include "core/hle/kernel/wait_object.h"
 #include "core/hle/result.h"
 
@@ -36,7 +37,7 @@ class Thread;
  * After the server replies to the request, the response is marshalled back to the caller's
  * TLS buffer and control is transferred back to it.
  */
-class ServerSession final : public WaitObject {
+class ServerSession final : public WaitObject, public SlabAllocated<ServerSession> {
 public:
     std::string GetTypeName() const override {
         return "ServerSession";
@@ -102,6 +103,10 @@ public:
     /// appended to this ServerSession instance.
     std::size_t NumDomainRequestHandlers() const;
 
+    /// Retrieves the domain request handler at an index, domain objects are identified by their
+    /// index plus one.
+    std::shared_ptr<SessionRequestHandler> GetDomainRequestHandler(std::size_t index) const;
+
     /// Returns true if the session has been converted to a domain, otherwise False
     bool IsDomain() const {
         return !IsSession();
@@ -12,6 +12,7 @@
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/physical_memory.h"
 #include "core/hle/kernel/process.h"
+#include "core/hle/kernel/slab_heap.h"
 #include "core/hle/result.h"
 
 namespace Kernel {
@@ -31,7 +32,7 @@ enum class MemoryPermission : u32 {
     DontCare = (1u << 28)
 };
 
-class SharedMemory final : public Object {
+class SharedMemory final : public Object, public SlabAllocated<SharedMemory> {
 public:
     /**
      * Creates a shared memory object.
@@ -0,0 +1,93 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+
+#include "common/assert.h"
+
+namespace Kernel {
+
+/**
+ * Allocator of the objects of a single kernel object type, similar to the slab heaps of Horizon.
+ * Memory is taken from the heap in blocks of several objects and freed objects are kept in a free
+ * list for the next allocations, so churning objects of the type rarely reaches the heap
+ * allocator. Memory of the slab heap is never returned to the heap.
+ *
+ * Object types opt in by deriving from SlabAllocated, see below.
+ */
+template <typename T>
+class SlabHeap final {
+public:
+    /// Number of objects allocated at once when the free list is empty.
+    static constexpr std::size_t OBJECTS_PER_BLOCK = 64;
+
+    static void* Allocate() {
+        State& state = GetState();
+        std::lock_guard lock{state.mutex};
+        if (state.free_list == nullptr) {
+            Grow(state);
+        }
+        Node* const node = state.free_list;
+        state.free_list = node->next;
+        return node;
+    }
+
+    static void Free(void* pointer) {
+        if (pointer == nullptr) {
+            return;
+        }
+        State& state = GetState();
+        std::lock_guard lock{state.mutex};
+        Node* const node = static_cast<Node*>(pointer);
+        node->next = state.free_list;
+        state.free_list = node;
+    }
+
+private:
+    union Node {
+        Node* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct State {
+        std::mutex mutex;
+        Node* free_list = nullptr;
+    };
+
+    static State& GetState() {
+        // Never destroyed, objects can be freed during the destruction of other statics
+        static State* const state = new State;
+        return *state;
+    }
+
+    static void Grow(State& state) {
+        Node* const block = new Node[OBJECTS_PER_BLOCK];
+        for (std::size_t i = 0; i < OBJECTS_PER_BLOCK; ++i) {
+            block[i].next = i + 1 < OBJECTS_PER_BLOCK ? &block[i + 1] : state.free_list;
+        }
+        state.free_list = block;
+    }
+};
+
+/**
+ * Makes new and delete of a kernel object type use its SlabHeap. The type must be final, the
+ * storage of the slab heap is sized for it.
+ */
+template <typename T>
+class SlabAllocated {
+public:
+    static void* operator new(std::size_t size) {
+        ASSERT(size == sizeof(T));
+        return SlabHeap<T>::Allocate();
+    }
+
+    static void operator delete(void* pointer) {
+        SlabHeap<T>::Free(pointer);
+    }
+};
+
+} // namespace Kernel
@@ -38,10 +38,10 @@
 #include "core/hle/kernel/thread.h"
 #include "core/hle/kernel/transfer_memory.h"
 #include "core/hle/kernel/writable_event.h"
-#include "core/hle/lock.h"
 #include "core/hle/result.h"
 #include "core/hle/service/service.h"
 #include "core/memory.h"
+#include "core/perf_stats.h"
 #include "core/reporter.h"
 
 namespace Kernel {
@@ -57,6 +57,10 @@ constexpr bool IsValidAddressRange(VAddr address, u64 size) {
 // 8 GiB
 constexpr u64 MAIN_MEMORY_SIZE = 0x200000000;
 
+// Consecutive zero timeout waits that found nothing after which a thread is considered to be
+// busy waiting.
+constexpr u32 BUSY_WAIT_POLL_THRESHOLD = 4;
+
 // Helper function that performs the common sanity checks for svcMapMemory
 // and svcUnmapMemory. This is doable, as both functions perform their sanitizing
 // in the same order.
@@ -498,6 +502,7 @@ static ResultCode WaitSynchronization(Core::System& system, Handle* index, VAddr
         WaitObject* object = itr->get();
         object->Acquire(thread);
         *index = static_cast<s32>(std::distance(objects.begin(), itr));
+        thread->ResetEmptyPollCount();
         return RESULT_SUCCESS;
     }
 
@@ -506,12 +511,16 @@ static ResultCode WaitSynchronization(Core::System& system, Handle* index, VAddr
     // If a timeout value of 0 was provided, just return the Timeout error code instead of
     // suspending the thread.
     if (nano_seconds == 0) {
+        // A thread that keeps polling is busy waiting for another core or an event, finish its
+        // slice early so they get to run instead of burning host time on the loop.
+        if (thread->IncrementEmptyPollCount() >= BUSY_WAIT_POLL_THRESHOLD) {
+            system.CoreTiming().Idle();
+            system.PrepareReschedule(thread->GetProcessorID());
+        }
         return RESULT_TIMEOUT;
     }
 
-    for (auto& object : objects) {
-        object->AddWaitingThread(thread);
-    }
+    thread->ResetEmptyPollCount();
 
     thread->SetWaitObjects(std::move(objects));
     thread->SetStatus(ThreadStatus::WaitSynch);
@@ -1585,9 +1594,9 @@ static void SleepThread(Core::System& system, s64 nanoseconds) {
 
     if (is_redundant) {
         // If it's redundant, the core is pretty much idle. Some games keep idling
-        // a core while it's doing nothing, we advance timing to avoid costly continuous
-        // calls.
-        system.CoreTiming().AddTicks(2000);
+        // a core while it's doing nothing, we skip to the next event to avoid costly
+        // continuous calls.
+        system.CoreTiming().Idle();
     }
     system.PrepareReschedule(current_thread->GetProcessorID());
 }
@@ -1650,22 +1659,11 @@ static ResultCode SignalProcessWideKey(Core::System& system, VAddr condition_var
 
     ASSERT(condition_variable_addr == Common::AlignDown(condition_variable_addr, 4));
 
-    // Retrieve a list of all threads that are waiting for this condition variable.
-    std::vector<SharedPtr<Thread>> waiting_threads;
-    const auto& scheduler = system.GlobalScheduler();
-    const auto& thread_list = scheduler.GetThreadList();
-
-    for (const auto& thread : thread_list) {
-        if (thread->GetCondVarWaitAddress() == condition_variable_addr) {
-            waiting_threads.push_back(thread);
-        }
-    }
-
-    // Sort them by priority, such that the highest priority ones come first.
-    std::sort(waiting_threads.begin(), waiting_threads.end(),
-              [](const SharedPtr<Thread>& lhs, const SharedPtr<Thread>& rhs) {
-                  return lhs->GetPriority() < rhs->GetPriority();
-              });
+    // Retrieve a list of all threads that are waiting for this condition variable, sorted by
+    // priority such that the highest priority ones come first.
+    const std::vector<SharedPtr<Thread>> waiting_threads =
+        system.Kernel().CurrentProcess()->GetCondVarWaitTable().GetWaitingThreads(
+            condition_variable_addr);
 
     // Only process up to 'target' threads, unless 'target' is -1, in which case process
     // them all.
@@ -2504,10 +2502,20 @@ MICROPROFILE_DEFINE(Kernel_SVC, "Kernel", "SVC", MP_RGB(70, 200, 70));
 void CallSVC(Core::System& system, u32 immediate) {
     MICROPROFILE_SCOPE(Kernel_SVC);
 
+    const FunctionDef* info = GetSVCInfo(immediate);
+
+    // GetSystemTick is polled in tight loops by some games and only reads the core timing, which
+    // the kernel mutex doesn't protect, so it skips taking the mutex.
+    if (info && info->func == SvcWrap<GetSystemTick>) {
+        info->func(system);
+        return;
+    }
+
+    const Core::PerfTimer timer{system.GetPerfStats(), Core::PerfCategory::Svc};
+
     // Lock the global kernel mutex when we enter the kernel HLE.
-    std::lock_guard lock{HLE::g_hle_lock};
+    std::lock_guard lock{system.Kernel().HLELock()};
 
-    const FunctionDef* info = GetSVCInfo(immediate);
     if (info) {
         if (info->func) {
             info->func(system);
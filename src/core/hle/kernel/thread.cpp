@@ -37,22 +37,24 @@ void Thread::Acquire(Thread* thread) {
 }
 
 Thread::Thread(KernelCore& kernel) : WaitObject{kernel} {}
-Thread::~Thread() = default;
+Thread::~Thread() {
+    ClearWaitObjects();
+}
 
 void Thread::Stop() {
     // Cancel any outstanding wakeup events for this thread
-    Core::System::GetInstance().CoreTiming().UnscheduleEvent(kernel.ThreadWakeupCallbackEventType(),
-                                                             callback_handle);
+    CancelWakeupTimer();
     kernel.ThreadWakeupCallbackHandleTable().Close(callback_handle);
     callback_handle = 0;
     SetStatus(ThreadStatus::Dead);
     WakeupAllWaitingThreads();
 
     // Clean up any dangling references in objects that this thread was waiting for
-    for (auto& wait_object : wait_objects) {
-        wait_object->RemoveWaitingThread(this);
-    }
-    wait_objects.clear();
+    ClearWaitObjects();
+
+    // Drop the thread from the address wait tables of its process
+    SetCondVarWaitAddress(0);
+    SetArbiterWaitAddress(0);
 
     owner_process->UnregisterThread(this);
 
@@ -60,6 +62,34 @@ void Thread::Stop() {
     owner_process->FreeTLSRegion(tls_address);
 }
 
+void Thread::SetCondVarWaitAddress(VAddr address) {
+    if (condvar_wait_address == address) {
+        return;
+    }
+    AddressWaitTable& wait_table = owner_process->GetCondVarWaitTable();
+    if (condvar_wait_address != 0) {
+        wait_table.Remove(condvar_wait_address, this);
+    }
+    condvar_wait_address = address;
+    if (address != 0) {
+        wait_table.Add(address, this);
+    }
+}
+
+void Thread::SetArbiterWaitAddress(VAddr address) {
+    if (arb_wait_address == address) {
+        return;
+    }
+    AddressWaitTable& wait_table = owner_process->GetArbiterWaitTable();
+    if (arb_wait_address != 0) {
+        wait_table.Remove(arb_wait_address, this);
+    }
+    arb_wait_address = address;
+    if (address != 0) {
+        wait_table.Add(address, this);
+    }
+}
+
 void Thread::WakeAfterDelay(s64 nanoseconds) {
     // Don't schedule a wakeup if the thread wants to wait forever
     if (nanoseconds == -1)
@@ -69,12 +99,11 @@ void Thread::WakeAfterDelay(s64 nanoseconds) {
     // thread-safe version of ScheduleEvent.
     const s64 cycles = Core::Timing::nsToCycles(std::chrono::nanoseconds{nanoseconds});
     Core::System::GetInstance().CoreTiming().ScheduleEvent(
-        cycles, kernel.ThreadWakeupCallbackEventType(), callback_handle);
+        cycles, kernel.ThreadWakeupCallbackEventType(), GetWakeupTimerUserdata());
 }
 
 void Thread::CancelWakeupTimer() {
-    Core::System::GetInstance().CoreTiming().UnscheduleEvent(kernel.ThreadWakeupCallbackEventType(),
-                                                             callback_handle);
+    ++wakeup_generation;
 }
 
 static std::optional<s32> GetNextProcessorId(u64 mask) {
@@ -337,6 +366,24 @@ void Thread::ChangeCore(u32 core, u64 mask) {
     SetCoreAndAffinityMask(core, mask);
 }
 
+void Thread::SetWaitObjects(ThreadWaitObjects objects) {
+    ClearWaitObjects();
+    wait_objects = std::move(objects);
+    wait_nodes.resize(wait_objects.size());
+    for (std::size_t i = 0; i < wait_objects.size(); ++i) {
+        wait_nodes[i].thread = this;
+        wait_objects[i]->LinkWaitingThread(wait_nodes[i]);
+    }
+}
+
+void Thread::ClearWaitObjects() {
+    for (std::size_t i = 0; i < wait_objects.size(); ++i) {
+        wait_objects[i]->UnlinkWaitingThread(wait_nodes[i]);
+    }
+    wait_objects.clear();
+    wait_nodes.clear();
+}
+
 bool Thread::AllWaitObjectsReady() const {
     return std::none_of(
         wait_objects.begin(), wait_objects.end(),
@@ -397,6 +444,12 @@ void Thread::SetSchedulingStatus(ThreadSchedStatus new_status) {
 void Thread::SetCurrentPriority(u32 new_priority) {
     const u32 old_priority = std::exchange(current_priority, new_priority);
     AdjustSchedulingOnPriority(old_priority);
+
+    // The waiting lists of the objects the thread waits on are sorted by priority
+    for (std::size_t i = 0; i < wait_objects.size(); ++i) {
+        wait_objects[i]->UnlinkWaitingThread(wait_nodes[i]);
+        wait_objects[i]->LinkWaitingThread(wait_nodes[i]);
+    }
 }
 
 ResultCode Thread::SetCoreAndAffinityMask(s32 new_core, u64 new_affinity_mask) {
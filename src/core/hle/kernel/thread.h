@@ -11,6 +11,7 @@
 #include "common/common_types.h"
 #include "core/arm/arm_interface.h"
 #include "core/hle/kernel/object.h"
+#include "core/hle/kernel/slab_heap.h"
 #include "core/hle/kernel/wait_object.h"
 #include "core/hle/result.h"
 
@@ -95,7 +96,7 @@ enum class ThreadSchedMasks : u32 {
     ForcePauseMask = 0x0070,
 };
 
-class Thread final : public WaitObject {
+class Thread final : public WaitObject, public SlabAllocated<Thread> {
 public:
     using MutexWaitingThreads = std::vector<SharedPtr<Thread>>;
 
@@ -205,6 +206,11 @@ public:
     /// Cancel any outstanding wakeup events for this thread
     void CancelWakeupTimer();
 
+    /// Returns whether a wakeup event scheduled with the given userdata hasn't been cancelled.
+    bool IsWakeupTimerCurrent(u64 userdata) const {
+        return userdata == GetWakeupTimerUserdata();
+    }
+
     /**
      * Sets the result after the thread awakens (from svcWaitSynchronization)
      * @param result Value to set to the returned result
@@ -314,16 +320,11 @@ public:
         return wait_objects;
     }
 
-    void SetWaitObjects(ThreadWaitObjects objects) {
-        wait_objects = std::move(objects);
-    }
+    /// Sets the objects the thread waits on and adds it to their waiting lists.
+    void SetWaitObjects(ThreadWaitObjects objects);
 
-    void ClearWaitObjects() {
-        for (const auto& waiting_object : wait_objects) {
-            waiting_object->RemoveWaitingThread(this);
-        }
-        wait_objects.clear();
-    }
+    /// Removes the thread from the waiting lists of its wait objects and clears them.
+    void ClearWaitObjects();
 
     /// Determines whether all the objects this thread is waiting on are ready.
     bool AllWaitObjectsReady() const;
@@ -344,9 +345,8 @@ public:
         return condvar_wait_address;
     }
 
-    void SetCondVarWaitAddress(VAddr address) {
-        condvar_wait_address = address;
-    }
+    /// Sets the condition variable the thread waits on, or 0 when it doesn't wait on any.
+    void SetCondVarWaitAddress(VAddr address);
 
     VAddr GetMutexWaitAddress() const {
         return mutex_wait_address;
@@ -368,9 +368,8 @@ public:
         return arb_wait_address;
     }
 
-    void SetArbiterWaitAddress(VAddr address) {
-        arb_wait_address = address;
-    }
+    /// Sets the address the thread waits on with the arbiter, or 0 when it doesn't wait on any.
+    void SetArbiterWaitAddress(VAddr address);
 
     bool HasWakeupCallback() const {
         return wakeup_callback != nullptr;
@@ -440,6 +439,15 @@ public:
         is_running = value;
     }
 
+    /// Counts a zero timeout wait that found nothing to acquire, returns the consecutive count.
+    u32 IncrementEmptyPollCount() {
+        return ++empty_poll_count;
+    }
+
+    void ResetEmptyPollCount() {
+        empty_poll_count = 0;
+    }
+
 private:
     explicit Thread(KernelCore& kernel);
     ~Thread() override;
@@ -487,6 +495,10 @@ private:
     /// passed to WaitSynchronization.
     ThreadWaitObjects wait_objects;
 
+    /// Links of the thread in the waiting lists of its wait objects, one for each of them. Its
+    /// capacity is kept between waits, waiting again does not allocate.
+    std::vector<WaitNode> wait_nodes;
+
     /// List of threads that are waiting for a mutex that is held by this thread.
     MutexWaitingThreads wait_mutex_threads;
 
@@ -503,9 +515,20 @@ private:
     /// If waiting for an AddressArbiter, this is the address being waited on.
     VAddr arb_wait_address{0};
 
+    /// Userdata of the wakeup event of the thread, the callback handle in the low bits and the
+    /// wakeup generation in the high bits.
+    u64 GetWakeupTimerUserdata() const {
+        return (u64{wakeup_generation} << 32) | callback_handle;
+    }
+
     /// Handle used as userdata to reference this object when inserting into the CoreTiming queue.
     Handle callback_handle = 0;
 
+    /// Incremented when the wakeup event of the thread is cancelled. Cancelled events stay in the
+    /// CoreTiming queue and are ignored when they fire, which avoids searching the queue on each
+    /// cancellation.
+    u32 wakeup_generation = 0;
+
     /// Callback that will be invoked when the thread is resumed from a waiting state. If the thread
     /// was waiting via WaitSynchronization then the object will be the last object that became
     /// available. In case of a timeout, the object will be nullptr.
@@ -525,6 +548,9 @@ private:
     u32 scheduling_state = 0;
     bool is_running = false;
 
+    /// Consecutive zero timeout waits that found nothing, used to detect busy waiting.
+    u32 empty_poll_count = 0;
+
     std::string name;
 };
 
@@ -75,13 +75,17 @@ VMManager::VMManager(Core::System& system) : system{system} {
     Reset(FileSys::ProgramAddressSpaceType::Is39Bit);
 }
 
-VMManager::~VMManager() = default;
+VMManager::~VMManager() {
+    ReleasePageTable();
+}
 
 void VMManager::Reset(FileSys::ProgramAddressSpaceType type) {
     Clear();
 
     InitializeMemoryRegionRanges(type);
 
+    // Resizing can move the page table, the JITs built on it would refer to the old storage
+    ReleasePageTable();
     page_table.Resize(address_space_width);
 
     // Initialize the map with a single free region covering the entire managed space.
@@ -280,9 +284,12 @@ ResultVal<VAddr> VMManager::SetHeapSize(u64 size) {
     }
 
     if (heap_memory == nullptr) {
-        // Initialize heap
-        heap_memory = std::make_shared<PhysicalMemory>(size);
-        heap_end = heap_region_base + size;
+        // Initialize heap. Where untouched host pages are free, the whole region is reserved up
+        // front, so the heap never has to be moved and only the touched pages take up memory.
+        heap_memory = std::make_shared<PhysicalMemory>();
+        if constexpr (HostMemory::LAZY_COMMIT) {
+            heap_memory->reserve(GetHeapRegionSize());
+        }
     } else {
         UnmapRange(heap_region_base, GetCurrentHeapSize());
     }
@@ -291,15 +298,17 @@ ResultVal<VAddr> VMManager::SetHeapSize(u64 size) {
     // the case of allocating. Otherwise, shrink the backing memory,
     // if a smaller heap has been requested.
     const u64 old_heap_size = GetCurrentHeapSize();
+    const u8* const old_heap_data = heap_memory->data();
     if (size > old_heap_size) {
-        const u64 alloc_size = size - old_heap_size;
-
-        heap_memory->insert(heap_memory->end(), alloc_size, 0);
-        RefreshMemoryBlockMappings(heap_memory.get());
+        // The new pages are zero already, they are committed when the guest first touches them
+        heap_memory->resize(size);
     } else if (size < old_heap_size) {
+        // Heap sizes are multiples of 2MB, so the freed pages are whole host pages. They read as
+        // zero once discarded, as the heap expects of them when it grows again.
         heap_memory->resize(size);
-        heap_memory->shrink_to_fit();
-
+        HostMemory::Discard(heap_memory->data() + size, old_heap_size - size);
+    }
+    if (heap_memory->data() != old_heap_data) {
         RefreshMemoryBlockMappings(heap_memory.get());
     }
 
@@ -545,7 +554,7 @@ ResultCode VMManager::UnmapCodeMemory(VAddr dst_address, VAddr src_address, u64
     Reprotect(src_vma_iter, VMAPermission::ReadWrite);
 
     if (dst_memory_state == MemoryState::ModuleCode) {
-        system.InvalidateCpuInstructionCaches();
+        system.InvalidateCpuInstructionCacheRange(dst_address, size);
     }
 
     return unmap_result;
@@ -903,6 +912,17 @@ void VMManager::InitializeMemoryRegionRanges(FileSys::ProgramAddressSpaceType ty
     }
 }
 
+void VMManager::ReleasePageTable() {
+    // The CPU cores, and the JITs they keep, only exist while the system is powered on
+    if (!system.IsPoweredOn()) {
+        return;
+    }
+    system.ArmInterface(0).PageTableDestroyed(page_table);
+    system.ArmInterface(1).PageTableDestroyed(page_table);
+    system.ArmInterface(2).PageTableDestroyed(page_table);
+    system.ArmInterface(3).PageTableDestroyed(page_table);
+}
+
 void VMManager::Clear() {
     ClearVMAMap();
     ClearPageTable();
@@ -914,7 +934,7 @@ void VMManager::ClearVMAMap() {
 
 void VMManager::ClearPageTable() {
     std::fill(page_table.pointers.begin(), page_table.pointers.end(), nullptr);
-    page_table.special_regions.clear();
+    page_table.ClearSpecialRegions();
     std::fill(page_table.attributes.begin(), page_table.attributes.end(),
               Common::PageType::Unmapped);
 }
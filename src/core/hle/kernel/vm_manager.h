@@ -701,6 +701,9 @@ private:
     /// Clears the underlying map and page table.
     void Clear();
 
+    /// Has the CPU cores drop the JITs they built for the page table.
+    void ReleasePageTable();
+
     /// Clears out the VMA map, unmapping any previously mapped ranges.
     void ClearVMAMap();
 
@@ -777,7 +780,8 @@ private:
     // Memory used to back the allocations in the regular heap. A single vector is used to cover
     // the entire virtual address space extents that bound the allocations, including any holes.
     // This makes deallocation and reallocation of holes fast and keeps process memory contiguous
-    // in the emulator address space, allowing Memory::GetPointer to be reasonably safe.
+    // in the emulator address space, allowing Memory::GetPointer to be reasonably safe. Its
+    // capacity covers the whole heap region where that is free, see HostMemory::LAZY_COMMIT.
     std::shared_ptr<PhysicalMemory> heap_memory;
 
     // The end of the currently allocated heap. This is not an inclusive
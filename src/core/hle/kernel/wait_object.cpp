@@ -18,26 +18,54 @@ namespace Kernel {
 WaitObject::WaitObject(KernelCore& kernel) : Object{kernel} {}
 WaitObject::~WaitObject() = default;
 
-void WaitObject::AddWaitingThread(SharedPtr<Thread> thread) {
-    auto itr = std::find(waiting_threads.begin(), waiting_threads.end(), thread);
-    if (itr == waiting_threads.end())
-        waiting_threads.push_back(std::move(thread));
+void WaitObject::LinkWaitingThread(WaitNode& node) {
+    ASSERT(node.prev == nullptr && node.next == nullptr && first_waiter != &node);
+
+    // Threads of the same priority are awoken in the order they started waiting
+    const u32 priority = node.thread->GetPriority();
+    WaitNode* prev = last_waiter;
+    while (prev != nullptr && prev->thread->GetPriority() > priority) {
+        prev = prev->prev;
+    }
+
+    WaitNode* const next = prev != nullptr ? prev->next : first_waiter;
+    node.prev = prev;
+    node.next = next;
+    if (prev != nullptr) {
+        prev->next = &node;
+    } else {
+        first_waiter = &node;
+    }
+    if (next != nullptr) {
+        next->prev = &node;
+    } else {
+        last_waiter = &node;
+    }
 }
 
-void WaitObject::RemoveWaitingThread(Thread* thread) {
-    auto itr = std::find(waiting_threads.begin(), waiting_threads.end(), thread);
-    // If a thread passed multiple handles to the same object,
-    // the kernel might attempt to remove the thread from the object's
-    // waiting threads list multiple times.
-    if (itr != waiting_threads.end())
-        waiting_threads.erase(itr);
+void WaitObject::UnlinkWaitingThread(WaitNode& node) {
+    // A thread that was resumed already is not linked anymore
+    if (node.prev == nullptr && first_waiter != &node) {
+        return;
+    }
+    if (node.prev != nullptr) {
+        node.prev->next = node.next;
+    } else {
+        first_waiter = node.next;
+    }
+    if (node.next != nullptr) {
+        node.next->prev = node.prev;
+    } else {
+        last_waiter = node.prev;
+    }
+    node.prev = nullptr;
+    node.next = nullptr;
 }
 
 SharedPtr<Thread> WaitObject::GetHighestPriorityReadyThread() const {
-    Thread* candidate = nullptr;
-    u32 candidate_priority = THREADPRIO_LOWEST + 1;
-
-    for (const auto& thread : waiting_threads) {
+    // The list is sorted by priority, the first thread that is ready is the one to wake up
+    for (const WaitNode* node = first_waiter; node != nullptr; node = node->next) {
+        Thread* const thread = node->thread;
         const ThreadStatus thread_status = thread->GetStatus();
 
         // The list of waiting threads must not contain threads that are not waiting to be awakened.
@@ -45,26 +73,17 @@ SharedPtr<Thread> WaitObject::GetHighestPriorityReadyThread() const {
                        thread_status == ThreadStatus::WaitHLEEvent,
                    "Inconsistent thread statuses in waiting_threads");
 
-        if (thread->GetPriority() >= candidate_priority)
-            continue;
-
-        if (ShouldWait(thread.get()))
+        if (ShouldWait(thread))
             continue;
 
         // A thread is ready to run if it's either in ThreadStatus::WaitSynch
         // and the rest of the objects it is waiting on are ready.
-        bool ready_to_run = true;
-        if (thread_status == ThreadStatus::WaitSynch) {
-            ready_to_run = thread->AllWaitObjectsReady();
-        }
-
-        if (ready_to_run) {
-            candidate = thread.get();
-            candidate_priority = thread->GetPriority();
+        if (thread_status != ThreadStatus::WaitSynch || thread->AllWaitObjectsReady()) {
+            return thread;
         }
     }
 
-    return candidate;
+    return nullptr;
 }
 
 void WaitObject::WakeupWaitingThread(SharedPtr<Thread> thread) {
@@ -105,8 +124,12 @@ void WaitObject::WakeupAllWaitingThreads() {
     }
 }
 
-const std::vector<SharedPtr<Thread>>& WaitObject::GetWaitingThreads() const {
-    return waiting_threads;
+std::vector<SharedPtr<Thread>> WaitObject::GetWaitingThreads() const {
+    std::vector<SharedPtr<Thread>> threads;
+    for (const WaitNode* node = first_waiter; node != nullptr; node = node->next) {
+        threads.emplace_back(node->thread);
+    }
+    return threads;
 }
 
 } // namespace Kernel
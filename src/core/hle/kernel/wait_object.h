@@ -13,6 +13,16 @@ namespace Kernel {
 class KernelCore;
 class Thread;
 
+/**
+ * Link of a thread in the waiting list of an object. A waiting thread holds one for each of the
+ * objects it waits on, so waiting and waking up need no allocation and no search of the lists.
+ */
+struct WaitNode {
+    Thread* thread = nullptr;
+    WaitNode* prev = nullptr;
+    WaitNode* next = nullptr;
+};
+
 /// Class that represents a Kernel object that a thread can be waiting on
 class WaitObject : public Object {
 public:
@@ -30,16 +40,16 @@ public:
     virtual void Acquire(Thread* thread) = 0;
 
     /**
-     * Add a thread to wait on this object
-     * @param thread Pointer to thread to add
+     * Add a thread to wait on this object, after the waiting threads of higher or equal priority
+     * @param node Link of the thread for this object, must stay in place while it is linked
      */
-    void AddWaitingThread(SharedPtr<Thread> thread);
+    void LinkWaitingThread(WaitNode& node);
 
     /**
      * Removes a thread from waiting on this object (e.g. if it was resumed already)
-     * @param thread Pointer to thread to remove
+     * @param node Link of the thread for this object
      */
-    void RemoveWaitingThread(Thread* thread);
+    void UnlinkWaitingThread(WaitNode& node);
 
     /**
      * Wake up all threads waiting on this object that can be awoken, in priority order,
@@ -56,12 +66,14 @@ public:
     /// Obtains the highest priority thread that is ready to run from this object's waiting list.
     SharedPtr<Thread> GetHighestPriorityReadyThread() const;
 
-    /// Get a const reference to the waiting threads list for debug use
-    const std::vector<SharedPtr<Thread>>& GetWaitingThreads() const;
+    /// Get the waiting threads in the order they are awoken for debug use
+    std::vector<SharedPtr<Thread>> GetWaitingThreads() const;
 
 private:
-    /// Threads waiting for this object to become available
-    std::vector<SharedPtr<Thread>> waiting_threads;
+    /// Threads waiting for this object to become available, sorted by priority and then by the
+    /// time they started waiting
+    WaitNode* first_waiter = nullptr;
+    WaitNode* last_waiter = nullptr;
 };
 
 // Specialization of DynamicObjectCast for WaitObjects
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "core/hle/kernel/object.h"
+#include "core/hle/kernel/slab_heap.h"
 
 namespace Kernel {
 
@@ -17,7 +18,7 @@ struct EventPair {
     SharedPtr<WritableEvent> writable;
 };
 
-class WritableEvent final : public Object {
+class WritableEvent final : public Object, public SlabAllocated<WritableEvent> {
 public:
     ~WritableEvent() override;
 
@@ -10,6 +10,7 @@
 #include "core/frontend/applets/profile_select.h"
 #include "core/frontend/applets/software_keyboard.h"
 #include "core/frontend/applets/web_browser.h"
+#include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/readable_event.h"
 #include "core/hle/kernel/server_session.h"
 #include "core/hle/kernel/writable_event.h"
@@ -120,10 +121,14 @@ Kernel::SharedPtr<Kernel::ReadableEvent> AppletDataBroker::GetStateChangedEvent(
     return state_changed_event.readable;
 }
 
-Applet::Applet(Kernel::KernelCore& kernel_) : broker{kernel_} {}
+Applet::Applet(Kernel::KernelCore& kernel_) : broker{kernel_}, kernel{kernel_} {}
 
 Applet::~Applet() = default;
 
+std::recursive_mutex& Applet::HLELock() {
+    return kernel.HLELock();
+}
+
 void Applet::Initialize() {
     const auto common = broker.PopNormalDataToApplet();
     ASSERT(common != nullptr);
@@ -5,7 +5,9 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <queue>
+#include <utility>
 #include "common/swap.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/writable_event.h"
@@ -149,9 +151,26 @@ protected:
     };
     static_assert(sizeof(CommonArguments) == 0x20, "CommonArguments has incorrect size.");
 
+    /**
+     * Wraps a callback given to a frontend applet so that it takes the HLE lock of the kernel, as
+     * frontends may call it from their own thread once the user is done.
+     */
+    template <typename Func>
+    auto MakeFrontendCallback(Func&& func) {
+        return [this, func = std::forward<Func>(func)](auto&&... args) {
+            std::lock_guard lock{HLELock()};
+            func(std::forward<decltype(args)>(args)...);
+        };
+    }
+
     CommonArguments common_args{};
     AppletDataBroker broker;
     bool initialized = false;
+
+private:
+    std::recursive_mutex& HLELock();
+
+    Kernel::KernelCore& kernel;
 };
 
 struct AppletFrontendSet {
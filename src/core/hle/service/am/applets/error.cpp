@@ -146,7 +146,7 @@ void Error::Execute() {
         return;
     }
 
-    const auto callback = [this] { DisplayCompleted(); };
+    const auto callback = MakeFrontendCallback([this] { DisplayCompleted(); });
     const auto title_id = system.CurrentProcess()->GetTitleID();
     const auto& reporter{system.GetReporter()};
 
@@ -95,7 +95,8 @@ void Auth::Execute() {
 
     switch (type) {
     case AuthAppletType::ShowParentalAuthentication: {
-        const auto callback = [this](bool successful) { AuthFinished(successful); };
+        const auto callback =
+            MakeFrontendCallback([this](bool successful) { AuthFinished(successful); });
 
         if (arg0 == 1 && arg1 == 0 && arg2 == 1) {
             // ShowAuthenticatorForConfiguration
@@ -109,7 +110,7 @@ void Auth::Execute() {
         break;
     }
     case AuthAppletType::RegisterParentalPasscode: {
-        const auto callback = [this] { AuthFinished(true); };
+        const auto callback = MakeFrontendCallback([this] { AuthFinished(true); });
 
         if (arg0 == 0 && arg1 == 0 && arg2 == 0) {
             // RegisterParentalPasscode
@@ -120,7 +121,7 @@ void Auth::Execute() {
         break;
     }
     case AuthAppletType::ChangeParentalPasscode: {
-        const auto callback = [this] { AuthFinished(true); };
+        const auto callback = MakeFrontendCallback([this] { AuthFinished(true); });
 
         if (arg0 == 0 && arg1 == 0 && arg2 == 0) {
             // ChangeParentalPasscode
@@ -184,7 +185,7 @@ void PhotoViewer::Execute() {
     if (complete)
         return;
 
-    const auto callback = [this] { ViewFinished(); };
+    const auto callback = MakeFrontendCallback([this] { ViewFinished(); });
     switch (mode) {
     case PhotoViewerAppletMode::CurrentApp:
         frontend.ShowPhotosForApplication(system.CurrentProcess()->GetTitleID(), callback);
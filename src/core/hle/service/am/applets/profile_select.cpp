@@ -54,7 +54,8 @@ void ProfileSelect::Execute() {
         return;
     }
 
-    frontend.SelectProfile([this](std::optional<Common::UUID> uuid) { SelectionComplete(uuid); });
+    frontend.SelectProfile(MakeFrontendCallback(
+        [this](std::optional<Common::UUID> uuid) { SelectionComplete(uuid); }));
 }
 
 void ProfileSelect::SelectionComplete(std::optional<Common::UUID> uuid) {
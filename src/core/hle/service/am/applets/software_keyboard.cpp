@@ -96,7 +96,7 @@ void SoftwareKeyboard::ExecuteInteractive() {
         std::memcpy(string.data(), data.data() + 4, string.size() * 2);
         frontend.SendTextCheckDialog(
             Common::UTF16StringFromFixedZeroTerminatedBuffer(string.data(), string.size()),
-            [this] { broker.SignalStateChanged(); });
+            MakeFrontendCallback([this] { broker.SignalStateChanged(); }));
     }
 }
 
@@ -108,7 +108,8 @@ void SoftwareKeyboard::Execute() {
 
     const auto parameters = ConvertToFrontendParameters(config, initial_text);
 
-    frontend.RequestText([this](std::optional<std::u16string> text) { WriteText(text); },
+    frontend.RequestText(MakeFrontendCallback(
+                             [this](std::optional<std::u16string> text) { WriteText(text); }),
                          parameters);
 }
 
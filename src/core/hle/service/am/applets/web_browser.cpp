@@ -491,7 +491,7 @@ void WebBrowser::InitializeOffline() {
 }
 
 void WebBrowser::ExecuteShop() {
-    const auto callback = [this]() { Finalize(); };
+    const auto callback = MakeFrontendCallback([this] { Finalize(); });
 
     const auto check_optional_parameter = [this](const auto& p) {
         if (!p.has_value()) {
@@ -545,7 +545,8 @@ void WebBrowser::ExecuteShop() {
 }
 
 void WebBrowser::ExecuteOffline() {
-    frontend.OpenPageLocal(filename, [this] { UnpackRomFS(); }, [this] { Finalize(); });
+    frontend.OpenPageLocal(filename, MakeFrontendCallback([this] { UnpackRomFS(); }),
+                           MakeFrontendCallback([this] { Finalize(); }));
 }
 
 } // namespace Service::AM::Applets
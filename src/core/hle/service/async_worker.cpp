@@ -0,0 +1,167 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+
+#include "common/thread.h"
+#include "core/hle/kernel/writable_event.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/service/async_worker.h"
+
+namespace Service {
+
+AsyncWorker::AsyncWorker(Kernel::KernelCore& kernel, std::string name_)
+    : name{std::move(name_)}, kernel{kernel} {
+    thread = std::thread([this] { Loop(); });
+}
+
+AsyncWorker::~AsyncWorker() {
+    {
+        std::lock_guard lock{queue_mutex};
+        is_stopping = true;
+    }
+    queue_cv.notify_one();
+    thread.join();
+
+    // Work left in the queue is dropped, its client threads are only woken up by emulation ending
+    std::lock_guard lock{kernel.HLELock()};
+    jobs = {};
+}
+
+void AsyncWorker::Run(Kernel::HLERequestContext& ctx, Work work,
+                      Kernel::HLERequestContext::WakeupCallback&& callback) {
+    auto event = ctx.SleepClientThread(name, 0, std::move(callback));
+    {
+        std::lock_guard lock{queue_mutex};
+        jobs.push({std::move(work), std::move(event)});
+    }
+    queue_cv.notify_one();
+}
+
+void AsyncWorker::RunInline(const Work& work) {
+    std::lock_guard lock{work_mutex};
+    work();
+}
+
+void AsyncWorker::Loop() {
+    Common::SetCurrentThreadName(name.c_str());
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock{queue_mutex};
+            queue_cv.wait(lock, [this] { return is_stopping || !jobs.empty(); });
+            if (is_stopping) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop();
+        }
+        {
+            std::lock_guard lock{work_mutex};
+            job.work();
+        }
+
+        // Waking up the client thread changes the kernel state, take the lock of the CPU threads
+        std::lock_guard lock{kernel.HLELock()};
+        job.event->Signal();
+        job = {};
+    }
+}
+
+class AsyncWorkerPool::Queue {
+public:
+    std::queue<Job> jobs;
+    /// True while the queue is ready or its work is running, it's scheduled at most once
+    bool is_scheduled = false;
+};
+
+AsyncWorkerPool::AsyncWorkerPool(Kernel::KernelCore& kernel, std::string name_,
+                                 std::size_t num_threads)
+    : name{std::move(name_)}, kernel{kernel} {
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([this] { Loop(); });
+    }
+}
+
+AsyncWorkerPool::~AsyncWorkerPool() {
+    {
+        std::lock_guard lock{mutex};
+        is_stopping = true;
+    }
+    cv.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Work left in the queues is dropped, its client threads are only woken up by emulation ending
+    std::lock_guard lock{kernel.HLELock()};
+    for (const auto& queue : ready_queues) {
+        queue->jobs = {};
+    }
+    ready_queues.clear();
+}
+
+std::shared_ptr<AsyncWorkerPool::Queue> AsyncWorkerPool::CreateQueue() {
+    return std::make_shared<Queue>();
+}
+
+void AsyncWorkerPool::Run(Kernel::HLERequestContext& ctx, const std::shared_ptr<Queue>& queue,
+                          Work work, Kernel::HLERequestContext::WakeupCallback&& callback) {
+    auto event = ctx.SleepClientThread(name, 0, std::move(callback));
+    Push(queue, {std::move(work), std::move(event)});
+}
+
+void AsyncWorkerPool::Submit(const std::shared_ptr<Queue>& queue, Work work) {
+    Push(queue, {std::move(work), nullptr});
+}
+
+void AsyncWorkerPool::Push(const std::shared_ptr<Queue>& queue, Job job) {
+    {
+        std::lock_guard lock{mutex};
+        queue->jobs.push(std::move(job));
+        if (queue->is_scheduled) {
+            // The thread running the queue picks the job up when it's done
+            return;
+        }
+        queue->is_scheduled = true;
+        ready_queues.push_back(queue);
+    }
+    cv.notify_one();
+}
+
+void AsyncWorkerPool::Loop() {
+    Common::SetCurrentThreadName(name.c_str());
+    std::unique_lock lock{mutex};
+    while (true) {
+        cv.wait(lock, [this] { return is_stopping || !ready_queues.empty(); });
+        if (is_stopping) {
+            return;
+        }
+        const std::shared_ptr<Queue> queue = std::move(ready_queues.front());
+        ready_queues.pop_front();
+        Job job = std::move(queue->jobs.front());
+        queue->jobs.pop();
+        lock.unlock();
+
+        job.work();
+        // Releases what the work holds on to before taking the lock, e.g. files
+        job.work = nullptr;
+        if (job.event) {
+            std::lock_guard hle_lock{kernel.HLELock()};
+            job.event->Signal();
+            job.event = nullptr;
+        }
+
+        lock.lock();
+        if (queue->jobs.empty()) {
+            queue->is_scheduled = false;
+        } else {
+            // Back of the line, other queues get a turn before the next job of this one
+            ready_queues.push_back(queue);
+            cv.notify_one();
+        }
+    }
+}
+
+} // namespace Service
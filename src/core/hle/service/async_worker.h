@@ -0,0 +1,120 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/hle/kernel/hle_ipc.h"
+
+namespace Kernel {
+class KernelCore;
+}
+
+namespace Service {
+
+/**
+ * Host thread running the blocking part of service requests, e.g. large file reads, while the
+ * guest thread that made the request sleeps. Other guest threads keep running on its core in the
+ * meantime. Work is run in the order it's submitted, one at a time.
+ */
+class AsyncWorker {
+public:
+    using Work = std::function<void()>;
+
+    explicit AsyncWorker(Kernel::KernelCore& kernel, std::string name);
+    ~AsyncWorker();
+
+    /**
+     * Puts the client thread of a request to sleep and runs work on the worker thread. Once it's
+     * done the client thread is woken up and callback writes the response, like with
+     * HLERequestContext::SleepClientThread. The context is destroyed when the handler returns, so
+     * work can't use it nor the buffer spans obtained from it.
+     */
+    void Run(Kernel::HLERequestContext& ctx, Work work,
+             Kernel::HLERequestContext::WakeupCallback&& callback);
+
+    /// Runs work on the calling thread, serialized with the work submitted through Run.
+    void RunInline(const Work& work);
+
+private:
+    struct Job {
+        Work work;
+        Kernel::SharedPtr<Kernel::WritableEvent> event;
+    };
+
+    void Loop();
+
+    std::string name;
+    Kernel::KernelCore& kernel;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::queue<Job> jobs;
+    bool is_stopping = false;
+
+    /// Held while work runs, on the worker thread or inline.
+    std::mutex work_mutex;
+
+    std::thread thread;
+};
+
+/**
+ * Pool of host threads running the blocking part of service requests, like AsyncWorker. Work is
+ * submitted to a queue, the work of a queue runs in order and one at a time while the work of
+ * different queues runs in parallel on the threads of the pool.
+ */
+class AsyncWorkerPool {
+public:
+    using Work = AsyncWorker::Work;
+
+    class Queue;
+
+    explicit AsyncWorkerPool(Kernel::KernelCore& kernel, std::string name,
+                             std::size_t num_threads);
+    ~AsyncWorkerPool();
+
+    /// Creates a queue of work ordered with respect to itself.
+    std::shared_ptr<Queue> CreateQueue();
+
+    /// Runs work on a thread of the pool after the work previously submitted to the queue, with
+    /// the same semantics as AsyncWorker::Run.
+    void Run(Kernel::HLERequestContext& ctx, const std::shared_ptr<Queue>& queue, Work work,
+             Kernel::HLERequestContext::WakeupCallback&& callback);
+
+    /// Runs work on a thread of the pool after the work previously submitted to the queue,
+    /// without a client thread waiting for it. Used for background work like readahead.
+    void Submit(const std::shared_ptr<Queue>& queue, Work work);
+
+private:
+    struct Job {
+        Work work;
+        /// Signaled when the work is done, null for background work
+        Kernel::SharedPtr<Kernel::WritableEvent> event;
+    };
+
+    void Push(const std::shared_ptr<Queue>& queue, Job job);
+    void Loop();
+
+    std::string name;
+    Kernel::KernelCore& kernel;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    /// Queues with pending work that no thread is running yet
+    std::deque<std::shared_ptr<Queue>> ready_queues;
+    bool is_stopping = false;
+
+    std::vector<std::thread> threads;
+};
+
+} // namespace Service
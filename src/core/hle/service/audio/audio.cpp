@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "core/core.h"
 #include "core/hle/service/audio/audctl.h"
 #include "core/hle/service/audio/auddbg.h"
 #include "core/hle/service/audio/audin_a.h"
@@ -30,7 +31,7 @@ void InstallInterfaces(SM::ServiceManager& service_manager, Core::System& system
     std::make_shared<AudRenA>()->InstallAsService(service_manager);
     std::make_shared<AudRenU>(system)->InstallAsService(service_manager);
     std::make_shared<CodecCtl>()->InstallAsService(service_manager);
-    std::make_shared<HwOpus>()->InstallAsService(service_manager);
+    std::make_shared<HwOpus>(system.Kernel())->InstallAsService(service_manager);
 
     std::make_shared<AudDbg>("audin:d")->InstallAsService(service_manager);
     std::make_shared<AudDbg>("audout:d")->InstallAsService(service_manager);
@@ -2,9 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include <opus.h>
@@ -14,6 +16,8 @@
 #include "common/logging/log.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/thread.h"
+#include "core/hle/service/async_worker.h"
 #include "core/hle/service/audio/hwopus.h"
 
 namespace Service::Audio {
@@ -50,33 +54,33 @@ public:
         Enabled,
     };
 
-    explicit OpusDecoderState(OpusDecoderPtr decoder, u32 sample_rate, u32 channel_count)
-        : decoder{std::move(decoder)}, sample_rate{sample_rate}, channel_count{channel_count} {}
-
-    // Decodes interleaved Opus packets. Optionally allows reporting time taken to
-    // perform the decoding, as well as any relevant extra behavior.
-    void DecodeInterleaved(Kernel::HLERequestContext& ctx, PerfTime perf_time,
-                           ExtraBehavior extra_behavior) {
-        if (perf_time == PerfTime::Disabled) {
-            DecodeInterleavedHelper(ctx, nullptr, extra_behavior);
-        } else {
-            u64 performance = 0;
-            DecodeInterleavedHelper(ctx, &performance, extra_behavior);
-        }
-    }
-
-private:
-    void DecodeInterleavedHelper(Kernel::HLERequestContext& ctx, u64* performance,
-                                 ExtraBehavior extra_behavior) {
+    /// Inputs and results of a decode, owned by the request while it runs on the decode pool.
+    struct DecodeRequest {
+        std::vector<u8> input;
+        std::vector<opus_int16> samples;
         u32 consumed = 0;
         u32 sample_count = 0;
-        std::vector<opus_int16> samples(ctx.GetWriteBufferSize() / sizeof(opus_int16));
+        u64 performance = 0;
+        bool succeeded = false;
+    };
 
+    explicit OpusDecoderState(OpusDecoderPtr decoder, u32 sample_rate, u32 channel_count)
+        : decoder{std::move(decoder)}, sample_rate{sample_rate}, channel_count{channel_count} {}
+
+    /// Decodes interleaved Opus packets into the samples of a request. Runs on the decode pool,
+    /// the requests of a decoder are serialized by its queue.
+    void Decode(DecodeRequest& request, ExtraBehavior extra_behavior) {
         if (extra_behavior == ExtraBehavior::ResetContext) {
             ResetDecoderContext();
         }
+        request.succeeded = DecodeOpusData(request.consumed, request.sample_count, request.input,
+                                           request.samples, &request.performance);
+    }
 
-        if (!DecodeOpusData(consumed, sample_count, ctx.ReadBuffer(), samples, performance)) {
+    /// Writes the response of a finished decode. Optionally reports the time taken to decode.
+    static void WriteResponse(Kernel::HLERequestContext& ctx, const DecodeRequest& request,
+                              PerfTime perf_time) {
+        if (!request.succeeded) {
             LOG_ERROR(Audio, "Failed to decode opus data");
             IPC::ResponseBuilder rb{ctx, 2};
             // TODO(ogniK): Use correct error code
@@ -84,17 +88,18 @@ private:
             return;
         }
 
-        const u32 param_size = performance != nullptr ? 6 : 4;
+        const u32 param_size = perf_time == PerfTime::Enabled ? 6 : 4;
         IPC::ResponseBuilder rb{ctx, param_size};
         rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(consumed);
-        rb.Push<u32>(sample_count);
-        if (performance) {
-            rb.Push<u64>(*performance);
+        rb.Push<u32>(request.consumed);
+        rb.Push<u32>(request.sample_count);
+        if (perf_time == PerfTime::Enabled) {
+            rb.Push<u64>(request.performance);
         }
-        ctx.WriteBuffer(samples.data(), samples.size() * sizeof(s16));
+        ctx.WriteBuffer(request.samples.data(), request.samples.size() * sizeof(s16));
     }
 
+private:
     bool DecodeOpusData(u32& consumed, u32& sample_count, const std::vector<u8>& input,
                         std::vector<opus_int16>& output, u64* out_performance_time) const {
         const auto start_time = std::chrono::high_resolution_clock::now();
@@ -160,8 +165,10 @@ private:
 
 class IHardwareOpusDecoderManager final : public ServiceFramework<IHardwareOpusDecoderManager> {
 public:
-    explicit IHardwareOpusDecoderManager(OpusDecoderState decoder_state)
-        : ServiceFramework("IHardwareOpusDecoderManager"), decoder_state{std::move(decoder_state)} {
+    explicit IHardwareOpusDecoderManager(std::shared_ptr<OpusDecoderState> decoder_state,
+                                         std::shared_ptr<AsyncWorkerPool> decode_pool)
+        : ServiceFramework("IHardwareOpusDecoderManager"), decoder_state{std::move(decoder_state)},
+          decode_pool{std::move(decode_pool)}, decode_queue{this->decode_pool->CreateQueue()} {
         // clang-format off
         static const FunctionInfo functions[] = {
             {0, &IHardwareOpusDecoderManager::DecodeInterleavedOld, "DecodeInterleavedOld"},
@@ -182,15 +189,15 @@ private:
     void DecodeInterleavedOld(Kernel::HLERequestContext& ctx) {
         LOG_DEBUG(Audio, "called");
 
-        decoder_state.DecodeInterleaved(ctx, OpusDecoderState::PerfTime::Disabled,
-                                        OpusDecoderState::ExtraBehavior::None);
+        DecodeInterleavedAsync(ctx, OpusDecoderState::PerfTime::Disabled,
+                               OpusDecoderState::ExtraBehavior::None);
     }
 
     void DecodeInterleavedWithPerfOld(Kernel::HLERequestContext& ctx) {
         LOG_DEBUG(Audio, "called");
 
-        decoder_state.DecodeInterleaved(ctx, OpusDecoderState::PerfTime::Enabled,
-                                        OpusDecoderState::ExtraBehavior::None);
+        DecodeInterleavedAsync(ctx, OpusDecoderState::PerfTime::Enabled,
+                               OpusDecoderState::ExtraBehavior::None);
     }
 
     void DecodeInterleaved(Kernel::HLERequestContext& ctx) {
@@ -200,12 +207,40 @@ private:
         const auto extra_behavior = rp.Pop<bool>() ? OpusDecoderState::ExtraBehavior::ResetContext
                                                    : OpusDecoderState::ExtraBehavior::None;
 
-        decoder_state.DecodeInterleaved(ctx, OpusDecoderState::PerfTime::Enabled, extra_behavior);
+        DecodeInterleavedAsync(ctx, OpusDecoderState::PerfTime::Enabled, extra_behavior);
     }
 
-    OpusDecoderState decoder_state;
+    /// Decodes on the decode pool while the client thread sleeps, other guest threads keep the
+    /// core. Decodes of other decoders run in parallel.
+    void DecodeInterleavedAsync(Kernel::HLERequestContext& ctx,
+                                OpusDecoderState::PerfTime perf_time,
+                                OpusDecoderState::ExtraBehavior extra_behavior) {
+        auto request = std::make_shared<OpusDecoderState::DecodeRequest>();
+        request->input = ctx.ReadBuffer();
+        request->samples.resize(ctx.GetWriteBufferSize() / sizeof(opus_int16));
+
+        decode_pool->Run(
+            ctx, decode_queue,
+            [state = decoder_state, request, extra_behavior] {
+                state->Decode(*request, extra_behavior);
+            },
+            [request, perf_time](Kernel::SharedPtr<Kernel::Thread> thread,
+                                 Kernel::HLERequestContext& ctx,
+                                 Kernel::ThreadWakeupReason reason) {
+                OpusDecoderState::WriteResponse(ctx, *request, perf_time);
+            });
+    }
+
+    std::shared_ptr<OpusDecoderState> decoder_state;
+    std::shared_ptr<AsyncWorkerPool> decode_pool;
+    std::shared_ptr<AsyncWorkerPool::Queue> decode_queue;
 };
 
+/// Number of threads decoding for all the decoders, a few streams play at once at most.
+std::size_t NumDecodeThreads() {
+    return std::clamp<std::size_t>(std::thread::hardware_concurrency() / 2, 1, 4);
+}
+
 std::size_t WorkerBufferSize(u32 channel_count) {
     ASSERT_MSG(channel_count == 1 || channel_count == 2, "Invalid channel count");
     constexpr int num_streams = 1;
@@ -285,10 +320,13 @@ void HwOpus::OpenOpusDecoder(Kernel::HLERequestContext& ctx) {
     IPC::ResponseBuilder rb{ctx, 2, 0, 1};
     rb.Push(RESULT_SUCCESS);
     rb.PushIpcInterface<IHardwareOpusDecoderManager>(
-        OpusDecoderState{std::move(decoder), sample_rate, channel_count});
+        std::make_shared<OpusDecoderState>(std::move(decoder), sample_rate, channel_count),
+        decode_pool);
 }
 
-HwOpus::HwOpus() : ServiceFramework("hwopus") {
+HwOpus::HwOpus(Kernel::KernelCore& kernel)
+    : ServiceFramework("hwopus"), decode_pool{std::make_shared<AsyncWorkerPool>(
+                                      kernel, "hwopus:Decode", NumDecodeThreads())} {
     static const FunctionInfo functions[] = {
         {0, &HwOpus::OpenOpusDecoder, "OpenOpusDecoder"},
         {1, &HwOpus::GetWorkBufferSize, "GetWorkBufferSize"},
@@ -4,18 +4,29 @@
 
 #pragma once
 
+#include <memory>
 #include "core/hle/service/service.h"
 
+namespace Kernel {
+class KernelCore;
+}
+
+namespace Service {
+class AsyncWorkerPool;
+}
+
 namespace Service::Audio {
 
 class HwOpus final : public ServiceFramework<HwOpus> {
 public:
-    explicit HwOpus();
+    explicit HwOpus(Kernel::KernelCore& kernel);
     ~HwOpus() override;
 
 private:
     void OpenOpusDecoder(Kernel::HLERequestContext& ctx);
     void GetWorkBufferSize(Kernel::HLERequestContext& ctx);
+
+    std::shared_ptr<AsyncWorkerPool> decode_pool;
 };
 
 } // namespace Service::Audio
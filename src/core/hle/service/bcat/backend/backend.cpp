@@ -5,13 +5,14 @@
 #include "common/hex_util.h"
 #include "common/logging/log.h"
 #include "core/core.h"
-#include "core/hle/lock.h"
+#include "core/hle/kernel/kernel.h"
 #include "core/hle/service/bcat/backend/backend.h"
 
 namespace Service::BCAT {
 
 ProgressServiceBackend::ProgressServiceBackend(Kernel::KernelCore& kernel,
-                                               std::string_view event_name) {
+                                               std::string_view event_name)
+    : kernel{kernel} {
     event = Kernel::WritableEvent::CreateEventPair(
         kernel, std::string("ProgressServiceBackend:UpdateEvent:").append(event_name));
 }
@@ -84,7 +85,7 @@ void ProgressServiceBackend::FinishDownload(ResultCode result) {
 
 void ProgressServiceBackend::SignalUpdate() const {
     if (need_hle_lock) {
-        std::lock_guard<std::recursive_mutex> lock(HLE::g_hle_lock);
+        std::lock_guard lock{kernel.HLELock()};
         event.writable->Signal();
     } else {
         event.writable->Signal();
@@ -106,6 +106,7 @@ private:
     DeliveryCacheProgressImpl impl{};
     Kernel::EventPair event;
     bool need_hle_lock = false;
+    Kernel::KernelCore& kernel;
 };
 
 // A class representing an abstract backend for BCAT functionality.
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
 #include <iterator>
@@ -23,8 +24,11 @@
 #include "core/file_sys/savedata_factory.h"
 #include "core/file_sys/system_archive/system_archive.h"
 #include "core/file_sys/vfs.h"
+#include "core/file_sys/vfs_write_back.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/process.h"
+#include "core/hle/kernel/thread.h"
+#include "core/hle/service/async_worker.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/hle/service/filesystem/fsp_srv.h"
 #include "core/reporter.h"
@@ -43,6 +47,71 @@ struct SizeGetter {
     }
 };
 
+/// Size in bytes from which IStorage reads are done on the worker thread.
+constexpr std::size_t ASYNC_READ_THRESHOLD = 0x100000;
+
+/// Number of reads in a row continuing where the previous one ended before a file is read ahead.
+constexpr std::size_t READAHEAD_MIN_SEQUENTIAL_READS = 2;
+/// Minimum amount of data kept loaded ahead of a sequential reader.
+constexpr std::size_t READAHEAD_SIZE = 0x40000;
+/// Threads of the readahead pool, the files of different requests are read ahead in parallel.
+constexpr std::size_t NUM_READAHEAD_THREADS = 2;
+
+/**
+ * Detects sequential reads of an opened file and prefetches the data following them on the
+ * readahead pool. Streaming reads then find that data already decrypted in the block cache of the
+ * file, the reads of the wrapped file having overlapped with the guest.
+ */
+class Readahead {
+public:
+    explicit Readahead(FileSys::VirtualFile file_, std::shared_ptr<AsyncWorkerPool> pool_)
+        : file(std::move(file_)), pool(std::move(pool_)) {
+        // Written files don't keep their contents in memory nor would they keep them valid
+        if (pool && file->IsReadable() && !file->IsWritable()) {
+            queue = pool->CreateQueue();
+        }
+    }
+
+    /// Called after each read of the file, on the thread handling the requests.
+    void OnRead(u64 offset, std::size_t length) {
+        if (queue == nullptr || length == 0) {
+            return;
+        }
+        if (offset == next_offset) {
+            ++sequential_reads;
+        } else {
+            sequential_reads = 0;
+            prefetched_end = 0;
+        }
+        next_offset = offset + length;
+        if (sequential_reads < READAHEAD_MIN_SEQUENTIAL_READS) {
+            return;
+        }
+
+        // The window grows with the size of the reads, it's topped up once half of it is consumed
+        const u64 window_size = std::max<u64>(READAHEAD_SIZE, length);
+        const u64 window_end = next_offset + window_size;
+        const u64 start = std::max(next_offset, prefetched_end);
+        if (start >= window_end || window_end - start < window_size / 2) {
+            return;
+        }
+        prefetched_end = window_end;
+        pool->Submit(queue, [file = file, start, size = window_end - start] {
+            file->Prefetch(static_cast<std::size_t>(start), static_cast<std::size_t>(size));
+        });
+    }
+
+private:
+    FileSys::VirtualFile file;
+    std::shared_ptr<AsyncWorkerPool> pool;
+    /// Null when the file isn't read ahead
+    std::shared_ptr<AsyncWorkerPool::Queue> queue;
+
+    u64 next_offset = 0;
+    std::size_t sequential_reads = 0;
+    u64 prefetched_end = 0;
+};
+
 enum class FileSystemType : u8 {
     Invalid0 = 0,
     Invalid1 = 1,
@@ -56,8 +125,10 @@ enum class FileSystemType : u8 {
 
 class IStorage final : public ServiceFramework<IStorage> {
 public:
-    explicit IStorage(FileSys::VirtualFile backend_)
-        : ServiceFramework("IStorage"), backend(std::move(backend_)) {
+    explicit IStorage(FileSys::VirtualFile backend_, std::shared_ptr<AsyncWorker> worker_,
+                      std::shared_ptr<AsyncWorkerPool> readahead_pool)
+        : ServiceFramework("IStorage"), backend(std::move(backend_)), worker(std::move(worker_)),
+          readahead(backend, std::move(readahead_pool)) {
         static const FunctionInfo functions[] = {
             {0, &IStorage::Read, "Read"},
             {1, nullptr, "Write"},
@@ -71,6 +142,8 @@ public:
 
 private:
     FileSys::VirtualFile backend;
+    std::shared_ptr<AsyncWorker> worker;
+    Readahead readahead;
 
     void Read(Kernel::HLERequestContext& ctx) {
         IPC::RequestParser rp{ctx};
@@ -93,10 +166,33 @@ private:
             return;
         }
 
-        // Read the data from the Storage backend
-        std::vector<u8> output = backend->ReadBytes(length, offset);
+        const std::size_t size =
+            std::min(static_cast<std::size_t>(length), ctx.GetWriteBufferSize());
+        readahead.OnRead(static_cast<u64>(offset), size);
+        if (size >= ASYNC_READ_THRESHOLD) {
+            // Large romfs reads can take a while to decrypt, don't block the core meanwhile
+            auto output = std::make_shared<std::vector<u8>>(size);
+            worker->Run(
+                ctx,
+                [backend = backend, output, offset] {
+                    output->resize(backend->Read(output->data(), output->size(), offset));
+                },
+                [output](Kernel::SharedPtr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                         Kernel::ThreadWakeupReason reason) {
+                    ctx.WriteBuffer(*output);
+
+                    IPC::ResponseBuilder rb{ctx, 2};
+                    rb.Push(RESULT_SUCCESS);
+                });
+            return;
+        }
+
+        // Read the data from the Storage backend straight into the output buffer
+        const auto output = ctx.WriteBufferSpan();
+        std::size_t read = 0;
+        worker->RunInline([&] { read = backend->Read(output.data(), size, offset); });
         // Write the data to memory
-        ctx.WriteBuffer(output);
+        ctx.WriteBuffer(output.data(), read);
 
         IPC::ResponseBuilder rb{ctx, 2};
         rb.Push(RESULT_SUCCESS);
@@ -114,8 +210,9 @@ private:
 
 class IFile final : public ServiceFramework<IFile> {
 public:
-    explicit IFile(FileSys::VirtualFile backend_)
-        : ServiceFramework("IFile"), backend(std::move(backend_)) {
+    explicit IFile(FileSys::VirtualFile backend_, std::shared_ptr<AsyncWorkerPool> readahead_pool)
+        : ServiceFramework("IFile"), backend(std::move(backend_)),
+          readahead(backend, std::move(readahead_pool)) {
         static const FunctionInfo functions[] = {
             {0, &IFile::Read, "Read"},       {1, &IFile::Write, "Write"},
             {2, &IFile::Flush, "Flush"},     {3, &IFile::SetSize, "SetSize"},
@@ -126,6 +223,7 @@ public:
 
 private:
     FileSys::VirtualFile backend;
+    Readahead readahead;
 
     void Read(Kernel::HLERequestContext& ctx) {
         IPC::RequestParser rp{ctx};
@@ -150,15 +248,18 @@ private:
             return;
         }
 
-        // Read the data from the Storage backend
-        std::vector<u8> output = backend->ReadBytes(length, offset);
+        // Read the data from the Storage backend straight into the output buffer
+        const auto output = ctx.WriteBufferSpan();
+        const std::size_t read = backend->Read(
+            output.data(), std::min(static_cast<std::size_t>(length), output.size()), offset);
+        readahead.OnRead(static_cast<u64>(offset), read);
 
         // Write the data to memory
-        ctx.WriteBuffer(output);
+        ctx.WriteBuffer(output.data(), read);
 
         IPC::ResponseBuilder rb{ctx, 4};
         rb.Push(RESULT_SUCCESS);
-        rb.Push(static_cast<u64>(output.size()));
+        rb.Push(static_cast<u64>(read));
     }
 
     void Write(Kernel::HLERequestContext& ctx) {
@@ -184,7 +285,7 @@ private:
             return;
         }
 
-        const std::vector<u8> data = ctx.ReadBuffer();
+        const auto data = ctx.ReadBufferSpan();
 
         ASSERT_MSG(
             static_cast<s64>(data.size()) <= length,
@@ -234,13 +335,14 @@ private:
     }
 };
 
-template <typename T>
-static void BuildEntryIndex(std::vector<FileSys::Entry>& entries, const std::vector<T>& new_data,
-                            FileSys::EntryType type) {
-    entries.reserve(entries.size() + new_data.size());
+static void BuildEntryIndex(std::vector<FileSys::Entry>& entries,
+                            const FileSys::VfsDirectoryListing& listing) {
+    entries.reserve(listing->size());
 
-    for (const auto& new_entry : new_data) {
-        entries.emplace_back(new_entry->GetName(), type, new_entry->GetSize());
+    for (const auto& entry : *listing) {
+        const auto type = entry.type == FileSys::VfsEntryType::Directory ? FileSys::Directory
+                                                                          : FileSys::File;
+        entries.emplace_back(entry.name, type, entry.size);
     }
 }
 
@@ -256,8 +358,9 @@ public:
 
         // TODO(DarkLordZach): Verify that this is the correct behavior.
         // Build entry index now to save time later.
-        BuildEntryIndex(entries, backend->GetFiles(), FileSys::File);
-        BuildEntryIndex(entries, backend->GetSubdirectories(), FileSys::Directory);
+        // The listing names the entries without opening them, and is kept by the VFS for the next
+        // directory opened at the same path.
+        BuildEntryIndex(entries, backend->GetListing());
     }
 
 private:
@@ -302,8 +405,12 @@ private:
 
 class IFileSystem final : public ServiceFramework<IFileSystem> {
 public:
-    explicit IFileSystem(FileSys::VirtualDir backend, SizeGetter size)
-        : ServiceFramework("IFileSystem"), backend(std::move(backend)), size(std::move(size)) {
+    explicit IFileSystem(FileSys::VirtualDir backend, SizeGetter size,
+                         std::shared_ptr<AsyncWorkerPool> readahead_pool,
+                         std::shared_ptr<FileSys::WriteBackCache> write_back_cache = nullptr)
+        : ServiceFramework("IFileSystem"), backend(std::move(backend)), size(std::move(size)),
+          readahead_pool(std::move(readahead_pool)),
+          write_back_cache(std::move(write_back_cache)) {
         static const FunctionInfo functions[] = {
             {0, &IFileSystem::CreateFile, "CreateFile"},
             {1, &IFileSystem::DeleteFile, "DeleteFile"},
@@ -346,6 +453,8 @@ public:
 
         LOG_DEBUG(Service_FS, "called. file={}", name);
 
+        CommitPendingWrites();
+
         IPC::ResponseBuilder rb{ctx, 2};
         rb.Push(backend.DeleteFile(name));
     }
@@ -366,6 +475,8 @@ public:
 
         LOG_DEBUG(Service_FS, "called. directory={}", name);
 
+        CommitPendingWrites();
+
         IPC::ResponseBuilder rb{ctx, 2};
         rb.Push(backend.DeleteDirectory(name));
     }
@@ -376,6 +487,8 @@ public:
 
         LOG_DEBUG(Service_FS, "called. directory={}", name);
 
+        CommitPendingWrites();
+
         IPC::ResponseBuilder rb{ctx, 2};
         rb.Push(backend.DeleteDirectoryRecursively(name));
     }
@@ -386,6 +499,8 @@ public:
 
         LOG_DEBUG(Service_FS, "called. Directory: {}", name);
 
+        CommitPendingWrites();
+
         IPC::ResponseBuilder rb{ctx, 2};
         rb.Push(backend.CleanDirectoryRecursively(name));
     }
@@ -402,6 +517,8 @@ public:
 
         LOG_DEBUG(Service_FS, "called. file '{}' to file '{}'", src_name, dst_name);
 
+        CommitPendingWrites();
+
         IPC::ResponseBuilder rb{ctx, 2};
         rb.Push(backend.RenameFile(src_name, dst_name));
     }
@@ -423,11 +540,16 @@ public:
             return;
         }
 
-        IFile file(result.Unwrap());
+        auto file = result.Unwrap();
+        if (write_back_cache != nullptr) {
+            file = write_back_cache->Wrap(std::move(file));
+        }
+
+        IFile ifile(std::move(file), readahead_pool);
 
         IPC::ResponseBuilder rb{ctx, 2, 0, 1};
         rb.Push(RESULT_SUCCESS);
-        rb.PushIpcInterface<IFile>(std::move(file));
+        rb.PushIpcInterface<IFile>(std::move(ifile));
     }
 
     void OpenDirectory(Kernel::HLERequestContext& ctx) {
@@ -441,6 +563,9 @@ public:
 
         LOG_DEBUG(Service_FS, "called. directory={}, filter={}", name, filter_flags);
 
+        // The entries report the sizes of the files on the host
+        CommitPendingWrites();
+
         auto result = backend.OpenDirectory(name);
         if (result.Failed()) {
             IPC::ResponseBuilder rb{ctx, 2};
@@ -474,10 +599,10 @@ public:
     }
 
     void Commit(Kernel::HLERequestContext& ctx) {
-        LOG_WARNING(Service_FS, "(STUBBED) called");
+        LOG_DEBUG(Service_FS, "called");
 
         IPC::ResponseBuilder rb{ctx, 2};
-        rb.Push(RESULT_SUCCESS);
+        rb.Push(CommitPendingWrites() ? RESULT_SUCCESS : ResultCode(-1));
     }
 
     void GetFreeSpaceSize(Kernel::HLERequestContext& ctx) {
@@ -497,8 +622,16 @@ public:
     }
 
 private:
+    /// Writes out what the write back cache holds, if this filesystem has one.
+    bool CommitPendingWrites() {
+        return write_back_cache == nullptr || write_back_cache->Commit();
+    }
+
     VfsDirectoryServiceWrapper backend;
     SizeGetter size;
+    std::shared_ptr<AsyncWorkerPool> readahead_pool;
+    /// Only set for save data, which games commit explicitly
+    std::shared_ptr<FileSys::WriteBackCache> write_back_cache;
 };
 
 class ISaveDataInfoReader final : public ServiceFramework<ISaveDataInfoReader> {
@@ -650,8 +783,13 @@ private:
     u64 next_entry_index = 0;
 };
 
-FSP_SRV::FSP_SRV(FileSystemController& fsc, const Core::Reporter& reporter)
-    : ServiceFramework("fsp-srv"), fsc(fsc), reporter(reporter) {
+FSP_SRV::FSP_SRV(Kernel::KernelCore& kernel, FileSystemController& fsc,
+                 const Core::Reporter& reporter)
+    : ServiceFramework("fsp-srv"), fsc(fsc),
+      storage_worker(std::make_shared<AsyncWorker>(kernel, "fsp-srv:IStorage")),
+      readahead_pool(
+          std::make_shared<AsyncWorkerPool>(kernel, "fsp-srv:Readahead", NUM_READAHEAD_THREADS)),
+      reporter(reporter) {
     // clang-format off
     static const FunctionInfo functions[] = {
         {0, nullptr, "OpenFileSystem"},
@@ -792,7 +930,8 @@ void FSP_SRV::OpenSdCardFileSystem(Kernel::HLERequestContext& ctx) {
     LOG_DEBUG(Service_FS, "called");
 
     IFileSystem filesystem(fsc.OpenSDMC().Unwrap(),
-                           SizeGetter::FromStorageId(fsc, FileSys::StorageId::SdCard));
+                           SizeGetter::FromStorageId(fsc, FileSys::StorageId::SdCard),
+                           readahead_pool);
 
     IPC::ResponseBuilder rb{ctx, 2, 0, 1};
     rb.Push(RESULT_SUCCESS);
@@ -843,7 +982,16 @@ void FSP_SRV::OpenSaveDataFileSystem(Kernel::HLERequestContext& ctx) {
         id = FileSys::StorageId::NandSystem;
     }
 
-    IFileSystem filesystem(std::move(dir.Unwrap()), SizeGetter::FromStorageId(fsc, id));
+    // Filesystems opened on the same save data share the pending writes
+    auto& weak_cache = save_data_caches[dir.Unwrap()->GetFullPath()];
+    auto write_back_cache = weak_cache.lock();
+    if (write_back_cache == nullptr) {
+        write_back_cache = std::make_shared<FileSys::WriteBackCache>();
+        weak_cache = write_back_cache;
+    }
+
+    IFileSystem filesystem(std::move(dir.Unwrap()), SizeGetter::FromStorageId(fsc, id),
+                           readahead_pool, std::move(write_back_cache));
 
     IPC::ResponseBuilder rb{ctx, 2, 0, 1};
     rb.Push(RESULT_SUCCESS);
@@ -895,7 +1043,7 @@ void FSP_SRV::OpenDataStorageByCurrentProcess(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    IStorage storage(std::move(romfs.Unwrap()));
+    IStorage storage(std::move(romfs.Unwrap()), storage_worker, readahead_pool);
 
     IPC::ResponseBuilder rb{ctx, 2, 0, 1};
     rb.Push(RESULT_SUCCESS);
@@ -919,7 +1067,8 @@ void FSP_SRV::OpenDataStorageByDataId(Kernel::HLERequestContext& ctx) {
         if (archive != nullptr) {
             IPC::ResponseBuilder rb{ctx, 2, 0, 1};
             rb.Push(RESULT_SUCCESS);
-            rb.PushIpcInterface(std::make_shared<IStorage>(archive));
+            rb.PushIpcInterface(
+                std::make_shared<IStorage>(archive, storage_worker, readahead_pool));
             return;
         }
 
@@ -934,7 +1083,8 @@ void FSP_SRV::OpenDataStorageByDataId(Kernel::HLERequestContext& ctx) {
 
     FileSys::PatchManager pm{title_id};
 
-    IStorage storage(pm.PatchRomFS(std::move(data.Unwrap()), 0, FileSys::ContentRecordType::Data));
+    IStorage storage(pm.PatchRomFS(std::move(data.Unwrap()), 0, FileSys::ContentRecordType::Data),
+                     storage_worker, readahead_pool);
 
     IPC::ResponseBuilder rb{ctx, 2, 0, 1};
     rb.Push(RESULT_SUCCESS);
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <string>
 #include "core/hle/service/service.h"
 
 namespace Core {
@@ -13,6 +15,16 @@ class Reporter;
 
 namespace FileSys {
 class FileSystemBackend;
+class WriteBackCache;
+}
+
+namespace Kernel {
+class KernelCore;
+}
+
+namespace Service {
+class AsyncWorker;
+class AsyncWorkerPool;
 }
 
 namespace Service::FileSystem {
@@ -32,7 +44,8 @@ enum class LogMode : u32 {
 
 class FSP_SRV final : public ServiceFramework<FSP_SRV> {
 public:
-    explicit FSP_SRV(FileSystemController& fsc, const Core::Reporter& reporter);
+    explicit FSP_SRV(Kernel::KernelCore& kernel, FileSystemController& fsc,
+                     const Core::Reporter& reporter);
     ~FSP_SRV() override;
 
 private:
@@ -53,6 +66,13 @@ private:
 
     FileSystemController& fsc;
 
+    /// Runs the reads of the storages opened through this service.
+    std::shared_ptr<AsyncWorker> storage_worker;
+    /// Loads the data following sequential reads of the opened files and storages.
+    std::shared_ptr<AsyncWorkerPool> readahead_pool;
+    /// Pending writes of the opened save data, by path of the save data directory.
+    std::map<std::string, std::weak_ptr<FileSys::WriteBackCache>> save_data_caches;
+
     FileSys::VirtualFile romfs;
     u64 current_process_id = 0;
     u32 access_log_program_index = 0;
@@ -27,4 +27,8 @@ void ControllerBase::DeactivateController() {
 bool ControllerBase::IsControllerActivated() const {
     return is_activated;
 }
+
+bool ControllerBase::IsUpdateNeeded() const {
+    return is_activated;
+}
 } // namespace Service::HID
@@ -34,6 +34,10 @@ public:
     // Called when input devices should be loaded
     virtual void OnLoadInputDevices() = 0;
 
+    // Whether OnUpdate has anything to write, controllers that aren't activated leave the shared
+    // memory untouched and are skipped
+    virtual bool IsUpdateNeeded() const;
+
     void ActivateController();
 
     void DeactivateController();
@@ -93,7 +93,15 @@ u32 Controller_NPad::IndexToNPad(std::size_t index) {
     };
 }
 
-Controller_NPad::Controller_NPad(Core::System& system) : ControllerBase(system), system(system) {}
+Controller_NPad::Controller_NPad(Core::System& system) : ControllerBase(system), system(system) {
+    if (!Settings::values.input_replay_path.empty()) {
+        input_recording = InputRecording::Open(Settings::values.input_replay_path,
+                                               InputRecording::Mode::Replay);
+    } else if (!Settings::values.input_record_path.empty()) {
+        input_recording = InputRecording::Open(Settings::values.input_record_path,
+                                               InputRecording::Mode::Record);
+    }
+}
 Controller_NPad::~Controller_NPad() = default;
 
 void Controller_NPad::InitNewlyAddedControler(std::size_t controller_idx) {
@@ -102,6 +110,7 @@ void Controller_NPad::InitNewlyAddedControler(std::size_t controller_idx) {
     if (controller_type == NPadControllerType::None) {
         return;
     }
+    dirty_entries.set(controller_idx);
     controller.joy_styles.raw = 0; // Zero out
     controller.device_type.raw = 0;
     switch (controller_type) {
@@ -180,6 +189,7 @@ void Controller_NPad::OnInit() {
     if (!IsControllerActivated()) {
         return;
     }
+    dirty_entries.set();
 
     if (style.raw == 0) {
         // We want to support all controllers
@@ -293,10 +303,34 @@ void Controller_NPad::RequestPadStateUpdate(u32 npad_id) {
     rstick_entry.y = static_cast<s32>(stick_r_y_f * HID_JOYSTICK_MAX);
 }
 
+void Controller_NPad::ProcessInputRecording(u32 npad_index) {
+    auto& pad_state = npad_pad_states[npad_index];
+    RecordedPadState state{pad_state.pad_states.raw, pad_state.l_stick.x, pad_state.l_stick.y,
+                           pad_state.r_stick.x, pad_state.r_stick.y};
+    input_recording->Process(npad_index, state);
+
+    pad_state.pad_states.raw = state.buttons;
+    pad_state.l_stick.x = state.l_stick_x;
+    pad_state.l_stick.y = state.l_stick_y;
+    pad_state.r_stick.x = state.r_stick_x;
+    pad_state.r_stick.y = state.r_stick_y;
+}
+
 void Controller_NPad::OnUpdate(const Core::Timing::CoreTiming& core_timing, u8* data,
                                std::size_t data_len) {
     if (!IsControllerActivated())
         return;
+    if (input_recording != nullptr) {
+        input_recording->BeginUpdate();
+    }
+
+    // Copies a part of the entries to the same place in the shared memory
+    const auto write_shared = [&](const auto& field) {
+        const auto offset = reinterpret_cast<const u8*>(&field) -
+                            reinterpret_cast<const u8*>(shared_memory_entries.data());
+        std::memcpy(data + NPAD_OFFSET + offset, &field, sizeof(field));
+    };
+
     for (std::size_t i = 0; i < shared_memory_entries.size(); i++) {
         auto& npad = shared_memory_entries[i];
         const std::array<NPadGeneric*, 7> controller_npads{&npad.main_controller_states,
@@ -331,6 +365,9 @@ void Controller_NPad::OnUpdate(const Core::Timing::CoreTiming& core_timing, u8*
         }
         const u32 npad_index = static_cast<u32>(i);
         RequestPadStateUpdate(npad_index);
+        if (input_recording != nullptr) {
+            ProcessInputRecording(npad_index);
+        }
         auto& pad_state = npad_pad_states[npad_index];
 
         auto& main_controller =
@@ -421,8 +458,22 @@ void Controller_NPad::OnUpdate(const Core::Timing::CoreTiming& core_timing, u8*
 
         press_state |= static_cast<u32>(pad_state.pad_states.raw);
     }
-    std::memcpy(data + NPAD_OFFSET, shared_memory_entries.data(),
-                shared_memory_entries.size() * sizeof(NPadEntry));
+
+    // A sample only changes the header and the newest state of each layout
+    for (std::size_t i = 0; i < shared_memory_entries.size(); i++) {
+        const auto& npad = shared_memory_entries[i];
+        if (dirty_entries[i]) {
+            write_shared(npad);
+            continue;
+        }
+        for (const NPadGeneric* layout :
+             {&npad.main_controller_states, &npad.handheld_states, &npad.dual_states,
+              &npad.left_joy_states, &npad.right_joy_states, &npad.pokeball_states, &npad.libnx}) {
+            write_shared(layout->common);
+            write_shared(layout->npad[layout->common.last_entry_index]);
+        }
+    }
+    dirty_entries.reset();
 }
 
 void Controller_NPad::SetSupportedStyleSet(NPadType style_set) {
@@ -482,6 +533,7 @@ void Controller_NPad::SetNpadMode(u32 npad_id, NPadAssignments assignment_mode)
     ASSERT(npad_index < shared_memory_entries.size());
     if (shared_memory_entries[npad_index].pad_assignment != assignment_mode) {
         shared_memory_entries[npad_index].pad_assignment = assignment_mode;
+        dirty_entries.set(npad_index);
     }
 }
 
@@ -5,12 +5,14 @@
 #pragma once
 
 #include <array>
+#include <bitset>
 #include "common/bit_field.h"
 #include "common/common_types.h"
 #include "core/frontend/input.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/writable_event.h"
 #include "core/hle/service/hid/controllers/controller_base.h"
+#include "core/hle/service/hid/input_recording.h"
 #include "core/settings.h"
 
 namespace Service::HID {
@@ -305,11 +307,16 @@ private:
     bool IsControllerSupported(NPadControllerType controller) const;
     NPadControllerType DecideBestController(NPadControllerType priority) const;
     void RequestPadStateUpdate(u32 npad_id);
+    /// Records the state just read for an npad, or replaces it with the state of the replay.
+    void ProcessInputRecording(u32 npad_index);
 
     u32 press_state{};
 
     NPadType style{};
     std::array<NPadEntry, 10> shared_memory_entries{};
+    /// Entries changed outside of the sampling, they are written whole on the next update. The
+    /// others only get their headers and newest states written.
+    std::bitset<10> dirty_entries;
     std::array<
         std::array<std::unique_ptr<Input::ButtonDevice>, Settings::NativeButton::NUM_BUTTONS_HID>,
         10>
@@ -328,6 +335,7 @@ private:
 
     std::array<ControllerPad, 10> npad_pad_states{};
     bool is_in_lr_assignment_mode{false};
+    std::unique_ptr<InputRecording> input_recording;
     Core::System& system;
 };
 } // namespace Service::HID
@@ -33,6 +33,10 @@ void Controller_Stubbed::OnUpdate(const Core::Timing::CoreTiming& core_timing, u
 
 void Controller_Stubbed::OnLoadInputDevices() {}
 
+bool Controller_Stubbed::IsUpdateNeeded() const {
+    return smart_update;
+}
+
 void Controller_Stubbed::SetCommonHeaderOffset(std::size_t off) {
     common_offset = off;
     smart_update = true;
@@ -25,6 +25,9 @@ public:
     // Called when input devices should be loaded
     void OnLoadInputDevices() override;
 
+    // Stubbed controllers write their header whether they are activated or not
+    bool IsUpdateNeeded() const override;
+
     void SetCommonHeaderOffset(std::size_t off);
 
 private:
@@ -20,6 +20,7 @@
 #include "core/hle/service/hid/hid.h"
 #include "core/hle/service/hid/irs.h"
 #include "core/hle/service/hid/xcd.h"
+#include "core/hle/service/nvflinger/nvflinger.h"
 #include "core/hle/service/service.h"
 #include "core/settings.h"
 
@@ -44,8 +45,10 @@ constexpr s64 pad_update_ticks = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE
     static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 100);
 constexpr std::size_t SHARED_MEMORY_SIZE = 0x40000;
 
-IAppletResource::IAppletResource(Core::System& system)
-    : ServiceFramework("IAppletResource"), system(system) {
+IAppletResource::IAppletResource(Core::System& system,
+                                 std::shared_ptr<NVFlinger::NVFlinger> nv_flinger)
+    : ServiceFramework("IAppletResource"), system(system), nv_flinger(std::move(nv_flinger)),
+      is_sampled_on_vsync(Settings::values.sample_input_on_vsync) {
     static const FunctionInfo functions[] = {
         {0, &IAppletResource::GetSharedMemoryHandle, "GetSharedMemoryHandle"},
     };
@@ -85,7 +88,11 @@ IAppletResource::IAppletResource(Core::System& system)
 
     // TODO(shinyquagsire23): Other update callbacks? (accel, gyro?)
 
-    core_timing.ScheduleEvent(pad_update_ticks, pad_update_event);
+    if (is_sampled_on_vsync) {
+        this->nv_flinger->SetVsyncInputCallback([this] { UpdateSharedMemory(); });
+    } else {
+        core_timing.ScheduleEvent(pad_update_ticks, pad_update_event);
+    }
 
     ReloadInputDevices();
 }
@@ -99,6 +106,9 @@ void IAppletResource::DeactivateController(HidController controller) {
 }
 
 IAppletResource ::~IAppletResource() {
+    if (is_sampled_on_vsync) {
+        nv_flinger->SetVsyncInputCallback({});
+    }
     system.CoreTiming().UnscheduleEvent(pad_update_event, 0);
 }
 
@@ -111,6 +121,11 @@ void IAppletResource::GetSharedMemoryHandle(Kernel::HLERequestContext& ctx) {
 }
 
 void IAppletResource::UpdateControllers(u64 userdata, s64 cycles_late) {
+    UpdateSharedMemory();
+    system.CoreTiming().ScheduleEvent(pad_update_ticks - cycles_late, pad_update_event);
+}
+
+void IAppletResource::UpdateSharedMemory() {
     auto& core_timing = system.CoreTiming();
 
     const bool should_reload = Settings::values.is_device_reload_pending.exchange(false);
@@ -118,10 +133,11 @@ void IAppletResource::UpdateControllers(u64 userdata, s64 cycles_late) {
         if (should_reload) {
             controller->OnLoadInputDevices();
         }
+        if (!controller->IsUpdateNeeded()) {
+            continue;
+        }
         controller->OnUpdate(core_timing, shared_mem->GetPointer(), SHARED_MEMORY_SIZE);
     }
-
-    core_timing.ScheduleEvent(pad_update_ticks - cycles_late, pad_update_event);
 }
 
 class IActiveVibrationDeviceList final : public ServiceFramework<IActiveVibrationDeviceList> {
@@ -144,13 +160,14 @@ private:
 
 std::shared_ptr<IAppletResource> Hid::GetAppletResource() {
     if (applet_resource == nullptr) {
-        applet_resource = std::make_shared<IAppletResource>(system);
+        applet_resource = std::make_shared<IAppletResource>(system, nv_flinger);
     }
 
     return applet_resource;
 }
 
-Hid::Hid(Core::System& system) : ServiceFramework("hid"), system(system) {
+Hid::Hid(Core::System& system, std::shared_ptr<NVFlinger::NVFlinger> nv_flinger)
+    : ServiceFramework("hid"), system(system), nv_flinger(std::move(nv_flinger)) {
     // clang-format off
     static const FunctionInfo functions[] = {
         {0, &Hid::CreateAppletResource, "CreateAppletResource"},
@@ -289,7 +306,7 @@ void Hid::CreateAppletResource(Kernel::HLERequestContext& ctx) {
     LOG_DEBUG(Service_HID, "called, applet_resource_user_id={}", applet_resource_user_id);
 
     if (applet_resource == nullptr) {
-        applet_resource = std::make_shared<IAppletResource>(system);
+        applet_resource = std::make_shared<IAppletResource>(system, nv_flinger);
     }
 
     IPC::ResponseBuilder rb{ctx, 2, 0, 1};
@@ -1099,8 +1116,9 @@ void ReloadInputDevices() {
     Settings::values.is_device_reload_pending.store(true);
 }
 
-void InstallInterfaces(SM::ServiceManager& service_manager, Core::System& system) {
-    std::make_shared<Hid>(system)->InstallAsService(service_manager);
+void InstallInterfaces(SM::ServiceManager& service_manager,
+                       std::shared_ptr<NVFlinger::NVFlinger> nv_flinger, Core::System& system) {
+    std::make_shared<Hid>(system, std::move(nv_flinger))->InstallAsService(service_manager);
     std::make_shared<HidBus>()->InstallAsService(service_manager);
     std::make_shared<HidDbg>()->InstallAsService(service_manager);
     std::make_shared<HidSys>()->InstallAsService(service_manager);
@@ -18,6 +18,10 @@ namespace Kernel {
 class SharedMemory;
 }
 
+namespace Service::NVFlinger {
+class NVFlinger;
+}
+
 namespace Service::SM {
 class ServiceManager;
 }
@@ -42,7 +46,8 @@ enum class HidController : std::size_t {
 
 class IAppletResource final : public ServiceFramework<IAppletResource> {
 public:
-    explicit IAppletResource(Core::System& system);
+    explicit IAppletResource(Core::System& system,
+                             std::shared_ptr<NVFlinger::NVFlinger> nv_flinger);
     ~IAppletResource() override;
 
     void ActivateController(HidController controller);
@@ -66,11 +71,15 @@ private:
 
     void GetSharedMemoryHandle(Kernel::HLERequestContext& ctx);
     void UpdateControllers(u64 userdata, s64 cycles_late);
+    void UpdateSharedMemory();
 
     Kernel::SharedPtr<Kernel::SharedMemory> shared_mem;
 
     Core::Timing::EventType* pad_update_event;
     Core::System& system;
+    std::shared_ptr<NVFlinger::NVFlinger> nv_flinger;
+    /// Whether the input is sampled on vsync instead of at the rate of pad_update_event
+    bool is_sampled_on_vsync;
 
     std::array<std::unique_ptr<ControllerBase>, static_cast<size_t>(HidController::MaxControllers)>
         controllers{};
@@ -78,7 +87,7 @@ private:
 
 class Hid final : public ServiceFramework<Hid> {
 public:
-    explicit Hid(Core::System& system);
+    explicit Hid(Core::System& system, std::shared_ptr<NVFlinger::NVFlinger> nv_flinger);
     ~Hid() override;
 
     std::shared_ptr<IAppletResource> GetAppletResource();
@@ -131,12 +140,14 @@ private:
 
     std::shared_ptr<IAppletResource> applet_resource;
     Core::System& system;
+    std::shared_ptr<NVFlinger::NVFlinger> nv_flinger;
 };
 
 /// Reload input devices. Used when input configuration changed
 void ReloadInputDevices();
 
 /// Registers all HID services with the specified service manager.
-void InstallInterfaces(SM::ServiceManager& service_manager, Core::System& system);
+void InstallInterfaces(SM::ServiceManager& service_manager,
+                       std::shared_ptr<NVFlinger::NVFlinger> nv_flinger, Core::System& system);
 
 } // namespace Service::HID
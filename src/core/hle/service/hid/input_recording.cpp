@@ -0,0 +1,88 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+#include "common/logging/log.h"
+#include "core/hle/service/hid/input_recording.h"
+
+namespace Service::HID {
+
+namespace {
+
+constexpr u32 RECORDING_MAGIC = Common::MakeMagic('Y', 'I', 'N', 'R');
+constexpr u32 RECORDING_VERSION = 1;
+
+} // Anonymous namespace
+
+std::unique_ptr<InputRecording> InputRecording::Open(const std::string& path, Mode mode) {
+    FileUtil::IOFile file(path, mode == Mode::Record ? "wb" : "rb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Service_HID, "Could not open the input recording {}", path);
+        return nullptr;
+    }
+
+    std::vector<Entry> entries;
+    if (mode == Mode::Record) {
+        const Header header{RECORDING_MAGIC, RECORDING_VERSION};
+        file.WriteObject(header);
+    } else {
+        Header header{};
+        if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+            header.magic != RECORDING_MAGIC || header.version != RECORDING_VERSION) {
+            LOG_ERROR(Service_HID, "{} is not an input recording", path);
+            return nullptr;
+        }
+
+        entries.resize((file.GetSize() - sizeof(header)) / sizeof(Entry));
+        if (file.ReadArray(entries.data(), entries.size()) != entries.size()) {
+            LOG_ERROR(Service_HID, "Could not read the input recording {}", path);
+            return nullptr;
+        }
+        LOG_INFO(Service_HID, "Replaying {} input changes from {}", entries.size(), path);
+    }
+
+    return std::unique_ptr<InputRecording>(
+        new InputRecording(mode, std::move(file), std::move(entries)));
+}
+
+InputRecording::InputRecording(Mode mode, FileUtil::IOFile file, std::vector<Entry> entries)
+    : mode(mode), file(std::move(file)), entries(std::move(entries)) {}
+
+InputRecording::~InputRecording() = default;
+
+void InputRecording::BeginUpdate() {
+    ++update;
+    if (mode != Mode::Replay) {
+        return;
+    }
+
+    for (; next_entry < entries.size() && entries[next_entry].update <= update; ++next_entry) {
+        const Entry& entry = entries[next_entry];
+        if (entry.npad_index < states.size()) {
+            states[entry.npad_index] = entry.state;
+        }
+    }
+}
+
+void InputRecording::Process(std::size_t npad_index, RecordedPadState& state) {
+    if (npad_index >= states.size()) {
+        return;
+    }
+
+    if (mode == Mode::Replay) {
+        state = states[npad_index];
+        return;
+    }
+
+    if (state != states[npad_index]) {
+        states[npad_index] = state;
+        Entry entry{};
+        entry.update = update;
+        entry.npad_index = static_cast<u32>(npad_index);
+        entry.state = state;
+        file.WriteObject(entry);
+    }
+}
+
+} // namespace Service::HID
@@ -0,0 +1,91 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace Service::HID {
+
+/// Input of one npad on one HID update.
+struct RecordedPadState {
+    u64 buttons{};
+    s32 l_stick_x{};
+    s32 l_stick_y{};
+    s32 r_stick_x{};
+    s32 r_stick_y{};
+
+    bool operator==(const RecordedPadState& other) const {
+        return buttons == other.buttons && l_stick_x == other.l_stick_x &&
+               l_stick_y == other.l_stick_y && r_stick_x == other.r_stick_x &&
+               r_stick_y == other.r_stick_y;
+    }
+
+    bool operator!=(const RecordedPadState& other) const {
+        return !operator==(other);
+    }
+};
+static_assert(sizeof(RecordedPadState) == 0x18, "RecordedPadState has incorrect size.");
+
+/**
+ * Records the npad states HID reads from the input devices on each update to a file, or replays a
+ * file recorded before in place of the input devices. Updates are scheduled in emulated time, so a
+ * recording replays the same way as long as the title boots with the same controllers, RNG seed
+ * and clock.
+ */
+class InputRecording {
+public:
+    enum class Mode {
+        Record,
+        Replay,
+    };
+
+    static constexpr std::size_t NUM_PADS = 10;
+
+    /// Opens a recording to write or to replay, returns nullptr if it could not be opened.
+    static std::unique_ptr<InputRecording> Open(const std::string& path, Mode mode);
+
+    ~InputRecording();
+
+    /// Starts the next HID update, applying the changes a replay recorded for it.
+    void BeginUpdate();
+
+    /// Records the state read for an npad on the current update, or replaces it with the state
+    /// of the replay.
+    void Process(std::size_t npad_index, RecordedPadState& state);
+
+private:
+    struct Header {
+        u32 magic;
+        u32 version;
+    };
+    static_assert(sizeof(Header) == 0x8, "Header has incorrect size.");
+
+    /// Change of the state of an npad, only written when the state differs from the previous one.
+    struct Entry {
+        u64 update;
+        u32 npad_index;
+        INSERT_PADDING_WORDS(1);
+        RecordedPadState state;
+    };
+    static_assert(sizeof(Entry) == 0x28, "Entry has incorrect size.");
+
+    InputRecording(Mode mode, FileUtil::IOFile file, std::vector<Entry> entries);
+
+    Mode mode;
+    FileUtil::IOFile file;
+    std::vector<Entry> entries;
+    std::size_t next_entry = 0;
+
+    u64 update = 0;
+    std::array<RecordedPadState, NUM_PADS> states{};
+};
+
+} // namespace Service::HID
@@ -364,7 +364,7 @@ public:
         vm_manager.ReprotectRange(*map_address + header.rw_offset, header.rw_size,
                                   Kernel::VMAPermission::ReadWrite);
 
-        system.InvalidateCpuInstructionCaches();
+        system.InvalidateCpuInstructionCacheRange(*map_address, nro_size + bss_size);
 
         nro.insert_or_assign(*map_address,
                              NROInfo{hash, nro_address, nro_size, bss_address, bss_size});
@@ -430,7 +430,8 @@ public:
                        .IsSuccess());
         }
 
-        system.InvalidateCpuInstructionCaches();
+        system.InvalidateCpuInstructionCacheRange(nro_address,
+                                                  nro_info.nro_size + nro_info.bss_size);
 
         nro.erase(iter);
         IPC::ResponseBuilder rb{ctx, 2};
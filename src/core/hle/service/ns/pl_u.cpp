@@ -17,7 +17,7 @@
 #include "core/file_sys/nca_metadata.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/romfs.h"
-#include "core/file_sys/system_archive/system_archive.h"
+#include "core/file_sys/system_archive/shared_font.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/physical_memory.h"
 #include "core/hle/kernel/shared_memory.h"
@@ -105,6 +105,19 @@ void EncryptSharedFont(const std::vector<u32>& input, std::vector<u8>& output,
     offset += transformed_font.size() * sizeof(u32);
 }
 
+/// Writes the contents of a bfttf file as DecryptSharedFont writes the encrypted file.
+static void WriteSharedFont(const FileSys::SystemArchive::SharedFontFile& font,
+                            Kernel::PhysicalMemory& output, std::size_t& offset) {
+    const auto font_size = static_cast<u32>(font.size / sizeof(u32) * sizeof(u32));
+    ASSERT_MSG(offset + font_size + 8 < SHARED_FONT_MEM_SIZE, "Shared fonts exceeds 17mb!");
+
+    const std::array<u32, 2> header{Common::swap32(EXPECTED_RESULT),
+                                    font_size ^ EXPECTED_RESULT ^ EXPECTED_MAGIC};
+    std::memcpy(output.data() + offset, header.data(), sizeof(header));
+    std::memcpy(output.data() + offset + sizeof(header), font.data, font_size);
+    offset += sizeof(header) + font_size;
+}
+
 // Helper function to make BuildSharedFontsRawRegions a bit nicer
 static u32 GetU32Swapped(const u8* data) {
     u32 value;
@@ -140,6 +153,68 @@ struct PL_U::Impl {
         }
     }
 
+    /// Builds the shared font memory on first use, from the data archives of the NAND or the
+    /// fonts synthesized archives are built from.
+    void LoadSharedFonts(Core::System& system) {
+        if (shared_font != nullptr) {
+            return;
+        }
+
+        // Attempt to load shared font data from disk
+        const auto* nand = system.GetFileSystemController().GetSystemNANDContents();
+        std::size_t offset = 0;
+
+        shared_font = std::make_shared<Kernel::PhysicalMemory>(SHARED_FONT_MEM_SIZE);
+        for (auto font : SHARED_FONTS) {
+            FileSys::VirtualFile romfs;
+            const auto nca =
+                nand->GetEntry(static_cast<u64>(font.first), FileSys::ContentRecordType::Data);
+            if (nca) {
+                romfs = nca->GetRomFS();
+            }
+
+            if (!romfs) {
+                // Written straight from the data the archive would be synthesized from, instead
+                // of encrypting it into an archive only to extract and decrypt it again
+                const auto font_file = FileSys::SystemArchive::GetSharedFontFile(font.second);
+                if (!font_file) {
+                    LOG_ERROR(Service_NS, "Failed to find or synthesize {:016X}! Skipping",
+                              static_cast<u64>(font.first));
+                    continue;
+                }
+                // Font offset and size do not account for the header
+                const auto region_offset = static_cast<u32>(offset + 8);
+                WriteSharedFont(*font_file, *shared_font, offset);
+                shared_font_regions.push_back(
+                    FontRegion{region_offset, static_cast<u32>(offset) - region_offset});
+                continue;
+            }
+
+            const auto extracted_romfs = FileSys::ExtractRomFS(romfs);
+            if (!extracted_romfs) {
+                LOG_ERROR(Service_NS, "Failed to extract RomFS for {:016X}! Skipping",
+                          static_cast<u64>(font.first));
+                continue;
+            }
+            const auto font_fp = extracted_romfs->GetFile(font.second);
+            if (!font_fp) {
+                LOG_ERROR(Service_NS, "{:016X} has no file \"{}\"! Skipping",
+                          static_cast<u64>(font.first), font.second);
+                continue;
+            }
+            std::vector<u32> font_data_u32(font_fp->GetSize() / sizeof(u32));
+            font_fp->ReadBytes<u32>(font_data_u32.data(), font_fp->GetSize());
+            // We need to be BigEndian as u32s for the xor encryption
+            std::transform(font_data_u32.begin(), font_data_u32.end(), font_data_u32.begin(),
+                           Common::swap32);
+            // Font offset and size do not account for the header
+            const FontRegion region{static_cast<u32>(offset + 8),
+                                    static_cast<u32>((font_data_u32.size() * sizeof(u32)) - 8)};
+            DecryptSharedFont(font_data_u32, *shared_font, offset);
+            shared_font_regions.push_back(region);
+        }
+    }
+
     /// Handle to shared memory region designated for a shared font
     Kernel::SharedPtr<Kernel::SharedMemory> shared_font_mem;
 
@@ -162,56 +237,6 @@ PL_U::PL_U(Core::System& system)
         {5, &PL_U::GetSharedFontInOrderOfPriority, "GetSharedFontInOrderOfPriority"},
     };
     RegisterHandlers(functions);
-
-    auto& fsc = system.GetFileSystemController();
-
-    // Attempt to load shared font data from disk
-    const auto* nand = fsc.GetSystemNANDContents();
-    std::size_t offset = 0;
-    // Rebuild shared fonts from data ncas or synthesize
-
-    impl->shared_font = std::make_shared<Kernel::PhysicalMemory>(SHARED_FONT_MEM_SIZE);
-    for (auto font : SHARED_FONTS) {
-        FileSys::VirtualFile romfs;
-        const auto nca =
-            nand->GetEntry(static_cast<u64>(font.first), FileSys::ContentRecordType::Data);
-        if (nca) {
-            romfs = nca->GetRomFS();
-        }
-
-        if (!romfs) {
-            romfs = FileSys::SystemArchive::SynthesizeSystemArchive(static_cast<u64>(font.first));
-        }
-
-        if (!romfs) {
-            LOG_ERROR(Service_NS, "Failed to find or synthesize {:016X}! Skipping",
-                      static_cast<u64>(font.first));
-            continue;
-        }
-
-        const auto extracted_romfs = FileSys::ExtractRomFS(romfs);
-        if (!extracted_romfs) {
-            LOG_ERROR(Service_NS, "Failed to extract RomFS for {:016X}! Skipping",
-                      static_cast<u64>(font.first));
-            continue;
-        }
-        const auto font_fp = extracted_romfs->GetFile(font.second);
-        if (!font_fp) {
-            LOG_ERROR(Service_NS, "{:016X} has no file \"{}\"! Skipping",
-                      static_cast<u64>(font.first), font.second);
-            continue;
-        }
-        std::vector<u32> font_data_u32(font_fp->GetSize() / sizeof(u32));
-        font_fp->ReadBytes<u32>(font_data_u32.data(), font_fp->GetSize());
-        // We need to be BigEndian as u32s for the xor encryption
-        std::transform(font_data_u32.begin(), font_data_u32.end(), font_data_u32.begin(),
-                       Common::swap32);
-        // Font offset and size do not account for the header
-        const FontRegion region{static_cast<u32>(offset + 8),
-                                static_cast<u32>((font_data_u32.size() * sizeof(u32)) - 8)};
-        DecryptSharedFont(font_data_u32, *impl->shared_font, offset);
-        impl->shared_font_regions.push_back(region);
-    }
 }
 
 PL_U::~PL_U() = default;
@@ -240,6 +265,7 @@ void PL_U::GetSize(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp{ctx};
     const u32 font_id{rp.Pop<u32>()};
     LOG_DEBUG(Service_NS, "called, font_id={}", font_id);
+    impl->LoadSharedFonts(system);
 
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(RESULT_SUCCESS);
@@ -250,6 +276,7 @@ void PL_U::GetSharedMemoryAddressOffset(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp{ctx};
     const u32 font_id{rp.Pop<u32>()};
     LOG_DEBUG(Service_NS, "called, font_id={}", font_id);
+    impl->LoadSharedFonts(system);
 
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(RESULT_SUCCESS);
@@ -259,6 +286,7 @@ void PL_U::GetSharedMemoryAddressOffset(Kernel::HLERequestContext& ctx) {
 void PL_U::GetSharedMemoryNativeHandle(Kernel::HLERequestContext& ctx) {
     // Map backing memory for the font data
     LOG_DEBUG(Service_NS, "called");
+    impl->LoadSharedFonts(system);
     system.CurrentProcess()->VMManager().MapMemoryBlock(SHARED_FONT_MEM_VADDR, impl->shared_font, 0,
                                                         SHARED_FONT_MEM_SIZE,
                                                         Kernel::MemoryState::Shared);
@@ -279,6 +307,7 @@ void PL_U::GetSharedFontInOrderOfPriority(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp{ctx};
     const u64 language_code{rp.Pop<u64>()}; // TODO(ogniK): Find out what this is used for
     LOG_DEBUG(Service_NS, "called, language_code={:X}", language_code);
+    impl->LoadSharedFonts(system);
 
     IPC::ResponseBuilder rb{ctx, 4};
     std::vector<u32> font_codes;
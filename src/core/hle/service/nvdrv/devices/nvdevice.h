@@ -4,7 +4,9 @@
 
 #pragma once
 
-#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
 #include "common/bit_field.h"
 #include "common/common_types.h"
 #include "common/swap.h"
@@ -17,6 +19,23 @@ class System;
 
 namespace Service::Nvidia::Devices {
 
+/// Reads the params of an ioctl from the start of its input, params past the end of the input are
+/// zero. The params are copied out as the output, which the ioctl writes, may be the same memory.
+template <typename T>
+T ReadIoctlParams(IoctlInput input) {
+    static_assert(std::is_trivially_copyable_v<T>, "Ioctl params must be trivially copyable");
+    T params{};
+    std::memcpy(&params, input.data(), std::min(input.size(), sizeof(T)));
+    return params;
+}
+
+/// Writes the params of an ioctl to the start of its output, truncated to the size of the output.
+template <typename T>
+void WriteIoctlParams(IoctlOutput output, const T& params) {
+    static_assert(std::is_trivially_copyable_v<T>, "Ioctl params must be trivially copyable");
+    std::memcpy(output.data(), &params, std::min(output.size(), sizeof(T)));
+}
+
 /// Represents an abstract nvidia device node. It is to be subclassed by concrete device nodes to
 /// implement the ioctl interface.
 class nvdevice {
@@ -39,9 +58,8 @@ public:
      * @param output A buffer where the output data will be written to.
      * @returns The result code of the ioctl.
      */
-    virtual u32 ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-                      std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-                      IoctlVersion version) = 0;
+    virtual u32 ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+                      IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) = 0;
 
 protected:
     Core::System& system;
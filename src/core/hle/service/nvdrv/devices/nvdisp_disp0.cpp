@@ -10,6 +10,7 @@
 #include "core/hle/service/nvdrv/devices/nvmap.h"
 #include "core/perf_stats.h"
 #include "video_core/gpu.h"
+#include "video_core/memory_manager.h"
 #include "video_core/renderer_base.h"
 
 namespace Service::Nvidia::Devices {
@@ -18,9 +19,8 @@ nvdisp_disp0::nvdisp_disp0(Core::System& system, std::shared_ptr<nvmap> nvmap_de
     : nvdevice(system), nvmap_dev(std::move(nvmap_dev)) {}
 nvdisp_disp0 ::~nvdisp_disp0() = default;
 
-u32 nvdisp_disp0::ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-                        std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-                        IoctlVersion version) {
+u32 nvdisp_disp0::ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+                        IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) {
     UNIMPLEMENTED_MSG("Unimplemented ioctl");
     return 0;
 }
@@ -35,14 +35,31 @@ void nvdisp_disp0::flip(u32 buffer_handle, u32 offset, u32 format, u32 width, u3
 
     using PixelFormat = Tegra::FramebufferConfig::PixelFormat;
     const Tegra::FramebufferConfig framebuffer{
-        addr,      offset,   width, height, stride, static_cast<PixelFormat>(format),
-        transform, crop_rect};
+        addr,      offset,    width, height, stride, static_cast<PixelFormat>(format),
+        transform, crop_rect, GetGPUAddress(buffer_handle)};
 
     system.GetPerfStats().EndGameFrame();
     system.GetPerfStats().EndSystemFrame();
     system.GPU().SwapBuffers(&framebuffer);
-    system.FrameLimiter().DoFrameLimiting(system.CoreTiming().GetGlobalTimeUs());
+    system.FrameLimiter().DoFrameLimiting(system.CoreTiming().GetGlobalTimeUs(),
+                                          system.GetPerfStats());
     system.GetPerfStats().BeginSystemFrame();
 }
 
+GPUVAddr nvdisp_disp0::GetGPUAddress(u32 buffer_handle) {
+    if (const auto it = gpu_mappings.find(buffer_handle); it != gpu_mappings.end()) {
+        return it->second;
+    }
+    const auto object = nvmap_dev->GetObject(buffer_handle);
+    if (!object || object->status != nvmap::Object::Status::Allocated) {
+        return 0;
+    }
+
+    // The buffer gets a mapping of its own, the texture cache finds the surfaces the guest
+    // rendered to it through its host memory, whatever their address in the GPU address space
+    const GPUVAddr gpu_addr = system.GPU().MemoryManager().MapBufferEx(object->addr, object->size);
+    gpu_mappings.emplace(buffer_handle, gpu_addr);
+    return gpu_addr;
+}
+
 } // namespace Service::Nvidia::Devices
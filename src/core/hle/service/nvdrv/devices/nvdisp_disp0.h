@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include "common/common_types.h"
 #include "common/math_util.h"
@@ -20,9 +21,8 @@ public:
     explicit nvdisp_disp0(Core::System& system, std::shared_ptr<nvmap> nvmap_dev);
     ~nvdisp_disp0() override;
 
-    u32 ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-              std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-              IoctlVersion version) override;
+    u32 ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+              IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) override;
 
     /// Performs a screen flip, drawing the buffer pointed to by the handle.
     void flip(u32 buffer_handle, u32 offset, u32 format, u32 width, u32 height, u32 stride,
@@ -30,7 +30,14 @@ public:
               const Common::Rectangle<int>& crop_rect);
 
 private:
+    /// Returns the address the buffer is mapped at in the GPU address space, mapping it on its
+    /// first flip. Returns zero when the handle is invalid.
+    GPUVAddr GetGPUAddress(u32 buffer_handle);
+
     std::shared_ptr<nvmap> nvmap_dev;
+
+    /// Mappings of the flipped buffers in the GPU address space, by nvmap handle.
+    std::unordered_map<u32, GPUVAddr> gpu_mappings;
 };
 
 } // namespace Service::Nvidia::Devices
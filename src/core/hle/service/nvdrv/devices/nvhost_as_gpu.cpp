@@ -26,9 +26,8 @@ nvhost_as_gpu::nvhost_as_gpu(Core::System& system, std::shared_ptr<nvmap> nvmap_
     : nvdevice(system), nvmap_dev(std::move(nvmap_dev)) {}
 nvhost_as_gpu::~nvhost_as_gpu() = default;
 
-u32 nvhost_as_gpu::ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-                         std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-                         IoctlVersion version) {
+u32 nvhost_as_gpu::ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+                         IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) {
     LOG_DEBUG(Service_NVDRV, "called, command=0x{:08X}, input_size=0x{:X}, output_size=0x{:X}",
               command.raw, input.size(), output.size());
 
@@ -56,17 +55,15 @@ u32 nvhost_as_gpu::ioctl(Ioctl command, const std::vector<u8>& input, const std:
     return 0;
 }
 
-u32 nvhost_as_gpu::InitalizeEx(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlInitalizeEx params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_as_gpu::InitalizeEx(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlInitalizeEx>(input);
     LOG_WARNING(Service_NVDRV, "(STUBBED) called, big_page_size=0x{:X}", params.big_page_size);
 
     return 0;
 }
 
-u32 nvhost_as_gpu::AllocateSpace(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlAllocSpace params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_as_gpu::AllocateSpace(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlAllocSpace>(input);
     LOG_DEBUG(Service_NVDRV, "called, pages={:X}, page_size={:X}, flags={:X}", params.pages,
               params.page_size, params.flags);
 
@@ -78,17 +75,18 @@ u32 nvhost_as_gpu::AllocateSpace(const std::vector<u8>& input, std::vector<u8>&
         params.offset = gpu.MemoryManager().AllocateSpace(size, params.align);
     }
 
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_as_gpu::Remap(const std::vector<u8>& input, std::vector<u8>& output) {
-    std::size_t num_entries = input.size() / sizeof(IoctlRemapEntry);
+u32 nvhost_as_gpu::Remap(IoctlInput input, IoctlOutput output) {
+    const std::size_t num_entries = input.size() / sizeof(IoctlRemapEntry);
+    const std::size_t entries_size = num_entries * sizeof(IoctlRemapEntry);
 
     LOG_WARNING(Service_NVDRV, "(STUBBED) called, num_entries=0x{:X}", num_entries);
 
     std::vector<IoctlRemapEntry> entries(num_entries);
-    std::memcpy(entries.data(), input.data(), input.size());
+    std::memcpy(entries.data(), input.data(), entries_size);
 
     auto& gpu = system.GPU();
     for (const auto& entry : entries) {
@@ -98,7 +96,7 @@ u32 nvhost_as_gpu::Remap(const std::vector<u8>& input, std::vector<u8>& output)
         auto object = nvmap_dev->GetObject(entry.nvmap_handle);
         if (!object) {
             LOG_CRITICAL(Service_NVDRV, "nvmap {} is an invalid handle!", entry.nvmap_handle);
-            std::memcpy(output.data(), entries.data(), output.size());
+            std::memcpy(output.data(), entries.data(), std::min(output.size(), entries_size));
             return static_cast<u32>(NvErrCodes::InvalidNmapHandle);
         }
 
@@ -110,13 +108,12 @@ u32 nvhost_as_gpu::Remap(const std::vector<u8>& input, std::vector<u8>& output)
         GPUVAddr returned = gpu.MemoryManager().MapBufferEx(object->addr, offset, size);
         ASSERT(returned == offset);
     }
-    std::memcpy(output.data(), entries.data(), output.size());
+    std::memcpy(output.data(), entries.data(), std::min(output.size(), entries_size));
     return 0;
 }
 
-u32 nvhost_as_gpu::MapBufferEx(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlMapBufferEx params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_as_gpu::MapBufferEx(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlMapBufferEx>(input);
 
     LOG_DEBUG(Service_NVDRV,
               "called, flags={:X}, nvmap_handle={:X}, buffer_offset={}, mapping_size={}"
@@ -160,13 +157,12 @@ u32 nvhost_as_gpu::MapBufferEx(const std::vector<u8>& input, std::vector<u8>& ou
 
     buffer_mappings[params.offset] = mapping;
 
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_as_gpu::UnmapBuffer(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlUnmapBuffer params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_as_gpu::UnmapBuffer(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlUnmapBuffer>(input);
 
     LOG_DEBUG(Service_NVDRV, "called, offset=0x{:X}", params.offset);
 
@@ -181,22 +177,20 @@ u32 nvhost_as_gpu::UnmapBuffer(const std::vector<u8>& input, std::vector<u8>& ou
     params.offset = system.GPU().MemoryManager().UnmapBuffer(params.offset, itr->second.size);
     buffer_mappings.erase(itr->second.offset);
 
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_as_gpu::BindChannel(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlBindChannel params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_as_gpu::BindChannel(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlBindChannel>(input);
     LOG_DEBUG(Service_NVDRV, "called, fd={:X}", params.fd);
 
     channel = params.fd;
     return 0;
 }
 
-u32 nvhost_as_gpu::GetVARegions(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlGetVaRegions params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_as_gpu::GetVARegions(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlGetVaRegions>(input);
     LOG_WARNING(Service_NVDRV, "(STUBBED) called, buf_addr={:X}, buf_size={:X}", params.buf_addr,
                 params.buf_size);
 
@@ -209,7 +203,7 @@ u32 nvhost_as_gpu::GetVARegions(const std::vector<u8>& input, std::vector<u8>& o
     params.regions[1].page_size = 0x10000;
     params.regions[1].pages = 0x1bffff;
     // TODO(ogniK): This probably can stay stubbed but should add support way way later
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
@@ -19,9 +19,8 @@ nvhost_ctrl::nvhost_ctrl(Core::System& system, EventInterface& events_interface)
     : nvdevice(system), events_interface{events_interface} {}
 nvhost_ctrl::~nvhost_ctrl() = default;
 
-u32 nvhost_ctrl::ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-                       std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-                       IoctlVersion version) {
+u32 nvhost_ctrl::ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+                       IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) {
     LOG_DEBUG(Service_NVDRV, "called, command=0x{:08X}, input_size=0x{:X}, output_size=0x{:X}",
               command.raw, input.size(), output.size());
 
@@ -44,18 +43,16 @@ u32 nvhost_ctrl::ioctl(Ioctl command, const std::vector<u8>& input, const std::v
     }
 }
 
-u32 nvhost_ctrl::NvOsGetConfigU32(const std::vector<u8>& input, std::vector<u8>& output) {
-    IocGetConfigParams params{};
-    std::memcpy(&params, input.data(), sizeof(params));
+u32 nvhost_ctrl::NvOsGetConfigU32(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IocGetConfigParams>(input);
     LOG_TRACE(Service_NVDRV, "called, setting={}!{}", params.domain_str.data(),
               params.param_str.data());
     return 0x30006; // Returns error on production mode
 }
 
-u32 nvhost_ctrl::IocCtrlEventWait(const std::vector<u8>& input, std::vector<u8>& output,
-                                  bool is_async, IoctlCtrl& ctrl) {
-    IocCtrlEventWaitParams params{};
-    std::memcpy(&params, input.data(), sizeof(params));
+u32 nvhost_ctrl::IocCtrlEventWait(IoctlInput input, IoctlOutput output, bool is_async,
+                                  IoctlCtrl& ctrl) {
+    auto params = ReadIoctlParams<IocCtrlEventWaitParams>(input);
     LOG_DEBUG(Service_NVDRV, "syncpt_id={}, threshold={}, timeout={}, is_async={}",
               params.syncpt_id, params.threshold, params.timeout, is_async);
 
@@ -66,7 +63,7 @@ u32 nvhost_ctrl::IocCtrlEventWait(const std::vector<u8>& input, std::vector<u8>&
     u32 event_id = params.value & 0x00FF;
 
     if (event_id >= MaxNvEvents) {
-        std::memcpy(output.data(), &params, sizeof(params));
+        WriteIoctlParams(output, params);
         return NvResult::BadParameter;
     }
 
@@ -84,7 +81,7 @@ u32 nvhost_ctrl::IocCtrlEventWait(const std::vector<u8>& input, std::vector<u8>&
     if (diff >= 0) {
         event.writable->Signal();
         params.value = current_syncpoint_value;
-        std::memcpy(output.data(), &params, sizeof(params));
+        WriteIoctlParams(output, params);
         return NvResult::Success;
     }
     const u32 target_value = current_syncpoint_value - diff;
@@ -94,7 +91,7 @@ u32 nvhost_ctrl::IocCtrlEventWait(const std::vector<u8>& input, std::vector<u8>&
     }
 
     if (params.timeout == 0) {
-        std::memcpy(output.data(), &params, sizeof(params));
+        WriteIoctlParams(output, params);
         return NvResult::Timeout;
     }
 
@@ -117,16 +114,15 @@ u32 nvhost_ctrl::IocCtrlEventWait(const std::vector<u8>& input, std::vector<u8>&
             ctrl.event_id = event_id;
             return NvResult::Timeout;
         }
-        std::memcpy(output.data(), &params, sizeof(params));
+        WriteIoctlParams(output, params);
         return NvResult::Timeout;
     }
-    std::memcpy(output.data(), &params, sizeof(params));
+    WriteIoctlParams(output, params);
     return NvResult::BadParameter;
 }
 
-u32 nvhost_ctrl::IocCtrlEventRegister(const std::vector<u8>& input, std::vector<u8>& output) {
-    IocCtrlEventRegisterParams params{};
-    std::memcpy(&params, input.data(), sizeof(params));
+u32 nvhost_ctrl::IocCtrlEventRegister(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IocCtrlEventRegisterParams>(input);
     const u32 event_id = params.user_event_id & 0x00FF;
     LOG_DEBUG(Service_NVDRV, " called, user_event_id: {:X}", event_id);
     if (event_id >= MaxNvEvents) {
@@ -139,9 +135,8 @@ u32 nvhost_ctrl::IocCtrlEventRegister(const std::vector<u8>& input, std::vector<
     return NvResult::Success;
 }
 
-u32 nvhost_ctrl::IocCtrlEventUnregister(const std::vector<u8>& input, std::vector<u8>& output) {
-    IocCtrlEventUnregisterParams params{};
-    std::memcpy(&params, input.data(), sizeof(params));
+u32 nvhost_ctrl::IocCtrlEventUnregister(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IocCtrlEventUnregisterParams>(input);
     const u32 event_id = params.user_event_id & 0x00FF;
     LOG_DEBUG(Service_NVDRV, " called, user_event_id: {:X}", event_id);
     if (event_id >= MaxNvEvents) {
@@ -154,9 +149,8 @@ u32 nvhost_ctrl::IocCtrlEventUnregister(const std::vector<u8>& input, std::vecto
     return NvResult::Success;
 }
 
-u32 nvhost_ctrl::IocCtrlEventSignal(const std::vector<u8>& input, std::vector<u8>& output) {
-    IocCtrlEventSignalParams params{};
-    std::memcpy(&params, input.data(), sizeof(params));
+u32 nvhost_ctrl::IocCtrlEventSignal(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IocCtrlEventSignalParams>(input);
     // TODO(Blinkhawk): This is normally called when an NvEvents timeout on WaitSynchronization
     // It is believed from RE to cancel the GPU Event. However, better research is required
     u32 event_id = params.user_event_id & 0x00FF;
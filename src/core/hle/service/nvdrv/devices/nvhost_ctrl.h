@@ -17,9 +17,8 @@ public:
     explicit nvhost_ctrl(Core::System& system, EventInterface& events_interface);
     ~nvhost_ctrl() override;
 
-    u32 ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-              std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-              IoctlVersion version) override;
+    u32 ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+              IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) override;
 
 private:
     enum class IoctlCommand : u32_le {
@@ -133,16 +132,15 @@ private:
     };
     static_assert(sizeof(IocCtrlEventKill) == 8, "IocCtrlEventKill is incorrect size");
 
-    u32 NvOsGetConfigU32(const std::vector<u8>& input, std::vector<u8>& output);
+    u32 NvOsGetConfigU32(IoctlInput input, IoctlOutput output);
 
-    u32 IocCtrlEventWait(const std::vector<u8>& input, std::vector<u8>& output, bool is_async,
-                         IoctlCtrl& ctrl);
+    u32 IocCtrlEventWait(IoctlInput input, IoctlOutput output, bool is_async, IoctlCtrl& ctrl);
 
-    u32 IocCtrlEventRegister(const std::vector<u8>& input, std::vector<u8>& output);
+    u32 IocCtrlEventRegister(IoctlInput input, IoctlOutput output);
 
-    u32 IocCtrlEventUnregister(const std::vector<u8>& input, std::vector<u8>& output);
+    u32 IocCtrlEventUnregister(IoctlInput input, IoctlOutput output);
 
-    u32 IocCtrlEventSignal(const std::vector<u8>& input, std::vector<u8>& output);
+    u32 IocCtrlEventSignal(IoctlInput input, IoctlOutput output);
 
     EventInterface& events_interface;
 };
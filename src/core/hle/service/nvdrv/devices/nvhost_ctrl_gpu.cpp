@@ -15,9 +15,8 @@ namespace Service::Nvidia::Devices {
 nvhost_ctrl_gpu::nvhost_ctrl_gpu(Core::System& system) : nvdevice(system) {}
 nvhost_ctrl_gpu::~nvhost_ctrl_gpu() = default;
 
-u32 nvhost_ctrl_gpu::ioctl(Ioctl command, const std::vector<u8>& input,
-                           const std::vector<u8>& input2, std::vector<u8>& output,
-                           std::vector<u8>& output2, IoctlCtrl& ctrl, IoctlVersion version) {
+u32 nvhost_ctrl_gpu::ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+                           IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) {
     LOG_DEBUG(Service_NVDRV, "called, command=0x{:08X}, input_size=0x{:X}, output_size=0x{:X}",
               command.raw, input.size(), output.size());
 
@@ -46,11 +45,10 @@ u32 nvhost_ctrl_gpu::ioctl(Ioctl command, const std::vector<u8>& input,
     }
 }
 
-u32 nvhost_ctrl_gpu::GetCharacteristics(const std::vector<u8>& input, std::vector<u8>& output,
-                                        std::vector<u8>& output2, IoctlVersion version) {
+u32 nvhost_ctrl_gpu::GetCharacteristics(IoctlInput input, IoctlOutput output, IoctlOutput output2,
+                                        IoctlVersion version) {
     LOG_DEBUG(Service_NVDRV, "called");
-    IoctlCharacteristics params{};
-    std::memcpy(&params, input.data(), input.size());
+    auto params = ReadIoctlParams<IoctlCharacteristics>(input);
     params.gc.arch = 0x120;
     params.gc.impl = 0xb;
     params.gc.rev = 0xa1;
@@ -90,17 +88,16 @@ u32 nvhost_ctrl_gpu::GetCharacteristics(const std::vector<u8>& input, std::vecto
     params.gpu_characteristics_buf_addr = 0xdeadbeef; // Cannot be 0 (UNUSED)
 
     if (version == IoctlVersion::Version3) {
-        std::memcpy(output.data(), input.data(), output.size());
-        std::memcpy(output2.data(), &params.gc, output2.size());
+        std::memmove(output.data(), input.data(), std::min(input.size(), output.size()));
+        WriteIoctlParams(output2, params.gc);
     } else {
-        std::memcpy(output.data(), &params, output.size());
+        WriteIoctlParams(output, params);
     }
     return 0;
 }
 
-u32 nvhost_ctrl_gpu::GetTPCMasks(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlGpuGetTpcMasksArgs params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_ctrl_gpu::GetTPCMasks(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlGpuGetTpcMasksArgs>(input);
     LOG_INFO(Service_NVDRV, "called, mask=0x{:X}, mask_buf_addr=0x{:X}", params.mask_buf_size,
              params.mask_buf_addr);
     // TODO(ogniK): Confirm value on hardware
@@ -108,43 +105,33 @@ u32 nvhost_ctrl_gpu::GetTPCMasks(const std::vector<u8>& input, std::vector<u8>&
         params.tpc_mask_size = 4 * 1; // 4 * num_gpc
     else
         params.tpc_mask_size = 0;
-    std::memcpy(output.data(), &params, sizeof(params));
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_ctrl_gpu::GetActiveSlotMask(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvhost_ctrl_gpu::GetActiveSlotMask(IoctlInput input, IoctlOutput output) {
     LOG_DEBUG(Service_NVDRV, "called");
 
-    IoctlActiveSlotMask params{};
-    if (input.size() > 0) {
-        std::memcpy(&params, input.data(), input.size());
-    }
+    auto params = ReadIoctlParams<IoctlActiveSlotMask>(input);
     params.slot = 0x07;
     params.mask = 0x01;
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_ctrl_gpu::ZCullGetCtxSize(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvhost_ctrl_gpu::ZCullGetCtxSize(IoctlInput input, IoctlOutput output) {
     LOG_DEBUG(Service_NVDRV, "called");
 
-    IoctlZcullGetCtxSize params{};
-    if (input.size() > 0) {
-        std::memcpy(&params, input.data(), input.size());
-    }
+    auto params = ReadIoctlParams<IoctlZcullGetCtxSize>(input);
     params.size = 0x1;
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_ctrl_gpu::ZCullGetInfo(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvhost_ctrl_gpu::ZCullGetInfo(IoctlInput input, IoctlOutput output) {
     LOG_DEBUG(Service_NVDRV, "called");
 
-    IoctlNvgpuGpuZcullGetInfoArgs params{};
-
-    if (input.size() > 0) {
-        std::memcpy(&params, input.data(), input.size());
-    }
+    auto params = ReadIoctlParams<IoctlNvgpuGpuZcullGetInfoArgs>(input);
 
     params.width_align_pixels = 0x20;
     params.height_align_pixels = 0x20;
@@ -156,48 +143,44 @@ u32 nvhost_ctrl_gpu::ZCullGetInfo(const std::vector<u8>& input, std::vector<u8>&
     params.subregion_width_align_pixels = 0x20;
     params.subregion_height_align_pixels = 0x40;
     params.subregion_count = 0x10;
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_ctrl_gpu::ZBCSetTable(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvhost_ctrl_gpu::ZBCSetTable(IoctlInput input, IoctlOutput output) {
     LOG_WARNING(Service_NVDRV, "(STUBBED) called");
 
-    IoctlZbcSetTable params{};
-    std::memcpy(&params, input.data(), input.size());
+    auto params = ReadIoctlParams<IoctlZbcSetTable>(input);
     // TODO(ogniK): What does this even actually do?
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_ctrl_gpu::ZBCQueryTable(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvhost_ctrl_gpu::ZBCQueryTable(IoctlInput input, IoctlOutput output) {
     LOG_WARNING(Service_NVDRV, "(STUBBED) called");
 
-    IoctlZbcQueryTable params{};
-    std::memcpy(&params, input.data(), input.size());
+    auto params = ReadIoctlParams<IoctlZbcQueryTable>(input);
     // TODO : To implement properly
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_ctrl_gpu::FlushL2(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvhost_ctrl_gpu::FlushL2(IoctlInput input, IoctlOutput output) {
     LOG_WARNING(Service_NVDRV, "(STUBBED) called");
 
-    IoctlFlushL2 params{};
-    std::memcpy(&params, input.data(), input.size());
+    auto params = ReadIoctlParams<IoctlFlushL2>(input);
     // TODO : To implement properly
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_ctrl_gpu::GetGpuTime(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvhost_ctrl_gpu::GetGpuTime(IoctlInput input, IoctlOutput output) {
     LOG_DEBUG(Service_NVDRV, "called");
 
-    IoctlGetGpuTime params{};
-    std::memcpy(&params, input.data(), input.size());
+    auto params = ReadIoctlParams<IoctlGetGpuTime>(input);
     const auto ns = Core::Timing::CyclesToNs(system.CoreTiming().GetTicks());
     params.gpu_time = static_cast<u64_le>(ns.count());
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
@@ -17,9 +17,8 @@ nvhost_gpu::nvhost_gpu(Core::System& system, std::shared_ptr<nvmap> nvmap_dev)
     : nvdevice(system), nvmap_dev(std::move(nvmap_dev)) {}
 nvhost_gpu::~nvhost_gpu() = default;
 
-u32 nvhost_gpu::ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-                      std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-                      IoctlVersion version) {
+u32 nvhost_gpu::ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+                      IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) {
     LOG_DEBUG(Service_NVDRV, "called, command=0x{:08X}, input_size=0x{:X}, output_size=0x{:X}",
               command.raw, input.size(), output.size());
 
@@ -61,63 +60,58 @@ u32 nvhost_gpu::ioctl(Ioctl command, const std::vector<u8>& input, const std::ve
     return 0;
 };
 
-u32 nvhost_gpu::SetNVMAPfd(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlSetNvmapFD params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_gpu::SetNVMAPfd(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlSetNvmapFD>(input);
     LOG_DEBUG(Service_NVDRV, "called, fd={}", params.nvmap_fd);
 
     nvmap_fd = params.nvmap_fd;
     return 0;
 }
 
-u32 nvhost_gpu::SetClientData(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvhost_gpu::SetClientData(IoctlInput input, IoctlOutput output) {
     LOG_DEBUG(Service_NVDRV, "called");
 
-    IoctlClientData params{};
-    std::memcpy(&params, input.data(), input.size());
+    auto params = ReadIoctlParams<IoctlClientData>(input);
     user_data = params.data;
     return 0;
 }
 
-u32 nvhost_gpu::GetClientData(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvhost_gpu::GetClientData(IoctlInput input, IoctlOutput output) {
     LOG_DEBUG(Service_NVDRV, "called");
 
-    IoctlClientData params{};
-    std::memcpy(&params, input.data(), input.size());
+    auto params = ReadIoctlParams<IoctlClientData>(input);
     params.data = user_data;
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_gpu::ZCullBind(const std::vector<u8>& input, std::vector<u8>& output) {
-    std::memcpy(&zcull_params, input.data(), input.size());
+u32 nvhost_gpu::ZCullBind(IoctlInput input, IoctlOutput output) {
+    zcull_params = ReadIoctlParams<IoctlZCullBind>(input);
     LOG_DEBUG(Service_NVDRV, "called, gpu_va={:X}, mode={:X}", zcull_params.gpu_va,
               zcull_params.mode);
 
-    std::memcpy(output.data(), &zcull_params, output.size());
+    WriteIoctlParams(output, zcull_params);
     return 0;
 }
 
-u32 nvhost_gpu::SetErrorNotifier(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlSetErrorNotifier params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_gpu::SetErrorNotifier(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlSetErrorNotifier>(input);
     LOG_WARNING(Service_NVDRV, "(STUBBED) called, offset={:X}, size={:X}, mem={:X}", params.offset,
                 params.size, params.mem);
 
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_gpu::SetChannelPriority(const std::vector<u8>& input, std::vector<u8>& output) {
-    std::memcpy(&channel_priority, input.data(), input.size());
+u32 nvhost_gpu::SetChannelPriority(IoctlInput input, IoctlOutput output) {
+    channel_priority = ReadIoctlParams<u32_le>(input);
     LOG_DEBUG(Service_NVDRV, "(STUBBED) called, priority={:X}", channel_priority);
 
     return 0;
 }
 
-u32 nvhost_gpu::AllocGPFIFOEx2(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlAllocGpfifoEx2 params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_gpu::AllocGPFIFOEx2(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlAllocGpfifoEx2>(input);
     LOG_WARNING(Service_NVDRV,
                 "(STUBBED) called, num_entries={:X}, flags={:X}, unk0={:X}, "
                 "unk1={:X}, unk2={:X}, unk3={:X}",
@@ -128,27 +122,25 @@ u32 nvhost_gpu::AllocGPFIFOEx2(const std::vector<u8>& input, std::vector<u8>& ou
     params.fence_out.id = assigned_syncpoints;
     params.fence_out.value = gpu.GetSyncpointValue(assigned_syncpoints);
     assigned_syncpoints++;
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_gpu::AllocateObjectContext(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlAllocObjCtx params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_gpu::AllocateObjectContext(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlAllocObjCtx>(input);
     LOG_WARNING(Service_NVDRV, "(STUBBED) called, class_num={:X}, flags={:X}", params.class_num,
                 params.flags);
 
     params.obj_id = 0x0;
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_gpu::SubmitGPFIFO(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvhost_gpu::SubmitGPFIFO(IoctlInput input, IoctlOutput output) {
     if (input.size() < sizeof(IoctlSubmitGpfifo)) {
         UNIMPLEMENTED();
     }
-    IoctlSubmitGpfifo params{};
-    std::memcpy(&params, input.data(), sizeof(IoctlSubmitGpfifo));
+    auto params = ReadIoctlParams<IoctlSubmitGpfifo>(input);
     LOG_TRACE(Service_NVDRV, "called, gpfifo={:X}, num_entries={:X}, flags={:X}", params.address,
               params.num_entries, params.flags.raw);
 
@@ -156,8 +148,9 @@ u32 nvhost_gpu::SubmitGPFIFO(const std::vector<u8>& input, std::vector<u8>& outp
                                    params.num_entries * sizeof(Tegra::CommandListHeader),
                "Incorrect input size");
 
+    // The entries are copied straight from the guest buffer, the GPU may process them later
     Tegra::CommandList entries(params.num_entries);
-    std::memcpy(entries.data(), &input[sizeof(IoctlSubmitGpfifo)],
+    std::memcpy(entries.data(), input.data() + sizeof(IoctlSubmitGpfifo),
                 params.num_entries * sizeof(Tegra::CommandListHeader));
 
     UNIMPLEMENTED_IF(params.flags.add_wait.Value() != 0);
@@ -172,17 +165,16 @@ u32 nvhost_gpu::SubmitGPFIFO(const std::vector<u8>& input, std::vector<u8>& outp
     }
     gpu.PushGPUEntries(std::move(entries));
 
-    std::memcpy(output.data(), &params, sizeof(IoctlSubmitGpfifo));
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_gpu::KickoffPB(const std::vector<u8>& input, std::vector<u8>& output,
-                          const std::vector<u8>& input2, IoctlVersion version) {
+u32 nvhost_gpu::KickoffPB(IoctlInput input, IoctlOutput output, IoctlInput input2,
+                          IoctlVersion version) {
     if (input.size() < sizeof(IoctlSubmitGpfifo)) {
         UNIMPLEMENTED();
     }
-    IoctlSubmitGpfifo params{};
-    std::memcpy(&params, input.data(), sizeof(IoctlSubmitGpfifo));
+    auto params = ReadIoctlParams<IoctlSubmitGpfifo>(input);
     LOG_TRACE(Service_NVDRV, "called, gpfifo={:X}, num_entries={:X}, flags={:X}", params.address,
               params.num_entries, params.flags.raw);
 
@@ -206,23 +198,21 @@ u32 nvhost_gpu::KickoffPB(const std::vector<u8>& input, std::vector<u8>& output,
     }
     gpu.PushGPUEntries(std::move(entries));
 
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_gpu::GetWaitbase(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlGetWaitbase params{};
-    std::memcpy(&params, input.data(), sizeof(IoctlGetWaitbase));
+u32 nvhost_gpu::GetWaitbase(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlGetWaitbase>(input);
     LOG_INFO(Service_NVDRV, "called, unknown=0x{:X}", params.unknown);
 
     params.value = 0; // Seems to be hard coded at 0
-    std::memcpy(output.data(), &params, output.size());
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvhost_gpu::ChannelSetTimeout(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlChannelSetTimeout params{};
-    std::memcpy(&params, input.data(), sizeof(IoctlChannelSetTimeout));
+u32 nvhost_gpu::ChannelSetTimeout(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlChannelSetTimeout>(input);
     LOG_INFO(Service_NVDRV, "called, timeout=0x{:X}", params.timeout);
 
     return 0;
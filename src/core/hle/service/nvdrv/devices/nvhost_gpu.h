@@ -24,9 +24,8 @@ public:
     explicit nvhost_gpu(Core::System& system, std::shared_ptr<nvmap> nvmap_dev);
     ~nvhost_gpu() override;
 
-    u32 ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-              std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-              IoctlVersion version) override;
+    u32 ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+              IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) override;
 
 private:
     enum class IoctlCommand : u32_le {
@@ -175,19 +174,18 @@ private:
     IoctlZCullBind zcull_params{};
     u32_le channel_priority{};
 
-    u32 SetNVMAPfd(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 SetClientData(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 GetClientData(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 ZCullBind(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 SetErrorNotifier(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 SetChannelPriority(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 AllocGPFIFOEx2(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 AllocateObjectContext(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 SubmitGPFIFO(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 KickoffPB(const std::vector<u8>& input, std::vector<u8>& output,
-                  const std::vector<u8>& input2, IoctlVersion version);
-    u32 GetWaitbase(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 ChannelSetTimeout(const std::vector<u8>& input, std::vector<u8>& output);
+    u32 SetNVMAPfd(IoctlInput input, IoctlOutput output);
+    u32 SetClientData(IoctlInput input, IoctlOutput output);
+    u32 GetClientData(IoctlInput input, IoctlOutput output);
+    u32 ZCullBind(IoctlInput input, IoctlOutput output);
+    u32 SetErrorNotifier(IoctlInput input, IoctlOutput output);
+    u32 SetChannelPriority(IoctlInput input, IoctlOutput output);
+    u32 AllocGPFIFOEx2(IoctlInput input, IoctlOutput output);
+    u32 AllocateObjectContext(IoctlInput input, IoctlOutput output);
+    u32 SubmitGPFIFO(IoctlInput input, IoctlOutput output);
+    u32 KickoffPB(IoctlInput input, IoctlOutput output, IoctlInput input2, IoctlVersion version);
+    u32 GetWaitbase(IoctlInput input, IoctlOutput output);
+    u32 ChannelSetTimeout(IoctlInput input, IoctlOutput output);
 
     std::shared_ptr<nvmap> nvmap_dev;
     u32 assigned_syncpoints{};
@@ -0,0 +1,223 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/hle/service/nvdrv/devices/nvhost_nvdec_common.h"
+#include "core/hle/service/nvdrv/devices/nvmap.h"
+#include "video_core/gpu.h"
+#include "video_core/memory_manager.h"
+
+namespace Service::Nvidia::Devices {
+
+namespace {
+
+/// Copies count elements of T starting at offset out of the input, advancing the offset.
+template <typename T>
+std::vector<T> ReadIoctlArray(IoctlInput input, std::size_t& offset, std::size_t count) {
+    std::vector<T> out(count);
+    std::memcpy(out.data(), input.data() + offset, count * sizeof(T));
+    offset += count * sizeof(T);
+    return out;
+}
+
+} // Anonymous namespace
+
+nvhost_nvdec_common::nvhost_nvdec_common(Core::System& system, std::shared_ptr<nvmap> nvmap_dev,
+                                         u32 syncpoint_id)
+    : nvdevice(system), nvmap_dev(std::move(nvmap_dev)), syncpoint_id(syncpoint_id) {}
+nvhost_nvdec_common::~nvhost_nvdec_common() = default;
+
+u32 nvhost_nvdec_common::ioctl(Ioctl command, IoctlInput input, IoctlInput input2,
+                               IoctlOutput output, IoctlOutput output2, IoctlCtrl& ctrl,
+                               IoctlVersion version) {
+    LOG_DEBUG(Service_NVDRV, "called, command=0x{:08X}, input_size=0x{:X}, output_size=0x{:X}",
+              command.raw, input.size(), output.size());
+
+    if (command.group == NVHOST_IOCTL_MAGIC && command.cmd == NVHOST_IOCTL_SET_NVMAP_FD) {
+        return SetNVMAPfd(input, output);
+    }
+
+    if (command.group == NVHOST_IOCTL_CHANNEL_GROUP) {
+        switch (static_cast<IoctlCommand>(command.cmd.Value())) {
+        case IoctlCommand::Submit:
+            return Submit(input, output);
+        case IoctlCommand::GetSyncpoint:
+            return GetSyncpoint(input, output);
+        case IoctlCommand::GetWaitbase:
+            return GetWaitbase(input, output);
+        case IoctlCommand::SetSubmitTimeout:
+            return SetSubmitTimeout(input, output);
+        case IoctlCommand::MapBuffer:
+            return MapBuffer(input, output);
+        case IoctlCommand::UnmapBuffer:
+            return UnmapBuffer(input, output);
+        default:
+            break;
+        }
+    }
+
+    UNIMPLEMENTED_MSG("Unimplemented ioctl");
+    return 0;
+}
+
+u32 nvhost_nvdec_common::SetNVMAPfd(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlSetNvmapFD>(input);
+    LOG_DEBUG(Service_NVDRV, "called, fd={}", params.nvmap_fd);
+
+    nvmap_fd = params.nvmap_fd;
+    return 0;
+}
+
+u32 nvhost_nvdec_common::Submit(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlSubmit>(input);
+    LOG_DEBUG(Service_NVDRV, "called, cmd_buffers={}, relocations={}, syncpoints={}, fences={}",
+              params.cmd_buffer_count, params.relocation_count, params.syncpoint_count,
+              params.fence_count);
+
+    const std::size_t needed_size =
+        sizeof(IoctlSubmit) + params.cmd_buffer_count * sizeof(CommandBuffer) +
+        params.relocation_count * (sizeof(Reloc) + sizeof(u32)) +
+        params.syncpoint_count * sizeof(SyncptIncr) + params.fence_count * sizeof(u32);
+    if (input.size() < needed_size || output.size() < needed_size) {
+        LOG_ERROR(Service_NVDRV, "Submission of 0x{:X} bytes does not fit in 0x{:X} bytes",
+                  needed_size, std::min(input.size(), output.size()));
+        return NvResult::BadParameter;
+    }
+
+    // The command buffers and their relocations are skipped, nothing executes them
+    std::size_t offset = sizeof(IoctlSubmit) + params.cmd_buffer_count * sizeof(CommandBuffer) +
+                         params.relocation_count * (sizeof(Reloc) + sizeof(u32));
+    const auto syncpt_increments =
+        ReadIoctlArray<SyncptIncr>(input, offset, params.syncpoint_count);
+    const std::size_t fences_offset = offset;
+    auto fence_thresholds = ReadIoctlArray<u32_le>(input, offset, params.fence_count);
+
+    // The work of the engine completes as soon as it is submitted
+    auto& gpu = system.GPU();
+    for (std::size_t i = 0; i < syncpt_increments.size(); ++i) {
+        const SyncptIncr& increment = syncpt_increments[i];
+        if (increment.id >= MaxSyncPoints) {
+            LOG_ERROR(Service_NVDRV, "Invalid syncpoint id {}", increment.id);
+            return NvResult::BadParameter;
+        }
+        for (u32 count = 0; count < increment.increments; ++count) {
+            gpu.IncrementSyncPoint(increment.id);
+        }
+        if (i < fence_thresholds.size()) {
+            fence_thresholds[i] = gpu.GetSyncpointValue(increment.id);
+        }
+    }
+
+    std::memmove(output.data(), input.data(), fences_offset);
+    std::memcpy(output.data() + fences_offset, fence_thresholds.data(),
+                fence_thresholds.size() * sizeof(u32_le));
+    return 0;
+}
+
+u32 nvhost_nvdec_common::GetSyncpoint(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlGetSyncpoint>(input);
+    LOG_DEBUG(Service_NVDRV, "called, param={}", params.param);
+
+    params.value = syncpoint_id;
+    WriteIoctlParams(output, params);
+    return 0;
+}
+
+u32 nvhost_nvdec_common::GetWaitbase(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlGetWaitbase>(input);
+    LOG_DEBUG(Service_NVDRV, "called, unknown=0x{:X}", params.unknown);
+
+    params.value = 0; // Seems to be hard coded at 0
+    WriteIoctlParams(output, params);
+    return 0;
+}
+
+u32 nvhost_nvdec_common::SetSubmitTimeout(IoctlInput input, IoctlOutput output) {
+    const auto params = ReadIoctlParams<IoctlSetSubmitTimeout>(input);
+    LOG_DEBUG(Service_NVDRV, "called, timeout={}", params.timeout);
+
+    submit_timeout = params.timeout;
+    return 0;
+}
+
+u32 nvhost_nvdec_common::MapBuffer(IoctlInput input, IoctlOutput output) {
+    const auto params = ReadIoctlParams<IoctlMapBuffer>(input);
+    LOG_DEBUG(Service_NVDRV, "called, num_entries={}", params.num_entries);
+
+    const std::size_t needed_size =
+        sizeof(IoctlMapBuffer) + params.num_entries * sizeof(MapBufferEntry);
+    if (input.size() < needed_size || output.size() < needed_size) {
+        LOG_ERROR(Service_NVDRV, "Mapping of 0x{:X} bytes does not fit in 0x{:X} bytes",
+                  needed_size, std::min(input.size(), output.size()));
+        return NvResult::BadParameter;
+    }
+
+    std::size_t offset = sizeof(IoctlMapBuffer);
+    auto entries = ReadIoctlArray<MapBufferEntry>(input, offset, params.num_entries);
+
+    auto& memory_manager = system.GPU().MemoryManager();
+    for (auto& entry : entries) {
+        const auto object = nvmap_dev->GetObject(entry.map_handle);
+        if (!object) {
+            LOG_ERROR(Service_NVDRV, "Invalid nvmap handle {}", entry.map_handle);
+            return NvResult::BadParameter;
+        }
+
+        // Buffers are mapped once and shared by all the mappings of their handle
+        auto mapping = buffer_mappings.find(entry.map_handle);
+        if (mapping == buffer_mappings.end()) {
+            const GPUVAddr address = memory_manager.MapBufferEx(object->addr, object->size);
+            if (address > std::numeric_limits<u32>::max()) {
+                LOG_ERROR(Service_NVDRV, "Mapping of handle {} at 0x{:X} is out of 32-bit range",
+                          entry.map_handle, address);
+                memory_manager.UnmapBuffer(address, object->size);
+                return NvResult::BadParameter;
+            }
+            const BufferMapping new_mapping{address, object->size};
+            mapping = buffer_mappings.emplace(entry.map_handle, new_mapping).first;
+        }
+        entry.map_address = static_cast<u32>(mapping->second.address);
+    }
+
+    std::memmove(output.data(), input.data(), sizeof(IoctlMapBuffer));
+    std::memcpy(output.data() + sizeof(IoctlMapBuffer), entries.data(),
+                entries.size() * sizeof(MapBufferEntry));
+    return 0;
+}
+
+u32 nvhost_nvdec_common::UnmapBuffer(IoctlInput input, IoctlOutput output) {
+    const auto params = ReadIoctlParams<IoctlMapBuffer>(input);
+    LOG_DEBUG(Service_NVDRV, "called, num_entries={}", params.num_entries);
+
+    const std::size_t needed_size =
+        sizeof(IoctlMapBuffer) + params.num_entries * sizeof(MapBufferEntry);
+    if (input.size() < needed_size) {
+        LOG_ERROR(Service_NVDRV, "Unmapping of 0x{:X} bytes does not fit in 0x{:X} bytes",
+                  needed_size, input.size());
+        return NvResult::BadParameter;
+    }
+
+    std::size_t offset = sizeof(IoctlMapBuffer);
+    const auto entries = ReadIoctlArray<MapBufferEntry>(input, offset, params.num_entries);
+
+    auto& memory_manager = system.GPU().MemoryManager();
+    for (const auto& entry : entries) {
+        const auto mapping = buffer_mappings.find(entry.map_handle);
+        if (mapping == buffer_mappings.end()) {
+            LOG_WARNING(Service_NVDRV, "Handle {} is not mapped", entry.map_handle);
+            continue;
+        }
+        memory_manager.UnmapBuffer(mapping->second.address, mapping->second.size);
+        buffer_mappings.erase(mapping);
+    }
+    return 0;
+}
+
+} // namespace Service::Nvidia::Devices
@@ -0,0 +1,138 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include "common/common_types.h"
+#include "common/swap.h"
+#include "core/hle/service/nvdrv/devices/nvdevice.h"
+
+namespace Service::Nvidia::Devices {
+
+class nvmap;
+
+/**
+ * Host1x channel of one of the multimedia engines, NVDEC or VIC. The channel takes the command
+ * buffers of the guest with the syncpoint increments that signal their completion, and maps the
+ * nvmap buffers the engine reads and writes into its address space.
+ *
+ * The engines themselves are not emulated: the command buffers are dropped and their syncpoint
+ * increments complete right away, so that titles waiting on the engine carry on instead of
+ * stalling, with their output surfaces left untouched.
+ */
+class nvhost_nvdec_common : public nvdevice {
+public:
+    explicit nvhost_nvdec_common(Core::System& system, std::shared_ptr<nvmap> nvmap_dev,
+                                 u32 syncpoint_id);
+    ~nvhost_nvdec_common() override;
+
+    u32 ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+              IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) override;
+
+private:
+    /// Ioctls of the channels have variable sizes, they are identified by their group and number.
+    enum class IoctlCommand : u32 {
+        Submit = 0x1,
+        GetSyncpoint = 0x2,
+        GetWaitbase = 0x3,
+        SetSubmitTimeout = 0x7,
+        MapBuffer = 0x9,
+        UnmapBuffer = 0xA,
+    };
+
+    static constexpr u32 NVHOST_IOCTL_CHANNEL_GROUP = 0x0;
+    static constexpr u32 NVHOST_IOCTL_MAGIC = 'H';
+    static constexpr u32 NVHOST_IOCTL_SET_NVMAP_FD = 0x1;
+
+    struct IoctlSetNvmapFD {
+        u32_le nvmap_fd;
+    };
+    static_assert(sizeof(IoctlSetNvmapFD) == 4, "IoctlSetNvmapFD is incorrect size");
+
+    /// Header of a submission, followed by the arrays it gives the counts of.
+    struct IoctlSubmit {
+        u32_le cmd_buffer_count;
+        u32_le relocation_count;
+        u32_le syncpoint_count;
+        u32_le fence_count;
+    };
+    static_assert(sizeof(IoctlSubmit) == 0x10, "IoctlSubmit is incorrect size");
+
+    struct CommandBuffer {
+        s32_le memory_id;
+        u32_le offset;
+        s32_le word_count;
+    };
+    static_assert(sizeof(CommandBuffer) == 0xC, "CommandBuffer is incorrect size");
+
+    struct Reloc {
+        s32_le cmdbuffer_memory;
+        s32_le cmdbuffer_offset;
+        s32_le target;
+        s32_le target_offset;
+    };
+    static_assert(sizeof(Reloc) == 0x10, "Reloc is incorrect size");
+
+    struct SyncptIncr {
+        u32_le id;
+        u32_le increments;
+    };
+    static_assert(sizeof(SyncptIncr) == 0x8, "SyncptIncr is incorrect size");
+
+    struct IoctlGetSyncpoint {
+        u32_le param;
+        u32_le value;
+    };
+    static_assert(sizeof(IoctlGetSyncpoint) == 0x8, "IoctlGetSyncpoint is incorrect size");
+
+    struct IoctlGetWaitbase {
+        u32_le unknown;
+        u32_le value;
+    };
+    static_assert(sizeof(IoctlGetWaitbase) == 0x8, "IoctlGetWaitbase is incorrect size");
+
+    struct IoctlSetSubmitTimeout {
+        u32_le timeout;
+    };
+    static_assert(sizeof(IoctlSetSubmitTimeout) == 0x4, "IoctlSetSubmitTimeout is incorrect size");
+
+    /// Header of a buffer (un)mapping, followed by num_entries entries.
+    struct IoctlMapBuffer {
+        u32_le num_entries;
+        u32_le data_address; // Ignored by the driver.
+        u32_le attach_host_ch_das;
+    };
+    static_assert(sizeof(IoctlMapBuffer) == 0xC, "IoctlMapBuffer is incorrect size");
+
+    struct MapBufferEntry {
+        u32_le map_handle;
+        u32_le map_address;
+    };
+    static_assert(sizeof(MapBufferEntry) == 0x8, "MapBufferEntry is incorrect size");
+
+    struct BufferMapping {
+        GPUVAddr address;
+        u64 size;
+    };
+
+    u32 SetNVMAPfd(IoctlInput input, IoctlOutput output);
+    u32 Submit(IoctlInput input, IoctlOutput output);
+    u32 GetSyncpoint(IoctlInput input, IoctlOutput output);
+    u32 GetWaitbase(IoctlInput input, IoctlOutput output);
+    u32 SetSubmitTimeout(IoctlInput input, IoctlOutput output);
+    u32 MapBuffer(IoctlInput input, IoctlOutput output);
+    u32 UnmapBuffer(IoctlInput input, IoctlOutput output);
+
+    std::shared_ptr<nvmap> nvmap_dev;
+    const u32 syncpoint_id;
+    u32_le nvmap_fd{};
+    u32_le submit_timeout{};
+
+    /// Address space mappings of the engine, by nvmap handle.
+    std::unordered_map<u32, BufferMapping> buffer_mappings;
+};
+
+} // namespace Service::Nvidia::Devices
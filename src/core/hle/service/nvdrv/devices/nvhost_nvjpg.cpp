@@ -13,9 +13,8 @@ namespace Service::Nvidia::Devices {
 nvhost_nvjpg::nvhost_nvjpg(Core::System& system) : nvdevice(system) {}
 nvhost_nvjpg::~nvhost_nvjpg() = default;
 
-u32 nvhost_nvjpg::ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-                        std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-                        IoctlVersion version) {
+u32 nvhost_nvjpg::ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+                        IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) {
     LOG_DEBUG(Service_NVDRV, "called, command=0x{:08X}, input_size=0x{:X}, output_size=0x{:X}",
               command.raw, input.size(), output.size());
 
@@ -28,9 +27,8 @@ u32 nvhost_nvjpg::ioctl(Ioctl command, const std::vector<u8>& input, const std::
     return 0;
 }
 
-u32 nvhost_nvjpg::SetNVMAPfd(const std::vector<u8>& input, std::vector<u8>& output) {
-    IoctlSetNvmapFD params{};
-    std::memcpy(&params, input.data(), input.size());
+u32 nvhost_nvjpg::SetNVMAPfd(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IoctlSetNvmapFD>(input);
     LOG_DEBUG(Service_NVDRV, "called, fd={}", params.nvmap_fd);
 
     nvmap_fd = params.nvmap_fd;
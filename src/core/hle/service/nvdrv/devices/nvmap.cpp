@@ -28,9 +28,8 @@ VAddr nvmap::GetObjectAddress(u32 handle) const {
     return object->addr;
 }
 
-u32 nvmap::ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-                 std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-                 IoctlVersion version) {
+u32 nvmap::ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+                 IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) {
     switch (static_cast<IoctlCommand>(command.raw)) {
     case IoctlCommand::Create:
         return IocCreate(input, output);
@@ -50,9 +49,8 @@ u32 nvmap::ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<
     return 0;
 }
 
-u32 nvmap::IocCreate(const std::vector<u8>& input, std::vector<u8>& output) {
-    IocCreateParams params;
-    std::memcpy(&params, input.data(), sizeof(params));
+u32 nvmap::IocCreate(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IocCreateParams>(input);
     LOG_DEBUG(Service_NVDRV, "size=0x{:08X}", params.size);
 
     if (!params.size) {
@@ -71,13 +69,12 @@ u32 nvmap::IocCreate(const std::vector<u8>& input, std::vector<u8>& output) {
 
     params.handle = handle;
 
-    std::memcpy(output.data(), &params, sizeof(params));
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvmap::IocAlloc(const std::vector<u8>& input, std::vector<u8>& output) {
-    IocAllocParams params;
-    std::memcpy(&params, input.data(), sizeof(params));
+u32 nvmap::IocAlloc(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IocAllocParams>(input);
     LOG_DEBUG(Service_NVDRV, "called, addr={:X}", params.addr);
 
     if (!params.handle) {
@@ -112,13 +109,12 @@ u32 nvmap::IocAlloc(const std::vector<u8>& input, std::vector<u8>& output) {
     object->addr = params.addr;
     object->status = Object::Status::Allocated;
 
-    std::memcpy(output.data(), &params, sizeof(params));
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvmap::IocGetId(const std::vector<u8>& input, std::vector<u8>& output) {
-    IocGetIdParams params;
-    std::memcpy(&params, input.data(), sizeof(params));
+u32 nvmap::IocGetId(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IocGetIdParams>(input);
 
     LOG_WARNING(Service_NVDRV, "called");
 
@@ -135,13 +131,12 @@ u32 nvmap::IocGetId(const std::vector<u8>& input, std::vector<u8>& output) {
 
     params.id = object->id;
 
-    std::memcpy(output.data(), &params, sizeof(params));
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvmap::IocFromId(const std::vector<u8>& input, std::vector<u8>& output) {
-    IocFromIdParams params;
-    std::memcpy(&params, input.data(), sizeof(params));
+u32 nvmap::IocFromId(IoctlInput input, IoctlOutput output) {
+    auto params = ReadIoctlParams<IocFromIdParams>(input);
 
     LOG_WARNING(Service_NVDRV, "(STUBBED) called");
 
@@ -163,15 +158,14 @@ u32 nvmap::IocFromId(const std::vector<u8>& input, std::vector<u8>& output) {
     // Return the existing handle instead of creating a new one.
     params.handle = itr->first;
 
-    std::memcpy(output.data(), &params, sizeof(params));
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvmap::IocParam(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvmap::IocParam(IoctlInput input, IoctlOutput output) {
     enum class ParamTypes { Size = 1, Alignment = 2, Base = 3, Heap = 4, Kind = 5, Compr = 6 };
 
-    IocParamParams params;
-    std::memcpy(&params, input.data(), sizeof(params));
+    auto params = ReadIoctlParams<IocParamParams>(input);
 
     LOG_WARNING(Service_NVDRV, "(STUBBED) called type={}", params.param);
 
@@ -204,19 +198,18 @@ u32 nvmap::IocParam(const std::vector<u8>& input, std::vector<u8>& output) {
         UNIMPLEMENTED();
     }
 
-    std::memcpy(output.data(), &params, sizeof(params));
+    WriteIoctlParams(output, params);
     return 0;
 }
 
-u32 nvmap::IocFree(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvmap::IocFree(IoctlInput input, IoctlOutput output) {
     // TODO(Subv): These flags are unconfirmed.
     enum FreeFlags {
         Freed = 0,
         NotFreedYet = 1,
     };
 
-    IocFreeParams params;
-    std::memcpy(&params, input.data(), sizeof(params));
+    auto params = ReadIoctlParams<IocFreeParams>(input);
 
     LOG_WARNING(Service_NVDRV, "(STUBBED) called");
 
@@ -249,7 +242,7 @@ u32 nvmap::IocFree(const std::vector<u8>& input, std::vector<u8>& output) {
 
     handles.erase(params.handle);
 
-    std::memcpy(output.data(), &params, sizeof(params));
+    WriteIoctlParams(output, params);
     return 0;
 }
 
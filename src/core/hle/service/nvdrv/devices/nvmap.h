@@ -22,9 +22,8 @@ public:
     /// Returns the allocated address of an nvmap object given its handle.
     VAddr GetObjectAddress(u32 handle) const;
 
-    u32 ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-              std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-              IoctlVersion version) override;
+    u32 ioctl(Ioctl command, IoctlInput input, IoctlInput input2, IoctlOutput output,
+              IoctlOutput output2, IoctlCtrl& ctrl, IoctlVersion version) override;
 
     /// Represents an nvmap object.
     struct Object {
@@ -119,12 +118,12 @@ private:
     };
     static_assert(sizeof(IocGetIdParams) == 8, "IocGetIdParams has wrong size");
 
-    u32 IocCreate(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 IocAlloc(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 IocGetId(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 IocFromId(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 IocParam(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 IocFree(const std::vector<u8>& input, std::vector<u8>& output);
+    u32 IocCreate(IoctlInput input, IoctlOutput output);
+    u32 IocAlloc(IoctlInput input, IoctlOutput output);
+    u32 IocGetId(IoctlInput input, IoctlOutput output);
+    u32 IocFromId(IoctlInput input, IoctlOutput output);
+    u32 IocParam(IoctlInput input, IoctlOutput output);
+    u32 IocFree(IoctlInput input, IoctlOutput output);
 };
 
 } // namespace Service::Nvidia::Devices
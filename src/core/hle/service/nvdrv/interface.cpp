@@ -38,51 +38,54 @@ void NVDRV::IoctlBase(Kernel::HLERequestContext& ctx, IoctlVersion version) {
     u32 fd = rp.Pop<u32>();
     u32 command = rp.Pop<u32>();
 
-    /// Ioctl 3 has 2 outputs, first in the input params, second is the result
-    std::vector<u8> output(ctx.GetWriteBufferSize(0));
-    std::vector<u8> output2;
-    if (version == IoctlVersion::Version3) {
-        output2.resize((ctx.GetWriteBufferSize(1)));
-    }
-
-    /// Ioctl2 has 2 inputs. It's used to pass data directly instead of providing a pointer.
-    /// KickOfPB uses this
-    auto input = ctx.ReadBuffer(0);
+    // The buffers are handed to the device as views of the IPC buffers, so that the typical small
+    // ioctl and the GPFIFO submissions don't copy them to and from vectors
+    const auto get_input2 = [version](const Kernel::HLERequestContext& ctx) {
+        // Ioctl2 has 2 inputs. It's used to pass data directly instead of providing a pointer.
+        // KickOfPB uses this
+        return version == IoctlVersion::Version2 ? ctx.ReadBufferSpan(1) : IoctlInput{};
+    };
+    const auto get_output2 = [version](const Kernel::HLERequestContext& ctx) {
+        // Ioctl 3 has 2 outputs, first in the input params, second is the result
+        return version == IoctlVersion::Version3 ? ctx.WriteBufferSpan(1) : IoctlOutput{};
+    };
+    const auto write_outputs = [version](const Kernel::HLERequestContext& ctx, IoctlOutput output,
+                                         IoctlOutput output2) {
+        ctx.WriteBuffer(output.data(), output.size());
+        if (version == IoctlVersion::Version3) {
+            ctx.WriteBuffer(output2.data(), output2.size(), 1);
+        }
+    };
 
-    std::vector<u8> input2;
-    if (version == IoctlVersion::Version2) {
-        input2 = ctx.ReadBuffer(1);
-    }
+    const IoctlOutput output = ctx.WriteBufferSpan(0);
+    const IoctlOutput output2 = get_output2(ctx);
 
     IoctlCtrl ctrl{};
 
-    u32 result = nvdrv->Ioctl(fd, command, input, input2, output, output2, ctrl, version);
+    u32 result = nvdrv->Ioctl(fd, command, ctx.ReadBufferSpan(0), get_input2(ctx), output, output2,
+                              ctrl, version);
 
     if (ctrl.must_delay) {
         ctrl.fresh_call = false;
-        ctx.SleepClientThread("NVServices::DelayedResponse", ctrl.timeout,
-                              [=](Kernel::SharedPtr<Kernel::Thread> thread,
-                                  Kernel::HLERequestContext& ctx,
-                                  Kernel::ThreadWakeupReason reason) {
-                                  IoctlCtrl ctrl2{ctrl};
-                                  std::vector<u8> tmp_output = output;
-                                  std::vector<u8> tmp_output2 = output2;
-                                  u32 result = nvdrv->Ioctl(fd, command, input, input2, tmp_output,
-                                                            tmp_output2, ctrl2, version);
-                                  ctx.WriteBuffer(tmp_output, 0);
-                                  if (version == IoctlVersion::Version3) {
-                                      ctx.WriteBuffer(tmp_output2, 1);
-                                  }
-                                  IPC::ResponseBuilder rb{ctx, 3};
-                                  rb.Push(RESULT_SUCCESS);
-                                  rb.Push(result);
-                              },
-                              nvdrv->GetEventWriteable(ctrl.event_id));
+        ctx.SleepClientThread(
+            "NVServices::DelayedResponse", ctrl.timeout,
+            [=](Kernel::SharedPtr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                Kernel::ThreadWakeupReason reason) {
+                // The views are taken again, the ones of the first call may point into buffers
+                // owned by the context it was made with
+                IoctlCtrl ctrl2{ctrl};
+                const IoctlOutput delayed_output = ctx.WriteBufferSpan(0);
+                const IoctlOutput delayed_output2 = get_output2(ctx);
+                u32 result = nvdrv->Ioctl(fd, command, ctx.ReadBufferSpan(0), get_input2(ctx),
+                                          delayed_output, delayed_output2, ctrl2, version);
+                write_outputs(ctx, delayed_output, delayed_output2);
+                IPC::ResponseBuilder rb{ctx, 3};
+                rb.Push(RESULT_SUCCESS);
+                rb.Push(result);
+            },
+            nvdrv->GetEventWriteable(ctrl.event_id));
     } else {
-        ctx.WriteBuffer(output);
-        if (version == IoctlVersion::Version3) {
-            ctx.WriteBuffer(output2, 1);
-        }
+        write_outputs(ctx, output, output2);
     }
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(RESULT_SUCCESS);
@@ -2,6 +2,7 @@
 
 #include <array>
 #include "common/common_types.h"
+#include "core/hle/kernel/hle_ipc.h"
 
 namespace Service::Nvidia {
 
@@ -51,4 +52,9 @@ struct IoctlCtrl {
     s32 event_id{-1};
 };
 
+/// Views of the buffers of an ioctl. They point into the IPC buffers of the guest when these are
+/// contiguous in host memory, in which case the input and the output are often the same memory.
+using IoctlInput = Kernel::BufferSpan<const u8>;
+using IoctlOutput = Kernel::BufferSpan<u8>;
+
 } // namespace Service::Nvidia
@@ -8,6 +8,7 @@
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "common/microprofile_trace.h"
 #include "common/scope_exit.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -28,6 +29,7 @@ namespace Service::NVFlinger {
 
 constexpr s64 frame_ticks = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 60);
 constexpr s64 frame_ticks_30fps = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 30);
+constexpr s64 present_poll_ticks = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 1000);
 
 NVFlinger::NVFlinger(Core::System& system) : system(system) {
     displays.emplace_back(0, "Default", system);
@@ -39,6 +41,13 @@ NVFlinger::NVFlinger(Core::System& system) : system(system) {
     // Schedule the screen composition events
     composition_event = system.CoreTiming().RegisterEvent(
         "ScreenComposition", [this](u64 userdata, s64 cycles_late) {
+            if (Settings::values.use_host_vsync && !IsLastFramePresented()) {
+                // The vblank waits for the host to present the last frame, emulated time keeps
+                // going while the host catches up
+                this->system.CoreTiming().ScheduleEvent(
+                    std::max<s64>(0LL, present_poll_ticks - cycles_late), composition_event);
+                return;
+            }
             Compose();
             const auto ticks =
                 Settings::values.force_30fps_mode ? frame_ticks_30fps : GetNextTicks();
@@ -57,6 +66,10 @@ void NVFlinger::SetNVDrvInstance(std::shared_ptr<Nvidia::Module> instance) {
     nvdrv = std::move(instance);
 }
 
+void NVFlinger::SetVsyncInputCallback(std::function<void()> callback) {
+    vsync_input_callback = std::move(callback);
+}
+
 std::optional<u64> NVFlinger::OpenDisplay(std::string_view name) {
     LOG_DEBUG(Service, "Opening \"{}\" display", name);
 
@@ -171,7 +184,13 @@ const VI::Layer* NVFlinger::FindLayer(u64 display_id, u64 layer_id) const {
 void NVFlinger::Compose() {
     for (auto& display : displays) {
         // Trigger vsync for this display at the end of drawing
-        SCOPE_EXIT({ display.SignalVSyncEvent(); });
+        SCOPE_EXIT({
+            // The input is sampled as late as possible before the guest wakes up to read it
+            if (vsync_input_callback && &display == &displays.front()) {
+                vsync_input_callback();
+            }
+            display.SignalVSyncEvent();
+        });
 
         // Don't do anything for displays without layers.
         if (!display.HasLayers())
@@ -185,6 +204,7 @@ void NVFlinger::Compose() {
         auto buffer = buffer_queue.AcquireBuffer();
 
         MicroProfileFlip();
+        Common::WriteProfileTrace();
 
         if (!buffer) {
             continue;
@@ -210,10 +230,15 @@ void NVFlinger::Compose() {
                      buffer->get().transform, buffer->get().crop_rect);
 
         swap_interval = buffer->get().swap_interval;
+        ++composed_frames;
         buffer_queue.ReleaseBuffer(buffer->get().slot);
     }
 }
 
+bool NVFlinger::IsLastFramePresented() const {
+    return system.Renderer().GetFinishedFrames() >= composed_frames;
+}
+
 s64 NVFlinger::GetNextTicks() const {
     constexpr s64 max_hertz = 120LL;
     return (Core::Timing::BASE_CLOCK_RATE * (1LL << swap_interval)) / max_hertz;
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -44,6 +45,10 @@ public:
     /// Sets the NVDrv module instance to use to send buffers to the GPU.
     void SetNVDrvInstance(std::shared_ptr<Nvidia::Module> instance);
 
+    /// Sets a function run right before the vsync events are signaled, which is when the guest
+    /// wakes up to read its input. An empty function removes it.
+    void SetVsyncInputCallback(std::function<void()> callback);
+
     /// Opens the specified display and returns the ID.
     ///
     /// If an invalid display name is provided, then an empty optional is returned.
@@ -89,6 +94,9 @@ private:
     /// Finds the layer identified by the specified ID in the desired display.
     const VI::Layer* FindLayer(u64 display_id, u64 layer_id) const;
 
+    /// Returns whether the renderer finished presenting every frame composed so far.
+    bool IsLastFramePresented() const;
+
     std::shared_ptr<Nvidia::Module> nvdrv;
 
     std::vector<VI::Display> displays;
@@ -102,6 +110,12 @@ private:
 
     u32 swap_interval = 1;
 
+    std::function<void()> vsync_input_callback;
+
+    /// Number of frames sent to the renderer, compared with the ones it finished to pace vsync on
+    /// the host presentation.
+    u64 composed_frames = 0;
+
     /// Event that handles screen composition.
     Core::Timing::EventType* composition_event;
 
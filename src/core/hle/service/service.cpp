@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <optional>
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -68,7 +69,10 @@
 #include "core/hle/service/usb/usb.h"
 #include "core/hle/service/vi/vi.h"
 #include "core/hle/service/wlan/wlan.h"
+#include "core/perf_stats.h"
 #include "core/reporter.h"
+#include "core/tools/ipc_trace.h"
+#include "core/tools/profiler.h"
 
 namespace Service {
 
@@ -162,10 +166,37 @@ void ServiceFrameworkBase::InvokeRequest(Kernel::HLERequestContext& ctx) {
     }
 
     LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName(), ctx.CommandBuffer()));
+
+    auto& system = Core::System::GetInstance();
+    Tools::Profiler* const profiler = system.GetProfiler();
+    Tools::IpcTrace* const ipc_trace = system.GetIpcTrace();
+    if (profiler == nullptr && ipc_trace == nullptr) {
+        handler_invoker(this, info->handler_callback, ctx);
+        return;
+    }
+
+    std::optional<Tools::IpcTrace::Request> request;
+    if (ipc_trace != nullptr) {
+        request = Tools::IpcTrace::Capture(ctx, service_name);
+    }
+    const auto begin = Tools::Profiler::Clock::now();
     handler_invoker(this, info->handler_callback, ctx);
+    const auto time = Tools::Profiler::Clock::now() - begin;
+
+    if (profiler != nullptr) {
+        profiler->AddServiceTime(system.CurrentCoreIndex(), system.CurrentArmInterface(),
+                                 service_name, info->name, time);
+    }
+    if (request) {
+        request->time = time;
+        ipc_trace->Record(*request);
+    }
 }
 
 ResultCode ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context) {
+    const Core::PerfTimer timer{Core::System::GetInstance().GetPerfStats(),
+                                Core::PerfCategory::Service};
+
     switch (context.GetCommandType()) {
     case IPC::CommandType::Close: {
         IPC::ResponseBuilder rb{context, 2};
@@ -222,7 +253,7 @@ void Init(std::shared_ptr<SM::ServiceManager>& sm, Core::System& system) {
     Friend::InstallInterfaces(*sm, system);
     Glue::InstallInterfaces(system);
     GRC::InstallInterfaces(*sm);
-    HID::InstallInterfaces(*sm, system);
+    HID::InstallInterfaces(*sm, nv_flinger, system);
     LBL::InstallInterfaces(*sm);
     LDN::InstallInterfaces(*sm);
     LDR::InstallInterfaces(*sm, system);
@@ -246,7 +277,7 @@ void Init(std::shared_ptr<SM::ServiceManager>& sm, Core::System& system) {
     PSC::InstallInterfaces(*sm);
     PSM::InstallInterfaces(*sm);
     Set::InstallInterfaces(*sm);
-    Sockets::InstallInterfaces(*sm);
+    Sockets::InstallInterfaces(*sm, system);
     SPL::InstallInterfaces(*sm);
     SSL::InstallInterfaces(*sm);
     Time::InstallInterfaces(system);
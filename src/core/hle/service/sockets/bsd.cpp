@@ -2,11 +2,110 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "common/logging/log.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/service/sockets/bsd.h"
+#include "core/hle/service/sockets/network_reactor.h"
 
 namespace Service::Sockets {
 
+namespace {
+
+/// Flags of the type of Socket, the options they set are left to Fcntl and SetSockOpt.
+constexpr u32 FLAG_SOCK_NONBLOCK = 0x20000000;
+constexpr u32 FLAG_SOCK_CLOEXEC = 0x10000000;
+
+/// Size of a read buffer of the request, 0 if the request has no such buffer.
+std::size_t GetReadBufferSize(const Kernel::HLERequestContext& ctx, std::size_t index) {
+    const auto& buffers_a = ctx.BufferDescriptorA();
+    const auto& buffers_x = ctx.BufferDescriptorX();
+    if (!buffers_a.empty() && index >= buffers_a.size()) {
+        return 0;
+    }
+    if (!buffers_a.empty() && buffers_a[index].Size() != 0) {
+        return buffers_a[index].Size();
+    }
+    return index < buffers_x.size() ? buffers_x[index].Size() : 0;
+}
+
+/// Size of a write buffer of the request, 0 if the request has no such buffer.
+std::size_t GetWriteBufferSize(const Kernel::HLERequestContext& ctx, std::size_t index) {
+    const auto& buffers_b = ctx.BufferDescriptorB();
+    const auto& buffers_c = ctx.BufferDescriptorC();
+    if (!buffers_b.empty() && index >= buffers_b.size()) {
+        return 0;
+    }
+    if (!buffers_b.empty() && buffers_b[index].Size() != 0) {
+        return buffers_b[index].Size();
+    }
+    return index < buffers_c.size() ? buffers_c[index].Size() : 0;
+}
+
+/// Copies a value from the start of a read buffer, returns false if the buffer is too small.
+template <typename T>
+bool ReadBufferValue(const Kernel::HLERequestContext& ctx, std::size_t index, T& value) {
+    if (GetReadBufferSize(ctx, index) < sizeof(T)) {
+        return false;
+    }
+    const std::vector<u8> buffer = ctx.ReadBuffer(static_cast<int>(index));
+    std::memcpy(&value, buffer.data(), sizeof(T));
+    return true;
+}
+
+/// Writes a value to a write buffer if it fits, returns the size written.
+template <typename T>
+u32 WriteBufferValue(Kernel::HLERequestContext& ctx, std::size_t index, const T& value) {
+    if (GetWriteBufferSize(ctx, index) < sizeof(T)) {
+        return 0;
+    }
+    ctx.WriteBuffer(&value, sizeof(T), static_cast<int>(index));
+    return sizeof(T);
+}
+
+std::pair<s32, Errno> FromErrno(Errno bsd_errno) {
+    return {bsd_errno == Errno::SUCCESS ? 0 : -1, bsd_errno};
+}
+
+void WriteResult(Kernel::HLERequestContext& ctx, std::pair<s32, Errno> result) {
+    IPC::ResponseBuilder rb{ctx, 4};
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<s32>(result.first);
+    rb.PushEnum(result.second);
+}
+
+/// Writes the result of the functions returning the length of an address or option.
+void WriteResultWithLength(Kernel::HLERequestContext& ctx, std::pair<s32, Errno> result,
+                           u32 length) {
+    IPC::ResponseBuilder rb{ctx, 5};
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<s32>(result.first);
+    rb.PushEnum(result.second);
+    rb.Push<u32>(length);
+}
+
+/// Converts a timeout of SO_RCVTIMEO or SO_SNDTIMEO, where zero waits forever.
+s32 TimevalToMilliseconds(const Timeval& timeval) {
+    if (timeval.sec == 0 && timeval.usec == 0) {
+        return -1;
+    }
+    const s64 milliseconds = timeval.sec * 1000 + (timeval.usec + 999) / 1000;
+    return static_cast<s32>(std::clamp<s64>(milliseconds, 0, std::numeric_limits<s32>::max()));
+}
+
+Timeval MillisecondsToTimeval(s32 milliseconds) {
+    if (milliseconds < 0) {
+        return {};
+    }
+    return {milliseconds / 1000, (milliseconds % 1000) * 1000};
+}
+
+} // Anonymous namespace
+
 void BSD::RegisterClient(Kernel::HLERequestContext& ctx) {
     LOG_WARNING(Service, "(STUBBED) called");
 
@@ -26,53 +125,583 @@ void BSD::StartMonitoring(Kernel::HLERequestContext& ctx) {
 
 void BSD::Socket(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp{ctx};
+    const auto domain = rp.PopEnum<Domain>();
+    const u32 raw_type = rp.Pop<u32>();
+    const auto protocol = rp.PopEnum<Protocol>();
 
-    u32 domain = rp.Pop<u32>();
-    u32 type = rp.Pop<u32>();
-    u32 protocol = rp.Pop<u32>();
+    LOG_DEBUG(Service, "called, domain={} type=0x{:X} protocol={}", static_cast<u32>(domain),
+              raw_type, static_cast<u32>(protocol));
 
-    LOG_WARNING(Service, "(STUBBED) called domain={} type={} protocol={}", domain, type, protocol);
+    const s32 fd = FindFreeDescriptor();
+    if (fd < 0) {
+        WriteResult(ctx, FromErrno(Errno::MFILE));
+        return;
+    }
+    const auto type = static_cast<Type>(raw_type & ~(FLAG_SOCK_NONBLOCK | FLAG_SOCK_CLOEXEC));
+    const auto [handle, bsd_errno] = Host::Open(domain, type, protocol);
+    if (bsd_errno != Errno::SUCCESS) {
+        WriteResult(ctx, FromErrno(bsd_errno));
+        return;
+    }
 
-    u32 fd = next_fd++;
+    FileDescriptor descriptor;
+    descriptor.handle = handle;
+    descriptor.is_non_blocking = (raw_type & FLAG_SOCK_NONBLOCK) != 0;
+    file_descriptors[fd] = descriptor;
+    WriteResult(ctx, {fd, Errno::SUCCESS});
+}
 
-    IPC::ResponseBuilder rb{ctx, 4};
+void BSD::Poll(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 nfds = rp.Pop<s32>();
+    const s32 timeout = rp.Pop<s32>();
 
-    rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(fd);
-    rb.Push<u32>(0); // bsd errno
+    LOG_DEBUG(Service, "called, nfds={} timeout={}", nfds, timeout);
+
+    const std::size_t size = static_cast<std::size_t>(std::max(nfds, 0)) * sizeof(PollFD);
+    if (nfds < 0 || nfds > static_cast<s32>(MAX_FD) || GetReadBufferSize(ctx, 0) < size ||
+        GetWriteBufferSize(ctx, 0) < size) {
+        WriteResult(ctx, FromErrno(Errno::INVAL));
+        return;
+    }
+
+    const auto fds = std::make_shared<std::vector<PollFD>>(nfds);
+    if (nfds != 0) {
+        std::memcpy(fds->data(), ctx.ReadBuffer().data(), size);
+    }
+
+    // Closed descriptors are ready right away, the others are polled on the host
+    std::vector<Host::PollEntry> entries;
+    std::vector<std::size_t> entry_indices;
+    s32 num_invalid = 0;
+    for (std::size_t i = 0; i < fds->size(); ++i) {
+        PollFD& pollfd = (*fds)[i];
+        pollfd.revents = 0;
+        if (pollfd.fd < 0) {
+            continue;
+        }
+        const FileDescriptor* const descriptor = GetDescriptor(pollfd.fd);
+        if (descriptor == nullptr) {
+            pollfd.revents = POLLFD_NVAL;
+            ++num_invalid;
+            continue;
+        }
+        entries.push_back({descriptor->handle, pollfd.events, 0});
+        entry_indices.push_back(i);
+    }
+
+    const auto update = [fds, entry_indices, num_invalid](
+                            const std::vector<Host::PollEntry>& polled_entries) {
+        s32 num_ready = num_invalid;
+        for (std::size_t i = 0; i < polled_entries.size(); ++i) {
+            PollFD& pollfd = (*fds)[entry_indices[i]];
+            pollfd.revents = polled_entries[i].revents;
+            num_ready += pollfd.revents != 0 ? 1 : 0;
+        }
+        return num_ready;
+    };
+    const Respond respond = [fds](Kernel::HLERequestContext& ctx, OperationResult result) {
+        if (!fds->empty()) {
+            ctx.WriteBuffer(*fds);
+        }
+        WriteResult(ctx, result);
+    };
+
+    s32 num_ready = num_invalid;
+    if (!entries.empty()) {
+        const auto [count, bsd_errno] = Host::Poll(entries, 0);
+        if (bsd_errno != Errno::SUCCESS) {
+            respond(ctx, FromErrno(bsd_errno));
+            return;
+        }
+        num_ready = update(entries);
+    }
+    if (num_ready != 0 || timeout == 0) {
+        respond(ctx, {num_ready, Errno::SUCCESS});
+        return;
+    }
+
+    const auto result = std::make_shared<OperationResult>(0, Errno::SUCCESS);
+    reactor->Wait(
+        ctx, std::move(entries), timeout,
+        [update, result](NetworkReactor::WakeReason reason,
+                         std::vector<Host::PollEntry>& polled_entries) {
+            result->first = update(polled_entries);
+            return true;
+        },
+        [respond, result](Kernel::HLERequestContext& ctx) { respond(ctx, *result); });
 }
 
-void BSD::Connect(Kernel::HLERequestContext& ctx) {
-    LOG_WARNING(Service, "(STUBBED) called");
+void BSD::Recv(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const u32 flags = rp.Pop<u32>();
 
-    IPC::ResponseBuilder rb{ctx, 4};
+    LOG_DEBUG(Service, "called, fd={} flags=0x{:X}", fd, flags);
+    RecvImpl(ctx, fd, flags, false);
+}
 
-    rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(0); // ret
-    rb.Push<u32>(0); // bsd errno
+void BSD::RecvFrom(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const u32 flags = rp.Pop<u32>();
+
+    LOG_DEBUG(Service, "called, fd={} flags=0x{:X}", fd, flags);
+    RecvImpl(ctx, fd, flags, true);
+}
+
+void BSD::Send(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const u32 flags = rp.Pop<u32>();
+
+    LOG_DEBUG(Service, "called, fd={} flags=0x{:X}", fd, flags);
+    SendImpl(ctx, fd, flags, false);
 }
 
 void BSD::SendTo(Kernel::HLERequestContext& ctx) {
-    LOG_WARNING(Service, "(STUBBED) called");
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const u32 flags = rp.Pop<u32>();
 
-    IPC::ResponseBuilder rb{ctx, 4};
+    LOG_DEBUG(Service, "called, fd={} flags=0x{:X}", fd, flags);
+    SendImpl(ctx, fd, flags, true);
+}
 
-    rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(0); // ret
-    rb.Push<u32>(0); // bsd errno
+void BSD::Accept(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called, fd={}", fd);
+
+    const FileDescriptor* const descriptor = GetDescriptor(fd);
+    if (descriptor == nullptr) {
+        WriteResultWithLength(ctx, FromErrno(Errno::BADF), 0);
+        return;
+    }
+
+    struct Accepted {
+        Host::Handle handle = Host::INVALID_HANDLE;
+        SockAddrIn addr{};
+    };
+    const auto accepted = std::make_shared<Accepted>();
+    const Host::Handle listen_handle = descriptor->handle;
+    Operation operation = [listen_handle, accepted] {
+        const auto [handle, bsd_errno] = Host::Accept(listen_handle, &accepted->addr);
+        accepted->handle = handle;
+        return FromErrno(bsd_errno);
+    };
+
+    // The descriptor of the connection is allocated on the CPU thread, along with the others
+    Respond respond = [this, accepted](Kernel::HLERequestContext& ctx, OperationResult result) {
+        if (result.second != Errno::SUCCESS) {
+            WriteResultWithLength(ctx, result, 0);
+            return;
+        }
+        const s32 new_fd = FindFreeDescriptor();
+        if (new_fd < 0) {
+            Host::Close(accepted->handle);
+            WriteResultWithLength(ctx, FromErrno(Errno::MFILE), 0);
+            return;
+        }
+        FileDescriptor new_descriptor;
+        new_descriptor.handle = accepted->handle;
+        file_descriptors[new_fd] = new_descriptor;
+        const u32 addr_length = WriteBufferValue(ctx, 0, accepted->addr);
+        WriteResultWithLength(ctx, {new_fd, Errno::SUCCESS}, addr_length);
+    };
+
+    ExecuteBlocking(ctx, *descriptor, 0, POLLFD_IN, descriptor->recv_timeout_ms,
+                    std::move(operation), std::move(respond));
+}
+
+void BSD::Bind(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called, fd={}", fd);
+
+    const FileDescriptor* const descriptor = GetDescriptor(fd);
+    SockAddrIn addr;
+    if (descriptor == nullptr) {
+        WriteResult(ctx, FromErrno(Errno::BADF));
+    } else if (!ReadBufferValue(ctx, 0, addr)) {
+        WriteResult(ctx, FromErrno(Errno::INVAL));
+    } else {
+        WriteResult(ctx, FromErrno(Host::Bind(descriptor->handle, addr)));
+    }
+}
+
+void BSD::Connect(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called, fd={}", fd);
+
+    const FileDescriptor* const descriptor = GetDescriptor(fd);
+    SockAddrIn addr;
+    if (descriptor == nullptr) {
+        WriteResult(ctx, FromErrno(Errno::BADF));
+        return;
+    }
+    if (!ReadBufferValue(ctx, 0, addr)) {
+        WriteResult(ctx, FromErrno(Errno::INVAL));
+        return;
+    }
+
+    const Host::Handle handle = descriptor->handle;
+    const Errno bsd_errno = Host::Connect(handle, addr);
+    if (bsd_errno != Errno::INPROGRESS || descriptor->is_non_blocking) {
+        WriteResult(ctx, FromErrno(bsd_errno));
+        return;
+    }
+
+    // Blocking connections complete when the socket becomes writable
+    WaitFor(
+        ctx, handle, POLLFD_OUT, -1, [handle] { return FromErrno(Host::GetPendingError(handle)); },
+        [](Kernel::HLERequestContext& ctx, OperationResult result) { WriteResult(ctx, result); });
+}
+
+void BSD::GetPeerName(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called, fd={}", fd);
+
+    const FileDescriptor* const descriptor = GetDescriptor(fd);
+    if (descriptor == nullptr) {
+        WriteResultWithLength(ctx, FromErrno(Errno::BADF), 0);
+        return;
+    }
+    SockAddrIn addr{};
+    const Errno bsd_errno = Host::GetPeerName(descriptor->handle, addr);
+    const u32 addr_length = bsd_errno == Errno::SUCCESS ? WriteBufferValue(ctx, 0, addr) : 0;
+    WriteResultWithLength(ctx, FromErrno(bsd_errno), addr_length);
+}
+
+void BSD::GetSockName(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called, fd={}", fd);
+
+    const FileDescriptor* const descriptor = GetDescriptor(fd);
+    if (descriptor == nullptr) {
+        WriteResultWithLength(ctx, FromErrno(Errno::BADF), 0);
+        return;
+    }
+    SockAddrIn addr{};
+    const Errno bsd_errno = Host::GetSockName(descriptor->handle, addr);
+    const u32 addr_length = bsd_errno == Errno::SUCCESS ? WriteBufferValue(ctx, 0, addr) : 0;
+    WriteResultWithLength(ctx, FromErrno(bsd_errno), addr_length);
+}
+
+void BSD::GetSockOpt(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const auto level = rp.PopEnum<OptLevel>();
+    const auto name = rp.PopEnum<OptName>();
+
+    LOG_DEBUG(Service, "called, fd={} level=0x{:X} name=0x{:X}", fd, static_cast<u32>(level),
+              static_cast<u32>(name));
+
+    const FileDescriptor* const descriptor = GetDescriptor(fd);
+    if (descriptor == nullptr) {
+        WriteResultWithLength(ctx, FromErrno(Errno::BADF), 0);
+        return;
+    }
+
+    // Timeouts are emulated, the host sockets don't block
+    if (level == OptLevel::SOCKET && (name == OptName::RCVTIMEO || name == OptName::SNDTIMEO)) {
+        const s32 timeout_ms = name == OptName::RCVTIMEO ? descriptor->recv_timeout_ms
+                                                         : descriptor->send_timeout_ms;
+        const u32 length = WriteBufferValue(ctx, 0, MillisecondsToTimeval(timeout_ms));
+        WriteResultWithLength(ctx, {0, Errno::SUCCESS}, length);
+        return;
+    }
+
+    auto [value, bsd_errno] = Host::GetSockOpt(descriptor->handle, level, name);
+    if (bsd_errno == Errno::OPNOTSUPP) {
+        LOG_WARNING(Service, "Unimplemented option level=0x{:X} name=0x{:X}",
+                    static_cast<u32>(level), static_cast<u32>(name));
+        value = 0;
+        bsd_errno = Errno::SUCCESS;
+    }
+    const u32 length = bsd_errno == Errno::SUCCESS ? WriteBufferValue(ctx, 0, value) : 0;
+    WriteResultWithLength(ctx, FromErrno(bsd_errno), length);
+}
+
+void BSD::Listen(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const s32 backlog = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called, fd={} backlog={}", fd, backlog);
+
+    const FileDescriptor* const descriptor = GetDescriptor(fd);
+    if (descriptor == nullptr) {
+        WriteResult(ctx, FromErrno(Errno::BADF));
+        return;
+    }
+    WriteResult(ctx, FromErrno(Host::Listen(descriptor->handle, backlog)));
+}
+
+void BSD::Fcntl(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const auto cmd = rp.PopEnum<FcntlCmd>();
+    const s32 arg = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called, fd={} cmd={} arg={}", fd, static_cast<s32>(cmd), arg);
+
+    FileDescriptor* const descriptor = GetDescriptor(fd);
+    if (descriptor == nullptr) {
+        WriteResult(ctx, FromErrno(Errno::BADF));
+        return;
+    }
+    switch (cmd) {
+    case FcntlCmd::GETFL:
+        WriteResult(ctx, {descriptor->is_non_blocking ? static_cast<s32>(FLAG_O_NONBLOCK) : 0,
+                          Errno::SUCCESS});
+        return;
+    case FcntlCmd::SETFL:
+        descriptor->is_non_blocking = (static_cast<u32>(arg) & FLAG_O_NONBLOCK) != 0;
+        WriteResult(ctx, {0, Errno::SUCCESS});
+        return;
+    default:
+        LOG_WARNING(Service, "Unimplemented fcntl command={}", static_cast<s32>(cmd));
+        WriteResult(ctx, FromErrno(Errno::INVAL));
+        return;
+    }
+}
+
+void BSD::SetSockOpt(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const auto level = rp.PopEnum<OptLevel>();
+    const auto name = rp.PopEnum<OptName>();
+
+    LOG_DEBUG(Service, "called, fd={} level=0x{:X} name=0x{:X}", fd, static_cast<u32>(level),
+              static_cast<u32>(name));
+
+    FileDescriptor* const descriptor = GetDescriptor(fd);
+    if (descriptor == nullptr) {
+        WriteResult(ctx, FromErrno(Errno::BADF));
+        return;
+    }
+
+    if (level == OptLevel::SOCKET && (name == OptName::RCVTIMEO || name == OptName::SNDTIMEO)) {
+        Timeval timeval;
+        if (!ReadBufferValue(ctx, 0, timeval)) {
+            WriteResult(ctx, FromErrno(Errno::INVAL));
+            return;
+        }
+        auto& timeout_ms = name == OptName::RCVTIMEO ? descriptor->recv_timeout_ms
+                                                     : descriptor->send_timeout_ms;
+        timeout_ms = TimevalToMilliseconds(timeval);
+        WriteResult(ctx, {0, Errno::SUCCESS});
+        return;
+    }
+
+    if (level == OptLevel::SOCKET && name == OptName::LINGER) {
+        Linger linger;
+        if (!ReadBufferValue(ctx, 0, linger)) {
+            WriteResult(ctx, FromErrno(Errno::INVAL));
+            return;
+        }
+        WriteResult(ctx, FromErrno(Host::SetLinger(descriptor->handle, linger)));
+        return;
+    }
+
+    s32 value;
+    if (!ReadBufferValue(ctx, 0, value)) {
+        WriteResult(ctx, FromErrno(Errno::INVAL));
+        return;
+    }
+    Errno bsd_errno = Host::SetSockOpt(descriptor->handle, level, name, value);
+    if (bsd_errno == Errno::OPNOTSUPP) {
+        LOG_WARNING(Service, "Unimplemented option level=0x{:X} name=0x{:X}",
+                    static_cast<u32>(level), static_cast<u32>(name));
+        bsd_errno = Errno::SUCCESS;
+    }
+    WriteResult(ctx, FromErrno(bsd_errno));
+}
+
+void BSD::Shutdown(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const auto how = rp.PopEnum<ShutdownHow>();
+
+    LOG_DEBUG(Service, "called, fd={} how={}", fd, static_cast<s32>(how));
+
+    const FileDescriptor* const descriptor = GetDescriptor(fd);
+    if (descriptor == nullptr) {
+        WriteResult(ctx, FromErrno(Errno::BADF));
+        return;
+    }
+    WriteResult(ctx, FromErrno(Host::Shutdown(descriptor->handle, how)));
+}
+
+void BSD::Write(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called, fd={}", fd);
+    SendImpl(ctx, fd, 0, false);
+}
+
+void BSD::Read(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called, fd={}", fd);
+    RecvImpl(ctx, fd, 0, false);
 }
 
 void BSD::Close(Kernel::HLERequestContext& ctx) {
-    LOG_WARNING(Service, "(STUBBED) called");
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
 
-    IPC::ResponseBuilder rb{ctx, 4};
+    LOG_DEBUG(Service, "called, fd={}", fd);
 
-    rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(0); // ret
-    rb.Push<u32>(0); // bsd errno
+    const FileDescriptor* const descriptor = GetDescriptor(fd);
+    if (descriptor == nullptr) {
+        WriteResult(ctx, FromErrno(Errno::BADF));
+        return;
+    }
+
+    // Requests of other threads waiting on the socket complete before it goes away
+    const Host::Handle handle = descriptor->handle;
+    reactor->Cancel(handle);
+    file_descriptors[fd].reset();
+    WriteResult(ctx, FromErrno(Host::Close(handle)));
 }
 
-BSD::BSD(const char* name) : ServiceFramework(name) {
+void BSD::RecvImpl(Kernel::HLERequestContext& ctx, s32 fd, u32 flags, bool has_addr) {
+    const auto write_result = [has_addr](Kernel::HLERequestContext& ctx, OperationResult result,
+                                         u32 addr_length) {
+        if (has_addr) {
+            WriteResultWithLength(ctx, result, addr_length);
+        } else {
+            WriteResult(ctx, result);
+        }
+    };
+
+    const FileDescriptor* const descriptor = GetDescriptor(fd);
+    if (descriptor == nullptr) {
+        write_result(ctx, FromErrno(Errno::BADF), 0);
+        return;
+    }
+
+    // The operation may run on the reactor thread, it receives into a buffer it shares
+    const auto buffer = std::make_shared<std::vector<u8>>(GetWriteBufferSize(ctx, 0));
+    const auto addr = has_addr ? std::make_shared<SockAddrIn>() : nullptr;
+    const Host::Handle handle = descriptor->handle;
+    Operation operation = [handle, flags, buffer, addr] {
+        return Host::Recv(handle, flags, buffer->data(), buffer->size(), addr.get());
+    };
+    Respond respond = [buffer, addr, write_result](Kernel::HLERequestContext& ctx,
+                                                    OperationResult result) {
+        if (result.first > 0) {
+            ctx.WriteBuffer(buffer->data(), static_cast<std::size_t>(result.first));
+        }
+        const bool has_received = result.second == Errno::SUCCESS && addr;
+        write_result(ctx, result, has_received ? WriteBufferValue(ctx, 1, *addr) : 0);
+    };
+
+    ExecuteBlocking(ctx, *descriptor, flags, POLLFD_IN, descriptor->recv_timeout_ms,
+                    std::move(operation), std::move(respond));
+}
+
+void BSD::SendImpl(Kernel::HLERequestContext& ctx, s32 fd, u32 flags, bool has_addr) {
+    const FileDescriptor* const descriptor = GetDescriptor(fd);
+    if (descriptor == nullptr) {
+        WriteResult(ctx, FromErrno(Errno::BADF));
+        return;
+    }
+
+    // Without an address SendTo sends to the peer of a connected socket, like Send
+    std::shared_ptr<SockAddrIn> addr;
+    if (has_addr && GetReadBufferSize(ctx, 1) != 0) {
+        addr = std::make_shared<SockAddrIn>();
+        if (!ReadBufferValue(ctx, 1, *addr)) {
+            WriteResult(ctx, FromErrno(Errno::INVAL));
+            return;
+        }
+    }
+
+    const auto message = std::make_shared<std::vector<u8>>();
+    if (GetReadBufferSize(ctx, 0) != 0) {
+        *message = ctx.ReadBuffer();
+    }
+    const Host::Handle handle = descriptor->handle;
+    Operation operation = [handle, flags, message, addr] {
+        return Host::Send(handle, flags, message->data(), message->size(), addr.get());
+    };
+    Respond respond = [](Kernel::HLERequestContext& ctx, OperationResult result) {
+        WriteResult(ctx, result);
+    };
+
+    ExecuteBlocking(ctx, *descriptor, flags, POLLFD_OUT, descriptor->send_timeout_ms,
+                    std::move(operation), std::move(respond));
+}
+
+void BSD::ExecuteBlocking(Kernel::HLERequestContext& ctx, const FileDescriptor& descriptor,
+                          u32 flags, u16 events, s32 timeout_ms, Operation operation,
+                          Respond respond) {
+    const OperationResult result = operation();
+    if (result.second != Errno::AGAIN || descriptor.is_non_blocking ||
+        (flags & FLAG_MSG_DONTWAIT) != 0) {
+        respond(ctx, result);
+        return;
+    }
+    WaitFor(ctx, descriptor.handle, events, timeout_ms, std::move(operation), std::move(respond));
+}
+
+void BSD::WaitFor(Kernel::HLERequestContext& ctx, Host::Handle handle, u16 events,
+                  s32 timeout_ms, Operation operation, Respond respond) {
+    const auto result = std::make_shared<OperationResult>(FromErrno(Errno::AGAIN));
+    reactor->Wait(
+        ctx, {{handle, events, 0}}, timeout_ms,
+        [operation = std::move(operation), result](NetworkReactor::WakeReason reason,
+                                                   std::vector<Host::PollEntry>& entries) {
+            switch (reason) {
+            case NetworkReactor::WakeReason::Ready:
+                *result = operation();
+                return result->second != Errno::AGAIN;
+            case NetworkReactor::WakeReason::TimedOut:
+                // Like on BSD, operations timed out by SO_RCVTIMEO or SO_SNDTIMEO fail with AGAIN
+                *result = FromErrno(Errno::AGAIN);
+                return true;
+            case NetworkReactor::WakeReason::Cancelled:
+            default:
+                *result = FromErrno(Errno::BADF);
+                return true;
+            }
+        },
+        [respond = std::move(respond), result](Kernel::HLERequestContext& ctx) {
+            respond(ctx, *result);
+        });
+}
+
+BSD::FileDescriptor* BSD::GetDescriptor(s32 fd) {
+    if (fd < 0 || static_cast<std::size_t>(fd) >= MAX_FD || !file_descriptors[fd]) {
+        return nullptr;
+    }
+    return &*file_descriptors[fd];
+}
+
+s32 BSD::FindFreeDescriptor() const {
+    const auto it = std::find_if(file_descriptors.begin(), file_descriptors.end(),
+                                 [](const auto& descriptor) { return !descriptor; });
+    if (it == file_descriptors.end()) {
+        return -1;
+    }
+    return static_cast<s32>(std::distance(file_descriptors.begin(), it));
+}
+
+BSD::BSD(const char* name, std::shared_ptr<NetworkReactor> reactor)
+    : ServiceFramework(name), reactor(std::move(reactor)) {
     // clang-format off
     static const FunctionInfo functions[] = {
         {0, &BSD::RegisterClient, "RegisterClient"},
@@ -81,26 +710,26 @@ BSD::BSD(const char* name) : ServiceFramework(name) {
         {3, nullptr, "SocketExempt"},
         {4, nullptr, "Open"},
         {5, nullptr, "Select"},
-        {6, nullptr, "Poll"},
+        {6, &BSD::Poll, "Poll"},
         {7, nullptr, "Sysctl"},
-        {8, nullptr, "Recv"},
-        {9, nullptr, "RecvFrom"},
-        {10, nullptr, "Send"},
+        {8, &BSD::Recv, "Recv"},
+        {9, &BSD::RecvFrom, "RecvFrom"},
+        {10, &BSD::Send, "Send"},
         {11, &BSD::SendTo, "SendTo"},
-        {12, nullptr, "Accept"},
-        {13, nullptr, "Bind"},
+        {12, &BSD::Accept, "Accept"},
+        {13, &BSD::Bind, "Bind"},
         {14, &BSD::Connect, "Connect"},
-        {15, nullptr, "GetPeerName"},
-        {16, nullptr, "GetSockName"},
-        {17, nullptr, "GetSockOpt"},
-        {18, nullptr, "Listen"},
+        {15, &BSD::GetPeerName, "GetPeerName"},
+        {16, &BSD::GetSockName, "GetSockName"},
+        {17, &BSD::GetSockOpt, "GetSockOpt"},
+        {18, &BSD::Listen, "Listen"},
         {19, nullptr, "Ioctl"},
-        {20, nullptr, "Fcntl"},
-        {21, nullptr, "SetSockOpt"},
-        {22, nullptr, "Shutdown"},
+        {20, &BSD::Fcntl, "Fcntl"},
+        {21, &BSD::SetSockOpt, "SetSockOpt"},
+        {22, &BSD::Shutdown, "Shutdown"},
         {23, nullptr, "ShutdownAllSockets"},
-        {24, nullptr, "Write"},
-        {25, nullptr, "Read"},
+        {24, &BSD::Write, "Write"},
+        {25, &BSD::Read, "Read"},
         {26, &BSD::Close, "Close"},
         {27, nullptr, "DuplicateSocket"},
         {28, nullptr, "GetResourceStatistics"},
@@ -114,7 +743,13 @@ BSD::BSD(const char* name) : ServiceFramework(name) {
     RegisterHandlers(functions);
 }
 
-BSD::~BSD() = default;
+BSD::~BSD() {
+    for (const auto& descriptor : file_descriptors) {
+        if (descriptor) {
+            Host::Close(descriptor->handle);
+        }
+    }
+}
 
 BSDCFG::BSDCFG() : ServiceFramework{"bsdcfg"} {
     // clang-format off
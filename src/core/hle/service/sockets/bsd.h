@@ -4,26 +4,94 @@
 
 #pragma once
 
+#include <array>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include "common/common_types.h"
 #include "core/hle/kernel/hle_ipc.h"
 #include "core/hle/service/service.h"
+#include "core/hle/service/sockets/host_socket.h"
 
 namespace Service::Sockets {
 
+class NetworkReactor;
+
+/**
+ * BSD socket service, backed by non-blocking sockets of the host. Operations that would block on
+ * a blocking socket put the guest thread to sleep until the network reactor completes them, so
+ * that only the guest thread waits and not its core.
+ */
 class BSD final : public ServiceFramework<BSD> {
 public:
-    explicit BSD(const char* name);
+    explicit BSD(const char* name, std::shared_ptr<NetworkReactor> reactor);
     ~BSD() override;
 
 private:
+    /// Socket of the guest, backed by a host socket.
+    struct FileDescriptor {
+        Host::Handle handle = Host::INVALID_HANDLE;
+        bool is_non_blocking = false;
+        /// Timeouts of the blocking operations, negative ones wait forever.
+        s32 recv_timeout_ms = -1;
+        s32 send_timeout_ms = -1;
+    };
+
+    /// Return value and errno of a BSD function.
+    using OperationResult = std::pair<s32, Errno>;
+    using Operation = std::function<OperationResult()>;
+    using Respond = std::function<void(Kernel::HLERequestContext& ctx, OperationResult result)>;
+
+    static constexpr std::size_t MAX_FD = 128;
+
     void RegisterClient(Kernel::HLERequestContext& ctx);
     void StartMonitoring(Kernel::HLERequestContext& ctx);
     void Socket(Kernel::HLERequestContext& ctx);
-    void Connect(Kernel::HLERequestContext& ctx);
+    void Poll(Kernel::HLERequestContext& ctx);
+    void Recv(Kernel::HLERequestContext& ctx);
+    void RecvFrom(Kernel::HLERequestContext& ctx);
+    void Send(Kernel::HLERequestContext& ctx);
     void SendTo(Kernel::HLERequestContext& ctx);
+    void Accept(Kernel::HLERequestContext& ctx);
+    void Bind(Kernel::HLERequestContext& ctx);
+    void Connect(Kernel::HLERequestContext& ctx);
+    void GetPeerName(Kernel::HLERequestContext& ctx);
+    void GetSockName(Kernel::HLERequestContext& ctx);
+    void GetSockOpt(Kernel::HLERequestContext& ctx);
+    void Listen(Kernel::HLERequestContext& ctx);
+    void Fcntl(Kernel::HLERequestContext& ctx);
+    void SetSockOpt(Kernel::HLERequestContext& ctx);
+    void Shutdown(Kernel::HLERequestContext& ctx);
+    void Write(Kernel::HLERequestContext& ctx);
+    void Read(Kernel::HLERequestContext& ctx);
     void Close(Kernel::HLERequestContext& ctx);
 
-    /// Id to use for the next open file descriptor.
-    u32 next_fd = 1;
+    void RecvImpl(Kernel::HLERequestContext& ctx, s32 fd, u32 flags, bool has_addr);
+    void SendImpl(Kernel::HLERequestContext& ctx, s32 fd, u32 flags, bool has_addr);
+
+    /**
+     * Runs an operation on a socket, when it would block on a blocking socket the client thread
+     * waits for events on the socket and the operation is retried by the reactor. The response is
+     * written by respond in both cases.
+     */
+    void ExecuteBlocking(Kernel::HLERequestContext& ctx, const FileDescriptor& descriptor,
+                         u32 flags, u16 events, s32 timeout_ms, Operation operation,
+                         Respond respond);
+
+    /// Puts the client thread to sleep until operation completes, retrying it on the reactor
+    /// when the socket reports events.
+    void WaitFor(Kernel::HLERequestContext& ctx, Host::Handle handle, u16 events, s32 timeout_ms,
+                 Operation operation, Respond respond);
+
+    /// Returns the descriptor of fd, or null if it's not an open socket.
+    FileDescriptor* GetDescriptor(s32 fd);
+
+    /// Returns the lowest fd that isn't open, or -1 if they all are.
+    s32 FindFreeDescriptor() const;
+
+    std::shared_ptr<NetworkReactor> reactor;
+    std::array<std::optional<FileDescriptor>, MAX_FD> file_descriptors;
 };
 
 class BSDCFG final : public ServiceFramework<BSDCFG> {
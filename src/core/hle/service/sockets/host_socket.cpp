@@ -0,0 +1,591 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "common/logging/log.h"
+#include "core/hle/service/sockets/host_socket.h"
+
+namespace Service::Sockets::Host {
+
+namespace {
+
+#ifdef _WIN32
+static_assert(std::is_same_v<Handle, SOCKET>, "Handle must be a SOCKET");
+using SockLen = int;
+
+int LastError() {
+    return WSAGetLastError();
+}
+#else
+using SockLen = socklen_t;
+
+int LastError() {
+    return errno;
+}
+#endif
+
+std::mutex initialize_mutex;
+u32 initialize_count = 0;
+
+Errno TranslateNativeError(int error) {
+    switch (error) {
+#ifdef _WIN32
+    case WSAEWOULDBLOCK:
+        return Errno::AGAIN;
+    case WSAEBADF:
+    case WSAENOTSOCK:
+        return Errno::BADF;
+    case WSAEINVAL:
+        return Errno::INVAL;
+    case WSAEMFILE:
+        return Errno::MFILE;
+    case WSAEACCES:
+        return Errno::ACCES;
+    case WSAEMSGSIZE:
+        return Errno::MSGSIZE;
+    case WSAEPROTONOSUPPORT:
+        return Errno::PROTONOSUPPORT;
+    case WSAEOPNOTSUPP:
+        return Errno::OPNOTSUPP;
+    case WSAEAFNOSUPPORT:
+        return Errno::AFNOSUPPORT;
+    case WSAEADDRINUSE:
+        return Errno::ADDRINUSE;
+    case WSAEADDRNOTAVAIL:
+        return Errno::ADDRNOTAVAIL;
+    case WSAENETDOWN:
+        return Errno::NETDOWN;
+    case WSAENETUNREACH:
+        return Errno::NETUNREACH;
+    case WSAECONNABORTED:
+        return Errno::CONNABORTED;
+    case WSAECONNRESET:
+        return Errno::CONNRESET;
+    case WSAENOBUFS:
+        return Errno::NOBUFS;
+    case WSAEISCONN:
+        return Errno::ISCONN;
+    case WSAENOTCONN:
+        return Errno::NOTCONN;
+    case WSAETIMEDOUT:
+        return Errno::TIMEDOUT;
+    case WSAECONNREFUSED:
+        return Errno::CONNREFUSED;
+    case WSAEHOSTUNREACH:
+        return Errno::HOSTUNREACH;
+    case WSAEALREADY:
+        return Errno::ALREADY;
+    case WSAEINPROGRESS:
+        return Errno::INPROGRESS;
+#else
+    case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+    case EWOULDBLOCK:
+#endif
+        return Errno::AGAIN;
+    case EBADF:
+    case ENOTSOCK:
+        return Errno::BADF;
+    case EINVAL:
+        return Errno::INVAL;
+    case EMFILE:
+    case ENFILE:
+        return Errno::MFILE;
+    case ENOMEM:
+        return Errno::NOMEM;
+    case EACCES:
+    case EPERM:
+        return Errno::ACCES;
+    case EPIPE:
+        return Errno::PIPE;
+    case EMSGSIZE:
+        return Errno::MSGSIZE;
+    case EPROTONOSUPPORT:
+        return Errno::PROTONOSUPPORT;
+    case EOPNOTSUPP:
+        return Errno::OPNOTSUPP;
+    case EAFNOSUPPORT:
+        return Errno::AFNOSUPPORT;
+    case EADDRINUSE:
+        return Errno::ADDRINUSE;
+    case EADDRNOTAVAIL:
+        return Errno::ADDRNOTAVAIL;
+    case ENETDOWN:
+        return Errno::NETDOWN;
+    case ENETUNREACH:
+        return Errno::NETUNREACH;
+    case ECONNABORTED:
+        return Errno::CONNABORTED;
+    case ECONNRESET:
+        return Errno::CONNRESET;
+    case ENOBUFS:
+        return Errno::NOBUFS;
+    case EISCONN:
+        return Errno::ISCONN;
+    case ENOTCONN:
+        return Errno::NOTCONN;
+    case ETIMEDOUT:
+        return Errno::TIMEDOUT;
+    case ECONNREFUSED:
+        return Errno::CONNREFUSED;
+    case EHOSTUNREACH:
+        return Errno::HOSTUNREACH;
+    case EALREADY:
+        return Errno::ALREADY;
+    case EINPROGRESS:
+        return Errno::INPROGRESS;
+#endif
+    default:
+        LOG_ERROR(Service, "Unhandled host socket error={}", error);
+        return Errno::INVAL;
+    }
+}
+
+Errno LastErrno() {
+    return TranslateNativeError(LastError());
+}
+
+Errno SetNonBlocking(Handle handle) {
+#ifdef _WIN32
+    u_long mode = 1;
+    if (ioctlsocket(handle, FIONBIO, &mode) != 0) {
+        return LastErrno();
+    }
+#else
+    const int flags = fcntl(handle, F_GETFL);
+    if (flags < 0 || fcntl(handle, F_SETFL, flags | O_NONBLOCK) < 0) {
+        return LastErrno();
+    }
+#ifdef __APPLE__
+    // Writes to closed connections raise SIGPIPE without it, there's no MSG_NOSIGNAL
+    const int value = 1;
+    setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &value, sizeof(value));
+#endif
+#endif
+    return Errno::SUCCESS;
+}
+
+sockaddr_in ToNative(const SockAddrIn& addr) {
+    sockaddr_in result{};
+    result.sin_family = AF_INET;
+    std::memcpy(&result.sin_port, addr.port.data(), sizeof(result.sin_port));
+    std::memcpy(&result.sin_addr, addr.ip.data(), sizeof(result.sin_addr));
+    return result;
+}
+
+SockAddrIn FromNative(const sockaddr_in& addr) {
+    SockAddrIn result{};
+    result.len = sizeof(SockAddrIn);
+    result.family = static_cast<u8>(Domain::INET);
+    std::memcpy(result.port.data(), &addr.sin_port, sizeof(addr.sin_port));
+    std::memcpy(result.ip.data(), &addr.sin_addr, sizeof(addr.sin_addr));
+    return result;
+}
+
+int TranslateMessageFlags(u32 flags) {
+    constexpr u32 FLAG_MSG_OOB = 0x1;
+    constexpr u32 FLAG_MSG_PEEK = 0x2;
+
+    // Host sockets never block, FLAG_MSG_DONTWAIT is handled by the service
+    int result = 0;
+    if ((flags & FLAG_MSG_OOB) != 0) {
+        result |= MSG_OOB;
+    }
+    if ((flags & FLAG_MSG_PEEK) != 0) {
+        result |= MSG_PEEK;
+    }
+    return result;
+}
+
+int ClampSize(std::size_t size) {
+    return static_cast<int>(std::min<std::size_t>(size, std::numeric_limits<int>::max()));
+}
+
+/// Returns false when the host has no equivalent of the option.
+bool TranslateOption(OptLevel level, OptName name, int& native_level, int& native_name) {
+    switch (level) {
+    case OptLevel::SOCKET:
+        native_level = SOL_SOCKET;
+        switch (name) {
+        case OptName::REUSEADDR:
+            native_name = SO_REUSEADDR;
+            return true;
+        case OptName::KEEPALIVE:
+            native_name = SO_KEEPALIVE;
+            return true;
+        case OptName::BROADCAST:
+            native_name = SO_BROADCAST;
+            return true;
+        case OptName::LINGER:
+            native_name = SO_LINGER;
+            return true;
+        case OptName::SNDBUF:
+            native_name = SO_SNDBUF;
+            return true;
+        case OptName::RCVBUF:
+            native_name = SO_RCVBUF;
+            return true;
+        case OptName::PENDING_ERROR:
+            native_name = SO_ERROR;
+            return true;
+        default:
+            return false;
+        }
+    case OptLevel::TCP:
+        native_level = IPPROTO_TCP;
+        if (name == OptName::NODELAY) {
+            native_name = TCP_NODELAY;
+            return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+}
+
+short TranslatePollEvents(u16 events) {
+    short result = 0;
+    if ((events & POLLFD_IN) != 0) {
+        result |= POLLIN;
+    }
+#ifndef _WIN32
+    // WSAPoll fails when asked for POLLPRI
+    if ((events & POLLFD_PRI) != 0) {
+        result |= POLLPRI;
+    }
+#endif
+    if ((events & POLLFD_OUT) != 0) {
+        result |= POLLOUT;
+    }
+    return result;
+}
+
+u16 TranslatePollRevents(short revents) {
+    u16 result = 0;
+    const auto translate = [&](short native, u16 event) {
+        if ((revents & native) != 0) {
+            result |= event;
+        }
+    };
+    translate(POLLIN, POLLFD_IN);
+    translate(POLLPRI, POLLFD_PRI);
+    translate(POLLOUT, POLLFD_OUT);
+    translate(POLLERR, POLLFD_ERR);
+    translate(POLLHUP, POLLFD_HUP);
+    translate(POLLNVAL, POLLFD_NVAL);
+    return result;
+}
+
+} // Anonymous namespace
+
+void Initialize() {
+    std::lock_guard lock{initialize_mutex};
+    if (initialize_count++ != 0) {
+        return;
+    }
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        LOG_ERROR(Service, "Failed to initialize Winsock, error={}", WSAGetLastError());
+    }
+#endif
+}
+
+void Shutdown() {
+    std::lock_guard lock{initialize_mutex};
+    if (--initialize_count != 0) {
+        return;
+    }
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+std::pair<Handle, Errno> Open(Domain domain, Type type, Protocol protocol) {
+    if (domain != Domain::INET) {
+        return {INVALID_HANDLE, Errno::AFNOSUPPORT};
+    }
+
+    int native_type;
+    switch (type) {
+    case Type::STREAM:
+        native_type = SOCK_STREAM;
+        break;
+    case Type::DGRAM:
+        native_type = SOCK_DGRAM;
+        break;
+    case Type::RAW:
+        native_type = SOCK_RAW;
+        break;
+    case Type::SEQPACKET:
+        native_type = SOCK_SEQPACKET;
+        break;
+    default:
+        return {INVALID_HANDLE, Errno::PROTONOSUPPORT};
+    }
+
+    int native_protocol;
+    switch (protocol) {
+    case Protocol::UNSPECIFIED:
+        native_protocol = 0;
+        break;
+    case Protocol::ICMP:
+        native_protocol = IPPROTO_ICMP;
+        break;
+    case Protocol::TCP:
+        native_protocol = IPPROTO_TCP;
+        break;
+    case Protocol::UDP:
+        native_protocol = IPPROTO_UDP;
+        break;
+    default:
+        return {INVALID_HANDLE, Errno::PROTONOSUPPORT};
+    }
+
+    const Handle handle = socket(AF_INET, native_type, native_protocol);
+    if (handle == INVALID_HANDLE) {
+        return {INVALID_HANDLE, LastErrno()};
+    }
+    if (const Errno error = SetNonBlocking(handle); error != Errno::SUCCESS) {
+        Close(handle);
+        return {INVALID_HANDLE, error};
+    }
+    return {handle, Errno::SUCCESS};
+}
+
+Errno Close(Handle handle) {
+#ifdef _WIN32
+    const int result = closesocket(handle);
+#else
+    const int result = close(handle);
+#endif
+    return result == 0 ? Errno::SUCCESS : LastErrno();
+}
+
+Errno Bind(Handle handle, const SockAddrIn& addr) {
+    const sockaddr_in native = ToNative(addr);
+    if (bind(handle, reinterpret_cast<const sockaddr*>(&native), sizeof(native)) != 0) {
+        return LastErrno();
+    }
+    return Errno::SUCCESS;
+}
+
+Errno Connect(Handle handle, const SockAddrIn& addr) {
+    const sockaddr_in native = ToNative(addr);
+    if (connect(handle, reinterpret_cast<const sockaddr*>(&native), sizeof(native)) == 0) {
+        return Errno::SUCCESS;
+    }
+    const Errno error = LastErrno();
+#ifdef _WIN32
+    // Winsock reports connections of non-blocking sockets in progress as would block
+    if (error == Errno::AGAIN) {
+        return Errno::INPROGRESS;
+    }
+#endif
+    return error;
+}
+
+Errno Listen(Handle handle, s32 backlog) {
+    return listen(handle, backlog) == 0 ? Errno::SUCCESS : LastErrno();
+}
+
+Errno Shutdown(Handle handle, ShutdownHow how) {
+    int native_how;
+    switch (how) {
+#ifdef _WIN32
+    case ShutdownHow::RD:
+        native_how = SD_RECEIVE;
+        break;
+    case ShutdownHow::WR:
+        native_how = SD_SEND;
+        break;
+    case ShutdownHow::RDWR:
+        native_how = SD_BOTH;
+        break;
+#else
+    case ShutdownHow::RD:
+        native_how = SHUT_RD;
+        break;
+    case ShutdownHow::WR:
+        native_how = SHUT_WR;
+        break;
+    case ShutdownHow::RDWR:
+        native_how = SHUT_RDWR;
+        break;
+#endif
+    default:
+        return Errno::INVAL;
+    }
+    return shutdown(handle, native_how) == 0 ? Errno::SUCCESS : LastErrno();
+}
+
+std::pair<Handle, Errno> Accept(Handle handle, SockAddrIn* addr) {
+    sockaddr_in native{};
+    SockLen length = sizeof(native);
+    const Handle result = accept(handle, reinterpret_cast<sockaddr*>(&native), &length);
+    if (result == INVALID_HANDLE) {
+        return {INVALID_HANDLE, LastErrno()};
+    }
+    // Accepted sockets don't inherit the non-blocking mode everywhere
+    if (const Errno error = SetNonBlocking(result); error != Errno::SUCCESS) {
+        Close(result);
+        return {INVALID_HANDLE, error};
+    }
+    if (addr != nullptr) {
+        *addr = FromNative(native);
+    }
+    return {result, Errno::SUCCESS};
+}
+
+std::pair<s32, Errno> Recv(Handle handle, u32 flags, u8* data, std::size_t size, SockAddrIn* addr) {
+    const int native_flags = TranslateMessageFlags(flags);
+    auto* const buffer = reinterpret_cast<char*>(data);
+    sockaddr_in native{};
+    SockLen length = sizeof(native);
+    const auto result =
+        addr != nullptr ? recvfrom(handle, buffer, ClampSize(size), native_flags,
+                                   reinterpret_cast<sockaddr*>(&native), &length)
+                        : recv(handle, buffer, ClampSize(size), native_flags);
+    if (result < 0) {
+        return {-1, LastErrno()};
+    }
+    if (addr != nullptr) {
+        *addr = FromNative(native);
+    }
+    return {static_cast<s32>(result), Errno::SUCCESS};
+}
+
+std::pair<s32, Errno> Send(Handle handle, u32 flags, const u8* data, std::size_t size,
+                           const SockAddrIn* addr) {
+    int native_flags = TranslateMessageFlags(flags);
+#ifdef MSG_NOSIGNAL
+    // Writes to closed connections fail with PIPE instead of raising SIGPIPE
+    native_flags |= MSG_NOSIGNAL;
+#endif
+    const auto* const buffer = reinterpret_cast<const char*>(data);
+    sockaddr_in native{};
+    if (addr != nullptr) {
+        native = ToNative(*addr);
+    }
+    const auto result =
+        addr != nullptr ? sendto(handle, buffer, ClampSize(size), native_flags,
+                                 reinterpret_cast<const sockaddr*>(&native), sizeof(native))
+                        : send(handle, buffer, ClampSize(size), native_flags);
+    if (result < 0) {
+        return {-1, LastErrno()};
+    }
+    return {static_cast<s32>(result), Errno::SUCCESS};
+}
+
+Errno GetSockName(Handle handle, SockAddrIn& addr) {
+    sockaddr_in native{};
+    SockLen length = sizeof(native);
+    if (getsockname(handle, reinterpret_cast<sockaddr*>(&native), &length) != 0) {
+        return LastErrno();
+    }
+    addr = FromNative(native);
+    return Errno::SUCCESS;
+}
+
+Errno GetPeerName(Handle handle, SockAddrIn& addr) {
+    sockaddr_in native{};
+    SockLen length = sizeof(native);
+    if (getpeername(handle, reinterpret_cast<sockaddr*>(&native), &length) != 0) {
+        return LastErrno();
+    }
+    addr = FromNative(native);
+    return Errno::SUCCESS;
+}
+
+Errno SetSockOpt(Handle handle, OptLevel level, OptName name, s32 value) {
+    int native_level;
+    int native_name;
+    if (!TranslateOption(level, name, native_level, native_name)) {
+        return Errno::OPNOTSUPP;
+    }
+    const int native_value = value;
+    if (setsockopt(handle, native_level, native_name,
+                   reinterpret_cast<const char*>(&native_value), sizeof(native_value)) != 0) {
+        return LastErrno();
+    }
+    return Errno::SUCCESS;
+}
+
+Errno SetLinger(Handle handle, const Linger& linger) {
+    ::linger native{};
+    native.l_onoff = static_cast<decltype(native.l_onoff)>(linger.onoff != 0);
+    native.l_linger = static_cast<decltype(native.l_linger)>(linger.linger);
+    if (setsockopt(handle, SOL_SOCKET, SO_LINGER, reinterpret_cast<const char*>(&native),
+                   sizeof(native)) != 0) {
+        return LastErrno();
+    }
+    return Errno::SUCCESS;
+}
+
+std::pair<s32, Errno> GetSockOpt(Handle handle, OptLevel level, OptName name) {
+    int native_level;
+    int native_name;
+    if (!TranslateOption(level, name, native_level, native_name) || name == OptName::LINGER) {
+        return {0, Errno::OPNOTSUPP};
+    }
+    int value = 0;
+    SockLen length = sizeof(value);
+    if (getsockopt(handle, native_level, native_name, reinterpret_cast<char*>(&value),
+                   &length) != 0) {
+        return {0, LastErrno()};
+    }
+    if (name == OptName::PENDING_ERROR && value != 0) {
+        value = static_cast<s32>(TranslateNativeError(value));
+    }
+    return {value, Errno::SUCCESS};
+}
+
+Errno GetPendingError(Handle handle) {
+    const auto [value, error] = GetSockOpt(handle, OptLevel::SOCKET, OptName::PENDING_ERROR);
+    return error != Errno::SUCCESS ? error : static_cast<Errno>(value);
+}
+
+std::pair<s32, Errno> Poll(std::vector<PollEntry>& entries, s32 timeout_ms) {
+    std::vector<pollfd> native(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        native[i].fd = entries[i].handle;
+        native[i].events = TranslatePollEvents(entries[i].events);
+        native[i].revents = 0;
+    }
+#ifdef _WIN32
+    const int result = WSAPoll(native.data(), static_cast<ULONG>(native.size()), timeout_ms);
+#else
+    const int result = poll(native.data(), static_cast<nfds_t>(native.size()), timeout_ms);
+    if (result < 0 && errno == EINTR) {
+        return {0, Errno::SUCCESS};
+    }
+#endif
+    if (result < 0) {
+        return {-1, LastErrno()};
+    }
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        entries[i].revents = TranslatePollRevents(native[i].revents);
+    }
+    return {result, Errno::SUCCESS};
+}
+
+} // namespace Service::Sockets::Host
@@ -0,0 +1,69 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "common/common_types.h"
+#include "core/hle/service/sockets/sockets.h"
+
+/// Thin portable layer over the sockets of the host, taking and returning the guest's types.
+/// Sockets are always non-blocking on the host, blocking is emulated on top of them.
+namespace Service::Sockets::Host {
+
+#ifdef _WIN32
+using Handle = std::uintptr_t;
+constexpr Handle INVALID_HANDLE = ~Handle{0};
+#else
+using Handle = int;
+constexpr Handle INVALID_HANDLE = -1;
+#endif
+
+/// Host socket waited on by Poll, events are the guest's PollEvents.
+struct PollEntry {
+    Handle handle;
+    u16 events;
+    u16 revents;
+};
+
+/// Initializes the socket library of the host, calls nest.
+void Initialize();
+void Shutdown();
+
+std::pair<Handle, Errno> Open(Domain domain, Type type, Protocol protocol);
+Errno Close(Handle handle);
+
+Errno Bind(Handle handle, const SockAddrIn& addr);
+Errno Connect(Handle handle, const SockAddrIn& addr);
+Errno Listen(Handle handle, s32 backlog);
+Errno Shutdown(Handle handle, ShutdownHow how);
+
+/// Accepts a connection, the address of the peer is written to addr when it is not null.
+std::pair<Handle, Errno> Accept(Handle handle, SockAddrIn* addr);
+
+/// Receives into data, the address of the sender is written to addr when it is not null.
+std::pair<s32, Errno> Recv(Handle handle, u32 flags, u8* data, std::size_t size, SockAddrIn* addr);
+
+/// Sends data, to addr when it is not null.
+std::pair<s32, Errno> Send(Handle handle, u32 flags, const u8* data, std::size_t size,
+                           const SockAddrIn* addr);
+
+Errno GetSockName(Handle handle, SockAddrIn& addr);
+Errno GetPeerName(Handle handle, SockAddrIn& addr);
+
+/// Sets an option taking an integer value, LINGER takes the Linger value instead.
+Errno SetSockOpt(Handle handle, OptLevel level, OptName name, s32 value);
+Errno SetLinger(Handle handle, const Linger& linger);
+std::pair<s32, Errno> GetSockOpt(Handle handle, OptLevel level, OptName name);
+
+/// Returns the error of a connection established asynchronously, once it completed.
+Errno GetPendingError(Handle handle);
+
+/// Polls the handles, with a negative timeout waiting until one is ready.
+std::pair<s32, Errno> Poll(std::vector<PollEntry>& entries, s32 timeout_ms);
+
+} // namespace Service::Sockets::Host
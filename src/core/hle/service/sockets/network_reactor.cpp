@@ -0,0 +1,237 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/thread.h"
+#include "core/hle/kernel/writable_event.h"
+#include "core/hle/service/sockets/network_reactor.h"
+
+namespace Service::Sockets {
+
+namespace {
+
+/// Interval at which new requests are picked up when no wakeup socket could be created.
+constexpr s32 FALLBACK_POLL_INTERVAL_MS = 10;
+
+s32 RemainingMilliseconds(std::chrono::steady_clock::time_point deadline,
+                          std::chrono::steady_clock::time_point now) {
+    if (deadline <= now) {
+        return 0;
+    }
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+    return static_cast<s32>(
+        std::min<decltype(remaining)>(remaining, std::numeric_limits<s32>::max()));
+}
+
+} // Anonymous namespace
+
+NetworkReactor::NetworkReactor(Kernel::KernelCore& kernel) : kernel{kernel} {
+    Host::Initialize();
+
+    const auto [handle, error] = Host::Open(Domain::INET, Type::DGRAM, Protocol::UDP);
+    if (error == Errno::SUCCESS) {
+        SockAddrIn addr{};
+        addr.len = sizeof(SockAddrIn);
+        addr.family = static_cast<u8>(Domain::INET);
+        addr.ip = {127, 0, 0, 1};
+        if (Host::Bind(handle, addr) == Errno::SUCCESS &&
+            Host::GetSockName(handle, addr) == Errno::SUCCESS &&
+            Host::Connect(handle, addr) == Errno::SUCCESS) {
+            wakeup_handle = handle;
+        } else {
+            Host::Close(handle);
+        }
+    }
+    if (wakeup_handle == Host::INVALID_HANDLE) {
+        LOG_ERROR(Service, "Failed to create the wakeup socket, new requests are polled for");
+    }
+
+    thread = std::thread([this] { Loop(); });
+}
+
+NetworkReactor::~NetworkReactor() {
+    {
+        std::lock_guard lock{mutex};
+        is_stopping = true;
+    }
+    Notify();
+    thread.join();
+
+    if (wakeup_handle != Host::INVALID_HANDLE) {
+        Host::Close(wakeup_handle);
+    }
+    {
+        // Requests left waiting are dropped, their client threads are only woken up by emulation
+        // ending
+        std::lock_guard lock{kernel.HLELock()};
+        requests.clear();
+    }
+    Host::Shutdown();
+}
+
+void NetworkReactor::Wait(Kernel::HLERequestContext& ctx, std::vector<Host::PollEntry> entries,
+                          s32 timeout_ms, Attempt attempt, Respond respond) {
+    auto request = std::make_shared<Request>();
+    request->entries = std::move(entries);
+    request->has_deadline = timeout_ms >= 0;
+    if (request->has_deadline) {
+        request->deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+    request->attempt = std::move(attempt);
+    request->event = ctx.SleepClientThread(
+        "NetworkReactor", 0,
+        [respond = std::move(respond)](Kernel::SharedPtr<Kernel::Thread> thread,
+                                       Kernel::HLERequestContext& ctx,
+                                       Kernel::ThreadWakeupReason reason) { respond(ctx); });
+    {
+        std::lock_guard lock{mutex};
+        requests.push_back(std::move(request));
+    }
+    Notify();
+}
+
+void NetworkReactor::Cancel(Host::Handle handle) {
+    std::vector<Kernel::SharedPtr<Kernel::WritableEvent>> cancelled;
+    {
+        std::lock_guard lock{mutex};
+        for (const auto& request : requests) {
+            const bool uses_handle = std::any_of(
+                request->entries.begin(), request->entries.end(),
+                [handle](const Host::PollEntry& entry) { return entry.handle == handle; });
+            if (!uses_handle) {
+                continue;
+            }
+            for (Host::PollEntry& entry : request->entries) {
+                entry.revents = entry.handle == handle ? POLLFD_NVAL : 0;
+            }
+            request->attempt(WakeReason::Cancelled, request->entries);
+            request->attempt = nullptr;
+            cancelled.push_back(std::move(request->event));
+        }
+        requests.erase(std::remove_if(requests.begin(), requests.end(),
+                                      [](const auto& request) { return !request->event; }),
+                       requests.end());
+    }
+    if (cancelled.empty()) {
+        return;
+    }
+
+    // The caller holds the HLE lock already
+    for (const auto& event : cancelled) {
+        event->Signal();
+    }
+    Notify();
+}
+
+void NetworkReactor::Loop() {
+    Common::SetCurrentThreadName("yuzu:NetworkReactor");
+
+    std::vector<std::shared_ptr<Request>> polled;
+    std::vector<Host::PollEntry> entries;
+    std::vector<Kernel::SharedPtr<Kernel::WritableEvent>> completed;
+    const bool has_wakeup = wakeup_handle != Host::INVALID_HANDLE;
+    while (true) {
+        s32 timeout_ms = has_wakeup ? -1 : FALLBACK_POLL_INTERVAL_MS;
+        {
+            std::lock_guard lock{mutex};
+            if (is_stopping) {
+                return;
+            }
+            polled = requests;
+            entries.clear();
+            if (has_wakeup) {
+                entries.push_back({wakeup_handle, POLLFD_IN, 0});
+            }
+            const auto now = Clock::now();
+            for (const auto& request : polled) {
+                entries.insert(entries.end(), request->entries.begin(), request->entries.end());
+                if (request->has_deadline) {
+                    const s32 remaining = RemainingMilliseconds(request->deadline, now);
+                    timeout_ms = timeout_ms < 0 ? remaining : std::min(timeout_ms, remaining);
+                }
+            }
+        }
+
+        if (entries.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+        } else if (const auto result = Host::Poll(entries, timeout_ms);
+                   result.second != Errno::SUCCESS) {
+            LOG_ERROR(Service, "Failed to poll {} host sockets, errno={}", entries.size(),
+                      static_cast<u32>(result.second));
+            std::this_thread::sleep_for(std::chrono::milliseconds(FALLBACK_POLL_INTERVAL_MS));
+        }
+
+        {
+            std::lock_guard lock{mutex};
+            if (is_stopping) {
+                return;
+            }
+            std::size_t offset = 0;
+            if (has_wakeup) {
+                std::array<u8, 64> buffer;
+                while (Host::Recv(wakeup_handle, 0, buffer.data(), buffer.size(), nullptr).second ==
+                       Errno::SUCCESS) {
+                }
+                offset = 1;
+            }
+
+            const auto now = Clock::now();
+            for (const auto& request : polled) {
+                const std::size_t num_entries = request->entries.size();
+                if (!request->event) {
+                    // Cancelled while the sockets were polled
+                    offset += num_entries;
+                    continue;
+                }
+                bool is_ready = false;
+                for (std::size_t i = 0; i < num_entries; ++i) {
+                    request->entries[i].revents = entries[offset + i].revents;
+                    is_ready |= request->entries[i].revents != 0;
+                }
+                offset += num_entries;
+
+                bool is_done = is_ready && request->attempt(WakeReason::Ready, request->entries);
+                if (!is_done && request->has_deadline && now >= request->deadline) {
+                    request->attempt(WakeReason::TimedOut, request->entries);
+                    is_done = true;
+                }
+                if (is_done) {
+                    request->attempt = nullptr;
+                    completed.push_back(std::move(request->event));
+                }
+            }
+            requests.erase(std::remove_if(requests.begin(), requests.end(),
+                                          [](const auto& request) { return !request->event; }),
+                           requests.end());
+        }
+        polled.clear();
+
+        if (!completed.empty()) {
+            // Waking up the client threads changes the kernel state, take the lock of the CPU
+            // threads
+            std::lock_guard lock{kernel.HLELock()};
+            for (const auto& event : completed) {
+                event->Signal();
+            }
+            completed.clear();
+        }
+    }
+}
+
+void NetworkReactor::Notify() {
+    if (wakeup_handle == Host::INVALID_HANDLE) {
+        return;
+    }
+    const u8 byte = 0;
+    Host::Send(wakeup_handle, 0, &byte, sizeof(byte), nullptr);
+}
+
+} // namespace Service::Sockets
@@ -0,0 +1,90 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/service/sockets/host_socket.h"
+
+namespace Kernel {
+class KernelCore;
+}
+
+namespace Service::Sockets {
+
+/**
+ * Host thread waiting for the host sockets guest threads block on, so that requests that would
+ * block, e.g. a Recv without data, put the guest thread to sleep in the emulated kernel instead of
+ * blocking its core. The thread polls the sockets of all the waiting requests at once and retries a
+ * request when its sockets are ready, until it completes, times out or is cancelled.
+ */
+class NetworkReactor {
+public:
+    enum class WakeReason {
+        Ready,
+        TimedOut,
+        Cancelled,
+    };
+
+    /**
+     * Retries the operation of a waiting request on the reactor thread, returns true when it
+     * completed and false to keep waiting. It's given the entries of the request with the events
+     * the host reported. It must complete when the reason isn't Ready, cancelled entries are
+     * reported with POLLFD_NVAL.
+     */
+    using Attempt = std::function<bool(WakeReason reason, std::vector<Host::PollEntry>& entries)>;
+
+    /// Writes the response of a request once its operation completed, on the CPU thread.
+    using Respond = std::function<void(Kernel::HLERequestContext& ctx)>;
+
+    explicit NetworkReactor(Kernel::KernelCore& kernel);
+    ~NetworkReactor();
+
+    /**
+     * Puts the client thread of a request to sleep until attempt completes, retrying it whenever
+     * the host reports events on entries. A negative timeout waits forever. Must be called with
+     * the HLE lock held, like the other service handlers.
+     */
+    void Wait(Kernel::HLERequestContext& ctx, std::vector<Host::PollEntry> entries, s32 timeout_ms,
+              Attempt attempt, Respond respond);
+
+    /// Completes the requests waiting on a host socket, before it's closed. Must be called with
+    /// the HLE lock held.
+    void Cancel(Host::Handle handle);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        std::vector<Host::PollEntry> entries;
+        bool has_deadline;
+        Clock::time_point deadline;
+        Attempt attempt;
+        Kernel::SharedPtr<Kernel::WritableEvent> event;
+    };
+
+    void Loop();
+
+    /// Interrupts the poll of the reactor thread, so that it picks up new requests.
+    void Notify();
+
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Request>> requests;
+    bool is_stopping = false;
+
+    /// Loopback socket connected to itself, made readable to interrupt polls.
+    Host::Handle wakeup_handle = Host::INVALID_HANDLE;
+
+    Kernel::KernelCore& kernel;
+    std::thread thread;
+};
+
+} // namespace Service::Sockets
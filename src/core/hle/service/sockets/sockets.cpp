@@ -2,17 +2,21 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "core/core.h"
 #include "core/hle/service/sockets/bsd.h"
 #include "core/hle/service/sockets/ethc.h"
+#include "core/hle/service/sockets/network_reactor.h"
 #include "core/hle/service/sockets/nsd.h"
 #include "core/hle/service/sockets/sfdnsres.h"
 #include "core/hle/service/sockets/sockets.h"
 
 namespace Service::Sockets {
 
-void InstallInterfaces(SM::ServiceManager& service_manager) {
-    std::make_shared<BSD>("bsd:s")->InstallAsService(service_manager);
-    std::make_shared<BSD>("bsd:u")->InstallAsService(service_manager);
+void InstallInterfaces(SM::ServiceManager& service_manager, Core::System& system) {
+    // Both services wait on the sockets of the guest with the same reactor thread
+    const auto reactor = std::make_shared<NetworkReactor>(system.Kernel());
+    std::make_shared<BSD>("bsd:s", reactor)->InstallAsService(service_manager);
+    std::make_shared<BSD>("bsd:u", reactor)->InstallAsService(service_manager);
     std::make_shared<BSDCFG>()->InstallAsService(service_manager);
 
     std::make_shared<ETHC_C>()->InstallAsService(service_manager);
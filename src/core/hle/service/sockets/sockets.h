@@ -4,11 +4,134 @@
 
 #pragma once
 
+#include <array>
+#include "common/common_types.h"
 #include "core/hle/service/service.h"
 
 namespace Service::Sockets {
 
+/// Error codes returned by the BSD socket functions along with their result.
+enum class Errno : u32 {
+    SUCCESS = 0,
+    BADF = 9,
+    AGAIN = 11,
+    NOMEM = 12,
+    ACCES = 13,
+    INVAL = 22,
+    MFILE = 24,
+    PIPE = 32,
+    MSGSIZE = 90,
+    PROTONOSUPPORT = 93,
+    OPNOTSUPP = 95,
+    AFNOSUPPORT = 97,
+    ADDRINUSE = 98,
+    ADDRNOTAVAIL = 99,
+    NETDOWN = 100,
+    NETUNREACH = 101,
+    CONNABORTED = 103,
+    CONNRESET = 104,
+    NOBUFS = 105,
+    ISCONN = 106,
+    NOTCONN = 107,
+    TIMEDOUT = 110,
+    CONNREFUSED = 111,
+    HOSTUNREACH = 113,
+    ALREADY = 114,
+    INPROGRESS = 115,
+};
+
+enum class Domain : u32 {
+    INET = 2,
+};
+
+enum class Type : u32 {
+    STREAM = 1,
+    DGRAM = 2,
+    RAW = 3,
+    SEQPACKET = 5,
+};
+
+enum class Protocol : u32 {
+    UNSPECIFIED = 0,
+    ICMP = 1,
+    TCP = 6,
+    UDP = 17,
+};
+
+enum class OptLevel : u32 {
+    SOCKET = 0xffff,
+    TCP = 6,
+};
+
+enum class OptName : u32 {
+    REUSEADDR = 0x4,
+    KEEPALIVE = 0x8,
+    BROADCAST = 0x20,
+    LINGER = 0x80,
+    SNDBUF = 0x1001,
+    RCVBUF = 0x1002,
+    SNDTIMEO = 0x1005,
+    RCVTIMEO = 0x1006,
+    PENDING_ERROR = 0x1007,
+    NODELAY = 0x1,
+};
+
+enum class ShutdownHow : s32 {
+    RD = 0,
+    WR = 1,
+    RDWR = 2,
+};
+
+enum class FcntlCmd : s32 {
+    GETFL = 3,
+    SETFL = 4,
+};
+
+/// Events of PollFD, the same for requested and returned events.
+enum PollEvents : u16 {
+    POLLFD_IN = 1 << 0,
+    POLLFD_PRI = 1 << 1,
+    POLLFD_OUT = 1 << 2,
+    POLLFD_ERR = 1 << 3,
+    POLLFD_HUP = 1 << 4,
+    POLLFD_NVAL = 1 << 5,
+};
+
+/// IPv4 socket address, laid out like the BSD sockaddr_in with the port in network byte order.
+struct SockAddrIn {
+    u8 len;
+    u8 family;
+    std::array<u8, 2> port;
+    std::array<u8, 4> ip;
+    std::array<u8, 8> zeroes;
+};
+static_assert(sizeof(SockAddrIn) == 16, "SockAddrIn is incorrect size");
+
+struct PollFD {
+    s32 fd;
+    u16 events;
+    u16 revents;
+};
+static_assert(sizeof(PollFD) == 8, "PollFD is incorrect size");
+
+struct Linger {
+    u32 onoff;
+    u32 linger;
+};
+static_assert(sizeof(Linger) == 8, "Linger is incorrect size");
+
+struct Timeval {
+    s64 sec;
+    s64 usec;
+};
+static_assert(sizeof(Timeval) == 16, "Timeval is incorrect size");
+
+/// Flag of Recv and Send making blocking sockets return AGAIN instead of blocking.
+constexpr u32 FLAG_MSG_DONTWAIT = 0x80;
+/// Flag of Fcntl for non-blocking sockets.
+constexpr u32 FLAG_O_NONBLOCK = 0x800;
+
 /// Registers all Sockets services with the specified service manager.
-void InstallInterfaces(SM::ServiceManager& service_manager);
+void InstallInterfaces(SM::ServiceManager& service_manager, Core::System& system);
 
 } // namespace Service::Sockets
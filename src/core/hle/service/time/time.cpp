@@ -3,8 +3,10 @@
 // Refer to the license.txt file included.
 
 #include <chrono>
+#include <cstring>
 #include <ctime>
 #include "common/logging/log.h"
+#include "common/uuid.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/core_timing_util.h"
@@ -18,6 +20,9 @@
 
 namespace Service::Time {
 
+/// The contexts of the system clocks are refreshed every second of emulated time
+constexpr s64 CLOCK_UPDATE_TICKS = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE);
+
 static std::chrono::seconds GetSecondsSinceEpoch() {
     return std::chrono::duration_cast<std::chrono::seconds>(
                std::chrono::system_clock::now().time_since_epoch()) +
@@ -71,9 +76,8 @@ enum class ClockContextType {
 
 class ISystemClock final : public ServiceFramework<ISystemClock> {
 public:
-    ISystemClock(std::shared_ptr<Service::Time::SharedMemory> shared_memory,
-                 ClockContextType clock_type)
-        : ServiceFramework("ISystemClock"), shared_memory(shared_memory), clock_type(clock_type) {
+    ISystemClock(std::shared_ptr<Module> time, ClockContextType clock_type)
+        : ServiceFramework("ISystemClock"), time(std::move(time)), clock_type(clock_type) {
         static const FunctionInfo functions[] = {
             {0, &ISystemClock::GetCurrentTime, "GetCurrentTime"},
             {1, nullptr, "SetCurrentTime"},
@@ -82,81 +86,53 @@ public:
 
         };
         RegisterHandlers(functions);
-
-        UpdateSharedMemoryContext(system_clock_context);
     }
 
 private:
     void GetCurrentTime(Kernel::HLERequestContext& ctx) {
-        const s64 time_since_epoch{GetSecondsSinceEpoch().count()};
         LOG_DEBUG(Service_Time, "called");
 
+        // The same computation the guest does with the context of the shared memory
+        const SystemClockContext context = time->GetSystemClockContext();
+        const u64 time_since_epoch = context.offset + time->GetSteadyClockTimePoint().value;
+
         IPC::ResponseBuilder rb{ctx, 4};
         rb.Push(RESULT_SUCCESS);
         rb.Push<u64>(time_since_epoch);
     }
 
     void GetSystemClockContext(Kernel::HLERequestContext& ctx) {
-        LOG_WARNING(Service_Time, "(STUBBED) called");
-
-        // TODO(ogniK): This should be updated periodically however since we have it stubbed we'll
-        // only update when we get a new context
-        UpdateSharedMemoryContext(system_clock_context);
+        LOG_DEBUG(Service_Time, "called, clock_type={}", static_cast<u32>(clock_type));
 
         IPC::ResponseBuilder rb{ctx, (sizeof(SystemClockContext) / 4) + 2};
         rb.Push(RESULT_SUCCESS);
-        rb.PushRaw(system_clock_context);
-    }
-
-    void UpdateSharedMemoryContext(const SystemClockContext& clock_context) {
-        switch (clock_type) {
-        case ClockContextType::StandardLocalSystem:
-            shared_memory->SetStandardLocalSystemClockContext(clock_context);
-            break;
-        case ClockContextType::StandardNetworkSystem:
-            shared_memory->SetStandardNetworkSystemClockContext(clock_context);
-            break;
-        }
+        rb.PushRaw(time->GetSystemClockContext());
     }
 
-    SystemClockContext system_clock_context{};
-    std::shared_ptr<Service::Time::SharedMemory> shared_memory;
+    std::shared_ptr<Module> time;
     ClockContextType clock_type;
 };
 
 class ISteadyClock final : public ServiceFramework<ISteadyClock> {
 public:
-    ISteadyClock(std::shared_ptr<SharedMemory> shared_memory, Core::System& system)
-        : ServiceFramework("ISteadyClock"), shared_memory(shared_memory), system(system) {
+    explicit ISteadyClock(std::shared_ptr<Module> time)
+        : ServiceFramework("ISteadyClock"), time(std::move(time)) {
         static const FunctionInfo functions[] = {
             {0, &ISteadyClock::GetCurrentTimePoint, "GetCurrentTimePoint"},
         };
         RegisterHandlers(functions);
-
-        shared_memory->SetStandardSteadyClockTimepoint(GetCurrentTimePoint());
     }
 
 private:
     void GetCurrentTimePoint(Kernel::HLERequestContext& ctx) {
         LOG_DEBUG(Service_Time, "called");
 
-        const auto time_point = GetCurrentTimePoint();
-        // TODO(ogniK): This should be updated periodically
-        shared_memory->SetStandardSteadyClockTimepoint(time_point);
-
         IPC::ResponseBuilder rb{ctx, (sizeof(SteadyClockTimePoint) / 4) + 2};
         rb.Push(RESULT_SUCCESS);
-        rb.PushRaw(time_point);
+        rb.PushRaw(time->GetSteadyClockTimePoint());
     }
 
-    SteadyClockTimePoint GetCurrentTimePoint() const {
-        const auto& core_timing = system.CoreTiming();
-        const auto ms = Core::Timing::CyclesToMs(core_timing.GetTicks());
-        return {static_cast<u64_le>(ms.count() / 1000), {}};
-    }
-
-    std::shared_ptr<SharedMemory> shared_memory;
-    Core::System& system;
+    std::shared_ptr<Module> time;
 };
 
 class ITimeZoneService final : public ServiceFramework<ITimeZoneService> {
@@ -275,7 +251,7 @@ void Module::Interface::GetStandardUserSystemClock(Kernel::HLERequestContext& ct
 
     IPC::ResponseBuilder rb{ctx, 2, 0, 1};
     rb.Push(RESULT_SUCCESS);
-    rb.PushIpcInterface<ISystemClock>(shared_memory, ClockContextType::StandardUserSystem);
+    rb.PushIpcInterface<ISystemClock>(time, ClockContextType::StandardUserSystem);
 }
 
 void Module::Interface::GetStandardNetworkSystemClock(Kernel::HLERequestContext& ctx) {
@@ -283,7 +259,7 @@ void Module::Interface::GetStandardNetworkSystemClock(Kernel::HLERequestContext&
 
     IPC::ResponseBuilder rb{ctx, 2, 0, 1};
     rb.Push(RESULT_SUCCESS);
-    rb.PushIpcInterface<ISystemClock>(shared_memory, ClockContextType::StandardNetworkSystem);
+    rb.PushIpcInterface<ISystemClock>(time, ClockContextType::StandardNetworkSystem);
 }
 
 void Module::Interface::GetStandardSteadyClock(Kernel::HLERequestContext& ctx) {
@@ -291,7 +267,7 @@ void Module::Interface::GetStandardSteadyClock(Kernel::HLERequestContext& ctx) {
 
     IPC::ResponseBuilder rb{ctx, 2, 0, 1};
     rb.Push(RESULT_SUCCESS);
-    rb.PushIpcInterface<ISteadyClock>(shared_memory, system);
+    rb.PushIpcInterface<ISteadyClock>(time);
 }
 
 void Module::Interface::GetTimeZoneService(Kernel::HLERequestContext& ctx) {
@@ -307,7 +283,7 @@ void Module::Interface::GetStandardLocalSystemClock(Kernel::HLERequestContext& c
 
     IPC::ResponseBuilder rb{ctx, 2, 0, 1};
     rb.Push(RESULT_SUCCESS);
-    rb.PushIpcInterface<ISystemClock>(shared_memory, ClockContextType::StandardLocalSystem);
+    rb.PushIpcInterface<ISystemClock>(time, ClockContextType::StandardLocalSystem);
 }
 
 void Module::Interface::GetClockSnapshot(Kernel::HLERequestContext& ctx) {
@@ -317,8 +293,8 @@ void Module::Interface::GetClockSnapshot(Kernel::HLERequestContext& ctx) {
     const auto initial_type = rp.PopRaw<u8>();
 
     const s64 time_since_epoch{GetSecondsSinceEpoch().count()};
-    const std::time_t time(time_since_epoch);
-    const std::tm* tm = std::localtime(&time);
+    const std::time_t posix_time(time_since_epoch);
+    const std::tm* tm = std::localtime(&posix_time);
     if (tm == nullptr) {
         LOG_ERROR(Service_Time, "tm is a nullptr");
         IPC::ResponseBuilder rb{ctx, 2};
@@ -326,10 +302,6 @@ void Module::Interface::GetClockSnapshot(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    const auto& core_timing = system.CoreTiming();
-    const auto ms = Core::Timing::CyclesToMs(core_timing.GetTicks());
-    const SteadyClockTimePoint steady_clock_time_point{static_cast<u64_le>(ms.count() / 1000), {}};
-
     CalendarTime calendar_time{};
     calendar_time.year = tm->tm_year + 1900;
     calendar_time.month = tm->tm_mon + 1;
@@ -339,6 +311,8 @@ void Module::Interface::GetClockSnapshot(Kernel::HLERequestContext& ctx) {
     calendar_time.second = tm->tm_sec;
 
     ClockSnapshot clock_snapshot{};
+    clock_snapshot.user_clock_context = time->GetSystemClockContext();
+    clock_snapshot.network_clock_context = clock_snapshot.user_clock_context;
     clock_snapshot.system_posix_time = time_since_epoch;
     clock_snapshot.network_posix_time = time_since_epoch;
     clock_snapshot.system_calendar_time = calendar_time;
@@ -350,7 +324,7 @@ void Module::Interface::GetClockSnapshot(Kernel::HLERequestContext& ctx) {
     clock_snapshot.system_calendar_info = additional_info;
     clock_snapshot.network_calendar_info = additional_info;
 
-    clock_snapshot.steady_clock_timepoint = steady_clock_time_point;
+    clock_snapshot.steady_clock_timepoint = time->GetSteadyClockTimePoint();
     clock_snapshot.location_name = LocationName{"UTC"};
     clock_snapshot.clock_auto_adjustment_enabled = 1;
     clock_snapshot.type = initial_type;
@@ -407,6 +381,59 @@ void Module::Interface::SetStandardUserSystemClockAutomaticCorrectionEnabled(
     rb.Push(RESULT_SUCCESS);
 }
 
+Module::Module(Core::System& system, std::shared_ptr<SharedMemory> shared_memory_)
+    : system{system}, shared_memory{std::move(shared_memory_)} {
+    const Common::UUID source_id = Common::UUID::Generate();
+    std::memcpy(clock_source_id.data(), source_id.uuid.data(), sizeof(clock_source_id));
+
+    // The steady clock counts the emulated time since boot, as does the tick counter the guest
+    // computes it from, so it needs no offset
+    shared_memory->SetStandardSteadyClockContext({0, clock_source_id});
+    UpdateSystemClockContext();
+
+    auto& core_timing = system.CoreTiming();
+    clock_update_event = core_timing.RegisterEvent(
+        "Time::ClockUpdateCallback",
+        [this](u64 userdata, s64 cycles_late) { ClockUpdateCallback(userdata, cycles_late); });
+    core_timing.ScheduleEvent(CLOCK_UPDATE_TICKS, clock_update_event);
+}
+
+Module::~Module() {
+    system.CoreTiming().UnscheduleEvent(clock_update_event, 0);
+}
+
+SteadyClockTimePoint Module::GetSteadyClockTimePoint() const {
+    const auto ms = Core::Timing::CyclesToMs(system.CoreTiming().GetTicks());
+    return {static_cast<u64_le>(ms.count() / 1000), clock_source_id};
+}
+
+SystemClockContext Module::GetSystemClockContext() const {
+    std::lock_guard lock{context_mutex};
+    return system_clock_context;
+}
+
+void Module::UpdateSystemClockContext() {
+    const SteadyClockTimePoint time_point = GetSteadyClockTimePoint();
+    const s64 offset = GetSecondsSinceEpoch().count() - static_cast<s64>(time_point.value);
+    const SystemClockContext context{static_cast<u64_le>(offset), time_point};
+    {
+        std::lock_guard lock{context_mutex};
+        // Every store makes the guest retry the reads it's doing, only store actual changes
+        if (system_clock_context.offset == context.offset &&
+            system_clock_context.time_point.source_id == clock_source_id) {
+            return;
+        }
+        system_clock_context = context;
+    }
+    shared_memory->SetStandardLocalSystemClockContext(context);
+    shared_memory->SetStandardNetworkSystemClockContext(context);
+}
+
+void Module::ClockUpdateCallback(u64 userdata, s64 cycles_late) {
+    UpdateSystemClockContext();
+    system.CoreTiming().ScheduleEvent(CLOCK_UPDATE_TICKS - cycles_late, clock_update_event);
+}
+
 Module::Interface::Interface(std::shared_ptr<Module> time,
                              std::shared_ptr<SharedMemory> shared_memory, Core::System& system,
                              const char* name)
@@ -416,8 +443,8 @@ Module::Interface::Interface(std::shared_ptr<Module> time,
 Module::Interface::~Interface() = default;
 
 void InstallInterfaces(Core::System& system) {
-    auto time = std::make_shared<Module>();
     auto shared_mem = std::make_shared<SharedMemory>(system);
+    auto time = std::make_shared<Module>(system, shared_mem);
 
     std::make_shared<Time>(time, shared_mem, system, "time:a")
         ->InstallAsService(system.ServiceManager());
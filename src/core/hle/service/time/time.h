@@ -5,9 +5,15 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <mutex>
 #include "common/common_funcs.h"
 #include "core/hle/service/service.h"
 
+namespace Core::Timing {
+struct EventType;
+}
+
 namespace Service::Time {
 
 class SharedMemory;
@@ -50,6 +56,13 @@ struct SteadyClockTimePoint {
 };
 static_assert(sizeof(SteadyClockTimePoint) == 0x18, "SteadyClockTimePoint is incorrect size");
 
+/// The guest computes the steady time point from its tick counter, in nanoseconds, plus the offset
+struct SteadyClockContext {
+    u64_le internal_offset;
+    SteadyClockTimePoint::SourceID clock_source_id;
+};
+static_assert(sizeof(SteadyClockContext) == 0x18, "SteadyClockContext is incorrect size");
+
 struct SystemClockContext {
     u64_le offset;
     SteadyClockTimePoint time_point;
@@ -77,6 +90,15 @@ static_assert(sizeof(ClockSnapshot) == 0xd0, "ClockSnapshot is an invalid size")
 
 class Module final {
 public:
+    explicit Module(Core::System& system, std::shared_ptr<SharedMemory> shared_memory);
+    ~Module();
+
+    /// Returns the current time point of the standard steady clock, the emulated time since boot.
+    SteadyClockTimePoint GetSteadyClockTimePoint() const;
+
+    /// Returns the context the standard system clocks compute the POSIX time from.
+    SystemClockContext GetSystemClockContext() const;
+
     class Interface : public ServiceFramework<Interface> {
     public:
         explicit Interface(std::shared_ptr<Module> time,
@@ -100,6 +122,25 @@ public:
         std::shared_ptr<SharedMemory> shared_memory;
         Core::System& system;
     };
+
+private:
+    /**
+     * Writes the context of the system clocks to the shared memory, where the guest reads it from
+     * without IPC. It's refreshed periodically so the clocks follow the host clock even when the
+     * emulated time runs slower.
+     */
+    void UpdateSystemClockContext();
+
+    void ClockUpdateCallback(u64 userdata, s64 cycles_late);
+
+    Core::System& system;
+    std::shared_ptr<SharedMemory> shared_memory;
+    SteadyClockTimePoint::SourceID clock_source_id{};
+
+    mutable std::mutex context_mutex;
+    SystemClockContext system_clock_context{};
+
+    Core::Timing::EventType* clock_update_event;
 };
 
 /// Registers all Time services with the specified service manager.
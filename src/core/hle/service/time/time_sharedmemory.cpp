@@ -25,9 +25,9 @@ Kernel::SharedPtr<Kernel::SharedMemory> SharedMemory::GetSharedMemoryHolder() co
     return shared_memory_holder;
 }
 
-void SharedMemory::SetStandardSteadyClockTimepoint(const SteadyClockTimePoint& timepoint) {
-    shared_memory_format.standard_steady_clock_timepoint.StoreData(
-        shared_memory_holder->GetPointer(), timepoint);
+void SharedMemory::SetStandardSteadyClockContext(const SteadyClockContext& context) {
+    shared_memory_format.standard_steady_clock_context.StoreData(
+        shared_memory_holder->GetPointer(), context);
 }
 
 void SharedMemory::SetStandardLocalSystemClockContext(const SystemClockContext& context) {
@@ -45,8 +45,8 @@ void SharedMemory::SetStandardUserSystemClockAutomaticCorrectionEnabled(bool ena
         shared_memory_holder->GetPointer(), enabled);
 }
 
-SteadyClockTimePoint SharedMemory::GetStandardSteadyClockTimepoint() {
-    return shared_memory_format.standard_steady_clock_timepoint.ReadData(
+SteadyClockContext SharedMemory::GetStandardSteadyClockContext() {
+    return shared_memory_format.standard_steady_clock_context.ReadData(
         shared_memory_holder->GetPointer());
 }
 
@@ -4,6 +4,11 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
 #include "common/common_types.h"
 #include "core/hle/kernel/shared_memory.h"
 #include "core/hle/service/time/time.h"
@@ -18,46 +23,50 @@ public:
     Kernel::SharedPtr<Kernel::SharedMemory> GetSharedMemoryHolder() const;
 
     // Set memory barriers in shared memory and update them
-    void SetStandardSteadyClockTimepoint(const SteadyClockTimePoint& timepoint);
+    void SetStandardSteadyClockContext(const SteadyClockContext& context);
     void SetStandardLocalSystemClockContext(const SystemClockContext& context);
     void SetStandardNetworkSystemClockContext(const SystemClockContext& context);
     void SetStandardUserSystemClockAutomaticCorrectionEnabled(bool enabled);
 
     // Pull from memory barriers in the shared memory
-    SteadyClockTimePoint GetStandardSteadyClockTimepoint();
+    SteadyClockContext GetStandardSteadyClockContext();
     SystemClockContext GetStandardLocalSystemClockContext();
     SystemClockContext GetStandardNetworkSystemClockContext();
     bool GetStandardUserSystemClockAutomaticCorrectionEnabled();
 
-    // TODO(ogniK): We have to properly simulate memory barriers, how are we going to do this?
+    /**
+     * A value the guest reads without locking: it reads the counter, the slot it selects, then
+     * the counter again, and retries if the counter changed in between. Stores write the slot the
+     * guest isn't reading before publishing it with the counter.
+     */
     template <typename T, std::size_t Offset>
     struct MemoryBarrier {
         static_assert(std::is_trivially_constructible_v<T>, "T must be trivially constructable");
         u32_le read_attempt{};
         std::array<T, 2> data{};
 
-        // These are not actually memory barriers at the moment as we don't have multicore and all
-        // HLE is mutexed. This will need to properly be implemented when we start updating the time
-        // points on threads. As of right now, we'll be updated both values synchronously and just
-        // incrementing the read_attempt to indicate that we waited.
         void StoreData(u8* shared_memory, T data_to_store) {
-            std::memcpy(this, shared_memory + Offset, sizeof(*this));
-            read_attempt++;
-            data[read_attempt & 1] = data_to_store;
-            std::memcpy(shared_memory + Offset, this, sizeof(*this));
+            u8* const base = shared_memory + Offset;
+            std::memcpy(this, base, sizeof(*this));
+            const u32 next_attempt = read_attempt + 1;
+            data[next_attempt & 1] = data_to_store;
+            std::memcpy(base + offsetof(MemoryBarrier, data), data.data(), sizeof(data));
+            std::atomic_thread_fence(std::memory_order_release);
+            read_attempt = next_attempt;
+            std::memcpy(base + offsetof(MemoryBarrier, read_attempt), &read_attempt,
+                        sizeof(read_attempt));
         }
 
-        // For reading we're just going to read the last stored value. If there was no value stored
-        // it will just end up reading an empty value as intended.
+        // Reads the last stored value, or an empty value if none was stored
         T ReadData(u8* shared_memory) {
             std::memcpy(this, shared_memory + Offset, sizeof(*this));
-            return data[(read_attempt - 1) & 1];
+            return data[read_attempt & 1];
         }
     };
 
     // Shared memory format
     struct Format {
-        MemoryBarrier<SteadyClockTimePoint, 0x0> standard_steady_clock_timepoint;
+        MemoryBarrier<SteadyClockContext, 0x0> standard_steady_clock_context;
         MemoryBarrier<SystemClockContext, 0x38> standard_local_system_clock_context;
         MemoryBarrier<SystemClockContext, 0x80> standard_network_system_clock_context;
         MemoryBarrier<bool, 0xc8> standard_user_system_clock_automatic_correction;
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <cinttypes>
+#include <string>
 #include <vector>
 
 #include "common/common_funcs.h"
@@ -11,6 +12,7 @@
 #include "common/logging/log.h"
 #include "common/lz4_compression.h"
 #include "common/swap.h"
+#include "common/thread.h"
 #include "core/core.h"
 #include "core/file_sys/patch_manager.h"
 #include "core/gdbstub/gdbstub.h"
@@ -48,62 +50,58 @@ std::vector<u8> DecompressSegment(const std::vector<u8>& compressed_data,
 constexpr u32 PageAlignSize(u32 size) {
     return (size + Memory::PAGE_MASK) & ~Memory::PAGE_MASK;
 }
-} // Anonymous namespace
 
-bool NSOHeader::IsSegmentCompressed(size_t segment_num) const {
-    ASSERT_MSG(segment_num < 3, "Invalid segment {}", segment_num);
-    return ((flags >> segment_num) & 1) != 0;
-}
-
-AppLoader_NSO::AppLoader_NSO(FileSys::VirtualFile file) : AppLoader(std::move(file)) {}
-
-FileType AppLoader_NSO::IdentifyType(const FileSys::VirtualFile& file) {
-    u32 magic = 0;
-    if (file->ReadObject(&magic) != sizeof(magic)) {
-        return FileType::Error;
-    }
-
-    if (Common::MakeMagic('N', 'S', 'O', '0') != magic) {
-        return FileType::Error;
-    }
+constexpr std::size_t NUM_SEGMENTS = 3;
 
-    return FileType::NSO;
-}
+/// An NSO as read from its file, segments are decompressed in place afterwards.
+struct ModuleData {
+    std::string name;
+    bool should_pass_arguments;
+    NSOHeader header;
+    std::array<std::vector<u8>, NUM_SEGMENTS> segments;
+};
 
-std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::Process& process,
-                                               const FileSys::VfsFile& file, VAddr load_base,
-                                               bool should_pass_arguments,
-                                               std::optional<FileSys::PatchManager> pm) {
+std::optional<ModuleData> ReadModule(const FileSys::VfsFile& file, bool should_pass_arguments) {
     if (file.GetSize() < sizeof(NSOHeader)) {
         return {};
     }
 
-    NSOHeader nso_header{};
-    if (sizeof(NSOHeader) != file.ReadObject(&nso_header)) {
+    ModuleData module{file.GetName(), should_pass_arguments, {}, {}};
+    if (sizeof(NSOHeader) != file.ReadObject(&module.header)) {
         return {};
     }
 
-    if (nso_header.magic != Common::MakeMagic('N', 'S', 'O', '0')) {
+    if (module.header.magic != Common::MakeMagic('N', 'S', 'O', '0')) {
         return {};
     }
 
+    for (std::size_t i = 0; i < NUM_SEGMENTS; ++i) {
+        module.segments[i] = file.ReadBytes(module.header.segments_compressed_size[i],
+                                            module.header.segments[i].offset);
+    }
+    return module;
+}
+
+/// Builds the program image of a decompressed module and loads it into the process.
+/// @returns The end of the module, where the next one can be loaded
+VAddr MapModule(Kernel::Process& process, ModuleData& module, VAddr load_base,
+                const std::optional<FileSys::PatchManager>& pm) {
+    NSOHeader& nso_header = module.header;
+
     // Build program image
     Kernel::CodeSet codeset;
     Kernel::PhysicalMemory program_image;
-    for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
-        std::vector<u8> data =
-            file.ReadBytes(nso_header.segments_compressed_size[i], nso_header.segments[i].offset);
-        if (nso_header.IsSegmentCompressed(i)) {
-            data = DecompressSegment(data, nso_header.segments[i]);
-        }
+    for (std::size_t i = 0; i < NUM_SEGMENTS; ++i) {
+        const std::vector<u8>& data = module.segments[i];
         program_image.resize(nso_header.segments[i].location);
         program_image.insert(program_image.end(), data.begin(), data.end());
         codeset.segments[i].addr = nso_header.segments[i].location;
         codeset.segments[i].offset = nso_header.segments[i].location;
         codeset.segments[i].size = PageAlignSize(static_cast<u32>(data.size()));
     }
+    module.segments = {};
 
-    if (should_pass_arguments && !Settings::values.program_args.empty()) {
+    if (module.should_pass_arguments && !Settings::values.program_args.empty()) {
         const auto arg_data = Settings::values.program_args;
         codeset.DataSegment().size += NSO_ARGUMENT_DATA_ALLOCATION_SIZE;
         NSOArgumentHeader args_header{
@@ -134,7 +132,8 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::Process& process,
     const u32 image_size{PageAlignSize(static_cast<u32>(program_image.size()) + bss_size)};
     program_image.resize(image_size);
 
-    // Apply patches if necessary
+    // Apply patches if necessary. The mods are read through the VFS, this stays on the calling
+    // thread and is cheap next to the decompression anyway.
     if (pm && (pm->HasNSOPatch(nso_header.build_id) || Settings::values.dump_nso)) {
         std::vector<u8> pi_header;
         pi_header.insert(pi_header.begin(), reinterpret_cast<u8*>(&nso_header),
@@ -142,7 +141,7 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::Process& process,
         pi_header.insert(pi_header.begin() + sizeof(NSOHeader), program_image.begin(),
                          program_image.end());
 
-        pi_header = pm->PatchNSO(pi_header, file.GetName());
+        pi_header = pm->PatchNSO(pi_header, module.name);
 
         std::copy(pi_header.begin() + sizeof(NSOHeader), pi_header.end(), program_image.begin());
     }
@@ -162,10 +161,77 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::Process& process,
     process.LoadModule(std::move(codeset), load_base);
 
     // Register module with GDBStub
-    GDBStub::RegisterModule(file.GetName(), load_base, load_base + program_image.size());
+    GDBStub::RegisterModule(module.name, load_base, load_base + image_size);
 
     return load_base + image_size;
 }
+} // Anonymous namespace
+
+bool NSOHeader::IsSegmentCompressed(size_t segment_num) const {
+    ASSERT_MSG(segment_num < 3, "Invalid segment {}", segment_num);
+    return ((flags >> segment_num) & 1) != 0;
+}
+
+AppLoader_NSO::AppLoader_NSO(FileSys::VirtualFile file) : AppLoader(std::move(file)) {}
+
+FileType AppLoader_NSO::IdentifyType(const FileSys::VirtualFile& file) {
+    u32 magic = 0;
+    if (file->ReadObject(&magic) != sizeof(magic)) {
+        return FileType::Error;
+    }
+
+    if (Common::MakeMagic('N', 'S', 'O', '0') != magic) {
+        return FileType::Error;
+    }
+
+    return FileType::NSO;
+}
+
+std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::Process& process,
+                                               const FileSys::VfsFile& file, VAddr load_base,
+                                               bool should_pass_arguments,
+                                               std::optional<FileSys::PatchManager> pm) {
+    const auto addresses = LoadModules(process, {{&file, should_pass_arguments}}, load_base, pm);
+    if (!addresses) {
+        return {};
+    }
+    return addresses->back();
+}
+
+std::optional<std::vector<VAddr>> AppLoader_NSO::LoadModules(
+    Kernel::Process& process, const std::vector<ModuleFile>& files, VAddr load_base,
+    std::optional<FileSys::PatchManager> pm) {
+    // The files are read on this thread, VFS layers like decryption aren't safe to share
+    std::vector<ModuleData> modules;
+    modules.reserve(files.size());
+    for (const auto& file : files) {
+        auto module = ReadModule(*file.file, file.should_pass_arguments);
+        if (!module) {
+            return {};
+        }
+        modules.push_back(std::move(*module));
+    }
+
+    // Segments don't depend on each other, decompress all of them at once
+    Common::ParallelFor(modules.size() * NUM_SEGMENTS, [&modules](std::size_t index) {
+        ModuleData& module = modules[index / NUM_SEGMENTS];
+        const std::size_t segment = index % NUM_SEGMENTS;
+        if (module.header.IsSegmentCompressed(segment)) {
+            module.segments[segment] =
+                DecompressSegment(module.segments[segment], module.header.segments[segment]);
+        }
+    });
+
+    std::vector<VAddr> addresses;
+    addresses.reserve(modules.size() + 1);
+    VAddr next_load_addr = load_base;
+    for (ModuleData& module : modules) {
+        addresses.push_back(next_load_addr);
+        next_load_addr = MapModule(process, module, next_load_addr, pm);
+    }
+    addresses.push_back(next_load_addr);
+    return addresses;
+}
 
 AppLoader_NSO::LoadResult AppLoader_NSO::Load(Kernel::Process& process) {
     if (is_loaded) {
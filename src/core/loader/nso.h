@@ -7,6 +7,7 @@
 #include <array>
 #include <optional>
 #include <type_traits>
+#include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/file_sys/patch_manager.h"
@@ -84,6 +85,23 @@ public:
                                            VAddr load_base, bool should_pass_arguments,
                                            std::optional<FileSys::PatchManager> pm = {});
 
+    /// An NSO to load with LoadModules.
+    struct ModuleFile {
+        const FileSys::VfsFile* file;
+        bool should_pass_arguments;
+    };
+
+    /**
+     * Loads NSOs one after the other starting at load_base, like LoadModule does for one. The
+     * segments of all of them are decompressed in parallel, the files are read from the calling
+     * thread only.
+     * @returns The load address of each module followed by the end of the last one, or nullopt if
+     * one of them isn't a valid NSO.
+     */
+    static std::optional<std::vector<VAddr>> LoadModules(
+        Kernel::Process& process, const std::vector<ModuleFile>& files, VAddr load_base,
+        std::optional<FileSys::PatchManager> pm = {});
+
     LoadResult Load(Kernel::Process& process) override;
 
     ResultStatus ReadNSOModules(Modules& modules) override;
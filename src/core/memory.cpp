@@ -4,51 +4,162 @@
 
 #include <algorithm>
 #include <cstring>
+#include <mutex>
 #include <optional>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "common/page_table.h"
 #include "common/swap.h"
+#include "common/write_watch.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/vm_manager.h"
 #include "core/memory.h"
 #include "core/memory_setup.h"
+#include "core/settings.h"
 #include "video_core/gpu.h"
 
 namespace Memory {
 
+static_assert(Common::WriteWatch::PAGE_SIZE == PAGE_SIZE, "Write watches must match guest pages");
+
 static Common::PageTable* current_page_table = nullptr;
 
+// Host pages of the cached pages that are write watched instead of going through the slow path,
+// mapped to their guest pages. Mirrors map one host page at more than one guest page. Shared with
+// the GPU thread, which marks pages as cached.
+static std::unordered_multimap<u8*, VAddr> watched_pages;
+static std::mutex watched_pages_mutex;
+// Host pages write watched for the memory freezer, mapped to their guest address. A page can be
+// watched for both, the watch is only ended once neither needs it.
+static std::unordered_map<u8*, VAddr> frozen_pages;
+// Written pages taken from the write watches that their owner hasn't handled yet.
+static std::vector<u8*> pending_watched_writes;
+static std::vector<VAddr> pending_frozen_writes;
+
+static bool IsWriteWatchEnabled() {
+    return Settings::values.use_host_page_protection && Common::WriteWatch::Initialize();
+}
+
+/**
+ * Stops watching a guest page that is no longer cached, the host page stays watched while other
+ * guest pages or the memory freezer need it. Expects watched_pages_mutex to be held.
+ */
+static void EraseWatchedPage(u8* pointer, VAddr page) {
+    const auto [begin, end] = watched_pages.equal_range(pointer);
+    const auto it =
+        std::find_if(begin, end, [page](const auto& entry) { return entry.second == page; });
+    if (it == end) {
+        return;
+    }
+    watched_pages.erase(it);
+    if (watched_pages.count(pointer) == 0 && frozen_pages.count(pointer) == 0) {
+        Common::WriteWatch::Unwatch(pointer);
+    }
+}
+
 void SetCurrentPageTable(Kernel::Process& process) {
     current_page_table = &process.VMManager().page_table;
 
     const std::size_t address_space_width = process.VMManager().GetAddressSpaceWidth();
 
+    // The CPU cores only exist while the system is powered on
     auto& system = Core::System::GetInstance();
+    if (!system.IsPoweredOn()) {
+        return;
+    }
     system.ArmInterface(0).PageTableChanged(*current_page_table, address_space_width);
     system.ArmInterface(1).PageTableChanged(*current_page_table, address_space_width);
     system.ArmInterface(2).PageTableChanged(*current_page_table, address_space_width);
     system.ArmInterface(3).PageTableChanged(*current_page_table, address_space_width);
 }
 
+/**
+ * Takes the pages written since the last call from the write watches and queues them for the
+ * GPU and the memory freezer, whichever watches them. Expects watched_pages_mutex to be held.
+ */
+static void CollectWatchedWrites() {
+    std::vector<u8*> written_pages;
+    if (!Common::WriteWatch::TakeWrittenPages(written_pages)) {
+        LOG_WARNING(HW_Memory, "Lost track of written pages, taking all watched pages as written");
+        for (auto it = watched_pages.begin(); it != watched_pages.end();
+             it = watched_pages.equal_range(it->first).second) {
+            Common::WriteWatch::Unwatch(it->first);
+            written_pages.push_back(it->first);
+        }
+        for (const auto& [pointer, vaddr] : frozen_pages) {
+            Common::WriteWatch::Unwatch(pointer);
+            if (watched_pages.count(pointer) == 0) {
+                written_pages.push_back(pointer);
+            }
+        }
+    }
+    for (u8* const pointer : written_pages) {
+        if (watched_pages.count(pointer) != 0) {
+            pending_watched_writes.push_back(pointer);
+        }
+        const auto it = frozen_pages.find(pointer);
+        if (it != frozen_pages.end()) {
+            pending_frozen_writes.push_back(it->second);
+            frozen_pages.erase(it);
+        }
+    }
+}
+
+/// Stops watching the pages of a range, before they are remapped.
+static void UnwatchPages(const Common::PageTable& page_table, VAddr base, u64 size) {
+    std::lock_guard lock{watched_pages_mutex};
+    if (watched_pages.empty() && frozen_pages.empty()) {
+        return;
+    }
+    for (u64 page = base; page < base + size; page++) {
+        u8* const pointer = page_table.pointers[page];
+        if (pointer == nullptr) {
+            continue;
+        }
+        const auto it = frozen_pages.find(pointer);
+        if (it != frozen_pages.end()) {
+            // The freezer handles it like a write, rewriting its values to the new mapping
+            pending_frozen_writes.push_back(it->second);
+            frozen_pages.erase(it);
+            if (watched_pages.count(pointer) == 0) {
+                Common::WriteWatch::Unwatch(pointer);
+            }
+        }
+        if (page_table.attributes[page] == Common::PageType::RasterizerCachedMemory) {
+            EraseWatchedPage(pointer, page << PAGE_BITS);
+        }
+    }
+}
+
 static void MapPages(Common::PageTable& page_table, VAddr base, u64 size, u8* memory,
                      Common::PageType type) {
     LOG_DEBUG(HW_Memory, "Mapping {} onto {:016X}-{:016X}", fmt::ptr(memory), base * PAGE_SIZE,
               (base + size) * PAGE_SIZE);
 
+    UnwatchPages(page_table, base, size);
+
     // During boot, current_page_table might not be set yet, in which case we need not flush
     if (Core::System::GetInstance().IsPoweredOn()) {
         auto& gpu = Core::System::GetInstance().GPU();
-        for (u64 i = 0; i < size; i++) {
-            const auto page = base + i;
-            if (page_table.attributes[page] == Common::PageType::RasterizerCachedMemory) {
-                gpu.FlushAndInvalidateRegion(page << PAGE_BITS, PAGE_SIZE);
-            }
+        const auto begin = page_table.attributes.begin() + base;
+        const auto end = begin + size;
+        auto run_begin = std::find(begin, end, Common::PageType::RasterizerCachedMemory);
+        while (run_begin != end) {
+            // Flush each run of cached pages at once instead of page by page
+            const auto run_end = std::find_if(run_begin, end, [](Common::PageType type) {
+                return type != Common::PageType::RasterizerCachedMemory;
+            });
+            const u64 first_page = base + static_cast<u64>(run_begin - begin);
+            gpu.FlushAndInvalidateRegion(first_page << PAGE_BITS,
+                                         static_cast<u64>(run_end - run_begin) * PAGE_SIZE);
+            run_begin = std::find(run_end, end, Common::PageType::RasterizerCachedMemory);
         }
     }
 
@@ -60,9 +171,12 @@ static void MapPages(Common::PageTable& page_table, VAddr base, u64 size, u8* me
 
     if (memory == nullptr) {
         std::fill(page_table.pointers.begin() + base, page_table.pointers.begin() + end, memory);
+        std::fill(page_table.backing_pointers.begin() + base,
+                  page_table.backing_pointers.begin() + end, memory);
     } else {
         while (base != end) {
             page_table.pointers[base] = memory;
+            page_table.backing_pointers[base] = memory;
 
             base += 1;
             memory += PAGE_SIZE;
@@ -82,10 +196,8 @@ void MapIoRegion(Common::PageTable& page_table, VAddr base, u64 size,
     ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: {:016X}", base);
     MapPages(page_table, base / PAGE_SIZE, size / PAGE_SIZE, nullptr, Common::PageType::Special);
 
-    auto interval = boost::icl::discrete_interval<VAddr>::closed(base, base + size - 1);
     Common::SpecialRegion region{Common::SpecialRegion::Type::IODevice, std::move(mmio_handler)};
-    page_table.special_regions.add(
-        std::make_pair(interval, std::set<Common::SpecialRegion>{region}));
+    page_table.AddSpecialRegion(base / PAGE_SIZE, size / PAGE_SIZE, region);
 }
 
 void UnmapRegion(Common::PageTable& page_table, VAddr base, u64 size) {
@@ -93,60 +205,109 @@ void UnmapRegion(Common::PageTable& page_table, VAddr base, u64 size) {
     ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: {:016X}", base);
     MapPages(page_table, base / PAGE_SIZE, size / PAGE_SIZE, nullptr, Common::PageType::Unmapped);
 
-    auto interval = boost::icl::discrete_interval<VAddr>::closed(base, base + size - 1);
-    page_table.special_regions.erase(interval);
+    page_table.ClearSpecialRegions(base / PAGE_SIZE, size / PAGE_SIZE);
 }
 
 void AddDebugHook(Common::PageTable& page_table, VAddr base, u64 size,
                   Common::MemoryHookPointer hook) {
-    auto interval = boost::icl::discrete_interval<VAddr>::closed(base, base + size - 1);
+    ASSERT_MSG((size & PAGE_MASK) == 0, "non-page aligned size: {:016X}", size);
+    ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: {:016X}", base);
+    const u64 first_page = base / PAGE_SIZE;
+    const u64 num_pages = size / PAGE_SIZE;
+
     Common::SpecialRegion region{Common::SpecialRegion::Type::DebugHook, std::move(hook)};
-    page_table.special_regions.add(
-        std::make_pair(interval, std::set<Common::SpecialRegion>{region}));
+    page_table.AddSpecialRegion(first_page, num_pages, region);
+
+    // The hooks only see the accesses that take the slow path, so the pages of the region lose
+    // their pointer. Their memory stays in the backing pointers, the hooks only observe it.
+    UnwatchPages(page_table, first_page, num_pages);
+    const bool is_powered_on = Core::System::GetInstance().IsPoweredOn();
+    for (u64 page = first_page; page < first_page + num_pages; ++page) {
+        Common::PageType& type = page_table.attributes[page];
+        if (type != Common::PageType::Memory && type != Common::PageType::RasterizerCachedMemory) {
+            continue;
+        }
+        if (type == Common::PageType::RasterizerCachedMemory && is_powered_on) {
+            Core::System::GetInstance().GPU().FlushRegion(
+                ToCacheAddr(page_table.backing_pointers[page]), PAGE_SIZE);
+        }
+        type = Common::PageType::Special;
+        page_table.pointers[page] = nullptr;
+    }
 }
 
 void RemoveDebugHook(Common::PageTable& page_table, VAddr base, u64 size,
                      Common::MemoryHookPointer hook) {
-    auto interval = boost::icl::discrete_interval<VAddr>::closed(base, base + size - 1);
+    ASSERT_MSG((size & PAGE_MASK) == 0, "non-page aligned size: {:016X}", size);
+    ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: {:016X}", base);
+    const u64 first_page = base / PAGE_SIZE;
+    const u64 num_pages = size / PAGE_SIZE;
+
     Common::SpecialRegion region{Common::SpecialRegion::Type::DebugHook, std::move(hook)};
-    page_table.special_regions.subtract(
-        std::make_pair(interval, std::set<Common::SpecialRegion>{region}));
+    page_table.RemoveSpecialRegion(first_page, num_pages, region);
+
+    // Pages with memory and no hooks left go back to the fast path. The GPU may have cached them
+    // while they were hooked, their caches are dropped as they can't be tracked as regular memory.
+    const bool is_powered_on = Core::System::GetInstance().IsPoweredOn();
+    for (u64 page = first_page; page < first_page + num_pages; ++page) {
+        u8* const pointer = page_table.backing_pointers[page];
+        if (page_table.attributes[page] != Common::PageType::Special || pointer == nullptr ||
+            !page_table.GetSpecialRegions(page).empty()) {
+            continue;
+        }
+        if (is_powered_on) {
+            Core::System::GetInstance().GPU().FlushAndInvalidateRegion(ToCacheAddr(pointer),
+                                                                       PAGE_SIZE);
+        }
+        page_table.attributes[page] = Common::PageType::Memory;
+        page_table.pointers[page] = pointer;
+    }
 }
 
 /**
- * Gets a pointer to the exact memory at the virtual address (i.e. not page aligned)
- * using a VMA from the current process
+ * Gets a pointer to the exact memory at the virtual address (i.e. not page aligned) from the
+ * backing pointers of a page table, null if the page has no memory.
  */
-static u8* GetPointerFromVMA(const Kernel::Process& process, VAddr vaddr) {
-    const auto& vm_manager = process.VMManager();
-
-    const auto it = vm_manager.FindVMA(vaddr);
-    DEBUG_ASSERT(vm_manager.IsValidHandle(it));
-
-    u8* direct_pointer = nullptr;
-    const auto& vma = it->second;
-    switch (vma.type) {
-    case Kernel::VMAType::AllocatedMemoryBlock:
-        direct_pointer = vma.backing_block->data() + vma.offset;
-        break;
-    case Kernel::VMAType::BackingMemory:
-        direct_pointer = vma.backing_memory;
-        break;
-    case Kernel::VMAType::Free:
+static u8* GetBackingPointer(const Common::PageTable& page_table, VAddr vaddr) {
+    u8* const page_pointer = page_table.backing_pointers[vaddr >> PAGE_BITS];
+    if (page_pointer == nullptr) {
         return nullptr;
-    default:
-        UNREACHABLE();
     }
-
-    return direct_pointer + (vaddr - vma.base);
+    return page_pointer + (vaddr & PAGE_MASK);
 }
 
 /**
- * Gets a pointer to the exact memory at the virtual address (i.e. not page aligned)
- * using a VMA from the current process.
+ * Gets a pointer to the exact memory at the virtual address (i.e. not page aligned) from the
+ * backing pointers of the current page table.
  */
-static u8* GetPointerFromVMA(VAddr vaddr) {
-    return GetPointerFromVMA(*Core::System::GetInstance().CurrentProcess(), vaddr);
+static u8* GetBackingPointer(VAddr vaddr) {
+    return GetBackingPointer(*current_page_table, vaddr);
+}
+
+template <typename T>
+static std::optional<T> ReadHook(Common::MemoryHook& hook, VAddr vaddr) {
+    if constexpr (sizeof(T) == 1) {
+        return hook.Read8(vaddr);
+    } else if constexpr (sizeof(T) == 2) {
+        return hook.Read16(vaddr);
+    } else if constexpr (sizeof(T) == 4) {
+        return hook.Read32(vaddr);
+    } else {
+        return hook.Read64(vaddr);
+    }
+}
+
+template <typename T>
+static bool WriteHook(Common::MemoryHook& hook, VAddr vaddr, T data) {
+    if constexpr (sizeof(T) == 1) {
+        return hook.Write8(vaddr, data);
+    } else if constexpr (sizeof(T) == 2) {
+        return hook.Write16(vaddr, data);
+    } else if constexpr (sizeof(T) == 4) {
+        return hook.Write32(vaddr, data);
+    } else {
+        return hook.Write64(vaddr, data);
+    }
 }
 
 template <typename T>
@@ -168,7 +329,24 @@ T Read(const VAddr vaddr) {
         ASSERT_MSG(false, "Mapped memory page without a pointer @ {:016X}", vaddr);
         break;
     case Common::PageType::RasterizerCachedMemory: {
-        auto host_ptr{GetPointerFromVMA(vaddr)};
+        auto host_ptr{GetBackingPointer(vaddr)};
+        Core::System::GetInstance().GPU().FlushRegion(ToCacheAddr(host_ptr), sizeof(T));
+        T value;
+        std::memcpy(&value, host_ptr, sizeof(T));
+        return value;
+    }
+    case Common::PageType::Special: {
+        // Debug hooks observe the access and leave it to the memory, IO devices answer it
+        for (const auto& region : current_page_table->GetSpecialRegions(vaddr >> PAGE_BITS)) {
+            if (const auto value = ReadHook<T>(*region.handler, vaddr)) {
+                return *value;
+            }
+        }
+        auto host_ptr{GetBackingPointer(vaddr)};
+        if (host_ptr == nullptr) {
+            LOG_ERROR(HW_Memory, "Unhandled special Read{} @ 0x{:016X}", sizeof(T) * 8, vaddr);
+            return 0;
+        }
         Core::System::GetInstance().GPU().FlushRegion(ToCacheAddr(host_ptr), sizeof(T));
         T value;
         std::memcpy(&value, host_ptr, sizeof(T));
@@ -199,7 +377,23 @@ void Write(const VAddr vaddr, const T data) {
         ASSERT_MSG(false, "Mapped memory page without a pointer @ {:016X}", vaddr);
         break;
     case Common::PageType::RasterizerCachedMemory: {
-        auto host_ptr{GetPointerFromVMA(vaddr)};
+        auto host_ptr{GetBackingPointer(vaddr)};
+        Core::System::GetInstance().GPU().InvalidateRegion(ToCacheAddr(host_ptr), sizeof(T));
+        std::memcpy(host_ptr, &data, sizeof(T));
+        break;
+    }
+    case Common::PageType::Special: {
+        for (const auto& region : current_page_table->GetSpecialRegions(vaddr >> PAGE_BITS)) {
+            if (WriteHook<T>(*region.handler, vaddr, data)) {
+                return;
+            }
+        }
+        auto host_ptr{GetBackingPointer(vaddr)};
+        if (host_ptr == nullptr) {
+            LOG_ERROR(HW_Memory, "Unhandled special Write{} 0x{:08X} @ 0x{:016X}",
+                      sizeof(data) * 8, static_cast<u32>(data), vaddr);
+            return;
+        }
         Core::System::GetInstance().GPU().InvalidateRegion(ToCacheAddr(host_ptr), sizeof(T));
         std::memcpy(host_ptr, &data, sizeof(T));
         break;
@@ -222,6 +416,18 @@ bool IsValidVirtualAddress(const Kernel::Process& process, const VAddr vaddr) {
     if (page_table.attributes[vaddr >> PAGE_BITS] != Common::PageType::Special)
         return false;
 
+    // Memory with debug hooks
+    if (page_table.backing_pointers[vaddr >> PAGE_BITS] != nullptr)
+        return true;
+
+    for (const auto& region : page_table.GetSpecialRegions(vaddr >> PAGE_BITS)) {
+        if (region.type != Common::SpecialRegion::Type::IODevice) {
+            continue;
+        }
+        if (const auto result = region.handler->IsValidAddress(vaddr)) {
+            return *result;
+        }
+    }
     return false;
 }
 
@@ -239,15 +445,41 @@ u8* GetPointer(const VAddr vaddr) {
         return page_pointer + (vaddr & PAGE_MASK);
     }
 
-    if (current_page_table->attributes[vaddr >> PAGE_BITS] ==
-        Common::PageType::RasterizerCachedMemory) {
-        return GetPointerFromVMA(vaddr);
+    const Common::PageType type = current_page_table->attributes[vaddr >> PAGE_BITS];
+    if (type == Common::PageType::RasterizerCachedMemory) {
+        return GetBackingPointer(vaddr);
+    }
+    if (type == Common::PageType::Special) {
+        if (u8* const pointer = GetBackingPointer(vaddr)) {
+            return pointer;
+        }
     }
 
     LOG_ERROR(HW_Memory, "Unknown GetPointer @ 0x{:016X}", vaddr);
     return nullptr;
 }
 
+u8* GetContiguousPointer(const VAddr vaddr, const std::size_t size) {
+    if (size == 0 || vaddr + size < vaddr) {
+        return nullptr;
+    }
+    const VAddr first_page = vaddr >> PAGE_BITS;
+    const VAddr last_page = (vaddr + size - 1) >> PAGE_BITS;
+    if (last_page >= current_page_table->pointers.size()) {
+        return nullptr;
+    }
+    u8* const base = current_page_table->pointers[first_page];
+    if (base == nullptr) {
+        return nullptr;
+    }
+    for (VAddr page = first_page + 1; page <= last_page; ++page) {
+        if (current_page_table->pointers[page] != base + ((page - first_page) << PAGE_BITS)) {
+            return nullptr;
+        }
+    }
+    return base + (vaddr & PAGE_MASK);
+}
+
 std::string ReadCString(VAddr vaddr, std::size_t max_length) {
     std::string string;
     string.reserve(max_length);
@@ -271,6 +503,15 @@ void RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached) {
     // space, marking the region as un/cached. The region is marked un/cached at a granularity of
     // CPU pages, hence why we iterate on a CPU page basis (note: GPU page size is different). This
     // assumes the specified GPU address region is contiguous as well.
+    //
+    // With write watches, cached pages keep their pointer so reads and writes stay on the fast
+    // path. Their host pages are write protected instead and the GPU caches are invalidated on
+    // the first write, see InvalidateWatchedWrites. Reads aren't trapped, so accurate GPU
+    // emulation, which flushes the GPU writes before the CPU reads them, keeps the slow path.
+
+    const bool use_write_watch =
+        cached && !Settings::values.use_accurate_gpu_emulation && IsWriteWatchEnabled();
+    std::lock_guard lock{watched_pages_mutex};
 
     u64 num_pages = ((vaddr + size - 1) >> PAGE_BITS) - (vaddr >> PAGE_BITS) + 1;
     for (unsigned i = 0; i < num_pages; ++i, vaddr += PAGE_SIZE) {
@@ -283,13 +524,29 @@ void RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached) {
                 // It is not necessary for a process to have this region mapped into its address
                 // space, for example, a system module need not have a VRAM mapping.
                 break;
-            case Common::PageType::Memory:
+            case Common::PageType::Memory: {
                 page_type = Common::PageType::RasterizerCachedMemory;
-                current_page_table->pointers[vaddr >> PAGE_BITS] = nullptr;
+                u8*& pointer = current_page_table->pointers[vaddr >> PAGE_BITS];
+                if (use_write_watch && Common::WriteWatch::Watch(pointer)) {
+                    watched_pages.emplace(pointer, vaddr & ~PAGE_MASK);
+                } else {
+                    pointer = nullptr;
+                }
                 break;
-            case Common::PageType::RasterizerCachedMemory:
+            }
+            case Common::PageType::RasterizerCachedMemory: {
                 // There can be more than one GPU region mapped per CPU region, so it's common that
-                // this area is already marked as cached.
+                // this area is already marked as cached. Pages watched before write watches were
+                // turned off, e.g. by enabling accurate GPU emulation, move to the slow path.
+                u8*& pointer = current_page_table->pointers[vaddr >> PAGE_BITS];
+                if (pointer != nullptr && !use_write_watch) {
+                    EraseWatchedPage(pointer, vaddr & ~PAGE_MASK);
+                    pointer = nullptr;
+                }
+                break;
+            }
+            case Common::PageType::Special:
+                // Every access to pages with debug hooks already flushes and invalidates the caches
                 break;
             default:
                 UNREACHABLE();
@@ -306,10 +563,16 @@ void RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached) {
                 // this area is already unmarked as cached.
                 break;
             case Common::PageType::RasterizerCachedMemory: {
-                u8* pointer = GetPointerFromVMA(vaddr & ~PAGE_MASK);
+                u8* const watched_pointer = current_page_table->pointers[vaddr >> PAGE_BITS];
+                if (watched_pointer != nullptr) {
+                    EraseWatchedPage(watched_pointer, vaddr & ~PAGE_MASK);
+                    page_type = Common::PageType::Memory;
+                    break;
+                }
+                u8* pointer = GetBackingPointer(vaddr & ~PAGE_MASK);
                 if (pointer == nullptr) {
                     // It's possible that this function has been called while updating the pagetable
-                    // after unmapping a VMA. In that case the underlying VMA will no longer exist,
+                    // after unmapping a VMA. In that case the page has no backing memory anymore,
                     // and we should just leave the pagetable entry blank.
                     page_type = Common::PageType::Unmapped;
                 } else {
@@ -318,6 +581,8 @@ void RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached) {
                 }
                 break;
             }
+            case Common::PageType::Special:
+                break;
             default:
                 UNREACHABLE();
             }
@@ -325,6 +590,75 @@ void RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached) {
     }
 }
 
+void InvalidateWatchedWrites() {
+    if (!IsWriteWatchEnabled()) {
+        return;
+    }
+    std::vector<u8*> written_pages;
+    {
+        std::lock_guard lock{watched_pages_mutex};
+        CollectWatchedWrites();
+        written_pages.swap(pending_watched_writes);
+        for (u8* const pointer : written_pages) {
+            // The page is writable again, later writes through any of its guest pages take the
+            // slow path until they're uncached. Pages uncached after they were written are gone.
+            const auto [begin, end] = watched_pages.equal_range(pointer);
+            for (auto it = begin; it != end; ++it) {
+                current_page_table->pointers[it->second >> PAGE_BITS] = nullptr;
+            }
+            watched_pages.erase(begin, end);
+        }
+    }
+
+    // Invalidating unregisters cached objects, which takes the lock when pages are uncached
+    auto& gpu = Core::System::GetInstance().GPU();
+    for (u8* const pointer : written_pages) {
+        gpu.InvalidateRegion(ToCacheAddr(pointer), PAGE_SIZE);
+    }
+}
+
+bool WatchFrozenPage(VAddr vaddr) {
+    if (current_page_table == nullptr || !IsWriteWatchEnabled()) {
+        return false;
+    }
+    std::lock_guard lock{watched_pages_mutex};
+    const VAddr page = vaddr & ~PAGE_MASK;
+    u8* const pointer = current_page_table->pointers[page >> PAGE_BITS];
+    // Cached pages without a pointer take the slow path, their writes can't be watched
+    if (pointer == nullptr || !Common::WriteWatch::Watch(pointer)) {
+        return false;
+    }
+    frozen_pages.insert_or_assign(pointer, page);
+    return true;
+}
+
+void UnwatchFrozenPage(VAddr vaddr) {
+    if (current_page_table == nullptr) {
+        return;
+    }
+    std::lock_guard lock{watched_pages_mutex};
+    const VAddr page = vaddr & ~PAGE_MASK;
+    u8* const pointer = current_page_table->pointers[page >> PAGE_BITS];
+    const auto it = frozen_pages.find(pointer);
+    if (pointer == nullptr || it == frozen_pages.end() || it->second != page) {
+        return;
+    }
+    if (watched_pages.count(pointer) == 0) {
+        Common::WriteWatch::Unwatch(pointer);
+    }
+    frozen_pages.erase(it);
+}
+
+void TakeFrozenPageWrites(std::vector<VAddr>& pages) {
+    if (!IsWriteWatchEnabled()) {
+        return;
+    }
+    std::lock_guard lock{watched_pages_mutex};
+    CollectWatchedWrites();
+    pages.insert(pages.end(), pending_frozen_writes.begin(), pending_frozen_writes.end());
+    pending_frozen_writes.clear();
+}
+
 u8 Read8(const VAddr addr) {
     return Read<u8>(addr);
 }
@@ -341,51 +675,86 @@ u64 Read64(const VAddr addr) {
     return Read<u64_le>(addr);
 }
 
-void ReadBlock(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
-               const std::size_t size) {
-    const auto& page_table = process.VMManager().page_table;
-
-    std::size_t remaining_size = size;
-    std::size_t page_index = src_addr >> PAGE_BITS;
-    std::size_t page_offset = src_addr & PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount =
-            std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
-        case Common::PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "Unmapped ReadBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
-                      current_vaddr, src_addr, size);
-            std::memset(dest_buffer, 0, copy_amount);
-            break;
+/**
+ * Splits a range of guest memory into runs of pages of the same type, whose backing memory is
+ * contiguous for mapped pages, and calls the handler of the type of each run once.
+ * @param on_unmapped Handles runs of unmapped pages, called with the guest address of the run.
+ * @param on_memory Handles runs of regular memory, called with the host pointer of the run.
+ * @param on_cached Handles runs of rasterizer cached memory and of memory with debug hooks, called
+ *                  with the host pointer of the run. Block accesses are not seen by the hooks.
+ * All handlers are also given the size of the run and its offset from the start of the range.
+ */
+template <typename OnUnmapped, typename OnMemory, typename OnCached>
+static void WalkBlock(const Common::PageTable& page_table, const VAddr addr, const std::size_t size,
+                      OnUnmapped&& on_unmapped, OnMemory&& on_memory, OnCached&& on_cached) {
+    std::size_t offset = 0;
+    while (offset < size) {
+        const VAddr run_vaddr = addr + offset;
+        const std::size_t first_page = run_vaddr >> PAGE_BITS;
+        const Common::PageType type = page_table.attributes[first_page];
+        u8* const run_pointer = page_table.backing_pointers[first_page];
+
+        // Extend the run while the next pages have the same type and follow in host memory
+        std::size_t run_size = PAGE_SIZE - (run_vaddr & PAGE_MASK);
+        std::size_t page = first_page + 1;
+        while (run_size < size - offset && page_table.attributes[page] == type &&
+               (type == Common::PageType::Unmapped ||
+                (run_pointer == nullptr ? page_table.backing_pointers[page] == nullptr
+                                        : page_table.backing_pointers[page] ==
+                                              run_pointer + (page - first_page) * PAGE_SIZE))) {
+            run_size += PAGE_SIZE;
+            ++page;
         }
-        case Common::PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
+        run_size = std::min(run_size, size - offset);
 
-            const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-            std::memcpy(dest_buffer, src_ptr, copy_amount);
+        switch (type) {
+        case Common::PageType::Unmapped:
+            on_unmapped(run_vaddr, run_size, offset);
             break;
-        }
-        case Common::PageType::RasterizerCachedMemory: {
-            const auto& host_ptr{GetPointerFromVMA(process, current_vaddr)};
-            Core::System::GetInstance().GPU().FlushRegion(ToCacheAddr(host_ptr), copy_amount);
-            std::memcpy(dest_buffer, host_ptr, copy_amount);
+        case Common::PageType::Memory:
+            DEBUG_ASSERT(page_table.pointers[first_page]);
+            on_memory(run_pointer + (run_vaddr & PAGE_MASK), run_size, offset);
+            break;
+        case Common::PageType::RasterizerCachedMemory:
+            on_cached(run_pointer + (run_vaddr & PAGE_MASK), run_size, offset);
+            break;
+        case Common::PageType::Special:
+            // IO devices have no memory to access as a block
+            if (run_pointer == nullptr) {
+                on_unmapped(run_vaddr, run_size, offset);
+            } else {
+                on_cached(run_pointer + (run_vaddr & PAGE_MASK), run_size, offset);
+            }
             break;
-        }
         default:
             UNREACHABLE();
         }
-
-        page_index++;
-        page_offset = 0;
-        dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-        remaining_size -= copy_amount;
+        offset += run_size;
     }
 }
 
+void ReadBlock(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
+               const std::size_t size) {
+    const auto& page_table = process.VMManager().page_table;
+    u8* const dest = static_cast<u8*>(dest_buffer);
+
+    WalkBlock(
+        page_table, src_addr, size,
+        [&](VAddr vaddr, std::size_t run_size, std::size_t offset) {
+            LOG_ERROR(HW_Memory,
+                      "Unmapped ReadBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
+                      vaddr, src_addr, size);
+            std::memset(dest + offset, 0, run_size);
+        },
+        [&](const u8* host_ptr, std::size_t run_size, std::size_t offset) {
+            std::memcpy(dest + offset, host_ptr, run_size);
+        },
+        [&](const u8* host_ptr, std::size_t run_size, std::size_t offset) {
+            Core::System::GetInstance().GPU().FlushRegion(ToCacheAddr(host_ptr), run_size);
+            std::memcpy(dest + offset, host_ptr, run_size);
+        });
+}
+
 void ReadBlock(const VAddr src_addr, void* dest_buffer, const std::size_t size) {
     ReadBlock(*Core::System::GetInstance().CurrentProcess(), src_addr, dest_buffer, size);
 }
@@ -409,44 +778,22 @@ void Write64(const VAddr addr, const u64 data) {
 void WriteBlock(const Kernel::Process& process, const VAddr dest_addr, const void* src_buffer,
                 const std::size_t size) {
     const auto& page_table = process.VMManager().page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = dest_addr >> PAGE_BITS;
-    std::size_t page_offset = dest_addr & PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount =
-            std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
+    const u8* const src = static_cast<const u8*>(src_buffer);
 
-        switch (page_table.attributes[page_index]) {
-        case Common::PageType::Unmapped: {
+    WalkBlock(
+        page_table, dest_addr, size,
+        [&](VAddr vaddr, std::size_t run_size, std::size_t offset) {
             LOG_ERROR(HW_Memory,
                       "Unmapped WriteBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
-                      current_vaddr, dest_addr, size);
-            break;
-        }
-        case Common::PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-
-            u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-            std::memcpy(dest_ptr, src_buffer, copy_amount);
-            break;
-        }
-        case Common::PageType::RasterizerCachedMemory: {
-            const auto& host_ptr{GetPointerFromVMA(process, current_vaddr)};
-            Core::System::GetInstance().GPU().InvalidateRegion(ToCacheAddr(host_ptr), copy_amount);
-            std::memcpy(host_ptr, src_buffer, copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+                      vaddr, dest_addr, size);
+        },
+        [&](u8* host_ptr, std::size_t run_size, std::size_t offset) {
+            std::memcpy(host_ptr, src + offset, run_size);
+        },
+        [&](u8* host_ptr, std::size_t run_size, std::size_t offset) {
+            Core::System::GetInstance().GPU().InvalidateRegion(ToCacheAddr(host_ptr), run_size);
+            std::memcpy(host_ptr, src + offset, run_size);
+        });
 }
 
 void WriteBlock(const VAddr dest_addr, const void* src_buffer, const std::size_t size) {
@@ -455,87 +802,43 @@ void WriteBlock(const VAddr dest_addr, const void* src_buffer, const std::size_t
 
 void ZeroBlock(const Kernel::Process& process, const VAddr dest_addr, const std::size_t size) {
     const auto& page_table = process.VMManager().page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = dest_addr >> PAGE_BITS;
-    std::size_t page_offset = dest_addr & PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount =
-            std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
 
-        switch (page_table.attributes[page_index]) {
-        case Common::PageType::Unmapped: {
+    WalkBlock(
+        page_table, dest_addr, size,
+        [&](VAddr vaddr, std::size_t run_size, std::size_t offset) {
             LOG_ERROR(HW_Memory,
                       "Unmapped ZeroBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
-                      current_vaddr, dest_addr, size);
-            break;
-        }
-        case Common::PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-
-            u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-            std::memset(dest_ptr, 0, copy_amount);
-            break;
-        }
-        case Common::PageType::RasterizerCachedMemory: {
-            const auto& host_ptr{GetPointerFromVMA(process, current_vaddr)};
-            Core::System::GetInstance().GPU().InvalidateRegion(ToCacheAddr(host_ptr), copy_amount);
-            std::memset(host_ptr, 0, copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        remaining_size -= copy_amount;
-    }
+                      vaddr, dest_addr, size);
+        },
+        [&](u8* host_ptr, std::size_t run_size, std::size_t offset) {
+            std::memset(host_ptr, 0, run_size);
+        },
+        [&](u8* host_ptr, std::size_t run_size, std::size_t offset) {
+            Core::System::GetInstance().GPU().InvalidateRegion(ToCacheAddr(host_ptr), run_size);
+            std::memset(host_ptr, 0, run_size);
+        });
 }
 
 void CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
                const std::size_t size) {
     const auto& page_table = process.VMManager().page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = src_addr >> PAGE_BITS;
-    std::size_t page_offset = src_addr & PAGE_MASK;
 
-    while (remaining_size > 0) {
-        const std::size_t copy_amount =
-            std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
-        case Common::PageType::Unmapped: {
+    // Each run of the source is written straight from its host memory
+    WalkBlock(
+        page_table, src_addr, size,
+        [&](VAddr vaddr, std::size_t run_size, std::size_t offset) {
             LOG_ERROR(HW_Memory,
                       "Unmapped CopyBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
-                      current_vaddr, src_addr, size);
-            ZeroBlock(process, dest_addr, copy_amount);
-            break;
-        }
-        case Common::PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-            const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-            WriteBlock(process, dest_addr, src_ptr, copy_amount);
-            break;
-        }
-        case Common::PageType::RasterizerCachedMemory: {
-            const auto& host_ptr{GetPointerFromVMA(process, current_vaddr)};
-            Core::System::GetInstance().GPU().FlushRegion(ToCacheAddr(host_ptr), copy_amount);
-            WriteBlock(process, dest_addr, host_ptr, copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        dest_addr += static_cast<VAddr>(copy_amount);
-        src_addr += static_cast<VAddr>(copy_amount);
-        remaining_size -= copy_amount;
-    }
+                      vaddr, src_addr, size);
+            ZeroBlock(process, dest_addr + offset, run_size);
+        },
+        [&](const u8* host_ptr, std::size_t run_size, std::size_t offset) {
+            WriteBlock(process, dest_addr + offset, host_ptr, run_size);
+        },
+        [&](const u8* host_ptr, std::size_t run_size, std::size_t offset) {
+            Core::System::GetInstance().GPU().FlushRegion(ToCacheAddr(host_ptr), run_size);
+            WriteBlock(process, dest_addr + offset, host_ptr, run_size);
+        });
 }
 
 void CopyBlock(VAddr dest_addr, VAddr src_addr, std::size_t size) {
@@ -6,6 +6,7 @@
 
 #include <cstddef>
 #include <string>
+#include <vector>
 #include "common/common_types.h"
 
 namespace Kernel {
@@ -66,6 +67,13 @@ void CopyBlock(VAddr dest_addr, VAddr src_addr, std::size_t size);
 
 u8* GetPointer(VAddr vaddr);
 
+/**
+ * Returns a pointer to a region of the current process if all its pages are backed by contiguous
+ * host memory that isn't cached by the rasterizer, null otherwise. Accesses through the pointer
+ * then behave like ReadBlock and WriteBlock without the copy.
+ */
+u8* GetContiguousPointer(VAddr vaddr, std::size_t size);
+
 std::string ReadCString(VAddr vaddr, std::size_t max_length);
 
 /**
@@ -73,4 +81,26 @@ std::string ReadCString(VAddr vaddr, std::size_t max_length);
  */
 void RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached);
 
+/**
+ * Invalidates the GPU caches of the write watched pages written since the last call. Has to be
+ * called before the GPU uses memory written by the CPU.
+ */
+void InvalidateWatchedWrites();
+
+/**
+ * Write watches the page of an address for the memory freezer, the next write to the page is
+ * reported by TakeFrozenPageWrites, which ends the watch.
+ * @returns True if the page is watched, false if writes to it can't be detected.
+ */
+bool WatchFrozenPage(VAddr vaddr);
+
+/// Stops watching the page of an address for the memory freezer.
+void UnwatchFrozenPage(VAddr vaddr);
+
+/**
+ * Appends the page aligned addresses of the pages watched for the memory freezer that were
+ * written or remapped since the last call. Their watches have ended.
+ */
+void TakeFrozenPageWrites(std::vector<VAddr>& pages);
+
 } // namespace Memory
@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include <locale>
+#include <vector>
 #include "common/hex_util.h"
 #include "common/microprofile.h"
 #include "common/swap.h"
@@ -20,7 +22,7 @@ namespace Memory {
 constexpr s64 CHEAT_ENGINE_TICKS = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 12);
 constexpr u32 KEYPAD_BITMASK = 0x3FFFFFF;
 
-StandardVmCallbacks::StandardVmCallbacks(const Core::System& system,
+StandardVmCallbacks::StandardVmCallbacks(Core::System& system,
                                          const CheatProcessMetadata& metadata)
     : metadata(metadata), system(system) {}
 
@@ -31,7 +33,21 @@ void StandardVmCallbacks::MemoryRead(VAddr address, void* data, u64 size) {
 }
 
 void StandardVmCallbacks::MemoryWrite(VAddr address, const void* data, u64 size) {
-    WriteBlock(SanitizeAddress(address), data, size);
+    const VAddr sanitized = SanitizeAddress(address);
+    const auto& code = metadata.main_nso_extents;
+    if (sanitized < code.base || sanitized >= code.base + code.size) {
+        WriteBlock(sanitized, data, size);
+        return;
+    }
+
+    // Cheats rewrite the same code every tick, only changed code has to be translated again
+    std::vector<u8> old_data(size);
+    ReadBlock(sanitized, old_data.data(), size);
+    if (std::memcmp(old_data.data(), data, size) == 0) {
+        return;
+    }
+    WriteBlock(sanitized, data, size);
+    system.InvalidateCpuInstructionCacheRange(sanitized, size);
 }
 
 u64 StandardVmCallbacks::HidKeysDown() {
@@ -59,6 +75,11 @@ void StandardVmCallbacks::CommandLog(std::string_view data) {
               data.back() == '\n' ? data.substr(0, data.size() - 1) : data);
 }
 
+bool StandardVmCallbacks::IsCommandLogEnabled() const {
+    return Log::Level::Debug >= Log::MIN_LOG_LEVEL &&
+           Log::Detail::IsLogged(Log::Class::CheatEngine, Log::Level::Debug);
+}
+
 VAddr StandardVmCallbacks::SanitizeAddress(VAddr in) const {
     if ((in < metadata.main_nso_extents.base ||
          in >= metadata.main_nso_extents.base + metadata.main_nso_extents.size) &&
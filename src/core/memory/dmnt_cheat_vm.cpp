@@ -605,26 +605,45 @@ bool DmntCheatVm::DecodeNextOpcode(CheatVmOpcode& out) {
     return valid;
 }
 
-void DmntCheatVm::SkipConditionalBlock() {
-    if (condition_depth > 0) {
-        // We want to continue until we're out of the current block.
-        const std::size_t desired_depth = condition_depth - 1;
+void DmntCheatVm::CompileProgram() {
+    compiled_program.clear();
+    instruction_ptr = 0;
+    decode_success = true;
 
-        CheatVmOpcode skip_opcode{};
-        while (condition_depth > desired_depth && DecodeNextOpcode(skip_opcode)) {
-            // Decode instructions until we see end of the current conditional block.
-            // NOTE: This is broken in gateway's implementation.
-            // Gateway currently checks for "0x2" instead of "0x20000000"
-            // In addition, they do a linear scan instead of correctly decoding opcodes.
-            // This causes issues if "0x2" appears as an immediate in the conditional block...
+    // Opcodes are decoded until the end of the program or the first one that fails to decode,
+    // which is where the execution of the program stops.
+    CheatVmOpcode opcode{};
+    std::vector<std::size_t> open_blocks;
+    while (DecodeNextOpcode(opcode)) {
+        // The end of each conditional block is found once, by matching the opcodes ending blocks
+        // with the innermost block they end.
+        // NOTE: This is broken in gateway's implementation.
+        // Gateway currently checks for "0x2" instead of "0x20000000"
+        // In addition, they do a linear scan instead of correctly decoding opcodes.
+        // This causes issues if "0x2" appears as an immediate in the conditional block...
 
-            // We also support nesting of conditional blocks, and Gateway does not.
-            if (skip_opcode.begin_conditional_block) {
-                condition_depth++;
-            } else if (std::holds_alternative<EndConditionalOpcode>(skip_opcode.opcode)) {
-                condition_depth--;
-            }
+        // We also support nesting of conditional blocks, and Gateway does not.
+        if (opcode.begin_conditional_block) {
+            open_blocks.push_back(compiled_program.size());
+        } else if (std::holds_alternative<EndConditionalOpcode>(opcode.opcode) &&
+                   !open_blocks.empty()) {
+            compiled_program[open_blocks.back()].block_end = compiled_program.size() + 1;
+            open_blocks.pop_back();
         }
+        compiled_program.push_back({opcode, instruction_ptr, 0});
+    }
+
+    // Skipping a block without an end skips the rest of the program.
+    for (const std::size_t index : open_blocks) {
+        compiled_program[index].block_end = compiled_program.size();
+    }
+}
+
+void DmntCheatVm::SkipConditionalBlock(std::size_t block_end) {
+    if (condition_depth > 0) {
+        // Continue past the end of the current block, leaving it.
+        instruction_ptr = block_end;
+        condition_depth--;
     } else {
         // Skipping, but condition_depth = 0.
         // This is an error condition.
@@ -668,7 +687,6 @@ void DmntCheatVm::ResetState() {
     loop_tops.fill(0);
     instruction_ptr = 0;
     condition_depth = 0;
-    decode_success = true;
 }
 
 bool DmntCheatVm::LoadProgram(const std::vector<CheatEntry>& entries) {
@@ -680,6 +698,7 @@ bool DmntCheatVm::LoadProgram(const std::vector<CheatEntry>& entries) {
             // Bounds check.
             if (entries[i].definition.num_opcodes + num_opcodes > MaximumProgramOpcodeCount) {
                 num_opcodes = 0;
+                compiled_program.clear();
                 return false;
             }
 
@@ -689,36 +708,46 @@ bool DmntCheatVm::LoadProgram(const std::vector<CheatEntry>& entries) {
         }
     }
 
+    CompileProgram();
     return true;
 }
 
 void DmntCheatVm::Execute(const CheatProcessMetadata& metadata) {
-    CheatVmOpcode cur_opcode{};
-
     // Get Keys down.
     u64 kDown = callbacks->HidKeysDown();
 
-    callbacks->CommandLog("Started VM execution.");
-    callbacks->CommandLog(fmt::format("Main NSO:  {:012X}", metadata.main_nso_extents.base));
-    callbacks->CommandLog(fmt::format("Heap:      {:012X}", metadata.main_nso_extents.base));
-    callbacks->CommandLog(fmt::format("Keys Down: {:08X}", static_cast<u32>(kDown & 0x0FFFFFFF)));
+    // Tracing formats dozens of messages per opcode, it is only done when they are kept.
+    const bool is_log_enabled = callbacks->IsCommandLogEnabled();
+    if (is_log_enabled) {
+        callbacks->CommandLog("Started VM execution.");
+        callbacks->CommandLog(fmt::format("Main NSO:  {:012X}", metadata.main_nso_extents.base));
+        callbacks->CommandLog(fmt::format("Heap:      {:012X}", metadata.main_nso_extents.base));
+        callbacks->CommandLog(
+            fmt::format("Keys Down: {:08X}", static_cast<u32>(kDown & 0x0FFFFFFF)));
+    }
 
     // Clear VM state.
     ResetState();
 
     // Loop until program finishes.
-    while (DecodeNextOpcode(cur_opcode)) {
-        callbacks->CommandLog(
-            fmt::format("Instruction Ptr: {:04X}", static_cast<u32>(instruction_ptr)));
+    while (instruction_ptr < compiled_program.size()) {
+        const CompiledOpcode& compiled_opcode = compiled_program[instruction_ptr++];
+        const CheatVmOpcode& cur_opcode = compiled_opcode.opcode;
 
-        for (std::size_t i = 0; i < NumRegisters; i++) {
-            callbacks->CommandLog(fmt::format("Registers[{:02X}]: {:016X}", i, registers[i]));
-        }
+        if (is_log_enabled) {
+            callbacks->CommandLog(fmt::format("Instruction Ptr: {:04X}",
+                                              static_cast<u32>(compiled_opcode.next_dword)));
 
-        for (std::size_t i = 0; i < NumRegisters; i++) {
-            callbacks->CommandLog(fmt::format("SavedRegs[{:02X}]: {:016X}", i, saved_values[i]));
+            for (std::size_t i = 0; i < NumRegisters; i++) {
+                callbacks->CommandLog(fmt::format("Registers[{:02X}]: {:016X}", i, registers[i]));
+            }
+
+            for (std::size_t i = 0; i < NumRegisters; i++) {
+                callbacks->CommandLog(
+                    fmt::format("SavedRegs[{:02X}]: {:016X}", i, saved_values[i]));
+            }
+            LogOpcode(cur_opcode);
         }
-        LogOpcode(cur_opcode);
 
         // Increment conditional depth, if relevant.
         if (cur_opcode.begin_conditional_block) {
@@ -744,7 +773,7 @@ void DmntCheatVm::Execute(const CheatProcessMetadata& metadata) {
             u64 src_address =
                 GetCheatProcessAddress(metadata, begin_cond->mem_type, begin_cond->rel_address);
             u64 src_value = 0;
-            switch (store_static->bit_width) {
+            switch (begin_cond->bit_width) {
             case 1:
             case 2:
             case 4:
@@ -777,7 +806,7 @@ void DmntCheatVm::Execute(const CheatProcessMetadata& metadata) {
             }
             // Skip conditional block if condition not met.
             if (!cond_met) {
-                SkipConditionalBlock();
+                SkipConditionalBlock(compiled_opcode.block_end);
             }
         } else if (auto end_cond = std::get_if<EndConditionalOpcode>(&cur_opcode.opcode)) {
             // Decrement the condition depth.
@@ -891,7 +920,7 @@ void DmntCheatVm::Execute(const CheatProcessMetadata& metadata) {
             // Check for keypress.
             if ((begin_keypress_cond->key_mask & kDown) != begin_keypress_cond->key_mask) {
                 // Keys not pressed. Skip conditional block.
-                SkipConditionalBlock();
+                SkipConditionalBlock(compiled_opcode.block_end);
             }
         } else if (auto perform_math_reg =
                        std::get_if<PerformArithmeticRegisterOpcode>(&cur_opcode.opcode)) {
@@ -1099,7 +1128,7 @@ void DmntCheatVm::Execute(const CheatProcessMetadata& metadata) {
 
             // Skip conditional block if condition not met.
             if (!cond_met) {
-                SkipConditionalBlock();
+                SkipConditionalBlock(compiled_opcode.block_end);
             }
         } else if (auto save_restore_reg =
                        std::get_if<SaveRestoreRegisterOpcode>(&cur_opcode.opcode)) {
@@ -277,6 +277,8 @@ public:
 
         virtual void DebugLog(u8 id, u64 value) = 0;
         virtual void CommandLog(std::string_view data) = 0;
+        /// Whether CommandLog messages are kept, the VM skips tracing its execution otherwise.
+        virtual bool IsCommandLogEnabled() const = 0;
     };
 
     static constexpr std::size_t MaximumProgramOpcodeCount = 0x400;
@@ -293,19 +295,32 @@ public:
     void Execute(const CheatProcessMetadata& metadata);
 
 private:
+    /// Opcode of the program decoded ahead of its execution.
+    struct CompiledOpcode {
+        CheatVmOpcode opcode;
+        /// Offset of the dword following the opcode in the program, for the command log.
+        std::size_t next_dword{};
+        /// Index of the opcode past the end of the block a conditional opcode begins.
+        std::size_t block_end{};
+    };
+
     std::unique_ptr<Callbacks> callbacks;
 
     std::size_t num_opcodes = 0;
+    /// Offset of the next dword while compiling, index of the next opcode while executing.
     std::size_t instruction_ptr = 0;
     std::size_t condition_depth = 0;
     bool decode_success = false;
     std::array<u32, MaximumProgramOpcodeCount> program{};
+    /// Opcodes of the program up to the first one that fails to decode.
+    std::vector<CompiledOpcode> compiled_program;
     std::array<u64, NumRegisters> registers{};
     std::array<u64, NumRegisters> saved_values{};
     std::array<std::size_t, NumRegisters> loop_tops{};
 
     bool DecodeNextOpcode(CheatVmOpcode& out);
-    void SkipConditionalBlock();
+    void CompileProgram();
+    void SkipConditionalBlock(std::size_t block_end);
     void ResetState();
 
     // For implementing the DebugLog opcode.
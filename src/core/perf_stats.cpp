@@ -8,11 +8,12 @@
 #include <mutex>
 #include <numeric>
 #include <sstream>
-#include <thread>
 #include <fmt/chrono.h>
 #include <fmt/format.h>
 #include "common/file_util.h"
 #include "common/math_util.h"
+#include "common/percentile.h"
+#include "common/thread.h"
 #include "core/perf_stats.h"
 #include "core/settings.h"
 
@@ -27,6 +28,51 @@ constexpr std::size_t IgnoreFrames = 5;
 
 namespace Core {
 
+namespace {
+
+/// Returns the nearest-rank percentiles of the first `count` samples, sorting them.
+PerfPercentiles GetPercentiles(double* samples, std::size_t count) {
+    if (count == 0) {
+        return {};
+    }
+    std::sort(samples, samples + count);
+    return {Common::GetPercentile(samples, count, 0.50),
+            Common::GetPercentile(samples, count, 0.95),
+            Common::GetPercentile(samples, count, 0.99)};
+}
+
+} // Anonymous namespace
+
+const char* GetPerfCategoryName(PerfCategory category) {
+    switch (category) {
+    case PerfCategory::CpuCore0:
+        return "cpu0";
+    case PerfCategory::CpuCore1:
+        return "cpu1";
+    case PerfCategory::CpuCore2:
+        return "cpu2";
+    case PerfCategory::CpuCore3:
+        return "cpu3";
+    case PerfCategory::Svc:
+        return "svc";
+    case PerfCategory::Service:
+        return "service";
+    case PerfCategory::GpuBusy:
+        return "gpu_busy";
+    case PerfCategory::GpuIdle:
+        return "gpu_idle";
+    case PerfCategory::ShaderCompile:
+        return "shader_compile";
+    case PerfCategory::PresentWait:
+        return "present_wait";
+    case PerfCategory::AudioMix:
+        return "audio_mix";
+    case PerfCategory::Count:
+        break;
+    }
+    return "unknown";
+}
+
 PerfStats::PerfStats(u64 title_id) : title_id(title_id) {}
 
 PerfStats::~PerfStats() {
@@ -53,7 +99,7 @@ void PerfStats::BeginSystemFrame() {
 }
 
 void PerfStats::EndSystemFrame() {
-    std::lock_guard lock{object_mutex};
+    std::unique_lock lock{object_mutex};
 
     auto frame_end = Clock::now();
     const auto frame_time = frame_end - frame_begin;
@@ -66,6 +112,23 @@ void PerfStats::EndSystemFrame() {
 
     previous_frame_length = frame_end - previous_frame_end;
     previous_frame_end = frame_end;
+
+    const std::size_t history_index = total_frames % BreakdownWindow;
+    breakdown_history[0][history_index] = duration_cast<DoubleSecs>(frame_time).count();
+    for (std::size_t i = 0; i < NumPerfCategories; ++i) {
+        const Clock::duration time{category_time[i].exchange(0, std::memory_order_relaxed)};
+        breakdown_history[i + 1][history_index] = duration_cast<DoubleSecs>(time).count();
+    }
+    total_frames += 1;
+
+    if (total_frames % BreakdownInterval != 0 || !breakdown_callback) {
+        return;
+    }
+    // The callback may take a while, so it runs without blocking the other threads
+    const FrameBreakdown breakdown = GetFrameBreakdownLocked();
+    const BreakdownCallback callback = breakdown_callback;
+    lock.unlock();
+    callback(breakdown);
 }
 
 void PerfStats::EndGameFrame() {
@@ -74,6 +137,56 @@ void PerfStats::EndGameFrame() {
     game_frames += 1;
 }
 
+void PerfStats::AddPresentLatency(Clock::duration latency) {
+    std::lock_guard lock{object_mutex};
+
+    accumulated_present_latency += latency;
+    present_latency_samples += 1;
+}
+
+void PerfStats::AddDroppedFrame() {
+    std::lock_guard lock{object_mutex};
+
+    dropped_frames += 1;
+}
+
+void PerfStats::AddFrameLimiterOvershoot(Clock::duration overshoot) {
+    std::lock_guard lock{object_mutex};
+
+    accumulated_limiter_overshoot += overshoot;
+    limiter_waits += 1;
+}
+
+FrameBreakdown PerfStats::GetFrameBreakdown() {
+    std::lock_guard lock{object_mutex};
+
+    return GetFrameBreakdownLocked();
+}
+
+void PerfStats::SetBreakdownCallback(BreakdownCallback callback) {
+    std::lock_guard lock{object_mutex};
+
+    breakdown_callback = std::move(callback);
+}
+
+FrameBreakdown PerfStats::GetFrameBreakdownLocked() const {
+    FrameBreakdown breakdown{};
+    breakdown.frame = total_frames;
+    breakdown.window_frames = static_cast<u32>(std::min<u64>(total_frames, BreakdownWindow));
+
+    std::array<double, BreakdownWindow> samples;
+    const auto percentiles = [&](std::size_t history) {
+        std::copy_n(breakdown_history[history].begin(), breakdown.window_frames,
+                    samples.begin());
+        return GetPercentiles(samples.data(), breakdown.window_frames);
+    };
+    breakdown.frametime = percentiles(0);
+    for (std::size_t i = 0; i < NumPerfCategories; ++i) {
+        breakdown.categories[i] = percentiles(i + 1);
+    }
+    return breakdown;
+}
+
 double PerfStats::GetMeanFrametime() {
     std::lock_guard lock{object_mutex};
 
@@ -100,6 +213,17 @@ PerfStatsResults PerfStats::GetAndResetStats(microseconds current_system_time_us
     results.frametime = duration_cast<DoubleSecs>(accumulated_frametime).count() /
                         static_cast<double>(system_frames);
     results.emulation_speed = system_us_per_second.count() / 1'000'000.0;
+    if (present_latency_samples > 0) {
+        results.present_latency = duration_cast<DoubleSecs>(accumulated_present_latency).count() /
+                                  static_cast<double>(present_latency_samples);
+    }
+    results.dropped_frames = dropped_frames;
+    if (limiter_waits > 0) {
+        results.frame_limiter_overshoot =
+            duration_cast<DoubleSecs>(accumulated_limiter_overshoot).count() /
+            static_cast<double>(limiter_waits);
+    }
+    results.breakdown = GetFrameBreakdownLocked();
 
     // Reset counters
     reset_point = now;
@@ -107,6 +231,11 @@ PerfStatsResults PerfStats::GetAndResetStats(microseconds current_system_time_us
     accumulated_frametime = Clock::duration::zero();
     system_frames = 0;
     game_frames = 0;
+    accumulated_present_latency = Clock::duration::zero();
+    present_latency_samples = 0;
+    dropped_frames = 0;
+    accumulated_limiter_overshoot = Clock::duration::zero();
+    limiter_waits = 0;
 
     return results;
 }
@@ -118,7 +247,7 @@ double PerfStats::GetLastFrameTimeScale() {
     return duration_cast<DoubleSecs>(previous_frame_length).count() / FRAME_LENGTH;
 }
 
-void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
+void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us, PerfStats& perf_stats) {
     if (!Settings::values.use_frame_limit) {
         return;
     }
@@ -141,8 +270,10 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
         std::clamp(frame_limiting_delta_err, -max_lag_time_us, max_lag_time_us);
 
     if (frame_limiting_delta_err > microseconds::zero()) {
-        std::this_thread::sleep_for(frame_limiting_delta_err);
-        auto now_after_sleep = Clock::now();
+        const auto deadline = now + frame_limiting_delta_err;
+        Common::PreciseSleepUntil(deadline);
+        const auto now_after_sleep = Clock::now();
+        perf_stats.AddFrameLimiterOvershoot(now_after_sleep - deadline);
         frame_limiting_delta_err -= duration_cast<microseconds>(now_after_sleep - now);
         now = now_after_sleep;
     }
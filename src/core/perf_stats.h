@@ -5,13 +5,56 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <functional>
 #include <mutex>
 #include "common/common_types.h"
 
 namespace Core {
 
+/// Parts of the host time spent emulating a system frame that are measured separately. They run on
+/// different threads and overlap, so they don't add up to the frame time.
+enum class PerfCategory : std::size_t {
+    CpuCore0,      ///< Guest code run by CPU core 0, including its supervisor calls
+    CpuCore1,      ///< Guest code run by CPU core 1, including its supervisor calls
+    CpuCore2,      ///< Guest code run by CPU core 2, including its supervisor calls
+    CpuCore3,      ///< Guest code run by CPU core 3, including its supervisor calls
+    Svc,           ///< Supervisor calls, including the HLE service requests they make
+    Service,       ///< HLE service requests
+    GpuBusy,       ///< GPU thread running commands
+    GpuIdle,       ///< GPU thread waiting for commands
+    ShaderCompile, ///< Generating, compiling and linking host shaders
+    PresentWait,   ///< Waiting for the host GPU and the window system to present a frame
+    AudioMix,      ///< Mixing audio renderer command lists
+    Count,
+};
+
+constexpr std::size_t NumPerfCategories = static_cast<std::size_t>(PerfCategory::Count);
+
+/// Returns the name of a category, as used in the exported statistics.
+const char* GetPerfCategoryName(PerfCategory category);
+
+/// Percentiles of a duration over the frames of a rolling window, in seconds.
+struct PerfPercentiles {
+    double p50;
+    double p95;
+    double p99;
+};
+
+/// Distribution of the frame time and of each category over the most recent system frames.
+struct FrameBreakdown {
+    /// Number of system frames since the statistics were created
+    u64 frame;
+    /// Number of frames the percentiles are taken over
+    u32 window_frames;
+    /// Walltime per system frame, excluding any waits
+    PerfPercentiles frametime;
+    /// Time spent on each category per system frame
+    std::array<PerfPercentiles, NumPerfCategories> categories;
+};
+
 struct PerfStatsResults {
     /// System FPS (LCD VBlanks) in Hz
     double system_fps;
@@ -21,6 +64,14 @@ struct PerfStatsResults {
     double frametime;
     /// Ratio of walltime / emulated time elapsed
     double emulation_speed;
+    /// Mean time from submitting a presented frame until the host GPU finished it, in seconds
+    double present_latency;
+    /// Frames that were not presented because a newer one replaced them
+    u32 dropped_frames;
+    /// Mean time the frame limiter woke up past its deadline, in seconds
+    double frame_limiter_overshoot;
+    /// Percentiles over the recent frames, not reset with the counters above
+    FrameBreakdown breakdown;
 };
 
 /**
@@ -35,10 +86,43 @@ public:
 
     using Clock = std::chrono::high_resolution_clock;
 
+    /// Called with the frame breakdown every BreakdownInterval system frames.
+    using BreakdownCallback = std::function<void(const FrameBreakdown&)>;
+
+    /// Number of system frames the percentiles of the frame breakdown are taken over.
+    static constexpr std::size_t BreakdownWindow = 600;
+    /// Number of system frames between two calls of the breakdown callback.
+    static constexpr std::size_t BreakdownInterval = 60;
+
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
 
+    /// Adds the time the host GPU took to finish a presented frame since it was submitted.
+    void AddPresentLatency(Clock::duration latency);
+
+    /// Counts a frame that was not presented because a newer one replaced it.
+    void AddDroppedFrame();
+
+    /// Adds the time the frame limiter woke up past the deadline it waited for.
+    void AddFrameLimiterOvershoot(Clock::duration overshoot);
+
+    /// Adds time spent on a category to the current system frame. It doesn't lock, so it can be
+    /// called on hot paths from any thread.
+    void AddTime(PerfCategory category, Clock::duration duration) {
+        category_time[static_cast<std::size_t>(category)].fetch_add(duration.count(),
+                                                                    std::memory_order_relaxed);
+    }
+
+    /// Returns the percentiles of the frame time and of each category over the recent frames.
+    FrameBreakdown GetFrameBreakdown();
+
+    /**
+     * Sets a function that's called with the frame breakdown every BreakdownInterval system
+     * frames, on the thread that ends them.
+     */
+    void SetBreakdownCallback(BreakdownCallback callback);
+
     PerfStatsResults GetAndResetStats(std::chrono::microseconds current_system_time_us);
 
     /**
@@ -53,6 +137,8 @@ public:
     double GetLastFrameTimeScale();
 
 private:
+    FrameBreakdown GetFrameBreakdownLocked() const;
+
     std::mutex object_mutex{};
 
     /// Title ID for the game that is running. 0 if there is no game running yet
@@ -74,6 +160,16 @@ private:
     u32 system_frames = 0;
     /// Cumulative number of game frames (GSP frame submissions) since last reset
     u32 game_frames = 0;
+    /// Cumulative host GPU latency of the frames presented since last reset
+    Clock::duration accumulated_present_latency = Clock::duration::zero();
+    /// Cumulative number of frames with a measured present latency since last reset
+    u32 present_latency_samples = 0;
+    /// Cumulative number of frames dropped since last reset
+    u32 dropped_frames = 0;
+    /// Cumulative overshoot of the frame limiter waits since last reset
+    Clock::duration accumulated_limiter_overshoot = Clock::duration::zero();
+    /// Cumulative number of frame limiter waits since last reset
+    u32 limiter_waits = 0;
 
     /// Point when the previous system frame ended
     Clock::time_point previous_frame_end = reset_point;
@@ -81,13 +177,43 @@ private:
     Clock::time_point frame_begin = reset_point;
     /// Total visible duration (including frame-limiting, etc.) of the previous system frame
     Clock::duration previous_frame_length = Clock::duration::zero();
+
+    /// Time spent on each category during the current system frame
+    std::array<std::atomic<Clock::rep>, NumPerfCategories> category_time{};
+    /// Frame time followed by the time of each category of the last BreakdownWindow frames, in
+    /// seconds
+    std::array<std::array<double, BreakdownWindow>, NumPerfCategories + 1> breakdown_history{};
+    /// Number of system frames ended since the statistics were created
+    u64 total_frames = 0;
+    BreakdownCallback breakdown_callback;
+};
+
+/// Adds the time between its construction and its destruction to a category of a PerfStats.
+class PerfTimer {
+public:
+    explicit PerfTimer(PerfStats& perf_stats, PerfCategory category)
+        : perf_stats{perf_stats}, category{category} {}
+
+    ~PerfTimer() {
+        perf_stats.AddTime(category, PerfStats::Clock::now() - start);
+    }
+
+    PerfTimer(const PerfTimer&) = delete;
+    PerfTimer& operator=(const PerfTimer&) = delete;
+
+private:
+    PerfStats& perf_stats;
+    PerfCategory category;
+    PerfStats::Clock::time_point start = PerfStats::Clock::now();
 };
 
 class FrameLimiter {
 public:
-    using Clock = std::chrono::high_resolution_clock;
+    using Clock = std::chrono::steady_clock;
 
-    void DoFrameLimiting(std::chrono::microseconds current_system_time_us);
+    /// Waits until the walltime catches up with the emulated time, adding the time each wait
+    /// overshot its deadline to the statistics.
+    void DoFrameLimiting(std::chrono::microseconds current_system_time_us, PerfStats& perf_stats);
 
 private:
     /// Emulated system time (in microseconds) at the last limiter invocation
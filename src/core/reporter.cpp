@@ -146,8 +146,8 @@ json GetFullDataAuto(const std::string& timestamp, u64 title_id, Core::System& s
     return out;
 }
 
-template <bool read_value, typename DescriptorType>
-json GetHLEBufferDescriptorData(const std::vector<DescriptorType>& buffer) {
+template <bool read_value, typename DescriptorList>
+json GetHLEBufferDescriptorData(const DescriptorList& buffer) {
     auto buffer_out = json::array();
     for (const auto& desc : buffer) {
         auto entry = json{
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "common/file_util.h"
+#include "common/thread_placement.h"
 #include "core/core.h"
 #include "core/gdbstub/gdbstub.h"
 #include "core/hle/service/hid/hid.h"
@@ -63,10 +64,17 @@ const std::array<const char*, NumMouseButtons> mapping = {{
 
 Values values = {};
 
+CpuAccuracy GetCpuAccuracy(u64 title_id) {
+    const auto it = values.cpu_accuracy_overrides.find(title_id);
+    return it != values.cpu_accuracy_overrides.end() ? it->second : values.cpu_accuracy;
+}
+
 void Apply() {
     GDBStub::SetServerPort(values.gdbstub_port);
     GDBStub::ToggleServer(values.use_gdbstub);
 
+    Common::SetThreadPlacement(values.thread_placement, values.use_multi_core ? 4 : 1);
+
     auto& system_instance = Core::System::GetInstance();
     if (system_instance.IsPoweredOn()) {
         system_instance.Renderer().RefreshBaseSettings();
@@ -87,22 +95,37 @@ void LogSettings() {
     LogSetting("System_CurrentUser", Settings::values.current_user);
     LogSetting("System_LanguageIndex", Settings::values.language_index);
     LogSetting("Core_UseMultiCore", Settings::values.use_multi_core);
+    LogSetting("Core_UseHostTiming", Settings::values.use_host_timing);
+    LogSetting("Core_ThreadPlacement", Settings::values.thread_placement);
+    LogSetting("Core_CpuAccuracy", static_cast<u32>(Settings::values.cpu_accuracy));
     LogSetting("Renderer_UseResolutionFactor", Settings::values.resolution_factor);
     LogSetting("Renderer_UseFrameLimit", Settings::values.use_frame_limit);
     LogSetting("Renderer_FrameLimit", Settings::values.frame_limit);
     LogSetting("Renderer_UseDiskShaderCache", Settings::values.use_disk_shader_cache);
+    LogSetting("Renderer_UseDiskTextureCache", Settings::values.use_disk_texture_cache);
     LogSetting("Renderer_UseAccurateGpuEmulation", Settings::values.use_accurate_gpu_emulation);
+    LogSetting("Renderer_UseHostPageProtection", Settings::values.use_host_page_protection);
     LogSetting("Renderer_UseAsynchronousGpuEmulation",
                Settings::values.use_asynchronous_gpu_emulation);
+    LogSetting("Renderer_UseAsynchronousShaders", Settings::values.use_asynchronous_shaders);
+    LogSetting("Renderer_UseShaderWarmup", Settings::values.use_shader_warmup);
+    LogSetting("Renderer_UseMailboxPresentation", Settings::values.use_mailbox_presentation);
+    LogSetting("Renderer_UseHostVsync", Settings::values.use_host_vsync);
+    LogSetting("Renderer_TextureMemoryBudget", Settings::values.texture_memory_budget);
     LogSetting("Audio_OutputEngine", Settings::values.sink_id);
     LogSetting("Audio_EnableAudioStretching", Settings::values.enable_audio_stretching);
     LogSetting("Audio_OutputDevice", Settings::values.audio_device_id);
     LogSetting("DataStorage_UseVirtualSd", Settings::values.use_virtual_sd);
     LogSetting("DataStorage_NandDir", FileUtil::GetUserPath(FileUtil::UserPath::NANDDir));
     LogSetting("DataStorage_SdmcDir", FileUtil::GetUserPath(FileUtil::UserPath::SDMCDir));
+    LogSetting("Debugging_RecordGuestProfile", Settings::values.record_guest_profile);
+    LogSetting("Debugging_RecordIpcTrace", Settings::values.record_ipc_trace);
     LogSetting("Debugging_UseGdbstub", Settings::values.use_gdbstub);
     LogSetting("Debugging_GdbstubPort", Settings::values.gdbstub_port);
     LogSetting("Debugging_ProgramArgs", Settings::values.program_args);
+    LogSetting("Debugging_DisableMacroJit", Settings::values.disable_macro_jit);
+    LogSetting("Debugging_ValidateMacroJit", Settings::values.validate_macro_jit);
+    LogSetting("Debugging_DisableMacroHle", Settings::values.disable_macro_hle);
     LogSetting("Services_BCATBackend", Settings::values.bcat_backend);
     LogSetting("Services_BCATBoxcatLocal", Settings::values.bcat_boxcat_local);
 }
@@ -371,6 +371,14 @@ enum class SDMCSize : u64 {
     S1TB = 0x10000000000ULL,
 };
 
+/// Trade-off between the accuracy of the emulated CPU and the speed of its JIT.
+enum class CpuAccuracy : u32 {
+    /// Checks the bounds of every memory access against the address space.
+    Accurate = 0,
+    /// Skips the bounds checks of the page table, addresses past the address space wrap around.
+    Unsafe = 1,
+};
+
 struct Values {
     // System
     bool use_docked_mode;
@@ -391,6 +399,7 @@ struct Values {
     MouseButtonsRaw mouse_buttons;
 
     bool keyboard_enabled;
+    bool sample_input_on_vsync;
     KeyboardKeysRaw keyboard_keys;
     KeyboardModsRaw keyboard_mods;
 
@@ -402,8 +411,19 @@ struct Values {
     TouchscreenInput touchscreen;
     std::atomic_bool is_device_reload_pending{true};
 
+    // Set by the frontend before boot to record the npad input to a file, or to replay a recording
+    // in place of the input devices
+    std::string input_record_path;
+    std::string input_replay_path;
+
     // Core
     bool use_multi_core;
+    bool use_host_timing;
+    // Placement of the host threads of each role on the host cores, see Common::SetThreadPlacement
+    std::string thread_placement;
+    CpuAccuracy cpu_accuracy;
+    // Accuracy of the titles that do not use cpu_accuracy
+    std::map<u64, CpuAccuracy> cpu_accuracy_overrides;
 
     // Data Storage
     bool use_virtual_sd;
@@ -420,8 +440,15 @@ struct Values {
     bool use_frame_limit;
     u16 frame_limit;
     bool use_disk_shader_cache;
+    bool use_disk_texture_cache;
     bool use_accurate_gpu_emulation;
+    bool use_host_page_protection;
     bool use_asynchronous_gpu_emulation;
+    bool use_asynchronous_shaders;
+    bool use_shader_warmup;
+    bool use_mailbox_presentation;
+    bool use_host_vsync;
+    u32 texture_memory_budget; ///< In MiB, 0 disables the budget
     bool force_30fps_mode;
 
     float bg_red;
@@ -440,6 +467,8 @@ struct Values {
 
     // Debugging
     bool record_frame_times;
+    bool record_guest_profile;
+    bool record_ipc_trace;
     bool use_gdbstub;
     u16 gdbstub_port;
     std::string program_args;
@@ -447,6 +476,9 @@ struct Values {
     bool dump_nso;
     bool reporting_services;
     bool quest_flag;
+    bool disable_macro_jit;
+    bool validate_macro_jit;
+    bool disable_macro_hle;
 
     // BCAT
     std::string bcat_backend;
@@ -462,6 +494,9 @@ struct Values {
     std::map<u64, std::vector<std::string>> disabled_addons;
 } extern values;
 
+/// Returns the CPU accuracy a title runs with.
+CpuAccuracy GetCpuAccuracy(u64 title_id);
+
 void Apply();
 void LogSettings();
 } // namespace Settings
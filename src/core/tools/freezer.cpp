@@ -32,6 +32,15 @@ u64 MemoryReadWidth(u32 width, VAddr addr) {
     }
 }
 
+VAddr GetPage(VAddr addr) {
+    return addr & ~Memory::PAGE_MASK;
+}
+
+// Values straddling two pages are always rewritten, watches are only taken on single pages.
+bool IsWatchable(const Freezer::Entry& entry) {
+    return GetPage(entry.address) == GetPage(entry.address + entry.width - 1);
+}
+
 void MemoryWriteWidth(u32 width, VAddr addr, u64 value) {
     switch (width) {
     case 1:
@@ -62,6 +71,9 @@ Freezer::Freezer(Core::Timing::CoreTiming& core_timing) : core_timing(core_timin
 
 Freezer::~Freezer() {
     core_timing.UnscheduleEvent(event, 0);
+
+    std::lock_guard lock{entries_mutex};
+    UnwatchAllPages();
 }
 
 void Freezer::SetActive(bool active) {
@@ -70,6 +82,8 @@ void Freezer::SetActive(bool active) {
         core_timing.ScheduleEvent(MEMORY_FREEZER_TICKS, event);
         LOG_DEBUG(Common_Memory, "Memory freezer activated!");
     } else {
+        std::lock_guard lock{entries_mutex};
+        UnwatchAllPages();
         LOG_DEBUG(Common_Memory, "Memory freezer deactivated!");
     }
 }
@@ -84,6 +98,7 @@ void Freezer::Clear() {
     LOG_DEBUG(Common_Memory, "Clearing all frozen memory values.");
 
     entries.clear();
+    UnwatchAllPages();
 }
 
 u64 Freezer::Freeze(VAddr address, u32 width) {
@@ -108,6 +123,7 @@ void Freezer::Unfreeze(VAddr address) {
         std::remove_if(entries.begin(), entries.end(),
                        [&address](const Entry& entry) { return entry.address == address; }),
         entries.end());
+    UnwatchPage(address);
 }
 
 bool Freezer::IsFrozen(VAddr address) const {
@@ -135,6 +151,10 @@ void Freezer::SetFrozenValue(VAddr address, u64 value) {
               "Manually overridden freeze value for address={:016X}, width={:02X} to value={:016X}",
               iter->address, iter->width, value);
     iter->value = value;
+
+    // The new value is written on the next rewrite
+    Memory::UnwatchFrozenPage(GetPage(address));
+    watched_pages.erase(GetPage(address));
 }
 
 std::optional<Freezer::Entry> Freezer::GetEntry(VAddr address) const {
@@ -165,13 +185,32 @@ void Freezer::FrameCallback(u64 userdata, s64 cycles_late) {
 
     std::lock_guard lock{entries_mutex};
 
+    std::vector<VAddr> written_pages;
+    Memory::TakeFrozenPageWrites(written_pages);
+    for (const VAddr page : written_pages) {
+        watched_pages.erase(page);
+    }
+
     for (const auto& entry : entries) {
+        if (IsWatchable(entry) && watched_pages.count(GetPage(entry.address)) != 0) {
+            // Nothing wrote the page since the value was last written
+            continue;
+        }
         LOG_DEBUG(Common_Memory,
                   "Enforcing memory freeze at address={:016X}, value={:016X}, width={:02X}",
                   entry.address, entry.value, entry.width);
         MemoryWriteWidth(entry.width, entry.address, entry.value);
     }
 
+    // Pages are watched after their values are written, so the writes above aren't reported
+    for (const auto& entry : entries) {
+        const VAddr page = GetPage(entry.address);
+        if (IsWatchable(entry) && watched_pages.count(page) == 0 &&
+            Memory::WatchFrozenPage(page)) {
+            watched_pages.insert(page);
+        }
+    }
+
     core_timing.ScheduleEvent(MEMORY_FREEZER_TICKS - cycles_late, event);
 }
 
@@ -185,4 +224,21 @@ void Freezer::FillEntryReads() {
     }
 }
 
+void Freezer::UnwatchPage(VAddr address) {
+    const VAddr page = GetPage(address);
+    const bool is_needed = std::any_of(entries.begin(), entries.end(), [page](const Entry& entry) {
+        return GetPage(entry.address) == page;
+    });
+    if (!is_needed && watched_pages.erase(page) != 0) {
+        Memory::UnwatchFrozenPage(page);
+    }
+}
+
+void Freezer::UnwatchAllPages() {
+    for (const VAddr page : watched_pages) {
+        Memory::UnwatchFrozenPage(page);
+    }
+    watched_pages.clear();
+}
+
 } // namespace Tools
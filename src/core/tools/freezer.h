@@ -7,6 +7,7 @@
 #include <atomic>
 #include <mutex>
 #include <optional>
+#include <set>
 #include <vector>
 #include "common/common_types.h"
 
@@ -24,6 +25,9 @@ namespace Tools {
  * One example could be a cheat to prevent Mario from taking damage in SMO. One could freeze the
  * memory address that the game uses to store Mario's health so when he takes damage (and the game
  * tries to write the new health value to memory), the value won't change.
+ *
+ * Values are rewritten periodically. When the host supports it, the pages of the values are write
+ * watched and values are only rewritten after their page was written.
  */
 class Freezer {
 public:
@@ -70,10 +74,16 @@ private:
     void FrameCallback(u64 userdata, s64 cycles_late);
     void FillEntryReads();
 
+    // Ends the watch of the page of address if no entry left needs it.
+    void UnwatchPage(VAddr address);
+    void UnwatchAllPages();
+
     std::atomic_bool active{false};
 
     mutable std::mutex entries_mutex;
     std::vector<Entry> entries;
+    // Page aligned addresses of the write watched pages whose values are still in place.
+    std::set<VAddr> watched_pages;
 
     Core::Timing::EventType* event;
     Core::Timing::CoreTiming& core_timing;
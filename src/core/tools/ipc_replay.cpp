@@ -0,0 +1,76 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "core/core.h"
+#include "core/hle/ipc.h"
+#include "core/hle/kernel/client_port.h"
+#include "core/hle/kernel/client_session.h"
+#include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/server_session.h"
+#include "core/hle/kernel/thread.h"
+#include "core/hle/service/service.h"
+#include "core/memory_setup.h"
+#include "core/tools/ipc_replay.h"
+
+namespace Tools {
+
+IpcReplay::IpcReplay(Core::System& system)
+    : system{system}, process{Kernel::Process::Create(system, "ipc_replay",
+                                                      Kernel::Process::ProcessType::Userland)} {
+    system.Kernel().MakeCurrentProcess(process.get());
+}
+
+IpcReplay::~IpcReplay() {
+    auto& page_table = process->VMManager().page_table;
+    for (const auto& [address, page] : pages) {
+        Memory::UnmapRegion(page_table, address, Memory::PAGE_SIZE);
+    }
+}
+
+IpcTrace::Clock::duration IpcReplay::Invoke(
+    const std::shared_ptr<Service::ServiceFrameworkBase>& service,
+    const IpcTrace::Request& request) {
+    for (const IpcTrace::Buffer& buffer : request.buffers) {
+        MapBuffer(buffer.address, buffer.size);
+        if (!buffer.data.empty()) {
+            Memory::WriteBlock(buffer.address, buffer.data.data(), buffer.data.size());
+        }
+    }
+
+    // A new session for each request, so that the interfaces a request returns don't pile up in
+    // the domain of the next ones
+    const auto [server, client] =
+        Kernel::ServerSession::CreateSessionPair(system.Kernel(), service->GetServiceName());
+    if (request.is_domain) {
+        server->AppendDomainRequestHandler(service);
+    }
+
+    std::array<u32, IPC::COMMAND_BUFFER_LENGTH> words{};
+    std::copy_n(request.command_buffer.begin(),
+                std::min(request.command_buffer.size(), words.size()), words.begin());
+    Kernel::HLERequestContext ctx(server, nullptr);
+    ctx.PopulateFromIncomingCommandBuffer(process->GetHandleTable(), words.data());
+
+    const auto begin = IpcTrace::Clock::now();
+    service->InvokeRequest(ctx);
+    return IpcTrace::Clock::now() - begin;
+}
+
+void IpcReplay::MapBuffer(VAddr address, u64 size) {
+    auto& page_table = process->VMManager().page_table;
+    const VAddr end = address + size;
+    for (VAddr page_address = address & ~Memory::PAGE_MASK; page_address < end;
+         page_address += Memory::PAGE_SIZE) {
+        auto& page = pages[page_address];
+        if (page == nullptr) {
+            page = std::make_unique<Page>();
+            Memory::MapMemoryRegion(page_table, page_address, Memory::PAGE_SIZE, page->data());
+        }
+    }
+}
+
+} // namespace Tools
@@ -0,0 +1,58 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include "common/common_types.h"
+#include "core/hle/kernel/object.h"
+#include "core/memory.h"
+#include "core/tools/ipc_trace.h"
+
+namespace Core {
+class System;
+}
+
+namespace Kernel {
+class Process;
+}
+
+namespace Service {
+class ServiceFrameworkBase;
+}
+
+namespace Tools {
+
+/**
+ * Runs the requests of an IpcTrace again against a service instance, without a CPU or a guest
+ * thread, so that the host time of a service can be measured on the same input every time.
+ *
+ * The replay owns a process of its own, made current on construction. The buffers of a request
+ * are mapped to host memory at the addresses they were recorded at, with the recorded contents
+ * of the input buffers. Requests that carry handles or that put the guest thread to sleep can't be
+ * replayed, the handles of the trace name no objects of the replay process.
+ */
+class IpcReplay {
+public:
+    explicit IpcReplay(Core::System& system);
+    ~IpcReplay();
+
+    /// Invokes a recorded request on a service, returns the host time its handler took.
+    IpcTrace::Clock::duration Invoke(const std::shared_ptr<Service::ServiceFrameworkBase>& service,
+                                     const IpcTrace::Request& request);
+
+private:
+    using Page = std::array<u8, Memory::PAGE_SIZE>;
+
+    /// Backs the pages of a buffer with host memory, the pages stay mapped for later requests.
+    void MapBuffer(VAddr address, u64 size);
+
+    Core::System& system;
+    Kernel::SharedPtr<Kernel::Process> process;
+    std::unordered_map<VAddr, std::unique_ptr<Page>> pages;
+};
+
+} // namespace Tools
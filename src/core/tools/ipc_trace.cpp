@@ -0,0 +1,269 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <utility>
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include "common/logging/log.h"
+#include "core/hle/ipc.h"
+#include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/server_session.h"
+#include "core/hle/kernel/thread.h"
+#include "core/memory.h"
+#include "core/tools/ipc_trace.h"
+
+namespace Tools {
+
+namespace {
+
+constexpr u32 TRACE_MAGIC = Common::MakeMagic('Y', 'I', 'P', 'C');
+constexpr u32 TRACE_VERSION = 1;
+
+/// Returns the number of words of a command buffer up to its last buffer descriptor.
+std::size_t GetCommandBufferSize(const std::array<u32, IPC::COMMAND_BUFFER_LENGTH>& words) {
+    IPC::CommandHeader header;
+    std::memcpy(&header, words.data(), sizeof(header));
+    std::size_t size = sizeof(header) / sizeof(u32);
+
+    if (header.enable_handle_descriptor) {
+        IPC::HandleDescriptorHeader handles;
+        std::memcpy(&handles, &words[size], sizeof(handles));
+        size += sizeof(handles) / sizeof(u32) + (handles.send_current_pid ? 2 : 0) +
+                handles.num_handles_to_copy + handles.num_handles_to_move;
+    }
+    size += header.num_buf_x_descriptors * sizeof(IPC::BufferDescriptorX) / sizeof(u32);
+    size += (header.num_buf_a_descriptors + header.num_buf_b_descriptors +
+             header.num_buf_w_descriptors) *
+            sizeof(IPC::BufferDescriptorABW) / sizeof(u32);
+    size += header.data_size;
+
+    using CFlag = IPC::CommandHeader::BufferDescriptorCFlag;
+    const CFlag c_flags = header.buf_c_descriptor_flags;
+    if (c_flags > CFlag::InlineDescriptor) {
+        const std::size_t num_c_descriptors =
+            c_flags == CFlag::OneDescriptor ? 1 : static_cast<std::size_t>(c_flags) - 2;
+        size += num_c_descriptors * sizeof(IPC::BufferDescriptorC) / sizeof(u32);
+    }
+    return std::min(size, words.size());
+}
+
+template <typename T>
+void Append(std::vector<u8>& out, const T& value) {
+    const auto* const bytes = reinterpret_cast<const u8*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+/// Reads the fields of an entry in order, failing once the entry is exhausted.
+class EntryReader {
+public:
+    EntryReader(const u8* data, std::size_t size) : data{data}, size{size} {}
+
+    template <typename T>
+    bool Read(T& value) {
+        return ReadBytes(&value, sizeof(T));
+    }
+
+    bool ReadBytes(void* out, std::size_t length) {
+        if (length > size - offset) {
+            return false;
+        }
+        std::memcpy(out, data + offset, length);
+        offset += length;
+        return true;
+    }
+
+private:
+    const u8* data;
+    std::size_t size;
+    std::size_t offset = 0;
+};
+
+} // Anonymous namespace
+
+std::unique_ptr<IpcTrace> IpcTrace::Create(const std::string& path) {
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Core, "Could not open the IPC trace {}", path);
+        return nullptr;
+    }
+    const Header header{TRACE_MAGIC, TRACE_VERSION};
+    file.WriteObject(header);
+    return std::unique_ptr<IpcTrace>(new IpcTrace(path, std::move(file)));
+}
+
+std::unique_ptr<IpcTrace> IpcTrace::CreateInLogDirectory(u64 title_id) {
+    const std::time_t t = std::time(nullptr);
+    const std::string& path = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
+    // %F Date format expanded is "%Y-%m-%d"
+    return Create(
+        fmt::format("{}/{:%F-%H-%M}_{:016X}.ipctrace", path, *std::localtime(&t), title_id));
+}
+
+std::optional<std::vector<IpcTrace::Request>> IpcTrace::Read(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    Header header{};
+    if (!file.IsOpen() || file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != TRACE_MAGIC || header.version != TRACE_VERSION) {
+        LOG_ERROR(Core, "{} is not an IPC trace", path);
+        return std::nullopt;
+    }
+
+    std::vector<std::string> interface_names;
+    std::vector<Request> requests;
+    std::vector<u8> payload;
+    EntryHeader entry_header{};
+    while (file.ReadBytes(&entry_header, sizeof(entry_header)) == sizeof(entry_header)) {
+        payload.resize(entry_header.size);
+        if (file.ReadBytes(payload.data(), payload.size()) != payload.size()) {
+            LOG_WARNING(Core, "IPC trace {} ends with a truncated entry", path);
+            break;
+        }
+
+        if (entry_header.type == EntryType::Interface) {
+            interface_names.emplace_back(payload.begin(), payload.end());
+            continue;
+        }
+        if (entry_header.type != EntryType::Request) {
+            continue;
+        }
+
+        EntryReader reader{payload.data(), payload.size()};
+        RequestEntry entry{};
+        if (!reader.Read(entry) || entry.interface_index >= interface_names.size()) {
+            LOG_ERROR(Core, "IPC trace {} has an invalid request", path);
+            return std::nullopt;
+        }
+
+        Request& request = requests.emplace_back();
+        request.interface_name = interface_names[entry.interface_index];
+        request.command = entry.command;
+        request.is_domain = entry.is_domain != 0;
+        request.time = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::nanoseconds{entry.time_ns});
+        request.command_buffer.resize(entry.command_buffer_size);
+        bool is_valid = reader.ReadBytes(request.command_buffer.data(),
+                                         request.command_buffer.size() * sizeof(u32));
+        for (u8 i = 0; is_valid && i < entry.num_buffers; ++i) {
+            BufferEntry buffer_entry{};
+            is_valid = reader.Read(buffer_entry);
+            if (!is_valid) {
+                break;
+            }
+            Buffer& buffer = request.buffers.emplace_back();
+            buffer.type = buffer_entry.type;
+            buffer.address = buffer_entry.address;
+            buffer.size = buffer_entry.size;
+            if (buffer_entry.has_data != 0) {
+                buffer.data.resize(buffer.size);
+                is_valid = reader.ReadBytes(buffer.data.data(), buffer.data.size());
+            }
+        }
+        if (!is_valid) {
+            LOG_ERROR(Core, "IPC trace {} has an invalid request", path);
+            return std::nullopt;
+        }
+    }
+    return requests;
+}
+
+IpcTrace::Request IpcTrace::Capture(const Kernel::HLERequestContext& ctx,
+                                    std::string interface_name) {
+    Request request{};
+    request.interface_name = std::move(interface_name);
+    request.command = ctx.GetCommand();
+    request.is_domain = ctx.Session()->IsDomain();
+
+    // The handler writes its response over the copy the context holds, the thread local storage
+    // still has the request as the guest made it
+    if (const auto& thread = ctx.GetThread()) {
+        std::array<u32, IPC::COMMAND_BUFFER_LENGTH> words{};
+        Memory::ReadBlock(thread->GetTLSAddress(), words.data(), sizeof(words));
+        request.command_buffer.assign(words.begin(), words.begin() + GetCommandBufferSize(words));
+    }
+
+    const auto add_buffer = [&request](BufferType type, VAddr address, u64 size, bool is_input) {
+        Buffer& buffer = request.buffers.emplace_back();
+        buffer.type = type;
+        buffer.address = address;
+        buffer.size = size;
+        if (is_input && size != 0) {
+            buffer.data.resize(size);
+            Memory::ReadBlock(address, buffer.data.data(), buffer.data.size());
+        }
+    };
+    for (const auto& descriptor : ctx.BufferDescriptorA()) {
+        add_buffer(BufferType::A, descriptor.Address(), descriptor.Size(), true);
+    }
+    for (const auto& descriptor : ctx.BufferDescriptorB()) {
+        add_buffer(BufferType::B, descriptor.Address(), descriptor.Size(), false);
+    }
+    for (const auto& descriptor : ctx.BufferDescriptorX()) {
+        add_buffer(BufferType::X, descriptor.Address(), descriptor.Size(), true);
+    }
+    for (const auto& descriptor : ctx.BufferDescriptorC()) {
+        add_buffer(BufferType::C, descriptor.Address(), descriptor.Size(), false);
+    }
+    return request;
+}
+
+IpcTrace::IpcTrace(std::string path, FileUtil::IOFile file)
+    : path{std::move(path)}, file{std::move(file)} {}
+
+IpcTrace::~IpcTrace() {
+    LOG_INFO(Core, "Wrote {} IPC requests to {}", num_requests, path);
+}
+
+void IpcTrace::Record(const Request& request) {
+    std::vector<u8> payload;
+    payload.reserve(sizeof(RequestEntry) + request.command_buffer.size() * sizeof(u32) +
+                    request.buffers.size() * sizeof(BufferEntry));
+
+    std::lock_guard lock{mutex};
+    auto [it, is_new] = interface_indices.emplace(request.interface_name,
+                                                  static_cast<u32>(interface_indices.size()));
+    if (is_new) {
+        const std::string& name = it->first;
+        WriteEntry(EntryType::Interface, std::vector<u8>(name.begin(), name.end()));
+    }
+
+    RequestEntry entry{};
+    entry.interface_index = it->second;
+    entry.command = request.command;
+    entry.time_ns = static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(request.time).count());
+    entry.is_domain = request.is_domain ? 1 : 0;
+    entry.command_buffer_size = static_cast<u8>(request.command_buffer.size());
+    entry.num_buffers = static_cast<u8>(request.buffers.size());
+    Append(payload, entry);
+    for (const u32 word : request.command_buffer) {
+        Append(payload, word);
+    }
+    for (const Buffer& buffer : request.buffers) {
+        BufferEntry buffer_entry{};
+        buffer_entry.address = buffer.address;
+        buffer_entry.size = buffer.size;
+        buffer_entry.type = buffer.type;
+        buffer_entry.has_data = buffer.data.empty() ? 0 : 1;
+        Append(payload, buffer_entry);
+        payload.insert(payload.end(), buffer.data.begin(), buffer.data.end());
+    }
+    WriteEntry(EntryType::Request, payload);
+    ++num_requests;
+}
+
+std::size_t IpcTrace::GetNumRequests() const {
+    std::lock_guard lock{mutex};
+    return num_requests;
+}
+
+void IpcTrace::WriteEntry(EntryType type, const std::vector<u8>& payload) {
+    const EntryHeader header{type, static_cast<u32>(payload.size())};
+    file.WriteObject(header);
+    file.WriteBytes(payload.data(), payload.size());
+}
+
+} // namespace Tools
@@ -0,0 +1,137 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace Kernel {
+class HLERequestContext;
+}
+
+namespace Tools {
+
+/**
+ * A trace of the IPC requests the HLE services handle, to find the services that dominate the host
+ * time of a title and to benchmark a service in isolation.
+ *
+ * Every request is written with the interface it was made to, its command id, the host time its
+ * handler took and its buffer descriptors. The command buffer and the contents of the input
+ * buffers are kept too, so that IpcReplay can run the request again without the guest.
+ */
+class IpcTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class BufferType : u8 {
+        A, ///< Send buffer, read by the service
+        B, ///< Receive buffer, written by the service
+        X, ///< Pointer buffer, read by the service
+        C, ///< Receive list, written by the service
+    };
+
+    struct Buffer {
+        BufferType type;
+        VAddr address;
+        u64 size;
+        /// Contents of the buffer when the service read them, empty for the output buffers.
+        std::vector<u8> data;
+    };
+
+    struct Request {
+        std::string interface_name;
+        u32 command;
+        bool is_domain;
+        Clock::duration time;
+        /// Incoming command buffer, from the header to the last buffer descriptor.
+        std::vector<u32> command_buffer;
+        std::vector<Buffer> buffers;
+    };
+
+    /// Opens a trace to write, returns nullptr if it could not be opened.
+    static std::unique_ptr<IpcTrace> Create(const std::string& path);
+
+    /// Opens a trace to write in the log directory.
+    static std::unique_ptr<IpcTrace> CreateInLogDirectory(u64 title_id);
+
+    /// Reads all the requests of a trace, returns nullopt if the file is not a valid trace.
+    static std::optional<std::vector<Request>> Read(const std::string& path);
+
+    /**
+     * Copies a request made by a guest thread, must be called before its handler writes the
+     * response. The time of the request is left for the caller to fill in.
+     */
+    static Request Capture(const Kernel::HLERequestContext& ctx, std::string interface_name);
+
+    ~IpcTrace();
+
+    /// Appends a request to the trace. Safe to call from the threads of all the cores.
+    void Record(const Request& request);
+
+    /// Returns the number of requests recorded so far.
+    std::size_t GetNumRequests() const;
+
+private:
+    struct Header {
+        u32 magic;
+        u32 version;
+    };
+    static_assert(sizeof(Header) == 0x8, "Header has incorrect size.");
+
+    enum class EntryType : u32 {
+        Interface, ///< Name of the interface of the next index, followed by the name
+        Request,   ///< A RequestEntry
+    };
+
+    /// Start of every entry, the payload follows with its size in bytes.
+    struct EntryHeader {
+        EntryType type;
+        u32 size;
+    };
+    static_assert(sizeof(EntryHeader) == 0x8, "EntryHeader has incorrect size.");
+
+    /// Followed by the command buffer words, then by the buffers.
+    struct RequestEntry {
+        u32 interface_index;
+        u32 command;
+        u64 time_ns;
+        u8 is_domain;
+        u8 command_buffer_size;
+        u8 num_buffers;
+        INSERT_PADDING_BYTES(5);
+    };
+    static_assert(sizeof(RequestEntry) == 0x18, "RequestEntry has incorrect size.");
+
+    /// Followed by the contents of the buffer if it has data.
+    struct BufferEntry {
+        u64 address;
+        u64 size;
+        BufferType type;
+        u8 has_data;
+        INSERT_PADDING_BYTES(6);
+    };
+    static_assert(sizeof(BufferEntry) == 0x18, "BufferEntry has incorrect size.");
+
+    IpcTrace(std::string path, FileUtil::IOFile file);
+
+    void WriteEntry(EntryType type, const std::vector<u8>& payload);
+
+    std::string path;
+
+    mutable std::mutex mutex;
+    FileUtil::IOFile file;
+    std::unordered_map<std::string, u32> interface_indices;
+    std::size_t num_requests = 0;
+};
+
+} // namespace Tools
@@ -0,0 +1,180 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+#include "common/assert.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/zstd_compression.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/vm_manager.h"
+#include "core/tools/memory_snapshot.h"
+
+namespace Tools {
+
+namespace {
+
+/// Longest run of changed pages compressed at once, a megabyte.
+constexpr std::size_t MAX_CHUNK_PAGES = 0x100;
+
+/// Snapshots are meant to be quick, the fastest level also compresses guest memory well.
+constexpr s32 COMPRESSION_LEVEL = 1;
+
+using Region = MemorySnapshotter::Region;
+
+/// Returns the host pointer of the page at address, or null if no region has it.
+u8* FindPage(const std::vector<Region>& sorted_regions, VAddr address) {
+    const auto it = std::upper_bound(
+        sorted_regions.begin(), sorted_regions.end(), address,
+        [](VAddr value, const Region& region) { return value < region.address; });
+    if (it == sorted_regions.begin()) {
+        return nullptr;
+    }
+    const Region& region = *std::prev(it);
+    if (address >= region.address + region.size) {
+        return nullptr;
+    }
+    return region.pointer + (address - region.address);
+}
+
+} // Anonymous namespace
+
+MemorySnapshotter::MemorySnapshotter() = default;
+MemorySnapshotter::~MemorySnapshotter() = default;
+
+std::size_t MemorySnapshotter::Capture(const std::vector<Region>& regions) {
+    Snapshot snapshot;
+    for (const Region& region : regions) {
+        ASSERT_MSG(region.address % PAGE_SIZE == 0 && region.size % PAGE_SIZE == 0,
+                   "Region at 0x{:016X} is not page aligned", region.address);
+
+        const std::size_t num_pages = region.size / PAGE_SIZE;
+        std::size_t run_begin = 0;
+        std::size_t run_size = 0;
+        const auto flush_run = [&] {
+            if (run_size == 0) {
+                return;
+            }
+            const u8* const run_pointer = region.pointer + run_begin * PAGE_SIZE;
+            Chunk chunk{region.address + run_begin * PAGE_SIZE, run_size,
+                        Common::Compression::CompressDataZSTD(run_pointer, run_size * PAGE_SIZE,
+                                                              COMPRESSION_LEVEL)};
+            snapshot.size += chunk.data.size();
+            snapshot.chunks.push_back(std::move(chunk));
+            run_size = 0;
+        };
+
+        for (std::size_t page = 0; page < num_pages; ++page) {
+            const u64 hash = Common::ComputeXXH3(region.pointer + page * PAGE_SIZE, PAGE_SIZE);
+            const auto [it, is_new] =
+                page_hashes.try_emplace(region.address + page * PAGE_SIZE, hash);
+            if (!is_new && it->second == hash) {
+                flush_run();
+                continue;
+            }
+            it->second = hash;
+            if (run_size == 0) {
+                run_begin = page;
+            }
+            if (++run_size == MAX_CHUNK_PAGES) {
+                flush_run();
+            }
+        }
+        flush_run();
+    }
+
+    LOG_DEBUG(Core, "Captured {} chunks of changed pages in 0x{:X} bytes", snapshot.chunks.size(),
+              snapshot.size);
+    snapshots.push_back(std::move(snapshot));
+    return snapshots.size() - 1;
+}
+
+bool MemorySnapshotter::Restore(std::size_t index, const std::vector<Region>& regions) {
+    if (index >= snapshots.size()) {
+        LOG_ERROR(Core, "Snapshot {} does not exist, there are {}", index, snapshots.size());
+        return false;
+    }
+
+    std::vector<Region> sorted_regions = regions;
+    std::sort(sorted_regions.begin(), sorted_regions.end(),
+              [](const Region& lhs, const Region& rhs) { return lhs.address < rhs.address; });
+
+    // Each page is restored from the latest snapshot up to index that captured it
+    std::unordered_set<VAddr> restored_pages;
+    std::size_t num_missing_pages = 0;
+    for (std::size_t i = index + 1; i-- > 0;) {
+        for (const Chunk& chunk : snapshots[i].chunks) {
+            std::vector<u8> data;
+            for (std::size_t page = 0; page < chunk.num_pages; ++page) {
+                const VAddr address = chunk.address + page * PAGE_SIZE;
+                if (restored_pages.count(address) != 0) {
+                    continue;
+                }
+                restored_pages.insert(address);
+
+                u8* const pointer = FindPage(sorted_regions, address);
+                if (pointer == nullptr) {
+                    ++num_missing_pages;
+                    page_hashes.erase(address);
+                    continue;
+                }
+                if (data.empty()) {
+                    data = Common::Compression::DecompressDataZSTD(chunk.data);
+                    ASSERT(data.size() == chunk.num_pages * PAGE_SIZE);
+                }
+                const u8* const source = data.data() + page * PAGE_SIZE;
+                std::memcpy(pointer, source, PAGE_SIZE);
+                page_hashes.insert_or_assign(address, Common::ComputeXXH3(source, PAGE_SIZE));
+            }
+        }
+    }
+    if (num_missing_pages != 0) {
+        LOG_WARNING(Core, "{} captured pages are no longer mapped and were not restored",
+                    num_missing_pages);
+    }
+
+    // Pages captured after the snapshot have to be captured again by the next one
+    for (auto it = page_hashes.begin(); it != page_hashes.end();) {
+        if (restored_pages.count(it->first) == 0) {
+            it = page_hashes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    snapshots.resize(index + 1);
+    return true;
+}
+
+void MemorySnapshotter::Clear() {
+    snapshots.clear();
+    page_hashes.clear();
+}
+
+std::size_t MemorySnapshotter::GetSnapshotSize(std::size_t index) const {
+    return index < snapshots.size() ? snapshots[index].size : 0;
+}
+
+std::vector<MemorySnapshotter::Region> GetProcessMemoryRegions(const Kernel::Process& process) {
+    const Kernel::VMManager& vm_manager = process.VMManager();
+    std::vector<MemorySnapshotter::Region> regions;
+    for (auto vma = vm_manager.FindVMA(0); vm_manager.IsValidHandle(vma); ++vma) {
+        const Kernel::VirtualMemoryArea& area = vma->second;
+        switch (area.type) {
+        case Kernel::VMAType::AllocatedMemoryBlock:
+            regions.push_back({area.base, area.backing_block->data() + area.offset, area.size});
+            break;
+        case Kernel::VMAType::BackingMemory:
+            regions.push_back({area.base, area.backing_memory, area.size});
+            break;
+        default:
+            break;
+        }
+    }
+    return regions;
+}
+
+} // namespace Tools
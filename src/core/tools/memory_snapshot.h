@@ -0,0 +1,88 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Kernel {
+class Process;
+}
+
+namespace Tools {
+
+/**
+ * Captures the contents of guest memory as a chain of snapshots that can be restored later. Each
+ * snapshot only stores the pages that changed since the previous snapshot or restore, compressed
+ * with Zstandard, so that capturing memory that mostly didn't change is quick and small.
+ *
+ * Changed pages are found by comparing the hashes of the pages with the ones they had when last
+ * captured or restored. Memory is given as a list of regions of host memory backing guest memory,
+ * which have to start and end on page boundaries.
+ */
+class MemorySnapshotter {
+public:
+    /// Host memory backing a range of guest memory.
+    struct Region {
+        VAddr address;
+        u8* pointer;
+        std::size_t size;
+    };
+
+    /// Size of the pages whose changes are tracked.
+    static constexpr std::size_t PAGE_SIZE = 0x1000;
+
+    MemorySnapshotter();
+    ~MemorySnapshotter();
+
+    /**
+     * Captures the pages of the regions that changed since the last snapshot or restore, the first
+     * snapshot captures every page.
+     * @returns Index of the snapshot.
+     */
+    std::size_t Capture(const std::vector<Region>& regions);
+
+    /**
+     * Restores the pages of the regions to their contents when a snapshot was captured, and drops
+     * the snapshots captured after it. Pages captured for the first time after the snapshot are
+     * left as they are.
+     * @returns True on success, false if there's no such snapshot.
+     */
+    bool Restore(std::size_t index, const std::vector<Region>& regions);
+
+    /// Drops all the snapshots, the next one captures every page again.
+    void Clear();
+
+    std::size_t GetNumSnapshots() const {
+        return snapshots.size();
+    }
+
+    /// Returns the compressed size in bytes of the pages a snapshot stores.
+    std::size_t GetSnapshotSize(std::size_t index) const;
+
+private:
+    /// Run of consecutive changed pages, compressed together.
+    struct Chunk {
+        VAddr address;
+        std::size_t num_pages;
+        std::vector<u8> data;
+    };
+
+    struct Snapshot {
+        std::vector<Chunk> chunks;
+        std::size_t size = 0;
+    };
+
+    std::vector<Snapshot> snapshots;
+    /// Hash of each page when it was last captured or restored, by guest address.
+    std::unordered_map<VAddr, u64> page_hashes;
+};
+
+/// Returns the regions of the memory mapped to a process that is backed by host memory.
+std::vector<MemorySnapshotter::Region> GetProcessMemoryRegions(const Kernel::Process& process);
+
+} // namespace Tools
@@ -0,0 +1,228 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <ctime>
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/arm/arm_interface.h"
+#include "core/core_cpu.h"
+#include "core/core_timing.h"
+#include "core/core_timing_util.h"
+#include "core/gdbstub/gdbstub.h"
+#include "core/memory.h"
+#include "core/tools/profiler.h"
+
+namespace Tools {
+
+namespace {
+
+static_assert(Profiler::NUM_CORES == Core::NUM_CPU_CORES, "Profiler must sample every core");
+
+/// A thousand samples per second of emulated time.
+constexpr s64 SAMPLE_TICKS = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 1000);
+
+/// Deepest stack sampled, frames further out are dropped.
+constexpr std::size_t MAX_STACK_DEPTH = 64;
+
+/// A module with its function symbols sorted by address.
+struct ModuleIndex {
+    const Profiler::Module* module;
+    std::vector<const Core::Symbols::Symbol*> symbols;
+};
+
+std::vector<ModuleIndex> IndexModules(const std::vector<Profiler::Module>& modules) {
+    std::vector<ModuleIndex> indices;
+    for (const Profiler::Module& module : modules) {
+        ModuleIndex& index = indices.emplace_back();
+        index.module = &module;
+        for (const Core::Symbols::Symbol& symbol : module.symbols) {
+            if (symbol.size != 0) {
+                index.symbols.push_back(&symbol);
+            }
+        }
+        std::sort(index.symbols.begin(), index.symbols.end(),
+                  [](const auto* lhs, const auto* rhs) { return lhs->value < rhs->value; });
+    }
+    std::sort(indices.begin(), indices.end(), [](const ModuleIndex& lhs, const ModuleIndex& rhs) {
+        return lhs.module->begin < rhs.module->begin;
+    });
+    return indices;
+}
+
+/// Names a frame by its module and symbol, or by its offset in the module if no symbol has it.
+std::string GetFrameName(const std::vector<ModuleIndex>& indices, VAddr address) {
+    const auto module_it = std::upper_bound(
+        indices.begin(), indices.end(), address,
+        [](VAddr value, const ModuleIndex& index) { return value < index.module->begin; });
+    if (module_it == indices.begin() || address > std::prev(module_it)->module->end) {
+        return fmt::format("0x{:016X}", address);
+    }
+    const ModuleIndex& index = *std::prev(module_it);
+    const u64 offset = address - index.module->begin;
+
+    const auto symbol_it = std::upper_bound(
+        index.symbols.begin(), index.symbols.end(), offset,
+        [](u64 value, const Core::Symbols::Symbol* symbol) { return value < symbol->value; });
+    if (symbol_it != index.symbols.begin()) {
+        const Core::Symbols::Symbol& symbol = **std::prev(symbol_it);
+        if (offset < symbol.value + symbol.size) {
+            return fmt::format("{}!{}", index.module->name, symbol.name);
+        }
+    }
+    return fmt::format("{}+0x{:X}", index.module->name, offset);
+}
+
+} // Anonymous namespace
+
+Profiler::Profiler(Core::Timing::CoreTiming& core_timing) : core_timing{core_timing} {
+    event = core_timing.RegisterEvent(
+        "Profiler::SampleCallback",
+        [this](u64 userdata, s64 cycles_late) { SampleCallback(userdata, cycles_late); });
+    core_timing.ScheduleEvent(SAMPLE_TICKS, event);
+}
+
+Profiler::~Profiler() {
+    core_timing.UnscheduleEvent(event, 0);
+}
+
+void Profiler::OnCoreSlice(std::size_t core_index, const Core::ARM_Interface& arm_interface,
+                           Clock::duration run_time) {
+    // The service functions ran within the slice, their time is already in their own samples
+    run_times[core_index] += run_time - std::exchange(service_times[core_index], {});
+
+    const u32 core_bit = 1U << core_index;
+    if ((pending_samples.load(std::memory_order_relaxed) & core_bit) == 0) {
+        return;
+    }
+    pending_samples.fetch_and(~core_bit, std::memory_order_relaxed);
+    AddSample(GetGuestStack(arm_interface), {}, std::exchange(run_times[core_index], {}));
+}
+
+void Profiler::AddServiceTime(std::size_t core_index, const Core::ARM_Interface& arm_interface,
+                              std::string_view service_name, std::string_view function_name,
+                              Clock::duration time) {
+    service_times[core_index] += time;
+    AddSample(GetGuestStack(arm_interface), fmt::format("{}::{}", service_name, function_name),
+              time);
+}
+
+void Profiler::AddSample(Stack stack, std::string hle_function, Clock::duration time) {
+    std::lock_guard lock{samples_mutex};
+    samples[{std::move(stack), std::move(hle_function)}] += time;
+    ++num_samples;
+}
+
+std::size_t Profiler::GetNumSamples() const {
+    std::lock_guard lock{samples_mutex};
+    return num_samples;
+}
+
+std::string Profiler::GetFoldedStacks(const std::vector<Module>& modules) const {
+    const std::vector<ModuleIndex> indices = IndexModules(modules);
+
+    // Samples of different addresses in the same functions are merged into one stack
+    std::map<std::string, Clock::duration> folded_stacks;
+    {
+        std::lock_guard lock{samples_mutex};
+        for (const auto& [key, time] : samples) {
+            const auto& [stack, hle_function] = key;
+
+            std::vector<std::string> frames;
+            for (std::size_t i = 0; i < stack.size(); ++i) {
+                std::string frame = GetFrameName(indices, stack[i]);
+                // lr only names the caller of a leaf function. Other functions either still have
+                // the return address of their frame record in it, or the address of their last
+                // call.
+                if (i == 1 &&
+                    ((stack.size() > 2 && stack[1] == stack[2]) || frame == frames.front())) {
+                    continue;
+                }
+                frames.push_back(std::move(frame));
+            }
+            if (!hle_function.empty()) {
+                frames.insert(frames.begin(), fmt::format("hle!{}", hle_function));
+            }
+            if (frames.empty()) {
+                continue;
+            }
+
+            std::string folded_stack;
+            for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+                if (!folded_stack.empty()) {
+                    folded_stack += ';';
+                }
+                folded_stack += *it;
+            }
+            folded_stacks[std::move(folded_stack)] += time;
+        }
+    }
+
+    std::string out;
+    for (const auto& [folded_stack, time] : folded_stacks) {
+        const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(time);
+        if (microseconds.count() > 0) {
+            out += fmt::format("{} {}\n", folded_stack, microseconds.count());
+        }
+    }
+    return out;
+}
+
+void Profiler::WriteToLogDirectory(u64 title_id) const {
+    const std::time_t t = std::time(nullptr);
+    const std::string& path = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
+    // %F Date format expanded is "%Y-%m-%d"
+    const std::string filename =
+        fmt::format("{}/{:%F-%H-%M}_{:016X}.folded", path, *std::localtime(&t), title_id);
+    FileUtil::IOFile file(filename, "w");
+    if (file.WriteString(GetFoldedStacks(GetLoadedModules())) == 0) {
+        LOG_ERROR(Core, "Failed to write the guest profile to {}", filename);
+        return;
+    }
+    LOG_INFO(Core, "Wrote {} guest profile samples to {}", GetNumSamples(), filename);
+}
+
+void Profiler::SampleCallback(u64 userdata, s64 cycles_late) {
+    pending_samples.store((1U << NUM_CORES) - 1, std::memory_order_relaxed);
+    core_timing.ScheduleEvent(SAMPLE_TICKS - cycles_late, event);
+}
+
+Profiler::Stack GetGuestStack(const Core::ARM_Interface& arm_interface) {
+    Profiler::Stack stack{arm_interface.GetPC(), arm_interface.GetReg(30) - 4};
+
+    // Frame records are two words, the previous frame record and the return address. Records
+    // always lie further up the stack than the ones of their callees.
+    VAddr fp = arm_interface.GetReg(29);
+    while (stack.size() < MAX_STACK_DEPTH && fp != 0 && fp % 8 == 0 &&
+           Memory::IsValidVirtualAddress(fp) && Memory::IsValidVirtualAddress(fp + 15)) {
+        const VAddr next_fp = Memory::Read64(fp);
+        const VAddr return_address = Memory::Read64(fp + 8);
+        if (return_address == 0) {
+            break;
+        }
+        stack.push_back(return_address - 4);
+        if (next_fp <= fp) {
+            break;
+        }
+        fp = next_fp;
+    }
+    return stack;
+}
+
+std::vector<Profiler::Module> GetLoadedModules() {
+    std::vector<Profiler::Module> modules;
+    for (const GDBStub::Module& module : GDBStub::GetModules()) {
+        // Modules of previous sessions stay registered, only name the ones still mapped
+        if (!Memory::IsValidVirtualAddress(module.beg)) {
+            continue;
+        }
+        modules.push_back(
+            {module.name, module.beg, module.end, Core::Symbols::GetSymbols(module.beg)});
+    }
+    return modules;
+}
+
+} // namespace Tools
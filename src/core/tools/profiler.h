@@ -0,0 +1,121 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "common/common_types.h"
+#include "core/arm/symbols.h"
+
+namespace Core {
+class ARM_Interface;
+}
+
+namespace Core::Timing {
+class CoreTiming;
+struct EventType;
+} // namespace Core::Timing
+
+namespace Tools {
+
+/**
+ * A sampling profiler of the guest code, to find the functions a slow title spends its time in.
+ *
+ * A timer periodically asks every emulated core for a sample, which each core takes on its own
+ * thread once its current slice ends, by walking the frame records of the running thread. A
+ * sample is weighted by the host time the core spent running guest code since its previous one.
+ * The host time taken by HLE service functions is recorded too, under the guest stack that called
+ * them, so that the hot spots of the game and of the emulator show up in the same profile.
+ *
+ * The profile is written as folded stacks, the input of the usual flame graph tools.
+ */
+class Profiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Guest stack of a sample, innermost first: the pc, the call site of lr, then the call sites
+     * of the return addresses found in the frame records.
+     */
+    using Stack = std::vector<VAddr>;
+
+    struct Module {
+        std::string name;
+        VAddr begin;
+        VAddr end;
+        Core::Symbols::Symbols symbols;
+    };
+
+    /// Number of emulated cores a profile can be sampled from.
+    static constexpr std::size_t NUM_CORES = 4;
+
+    explicit Profiler(Core::Timing::CoreTiming& core_timing);
+    ~Profiler();
+
+    /**
+     * Accounts the host time a core spent in its last slice, and samples the stack of its running
+     * thread if a sample is due. Must be called by the thread of the core.
+     */
+    void OnCoreSlice(std::size_t core_index, const Core::ARM_Interface& arm_interface,
+                     Clock::duration run_time);
+
+    /**
+     * Records the host time an HLE service function called by a core took. Must be called by the
+     * thread of the core, before the slice making the call ends.
+     */
+    void AddServiceTime(std::size_t core_index, const Core::ARM_Interface& arm_interface,
+                        std::string_view service_name, std::string_view function_name,
+                        Clock::duration time);
+
+    /// Adds time to a guest stack, optionally spent in an HLE function called from it.
+    void AddSample(Stack stack, std::string hle_function, Clock::duration time);
+
+    /// Returns the number of samples taken so far.
+    std::size_t GetNumSamples() const;
+
+    /**
+     * Returns the profile as folded stacks, one line for each distinct stack with the frames from
+     * the outermost to the innermost and its time in microseconds.
+     *
+     * @param modules Loaded modules, used to name the frames by module and symbol.
+     */
+    std::string GetFoldedStacks(const std::vector<Module>& modules) const;
+
+    /// Writes the folded stacks of the loaded modules to a file in the log directory.
+    void WriteToLogDirectory(u64 title_id) const;
+
+private:
+    void SampleCallback(u64 userdata, s64 cycles_late);
+
+    /// Bit of each core asked for a sample it has not taken yet.
+    std::atomic<u32> pending_samples{0};
+
+    /// Host time each core spent running guest code since its last sample.
+    std::array<Clock::duration, NUM_CORES> run_times{};
+    /// Host time each core spent in HLE service functions during its current slice.
+    std::array<Clock::duration, NUM_CORES> service_times{};
+
+    mutable std::mutex samples_mutex;
+    std::map<std::pair<Stack, std::string>, Clock::duration> samples;
+    std::size_t num_samples = 0;
+
+    Core::Timing::EventType* event;
+    Core::Timing::CoreTiming& core_timing;
+};
+
+/// Returns the stack of the thread running on a core.
+Profiler::Stack GetGuestStack(const Core::ARM_Interface& arm_interface);
+
+/// Returns the modules loaded in the current process, with their symbols.
+std::vector<Profiler::Module> GetLoadedModules();
+
+} // namespace Tools
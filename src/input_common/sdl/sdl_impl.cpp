@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cmath>
 #include <functional>
@@ -10,7 +11,6 @@
 #include <string>
 #include <thread>
 #include <tuple>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <SDL.h>
@@ -46,29 +46,41 @@ static int SDLEventWatcher(void* user_data, SDL_Event* event) {
     return 0;
 }
 
+/// Returns whether index addresses an element of the array
+template <typename T, std::size_t N>
+constexpr bool IsInRange(int index, const std::array<T, N>&) {
+    return index >= 0 && static_cast<std::size_t>(index) < N;
+}
+
 class SDLJoystick {
 public:
     SDLJoystick(std::string guid_, int port_, SDL_Joystick* joystick)
         : guid{std::move(guid_)}, port{port_}, sdl_joystick{joystick, &SDL_JoystickClose} {}
 
     void SetButton(int button, bool value) {
-        std::lock_guard lock{mutex};
-        state.buttons.insert_or_assign(button, value);
+        if (IsInRange(button, state.buttons)) {
+            state.buttons[button].store(value, std::memory_order_relaxed);
+        }
     }
 
     bool GetButton(int button) const {
-        std::lock_guard lock{mutex};
-        return state.buttons.at(button);
+        if (!IsInRange(button, state.buttons)) {
+            return false;
+        }
+        return state.buttons[button].load(std::memory_order_relaxed);
     }
 
     void SetAxis(int axis, Sint16 value) {
-        std::lock_guard lock{mutex};
-        state.axes.insert_or_assign(axis, value);
+        if (IsInRange(axis, state.axes)) {
+            state.axes[axis].store(value, std::memory_order_relaxed);
+        }
     }
 
     float GetAxis(int axis) const {
-        std::lock_guard lock{mutex};
-        return state.axes.at(axis) / 32767.0f;
+        if (!IsInRange(axis, state.axes)) {
+            return 0.0f;
+        }
+        return state.axes[axis].load(std::memory_order_relaxed) / 32767.0f;
     }
 
     std::tuple<float, float> GetAnalog(int axis_x, int axis_y) const {
@@ -89,13 +101,16 @@ public:
     }
 
     void SetHat(int hat, Uint8 direction) {
-        std::lock_guard lock{mutex};
-        state.hats.insert_or_assign(hat, direction);
+        if (IsInRange(hat, state.hats)) {
+            state.hats[hat].store(direction, std::memory_order_relaxed);
+        }
     }
 
     bool GetHatDirection(int hat, Uint8 direction) const {
-        std::lock_guard lock{mutex};
-        return (state.hats.at(hat) & direction) != 0;
+        if (!IsInRange(hat, state.hats)) {
+            return false;
+        }
+        return (state.hats[hat].load(std::memory_order_relaxed) & direction) != 0;
     }
     /**
      * The guid of the joystick
@@ -120,15 +135,16 @@ public:
     }
 
 private:
+    /// State written by the SDL event thread. Each input is a lock-free atomic indexed by its
+    /// SDL number, which is an 8-bit value in the events, so HID reads never wait on the poller.
     struct State {
-        std::unordered_map<int, bool> buttons;
-        std::unordered_map<int, Sint16> axes;
-        std::unordered_map<int, Uint8> hats;
+        std::array<std::atomic<bool>, 256> buttons{};
+        std::array<std::atomic<Sint16>, 256> axes{};
+        std::array<std::atomic<Uint8>, 256> hats{};
     } state;
     std::string guid;
     int port;
     std::unique_ptr<SDL_Joystick, decltype(&SDL_JoystickClose)> sdl_joystick;
-    mutable std::mutex mutex;
 };
 
 std::shared_ptr<SDLJoystick> SDLState::GetSDLJoystickByGUID(const std::string& guid, int port) {
@@ -476,9 +492,11 @@ SDLState::SDLState() {
     if (start_thread) {
         poll_thread = std::thread([this] {
             using namespace std::chrono_literals;
+            // Events are pumped every millisecond so they wait as little as possible before HID
+            // samples them
             while (initialized) {
                 SDL_PumpEvents();
-                std::this_thread::sleep_for(10ms);
+                std::this_thread::sleep_for(1ms);
             }
         });
     }
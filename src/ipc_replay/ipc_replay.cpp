@@ -0,0 +1,141 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// Summarizes the host time an IPC trace spent in each command of each service, and replays the
+// requests of a service against a fresh instance of it to measure them again on the same input.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "core/hle/service/audio/audren_u.h"
+#include "core/hle/service/nvdrv/interface.h"
+#include "core/hle/service/nvdrv/nvdrv.h"
+#include "core/tools/ipc_replay.h"
+#include "core/tools/ipc_trace.h"
+
+namespace {
+
+using Tools::IpcTrace;
+
+using ServiceFactory = std::shared_ptr<Service::ServiceFrameworkBase> (*)(Core::System&);
+
+template <const char* name>
+std::shared_ptr<Service::ServiceFrameworkBase> MakeNvdrv(Core::System& system) {
+    return std::make_shared<Service::Nvidia::NVDRV>(
+        std::make_shared<Service::Nvidia::Module>(system), name);
+}
+
+std::shared_ptr<Service::ServiceFrameworkBase> MakeAudRenU(Core::System& system) {
+    return std::make_shared<Service::Audio::AudRenU>(system);
+}
+
+constexpr char NVDRV_NAME[] = "nvdrv";
+constexpr char NVDRV_A_NAME[] = "nvdrv:a";
+constexpr char NVDRV_S_NAME[] = "nvdrv:s";
+constexpr char NVDRV_T_NAME[] = "nvdrv:t";
+
+/// Services that can run without a loaded title, the state they need comes from the requests.
+const std::map<std::string, ServiceFactory> SERVICE_FACTORIES{
+    {NVDRV_NAME, &MakeNvdrv<NVDRV_NAME>},     {NVDRV_A_NAME, &MakeNvdrv<NVDRV_A_NAME>},
+    {NVDRV_S_NAME, &MakeNvdrv<NVDRV_S_NAME>}, {NVDRV_T_NAME, &MakeNvdrv<NVDRV_T_NAME>},
+    {"audren:u", &MakeAudRenU},
+};
+
+struct CommandStats {
+    std::size_t count = 0;
+    IpcTrace::Clock::duration total{};
+    IpcTrace::Clock::duration max{};
+    u64 input_bytes = 0;
+
+    void Add(IpcTrace::Clock::duration time) {
+        ++count;
+        total += time;
+        max = std::max(max, time);
+    }
+};
+
+using StatsMap = std::map<std::pair<std::string, u32>, CommandStats>;
+
+double ToMicroseconds(IpcTrace::Clock::duration time) {
+    return std::chrono::duration<double, std::micro>(time).count();
+}
+
+void PrintStats(const StatsMap& stats) {
+    fmt::print("{:<32}{:>8}{:>10}{:>12}{:>12}{:>12}{:>12}\n", "interface", "command", "count",
+               "total ms", "mean us", "max us", "input KiB");
+    for (const auto& [key, command_stats] : stats) {
+        fmt::print("{:<32}{:>8}{:>10}{:>12.3f}{:>12.2f}{:>12.2f}{:>12.1f}\n", key.first, key.second,
+                   command_stats.count, ToMicroseconds(command_stats.total) / 1000,
+                   ToMicroseconds(command_stats.total) / command_stats.count,
+                   ToMicroseconds(command_stats.max), command_stats.input_bytes / 1024.0);
+    }
+}
+
+} // Anonymous namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <trace> [service]\n", argv[0]);
+        std::fprintf(stderr, "services that can be replayed:");
+        for (const auto& [name, factory] : SERVICE_FACTORIES) {
+            std::fprintf(stderr, " %s", name.c_str());
+        }
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+
+    const auto requests = IpcTrace::Read(argv[1]);
+    if (!requests) {
+        std::fprintf(stderr, "%s is not an IPC trace\n", argv[1]);
+        return 1;
+    }
+
+    StatsMap recorded;
+    for (const IpcTrace::Request& request : *requests) {
+        CommandStats& stats = recorded[{request.interface_name, request.command}];
+        stats.Add(request.time);
+        for (const IpcTrace::Buffer& buffer : request.buffers) {
+            stats.input_bytes += buffer.data.size();
+        }
+    }
+    fmt::print("Recorded, {} requests\n", requests->size());
+    PrintStats(recorded);
+
+    if (argc < 3) {
+        return 0;
+    }
+    const std::string service_name = argv[2];
+    const auto factory = SERVICE_FACTORIES.find(service_name);
+    if (factory == SERVICE_FACTORIES.end()) {
+        std::fprintf(stderr, "%s can't be replayed\n", service_name.c_str());
+        return 1;
+    }
+
+    // Requests are replayed in the order they were made, the service builds the same state as it
+    // had in the title as long as the trace holds all of its requests
+    auto& system = Core::System::GetInstance();
+    Tools::IpcReplay replay{system};
+    const auto service = factory->second(system);
+
+    StatsMap replayed;
+    for (const IpcTrace::Request& request : *requests) {
+        if (request.interface_name != service_name) {
+            continue;
+        }
+        replayed[{request.interface_name, request.command}].Add(replay.Invoke(service, request));
+    }
+    fmt::print("\nReplayed\n");
+    PrintStats(replayed);
+    return 0;
+}
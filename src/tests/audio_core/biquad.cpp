@@ -0,0 +1,60 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "audio_core/algorithm/biquad.h"
+
+namespace AudioCore {
+
+TEST_CASE("Biquad: Unity coefficients pass samples through", "[audio_core]") {
+    const std::vector<s16> input{0, 1, -1, 32767, -32768, 1234, -4321, 0};
+    std::vector<s16> output(input.size());
+    BiquadState state;
+    ApplyBiquad(BiquadFromFixedPoint({1 << 14, 0, 0}, {0, 0}), state, input.data(),
+                output.data(), input.size() / 2);
+    REQUIRE(output == input);
+}
+
+TEST_CASE("Biquad: Matches a double precision reference across blocks", "[audio_core]") {
+    // Low-pass with coefficients close to what games use, in Q14
+    const std::array<s16, 3> numerator{1024, 2048, 1024};
+    const std::array<s16, 2> denominator{-18000, 7000};
+    const BiquadCoefficients coefficients = BiquadFromFixedPoint(numerator, denominator);
+
+    std::vector<s16> input(512 * 2);
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<s16>(((i * 7919) % 20000) - 10000);
+    }
+
+    // Filtered in two blocks to check the state is carried over
+    std::vector<s16> output(input.size());
+    BiquadState state;
+    ApplyBiquad(coefficients, state, input.data(), output.data(), 100);
+    ApplyBiquad(coefficients, state, input.data() + 200, output.data() + 200, 412);
+
+    for (std::size_t channel = 0; channel < 2; ++channel) {
+        double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+        for (std::size_t frame = 0; frame < 512; ++frame) {
+            const double x = input[frame * 2 + channel];
+            const double y = (numerator[0] * x + numerator[1] * x1 + numerator[2] * x2 -
+                              denominator[0] * y1 - denominator[1] * y2) /
+                             (1 << 14);
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            const double expected = std::clamp(y, -32768.0, 32767.0);
+            REQUIRE(std::abs(output[frame * 2 + channel] - expected) <= 1.0);
+        }
+    }
+}
+
+} // namespace AudioCore
@@ -0,0 +1,60 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdlib>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "audio_core/algorithm/resampler.h"
+
+namespace AudioCore {
+
+namespace {
+
+std::vector<s16> Constant(std::size_t num_frames, s16 value) {
+    return std::vector<s16>(num_frames * 2, value);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Resampler: Output length follows the ratio", "[audio_core]") {
+    for (const u32 input_rate : {32000U, 44100U, 22050U, 30000U, 48000U, 96000U}) {
+        Resampler resampler;
+        const std::vector<s16> input = Constant(input_rate / 10, 0);
+        std::vector<s16> output;
+        resampler.Process(input.data(), input.size() / 2, input_rate, 48000, output);
+        REQUIRE(output.size() == 4800 * 2);
+    }
+}
+
+TEST_CASE("Resampler: Constant signals keep their level", "[audio_core]") {
+    for (const auto quality : {Resampler::Quality::Polyphase, Resampler::Quality::Linear}) {
+        for (const u32 input_rate : {32000U, 44100U, 22050U, 96000U}) {
+            Resampler resampler;
+            resampler.SetQuality(quality);
+            const std::vector<s16> input = Constant(1000, 10000);
+            std::vector<s16> output;
+            resampler.Process(input.data(), input.size() / 2, input_rate, 48000, output);
+
+            // Skips the frames filled from the initial silence of the history
+            for (std::size_t i = Resampler::NUM_TAPS * 8; i < output.size(); ++i) {
+                REQUIRE(std::abs(output[i] - 10000) <= 2);
+            }
+        }
+    }
+}
+
+TEST_CASE("Resampler: Linear mode interpolates between frames", "[audio_core]") {
+    Resampler resampler;
+    resampler.SetQuality(Resampler::Quality::Linear);
+    const std::vector<s16> input{0, 0, 300, -300, 600, -600};
+    std::vector<s16> output;
+    // Three output frames per input frame
+    resampler.Process(input.data(), 3, 16000, 48000, output);
+    REQUIRE(output == std::vector<s16>{0,   0,    0,   0,    0,   0,    0,   0,    100,
+                                       -100, 200, -200, 300, -300, 400, -400, 500, -500});
+}
+
+} // namespace AudioCore
@@ -0,0 +1,251 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "audio_core/algorithm/biquad.h"
+#include "audio_core/algorithm/mixer.h"
+#include "audio_core/algorithm/resampler.h"
+#include "audio_core/codec.h"
+#include "common/common_types.h"
+#include "tests/benchmarks/benchmark.h"
+
+namespace Benchmarks {
+
+namespace {
+
+// Voices play looping wave buffers of PCM16 and ADPCM data at the sample rates games use, each
+// buffer is decoded and resampled when the voice reaches it, then filtered and mixed 512 frames at
+// a time like a command list does. The input is generated from a fixed seed, so runs are
+// comparable.
+
+using AudioCore::BiquadCoefficients;
+using AudioCore::BiquadState;
+using AudioCore::Resampler;
+
+constexpr u32 STREAM_SAMPLE_RATE = 48000;
+constexpr std::size_t NUM_CHANNELS = 2;
+constexpr std::size_t BUFFER_FRAMES = 512;
+constexpr std::size_t WAVE_BUFFER_FRAMES = 4096;
+constexpr std::array<float, NUM_CHANNELS> CHANNEL_VOLUMES{1.0f, 1.0f};
+/// Voices playing at once, a busy scene in most games.
+constexpr std::size_t NUM_VOICES = 64;
+constexpr std::array<u32, 4> SAMPLE_RATES{48000, 32000, 44100, 22050};
+
+/// Bytes and samples of an ADPCM frame, as defined by the codec.
+constexpr std::size_t ADPCM_FRAME_LEN = 8;
+constexpr std::size_t ADPCM_SAMPLES_PER_FRAME = 14;
+
+struct Voice {
+    bool is_adpcm{};
+    u32 sample_rate{};
+    bool is_filtered{};
+
+    std::vector<u8> wave_data;
+    AudioCore::Codec::ADPCM_Coeff coeffs{};
+    AudioCore::Codec::ADPCMState adpcm_state{};
+    Resampler resampler;
+    BiquadCoefficients biquad;
+    BiquadState biquad_state;
+
+    std::vector<s16> decoded_samples;
+    std::vector<s16> samples;
+    std::vector<s16> resampled_samples;
+    std::vector<s16> filtered_samples;
+    std::size_t offset{};
+};
+
+std::vector<Voice> MakeVoices(std::size_t num_voices) {
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> sample_distribution(-32768, 32767);
+    std::uniform_int_distribution<int> byte_distribution(0, 255);
+    std::uniform_int_distribution<int> coeff_distribution(-2048, 2048);
+
+    std::vector<Voice> voices(num_voices);
+    for (std::size_t index = 0; index < num_voices; ++index) {
+        Voice& voice = voices[index];
+        voice.is_adpcm = index % 2 != 0;
+        voice.sample_rate = SAMPLE_RATES[index % SAMPLE_RATES.size()];
+        voice.is_filtered = index % 3 == 0;
+        voice.resampler.SetQuality(Resampler::Quality::Polyphase);
+        // Poles at a radius of 0.9, only the cost of the filter matters here
+        voice.biquad = AudioCore::BiquadFromFixedPoint({4096, 8192, 4096}, {0, 13271});
+
+        if (voice.is_adpcm) {
+            // ADPCM data is mono
+            const std::size_t num_frames = WAVE_BUFFER_FRAMES / ADPCM_SAMPLES_PER_FRAME;
+            voice.wave_data.resize(num_frames * ADPCM_FRAME_LEN);
+            for (std::size_t offset = 0; offset < voice.wave_data.size(); ++offset) {
+                // Headers select predictor 0-7 with a small scale, the rest is nibble data
+                voice.wave_data[offset] = offset % ADPCM_FRAME_LEN == 0
+                                              ? static_cast<u8>(byte_distribution(generator) & 0x73)
+                                              : static_cast<u8>(byte_distribution(generator));
+            }
+            std::generate(voice.coeffs.begin(), voice.coeffs.end(),
+                          [&] { return static_cast<s16>(coeff_distribution(generator)); });
+        } else {
+            voice.wave_data.resize(WAVE_BUFFER_FRAMES * NUM_CHANNELS * sizeof(s16));
+            for (std::size_t offset = 0; offset < voice.wave_data.size(); offset += sizeof(s16)) {
+                const auto sample = static_cast<s16>(sample_distribution(generator));
+                std::memcpy(voice.wave_data.data() + offset, &sample, sizeof(s16));
+            }
+        }
+    }
+    return voices;
+}
+
+/// Decodes and resamples the wave buffer of a voice, as the renderer does when a voice reaches it.
+void RefreshBuffer(Voice& voice) {
+    const s16* pcm = reinterpret_cast<const s16*>(voice.wave_data.data());
+    std::size_t num_samples = voice.wave_data.size() / sizeof(s16);
+    if (voice.is_adpcm) {
+        voice.decoded_samples.resize(AudioCore::Codec::GetADPCMSampleCount(voice.wave_data.size()));
+        num_samples = AudioCore::Codec::DecodeADPCM(
+            voice.decoded_samples.data(), voice.wave_data.data(), voice.wave_data.size(),
+            voice.coeffs, voice.adpcm_state);
+        pcm = voice.decoded_samples.data();
+
+        voice.samples.resize(num_samples * NUM_CHANNELS);
+        for (std::size_t index = 0; index < num_samples; ++index) {
+            voice.samples[index * 2] = pcm[index];
+            voice.samples[index * 2 + 1] = pcm[index];
+        }
+    } else {
+        voice.samples.assign(pcm, pcm + num_samples);
+    }
+
+    if (voice.sample_rate != STREAM_SAMPLE_RATE) {
+        voice.resampled_samples.clear();
+        voice.resampler.Process(voice.samples.data(), voice.samples.size() / NUM_CHANNELS,
+                                voice.sample_rate, STREAM_SAMPLE_RATE, voice.resampled_samples);
+        voice.samples.swap(voice.resampled_samples);
+    }
+    voice.offset = 0;
+}
+
+/// Mixes the next frames of a voice into the bus, refreshing its looping wave buffer as needed.
+void MixVoice(Voice& voice, float volume, std::vector<float>& bus) {
+    std::size_t frame = 0;
+    while (frame < BUFFER_FRAMES) {
+        if (voice.offset == voice.samples.size()) {
+            RefreshBuffer(voice);
+            if (voice.samples.empty()) {
+                return;
+            }
+        }
+        const std::size_t num_frames = std::min(
+            BUFFER_FRAMES - frame, (voice.samples.size() - voice.offset) / NUM_CHANNELS);
+        const s16* samples = voice.samples.data() + voice.offset;
+        if (voice.is_filtered) {
+            voice.filtered_samples.resize(num_frames * NUM_CHANNELS);
+            AudioCore::ApplyBiquad(voice.biquad, voice.biquad_state, samples,
+                                   voice.filtered_samples.data(), num_frames);
+            samples = voice.filtered_samples.data();
+        }
+        AudioCore::MixSamples(bus.data() + frame * NUM_CHANNELS, samples, num_frames,
+                              NUM_CHANNELS, CHANNEL_VOLUMES.data(), volume, 0.0f);
+        voice.offset += num_frames * NUM_CHANNELS;
+        frame += num_frames;
+    }
+}
+
+using Voices = std::vector<std::vector<s16>>;
+
+Voices MakeMixVoices(std::size_t num_voices) {
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> distribution(-32768, 32767);
+    Voices voices(num_voices, std::vector<s16>(BUFFER_FRAMES * NUM_CHANNELS));
+    for (auto& voice : voices) {
+        std::generate(voice.begin(), voice.end(),
+                      [&] { return static_cast<s16>(distribution(generator)); });
+    }
+    return voices;
+}
+
+/// Per sample s16 adds with clamping, as the renderer used to mix.
+void MixLegacy(const Voices& voices, float volume, std::vector<s16>& output) {
+    std::fill(output.begin(), output.end(), s16{0});
+    for (const auto& voice : voices) {
+        for (std::size_t i = 0; i < voice.size(); ++i) {
+            const s32 mixed = output[i] + static_cast<s32>(voice[i] * volume);
+            output[i] = static_cast<s16>(std::clamp(mixed, -32768, 32767));
+        }
+    }
+}
+
+template <typename MixFunc, typename SaturateFunc>
+void MixBus(const Voices& voices, float volume, std::vector<float>& bus, std::vector<s16>& output,
+            MixFunc&& mix, SaturateFunc&& saturate) {
+    std::fill(bus.begin(), bus.end(), 0.0f);
+    for (const auto& voice : voices) {
+        mix(bus.data(), voice.data(), BUFFER_FRAMES, NUM_CHANNELS, CHANNEL_VOLUMES.data(), volume,
+            0.0f);
+    }
+    saturate(output.data(), bus.data(), bus.size());
+}
+
+void RunVoiceBenchmark(Runner& runner) {
+    const float volume = 1.0f / static_cast<float>(NUM_VOICES);
+    std::vector<Voice> voices = MakeVoices(NUM_VOICES);
+    std::vector<float> bus(BUFFER_FRAMES * NUM_CHANNELS);
+    std::vector<s16> output(bus.size());
+
+    runner.Run("AudioRenderer/Voices64", 0, [&] {
+        std::fill(bus.begin(), bus.end(), 0.0f);
+        for (Voice& voice : voices) {
+            MixVoice(voice, volume, bus);
+        }
+        AudioCore::SaturateToS16(output.data(), bus.data(), bus.size());
+        DoNotOptimize(output);
+    });
+}
+
+void RunMixBenchmarks(Runner& runner) {
+    // Low enough to keep most of the legacy mix out of saturation
+    const float volume = 1.0f / static_cast<float>(NUM_VOICES);
+    const Voices voices = MakeMixVoices(NUM_VOICES);
+    const std::size_t input_size = NUM_VOICES * BUFFER_FRAMES * NUM_CHANNELS * sizeof(s16);
+    std::vector<float> bus(BUFFER_FRAMES * NUM_CHANNELS);
+    std::vector<s16> legacy_output(bus.size());
+    std::vector<s16> scalar_output(bus.size());
+    std::vector<s16> vector_output(bus.size());
+    bool has_scalar_output = false;
+    bool has_vector_output = false;
+
+    runner.Run("Mixer/Legacy64", input_size, [&] {
+        MixLegacy(voices, volume, legacy_output);
+        DoNotOptimize(legacy_output);
+    });
+    runner.Run("Mixer/Scalar64", input_size, [&] {
+        MixBus(voices, volume, bus, scalar_output, AudioCore::Scalar::MixSamples,
+               AudioCore::Scalar::SaturateToS16);
+        DoNotOptimize(scalar_output);
+        has_scalar_output = true;
+    });
+    runner.Run("Mixer/Vector64", input_size, [&] {
+        MixBus(voices, volume, bus, vector_output, AudioCore::MixSamples,
+               AudioCore::SaturateToS16);
+        DoNotOptimize(vector_output);
+        has_vector_output = true;
+    });
+
+    // The filter may have skipped one of the kernels
+    if (has_scalar_output && has_vector_output && scalar_output != vector_output) {
+        runner.Fail("Mixer/Vector64", "output differs from the scalar reference");
+    }
+}
+
+} // Anonymous namespace
+
+void RunAudioCoreBenchmarks(Runner& runner) {
+    RunVoiceBenchmark(runner);
+    RunMixBenchmarks(runner);
+}
+
+} // namespace Benchmarks
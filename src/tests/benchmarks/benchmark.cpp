@@ -0,0 +1,157 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/scm_rev.h"
+#include "tests/benchmarks/benchmark.h"
+
+namespace {
+
+std::atomic<std::size_t> num_allocations{0};
+std::atomic<std::size_t> num_allocated_bytes{0};
+
+} // Anonymous namespace
+
+void* operator new(std::size_t size) {
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    num_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace Benchmarks {
+
+std::size_t GetAllocationCount() {
+    return num_allocations.load(std::memory_order_relaxed);
+}
+
+std::size_t GetAllocatedBytes() {
+    return num_allocated_bytes.load(std::memory_order_relaxed);
+}
+
+Runner::Runner(std::string filter, double min_time)
+    : filter(std::move(filter)), min_time(min_time) {}
+
+u64 Runner::NextIterations(u64 iterations, double seconds) const {
+    // Aims a bit past the minimum time from the rate measured so far, growing at most tenfold
+    const double target = seconds > 0.0 ? iterations * min_time * 1.2 / seconds : iterations * 10.0;
+    const double next = std::clamp(target, iterations * 2.0, iterations * 10.0);
+    return std::min(static_cast<u64>(next), MAX_ITERATIONS);
+}
+
+void Runner::AddResult(const std::string& name, u64 iterations, double seconds,
+                       std::size_t bytes_per_iteration, std::size_t allocations,
+                       std::size_t allocated_bytes) {
+    Result result{name,
+                  iterations,
+                  seconds * 1e9 / iterations,
+                  0.0,
+                  static_cast<double>(allocations) / iterations,
+                  static_cast<double>(allocated_bytes) / iterations};
+    if (bytes_per_iteration != 0) {
+        result.bytes_per_second = static_cast<double>(bytes_per_iteration) * iterations / seconds;
+        std::printf("%-40s %14.1f ns %12.1f MB/s %10.1f allocs\n", name.c_str(),
+                    result.ns_per_iteration, result.bytes_per_second / (1024 * 1024),
+                    result.allocations_per_iteration);
+    } else {
+        std::printf("%-40s %14.1f ns %17s %10.1f allocs\n", name.c_str(),
+                    result.ns_per_iteration, "", result.allocations_per_iteration);
+    }
+    std::fflush(stdout);
+    results.push_back(std::move(result));
+}
+
+void Runner::Fail(const std::string& name, const std::string& reason) {
+    std::fprintf(stderr, "%s: %s\n", name.c_str(), reason.c_str());
+    failed = true;
+}
+
+std::string Runner::ToJson() const {
+    std::string json = fmt::format("{{\n  \"context\": {{\n    \"branch\": \"{}\",\n"
+                                   "    \"description\": \"{}\",\n    \"min_time\": {}\n  }},\n"
+                                   "  \"benchmarks\": [",
+                                   Common::g_scm_branch, Common::g_scm_desc, min_time);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        json += fmt::format("{}\n    {{\"name\": \"{}\", \"iterations\": {}, "
+                            "\"ns_per_iteration\": {:.3f}, \"bytes_per_second\": {:.1f}, "
+                            "\"allocations_per_iteration\": {:.1f}, "
+                            "\"allocated_bytes_per_iteration\": {:.1f}}}",
+                            i == 0 ? "" : ",", result.name, result.iterations,
+                            result.ns_per_iteration, result.bytes_per_second,
+                            result.allocations_per_iteration,
+                            result.allocated_bytes_per_iteration);
+    }
+    json += "\n  ]\n}\n";
+    return json;
+}
+
+} // namespace Benchmarks
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string json_path;
+    std::vector<std::string> shader_caches;
+    double min_time = 0.5;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument.rfind("--filter=", 0) == 0) {
+            filter = argument.substr(9);
+        } else if (argument.rfind("--json=", 0) == 0) {
+            json_path = argument.substr(7);
+        } else if (argument.rfind("--min-time=", 0) == 0) {
+            min_time = std::max(std::atof(argument.c_str() + 11), 0.001);
+        } else if (argument.rfind("--shader-cache=", 0) == 0) {
+            shader_caches.push_back(argument.substr(15));
+        } else {
+            std::fprintf(stderr,
+                         "Usage: %s [--filter=TEXT] [--min-time=SECONDS] [--json=FILE] "
+                         "[--shader-cache=FILE]...\n",
+                         argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Only critical messages, logging e.g. unimplemented shader instructions would dominate the
+    // timings
+    Log::Filter log_filter(Log::Level::Critical);
+    Log::SetGlobalFilter(log_filter);
+
+    Benchmarks::Runner runner(std::move(filter), min_time);
+    Benchmarks::RunAudioCoreBenchmarks(runner);
+    Benchmarks::RunCommonBenchmarks(runner);
+    Benchmarks::RunCoreBenchmarks(runner);
+    Benchmarks::RunVideoCoreBenchmarks(runner);
+    Benchmarks::RunShaderBenchmarks(runner, shader_caches);
+
+    if (!json_path.empty() &&
+        FileUtil::WriteStringToFile(true, json_path, runner.ToJson()) == 0) {
+        std::fprintf(stderr, "Could not write %s\n", json_path.c_str());
+        return EXIT_FAILURE;
+    }
+    return runner.HasFailed() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace Benchmarks {
+
+/// Number of allocations made so far and their total size, counted by the global operator new.
+std::size_t GetAllocationCount();
+std::size_t GetAllocatedBytes();
+
+/// Keeps the compiler from optimizing away the computation of a value.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#ifdef _MSC_VER
+    static const void* volatile sink;
+    sink = &value;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/// Runs benchmarks and collects their results. Each benchmark is called in batches of growing size
+/// until a batch runs for the minimum time, which is then measured.
+class Runner {
+public:
+    struct Result {
+        std::string name;
+        u64 iterations;
+        double ns_per_iteration;
+        /// Bytes processed per second, zero for benchmarks that don't process a buffer
+        double bytes_per_second;
+        double allocations_per_iteration;
+        double allocated_bytes_per_iteration;
+    };
+
+    /// Only the benchmarks whose name contains filter are run.
+    Runner(std::string filter, double min_time);
+
+    /// Measures func, which processes bytes_per_iteration bytes on each call unless it is zero.
+    template <typename Func>
+    void Run(const std::string& name, std::size_t bytes_per_iteration, Func&& func) {
+        if (name.find(filter) == std::string::npos) {
+            return;
+        }
+
+        u64 iterations = 1;
+        while (true) {
+            const std::size_t allocations = GetAllocationCount();
+            const std::size_t allocated_bytes = GetAllocatedBytes();
+            const auto start = Clock::now();
+            for (u64 i = 0; i < iterations; ++i) {
+                func();
+            }
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (seconds >= min_time || iterations >= MAX_ITERATIONS) {
+                AddResult(name, iterations, seconds, bytes_per_iteration,
+                          GetAllocationCount() - allocations,
+                          GetAllocatedBytes() - allocated_bytes);
+                return;
+            }
+            iterations = NextIterations(iterations, seconds);
+        }
+    }
+
+    const std::vector<Result>& GetResults() const {
+        return results;
+    }
+
+    /// Reports a benchmark whose output is wrong, the run then exits with a failure.
+    void Fail(const std::string& name, const std::string& reason);
+
+    bool HasFailed() const {
+        return failed;
+    }
+
+    /// Returns the results as a JSON document, to be compared with earlier runs.
+    std::string ToJson() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr u64 MAX_ITERATIONS = 1000000000;
+
+    u64 NextIterations(u64 iterations, double seconds) const;
+    void AddResult(const std::string& name, u64 iterations, double seconds,
+                   std::size_t bytes_per_iteration, std::size_t allocations,
+                   std::size_t allocated_bytes);
+
+    std::string filter;
+    double min_time;
+    std::vector<Result> results;
+    bool failed = false;
+};
+
+void RunAudioCoreBenchmarks(Runner& runner);
+void RunCommonBenchmarks(Runner& runner);
+void RunCoreBenchmarks(Runner& runner);
+void RunVideoCoreBenchmarks(Runner& runner);
+
+/// Decodes the shaders of transferable shader caches, only run when caches are given.
+void RunShaderBenchmarks(Runner& runner, const std::vector<std::string>& cache_paths);
+
+} // namespace Benchmarks
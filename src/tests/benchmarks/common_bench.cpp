@@ -0,0 +1,111 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/cityhash.h"
+#include "common/common_types.h"
+#include "common/hash.h"
+#include "common/lz4_compression.h"
+#include "common/multi_level_queue.h"
+#include "common/zstd_compression.h"
+#include "tests/benchmarks/benchmark.h"
+
+namespace Benchmarks {
+
+namespace {
+
+constexpr std::size_t COMPRESSION_SIZE = 1024 * 1024;
+
+/// Returns data that compresses about as well as shader caches and save data, runs of repeating
+/// words mixed with noise.
+std::vector<u8> MakeCompressibleData(std::size_t size) {
+    std::mt19937 generator(0x5EED);
+    std::vector<u8> data(size);
+    for (std::size_t i = 0; i < size; i += sizeof(u32)) {
+        const u32 word = generator() % 4 == 0 ? generator() : static_cast<u32>(i / 256);
+        std::memcpy(data.data() + i, &word, std::min(sizeof(u32), size - i));
+    }
+    return data;
+}
+
+void RunHashBenchmarks(Runner& runner) {
+    std::vector<u8> data(1 << 20);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<u8>(i * 31 + 7);
+    }
+
+    for (const std::size_t size : {16, 64, 4096, 1 << 20}) {
+        runner.Run(fmt::format("CityHash64/{}", size), size, [&] {
+            DoNotOptimize(Common::CityHash64(reinterpret_cast<const char*>(data.data()), size));
+        });
+        runner.Run(fmt::format("XXH3/{}", size), size,
+                   [&] { DoNotOptimize(Common::ComputeXXH3(data.data(), size)); });
+    }
+}
+
+void RunMultiLevelQueueBenchmarks(Runner& runner) {
+    // Like the scheduler of a core with a few threads on each of the priorities games use
+    constexpr std::size_t NUM_THREADS = 32;
+    Common::MultiLevelQueue<u32, 64> queue;
+    for (u32 thread = 0; thread < NUM_THREADS; ++thread) {
+        queue.add(thread, 24 + thread % 8);
+    }
+
+    runner.Run("MultiLevelQueue/FrontRemoveAdd", 0, [&] {
+        const u32 thread = queue.front();
+        const u32 priority = 24 + thread % 8;
+        queue.remove(thread, priority);
+        queue.add(thread, priority);
+    });
+    runner.Run("MultiLevelQueue/Yield", 0, [&] {
+        queue.yield(24);
+        DoNotOptimize(queue.front());
+    });
+    runner.Run("MultiLevelQueue/Adjust", 0, [&] {
+        const u32 thread = queue.front();
+        const u32 priority = 24 + thread % 8;
+        queue.adjust(thread, priority, 63);
+        queue.adjust(thread, 63, priority);
+    });
+}
+
+void RunCompressionBenchmarks(Runner& runner) {
+    const std::vector<u8> data = MakeCompressibleData(COMPRESSION_SIZE);
+
+    const std::vector<u8> lz4 = Common::Compression::CompressDataLZ4(data.data(), data.size());
+    runner.Run("LZ4/Compress", data.size(), [&] {
+        DoNotOptimize(Common::Compression::CompressDataLZ4(data.data(), data.size()));
+    });
+    runner.Run("LZ4/CompressHC", data.size(), [&] {
+        DoNotOptimize(Common::Compression::CompressDataLZ4HC(data.data(), data.size(), 9));
+    });
+    runner.Run("LZ4/Decompress", data.size(), [&] {
+        DoNotOptimize(Common::Compression::DecompressDataLZ4(lz4, data.size()));
+    });
+
+    const std::vector<u8> zstd =
+        Common::Compression::CompressDataZSTDDefault(data.data(), data.size());
+    runner.Run("Zstd/Compress", data.size(), [&] {
+        DoNotOptimize(Common::Compression::CompressDataZSTDDefault(data.data(), data.size()));
+    });
+    runner.Run("Zstd/Decompress", data.size(), [&] {
+        DoNotOptimize(Common::Compression::DecompressDataZSTD(zstd));
+    });
+}
+
+} // Anonymous namespace
+
+void RunCommonBenchmarks(Runner& runner) {
+    RunHashBenchmarks(runner);
+    RunMultiLevelQueueBenchmarks(runner);
+    RunCompressionBenchmarks(runner);
+}
+
+} // namespace Benchmarks
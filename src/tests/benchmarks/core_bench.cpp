@@ -0,0 +1,278 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <mbedtls/cipher.h>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/crypto/aes_util.h"
+#include "core/crypto/key_manager.h"
+#include "core/hle/kernel/handle_table.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/resource_limit.h"
+#include "core/memory.h"
+#include "core/memory_setup.h"
+#include "tests/benchmarks/benchmark.h"
+
+namespace Benchmarks {
+
+namespace {
+
+constexpr VAddr MEMORY_BASE = 0x10000000;
+constexpr std::size_t MEMORY_SIZE = 0x100000;
+/// Bytes touched by one iteration of the single access benchmarks.
+constexpr std::size_t ACCESS_SPAN = 0x1000;
+constexpr std::size_t BLOCK_SIZE = 0x10000;
+/// Bytes decrypted by one iteration of the AES benchmarks.
+constexpr std::size_t CRYPTO_SIZE = 0x100000;
+
+template <typename T, typename Access>
+void RunAccessBenchmark(Runner& runner, const char* name, Access&& access) {
+    runner.Run(name, ACCESS_SPAN, [&] {
+        for (VAddr addr = MEMORY_BASE; addr < MEMORY_BASE + ACCESS_SPAN; addr += sizeof(T)) {
+            access(addr);
+        }
+    });
+}
+
+void RunMemoryBenchmarks(Runner& runner) {
+    auto& system = Core::System::GetInstance();
+    const auto process =
+        Kernel::Process::Create(system, "benchmark", Kernel::Process::ProcessType::Userland);
+    auto& page_table = process->VMManager().page_table;
+
+    std::vector<u8> backing(MEMORY_SIZE);
+    Memory::MapMemoryRegion(page_table, MEMORY_BASE, MEMORY_SIZE, backing.data());
+    system.Kernel().MakeCurrentProcess(process.get());
+
+    RunAccessBenchmark<u8>(runner, "Memory/Read8",
+                           [](VAddr addr) { DoNotOptimize(Memory::Read8(addr)); });
+    RunAccessBenchmark<u32>(runner, "Memory/Read32",
+                            [](VAddr addr) { DoNotOptimize(Memory::Read32(addr)); });
+    RunAccessBenchmark<u64>(runner, "Memory/Read64",
+                            [](VAddr addr) { DoNotOptimize(Memory::Read64(addr)); });
+    RunAccessBenchmark<u8>(runner, "Memory/Write8",
+                           [](VAddr addr) { Memory::Write8(addr, static_cast<u8>(addr)); });
+    RunAccessBenchmark<u32>(runner, "Memory/Write32",
+                            [](VAddr addr) { Memory::Write32(addr, static_cast<u32>(addr)); });
+    RunAccessBenchmark<u64>(runner, "Memory/Write64",
+                            [](VAddr addr) { Memory::Write64(addr, addr); });
+
+    std::vector<u8> block(BLOCK_SIZE);
+    // The second half of the range starts in the middle of a page, as most guest buffers do
+    const VAddr block_addr = MEMORY_BASE + MEMORY_SIZE / 2 + Memory::PAGE_SIZE / 2;
+    runner.Run("Memory/ReadBlock", BLOCK_SIZE, [&] {
+        Memory::ReadBlock(block_addr, block.data(), block.size());
+        DoNotOptimize(block);
+    });
+    runner.Run("Memory/WriteBlock", BLOCK_SIZE,
+               [&] { Memory::WriteBlock(block_addr, block.data(), block.size()); });
+
+    system.Kernel().MakeCurrentProcess(nullptr);
+    Memory::UnmapRegion(page_table, MEMORY_BASE, MEMORY_SIZE);
+}
+
+void RunCoreTimingBenchmarks(Runner& runner) {
+    constexpr u64 NUM_EVENTS = 64;
+
+    Core::Timing::CoreTiming core_timing;
+    core_timing.Initialize();
+
+    u64 fired = 0;
+    auto* const event = core_timing.RegisterEvent("benchmark", [&fired](u64, s64) { ++fired; });
+
+    // Schedules events at scattered times, then runs a core through them as the CPU loop does
+    runner.Run("CoreTiming/ScheduleAdvance", 0, [&] {
+        fired = 0;
+        for (u64 i = 0; i < NUM_EVENTS; ++i) {
+            core_timing.ScheduleEvent(static_cast<s64>(100 + (i * 7919) % 5000), event, i);
+        }
+        while (fired < NUM_EVENTS) {
+            core_timing.SwitchContext(0);
+            if (!core_timing.CanCurrentContextRun()) {
+                core_timing.ResetRun();
+            }
+            core_timing.AddTicks(core_timing.GetDowncount());
+            core_timing.Advance();
+        }
+    });
+
+    runner.Run("CoreTiming/ScheduleUnschedule", 0, [&] {
+        for (u64 i = 0; i < NUM_EVENTS; ++i) {
+            core_timing.ScheduleEvent(static_cast<s64>(100 + (i * 7919) % 5000), event, i);
+        }
+        for (u64 i = 0; i < NUM_EVENTS; ++i) {
+            core_timing.UnscheduleEvent(event, i);
+        }
+    });
+
+    core_timing.Shutdown();
+}
+
+void RunHandleTableBenchmarks(Runner& runner) {
+    constexpr std::size_t NUM_HANDLES = 256;
+
+    auto& kernel = Core::System::GetInstance().Kernel();
+    const auto object = Kernel::ResourceLimit::Create(kernel);
+
+    Kernel::HandleTable handle_table;
+    std::array<Kernel::Handle, NUM_HANDLES> handles{};
+
+    runner.Run("HandleTable/CreateClose", 0, [&] {
+        for (auto& handle : handles) {
+            handle = handle_table.Create(object).Unwrap();
+        }
+        for (const auto handle : handles) {
+            handle_table.Close(handle);
+        }
+    });
+
+    for (auto& handle : handles) {
+        handle = handle_table.Create(object).Unwrap();
+    }
+    runner.Run("HandleTable/Get", 0, [&] {
+        for (const auto handle : handles) {
+            DoNotOptimize(handle_table.Get<Kernel::ResourceLimit>(handle));
+        }
+    });
+    handle_table.Clear();
+}
+
+/// Decrypts with mbedtls the way AESCipher did before the native path, one update per call.
+void MbedtlsTranscode(mbedtls_cipher_context_t& context, const u8* iv, const u8* src,
+                      std::size_t size, u8* dest) {
+    std::size_t written = 0;
+    mbedtls_cipher_set_iv(&context, iv, 0x10);
+    mbedtls_cipher_reset(&context);
+    mbedtls_cipher_update(&context, src, size, dest, &written);
+    mbedtls_cipher_finish(&context, nullptr, nullptr);
+}
+
+std::array<u8, 0x10> SectorTweak(std::size_t sector) {
+    std::array<u8, 0x10> tweak{};
+    for (std::size_t i = 0xF; i <= 0xF; --i) {
+        tweak[i] = static_cast<u8>(sector & 0xFF);
+        sector >>= 8;
+    }
+    return tweak;
+}
+
+std::array<u8, 0x10> CtrCounter(std::size_t offset) {
+    std::array<u8, 0x10> counter{};
+    offset >>= 4;
+    for (std::size_t i = 0; i < 8; ++i) {
+        counter[0xF - i] = static_cast<u8>(offset & 0xFF);
+        offset >>= 8;
+    }
+    return counter;
+}
+
+/// Decrypts in the modes used by NCA sections and headers with AESCipher and with mbedtls used
+/// directly, the outputs of both have to match.
+void RunAESBenchmarks(Runner& runner) {
+    using Core::Crypto::AESCipher;
+    using Core::Crypto::Key128;
+    using Core::Crypto::Key256;
+    using Core::Crypto::Mode;
+    using Core::Crypto::Op;
+
+    /// Sector size of NCA sections encrypted with XTS.
+    constexpr std::size_t XTS_SECTOR_SIZE = 0x4000;
+    /// Reads of RomFS data through the CTR layer are usually this size or smaller.
+    constexpr std::size_t CTR_CHUNK_SIZE = 0x4000;
+
+    Key256 key256{};
+    for (std::size_t i = 0; i < key256.size(); ++i) {
+        key256[i] = static_cast<u8>(i * 29 + 3);
+    }
+    Key128 key128{};
+    std::copy_n(key256.begin(), key128.size(), key128.begin());
+
+    std::vector<u8> input(CRYPTO_SIZE);
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<u8>(i * 7 + 1);
+    }
+    std::vector<u8> cipher_output(CRYPTO_SIZE);
+    std::vector<u8> mbedtls_output(CRYPTO_SIZE);
+
+    mbedtls_cipher_context_t ctr_context;
+    mbedtls_cipher_init(&ctr_context);
+    mbedtls_cipher_setup(&ctr_context, mbedtls_cipher_info_from_type(MBEDTLS_CIPHER_AES_128_CTR));
+    mbedtls_cipher_setkey(&ctr_context, key128.data(), 128, MBEDTLS_DECRYPT);
+
+    mbedtls_cipher_context_t xts_context;
+    mbedtls_cipher_init(&xts_context);
+    mbedtls_cipher_setup(&xts_context, mbedtls_cipher_info_from_type(MBEDTLS_CIPHER_AES_128_XTS));
+    mbedtls_cipher_setkey(&xts_context, key256.data(), 256, MBEDTLS_DECRYPT);
+
+    // The filter may have skipped one side, outputs are only compared when both ran
+    bool has_cipher_output = false;
+    bool has_mbedtls_output = false;
+    const auto compare = [&](const char* name) {
+        if (has_cipher_output && has_mbedtls_output && cipher_output != mbedtls_output) {
+            runner.Fail(name, "AESCipher output differs from mbedtls");
+        }
+        has_cipher_output = false;
+        has_mbedtls_output = false;
+    };
+
+    AESCipher<Key128> ctr_cipher(key128, Mode::CTR);
+    runner.Run("AESCipher/CTR", CRYPTO_SIZE, [&] {
+        for (std::size_t offset = 0; offset < CRYPTO_SIZE; offset += CTR_CHUNK_SIZE) {
+            const auto counter = CtrCounter(offset);
+            ctr_cipher.SetIV({counter.begin(), counter.end()});
+            ctr_cipher.Transcode(input.data() + offset, CTR_CHUNK_SIZE,
+                                 cipher_output.data() + offset, Op::Decrypt);
+        }
+        DoNotOptimize(cipher_output);
+        has_cipher_output = true;
+    });
+    runner.Run("mbedtls/CTR", CRYPTO_SIZE, [&] {
+        for (std::size_t offset = 0; offset < CRYPTO_SIZE; offset += CTR_CHUNK_SIZE) {
+            MbedtlsTranscode(ctr_context, CtrCounter(offset).data(), input.data() + offset,
+                             CTR_CHUNK_SIZE, mbedtls_output.data() + offset);
+        }
+        DoNotOptimize(mbedtls_output);
+        has_mbedtls_output = true;
+    });
+    compare("AESCipher/CTR");
+
+    AESCipher<Key256> xts_cipher(key256, Mode::XTS);
+    runner.Run("AESCipher/XTS", CRYPTO_SIZE, [&] {
+        xts_cipher.XTSTranscode(input.data(), CRYPTO_SIZE, cipher_output.data(), 0,
+                                XTS_SECTOR_SIZE, Op::Decrypt);
+        DoNotOptimize(cipher_output);
+        has_cipher_output = true;
+    });
+    runner.Run("mbedtls/XTS", CRYPTO_SIZE, [&] {
+        for (std::size_t offset = 0; offset < CRYPTO_SIZE; offset += XTS_SECTOR_SIZE) {
+            MbedtlsTranscode(xts_context, SectorTweak(offset / XTS_SECTOR_SIZE).data(),
+                             input.data() + offset, XTS_SECTOR_SIZE,
+                             mbedtls_output.data() + offset);
+        }
+        DoNotOptimize(mbedtls_output);
+        has_mbedtls_output = true;
+    });
+    compare("AESCipher/XTS");
+
+    mbedtls_cipher_free(&ctr_context);
+    mbedtls_cipher_free(&xts_context);
+}
+
+} // Anonymous namespace
+
+void RunCoreBenchmarks(Runner& runner) {
+    RunMemoryBenchmarks(runner);
+    RunCoreTimingBenchmarks(runner);
+    RunHandleTableBenchmarks(runner);
+    RunAESBenchmarks(runner);
+}
+
+} // namespace Benchmarks
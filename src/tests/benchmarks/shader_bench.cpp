@@ -0,0 +1,197 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common_types.h"
+#include "tests/benchmarks/benchmark.h"
+#include "video_core/engines/const_buffer_engine_interface.h"
+#include "video_core/renderer_opengl/gl_device.h"
+#include "video_core/renderer_opengl/gl_shader_decompiler.h"
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+#include "video_core/renderer_opengl/gl_shader_gen.h"
+#include "video_core/shader/const_buffer_locker.h"
+#include "video_core/shader/control_flow.h"
+#include "video_core/shader/shader_ir.h"
+
+namespace Benchmarks {
+
+namespace {
+
+using OpenGL::ProgramType;
+using OpenGL::ShaderDiskCacheOpenGL;
+using OpenGL::ShaderDiskCacheRaw;
+using OpenGL::ShaderDiskCacheUsage;
+using VideoCommon::Shader::CompilerSettings;
+using VideoCommon::Shader::ConstBufferLocker;
+using VideoCommon::Shader::ProgramCode;
+using VideoCommon::Shader::ShaderIR;
+
+constexpr u32 STAGE_MAIN_OFFSET = 10;
+constexpr u32 KERNEL_MAIN_OFFSET = 0;
+constexpr CompilerSettings COMPILER_SETTINGS{};
+
+/// A shader of the corpus with one of the sets of keys its usages recorded.
+struct ShaderVariant {
+    const ShaderDiskCacheRaw* raw;
+    std::unique_ptr<ConstBufferLocker> locker;
+    std::unique_ptr<ShaderIR> ir;
+    std::unique_ptr<ShaderIR> ir_b;
+};
+
+Tegra::Engines::ShaderType GetEnginesShaderType(ProgramType program_type) {
+    switch (program_type) {
+    case ProgramType::VertexA:
+    case ProgramType::VertexB:
+        return Tegra::Engines::ShaderType::Vertex;
+    case ProgramType::TessellationControl:
+        return Tegra::Engines::ShaderType::TesselationControl;
+    case ProgramType::TessellationEval:
+        return Tegra::Engines::ShaderType::TesselationEval;
+    case ProgramType::Geometry:
+        return Tegra::Engines::ShaderType::Geometry;
+    case ProgramType::Fragment:
+        return Tegra::Engines::ShaderType::Fragment;
+    case ProgramType::Compute:
+        return Tegra::Engines::ShaderType::Compute;
+    }
+    return Tegra::Engines::ShaderType::Vertex;
+}
+
+std::string GenerateGLSL(const OpenGL::Device& device, ProgramType program_type,
+                         const ShaderIR& ir, const ShaderIR* ir_b) {
+    using namespace OpenGL::GLShader;
+    switch (program_type) {
+    case ProgramType::VertexA:
+    case ProgramType::VertexB:
+        return GenerateVertexShader(device, ir, ir_b);
+    case ProgramType::Geometry:
+        return GenerateGeometryShader(device, ir);
+    case ProgramType::Fragment:
+        return GenerateFragmentShader(device, ir);
+    case ProgramType::Compute:
+        return GenerateComputeShader(device, ir);
+    default:
+        return {};
+    }
+}
+
+std::unique_ptr<ConstBufferLocker> MakeLocker(ProgramType program_type,
+                                              const ShaderDiskCacheUsage* usage) {
+    auto locker = std::make_unique<ConstBufferLocker>(GetEnginesShaderType(program_type));
+    if (usage == nullptr) {
+        return locker;
+    }
+    for (const auto& [address, value] : usage->keys) {
+        locker->InsertKey(address.first, address.second, value);
+    }
+    for (const auto& [offset, sampler] : usage->bound_samplers) {
+        locker->InsertBoundSampler(offset, sampler);
+    }
+    for (const auto& [address, sampler] : usage->bindless_samplers) {
+        locker->InsertBindlessSampler(address.first, address.second, sampler);
+    }
+    return locker;
+}
+
+/// Returns a locker for each distinct set of keys the usages of a shader recorded.
+std::vector<std::unique_ptr<ConstBufferLocker>> MakeLockers(
+    const ShaderDiskCacheRaw& raw, const std::vector<ShaderDiskCacheUsage>& usages) {
+    std::vector<std::unique_ptr<ConstBufferLocker>> lockers;
+    for (const auto& usage : usages) {
+        if (usage.unique_identifier != raw.GetUniqueIdentifier()) {
+            continue;
+        }
+        auto locker = MakeLocker(raw.GetProgramType(), &usage);
+        const bool is_new = std::none_of(lockers.begin(), lockers.end(), [&](const auto& other) {
+            return other->HasEqualKeys(*locker);
+        });
+        if (is_new) {
+            lockers.push_back(std::move(locker));
+        }
+    }
+    if (lockers.empty()) {
+        lockers.push_back(MakeLocker(raw.GetProgramType(), nullptr));
+    }
+    return lockers;
+}
+
+u32 GetMainOffset(const ShaderDiskCacheRaw& raw) {
+    return raw.GetProgramType() == ProgramType::Compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
+}
+
+void DecodeVariant(ShaderVariant& variant) {
+    const u32 main_offset = GetMainOffset(*variant.raw);
+    const ProgramCode& code_b = variant.raw->GetProgramCodeB();
+    variant.ir = std::make_unique<ShaderIR>(variant.raw->GetProgramCode(), main_offset,
+                                            COMPILER_SETTINGS, *variant.locker);
+    if (!code_b.empty()) {
+        variant.ir_b =
+            std::make_unique<ShaderIR>(code_b, main_offset, COMPILER_SETTINGS, *variant.locker);
+    }
+}
+
+} // Anonymous namespace
+
+void RunShaderBenchmarks(Runner& runner, const std::vector<std::string>& cache_paths) {
+    std::vector<ShaderDiskCacheRaw> raws;
+    std::vector<ShaderDiskCacheUsage> usages;
+    for (const auto& path : cache_paths) {
+        auto entries = ShaderDiskCacheOpenGL::LoadTransferableFile(path);
+        if (!entries) {
+            runner.Fail("Shader", "failed to load " + path);
+            return;
+        }
+        auto& [file_raws, file_usages] = *entries;
+        std::move(file_raws.begin(), file_raws.end(), std::back_inserter(raws));
+        std::move(file_usages.begin(), file_usages.end(), std::back_inserter(usages));
+    }
+    if (raws.empty()) {
+        return;
+    }
+
+    // Every shader is decoded once per set of keys its usages recorded, the same way the disk
+    // cache does on boot
+    std::vector<ShaderVariant> variants;
+    for (const auto& raw : raws) {
+        for (auto& locker : MakeLockers(raw, usages)) {
+            variants.push_back({&raw, std::move(locker), nullptr, nullptr});
+        }
+    }
+    std::printf("%zu shaders, %zu key variants\n", raws.size(), variants.size());
+
+    // ShaderIR scans the control flow again, the decode benchmark includes it
+    runner.Run("Shader/ControlFlow", 0, [&] {
+        for (const auto& variant : variants) {
+            DoNotOptimize(VideoCommon::Shader::ScanFlow(variant.raw->GetProgramCode(),
+                                                        GetMainOffset(*variant.raw),
+                                                        COMPILER_SETTINGS, *variant.locker));
+        }
+    });
+    runner.Run("Shader/Decode", 0, [&] {
+        for (auto& variant : variants) {
+            DecodeVariant(variant);
+        }
+    });
+
+    const OpenGL::Device device(nullptr);
+    for (auto& variant : variants) {
+        if (!variant.ir) {
+            DecodeVariant(variant);
+        }
+    }
+    runner.Run("Shader/GLSL", 0, [&] {
+        for (const auto& variant : variants) {
+            DoNotOptimize(GenerateGLSL(device, variant.raw->GetProgramType(), *variant.ir,
+                                       variant.ir_b.get()));
+        }
+    });
+}
+
+} // namespace Benchmarks
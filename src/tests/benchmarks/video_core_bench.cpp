@@ -0,0 +1,76 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <vector>
+
+#include "common/common_types.h"
+#include "tests/benchmarks/benchmark.h"
+#include "video_core/textures/astc.h"
+#include "video_core/textures/decoders.h"
+
+namespace Benchmarks {
+
+namespace {
+
+/// Swizzled in blocks of 16 GOBs, as the guest allocates most render targets and textures.
+constexpr u32 BLOCK_HEIGHT = 4;
+constexpr u32 BLOCK_DEPTH = 0;
+/// Alignment of the width in GOBs, the default of zero is not a valid alignment.
+constexpr u32 WIDTH_SPACING = 1;
+
+void RunUnswizzleBenchmark(Runner& runner, const char* name, u32 tile_size, u32 bytes_per_pixel,
+                           u32 width, u32 height) {
+    const u32 width_in_tiles = (width + tile_size - 1) / tile_size;
+    const u32 height_in_tiles = (height + tile_size - 1) / tile_size;
+    std::vector<u8> swizzled(Tegra::Texture::CalculateSize(
+        true, bytes_per_pixel, width_in_tiles, height_in_tiles, 1, BLOCK_HEIGHT, BLOCK_DEPTH));
+    for (std::size_t i = 0; i < swizzled.size(); ++i) {
+        swizzled[i] = static_cast<u8>(i);
+    }
+    std::vector<u8> unswizzled(width_in_tiles * height_in_tiles * bytes_per_pixel);
+
+    runner.Run(name, unswizzled.size(), [&] {
+        Tegra::Texture::UnswizzleTexture(unswizzled.data(), swizzled.data(), tile_size, tile_size,
+                                         bytes_per_pixel, width, height, 1, BLOCK_HEIGHT,
+                                         BLOCK_DEPTH, WIDTH_SPACING);
+        DoNotOptimize(unswizzled);
+    });
+}
+
+void RunASTCBenchmark(Runner& runner) {
+    constexpr u32 WIDTH = 256;
+    constexpr u32 HEIGHT = 256;
+    constexpr u32 BLOCK_SIZE = 4;
+    constexpr std::size_t NUM_BLOCKS = (WIDTH / BLOCK_SIZE) * (HEIGHT / BLOCK_SIZE);
+
+    // Random blocks with a fixed mode keep the decoder on its common path: a 4x4 weight grid of
+    // 3 bit weights, a single partition and RGBA endpoints, with random endpoints and weights
+    std::mt19937 random(0x41535443);
+    std::vector<u8> blocks(NUM_BLOCKS * 16);
+    for (std::size_t block = 0; block < NUM_BLOCKS; ++block) {
+        u8* const data = &blocks[block * 16];
+        for (std::size_t i = 3; i < 16; ++i) {
+            data[i] = static_cast<u8>(random());
+        }
+        data[0] = 0x41;
+        data[1] = 0x00;
+        data[2] = static_cast<u8>((random() & 0xFE) | 1);
+    }
+
+    runner.Run("ASTC/Decompress4x4", WIDTH * HEIGHT * 4, [&] {
+        DoNotOptimize(Tegra::Texture::ASTC::Decompress(blocks.data(), WIDTH, HEIGHT, 1,
+                                                       BLOCK_SIZE, BLOCK_SIZE));
+    });
+}
+
+} // Anonymous namespace
+
+void RunVideoCoreBenchmarks(Runner& runner) {
+    RunUnswizzleBenchmark(runner, "Texture/UnswizzleRGBA8", 1, 4, 1024, 1024);
+    RunUnswizzleBenchmark(runner, "Texture/UnswizzleBC1", 4, 8, 1024, 1024);
+    RunASTCBenchmark(runner);
+}
+
+} // namespace Benchmarks
@@ -0,0 +1,95 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/bounded_threadsafe_queue.h"
+
+namespace Common {
+
+TEST_CASE("BoundedMPSCQueue: Basic Tests", "[common]") {
+    BoundedMPSCQueue<int, 4> queue;
+    int value = 0;
+
+    // Popping from an empty queue should fail.
+    REQUIRE(queue.Empty());
+    REQUIRE(!queue.Pop(value));
+
+    // Pushing returns the position of each element, starting at one.
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(queue.Push(i * 10) == static_cast<u64>(i) + 1);
+    }
+    REQUIRE(!queue.Empty());
+
+    // Elements are popped in the order they were pushed.
+    for (int i = 0; i < 2; i++) {
+        REQUIRE(queue.Pop(value));
+        REQUIRE(value == i * 10);
+    }
+
+    // Freed slots can be reused once the queue wraps around.
+    REQUIRE(queue.Push(40) == 5);
+    REQUIRE(queue.Push(50) == 6);
+    for (int i = 2; i < 6; i++) {
+        queue.PopWait(value);
+        REQUIRE(value == i * 10);
+    }
+
+    REQUIRE(queue.Empty());
+}
+
+TEST_CASE("BoundedMPSCQueue: TryPush", "[common]") {
+    BoundedMPSCQueue<int, 2> queue;
+    int value = 0;
+
+    // TryPush fails instead of waiting once the queue is full.
+    REQUIRE(queue.TryPush(1));
+    REQUIRE(queue.TryPush(2));
+    REQUIRE(!queue.TryPush(3));
+
+    // Popping frees a slot for the next element.
+    REQUIRE(queue.Pop(value));
+    REQUIRE(value == 1);
+    REQUIRE(queue.TryPush(4));
+    REQUIRE(queue.Pop(value));
+    REQUIRE(value == 2);
+    REQUIRE(queue.Pop(value));
+    REQUIRE(value == 4);
+    REQUIRE(queue.Empty());
+}
+
+TEST_CASE("BoundedMPSCQueue: Threaded Test", "[common]") {
+    constexpr std::size_t num_producers = 4;
+    constexpr u32 count = 100000;
+    BoundedMPSCQueue<std::array<u32, 2>, 8> queue;
+
+    std::vector<std::thread> producers;
+    for (u32 producer = 0; producer < num_producers; producer++) {
+        producers.emplace_back([&queue, producer] {
+            for (u32 i = 0; i < count; i++) {
+                queue.Push(std::array<u32, 2>{producer, i});
+            }
+        });
+    }
+
+    // Every producer's elements arrive in order, even when interleaved with the others'.
+    std::array<u32, num_producers> next{};
+    for (std::size_t i = 0; i < num_producers * count; i++) {
+        std::array<u32, 2> value;
+        queue.PopWait(value);
+        REQUIRE(value[0] < num_producers);
+        REQUIRE(value[1] == next[value[0]]);
+        next[value[0]]++;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    REQUIRE(queue.Empty());
+}
+
+} // namespace Common
@@ -0,0 +1,65 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstddef>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "common/hash.h"
+
+namespace Common {
+
+namespace {
+
+struct HashVector {
+    std::size_t len;
+    u64 hash;
+    u64 seeded_hash;
+};
+
+constexpr u64 SEED = 0x9E3779B97F4A7C15ULL;
+
+// Hashes of the reference XXH3_64bits, one for each of the code paths of the hash.
+constexpr std::array<HashVector, 8> VECTORS{{
+    {0, 0x2D06800538D394C2ULL, 0x602B0E2CD6662C8BULL},
+    {3, 0x326832CB2353E0FAULL, 0xA7FCB784ECB9BC6BULL},
+    {8, 0x8D166D6ECFB40A39ULL, 0x3EFD468C56F64E64ULL},
+    {16, 0x8F20EA5FC099E842ULL, 0x3DFF7C27ABD8E0FFULL},
+    {100, 0xCB7D1B6097437AD6ULL, 0x8CA5438DA052FC17ULL},
+    {200, 0xA2330474D1BC2BE0ULL, 0xD5AD540E5684C03AULL},
+    {1000, 0xE72FB4EC72265C80ULL, 0x142EC8C8F5458EA2ULL},
+    {4096, 0xA2297E1FADC5C8E1ULL, 0x13BE0AAA940CB494ULL},
+}};
+
+std::array<u8, 4096> MakeData() {
+    std::array<u8, 4096> data;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<u8>(i * i + 7 * i + 3);
+    }
+    return data;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("XXH3: Matches the reference hashes", "[common]") {
+    const auto data = MakeData();
+    for (const auto& vector : VECTORS) {
+        REQUIRE(ComputeXXH3(data.data(), vector.len) == vector.hash);
+        REQUIRE(ComputeXXH3(data.data(), vector.len, SEED) == vector.seeded_hash);
+    }
+}
+
+TEST_CASE("XXH3: Unaligned input", "[common]") {
+    const auto data = MakeData();
+    std::array<u8, 4097> shifted;
+    shifted[0] = 0;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        shifted[i + 1] = data[i];
+    }
+    for (const auto& vector : VECTORS) {
+        REQUIRE(ComputeXXH3(shifted.data() + 1, vector.len) == vector.hash);
+    }
+}
+
+} // namespace Common
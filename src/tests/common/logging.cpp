@@ -0,0 +1,123 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+
+namespace {
+
+/// Backend keeping the messages of one log class, so the test can wait for the logging thread.
+class CaptureBackend : public Log::Backend {
+public:
+    static const char* Name() {
+        return "capture";
+    }
+
+    const char* GetName() const override {
+        return Name();
+    }
+
+    void Write(const Log::Entry& entry) override {
+        if (entry.log_class != Log::Class::Debug_Emulated) {
+            return;
+        }
+        std::lock_guard lock{mutex};
+        messages.push_back(entry.message);
+        cv.notify_all();
+    }
+
+    std::vector<std::string> WaitForMessages(std::size_t count) {
+        std::unique_lock lock{mutex};
+        cv.wait_for(lock, std::chrono::seconds{10}, [&] { return messages.size() >= count; });
+        return messages;
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> messages;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("Logging[DeferredFormatting]", "[common]") {
+    auto capture = std::make_unique<CaptureBackend>();
+    auto* const backend = capture.get();
+    Log::AddBackend(std::move(capture));
+
+    Log::Filter filter;
+    filter.ParseFilterString("*:Info");
+    Log::SetGlobalFilter(filter);
+
+    std::vector<std::string> expected;
+    {
+        // The arguments are gone before the logging thread formats the message
+        std::string temporary = "temporary string";
+        const std::string_view view = temporary;
+        LOG_INFO(Debug_Emulated, "{} {} {}", temporary, view.substr(0, 9), temporary.c_str());
+        temporary.assign(temporary.size(), 'x');
+        expected.push_back("temporary string temporary temporary string");
+    }
+
+    const u8 byte = 0xAB;
+    const u64 address = 0x80004000;
+    LOG_INFO(Debug_Emulated, "{} {:#x} {:016X} {} {:.2f} {}", byte, byte, address, 'c', 2.5,
+             true);
+    expected.push_back("171 0xab 0000000080004000 c 2.50 true");
+
+    // Too large to be packed, formatted by the caller instead
+    const std::string large(Log::Detail::PACKED_ARGS_SIZE, 'a');
+    LOG_WARNING(Debug_Emulated, "{}{}", large, 1);
+    expected.push_back(large + "1");
+
+    LOG_ERROR(Debug_Emulated, "No arguments");
+    expected.push_back("No arguments");
+
+    // Rejected by the filter
+    LOG_DEBUG(Debug_Emulated, "{}", 0);
+
+    LOG_INFO(Debug_Emulated, "Bad {:d}", "format");
+    LOG_INFO(Debug_Emulated, "Last");
+
+    const auto messages = backend->WaitForMessages(expected.size() + 2);
+    Log::RemoveBackend(CaptureBackend::Name());
+
+    REQUIRE(messages.size() == expected.size() + 2);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(messages[i] == expected[i]);
+    }
+    REQUIRE(messages[expected.size()].find("Invalid log format") == 0);
+    REQUIRE(messages[expected.size() + 1] == "Last");
+}
+
+TEST_CASE("Logging[FilteredArguments]", "[common]") {
+    Log::Filter filter;
+    filter.ParseFilterString("*:Info Debug.Emulated:Warning");
+    Log::SetGlobalFilter(filter);
+
+    int evaluated = 0;
+    const auto evaluate = [&evaluated] { return ++evaluated; };
+
+    // Arguments of filtered messages are never evaluated
+    LOG_INFO(Debug_Emulated, "{}", evaluate());
+    LOG_TRACE(Debug_GPU, "{}", evaluate());
+    REQUIRE(evaluated == 0);
+
+    LOG_INFO(Debug_GPU, "{}", evaluate());
+    LOG_WARNING(Debug_Emulated, "{}", evaluate());
+    REQUIRE(evaluated == 2);
+
+    Log::SetGlobalFilter(Log::Filter{});
+}
@@ -0,0 +1,23 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/percentile.h"
+
+namespace Common {
+
+TEST_CASE("GetPercentile[NearestRank]", "[common]") {
+    const std::vector<double> samples{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0};
+    REQUIRE(GetPercentile(samples, 0.0) == 1.0);
+    REQUIRE(GetPercentile(samples, 0.50) == 5.0);
+    REQUIRE(GetPercentile(samples, 0.95) == 10.0);
+    REQUIRE(GetPercentile(samples, 1.0) == 10.0);
+    REQUIRE(GetPercentile(samples.data(), 4, 0.50) == 2.0);
+    REQUIRE(GetPercentile(std::vector<double>{}, 0.50) == 0.0);
+}
+
+} // namespace Common
@@ -0,0 +1,120 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/thread.h"
+#include "common/thread_pool.h"
+
+namespace Common {
+
+TEST_CASE("ThreadPool: Submit", "[common]") {
+    ThreadPool pool{4};
+    std::atomic<int> count{0};
+
+    std::vector<TaskHandle> tasks;
+    for (int i = 0; i < 100; i++) {
+        tasks.push_back(pool.Submit([&count] { ++count; }));
+    }
+    for (const auto& task : tasks) {
+        task.Wait();
+        REQUIRE(task.IsDone());
+    }
+    REQUIRE(count == 100);
+
+    // A default constructed handle refers to no task and never blocks.
+    const TaskHandle empty;
+    REQUIRE(!empty.IsValid());
+    REQUIRE(empty.IsDone());
+    empty.Wait();
+}
+
+TEST_CASE("ThreadPool: Continuations", "[common]") {
+    ThreadPool pool{2};
+    std::mutex mutex;
+    std::vector<int> order;
+    const auto append = [&](int value) {
+        std::lock_guard lock{mutex};
+        order.push_back(value);
+    };
+
+    // Continuations run after their parent, even when it finished before they were added.
+    const auto first = pool.Submit([&] { append(1); });
+    const auto second = pool.Then(first, [&] { append(2); });
+    const auto third = pool.Then(second, [&] { append(3); }, TaskPriority::High);
+    third.Wait();
+    const auto fourth = pool.Then(third, [&] { append(4); });
+    fourth.Wait();
+
+    REQUIRE(order == std::vector<int>{1, 2, 3, 4});
+}
+
+TEST_CASE("ThreadPool: Nested waits", "[common]") {
+    // Tasks waiting on the tasks they submit don't deadlock a pool with a single worker.
+    ThreadPool pool{1};
+    std::atomic<int> count{0};
+
+    const auto outer = pool.Submit([&] {
+        std::vector<TaskHandle> inner;
+        for (int i = 0; i < 8; i++) {
+            inner.push_back(pool.Submit([&count] { ++count; }));
+        }
+        for (const auto& task : inner) {
+            task.Wait();
+        }
+    });
+    outer.Wait();
+    REQUIRE(count == 8);
+}
+
+TEST_CASE("ThreadPool: Reserved threads", "[common]") {
+    ThreadPool pool{4};
+    REQUIRE(pool.GetNumActiveThreads() == 4);
+
+    pool.SetReservedThreads(3);
+    REQUIRE(pool.GetNumActiveThreads() == 1);
+
+    // At least one worker keeps running tasks.
+    pool.SetReservedThreads(8);
+    REQUIRE(pool.GetNumActiveThreads() == 1);
+    std::atomic<int> count{0};
+    std::vector<TaskHandle> tasks;
+    for (int i = 0; i < 16; i++) {
+        tasks.push_back(pool.Submit([&count] { ++count; }, TaskPriority::Low));
+    }
+    for (const auto& task : tasks) {
+        task.Wait();
+    }
+    REQUIRE(count == 16);
+
+    pool.SetReservedThreads(0);
+    REQUIRE(pool.GetNumActiveThreads() == 4);
+}
+
+TEST_CASE("ParallelFor: Runs every index once", "[common]") {
+    std::vector<std::atomic<int>> calls(1000);
+    ParallelFor(calls.size(), [&calls](std::size_t index) { ++calls[index]; });
+    for (const auto& value : calls) {
+        REQUIRE(value == 1);
+    }
+}
+
+TEST_CASE("PreciseSleepUntil: Never wakes up early", "[common]") {
+    using Clock = std::chrono::steady_clock;
+    for (const auto delay : {std::chrono::microseconds{0}, std::chrono::microseconds{100},
+                             std::chrono::microseconds{2500}}) {
+        const auto deadline = Clock::now() + delay;
+        PreciseSleepUntil(deadline);
+        REQUIRE(Clock::now() >= deadline);
+    }
+
+    // Deadlines that already passed return immediately
+    PreciseSleepUntil(Clock::now() - std::chrono::seconds{1});
+}
+
+} // namespace Common
@@ -21,7 +21,7 @@ TestEnvironment::TestEnvironment(bool mutable_memory_)
     page_table = &process->VMManager().page_table;
 
     std::fill(page_table->pointers.begin(), page_table->pointers.end(), nullptr);
-    page_table->special_regions.clear();
+    page_table->ClearSpecialRegions();
     std::fill(page_table->attributes.begin(), page_table->attributes.end(),
               Common::PageType::Unmapped);
 
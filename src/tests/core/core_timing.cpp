@@ -8,9 +8,11 @@
 #include <bitset>
 #include <cstdlib>
 #include <string>
+#include <thread>
 #include "common/file_util.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/core_timing_util.h"
 
 // Numbers are chosen randomly to make sure the correct one is given.
 static constexpr std::array<u64, 5> CB_IDS{{42, 144, 93, 1026, UINT64_C(0xFFFF7FFFF7FFFF)}};
@@ -202,3 +204,51 @@ TEST_CASE("CoreTiming[ChainScheduling]", "[core]") {
     core_timing.Advance(); // cb_rs
     REQUIRE(0 == reschedules);
 }
+
+TEST_CASE("CoreTiming[ThreadsafeScheduling]", "[core]") {
+    ScopeInit guard;
+    auto& core_timing = guard.core_timing;
+
+    Core::Timing::EventType* cb_a = core_timing.RegisterEvent("callbackA", CallbackTemplate<0>);
+    Core::Timing::EventType* cb_b = core_timing.RegisterEvent("callbackB", CallbackTemplate<1>);
+
+    // Enter slice 0
+    core_timing.ResetRun();
+
+    std::thread poster([&] {
+        core_timing.ScheduleEventThreadsafe(0, cb_a, CB_IDS[0]);
+        core_timing.ScheduleEventThreadsafe(100, cb_b, CB_IDS[1]);
+    });
+    poster.join();
+
+    // Posted events don't touch the running slice, they are queued by the next Advance
+    REQUIRE(MAX_SLICE_LENGTH == core_timing.GetDowncount());
+
+    AdvanceAndCheck(core_timing, 0, 0);
+    AdvanceAndCheck(core_timing, 1, 1);
+}
+
+TEST_CASE("CoreTiming[HostTiming]", "[core]") {
+    Core::Timing::CoreTiming core_timing;
+    core_timing.Initialize(true);
+
+    Core::Timing::EventType* cb = core_timing.RegisterEvent("callback", EmptyCallback);
+    callbacks_done = 0;
+
+    core_timing.ResetRun();
+    core_timing.ScheduleEvent(Core::Timing::msToCycles(std::chrono::milliseconds(1)), cb);
+
+    // Executed cycles don't move guest time, only the host clock does
+    core_timing.SwitchContext(0);
+    core_timing.AddTicks(core_timing.GetDowncount());
+    core_timing.Advance();
+    REQUIRE(callbacks_done == 0);
+
+    core_timing.WaitForNextEvent();
+    REQUIRE(core_timing.GetTicks() >=
+            static_cast<u64>(Core::Timing::msToCycles(std::chrono::milliseconds(1))));
+    core_timing.Advance();
+    REQUIRE(callbacks_done == 1);
+
+    core_timing.Shutdown();
+}
@@ -0,0 +1,57 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "common/hex_util.h"
+#include "core/crypto/sha_util.h"
+
+namespace Core::Crypto {
+
+namespace {
+
+SHA256Hash Hash(std::string_view message) {
+    SHA256Hasher hasher;
+    hasher.Update(reinterpret_cast<const u8*>(message.data()), message.size());
+    return hasher.Finish();
+}
+
+} // Anonymous namespace
+
+TEST_CASE("SHA256Hasher", "[core][crypto]") {
+    // FIPS 180-2 appendix B, and the hash of the empty message
+    REQUIRE(Hash("") == Common::HexStringToArray<0x20>(
+                            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+    REQUIRE(Hash("abc") == Common::HexStringToArray<0x20>(
+                               "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+    REQUIRE(Hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+            Common::HexStringToArray<0x20>(
+                "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+}
+
+TEST_CASE("SHA256Hasher[Incremental]", "[core][crypto]") {
+    // One million 'a', fed in chunks of varying size that cross the block boundaries
+    const std::vector<u8> message(1000000, 'a');
+    SHA256Hasher hasher;
+    std::size_t offset = 0;
+    for (std::size_t chunk = 1; offset < message.size(); chunk = chunk * 3 % 97 + 1) {
+        const std::size_t size = std::min(chunk, message.size() - offset);
+        hasher.Update(message.data() + offset, size);
+        offset += size;
+    }
+    REQUIRE(hasher.Finish() ==
+            Common::HexStringToArray<0x20>(
+                "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+
+    // Finish starts over
+    REQUIRE(hasher.Finish() == Hash(""));
+}
+
+} // namespace Core::Crypto
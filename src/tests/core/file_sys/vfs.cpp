@@ -0,0 +1,65 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "core/file_sys/vfs.h"
+#include "core/file_sys/vfs_vector.h"
+#include "tests/test_support.h"
+
+namespace FileSys {
+
+using Tests::MakeData;
+
+TEST_CASE("VfsPipelinedCopy", "[core][file_sys]") {
+    const auto data = MakeData(0x10000 + 0x123);
+    const auto src = std::make_shared<VectorVfsFile>(data, "src");
+
+    for (const std::size_t block_size : {std::size_t{0x100}, std::size_t{0x1000}, data.size(),
+                                         data.size() * 2}) {
+        const auto dest = std::make_shared<VectorVfsFile>(std::vector<u8>{}, "dest");
+        std::vector<u8> blocks;
+        std::size_t last_written = 0;
+        const bool copied = VfsPipelinedCopy(
+            src, dest, block_size,
+            [&blocks](const u8* block, std::size_t size) {
+                blocks.insert(blocks.end(), block, block + size);
+            },
+            [&last_written](std::size_t written) {
+                REQUIRE(written > last_written);
+                last_written = written;
+                return true;
+            });
+
+        REQUIRE(copied);
+        REQUIRE(dest->ReadAllBytes() == data);
+        REQUIRE(blocks == data);
+        REQUIRE(last_written == data.size());
+    }
+}
+
+TEST_CASE("VfsPipelinedCopy[Cancel]", "[core][file_sys]") {
+    const auto data = MakeData(0x10000);
+    const auto src = std::make_shared<VectorVfsFile>(data, "src");
+    const auto dest = std::make_shared<VectorVfsFile>(std::vector<u8>{}, "dest");
+
+    std::size_t num_progress = 0;
+    const bool copied =
+        VfsPipelinedCopy(src, dest, 0x100, {}, [&num_progress](std::size_t written) {
+            ++num_progress;
+            return written < 0x1000;
+        });
+
+    REQUIRE(!copied);
+    REQUIRE(num_progress == 0x10);
+
+    const auto empty = std::make_shared<VectorVfsFile>(std::vector<u8>{}, "empty");
+    REQUIRE(VfsPipelinedCopy(empty, dest, 0x100));
+    REQUIRE(dest->GetSize() == 0);
+}
+
+} // namespace FileSys
@@ -0,0 +1,128 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "core/file_sys/vfs_cached.h"
+#include "core/file_sys/vfs_vector.h"
+#include "tests/test_support.h"
+
+namespace FileSys {
+
+using Tests::MakeData;
+
+namespace {
+
+constexpr std::size_t BLOCK_SIZE = CachedVfsFile::BLOCK_SIZE;
+
+/// Counts the reads that reach the wrapped file.
+class CountingVfsFile : public VectorVfsFile {
+public:
+    using VectorVfsFile::VectorVfsFile;
+
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override {
+        ++reads;
+        return VectorVfsFile::Read(data, length, offset);
+    }
+
+    mutable std::size_t reads = 0;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("CachedVfsFile[ReadsMatch]", "[core][file_sys]") {
+    // Not a multiple of the block size, so the last block is short
+    const std::vector<u8> data = MakeData(BLOCK_SIZE * 3 + 0x123);
+    const auto base = std::make_shared<CountingVfsFile>(data);
+    const CachedVfsFile cached(base);
+
+    REQUIRE(cached.GetSize() == data.size());
+    for (const std::size_t offset : {std::size_t{0}, std::size_t{0x10}, BLOCK_SIZE - 3,
+                                     BLOCK_SIZE * 3 + 0x100, data.size() - 1}) {
+        std::vector<u8> out(0x200);
+        const std::size_t read = cached.Read(out.data(), out.size(), offset);
+        REQUIRE(read == std::min(out.size(), data.size() - offset));
+        REQUIRE(std::equal(out.begin(), out.begin() + read, data.begin() + offset));
+    }
+    REQUIRE(cached.Read(nullptr, 0x10, data.size()) == 0);
+}
+
+TEST_CASE("CachedVfsFile[Hits]", "[core][file_sys]") {
+    const std::vector<u8> data = MakeData(BLOCK_SIZE * 4);
+    const auto base = std::make_shared<CountingVfsFile>(data);
+    const CachedVfsFile cached(base, 2);
+
+    std::vector<u8> out(0x100);
+    cached.Read(out.data(), out.size(), 0);
+    cached.Read(out.data(), out.size(), 0x800);
+    REQUIRE(base->reads == 1);
+    REQUIRE(cached.GetHits() == 1);
+    REQUIRE(cached.GetMisses() == 1);
+
+    // Straddles blocks 0 and 1
+    cached.Read(out.data(), out.size(), BLOCK_SIZE - 0x80);
+    REQUIRE(base->reads == 2);
+    REQUIRE(std::equal(out.begin(), out.end(), data.begin() + BLOCK_SIZE - 0x80));
+
+    // Block 2 evicts the least recently used block, which is block 0
+    cached.Read(out.data(), out.size(), BLOCK_SIZE * 2);
+    cached.Read(out.data(), out.size(), BLOCK_SIZE);
+    REQUIRE(base->reads == 3);
+    cached.Read(out.data(), out.size(), 0);
+    REQUIRE(base->reads == 4);
+    REQUIRE(std::equal(out.begin(), out.end(), data.begin()));
+}
+
+TEST_CASE("CachedVfsFile[LargeReads]", "[core][file_sys]") {
+    const std::vector<u8> data = MakeData(BLOCK_SIZE * 8);
+    const auto base = std::make_shared<CountingVfsFile>(data);
+    const CachedVfsFile cached(base);
+
+    // Large reads go straight to the wrapped file and are not cached
+    std::vector<u8> out(data.size());
+    REQUIRE(cached.Read(out.data(), out.size(), 0) == data.size());
+    REQUIRE(out == data);
+    REQUIRE(base->reads == 1);
+    cached.Read(out.data(), 0x10, 0);
+    REQUIRE(base->reads == 2);
+
+    // Except for the blocks that are already cached, block 0 splits the read in two runs
+    std::fill(out.begin(), out.end(), u8{0});
+    REQUIRE(cached.Read(out.data(), out.size() - 0x10, 0x10) == data.size() - 0x10);
+    REQUIRE(std::equal(data.begin() + 0x10, data.end(), out.begin()));
+    REQUIRE(base->reads == 3);
+}
+
+TEST_CASE("CachedVfsFile[Prefetch]", "[core][file_sys]") {
+    const std::vector<u8> data = MakeData(BLOCK_SIZE * 8 + 0x40);
+    const auto base = std::make_shared<CountingVfsFile>(data);
+    const CachedVfsFile cached(base, 8);
+
+    // Limited to half of the cache
+    cached.Prefetch(BLOCK_SIZE, data.size());
+    REQUIRE(base->reads == 4);
+    REQUIRE(cached.GetPrefetches() == 4);
+
+    std::vector<u8> out(BLOCK_SIZE * 4);
+    REQUIRE(cached.Read(out.data(), out.size(), BLOCK_SIZE) == out.size());
+    REQUIRE(std::equal(out.begin(), out.end(), data.begin() + BLOCK_SIZE));
+    REQUIRE(base->reads == 4);
+    REQUIRE(cached.GetHits() == 4);
+    REQUIRE(cached.GetMisses() == 0);
+
+    // The short last block
+    cached.Prefetch(BLOCK_SIZE * 8, 0x1000);
+    REQUIRE(cached.Read(out.data(), 0x100, BLOCK_SIZE * 8) == 0x40);
+    REQUIRE(std::equal(out.begin(), out.begin() + 0x40, data.begin() + BLOCK_SIZE * 8));
+    REQUIRE(base->reads == 5);
+    cached.Prefetch(data.size(), 0x10);
+    REQUIRE(base->reads == 5);
+}
+
+} // namespace FileSys
@@ -0,0 +1,101 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "core/file_sys/mode.h"
+#include "core/file_sys/vfs_real.h"
+#include "tests/test_support.h"
+
+namespace FileSys {
+
+using Tests::TestDirectory;
+
+namespace {
+
+bool HasEntry(const VfsDirectoryListing& listing, const std::string& name, VfsEntryType type,
+              u64 size) {
+    for (const auto& entry : *listing) {
+        if (entry.name == name) {
+            return entry.type == type && entry.size == size;
+        }
+    }
+    return false;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("RealVfsDirectory[Listing]", "[core][file_sys]") {
+    TestDirectory test{"vfs_real_test"};
+    REQUIRE(test.dir->CreateSubdirectory("sub") != nullptr);
+    const auto file = test.dir->CreateFile("save.bin");
+    REQUIRE(file != nullptr);
+    REQUIRE(file->WriteBytes(std::vector<u8>(0x10)) == 0x10);
+
+    const auto listing = test.dir->GetListing();
+    REQUIRE(listing->size() == 2);
+    // Files come first, as with GetFiles and GetSubdirectories
+    REQUIRE(listing->front().name == "save.bin");
+    REQUIRE(HasEntry(listing, "save.bin", VfsEntryType::File, 0x10));
+    REQUIRE(HasEntry(listing, "sub", VfsEntryType::Directory, 0));
+
+    // Unchanged directories share their listing, also when opened again
+    REQUIRE(test.dir->GetListing() == listing);
+    REQUIRE(test.filesystem.OpenDirectory(test.path, Mode::Read)->GetListing() == listing);
+    REQUIRE(test.dir->GetFiles().size() == 1);
+    REQUIRE(test.dir->GetSubdirectories().size() == 1);
+}
+
+TEST_CASE("RealVfsDirectory[ListingInvalidation]", "[core][file_sys]") {
+    TestDirectory test{"vfs_real_test"};
+    const auto file = test.dir->CreateFile("a.bin");
+    REQUIRE(file != nullptr);
+    REQUIRE(test.dir->GetListing()->size() == 1);
+
+    // Writes that grow a file change its size in the listing
+    REQUIRE(file->WriteBytes(std::vector<u8>(0x20)) == 0x20);
+    REQUIRE(HasEntry(test.dir->GetListing(), "a.bin", VfsEntryType::File, 0x20));
+
+    REQUIRE(file->Rename("b.bin"));
+    const auto renamed = test.dir->GetListing();
+    REQUIRE(renamed->size() == 1);
+    REQUIRE(HasEntry(renamed, "b.bin", VfsEntryType::File, 0x20));
+
+    REQUIRE(test.dir->DeleteFile("b.bin"));
+    REQUIRE(test.dir->GetListing()->empty());
+
+    // Deleting a directory drops its own listing too
+    const auto sub = test.dir->CreateSubdirectory("sub");
+    REQUIRE(sub != nullptr);
+    REQUIRE(sub->CreateFile("c.bin") != nullptr);
+    REQUIRE(sub->GetListing()->size() == 1);
+    REQUIRE(test.dir->DeleteSubdirectory("sub"));
+    REQUIRE(test.dir->GetListing()->empty());
+    REQUIRE(test.filesystem.OpenDirectory(test.path + "/sub", Mode::Read)->GetListing()->empty());
+}
+
+TEST_CASE("RealVfsDirectory[Replace]", "[core][file_sys]") {
+    TestDirectory test{"vfs_real_test"};
+    test.MakeFile("new.bin", {1, 2});
+    const auto old_file = test.MakeFile("old.bin", {3, 4, 5});
+    REQUIRE(test.dir->GetListing()->size() == 2);
+
+    // Replaces the file even while it's open
+    REQUIRE(test.dir->Replace("new.bin", "old.bin"));
+    REQUIRE(test.ReadHost("old.bin") == std::vector<u8>{1, 2});
+    REQUIRE(test.dir->GetFile("new.bin") == nullptr);
+    REQUIRE(test.dir->GetListing()->size() == 1);
+    REQUIRE(HasEntry(test.dir->GetListing(), "old.bin", VfsEntryType::File, 2));
+
+    // Works as a rename without a file to replace, but not without a source
+    REQUIRE(test.dir->Replace("old.bin", "other.bin"));
+    REQUIRE(test.ReadHost("other.bin") == std::vector<u8>{1, 2});
+    REQUIRE(!test.dir->Replace("old.bin", "other.bin"));
+    REQUIRE(test.ReadHost("other.bin") == std::vector<u8>{1, 2});
+}
+
+} // namespace FileSys
@@ -0,0 +1,71 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "core/file_sys/vfs_layered.h"
+#include "core/file_sys/vfs_vector.h"
+
+namespace FileSys {
+
+namespace {
+
+VirtualFile MakeFile(std::string name, u8 value) {
+    return std::make_shared<VectorVfsFile>(std::vector<u8>{value}, std::move(name));
+}
+
+} // Anonymous namespace
+
+TEST_CASE("VectorVfsDirectory[Lookup]", "[core][file_sys]") {
+    const auto sub = std::make_shared<VectorVfsDirectory>(
+        std::vector<VirtualFile>{MakeFile("b.bin", 2)}, std::vector<VirtualDir>{}, "sub");
+    const auto root = std::make_shared<VectorVfsDirectory>(
+        std::vector<VirtualFile>{MakeFile("a.bin", 1)}, std::vector<VirtualDir>{sub}, "root");
+
+    REQUIRE(root->GetFile("a.bin")->ReadByte() == 1);
+    REQUIRE(root->GetFile("b.bin") == nullptr);
+    REQUIRE(root->GetSubdirectory("sub") == sub);
+    REQUIRE(root->GetSubdirectory("a.bin") == nullptr);
+    REQUIRE(root->GetFileRelative("/sub/b.bin")->ReadByte() == 2);
+    REQUIRE(root->GetFileRelative("sub/c.bin") == nullptr);
+    REQUIRE(root->GetDirectoryRelative("sub") == sub);
+
+    // The first entry with a name is found, deleting it uncovers the next one
+    root->AddFile(MakeFile("c.bin", 3));
+    root->AddFile(MakeFile("c.bin", 4));
+    REQUIRE(root->GetFile("c.bin")->ReadByte() == 3);
+    REQUIRE(root->DeleteFile("a.bin"));
+    REQUIRE(root->GetFile("a.bin") == nullptr);
+    REQUIRE(root->GetFile("c.bin")->ReadByte() == 3);
+    REQUIRE(root->DeleteFile("c.bin"));
+    REQUIRE(root->GetFile("c.bin")->ReadByte() == 4);
+    REQUIRE(root->GetFiles().size() == 1);
+
+    REQUIRE(root->DeleteSubdirectory("sub"));
+    REQUIRE(root->GetSubdirectory("sub") == nullptr);
+    REQUIRE(!root->DeleteSubdirectory("sub"));
+}
+
+TEST_CASE("LayeredVfsDirectory[Files]", "[core][file_sys]") {
+    const auto upper = std::make_shared<VectorVfsDirectory>(
+        std::vector<VirtualFile>{MakeFile("a.bin", 1)}, std::vector<VirtualDir>{}, "data");
+    const auto lower = std::make_shared<VectorVfsDirectory>(
+        std::vector<VirtualFile>{MakeFile("b.bin", 2), MakeFile("a.bin", 3)},
+        std::vector<VirtualDir>{}, "data");
+    const auto layered = LayeredVfsDirectory::MakeLayeredDirectory({upper, lower});
+
+    const auto files = layered->GetFiles();
+    REQUIRE(files.size() == 2);
+    REQUIRE(files[0]->GetName() == "a.bin");
+    REQUIRE(files[0]->ReadByte() == 1);
+    REQUIRE(files[1]->GetName() == "b.bin");
+    REQUIRE(layered->GetFile("a.bin")->ReadByte() == 1);
+    REQUIRE(layered->GetFile("b.bin")->ReadByte() == 2);
+}
+
+} // namespace FileSys
@@ -0,0 +1,142 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "core/file_sys/vfs_vector.h"
+#include "core/file_sys/vfs_write_back.h"
+#include "tests/test_support.h"
+
+namespace FileSys {
+
+using Tests::TestDirectory;
+
+namespace {
+
+bool IsDirty(const VirtualFile& file) {
+    return std::static_pointer_cast<WriteBackVfsFile>(file)->IsDirty();
+}
+
+/// A writable directory in memory whose replace can be made to fail after removing the original,
+/// as it would when a host without an atomic replace fails halfway.
+class FlakyDirectory : public VectorVfsDirectory {
+public:
+    std::shared_ptr<VfsFile> CreateFile(std::string_view name) override {
+        auto file = std::make_shared<VectorVfsFile>(std::vector<u8>{}, std::string(name),
+                                                    self.lock());
+        AddFile(file);
+        return file;
+    }
+
+    bool Replace(std::string_view src, std::string_view dest) override {
+        const auto file = GetFile(src);
+        if (file == nullptr) {
+            return false;
+        }
+        DeleteFile(dest);
+        if (fail_next_replace) {
+            fail_next_replace = false;
+            return false;
+        }
+        DeleteFile(src);
+        file->Rename(dest);
+        AddFile(file);
+        return true;
+    }
+
+    std::weak_ptr<FlakyDirectory> self;
+    bool fail_next_replace = false;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("WriteBackCache[Commit]", "[core][file_sys]") {
+    TestDirectory test{"vfs_write_back_test"};
+    const auto cache = std::make_shared<WriteBackCache>();
+    const auto file = cache->Wrap(test.MakeFile("save.bin", {1, 2, 3, 4}));
+
+    // Opening the file again shares the pending writes
+    REQUIRE(cache->Wrap(test.dir->GetFile("save.bin")) == file);
+
+    REQUIRE(file->WriteBytes({9, 8}, 1) == 2);
+    REQUIRE(IsDirty(file));
+    REQUIRE(file->WriteBytes({7, 6}, 4) == 2);
+    REQUIRE(file->ReadAllBytes() == std::vector<u8>{1, 9, 8, 4, 7, 6});
+    REQUIRE(test.ReadHost("save.bin") == std::vector<u8>{1, 2, 3, 4});
+    REQUIRE(cache->GetDirtySize() == 6);
+
+    REQUIRE(cache->Commit());
+    REQUIRE(cache->GetDirtySize() == 0);
+    REQUIRE(test.ReadHost("save.bin") == std::vector<u8>{1, 9, 8, 4, 7, 6});
+    REQUIRE(test.dir->GetFiles().size() == 1);
+
+    // The file keeps working after it has been replaced by the commit
+    REQUIRE(file->Resize(2));
+    REQUIRE(file->ReadAllBytes() == std::vector<u8>{1, 9});
+    REQUIRE(cache->Commit());
+    REQUIRE(test.ReadHost("save.bin") == std::vector<u8>{1, 9});
+}
+
+TEST_CASE("WriteBackCache[Limits]", "[core][file_sys]") {
+    TestDirectory test{"vfs_write_back_test"};
+    auto cache = std::make_shared<WriteBackCache>(8);
+
+    // Files over the limit are written through
+    const auto large = cache->Wrap(test.MakeFile("large.bin", std::vector<u8>(16)));
+    REQUIRE(large->WriteBytes({1}, 0) == 1);
+    REQUIRE(!IsDirty(large));
+    REQUIRE(cache->GetDirtySize() == 0);
+
+    // Going over the limit commits everything early
+    const auto first = cache->Wrap(test.MakeFile("first.bin", {0, 0, 0, 0}));
+    const auto second = cache->Wrap(test.MakeFile("second.bin", {0, 0, 0, 0}));
+    REQUIRE(first->WriteBytes({1}, 0) == 1);
+    REQUIRE(second->WriteBytes({2}, 0) == 1);
+    REQUIRE(cache->GetDirtySize() == 8);
+    REQUIRE(test.ReadHost("first.bin")[0] == 0);
+    REQUIRE(second->WriteBytes({2}, 4) == 1);
+    REQUIRE(cache->GetDirtySize() == 0);
+    REQUIRE(test.ReadHost("first.bin")[0] == 1);
+    REQUIRE(test.ReadHost("second.bin") == std::vector<u8>{2, 0, 0, 0, 2});
+
+    // Pending writes are committed when the cache goes away, later ones are written through
+    REQUIRE(first->WriteBytes({3}, 1) == 1);
+    cache.reset();
+    REQUIRE(test.ReadHost("first.bin") == std::vector<u8>{1, 3, 0, 0});
+    REQUIRE(first->WriteBytes({4}, 2) == 1);
+    REQUIRE(!IsDirty(first));
+    REQUIRE(first->ReadAllBytes() == std::vector<u8>{1, 3, 4, 0});
+}
+
+TEST_CASE("WriteBackCache[FailedReplace]", "[core][file_sys]") {
+    const auto dir = std::make_shared<FlakyDirectory>();
+    dir->self = dir;
+    const auto original = dir->CreateFile("save.bin");
+    REQUIRE(original->WriteBytes(std::vector<u8>{1, 2}) == 2);
+    const auto cache = std::make_shared<WriteBackCache>();
+    const auto file = cache->Wrap(original);
+    REQUIRE(file->WriteBytes({3}, 2) == 1);
+
+    // The original is gone after the failed replace, the next commit still has to finish it
+    dir->fail_next_replace = true;
+    REQUIRE(!cache->Commit());
+    REQUIRE(dir->GetFile("save.bin") == nullptr);
+    REQUIRE(IsDirty(file));
+    REQUIRE(file->ReadAllBytes() == std::vector<u8>{1, 2, 3});
+
+    REQUIRE(cache->Commit());
+    REQUIRE(!IsDirty(file));
+    REQUIRE(dir->GetFiles().size() == 1);
+    REQUIRE(dir->GetFile("save.bin")->ReadAllBytes() == std::vector<u8>{1, 2, 3});
+
+    // The files refer to their directory
+    REQUIRE(dir->DeleteFile("save.bin"));
+}
+
+} // namespace FileSys
@@ -0,0 +1,76 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/file_util.h"
+#include "core/hle/service/hid/input_recording.h"
+
+namespace Service::HID {
+
+TEST_CASE("InputRecording[Replay]", "[core]") {
+    const std::string path = "input_recording_test.bin";
+    const RecordedPadState pressed{0x1, 100, -100, 0, 0};
+    const RecordedPadState moved{0x3, 0, 0, 32767, -32767};
+    const RecordedPadState other{0x8, 0, 0, 0, 0};
+
+    // Update, npad and state read from the input devices
+    struct Input {
+        u64 update;
+        std::size_t npad_index;
+        RecordedPadState state;
+    };
+    const std::vector<Input> inputs{
+        {1, 0, {}},      {2, 0, pressed}, {2, 1, other}, {3, 0, pressed},
+        {4, 0, moved},   {5, 0, {}},      {5, 1, other}, {6, 1, {}},
+    };
+    constexpr u64 NUM_UPDATES = 7;
+
+    {
+        auto recording = InputRecording::Open(path, InputRecording::Mode::Record);
+        REQUIRE(recording != nullptr);
+        std::size_t next = 0;
+        for (u64 update = 1; update <= NUM_UPDATES; ++update) {
+            recording->BeginUpdate();
+            for (; next < inputs.size() && inputs[next].update == update; ++next) {
+                RecordedPadState state = inputs[next].state;
+                recording->Process(inputs[next].npad_index, state);
+                // Recording leaves the input as it was read
+                REQUIRE(state == inputs[next].state);
+            }
+        }
+    }
+
+    auto replay = InputRecording::Open(path, InputRecording::Mode::Replay);
+    REQUIRE(replay != nullptr);
+
+    std::array<RecordedPadState, 2> expected{};
+    std::size_t next = 0;
+    for (u64 update = 1; update <= NUM_UPDATES; ++update) {
+        replay->BeginUpdate();
+        for (; next < inputs.size() && inputs[next].update == update; ++next) {
+            expected[inputs[next].npad_index] = inputs[next].state;
+        }
+        for (std::size_t npad = 0; npad < expected.size(); ++npad) {
+            // The devices read nothing, the replay provides the recorded state
+            RecordedPadState state{0xFF, 1, 1, 1, 1};
+            replay->Process(npad, state);
+            REQUIRE(state == expected[npad]);
+        }
+    }
+
+    replay.reset();
+    FileUtil::Delete(path);
+
+    // Files that are not recordings are rejected
+    FileUtil::WriteStringToFile(false, path, "not a recording");
+    REQUIRE(InputRecording::Open(path, InputRecording::Mode::Replay) == nullptr);
+    FileUtil::Delete(path);
+}
+
+} // namespace Service::HID
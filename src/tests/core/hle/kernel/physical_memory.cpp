@@ -0,0 +1,53 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdint>
+#include <catch2/catch.hpp>
+#include "core/hle/kernel/physical_memory.h"
+
+namespace Kernel {
+
+namespace {
+
+bool IsZero(const u8* begin, const u8* end) {
+    return std::all_of(begin, end, [](u8 value) { return value == 0; });
+}
+
+} // Anonymous namespace
+
+TEST_CASE("PhysicalMemory: Blocks are zeroed", "[core]") {
+    for (const std::size_t size : {std::size_t{0x10}, HostMemory::HUGE_PAGE_SIZE * 3 + 0x1000}) {
+        PhysicalMemory memory(size);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(memory.data()) % HostMemory::PAGE_ALIGNMENT ==
+                0);
+        REQUIRE(IsZero(memory.data(), memory.data() + memory.size()));
+    }
+
+    // Blocks grown within their capacity are zeroed too
+    PhysicalMemory memory;
+    memory.reserve(HostMemory::HUGE_PAGE_SIZE * 4);
+    memory.resize(HostMemory::HUGE_PAGE_SIZE);
+    const u8* const data = memory.data();
+    memory.resize(HostMemory::HUGE_PAGE_SIZE * 4);
+    REQUIRE(memory.data() == data);
+    REQUIRE(IsZero(memory.data(), memory.data() + memory.size()));
+}
+
+TEST_CASE("PhysicalMemory: Discarded pages read as zero", "[core]") {
+    constexpr std::size_t size = HostMemory::HUGE_PAGE_SIZE * 2;
+    PhysicalMemory memory(size);
+    std::fill(memory.begin(), memory.end(), u8{0xAB});
+
+    HostMemory::Discard(memory.data() + HostMemory::HUGE_PAGE_SIZE, HostMemory::HUGE_PAGE_SIZE);
+    REQUIRE(std::all_of(memory.begin(), memory.begin() + HostMemory::HUGE_PAGE_SIZE,
+                        [](u8 value) { return value == 0xAB; }));
+    REQUIRE(IsZero(memory.data() + HostMemory::HUGE_PAGE_SIZE, memory.data() + size));
+
+    // The discarded pages stay usable
+    memory[size - 1] = 1;
+    REQUIRE(memory[size - 1] == 1);
+}
+
+} // namespace Kernel
@@ -0,0 +1,62 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <catch2/catch.hpp>
+#include "core/hle/service/time/time_sharedmemory.h"
+
+namespace Service::Time {
+
+namespace {
+
+using Barrier = SharedMemory::MemoryBarrier<SystemClockContext, 0x38>;
+
+u32 GuestReadAttempt(const u8* shared_memory) {
+    u32 read_attempt;
+    std::memcpy(&read_attempt, shared_memory + 0x38 + offsetof(Barrier, read_attempt),
+                sizeof(read_attempt));
+    return read_attempt;
+}
+
+/// Reads the slot a counter value selects, as the guest does
+SystemClockContext GuestRead(const u8* shared_memory, u32 read_attempt) {
+    SystemClockContext context;
+    std::memcpy(&context,
+                shared_memory + 0x38 + offsetof(Barrier, data) +
+                    (read_attempt & 1) * sizeof(SystemClockContext),
+                sizeof(context));
+    return context;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Time::SharedMemory: The guest reads the last stored value", "[core]") {
+    std::array<u8, 0x1000> shared_memory{};
+    Barrier barrier;
+
+    for (u64 offset = 1; offset <= 3; ++offset) {
+        const u32 previous_attempt = barrier.read_attempt;
+        barrier.StoreData(shared_memory.data(), SystemClockContext{offset, {}});
+
+        REQUIRE(barrier.read_attempt == previous_attempt + 1);
+        const u32 read_attempt = GuestReadAttempt(shared_memory.data());
+        REQUIRE(read_attempt == barrier.read_attempt);
+        REQUIRE(GuestRead(shared_memory.data(), read_attempt).offset == offset);
+        REQUIRE(barrier.ReadData(shared_memory.data()).offset == offset);
+    }
+}
+
+TEST_CASE("Time::SharedMemory: Stores leave the slot being read alone", "[core]") {
+    std::array<u8, 0x1000> shared_memory{};
+    Barrier barrier;
+    barrier.StoreData(shared_memory.data(), SystemClockContext{1, {}});
+
+    // A guest that read the counter before the store still finds the previous value in its slot
+    const u32 read_attempt = GuestReadAttempt(shared_memory.data());
+    barrier.StoreData(shared_memory.data(), SystemClockContext{2, {}});
+    REQUIRE(GuestRead(shared_memory.data(), read_attempt).offset == 1);
+}
+
+} // namespace Service::Time
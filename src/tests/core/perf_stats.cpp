@@ -0,0 +1,93 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <optional>
+
+#include <catch2/catch.hpp>
+
+#include "core/perf_stats.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+using Core::PerfCategory;
+using Core::PerfStats;
+
+} // Anonymous namespace
+
+TEST_CASE("PerfStats[FrameBreakdown]", "[core]") {
+    PerfStats perf_stats{0};
+
+    std::optional<Core::FrameBreakdown> reported;
+    perf_stats.SetBreakdownCallback(
+        [&reported](const Core::FrameBreakdown& breakdown) { reported = breakdown; });
+
+    // Frame i spends i ms in supervisor calls and 2 ms mixing audio
+    for (int i = 1; i <= 100; ++i) {
+        perf_stats.BeginSystemFrame();
+        perf_stats.AddTime(PerfCategory::Svc, std::chrono::milliseconds{i});
+        perf_stats.AddTime(PerfCategory::AudioMix, 1ms);
+        perf_stats.AddTime(PerfCategory::AudioMix, 1ms);
+        perf_stats.EndSystemFrame();
+    }
+
+    REQUIRE(reported.has_value());
+    REQUIRE(reported->frame == PerfStats::BreakdownInterval);
+    REQUIRE(reported->window_frames == PerfStats::BreakdownInterval);
+
+    const auto breakdown = perf_stats.GetFrameBreakdown();
+    REQUIRE(breakdown.frame == 100);
+    REQUIRE(breakdown.window_frames == 100);
+
+    const auto& svc = breakdown.categories[static_cast<std::size_t>(PerfCategory::Svc)];
+    REQUIRE(svc.p50 == Approx(0.050));
+    REQUIRE(svc.p95 == Approx(0.095));
+    REQUIRE(svc.p99 == Approx(0.099));
+
+    const auto& audio = breakdown.categories[static_cast<std::size_t>(PerfCategory::AudioMix)];
+    REQUIRE(audio.p50 == Approx(0.002));
+    REQUIRE(audio.p99 == Approx(0.002));
+
+    const auto& gpu = breakdown.categories[static_cast<std::size_t>(PerfCategory::GpuBusy)];
+    REQUIRE(gpu.p99 == 0.0);
+
+    // The time of a category is reset with each frame
+    perf_stats.BeginSystemFrame();
+    perf_stats.EndSystemFrame();
+    REQUIRE(perf_stats.GetFrameBreakdown().window_frames == 101);
+}
+
+TEST_CASE("PerfStats[RollingWindow]", "[core]") {
+    PerfStats perf_stats{0};
+
+    for (std::size_t i = 0; i < PerfStats::BreakdownWindow; ++i) {
+        perf_stats.BeginSystemFrame();
+        perf_stats.AddTime(PerfCategory::ShaderCompile, 10ms);
+        perf_stats.EndSystemFrame();
+    }
+    // Only the most recent frames are kept
+    for (std::size_t i = 0; i < PerfStats::BreakdownWindow; ++i) {
+        perf_stats.BeginSystemFrame();
+        perf_stats.EndSystemFrame();
+    }
+
+    const auto breakdown = perf_stats.GetFrameBreakdown();
+    REQUIRE(breakdown.window_frames == PerfStats::BreakdownWindow);
+    const auto& shader =
+        breakdown.categories[static_cast<std::size_t>(PerfCategory::ShaderCompile)];
+    REQUIRE(shader.p99 == 0.0);
+}
+
+TEST_CASE("PerfStats[FrameLimiterOvershoot]", "[core]") {
+    PerfStats perf_stats{0};
+
+    perf_stats.AddFrameLimiterOvershoot(100us);
+    perf_stats.AddFrameLimiterOvershoot(300us);
+    REQUIRE(perf_stats.GetAndResetStats(0us).frame_limiter_overshoot == Approx(0.0002));
+
+    // The mean is reset with the other counters
+    REQUIRE(perf_stats.GetAndResetStats(0us).frame_limiter_overshoot == 0.0);
+}
@@ -0,0 +1,96 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/file_util.h"
+#include "core/tools/ipc_trace.h"
+
+namespace {
+
+using Tools::IpcTrace;
+
+IpcTrace::Request MakeRequest(std::string interface_name, u32 command, u32 seed) {
+    IpcTrace::Request request{};
+    request.interface_name = std::move(interface_name);
+    request.command = command;
+    request.is_domain = seed % 2 != 0;
+    request.time = std::chrono::microseconds{seed * 10};
+    request.command_buffer = {0x4, 0xA, seed, seed + 1, command};
+    request.buffers.push_back({IpcTrace::BufferType::A, 0x1000 + seed, 5, {1, 2, 3, 4, 5}});
+    request.buffers.push_back({IpcTrace::BufferType::B, 0x8000, 0x100, {}});
+    request.buffers.push_back({IpcTrace::BufferType::X, 0x2000, 0, {}});
+    request.buffers.push_back({IpcTrace::BufferType::C, 0x9000, 0x20, {}});
+    return request;
+}
+
+void RequireEqual(const IpcTrace::Request& lhs, const IpcTrace::Request& rhs) {
+    REQUIRE(lhs.interface_name == rhs.interface_name);
+    REQUIRE(lhs.command == rhs.command);
+    REQUIRE(lhs.is_domain == rhs.is_domain);
+    REQUIRE(lhs.time == rhs.time);
+    REQUIRE(lhs.command_buffer == rhs.command_buffer);
+    REQUIRE(lhs.buffers.size() == rhs.buffers.size());
+    for (std::size_t i = 0; i < lhs.buffers.size(); ++i) {
+        REQUIRE(lhs.buffers[i].type == rhs.buffers[i].type);
+        REQUIRE(lhs.buffers[i].address == rhs.buffers[i].address);
+        REQUIRE(lhs.buffers[i].size == rhs.buffers[i].size);
+        REQUIRE(lhs.buffers[i].data == rhs.buffers[i].data);
+    }
+}
+
+} // Anonymous namespace
+
+TEST_CASE("IpcTrace[RoundTrip]", "[core]") {
+    const std::string path = "ipc_trace_test.ipctrace";
+    const std::vector<IpcTrace::Request> requests{
+        MakeRequest("fsp-srv", 18, 1),
+        MakeRequest("IFile", 0, 2),
+        MakeRequest("fsp-srv", 200, 3),
+        MakeRequest("IFile", 1, 4),
+    };
+
+    {
+        auto trace = IpcTrace::Create(path);
+        REQUIRE(trace != nullptr);
+        for (const auto& request : requests) {
+            trace->Record(request);
+        }
+        REQUIRE(trace->GetNumRequests() == requests.size());
+    }
+
+    const auto read = IpcTrace::Read(path);
+    REQUIRE(read.has_value());
+    REQUIRE(read->size() == requests.size());
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        RequireEqual((*read)[i], requests[i]);
+    }
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("IpcTrace[RejectsInvalidFiles]", "[core]") {
+    const std::string path = "ipc_trace_test.ipctrace";
+    FileUtil::WriteStringToFile(false, path, "not a trace");
+    REQUIRE(!IpcTrace::Read(path).has_value());
+    FileUtil::Delete(path);
+
+    // A trace cut in the middle of a request keeps the requests before it
+    {
+        auto trace = IpcTrace::Create(path);
+        REQUIRE(trace != nullptr);
+        trace->Record(MakeRequest("nvdrv", 1, 1));
+        trace->Record(MakeRequest("nvdrv", 1, 2));
+    }
+    std::string contents;
+    FileUtil::ReadFileToString(false, path, contents);
+    FileUtil::WriteStringToFile(false, path, contents.substr(0, contents.size() - 4));
+    const auto read = IpcTrace::Read(path);
+    REQUIRE(read.has_value());
+    REQUIRE(read->size() == 1);
+    FileUtil::Delete(path);
+}
@@ -0,0 +1,80 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "core/tools/memory_snapshot.h"
+
+namespace {
+
+using Tools::MemorySnapshotter;
+
+constexpr std::size_t PAGE_SIZE = MemorySnapshotter::PAGE_SIZE;
+constexpr std::size_t NUM_PAGES = 0x200;
+
+std::vector<u8> MakeMemory() {
+    std::vector<u8> memory(NUM_PAGES * PAGE_SIZE);
+    for (std::size_t i = 0; i < memory.size(); ++i) {
+        memory[i] = static_cast<u8>(i * 7 + i / PAGE_SIZE);
+    }
+    return memory;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("MemorySnapshotter[CapturesChangedPages]", "[core]") {
+    std::vector<u8> memory = MakeMemory();
+    const std::vector<MemorySnapshotter::Region> regions{
+        {0x10000000, memory.data(), memory.size()}};
+
+    MemorySnapshotter snapshotter;
+    REQUIRE(snapshotter.Capture(regions) == 0);
+    REQUIRE(snapshotter.GetSnapshotSize(0) != 0);
+
+    // Nothing changed
+    REQUIRE(snapshotter.Capture(regions) == 1);
+    REQUIRE(snapshotter.GetSnapshotSize(1) == 0);
+
+    memory[3 * PAGE_SIZE + 5] ^= 0xFF;
+    REQUIRE(snapshotter.Capture(regions) == 2);
+    REQUIRE(snapshotter.GetSnapshotSize(2) != 0);
+    REQUIRE(snapshotter.GetSnapshotSize(2) < snapshotter.GetSnapshotSize(0));
+    REQUIRE(snapshotter.GetNumSnapshots() == 3);
+}
+
+TEST_CASE("MemorySnapshotter[RestoresSnapshots]", "[core]") {
+    std::vector<u8> memory = MakeMemory();
+    const std::vector<MemorySnapshotter::Region> regions{
+        {0x10000000, memory.data(), memory.size() / 2},
+        {0x20000000, memory.data() + memory.size() / 2, memory.size() / 2}};
+
+    MemorySnapshotter snapshotter;
+    const std::vector<u8> first = memory;
+    snapshotter.Capture(regions);
+
+    std::memset(memory.data() + 10 * PAGE_SIZE, 0xAA, 300 * PAGE_SIZE);
+    const std::vector<u8> second = memory;
+    snapshotter.Capture(regions);
+
+    std::memset(memory.data(), 0x55, memory.size());
+    snapshotter.Capture(regions);
+
+    REQUIRE(snapshotter.Restore(1, regions));
+    REQUIRE(memory == second);
+    REQUIRE(snapshotter.GetNumSnapshots() == 2);
+
+    REQUIRE(snapshotter.Restore(0, regions));
+    REQUIRE(memory == first);
+    REQUIRE(snapshotter.GetNumSnapshots() == 1);
+
+    // The restored contents are the base of the next snapshot
+    REQUIRE(snapshotter.Capture(regions) == 1);
+    REQUIRE(snapshotter.GetSnapshotSize(1) == 0);
+
+    REQUIRE_FALSE(snapshotter.Restore(2, regions));
+}
@@ -0,0 +1,71 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "core/core_timing.h"
+#include "core/tools/profiler.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+using Tools::Profiler;
+
+struct ScopeInit final {
+    ScopeInit() {
+        core_timing.Initialize();
+    }
+    ~ScopeInit() {
+        core_timing.Shutdown();
+    }
+
+    Core::Timing::CoreTiming core_timing;
+};
+
+std::vector<Profiler::Module> MakeModules() {
+    return {
+        {"sdk.elf", 0x9000000, 0x9100000, {{"memcpy", 0x100, 0x80}}},
+        {"main.elf", 0x8000000, 0x8100000, {{"main", 0x1000, 0x100}, {"Update", 0x2000, 0x200}}},
+    };
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Profiler[FoldsStacks]", "[core]") {
+    ScopeInit guard;
+    Profiler profiler{guard.core_timing};
+
+    // Leaf function called from Update, the caller is only in lr
+    profiler.AddSample({0x9000140, 0x8002010, 0x8001020}, {}, 3ms);
+    // Same functions at other addresses, merged into the same stack
+    profiler.AddSample({0x9000100, 0x8002080, 0x8001020}, {}, 2ms);
+    // lr points into the function itself after it made a call
+    profiler.AddSample({0x8002100, 0x80020F0, 0x8001020}, {}, 4ms);
+    // lr still holds the return address of the frame record
+    profiler.AddSample({0x8002100, 0x8001020, 0x8001020}, {}, 1ms);
+    // Outside of any symbol and any module
+    profiler.AddSample({0x8003000, 0x50000000}, {}, 500us);
+    REQUIRE(profiler.GetNumSamples() == 5);
+
+    REQUIRE(profiler.GetFoldedStacks(MakeModules()) ==
+            "0x0000000050000000;main.elf+0x3000 500\n"
+            "main.elf!main;main.elf!Update 5000\n"
+            "main.elf!main;main.elf!Update;sdk.elf!memcpy 5000\n");
+}
+
+TEST_CASE("Profiler[AttributesServiceTime]", "[core]") {
+    ScopeInit guard;
+    Profiler profiler{guard.core_timing};
+
+    profiler.AddSample({0x8002100, 0x80020F0, 0x8001020}, "nvdrv::Ioctl", 7ms);
+    profiler.AddSample({0x8002100, 0x80020F0, 0x8001020}, {}, 1ms);
+
+    REQUIRE(profiler.GetFoldedStacks(MakeModules()) ==
+            "main.elf!main;main.elf!Update 1000\n"
+            "main.elf!main;main.elf!Update;hle!nvdrv::Ioctl 7000\n");
+}
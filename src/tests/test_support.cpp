@@ -0,0 +1,49 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include "common/file_util.h"
+#include "core/file_sys/mode.h"
+#include "tests/test_support.h"
+
+namespace Tests {
+
+std::vector<u8> MakeData(std::size_t size) {
+    std::vector<u8> data(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<u8>(i * 7 + i / 251);
+    }
+    return data;
+}
+
+TestDirectory::TestDirectory(const std::string& name) {
+    const auto current = FileUtil::GetCurrentDir();
+    REQUIRE(current);
+    path = *current + "/" + name;
+    FileUtil::DeleteDirRecursively(path);
+    dir = filesystem.CreateDirectory(path, FileSys::Mode::ReadWrite);
+    REQUIRE(dir != nullptr);
+}
+
+TestDirectory::~TestDirectory() {
+    dir.reset();
+    FileUtil::DeleteDirRecursively(path);
+}
+
+FileSys::VirtualFile TestDirectory::MakeFile(const std::string& name,
+                                             const std::vector<u8>& data) {
+    const auto file = dir->CreateFile(name);
+    REQUIRE(file != nullptr);
+    REQUIRE(file->WriteBytes(data) == data.size());
+    return file;
+}
+
+std::vector<u8> TestDirectory::ReadHost(const std::string& name) {
+    const auto file = filesystem.OpenFile(path + "/" + name, FileSys::Mode::Read);
+    REQUIRE(file != nullptr);
+    return file->ReadAllBytes();
+}
+
+} // namespace Tests
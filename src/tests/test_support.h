@@ -0,0 +1,37 @@
+// Copyright 2019 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/file_sys/vfs_real.h"
+
+namespace Tests {
+
+/// Data of the given size whose pattern does not repeat every 256 bytes, so misplaced blocks and
+/// off-by-one offsets show up in comparisons.
+std::vector<u8> MakeData(std::size_t size);
+
+/// A directory on the host for the duration of a test, removed again afterwards.
+class TestDirectory {
+public:
+    /// Creates an empty directory of the given name in the current directory.
+    explicit TestDirectory(const std::string& name);
+    ~TestDirectory();
+
+    /// Creates a file in the directory holding the given data.
+    FileSys::VirtualFile MakeFile(const std::string& name, const std::vector<u8>& data);
+
+    /// Contents of a file as seen on the host, bypassing any cache.
+    std::vector<u8> ReadHost(const std::string& name);
+
+    FileSys::RealVfsFilesystem filesystem;
+    std::string path;
+    FileSys::VirtualDir dir;
+};
+
+} // namespace Tests
@@ -0,0 +1,114 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <map>
+#include <utility>
+
+#include <catch2/catch.hpp>
+
+#include "video_core/engines/const_buffer_engine_interface.h"
+#include "video_core/shader/const_buffer_locker.h"
+
+namespace VideoCommon::Shader {
+
+namespace {
+
+using Tegra::Engines::SamplerDescriptor;
+using Tegra::Engines::ShaderType;
+
+class FakeEngine final : public Tegra::Engines::ConstBufferEngineInterface {
+public:
+    u32 AccessConstBuffer32(ShaderType stage, u64 const_buffer, u64 offset) const override {
+        ++num_accesses;
+        const auto it = words.find({const_buffer, offset});
+        return it == words.end() ? 0 : it->second;
+    }
+
+    SamplerDescriptor AccessBoundSampler(ShaderType stage, u64 offset) const override {
+        return AccessBindlessSampler(stage, 0, offset);
+    }
+
+    SamplerDescriptor AccessBindlessSampler(ShaderType stage, u64 const_buffer,
+                                            u64 offset) const override {
+        SamplerDescriptor sampler;
+        sampler.raw = AccessConstBuffer32(stage, const_buffer, offset);
+        return sampler;
+    }
+
+    u32 GetBoundBuffer() const override {
+        return 0;
+    }
+
+    std::map<std::pair<u64, u64>, u32> words;
+    mutable int num_accesses = 0;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("ConstBufferLocker[ObtainsKeysOnce]", "[video_core]") {
+    FakeEngine engine;
+    engine.words[{1, 0x10}] = 0x1234;
+
+    ConstBufferLocker locker(ShaderType::Fragment, engine);
+    REQUIRE(locker.ObtainKey(1, 0x10) == 0x1234u);
+    REQUIRE(locker.ObtainKey(1, 0x10) == 0x1234u);
+    REQUIRE(engine.num_accesses == 1);
+    REQUIRE(locker.GetKeys().size() == 1);
+
+    // Without an engine only registered keys are known
+    ConstBufferLocker disk_locker(ShaderType::Fragment);
+    disk_locker.InsertKey(1, 0x10, 0x1234);
+    REQUIRE(disk_locker.ObtainKey(1, 0x10) == 0x1234u);
+    REQUIRE_FALSE(disk_locker.ObtainKey(1, 0x14));
+}
+
+TEST_CASE("ConstBufferLocker[IsConsistent]", "[video_core]") {
+    FakeEngine engine;
+    engine.words[{0, 0x8}] = 5;
+    engine.words[{2, 0x20}] = 7;
+
+    ConstBufferLocker locker(ShaderType::Vertex, engine);
+    locker.ObtainKey(2, 0x20);
+    locker.ObtainBindlessSampler(0, 0x8);
+    REQUIRE(locker.IsConsistent());
+
+    engine.words[{0, 0x8}] = 6;
+    REQUIRE_FALSE(locker.IsConsistent());
+    engine.words[{0, 0x8}] = 5;
+    REQUIRE(locker.IsConsistent());
+
+    engine.words[{2, 0x20}] = 8;
+    REQUIRE_FALSE(locker.IsConsistent());
+}
+
+TEST_CASE("ConstBufferLocker[HasEqualKeys]", "[video_core]") {
+    SamplerDescriptor sampler;
+    sampler.raw = 0x42;
+
+    ConstBufferLocker lhs(ShaderType::Fragment);
+    lhs.InsertKey(1, 0x10, 3);
+    lhs.InsertKey(0, 0x40, 4);
+    lhs.InsertBoundSampler(0x8, sampler);
+
+    // Keys inserted in a different order
+    ConstBufferLocker rhs(ShaderType::Fragment);
+    rhs.InsertBoundSampler(0x8, sampler);
+    rhs.InsertKey(0, 0x40, 4);
+    rhs.InsertKey(1, 0x10, 9);
+    REQUIRE_FALSE(rhs.HasEqualKeys(lhs));
+
+    rhs.InsertKey(1, 0x10, 3);
+    REQUIRE(rhs.HasEqualKeys(lhs));
+    REQUIRE(rhs.GetHash() == lhs.GetHash());
+
+    // The same entry in another database is a different key
+    ConstBufferLocker bindless(ShaderType::Fragment);
+    bindless.InsertBindlessSampler(1, 0x10, sampler);
+    ConstBufferLocker key(ShaderType::Fragment);
+    key.InsertKey(1, 0x10, 0x42);
+    REQUIRE(bindless.GetHash() != key.GetHash());
+    REQUIRE_FALSE(bindless.HasEqualKeys(key));
+}
+
+} // namespace VideoCommon::Shader
@@ -0,0 +1,44 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "video_core/surface.h"
+#include "video_core/textures/convert.h"
+
+namespace Tegra::Texture {
+
+using VideoCore::Surface::PixelFormat;
+
+TEST_CASE("Convert[S8Z24]", "[video_core]") {
+    // Widths that leave pixels after the vectorized loops
+    for (const u32 width : {1U, 3U, 4U, 7U, 8U, 9U, 37U, 64U}) {
+        constexpr u32 height = 5;
+        std::vector<u8> data(width * height * sizeof(u32));
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<u8>(i * 13 + 7);
+        }
+        const std::vector<u8> original = data;
+
+        ConvertFromGuestToHost(data.data(), nullptr, PixelFormat::S8Z24, width, height, 1, false,
+                               true);
+        for (std::size_t pixel = 0; pixel < width * height; ++pixel) {
+            u32 s8z24;
+            u32 z24s8;
+            std::memcpy(&s8z24, &original[pixel * sizeof(u32)], sizeof(u32));
+            std::memcpy(&z24s8, &data[pixel * sizeof(u32)], sizeof(u32));
+            REQUIRE((z24s8 & 0xFF) == s8z24 >> 24);
+            REQUIRE(z24s8 >> 8 == (s8z24 & 0xFFFFFF));
+        }
+
+        ConvertFromHostToGuest(data.data(), PixelFormat::S8Z24, width, height, 1, false, true);
+        REQUIRE(data == original);
+    }
+}
+
+} // namespace Tegra::Texture
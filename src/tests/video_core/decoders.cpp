@@ -0,0 +1,125 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "video_core/textures/decoders.h"
+
+namespace Tegra::Texture {
+
+namespace {
+
+constexpr std::array<u32, 5> bytes_per_pixel_classes{1, 2, 4, 8, 16};
+
+/// Reference block-linear address of a byte, computed without tables or fast paths.
+std::size_t SwizzledOffset(u32 x_byte, u32 y, u32 width_in_bytes, u32 block_height) {
+    const u32 width_in_gobs = (width_in_bytes + 63) / 64;
+    const u32 block_index = (y / (8 * block_height)) * width_in_gobs + x_byte / 64;
+    const u32 gob_in_block = (y % (8 * block_height)) / 8;
+    const u32 x = x_byte % 64;
+    const u32 gob_offset =
+        ((x % 64) / 32) * 256 + ((y % 8) / 2) * 64 + ((x % 32) / 16) * 32 + (y % 2) * 16 + x % 16;
+    return block_index * 512 * block_height + gob_in_block * 512 + gob_offset;
+}
+
+std::vector<u8> RandomBytes(std::size_t size) {
+    std::mt19937 generator(size);
+    std::uniform_int_distribution<u32> distribution(0, 0xff);
+    std::vector<u8> bytes(size);
+    for (u8& byte : bytes) {
+        byte = static_cast<u8>(distribution(generator));
+    }
+    return bytes;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Decoders::UnswizzleTexture", "[video_core]") {
+    constexpr u32 height = 37;
+    constexpr u32 block_height_bit = 1;
+    for (const u32 bytes_per_pixel : bytes_per_pixel_classes) {
+        // Three whole GOBs and a partial one on each row, with partial GOBs at the bottom
+        const u32 width = 208 / bytes_per_pixel;
+        const u32 pitch = width * bytes_per_pixel;
+        std::vector<u8> swizzled = RandomBytes(
+            CalculateSize(true, bytes_per_pixel, width, height, 1, block_height_bit, 0));
+
+        const std::vector<u8> unswizzled = UnswizzleTexture(
+            swizzled.data(), 1, 1, bytes_per_pixel, width, height, 1, block_height_bit, 0, 1);
+
+        for (u32 y = 0; y < height; ++y) {
+            for (u32 x_byte = 0; x_byte < pitch; ++x_byte) {
+                const std::size_t offset = SwizzledOffset(x_byte, y, pitch, 1U << block_height_bit);
+                REQUIRE(unswizzled[y * pitch + x_byte] == swizzled[offset]);
+            }
+        }
+    }
+}
+
+TEST_CASE("Decoders::SwizzleTexture", "[video_core]") {
+    constexpr u32 height = 37;
+    constexpr u32 block_height_bit = 2;
+    for (const u32 bytes_per_pixel : bytes_per_pixel_classes) {
+        const u32 width = 208 / bytes_per_pixel;
+        const u32 pitch = width * bytes_per_pixel;
+        std::vector<u8> unswizzled = RandomBytes(pitch * height);
+        std::vector<u8> swizzled(
+            CalculateSize(true, bytes_per_pixel, width, height, 1, block_height_bit, 0));
+        std::vector<u8> expected(swizzled.size());
+        for (u32 y = 0; y < height; ++y) {
+            for (u32 x_byte = 0; x_byte < pitch; ++x_byte) {
+                const std::size_t offset = SwizzledOffset(x_byte, y, pitch, 1U << block_height_bit);
+                expected[offset] = unswizzled[y * pitch + x_byte];
+            }
+        }
+
+        CopySwizzledData(width, height, 1, bytes_per_pixel, bytes_per_pixel, swizzled.data(),
+                         unswizzled.data(), false, block_height_bit, 0, 1);
+
+        REQUIRE(swizzled == expected);
+    }
+}
+
+TEST_CASE("Decoders::SwizzleSubrect", "[video_core]") {
+    constexpr u32 swizzled_height = 64;
+    constexpr u32 block_height_bit = 1;
+    for (const u32 bytes_per_pixel : bytes_per_pixel_classes) {
+        const u32 swizzled_width = 256 / bytes_per_pixel;
+        const u32 swizzled_pitch = swizzled_width * bytes_per_pixel;
+        const u32 gob_pixels = 64 / bytes_per_pixel;
+
+        // GOB aligned and unaligned origins, both with partial GOBs on the edges
+        const std::array<std::array<u32, 2>, 2> origins{{{gob_pixels, 8}, {3, 5}}};
+        for (const auto [offset_x, offset_y] : origins) {
+            const u32 subrect_width = gob_pixels * 2 + gob_pixels / 2;
+            const u32 subrect_height = 19;
+            const u32 source_pitch = subrect_width * bytes_per_pixel + 16;
+            std::vector<u8> source = RandomBytes(source_pitch * subrect_height);
+            std::vector<u8> swizzled = RandomBytes(swizzled_pitch * swizzled_height);
+            std::vector<u8> expected = swizzled;
+            for (u32 line = 0; line < subrect_height; ++line) {
+                for (u32 x_byte = 0; x_byte < subrect_width * bytes_per_pixel; ++x_byte) {
+                    const std::size_t offset =
+                        SwizzledOffset(offset_x * bytes_per_pixel + x_byte, offset_y + line,
+                                       swizzled_pitch, 1U << block_height_bit);
+                    expected[offset] = source[line * source_pitch + x_byte];
+                }
+            }
+
+            SwizzleSubrect(subrect_width, subrect_height, source_pitch, swizzled_width,
+                           bytes_per_pixel, swizzled.data(), source.data(), block_height_bit,
+                           offset_x, offset_y);
+
+            REQUIRE(swizzled == expected);
+        }
+    }
+}
+
+} // namespace Tegra::Texture
@@ -0,0 +1,61 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+
+#include <catch2/catch.hpp>
+
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_hle.h"
+
+namespace Tegra::Macro {
+
+namespace {
+
+/// Code that hashes to the key of the indexed indirect draw macro in the HLE table.
+constexpr std::array<u32, 3> KNOWN_MACRO{0xf6905bc2, 0x028985ae, 0x000000b1};
+constexpr u64 KNOWN_MACRO_HASH = 0x0217920100488FF7;
+
+} // Anonymous namespace
+
+TEST_CASE("MacroUploads[KnownMacro]", "[video_core]") {
+    MacroUploads uploads;
+    // Drivers upload their macros a word at a time
+    for (std::size_t i = 0; i < KNOWN_MACRO.size(); ++i) {
+        uploads.Add(static_cast<u32>(0x40 + i), &KNOWN_MACRO[i], 1);
+    }
+    const auto hash = uploads.GetHash(0x40);
+    REQUIRE(hash);
+    REQUIRE(*hash == KNOWN_MACRO_HASH);
+    REQUIRE(HLEMacro::HasHLEProgram(*hash));
+
+    // Uploaded in one go it hashes the same
+    MacroUploads batch;
+    batch.Add(0x80, KNOWN_MACRO.data(), KNOWN_MACRO.size());
+    REQUIRE(batch.GetHash(0x80) == KNOWN_MACRO_HASH);
+}
+
+TEST_CASE("MacroUploads[Batches]", "[video_core]") {
+    constexpr std::array<u32, 2> other{0x11, 0x22};
+    MacroUploads uploads;
+    REQUIRE(!uploads.GetHash(0));
+
+    // A macro bound in the middle of an upload hashes until its end
+    uploads.Add(0, other.data(), other.size());
+    uploads.Add(2, KNOWN_MACRO.data(), KNOWN_MACRO.size());
+    REQUIRE(uploads.GetHash(2) == KNOWN_MACRO_HASH);
+    REQUIRE(uploads.GetHash(0) != KNOWN_MACRO_HASH);
+    REQUIRE(!uploads.GetHash(5));
+
+    // Words that don't follow the last upload start a new one, cutting the one they overwrite
+    uploads.Add(4, other.data(), other.size());
+    REQUIRE(uploads.GetHash(2) != KNOWN_MACRO_HASH);
+    uploads.Add(10, KNOWN_MACRO.data(), KNOWN_MACRO.size());
+    REQUIRE(uploads.GetHash(10) == KNOWN_MACRO_HASH);
+
+    uploads.Clear();
+    REQUIRE(!uploads.GetHash(10));
+}
+
+} // namespace Tegra::Macro
@@ -0,0 +1,103 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "video_core/page_index.h"
+
+namespace VideoCommon {
+
+namespace {
+
+constexpr u64 PAGE_BITS = 12;
+constexpr CacheAddr PAGE_SIZE = 1 << PAGE_BITS;
+
+using Index = PageIndex<int, PAGE_BITS>;
+
+std::vector<int> Lookup(const Index& index, CacheAddr start, CacheAddr end) {
+    std::vector<int> objects;
+    index.ForEachInRange(start, end, [&objects](int object) { objects.push_back(object); });
+    return objects;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("PageIndex: Empty", "[video_core]") {
+    Index index;
+    REQUIRE(index.Empty());
+    REQUIRE(Lookup(index, 0, PAGE_SIZE * 16).empty());
+
+    // Empty ranges are ignored.
+    index.Insert(PAGE_SIZE, PAGE_SIZE, 1);
+    REQUIRE(index.Empty());
+}
+
+TEST_CASE("PageIndex: Overlapping objects are reported once", "[video_core]") {
+    Index index;
+    index.Insert(PAGE_SIZE / 2, PAGE_SIZE * 3, 1);
+    index.Insert(PAGE_SIZE * 2, PAGE_SIZE * 2 + 16, 2);
+    index.Insert(PAGE_SIZE * 5, PAGE_SIZE * 6, 3);
+
+    REQUIRE(Lookup(index, 0, PAGE_SIZE * 8) == std::vector<int>{1, 2, 3});
+    REQUIRE(Lookup(index, PAGE_SIZE * 2, PAGE_SIZE * 3) == std::vector<int>{1, 2});
+    REQUIRE(Lookup(index, PAGE_SIZE * 2 + 16, PAGE_SIZE * 3) == std::vector<int>{1});
+
+    // Ranges are half open, touching an object's end doesn't overlap it.
+    REQUIRE(Lookup(index, PAGE_SIZE * 3, PAGE_SIZE * 5).empty());
+    REQUIRE(Lookup(index, 0, PAGE_SIZE / 2).empty());
+    REQUIRE(Lookup(index, PAGE_SIZE * 6 - 1, PAGE_SIZE * 6) == std::vector<int>{3});
+}
+
+TEST_CASE("PageIndex: Objects spanning chunks", "[video_core]") {
+    // Cover more pages than a chunk holds and look up ranges starting in either of them.
+    constexpr CacheAddr start = PAGE_SIZE * 1000;
+    constexpr CacheAddr end = PAGE_SIZE * 3000;
+    Index index;
+    index.Insert(start, end, 1);
+
+    REQUIRE(Lookup(index, 0, start + 1) == std::vector<int>{1});
+    REQUIRE(Lookup(index, PAGE_SIZE * 2048, PAGE_SIZE * 4096) == std::vector<int>{1});
+    REQUIRE(Lookup(index, end, end + PAGE_SIZE * 2048).empty());
+
+    index.Erase(start, end, 1);
+    REQUIRE(index.Empty());
+}
+
+TEST_CASE("PageIndex: ForEach", "[video_core]") {
+    Index index;
+    index.Insert(PAGE_SIZE * 4, PAGE_SIZE * 3000, 1);
+    index.Insert(0, PAGE_SIZE, 2);
+    index.Insert(PAGE_SIZE * 2048, PAGE_SIZE * 2049, 3);
+
+    std::vector<int> objects;
+    index.ForEach([&objects](int object) { objects.push_back(object); });
+    std::sort(objects.begin(), objects.end());
+    REQUIRE(objects == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("PageIndex: Erase", "[video_core]") {
+    Index index;
+    index.Insert(0, PAGE_SIZE * 2, 1);
+    index.Insert(0, PAGE_SIZE * 2, 2);
+    index.Insert(PAGE_SIZE, PAGE_SIZE * 4, 3);
+
+    index.Erase(0, PAGE_SIZE * 2, 1);
+    REQUIRE(Lookup(index, 0, PAGE_SIZE * 4) == std::vector<int>{2, 3});
+
+    index.Erase(PAGE_SIZE, PAGE_SIZE * 4, 3);
+    REQUIRE(Lookup(index, 0, PAGE_SIZE * 4) == std::vector<int>{2});
+
+    index.Erase(0, PAGE_SIZE * 2, 2);
+    REQUIRE(index.Empty());
+
+    index.Insert(0, PAGE_SIZE, 4);
+    index.Clear();
+    REQUIRE(index.Empty());
+    REQUIRE(Lookup(index, 0, PAGE_SIZE).empty());
+}
+
+} // namespace VideoCommon
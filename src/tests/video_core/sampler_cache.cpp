@@ -0,0 +1,99 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include "video_core/sampler_cache.h"
+#include "video_core/textures/texture.h"
+
+namespace VideoCommon {
+
+namespace {
+
+using Tegra::Texture::DepthCompareFunc;
+using Tegra::Texture::TextureFilter;
+using Tegra::Texture::TSCEntry;
+using Tegra::Texture::WrapMode;
+
+TSCEntry MakeEntry(WrapMode wrap) {
+    TSCEntry tsc{};
+    tsc.wrap_u.Assign(wrap);
+    tsc.wrap_v.Assign(wrap);
+    tsc.wrap_p.Assign(wrap);
+    tsc.mag_filter.Assign(TextureFilter::Linear);
+    tsc.min_filter.Assign(TextureFilter::Linear);
+    tsc.max_lod_clamp.Assign(0xfff);
+    return tsc;
+}
+
+class CountingSamplerCache final : public SamplerCache<int, int> {
+public:
+    int num_created = 0;
+
+protected:
+    int CreateSampler(const TSCEntry&) const override {
+        return ++const_cast<CountingSamplerCache*>(this)->num_created;
+    }
+
+    int ToSamplerType(const int& sampler) const override {
+        return sampler;
+    }
+};
+
+} // Anonymous namespace
+
+TEST_CASE("SamplerCacheKey: Border color is only kept when sampled", "[video_core]") {
+    TSCEntry lhs = MakeEntry(WrapMode::ClampToEdge);
+    TSCEntry rhs = lhs;
+    rhs.border_color = {1.0f, 0.5f, 0.25f, 1.0f};
+    REQUIRE(SamplerCacheKey{lhs} == SamplerCacheKey{rhs});
+
+    lhs.wrap_p.Assign(WrapMode::Border);
+    rhs.wrap_p.Assign(WrapMode::Border);
+    REQUIRE(SamplerCacheKey{lhs} != SamplerCacheKey{rhs});
+}
+
+TEST_CASE("SamplerCacheKey: Comparison function is ignored when disabled", "[video_core]") {
+    TSCEntry lhs = MakeEntry(WrapMode::Wrap);
+    TSCEntry rhs = lhs;
+    rhs.depth_compare_func.Assign(DepthCompareFunc::Greater);
+    REQUIRE(SamplerCacheKey{lhs} == SamplerCacheKey{rhs});
+
+    lhs.depth_compare_enabled.Assign(1);
+    rhs.depth_compare_enabled.Assign(1);
+    REQUIRE(SamplerCacheKey{lhs} != SamplerCacheKey{rhs});
+}
+
+TEST_CASE("SamplerCacheKey: Sampling state is preserved", "[video_core]") {
+    const TSCEntry base = MakeEntry(WrapMode::Wrap);
+    TSCEntry other = base;
+    other.mip_lod_bias.Assign(0x1fff);
+    REQUIRE(SamplerCacheKey{base} != SamplerCacheKey{other});
+
+    other = base;
+    other.min_lod_clamp.Assign(1);
+    REQUIRE(SamplerCacheKey{base} != SamplerCacheKey{other});
+
+    other = base;
+    other.wrap_v.Assign(WrapMode::Mirror);
+    REQUIRE(SamplerCacheKey{base} != SamplerCacheKey{other});
+}
+
+TEST_CASE("SamplerCache: Equivalent entries share a sampler", "[video_core]") {
+    CountingSamplerCache cache;
+    TSCEntry lhs = MakeEntry(WrapMode::Wrap);
+    TSCEntry rhs = lhs;
+    rhs.border_color = {1.0f, 1.0f, 1.0f, 1.0f};
+    const int sampler = cache.GetSampler(lhs);
+    REQUIRE(cache.GetSampler(rhs) == sampler);
+    REQUIRE(cache.GetSampler(lhs) == sampler);
+    REQUIRE(cache.num_created == 1);
+
+    rhs.mag_filter.Assign(TextureFilter::Nearest);
+    REQUIRE(cache.GetSampler(rhs) != sampler);
+    REQUIRE(cache.GetSampler(lhs) == sampler);
+    REQUIRE(cache.num_created == 2);
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,158 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include "video_core/surface.h"
+#include "video_core/texture_cache/surface_base.h"
+#include "video_core/texture_cache/surface_params.h"
+
+namespace VideoCommon {
+
+namespace {
+
+using VideoCore::Surface::ComponentType;
+using VideoCore::Surface::PixelFormat;
+using VideoCore::Surface::SurfaceType;
+
+constexpr CacheAddr BASE_ADDR = 0x10000000;
+constexpr u32 NUM_LAYERS = 4;
+constexpr u32 NUM_LEVELS = 3;
+
+SurfaceParams MakeArrayParams() {
+    SurfaceParams params{};
+    params.is_tiled = true;
+    params.is_layered = true;
+    params.width = 64;
+    params.height = 64;
+    params.depth = NUM_LAYERS;
+    params.num_levels = NUM_LEVELS;
+    params.emulated_levels = NUM_LEVELS;
+    params.resolution_scale = 1;
+    params.pixel_format = PixelFormat::ABGR8U;
+    params.component_type = ComponentType::UNorm;
+    params.type = SurfaceType::ColorTexture;
+    params.target = SurfaceTarget::Texture2DArray;
+    return params;
+}
+
+class TestSurface final : public SurfaceBaseImpl {
+public:
+    explicit TestSurface(const SurfaceParams& params) : SurfaceBaseImpl(0, params) {
+        SetCacheAddr(BASE_ADDR);
+    }
+
+    /// Returns the address of the given subresource.
+    CacheAddr GetSubresourceAddr(u32 layer, u32 level) const {
+        return BASE_ADDR + layer * layer_size + mipmap_offsets[level];
+    }
+
+private:
+    void DecorateSurfaceName() override {}
+};
+
+class TestClearSurface final : public SurfaceBase<int> {
+public:
+    explicit TestClearSurface(const SurfaceParams& params) : SurfaceBase<int>(0, params) {}
+
+    void UploadTexture(const std::vector<u8>&) override {}
+    void DownloadTexture(std::vector<u8>&) override {}
+
+private:
+    void DecorateSurfaceName() override {}
+
+    int CreateView(const ViewParams&) override {
+        return 0;
+    }
+};
+
+SurfaceParams MakeTargetParams() {
+    SurfaceParams params = MakeArrayParams();
+    params.is_layered = false;
+    params.depth = 1;
+    params.num_levels = 1;
+    params.emulated_levels = 1;
+    params.target = SurfaceTarget::Texture2D;
+    return params;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("SurfaceBase: Clean surfaces process every subresource", "[video_core]") {
+    const TestSurface surface(MakeArrayParams());
+    REQUIRE_FALSE(surface.HasDirtySubresources());
+    for (u32 layer = 0; layer < NUM_LAYERS; ++layer) {
+        for (u32 level = 0; level < NUM_LEVELS; ++level) {
+            REQUIRE(surface.IsSubresourceDirty(layer, level));
+        }
+    }
+}
+
+TEST_CASE("SurfaceBase: Regions mark the subresources they overlap", "[video_core]") {
+    TestSurface surface(MakeArrayParams());
+    const CacheAddr addr = surface.GetSubresourceAddr(2, 1);
+    REQUIRE_FALSE(surface.MarkRegionAsDirty(addr + 4, addr + 8));
+    REQUIRE(surface.HasDirtySubresources());
+    for (u32 layer = 0; layer < NUM_LAYERS; ++layer) {
+        for (u32 level = 0; level < NUM_LEVELS; ++level) {
+            REQUIRE(surface.IsSubresourceDirty(layer, level) == (layer == 2 && level == 1));
+        }
+    }
+    REQUIRE(surface.IsLevelDirty(1));
+    REQUIRE_FALSE(surface.IsLevelDirty(0));
+
+    // A region crossing the boundary of two layers marks both of them
+    const CacheAddr boundary = surface.GetSubresourceAddr(1, 0);
+    REQUIRE_FALSE(surface.MarkRegionAsDirty(boundary - 4, boundary + 4));
+    REQUIRE(surface.IsSubresourceDirty(0, NUM_LEVELS - 1));
+    REQUIRE(surface.IsSubresourceDirty(1, 0));
+    REQUIRE_FALSE(surface.IsSubresourceDirty(1, 1));
+
+    surface.ClearDirtySubresources();
+    REQUIRE_FALSE(surface.HasDirtySubresources());
+    REQUIRE(surface.IsSubresourceDirty(3, 2));
+}
+
+TEST_CASE("SurfaceBase: Regions covering the surface mark it whole", "[video_core]") {
+    TestSurface surface(MakeArrayParams());
+    REQUIRE_FALSE(surface.MarkRegionAsDirty(BASE_ADDR - 0x1000, BASE_ADDR));
+    REQUIRE_FALSE(surface.HasDirtySubresources());
+    REQUIRE(surface.MarkRegionAsDirty(BASE_ADDR - 0x1000,
+                                      BASE_ADDR + surface.GetSizeInBytes() + 0x1000));
+}
+
+TEST_CASE("SurfaceBase: Clears are recorded until the surface is modified", "[video_core]") {
+    TestClearSurface surface(MakeTargetParams());
+    ClearValue value;
+    value.color = {0.0f, 0.5f, 1.0f, 1.0f};
+    REQUIRE_FALSE(surface.GetFullClearValue());
+
+    // Partial clears don't clear the whole surface
+    surface.MarkAsCleared(value, {0, 0, 32, 64});
+    REQUIRE(surface.IsClearedTo(value, {8, 8, 16, 16}));
+    REQUIRE_FALSE(surface.IsClearedTo(value, {0, 0, 64, 64}));
+    REQUIRE_FALSE(surface.GetFullClearValue());
+
+    // Unbounded rectangles are clamped to the surface
+    surface.MarkAsCleared(value, {0, 0, 0xFFFFFFFF, 0xFFFFFFFF});
+    REQUIRE(surface.GetFullClearValue() == value);
+
+    // A clear part of the previous one to the same value keeps it whole
+    surface.MarkAsCleared(value, {0, 0, 16, 16});
+    REQUIRE(surface.GetFullClearValue() == value);
+
+    ClearValue other;
+    other.color = {1.0f, 1.0f, 1.0f, 1.0f};
+    REQUIRE_FALSE(surface.IsClearedTo(other, {0, 0, 16, 16}));
+    surface.MarkAsCleared(other, {0, 0, 16, 16});
+    REQUIRE(surface.IsClearedTo(other, {0, 0, 16, 16}));
+    REQUIRE_FALSE(surface.IsClearedTo(value, {32, 32, 64, 64}));
+
+    surface.MarkAsCleared(value, {0, 0, 64, 64});
+    surface.MarkAsModified(true, 1);
+    REQUIRE_FALSE(surface.GetFullClearValue());
+    REQUIRE_FALSE(surface.IsClearedTo(value, {0, 0, 16, 16}));
+}
+
+} // namespace VideoCommon
@@ -31,8 +31,14 @@ public:
         return FromCacheAddr(cache_addr + offset);
     }
 
-    std::size_t GetOffset(const CacheAddr in_addr) {
-        return static_cast<std::size_t>(in_addr - cache_addr);
+    /// Returns the offset of an address in the storage of the block, which may be shared with
+    /// other blocks.
+    std::size_t GetOffset(const CacheAddr in_addr) const {
+        return storage_offset + static_cast<std::size_t>(in_addr - cache_addr);
+    }
+
+    std::size_t GetStorageOffset() const {
+        return storage_offset;
     }
 
     CacheAddr GetCacheAddr() const {
@@ -52,6 +58,12 @@ public:
         return size;
     }
 
+    /// Changes the size of the block once its storage was grown in place.
+    void SetSize(const std::size_t new_size) {
+        size = new_size;
+        cache_addr_end = cache_addr + size;
+    }
+
     void SetEpoch(u64 new_epoch) {
         epoch = new_epoch;
     }
@@ -61,7 +73,9 @@ public:
     }
 
 protected:
-    explicit BufferBlock(CacheAddr cache_addr, const std::size_t size) : size{size} {
+    explicit BufferBlock(CacheAddr cache_addr, const std::size_t size,
+                         const std::size_t storage_offset = 0)
+        : size{size}, storage_offset{storage_offset} {
         SetCacheAddr(cache_addr);
     }
     ~BufferBlock() = default;
@@ -70,6 +84,7 @@ private:
     CacheAddr cache_addr{};
     CacheAddr cache_addr_end{};
     std::size_t size{};
+    std::size_t storage_offset{};
     u64 epoch{};
 };
 
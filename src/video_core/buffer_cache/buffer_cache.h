@@ -4,24 +4,23 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <list>
 #include <memory>
-#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
-#include <boost/icl/interval_map.hpp>
-#include <boost/icl/interval_set.hpp>
-#include <boost/range/iterator_range.hpp>
-
 #include "common/alignment.h"
 #include "common/common_types.h"
 #include "core/core.h"
 #include "video_core/buffer_cache/buffer_block.h"
 #include "video_core/buffer_cache/map_interval.h"
 #include "video_core/memory_manager.h"
+#include "video_core/page_index.h"
 #include "video_core/rasterizer_interface.h"
 
 namespace VideoCommon {
@@ -33,30 +32,41 @@ class BufferCache {
 public:
     using BufferInfo = std::pair<const TBufferType*, u64>;
 
+    /// Uploads smaller than this go through the stream buffer, unless the GPU writes their range.
+    static constexpr std::size_t MAX_STREAM_SIZE = 0x800;
+
     BufferInfo UploadMemory(GPUVAddr gpu_addr, std::size_t size, std::size_t alignment = 4,
                             bool is_written = false, bool use_fast_cbuf = false) {
-        std::lock_guard lock{mutex};
-
         auto& memory_manager = system.GPU().MemoryManager();
         const auto host_ptr = memory_manager.GetPointer(gpu_addr);
         if (!host_ptr) {
             return {GetEmptyBuffer(size), 0};
         }
+        memory_manager.TrackRead(gpu_addr, size);
         const auto cache_addr = ToCacheAddr(host_ptr);
 
         // Cache management is a big overhead, so only cache entries with a given size.
         // TODO: Figure out which size is the best for given games.
-        constexpr std::size_t max_stream_size = 0x800;
-        if (use_fast_cbuf || size < max_stream_size) {
+        if (use_fast_cbuf || size < MAX_STREAM_SIZE) {
             if (!is_written && !IsRegionWritten(cache_addr, cache_addr + size - 1)) {
                 if (use_fast_cbuf) {
+                    system.GPU().Statistics().Add(VideoCore::GPUCounter::BufferUploadBytes, size);
                     return ConstBufferUpload(host_ptr, size);
                 } else {
-                    return StreamBufferUpload(host_ptr, size, alignment);
+                    return CachedStreamBufferUpload(cache_addr, host_ptr, size, alignment);
                 }
             }
         }
 
+        if (!is_written) {
+            // Repeated draws of the same mesh hit this, skip the block and interval lookups
+            const auto it = cached_bindings.find(cache_addr);
+            if (it != cached_bindings.end() && it->second.size == size &&
+                it->second.generation == bindings_generation) {
+                return it->second.info;
+            }
+        }
+
         auto block = GetBlock(cache_addr, size);
         auto map = MapAddress(block, gpu_addr, cache_addr, size);
         if (is_written) {
@@ -65,6 +75,7 @@ public:
                 map->MarkAsWritten(true);
                 MarkRegionAsWritten(map->GetStart(), map->GetEnd() - 1);
             }
+            pending_downloads.insert(map);
         } else {
             if (map->IsWritten()) {
                 WriteBarrier();
@@ -72,34 +83,42 @@ public:
         }
 
         const u64 offset = static_cast<u64>(block->GetOffset(cache_addr));
-
-        return {ToHandle(block), offset};
+        const BufferInfo info{ToHandle(block), offset};
+        if (!is_written && !map->IsWritten()) {
+            if (cached_bindings.size() >= max_cached_bindings) {
+                cached_bindings.clear();
+            }
+            cached_bindings[cache_addr] = {size, bindings_generation, info};
+        }
+        return info;
     }
 
     /// Uploads from a host memory. Returns the OpenGL buffer where it's located and its offset.
     BufferInfo UploadHostMemory(const void* raw_pointer, std::size_t size,
                                 std::size_t alignment = 4) {
-        std::lock_guard lock{mutex};
         return StreamBufferUpload(raw_pointer, size, alignment);
     }
 
     void Map(std::size_t max_size) {
-        std::lock_guard lock{mutex};
-
+        const u64 previous_end = buffer_offset;
         std::tie(buffer_ptr, buffer_offset_base, invalidated) = stream_buffer->Map(max_size, 4);
         buffer_offset = buffer_offset_base;
+        if (invalidated || buffer_offset_base < previous_end) {
+            // Previous uploads were orphaned with the old stream buffer storage, or a persistent
+            // stream buffer wrapped around and is about to overwrite them
+            stream_uploads.clear();
+        }
     }
 
     /// Finishes the upload stream, returns true on bindings invalidation.
     bool Unmap() {
-        std::lock_guard lock{mutex};
-
         stream_buffer->Unmap(buffer_offset - buffer_offset_base);
         return std::exchange(invalidated, false);
     }
 
     void TickFrame() {
         ++epoch;
+        cached_bindings.clear();
         while (!pending_destruction.empty()) {
             if (pending_destruction.front()->GetEpoch() + 1 > epoch) {
                 break;
@@ -108,10 +127,32 @@ public:
         }
     }
 
+    /// Starts downloading the buffers written by the GPU in the command batch that just ended, so
+    /// flushing them later waits for the copy instead of reading them back synchronously.
+    void CommitAsyncFlushes() {
+        bool is_barrier_pending = true;
+        for (const MapInterval& map : pending_downloads) {
+            if (!map->IsRegistered() || !map->IsModified() || map->HasDownload()) {
+                continue;
+            }
+            if (std::exchange(is_barrier_pending, false)) {
+                WriteBarrier();
+            }
+            const std::size_t size = map->GetEnd() - map->GetStart();
+            const TBuffer& block = blocks[map->GetStart() >> block_page_bits];
+            const u64 token = QueueDownload(block, block->GetOffset(map->GetStart()), size);
+            if (token != 0) {
+                map->SetDownload(token);
+            }
+        }
+        pending_downloads.clear();
+        if (!is_barrier_pending) {
+            FenceDownloads();
+        }
+    }
+
     /// Write any cached resources overlapping the specified region back to memory
     void FlushRegion(CacheAddr addr, std::size_t size) {
-        std::lock_guard lock{mutex};
-
         std::vector<MapInterval> objects = GetMapsInRange(addr, size);
         std::sort(objects.begin(), objects.end(), [](const MapInterval& a, const MapInterval& b) {
             return a->GetModificationTick() < b->GetModificationTick();
@@ -123,10 +164,20 @@ public:
         }
     }
 
+    /// Returns true when the region holds data written by the GPU that guest memory doesn't have.
+    bool IsRegionModified(GPUVAddr gpu_addr, std::size_t size) {
+        const u8* const host_ptr = system.GPU().MemoryManager().GetPointer(gpu_addr);
+        if (!host_ptr || size == 0) {
+            return false;
+        }
+        const std::vector<MapInterval> maps = GetMapsInRange(ToCacheAddr(host_ptr), size);
+        return std::any_of(maps.begin(), maps.end(), [](const MapInterval& map) {
+            return map->IsRegistered() && map->IsModified();
+        });
+    }
+
     /// Mark the specified region as being invalidated
     void InvalidateRegion(CacheAddr addr, u64 size) {
-        std::lock_guard lock{mutex};
-
         std::vector<MapInterval> objects = GetMapsInRange(addr, size);
         for (auto& object : objects) {
             if (object->IsRegistered()) {
@@ -135,6 +186,42 @@ public:
         }
     }
 
+    /// Copies a guest range on the host GPU when the source holds data modified by the GPU,
+    /// marking the destination as modified. Returns false when the copy has to be done through
+    /// guest memory instead.
+    bool CopyRegion(GPUVAddr src_gpu_addr, GPUVAddr dst_gpu_addr, std::size_t size) {
+        auto& memory_manager = system.GPU().MemoryManager();
+        const CacheAddr src_addr = ToCacheAddr(memory_manager.GetPointer(src_gpu_addr));
+        const CacheAddr dst_addr = ToCacheAddr(memory_manager.GetPointer(dst_gpu_addr));
+        if (!src_addr || !dst_addr || size == 0) {
+            return false;
+        }
+        // Host copies can't overlap, the guest may copy a buffer into itself
+        if (src_addr < dst_addr + size && dst_addr < src_addr + size) {
+            return false;
+        }
+        const std::vector<MapInterval> src_maps = GetMapsInRange(src_addr, size);
+        if (std::none_of(src_maps.begin(), src_maps.end(),
+                         [](const MapInterval& map) { return map->IsModified(); })) {
+            return false;
+        }
+
+        MapAddress(GetBlock(src_addr, size), src_gpu_addr, src_addr, size);
+        const TBuffer dst_block = GetBlock(dst_addr, size);
+        MapInterval dst_map = MapAddress(dst_block, dst_gpu_addr, dst_addr, size);
+        dst_map->MarkAsModified(true, GetModifiedTicks());
+        if (!dst_map->IsWritten()) {
+            dst_map->MarkAsWritten(true);
+            MarkRegionAsWritten(dst_map->GetStart(), dst_map->GetEnd() - 1);
+        }
+
+        // Getting the destination block may have merged the one holding the source
+        const TBuffer src_block = GetBlock(src_addr, size);
+        CopyBlock(src_block, dst_block, src_block->GetOffset(src_addr),
+                  dst_block->GetOffset(dst_addr), size);
+        return true;
+    }
+
     virtual const TBufferType* GetEmptyBuffer(std::size_t size) = 0;
 
 protected:
@@ -160,10 +247,30 @@ protected:
     virtual void CopyBlock(const TBuffer& src, const TBuffer& dst, std::size_t src_offset,
                            std::size_t dst_offset, std::size_t size) = 0;
 
+    /// Grows the storage of a block in place when the storage after it is free. Returns false
+    /// when the block has to be copied to a new one instead.
+    virtual bool GrowBlock(const TBuffer& buffer, std::size_t new_size) {
+        return false;
+    }
+
     virtual BufferInfo ConstBufferUpload(const void* raw_pointer, std::size_t size) {
         return {};
     }
 
+    /// Starts copying a range of a block to host memory. Returns the token to finish the download
+    /// with, or zero when it has to be downloaded synchronously.
+    virtual u64 QueueDownload(const TBuffer& buffer, std::size_t offset, std::size_t size) {
+        return 0;
+    }
+
+    /// Fences the downloads queued since the last call.
+    virtual void FenceDownloads() {}
+
+    /// Waits for a queued download and copies it to data. Returns false when it's not available.
+    virtual bool FinishDownload(u64 token, u8* data, std::size_t size) {
+        return false;
+    }
+
     /// Register an object into the cache
     void Register(const MapInterval& new_map, bool inherit_written = false) {
         const CacheAddr cache_ptr = new_map->GetStart();
@@ -177,8 +284,8 @@ protected:
         const std::size_t size = new_map->GetEnd() - new_map->GetStart();
         new_map->SetCpuAddress(*cpu_addr);
         new_map->MarkAsRegistered(true);
-        const IntervalType interval{new_map->GetStart(), new_map->GetEnd()};
-        mapped_addresses.insert({interval, new_map});
+        ++bindings_generation;
+        mapped_addresses.Insert(new_map->GetStart(), new_map->GetEnd(), new_map);
         rasterizer.UpdatePagesCachedCount(*cpu_addr, size, 1);
         if (inherit_written) {
             MarkRegionAsWritten(new_map->GetStart(), new_map->GetEnd() - 1);
@@ -191,11 +298,11 @@ protected:
         const std::size_t size = map->GetEnd() - map->GetStart();
         rasterizer.UpdatePagesCachedCount(map->GetCpuAddress(), size, -1);
         map->MarkAsRegistered(false);
+        ++bindings_generation;
         if (map->IsWritten()) {
             UnmarkRegionAsWritten(map->GetStart(), map->GetEnd() - 1);
         }
-        const IntervalType delete_interval{map->GetStart(), map->GetEnd()};
-        mapped_addresses.erase(delete_interval);
+        mapped_addresses.Erase(map->GetStart(), map->GetEnd(), map);
     }
 
 private:
@@ -212,6 +319,7 @@ private:
             MapInterval new_map = CreateMap(cache_addr, cache_addr_end, gpu_addr);
             u8* host_ptr = FromCacheAddr(cache_addr);
             UploadBlockData(block, block->GetOffset(cache_addr), size, host_ptr);
+            system.GPU().Statistics().Add(VideoCore::GPUCounter::BufferUploadBytes, size);
             Register(new_map);
             return new_map;
         }
@@ -249,20 +357,24 @@ private:
 
     void UpdateBlock(const TBuffer& block, CacheAddr start, CacheAddr end,
                      std::vector<MapInterval>& overlaps) {
-        const IntervalType base_interval{start, end};
-        IntervalSet interval_set{};
-        interval_set.add(base_interval);
-        for (auto& overlap : overlaps) {
-            const IntervalType subtract{overlap->GetStart(), overlap->GetEnd()};
-            interval_set.subtract(subtract);
-        }
-        for (auto& interval : interval_set) {
-            std::size_t size = interval.upper() - interval.lower();
-            if (size > 0) {
-                u8* host_ptr = FromCacheAddr(interval.lower());
-                UploadBlockData(block, block->GetOffset(interval.lower()), size, host_ptr);
+        const auto upload = [&](CacheAddr gap_start, CacheAddr gap_end) {
+            if (gap_start < gap_end) {
+                u8* host_ptr = FromCacheAddr(gap_start);
+                const std::size_t gap_size = gap_end - gap_start;
+                UploadBlockData(block, block->GetOffset(gap_start), gap_size, host_ptr);
+                system.GPU().Statistics().Add(VideoCore::GPUCounter::BufferUploadBytes, gap_size);
             }
+        };
+        // Maps never overlap each other, upload the gaps between them.
+        std::sort(overlaps.begin(), overlaps.end(), [](const MapInterval& a, const MapInterval& b) {
+            return a->GetStart() < b->GetStart();
+        });
+        CacheAddr gap_start = start;
+        for (const auto& overlap : overlaps) {
+            upload(gap_start, overlap->GetStart());
+            gap_start = std::max(gap_start, overlap->GetEnd());
         }
+        upload(gap_start, end);
     }
 
     std::vector<MapInterval> GetMapsInRange(CacheAddr addr, std::size_t size) {
@@ -271,10 +383,8 @@ private:
         }
 
         std::vector<MapInterval> objects{};
-        const IntervalType interval{addr, addr + size};
-        for (auto& pair : boost::make_iterator_range(mapped_addresses.equal_range(interval))) {
-            objects.push_back(pair.second);
-        }
+        mapped_addresses.ForEachInRange(
+            addr, addr + size, [&objects](const MapInterval& map) { objects.push_back(map); });
 
         return objects;
     }
@@ -288,7 +398,9 @@ private:
         std::size_t size = map->GetEnd() - map->GetStart();
         TBuffer block = blocks[map->GetStart() >> block_page_bits];
         u8* host_ptr = FromCacheAddr(map->GetStart());
-        DownloadBlockData(block, block->GetOffset(map->GetStart()), size, host_ptr);
+        if (!map->HasDownload() || !FinishDownload(map->GetDownloadToken(), host_ptr, size)) {
+            DownloadBlockData(block, block->GetOffset(map->GetStart()), size, host_ptr);
+        }
         map->MarkAsModified(false, 0);
     }
 
@@ -297,12 +409,34 @@ private:
         AlignBuffer(alignment);
         const std::size_t uploaded_offset = buffer_offset;
         std::memcpy(buffer_ptr, raw_pointer, size);
+        system.GPU().Statistics().Add(VideoCore::GPUCounter::BufferUploadBytes, size);
 
         buffer_ptr += size;
         buffer_offset += size;
         return {&stream_buffer_handle, uploaded_offset};
     }
 
+    /// Uploads a small guest buffer to the stream buffer. When the same range was uploaded before
+    /// with the same contents, the previous upload is returned and nothing is copied.
+    BufferInfo CachedStreamBufferUpload(CacheAddr cache_addr, const u8* host_ptr,
+                                        std::size_t size, std::size_t alignment) {
+        const auto it = stream_uploads.find(cache_addr);
+        if (it != stream_uploads.end()) {
+            StreamUpload& upload = it->second;
+            if (upload.data.size() == size && upload.offset % alignment == 0 &&
+                std::memcmp(upload.data.data(), host_ptr, size) == 0) {
+                return {&stream_buffer_handle, upload.offset};
+            }
+        } else if (stream_uploads.size() >= max_stream_uploads) {
+            stream_uploads.clear();
+        }
+        const BufferInfo info = StreamBufferUpload(host_ptr, size, alignment);
+        StreamUpload& upload = stream_uploads[cache_addr];
+        upload.offset = info.second;
+        upload.data.assign(host_ptr, host_ptr + size);
+        return info;
+    }
+
     void AlignBuffer(std::size_t alignment) {
         // Align the offset, not the mapped pointer
         const std::size_t offset_aligned = Common::AlignUp(buffer_offset, alignment);
@@ -314,10 +448,17 @@ private:
         const std::size_t old_size = buffer->GetSize();
         const std::size_t new_size = old_size + block_page_size;
         const CacheAddr cache_addr = buffer->GetCacheAddr();
-        TBuffer new_buffer = CreateBlock(cache_addr, new_size);
-        CopyBlock(buffer, new_buffer, 0, 0, old_size);
-        buffer->SetEpoch(epoch);
-        pending_destruction.push_back(buffer);
+        TBuffer new_buffer = buffer;
+        if (GrowBlock(buffer, new_size)) {
+            buffer->SetSize(new_size);
+        } else {
+            new_buffer = CreateBlock(cache_addr, new_size);
+            CopyBlock(buffer, new_buffer, buffer->GetStorageOffset(),
+                      new_buffer->GetStorageOffset(), old_size);
+            buffer->SetEpoch(epoch);
+            pending_destruction.push_back(buffer);
+            ++bindings_generation;
+        }
         const CacheAddr cache_addr_end = cache_addr + new_size - 1;
         u64 page_start = cache_addr >> block_page_bits;
         const u64 page_end = cache_addr_end >> block_page_bits;
@@ -336,12 +477,15 @@ private:
         const CacheAddr new_addr = std::min(first_addr, second_addr);
         const std::size_t new_size = size_1 + size_2;
         TBuffer new_buffer = CreateBlock(new_addr, new_size);
-        CopyBlock(first, new_buffer, 0, new_buffer->GetOffset(first_addr), size_1);
-        CopyBlock(second, new_buffer, 0, new_buffer->GetOffset(second_addr), size_2);
+        CopyBlock(first, new_buffer, first->GetStorageOffset(), new_buffer->GetOffset(first_addr),
+                  size_1);
+        CopyBlock(second, new_buffer, second->GetStorageOffset(),
+                  new_buffer->GetOffset(second_addr), size_2);
         first->SetEpoch(epoch);
         second->SetEpoch(epoch);
         pending_destruction.push_back(first);
         pending_destruction.push_back(second);
+        ++bindings_generation;
         const CacheAddr cache_addr_end = new_addr + new_size - 1;
         u64 page_start = new_addr >> block_page_bits;
         const u64 page_end = cache_addr_end >> block_page_bits;
@@ -384,6 +528,7 @@ private:
     }
 
     void MarkRegionAsWritten(const CacheAddr start, const CacheAddr end) {
+        ++bindings_generation;
         u64 page_start = start >> write_page_bit;
         const u64 page_end = end >> write_page_bit;
         while (page_start <= page_end) {
@@ -437,10 +582,31 @@ private:
     u64 buffer_offset = 0;
     u64 buffer_offset_base = 0;
 
-    using IntervalSet = boost::icl::interval_set<CacheAddr>;
-    using IntervalCache = boost::icl::interval_map<CacheAddr, MapInterval>;
-    using IntervalType = typename IntervalCache::interval_type;
-    IntervalCache mapped_addresses{};
+    /// Last stream buffer upload of a guest range, valid until the stream buffer is invalidated
+    /// or wraps around.
+    struct StreamUpload {
+        u64 offset{};
+        std::vector<u8> data;
+    };
+    static constexpr std::size_t max_stream_uploads{0x1000};
+    std::unordered_map<CacheAddr, StreamUpload> stream_uploads;
+
+    /// Binding of an unwritten guest range in a cached block. Only valid while no map, block or
+    /// written region changed since it was taken, and dropped every frame.
+    struct CachedBinding {
+        std::size_t size{};
+        u64 generation{};
+        BufferInfo info{};
+    };
+    static constexpr std::size_t max_cached_bindings{0x1000};
+    std::unordered_map<CacheAddr, CachedBinding> cached_bindings;
+    u64 bindings_generation{};
+
+    /// Maps written by the GPU in the current command batch
+    std::unordered_set<MapInterval> pending_downloads;
+
+    static constexpr u64 map_page_bits{16};
+    PageIndex<MapInterval, map_page_bits> mapped_addresses{};
 
     static constexpr u64 write_page_bit{11};
     std::unordered_map<u64, u32> written_pages{};
@@ -452,8 +618,6 @@ private:
     std::list<TBuffer> pending_destruction{};
     u64 epoch{};
     u64 modified_ticks{};
-
-    std::recursive_mutex mutex;
 };
 
 } // namespace VideoCommon
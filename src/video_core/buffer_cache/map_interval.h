@@ -75,6 +75,21 @@ public:
         return is_written;
     }
 
+    /// Records an asynchronous download of the current contents of the map.
+    void SetDownload(const u64 token) {
+        download_token = token;
+        download_ticks = ticks;
+    }
+
+    /// Returns true when a download of the current contents of the map was queued.
+    bool HasDownload() const {
+        return is_modified && download_token != 0 && download_ticks == ticks;
+    }
+
+    u64 GetDownloadToken() const {
+        return download_token;
+    }
+
 private:
     CacheAddr start;
     CacheAddr end;
@@ -84,6 +99,8 @@ private:
     bool is_modified{};
     bool is_registered{};
     u64 ticks{};
+    u64 download_token{};
+    u64 download_ticks{};
 };
 
 } // namespace VideoCommon
@@ -2,12 +2,15 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "common/microprofile.h"
 #include "core/core.h"
 #include "core/memory.h"
 #include "video_core/dma_pusher.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/gpu.h"
+#include "video_core/gpu_capture.h"
 #include "video_core/memory_manager.h"
 
 namespace Tegra {
@@ -18,6 +21,14 @@ DmaPusher::~DmaPusher() = default;
 
 MICROPROFILE_DEFINE(DispatchCalls, "GPU", "Execute command buffer", MP_RGB(128, 128, 192));
 
+void DmaPusher::Push(CommandList&& entries) {
+    auto& capture = gpu.Capture();
+    if (capture.IsRecording()) {
+        capture.RecordCommandList(entries);
+    }
+    dma_pushbuffer.push(std::move(entries));
+}
+
 void DmaPusher::DispatchCalls() {
     MICROPROFILE_SCOPE(DispatchCalls);
 
@@ -32,6 +43,11 @@ void DmaPusher::DispatchCalls() {
         }
     }
     gpu.FlushCommands();
+
+    auto& capture = gpu.Capture();
+    if (capture.IsRecording()) {
+        capture.FinishCommandLists();
+    }
 }
 
 bool DmaPusher::Step() {
@@ -64,24 +80,34 @@ bool DmaPusher::Step() {
     }
 
     // Push buffer non-empty, read a word
-    command_headers.resize(command_list_header.size);
-    gpu.MemoryManager().ReadBlockUnsafe(dma_get, command_headers.data(),
-                                        command_list_header.size * sizeof(u32));
+    const std::size_t num_headers = command_list_header.size;
+    gpu.Statistics().Add(VideoCore::GPUCounter::PushBufferWords, num_headers);
+    const CommandHeader* const headers = ReadCommandHeaders(dma_get, num_headers);
+    Engines::Maxwell3D& maxwell_3d = gpu.Maxwell3D();
 
-    for (const CommandHeader& command_header : command_headers) {
+    for (std::size_t index = 0; index < num_headers; ++index) {
+        const CommandHeader& command_header = headers[index];
 
         // now, see if we're in the middle of a command
         if (dma_state.length_pending) {
             // Second word of long non-inc methods command - method count
             dma_state.length_pending = 0;
             dma_state.method_count = command_header.method_count_;
+        } else if (dma_state.method_count && dma_state.non_incrementing) {
+            // Data words of a non-incrementing methods command, hand the engine every word of the
+            // run available in this fetch at once.
+            const std::size_t remaining = num_headers - index;
+            const u32 num_methods =
+                static_cast<u32>(std::min<std::size_t>(dma_state.method_count, remaining));
+            maxwell_3d.current_dma_segment = dma_get + index * sizeof(u32);
+            CallMultiMethod(&command_header.argument, num_methods);
+            dma_state.method_count -= num_methods;
+            index += num_methods - 1;
         } else if (dma_state.method_count) {
-            // Data word of methods command
+            // Data word of an incrementing methods command
+            maxwell_3d.current_dma_segment = dma_get + index * sizeof(u32);
             CallMethod(command_header.argument);
-
-            if (!dma_state.non_incrementing) {
-                dma_state.method++;
-            }
+            dma_state.method++;
 
             if (dma_increment_once) {
                 dma_state.non_incrementing = true;
@@ -104,6 +130,8 @@ bool DmaPusher::Step() {
             case SubmissionMode::Inline:
                 dma_state.method = command_header.method;
                 dma_state.subchannel = command_header.subchannel;
+                // The argument shares its word with the header, it has no address of its own
+                maxwell_3d.current_dma_segment = 0;
                 CallMethod(command_header.arg_count);
                 dma_state.non_incrementing = true;
                 dma_increment_once = false;
@@ -127,6 +155,21 @@ bool DmaPusher::Step() {
     return true;
 }
 
+const CommandHeader* DmaPusher::ReadCommandHeaders(GPUVAddr dma_get, std::size_t num_headers) {
+    auto& memory_manager = gpu.MemoryManager();
+    const std::size_t size = num_headers * sizeof(u32);
+
+    // Command lists that are contiguous in host memory are read in place, avoiding the copy.
+    const u8* const host_ptr = memory_manager.GetContiguousSpan(dma_get, size);
+    if (host_ptr != nullptr) {
+        return reinterpret_cast<const CommandHeader*>(host_ptr);
+    }
+
+    command_headers.resize(num_headers);
+    memory_manager.ReadBlockUnsafe(dma_get, command_headers.data(), size);
+    return command_headers.data();
+}
+
 void DmaPusher::SetState(const CommandHeader& command_header) {
     dma_state.method = command_header.method;
     dma_state.subchannel = command_header.subchannel;
@@ -137,4 +180,9 @@ void DmaPusher::CallMethod(u32 argument) const {
     gpu.CallMethod({dma_state.method, argument, dma_state.subchannel, dma_state.method_count});
 }
 
+void DmaPusher::CallMultiMethod(const u32* base_start, u32 num_methods) const {
+    gpu.CallMultiMethod(dma_state.method, dma_state.subchannel, base_start, num_methods,
+                        dma_state.method_count);
+}
+
 } // namespace Tegra
@@ -59,22 +59,30 @@ public:
     explicit DmaPusher(GPU& gpu);
     ~DmaPusher();
 
-    void Push(CommandList&& entries) {
-        dma_pushbuffer.push(std::move(entries));
-    }
+    void Push(CommandList&& entries);
 
     void DispatchCalls();
 
 private:
     bool Step();
 
+    /**
+     * Returns the command headers of a command list, pointing directly into host memory when the
+     * list is contiguous and into a copy owned by the pusher otherwise.
+     * @param dma_get GPU address of the command list.
+     * @param num_headers Number of words in the command list.
+     */
+    const CommandHeader* ReadCommandHeaders(GPUVAddr dma_get, std::size_t num_headers);
+
     void SetState(const CommandHeader& command_header);
 
     void CallMethod(u32 argument) const;
+    void CallMultiMethod(const u32* base_start, u32 num_methods) const;
 
     GPU& gpu;
 
-    std::vector<CommandHeader> command_headers; ///< Buffer for list of commands fetched at once
+    /// Buffer for list of commands fetched at once when they can't be read in place
+    std::vector<CommandHeader> command_headers;
 
     std::queue<CommandList> dma_pushbuffer; ///< Queue of command lists to be processed
     std::size_t dma_pushbuffer_subindex{};  ///< Index within a command list within the pushbuffer
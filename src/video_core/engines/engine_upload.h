@@ -60,6 +60,14 @@ public:
     void ProcessExec(bool is_linear);
     void ProcessData(u32 data, bool is_last_call);
 
+    /**
+     * Appends a run of words written to the data register to the upload in one copy.
+     * @param data Words of the run.
+     * @param num_words Number of words in the run.
+     * @param is_last_call Whether the last word of the run ends the upload.
+     */
+    void ProcessData(const u32* data, std::size_t num_words, bool is_last_call);
+
 private:
     u32 write_offset = 0;
     u32 copy_size = 0;
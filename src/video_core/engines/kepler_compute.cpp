@@ -8,6 +8,7 @@
 #include "core/core.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/engines/maxwell_3d.h"
+#include "video_core/gpu.h"
 #include "video_core/memory_manager.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_base.h"
@@ -50,6 +51,27 @@ void KeplerCompute::CallMethod(const GPU::MethodCall& method_call) {
     }
 }
 
+void KeplerCompute::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
+                                    u32 methods_pending) {
+    switch (method) {
+    case KEPLER_COMPUTE_REG_INDEX(data_upload): {
+        // Inline data is copied to the upload buffer as a whole instead of a word at a time.
+        regs.reg_array[method] = base_start[amount - 1];
+        const bool is_last_call = amount == methods_pending;
+        upload_state.ProcessData(base_start, amount, is_last_call);
+        if (is_last_call) {
+            system.GPU().Maxwell3D().dirty.OnMemoryWrite();
+        }
+        break;
+    }
+    default:
+        for (std::size_t i = 0; i < amount; i++) {
+            CallMethod({method, base_start[i], 0, methods_pending - static_cast<u32>(i)});
+        }
+        break;
+    }
+}
+
 Texture::FullTextureInfo KeplerCompute::GetTexture(std::size_t offset) const {
     const std::bitset<8> cbuf_mask = launch_description.const_buffer_enable_mask.Value();
     ASSERT(cbuf_mask[regs.tex_cb_index]);
@@ -71,9 +93,7 @@ Texture::FullTextureInfo KeplerCompute::GetTextureInfo(Texture::TextureHandle te
 u32 KeplerCompute::AccessConstBuffer32(ShaderType stage, u64 const_buffer, u64 offset) const {
     ASSERT(stage == ShaderType::Compute);
     const auto& buffer = launch_description.const_buffer_config[const_buffer];
-    u32 result;
-    std::memcpy(&result, memory_manager.GetPointer(buffer.Address() + offset), sizeof(u32));
-    return result;
+    return memory_manager.Read<u32>(buffer.Address() + offset);
 }
 
 SamplerDescriptor KeplerCompute::AccessBoundSampler(ShaderType stage, u64 offset) const {
@@ -101,6 +121,7 @@ void KeplerCompute::ProcessLaunch() {
     const GPUVAddr code_addr = regs.code_loc.Address() + launch_description.program_start;
     LOG_TRACE(HW_GPU, "Compute invocation launched at address 0x{:016x}", code_addr);
 
+    system.GPU().Statistics().Add(VideoCore::GPUCounter::Dispatches);
     rasterizer.DispatchCompute(code_addr);
 }
 
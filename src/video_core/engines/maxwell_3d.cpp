@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
 #include "common/assert.h"
@@ -21,7 +22,7 @@ constexpr u32 MacroRegistersStart = 0xE00;
 Maxwell3D::Maxwell3D(Core::System& system, VideoCore::RasterizerInterface& rasterizer,
                      MemoryManager& memory_manager)
     : system{system}, rasterizer{rasterizer}, memory_manager{memory_manager},
-      macro_interpreter{*this}, upload_state{memory_manager, regs.upload} {
+      macro_engine{GetMacroEngine(*this)}, upload_state{memory_manager, regs.upload} {
     InitDirtySettings();
     InitializeRegisterDefaults();
 }
@@ -96,6 +97,15 @@ void Maxwell3D::InitializeRegisterDefaults() {
     mme_inline[MAXWELL3D_REG_INDEX(draw.vertex_begin_gl)] = true;
     mme_inline[MAXWELL3D_REG_INDEX(vertex_buffer.count)] = true;
     mme_inline[MAXWELL3D_REG_INDEX(index_array.count)] = true;
+
+    draw_parameters[MAXWELL3D_REG_INDEX(draw.vertex_end_gl)] = true;
+    draw_parameters[MAXWELL3D_REG_INDEX(draw.vertex_begin_gl)] = true;
+    draw_parameters[MAXWELL3D_REG_INDEX(vertex_buffer.first)] = true;
+    draw_parameters[MAXWELL3D_REG_INDEX(vertex_buffer.count)] = true;
+    draw_parameters[MAXWELL3D_REG_INDEX(index_array.first)] = true;
+    draw_parameters[MAXWELL3D_REG_INDEX(index_array.count)] = true;
+    draw_parameters[MAXWELL3D_REG_INDEX(vb_element_base)] = true;
+    draw_parameters[MAXWELL3D_REG_INDEX(vb_base_instance)] = true;
 }
 
 #define DIRTY_REGS_POS(field_name) static_cast<u8>(offsetof(Maxwell3D::DirtyRegs, field_name))
@@ -159,8 +169,11 @@ void Maxwell3D::InitDirtySettings() {
         set_block(vertex_reg, vertex_instance_size, vi_dirty_reg);
         vi_dirty_reg++;
     }
-    set_block(MAXWELL3D_REG_INDEX(vertex_attrib_format), regs.vertex_attrib_format.size(),
-              DIRTY_REGS_POS(vertex_attrib_format));
+    constexpr u32 vertex_attrib_start = MAXWELL3D_REG_INDEX(vertex_attrib_format);
+    u8 vertex_attrib_dirty_reg = DIRTY_REGS_POS(vertex_attrib);
+    for (u32 index = 0; index < Regs::NumVertexAttributes; ++index) {
+        dirty_pointers[vertex_attrib_start + index] = vertex_attrib_dirty_reg++;
+    }
 
     // Init Shaders
     constexpr u32 shader_registers_count =
@@ -254,6 +267,28 @@ void Maxwell3D::InitDirtySettings() {
     constexpr u8 depth_bounds_values_dirty_reg = DIRTY_REGS_POS(depth_bounds_values);
     dirty_pointers[MAXWELL3D_REG_INDEX(depth_bounds[0])] = depth_bounds_values_dirty_reg;
     dirty_pointers[MAXWELL3D_REG_INDEX(depth_bounds[1])] = depth_bounds_values_dirty_reg;
+
+    // Transform Feedback
+    dirty_pointers[MAXWELL3D_REG_INDEX(tfb_enabled)] = DIRTY_REGS_POS(transform_feedback);
+
+    // Logic Operation
+    set_block(MAXWELL3D_REG_INDEX(logic_op), sizeof(regs.logic_op) / sizeof(u32),
+              DIRTY_REGS_POS(logic_op));
+
+    // Fragment Color Clamp
+    dirty_pointers[MAXWELL3D_REG_INDEX(frag_color_clamp)] = DIRTY_REGS_POS(fragment_color_clamp);
+
+    // Multisample Control
+    dirty_pointers[MAXWELL3D_REG_INDEX(multisample_control)] = DIRTY_REGS_POS(multisample_control);
+
+    // Point Size
+    dirty_pointers[MAXWELL3D_REG_INDEX(point_size)] = DIRTY_REGS_POS(point_size);
+
+    // Alpha Test
+    constexpr u8 alpha_test_dirty_reg = DIRTY_REGS_POS(alpha_test);
+    dirty_pointers[MAXWELL3D_REG_INDEX(alpha_test_enabled)] = alpha_test_dirty_reg;
+    dirty_pointers[MAXWELL3D_REG_INDEX(alpha_test_func)] = alpha_test_dirty_reg;
+    dirty_pointers[MAXWELL3D_REG_INDEX(alpha_test_ref)] = alpha_test_dirty_reg;
 }
 
 void Maxwell3D::CallMacroMethod(u32 method, std::size_t num_parameters, const u32* parameters) {
@@ -264,7 +299,8 @@ void Maxwell3D::CallMacroMethod(u32 method, std::size_t num_parameters, const u3
     const u32 entry = ((method - MacroRegistersStart) >> 1) % macro_positions.size();
 
     // Execute the current macro.
-    macro_interpreter.Execute(macro_positions[entry], num_parameters, parameters);
+    system.GPU().Statistics().Add(VideoCore::GPUCounter::MacroExecutions);
+    macro_engine->Execute(macro_positions[entry], num_parameters, parameters);
     if (mme_draw.current_mode != MMEDrawMode::Undefined) {
         FlushMMEInlineDraw();
     }
@@ -275,6 +311,10 @@ void Maxwell3D::CallMethod(const GPU::MethodCall& method_call) {
 
     const u32 method = method_call.method;
 
+    if (method < Regs::NUM_REGS && !draw_parameters[method]) {
+        FlushBatchedDraws();
+    }
+
     if (method == cb_data_state.current) {
         regs.reg_array[method] = method_call.argument;
         ProcessCBData(method_call.argument);
@@ -301,11 +341,13 @@ void Maxwell3D::CallMethod(const GPU::MethodCall& method_call) {
         }
 
         macro_params.push_back(method_call.argument);
+        macro_addresses.push_back(current_dma_segment);
 
         // Call the macro when there are no more parameters in the command buffer
         if (method_call.IsLastCall()) {
             CallMacroMethod(executing_macro, macro_params.size(), macro_params.data());
             macro_params.clear();
+            macro_addresses.clear();
         }
         return;
     }
@@ -322,8 +364,11 @@ void Maxwell3D::CallMethod(const GPU::MethodCall& method_call) {
         const std::size_t dirty_reg = dirty_pointers[method];
         if (dirty_reg) {
             dirty.regs[dirty_reg] = true;
-            if (dirty_reg >= DIRTY_REGS_POS(vertex_array) &&
-                dirty_reg < DIRTY_REGS_POS(vertex_array_buffers)) {
+            if (dirty_reg >= DIRTY_REGS_POS(vertex_attrib) &&
+                dirty_reg < DIRTY_REGS_POS(vertex_attrib_format)) {
+                dirty.vertex_attrib_format = true;
+            } else if (dirty_reg >= DIRTY_REGS_POS(vertex_array) &&
+                       dirty_reg < DIRTY_REGS_POS(vertex_array_buffers)) {
                 dirty.vertex_array_buffers = true;
             } else if (dirty_reg >= DIRTY_REGS_POS(vertex_instance) &&
                        dirty_reg < DIRTY_REGS_POS(vertex_instances)) {
@@ -399,6 +444,10 @@ void Maxwell3D::CallMethod(const GPU::MethodCall& method_call) {
         ProcessQueryGet();
         break;
     }
+    case MAXWELL3D_REG_INDEX(counter_reset): {
+        ProcessCounterReset();
+        break;
+    }
     case MAXWELL3D_REG_INDEX(condition.mode): {
         ProcessQueryCondition();
         break;
@@ -428,6 +477,67 @@ void Maxwell3D::CallMethod(const GPU::MethodCall& method_call) {
     }
 }
 
+void Maxwell3D::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
+                                u32 methods_pending) {
+    // The first word goes through the regular path, it sets up the state (const buffer upload,
+    // macro execution) the rest of the run continues.
+    CallMethod({method, base_start[0], 0, methods_pending});
+    if (amount == 1) {
+        return;
+    }
+    const u32* const data = base_start + 1;
+    const u32 count = amount - 1;
+    methods_pending--;
+
+    if (method == cb_data_state.current) {
+        regs.reg_array[method] = data[count - 1];
+        ProcessCBMultiData(data, count);
+        return;
+    }
+
+    if (method >= MacroRegistersStart && executing_macro != 0) {
+        ASSERT(method == executing_macro + 1);
+        macro_params.insert(macro_params.end(), data, data + count);
+        for (u32 i = 1; i <= count; ++i) {
+            macro_addresses.push_back(current_dma_segment + i * sizeof(u32));
+        }
+
+        // Call the macro when there are no more parameters in the command buffer
+        if (count == methods_pending) {
+            CallMacroMethod(executing_macro, macro_params.size(), macro_params.data());
+            macro_params.clear();
+            macro_addresses.clear();
+        }
+        return;
+    }
+
+    if (method == MAXWELL3D_REG_INDEX(macros.data)) {
+        regs.reg_array[method] = data[count - 1];
+        ProcessMacroMultiUpload(data, count);
+        return;
+    }
+
+    if (method == MAXWELL3D_REG_INDEX(macros.bind)) {
+        regs.reg_array[method] = data[count - 1];
+        ProcessMacroMultiBind(data, count);
+        return;
+    }
+
+    if (method == MAXWELL3D_REG_INDEX(data_upload)) {
+        regs.reg_array[method] = data[count - 1];
+        const bool is_last_call = count == methods_pending;
+        upload_state.ProcessData(data, count, is_last_call);
+        if (is_last_call) {
+            dirty.OnMemoryWrite();
+        }
+        return;
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        CallMethod({method, data[i], 0, methods_pending - static_cast<u32>(i)});
+    }
+}
+
 void Maxwell3D::StepInstance(const MMEDrawMode expected_mode, const u32 count) {
     if (mme_draw.current_mode == MMEDrawMode::Undefined) {
         if (mme_draw.gl_begin_consume) {
@@ -477,6 +587,92 @@ void Maxwell3D::CallMethodFromMME(const GPU::MethodCall& method_call) {
     }
 }
 
+void Maxwell3D::FlushBatchedDraws() {
+    if (has_batched_draws) {
+        rasterizer.FlushBatchedDraws();
+    }
+}
+
+bool Maxwell3D::DrawIndirect(const VideoCore::IndirectDrawParams& params) {
+    if (!ShouldExecute()) {
+        // The draw is skipped either way, its arguments don't matter
+        return true;
+    }
+    auto debug_context = system.GetGPUDebugContext();
+    if (debug_context) {
+        debug_context->OnEvent(Tegra::DebugContext::Event::IncomingPrimitiveBatch, nullptr);
+    }
+    const bool is_drawn = rasterizer.DrawIndirect(params);
+    if (is_drawn) {
+        system.GPU().Statistics().Add(VideoCore::GPUCounter::Draws);
+    }
+    if (debug_context) {
+        debug_context->OnEvent(Tegra::DebugContext::Event::FinishedPrimitiveBatch, nullptr);
+    }
+    return is_drawn;
+}
+
+bool Maxwell3D::AreMacroParametersContiguous(std::size_t first, std::size_t count) const {
+    ASSERT(first + count <= macro_addresses.size());
+    for (std::size_t i = 1; i < count; ++i) {
+        if (macro_addresses[first + i] != macro_addresses[first] + i * sizeof(u32)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Maxwell3D::AreMacroParametersModified(std::size_t first, std::size_t count) const {
+    ASSERT(first + count <= macro_addresses.size());
+    const std::size_t end = first + count;
+    std::size_t i = first;
+    while (i < end) {
+        // Parameters in the same run as the first one were pushed together with the macro call
+        if (macro_addresses[i] == macro_addresses[0] + i * sizeof(u32)) {
+            ++i;
+            continue;
+        }
+        const std::size_t run_begin = i;
+        const GPUVAddr run_address = macro_addresses[run_begin];
+        do {
+            ++i;
+        } while (i < end && macro_addresses[i] == run_address + (i - run_begin) * sizeof(u32));
+        if (rasterizer.IsGPUModified(run_address, (i - run_begin) * sizeof(u32))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Maxwell3D::RefreshMacroParameters(u32* parameters, std::size_t first, std::size_t count) {
+    ASSERT(first + count <= macro_addresses.size());
+    for (std::size_t i = first; i < first + count; ++i) {
+        const GPUVAddr address = macro_addresses[i];
+        if (const u8* const host_ptr = memory_manager.GetPointer(address)) {
+            rasterizer.FlushRegion(ToCacheAddr(host_ptr), sizeof(u32));
+            parameters[i] = memory_manager.Read<u32>(address);
+        }
+    }
+}
+
+bool Maxwell3D::CopyMacroParametersToConstBuffer(std::size_t first, std::size_t count,
+                                                  u32 cb_pos) {
+    ASSERT(AreMacroParametersContiguous(first, count));
+    if (cb_data_state.current != null_cb_data) {
+        FinishCBData();
+    }
+    const GPUVAddr buffer_address = regs.const_buffer.BufferAddress();
+    if (buffer_address == 0 || cb_pos + count * sizeof(u32) > regs.const_buffer.cb_size) {
+        return false;
+    }
+    if (!rasterizer.AccelerateDMABufferCopy(macro_addresses[first], buffer_address + cb_pos,
+                                            count * sizeof(u32))) {
+        return false;
+    }
+    dirty.OnMemoryWrite();
+    return true;
+}
+
 void Maxwell3D::FlushMMEInlineDraw() {
     LOG_TRACE(HW_GPU, "called, topology={}, count={}", static_cast<u32>(regs.draw.topology.Value()),
               regs.vertex_buffer.count);
@@ -495,6 +691,7 @@ void Maxwell3D::FlushMMEInlineDraw() {
 
     const bool is_indexed = mme_draw.current_mode == MMEDrawMode::Indexed;
     if (ShouldExecute()) {
+        system.GPU().Statistics().Add(VideoCore::GPUCounter::Draws);
         rasterizer.DrawMultiBatch(is_indexed);
     }
 
@@ -522,13 +719,35 @@ void Maxwell3D::FlushMMEInlineDraw() {
 void Maxwell3D::ProcessMacroUpload(u32 data) {
     ASSERT_MSG(regs.macros.upload_address < macro_memory.size(),
                "upload_address exceeded macro_memory size!");
+    macro_engine->AddCode(regs.macros.upload_address, &data, 1);
     macro_memory[regs.macros.upload_address++] = data;
 }
 
+void Maxwell3D::ProcessMacroMultiUpload(const u32* data, u32 amount) {
+    ASSERT_MSG(regs.macros.upload_address + amount <= macro_memory.size(),
+               "upload_address exceeded macro_memory size!");
+    macro_engine->AddCode(regs.macros.upload_address, data, amount);
+    std::copy(data, data + amount, macro_memory.begin() + regs.macros.upload_address);
+    regs.macros.upload_address += amount;
+}
+
 void Maxwell3D::ProcessMacroBind(u32 data) {
     macro_positions[regs.macros.entry++] = data;
 }
 
+void Maxwell3D::ProcessMacroMultiBind(const u32* data, u32 amount) {
+    ASSERT_MSG(regs.macros.entry + amount <= macro_positions.size(),
+               "macro entry exceeded macro_positions size!");
+    std::copy(data, data + amount, macro_positions.begin() + regs.macros.entry);
+    regs.macros.entry += amount;
+}
+
+void Maxwell3D::RestoreMacros(const std::array<u32, 0x80>& positions, const MacroMemory& memory) {
+    macro_positions = positions;
+    macro_memory = memory;
+    macro_engine->ClearUploads();
+}
+
 void Maxwell3D::ProcessFirmwareCall4() {
     LOG_WARNING(HW_GPU, "(STUBBED) called");
 
@@ -547,6 +766,7 @@ void Maxwell3D::ProcessQueryGet() {
                "Units other than CROP are unimplemented");
 
     u64 result = 0;
+    bool is_deferred = false;
 
     // TODO(Subv): Support the other query variables
     switch (regs.query.query_get.select) {
@@ -554,6 +774,10 @@ void Maxwell3D::ProcessQueryGet() {
         // This seems to actually write the query sequence to the query address.
         result = regs.query.query_sequence;
         break;
+    case Regs::QuerySelect::SamplesPassed:
+        // The result comes from the host GPU, the rasterizer writes it when it's read.
+        is_deferred = true;
+        break;
     default:
         result = 1;
         UNIMPLEMENTED_MSG("Unimplemented query select type {}",
@@ -577,6 +801,9 @@ void Maxwell3D::ProcessQueryGet() {
             // TODO(Subv): Find out what happens if you use a long query type but mark it as a short
             // query.
             memory_manager.Write<u32>(sequence_address, sequence);
+        } else if (is_deferred) {
+            rasterizer.Query(sequence_address, VideoCore::QueryType::SamplesPassed,
+                             system.CoreTiming().GetTicks());
         } else {
             // Write the 128-bit result structure in long mode. Note: We emulate an infinitely fast
             // GPU, this command may actually take a while to complete in real hardware due to GPU
@@ -595,8 +822,24 @@ void Maxwell3D::ProcessQueryGet() {
     }
 }
 
+void Maxwell3D::ProcessCounterReset() {
+    switch (regs.counter_reset) {
+    case Regs::CounterReset::SampleCnt:
+        rasterizer.ResetCounter(VideoCore::QueryType::SamplesPassed);
+        break;
+    default:
+        LOG_DEBUG(HW_GPU, "Unimplemented counter reset={}",
+                  static_cast<u32>(regs.counter_reset));
+        break;
+    }
+}
+
 void Maxwell3D::ProcessQueryCondition() {
     const GPUVAddr condition_address{regs.condition.Address()};
+    if (const u8* host_ptr = memory_manager.GetPointer(condition_address)) {
+        // Results of queries cached by the rasterizer are only written on demand.
+        rasterizer.FlushRegion(ToCacheAddr(host_ptr), sizeof(Regs::QueryCompare));
+    }
     switch (regs.condition.mode) {
     case Regs::ConditionMode::Always: {
         execute_on = true;
@@ -638,7 +881,7 @@ void Maxwell3D::ProcessSyncPoint() {
     const u32 sync_point = regs.sync_info.sync_point.Value();
     const u32 increment = regs.sync_info.increment.Value();
     [[maybe_unused]] const u32 cache_flush = regs.sync_info.unknown.Value();
-    if (increment) {
+    if (increment && !rasterizer.SignalSyncPoint(sync_point)) {
         system.GPU().IncrementSyncPoint(sync_point);
     }
 }
@@ -668,6 +911,7 @@ void Maxwell3D::DrawArrays() {
 
     const bool is_indexed{regs.index_array.count && !regs.vertex_buffer.count};
     if (ShouldExecute()) {
+        system.GPU().Statistics().Add(VideoCore::GPUCounter::Draws);
         rasterizer.DrawBatch(is_indexed);
     }
 
@@ -707,6 +951,16 @@ void Maxwell3D::ProcessCBData(u32 value) {
     cb_data_state.counter++;
 }
 
+void Maxwell3D::ProcessCBMultiData(const u32* data, u32 amount) {
+    const u32 id = cb_data_state.id;
+    auto& buffer = cb_data_state.buffer[id];
+    ASSERT(cb_data_state.counter + amount <= buffer.size());
+    std::memcpy(&buffer[cb_data_state.counter], data, amount * sizeof(u32));
+    // Increment the current buffer position.
+    regs.const_buffer.cb_pos = regs.const_buffer.cb_pos + amount * sizeof(u32);
+    cb_data_state.counter += amount;
+}
+
 void Maxwell3D::StartCBData(u32 method) {
     constexpr u32 first_cb_data = MAXWELL3D_REG_INDEX(const_buffer.cb_data[0]);
     cb_data_state.start_pos = regs.const_buffer.cb_pos;
@@ -797,9 +1051,7 @@ u32 Maxwell3D::AccessConstBuffer32(ShaderType stage, u64 const_buffer, u64 offse
     ASSERT(stage != ShaderType::Compute);
     const auto& shader_stage = state.shader_stages[static_cast<std::size_t>(stage)];
     const auto& buffer = shader_stage.const_buffers[const_buffer];
-    u32 result;
-    std::memcpy(&result, memory_manager.GetPointer(buffer.address + offset), sizeof(u32));
-    return result;
+    return memory_manager.Read<u32>(buffer.address + offset);
 }
 
 SamplerDescriptor Maxwell3D::AccessBoundSampler(ShaderType stage, u64 offset) const {
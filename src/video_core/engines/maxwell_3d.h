@@ -6,6 +6,7 @@
 
 #include <array>
 #include <bitset>
+#include <memory>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -19,7 +20,7 @@
 #include "video_core/engines/const_buffer_info.h"
 #include "video_core/engines/engine_upload.h"
 #include "video_core/gpu.h"
-#include "video_core/macro_interpreter.h"
+#include "video_core/macro/macro.h"
 #include "video_core/textures/texture.h"
 
 namespace Core {
@@ -32,7 +33,8 @@ class MemoryManager;
 
 namespace VideoCore {
 class RasterizerInterface;
-}
+struct IndirectDrawParams;
+} // namespace VideoCore
 
 namespace Tegra::Engines {
 
@@ -99,6 +101,27 @@ public:
             TransformFeedbackUnknown = 26,
         };
 
+        enum class CounterReset : u32 {
+            SampleCnt = 0x01,
+            Unk02 = 0x02,
+            Unk03 = 0x03,
+            Unk04 = 0x04,
+            EmittedPrimitives = 0x10, // Not tested
+            Unk11 = 0x11,
+            Unk12 = 0x12,
+            Unk13 = 0x13,
+            Unk15 = 0x15,
+            Unk16 = 0x16,
+            Unk17 = 0x17,
+            Unk18 = 0x18,
+            Unk1A = 0x1A,
+            Unk1B = 0x1B,
+            Unk1C = 0x1C,
+            Unk1D = 0x1D,
+            Unk1E = 0x1E,
+            GeneratedPrimitives = 0x1F,
+        };
+
         struct QueryCompare {
             u32 initial_sequence;
             u32 initial_mode;
@@ -829,11 +852,15 @@ public:
                     BitField<7, 1, u32> c7;
                 } clip_distance_enabled;
 
-                INSERT_UNION_PADDING_WORDS(0x1);
+                u32 samplecnt_enable;
 
                 float point_size;
 
-                INSERT_UNION_PADDING_WORDS(0x7);
+                INSERT_UNION_PADDING_WORDS(0x5);
+
+                CounterReset counter_reset;
+
+                INSERT_UNION_PADDING_WORDS(0x1);
 
                 u32 zeta_enable;
 
@@ -1173,6 +1200,8 @@ public:
                 bool null_dirty;
 
                 // Vertex Attributes
+                std::array<bool, 32> vertex_attrib;
+
                 bool vertex_attrib_format;
 
                 // Vertex Arrays
@@ -1207,6 +1236,11 @@ public:
                 bool color_mask;
                 bool polygon_offset;
                 bool depth_bounds_values;
+                bool logic_op;
+                bool fragment_color_clamp;
+                bool multisample_control;
+                bool point_size;
+                bool alpha_test;
 
                 // Complementary
                 bool viewport_transform;
@@ -1245,11 +1279,45 @@ public:
     /// Write the value to the register identified by method.
     void CallMethod(const GPU::MethodCall& method_call);
 
+    /// Write multiple values to the register identified by method.
+    void CallMultiMethod(u32 method, const u32* base_start, u32 amount, u32 methods_pending);
+
     /// Write the value to the register identified by method.
     void CallMethodFromMME(const GPU::MethodCall& method_call);
 
     void FlushMMEInlineDraw();
 
+    /// Emits the draws the rasterizer is holding back to batch them, if any.
+    void FlushBatchedDraws();
+
+    /// Draws with arguments the host GPU reads from guest GPU memory, returns false when the
+    /// rasterizer can't and the arguments have to be read on the CPU.
+    bool DrawIndirect(const VideoCore::IndirectDrawParams& params);
+
+    /// Returns the GPU address a parameter of the executing macro was fetched from.
+    GPUVAddr GetMacroAddress(std::size_t index) const {
+        return macro_addresses[index];
+    }
+
+    /// Returns true when a range of parameters of the executing macro was fetched from one run of
+    /// guest memory.
+    bool AreMacroParametersContiguous(std::size_t first, std::size_t count) const;
+
+    /**
+     * Returns true when a range of parameters of the executing macro was fetched from guest memory
+     * the host GPU has written since, the values the macro received are stale then. Parameters
+     * pushed inline with the macro call are assumed to be written by the CPU.
+     */
+    bool AreMacroParametersModified(std::size_t first, std::size_t count) const;
+
+    /// Reads a range of parameters of the executing macro again, after flushing what the host GPU
+    /// wrote to them.
+    void RefreshMacroParameters(u32* parameters, std::size_t first, std::size_t count);
+
+    /// Copies a contiguous range of parameters of the executing macro to the bound constant buffer
+    /// on the host GPU, as writes to cb_data would. Returns false when the host GPU can't.
+    bool CopyMacroParametersToConstBuffer(std::size_t first, std::size_t count, u32 cb_pos);
+
     /// Given a texture handle, returns the TSC and TIC entries.
     Texture::FullTextureInfo GetTextureInfo(Texture::TextureHandle tex_handle) const;
 
@@ -1276,6 +1344,14 @@ public:
         return macro_memory;
     }
 
+    /// Gets the start offsets of each macro in macro memory.
+    const std::array<u32, 0x80>& GetMacroPositions() const {
+        return macro_positions;
+    }
+
+    /// Replaces the uploaded macros and their start offsets, used to restore a saved state.
+    void RestoreMacros(const std::array<u32, 0x80>& positions, const MacroMemory& memory);
+
     bool ShouldExecute() const {
         return execute_on;
     }
@@ -1295,6 +1371,13 @@ public:
         u32 gl_end_count{};
     } mme_draw;
 
+    /// Set by the rasterizer while it holds draws back to emit them together. Writing a register
+    /// other than the draw parameters emits them first, as it may change their state.
+    bool has_batched_draws = false;
+
+    /// GPU address of the command word being processed, set by the DMA pusher.
+    GPUVAddr current_dma_segment = 0;
+
 private:
     void InitializeRegisterDefaults();
 
@@ -1309,6 +1392,9 @@ private:
 
     std::array<bool, Regs::NUM_REGS> mme_inline{};
 
+    /// Registers that only select which vertices are drawn, they don't end a batch of draws.
+    std::array<bool, Regs::NUM_REGS> draw_parameters{};
+
     /// Memory for macro code
     MacroMemory macro_memory;
 
@@ -1316,9 +1402,11 @@ private:
     u32 executing_macro = 0;
     /// Parameters that have been submitted to the macro call so far.
     std::vector<u32> macro_params;
+    /// GPU addresses the parameters of the macro call were fetched from.
+    std::vector<GPUVAddr> macro_addresses;
 
-    /// Interpreter for the macro codes uploaded to the GPU.
-    MacroInterpreter macro_interpreter;
+    /// Executes the macro codes uploaded to the GPU.
+    std::unique_ptr<MacroEngine> macro_engine;
 
     static constexpr u32 null_cb_data = 0xFFFFFFFF;
     struct {
@@ -1352,9 +1440,15 @@ private:
     /// Handles writes to the macro uploading register.
     void ProcessMacroUpload(u32 data);
 
+    /// Handles a run of writes to the macro uploading register.
+    void ProcessMacroMultiUpload(const u32* data, u32 amount);
+
     /// Handles writes to the macro bind register.
     void ProcessMacroBind(u32 data);
 
+    /// Handles a run of writes to the macro bind register.
+    void ProcessMacroMultiBind(const u32* data, u32 amount);
+
     /// Handles firmware blob 4
     void ProcessFirmwareCall4();
 
@@ -1364,6 +1458,9 @@ private:
     /// Handles a write to the QUERY_GET register.
     void ProcessQueryGet();
 
+    /// Handles a write to the COUNTER_RESET register.
+    void ProcessCounterReset();
+
     // Handles Conditional Rendering
     void ProcessQueryCondition();
 
@@ -1373,6 +1470,7 @@ private:
     /// Handles a write to the CB_DATA[i] register.
     void StartCBData(u32 method);
     void ProcessCBData(u32 value);
+    void ProcessCBMultiData(const u32* data, u32 amount);
     void FinishCBData();
 
     /// Handles a write to the CB_BIND register.
@@ -1442,7 +1540,9 @@ ASSERT_REG_POSITION(screen_y_control, 0x4EB);
 ASSERT_REG_POSITION(vb_element_base, 0x50D);
 ASSERT_REG_POSITION(vb_base_instance, 0x50E);
 ASSERT_REG_POSITION(clip_distance_enabled, 0x544);
+ASSERT_REG_POSITION(samplecnt_enable, 0x545);
 ASSERT_REG_POSITION(point_size, 0x546);
+ASSERT_REG_POSITION(counter_reset, 0x54C);
 ASSERT_REG_POSITION(zeta_enable, 0x54E);
 ASSERT_REG_POSITION(multisample_control, 0x54F);
 ASSERT_REG_POSITION(condition, 0x554);
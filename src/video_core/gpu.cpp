@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
+#include <type_traits>
+
 #include "common/assert.h"
 #include "common/microprofile.h"
 #include "core/core.h"
@@ -13,6 +16,7 @@
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/maxwell_dma.h"
 #include "video_core/gpu.h"
+#include "video_core/gpu_capture.h"
 #include "video_core/memory_manager.h"
 #include "video_core/renderer_base.h"
 
@@ -20,15 +24,34 @@ namespace Tegra {
 
 MICROPROFILE_DEFINE(GPU_wait, "GPU", "Wait for the GPU", MP_RGB(128, 128, 192));
 
+namespace {
+
+template <typename T>
+void AppendState(std::vector<u8>& state, const T& object) {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    const auto* const bytes = reinterpret_cast<const u8*>(&object);
+    state.insert(state.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+void ReadState(const u8*& data, T& object) {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    std::memcpy(&object, data, sizeof(T));
+    data += sizeof(T);
+}
+
+} // Anonymous namespace
+
 GPU::GPU(Core::System& system, VideoCore::RendererBase& renderer, bool is_async)
     : system{system}, renderer{renderer}, is_async{is_async} {
     auto& rasterizer{renderer.Rasterizer()};
-    memory_manager = std::make_unique<Tegra::MemoryManager>(system, rasterizer);
+    capture = std::make_unique<VideoCommon::GPUCapture>(*this);
+    memory_manager = std::make_unique<Tegra::MemoryManager>(system, rasterizer, *capture);
     dma_pusher = std::make_unique<Tegra::DmaPusher>(*this);
     maxwell_3d = std::make_unique<Engines::Maxwell3D>(system, rasterizer, *memory_manager);
     fermi_2d = std::make_unique<Engines::Fermi2D>(rasterizer);
     kepler_compute = std::make_unique<Engines::KeplerCompute>(system, rasterizer, *memory_manager);
-    maxwell_dma = std::make_unique<Engines::MaxwellDMA>(system, *memory_manager);
+    maxwell_dma = std::make_unique<Engines::MaxwellDMA>(system, rasterizer, *memory_manager);
     kepler_memory = std::make_unique<Engines::KeplerMemory>(system, *memory_manager);
 }
 
@@ -72,13 +95,16 @@ void GPU::WaitFence(u32 syncpoint_id, u32 value) const {
         return;
     }
     MICROPROFILE_SCOPE(GPU_wait);
-    while (syncpoints[syncpoint_id].load(std::memory_order_relaxed) < value) {
-    }
+    std::unique_lock lock{sync_mutex};
+    sync_cv.wait(lock, [this, syncpoint_id, value] {
+        return syncpoints[syncpoint_id].load(std::memory_order_relaxed) >= value;
+    });
 }
 
 void GPU::IncrementSyncPoint(const u32 syncpoint_id) {
     syncpoints[syncpoint_id]++;
     std::lock_guard lock{sync_mutex};
+    sync_cv.notify_all();
     if (!syncpt_interrupts[syncpoint_id].empty()) {
         u32 value = syncpoints[syncpoint_id].load();
         auto it = syncpt_interrupts[syncpoint_id].begin();
@@ -125,6 +151,44 @@ void GPU::FlushCommands() {
     renderer.Rasterizer().FlushCommands();
 }
 
+void GPU::SaveState(std::vector<u8>& state) const {
+    AppendState(state, regs);
+    AppendState(state, bound_engines);
+    AppendState(state, maxwell_3d->regs);
+    AppendState(state, maxwell_3d->state);
+    AppendState(state, maxwell_3d->GetMacroPositions());
+    AppendState(state, maxwell_3d->GetMacroMemory());
+    AppendState(state, fermi_2d->regs);
+    AppendState(state, kepler_compute->regs);
+    AppendState(state, maxwell_dma->regs);
+    AppendState(state, kepler_memory->regs);
+}
+
+bool GPU::RestoreState(const std::vector<u8>& state) {
+    std::vector<u8> current_state;
+    SaveState(current_state);
+    if (state.size() != current_state.size()) {
+        return false;
+    }
+
+    const u8* data = state.data();
+    ReadState(data, regs);
+    ReadState(data, bound_engines);
+    ReadState(data, maxwell_3d->regs);
+    ReadState(data, maxwell_3d->state);
+    std::array<u32, 0x80> macro_positions;
+    ReadState(data, macro_positions);
+    const auto macro_memory = std::make_unique<Engines::Maxwell3D::MacroMemory>();
+    ReadState(data, *macro_memory);
+    maxwell_3d->RestoreMacros(macro_positions, *macro_memory);
+    maxwell_3d->dirty.regs.fill(true);
+    ReadState(data, fermi_2d->regs);
+    ReadState(data, kepler_compute->regs);
+    ReadState(data, maxwell_dma->regs);
+    ReadState(data, kepler_memory->regs);
+    return true;
+}
+
 u32 RenderTargetBytesPerPixel(RenderTargetFormat format) {
     ASSERT(format != RenderTargetFormat::NONE);
 
@@ -228,16 +292,44 @@ void GPU::CallMethod(const MethodCall& method_call) {
 
     ASSERT(method_call.subchannel < bound_engines.size());
 
-    if (ExecuteMethodOnEngine(method_call)) {
+    FlushBatchedDraws(method_call.method, method_call.subchannel);
+
+    if (ExecuteMethodOnEngine(method_call.method)) {
         CallEngineMethod(method_call);
     } else {
         CallPullerMethod(method_call);
     }
 }
 
-bool GPU::ExecuteMethodOnEngine(const MethodCall& method_call) {
-    const auto method = static_cast<BufferMethods>(method_call.method);
-    return method >= BufferMethods::NonPullerMethods;
+void GPU::CallMultiMethod(u32 method, u32 subchannel, const u32* base_start, u32 amount,
+                          u32 methods_pending) {
+    LOG_TRACE(HW_GPU, "Processing method {:08X} on subchannel {} with {} arguments", method,
+              subchannel, amount);
+
+    ASSERT(subchannel < bound_engines.size());
+
+    FlushBatchedDraws(method, subchannel);
+
+    if (ExecuteMethodOnEngine(method)) {
+        CallEngineMultiMethod(method, subchannel, base_start, amount, methods_pending);
+    } else {
+        for (std::size_t i = 0; i < amount; i++) {
+            CallPullerMethod(
+                {method, base_start[i], subchannel, methods_pending - static_cast<u32>(i)});
+        }
+    }
+}
+
+void GPU::FlushBatchedDraws(u32 method, u32 subchannel) {
+    // The 3D engine flushes its own draws, the puller and other engines may depend on them
+    if (!ExecuteMethodOnEngine(method) || bound_engines[subchannel] != EngineID::MAXWELL_B) {
+        maxwell_3d->FlushBatchedDraws();
+    }
+}
+
+bool GPU::ExecuteMethodOnEngine(u32 method) {
+    const auto buffer_method = static_cast<BufferMethods>(method);
+    return buffer_method >= BufferMethods::NonPullerMethods;
 }
 
 void GPU::CallPullerMethod(const MethodCall& method_call) {
@@ -317,6 +409,31 @@ void GPU::CallEngineMethod(const MethodCall& method_call) {
     }
 }
 
+void GPU::CallEngineMultiMethod(u32 method, u32 subchannel, const u32* base_start, u32 amount,
+                                u32 methods_pending) {
+    const EngineID engine = bound_engines[subchannel];
+
+    switch (engine) {
+    case EngineID::FERMI_TWOD_A:
+        fermi_2d->CallMultiMethod(method, base_start, amount, methods_pending);
+        break;
+    case EngineID::MAXWELL_B:
+        maxwell_3d->CallMultiMethod(method, base_start, amount, methods_pending);
+        break;
+    case EngineID::KEPLER_COMPUTE_B:
+        kepler_compute->CallMultiMethod(method, base_start, amount, methods_pending);
+        break;
+    case EngineID::MAXWELL_DMA_COPY_A:
+        maxwell_dma->CallMultiMethod(method, base_start, amount, methods_pending);
+        break;
+    case EngineID::KEPLER_INLINE_TO_MEMORY_B:
+        kepler_memory->CallMultiMethod(method, base_start, amount, methods_pending);
+        break;
+    default:
+        UNIMPLEMENTED_MSG("Unimplemented engine");
+    }
+}
+
 void GPU::ProcessBindMethod(const MethodCall& method_call) {
     // Bind the current subchannel to the desired engine id.
     LOG_DEBUG(HW_GPU, "Binding subchannel {} to engine {}", method_call.subchannel,
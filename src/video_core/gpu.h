@@ -6,13 +6,16 @@
 
 #include <array>
 #include <atomic>
+#include <condition_variable>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <vector>
 #include "common/common_types.h"
 #include "core/hle/service/nvdrv/nvdata.h"
 #include "core/hle/service/nvflinger/buffer_queue.h"
 #include "video_core/dma_pusher.h"
+#include "video_core/gpu_statistics.h"
 
 using CacheAddr = std::uintptr_t;
 inline CacheAddr ToCacheAddr(const void* host_ptr) {
@@ -31,6 +34,10 @@ namespace VideoCore {
 class RendererBase;
 } // namespace VideoCore
 
+namespace VideoCommon {
+class GPUCapture;
+} // namespace VideoCommon
+
 namespace Tegra {
 
 enum class RenderTargetFormat : u32 {
@@ -110,6 +117,10 @@ struct FramebufferConfig {
     using TransformFlags = Service::NVFlinger::BufferQueue::BufferTransformFlags;
     TransformFlags transform_flags;
     Common::Rectangle<int> crop_rect;
+
+    /// Address of the buffer in the GPU address space, used to find or create its surface in the
+    /// texture cache. Zero when the buffer is not mapped.
+    GPUVAddr gpu_address;
 };
 
 namespace Engines {
@@ -154,6 +165,10 @@ public:
     /// Calls a GPU method.
     void CallMethod(const MethodCall& method_call);
 
+    /// Calls a GPU method with a run of arguments written to the same register.
+    void CallMultiMethod(u32 method, u32 subchannel, const u32* base_start, u32 amount,
+                         u32 methods_pending);
+
     void FlushCommands();
 
     /// Returns a reference to the Maxwell3D GPU engine.
@@ -177,6 +192,33 @@ public:
     /// Returns a reference to the GPU DMA pusher.
     Tegra::DmaPusher& DmaPusher();
 
+    /// Returns the counters of the GPU frontend and the renderer caches.
+    VideoCore::GPUStatistics& Statistics() {
+        return statistics;
+    }
+
+    /// Returns the counters of the GPU frontend and the renderer caches.
+    const VideoCore::GPUStatistics& Statistics() const {
+        return statistics;
+    }
+
+    /// Returns the recorder of GPU captures.
+    VideoCommon::GPUCapture& Capture() {
+        return *capture;
+    }
+
+    /**
+     * Appends the registers of the puller and of every engine, and the macros of the 3D engine, to
+     * a buffer. Must be called between command lists, on the thread that executes them.
+     */
+    void SaveState(std::vector<u8>& state) const;
+
+    /**
+     * Restores the state saved by SaveState, with every register of the 3D engine dirty.
+     * @returns false if the buffer doesn't hold a state saved by this version.
+     */
+    bool RestoreState(const std::vector<u8>& state);
+
     // Waits for the GPU to finish working
     virtual void WaitIdle() const = 0;
 
@@ -282,8 +324,15 @@ private:
     /// Calls a GPU engine method.
     void CallEngineMethod(const MethodCall& method_call);
 
+    /// Calls a GPU engine method with multiple arguments.
+    void CallEngineMultiMethod(u32 method, u32 subchannel, const u32* base_start, u32 amount,
+                               u32 methods_pending);
+
+    /// Emits the draws batched by the 3D engine when a method doesn't target it.
+    void FlushBatchedDraws(u32 method, u32 subchannel);
+
     /// Determines where the method should be executed.
-    bool ExecuteMethodOnEngine(const MethodCall& method_call);
+    bool ExecuteMethodOnEngine(u32 method);
 
 protected:
     std::unique_ptr<Tegra::DmaPusher> dma_pusher;
@@ -291,6 +340,10 @@ protected:
     VideoCore::RendererBase& renderer;
 
 private:
+    VideoCore::GPUStatistics statistics;
+
+    std::unique_ptr<VideoCommon::GPUCapture> capture;
+
     std::unique_ptr<Tegra::MemoryManager> memory_manager;
 
     /// Mapping of command subchannels to their bound engine ids
@@ -310,7 +363,9 @@ private:
 
     std::array<std::list<u32>, Service::Nvidia::MaxSyncPoints> syncpt_interrupts;
 
-    std::mutex sync_mutex;
+    mutable std::mutex sync_mutex;
+    /// Notified when a syncpoint is incremented, guarded by sync_mutex.
+    mutable std::condition_variable sync_cv;
 
     const bool is_async;
 };
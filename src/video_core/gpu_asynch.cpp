@@ -4,6 +4,7 @@
 
 #include "core/core.h"
 #include "core/hardware_interrupt_manager.h"
+#include "core/memory.h"
 #include "video_core/gpu_asynch.h"
 #include "video_core/gpu_thread.h"
 #include "video_core/renderer_base.h"
@@ -20,15 +21,18 @@ void GPUAsynch::Start() {
 }
 
 void GPUAsynch::PushGPUEntries(Tegra::CommandList&& entries) {
+    Memory::InvalidateWatchedWrites();
     gpu_thread.SubmitList(std::move(entries));
 }
 
 void GPUAsynch::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
+    Memory::InvalidateWatchedWrites();
     gpu_thread.SwapBuffers(framebuffer);
 }
 
 void GPUAsynch::FlushRegion(CacheAddr addr, u64 size) {
-    gpu_thread.FlushRegion(addr, size);
+    // The CPU reads the region right after, it has to hold what the GPU wrote by then
+    gpu_thread.WaitForFence(gpu_thread.FlushRegion(addr, size));
 }
 
 void GPUAsynch::InvalidateRegion(CacheAddr addr, u64 size) {
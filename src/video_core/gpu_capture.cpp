@@ -0,0 +1,238 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+
+#include "common/alignment.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "core/memory.h"
+#include "video_core/gpu.h"
+#include "video_core/gpu_capture.h"
+#include "video_core/memory_manager.h"
+#include "video_core/surface.h"
+
+namespace VideoCommon {
+
+GPUCapture::GPUCapture(Tegra::GPU& gpu) : gpu{gpu} {}
+
+GPUCapture::~GPUCapture() {
+    Stop();
+}
+
+bool GPUCapture::Start(const std::string& path, u32 frames_to_skip_, u32 num_frames) {
+    std::lock_guard lock{mutex};
+    if (state != State::Idle || num_frames == 0) {
+        return false;
+    }
+    if (!file.Open(path, "wb")) {
+        LOG_ERROR(HW_GPU, "Could not open the GPU capture file {}", path);
+        return false;
+    }
+    frames_to_skip = frames_to_skip_;
+    frames_left = num_frames;
+    state = State::Waiting;
+    return true;
+}
+
+void GPUCapture::Stop() {
+    std::lock_guard lock{mutex};
+    Finish();
+}
+
+bool GPUCapture::IsRunning() const {
+    std::lock_guard lock{mutex};
+    return state != State::Idle;
+}
+
+void GPUCapture::RecordMap(GPUVAddr gpu_addr, VAddr cpu_addr, u64 size) {
+    std::lock_guard lock{mutex};
+    const GPUVAddr end = gpu_addr + size;
+    for (auto it = mappings.lower_bound(gpu_addr); it != mappings.end() && it->first < end;) {
+        it = mappings.erase(it);
+    }
+    const MapRecord record{gpu_addr, cpu_addr, size};
+    mappings.insert_or_assign(gpu_addr, record);
+
+    if (state == State::Recording) {
+        WriteRecord(RecordType::Map, &record, sizeof(record));
+    }
+}
+
+void GPUCapture::RecordUnmap(GPUVAddr gpu_addr, u64 size) {
+    std::lock_guard lock{mutex};
+    const GPUVAddr end = gpu_addr + size;
+    for (auto it = mappings.lower_bound(gpu_addr); it != mappings.end() && it->first < end;) {
+        it = mappings.erase(it);
+    }
+
+    if (state == State::Recording) {
+        const UnmapRecord record{gpu_addr, size};
+        WriteRecord(RecordType::Unmap, &record, sizeof(record));
+    }
+}
+
+void GPUCapture::RecordRead(const Tegra::MemoryManager& memory_manager, GPUVAddr gpu_addr,
+                            std::size_t size) {
+    std::lock_guard lock{mutex};
+    if (state != State::Recording || size == 0) {
+        return;
+    }
+
+    // Pages are recorded by their CPU address, the same memory can be mapped more than once
+    const GPUVAddr end = gpu_addr + size;
+    for (GPUVAddr page = Common::AlignDown(gpu_addr, PAGE_SIZE); page < end; page += PAGE_SIZE) {
+        if (const auto cpu_addr = memory_manager.GpuToCpuAddress(page)) {
+            RecordPages(*cpu_addr, PAGE_SIZE);
+        }
+    }
+}
+
+void GPUCapture::RecordCommandList(const Tegra::CommandList& entries) {
+    std::lock_guard lock{mutex};
+    if (state == State::Recording) {
+        command_lists.push_back(entries);
+    }
+}
+
+void GPUCapture::FinishCommandLists() {
+    std::lock_guard lock{mutex};
+    if (state != State::Recording) {
+        return;
+    }
+
+    // The memory read by the command lists is replayed before them
+    WriteChangedPages();
+    for (const auto& entries : command_lists) {
+        WriteRecord(RecordType::CommandList, entries.data(),
+                    entries.size() * sizeof(Tegra::CommandListHeader));
+    }
+    command_lists.clear();
+}
+
+void GPUCapture::RecordSwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
+    std::lock_guard lock{mutex};
+    if (state == State::Waiting) {
+        if (frames_to_skip == 0) {
+            Begin();
+        } else {
+            --frames_to_skip;
+        }
+        return;
+    }
+    if (state != State::Recording) {
+        return;
+    }
+
+    if (framebuffer == nullptr) {
+        WriteRecord(RecordType::SwapBuffers, nullptr, 0);
+    } else {
+        // Presented framebuffers that were not rendered by the GPU are read from guest memory
+        const auto pixel_format =
+            VideoCore::Surface::PixelFormatFromGPUPixelFormat(framebuffer->pixel_format);
+        const u64 size = static_cast<u64>(framebuffer->stride) * framebuffer->height *
+                         VideoCore::Surface::GetBytesPerPixel(pixel_format);
+        RecordPages(framebuffer->address + framebuffer->offset, size);
+        WriteChangedPages();
+        WriteRecord(RecordType::SwapBuffers, framebuffer, sizeof(*framebuffer));
+    }
+
+    if (--frames_left == 0) {
+        Finish();
+    }
+}
+
+void GPUCapture::Begin() {
+    const FileHeader header{MAGIC, VERSION};
+    file.WriteObject(header);
+
+    std::vector<u8> engine_state;
+    gpu.SaveState(engine_state);
+    WriteRecord(RecordType::EngineState, engine_state.data(), engine_state.size());
+
+    for (const auto& [gpu_addr, record] : mappings) {
+        WriteRecord(RecordType::Map, &record, sizeof(record));
+    }
+
+    page_hashes.clear();
+    checked_pages.clear();
+    changed_pages.clear();
+    command_lists.clear();
+    state = State::Recording;
+    is_recording.store(true, std::memory_order_relaxed);
+    LOG_INFO(HW_GPU, "GPU capture started");
+}
+
+void GPUCapture::Finish() {
+    if (state == State::Idle) {
+        return;
+    }
+    if (state == State::Recording) {
+        LOG_INFO(HW_GPU, "GPU capture finished, {} bytes written", file.Tell());
+    }
+    is_recording.store(false, std::memory_order_relaxed);
+    state = State::Idle;
+    file.Close();
+
+    page_hashes.clear();
+    checked_pages.clear();
+    changed_pages.clear();
+    command_lists.clear();
+}
+
+void GPUCapture::RecordPages(VAddr cpu_addr, std::size_t size) {
+    const VAddr end = cpu_addr + size;
+    for (VAddr page = Common::AlignDown(cpu_addr, PAGE_SIZE); page < end; page += PAGE_SIZE) {
+        if (!checked_pages.insert(page).second) {
+            continue;
+        }
+        if (!Memory::IsValidVirtualAddress(page)) {
+            continue;
+        }
+        const u8* const pointer = Memory::GetPointer(page);
+
+        const u64 hash = Common::ComputeXXH3(pointer, PAGE_SIZE);
+        const auto [it, is_new] = page_hashes.try_emplace(page, hash);
+        if (!is_new && it->second == hash) {
+            continue;
+        }
+        it->second = hash;
+        changed_pages.insert_or_assign(page, std::vector<u8>(pointer, pointer + PAGE_SIZE));
+    }
+}
+
+void GPUCapture::WriteRecord(RecordType type, const void* data, std::size_t size) {
+    const RecordHeader header{type, 0, size};
+    file.WriteObject(header);
+    if (size != 0) {
+        file.WriteBytes(static_cast<const u8*>(data), size);
+    }
+}
+
+void GPUCapture::WriteChangedPages() {
+    std::vector<u8> record;
+    VAddr next_page = 0;
+    const auto flush = [&] {
+        if (!record.empty()) {
+            WriteRecord(RecordType::Memory, record.data(), record.size());
+            record.clear();
+        }
+    };
+
+    for (const auto& [page, contents] : changed_pages) {
+        if (record.empty() || page != next_page) {
+            flush();
+            record.resize(sizeof(VAddr));
+            std::memcpy(record.data(), &page, sizeof(VAddr));
+        }
+        record.insert(record.end(), contents.begin(), contents.end());
+        next_page = page + PAGE_SIZE;
+    }
+    flush();
+
+    changed_pages.clear();
+    checked_pages.clear();
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,161 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "video_core/dma_pusher.h"
+
+namespace Tegra {
+struct FramebufferConfig;
+class GPU;
+class MemoryManager;
+} // namespace Tegra
+
+namespace VideoCommon {
+
+/**
+ * Records the command lists the GPU executes over a span of frames, along with the guest memory
+ * they read, so that they can be replayed without emulating the CPU. The capture starts with the
+ * registers of the engines and the GPU mappings, memory is recorded lazily: a page is written to
+ * the capture when a command list reads it for the first time, and again whenever its contents
+ * changed since. Textures rendered before the capture started are replayed from guest memory.
+ */
+class GPUCapture {
+public:
+    static constexpr u32 MAGIC = 0x43504759; ///< "YGPC"
+    static constexpr u32 VERSION = 2;
+
+    /// Granularity of the recorded memory.
+    static constexpr u64 PAGE_BITS = 12;
+    static constexpr u64 PAGE_SIZE = 1ULL << PAGE_BITS;
+    static constexpr u64 PAGE_MASK = PAGE_SIZE - 1;
+
+    enum class RecordType : u32 {
+        EngineState,
+        Map,
+        Unmap,
+        Memory,
+        CommandList,
+        SwapBuffers,
+    };
+
+    struct FileHeader {
+        u32 magic;
+        u32 version;
+    };
+    static_assert(sizeof(FileHeader) == 0x8, "FileHeader has incorrect size.");
+
+    /// Header of each record, followed by size bytes of payload.
+    struct RecordHeader {
+        RecordType type;
+        u32 reserved;
+        u64 size;
+    };
+    static_assert(sizeof(RecordHeader) == 0x10, "RecordHeader has incorrect size.");
+
+    struct MapRecord {
+        GPUVAddr gpu_addr;
+        VAddr cpu_addr;
+        u64 size;
+    };
+    static_assert(sizeof(MapRecord) == 0x18, "MapRecord has incorrect size.");
+
+    struct UnmapRecord {
+        GPUVAddr gpu_addr;
+        u64 size;
+    };
+    static_assert(sizeof(UnmapRecord) == 0x10, "UnmapRecord has incorrect size.");
+
+    // Memory records hold the CPU address of the data followed by the data, command lists hold
+    // their CommandListHeaders, swaps hold the FramebufferConfig or nothing when there is none.
+
+    explicit GPUCapture(Tegra::GPU& gpu);
+    ~GPUCapture();
+
+    /**
+     * Starts a capture, it begins once the given number of frames has been presented.
+     * @returns false if a capture is running or the file could not be opened.
+     */
+    bool Start(const std::string& path, u32 frames_to_skip, u32 num_frames);
+
+    /// Stops the running capture, the capture file holds the frames presented until now.
+    void Stop();
+
+    /// Whether a capture has been started and has not finished yet.
+    bool IsRunning() const;
+
+    /// Whether the executed commands are being recorded.
+    bool IsRecording() const {
+        return is_recording.load(std::memory_order_relaxed);
+    }
+
+    /// Keeps track of a new GPU mapping, called on every mapping whether capturing or not.
+    void RecordMap(GPUVAddr gpu_addr, VAddr cpu_addr, u64 size);
+
+    /// Keeps track of an unmapped GPU range, called on every unmap whether capturing or not.
+    void RecordUnmap(GPUVAddr gpu_addr, u64 size);
+
+    /// Records the contents of a range read by the GPU, if they changed since it was recorded.
+    void RecordRead(const Tegra::MemoryManager& memory_manager, GPUVAddr gpu_addr,
+                    std::size_t size);
+
+    /// Records a command list before the DMA pusher executes it.
+    void RecordCommandList(const Tegra::CommandList& entries);
+
+    /// Writes the command lists recorded since the last call, once the DMA pusher executed them.
+    void FinishCommandLists();
+
+    /// Records a presented frame, on the GPU thread. Begins and ends the running capture.
+    void RecordSwapBuffers(const Tegra::FramebufferConfig* framebuffer);
+
+private:
+    enum class State {
+        Idle,
+        Waiting,
+        Recording,
+    };
+
+    void Begin();
+    void Finish();
+
+    /// Records the pages of a CPU range that changed since they were last recorded.
+    void RecordPages(VAddr cpu_addr, std::size_t size);
+
+    void WriteRecord(RecordType type, const void* data, std::size_t size);
+
+    /// Writes the pages that changed since the last call, merging the ones that are adjacent.
+    void WriteChangedPages();
+
+    Tegra::GPU& gpu;
+
+    mutable std::mutex mutex;
+    std::atomic_bool is_recording{false};
+    State state{State::Idle};
+    FileUtil::IOFile file;
+    u32 frames_to_skip{};
+    u32 frames_left{};
+
+    /// Mappings of the GPU address space, kept to start captures from the current mappings.
+    std::map<GPUVAddr, MapRecord> mappings;
+
+    /// Hashes of the recorded contents of each CPU page.
+    std::unordered_map<VAddr, u64> page_hashes;
+    /// Pages checked since the last write, each is only checked once per batch of command lists.
+    std::unordered_set<VAddr> checked_pages;
+    /// Changed pages and their contents, as read, waiting to be written.
+    std::map<VAddr, std::vector<u8>> changed_pages;
+    std::vector<Tegra::CommandList> command_lists;
+};
+
+} // namespace VideoCommon
@@ -0,0 +1,239 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#include "common/alignment.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/vm_manager.h"
+#include "core/memory.h"
+#include "video_core/gpu.h"
+#include "video_core/gpu_replay.h"
+#include "video_core/memory_manager.h"
+
+namespace VideoCommon {
+
+namespace {
+
+constexpr u64 PAGE_SIZE = GPUCapture::PAGE_SIZE;
+
+template <typename T>
+T ReadPayload(const u8* payload) {
+    T value;
+    std::memcpy(&value, payload, sizeof(T));
+    return value;
+}
+
+} // Anonymous namespace
+
+std::unique_ptr<GPUReplay> GPUReplay::Open(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(HW_GPU, "Could not open the GPU capture {}", path);
+        return nullptr;
+    }
+
+    std::vector<u8> data(file.GetSize());
+    if (file.ReadBytes(data.data(), data.size()) != data.size()) {
+        LOG_ERROR(HW_GPU, "Could not read the GPU capture {}", path);
+        return nullptr;
+    }
+
+    GPUCapture::FileHeader header{};
+    if (data.size() < sizeof(header)) {
+        LOG_ERROR(HW_GPU, "{} is not a GPU capture", path);
+        return nullptr;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != GPUCapture::MAGIC || header.version != GPUCapture::VERSION) {
+        LOG_ERROR(HW_GPU, "{} is not a GPU capture", path);
+        return nullptr;
+    }
+
+    std::vector<Record> records;
+    std::size_t offset = sizeof(header);
+    while (offset + sizeof(GPUCapture::RecordHeader) <= data.size()) {
+        const auto record = ReadPayload<GPUCapture::RecordHeader>(data.data() + offset);
+        offset += sizeof(record);
+        if (record.size > data.size() - offset) {
+            // The capture was cut short, the last record is dropped
+            LOG_WARNING(HW_GPU, "GPU capture {} is truncated", path);
+            break;
+        }
+        records.push_back({record.type, offset, static_cast<std::size_t>(record.size)});
+        offset += record.size;
+    }
+
+    return std::unique_ptr<GPUReplay>(new GPUReplay(std::move(data), std::move(records)));
+}
+
+GPUReplay::GPUReplay(std::vector<u8> data_, std::vector<Record> records_)
+    : data{std::move(data_)}, records{std::move(records_)} {
+    num_frames = std::count_if(records.begin(), records.end(), [](const Record& record) {
+        return record.type == GPUCapture::RecordType::SwapBuffers;
+    });
+}
+
+GPUReplay::~GPUReplay() = default;
+
+bool GPUReplay::Initialize(Core::System& system_) {
+    system = &system_;
+
+    // Every guest range the capture maps or writes gets host memory, adjacent ranges share it
+    std::vector<std::pair<VAddr, VAddr>> ranges;
+    for (const Record& record : records) {
+        const u8* const payload = data.data() + record.offset;
+        if (record.type == GPUCapture::RecordType::Map) {
+            const auto map = ReadPayload<GPUCapture::MapRecord>(payload);
+            ranges.emplace_back(map.cpu_addr, map.cpu_addr + map.size);
+        } else if (record.type == GPUCapture::RecordType::Memory && record.size > sizeof(VAddr)) {
+            const auto cpu_addr = ReadPayload<VAddr>(payload);
+            ranges.emplace_back(cpu_addr, cpu_addr + record.size - sizeof(VAddr));
+        }
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    regions.clear();
+    VAddr region_end = 0;
+    for (const auto& [begin, end] : ranges) {
+        const VAddr aligned_begin = Common::AlignDown(begin, PAGE_SIZE);
+        const VAddr aligned_end = Common::AlignUp(end, PAGE_SIZE);
+        if (regions.empty() || aligned_begin > region_end) {
+            regions.push_back({aligned_begin, {}});
+        }
+        region_end = std::max(region_end, aligned_end);
+        regions.back().memory.resize(region_end - regions.back().base);
+    }
+
+    auto& vm_manager = system->CurrentProcess()->VMManager();
+    for (Region& region : regions) {
+        const auto result = vm_manager.MapBackingMemory(region.base, region.memory.data(),
+                                                        region.memory.size(),
+                                                        Kernel::MemoryState::Heap);
+        if (result.Failed()) {
+            LOG_ERROR(HW_GPU, "Could not map the guest memory at {:016X}-{:016X}", region.base,
+                      region.base + region.memory.size());
+            return false;
+        }
+    }
+
+    LOG_INFO(HW_GPU, "Replaying {} frames from {} records, {} guest memory regions", num_frames,
+             records.size(), regions.size());
+    return true;
+}
+
+bool GPUReplay::ReplayFrame() {
+    auto& gpu = system->GPU();
+    auto& memory_manager = gpu.MemoryManager();
+
+    while (next_record < records.size()) {
+        const Record& record = records[next_record++];
+        const u8* const payload = data.data() + record.offset;
+
+        switch (record.type) {
+        case GPUCapture::RecordType::EngineState:
+            gpu.WaitIdle();
+            if (!gpu.RestoreState({payload, payload + record.size})) {
+                LOG_ERROR(HW_GPU, "The engine state of the capture does not match this build");
+            }
+            break;
+        case GPUCapture::RecordType::Map: {
+            const auto map = ReadPayload<GPUCapture::MapRecord>(payload);
+            gpu.WaitIdle();
+            memory_manager.MapBufferEx(map.cpu_addr, map.gpu_addr, map.size);
+            mappings.insert_or_assign(map.gpu_addr, map.size);
+            break;
+        }
+        case GPUCapture::RecordType::Unmap: {
+            const auto unmap = ReadPayload<GPUCapture::UnmapRecord>(payload);
+            gpu.WaitIdle();
+            memory_manager.UnmapBuffer(unmap.gpu_addr, unmap.size);
+            mappings.erase(unmap.gpu_addr);
+            break;
+        }
+        case GPUCapture::RecordType::Memory:
+            if (record.size > sizeof(VAddr)) {
+                gpu.WaitIdle();
+                WriteMemory(ReadPayload<VAddr>(payload), payload + sizeof(VAddr),
+                            record.size - sizeof(VAddr));
+            }
+            break;
+        case GPUCapture::RecordType::CommandList: {
+            Tegra::CommandList entries(record.size / sizeof(Tegra::CommandListHeader));
+            std::memcpy(entries.data(), payload, entries.size() * sizeof(Tegra::CommandListHeader));
+            gpu.PushGPUEntries(std::move(entries));
+            break;
+        }
+        case GPUCapture::RecordType::SwapBuffers:
+            if (record.size == sizeof(Tegra::FramebufferConfig)) {
+                const auto framebuffer = ReadPayload<Tegra::FramebufferConfig>(payload);
+                gpu.SwapBuffers(&framebuffer);
+            } else {
+                gpu.SwapBuffers(nullptr);
+            }
+            return true;
+        default:
+            LOG_WARNING(HW_GPU, "Unknown GPU capture record type {}",
+                        static_cast<u32>(record.type));
+            break;
+        }
+    }
+
+    // The capture starts over from the mappings it was started with
+    gpu.WaitIdle();
+    for (const auto& [gpu_addr, size] : mappings) {
+        memory_manager.UnmapBuffer(gpu_addr, size);
+    }
+    mappings.clear();
+    next_record = 0;
+    return false;
+}
+
+void GPUReplay::WriteMemory(VAddr cpu_addr, const u8* source, std::size_t size) {
+    // Only the pages that changed are written, so that the caches keep the others
+    std::size_t run_begin = 0;
+    std::size_t run_size = 0;
+    const auto flush = [&] {
+        if (run_size != 0) {
+            Memory::WriteBlock(cpu_addr + run_begin, source + run_begin, run_size);
+            run_size = 0;
+        }
+    };
+
+    for (std::size_t offset = 0; offset < size; offset += PAGE_SIZE) {
+        const std::size_t page_size = std::min<std::size_t>(PAGE_SIZE, size - offset);
+        const u8* const pointer = GetBackingPointer(cpu_addr + offset);
+        if (pointer != nullptr && std::memcmp(pointer, source + offset, page_size) == 0) {
+            flush();
+            continue;
+        }
+        if (run_size == 0) {
+            run_begin = offset;
+        }
+        run_size += page_size;
+    }
+    flush();
+}
+
+u8* GPUReplay::GetBackingPointer(VAddr cpu_addr) {
+    const auto it = std::upper_bound(
+        regions.begin(), regions.end(), cpu_addr,
+        [](VAddr addr, const Region& region) { return addr < region.base; });
+    if (it == regions.begin()) {
+        return nullptr;
+    }
+    Region& region = *std::prev(it);
+    if (cpu_addr - region.base >= region.memory.size()) {
+        return nullptr;
+    }
+    return region.memory.data() + (cpu_addr - region.base);
+}
+
+} // namespace VideoCommon
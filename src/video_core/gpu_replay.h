@@ -0,0 +1,83 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/gpu_capture.h"
+
+namespace Core {
+class System;
+}
+
+namespace VideoCommon {
+
+/**
+ * Replays a capture written by GPUCapture into the GPU of a system that runs no application. The
+ * guest memory of the capture is backed by host memory mapped into the current process, the
+ * recorded pages are written to it before the command lists that read them.
+ */
+class GPUReplay {
+public:
+    /// Reads a capture, returns nullptr if the file could not be read or is not a capture.
+    static std::unique_ptr<GPUReplay> Open(const std::string& path);
+
+    ~GPUReplay();
+
+    /**
+     * Maps the guest memory used by the capture into the current process of the system, which
+     * must have been loaded without an application.
+     * @returns false if the memory could not be mapped.
+     */
+    bool Initialize(Core::System& system);
+
+    /// Number of frames presented by the capture.
+    std::size_t GetNumFrames() const {
+        return num_frames;
+    }
+
+    /**
+     * Submits the records of the next frame to the GPU, up to its presentation.
+     * @returns false once the last frame was replayed, the next call starts over from the first.
+     */
+    bool ReplayFrame();
+
+private:
+    struct Record {
+        GPUCapture::RecordType type;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    /// Range of guest memory backed by host memory.
+    struct Region {
+        VAddr base;
+        std::vector<u8> memory;
+    };
+
+    GPUReplay(std::vector<u8> data, std::vector<Record> records);
+
+    /// Writes the recorded pages of a memory record that differ from the current contents.
+    void WriteMemory(VAddr cpu_addr, const u8* source, std::size_t size);
+
+    /// Host pointer backing a guest address, nullptr if the capture does not use the address.
+    u8* GetBackingPointer(VAddr cpu_addr);
+
+    Core::System* system = nullptr;
+    std::vector<u8> data;
+    std::vector<Record> records;
+    std::size_t num_frames = 0;
+    std::size_t next_record = 0;
+
+    std::vector<Region> regions;
+    /// Mappings made by the replay, undone when it starts over.
+    std::map<GPUVAddr, u64> mappings;
+};
+
+} // namespace VideoCommon
@@ -0,0 +1,53 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+#include "video_core/gpu_statistics.h"
+
+namespace VideoCore {
+
+namespace {
+
+constexpr std::array<const char*, NumGPUCounters> COUNTER_NAMES{
+    "draws",
+    "dispatches",
+    "pushbuffer_words",
+    "macro_executions",
+    "texture_cache_hits",
+    "texture_cache_misses",
+    "texture_cache_recycles",
+    "buffer_upload_bytes",
+    "shader_cache_misses",
+    "flushes",
+    "invalidations",
+};
+
+} // Anonymous namespace
+
+const char* GetGPUCounterName(GPUCounter counter) {
+    return COUNTER_NAMES[static_cast<std::size_t>(counter)];
+}
+
+void GPUStatistics::EndFrame() {
+    std::lock_guard lock{frame_mutex};
+    ++last_frame.number;
+    for (std::size_t i = 0; i < NumGPUCounters; ++i) {
+        last_frame.values[i] = counters[i].exchange(0, std::memory_order_relaxed);
+    }
+    if (frame_callback) {
+        frame_callback(last_frame);
+    }
+}
+
+GPUStatistics::Frame GPUStatistics::GetLastFrame() const {
+    std::lock_guard lock{frame_mutex};
+    return last_frame;
+}
+
+void GPUStatistics::SetFrameCallback(FrameCallback callback) {
+    std::lock_guard lock{frame_mutex};
+    frame_callback = std::move(callback);
+}
+
+} // namespace VideoCore
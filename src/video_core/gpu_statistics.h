@@ -0,0 +1,77 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/// Events counted by the GPU frontend and the caches of the renderer.
+enum class GPUCounter : std::size_t {
+    Draws,
+    Dispatches,
+    PushBufferWords,
+    MacroExecutions,
+    TextureCacheHits,
+    TextureCacheMisses,
+    TextureCacheRecycles,
+    BufferUploadBytes,
+    ShaderCacheMisses,
+    Flushes,
+    Invalidations,
+    Count,
+};
+
+constexpr std::size_t NumGPUCounters = static_cast<std::size_t>(GPUCounter::Count);
+
+/// Returns the name of a counter, as used in tables and CSV headers.
+const char* GetGPUCounterName(GPUCounter counter);
+
+/**
+ * Registry of the GPU counters. Counters are accumulated while a frame is emulated and moved to
+ * the last frame's values when it ends. Adding to a counter is thread-safe and lock-free.
+ */
+class GPUStatistics {
+public:
+    struct Frame {
+        /// Number of the frame, counting from one, zero before any frame ended
+        u64 number{};
+        std::array<u64, NumGPUCounters> values{};
+
+        u64 operator[](GPUCounter counter) const {
+            return values[static_cast<std::size_t>(counter)];
+        }
+    };
+
+    using FrameCallback = std::function<void(const Frame&)>;
+
+    void Add(GPUCounter counter, u64 amount = 1) {
+        counters[static_cast<std::size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    /// Ends the current frame, its counters become the last frame's values.
+    void EndFrame();
+
+    /// Returns the counters of the last frame that ended.
+    Frame GetLastFrame() const;
+
+    /// Sets a callback invoked with the counters of each frame when it ends, from the thread
+    /// that ends it.
+    void SetFrameCallback(FrameCallback callback);
+
+private:
+    std::array<std::atomic<u64>, NumGPUCounters> counters{};
+
+    mutable std::mutex frame_mutex;
+    Frame last_frame;
+    FrameCallback frame_callback;
+};
+
+} // namespace VideoCore
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "core/memory.h"
+#include "video_core/gpu_capture.h"
 #include "video_core/gpu_synch.h"
 #include "video_core/renderer_base.h"
 
@@ -15,23 +17,31 @@ GPUSynch::~GPUSynch() = default;
 void GPUSynch::Start() {}
 
 void GPUSynch::PushGPUEntries(Tegra::CommandList&& entries) {
+    Memory::InvalidateWatchedWrites();
+    std::lock_guard lock{mutex};
     dma_pusher->Push(std::move(entries));
     dma_pusher->DispatchCalls();
 }
 
 void GPUSynch::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
+    Memory::InvalidateWatchedWrites();
+    std::lock_guard lock{mutex};
+    Capture().RecordSwapBuffers(framebuffer);
     renderer.SwapBuffers(framebuffer);
 }
 
 void GPUSynch::FlushRegion(CacheAddr addr, u64 size) {
+    std::lock_guard lock{mutex};
     renderer.Rasterizer().FlushRegion(addr, size);
 }
 
 void GPUSynch::InvalidateRegion(CacheAddr addr, u64 size) {
+    std::lock_guard lock{mutex};
     renderer.Rasterizer().InvalidateRegion(addr, size);
 }
 
 void GPUSynch::FlushAndInvalidateRegion(CacheAddr addr, u64 size) {
+    std::lock_guard lock{mutex};
     renderer.Rasterizer().FlushAndInvalidateRegion(addr, size);
 }
 
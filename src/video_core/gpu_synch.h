@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "video_core/gpu.h"
 
 namespace VideoCore {
@@ -29,6 +31,11 @@ public:
 protected:
     void TriggerCpuInterrupt([[maybe_unused]] u32 syncpoint_id,
                              [[maybe_unused]] u32 value) const override {}
+
+private:
+    /// Serializes the CPU threads calling into the GPU, the caches don't lock on their own. It's
+    /// recursive because GPU work can invalidate the memory it writes.
+    std::recursive_mutex mutex;
 };
 
 } // namespace VideoCommon
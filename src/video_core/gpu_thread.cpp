@@ -2,53 +2,112 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <iterator>
+
 #include "common/assert.h"
 #include "common/microprofile.h"
+#include "common/thread_placement.h"
 #include "core/core.h"
 #include "core/frontend/scope_acquire_window_context.h"
+#include "core/perf_stats.h"
+#include "core/settings.h"
 #include "video_core/dma_pusher.h"
 #include "video_core/gpu.h"
+#include "video_core/gpu_capture.h"
 #include "video_core/gpu_thread.h"
 #include "video_core/renderer_base.h"
 
 namespace VideoCommon::GPUThread {
 
+/// Granularity in bits of the regions tracked for pending flushes.
+constexpr u64 FLUSH_PAGE_BITS = 12;
+/// Number of pending flush entries that triggers pruning the signaled ones.
+constexpr std::size_t MAX_PENDING_FLUSHES = 1024;
+
+/// Applies the invalidations requested by the CPU since the last drain.
+static void DrainInvalidations(VideoCore::RasterizerInterface& rasterizer, SynchState& state) {
+    if (!state.has_invalidations.load(std::memory_order_acquire)) {
+        return;
+    }
+    boost::icl::interval_set<CacheAddr> ranges;
+    {
+        std::lock_guard lock{state.invalidations_mutex};
+        ranges.swap(state.invalidations);
+        state.has_invalidations.store(false, std::memory_order_relaxed);
+    }
+    // The rasterizer is called outside of the lock, CPU writes don't wait on the caches
+    for (const auto& range : ranges) {
+        rasterizer.InvalidateRegion(range.lower(), range.upper() - range.lower());
+    }
+}
+
+/// Pops the next command. While syncpoint increments are pending, the host GPU work they wait
+/// for is polled instead of blocking on the queue, so they are released as soon as it finishes.
+static void PopCommand(VideoCore::RasterizerInterface& rasterizer, SynchState& state,
+                       CommandDataContainer& next) {
+    while (rasterizer.HasPendingSyncPoints()) {
+        if (state.queue.Pop(next)) {
+            return;
+        }
+        rasterizer.ReleaseSyncPoints(true);
+    }
+    state.queue.PopWait(next);
+}
+
 /// Runs the GPU thread
 static void RunThread(VideoCore::RendererBase& renderer, Tegra::DmaPusher& dma_pusher,
-                      SynchState& state) {
+                      SynchState& state, Core::PerfStats& perf_stats, GPUCapture& capture) {
     MicroProfileOnThreadCreate("GpuThread");
+    Common::ApplyThreadPlacement(Common::ThreadRole::Gpu);
 
     // Wait for first GPU command before acquiring the window context
-    while (state.queue.Empty())
-        ;
+    CommandDataContainer next;
+    state.queue.PopWait(next);
 
     // If emulation was stopped during disk shader loading, abort before trying to acquire context
-    if (!state.is_running) {
+    if (std::holds_alternative<EndProcessingCommand>(next.data)) {
         return;
     }
 
     Core::Frontend::ScopeAcquireWindowContext acquire_context{renderer.GetRenderWindow()};
 
-    CommandDataContainer next;
-    while (state.is_running) {
-        while (!state.queue.Empty()) {
-            state.queue.Pop(next);
-            if (const auto submit_list = std::get_if<SubmitListCommand>(&next.data)) {
-                dma_pusher.Push(std::move(submit_list->entries));
-                dma_pusher.DispatchCalls();
-            } else if (const auto data = std::get_if<SwapBuffersCommand>(&next.data)) {
-                renderer.SwapBuffers(data->framebuffer ? &*data->framebuffer : nullptr);
-            } else if (const auto data = std::get_if<FlushRegionCommand>(&next.data)) {
-                renderer.Rasterizer().FlushRegion(data->addr, data->size);
-            } else if (const auto data = std::get_if<InvalidateRegionCommand>(&next.data)) {
-                renderer.Rasterizer().InvalidateRegion(data->addr, data->size);
-            } else if (std::holds_alternative<EndProcessingCommand>(next.data)) {
-                return;
+    u64 fence = 0;
+    auto busy_start = Core::PerfStats::Clock::now();
+    while (true) {
+        // Pending invalidations were requested before this command was pushed.
+        DrainInvalidations(renderer.Rasterizer(), state);
+
+        if (const auto submit_list = std::get_if<SubmitListCommand>(&next.data)) {
+            dma_pusher.Push(std::move(submit_list->entries));
+            dma_pusher.DispatchCalls();
+        } else if (const auto data = std::get_if<SwapBuffersCommand>(&next.data)) {
+            const auto framebuffer = data->framebuffer ? &*data->framebuffer : nullptr;
+            capture.RecordSwapBuffers(framebuffer);
+            const bool is_stale = state.queued_swaps.fetch_sub(1) > 1;
+            if (is_stale && Settings::values.use_mailbox_presentation) {
+                // Emulation is ahead of presentation, only the newest frame is shown
+                renderer.DropFrame(framebuffer);
             } else {
-                UNREACHABLE();
+                renderer.SwapBuffers(framebuffer);
             }
-            state.signaled_fence.store(next.fence);
+        } else if (const auto data = std::get_if<FlushRegionCommand>(&next.data)) {
+            renderer.Rasterizer().FlushRegion(data->addr, data->size);
+        } else if (const auto data = std::get_if<InvalidateRegionCommand>(&next.data)) {
+            renderer.Rasterizer().InvalidateRegion(data->addr, data->size);
+        } else if (std::holds_alternative<EndProcessingCommand>(next.data)) {
+            return;
+        } else {
+            UNREACHABLE();
         }
+        state.signaled_fence.store(++fence);
+        renderer.Rasterizer().ReleaseSyncPoints(false);
+
+        const auto idle_start = Core::PerfStats::Clock::now();
+        perf_stats.AddTime(Core::PerfCategory::GpuBusy, idle_start - busy_start);
+        PopCommand(renderer.Rasterizer(), state, next);
+        busy_start = Core::PerfStats::Clock::now();
+        perf_stats.AddTime(Core::PerfCategory::GpuIdle, busy_start - idle_start);
     }
 }
 
@@ -65,24 +124,70 @@ ThreadManager::~ThreadManager() {
 }
 
 void ThreadManager::StartThread(VideoCore::RendererBase& renderer, Tegra::DmaPusher& dma_pusher) {
-    thread = std::thread{RunThread, std::ref(renderer), std::ref(dma_pusher), std::ref(state)};
+    thread = std::thread{RunThread, std::ref(renderer), std::ref(dma_pusher), std::ref(state),
+                         std::ref(system.GetPerfStats()), std::ref(system.GPU().Capture())};
 }
 
 void ThreadManager::SubmitList(Tegra::CommandList&& entries) {
-    PushCommand(SubmitListCommand(std::move(entries)));
+    const u64 fence{PushCommand(SubmitListCommand(std::move(entries)))};
+    u64 last_submit{state.last_submit_fence.load(std::memory_order_relaxed)};
+    while (last_submit < fence &&
+           !state.last_submit_fence.compare_exchange_weak(last_submit, fence)) {
+    }
 }
 
 void ThreadManager::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
+    state.queued_swaps.fetch_add(1);
     PushCommand(SwapBuffersCommand(framebuffer ? *framebuffer
                                                : std::optional<const Tegra::FramebufferConfig>{}));
 }
 
-void ThreadManager::FlushRegion(CacheAddr addr, u64 size) {
-    PushCommand(FlushRegionCommand(addr, size));
+u64 ThreadManager::FlushRegion(CacheAddr addr, u64 size) {
+    if (size == 0) {
+        return state.last_fence.load();
+    }
+    const u64 page_start{addr >> FLUSH_PAGE_BITS};
+    const u64 page_end{(addr + size - 1) >> FLUSH_PAGE_BITS};
+
+    std::lock_guard lock{state.pending_flushes_mutex};
+
+    // Guest code polling GPU written memory requests the same flush repeatedly. A queued flush
+    // of these pages with no GPU work submitted after it already covers this request.
+    const u64 signaled{state.signaled_fence.load()};
+    const u64 last_submit{state.last_submit_fence.load()};
+    u64 reused_fence{};
+    for (u64 page = page_start; page <= page_end; ++page) {
+        const auto it = state.pending_flushes.find(page);
+        if (it == state.pending_flushes.end() || it->second <= signaled ||
+            it->second < last_submit) {
+            reused_fence = 0;
+            break;
+        }
+        reused_fence = std::max(reused_fence, it->second);
+    }
+    if (reused_fence != 0) {
+        return reused_fence;
+    }
+
+    const u64 fence{PushCommand(FlushRegionCommand(addr, size))};
+    if (state.pending_flushes.size() >= MAX_PENDING_FLUSHES) {
+        for (auto it = state.pending_flushes.begin(); it != state.pending_flushes.end();) {
+            it = it->second <= signaled ? state.pending_flushes.erase(it) : std::next(it);
+        }
+    }
+    for (u64 page = page_start; page <= page_end; ++page) {
+        state.pending_flushes[page] = fence;
+    }
+    return fence;
 }
 
 void ThreadManager::InvalidateRegion(CacheAddr addr, u64 size) {
-    system.Renderer().Rasterizer().InvalidateRegion(addr, size);
+    if (size == 0) {
+        return;
+    }
+    std::lock_guard lock{state.invalidations_mutex};
+    state.invalidations += boost::icl::interval<CacheAddr>::right_open(addr, addr + size);
+    state.has_invalidations.store(true, std::memory_order_release);
 }
 
 void ThreadManager::FlushAndInvalidateRegion(CacheAddr addr, u64 size) {
@@ -90,14 +195,27 @@ void ThreadManager::FlushAndInvalidateRegion(CacheAddr addr, u64 size) {
     InvalidateRegion(addr, size);
 }
 
-void ThreadManager::WaitIdle() const {
-    while (state.last_fence > state.signaled_fence.load(std::memory_order_relaxed)) {
+bool ThreadManager::IsFenceSignaled(u64 fence) const {
+    return state.signaled_fence.load(std::memory_order_acquire) >= fence;
+}
+
+void ThreadManager::WaitForFence(u64 fence) const {
+    while (!IsFenceSignaled(fence)) {
+        std::this_thread::yield();
     }
 }
 
+void ThreadManager::WaitIdle() const {
+    WaitForFence(state.last_fence.load());
+}
+
 u64 ThreadManager::PushCommand(CommandData&& command_data) {
-    const u64 fence{++state.last_fence};
-    state.queue.Push(CommandDataContainer(std::move(command_data), fence));
+    const u64 fence{state.queue.Push(CommandDataContainer(std::move(command_data)))};
+
+    // Producers may finish pushing out of order, only ever move the last fence forward.
+    u64 last_fence{state.last_fence.load(std::memory_order_relaxed)};
+    while (last_fence < fence && !state.last_fence.compare_exchange_weak(last_fence, fence)) {
+    }
     return fence;
 }
 
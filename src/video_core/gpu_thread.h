@@ -9,9 +9,12 @@
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <unordered_map>
 #include <variant>
 
-#include "common/threadsafe_queue.h"
+#include <boost/icl/interval_set.hpp>
+
+#include "common/bounded_threadsafe_queue.h"
 #include "video_core/gpu.h"
 
 namespace Tegra {
@@ -75,21 +78,41 @@ using CommandData =
 struct CommandDataContainer {
     CommandDataContainer() = default;
 
-    CommandDataContainer(CommandData&& data, u64 next_fence)
-        : data{std::move(data)}, fence{next_fence} {}
+    explicit CommandDataContainer(CommandData&& data) : data{std::move(data)} {}
 
     CommandData data;
-    u64 fence{};
 };
 
 /// Struct used to synchronize the GPU thread
 struct SynchState final {
-    std::atomic_bool is_running{true};
+    /// Maximum number of commands in flight, pushing blocks when the GPU thread falls this far
+    /// behind.
+    static constexpr std::size_t QUEUE_CAPACITY = 1024;
 
-    using CommandQueue = Common::SPSCQueue<CommandDataContainer>;
+    using CommandQueue = Common::BoundedMPSCQueue<CommandDataContainer, QUEUE_CAPACITY>;
     CommandQueue queue;
-    u64 last_fence{};
+    /// Fence of the most recent command pushed. Fences are the position of the command in the
+    /// queue, so the GPU thread signals them in increasing order.
+    std::atomic<u64> last_fence{};
     std::atomic<u64> signaled_fence{};
+
+    /// Fence of the most recent command list submitted.
+    std::atomic<u64> last_submit_fence{};
+
+    /// Number of swaps pushed and not processed yet. A swap with newer ones queued behind it
+    /// presents a stale frame.
+    std::atomic<u32> queued_swaps{};
+
+    /// Regions written by the CPU, applied by the GPU thread before its next command. Writes that
+    /// overlap or touch are merged as they are added, so each region is invalidated once.
+    boost::icl::interval_set<CacheAddr> invalidations;
+    std::mutex invalidations_mutex;
+    /// True while invalidations has regions, lets the GPU thread skip the lock when it's empty.
+    std::atomic_bool has_invalidations{};
+
+    /// Fences of the flushes still in flight, keyed by the page they flush.
+    std::unordered_map<u64, u64> pending_flushes;
+    std::mutex pending_flushes_mutex;
 };
 
 /// Class used to manage the GPU thread
@@ -107,15 +130,28 @@ public:
     /// Swap buffers (render frame)
     void SwapBuffers(const Tegra::FramebufferConfig* framebuffer);
 
-    /// Notify rasterizer that any caches of the specified region should be flushed to Switch memory
-    void FlushRegion(CacheAddr addr, u64 size);
-
-    /// Notify rasterizer that any caches of the specified region should be invalidated
+    /**
+     * Notify rasterizer that any caches of the specified region should be flushed to Switch memory.
+     * A flush of the same pages that is still queued behind no newer GPU work is reused.
+     * @returns The fence signaled when the region has been flushed.
+     */
+    u64 FlushRegion(CacheAddr addr, u64 size);
+
+    /**
+     * Notify rasterizer that any caches of the specified region should be invalidated.
+     * The invalidation is applied by the GPU thread before it processes its next command.
+     */
     void InvalidateRegion(CacheAddr addr, u64 size);
 
     /// Notify rasterizer that any caches of the specified region should be flushed and invalidated
     void FlushAndInvalidateRegion(CacheAddr addr, u64 size);
 
+    /// Returns true when the GPU thread has processed the command with the specified fence.
+    bool IsFenceSignaled(u64 fence) const;
+
+    /// Waits until the GPU thread has processed the command with the specified fence.
+    void WaitForFence(u64 fence) const;
+
     // Wait until the gpu thread is idle.
     void WaitIdle() const;
 
@@ -0,0 +1,217 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+
+#include <boost/functional/hash.hpp>
+
+#include "common/assert.h"
+#include "common/cityhash.h"
+#include "core/settings.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_hle.h"
+#include "video_core/macro/macro_interpreter.h"
+#ifdef ARCHITECTURE_x86_64
+#include "video_core/macro/macro_jit_x64.h"
+#endif
+
+namespace Tegra {
+
+namespace Macro {
+
+MacroCapture::MacroCapture(const Engines::Maxwell3D& maxwell3d) : maxwell3d{maxwell3d} {}
+
+void MacroCapture::Send(u32 method, u32 argument) {
+    calls.emplace_back(method, argument);
+}
+
+u32 MacroCapture::Read(u32 method) const {
+    const auto it = std::find_if(calls.rbegin(), calls.rend(),
+                                 [method](const auto& call) { return call.first == method; });
+    if (it != calls.rend()) {
+        return it->second;
+    }
+    return maxwell3d.GetRegisterValue(method);
+}
+
+void MacroUploads::Add(u32 address, const u32* data, std::size_t count) {
+    if (count == 0) {
+        return;
+    }
+    const u32 end = address + static_cast<u32>(count);
+
+    // Uploads usually come a word at a time, extend the last one while they follow it
+    if (last_upload) {
+        auto& last = uploads[*last_upload];
+        if (*last_upload + last.size() != address) {
+            last_upload.reset();
+        }
+    }
+    if (!last_upload) {
+        last_upload = address;
+        uploads[address].clear();
+    }
+
+    for (auto it = uploads.begin(); it != uploads.end();) {
+        const u32 begin = it->first;
+        std::vector<u32>& code = it->second;
+        if (begin == *last_upload || begin >= end || begin + code.size() <= address) {
+            ++it;
+            continue;
+        }
+        if (begin < address) {
+            code.resize(address - begin);
+            ++it;
+        } else {
+            it = uploads.erase(it);
+        }
+    }
+
+    auto& last = uploads[*last_upload];
+    last.insert(last.end(), data, data + count);
+}
+
+void MacroUploads::Clear() {
+    uploads.clear();
+    last_upload.reset();
+}
+
+std::optional<u64> MacroUploads::GetHash(u32 offset) const {
+    auto it = uploads.upper_bound(offset);
+    if (it == uploads.begin()) {
+        return std::nullopt;
+    }
+    --it;
+    const std::vector<u32>& code = it->second;
+    const u32 position = offset - it->first;
+    if (position >= code.size()) {
+        return std::nullopt;
+    }
+    // Same hash as boost::hash_value of the code vector, which the known hashes were taken with
+    return boost::hash_range(code.begin() + position, code.end());
+}
+
+} // namespace Macro
+
+MacroEngine::MacroEngine(Engines::Maxwell3D& maxwell3d)
+    : maxwell3d{maxwell3d}, hle_macros{std::make_unique<HLEMacro>(maxwell3d)} {}
+
+MacroEngine::~MacroEngine() {
+    if (hle_hits != 0 || hle_misses != 0) {
+        LOG_INFO(HW_GPU, "Macro HLE: {} hits, {} misses", hle_hits, hle_misses);
+    }
+}
+
+void MacroEngine::Execute(u32 offset, std::size_t num_parameters, const u32* parameters) {
+    auto it = macro_cache.find(offset);
+    if (it == macro_cache.end()) {
+        const auto& memory = maxwell3d.GetMacroMemory();
+        const std::vector<u32> code = ReadMacroCode(memory.data(), memory.size(), offset);
+        const u64 hash = Common::CityHash64(reinterpret_cast<const char*>(code.data()),
+                                            code.size() * sizeof(u32));
+
+        CachedMacro* program = nullptr;
+        if (const auto upload_hash = uploads.GetHash(offset);
+            upload_hash && !Settings::values.disable_macro_hle) {
+            auto [hle_it, is_new] = hle_programs.try_emplace(*upload_hash);
+            if (is_new) {
+                hle_it->second = hle_macros->GetHLEProgram(*upload_hash);
+                if (!hle_it->second) {
+                    LOG_DEBUG(HW_GPU,
+                              "Macro {:016X} with {} instructions has no HLE implementation",
+                              *upload_hash, code.size());
+                }
+            }
+            program = hle_it->second.get();
+        }
+        const bool is_hle = program != nullptr;
+        if (!is_hle) {
+            auto& compiled = compiled_macros[hash];
+            if (!compiled) {
+                compiled = Compile(code);
+            }
+            program = compiled.get();
+        }
+        it = macro_cache.emplace(offset, CacheInfo{program, is_hle}).first;
+    }
+
+    const CacheInfo& cache_info = it->second;
+    if (cache_info.is_hle) {
+        ++hle_hits;
+    } else {
+        ++hle_misses;
+    }
+    cache_info.program->Execute(parameters, num_parameters, nullptr);
+}
+
+void MacroEngine::ClearCode() {
+    if (!macro_cache.empty()) {
+        macro_cache.clear();
+    }
+}
+
+void MacroEngine::AddCode(u32 address, const u32* data, std::size_t count) {
+    uploads.Add(address, data, count);
+    ClearCode();
+}
+
+void MacroEngine::ClearUploads() {
+    uploads.Clear();
+    ClearCode();
+}
+
+std::vector<u32> ReadMacroCode(const u32* memory, std::size_t memory_size, u32 offset) {
+    if (offset >= memory_size) {
+        LOG_ERROR(HW_GPU, "Macro offset {} is out of macro memory", offset);
+        return {};
+    }
+    const std::size_t available = memory_size - offset;
+
+    // Instructions in the delay slot of an exit are executed without following their successors,
+    // track them separately so the code of the next macro isn't considered part of this one.
+    std::vector<bool> visited(available);
+    std::vector<bool> visited_delay_slot(available);
+    std::vector<std::pair<u32, bool>> pending{{0, false}};
+    std::size_t size = 0;
+
+    while (!pending.empty()) {
+        const auto [pc, is_exit_delay_slot] = pending.back();
+        pending.pop_back();
+        if (pc >= available) {
+            continue;
+        }
+        auto& visited_set = is_exit_delay_slot ? visited_delay_slot : visited;
+        if (visited_set[pc]) {
+            continue;
+        }
+        visited_set[pc] = true;
+        size = std::max<std::size_t>(size, pc + 1);
+        if (is_exit_delay_slot) {
+            continue;
+        }
+
+        const Macro::Opcode opcode{memory[offset + pc]};
+        if (opcode.operation == Macro::Operation::Branch) {
+            const s64 target = static_cast<s64>(pc) + opcode.immediate;
+            if (target >= 0) {
+                pending.emplace_back(static_cast<u32>(target), false);
+            }
+        }
+        pending.emplace_back(pc + 1, opcode.is_exit != 0);
+    }
+
+    return {memory + offset, memory + offset + size};
+}
+
+std::unique_ptr<MacroEngine> GetMacroEngine(Engines::Maxwell3D& maxwell3d) {
+#ifdef ARCHITECTURE_x86_64
+    if (!Settings::values.disable_macro_jit) {
+        return std::make_unique<MacroJITx64>(maxwell3d);
+    }
+#endif
+    return std::make_unique<MacroInterpreter>(maxwell3d);
+}
+
+} // namespace Tegra
@@ -0,0 +1,251 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/bit_field.h"
+#include "common/common_types.h"
+
+namespace Tegra {
+namespace Engines {
+class Maxwell3D;
+}
+
+class HLEMacro;
+
+namespace Macro {
+
+constexpr std::size_t NUM_MACRO_REGISTERS = 8;
+
+enum class Operation : u32 {
+    ALU = 0,
+    AddImmediate = 1,
+    ExtractInsert = 2,
+    ExtractShiftLeftImmediate = 3,
+    ExtractShiftLeftRegister = 4,
+    Read = 5,
+    Unused = 6, // This operation doesn't seem to be a valid encoding.
+    Branch = 7,
+};
+
+enum class ALUOperation : u32 {
+    Add = 0,
+    AddWithCarry = 1,
+    Subtract = 2,
+    SubtractWithBorrow = 3,
+    // Operations 4-7 don't seem to be valid encodings.
+    Xor = 8,
+    Or = 9,
+    And = 10,
+    AndNot = 11,
+    Nand = 12
+};
+
+enum class ResultOperation : u32 {
+    IgnoreAndFetch = 0,
+    Move = 1,
+    MoveAndSetMethod = 2,
+    FetchAndSend = 3,
+    MoveAndSend = 4,
+    FetchAndSetMethod = 5,
+    MoveAndSetMethodFetchAndSend = 6,
+    MoveAndSetMethodSend = 7
+};
+
+enum class BranchCondition : u32 {
+    Zero = 0,
+    NotZero = 1,
+};
+
+union Opcode {
+    u32 raw;
+    BitField<0, 3, Operation> operation;
+    BitField<4, 3, ResultOperation> result_operation;
+    BitField<4, 1, BranchCondition> branch_condition;
+    // If set on a branch, then the branch doesn't have a delay slot.
+    BitField<5, 1, u32> branch_annul;
+    BitField<7, 1, u32> is_exit;
+    BitField<8, 3, u32> dst;
+    BitField<11, 3, u32> src_a;
+    BitField<14, 3, u32> src_b;
+    // The signed immediate overlaps the second source operand and the alu operation.
+    BitField<14, 18, s32> immediate;
+
+    BitField<17, 5, ALUOperation> alu_operation;
+
+    // Bitfield instructions data
+    BitField<17, 5, u32> bf_src_bit;
+    BitField<22, 5, u32> bf_size;
+    BitField<27, 5, u32> bf_dst_bit;
+
+    u32 GetBitfieldMask() const {
+        return (1 << bf_size) - 1;
+    }
+
+    s32 GetBranchTarget() const {
+        return static_cast<s32>(immediate * sizeof(u32));
+    }
+};
+
+union MethodAddress {
+    u32 raw;
+    BitField<0, 12, u32> address;
+    BitField<12, 6, u32> increment;
+};
+
+/**
+ * Records the side effects of a macro instead of applying them to the engine. Register reads
+ * observe the values sent earlier in the same execution, falling back to the engine's registers.
+ */
+class MacroCapture {
+public:
+    explicit MacroCapture(const Engines::Maxwell3D& maxwell3d);
+
+    /// Records a method call done by the macro.
+    void Send(u32 method, u32 argument);
+
+    /// Reads a register as the macro would observe it if the recorded calls had been applied.
+    u32 Read(u32 method) const;
+
+    /// Returns the recorded (method, argument) pairs in submission order.
+    const std::vector<std::pair<u32, u32>>& GetCalls() const {
+        return calls;
+    }
+
+private:
+    const Engines::Maxwell3D& maxwell3d;
+    std::vector<std::pair<u32, u32>> calls;
+};
+
+/**
+ * Keeps the code of each upload to macro memory, which is what identifies the known macros. A macro
+ * is hashed from its first word to the end of the upload it was part of, as the known hashes were
+ * taken from the drivers that upload their macros together.
+ */
+class MacroUploads {
+public:
+    /**
+     * Records words written to macro memory. Words that follow the last upload extend it, others
+     * start a new upload and drop what they overwrite of the older ones.
+     * @param address Offset in words of the first word in macro memory.
+     * @param data Words written.
+     * @param count Number of words.
+     */
+    void Add(u32 address, const u32* data, std::size_t count);
+
+    /// Forgets all the uploads, for macro memory restored as a whole.
+    void Clear();
+
+    /// Returns the hash of the macro at an offset of macro memory, nullopt if no upload has it.
+    std::optional<u64> GetHash(u32 offset) const;
+
+private:
+    /// Words of each upload, keyed by the offset of its first word.
+    std::map<u32, std::vector<u32>> uploads;
+    /// Offset of the upload the next contiguous words extend.
+    std::optional<u32> last_upload;
+};
+
+} // namespace Macro
+
+/// A macro program ready for execution, produced by a MacroEngine.
+class CachedMacro {
+public:
+    virtual ~CachedMacro() = default;
+
+    /**
+     * Executes the macro code with the specified input parameters.
+     * @param parameters The parameters of the macro.
+     * @param num_parameters Number of parameters, at least one.
+     * @param capture When not null, method calls are recorded here instead of sent to the engine.
+     */
+    virtual void Execute(const u32* parameters, std::size_t num_parameters,
+                         Macro::MacroCapture* capture) = 0;
+};
+
+/// Caches the programs built from the code in macro memory and executes them.
+class MacroEngine {
+public:
+    explicit MacroEngine(Engines::Maxwell3D& maxwell3d);
+    virtual ~MacroEngine();
+
+    /**
+     * Executes the macro starting at the specified offset of macro memory, building it first if it
+     * hasn't been executed since the last upload.
+     * @param offset Offset in words of the macro in macro memory.
+     * @param num_parameters Number of parameters.
+     * @param parameters The parameters of the macro.
+     */
+    void Execute(u32 offset, std::size_t num_parameters, const u32* parameters);
+
+    /// Drops the programs bound to macro memory offsets, called when macro memory is written.
+    void ClearCode();
+
+    /**
+     * Records words written to macro memory and drops the programs bound to its offsets.
+     * @param address Offset in words of the first word in macro memory.
+     * @param data Words written.
+     * @param count Number of words.
+     */
+    void AddCode(u32 address, const u32* data, std::size_t count);
+
+    /// Forgets the uploads that identify the known macros, for macro memory restored as a whole.
+    void ClearUploads();
+
+    /// Returns the number of macro executions that ran a native replacement.
+    u64 GetHLEHits() const {
+        return hle_hits;
+    }
+
+    /// Returns the number of macro executions that ran the macro code.
+    u64 GetHLEMisses() const {
+        return hle_misses;
+    }
+
+protected:
+    /// Builds a program from the code of a macro.
+    virtual std::unique_ptr<CachedMacro> Compile(const std::vector<u32>& code) = 0;
+
+    Engines::Maxwell3D& maxwell3d;
+
+private:
+    struct CacheInfo {
+        CachedMacro* program{};
+        bool is_hle{};
+    };
+
+    /// Programs bound to each macro memory offset, invalidated on upload.
+    std::unordered_map<u32, CacheInfo> macro_cache;
+    /// Programs keyed by the hash of their code, shared by identical macros.
+    std::unordered_map<u64, std::unique_ptr<CachedMacro>> compiled_macros;
+    /// Native replacements keyed by the hash of their upload, null for the unknown macros.
+    std::unordered_map<u64, std::unique_ptr<CachedMacro>> hle_programs;
+
+    /// Native replacements of known macros.
+    std::unique_ptr<HLEMacro> hle_macros;
+    Macro::MacroUploads uploads;
+    u64 hle_hits = 0;
+    u64 hle_misses = 0;
+};
+
+/**
+ * Reads the code of a macro by following every path reachable from its first instruction.
+ * @param memory Macro memory.
+ * @param memory_size Size in words of macro memory.
+ * @param offset Offset in words of the macro in macro memory.
+ * @returns The words from the first instruction up to the last reachable one.
+ */
+std::vector<u32> ReadMacroCode(const u32* memory, std::size_t memory_size, u32 offset);
+
+/// Creates the macro engine selected by the user settings and supported by the host.
+std::unique_ptr<MacroEngine> GetMacroEngine(Engines::Maxwell3D& maxwell3d);
+
+} // namespace Tegra
@@ -0,0 +1,206 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/macro/macro_hle.h"
+#include "video_core/rasterizer_interface.h"
+
+MICROPROFILE_DEFINE(MacroHLE, "GPU", "Execute macro HLE", MP_RGB(128, 192, 192));
+
+namespace Tegra {
+
+namespace {
+
+using Maxwell = Engines::Maxwell3D;
+
+/// Register holding the mask applied to the instance count by the draw macros.
+constexpr u32 INSTANCE_COUNT_MASK_REGISTER = 0xD1B;
+/// Offset in the driver constant buffer where the indexed draw macro stores its draw parameters.
+constexpr u32 DRAW_PARAMETERS_CB_POS = 0x640;
+
+/// Writes a register through the same path the macro would use, keeping dirty tracking intact.
+void WriteRegister(Maxwell& maxwell3d, u32 method, u32 value) {
+    maxwell3d.CallMethodFromMME({method, value});
+}
+
+void SetTopology(Maxwell& maxwell3d, u32 value) {
+    maxwell3d.regs.draw.topology.Assign(
+        static_cast<Maxwell::Regs::PrimitiveTopology>(value & 0x3ffffff));
+}
+
+/// Draws the current vertex or index array as one instanced batch.
+void DrawInstanced(Maxwell& maxwell3d, bool is_indexed, u32 instance_count) {
+    auto& mme_draw = maxwell3d.mme_draw;
+    mme_draw.current_mode =
+        is_indexed ? Maxwell::MMEDrawMode::Indexed : Maxwell::MMEDrawMode::Array;
+    mme_draw.instance_count = instance_count;
+    mme_draw.gl_end_count = instance_count;
+    mme_draw.instance_mode = instance_count > 1;
+    maxwell3d.FlushMMEInlineDraw();
+}
+
+/// Returns true when the host GPU can read the arguments of a draw macro in place, they have to
+/// be laid out like its indirect draw commands from the second parameter on.
+bool CanDrawIndirect(const Maxwell& maxwell3d, std::size_t num_arguments) {
+    // The host GPU can't mask the instance count it reads
+    return maxwell3d.GetRegisterValue(INSTANCE_COUNT_MASK_REGISTER) == 0xFFFFFFFF &&
+           maxwell3d.AreMacroParametersContiguous(1, num_arguments);
+}
+
+/// Draws with the arguments of a draw macro read in place by the host GPU.
+bool DrawIndirect(Maxwell& maxwell3d, bool is_indexed, std::size_t num_arguments) {
+    VideoCore::IndirectDrawParams params{};
+    params.is_indexed = is_indexed;
+    params.arguments_address = maxwell3d.GetMacroAddress(1);
+    params.max_draw_count = 1;
+    params.stride = static_cast<u32>(num_arguments * sizeof(u32));
+    return maxwell3d.DrawIndirect(params);
+}
+
+/**
+ * Copies the parameters of a draw macro to storage when some were fetched from memory the host
+ * GPU wrote, with its topology read again. Returns false when the parameters are current.
+ */
+template <std::size_t N>
+bool CopyStaleParameters(Maxwell& maxwell3d, const u32* parameters, std::array<u32, N>& storage) {
+    if (!maxwell3d.AreMacroParametersModified(0, N)) {
+        return false;
+    }
+    std::copy_n(parameters, N, storage.begin());
+    maxwell3d.RefreshMacroParameters(storage.data(), 0, 1);
+    return true;
+}
+
+/// Instanced indexed draw.
+void HLE_771BB18C62444DA0(Maxwell& maxwell3d, const u32* parameters, std::size_t num_parameters) {
+    ASSERT(num_parameters >= 6);
+    // The element base comes before the first index, unlike in the indirect commands of the host
+    std::array<u32, 6> storage;
+    if (CopyStaleParameters(maxwell3d, parameters, storage)) {
+        maxwell3d.RefreshMacroParameters(storage.data(), 1, 5);
+        parameters = storage.data();
+    }
+    const u32 instance_count = maxwell3d.GetRegisterValue(INSTANCE_COUNT_MASK_REGISTER) &
+                               parameters[2];
+    if (instance_count == 0) {
+        return;
+    }
+    SetTopology(maxwell3d, parameters[0]);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(vb_element_base), parameters[3]);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(index_array.first), parameters[4]);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(vb_base_instance), parameters[5]);
+    maxwell3d.regs.index_array.count = parameters[1];
+    maxwell3d.regs.vertex_buffer.count = 0;
+    DrawInstanced(maxwell3d, true, instance_count);
+}
+
+/// Instanced non-indexed draw.
+void HLE_0D61FC9FAAC9FCAD(Maxwell& maxwell3d, const u32* parameters, std::size_t num_parameters) {
+    ASSERT(num_parameters >= 5);
+    // Count, instance count, first vertex and base instance, as in the host commands
+    std::array<u32, 5> storage;
+    if (CopyStaleParameters(maxwell3d, parameters, storage)) {
+        SetTopology(maxwell3d, storage[0]);
+        if (CanDrawIndirect(maxwell3d, 4) && DrawIndirect(maxwell3d, false, 4)) {
+            return;
+        }
+        maxwell3d.RefreshMacroParameters(storage.data(), 1, 4);
+        parameters = storage.data();
+    }
+    const u32 instance_count = maxwell3d.GetRegisterValue(INSTANCE_COUNT_MASK_REGISTER) &
+                               parameters[2];
+    if (instance_count == 0) {
+        return;
+    }
+    SetTopology(maxwell3d, parameters[0]);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(vertex_buffer.first), parameters[3]);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(vb_base_instance), parameters[4]);
+    maxwell3d.regs.vertex_buffer.count = parameters[1];
+    maxwell3d.regs.index_array.count = 0;
+    DrawInstanced(maxwell3d, false, instance_count);
+}
+
+/// Instanced indexed draw that also exposes the base vertex and instance to the shaders.
+void HLE_0217920100488FF7(Maxwell& maxwell3d, const u32* parameters, std::size_t num_parameters) {
+    ASSERT(num_parameters >= 6);
+    // Count, instance count, first index, element base and base instance, as in the host commands
+    std::array<u32, 6> storage;
+    if (CopyStaleParameters(maxwell3d, parameters, storage)) {
+        SetTopology(maxwell3d, storage[0]);
+        if (CanDrawIndirect(maxwell3d, 5) &&
+            maxwell3d.CopyMacroParametersToConstBuffer(4, 2, DRAW_PARAMETERS_CB_POS) &&
+            DrawIndirect(maxwell3d, true, 5)) {
+            return;
+        }
+        maxwell3d.RefreshMacroParameters(storage.data(), 1, 5);
+        parameters = storage.data();
+    }
+    const u32 instance_count = maxwell3d.GetRegisterValue(INSTANCE_COUNT_MASK_REGISTER) &
+                               parameters[2];
+    if (instance_count == 0) {
+        return;
+    }
+    const u32 element_base = parameters[4];
+    const u32 base_instance = parameters[5];
+    SetTopology(maxwell3d, parameters[0]);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(index_array.first), parameters[3]);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(vb_element_base), element_base);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(vb_base_instance), base_instance);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(const_buffer.cb_pos), DRAW_PARAMETERS_CB_POS);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(const_buffer.cb_data[0]), element_base);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(const_buffer.cb_data[0]), base_instance);
+    maxwell3d.regs.index_array.count = parameters[1];
+    maxwell3d.regs.vertex_buffer.count = 0;
+    DrawInstanced(maxwell3d, true, instance_count);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(vb_element_base), 0);
+    WriteRegister(maxwell3d, MAXWELL3D_REG_INDEX(vb_base_instance), 0);
+}
+
+/// Hashes of the macro code from its first word to the end of its upload, see MacroUploads.
+constexpr std::array<std::pair<u64, HLEFunction>, 3> hle_funcs{{
+    {0x771BB18C62444DA0, &HLE_771BB18C62444DA0},
+    {0x0D61FC9FAAC9FCAD, &HLE_0D61FC9FAAC9FCAD},
+    {0x0217920100488FF7, &HLE_0217920100488FF7},
+}};
+
+} // Anonymous namespace
+
+HLEMacro::HLEMacro(Engines::Maxwell3D& maxwell3d) : maxwell3d{maxwell3d} {}
+
+HLEMacro::~HLEMacro() = default;
+
+std::unique_ptr<CachedMacro> HLEMacro::GetHLEProgram(u64 hash) const {
+    const auto it = std::find_if(hle_funcs.cbegin(), hle_funcs.cend(),
+                                 [hash](const auto& pair) { return pair.first == hash; });
+    if (it == hle_funcs.cend()) {
+        return nullptr;
+    }
+    return std::make_unique<HLEMacroImpl>(maxwell3d, it->second);
+}
+
+bool HLEMacro::HasHLEProgram(u64 hash) {
+    return std::any_of(hle_funcs.cbegin(), hle_funcs.cend(),
+                       [hash](const auto& pair) { return pair.first == hash; });
+}
+
+HLEMacroImpl::HLEMacroImpl(Engines::Maxwell3D& maxwell3d, HLEFunction func)
+    : maxwell3d{maxwell3d}, func{func} {}
+
+HLEMacroImpl::~HLEMacroImpl() = default;
+
+void HLEMacroImpl::Execute(const u32* parameters, std::size_t num_parameters,
+                           Macro::MacroCapture* capture) {
+    MICROPROFILE_SCOPE(MacroHLE);
+    ASSERT_MSG(capture == nullptr, "HLE macros can't be captured");
+    func(maxwell3d, parameters, num_parameters);
+}
+
+} // namespace Tegra
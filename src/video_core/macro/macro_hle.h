@@ -0,0 +1,54 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+
+#include "common/common_types.h"
+#include "video_core/macro/macro.h"
+
+namespace Tegra {
+namespace Engines {
+class Maxwell3D;
+}
+
+/// Native replacement of a macro. Receives the same parameters as the macro code.
+using HLEFunction = void (*)(Engines::Maxwell3D& maxwell3d, const u32* parameters,
+                             std::size_t num_parameters);
+
+/// Table of the macros recognized by the hash of their code that have a native implementation.
+class HLEMacro {
+public:
+    explicit HLEMacro(Engines::Maxwell3D& maxwell3d);
+    ~HLEMacro();
+
+    /**
+     * Looks up the native replacement of a macro.
+     * @param hash Hash of the macro code.
+     * @returns The native program or null when the macro isn't recognized.
+     */
+    std::unique_ptr<CachedMacro> GetHLEProgram(u64 hash) const;
+
+    /// Returns whether a macro hash has a native replacement.
+    static bool HasHLEProgram(u64 hash);
+
+private:
+    Engines::Maxwell3D& maxwell3d;
+};
+
+class HLEMacroImpl final : public CachedMacro {
+public:
+    explicit HLEMacroImpl(Engines::Maxwell3D& maxwell3d, HLEFunction func);
+    ~HLEMacroImpl() override;
+
+    void Execute(const u32* parameters, std::size_t num_parameters,
+                 Macro::MacroCapture* capture) override;
+
+private:
+    Engines::Maxwell3D& maxwell3d;
+    HLEFunction func;
+};
+
+} // namespace Tegra
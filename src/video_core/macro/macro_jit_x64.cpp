@@ -0,0 +1,494 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include <xbyak.h>
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "core/settings.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/macro/macro_interpreter.h"
+#include "video_core/macro/macro_jit_x64.h"
+
+MICROPROFILE_DEFINE(MacroJitCompile, "GPU", "Compile macro JIT", MP_RGB(173, 255, 47));
+MICROPROFILE_DEFINE(MacroJitExecute, "GPU", "Execute macro JIT", MP_RGB(255, 255, 0));
+
+namespace Tegra {
+
+namespace {
+
+// Host registers holding the JIT state, they are callee-saved in both the System V and Win64 ABIs
+const Xbyak::Reg64 STATE = Xbyak::util::rbx;
+const Xbyak::Reg64 PARAMETERS = Xbyak::util::r12;
+const Xbyak::Reg64 PARAMETERS_END = Xbyak::util::r13;
+const Xbyak::Reg32 RESULT = Xbyak::util::ebp;
+
+#ifdef _WIN32
+const Xbyak::Reg64 ABI_PARAM1 = Xbyak::util::rcx;
+const Xbyak::Reg64 ABI_PARAM2 = Xbyak::util::rdx;
+const Xbyak::Reg64 ABI_PARAM3 = Xbyak::util::r8;
+constexpr std::size_t ABI_SHADOW_SPACE = 32;
+#else
+const Xbyak::Reg64 ABI_PARAM1 = Xbyak::util::rdi;
+const Xbyak::Reg64 ABI_PARAM2 = Xbyak::util::rsi;
+const Xbyak::Reg64 ABI_PARAM3 = Xbyak::util::rdx;
+constexpr std::size_t ABI_SHADOW_SPACE = 0;
+#endif
+
+/// Initial size of the code buffer, it grows on demand for bigger macros.
+constexpr std::size_t INITIAL_CODE_SIZE = 0x1000;
+
+/// Macro state accessed by the generated code.
+struct JITState {
+    Engines::Maxwell3D* maxwell3d;
+    Macro::MacroCapture* capture;
+    std::array<u32, Macro::NUM_MACRO_REGISTERS> registers;
+    u32 carry_flag;
+    u32 method_address;
+};
+static_assert(std::is_standard_layout_v<JITState>, "JITState must be standard layout");
+
+void SendTrampoline(JITState* state, u32 value) {
+    Macro::MethodAddress address{state->method_address};
+    if (state->capture != nullptr) {
+        state->capture->Send(address.address, value);
+    } else {
+        state->maxwell3d->CallMethodFromMME({address.address, value});
+    }
+    address.address.Assign(address.address.Value() + address.increment.Value());
+    state->method_address = address.raw;
+}
+
+u32 ReadTrampoline(JITState* state, u32 method) {
+    if (state->capture != nullptr) {
+        return state->capture->Read(method);
+    }
+    return state->maxwell3d->GetRegisterValue(method);
+}
+
+class MacroJITx64Impl final : public Xbyak::CodeGenerator, public CachedMacro {
+public:
+    explicit MacroJITx64Impl(Engines::Maxwell3D& maxwell3d, const std::vector<u32>& code)
+        : Xbyak::CodeGenerator{INITIAL_CODE_SIZE, Xbyak::AutoGrow}, maxwell3d{maxwell3d},
+          code{code}, labels(code.size()) {}
+
+    /// Generates the host code, returns false when the macro uses a construct the JIT can't handle.
+    bool Compile() {
+        MICROPROFILE_SCOPE(MacroJitCompile);
+        try {
+            if (!GenerateCode()) {
+                return false;
+            }
+            ready();
+        } catch (const Xbyak::Error& error) {
+            LOG_ERROR(HW_GPU, "Failed to generate macro code: {}", error.what());
+            return false;
+        }
+        program = getCode<ProgramType>();
+        return true;
+    }
+
+    void Execute(const u32* parameters, std::size_t num_parameters,
+                 Macro::MacroCapture* capture) override {
+        MICROPROFILE_SCOPE(MacroJitExecute);
+        JITState state{};
+        state.maxwell3d = &maxwell3d;
+        state.capture = capture;
+        // $r1 holds the first parameter, the 'parm' instruction fetches from the second one.
+        state.registers[1] = parameters[0];
+        program(&state, parameters + 1, parameters + num_parameters);
+    }
+
+private:
+    using ProgramType = void (*)(JITState* state, const u32* parameters,
+                                 const u32* parameters_end);
+
+    bool GenerateCode() {
+        push(STATE);
+        push(RESULT.cvt64());
+        push(PARAMETERS);
+        push(PARAMETERS_END);
+        // Four pushes keep the stack misaligned by 8 bytes, realign it for the calls.
+        sub(rsp, 8 + ABI_SHADOW_SPACE);
+        mov(STATE, ABI_PARAM1);
+        mov(PARAMETERS, ABI_PARAM2);
+        mov(PARAMETERS_END, ABI_PARAM3);
+
+        for (u32 pc = 0; pc < static_cast<u32>(code.size()); ++pc) {
+            L(labels[pc]);
+            if (!CompileInstruction(pc, false)) {
+                return false;
+            }
+        }
+        // Code reading guarantees every fall-through path exits before the end of the macro, this
+        // is only reached for macros truncated by the end of macro memory.
+        jmp(end_of_code, T_NEAR);
+
+        L(end_of_code);
+        add(rsp, 8 + ABI_SHADOW_SPACE);
+        pop(PARAMETERS_END);
+        pop(PARAMETERS);
+        pop(RESULT.cvt64());
+        pop(STATE);
+        ret();
+        return true;
+    }
+
+    bool CompileInstruction(u32 pc, bool is_delay_slot) {
+        const Macro::Opcode opcode{code[pc]};
+        switch (opcode.operation) {
+        case Macro::Operation::ALU:
+            if (!CompileALU(opcode)) {
+                return false;
+            }
+            break;
+        case Macro::Operation::AddImmediate:
+            LoadRegister(RESULT, opcode.src_a);
+            if (opcode.immediate != 0) {
+                add(RESULT, static_cast<u32>(opcode.immediate.Value()));
+            }
+            CompileProcessResult(opcode.result_operation, opcode.dst);
+            break;
+        case Macro::Operation::ExtractInsert: {
+            const u32 mask = opcode.GetBitfieldMask();
+            LoadRegister(RESULT, opcode.src_a);
+            LoadRegister(eax, opcode.src_b);
+            ShiftRight(eax, opcode.bf_src_bit);
+            and_(eax, mask);
+            ShiftLeft(eax, opcode.bf_dst_bit);
+            and_(RESULT, ~(mask << opcode.bf_dst_bit));
+            or_(RESULT, eax);
+            CompileProcessResult(opcode.result_operation, opcode.dst);
+            break;
+        }
+        case Macro::Operation::ExtractShiftLeftImmediate:
+            LoadRegister(ecx, opcode.src_a);
+            LoadRegister(RESULT, opcode.src_b);
+            shr(RESULT, cl);
+            and_(RESULT, opcode.GetBitfieldMask());
+            ShiftLeft(RESULT, opcode.bf_dst_bit);
+            CompileProcessResult(opcode.result_operation, opcode.dst);
+            break;
+        case Macro::Operation::ExtractShiftLeftRegister:
+            LoadRegister(ecx, opcode.src_a);
+            LoadRegister(RESULT, opcode.src_b);
+            ShiftRight(RESULT, opcode.bf_src_bit);
+            and_(RESULT, opcode.GetBitfieldMask());
+            shl(RESULT, cl);
+            CompileProcessResult(opcode.result_operation, opcode.dst);
+            break;
+        case Macro::Operation::Read:
+            LoadRegister(ABI_PARAM2.cvt32(), opcode.src_a);
+            if (opcode.immediate != 0) {
+                add(ABI_PARAM2.cvt32(), static_cast<u32>(opcode.immediate.Value()));
+            }
+            CallTrampoline(reinterpret_cast<const void*>(&ReadTrampoline));
+            mov(RESULT, eax);
+            CompileProcessResult(opcode.result_operation, opcode.dst);
+            break;
+        case Macro::Operation::Branch:
+            if (!CompileBranch(pc, opcode, is_delay_slot)) {
+                return false;
+            }
+            break;
+        default:
+            LOG_WARNING(HW_GPU, "Unsupported macro operation {}, using the interpreter",
+                        static_cast<u32>(opcode.operation.Value()));
+            return false;
+        }
+
+        // An instruction with the Exit flag will not actually cause an exit if it's executed
+        // inside a delay slot.
+        if (opcode.is_exit && !is_delay_slot) {
+            // Exit has a delay slot, execute the next instruction
+            if (!CompileDelaySlot(pc + 1)) {
+                return false;
+            }
+            jmp(end_of_code, T_NEAR);
+        }
+        return true;
+    }
+
+    bool CompileALU(Macro::Opcode opcode) {
+        LoadRegister(RESULT, opcode.src_a);
+        LoadRegister(ecx, opcode.src_b);
+
+        const Xbyak::RegExp carry_flag = STATE + offsetof(JITState, carry_flag);
+        switch (opcode.alu_operation) {
+        case Macro::ALUOperation::Add:
+            add(RESULT, ecx);
+            setc(byte[carry_flag]);
+            break;
+        case Macro::ALUOperation::AddWithCarry:
+            bt(dword[carry_flag], 0);
+            adc(RESULT, ecx);
+            setc(byte[carry_flag]);
+            break;
+        case Macro::ALUOperation::Subtract:
+            // The macro carry flag is set when there's no borrow, the opposite of x86.
+            sub(RESULT, ecx);
+            setnc(byte[carry_flag]);
+            break;
+        case Macro::ALUOperation::SubtractWithBorrow:
+            // Sets the host carry (borrow) when the macro carry is clear.
+            cmp(dword[carry_flag], 1);
+            sbb(RESULT, ecx);
+            setnc(byte[carry_flag]);
+            break;
+        case Macro::ALUOperation::Xor:
+            xor_(RESULT, ecx);
+            break;
+        case Macro::ALUOperation::Or:
+            or_(RESULT, ecx);
+            break;
+        case Macro::ALUOperation::And:
+            and_(RESULT, ecx);
+            break;
+        case Macro::ALUOperation::AndNot:
+            not_(ecx);
+            and_(RESULT, ecx);
+            break;
+        case Macro::ALUOperation::Nand:
+            and_(RESULT, ecx);
+            not_(RESULT);
+            break;
+        default:
+            LOG_WARNING(HW_GPU, "Unsupported macro ALU operation {}, using the interpreter",
+                        static_cast<u32>(opcode.alu_operation.Value()));
+            return false;
+        }
+        CompileProcessResult(opcode.result_operation, opcode.dst);
+        return true;
+    }
+
+    bool CompileBranch(u32 pc, Macro::Opcode opcode, bool is_delay_slot) {
+        if (is_delay_slot) {
+            LOG_WARNING(HW_GPU, "Macro branch in a delay slot, using the interpreter");
+            return false;
+        }
+        const s64 target = static_cast<s64>(pc) + opcode.immediate;
+        if (target < 0 || target >= static_cast<s64>(code.size())) {
+            LOG_WARNING(HW_GPU, "Macro branch target {} is out of the macro code", target);
+            return false;
+        }
+        const Xbyak::Label& target_label = labels[static_cast<std::size_t>(target)];
+        const bool branch_if_zero = opcode.branch_condition == Macro::BranchCondition::Zero;
+
+        LoadRegister(eax, opcode.src_a);
+        test(eax, eax);
+        if (opcode.branch_annul) {
+            // Taken branches skip the delay slot, jump straight to the target.
+            if (branch_if_zero) {
+                jz(target_label, T_NEAR);
+            } else {
+                jnz(target_label, T_NEAR);
+            }
+            return true;
+        }
+
+        // Taken branches execute the delay slot before jumping, not taken branches fall through
+        // and execute the same instruction normally.
+        Xbyak::Label not_taken;
+        if (branch_if_zero) {
+            jnz(not_taken, T_NEAR);
+        } else {
+            jz(not_taken, T_NEAR);
+        }
+        if (!CompileDelaySlot(pc + 1)) {
+            return false;
+        }
+        jmp(target_label, T_NEAR);
+        L(not_taken);
+        return true;
+    }
+
+    bool CompileDelaySlot(u32 pc) {
+        if (pc >= code.size()) {
+            LOG_WARNING(HW_GPU, "Macro delay slot is out of the macro code");
+            return false;
+        }
+        return CompileInstruction(pc, true);
+    }
+
+    void CompileProcessResult(Macro::ResultOperation operation, u32 reg) {
+        switch (operation) {
+        case Macro::ResultOperation::IgnoreAndFetch:
+            FetchParameter(eax);
+            StoreRegister(reg, eax);
+            break;
+        case Macro::ResultOperation::Move:
+            StoreRegister(reg, RESULT);
+            break;
+        case Macro::ResultOperation::MoveAndSetMethod:
+            StoreRegister(reg, RESULT);
+            SetMethodAddress(RESULT);
+            break;
+        case Macro::ResultOperation::FetchAndSend:
+            FetchParameter(eax);
+            StoreRegister(reg, eax);
+            Send(RESULT);
+            break;
+        case Macro::ResultOperation::MoveAndSend:
+            StoreRegister(reg, RESULT);
+            Send(RESULT);
+            break;
+        case Macro::ResultOperation::FetchAndSetMethod:
+            FetchParameter(eax);
+            StoreRegister(reg, eax);
+            SetMethodAddress(RESULT);
+            break;
+        case Macro::ResultOperation::MoveAndSetMethodFetchAndSend:
+            StoreRegister(reg, RESULT);
+            SetMethodAddress(RESULT);
+            FetchParameter(eax);
+            Send(eax);
+            break;
+        case Macro::ResultOperation::MoveAndSetMethodSend:
+            StoreRegister(reg, RESULT);
+            SetMethodAddress(RESULT);
+            mov(eax, RESULT);
+            shr(eax, 12);
+            and_(eax, 0b111111);
+            Send(eax);
+            break;
+        }
+    }
+
+    /// Returns the host address of a macro register in the JIT state.
+    static Xbyak::RegExp RegisterAddress(u32 reg) {
+        return STATE + offsetof(JITState, registers) + reg * sizeof(u32);
+    }
+
+    void LoadRegister(const Xbyak::Reg32& dst, u32 reg) {
+        // Register 0 is hardwired as the zero register.
+        if (reg == 0) {
+            xor_(dst, dst);
+        } else {
+            mov(dst, dword[RegisterAddress(reg)]);
+        }
+    }
+
+    void StoreRegister(u32 reg, const Xbyak::Reg32& src) {
+        if (reg != 0) {
+            mov(dword[RegisterAddress(reg)], src);
+        }
+    }
+
+    void ShiftLeft(const Xbyak::Reg32& reg, u32 amount) {
+        if (amount != 0) {
+            shl(reg, static_cast<int>(amount));
+        }
+    }
+
+    void ShiftRight(const Xbyak::Reg32& reg, u32 amount) {
+        if (amount != 0) {
+            shr(reg, static_cast<int>(amount));
+        }
+    }
+
+    void FetchParameter(const Xbyak::Reg32& dst) {
+        // Macros fetching more parameters than they were given read zeroes.
+        Xbyak::Label out_of_parameters;
+        Xbyak::Label done;
+        cmp(PARAMETERS, PARAMETERS_END);
+        jae(out_of_parameters, T_NEAR);
+        mov(dst, dword[PARAMETERS]);
+        add(PARAMETERS, static_cast<u32>(sizeof(u32)));
+        jmp(done, T_NEAR);
+        L(out_of_parameters);
+        xor_(dst, dst);
+        L(done);
+    }
+
+    void SetMethodAddress(const Xbyak::Reg32& address) {
+        mov(dword[STATE + offsetof(JITState, method_address)], address);
+    }
+
+    void Send(const Xbyak::Reg32& value) {
+        mov(ABI_PARAM2.cvt32(), value);
+        CallTrampoline(reinterpret_cast<const void*>(&SendTrampoline));
+    }
+
+    void CallTrampoline(const void* function) {
+        mov(ABI_PARAM1, STATE);
+        mov(rax, reinterpret_cast<u64>(function));
+        call(rax);
+    }
+
+    Engines::Maxwell3D& maxwell3d;
+    std::vector<u32> code;
+    /// Label of the first host instruction of each macro instruction.
+    std::vector<Xbyak::Label> labels;
+    Xbyak::Label end_of_code;
+    ProgramType program = nullptr;
+};
+
+/// Runs both the JIT and the interpreter and reports when their method calls differ.
+class ValidatedMacro final : public CachedMacro {
+public:
+    explicit ValidatedMacro(Engines::Maxwell3D& maxwell3d, std::unique_ptr<CachedMacro> jit,
+                            std::unique_ptr<CachedMacro> interpreter)
+        : maxwell3d{maxwell3d}, jit{std::move(jit)}, interpreter{std::move(interpreter)} {}
+
+    void Execute(const u32* parameters, std::size_t num_parameters,
+                 Macro::MacroCapture* capture) override {
+        // Method calls are applied after both executions, so register reads observe the values
+        // sent by the macro itself instead of any side effect the engine applies on writes.
+        Macro::MacroCapture jit_capture{maxwell3d};
+        Macro::MacroCapture interpreter_capture{maxwell3d};
+        jit->Execute(parameters, num_parameters, &jit_capture);
+        interpreter->Execute(parameters, num_parameters, &interpreter_capture);
+
+        const auto& expected = interpreter_capture.GetCalls();
+        const auto& result = jit_capture.GetCalls();
+        if (result != expected) {
+            LOG_CRITICAL(HW_GPU, "Macro JIT diverged from the interpreter: {} calls, expected {}",
+                         result.size(), expected.size());
+            for (std::size_t i = 0; i < std::max(result.size(), expected.size()); ++i) {
+                if (i >= result.size() || i >= expected.size() || result[i] != expected[i]) {
+                    LOG_CRITICAL(HW_GPU, "First mismatch at call {}", i);
+                    break;
+                }
+            }
+        }
+
+        // The interpreter is the reference implementation, apply its results.
+        for (const auto& [method, argument] : expected) {
+            if (capture != nullptr) {
+                capture->Send(method, argument);
+            } else {
+                maxwell3d.CallMethodFromMME({method, argument});
+            }
+        }
+    }
+
+private:
+    Engines::Maxwell3D& maxwell3d;
+    std::unique_ptr<CachedMacro> jit;
+    std::unique_ptr<CachedMacro> interpreter;
+};
+
+} // Anonymous namespace
+
+MacroJITx64::MacroJITx64(Engines::Maxwell3D& maxwell3d) : MacroEngine{maxwell3d} {}
+
+std::unique_ptr<CachedMacro> MacroJITx64::Compile(const std::vector<u32>& code) {
+    auto jit = std::make_unique<MacroJITx64Impl>(maxwell3d, code);
+    if (!jit->Compile()) {
+        return std::make_unique<MacroInterpreterImpl>(maxwell3d, code);
+    }
+    if (Settings::values.validate_macro_jit) {
+        return std::make_unique<ValidatedMacro>(
+            maxwell3d, std::move(jit), std::make_unique<MacroInterpreterImpl>(maxwell3d, code));
+    }
+    return jit;
+}
+
+} // namespace Tegra
@@ -2,6 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -14,13 +18,10 @@
 
 namespace Tegra {
 
-MemoryManager::MemoryManager(Core::System& system, VideoCore::RasterizerInterface& rasterizer)
-    : rasterizer{rasterizer}, system{system} {
-    std::fill(page_table.pointers.begin(), page_table.pointers.end(), nullptr);
-    std::fill(page_table.attributes.begin(), page_table.attributes.end(),
-              Common::PageType::Unmapped);
-    page_table.Resize(address_space_width);
-
+MemoryManager::MemoryManager(Core::System& system, VideoCore::RasterizerInterface& rasterizer,
+                             VideoCommon::GPUCapture& capture)
+    : page_directory(address_space_end >> directory_bits), rasterizer{rasterizer},
+      capture{capture}, system{system} {
     // Initialize the map with a single free region covering the entire managed space.
     VirtualMemoryArea initial_vma;
     initial_vma.size = address_space_end;
@@ -32,7 +33,7 @@ MemoryManager::MemoryManager(Core::System& system, VideoCore::RasterizerInterfac
 MemoryManager::~MemoryManager() = default;
 
 GPUVAddr MemoryManager::AllocateSpace(u64 size, u64 align) {
-    const u64 aligned_size{Common::AlignUp(size, page_size)};
+    const u64 aligned_size{Common::AlignUp(size, small_page_size)};
     const GPUVAddr gpu_addr{FindFreeRegion(address_space_base, aligned_size)};
 
     AllocateMemory(gpu_addr, 0, aligned_size);
@@ -41,7 +42,7 @@ GPUVAddr MemoryManager::AllocateSpace(u64 size, u64 align) {
 }
 
 GPUVAddr MemoryManager::AllocateSpace(GPUVAddr gpu_addr, u64 size, u64 align) {
-    const u64 aligned_size{Common::AlignUp(size, page_size)};
+    const u64 aligned_size{Common::AlignUp(size, small_page_size)};
 
     AllocateMemory(gpu_addr, 0, aligned_size);
 
@@ -49,7 +50,7 @@ GPUVAddr MemoryManager::AllocateSpace(GPUVAddr gpu_addr, u64 size, u64 align) {
 }
 
 GPUVAddr MemoryManager::MapBufferEx(VAddr cpu_addr, u64 size) {
-    const u64 aligned_size{Common::AlignUp(size, page_size)};
+    const u64 aligned_size{Common::AlignUp(size, small_page_size)};
     const GPUVAddr gpu_addr{FindFreeRegion(address_space_base, aligned_size)};
 
     MapBackingMemory(gpu_addr, Memory::GetPointer(cpu_addr), aligned_size, cpu_addr);
@@ -58,14 +59,15 @@ GPUVAddr MemoryManager::MapBufferEx(VAddr cpu_addr, u64 size) {
                .SetMemoryAttribute(cpu_addr, size, Kernel::MemoryAttribute::DeviceMapped,
                                    Kernel::MemoryAttribute::DeviceMapped)
                .IsSuccess());
+    capture.RecordMap(gpu_addr, cpu_addr, aligned_size);
 
     return gpu_addr;
 }
 
 GPUVAddr MemoryManager::MapBufferEx(VAddr cpu_addr, GPUVAddr gpu_addr, u64 size) {
-    ASSERT((gpu_addr & page_mask) == 0);
+    ASSERT((gpu_addr & small_page_mask) == 0);
 
-    const u64 aligned_size{Common::AlignUp(size, page_size)};
+    const u64 aligned_size{Common::AlignUp(size, small_page_size)};
 
     MapBackingMemory(gpu_addr, Memory::GetPointer(cpu_addr), aligned_size, cpu_addr);
     ASSERT(system.CurrentProcess()
@@ -73,19 +75,21 @@ GPUVAddr MemoryManager::MapBufferEx(VAddr cpu_addr, GPUVAddr gpu_addr, u64 size)
                .SetMemoryAttribute(cpu_addr, size, Kernel::MemoryAttribute::DeviceMapped,
                                    Kernel::MemoryAttribute::DeviceMapped)
                .IsSuccess());
+    capture.RecordMap(gpu_addr, cpu_addr, aligned_size);
     return gpu_addr;
 }
 
 GPUVAddr MemoryManager::UnmapBuffer(GPUVAddr gpu_addr, u64 size) {
-    ASSERT((gpu_addr & page_mask) == 0);
+    ASSERT((gpu_addr & small_page_mask) == 0);
 
-    const u64 aligned_size{Common::AlignUp(size, page_size)};
+    const u64 aligned_size{Common::AlignUp(size, small_page_size)};
     const CacheAddr cache_addr{ToCacheAddr(GetPointer(gpu_addr))};
     const auto cpu_addr = GpuToCpuAddress(gpu_addr);
     ASSERT(cpu_addr);
 
     rasterizer.FlushAndInvalidateRegion(cache_addr, aligned_size);
     UnmapRange(gpu_addr, aligned_size);
+    capture.RecordUnmap(gpu_addr, aligned_size);
     ASSERT(system.CurrentProcess()
                ->VMManager()
                .SetMemoryAttribute(cpu_addr.value(), size, Kernel::MemoryAttribute::DeviceMapped,
@@ -96,36 +100,51 @@ GPUVAddr MemoryManager::UnmapBuffer(GPUVAddr gpu_addr, u64 size) {
 }
 
 GPUVAddr MemoryManager::FindFreeRegion(GPUVAddr region_start, u64 size) const {
+    const auto get_start = [region_start](const VirtualMemoryArea& vma) {
+        return Common::AlignUp(std::max(region_start, vma.base), big_page_size);
+    };
     // Find the first Free VMA.
     const VMAHandle vma_handle{
-        std::find_if(vma_map.begin(), vma_map.end(), [region_start, size](const auto& vma) {
+        std::find_if(vma_map.begin(), vma_map.end(), [&get_start, size](const auto& vma) {
             if (vma.second.type != VirtualMemoryArea::Type::Unmapped) {
                 return false;
             }
 
             const VAddr vma_end{vma.second.base + vma.second.size};
-            return vma_end > region_start && vma_end >= region_start + size;
+            return vma_end >= get_start(vma.second) + size;
         })};
 
     if (vma_handle == vma_map.end()) {
         return {};
     }
 
-    return std::max(region_start, vma_handle->second.base);
+    return get_start(vma_handle->second);
 }
 
 bool MemoryManager::IsAddressValid(GPUVAddr addr) const {
-    return (addr >> page_bits) < page_table.pointers.size();
+    return addr < address_space_end;
 }
 
-std::optional<VAddr> MemoryManager::GpuToCpuAddress(GPUVAddr addr) const {
+std::pair<const MemoryManager::PageEntry*, u64> MemoryManager::FindPage(GPUVAddr addr) const {
     if (!IsAddressValid(addr)) {
-        return {};
+        return {nullptr, 0};
+    }
+    const DirectoryEntry& directory{page_directory[addr >> directory_bits]};
+    if (!directory.big_pages) {
+        return {nullptr, 0};
     }
+    const std::size_t big_index{(addr & directory_mask) >> big_page_bits};
+    if (!directory.split_pages[big_index]) {
+        return {&(*directory.big_pages)[big_index], addr & big_page_mask};
+    }
+    const std::size_t small_index{(addr & directory_mask) >> small_page_bits};
+    return {&(*directory.small_pages)[small_index], addr & small_page_mask};
+}
 
-    const VAddr cpu_addr{page_table.backing_addr[addr >> page_bits]};
-    if (cpu_addr) {
-        return cpu_addr + (addr & page_mask);
+std::optional<VAddr> MemoryManager::GpuToCpuAddress(GPUVAddr addr) const {
+    const auto [page, offset] = FindPage(addr);
+    if (page && page->backing_addr) {
+        return page->backing_addr + offset;
     }
 
     return {};
@@ -133,55 +152,30 @@ std::optional<VAddr> MemoryManager::GpuToCpuAddress(GPUVAddr addr) const {
 
 template <typename T>
 T MemoryManager::Read(GPUVAddr addr) const {
-    if (!IsAddressValid(addr)) {
-        return {};
-    }
-
-    const u8* page_pointer{page_table.pointers[addr >> page_bits]};
-    if (page_pointer) {
+    TrackRead(addr, sizeof(T));
+    const auto [page, offset] = FindPage(addr);
+    if (page && page->pointer) {
         // NOTE: Avoid adding any extra logic to this fast-path block
         T value;
-        std::memcpy(&value, &page_pointer[addr & page_mask], sizeof(T));
+        std::memcpy(&value, &page->pointer[offset], sizeof(T));
         return value;
     }
 
-    switch (page_table.attributes[addr >> page_bits]) {
-    case Common::PageType::Unmapped:
-        LOG_ERROR(HW_GPU, "Unmapped Read{} @ 0x{:08X}", sizeof(T) * 8, addr);
-        return 0;
-    case Common::PageType::Memory:
-        ASSERT_MSG(false, "Mapped memory page without a pointer @ {:016X}", addr);
-        break;
-    default:
-        UNREACHABLE();
-    }
+    LOG_ERROR(HW_GPU, "Unmapped Read{} @ 0x{:08X}", sizeof(T) * 8, addr);
     return {};
 }
 
 template <typename T>
 void MemoryManager::Write(GPUVAddr addr, T data) {
-    if (!IsAddressValid(addr)) {
-        return;
-    }
-
-    u8* page_pointer{page_table.pointers[addr >> page_bits]};
-    if (page_pointer) {
+    const auto [page, offset] = FindPage(addr);
+    if (page && page->pointer) {
         // NOTE: Avoid adding any extra logic to this fast-path block
-        std::memcpy(&page_pointer[addr & page_mask], &data, sizeof(T));
+        std::memcpy(&page->pointer[offset], &data, sizeof(T));
         return;
     }
 
-    switch (page_table.attributes[addr >> page_bits]) {
-    case Common::PageType::Unmapped:
-        LOG_ERROR(HW_GPU, "Unmapped Write{} 0x{:08X} @ 0x{:016X}", sizeof(data) * 8,
-                  static_cast<u32>(data), addr);
-        return;
-    case Common::PageType::Memory:
-        ASSERT_MSG(false, "Mapped memory page without a pointer @ {:016X}", addr);
-        break;
-    default:
-        UNREACHABLE();
-    }
+    LOG_ERROR(HW_GPU, "Unmapped Write{} 0x{:08X} @ 0x{:016X}", sizeof(data) * 8,
+              static_cast<u32>(data), addr);
 }
 
 template u8 MemoryManager::Read<u8>(GPUVAddr addr) const;
@@ -194,166 +188,124 @@ template void MemoryManager::Write<u32>(GPUVAddr addr, u32 data);
 template void MemoryManager::Write<u64>(GPUVAddr addr, u64 data);
 
 u8* MemoryManager::GetPointer(GPUVAddr addr) {
-    if (!IsAddressValid(addr)) {
-        return {};
-    }
+    return const_cast<u8*>(std::as_const(*this).GetPointer(addr));
+}
 
-    u8* const page_pointer{page_table.pointers[addr >> page_bits]};
-    if (page_pointer != nullptr) {
-        return page_pointer + (addr & page_mask);
+const u8* MemoryManager::GetPointer(GPUVAddr addr) const {
+    const auto [page, offset] = FindPage(addr);
+    if (page && page->pointer) {
+        return page->pointer + offset;
     }
 
     LOG_ERROR(HW_GPU, "Unknown GetPointer @ 0x{:016X}", addr);
     return {};
 }
 
-const u8* MemoryManager::GetPointer(GPUVAddr addr) const {
-    if (!IsAddressValid(addr)) {
-        return {};
-    }
+u8* MemoryManager::GetContiguousSpan(GPUVAddr gpu_addr, std::size_t size) {
+    return const_cast<u8*>(std::as_const(*this).GetContiguousSpan(gpu_addr, size));
+}
 
-    const u8* const page_pointer{page_table.pointers[addr >> page_bits]};
-    if (page_pointer != nullptr) {
-        return page_pointer + (addr & page_mask);
+const u8* MemoryManager::GetContiguousSpan(GPUVAddr gpu_addr, std::size_t size) const {
+    TrackRead(gpu_addr, size);
+    // Mapped VMAs are backed by contiguous host memory, and adjacent ones are merged when their
+    // backing memory is contiguous
+    const VMAHandle vma_handle{FindVMA(gpu_addr)};
+    if (vma_handle == vma_map.end()) {
+        return nullptr;
     }
-
-    LOG_ERROR(HW_GPU, "Unknown GetPointer @ 0x{:016X}", addr);
-    return {};
+    const VirtualMemoryArea& vma{vma_handle->second};
+    const u64 offset{gpu_addr - vma.base};
+    if (vma.type != VirtualMemoryArea::Type::Mapped || size > vma.size - offset) {
+        return nullptr;
+    }
+    return vma.backing_memory + offset;
 }
 
 bool MemoryManager::IsBlockContinuous(const GPUVAddr start, const std::size_t size) const {
-    const std::size_t inner_size = size - 1;
-    const GPUVAddr end = start + inner_size;
-    const auto host_ptr_start = reinterpret_cast<std::uintptr_t>(GetPointer(start));
-    const auto host_ptr_end = reinterpret_cast<std::uintptr_t>(GetPointer(end));
-    const auto range = static_cast<std::size_t>(host_ptr_end - host_ptr_start);
-    return range == inner_size;
+    return GetContiguousSpan(start, size) != nullptr;
 }
 
-void MemoryManager::ReadBlock(GPUVAddr src_addr, void* dest_buffer, const std::size_t size) const {
-    std::size_t remaining_size{size};
-    std::size_t page_index{src_addr >> page_bits};
-    std::size_t page_offset{src_addr & page_mask};
+template <typename Func>
+void MemoryManager::ForEachSpan(GPUVAddr addr, std::size_t size, Func&& func) const {
+    while (size > 0) {
+        const VMAHandle vma_handle{FindVMA(addr)};
+        if (vma_handle == vma_map.end()) {
+            func(addr, nullptr, size);
+            return;
+        }
+        const VirtualMemoryArea& vma{vma_handle->second};
+        const u64 offset{addr - vma.base};
+        const std::size_t amount{static_cast<std::size_t>(std::min<u64>(vma.size - offset, size))};
+        const bool is_mapped{vma.type == VirtualMemoryArea::Type::Mapped};
+        func(addr, is_mapped ? vma.backing_memory + offset : nullptr, amount);
 
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
+        addr += amount;
+        size -= amount;
+    }
+}
 
-        switch (page_table.attributes[page_index]) {
-        case Common::PageType::Memory: {
-            const u8* src_ptr{page_table.pointers[page_index] + page_offset};
+void MemoryManager::ReadBlock(GPUVAddr src_addr, void* dest_buffer, const std::size_t size) const {
+    TrackRead(src_addr, size);
+    ForEachSpan(src_addr, size, [&](GPUVAddr addr, const u8* src_ptr, std::size_t copy_amount) {
+        if (src_ptr) {
             rasterizer.FlushRegion(ToCacheAddr(src_ptr), copy_amount);
             std::memcpy(dest_buffer, src_ptr, copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
+        } else {
+            UNREACHABLE_MSG("Unmapped ReadBlock @ 0x{:016X} with 0x{:X} bytes left", addr,
+                            src_addr + size - addr);
         }
-
-        page_index++;
-        page_offset = 0;
         dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    });
 }
 
 void MemoryManager::ReadBlockUnsafe(GPUVAddr src_addr, void* dest_buffer,
                                     const std::size_t size) const {
-    std::size_t remaining_size{size};
-    std::size_t page_index{src_addr >> page_bits};
-    std::size_t page_offset{src_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
-        const u8* page_pointer = page_table.pointers[page_index];
-        if (page_pointer) {
-            const u8* src_ptr{page_pointer + page_offset};
+    TrackRead(src_addr, size);
+    ForEachSpan(src_addr, size, [&](GPUVAddr, const u8* src_ptr, std::size_t copy_amount) {
+        if (src_ptr) {
             std::memcpy(dest_buffer, src_ptr, copy_amount);
         } else {
             std::memset(dest_buffer, 0, copy_amount);
         }
-        page_index++;
-        page_offset = 0;
         dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    });
 }
 
 void MemoryManager::WriteBlock(GPUVAddr dest_addr, const void* src_buffer, const std::size_t size) {
-    std::size_t remaining_size{size};
-    std::size_t page_index{dest_addr >> page_bits};
-    std::size_t page_offset{dest_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
-
-        switch (page_table.attributes[page_index]) {
-        case Common::PageType::Memory: {
-            u8* dest_ptr{page_table.pointers[page_index] + page_offset};
+    ForEachSpan(dest_addr, size, [&](GPUVAddr addr, u8* dest_ptr, std::size_t copy_amount) {
+        if (dest_ptr) {
             rasterizer.InvalidateRegion(ToCacheAddr(dest_ptr), copy_amount);
             std::memcpy(dest_ptr, src_buffer, copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
+        } else {
+            UNREACHABLE_MSG("Unmapped WriteBlock @ 0x{:016X} with 0x{:X} bytes left", addr,
+                            dest_addr + size - addr);
         }
-
-        page_index++;
-        page_offset = 0;
         src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    });
 }
 
 void MemoryManager::WriteBlockUnsafe(GPUVAddr dest_addr, const void* src_buffer,
                                      const std::size_t size) {
-    std::size_t remaining_size{size};
-    std::size_t page_index{dest_addr >> page_bits};
-    std::size_t page_offset{dest_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
-        u8* page_pointer = page_table.pointers[page_index];
-        if (page_pointer) {
-            u8* dest_ptr{page_pointer + page_offset};
+    ForEachSpan(dest_addr, size, [&](GPUVAddr, u8* dest_ptr, std::size_t copy_amount) {
+        if (dest_ptr) {
             std::memcpy(dest_ptr, src_buffer, copy_amount);
         }
-        page_index++;
-        page_offset = 0;
         src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    });
 }
 
 void MemoryManager::CopyBlock(GPUVAddr dest_addr, GPUVAddr src_addr, const std::size_t size) {
-    std::size_t remaining_size{size};
-    std::size_t page_index{src_addr >> page_bits};
-    std::size_t page_offset{src_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
-
-        switch (page_table.attributes[page_index]) {
-        case Common::PageType::Memory: {
-            const u8* src_ptr{page_table.pointers[page_index] + page_offset};
+    TrackRead(src_addr, size);
+    ForEachSpan(src_addr, size, [&](GPUVAddr addr, const u8* src_ptr, std::size_t copy_amount) {
+        if (src_ptr) {
             rasterizer.FlushRegion(ToCacheAddr(src_ptr), copy_amount);
             WriteBlock(dest_addr, src_ptr, copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
+        } else {
+            UNREACHABLE_MSG("Unmapped CopyBlock @ 0x{:016X} with 0x{:X} bytes left", addr,
+                            src_addr + size - addr);
         }
-
-        page_index++;
-        page_offset = 0;
-        dest_addr += static_cast<VAddr>(copy_amount);
-        src_addr += static_cast<VAddr>(copy_amount);
-        remaining_size -= copy_amount;
-    }
+        dest_addr += static_cast<GPUVAddr>(copy_amount);
+    });
 }
 
 void MemoryManager::CopyBlockUnsafe(GPUVAddr dest_addr, GPUVAddr src_addr, const std::size_t size) {
@@ -362,27 +314,54 @@ void MemoryManager::CopyBlockUnsafe(GPUVAddr dest_addr, GPUVAddr src_addr, const
     WriteBlockUnsafe(dest_addr, tmp_buffer.data(), size);
 }
 
-void MemoryManager::MapPages(GPUVAddr base, u64 size, u8* memory, Common::PageType type,
-                             VAddr backing_addr) {
-    LOG_DEBUG(HW_GPU, "Mapping {} onto {:016X}-{:016X}", fmt::ptr(memory), base * page_size,
-              (base + size) * page_size);
+void MemoryManager::SplitBigPage(DirectoryEntry& directory, std::size_t big_index) {
+    if (directory.split_pages[big_index]) {
+        return;
+    }
+    if (!directory.small_pages) {
+        directory.small_pages = std::make_unique<SmallPageTable>();
+    }
+    const PageEntry& big_page{(*directory.big_pages)[big_index]};
+    for (std::size_t i = 0; i < small_pages_per_big_page; ++i) {
+        const u64 offset{i * small_page_size};
+        PageEntry& small_page{(*directory.small_pages)[big_index * small_pages_per_big_page + i]};
+        small_page.pointer = big_page.pointer ? big_page.pointer + offset : nullptr;
+        small_page.backing_addr = big_page.backing_addr ? big_page.backing_addr + offset : 0;
+    }
+    directory.split_pages.set(big_index);
+}
 
-    const VAddr end{base + size};
-    ASSERT_MSG(end <= page_table.pointers.size(), "out of range mapping at {:016X}",
-               base + page_table.pointers.size());
+void MemoryManager::MapPages(GPUVAddr base, u64 size, u8* memory, VAddr backing_addr) {
+    LOG_DEBUG(HW_GPU, "Mapping {} onto {:016X}-{:016X}", fmt::ptr(memory), base, base + size);
 
-    std::fill(page_table.attributes.begin() + base, page_table.attributes.begin() + end, type);
+    const GPUVAddr end{base + size};
+    ASSERT_MSG(end <= address_space_end, "out of range mapping at {:016X}", end);
 
-    if (memory == nullptr) {
-        std::fill(page_table.pointers.begin() + base, page_table.pointers.begin() + end, memory);
-        std::fill(page_table.backing_addr.begin() + base, page_table.backing_addr.begin() + end,
-                  backing_addr);
-    } else {
-        while (base != end) {
-            page_table.pointers[base] = memory;
-            page_table.backing_addr[base] = backing_addr;
+    while (base != end) {
+        DirectoryEntry& directory{page_directory[base >> directory_bits]};
+        if (!directory.big_pages) {
+            if (memory == nullptr && backing_addr == 0) {
+                // Nothing was ever mapped in this directory entry, there is nothing to unmap
+                base = std::min(end, (base & ~directory_mask) + directory_size);
+                continue;
+            }
+            directory.big_pages = std::make_unique<BigPageTable>();
+        }
+
+        const std::size_t big_index{(base & directory_mask) >> big_page_bits};
+        const bool is_big_page{(base & big_page_mask) == 0 && end - base >= big_page_size};
+        const PageEntry entry{memory, backing_addr};
+        if (is_big_page) {
+            (*directory.big_pages)[big_index] = entry;
+            directory.split_pages.reset(big_index);
+        } else {
+            SplitBigPage(directory, big_index);
+            (*directory.small_pages)[(base & directory_mask) >> small_page_bits] = entry;
+        }
 
-            base += 1;
+        const u64 page_size{is_big_page ? big_page_size : small_page_size};
+        base += page_size;
+        if (memory != nullptr) {
             memory += page_size;
             backing_addr += page_size;
         }
@@ -390,15 +369,15 @@ void MemoryManager::MapPages(GPUVAddr base, u64 size, u8* memory, Common::PageTy
 }
 
 void MemoryManager::MapMemoryRegion(GPUVAddr base, u64 size, u8* target, VAddr backing_addr) {
-    ASSERT_MSG((size & page_mask) == 0, "non-page aligned size: {:016X}", size);
-    ASSERT_MSG((base & page_mask) == 0, "non-page aligned base: {:016X}", base);
-    MapPages(base / page_size, size / page_size, target, Common::PageType::Memory, backing_addr);
+    ASSERT_MSG((size & small_page_mask) == 0, "non-page aligned size: {:016X}", size);
+    ASSERT_MSG((base & small_page_mask) == 0, "non-page aligned base: {:016X}", base);
+    MapPages(base, size, target, backing_addr);
 }
 
 void MemoryManager::UnmapRegion(GPUVAddr base, u64 size) {
-    ASSERT_MSG((size & page_mask) == 0, "non-page aligned size: {:016X}", size);
-    ASSERT_MSG((base & page_mask) == 0, "non-page aligned base: {:016X}", base);
-    MapPages(base / page_size, size / page_size, nullptr, Common::PageType::Unmapped);
+    ASSERT_MSG((size & small_page_mask) == 0, "non-page aligned size: {:016X}", size);
+    ASSERT_MSG((base & small_page_mask) == 0, "non-page aligned base: {:016X}", base);
+    MapPages(base, size, nullptr);
 }
 
 bool VirtualMemoryArea::CanBeMergedWith(const VirtualMemoryArea& next) const {
@@ -487,8 +466,8 @@ MemoryManager::VMAIter MemoryManager::StripIterConstness(const VMAHandle& iter)
 }
 
 MemoryManager::VMAIter MemoryManager::CarveVMA(GPUVAddr base, u64 size) {
-    ASSERT_MSG((size & page_mask) == 0, "non-page aligned size: 0x{:016X}", size);
-    ASSERT_MSG((base & page_mask) == 0, "non-page aligned base: 0x{:016X}", base);
+    ASSERT_MSG((size & small_page_mask) == 0, "non-page aligned size: 0x{:016X}", size);
+    ASSERT_MSG((base & small_page_mask) == 0, "non-page aligned base: 0x{:016X}", base);
 
     VMAIter vma_handle{StripIterConstness(FindVMA(base))};
     if (vma_handle == vma_map.end()) {
@@ -521,8 +500,8 @@ MemoryManager::VMAIter MemoryManager::CarveVMA(GPUVAddr base, u64 size) {
 }
 
 MemoryManager::VMAIter MemoryManager::CarveVMARange(GPUVAddr target, u64 size) {
-    ASSERT_MSG((size & page_mask) == 0, "non-page aligned size: 0x{:016X}", size);
-    ASSERT_MSG((target & page_mask) == 0, "non-page aligned base: 0x{:016X}", target);
+    ASSERT_MSG((size & small_page_mask) == 0, "non-page aligned size: 0x{:016X}", size);
+    ASSERT_MSG((target & small_page_mask) == 0, "non-page aligned base: 0x{:016X}", target);
 
     const VAddr target_end{target + size};
     ASSERT(target_end >= target);
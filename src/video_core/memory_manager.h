@@ -4,11 +4,16 @@
 
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <map>
+#include <memory>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "common/common_types.h"
-#include "common/page_table.h"
+#include "video_core/gpu_capture.h"
 
 namespace VideoCore {
 class RasterizerInterface;
@@ -51,7 +56,8 @@ struct VirtualMemoryArea {
 
 class MemoryManager final {
 public:
-    explicit MemoryManager(Core::System& system, VideoCore::RasterizerInterface& rasterizer);
+    explicit MemoryManager(Core::System& system, VideoCore::RasterizerInterface& rasterizer,
+                           VideoCommon::GPUCapture& capture);
     ~MemoryManager();
 
     GPUVAddr AllocateSpace(u64 size, u64 align);
@@ -70,9 +76,25 @@ public:
     u8* GetPointer(GPUVAddr addr);
     const u8* GetPointer(GPUVAddr addr) const;
 
+    /**
+     * Returns the host pointer of a GPU range when the whole range is mapped contiguously in host
+     * memory, letting callers access it directly instead of going through pages.
+     * @returns the host pointer of gpu_addr, or null when the range isn't contiguous.
+     */
+    u8* GetContiguousSpan(GPUVAddr gpu_addr, std::size_t size);
+    const u8* GetContiguousSpan(GPUVAddr gpu_addr, std::size_t size) const;
+
     /// Returns true if the block is continuous in host memory, false otherwise
     bool IsBlockContinuous(GPUVAddr start, std::size_t size) const;
 
+    /// Lets a running GPU capture record a range read through a pointer from GetPointer, the
+    /// accessors taking a size record what they read on their own.
+    void TrackRead(GPUVAddr gpu_addr, std::size_t size) const {
+        if (capture.IsRecording()) {
+            capture.RecordRead(*this, gpu_addr, size);
+        }
+    }
+
     /**
      * ReadBlock and WriteBlock are full read and write operations over virtual
      * GPU Memory. It's important to use these when GPU memory may not be continuous
@@ -102,9 +124,58 @@ private:
     using VMAHandle = VMAMap::const_iterator;
     using VMAIter = VMAMap::iterator;
 
+    /// Small pages are the granularity of mappings, big pages are used wherever a mapping covers
+    /// them entirely, as on Maxwell.
+    static constexpr u64 small_page_bits{12};
+    static constexpr u64 small_page_size{1ULL << small_page_bits};
+    static constexpr u64 small_page_mask{small_page_size - 1};
+    static constexpr u64 big_page_bits{16};
+    static constexpr u64 big_page_size{1ULL << big_page_bits};
+    static constexpr u64 big_page_mask{big_page_size - 1};
+    /// Size of the address space covered by each page directory entry.
+    static constexpr u64 directory_bits{26};
+    static constexpr u64 directory_size{1ULL << directory_bits};
+    static constexpr u64 directory_mask{directory_size - 1};
+    static constexpr std::size_t big_pages_per_directory{1ULL << (directory_bits - big_page_bits)};
+    static constexpr std::size_t small_pages_per_big_page{1ULL
+                                                          << (big_page_bits - small_page_bits)};
+    static constexpr std::size_t small_pages_per_directory{big_pages_per_directory *
+                                                           small_pages_per_big_page};
+
+    /// Address space in bits, according to Tegra X1 TRM
+    static constexpr u32 address_space_width{40};
+    /// Start address for mapping, this is fairly arbitrary but must be non-zero.
+    static constexpr GPUVAddr address_space_base{0x100000};
+    /// End of address space, based on address space in bits.
+    static constexpr GPUVAddr address_space_end{1ULL << address_space_width};
+
+    /// Page table entry, pages that aren't backed by memory have a null pointer.
+    struct PageEntry {
+        u8* pointer{};        ///< Host memory backing the page.
+        VAddr backing_addr{}; ///< CPU address backing the page.
+    };
+
+    using BigPageTable = std::array<PageEntry, big_pages_per_directory>;
+    using SmallPageTable = std::array<PageEntry, small_pages_per_directory>;
+
+    /// Page directory entry, pointing to the tables of the big and small pages it covers. Tables
+    /// are only allocated once something is mapped in them.
+    struct DirectoryEntry {
+        std::unique_ptr<BigPageTable> big_pages;
+        std::unique_ptr<SmallPageTable> small_pages;
+        std::bitset<big_pages_per_directory> split_pages; ///< Big pages mapped as small pages.
+    };
+
     bool IsAddressValid(GPUVAddr addr) const;
-    void MapPages(GPUVAddr base, u64 size, u8* memory, Common::PageType type,
-                  VAddr backing_addr = 0);
+
+    /// Returns the entry of the page holding an address and the offset of the address in it, the
+    /// entry is null when no table holds the page.
+    std::pair<const PageEntry*, u64> FindPage(GPUVAddr addr) const;
+
+    /// Makes the small pages of a big page hold its mapping, so they can be mapped separately.
+    void SplitBigPage(DirectoryEntry& directory, std::size_t big_index);
+
+    void MapPages(GPUVAddr base, u64 size, u8* memory, VAddr backing_addr = 0);
     void MapMemoryRegion(GPUVAddr base, u64 size, u8* target, VAddr backing_addr);
     void UnmapRegion(GPUVAddr base, u64 size);
 
@@ -160,23 +231,20 @@ private:
     void UpdatePageTableForVMA(const VirtualMemoryArea& vma);
 
     /// Finds a free (unmapped region) of the specified size starting at the specified address.
+    /// The region starts on a big page, so big mappings can use them.
     GPUVAddr FindFreeRegion(GPUVAddr region_start, u64 size) const;
 
-private:
-    static constexpr u64 page_bits{16};
-    static constexpr u64 page_size{1 << page_bits};
-    static constexpr u64 page_mask{page_size - 1};
-
-    /// Address space in bits, according to Tegra X1 TRM
-    static constexpr u32 address_space_width{40};
-    /// Start address for mapping, this is fairly arbitrary but must be non-zero.
-    static constexpr GPUVAddr address_space_base{0x100000};
-    /// End of address space, based on address space in bits.
-    static constexpr GPUVAddr address_space_end{1ULL << address_space_width};
+    /**
+     * Calls func with the GPU address, host pointer and size of each run of a GPU range that is
+     * contiguous in host memory, the pointer is null for runs that aren't mapped to memory.
+     */
+    template <typename Func>
+    void ForEachSpan(GPUVAddr addr, std::size_t size, Func&& func) const;
 
-    Common::PageTable page_table{page_bits};
+    std::vector<DirectoryEntry> page_directory;
     VMAMap vma_map;
     VideoCore::RasterizerInterface& rasterizer;
+    VideoCommon::GPUCapture& capture;
 
     Core::System& system;
 };
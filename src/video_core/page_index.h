@@ -0,0 +1,154 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "video_core/gpu.h"
+
+namespace VideoCommon {
+
+/**
+ * Index of cached objects by the pages of memory they cover. Each page holds a small list of the
+ * objects overlapping it, pages are grouped in fixed size chunks that are allocated on demand.
+ * Looking up a range walks the pages it touches without allocating and reports every object
+ * overlapping the range exactly once.
+ * @tparam T          Object type, compared with operator== when it's removed
+ * @tparam page_bits  Log2 of the page size
+ */
+template <typename T, u64 page_bits>
+class PageIndex {
+public:
+    /// Adds an object covering the range [start, end).
+    void Insert(CacheAddr start, CacheAddr end, const T& object) {
+        if (start >= end) {
+            return;
+        }
+        const u64 page_end = (end - 1) >> page_bits;
+        for (u64 page = start >> page_bits; page <= page_end; ++page) {
+            Chunk& chunk = GetOrCreateChunk(page >> CHUNK_BITS);
+            chunk.pages[page & CHUNK_MASK].push_back(Entry{start, end, object});
+            ++chunk.num_entries;
+        }
+    }
+
+    /// Removes an object previously added with the same range.
+    void Erase(CacheAddr start, CacheAddr end, const T& object) {
+        if (start >= end) {
+            return;
+        }
+        const u64 page_end = (end - 1) >> page_bits;
+        for (u64 page = start >> page_bits; page <= page_end; ++page) {
+            const auto it = chunks.find(page >> CHUNK_BITS);
+            ASSERT(it != chunks.end());
+            Chunk& chunk = *it->second;
+            auto& list = chunk.pages[page & CHUNK_MASK];
+            const auto entry = std::find_if(list.begin(), list.end(), [&](const Entry& entry) {
+                return entry.start == start && entry.end == end && entry.object == object;
+            });
+            ASSERT(entry != list.end());
+            list.erase(entry);
+            if (--chunk.num_entries == 0) {
+                chunks.erase(it);
+            }
+        }
+    }
+
+    /**
+     * Calls func once for every object overlapping the range [start, end). Objects are visited by
+     * ascending page, in insertion order within a page. func must not modify the index.
+     */
+    template <typename Func>
+    void ForEachInRange(CacheAddr start, CacheAddr end, Func&& func) const {
+        if (start >= end) {
+            return;
+        }
+        const u64 page_begin = start >> page_bits;
+        const u64 page_end = (end - 1) >> page_bits;
+        u64 page = page_begin;
+        while (page <= page_end) {
+            const auto it = chunks.find(page >> CHUNK_BITS);
+            const u64 chunk_end = std::min(page_end, page | CHUNK_MASK);
+            if (it == chunks.end()) {
+                page = chunk_end + 1;
+                continue;
+            }
+            for (; page <= chunk_end; ++page) {
+                for (const Entry& entry : it->second->pages[page & CHUNK_MASK]) {
+                    if (entry.start >= end || start >= entry.end) {
+                        continue;
+                    }
+                    // Objects spanning several pages are in the list of each of them, report
+                    // them only from the first page shared with the range.
+                    const u64 first_page = std::max(entry.start >> page_bits, page_begin);
+                    if (page == first_page) {
+                        func(entry.object);
+                    }
+                }
+            }
+        }
+    }
+
+    /// Calls func once for every indexed object. func must not modify the index.
+    template <typename Func>
+    void ForEach(Func&& func) const {
+        for (const auto& [chunk_index, chunk] : chunks) {
+            for (u64 i = 0; i < CHUNK_SIZE; ++i) {
+                const u64 page = (chunk_index << CHUNK_BITS) | i;
+                for (const Entry& entry : chunk->pages[i]) {
+                    if (entry.start >> page_bits == page) {
+                        func(entry.object);
+                    }
+                }
+            }
+        }
+    }
+
+    /// Returns true when no object is indexed.
+    bool Empty() const {
+        return chunks.empty();
+    }
+
+    /// Removes all the objects from the index.
+    void Clear() {
+        chunks.clear();
+    }
+
+private:
+    static constexpr u64 CHUNK_BITS = 10;
+    static constexpr u64 CHUNK_SIZE = 1ULL << CHUNK_BITS;
+    static constexpr u64 CHUNK_MASK = CHUNK_SIZE - 1;
+
+    struct Entry {
+        CacheAddr start;
+        CacheAddr end;
+        T object;
+    };
+
+    struct Chunk {
+        std::array<std::vector<Entry>, CHUNK_SIZE> pages;
+        std::size_t num_entries = 0;
+    };
+
+    Chunk& GetOrCreateChunk(u64 chunk_index) {
+        auto& chunk = chunks[chunk_index];
+        if (!chunk) {
+            chunk = std::make_unique<Chunk>();
+        }
+        return *chunk;
+    }
+
+    std::unordered_map<u64, std::unique_ptr<Chunk>> chunks;
+};
+
+} // namespace VideoCommon
@@ -2,10 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <limits>
+#include <memory>
 #include <mutex>
 
-#include <boost/icl/interval_map.hpp>
-
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "core/memory.h"
@@ -15,49 +16,79 @@ namespace VideoCore {
 
 namespace {
 
-template <typename Map, typename Interval>
-constexpr auto RangeFromInterval(Map& map, const Interval& interval) {
-    return boost::make_iterator_range(map.equal_range(interval));
-}
+/// Width of the guest address spaces, the widest a process can have.
+constexpr std::size_t ADDRESS_SPACE_BITS = 39;
+constexpr std::size_t CHUNK_PAGE_BITS = 21 - Memory::PAGE_BITS;
+constexpr u64 CHUNK_PAGE_MASK = (1ULL << CHUNK_PAGE_BITS) - 1;
+constexpr u64 NUM_PAGES = 1ULL << (ADDRESS_SPACE_BITS - Memory::PAGE_BITS);
+constexpr std::size_t NUM_CHUNKS = NUM_PAGES >> CHUNK_PAGE_BITS;
 
 } // Anonymous namespace
 
-RasterizerAccelerated::RasterizerAccelerated() = default;
+struct RasterizerAccelerated::CounterChunk {
+    std::array<u16, 1ULL << CHUNK_PAGE_BITS> counts{};
+};
+
+RasterizerAccelerated::RasterizerAccelerated()
+    : counter_chunks{std::make_unique<std::unique_ptr<CounterChunk>[]>(NUM_CHUNKS)} {}
 
 RasterizerAccelerated::~RasterizerAccelerated() = default;
 
 void RasterizerAccelerated::UpdatePagesCachedCount(VAddr addr, u64 size, int delta) {
-    std::lock_guard lock{pages_mutex};
     const u64 page_start{addr >> Memory::PAGE_BITS};
     const u64 page_end{(addr + size + Memory::PAGE_SIZE - 1) >> Memory::PAGE_BITS};
-
-    // Interval maps will erase segments if count reaches 0, so if delta is negative we have to
-    // subtract after iterating
-    const auto pages_interval = CachedPageMap::interval_type::right_open(page_start, page_end);
-    if (delta > 0) {
-        cached_pages.add({pages_interval, delta});
+    ASSERT_MSG(page_end <= NUM_PAGES, "Region at 0x{:016X} is out of the address space", addr);
+    if (page_end > NUM_PAGES) {
+        return;
     }
 
-    for (const auto& pair : RangeFromInterval(cached_pages, pages_interval)) {
-        const auto interval = pair.first & pages_interval;
-        const int count = pair.second;
-
-        const VAddr interval_start_addr = boost::icl::first(interval) << Memory::PAGE_BITS;
-        const VAddr interval_end_addr = boost::icl::last_next(interval) << Memory::PAGE_BITS;
-        const u64 interval_size = interval_end_addr - interval_start_addr;
+    // The caches call this under their own locks, the counts and the marks of a page have to
+    // change together so another cache can't mark it in between
+    std::lock_guard lock{pages_mutex};
 
-        if (delta > 0 && count == delta) {
-            Memory::RasterizerMarkRegionCached(interval_start_addr, interval_size, true);
-        } else if (delta < 0 && count == -delta) {
-            Memory::RasterizerMarkRegionCached(interval_start_addr, interval_size, false);
+    // Pages whose count moved from or to zero are marked in runs
+    const bool cached = delta > 0;
+    const auto magnitude = static_cast<u16>(cached ? delta : -delta);
+    u64 run_start = page_start;
+    u64 run_size = 0;
+    const auto flush_run = [&] {
+        if (run_size != 0) {
+            Memory::RasterizerMarkRegionCached(run_start << Memory::PAGE_BITS,
+                                               run_size << Memory::PAGE_BITS, cached);
+            run_size = 0;
+        }
+    };
+
+    for (u64 page = page_start; page < page_end; ++page) {
+        u16& count = GetPageCount(page);
+        bool is_transition;
+        if (cached) {
+            ASSERT(count <= std::numeric_limits<u16>::max() - magnitude);
+            is_transition = count == 0;
+            count += magnitude;
         } else {
-            ASSERT(count >= 0);
+            ASSERT(count >= magnitude);
+            is_transition = count == magnitude;
+            count -= magnitude;
+        }
+        if (!is_transition) {
+            flush_run();
+            continue;
         }
+        if (run_size == 0) {
+            run_start = page;
+        }
+        ++run_size;
     }
+    flush_run();
+}
 
-    if (delta < 0) {
-        cached_pages.add({pages_interval, delta});
+u16& RasterizerAccelerated::GetPageCount(u64 page) {
+    std::unique_ptr<CounterChunk>& chunk = counter_chunks[page >> CHUNK_PAGE_BITS];
+    if (!chunk) {
+        chunk = std::make_unique<CounterChunk>();
     }
+    return chunk->counts[page & CHUNK_PAGE_MASK];
 }
 
 } // namespace VideoCore
@@ -4,10 +4,9 @@
 
 #pragma once
 
+#include <memory>
 #include <mutex>
 
-#include <boost/icl/interval_map.hpp>
-
 #include "common/common_types.h"
 #include "video_core/rasterizer_interface.h"
 
@@ -22,9 +21,17 @@ public:
     void UpdatePagesCachedCount(VAddr addr, u64 size, int delta) override;
 
 private:
-    using CachedPageMap = boost::icl::interval_map<u64, int>;
-    CachedPageMap cached_pages;
+    /// Counters of the cached objects of the pages of 2 MiB of guest memory.
+    struct CounterChunk;
+
+    /// Returns the counter of a page, allocating its chunk on first use.
+    u16& GetPageCount(u64 page);
+
+    /// Chunks of counters covering the guest address space, null until a page in them is cached.
+    /// Pages are only marked cached or uncached when their count moves from or to zero.
+    std::unique_ptr<std::unique_ptr<CounterChunk>[]> counter_chunks;
 
+    /// Guards the counters and the marks of the pages, updated by several caches.
     std::mutex pages_mutex;
 };
 
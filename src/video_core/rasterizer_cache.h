@@ -4,16 +4,14 @@
 
 #pragma once
 
-#include <mutex>
-#include <set>
+#include <algorithm>
 #include <unordered_map>
-
-#include <boost/icl/interval_map.hpp>
-#include <boost/range/iterator_range_core.hpp>
+#include <vector>
 
 #include "common/common_types.h"
 #include "core/settings.h"
 #include "video_core/gpu.h"
+#include "video_core/page_index.h"
 #include "video_core/rasterizer_interface.h"
 
 class RasterizerCacheObject {
@@ -81,8 +79,6 @@ public:
 
     /// Write any cached resources overlapping the specified region back to memory
     void FlushRegion(CacheAddr addr, std::size_t size) {
-        std::lock_guard lock{mutex};
-
         const auto& objects{GetSortedObjectsFromRegion(addr, size)};
         for (auto& object : objects) {
             FlushObject(object);
@@ -91,8 +87,6 @@ public:
 
     /// Mark the specified region as being invalidated
     void InvalidateRegion(CacheAddr addr, u64 size) {
-        std::lock_guard lock{mutex};
-
         const auto& objects{GetSortedObjectsFromRegion(addr, size)};
         for (auto& object : objects) {
             if (!object->IsRegistered()) {
@@ -105,10 +99,8 @@ public:
 
     /// Invalidates everything in the cache
     void InvalidateAll() {
-        std::lock_guard lock{mutex};
-
-        while (interval_cache.begin() != interval_cache.end()) {
-            Unregister(*interval_cache.begin()->second.begin());
+        while (!map_cache.empty()) {
+            Unregister(map_cache.begin()->second);
         }
     }
 
@@ -130,29 +122,23 @@ protected:
 
     /// Register an object into the cache
     virtual void Register(const T& object) {
-        std::lock_guard lock{mutex};
-
         object->SetIsRegistered(true);
-        interval_cache.add({GetInterval(object), ObjectSet{object}});
+        page_index.Insert(object->GetCacheAddr(), GetCacheAddrEnd(object), object);
         map_cache.insert({object->GetCacheAddr(), object});
         rasterizer.UpdatePagesCachedCount(object->GetCpuAddr(), object->GetSizeInBytes(), 1);
     }
 
     /// Unregisters an object from the cache
     virtual void Unregister(const T& object) {
-        std::lock_guard lock{mutex};
-
         object->SetIsRegistered(false);
         rasterizer.UpdatePagesCachedCount(object->GetCpuAddr(), object->GetSizeInBytes(), -1);
         const CacheAddr addr = object->GetCacheAddr();
-        interval_cache.subtract({GetInterval(object), ObjectSet{object}});
+        page_index.Erase(addr, GetCacheAddrEnd(object), object);
         map_cache.erase(addr);
     }
 
     /// Returns a ticks counter used for tracking when cached objects were last modified
     u64 GetModifiedTicks() {
-        std::lock_guard lock{mutex};
-
         return ++modified_ticks;
     }
 
@@ -160,8 +146,6 @@ protected:
 
     /// Flushes the specified object, updating appropriate cache state as needed
     void FlushObject(const T& object) {
-        std::lock_guard lock{mutex};
-
         if (!object->IsDirty()) {
             return;
         }
@@ -169,8 +153,6 @@ protected:
         object->MarkAsModified(false, *this);
     }
 
-    std::recursive_mutex mutex;
-
 private:
     /// Returns a list of cached objects from the specified memory region, ordered by access time
     std::vector<T> GetSortedObjectsFromRegion(CacheAddr addr, u64 size) {
@@ -179,15 +161,8 @@ private:
         }
 
         std::vector<T> objects;
-        const ObjectInterval interval{addr, addr + size};
-        for (auto& pair : boost::make_iterator_range(interval_cache.equal_range(interval))) {
-            for (auto& cached_object : pair.second) {
-                if (!cached_object) {
-                    continue;
-                }
-                objects.push_back(cached_object);
-            }
-        }
+        page_index.ForEachInRange(addr, addr + size,
+                                  [&objects](const T& object) { objects.push_back(object); });
 
         std::sort(objects.begin(), objects.end(), [](const T& a, const T& b) -> bool {
             return a->GetLastModifiedTicks() < b->GetLastModifiedTicks();
@@ -196,18 +171,15 @@ private:
         return objects;
     }
 
-    using ObjectSet = std::set<T>;
     using ObjectCache = std::unordered_map<CacheAddr, T>;
-    using IntervalCache = boost::icl::interval_map<CacheAddr, ObjectSet>;
-    using ObjectInterval = typename IntervalCache::interval_type;
 
-    static auto GetInterval(const T& object) {
-        return ObjectInterval::right_open(object->GetCacheAddr(),
-                                          object->GetCacheAddr() + object->GetSizeInBytes());
+    static CacheAddr GetCacheAddrEnd(const T& object) {
+        return object->GetCacheAddr() + object->GetSizeInBytes();
     }
 
     ObjectCache map_cache;
-    IntervalCache interval_cache; ///< Cache of objects
-    u64 modified_ticks{};         ///< Counter of cache state ticks, used for in-order flushing
+    /// Cached objects by the 4 KiB pages they cover
+    VideoCommon::PageIndex<T, 12> page_index;
+    u64 modified_ticks{}; ///< Counter of cache state ticks, used for in-order flushing
     VideoCore::RasterizerInterface& rasterizer;
 };
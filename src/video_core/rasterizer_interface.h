@@ -6,8 +6,10 @@
 
 #include <atomic>
 #include <functional>
+#include <optional>
 #include "common/common_types.h"
 #include "video_core/engines/fermi_2d.h"
+#include "video_core/engines/maxwell_dma.h"
 #include "video_core/gpu.h"
 
 namespace Tegra {
@@ -24,6 +26,23 @@ enum class LoadCallbackStage {
 };
 using DiskResourceLoadCallback = std::function<void(LoadCallbackStage, std::size_t, std::size_t)>;
 
+enum class QueryType {
+    SamplesPassed,
+};
+constexpr std::size_t NumQueryTypes = 1;
+
+/// Draws whose arguments the host GPU reads from guest GPU memory.
+struct IndirectDrawParams {
+    bool is_indexed;
+    /// Address of the first draw command, laid out as the OpenGL indirect draw commands.
+    GPUVAddr arguments_address;
+    /// Address of the number of draws, zero when max_draw_count draws are made.
+    GPUVAddr count_address;
+    u32 max_draw_count;
+    /// Bytes from one draw command to the next.
+    u32 stride;
+};
+
 class RasterizerInterface {
 public:
     virtual ~RasterizerInterface() {}
@@ -34,12 +53,32 @@ public:
     /// Draw the current batch of multiple instances of vertex arrays
     virtual bool DrawMultiBatch(bool is_indexed) = 0;
 
+    /// Emits the draws held back to be submitted together
+    virtual void FlushBatchedDraws() {}
+
+    /// Draws with arguments the host GPU reads itself, returns false when they have to be read on
+    /// the CPU instead
+    virtual bool DrawIndirect(const IndirectDrawParams& params) {
+        return false;
+    }
+
+    /// Returns true when the host GPU wrote a range that hasn't been flushed to guest memory yet
+    virtual bool IsGPUModified(GPUVAddr gpu_addr, u64 size) {
+        return false;
+    }
+
     /// Clear the current framebuffer
     virtual void Clear() = 0;
 
     /// Dispatches a compute shader invocation
     virtual void DispatchCompute(GPUVAddr code_addr) = 0;
 
+    /// Resets the counter of a query
+    virtual void ResetCounter(QueryType type) = 0;
+
+    /// Records a GPU query and caches it
+    virtual void Query(GPUVAddr gpu_addr, QueryType type, std::optional<u64> timestamp) = 0;
+
     /// Notify rasterizer that all caches should be flushed to Switch memory
     virtual void FlushAll() = 0;
 
@@ -59,6 +98,21 @@ public:
     /// Notify rasterizer that a frame is about to finish
     virtual void TickFrame() = 0;
 
+    /// Attempt to defer a syncpoint increment until the host GPU finishes the work submitted
+    /// before it. Returns false when the syncpoint has to be incremented right away.
+    virtual bool SignalSyncPoint(u32 syncpoint_id) {
+        return false;
+    }
+
+    /// Returns true when there are deferred syncpoint increments not released yet.
+    virtual bool HasPendingSyncPoints() const {
+        return false;
+    }
+
+    /// Increments the deferred syncpoints whose host GPU work has finished. When wait is true,
+    /// waits a bounded time for the oldest one to finish.
+    virtual void ReleaseSyncPoints(bool wait) {}
+
     /// Attempt to use a faster method to perform a surface copy
     virtual bool AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src,
                                        const Tegra::Engines::Fermi2D::Regs::Surface& dst,
@@ -66,6 +120,21 @@ public:
         return false;
     }
 
+    /// Attempt to perform a linear DMA copy of size bytes on the host GPU
+    virtual bool AccelerateDMABufferCopy(GPUVAddr src_addr, GPUVAddr dst_addr, u64 size) {
+        return false;
+    }
+
+    /// Attempt to perform a DMA copy from a block linear image to a linear buffer on the host GPU
+    virtual bool AccelerateDMAImageToBuffer(const Tegra::Engines::MaxwellDMA::Regs& regs) {
+        return false;
+    }
+
+    /// Attempt to perform a DMA copy from a linear buffer to a block linear image on the host GPU
+    virtual bool AccelerateDMABufferToImage(const Tegra::Engines::MaxwellDMA::Regs& regs) {
+        return false;
+    }
+
     /// Attempt to use a faster method to display the framebuffer to screen
     virtual bool AccelerateDisplay(const Tegra::FramebufferConfig& config, VAddr framebuffer_addr,
                                    u32 pixel_stride) {
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <optional>
 
@@ -38,6 +39,19 @@ public:
     /// Swap buffers (render frame)
     virtual void SwapBuffers(const Tegra::FramebufferConfig* framebuffer) = 0;
 
+    /// Finishes a frame without presenting it, a newer frame is about to replace it
+    virtual void DropFrame(const Tegra::FramebufferConfig* framebuffer) {
+        SwapBuffers(framebuffer);
+    }
+
+    /**
+     * Presents the newest frame to the framebuffer of the context current on the caller thread,
+     * for frontends presenting the frames themselves. It must not be called by the GPU thread.
+     * @param timeout Time to wait for a frame that was not presented yet
+     * @returns True if a frame was presented and the buffers of the window should be swapped
+     */
+    virtual bool TryPresent(std::chrono::milliseconds timeout) = 0;
+
     /// Initialize the renderer
     virtual bool Init() = 0;
 
@@ -55,6 +69,11 @@ public:
         return m_current_frame;
     }
 
+    /// Returns the number of frames presented or dropped so far, it may be read from any thread
+    u64 GetFinishedFrames() const {
+        return finished_frames.load(std::memory_order_acquire);
+    }
+
     RasterizerInterface& Rasterizer() {
         return *rasterizer;
     }
@@ -94,9 +113,16 @@ protected:
 
     RendererSettings renderer_settings;
 
+    /// Called by the renderer once it presented or dropped a frame
+    void FinishFrame() {
+        finished_frames.fetch_add(1, std::memory_order_release);
+    }
+
 private:
     /// Updates the framebuffer layout of the contained render window handle.
     void UpdateCurrentFramebufferLayout();
+
+    std::atomic<u64> finished_frames{0};
 };
 
 } // namespace VideoCore
@@ -0,0 +1,89 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+
+#include <glad/glad.h>
+
+#include "common/scope_exit.h"
+#include "core/frontend/emu_window.h"
+#include "video_core/renderer_opengl/gl_async_shaders.h"
+
+namespace OpenGL {
+
+AsyncShaders::AsyncShaders(Core::Frontend::EmuWindow& emu_window) {
+    // Leave most of the host threads to the CPU and GPU emulation, building is a background task.
+    const std::size_t num_workers =
+        std::max<std::size_t>(std::thread::hardware_concurrency() / 4, 1);
+    contexts.reserve(num_workers);
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        // On some platforms the shared context has to be created from the GUI thread
+        auto& context = contexts.emplace_back(emu_window.CreateSharedContext());
+        workers.emplace_back(&AsyncShaders::WorkerLoop, this, context.get());
+    }
+}
+
+AsyncShaders::~AsyncShaders() {
+    {
+        std::lock_guard lock{queue_mutex};
+        is_stopping = true;
+    }
+    queue_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void AsyncShaders::QueueBuild(std::shared_ptr<OGLProgram> target, BuildFunction build) {
+    {
+        std::lock_guard lock{queue_mutex};
+        pending.push_back(Job{std::move(target), std::move(build)});
+    }
+    queue_cv.notify_one();
+}
+
+void AsyncShaders::InstallCompleted() {
+    std::vector<Result> results;
+    {
+        std::lock_guard lock{completed_mutex};
+        if (completed.empty()) {
+            return;
+        }
+        results = std::move(completed);
+        completed.clear();
+    }
+    for (auto& result : results) {
+        *result.target = std::move(result.program);
+    }
+}
+
+void AsyncShaders::WorkerLoop(Core::Frontend::GraphicsContext* context) {
+    context->MakeCurrent();
+    SCOPE_EXIT({ return context->DoneCurrent(); });
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock{queue_mutex};
+            queue_cv.wait(lock, [this] { return is_stopping || !pending.empty(); });
+            if (is_stopping) {
+                return;
+            }
+            job = std::move(pending.front());
+            pending.pop_front();
+        }
+
+        OGLProgram program = job.build();
+
+        // Changes to shared objects are only guaranteed to be visible from other contexts once
+        // the commands that made them have completed.
+        glFinish();
+
+        std::lock_guard lock{completed_mutex};
+        completed.push_back(Result{std::move(job.target), std::move(program)});
+    }
+}
+
+} // namespace OpenGL
@@ -0,0 +1,72 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace Core::Frontend {
+class EmuWindow;
+class GraphicsContext;
+} // namespace Core::Frontend
+
+namespace OpenGL {
+
+/**
+ * Pool of worker threads with OpenGL contexts shared with the emulation window. Programs are built
+ * in the background and handed back to the GPU thread, which installs them before drawing.
+ */
+class AsyncShaders {
+public:
+    using BuildFunction = std::function<OGLProgram()>;
+
+    explicit AsyncShaders(Core::Frontend::EmuWindow& emu_window);
+    ~AsyncShaders();
+
+    /**
+     * Queues a program build.
+     * @param target Program object that receives the built program, it stays empty until then.
+     * @param build Function building the program. It runs on a worker thread, so it must not
+     *              access emulated GPU state.
+     */
+    void QueueBuild(std::shared_ptr<OGLProgram> target, BuildFunction build);
+
+    /// Moves the programs built since the last call into their targets, called from the GPU thread.
+    void InstallCompleted();
+
+private:
+    struct Job {
+        std::shared_ptr<OGLProgram> target;
+        BuildFunction build;
+    };
+
+    struct Result {
+        std::shared_ptr<OGLProgram> target;
+        OGLProgram program;
+    };
+
+    void WorkerLoop(Core::Frontend::GraphicsContext* context);
+
+    std::vector<std::unique_ptr<Core::Frontend::GraphicsContext>> contexts;
+    std::vector<std::thread> workers;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<Job> pending;
+    bool is_stopping = false;
+
+    std::mutex completed_mutex;
+    std::vector<Result> completed;
+};
+
+} // namespace OpenGL
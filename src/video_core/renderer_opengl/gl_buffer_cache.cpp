@@ -2,16 +2,20 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 
 #include <glad/glad.h>
 
+#include "common/alignment.h"
 #include "common/assert.h"
 #include "common/microprofile.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_opengl/gl_buffer_cache.h"
 #include "video_core/renderer_opengl/gl_device.h"
+#include "video_core/renderer_opengl/gl_fence_ring.h"
 #include "video_core/renderer_opengl/gl_rasterizer.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 
@@ -20,18 +24,93 @@ namespace OpenGL {
 using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 
 MICROPROFILE_DEFINE(OpenGL_Buffer_Download, "OpenGL", "Buffer Download", MP_RGB(192, 192, 128));
+MICROPROFILE_DEFINE(OpenGL_Buffer_DownloadWait, "OpenGL", "Buffer Download Wait",
+                    MP_RGB(192, 192, 128));
 
-CachedBufferBlock::CachedBufferBlock(CacheAddr cache_addr, const std::size_t size)
-    : VideoCommon::BufferBlock{cache_addr, size} {
+namespace {
+
+/// Size of the buffer asynchronous downloads are copied to.
+constexpr std::size_t DOWNLOAD_BUFFER_SIZE = 32 * 1024 * 1024;
+
+/// Largest range downloaded asynchronously, bigger ones would evict too many others.
+constexpr std::size_t MAX_ASYNC_DOWNLOAD_SIZE = DOWNLOAD_BUFFER_SIZE / 4;
+
+/// Size of the buffer objects blocks are sub-allocated from, larger blocks get their own.
+constexpr std::size_t ARENA_SIZE = 64 * 1024 * 1024;
+
+} // Anonymous namespace
+
+BufferArena::BufferArena(std::size_t size) : free_ranges{{0, size}} {
     gl_buffer.Create();
     glNamedBufferData(gl_buffer.handle, static_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_DRAW);
 }
 
-CachedBufferBlock::~CachedBufferBlock() = default;
+BufferArena::~BufferArena() = default;
+
+std::optional<std::size_t> BufferArena::Allocate(std::size_t size) {
+    const auto it = std::find_if(free_ranges.begin(), free_ranges.end(),
+                                 [size](const auto& range) { return range.second >= size; });
+    if (it == free_ranges.end()) {
+        return std::nullopt;
+    }
+    const auto [offset, free_size] = *it;
+    free_ranges.erase(it);
+    if (free_size > size) {
+        free_ranges.emplace(offset + size, free_size - size);
+    }
+    return offset;
+}
+
+bool BufferArena::Grow(std::size_t offset, std::size_t size, std::size_t new_size) {
+    const auto it = free_ranges.find(offset + size);
+    const std::size_t growth = new_size - size;
+    if (it == free_ranges.end() || it->second < growth) {
+        return false;
+    }
+    const std::size_t free_size = it->second;
+    free_ranges.erase(it);
+    if (free_size > growth) {
+        free_ranges.emplace(offset + new_size, free_size - growth);
+    }
+    return true;
+}
+
+void BufferArena::Free(std::size_t offset, std::size_t size) {
+    auto next = free_ranges.lower_bound(offset);
+    if (next != free_ranges.end() && next->first == offset + size) {
+        size += next->second;
+        next = free_ranges.erase(next);
+    }
+    if (next != free_ranges.begin()) {
+        const auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            previous->second += size;
+            return;
+        }
+    }
+    free_ranges.emplace_hint(next, offset, size);
+}
+
+CachedBufferBlock::CachedBufferBlock(CacheAddr cache_addr, std::size_t size,
+                                     std::shared_ptr<BufferArena> arena,
+                                     std::size_t storage_offset)
+    : VideoCommon::BufferBlock{cache_addr, size, storage_offset}, arena{std::move(arena)} {}
+
+CachedBufferBlock::~CachedBufferBlock() {
+    arena->Free(GetStorageOffset(), GetSize());
+}
 
 OGLBufferCache::OGLBufferCache(RasterizerOpenGL& rasterizer, Core::System& system,
                                const Device& device, std::size_t stream_size)
     : GenericBufferCache{rasterizer, system, std::make_unique<OGLStreamBuffer>(stream_size, true)} {
+    static constexpr GLbitfield download_flags =
+        GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    download_buffer.Create();
+    glNamedBufferStorage(download_buffer.handle, static_cast<GLsizeiptr>(DOWNLOAD_BUFFER_SIZE),
+                         nullptr, download_flags | GL_CLIENT_STORAGE_BIT);
+    download_pointer = static_cast<const u8*>(glMapNamedBufferRange(
+        download_buffer.handle, 0, static_cast<GLsizeiptr>(DOWNLOAD_BUFFER_SIZE), download_flags));
+
     if (!device.HasFastBufferSubData()) {
         return;
     }
@@ -44,15 +123,33 @@ OGLBufferCache::OGLBufferCache(RasterizerOpenGL& rasterizer, Core::System& syste
 }
 
 OGLBufferCache::~OGLBufferCache() {
+    glUnmapNamedBuffer(download_buffer.handle);
     glDeleteBuffers(static_cast<GLsizei>(std::size(cbufs)), std::data(cbufs));
 }
 
 Buffer OGLBufferCache::CreateBlock(CacheAddr cache_addr, std::size_t size) {
-    return std::make_shared<CachedBufferBlock>(cache_addr, size);
+    for (const auto& arena : arenas) {
+        if (const auto offset = arena->Allocate(size)) {
+            return std::make_shared<CachedBufferBlock>(cache_addr, size, arena, *offset);
+        }
+    }
+    auto arena = std::make_shared<BufferArena>(std::max(size, ARENA_SIZE));
+    const auto offset = arena->Allocate(size);
+    ASSERT(offset);
+    arenas.push_back(arena);
+    return std::make_shared<CachedBufferBlock>(cache_addr, size, std::move(arena), *offset);
+}
+
+bool OGLBufferCache::GrowBlock(const Buffer& buffer, std::size_t new_size) {
+    return buffer->GetArena().Grow(buffer->GetStorageOffset(), buffer->GetSize(), new_size);
 }
 
 void OGLBufferCache::WriteBarrier() {
-    glMemoryBarrier(GL_ALL_BARRIER_BITS);
+    // Written blocks are only read back as buffers or through texture buffers
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT |
+                    GL_UNIFORM_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT |
+                    GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT |
+                    GL_PIXEL_BUFFER_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
 }
 
 const GLuint* OGLBufferCache::ToHandle(const Buffer& buffer) {
@@ -92,4 +189,55 @@ OGLBufferCache::BufferInfo OGLBufferCache::ConstBufferUpload(const void* raw_poi
     return {&cbuf, 0};
 }
 
+u64 OGLBufferCache::QueueDownload(const Buffer& buffer, std::size_t offset, std::size_t size) {
+    if (download_pointer == nullptr || size > MAX_ASYNC_DOWNLOAD_SIZE) {
+        return 0;
+    }
+    std::size_t download_offset = Common::AlignUp(download_cursor, 4);
+    if (download_offset + size > DOWNLOAD_BUFFER_SIZE) {
+        download_offset = 0;
+    }
+    // Downloads that weren't flushed before the ring wrapped around are lost, the GPU executes
+    // the copies in order so the new one can be queued right away
+    const std::size_t download_end = download_offset + size;
+    while (!downloads.empty() && downloads.front().offset < download_end &&
+           download_offset < downloads.front().offset + downloads.front().size) {
+        downloads.pop_front();
+    }
+    download_cursor = download_end;
+
+    glCopyNamedBufferSubData(*buffer->GetHandle(), download_buffer.handle,
+                             static_cast<GLintptr>(offset), static_cast<GLintptr>(download_offset),
+                             static_cast<GLsizeiptr>(size));
+
+    const u64 token = next_download_token++;
+    downloads.push_back({token, download_offset, size, nullptr});
+    return token;
+}
+
+void OGLBufferCache::FenceDownloads() {
+    auto fence = std::make_shared<OGLSync>();
+    fence->Create();
+    for (auto it = downloads.rbegin(); it != downloads.rend() && !it->fence; ++it) {
+        it->fence = fence;
+    }
+}
+
+bool OGLBufferCache::FinishDownload(u64 token, u8* data, std::size_t size) {
+    const auto it = std::find_if(downloads.begin(), downloads.end(),
+                                 [token](const AsyncDownload& download) {
+                                     return download.token == token;
+                                 });
+    if (it == downloads.end() || it->size != size || !it->fence) {
+        return false;
+    }
+    {
+        MICROPROFILE_SCOPE(OpenGL_Buffer_DownloadWait);
+        WaitFence(*it->fence);
+    }
+    std::memcpy(data, download_pointer + it->offset, size);
+    downloads.erase(it);
+    return true;
+}
+
 } // namespace OpenGL
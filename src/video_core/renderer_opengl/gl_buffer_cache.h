@@ -5,7 +5,11 @@
 #pragma once
 
 #include <array>
+#include <deque>
+#include <map>
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "common/common_types.h"
 #include "video_core/buffer_cache/buffer_cache.h"
@@ -29,10 +33,20 @@ class CachedBufferBlock;
 using Buffer = std::shared_ptr<CachedBufferBlock>;
 using GenericBufferCache = VideoCommon::BufferCache<Buffer, GLuint, OGLStreamBuffer>;
 
-class CachedBufferBlock : public VideoCommon::BufferBlock {
+/// Large buffer object the storage of many blocks is sub-allocated from.
+class BufferArena {
 public:
-    explicit CachedBufferBlock(CacheAddr cache_addr, const std::size_t size);
-    ~CachedBufferBlock();
+    explicit BufferArena(std::size_t size);
+    ~BufferArena();
+
+    /// Returns the offset of a free range of the given size, or empty when there is none.
+    std::optional<std::size_t> Allocate(std::size_t size);
+
+    /// Grows an allocated range in place. Returns false when the storage after it isn't free.
+    bool Grow(std::size_t offset, std::size_t size, std::size_t new_size);
+
+    /// Returns an allocated range to the arena.
+    void Free(std::size_t offset, std::size_t size);
 
     const GLuint* GetHandle() const {
         return &gl_buffer.handle;
@@ -40,6 +54,25 @@ public:
 
 private:
     OGLBuffer gl_buffer{};
+    std::map<std::size_t, std::size_t> free_ranges; ///< Offset to size, never adjacent
+};
+
+class CachedBufferBlock : public VideoCommon::BufferBlock {
+public:
+    explicit CachedBufferBlock(CacheAddr cache_addr, std::size_t size,
+                               std::shared_ptr<BufferArena> arena, std::size_t storage_offset);
+    ~CachedBufferBlock();
+
+    const GLuint* GetHandle() const {
+        return arena->GetHandle();
+    }
+
+    BufferArena& GetArena() const {
+        return *arena;
+    }
+
+private:
+    std::shared_ptr<BufferArena> arena;
 };
 
 class OGLBufferCache final : public GenericBufferCache {
@@ -72,7 +105,33 @@ protected:
 
     BufferInfo ConstBufferUpload(const void* raw_pointer, std::size_t size) override;
 
+    u64 QueueDownload(const Buffer& buffer, std::size_t offset, std::size_t size) override;
+
+    void FenceDownloads() override;
+
+    bool FinishDownload(u64 token, u8* data, std::size_t size) override;
+
+    bool GrowBlock(const Buffer& buffer, std::size_t new_size) override;
+
 private:
+    /// Arenas the blocks are allocated from, blocks keep theirs alive
+    std::vector<std::shared_ptr<BufferArena>> arenas;
+
+    /// Range of the download buffer a block range was copied to
+    struct AsyncDownload {
+        u64 token{};
+        std::size_t offset{};
+        std::size_t size{};
+        std::shared_ptr<OGLSync> fence;
+    };
+
+    /// Persistently mapped buffer the downloads are copied to, used as a ring
+    OGLBuffer download_buffer;
+    const u8* download_pointer = nullptr;
+    std::size_t download_cursor = 0;
+    std::deque<AsyncDownload> downloads; ///< In the order they were copied to the ring
+    u64 next_download_token = 1;
+
     std::size_t cbuf_cursor = 0;
     std::array<GLuint, Tegra::Engines::Maxwell3D::Regs::MaxConstBuffers *
                            Tegra::Engines::Maxwell3D::Regs::MaxShaderProgram>
@@ -48,6 +48,29 @@ bool HasExtension(const std::vector<std::string_view>& images, std::string_view
     return std::find(images.begin(), images.end(), extension) != images.end();
 }
 
+bool TestSubgroupIntrinsics(const std::vector<std::string_view>& extensions) {
+    if (!HasExtension(extensions, "GL_KHR_shader_subgroup")) {
+        return false;
+    }
+
+    // Tokens of GL_KHR_shader_subgroup, glad doesn't know about the extension
+    constexpr GLenum SUBGROUP_SIZE_KHR = 0x9532;
+    constexpr GLenum SUBGROUP_SUPPORTED_STAGES_KHR = 0x9533;
+    constexpr GLenum SUBGROUP_SUPPORTED_FEATURES_KHR = 0x9534;
+    constexpr GLint SUBGROUP_FEATURE_VOTE_BIT_KHR = 0x2;
+    constexpr GLint SUBGROUP_FEATURE_BALLOT_BIT_KHR = 0x8;
+    constexpr GLint SUBGROUP_FEATURE_SHUFFLE_BIT_KHR = 0x10;
+
+    constexpr u32 guest_warp_size = 32;
+    constexpr GLint stages = GL_VERTEX_SHADER_BIT | GL_GEOMETRY_SHADER_BIT |
+                             GL_FRAGMENT_SHADER_BIT | GL_COMPUTE_SHADER_BIT;
+    constexpr GLint features = SUBGROUP_FEATURE_VOTE_BIT_KHR | SUBGROUP_FEATURE_BALLOT_BIT_KHR |
+                               SUBGROUP_FEATURE_SHUFFLE_BIT_KHR;
+    return GetInteger<u32>(SUBGROUP_SIZE_KHR) >= guest_warp_size &&
+           (GetInteger<GLint>(SUBGROUP_SUPPORTED_STAGES_KHR) & stages) == stages &&
+           (GetInteger<GLint>(SUBGROUP_SUPPORTED_FEATURES_KHR) & features) == features;
+}
+
 } // Anonymous namespace
 
 Device::Device() {
@@ -62,6 +85,8 @@ Device::Device() {
     max_varyings = GetInteger<u32>(GL_MAX_VARYING_VECTORS);
     has_warp_intrinsics = GLAD_GL_NV_gpu_shader5 && GLAD_GL_NV_shader_thread_group &&
                           GLAD_GL_NV_shader_thread_shuffle;
+    has_subgroup_intrinsics = TestSubgroupIntrinsics(extensions);
+    has_native_half_float = GLAD_GL_NV_gpu_shader5 || GLAD_GL_AMD_gpu_shader_half_float;
     has_vertex_viewport_layer = GLAD_GL_ARB_shader_viewport_layer_array;
     has_image_load_formatted = HasExtension(extensions, "GL_EXT_shader_image_load_formatted");
     has_variable_aoffi = TestVariableAoffi();
@@ -69,6 +94,8 @@ Device::Device() {
     has_precise_bug = TestPreciseBug();
     has_fast_buffer_sub_data = is_nvidia;
 
+    LOG_INFO(Render_OpenGL, "Renderer_SubgroupIntrinsics: {}", has_subgroup_intrinsics);
+    LOG_INFO(Render_OpenGL, "Renderer_NativeHalfFloat: {}", has_native_half_float);
     LOG_INFO(Render_OpenGL, "Renderer_VariableAOFFI: {}", has_variable_aoffi);
     LOG_INFO(Render_OpenGL, "Renderer_ComponentIndexingBug: {}", has_component_indexing_bug);
     LOG_INFO(Render_OpenGL, "Renderer_PreciseBug: {}", has_precise_bug);
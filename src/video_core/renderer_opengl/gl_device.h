@@ -34,6 +34,16 @@ public:
         return has_warp_intrinsics;
     }
 
+    /// Returns true when GL_KHR_shader_subgroup can implement the warp intrinsics of the guest,
+    /// with subgroups at least as wide as its warps.
+    bool HasSubgroupIntrinsics() const {
+        return has_subgroup_intrinsics;
+    }
+
+    bool HasNativeHalfFloat() const {
+        return has_native_half_float;
+    }
+
     bool HasVertexViewportLayer() const {
         return has_vertex_viewport_layer;
     }
@@ -68,6 +78,8 @@ private:
     u32 max_vertex_attributes{};
     u32 max_varyings{};
     bool has_warp_intrinsics{};
+    bool has_subgroup_intrinsics{};
+    bool has_native_half_float{};
     bool has_vertex_viewport_layer{};
     bool has_image_load_formatted{};
     bool has_variable_aoffi{};
@@ -0,0 +1,24 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <glad/glad.h>
+
+#include "video_core/renderer_opengl/gl_fence_ring.h"
+
+namespace OpenGL {
+
+namespace {
+
+/// Time to wait for a fence before checking it again, in nanoseconds.
+constexpr GLuint64 FENCE_TIMEOUT = 1'000'000'000;
+
+} // Anonymous namespace
+
+void WaitFence(const OGLSync& fence) {
+    while (glClientWaitSync(fence.handle, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT) ==
+           GL_TIMEOUT_EXPIRED) {
+    }
+}
+
+} // namespace OpenGL
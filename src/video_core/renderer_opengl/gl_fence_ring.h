@@ -0,0 +1,48 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace OpenGL {
+
+/// Waits on the CPU until the GPU signals a fence.
+void WaitFence(const OGLSync& fence);
+
+/**
+ * Fences guarding the parts of a persistently mapped buffer that is written in order and wraps
+ * around. A part is only written again after the commands that used it have finished.
+ */
+template <std::size_t N>
+class FenceRing {
+public:
+    /// Fences the commands issued so far that use a part. A newer fence signals after the older
+    /// ones, so it replaces them.
+    void Signal(std::size_t index) {
+        fences[index].Release();
+        fences[index].Create();
+    }
+
+    /// Returns true when a part has a fence that hasn't been waited on.
+    bool IsPending(std::size_t index) const {
+        return fences[index].handle != 0;
+    }
+
+    /// Waits for the GPU to be done with a part, it returns right away when the part is unused.
+    void Wait(std::size_t index) {
+        if (IsPending(index)) {
+            WaitFence(fences[index]);
+            fences[index].Release();
+        }
+    }
+
+private:
+    std::array<OGLSync, N> fences;
+};
+
+} // namespace OpenGL
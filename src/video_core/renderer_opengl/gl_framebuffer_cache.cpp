@@ -5,6 +5,7 @@
 #include <tuple>
 
 #include "common/cityhash.h"
+#include "common/logging/log.h"
 #include "common/scope_exit.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/renderer_opengl/gl_framebuffer_cache.h"
@@ -19,11 +20,16 @@ FramebufferCacheOpenGL::FramebufferCacheOpenGL() = default;
 FramebufferCacheOpenGL::~FramebufferCacheOpenGL() = default;
 
 GLuint FramebufferCacheOpenGL::GetFramebuffer(const FramebufferCacheKey& key) {
+    if (last_framebuffer != 0 && key == last_key) {
+        return last_framebuffer;
+    }
     const auto [entry, is_cache_miss] = cache.try_emplace(key);
     auto& framebuffer{entry->second};
     if (is_cache_miss) {
         framebuffer = CreateFramebuffer(key);
     }
+    last_key = key;
+    last_framebuffer = framebuffer.handle;
     return framebuffer.handle;
 }
 
@@ -52,6 +58,11 @@ OGLFramebuffer FramebufferCacheOpenGL::CreateFramebuffer(const FramebufferCacheK
                          GL_DRAW_FRAMEBUFFER);
     }
 
+    const GLenum status = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_ERROR(Render_OpenGL, "Framebuffer is incomplete, status=0x{:04X}", status);
+    }
+
     return framebuffer;
 }
 
@@ -58,10 +58,15 @@ public:
     GLuint GetFramebuffer(const FramebufferCacheKey& key);
 
 private:
+    /// Creates a framebuffer with the attachments of the key, it's only validated here.
     OGLFramebuffer CreateFramebuffer(const FramebufferCacheKey& key);
 
     OpenGLState local_state;
     std::unordered_map<FramebufferCacheKey, OGLFramebuffer> cache;
+
+    /// Last requested key, render targets are usually requested again without changes.
+    FramebufferCacheKey last_key;
+    GLuint last_framebuffer = 0;
 };
 
 } // namespace OpenGL
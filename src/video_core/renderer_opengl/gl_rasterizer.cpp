@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <array>
 #include <bitset>
+#include <limits>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -49,6 +50,34 @@ MICROPROFILE_DEFINE(OpenGL_Blits, "OpenGL", "Blits", MP_RGB(128, 128, 192));
 MICROPROFILE_DEFINE(OpenGL_CacheManagement, "OpenGL", "Cache Mgmt", MP_RGB(100, 255, 100));
 MICROPROFILE_DEFINE(OpenGL_PrimitiveAssembly, "OpenGL", "Prim Asmbl", MP_RGB(255, 100, 100));
 
+/// Time to wait for the oldest pending syncpoint before checking the command queue again, in
+/// nanoseconds.
+constexpr GLuint64 SYNC_POINT_WAIT_TIMEOUT = 1'000'000;
+
+/// Reads the texture handle of a draw's sampler entry from the const buffers of its stage.
+static Tegra::Texture::TextureHandle GetGraphicsTextureHandle(
+    const Tegra::Engines::Maxwell3D& maxwell3d, Maxwell::ShaderStage stage,
+    const GLShader::SamplerEntry& entry) {
+    const auto shader_type = static_cast<Tegra::Engines::ShaderType>(stage);
+    if (!entry.IsBindless()) {
+        const u64 offset = entry.GetOffset() * sizeof(Tegra::Texture::TextureHandle);
+        return maxwell3d.AccessConstBuffer32(shader_type, maxwell3d.regs.tex_cb_index, offset);
+    }
+    return maxwell3d.AccessConstBuffer32(shader_type, entry.GetBuffer(), entry.GetOffset());
+}
+
+/// Reads the texture handle of a kernel's sampler or image entry from its const buffer.
+template <typename Entry>
+Tegra::Texture::TextureHandle GetComputeTextureHandle(const Tegra::Engines::KeplerCompute& compute,
+                                                      const Entry& entry) {
+    constexpr auto shader_type = Tegra::Engines::ShaderType::Compute;
+    if (!entry.IsBindless()) {
+        const u64 offset = entry.GetOffset() * sizeof(Tegra::Texture::TextureHandle);
+        return compute.AccessConstBuffer32(shader_type, compute.regs.tex_cb_index, offset);
+    }
+    return compute.AccessConstBuffer32(shader_type, entry.GetBuffer(), entry.GetOffset());
+}
+
 static std::size_t GetConstBufferSize(const Tegra::Engines::ConstBufferInfo& buffer,
                                       const GLShader::ConstBufferEntry& entry) {
     if (!entry.IsIndirect()) {
@@ -64,10 +93,53 @@ static std::size_t GetConstBufferSize(const Tegra::Engines::ConstBufferInfo& buf
     return buffer.size;
 }
 
+/// Returns the resolution scale of the first bound attachment. Attachments of different scales
+/// can't be rendered together, the rest are expected to match it.
+static u32 GetAttachmentsScale(const View& zeta, const View* colors, std::size_t num_colors) {
+    if (zeta) {
+        return zeta->GetSurfaceParams().resolution_scale;
+    }
+    for (std::size_t index = 0; index < num_colors; ++index) {
+        if (colors[index]) {
+            return colors[index]->GetSurfaceParams().resolution_scale;
+        }
+    }
+    return 1;
+}
+
+/// Returns the rectangle a clear is restricted to in guest texels. It's unbounded when the clear
+/// isn't restricted, the texture cache clamps it to the size of the targets.
+static Common::Rectangle<u32> GetClearRect(const Maxwell& regs) {
+    constexpr u32 unbounded = std::numeric_limits<u32>::max();
+    Common::Rectangle<u32> rect{0, 0, unbounded, unbounded};
+    const auto intersect = [&rect](u32 left, u32 top, u32 right, u32 bottom) {
+        rect.left = std::max(rect.left, left);
+        rect.top = std::max(rect.top, top);
+        rect.right = std::max(rect.left, std::min(rect.right, right));
+        rect.bottom = std::max(rect.top, std::min(rect.bottom, bottom));
+    };
+    if (regs.clear_flags.scissor && regs.scissor_test[0].enable) {
+        const auto& scissor = regs.scissor_test[0];
+        intersect(scissor.min_x, scissor.min_y, scissor.max_x, scissor.max_y);
+    }
+    if (regs.clear_flags.viewport) {
+        const auto& viewport = regs.viewport_transform[0];
+        const auto x = static_cast<u32>(viewport.GetX());
+        const auto y = static_cast<u32>(viewport.GetY());
+        intersect(x, y, x + static_cast<u32>(std::max(viewport.GetWidth(), 0)),
+                  y + static_cast<u32>(std::max(viewport.GetHeight(), 0)));
+    }
+    return rect;
+}
+
 RasterizerOpenGL::RasterizerOpenGL(Core::System& system, Core::Frontend::EmuWindow& emu_window,
                                    ScreenInfo& info)
     : texture_cache{system, *this, device}, shader_cache{*this, system, emu_window, device},
-      system{system}, screen_info{info}, buffer_cache{*this, system, device, STREAM_BUFFER_SIZE} {
+      system{system}, screen_info{info}, buffer_cache{*this, system, device, STREAM_BUFFER_SIZE},
+      query_cache{system, *this}, graphics_tic_table{*this, system.GPU().MemoryManager()},
+      graphics_tsc_table{*this, system.GPU().MemoryManager()},
+      compute_tic_table{*this, system.GPU().MemoryManager()},
+      compute_tsc_table{*this, system.GPU().MemoryManager()} {
     shader_program_manager = std::make_unique<GLShader::ProgramManager>();
     state.draw.shader_program = 0;
     state.Apply();
@@ -91,67 +163,66 @@ GLuint RasterizerOpenGL::SetupVertexFormat() {
     auto& gpu = system.GPU().Maxwell3D();
     const auto& regs = gpu.regs;
 
+    if (vertex_array.handle == 0) {
+        vertex_array.Create();
+
+        // Eventhough we are using DSA to create this vertex array, there is a bug on Intel's blob
+        // that fails to properly create the vertex array if it's not bound even after creating it
+        // with glCreateVertexArrays
+        state.draw.vertex_array = vertex_array.handle;
+        state.ApplyVertexArrayState();
+    }
+    const GLuint vao = vertex_array.handle;
+    state.draw.vertex_array = vao;
+
     if (!gpu.dirty.vertex_attrib_format) {
-        return state.draw.vertex_array;
+        return vao;
     }
     gpu.dirty.vertex_attrib_format = false;
 
     MICROPROFILE_SCOPE(OpenGL_VAO);
 
-    auto [iter, is_cache_miss] = vertex_array_cache.try_emplace(regs.vertex_attrib_format);
-    auto& vao_entry = iter->second;
+    // Use the vertex array as-is, assumes that the data is formatted correctly for OpenGL.
+    // Only the first 16 vertex attributes are specified, as we don't know which ones are actually
+    // used until shader time. Note, Tegra technically supports 32, but we're capping this to 16
+    // for now to avoid OpenGL errors.
+    // TODO(Subv): Analyze the shader to identify which attributes are actually used and don't
+    // assume every shader uses them all.
+    for (u32 index = 0; index < 16; ++index) {
+        if (!gpu.dirty.vertex_attrib[index]) {
+            continue;
+        }
+        gpu.dirty.vertex_attrib[index] = false;
 
-    if (is_cache_miss) {
-        vao_entry.Create();
-        const GLuint vao = vao_entry.handle;
+        const auto& attrib = regs.vertex_attrib_format[index];
 
-        // Eventhough we are using DSA to create this vertex array, there is a bug on Intel's blob
-        // that fails to properly create the vertex array if it's not bound even after creating it
-        // with glCreateVertexArrays
-        state.draw.vertex_array = vao;
-        state.ApplyVertexArrayState();
-
-        // Use the vertex array as-is, assumes that the data is formatted correctly for OpenGL.
-        // Enables the first 16 vertex attributes always, as we don't know which ones are actually
-        // used until shader time. Note, Tegra technically supports 32, but we're capping this to 16
-        // for now to avoid OpenGL errors.
-        // TODO(Subv): Analyze the shader to identify which attributes are actually used and don't
-        // assume every shader uses them all.
-        for (u32 index = 0; index < 16; ++index) {
-            const auto& attrib = regs.vertex_attrib_format[index];
-
-            // Ignore invalid attributes.
-            if (!attrib.IsValid())
-                continue;
-
-            const auto& buffer = regs.vertex_array[attrib.buffer];
-            LOG_TRACE(Render_OpenGL,
-                      "vertex attrib {}, count={}, size={}, type={}, offset={}, normalize={}",
-                      index, attrib.ComponentCount(), attrib.SizeString(), attrib.TypeString(),
-                      attrib.offset.Value(), attrib.IsNormalized());
-
-            ASSERT(buffer.IsEnabled());
-
-            glEnableVertexArrayAttrib(vao, index);
-            if (attrib.type == Tegra::Engines::Maxwell3D::Regs::VertexAttribute::Type::SignedInt ||
-                attrib.type ==
-                    Tegra::Engines::Maxwell3D::Regs::VertexAttribute::Type::UnsignedInt) {
-                glVertexArrayAttribIFormat(vao, index, attrib.ComponentCount(),
-                                           MaxwellToGL::VertexType(attrib), attrib.offset);
-            } else {
-                glVertexArrayAttribFormat(
-                    vao, index, attrib.ComponentCount(), MaxwellToGL::VertexType(attrib),
-                    attrib.IsNormalized() ? GL_TRUE : GL_FALSE, attrib.offset);
-            }
-            glVertexArrayAttribBinding(vao, index, attrib.buffer);
+        // Disable invalid attributes.
+        if (!attrib.IsValid()) {
+            glDisableVertexArrayAttrib(vao, index);
+            continue;
         }
-    }
 
-    // Rebinding the VAO invalidates the vertex buffer bindings.
-    gpu.dirty.ResetVertexArrays();
+        const auto& buffer = regs.vertex_array[attrib.buffer];
+        LOG_TRACE(Render_OpenGL,
+                  "vertex attrib {}, count={}, size={}, type={}, offset={}, normalize={}", index,
+                  attrib.ComponentCount(), attrib.SizeString(), attrib.TypeString(),
+                  attrib.offset.Value(), attrib.IsNormalized());
 
-    state.draw.vertex_array = vao_entry.handle;
-    return vao_entry.handle;
+        ASSERT(buffer.IsEnabled());
+
+        glEnableVertexArrayAttrib(vao, index);
+        if (attrib.type == Tegra::Engines::Maxwell3D::Regs::VertexAttribute::Type::SignedInt ||
+            attrib.type == Tegra::Engines::Maxwell3D::Regs::VertexAttribute::Type::UnsignedInt) {
+            glVertexArrayAttribIFormat(vao, index, attrib.ComponentCount(),
+                                       MaxwellToGL::VertexType(attrib), attrib.offset);
+        } else {
+            glVertexArrayAttribFormat(vao, index, attrib.ComponentCount(),
+                                      MaxwellToGL::VertexType(attrib),
+                                      attrib.IsNormalized() ? GL_TRUE : GL_FALSE, attrib.offset);
+        }
+        glVertexArrayAttribBinding(vao, index, attrib.buffer);
+    }
+    return vao;
 }
 
 void RasterizerOpenGL::SetupVertexBuffer(GLuint vao) {
@@ -229,15 +300,51 @@ GLintptr RasterizerOpenGL::SetupIndexBuffer() {
     MICROPROFILE_SCOPE(OpenGL_Index);
     const auto& regs = system.GPU().Maxwell3D().regs;
     const std::size_t size = CalculateIndexBufferSize();
-    const auto [buffer, offset] = buffer_cache.UploadMemory(regs.index_array.IndexStart(), size);
+    const GPUVAddr address =
+        indirect_draw ? regs.index_array.StartAddress() : regs.index_array.IndexStart();
+    const auto [buffer, offset] = buffer_cache.UploadMemory(address, size);
     vertex_array_pushbuffer.SetIndexBuffer(buffer);
+    indirect_index_buffer = buffer;
     return offset;
 }
 
-void RasterizerOpenGL::SetupShaders(GLenum primitive_mode) {
+void RasterizerOpenGL::SetupIndirectBuffers() {
+    if (!indirect_draw) {
+        return;
+    }
+    const std::size_t arguments_size =
+        static_cast<std::size_t>(indirect_draw->max_draw_count) * indirect_draw->stride;
+    indirect_arguments =
+        buffer_cache.UploadMemory(indirect_draw->arguments_address, arguments_size);
+    if (indirect_draw->count_address != 0) {
+        indirect_count = buffer_cache.UploadMemory(indirect_draw->count_address, sizeof(u32));
+    }
+}
+
+bool RasterizerOpenGL::SetupShaders(GLenum primitive_mode) {
     MICROPROFILE_SCOPE(OpenGL_Shader);
     auto& gpu = system.GPU().Maxwell3D();
 
+    shader_cache.InstallAsyncShaders();
+
+    // Fetch the programs first, so the textures missing the cache start decoding in the
+    // background while the resources of the stages are set up
+    std::array<Shader, Maxwell::MaxShaderProgram> shaders;
+    for (std::size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
+        if (!gpu.regs.IsShaderConfigEnabled(index)) {
+            continue;
+        }
+        const auto program{static_cast<Maxwell::ShaderProgram>(index)};
+        shaders[index] = shader_cache.GetStageProgram(program);
+
+        const std::size_t stage{index == 0 ? 0 : index - 1};
+        PrefetchDrawTextures(static_cast<Maxwell::ShaderStage>(stage), shaders[index]);
+        if (program == Maxwell::ShaderProgram::VertexA) {
+            ++index;
+        }
+    }
+
+    bool is_ready = true;
     BaseBindings base_bindings;
     std::array<bool, Maxwell::NumClipDistances> clip_distances{};
 
@@ -267,7 +374,7 @@ void RasterizerOpenGL::SetupShaders(GLenum primitive_mode) {
         // Bind the emulation info buffer
         bind_ubo_pushbuffer.Push(buffer, offset, static_cast<GLsizeiptr>(sizeof(ubo)));
 
-        Shader shader{shader_cache.GetStageProgram(program)};
+        const Shader& shader{shaders[index]};
 
         const auto stage_enum = static_cast<Maxwell::ShaderStage>(stage);
         SetupDrawConstBuffers(stage_enum, shader);
@@ -276,6 +383,10 @@ void RasterizerOpenGL::SetupShaders(GLenum primitive_mode) {
 
         const ProgramVariant variant{base_bindings, primitive_mode, texture_buffer_usage};
         const auto [program_handle, next_bindings] = shader->GetProgramHandle(variant);
+        if (program_handle == 0) {
+            // The program is still being built in the background.
+            is_ready = false;
+        }
 
         switch (program) {
         case Maxwell::ShaderProgram::VertexA:
@@ -313,6 +424,7 @@ void RasterizerOpenGL::SetupShaders(GLenum primitive_mode) {
     SyncClipEnabled(clip_distances);
 
     gpu.dirty.shaders = false;
+    return is_ready;
 }
 
 std::size_t RasterizerOpenGL::CalculateVertexArraysSize() const {
@@ -336,6 +448,12 @@ std::size_t RasterizerOpenGL::CalculateVertexArraysSize() const {
 std::size_t RasterizerOpenGL::CalculateIndexBufferSize() const {
     const auto& regs = system.GPU().Maxwell3D().regs;
 
+    if (indirect_draw) {
+        // The indices an indirect draw reads are only known by the host GPU
+        const GPUVAddr start = regs.index_array.StartAddress();
+        const GPUVAddr end = regs.index_array.EndAddress();
+        return end >= start ? static_cast<std::size_t>(end - start + 1) : 0;
+    }
     return static_cast<std::size_t>(regs.index_array.count) *
            static_cast<std::size_t>(regs.index_array.FormatSizeInBytes());
 }
@@ -359,6 +477,7 @@ void RasterizerOpenGL::ConfigureFramebuffers() {
 
     const auto& regs = gpu.regs;
     state.framebuffer_srgb.enabled = regs.framebuffer_srgb != 0;
+    state.MarkDirtySRgb();
     //UNIMPLEMENTED_IF(regs.rt_separate_frag_data == 0);
 
     // Bind the framebuffer surfaces
@@ -388,12 +507,19 @@ void RasterizerOpenGL::ConfigureFramebuffers() {
 
     texture_cache.GuardRenderTargets(false);
 
+    // Viewports and scissors are synced before the render targets are known
+    const u32 scale = GetAttachmentsScale(fbkey.zeta, fbkey.colors.data(), fbkey.colors.size());
+    if (scale != render_scale) {
+        render_scale = scale;
+        SyncViewport(state, render_scale);
+        SyncScissorTest(state, render_scale);
+    }
+
     state.draw.draw_framebuffer = framebuffer_cache.GetFramebuffer(fbkey);
-    SyncViewport(state);
 }
 
-void RasterizerOpenGL::ConfigureClearFramebuffer(OpenGLState& current_state, bool using_color_fb,
-                                                 bool using_depth_fb, bool using_stencil_fb) {
+u32 RasterizerOpenGL::ConfigureClearFramebuffer(OpenGLState& current_state, bool using_color_fb,
+                                                bool using_depth_fb, bool using_stencil_fb) {
     auto& gpu = system.GPU().Maxwell3D();
     const auto& regs = gpu.regs;
 
@@ -434,9 +560,12 @@ void RasterizerOpenGL::ConfigureClearFramebuffer(OpenGLState& current_state, boo
         glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, 0,
                                0);
     }
+    return GetAttachmentsScale(depth_surface, &color_surface, 1);
 }
 
 void RasterizerOpenGL::Clear() {
+    FlushBatchedDraws();
+
     const auto& maxwell3d = system.GPU().Maxwell3D();
 
     if (!maxwell3d.ShouldExecute()) {
@@ -513,11 +642,44 @@ void RasterizerOpenGL::Clear() {
         return;
     }
 
-    ConfigureClearFramebuffer(clear_state, use_color, use_depth, use_stencil);
+    const u32 scale = ConfigureClearFramebuffer(clear_state, use_color, use_depth, use_stencil);
 
-    SyncViewport(clear_state);
+    // Targets that already hold the clear value in the cleared rectangle are skipped
+    const Common::Rectangle<u32> clear_rect = GetClearRect(regs);
+    if (use_color) {
+        const std::size_t index = regs.clear_buffers.RT;
+        VideoCommon::ClearValue value;
+        std::copy(std::begin(regs.clear_color), std::end(regs.clear_color), value.color.begin());
+        if (!regs.clear_buffers.R || !regs.clear_buffers.G || !regs.clear_buffers.B ||
+            !regs.clear_buffers.A) {
+            texture_cache.MarkColorBufferInUse(index);
+        } else if (texture_cache.MarkColorBufferCleared(index, value, clear_rect)) {
+            use_color = false;
+        }
+    }
+    if (const View depth_surface = texture_cache.GetDepthBufferSurface(false);
+        depth_surface && (use_depth || use_stencil)) {
+        const bool has_stencil =
+            depth_surface->GetSurfaceParams().type == SurfaceType::DepthStencil;
+        // Masked stencil clears only write a part of the stencil bits
+        const bool clears_stencil = use_stencil && !regs.clear_flags.stencil;
+        VideoCommon::ClearValue value;
+        value.depth = regs.clear_depth;
+        value.stencil = has_stencil ? regs.clear_stencil : 0;
+        if (!use_depth || (has_stencil && !clears_stencil)) {
+            texture_cache.MarkDepthBufferInUse();
+        } else if (texture_cache.MarkDepthBufferCleared(value, clear_rect)) {
+            use_depth = false;
+            use_stencil = false;
+        }
+    }
+    if (!use_color && !use_depth && !use_stencil) {
+        return;
+    }
+
+    SyncViewport(clear_state, scale);
     if (regs.clear_flags.scissor) {
-        SyncScissorTest(clear_state);
+        SyncScissorTest(clear_state, scale);
     }
 
     if (regs.clear_flags.viewport) {
@@ -540,9 +702,11 @@ void RasterizerOpenGL::Clear() {
     }
 }
 
-void RasterizerOpenGL::DrawPrelude() {
+bool RasterizerOpenGL::DrawPrelude() {
     auto& gpu = system.GPU().Maxwell3D();
 
+    query_cache.UpdateCounters();
+
     SyncColorMask();
     SyncFragmentColorClampState();
     SyncMultiSampleState();
@@ -552,12 +716,32 @@ void RasterizerOpenGL::DrawPrelude() {
     SyncLogicOpState();
     SyncCullMode();
     SyncPrimitiveRestart();
-    SyncScissorTest(state);
     SyncTransformFeedback();
     SyncPointState();
     SyncPolygonOffset();
     SyncAlphaTest();
 
+    // Geometry shaders can write to any viewport, toggling them changes how many viewports and
+    // scissors have to be synced.
+    const bool geometry_shaders_enabled =
+        gpu.regs.IsShaderConfigEnabled(static_cast<size_t>(Maxwell::ShaderProgram::Geometry));
+    if (geometry_shaders_enabled != synced_geometry_shaders) {
+        synced_geometry_shaders = geometry_shaders_enabled;
+        gpu.dirty.viewport = true;
+        gpu.dirty.scissor_test = true;
+    }
+
+    // The viewport transform is also read by SyncCullMode, so this has to be synced after it.
+    if (gpu.dirty.viewport || gpu.dirty.viewport_transform) {
+        gpu.dirty.viewport = false;
+        gpu.dirty.viewport_transform = false;
+        SyncViewport(state, render_scale);
+    }
+    if (gpu.dirty.scissor_test) {
+        gpu.dirty.scissor_test = false;
+        SyncScissorTest(state, render_scale);
+    }
+
     buffer_cache.Acquire();
 
     // Draw the vertex batch
@@ -567,7 +751,20 @@ void RasterizerOpenGL::DrawPrelude() {
 
     // Add space for index buffer
     if (is_indexed) {
-        buffer_size = Common::AlignUp(buffer_size, 4) + CalculateIndexBufferSize();
+        std::size_t index_size = CalculateIndexBufferSize();
+        if (indirect_draw) {
+            // The whole index array is uploaded, only small ones go through the stream buffer
+            index_size = std::min(index_size, OGLBufferCache::MAX_STREAM_SIZE);
+        }
+        buffer_size = Common::AlignUp(buffer_size, 4) + index_size;
+    }
+
+    // Add space for the arguments and the draw count of an indirect draw
+    if (indirect_draw) {
+        const std::size_t arguments_size =
+            static_cast<std::size_t>(indirect_draw->max_draw_count) * indirect_draw->stride;
+        buffer_size = Common::AlignUp(buffer_size, 4) +
+                      std::min(arguments_size, OGLBufferCache::MAX_STREAM_SIZE) + 4 + sizeof(u32);
     }
 
     // Uniform space for the 5 shader stages
@@ -590,6 +787,7 @@ void RasterizerOpenGL::DrawPrelude() {
     SetupVertexBuffer(vao);
     SetupVertexInstances(vao);
     index_buffer_offset = SetupIndexBuffer();
+    SetupIndirectBuffers();
 
     // Prepare packed bindings.
     bind_ubo_pushbuffer.Setup(0);
@@ -598,7 +796,8 @@ void RasterizerOpenGL::DrawPrelude() {
     // Setup shaders and their used resources.
     texture_cache.GuardSamplers(true);
     const auto primitive_mode = MaxwellToGL::PrimitiveTopology(gpu.regs.draw.topology);
-    SetupShaders(primitive_mode);
+    const bool shaders_ready = SetupShaders(primitive_mode);
+    texture_cache.DiscardPrefetches();
     texture_cache.GuardSamplers(false);
 
     ConfigureFramebuffers();
@@ -609,6 +808,9 @@ void RasterizerOpenGL::DrawPrelude() {
     // Now that we are no longer uploading data, we can safely bind the buffers to OpenGL.
     vertex_array_pushbuffer.Bind();
     bind_ubo_pushbuffer.Bind();
+    if (texture_cache.StorageBindingsChanged()) {
+        bind_ssbo_pushbuffer.Invalidate();
+    }
     bind_ssbo_pushbuffer.Bind();
 
     if (invalidate) {
@@ -619,120 +821,297 @@ void RasterizerOpenGL::DrawPrelude() {
     shader_program_manager->ApplyTo(state);
     state.Apply();
 
+    return shaders_ready;
+}
+
+void RasterizerOpenGL::Draw(bool is_indexed, GLuint instance_count, GLuint base_instance) {
+    MICROPROFILE_SCOPE(OpenGL_Drawing);
+
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    const auto& regs = maxwell3d.regs;
+    const GLenum primitive_mode = MaxwellToGL::PrimitiveTopology(regs.draw.topology);
+
+    BatchedDraw draw{};
+    draw.instance_count = instance_count;
+    draw.base_instance = base_instance;
+    if (is_indexed) {
+        draw.count = regs.index_array.count;
+        draw.first = regs.index_array.first;
+        draw.base_vertex = static_cast<GLint>(regs.vb_element_base);
+    } else {
+        draw.count = regs.vertex_buffer.count;
+        draw.first = regs.vertex_buffer.first;
+    }
+
+    if (IsBatchable(is_indexed, primitive_mode, draw)) {
+        // Only the draw parameters changed since the last draw, the rest of its state is reused
+        pending_draws.draws.push_back(draw);
+        pending_draws.index_begin = std::min(pending_draws.index_begin, draw.first);
+        pending_draws.index_end = std::max(pending_draws.index_end, draw.first + draw.count);
+        maxwell3d.dirty.memory_general = false;
+        return;
+    }
+    FlushBatchedDraws();
+
+    accelerate_draw = is_indexed ? AccelDraw::Indexed : AccelDraw::Arrays;
+    const bool shaders_ready = DrawPrelude();
+    accelerate_draw = AccelDraw::Disabled;
+    maxwell3d.dirty.memory_general = false;
+    if (!shaders_ready) {
+        return;
+    }
+
+    pending_draws.draws.push_back(draw);
+    pending_draws.is_indexed = is_indexed;
+    pending_draws.primitive_mode = primitive_mode;
+    pending_draws.vao = state.draw.vertex_array;
+    pending_draws.index_buffer_offset = index_buffer_offset;
+    if (is_indexed) {
+        pending_draws.index_format = MaxwellToGL::IndexFormat(regs.index_array.format);
+        pending_draws.index_size = regs.index_array.FormatSizeInBytes();
+        pending_draws.index_address = regs.index_array.StartAddress();
+        pending_draws.index_begin = draw.first;
+        pending_draws.index_end = draw.first + draw.count;
+    }
+    maxwell3d.has_batched_draws = true;
+
     if (texture_cache.TextureBarrier()) {
+        // The next draws may sample what this one renders, they need a barrier of their own
         glTextureBarrier();
+        FlushBatchedDraws();
+    }
+}
+
+bool RasterizerOpenGL::IsBatchable(bool is_indexed, GLenum primitive_mode,
+                                   const BatchedDraw& draw) const {
+    if (pending_draws.draws.empty() || pending_draws.draws.size() >= MAX_BATCHED_DRAWS) {
+        return false;
+    }
+    if (pending_draws.is_indexed != is_indexed || pending_draws.primitive_mode != primitive_mode) {
+        return false;
+    }
+    if (!is_indexed) {
+        return true;
+    }
+    // The indices of the whole batch are uploaded as a single range
+    const GLuint begin = std::min(pending_draws.index_begin, draw.first);
+    const GLuint end = std::max(pending_draws.index_end, draw.first + draw.count);
+    return (end - begin) * pending_draws.index_size <= MAX_BATCHED_INDEX_SIZE;
+}
+
+void RasterizerOpenGL::DispatchDraw(const BatchedDraw& draw, GLintptr index_offset) const {
+    const GLenum primitive_mode = pending_draws.primitive_mode;
+    const auto count = static_cast<GLsizei>(draw.count);
+    const auto instance_count = static_cast<GLsizei>(draw.instance_count);
+    const bool is_instanced = draw.instance_count != 1 || draw.base_instance != 0;
+    if (pending_draws.is_indexed) {
+        const GLenum index_format = pending_draws.index_format;
+        const auto index_buffer_ptr = reinterpret_cast<const void*>(index_offset);
+        if (is_instanced) {
+            glDrawElementsInstancedBaseVertexBaseInstance(primitive_mode, count, index_format,
+                                                          index_buffer_ptr, instance_count,
+                                                          draw.base_vertex, draw.base_instance);
+        } else {
+            glDrawElementsBaseVertex(primitive_mode, count, index_format, index_buffer_ptr,
+                                     draw.base_vertex);
+        }
+    } else {
+        const auto first = static_cast<GLint>(draw.first);
+        if (is_instanced) {
+            glDrawArraysInstancedBaseInstance(primitive_mode, first, count, instance_count,
+                                              draw.base_instance);
+        } else {
+            glDrawArrays(primitive_mode, first, count);
+        }
     }
 }
 
-struct DrawParams {
-    bool is_indexed{};
-    bool is_instanced{};
-    GLenum primitive_mode{};
-    GLint count{};
-    GLint base_vertex{};
+void RasterizerOpenGL::FlushBatchedDraws() {
+    auto& draws = pending_draws.draws;
+    if (draws.empty()) {
+        return;
+    }
+    MICROPROFILE_SCOPE(OpenGL_Drawing);
+    SCOPE_EXIT({
+        draws.clear();
+        system.GPU().Maxwell3D().has_batched_draws = false;
+    });
 
-    // Indexed settings
-    GLenum index_format{};
-    GLintptr index_buffer_offset{};
+    if (draws.size() == 1) {
+        DispatchDraw(draws.front(), pending_draws.index_buffer_offset);
+        return;
+    }
 
-    // Instanced setting
-    GLint num_instances{};
-    GLint base_instance{};
+    const bool is_indexed = pending_draws.is_indexed;
+    const std::size_t index_size = pending_draws.index_size;
+    const std::size_t indices_size =
+        is_indexed ? (pending_draws.index_end - pending_draws.index_begin) * index_size : 0;
+    buffer_cache.Map(Common::AlignUp<std::size_t>(indices_size, 4) +
+                     draws.size() * sizeof(BatchedDraw));
 
-    void DispatchDraw() {
-        if (is_indexed) {
-            const auto index_buffer_ptr = reinterpret_cast<const void*>(index_buffer_offset);
-            if (is_instanced) {
-                glDrawElementsInstancedBaseVertexBaseInstance(primitive_mode, count, index_format,
-                                                              index_buffer_ptr, num_instances,
-                                                              base_vertex, base_instance);
-            } else {
-                glDrawElementsBaseVertex(primitive_mode, count, index_format, index_buffer_ptr,
-                                         base_vertex);
-            }
-        } else {
-            if (is_instanced) {
-                glDrawArraysInstancedBaseInstance(primitive_mode, base_vertex, count, num_instances,
-                                                  base_instance);
+    const GLuint* index_buffer = nullptr;
+    u64 index_offset = 0;
+    if (is_indexed) {
+        const GPUVAddr address =
+            pending_draws.index_address + pending_draws.index_begin * index_size;
+        std::tie(index_buffer, index_offset) = buffer_cache.UploadMemory(address, indices_size);
+    }
+
+    // Indirect commands address indices in elements, the upload has to be aligned to one
+    const bool use_indirect = !is_indexed || index_offset % index_size == 0;
+    const GLuint* indirect_buffer = nullptr;
+    u64 indirect_offset = 0;
+    if (use_indirect) {
+        const u64 index_base = is_indexed ? index_offset / index_size : 0;
+        for (auto& draw : draws) {
+            if (is_indexed) {
+                const u64 first = draw.first - pending_draws.index_begin + index_base;
+                draw.first = static_cast<GLuint>(first);
             } else {
-                glDrawArrays(primitive_mode, base_vertex, count);
+                // Arrays commands have no base vertex, their base instance takes its place
+                draw.base_vertex = static_cast<GLint>(draw.base_instance);
             }
         }
+        std::tie(indirect_buffer, indirect_offset) =
+            buffer_cache.UploadHostMemory(draws.data(), draws.size() * sizeof(BatchedDraw));
     }
-};
 
-bool RasterizerOpenGL::DrawBatch(bool is_indexed) {
-    accelerate_draw = is_indexed ? AccelDraw::Indexed : AccelDraw::Arrays;
+    // The stream buffer is persistent, it wraps around without orphaning the batched vertices
+    [[maybe_unused]] const bool invalidate = buffer_cache.Unmap();
+    ASSERT(!invalidate);
 
-    MICROPROFILE_SCOPE(OpenGL_Drawing);
+    if (is_indexed) {
+        glVertexArrayElementBuffer(pending_draws.vao, *index_buffer);
+    }
+    if (!use_indirect) {
+        for (const auto& draw : draws) {
+            const u64 offset = index_offset + (draw.first - pending_draws.index_begin) * index_size;
+            DispatchDraw(draw, static_cast<GLintptr>(offset));
+        }
+        return;
+    }
 
-    DrawPrelude();
+    const auto indirect_ptr = reinterpret_cast<const void*>(indirect_offset);
+    const auto draw_count = static_cast<GLsizei>(draws.size());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, *indirect_buffer);
+    if (is_indexed) {
+        glMultiDrawElementsIndirect(pending_draws.primitive_mode, pending_draws.index_format,
+                                    indirect_ptr, draw_count, sizeof(BatchedDraw));
+    } else {
+        glMultiDrawArraysIndirect(pending_draws.primitive_mode, indirect_ptr, draw_count,
+                                  sizeof(BatchedDraw));
+    }
+}
 
+bool RasterizerOpenGL::DrawIndirect(const VideoCore::IndirectDrawParams& params) {
+    const bool has_count = params.count_address != 0;
+    if (has_count && !GLAD_GL_ARB_indirect_parameters) {
+        return false;
+    }
+    // The host GPU reads commands of the same layout, only their stride may differ
+    const std::size_t command_size = (params.is_indexed ? 5 : 4) * sizeof(u32);
+    if (params.max_draw_count == 0 || params.stride % 4 != 0 || params.stride < command_size) {
+        return false;
+    }
     auto& maxwell3d = system.GPU().Maxwell3D();
     const auto& regs = maxwell3d.regs;
-    const auto current_instance = maxwell3d.state.current_instance;
-    DrawParams draw_call{};
-    draw_call.is_indexed = is_indexed;
-    draw_call.num_instances = static_cast<GLint>(1);
-    draw_call.base_instance = static_cast<GLint>(current_instance);
-    draw_call.is_instanced = current_instance > 0;
-    draw_call.primitive_mode = MaxwellToGL::PrimitiveTopology(regs.draw.topology);
-    if (draw_call.is_indexed) {
-        draw_call.count = static_cast<GLint>(regs.index_array.count);
-        draw_call.base_vertex = static_cast<GLint>(regs.vb_element_base);
-        draw_call.index_format = MaxwellToGL::IndexFormat(regs.index_array.format);
-        draw_call.index_buffer_offset = index_buffer_offset;
+    if (params.is_indexed && regs.index_array.EndAddress() < regs.index_array.StartAddress()) {
+        return false;
+    }
+    MICROPROFILE_SCOPE(OpenGL_Drawing);
+    FlushBatchedDraws();
+    indirect_draw = &params;
+    accelerate_draw = params.is_indexed ? AccelDraw::Indexed : AccelDraw::Arrays;
+    const bool shaders_ready = DrawPrelude();
+    accelerate_draw = AccelDraw::Disabled;
+    indirect_draw = nullptr;
+    maxwell3d.dirty.memory_general = false;
+    if (!shaders_ready) {
+        // The draw is skipped like the direct ones while its shaders build
+        return true;
+    }
+
+    const GLenum primitive_mode = MaxwellToGL::PrimitiveTopology(regs.draw.topology);
+    if (params.is_indexed && index_buffer_offset != 0) {
+        const std::size_t index_size = CalculateIndexBufferSize();
+        if (indirect_index_copy_size < index_size) {
+            indirect_index_copy.Release();
+            indirect_index_copy.Create();
+            indirect_index_copy.MakeStreamCopy(index_size);
+            indirect_index_copy_size = index_size;
+        }
+        glCopyNamedBufferSubData(*indirect_index_buffer, indirect_index_copy.handle,
+                                 index_buffer_offset, 0, static_cast<GLsizeiptr>(index_size));
+        glVertexArrayElementBuffer(state.draw.vertex_array, indirect_index_copy.handle);
+    }
+
+    const auto& [arguments_buffer, arguments_offset] = indirect_arguments;
+    const auto arguments_ptr = reinterpret_cast<const void*>(arguments_offset);
+    const auto max_draw_count = static_cast<GLsizei>(params.max_draw_count);
+    const auto stride = static_cast<GLsizei>(params.stride);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, *arguments_buffer);
+    if (has_count) {
+        const auto& [count_buffer, count_offset] = indirect_count;
+        glBindBuffer(GL_PARAMETER_BUFFER_ARB, *count_buffer);
+        const auto count_ptr = static_cast<GLintptr>(count_offset);
+        if (params.is_indexed) {
+            const GLenum index_format = MaxwellToGL::IndexFormat(regs.index_array.format);
+            glMultiDrawElementsIndirectCountARB(primitive_mode, index_format, arguments_ptr,
+                                                count_ptr, max_draw_count, stride);
+        } else {
+            glMultiDrawArraysIndirectCountARB(primitive_mode, arguments_ptr, count_ptr,
+                                              max_draw_count, stride);
+        }
+    } else if (params.is_indexed) {
+        const GLenum index_format = MaxwellToGL::IndexFormat(regs.index_array.format);
+        glMultiDrawElementsIndirect(primitive_mode, index_format, arguments_ptr, max_draw_count,
+                                    stride);
     } else {
-        draw_call.count = static_cast<GLint>(regs.vertex_buffer.count);
-        draw_call.base_vertex = static_cast<GLint>(regs.vertex_buffer.first);
+        glMultiDrawArraysIndirect(primitive_mode, arguments_ptr, max_draw_count, stride);
     }
-    draw_call.DispatchDraw();
 
-    maxwell3d.dirty.memory_general = false;
-    accelerate_draw = AccelDraw::Disabled;
+    if (texture_cache.TextureBarrier()) {
+        glTextureBarrier();
+    }
     return true;
 }
 
-bool RasterizerOpenGL::DrawMultiBatch(bool is_indexed) {
-    accelerate_draw = is_indexed ? AccelDraw::Indexed : AccelDraw::Arrays;
-
-    MICROPROFILE_SCOPE(OpenGL_Drawing);
+bool RasterizerOpenGL::IsGPUModified(GPUVAddr gpu_addr, u64 size) {
+    return buffer_cache.IsRegionModified(gpu_addr, static_cast<std::size_t>(size));
+}
 
-    DrawPrelude();
+bool RasterizerOpenGL::DrawBatch(bool is_indexed) {
+    const auto current_instance = system.GPU().Maxwell3D().state.current_instance;
+    Draw(is_indexed, 1, static_cast<GLuint>(current_instance));
+    return true;
+}
 
-    auto& maxwell3d = system.GPU().Maxwell3D();
-    const auto& regs = maxwell3d.regs;
-    const auto& draw_setup = maxwell3d.mme_draw;
-    DrawParams draw_call{};
-    draw_call.is_indexed = is_indexed;
-    draw_call.num_instances = static_cast<GLint>(draw_setup.instance_count);
-    draw_call.base_instance = static_cast<GLint>(regs.vb_base_instance);
-    draw_call.is_instanced = draw_setup.instance_count > 1;
-    draw_call.primitive_mode = MaxwellToGL::PrimitiveTopology(regs.draw.topology);
-    if (draw_call.is_indexed) {
-        draw_call.count = static_cast<GLint>(regs.index_array.count);
-        draw_call.base_vertex = static_cast<GLint>(regs.vb_element_base);
-        draw_call.index_format = MaxwellToGL::IndexFormat(regs.index_array.format);
-        draw_call.index_buffer_offset = index_buffer_offset;
+bool RasterizerOpenGL::DrawMultiBatch(bool is_indexed) {
+    const auto& maxwell3d = system.GPU().Maxwell3D();
+    const u32 instance_count = maxwell3d.mme_draw.instance_count;
+    if (instance_count > 1) {
+        Draw(is_indexed, instance_count, maxwell3d.regs.vb_base_instance);
     } else {
-        draw_call.count = static_cast<GLint>(regs.vertex_buffer.count);
-        draw_call.base_vertex = static_cast<GLint>(regs.vertex_buffer.first);
+        Draw(is_indexed, 1, 0);
     }
-    draw_call.DispatchDraw();
-
-    maxwell3d.dirty.memory_general = false;
-    accelerate_draw = AccelDraw::Disabled;
     return true;
 }
 
 void RasterizerOpenGL::DispatchCompute(GPUVAddr code_addr) {
+    FlushBatchedDraws();
+
     if (!GLAD_GL_ARB_compute_variable_group_size) {
         LOG_ERROR(Render_OpenGL, "Compute is currently not supported on this device due to the "
                                  "lack of GL_ARB_compute_variable_group_size");
         return;
     }
 
-    auto kernel = shader_cache.GetComputeKernel(code_addr);
+    // Consecutive dispatches usually launch the same kernel, skip the cache lookup for them.
+    if (!last_kernel || code_addr != last_kernel_addr || !last_kernel->IsRegistered()) {
+        last_kernel = shader_cache.GetComputeKernel(code_addr);
+        last_kernel_addr = code_addr;
+    }
+    const Shader& kernel = last_kernel;
     ProgramVariant variant;
     variant.texture_buffer_usage = SetupComputeTextures(kernel);
     SetupComputeImages(kernel);
@@ -755,6 +1134,9 @@ void RasterizerOpenGL::DispatchCompute(GPUVAddr code_addr) {
     buffer_cache.Unmap();
 
     bind_ubo_pushbuffer.Bind();
+    if (texture_cache.StorageBindingsChanged()) {
+        bind_ssbo_pushbuffer.Invalidate();
+    }
     bind_ssbo_pushbuffer.Bind();
 
     state.ApplyTextures();
@@ -766,27 +1148,59 @@ void RasterizerOpenGL::DispatchCompute(GPUVAddr code_addr) {
     glDispatchComputeGroupSizeARB(launch_desc.grid_dim_x, launch_desc.grid_dim_y,
                                   launch_desc.grid_dim_z, launch_desc.block_dim_x,
                                   launch_desc.block_dim_y, launch_desc.block_dim_z);
+
+    // Written global memory is synchronized by the buffer cache when it's read back, only images
+    // stored by the kernel have to be made visible here.
+    const auto& images = kernel->GetShaderEntries().images;
+    const bool writes_images = std::any_of(images.begin(), images.end(),
+                                           [](const auto& image) { return image.IsWritten(); });
+    if (writes_images) {
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT |
+                        GL_TEXTURE_UPDATE_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+    }
+}
+
+void RasterizerOpenGL::ResetCounter(VideoCore::QueryType type) {
+    FlushBatchedDraws();
+
+    query_cache.ResetCounter(type);
+}
+
+void RasterizerOpenGL::Query(GPUVAddr gpu_addr, VideoCore::QueryType type,
+                             std::optional<u64> timestamp) {
+    FlushBatchedDraws();
+
+    query_cache.Query(gpu_addr, type, timestamp);
 }
 
 void RasterizerOpenGL::FlushAll() {}
 
 void RasterizerOpenGL::FlushRegion(CacheAddr addr, u64 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    FlushBatchedDraws();
+
     if (!addr || !size) {
         return;
     }
+    system.GPU().Statistics().Add(VideoCore::GPUCounter::Flushes);
     texture_cache.FlushRegion(addr, size);
     buffer_cache.FlushRegion(addr, size);
+    query_cache.FlushRegion(addr, size);
 }
 
 void RasterizerOpenGL::InvalidateRegion(CacheAddr addr, u64 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    FlushBatchedDraws();
+
     if (!addr || !size) {
         return;
     }
+    system.GPU().Statistics().Add(VideoCore::GPUCounter::Invalidations);
     texture_cache.InvalidateRegion(addr, size);
     shader_cache.InvalidateRegion(addr, size);
     buffer_cache.InvalidateRegion(addr, size);
+    query_cache.InvalidateRegion(addr, size);
+    InvalidateDescriptorTables(addr, size);
 }
 
 void RasterizerOpenGL::FlushAndInvalidateRegion(CacheAddr addr, u64 size) {
@@ -797,31 +1211,205 @@ void RasterizerOpenGL::FlushAndInvalidateRegion(CacheAddr addr, u64 size) {
 }
 
 void RasterizerOpenGL::FlushCommands() {
+    FlushBatchedDraws();
+    buffer_cache.CommitAsyncFlushes();
+
     glFlush();
 }
 
 void RasterizerOpenGL::TickFrame() {
+    FlushBatchedDraws();
+
     buffer_cache.TickFrame();
+    texture_cache.TickFrame();
+
+    // Ticking the buffer cache may delete buffers and their names can be reused
+    bind_ubo_pushbuffer.Invalidate();
+    bind_ssbo_pushbuffer.Invalidate();
+}
+
+bool RasterizerOpenGL::SignalSyncPoint(u32 syncpoint_id) {
+    // Synchronous GPU emulation relies on syncpoints being incremented immediately
+    if (!system.GPU().IsAsync()) {
+        return false;
+    }
+    FlushBatchedDraws();
+
+    PendingSyncPoint& pending = pending_sync_points.emplace_back();
+    pending.fence.Create();
+    pending.syncpoint_id = syncpoint_id;
+
+    // Make sure the fence reaches the host GPU, it's polled without flushing
+    glFlush();
+    return true;
+}
+
+bool RasterizerOpenGL::HasPendingSyncPoints() const {
+    return !pending_sync_points.empty();
+}
+
+void RasterizerOpenGL::ReleaseSyncPoints(bool wait) {
+    auto& gpu = system.GPU();
+    while (!pending_sync_points.empty()) {
+        PendingSyncPoint& pending = pending_sync_points.front();
+        const GLuint64 timeout = wait ? SYNC_POINT_WAIT_TIMEOUT : 0;
+        const GLenum result = glClientWaitSync(pending.fence.handle, 0, timeout);
+        if (result == GL_TIMEOUT_EXPIRED) {
+            return;
+        }
+        gpu.IncrementSyncPoint(pending.syncpoint_id);
+        pending_sync_points.pop_front();
+        // Only the first fence is waited on, the rest are released when already finished
+        wait = false;
+    }
 }
 
 bool RasterizerOpenGL::AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src,
                                              const Tegra::Engines::Fermi2D::Regs::Surface& dst,
                                              const Tegra::Engines::Fermi2D::Config& copy_config) {
     MICROPROFILE_SCOPE(OpenGL_Blits);
+    FlushBatchedDraws();
+
     texture_cache.DoFermiCopy(src, dst, copy_config);
     return true;
 }
 
+bool RasterizerOpenGL::AccelerateDMABufferCopy(GPUVAddr src_addr, GPUVAddr dst_addr, u64 size) {
+    // Accurate GPU emulation keeps guest memory up to date, copies are done through it
+    if (Settings::values.use_accurate_gpu_emulation) {
+        return false;
+    }
+    MICROPROFILE_SCOPE(OpenGL_Blits);
+    FlushBatchedDraws();
+
+    if (!buffer_cache.CopyRegion(src_addr, dst_addr, static_cast<std::size_t>(size))) {
+        return false;
+    }
+    const u8* dst_ptr = system.GPU().MemoryManager().GetPointer(dst_addr);
+    InvalidateDMADestination(ToCacheAddr(dst_ptr), size);
+    return true;
+}
+
+bool RasterizerOpenGL::AccelerateDMAImageToBuffer(const Tegra::Engines::MaxwellDMA::Regs& regs) {
+    if (Settings::values.use_accurate_gpu_emulation || regs.x_count == 0) {
+        return false;
+    }
+    const u32 bytes_per_pixel = regs.dst_pitch / regs.x_count;
+    if (bytes_per_pixel == 0 || regs.dst_pitch % bytes_per_pixel != 0) {
+        return false;
+    }
+    const GPUVAddr dst_addr = regs.dst_address.Address();
+    const u8* dst_ptr = system.GPU().MemoryManager().GetPointer(dst_addr);
+    const auto surface =
+        texture_cache.TryFindDMASurface(regs.src_address.Address(), regs.src_params,
+                                        bytes_per_pixel, regs.x_count, regs.y_count);
+    // Guest memory already holds the image of surfaces that weren't modified by the GPU
+    if (!dst_ptr || !surface || !surface->IsModified()) {
+        return false;
+    }
+    MICROPROFILE_SCOPE(OpenGL_Blits);
+    FlushBatchedDraws();
+
+    const std::size_t dst_size = static_cast<std::size_t>(regs.dst_pitch) * regs.y_count;
+    const auto [buffer, offset] = buffer_cache.UploadMemory(dst_addr, dst_size, 4, true);
+    const u32 x = regs.src_params.pos_x;
+    const u32 y = regs.src_params.pos_y;
+    surface->DownloadRegion(*buffer, static_cast<std::size_t>(offset), dst_size, regs.dst_pitch,
+                            {x, y, x + regs.x_count, y + regs.y_count});
+    InvalidateDMADestination(ToCacheAddr(dst_ptr), dst_size);
+    return true;
+}
+
+bool RasterizerOpenGL::AccelerateDMABufferToImage(const Tegra::Engines::MaxwellDMA::Regs& regs) {
+    if (Settings::values.use_accurate_gpu_emulation || regs.x_count == 0) {
+        return false;
+    }
+    const u32 bytes_per_pixel = regs.src_pitch / regs.x_count;
+    const std::size_t src_size = static_cast<std::size_t>(regs.src_pitch) * regs.y_count;
+    if (bytes_per_pixel == 0 || regs.src_pitch % bytes_per_pixel != 0 ||
+        src_size > STREAM_BUFFER_SIZE / 2) {
+        return false;
+    }
+    const GPUVAddr src_addr = regs.src_address.Address();
+    const GPUVAddr dst_addr = regs.dst_address.Address();
+    auto& memory_manager = system.GPU().MemoryManager();
+    const u8* dst_ptr = memory_manager.GetPointer(dst_addr);
+    const auto surface = texture_cache.TryFindDMASurface(dst_addr, regs.dst_params,
+                                                         bytes_per_pixel, regs.x_count,
+                                                         regs.y_count);
+    if (!memory_manager.GetPointer(src_addr) || !surface) {
+        return false;
+    }
+    MICROPROFILE_SCOPE(OpenGL_Blits);
+    FlushBatchedDraws();
+
+    // The source is taken from the buffer cache, either where the GPU wrote it or uploaded
+    buffer_cache.Map(Common::AlignUp<std::size_t>(src_size, 4) + 4);
+    const auto [buffer, offset] = buffer_cache.UploadMemory(src_addr, src_size);
+    buffer_cache.Unmap();
+
+    const u32 x = regs.dst_params.pos_x;
+    const u32 y = regs.dst_params.pos_y;
+    surface->UploadRegion(*buffer, static_cast<std::size_t>(offset), regs.src_pitch,
+                          {x, y, x + regs.x_count, y + regs.y_count});
+    surface->MarkAsModified(true, texture_cache.Tick());
+
+    // The surface now holds the only up to date copy of the destination
+    const CacheAddr dst_cache_addr = ToCacheAddr(dst_ptr);
+    const u64 dst_size = surface->GetSurfaceParams().GetGuestSizeInBytes();
+    shader_cache.InvalidateRegion(dst_cache_addr, dst_size);
+    buffer_cache.InvalidateRegion(dst_cache_addr, dst_size);
+    query_cache.InvalidateRegion(dst_cache_addr, dst_size);
+    return true;
+}
+
+void RasterizerOpenGL::InvalidateDMADestination(CacheAddr addr, u64 size) {
+    texture_cache.InvalidateRegion(addr, size);
+    shader_cache.InvalidateRegion(addr, size);
+    query_cache.InvalidateRegion(addr, size);
+    InvalidateDescriptorTables(addr, size);
+}
+
+void RasterizerOpenGL::InvalidateDescriptorTables(CacheAddr addr, u64 size) {
+    graphics_tic_table.InvalidateRegion(addr, size);
+    graphics_tsc_table.InvalidateRegion(addr, size);
+    compute_tic_table.InvalidateRegion(addr, size);
+    compute_tsc_table.InvalidateRegion(addr, size);
+}
+
+Tegra::Texture::FullTextureInfo RasterizerOpenGL::GetGraphicsTextureInfo(
+    Tegra::Texture::TextureHandle handle) {
+    const auto& regs = system.GPU().Maxwell3D().regs;
+    graphics_tic_table.Refresh(regs.tic.TICAddress(), regs.tic.tic_limit);
+    graphics_tsc_table.Refresh(regs.tsc.TSCAddress(), regs.tsc.tsc_limit);
+    return {graphics_tic_table.Read(handle.tic_id), graphics_tsc_table.Read(handle.tsc_id)};
+}
+
+Tegra::Texture::FullTextureInfo RasterizerOpenGL::GetComputeTextureInfo(
+    Tegra::Texture::TextureHandle handle) {
+    const auto& regs = system.GPU().KeplerCompute().regs;
+    compute_tic_table.Refresh(regs.tic.Address(), regs.tic.limit);
+    compute_tsc_table.Refresh(regs.tsc.Address(), regs.tsc.limit);
+    return {compute_tic_table.Read(handle.tic_id), compute_tsc_table.Read(handle.tsc_id)};
+}
+
 bool RasterizerOpenGL::AccelerateDisplay(const Tegra::FramebufferConfig& config,
                                          VAddr framebuffer_addr, u32 pixel_stride) {
+    FlushBatchedDraws();
+
     if (!framebuffer_addr) {
         return {};
     }
 
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
 
-    const auto surface{
-        texture_cache.TryFindFramebufferSurface(Memory::GetPointer(framebuffer_addr))};
+    auto surface{texture_cache.TryFindFramebufferSurface(Memory::GetPointer(framebuffer_addr))};
+    if (!surface && config.gpu_address != 0) {
+        // Framebuffers the GPU did not render to are loaded into the texture cache once, frames
+        // are presented from it until the guest writes to them again
+        surface = texture_cache.GetDisplaySurface(config.gpu_address + config.offset,
+                                                  SurfaceParams::CreateForDisplay(config));
+    }
     if (!surface) {
         return {};
     }
@@ -934,15 +1522,8 @@ TextureBufferUsage RasterizerOpenGL::SetupDrawTextures(Maxwell::ShaderStage stag
 
     for (u32 bindpoint = 0; bindpoint < entries.size(); ++bindpoint) {
         const auto& entry = entries[bindpoint];
-        const auto texture = [&] {
-            if (!entry.IsBindless()) {
-                return maxwell3d.GetStageTexture(stage, entry.GetOffset());
-            }
-            const auto shader_type = static_cast<Tegra::Engines::ShaderType>(stage);
-            const Tegra::Texture::TextureHandle tex_handle =
-                maxwell3d.AccessConstBuffer32(shader_type, entry.GetBuffer(), entry.GetOffset());
-            return maxwell3d.GetTextureInfo(tex_handle);
-        }();
+        const auto texture =
+            GetGraphicsTextureInfo(GetGraphicsTextureHandle(maxwell3d, stage, entry));
 
         if (SetupTexture(base_bindings.sampler + bindpoint, texture, entry)) {
             texture_buffer_usage.set(bindpoint);
@@ -952,6 +1533,15 @@ TextureBufferUsage RasterizerOpenGL::SetupDrawTextures(Maxwell::ShaderStage stag
     return texture_buffer_usage;
 }
 
+void RasterizerOpenGL::PrefetchDrawTextures(Maxwell::ShaderStage stage, const Shader& shader) {
+    const auto& maxwell3d = system.GPU().Maxwell3D();
+    for (const auto& entry : shader->GetShaderEntries().samplers) {
+        const auto texture =
+            GetGraphicsTextureInfo(GetGraphicsTextureHandle(maxwell3d, stage, entry));
+        texture_cache.PrefetchTextureSurface(texture.tic, entry);
+    }
+}
+
 TextureBufferUsage RasterizerOpenGL::SetupComputeTextures(const Shader& kernel) {
     MICROPROFILE_SCOPE(OpenGL_Texture);
     const auto& compute = system.GPU().KeplerCompute();
@@ -964,14 +1554,7 @@ TextureBufferUsage RasterizerOpenGL::SetupComputeTextures(const Shader& kernel)
 
     for (u32 bindpoint = 0; bindpoint < entries.size(); ++bindpoint) {
         const auto& entry = entries[bindpoint];
-        const auto texture = [&] {
-            if (!entry.IsBindless()) {
-                return compute.GetTexture(entry.GetOffset());
-            }
-            const Tegra::Texture::TextureHandle tex_handle = compute.AccessConstBuffer32(
-                Tegra::Engines::ShaderType::Compute, entry.GetBuffer(), entry.GetOffset());
-            return compute.GetTextureInfo(tex_handle);
-        }();
+        const auto texture = GetComputeTextureInfo(GetComputeTextureHandle(compute, entry));
 
         if (SetupTexture(bindpoint, texture, entry)) {
             texture_buffer_usage.set(bindpoint);
@@ -1008,14 +1591,7 @@ void RasterizerOpenGL::SetupComputeImages(const Shader& shader) {
     const auto& entries = shader->GetShaderEntries().images;
     for (u32 bindpoint = 0; bindpoint < entries.size(); ++bindpoint) {
         const auto& entry = entries[bindpoint];
-        const auto tic = [&] {
-            if (!entry.IsBindless()) {
-                return compute.GetTexture(entry.GetOffset()).tic;
-            }
-            const Tegra::Texture::TextureHandle tex_handle = compute.AccessConstBuffer32(
-                Tegra::Engines::ShaderType::Compute, entry.GetBuffer(), entry.GetOffset());
-            return compute.GetTextureInfo(tex_handle).tic;
-        }();
+        const auto tic = GetComputeTextureInfo(GetComputeTextureHandle(compute, entry)).tic;
         SetupImage(bindpoint, tic, entry);
     }
 }
@@ -1036,25 +1612,28 @@ void RasterizerOpenGL::SetupImage(u32 binding, const Tegra::Texture::TICEntry& t
     state.images[binding] = view->GetTexture();
 }
 
-void RasterizerOpenGL::SyncViewport(OpenGLState& current_state) {
+void RasterizerOpenGL::SyncViewport(OpenGLState& current_state, u32 scale) {
     const auto& regs = system.GPU().Maxwell3D().regs;
     const bool geometry_shaders_enabled =
         regs.IsShaderConfigEnabled(static_cast<size_t>(Maxwell::ShaderProgram::Geometry));
     const std::size_t viewport_count =
         geometry_shaders_enabled ? Tegra::Engines::Maxwell3D::Regs::NumViewports : 1;
+    const s32 factor = static_cast<s32>(scale);
     for (std::size_t i = 0; i < viewport_count; i++) {
         auto& viewport = current_state.viewports[i];
         const auto& src = regs.viewports[i];
         const Common::Rectangle<s32> viewport_rect{regs.viewport_transform[i].GetRect()};
-        viewport.x = viewport_rect.left;
-        viewport.y = viewport_rect.bottom;
-        viewport.width = viewport_rect.GetWidth();
-        viewport.height = viewport_rect.GetHeight();
+        viewport.x = viewport_rect.left * factor;
+        viewport.y = viewport_rect.bottom * factor;
+        viewport.width = viewport_rect.GetWidth() * factor;
+        viewport.height = viewport_rect.GetHeight() * factor;
         viewport.depth_range_far = src.depth_range_far;
         viewport.depth_range_near = src.depth_range_near;
     }
     state.depth_clamp.far_plane = regs.view_volume_clip_control.depth_clamp_far != 0;
     state.depth_clamp.near_plane = regs.view_volume_clip_control.depth_clamp_near != 0;
+    current_state.MarkDirtyViewport();
+    state.MarkDirtyDepthClamp();
 }
 
 void RasterizerOpenGL::SyncClipEnabled(
@@ -1070,6 +1649,7 @@ void RasterizerOpenGL::SyncClipEnabled(
     for (std::size_t i = 0; i < Maxwell::Regs::NumClipDistances; ++i) {
         state.clip_distance[i] = reg_state[i] && clip_mask[i];
     }
+    state.MarkDirtyClipDistances();
 }
 
 void RasterizerOpenGL::SyncClipCoef() {
@@ -1078,10 +1658,17 @@ void RasterizerOpenGL::SyncClipCoef() {
 
 void RasterizerOpenGL::SyncCullMode() {
     auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.cull_mode && !maxwell3d.dirty.screen_y_control &&
+        !maxwell3d.dirty.viewport_transform) {
+        return;
+    }
+    maxwell3d.dirty.cull_mode = false;
+    maxwell3d.dirty.screen_y_control = false;
 
     const auto& regs = maxwell3d.regs;
 
     state.cull.enabled = regs.cull.enabled != 0;
+    state.MarkDirtyCulling();
     if (state.cull.enabled) {
         state.cull.front_face = MaxwellToGL::FrontFace(regs.cull.front_face);
         state.cull.mode = MaxwellToGL::CullFace(regs.cull.cull_face);
@@ -1102,17 +1689,31 @@ void RasterizerOpenGL::SyncCullMode() {
 }
 
 void RasterizerOpenGL::SyncPrimitiveRestart() {
-    const auto& regs = system.GPU().Maxwell3D().regs;
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.primitive_restart) {
+        return;
+    }
+    maxwell3d.dirty.primitive_restart = false;
+
+    const auto& regs = maxwell3d.regs;
 
     state.primitive_restart.enabled = regs.primitive_restart.enabled;
     state.primitive_restart.index = regs.primitive_restart.index;
+    state.MarkDirtyPrimitiveRestart();
 }
 
 void RasterizerOpenGL::SyncDepthTestState() {
-    const auto& regs = system.GPU().Maxwell3D().regs;
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.depth_test) {
+        return;
+    }
+    maxwell3d.dirty.depth_test = false;
+
+    const auto& regs = maxwell3d.regs;
 
     state.depth.test_enabled = regs.depth_test_enable != 0;
     state.depth.write_mask = regs.depth_write_enabled ? GL_TRUE : GL_FALSE;
+    state.MarkDirtyDepth();
 
     if (!state.depth.test_enabled) {
         return;
@@ -1185,14 +1786,28 @@ void RasterizerOpenGL::SyncColorMask() {
 }
 
 void RasterizerOpenGL::SyncMultiSampleState() {
-    const auto& regs = system.GPU().Maxwell3D().regs;
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.multisample_control) {
+        return;
+    }
+    maxwell3d.dirty.multisample_control = false;
+
+    const auto& regs = maxwell3d.regs;
     state.multisample_control.alpha_to_coverage = regs.multisample_control.alpha_to_coverage != 0;
     state.multisample_control.alpha_to_one = regs.multisample_control.alpha_to_one != 0;
+    state.MarkDirtyMultisample();
 }
 
 void RasterizerOpenGL::SyncFragmentColorClampState() {
-    const auto& regs = system.GPU().Maxwell3D().regs;
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.fragment_color_clamp) {
+        return;
+    }
+    maxwell3d.dirty.fragment_color_clamp = false;
+
+    const auto& regs = maxwell3d.regs;
     state.fragment_color_clamp.enabled = regs.frag_color_clamp != 0;
+    state.MarkDirtyFragmentColorClamp();
 }
 
 void RasterizerOpenGL::SyncBlendState() {
@@ -1247,9 +1862,16 @@ void RasterizerOpenGL::SyncBlendState() {
 }
 
 void RasterizerOpenGL::SyncLogicOpState() {
-    const auto& regs = system.GPU().Maxwell3D().regs;
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.logic_op) {
+        return;
+    }
+    maxwell3d.dirty.logic_op = false;
+
+    const auto& regs = maxwell3d.regs;
 
     state.logic_op.enabled = regs.logic_op.enable != 0;
+    state.MarkDirtyLogicOp();
 
     if (!state.logic_op.enabled)
         return;
@@ -1260,12 +1882,13 @@ void RasterizerOpenGL::SyncLogicOpState() {
     state.logic_op.operation = MaxwellToGL::LogicOp(regs.logic_op.operation);
 }
 
-void RasterizerOpenGL::SyncScissorTest(OpenGLState& current_state) {
+void RasterizerOpenGL::SyncScissorTest(OpenGLState& current_state, u32 scale) {
     const auto& regs = system.GPU().Maxwell3D().regs;
     const bool geometry_shaders_enabled =
         regs.IsShaderConfigEnabled(static_cast<size_t>(Maxwell::ShaderProgram::Geometry));
     const std::size_t viewport_count =
         geometry_shaders_enabled ? Tegra::Engines::Maxwell3D::Regs::NumViewports : 1;
+    current_state.MarkDirtyViewport();
     for (std::size_t i = 0; i < viewport_count; i++) {
         const auto& src = regs.scissor_test[i];
         auto& dst = current_state.viewports[i].scissor;
@@ -1275,23 +1898,36 @@ void RasterizerOpenGL::SyncScissorTest(OpenGLState& current_state) {
         }
         const u32 width = src.max_x - src.min_x;
         const u32 height = src.max_y - src.min_y;
-        dst.x = src.min_x;
-        dst.y = src.min_y;
-        dst.width = width;
-        dst.height = height;
+        dst.x = src.min_x * scale;
+        dst.y = src.min_y * scale;
+        dst.width = width * scale;
+        dst.height = height * scale;
     }
 }
 
 void RasterizerOpenGL::SyncTransformFeedback() {
-    const auto& regs = system.GPU().Maxwell3D().regs;
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.transform_feedback) {
+        return;
+    }
+    maxwell3d.dirty.transform_feedback = false;
+
+    const auto& regs = maxwell3d.regs;
     UNIMPLEMENTED_IF_MSG(regs.tfb_enabled != 0, "Transform feedbacks are not implemented");
 }
 
 void RasterizerOpenGL::SyncPointState() {
-    const auto& regs = system.GPU().Maxwell3D().regs;
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.point_size) {
+        return;
+    }
+    maxwell3d.dirty.point_size = false;
+
+    const auto& regs = maxwell3d.regs;
     // Limit the point size to 1 since nouveau sometimes sets a point size of 0 (and that's invalid
     // in OpenGL).
     state.point.size = std::max(1.0f, regs.point_size);
+    state.MarkDirtyPointSize();
 }
 
 void RasterizerOpenGL::SyncPolygonOffset() {
@@ -1315,11 +1951,18 @@ void RasterizerOpenGL::SyncPolygonOffset() {
 }
 
 void RasterizerOpenGL::SyncAlphaTest() {
-    const auto& regs = system.GPU().Maxwell3D().regs;
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.alpha_test) {
+        return;
+    }
+    maxwell3d.dirty.alpha_test = false;
+
+    const auto& regs = maxwell3d.regs;
     UNIMPLEMENTED_IF_MSG(regs.alpha_test_enabled != 0 && regs.rt_control.count > 1,
                          "Alpha Testing is enabled with more than one rendertarget");
 
     state.alpha_test.enabled = regs.alpha_test_enabled;
+    state.MarkDirtyAlphaTest();
     if (!state.alpha_test.enabled) {
         return;
     }
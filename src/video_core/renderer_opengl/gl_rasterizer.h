@@ -7,11 +7,12 @@
 #include <array>
 #include <atomic>
 #include <cstddef>
-#include <map>
+#include <deque>
 #include <memory>
 #include <optional>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include <glad/glad.h>
 
@@ -24,6 +25,7 @@
 #include "video_core/renderer_opengl/gl_buffer_cache.h"
 #include "video_core/renderer_opengl/gl_device.h"
 #include "video_core/renderer_opengl/gl_framebuffer_cache.h"
+#include "video_core/renderer_opengl/gl_query_cache.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_sampler_cache.h"
 #include "video_core/renderer_opengl/gl_shader_cache.h"
@@ -32,6 +34,7 @@
 #include "video_core/renderer_opengl/gl_state.h"
 #include "video_core/renderer_opengl/gl_texture_cache.h"
 #include "video_core/renderer_opengl/utils.h"
+#include "video_core/texture_cache/descriptor_table.h"
 #include "video_core/textures/texture.h"
 
 namespace Core {
@@ -59,28 +62,54 @@ public:
 
     bool DrawBatch(bool is_indexed) override;
     bool DrawMultiBatch(bool is_indexed) override;
+    void FlushBatchedDraws() override;
+    bool DrawIndirect(const VideoCore::IndirectDrawParams& params) override;
+    bool IsGPUModified(GPUVAddr gpu_addr, u64 size) override;
     void Clear() override;
     void DispatchCompute(GPUVAddr code_addr) override;
+    void ResetCounter(VideoCore::QueryType type) override;
+    void Query(GPUVAddr gpu_addr, VideoCore::QueryType type, std::optional<u64> timestamp) override;
     void FlushAll() override;
     void FlushRegion(CacheAddr addr, u64 size) override;
     void InvalidateRegion(CacheAddr addr, u64 size) override;
     void FlushAndInvalidateRegion(CacheAddr addr, u64 size) override;
     void FlushCommands() override;
     void TickFrame() override;
+    bool SignalSyncPoint(u32 syncpoint_id) override;
+    bool HasPendingSyncPoints() const override;
+    void ReleaseSyncPoints(bool wait) override;
     bool AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src,
                                const Tegra::Engines::Fermi2D::Regs::Surface& dst,
                                const Tegra::Engines::Fermi2D::Config& copy_config) override;
+    bool AccelerateDMABufferCopy(GPUVAddr src_addr, GPUVAddr dst_addr, u64 size) override;
+    bool AccelerateDMAImageToBuffer(const Tegra::Engines::MaxwellDMA::Regs& regs) override;
+    bool AccelerateDMABufferToImage(const Tegra::Engines::MaxwellDMA::Regs& regs) override;
     bool AccelerateDisplay(const Tegra::FramebufferConfig& config, VAddr framebuffer_addr,
                            u32 pixel_stride) override;
     void LoadDiskResources(const std::atomic_bool& stop_loading,
                            const VideoCore::DiskResourceLoadCallback& callback) override;
 
 private:
+    /// Invalidates the caches other than the buffer cache of a region written by a DMA copy on
+    /// the host GPU.
+    void InvalidateDMADestination(CacheAddr addr, u64 size);
+
+    /// Drops the cached texture descriptors of a written region.
+    void InvalidateDescriptorTables(CacheAddr addr, u64 size);
+
+    /// Returns the descriptors of a texture handle used by a draw, through the descriptor caches.
+    Tegra::Texture::FullTextureInfo GetGraphicsTextureInfo(Tegra::Texture::TextureHandle handle);
+
+    /// Returns the descriptors of a texture handle used by a dispatch, through the descriptor
+    /// caches.
+    Tegra::Texture::FullTextureInfo GetComputeTextureInfo(Tegra::Texture::TextureHandle handle);
+
     /// Configures the color and depth framebuffer states.
     void ConfigureFramebuffers();
 
-    void ConfigureClearFramebuffer(OpenGLState& current_state, bool using_color_fb,
-                                   bool using_depth_fb, bool using_stencil_fb);
+    /// Configures the clear framebuffer, returns the resolution scale of its attachments.
+    u32 ConfigureClearFramebuffer(OpenGLState& current_state, bool using_color_fb,
+                                  bool using_depth_fb, bool using_stencil_fb);
 
     /// Configures the current constbuffers to use for the draw command.
     void SetupDrawConstBuffers(Tegra::Engines::Maxwell3D::Regs::ShaderStage stage,
@@ -105,13 +134,37 @@ private:
                            std::size_t size);
 
     /// Syncs all the state, shaders, render targets and textures setting before a draw call.
-    void DrawPrelude();
+    /// Returns false when the draw has to be skipped because its shaders are not built yet.
+    bool DrawPrelude();
+
+    /// Parameters of a draw, laid out as a glMultiDrawElementsIndirect command.
+    struct BatchedDraw {
+        GLuint count;
+        GLuint instance_count;
+        GLuint first;
+        GLint base_vertex;
+        GLuint base_instance;
+    };
+    static_assert(sizeof(BatchedDraw) == 20, "BatchedDraw is not an indirect draw command");
+
+    /// Draws with the current state, the draw is held back to be batched with the next ones.
+    void Draw(bool is_indexed, GLuint instance_count, GLuint base_instance);
+
+    /// Returns true when a draw only differs in its parameters from the pending ones.
+    bool IsBatchable(bool is_indexed, GLenum primitive_mode, const BatchedDraw& draw) const;
+
+    /// Emits a single pending draw reading indices at the given offset of the index buffer.
+    void DispatchDraw(const BatchedDraw& draw, GLintptr index_offset) const;
 
     /// Configures the current textures to use for the draw command. Returns shaders texture buffer
     /// usage.
     TextureBufferUsage SetupDrawTextures(Tegra::Engines::Maxwell3D::Regs::ShaderStage stage,
                                          const Shader& shader, BaseBindings base_bindings);
 
+    /// Starts decoding in the background the textures of a draw stage that miss the cache.
+    void PrefetchDrawTextures(Tegra::Engines::Maxwell3D::Regs::ShaderStage stage,
+                              const Shader& shader);
+
     /// Configures the textures used in a compute shader. Returns texture buffer usage.
     TextureBufferUsage SetupComputeTextures(const Shader& kernel);
 
@@ -126,8 +179,8 @@ private:
     void SetupImage(u32 binding, const Tegra::Texture::TICEntry& tic,
                     const GLShader::ImageEntry& entry);
 
-    /// Syncs the viewport and depth range to match the guest state
-    void SyncViewport(OpenGLState& current_state);
+    /// Syncs the viewport and depth range to match the guest state, scaled by the given factor
+    void SyncViewport(OpenGLState& current_state, u32 scale);
 
     /// Syncs the clip enabled status to match the guest state
     void SyncClipEnabled(
@@ -160,8 +213,8 @@ private:
     /// Syncs the alpha coverage and alpha to one
     void SyncMultiSampleState();
 
-    /// Syncs the scissor test state to match the guest state
-    void SyncScissorTest(OpenGLState& current_state);
+    /// Syncs the scissor test state to match the guest state, scaled by the given factor
+    void SyncScissorTest(OpenGLState& current_state, u32 scale);
 
     /// Syncs the transform feedback state to match the guest state
     void SyncTransformFeedback();
@@ -194,18 +247,33 @@ private:
     ScreenInfo& screen_info;
 
     std::unique_ptr<GLShader::ProgramManager> shader_program_manager;
-    std::map<std::array<Tegra::Engines::Maxwell3D::Regs::VertexAttribute,
-                        Tegra::Engines::Maxwell3D::Regs::NumVertexAttributes>,
-             OGLVertexArray>
-        vertex_array_cache;
+    /// Vertex array used by every draw, its attributes are respecified as their formats change.
+    OGLVertexArray vertex_array;
 
     static constexpr std::size_t STREAM_BUFFER_SIZE = 128 * 1024 * 1024;
     OGLBufferCache buffer_cache;
+    QueryCache query_cache;
+
+    VideoCommon::DescriptorTable<Tegra::Texture::TICEntry> graphics_tic_table;
+    VideoCommon::DescriptorTable<Tegra::Texture::TSCEntry> graphics_tsc_table;
+    VideoCommon::DescriptorTable<Tegra::Texture::TICEntry> compute_tic_table;
+    VideoCommon::DescriptorTable<Tegra::Texture::TSCEntry> compute_tsc_table;
 
     VertexArrayPushBuffer vertex_array_pushbuffer;
     BindBuffersRangePushBuffer bind_ubo_pushbuffer{GL_UNIFORM_BUFFER};
     BindBuffersRangePushBuffer bind_ssbo_pushbuffer{GL_SHADER_STORAGE_BUFFER};
 
+    /// Kernel of the last dispatch, reused while its code address is launched again.
+    Shader last_kernel;
+    GPUVAddr last_kernel_addr{};
+
+    /// Syncpoint increments waiting for the host GPU work submitted before them, oldest first.
+    struct PendingSyncPoint {
+        OGLSync fence;
+        u32 syncpoint_id{};
+    };
+    std::deque<PendingSyncPoint> pending_sync_points;
+
     std::size_t CalculateVertexArraysSize() const;
 
     std::size_t CalculateIndexBufferSize() const;
@@ -218,9 +286,48 @@ private:
 
     GLintptr SetupIndexBuffer();
 
+    /// Uploads the arguments of the indirect draw being prepared, and its draw count if it has one.
+    void SetupIndirectBuffers();
+
     GLintptr index_buffer_offset;
 
-    void SetupShaders(GLenum primitive_mode);
+    /// Indirect draw being prepared by DrawPrelude, null for the other draws.
+    const VideoCore::IndirectDrawParams* indirect_draw = nullptr;
+    /// Index buffer handle of the indirect draw, its range covers the whole index array.
+    const GLuint* indirect_index_buffer = nullptr;
+    OGLBufferCache::BufferInfo indirect_arguments{};
+    OGLBufferCache::BufferInfo indirect_count{};
+
+    /// Indirect draws index the element buffer from its start, index arrays not uploaded at the
+    /// start of a buffer are copied here.
+    OGLBuffer indirect_index_copy;
+    std::size_t indirect_index_copy_size = 0;
+
+    static constexpr std::size_t MAX_BATCHED_DRAWS = 256;
+    static constexpr std::size_t MAX_BATCHED_INDEX_SIZE = 1024 * 1024;
+
+    /// Consecutive draws sharing all their state, emitted together by FlushBatchedDraws.
+    struct PendingDraws {
+        std::vector<BatchedDraw> draws;
+        bool is_indexed = false;
+        GLenum primitive_mode = 0;
+        GLenum index_format = 0;
+        std::size_t index_size = 0;
+        GLuint vao = 0;
+        GPUVAddr index_address = 0;       ///< Start of the index buffer, ignoring the first index.
+        GLintptr index_buffer_offset = 0; ///< Where the indices of the first draw were uploaded.
+        GLuint index_begin = 0;           ///< First index read by the batch.
+        GLuint index_end = 0;             ///< One past the last index read by the batch.
+    } pending_draws;
+
+    /// Whether geometry shaders were enabled the last time viewports and scissors were synced.
+    bool synced_geometry_shaders = false;
+
+    /// Resolution scale of the bound render targets, viewports and scissors are scaled by it.
+    u32 render_scale = 1;
+
+    /// Binds the shader programs of the draw, returns false when some are still being built
+    bool SetupShaders(GLenum primitive_mode);
 
     enum class AccelDraw { Disabled, Arrays, Indexed };
     AccelDraw accelerate_draw = AccelDraw::Disabled;
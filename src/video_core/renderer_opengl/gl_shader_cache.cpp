@@ -2,19 +2,24 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
 #include <unordered_set>
-#include <boost/functional/hash.hpp>
 #include "common/assert.h"
+#include "common/hash.h"
 #include "common/scope_exit.h"
 #include "core/core.h"
 #include "core/frontend/emu_window.h"
+#include "core/perf_stats.h"
+#include "core/settings.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/memory_manager.h"
+#include "video_core/renderer_opengl/gl_async_shaders.h"
 #include "video_core/renderer_opengl/gl_rasterizer.h"
 #include "video_core/renderer_opengl/gl_shader_cache.h"
 #include "video_core/renderer_opengl/gl_shader_decompiler.h"
@@ -110,6 +115,21 @@ constexpr GLenum GetShaderType(ProgramType program_type) {
     }
 }
 
+/// Gets the program pipeline stage bit of a Maxwell program type, zero when it has no stage
+constexpr GLbitfield GetStageBit(ProgramType program_type) {
+    switch (program_type) {
+    case ProgramType::VertexA:
+    case ProgramType::VertexB:
+        return GL_VERTEX_SHADER_BIT;
+    case ProgramType::Geometry:
+        return GL_GEOMETRY_SHADER_BIT;
+    case ProgramType::Fragment:
+        return GL_FRAGMENT_SHADER_BIT;
+    default:
+        return 0;
+    }
+}
+
 /// Describes primitive behavior on geometry shaders
 constexpr std::tuple<const char*, const char*, u32> GetPrimitiveDescription(GLenum primitive_mode) {
     switch (primitive_mode) {
@@ -155,10 +175,11 @@ ProgramType GetProgramType(Maxwell::ShaderProgram program) {
 /// Hashes one (or two) program streams
 u64 GetUniqueIdentifier(ProgramType program_type, const ProgramCode& code,
                         const ProgramCode& code_b) {
-    u64 unique_identifier = boost::hash_value(code);
+    u64 unique_identifier = Common::ComputeXXH3(code.data(), code.size() * sizeof(u64));
     if (program_type == ProgramType::VertexA) {
         // VertexA programs include two programs
-        boost::hash_combine(unique_identifier, boost::hash_value(code_b));
+        unique_identifier =
+            Common::ComputeXXH3(code_b.data(), code_b.size() * sizeof(u64), unique_identifier);
     }
     return unique_identifier;
 }
@@ -253,19 +274,11 @@ void FillLocker(ConstBufferLocker& locker, const ShaderDiskCacheUsage& usage) {
     }
 }
 
-CachedProgram BuildShader(const Device& device, u64 unique_identifier, ProgramType program_type,
-                          const ProgramCode& program_code, const ProgramCode& program_code_b,
-                          const ProgramVariant& variant, ConstBufferLocker& locker,
-                          bool hint_retrievable = false) {
-    LOG_INFO(Render_OpenGL, "called. {}", GetShaderId(unique_identifier, program_type));
-
+/// Generates the GLSL source of a program variant from already decoded programs.
+std::string GenerateSource(const Device& device, u64 unique_identifier, ProgramType program_type,
+                           const ShaderIR& ir, const std::optional<ShaderIR>& ir_b,
+                           const ProgramVariant& variant) {
     const bool is_compute = program_type == ProgramType::Compute;
-    const u32 main_offset = is_compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
-    const ShaderIR ir(program_code, main_offset, COMPILER_SETTINGS, locker);
-    std::optional<ShaderIR> ir_b;
-    if (!program_code_b.empty()) {
-        ir_b.emplace(program_code_b, main_offset, COMPILER_SETTINGS, locker);
-    }
     const auto entries = GLShader::GetEntries(ir);
 
     auto base_bindings{variant.base_bindings};
@@ -278,8 +291,12 @@ CachedProgram BuildShader(const Device& device, u64 unique_identifier, ProgramTy
 #extension GL_ARB_shader_viewport_layer_array : enable
 #extension GL_EXT_shader_image_load_formatted : enable
 #extension GL_NV_gpu_shader5 : enable
+#extension GL_AMD_gpu_shader_half_float : enable
 #extension GL_NV_shader_thread_group : enable
 #extension GL_NV_shader_thread_shuffle : enable
+#extension GL_KHR_shader_subgroup_ballot : enable
+#extension GL_KHR_shader_subgroup_vote : enable
+#extension GL_KHR_shader_subgroup_shuffle : enable
 )",
                                      GetShaderId(unique_identifier, program_type));
     if (is_compute) {
@@ -332,6 +349,29 @@ CachedProgram BuildShader(const Device& device, u64 unique_identifier, ProgramTy
 
     source += '\n';
     source += GenerateGLSL(device, program_type, ir, ir_b);
+    return source;
+}
+
+/// Generates the GLSL source of a program variant, decoding its programs with a locker's keys.
+std::string GenerateSource(const Device& device, u64 unique_identifier, ProgramType program_type,
+                           const ProgramCode& program_code, const ProgramCode& program_code_b,
+                           const ProgramVariant& variant, ConstBufferLocker& locker) {
+    const u32 main_offset =
+        program_type == ProgramType::Compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
+    const ShaderIR ir(program_code, main_offset, COMPILER_SETTINGS, locker);
+    std::optional<ShaderIR> ir_b;
+    if (!program_code_b.empty()) {
+        ir_b.emplace(program_code_b, main_offset, COMPILER_SETTINGS, locker);
+    }
+    return GenerateSource(device, unique_identifier, program_type, ir, ir_b, variant);
+}
+
+/// Builds a program from its GLSL source.
+CachedProgram BuildShader(u64 unique_identifier, ProgramType program_type,
+                          const std::string& source, bool hint_retrievable = false) {
+    LOG_INFO(Render_OpenGL, "called. {}", GetShaderId(unique_identifier, program_type));
+    const Core::PerfTimer timer{Core::System::GetInstance().GetPerfStats(),
+                                Core::PerfCategory::ShaderCompile};
 
     OGLShader shader;
     shader.Create(source.c_str(), GetShaderType(program_type));
@@ -361,9 +401,10 @@ CachedShader::CachedShader(const ShaderParameters& params, ProgramType program_t
                            GLShader::ShaderEntries entries, ProgramCode program_code,
                            ProgramCode program_code_b)
     : RasterizerCacheObject{params.host_ptr}, system{params.system},
-      disk_cache{params.disk_cache}, device{params.device}, cpu_addr{params.cpu_addr},
-      unique_identifier{params.unique_identifier}, program_type{program_type}, entries{entries},
-      program_code{std::move(program_code)}, program_code_b{std::move(program_code_b)} {
+      disk_cache{params.disk_cache}, device{params.device}, async_shaders{params.async_shaders},
+      cpu_addr{params.cpu_addr}, unique_identifier{params.unique_identifier},
+      program_type{program_type}, entries{entries}, program_code{std::move(program_code)},
+      program_code_b{std::move(program_code_b)} {
     if (!params.precompiled_variants) {
         return;
     }
@@ -431,11 +472,17 @@ std::tuple<GLuint, BaseBindings> CachedShader::GetProgramHandle(const ProgramVar
     const auto [entry, is_cache_miss] = curr_variant->programs.try_emplace(variant);
     auto& program = entry->second;
     if (is_cache_miss) {
-        program = BuildShader(device, unique_identifier, program_type, program_code, program_code_b,
-                              variant, *curr_variant->locker);
-        disk_cache.SaveUsage(GetUsage(variant, *curr_variant->locker));
+        if (async_shaders) {
+            program = BuildAsync(variant);
+        } else {
+            DecodeVariant();
+            program = BuildShader(unique_identifier, program_type,
+                                  GenerateSource(device, unique_identifier, program_type,
+                                                 *curr_variant->ir, curr_variant->ir_b, variant));
+            disk_cache.SaveUsage(GetUsage(variant, *curr_variant->locker));
 
-        LabelGLObject(GL_PROGRAM, program->handle, cpu_addr);
+            LabelGLObject(GL_PROGRAM, program->handle, cpu_addr);
+        }
     }
 
     auto base_bindings = variant.base_bindings;
@@ -468,6 +515,43 @@ void CachedShader::UpdateVariant() {
     }
 }
 
+void CachedShader::DecodeVariant() {
+    if (curr_variant->ir) {
+        return;
+    }
+    // The decoded programs only depend on the keys of the locker, which decoding them again
+    // would read back unchanged, so every program variant of a locker variant shares them
+    const u32 main_offset =
+        program_type == ProgramType::Compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
+    ConstBufferLocker& locker = *curr_variant->locker;
+    curr_variant->ir.emplace(program_code, main_offset, COMPILER_SETTINGS, locker);
+    if (!program_code_b.empty()) {
+        curr_variant->ir_b.emplace(program_code_b, main_offset, COMPILER_SETTINGS, locker);
+    }
+}
+
+CachedProgram CachedShader::BuildAsync(const ProgramVariant& variant) {
+    // Decode the shader here to record the constant buffer keys it depends on, as workers can't
+    // read the state of the engines. Workers decode it again with a locker filled with these keys.
+    DecodeVariant();
+    ShaderDiskCacheUsage usage = GetUsage(variant, *curr_variant->locker);
+    disk_cache.SaveUsage(usage);
+
+    auto program = std::make_shared<OGLProgram>();
+    async_shaders->QueueBuild(program, [&device = device, usage = std::move(usage),
+                                        program_type = program_type, code = program_code,
+                                        code_b = program_code_b, variant, cpu_addr = cpu_addr] {
+        ConstBufferLocker worker_locker(GetEnginesShaderType(program_type));
+        FillLocker(worker_locker, usage);
+        const std::string source = GenerateSource(device, usage.unique_identifier, program_type,
+                                                  code, code_b, variant, worker_locker);
+        const CachedProgram built = BuildShader(usage.unique_identifier, program_type, source);
+        LabelGLObject(GL_PROGRAM, built->handle, cpu_addr);
+        return std::move(*built);
+    });
+    return program;
+}
+
 ShaderDiskCacheUsage CachedShader::GetUsage(const ProgramVariant& variant,
                                             const ConstBufferLocker& locker) const {
     ShaderDiskCacheUsage usage;
@@ -482,7 +566,13 @@ ShaderDiskCacheUsage CachedShader::GetUsage(const ProgramVariant& variant,
 ShaderCacheOpenGL::ShaderCacheOpenGL(RasterizerOpenGL& rasterizer, Core::System& system,
                                      Core::Frontend::EmuWindow& emu_window, const Device& device)
     : RasterizerCache{rasterizer}, system{system}, emu_window{emu_window}, device{device},
-      disk_cache{system} {}
+      disk_cache{system} {
+    if (Settings::values.use_asynchronous_shaders) {
+        async_shaders = std::make_unique<AsyncShaders>(emu_window);
+    }
+}
+
+ShaderCacheOpenGL::~ShaderCacheOpenGL() = default;
 
 void ShaderCacheOpenGL::LoadDiskCache(const std::atomic_bool& stop_loading,
                                       const VideoCore::DiskResourceLoadCallback& callback) {
@@ -498,10 +588,6 @@ void ShaderCacheOpenGL::LoadDiskCache(const std::atomic_bool& stop_loading,
     const auto dumps = disk_cache.LoadPrecompiled();
     const auto supported_formats = GetSupportedFormats();
 
-    // Track if precompiled cache was altered during loading to know if we have to
-    // serialize the virtual precompiled cache file back to the hard drive
-    bool precompiled_cache_altered = false;
-
     // Inform the frontend about shader build initialization
     if (callback) {
         callback(VideoCore::LoadCallbackStage::Build, 0, shader_usages.size());
@@ -509,16 +595,27 @@ void ShaderCacheOpenGL::LoadDiskCache(const std::atomic_bool& stop_loading,
 
     std::mutex mutex;
     std::size_t built_shaders = 0; // It doesn't have be atomic since it's used behind a mutex
-    std::atomic_bool compilation_failed = false;
+    std::atomic_bool is_precompiled_outdated = false;
+
+    // Sources of the built programs, saved along their binaries. Each worker only writes the
+    // entries it takes.
+    std::vector<std::string> sources(shader_usages.size());
+
+    // Workers take the next entry in recorded usage order instead of a fixed bucket, so the
+    // shaders used first by the game are built first and no worker idles while another one is
+    // stuck on slow builds
+    std::atomic<std::size_t> next_usage = 0;
 
-    const auto Worker = [&](Core::Frontend::GraphicsContext* context, std::size_t begin,
-                            std::size_t end, const std::vector<ShaderDiskCacheUsage>& shader_usages,
-                            const ShaderDumpsMap& dumps) {
+    // Reserve the programs up front, the variants hold iterators that a rehash would invalidate
+    precompiled_programs.reserve(precompiled_programs.size() + shader_usages.size());
+
+    const auto Worker = [&](Core::Frontend::GraphicsContext* context) {
         context->MakeCurrent();
         SCOPE_EXIT({ return context->DoneCurrent(); });
 
-        for (std::size_t i = begin; i < end; ++i) {
-            if (stop_loading || compilation_failed) {
+        while (!stop_loading) {
+            const std::size_t i = next_usage++;
+            if (i >= shader_usages.size()) {
                 return;
             }
             const auto& usage{shader_usages[i]};
@@ -529,17 +626,23 @@ void ShaderCacheOpenGL::LoadDiskCache(const std::atomic_bool& stop_loading,
             if (dump != dumps.end()) {
                 // If the shader is dumped, attempt to load it with
                 shader = GeneratePrecompiledProgram(dump->second, supported_formats);
+                sources[i] = dump->second.source;
                 if (!shader) {
-                    compilation_failed = true;
-                    return;
+                    // Binaries are rejected when the driver changes, build the stored source
+                    // instead of decompiling the shader again and dump the new binaries
+                    shader = BuildShader(usage.unique_identifier, unspecialized.program_type,
+                                         sources[i], true);
+                    is_precompiled_outdated = true;
                 }
             }
             if (!shader) {
                 auto locker{MakeLocker(system, unspecialized.program_type)};
                 FillLocker(*locker, usage);
-                shader = BuildShader(device, usage.unique_identifier, unspecialized.program_type,
-                                     unspecialized.code, unspecialized.code_b, usage.variant,
-                                     *locker, true);
+                sources[i] = GenerateSource(device, usage.unique_identifier,
+                                            unspecialized.program_type, unspecialized.code,
+                                            unspecialized.code_b, usage.variant, *locker);
+                shader = BuildShader(usage.unique_identifier, unspecialized.program_type,
+                                     sources[i], true);
             }
 
             std::scoped_lock lock{mutex};
@@ -556,48 +659,109 @@ void ShaderCacheOpenGL::LoadDiskCache(const std::atomic_bool& stop_loading,
         }
     };
 
-    const auto num_workers{static_cast<std::size_t>(std::thread::hardware_concurrency() + 1ULL)};
-    const std::size_t bucket_size{shader_usages.size() / num_workers};
+    // Never start more workers than there are entries, each one needs its own context
+    const auto max_workers{static_cast<std::size_t>(std::thread::hardware_concurrency() + 1ULL)};
+    const auto num_workers{std::min(max_workers, shader_usages.size())};
     std::vector<std::unique_ptr<Core::Frontend::GraphicsContext>> contexts(num_workers);
     std::vector<std::thread> threads(num_workers);
     for (std::size_t i = 0; i < num_workers; ++i) {
-        const bool is_last_worker = i + 1 == num_workers;
-        const std::size_t start{bucket_size * i};
-        const std::size_t end{is_last_worker ? shader_usages.size() : start + bucket_size};
-
         // On some platforms the shared context has to be created from the GUI thread
         contexts[i] = emu_window.CreateSharedContext();
-        threads[i] = std::thread(Worker, contexts[i].get(), start, end, shader_usages, dumps);
+        threads[i] = std::thread(Worker, contexts[i].get());
     }
     for (auto& thread : threads) {
         thread.join();
     }
 
-    if (compilation_failed) {
-        // Invalidate the precompiled cache if a shader dumped shader was rejected
-        disk_cache.InvalidatePrecompiled();
-        precompiled_cache_altered = true;
-        return;
-    }
     if (stop_loading) {
         return;
     }
+    if (is_precompiled_outdated) {
+        // Dump the programs again with the binaries of the current driver
+        disk_cache.InvalidatePrecompiled();
+    }
 
-    // TODO(Rodrigo): Do state tracking for transferable shaders and do a dummy draw
-    // before precompiling them
+    if (Settings::values.use_shader_warmup) {
+        // Warmed up before dumping, so the binaries include what the driver built on first use
+        WarmupPrograms(stop_loading, shader_usages);
+    }
 
     for (std::size_t i = 0; i < shader_usages.size(); ++i) {
         const auto& usage{shader_usages[i]};
-        if (dumps.find(usage) == dumps.end()) {
+        if (is_precompiled_outdated || dumps.find(usage) == dumps.end()) {
             const auto& program{precompiled_programs.at(usage)};
-            disk_cache.SaveDump(usage, program->handle);
-            precompiled_cache_altered = true;
+            disk_cache.SaveDump(usage, program->handle, sources[i]);
         }
     }
+}
 
-    if (precompiled_cache_altered) {
-        disk_cache.SaveVirtualPrecompiledFile();
-    }
+void ShaderCacheOpenGL::WarmupPrograms(const std::atomic_bool& stop_loading,
+                                       const std::vector<ShaderDiskCacheUsage>& usages) {
+    const auto context = emu_window.CreateSharedContext();
+    std::size_t num_draws = 0;
+    const auto Warmup = [&] {
+        context->MakeCurrent();
+        SCOPE_EXIT({ return context->DoneCurrent(); });
+
+        // Pipelines, framebuffers and vertex arrays aren't shared between contexts
+        OGLTexture texture;
+        texture.Create(GL_TEXTURE_2D);
+        glTextureStorage2D(texture.handle, 1, GL_RGBA8, 1, 1);
+        OGLFramebuffer framebuffer;
+        framebuffer.Create();
+        glNamedFramebufferTexture(framebuffer.handle, GL_COLOR_ATTACHMENT0, texture.handle, 0);
+        OGLVertexArray vertex_array;
+        vertex_array.Create();
+        OGLPipeline pipeline;
+        pipeline.Create();
+
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer.handle);
+        glBindVertexArray(vertex_array.handle);
+        glBindProgramPipeline(pipeline.handle);
+        glViewport(0, 0, 1, 1);
+
+        GLbitfield bound_stages = 0;
+        GLenum primitive_mode = GL_POINTS;
+        const auto Draw = [&] {
+            if (bound_stages == 0) {
+                return;
+            }
+            // A single primitive without vertex attributes, only its state matters to the driver
+            const u32 vertices = std::get<2>(GetPrimitiveDescription(primitive_mode));
+            glDrawArrays(primitive_mode, 0, static_cast<GLsizei>(vertices));
+            glUseProgramStages(pipeline.handle, GL_ALL_SHADER_BITS, 0);
+            bound_stages = 0;
+            ++num_draws;
+        };
+
+        for (const auto& usage : usages) {
+            if (stop_loading) {
+                return;
+            }
+            const auto& unspecialized{unspecialized_shaders.at(usage.unique_identifier)};
+            const GLbitfield stage = GetStageBit(unspecialized.program_type);
+            if (stage == 0) {
+                // Compute kernels don't depend on draw state, they are finished when linked
+                continue;
+            }
+            // The stages of a draw are recorded one after the other, a stage that is already
+            // bound belongs to the next draw
+            if ((bound_stages & stage) != 0 || usage.variant.primitive_mode != primitive_mode) {
+                Draw();
+            }
+            primitive_mode = usage.variant.primitive_mode;
+            glUseProgramStages(pipeline.handle, stage, precompiled_programs.at(usage)->handle);
+            bound_stages |= stage;
+        }
+        Draw();
+
+        // Don't start the game until the driver is done with the draws
+        glFinish();
+    };
+    std::thread thread(Warmup);
+    thread.join();
+
+    LOG_INFO(Render_OpenGL, "Warmed up {} shader usages with {} draws", usages.size(), num_draws);
 }
 
 const PrecompiledVariants* ShaderCacheOpenGL::GetPrecompiledVariants(u64 unique_identifier) const {
@@ -608,7 +772,7 @@ const PrecompiledVariants* ShaderCacheOpenGL::GetPrecompiledVariants(u64 unique_
 CachedProgram ShaderCacheOpenGL::GeneratePrecompiledProgram(
     const ShaderDiskCacheDump& dump, const std::unordered_set<GLenum>& supported_formats) {
     if (supported_formats.find(dump.binary_format) == supported_formats.end()) {
-        LOG_INFO(Render_OpenGL, "Precompiled cache entry with unsupported format - removing");
+        LOG_INFO(Render_OpenGL, "Precompiled cache entry with unsupported format - rebuilding");
         return {};
     }
 
@@ -621,7 +785,7 @@ CachedProgram ShaderCacheOpenGL::GeneratePrecompiledProgram(
     GLint link_status{};
     glGetProgramiv(shader->handle, GL_LINK_STATUS, &link_status);
     if (link_status == GL_FALSE) {
-        LOG_INFO(Render_OpenGL, "Precompiled cache rejected by the driver - removing");
+        LOG_INFO(Render_OpenGL, "Precompiled cache rejected by the driver - rebuilding");
         return {};
     }
 
@@ -703,7 +867,7 @@ Shader ShaderCacheOpenGL::GetStageProgram(Maxwell::ShaderProgram program) {
     const auto precompiled_variants = GetPrecompiledVariants(unique_identifier);
     const auto cpu_addr{*memory_manager.GpuToCpuAddress(address)};
     const ShaderParameters params{system,   disk_cache, precompiled_variants, device,
-                                  cpu_addr, host_ptr,   unique_identifier};
+                                  cpu_addr, host_ptr,   unique_identifier,    async_shaders.get()};
 
     const auto found = unspecialized_shaders.find(unique_identifier);
     if (found == unspecialized_shaders.end()) {
@@ -712,11 +876,18 @@ Shader ShaderCacheOpenGL::GetStageProgram(Maxwell::ShaderProgram program) {
     } else {
         shader = CachedShader::CreateFromCache(params, found->second);
     }
+    system.GPU().Statistics().Add(VideoCore::GPUCounter::ShaderCacheMisses);
     Register(shader);
 
     return last_shaders[static_cast<std::size_t>(program)] = shader;
 }
 
+void ShaderCacheOpenGL::InstallAsyncShaders() {
+    if (async_shaders) {
+        async_shaders->InstallCompleted();
+    }
+}
+
 Shader ShaderCacheOpenGL::GetComputeKernel(GPUVAddr code_addr) {
     auto& memory_manager{system.GPU().MemoryManager()};
     const auto host_ptr{memory_manager.GetPointer(code_addr)};
@@ -730,8 +901,9 @@ Shader ShaderCacheOpenGL::GetComputeKernel(GPUVAddr code_addr) {
     const auto unique_identifier{GetUniqueIdentifier(ProgramType::Compute, code, {})};
     const auto precompiled_variants = GetPrecompiledVariants(unique_identifier);
     const auto cpu_addr{*memory_manager.GpuToCpuAddress(code_addr)};
+    // Kernels are always built synchronously, dispatches can't be skipped like draws.
     const ShaderParameters params{system,   disk_cache, precompiled_variants, device,
-                                  cpu_addr, host_ptr,   unique_identifier};
+                                  cpu_addr, host_ptr,   unique_identifier,    nullptr};
 
     const auto found = unspecialized_shaders.find(unique_identifier);
     if (found == unspecialized_shaders.end()) {
@@ -740,6 +912,7 @@ Shader ShaderCacheOpenGL::GetComputeKernel(GPUVAddr code_addr) {
         kernel = CachedShader::CreateFromCache(params, found->second);
     }
 
+    system.GPU().Statistics().Add(VideoCore::GPUCounter::ShaderCacheMisses);
     Register(kernel);
     return kernel;
 }
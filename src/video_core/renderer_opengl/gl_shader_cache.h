@@ -8,6 +8,7 @@
 #include <atomic>
 #include <bitset>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -34,6 +35,7 @@ class EmuWindow;
 
 namespace OpenGL {
 
+class AsyncShaders;
 class CachedShader;
 class Device;
 class RasterizerOpenGL;
@@ -60,6 +62,7 @@ struct ShaderParameters {
     VAddr cpu_addr;
     u8* host_ptr;
     u64 unique_identifier;
+    AsyncShaders* async_shaders;
 };
 
 class CachedShader final : public RasterizerCacheObject {
@@ -85,13 +88,17 @@ public:
         return entries;
     }
 
-    /// Gets the GL program handle for the shader
+    /// Gets the GL program handle for the shader, zero while the program is built asynchronously
     std::tuple<GLuint, BaseBindings> GetProgramHandle(const ProgramVariant& variant);
 
 private:
     struct LockerVariant {
         std::unique_ptr<VideoCommon::Shader::ConstBufferLocker> locker;
         std::unordered_map<ProgramVariant, CachedProgram> programs;
+
+        /// Decoded programs shared by the program variants, empty until one is built
+        std::optional<VideoCommon::Shader::ShaderIR> ir;
+        std::optional<VideoCommon::Shader::ShaderIR> ir_b;
     };
 
     explicit CachedShader(const ShaderParameters& params, ProgramType program_type,
@@ -103,9 +110,16 @@ private:
     ShaderDiskCacheUsage GetUsage(const ProgramVariant& variant,
                                   const VideoCommon::Shader::ConstBufferLocker& locker) const;
 
+    /// Decodes the programs of the current locker variant unless they already are.
+    void DecodeVariant();
+
+    /// Queues the build of a program variant on the shader workers, returns the empty program.
+    CachedProgram BuildAsync(const ProgramVariant& variant);
+
     Core::System& system;
     ShaderDiskCacheOpenGL& disk_cache;
     const Device& device;
+    AsyncShaders* async_shaders;
 
     VAddr cpu_addr{};
 
@@ -125,6 +139,7 @@ class ShaderCacheOpenGL final : public RasterizerCache<Shader> {
 public:
     explicit ShaderCacheOpenGL(RasterizerOpenGL& rasterizer, Core::System& system,
                                Core::Frontend::EmuWindow& emu_window, const Device& device);
+    ~ShaderCacheOpenGL();
 
     /// Loads disk cache for the current game
     void LoadDiskCache(const std::atomic_bool& stop_loading,
@@ -136,6 +151,9 @@ public:
     /// Gets a compute kernel in the passed address
     Shader GetComputeKernel(GPUVAddr code_addr);
 
+    /// Installs the programs finished by the shader workers since the last call
+    void InstallAsyncShaders();
+
 protected:
     // We do not have to flush this cache as things in it are never modified by us.
     void FlushObjectInner(const Shader& object) override {}
@@ -145,6 +163,11 @@ private:
                                       const VideoCore::DiskResourceLoadCallback& callback,
                                       const std::vector<ShaderDiskCacheRaw>& raws);
 
+    /// Draws with the loaded programs in recorded usage order on a shared context, so drivers
+    /// that defer building programs until their first draw do it before the game starts.
+    void WarmupPrograms(const std::atomic_bool& stop_loading,
+                        const std::vector<ShaderDiskCacheUsage>& usages);
+
     CachedProgram GeneratePrecompiledProgram(const ShaderDiskCacheDump& dump,
                                              const std::unordered_set<GLenum>& supported_formats);
 
@@ -162,6 +185,9 @@ private:
     std::unordered_map<u64, UnspecializedShader> unspecialized_shaders;
 
     std::array<Shader, Maxwell::MaxShaderProgram> last_shaders;
+
+    /// Shader workers, only created when asynchronous shaders are enabled
+    std::unique_ptr<AsyncShaders> async_shaders;
 };
 
 } // namespace OpenGL
@@ -163,7 +163,7 @@ public:
         case Type::Int:
             return fmt::format("itof({})", code);
         case Type::HalfFloat:
-            return fmt::format("utof(packHalf2x16({}))", code);
+            return fmt::format("utof(htou({}))", code);
         default:
             UNREACHABLE_MSG("Incompatible types");
             return code;
@@ -179,7 +179,7 @@ public:
         case Type::Int:
             return code;
         case Type::HalfFloat:
-            return fmt::format("int(packHalf2x16({}))", code);
+            return fmt::format("int(htou({}))", code);
         default:
             UNREACHABLE_MSG("Incompatible types");
             return code;
@@ -195,7 +195,7 @@ public:
         case Type::Int:
             return fmt::format("uint({})", code);
         case Type::HalfFloat:
-            return fmt::format("packHalf2x16({})", code);
+            return fmt::format("htou({})", code);
         default:
             UNREACHABLE_MSG("Incompatible types");
             return code;
@@ -205,11 +205,11 @@ public:
     std::string AsHalfFloat() const {
         switch (type) {
         case Type::Float:
-            return fmt::format("unpackHalf2x16(ftou({}))", code);
+            return fmt::format("utoh(ftou({}))", code);
         case Type::Uint:
-            return fmt::format("unpackHalf2x16({})", code);
+            return fmt::format("utoh({})", code);
         case Type::Int:
-            return fmt::format("unpackHalf2x16(int({}))", code);
+            return fmt::format("utoh(uint({}))", code);
         case Type::HalfFloat:
             return code;
         default:
@@ -236,7 +236,7 @@ constexpr const char* GetTypeString(Type type) {
     case Type::Uint:
         return "uint";
     case Type::HalfFloat:
-        return "vec2";
+        return "half2";
     default:
         UNREACHABLE_MSG("Invalid type");
         return "<invalid type>";
@@ -397,6 +397,7 @@ public:
         DeclareGlobalMemory();
         DeclareSamplers();
         DeclarePhysicalAttributeReader();
+        DeclareWarpHelpers();
 
         code.AddLine("void execute_{}() {{", suffix);
         ++code.scope;
@@ -733,6 +734,63 @@ private:
         code.AddNewLine();
     }
 
+    void DeclareWarpHelpers() {
+        if (!ir.UsesWarps() || device.HasWarpIntrinsics() || !device.HasSubgroupIntrinsics()) {
+            return;
+        }
+        // Warps of the guest are 32 invocations wide, wider subgroups are split in several warps.
+        // Shuffles follow the semantics of GL_NV_shader_thread_shuffle, reading the value of the
+        // invocation itself when the source is out of its segment of the warp.
+        code.AddExpression(R"(uint warpBallot(bool value) {
+    return subgroupBallot(value)[gl_SubgroupInvocationID >> 5];
+}
+
+bool warpAll(bool value) {
+    return warpBallot(value) == warpBallot(true);
+}
+
+bool warpAny(bool value) {
+    return warpBallot(value) != 0U;
+}
+
+bool warpAllEqual(bool value) {
+    uint votes = warpBallot(value);
+    return votes == 0U || votes == warpBallot(true);
+}
+
+uint warpSegmentBase(uint width) {
+    return (gl_SubgroupInvocationID & 31U) & ~(width - 1U);
+}
+
+uint warpShuffleIndexedSource(uint index, uint width) {
+    return warpSegmentBase(width) + index;
+}
+
+uint warpShuffleUpSource(uint index, uint width) {
+    return (gl_SubgroupInvocationID & 31U) - index;
+}
+
+uint warpShuffleDownSource(uint index, uint width) {
+    return (gl_SubgroupInvocationID & 31U) + index;
+}
+
+uint warpShuffleButterflySource(uint index, uint width) {
+    return (gl_SubgroupInvocationID & 31U) ^ index;
+}
+
+bool warpInRange(uint source, uint width) {
+    uint base = warpSegmentBase(width);
+    return source >= base && source < base + width;
+}
+
+float warpShuffle(float value, uint source, uint width) {
+    uint lane = warpInRange(source, width) ? source : (gl_SubgroupInvocationID & 31U);
+    return subgroupShuffle(value, (gl_SubgroupInvocationID & ~31U) + lane);
+}
+
+)");
+    }
+
     void DeclareImages() {
         const auto& images{ir.GetImages()};
         for (const auto& image : images) {
@@ -1308,11 +1366,13 @@ private:
     }
 
     Expression FCastHalf0(Operation operation) {
-        return {fmt::format("({})[0]", VisitOperand(operation, 0).AsHalfFloat()), Type::Float};
+        return {fmt::format("float(({})[0])", VisitOperand(operation, 0).AsHalfFloat()),
+                Type::Float};
     }
 
     Expression FCastHalf1(Operation operation) {
-        return {fmt::format("({})[1]", VisitOperand(operation, 0).AsHalfFloat()), Type::Float};
+        return {fmt::format("float(({})[1])", VisitOperand(operation, 0).AsHalfFloat()),
+                Type::Float};
     }
 
     template <Type type>
@@ -1456,7 +1516,7 @@ private:
         const auto GetNegate = [&](std::size_t index) {
             return VisitOperand(operation, index).AsBool() + " ? -1 : 1";
         };
-        return {fmt::format("({} * vec2({}, {}))", VisitOperand(operation, 0).AsHalfFloat(),
+        return {fmt::format("({} * half2({}, {}))", VisitOperand(operation, 0).AsHalfFloat(),
                             GetNegate(1), GetNegate(2)),
                 Type::HalfFloat};
     }
@@ -1465,13 +1525,13 @@ private:
         const std::string value = VisitOperand(operation, 0).AsHalfFloat();
         const std::string min = VisitOperand(operation, 1).AsFloat();
         const std::string max = VisitOperand(operation, 2).AsFloat();
-        std::string clamped = fmt::format("clamp({}, vec2({}), vec2({}))", value, min, max);
+        std::string clamped = fmt::format("clamp({}, half2({}), half2({}))", value, min, max);
 
         return ApplyPrecise(operation, std::move(clamped), Type::HalfFloat);
     }
 
     Expression HCastFloat(Operation operation) {
-        return {fmt::format("vec2({})", VisitOperand(operation, 0).AsFloat()), Type::HalfFloat};
+        return {fmt::format("half2({})", VisitOperand(operation, 0).AsFloat()), Type::HalfFloat};
     }
 
     Expression HUnpack(Operation operation) {
@@ -1480,11 +1540,11 @@ private:
         case Tegra::Shader::HalfType::H0_H1:
             return operand;
         case Tegra::Shader::HalfType::F32:
-            return {fmt::format("vec2({})", operand.AsFloat()), Type::HalfFloat};
+            return {fmt::format("half2({})", operand.AsFloat()), Type::HalfFloat};
         case Tegra::Shader::HalfType::H0_H0:
-            return {fmt::format("vec2({}[0])", operand.AsHalfFloat()), Type::HalfFloat};
+            return {fmt::format("half2({}[0])", operand.AsHalfFloat()), Type::HalfFloat};
         case Tegra::Shader::HalfType::H1_H1:
-            return {fmt::format("vec2({}[1])", operand.AsHalfFloat()), Type::HalfFloat};
+            return {fmt::format("half2({}[1])", operand.AsHalfFloat()), Type::HalfFloat};
         }
         UNREACHABLE();
         return {"0", Type::Int};
@@ -1507,7 +1567,7 @@ private:
     }
 
     Expression HPack2(Operation operation) {
-        return {fmt::format("vec2({}, {})", VisitOperand(operation, 0).AsFloat(),
+        return {fmt::format("half2({}, {})", VisitOperand(operation, 0).AsFloat(),
                             VisitOperand(operation, 1).AsFloat()),
                 Type::HalfFloat};
     }
@@ -1905,48 +1965,54 @@ private:
 
     Expression BallotThread(Operation operation) {
         const std::string value = VisitOperand(operation, 0).AsBool();
-        if (!device.HasWarpIntrinsics()) {
-            LOG_ERROR(Render_OpenGL, "Nvidia vote intrinsics are required by this shader");
-            // Stub on non-Nvidia devices by simulating all threads voting the same as the active
-            // one.
-            return {fmt::format("({} ? 0xFFFFFFFFU : 0U)", value), Type::Uint};
+        if (device.HasWarpIntrinsics()) {
+            return {fmt::format("ballotThreadNV({})", value), Type::Uint};
         }
-        return {fmt::format("ballotThreadNV({})", value), Type::Uint};
+        if (device.HasSubgroupIntrinsics()) {
+            return {fmt::format("warpBallot({})", value), Type::Uint};
+        }
+        LOG_ERROR(Render_OpenGL, "Warp vote intrinsics are required by this shader");
+        // Stub on devices without them by simulating all threads voting the same as the active
+        // one.
+        return {fmt::format("({} ? 0xFFFFFFFFU : 0U)", value), Type::Uint};
     }
 
-    Expression Vote(Operation operation, const char* func) {
+    Expression Vote(Operation operation, const char* func, const char* subgroup_func) {
         const std::string value = VisitOperand(operation, 0).AsBool();
-        if (!device.HasWarpIntrinsics()) {
-            LOG_ERROR(Render_OpenGL, "Nvidia vote intrinsics are required by this shader");
-            // Stub with a warp size of one.
-            return {value, Type::Bool};
+        if (device.HasWarpIntrinsics()) {
+            return {fmt::format("{}({})", func, value), Type::Bool};
         }
-        return {fmt::format("{}({})", func, value), Type::Bool};
+        if (device.HasSubgroupIntrinsics()) {
+            return {fmt::format("{}({})", subgroup_func, value), Type::Bool};
+        }
+        LOG_ERROR(Render_OpenGL, "Warp vote intrinsics are required by this shader");
+        // Stub with a warp size of one.
+        return {value, Type::Bool};
     }
 
     Expression VoteAll(Operation operation) {
-        return Vote(operation, "allThreadsNV");
+        return Vote(operation, "allThreadsNV", "warpAll");
     }
 
     Expression VoteAny(Operation operation) {
-        return Vote(operation, "anyThreadNV");
+        return Vote(operation, "anyThreadNV", "warpAny");
     }
 
     Expression VoteEqual(Operation operation) {
-        if (!device.HasWarpIntrinsics()) {
-            LOG_ERROR(Render_OpenGL, "Nvidia vote intrinsics are required by this shader");
+        if (!device.HasWarpIntrinsics() && !device.HasSubgroupIntrinsics()) {
+            LOG_ERROR(Render_OpenGL, "Warp vote intrinsics are required by this shader");
             // We must return true here since a stub for a theoretical warp size of 1.
             // This will always return an equal result across all votes.
             return {"true", Type::Bool};
         }
-        return Vote(operation, "allThreadsEqualNV");
+        return Vote(operation, "allThreadsEqualNV", "warpAllEqual");
     }
 
-    template <const std::string_view& func>
+    template <const std::string_view& func, const std::string_view& subgroup_source>
     Expression Shuffle(Operation operation) {
         const std::string value = VisitOperand(operation, 0).AsFloat();
-        if (!device.HasWarpIntrinsics()) {
-            LOG_ERROR(Render_OpenGL, "Nvidia shuffle intrinsics are required by this shader");
+        if (!device.HasWarpIntrinsics() && !device.HasSubgroupIntrinsics()) {
+            LOG_ERROR(Render_OpenGL, "Warp shuffle intrinsics are required by this shader");
             // On a "single-thread" device we are either on the same thread or out of bounds. Both
             // cases return the passed value.
             return {value, Type::Float};
@@ -1954,17 +2020,27 @@ private:
 
         const std::string index = VisitOperand(operation, 1).AsUint();
         const std::string width = VisitOperand(operation, 2).AsUint();
+        if (!device.HasWarpIntrinsics()) {
+            return {fmt::format("warpShuffle({}, {}({}, {}), {})", value, subgroup_source, index,
+                                width, width),
+                    Type::Float};
+        }
         return {fmt::format("{}({}, {}, {})", func, value, index, width), Type::Float};
     }
 
-    template <const std::string_view& func>
+    template <const std::string_view& func, const std::string_view& subgroup_source>
     Expression InRangeShuffle(Operation operation) {
         const std::string index = VisitOperand(operation, 0).AsUint();
         const std::string width = VisitOperand(operation, 1).AsUint();
-        if (!device.HasWarpIntrinsics()) {
+        if (!device.HasWarpIntrinsics() && !device.HasSubgroupIntrinsics()) {
             // On a "single-thread" device we are only in bounds when the requested index is 0.
             return {fmt::format("({} == 0U)", index), Type::Bool};
         }
+        if (!device.HasWarpIntrinsics()) {
+            return {fmt::format("warpInRange({}({}, {}), {})", subgroup_source, index, width,
+                                width),
+                    Type::Bool};
+        }
 
         const std::string in_range = code.GenerateTemporary();
         code.AddLine("bool {};", in_range);
@@ -1986,6 +2062,11 @@ private:
         static constexpr std::string_view ShuffleUp = "shuffleUpNV";
         static constexpr std::string_view ShuffleDown = "shuffleDownNV";
         static constexpr std::string_view ShuffleButterfly = "shuffleXorNV";
+
+        static constexpr std::string_view SubgroupShuffleIndexed = "warpShuffleIndexedSource";
+        static constexpr std::string_view SubgroupShuffleUp = "warpShuffleUpSource";
+        static constexpr std::string_view SubgroupShuffleDown = "warpShuffleDownSource";
+        static constexpr std::string_view SubgroupShuffleButterfly = "warpShuffleButterflySource";
     };
 
     static constexpr std::array operation_decompilers = {
@@ -2151,15 +2232,15 @@ private:
         &GLSLDecompiler::VoteAny,
         &GLSLDecompiler::VoteEqual,
 
-        &GLSLDecompiler::Shuffle<Func::ShuffleIndexed>,
-        &GLSLDecompiler::Shuffle<Func::ShuffleUp>,
-        &GLSLDecompiler::Shuffle<Func::ShuffleDown>,
-        &GLSLDecompiler::Shuffle<Func::ShuffleButterfly>,
+        &GLSLDecompiler::Shuffle<Func::ShuffleIndexed, Func::SubgroupShuffleIndexed>,
+        &GLSLDecompiler::Shuffle<Func::ShuffleUp, Func::SubgroupShuffleUp>,
+        &GLSLDecompiler::Shuffle<Func::ShuffleDown, Func::SubgroupShuffleDown>,
+        &GLSLDecompiler::Shuffle<Func::ShuffleButterfly, Func::SubgroupShuffleButterfly>,
 
-        &GLSLDecompiler::InRangeShuffle<Func::ShuffleIndexed>,
-        &GLSLDecompiler::InRangeShuffle<Func::ShuffleUp>,
-        &GLSLDecompiler::InRangeShuffle<Func::ShuffleDown>,
-        &GLSLDecompiler::InRangeShuffle<Func::ShuffleButterfly>,
+        &GLSLDecompiler::InRangeShuffle<Func::ShuffleIndexed, Func::SubgroupShuffleIndexed>,
+        &GLSLDecompiler::InRangeShuffle<Func::ShuffleUp, Func::SubgroupShuffleUp>,
+        &GLSLDecompiler::InRangeShuffle<Func::ShuffleDown, Func::SubgroupShuffleDown>,
+        &GLSLDecompiler::InRangeShuffle<Func::ShuffleButterfly, Func::SubgroupShuffleButterfly>,
     };
     static_assert(operation_decompilers.size() == static_cast<std::size_t>(OperationCode::Amount));
 
@@ -2481,18 +2562,35 @@ ShaderEntries GetEntries(const VideoCommon::Shader::ShaderIR& ir) {
     return entries;
 }
 
-std::string GetCommonDeclarations() {
-    return R"(#define ftoi floatBitsToInt
+std::string GetCommonDeclarations(const Device& device) {
+    std::string declarations = R"(#define ftoi floatBitsToInt
 #define ftou floatBitsToUint
 #define itof intBitsToFloat
 #define utof uintBitsToFloat
+)";
+
+    // Half float pairs are native types when the host supports them, packing pairs in and out of
+    // registers is then a bitcast. Otherwise they are emulated with fp32 vectors.
+    if (device.HasNativeHalfFloat()) {
+        declarations += R"(#define half2 f16vec2
+#define htou packFloat2x16
+#define utoh unpackFloat2x16
+)";
+    } else {
+        declarations += R"(#define half2 vec2
+#define htou packHalf2x16
+#define utoh unpackHalf2x16
+)";
+    }
 
-bvec2 HalfFloatNanComparison(bvec2 comparison, vec2 pair1, vec2 pair2) {
+    declarations += R"(
+bvec2 HalfFloatNanComparison(bvec2 comparison, half2 pair1, half2 pair2) {
     bvec2 is_nan1 = isnan(pair1);
     bvec2 is_nan2 = isnan(pair2);
     return bvec2(comparison.x || is_nan1.x || is_nan2.x, comparison.y || is_nan1.y || is_nan2.y);
 }
 )";
+    return declarations;
 }
 
 std::string Decompile(const Device& device, const ShaderIR& ir, ProgramType stage,
@@ -91,7 +91,7 @@ struct ShaderEntries {
 
 ShaderEntries GetEntries(const VideoCommon::Shader::ShaderIR& ir);
 
-std::string GetCommonDeclarations();
+std::string GetCommonDeclarations(const Device& device);
 
 std::string Decompile(const Device& device, const VideoCommon::Shader::ShaderIR& ir,
                       ProgramType stage, const std::string& suffix);
@@ -2,7 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include <fmt/format.h>
 
 #include "common/assert.h"
@@ -11,6 +18,7 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
+#include "common/thread.h"
 #include "common/zstd_compression.h"
 
 #include "core/core.h"
@@ -52,11 +60,32 @@ enum class TransferableEntryKind : u32 {
     Usage,
 };
 
-constexpr u32 NativeVersion = 5;
+enum class CacheFile : u32 {
+    Transferable,
+    Precompiled,
+};
+constexpr std::size_t NumCacheFiles = 2;
+
+constexpr u32 NativeVersion = 6;
+
+/// Version of the layout of the precompiled file, the programs themselves are versioned by the
+/// shader cache version hash.
+constexpr u32 PrecompiledVersion = 3;
+
+/// Precedes each entry of the precompiled file, entries are compressed one by one so the file can
+/// be appended to and loaded without holding all of it in memory.
+struct PrecompiledEntryHeader {
+    u64 compressed_size;
+    u64 size;
+};
+static_assert(sizeof(PrecompiledEntryHeader) == 16, "PrecompiledEntryHeader has padding");
 
 // Making sure sizes doesn't change by accident
 static_assert(sizeof(BaseBindings) == 16);
 
+/// Longest time written entries wait before they are synchronized to the storage device.
+constexpr auto SYNC_INTERVAL = std::chrono::seconds{1};
+
 ShaderCacheVersionHash GetShaderCacheVersionHash() {
     ShaderCacheVersionHash hash{};
     const std::size_t length = std::min(std::strlen(Common::g_shader_cache_version), hash.size());
@@ -64,6 +93,139 @@ ShaderCacheVersionHash GetShaderCacheVersionHash() {
     return hash;
 }
 
+/// Appends trivially copyable objects to a buffer.
+template <typename T>
+void AppendArray(std::vector<u8>& buffer, const T* data, std::size_t length) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const std::size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(T) * length);
+    std::memcpy(buffer.data() + offset, data, sizeof(T) * length);
+}
+
+template <typename T>
+void AppendObject(std::vector<u8>& buffer, const T& object) {
+    AppendArray(buffer, &object, 1);
+}
+
+/// Appends the usage keys in the layout shared by the transferable and precompiled files.
+void AppendUsage(std::vector<u8>& buffer, const ShaderDiskCacheUsage& usage) {
+    AppendObject(buffer, usage.unique_identifier);
+    AppendObject(buffer, usage.variant);
+    AppendObject(buffer, static_cast<u32>(usage.keys.size()));
+    AppendObject(buffer, static_cast<u32>(usage.bound_samplers.size()));
+    AppendObject(buffer, static_cast<u32>(usage.bindless_samplers.size()));
+    for (const auto& [pair, value] : usage.keys) {
+        const auto [cbuf, offset] = pair;
+        AppendObject(buffer, ConstBufferKey{cbuf, offset, value});
+    }
+    for (const auto& [offset, sampler] : usage.bound_samplers) {
+        AppendObject(buffer, BoundSamplerKey{offset, sampler});
+    }
+    for (const auto& [pair, sampler] : usage.bindless_samplers) {
+        const auto [cbuf, offset] = pair;
+        AppendObject(buffer, BindlessSamplerKey{cbuf, offset, sampler});
+    }
+}
+
+/// Reads trivially copyable objects from a decompressed precompiled entry.
+class EntryReader {
+public:
+    explicit EntryReader(const std::vector<u8>& data) : data{data} {}
+
+    template <typename T>
+    bool ReadArray(T* output, std::size_t length) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const std::size_t size = sizeof(T) * length;
+        if (data.size() - offset < size) {
+            return false;
+        }
+        std::memcpy(output, data.data() + offset, size);
+        offset += size;
+        return true;
+    }
+
+    template <typename T>
+    bool ReadObject(T& object) {
+        return ReadArray(&object, 1);
+    }
+
+    /// Reads length elements into a vector or string. Counts read from the entry are checked
+    /// against what is left of it before anything is allocated.
+    template <typename Container>
+    bool ReadContainer(Container& output, std::size_t length) {
+        using T = typename Container::value_type;
+        if ((data.size() - offset) / sizeof(T) < length) {
+            return false;
+        }
+        output.resize(length);
+        return ReadArray(output.data(), length);
+    }
+
+private:
+    const std::vector<u8>& data;
+    std::size_t offset = 0;
+};
+
+/// Loads a transferable entry into raws or usages. Returns false on failure.
+bool LoadTransferableEntry(FileUtil::IOFile& file, std::vector<ShaderDiskCacheRaw>& raws,
+                           std::vector<ShaderDiskCacheUsage>& usages) {
+    TransferableEntryKind kind{};
+    if (file.ReadBytes(&kind, sizeof(u32)) != sizeof(u32)) {
+        return false;
+    }
+
+    switch (kind) {
+    case TransferableEntryKind::Raw: {
+        ShaderDiskCacheRaw entry;
+        if (!entry.Load(file)) {
+            return false;
+        }
+        raws.push_back(std::move(entry));
+        return true;
+    }
+    case TransferableEntryKind::Usage: {
+        ShaderDiskCacheUsage usage;
+
+        u32 num_keys{};
+        u32 num_bound_samplers{};
+        u32 num_bindless_samplers{};
+        if (file.ReadArray(&usage.unique_identifier, 1) != 1 ||
+            file.ReadArray(&usage.variant, 1) != 1 || file.ReadArray(&num_keys, 1) != 1 ||
+            file.ReadArray(&num_bound_samplers, 1) != 1 ||
+            file.ReadArray(&num_bindless_samplers, 1) != 1) {
+            return false;
+        }
+
+        std::vector<ConstBufferKey> keys(num_keys);
+        std::vector<BoundSamplerKey> bound_samplers(num_bound_samplers);
+        std::vector<BindlessSamplerKey> bindless_samplers(num_bindless_samplers);
+        if (file.ReadArray(keys.data(), keys.size()) != keys.size() ||
+            file.ReadArray(bound_samplers.data(), bound_samplers.size()) !=
+                bound_samplers.size() ||
+            file.ReadArray(bindless_samplers.data(), bindless_samplers.size()) !=
+                bindless_samplers.size()) {
+            return false;
+        }
+        for (const auto& key : keys) {
+            usage.keys.insert({{key.cbuf, key.offset}, key.value});
+        }
+        for (const auto& key : bound_samplers) {
+            usage.bound_samplers.emplace(key.offset, key.sampler);
+        }
+        for (const auto& key : bindless_samplers) {
+            usage.bindless_samplers.insert({{key.cbuf, key.offset}, key.sampler});
+        }
+
+        usages.push_back(std::move(usage));
+        return true;
+    }
+    default:
+        LOG_ERROR(Render_OpenGL, "Unknown transferable shader cache entry kind={}",
+                  static_cast<u32>(kind));
+        return false;
+    }
+}
+
 } // Anonymous namespace
 
 ShaderDiskCacheRaw::ShaderDiskCacheRaw(u64 unique_identifier, ProgramType program_type,
@@ -100,23 +262,219 @@ bool ShaderDiskCacheRaw::Load(FileUtil::IOFile& file) {
     return true;
 }
 
-bool ShaderDiskCacheRaw::Save(FileUtil::IOFile& file) const {
-    if (file.WriteObject(unique_identifier) != 1 ||
-        file.WriteObject(static_cast<u32>(program_type)) != 1 ||
-        file.WriteObject(static_cast<u32>(program_code.size())) != 1 ||
-        file.WriteObject(static_cast<u32>(program_code_b.size())) != 1) {
-        return false;
+void ShaderDiskCacheRaw::Save(std::vector<u8>& buffer) const {
+    AppendObject(buffer, unique_identifier);
+    AppendObject(buffer, static_cast<u32>(program_type));
+    AppendObject(buffer, static_cast<u32>(program_code.size()));
+    AppendObject(buffer, static_cast<u32>(program_code_b.size()));
+    AppendArray(buffer, program_code.data(), program_code.size());
+    if (HasProgramA()) {
+        AppendArray(buffer, program_code_b.data(), program_code_b.size());
     }
+}
 
-    if (file.WriteArray(program_code.data(), program_code.size()) != program_code.size())
-        return false;
+/// Appends the saved entries to the cache files from its own thread, so the GPU thread never
+/// waits on the disk. Every entry is written at the end of its file with a single write, a crash
+/// can only leave the last one truncated and the loaders cut it off. Files are synchronized to
+/// the storage device at most once every SYNC_INTERVAL and when the writer is destroyed.
+class ShaderDiskCacheOpenGL::Writer {
+public:
+    explicit Writer(const ShaderDiskCacheOpenGL& cache)
+        : cache{cache}, paths{cache.GetTransferablePath(), cache.GetPrecompiledPath()} {
+        thread = std::thread(&Writer::Loop, this);
+    }
+
+    ~Writer() {
+        {
+            std::lock_guard lock{mutex};
+            is_stopping = true;
+        }
+        work_cv.notify_one();
+        thread.join();
+    }
 
-    if (HasProgramA() &&
-        file.WriteArray(program_code_b.data(), program_code_b.size()) != program_code_b.size()) {
-        return false;
+    /// Queues data to be appended to a file. Precompiled entries are compressed by the writer.
+    void Append(CacheFile file, std::vector<u8> data) {
+        {
+            std::lock_guard lock{mutex};
+            queue.push_back({file, false, std::move(data)});
+        }
+        work_cv.notify_one();
     }
-    return true;
-}
+
+    /// Removes a file after the writes queued before, and waits until it is removed.
+    void Remove(CacheFile file) {
+        std::unique_lock lock{mutex};
+        queue.push_back({file, true, {}});
+        work_cv.notify_one();
+        idle_cv.wait(lock, [this] { return queue.empty() && !is_busy; });
+    }
+
+private:
+    struct Operation {
+        CacheFile file;
+        bool is_remove;
+        std::vector<u8> data;
+    };
+
+    void Loop() {
+        Common::SetCurrentThreadName("yuzu:ShaderDiskCacheWriter");
+
+        std::deque<Operation> batch;
+        std::unique_lock lock{mutex};
+        while (true) {
+            const auto has_work = [this] { return !queue.empty() || is_stopping; };
+            if (has_unsynced_writes) {
+                work_cv.wait_for(lock, SYNC_INTERVAL, has_work);
+            } else {
+                work_cv.wait(lock, has_work);
+            }
+            batch.swap(queue);
+            is_busy = true;
+            lock.unlock();
+
+            for (Operation& operation : batch) {
+                Execute(operation);
+            }
+            batch.clear();
+            if (has_unsynced_writes &&
+                std::chrono::steady_clock::now() - last_sync >= SYNC_INTERVAL) {
+                Sync();
+            }
+
+            lock.lock();
+            is_busy = false;
+            if (queue.empty()) {
+                idle_cv.notify_all();
+                if (is_stopping) {
+                    break;
+                }
+            }
+        }
+        lock.unlock();
+        Sync();
+    }
+
+    void Execute(Operation& operation) {
+        const auto index = static_cast<std::size_t>(operation.file);
+        if (operation.is_remove) {
+            Delete(operation.file);
+            is_failed[index] = false;
+            return;
+        }
+        if (is_failed[index]) {
+            return;
+        }
+
+        FileUtil::IOFile& file = files[index];
+        if (!file.IsOpen() && !Open(operation.file)) {
+            is_failed[index] = true;
+            return;
+        }
+
+        bool is_written;
+        if (operation.file == CacheFile::Transferable) {
+            const std::vector<u8>& data = operation.data;
+            is_written = file.WriteBytes(data.data(), data.size()) == data.size();
+        } else {
+            // The header and the entry are written at once so they can't be separated on a crash
+            const std::vector<u8> compressed = Common::Compression::CompressDataZSTDDefault(
+                operation.data.data(), operation.data.size());
+            if (compressed.empty()) {
+                return;
+            }
+            std::vector<u8> entry;
+            entry.reserve(sizeof(PrecompiledEntryHeader) + compressed.size());
+            AppendObject(entry, PrecompiledEntryHeader{compressed.size(), operation.data.size()});
+            AppendArray(entry, compressed.data(), compressed.size());
+            is_written = file.WriteBytes(entry.data(), entry.size()) == entry.size();
+        }
+        if (!is_written) {
+            LOG_ERROR(Render_OpenGL, "Failed to write shader cache file={}, removing",
+                      paths[index]);
+            Delete(operation.file);
+            is_failed[index] = true;
+            // Precompiled entries are only valid alongside the transferable they were built from
+            if (operation.file == CacheFile::Transferable) {
+                Delete(CacheFile::Precompiled);
+                is_failed[static_cast<std::size_t>(CacheFile::Precompiled)] = true;
+            }
+            return;
+        }
+        has_unsynced_writes = true;
+    }
+
+    /// Opens a file for appending and writes its header if it's new
+    bool Open(CacheFile kind) {
+        const auto index = static_cast<std::size_t>(kind);
+        const std::string& path = paths[index];
+        if (!cache.EnsureDirectories()) {
+            return false;
+        }
+
+        FileUtil::IOFile& file = files[index];
+        if (!file.Open(path, "ab")) {
+            LOG_ERROR(Render_OpenGL, "Failed to open shader cache in path={}", path);
+            return false;
+        }
+        if (file.GetSize() != 0) {
+            return true;
+        }
+
+        std::vector<u8> header;
+        if (kind == CacheFile::Transferable) {
+            AppendObject(header, NativeVersion);
+        } else {
+            // The version of the precompiled layout and the version of the programs
+            const auto hash{GetShaderCacheVersionHash()};
+            AppendObject(header, PrecompiledVersion);
+            AppendArray(header, hash.data(), hash.size());
+        }
+        if (file.WriteBytes(header.data(), header.size()) != header.size()) {
+            LOG_ERROR(Render_OpenGL, "Failed to write shader cache version in path={}", path);
+            file.Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Delete(CacheFile kind) {
+        const auto index = static_cast<std::size_t>(kind);
+        files[index].Close();
+        if (FileUtil::Exists(paths[index]) && !FileUtil::Delete(paths[index])) {
+            LOG_ERROR(Render_OpenGL, "Failed to invalidate shader cache file={}", paths[index]);
+        }
+    }
+
+    void Sync() {
+        for (std::size_t index = 0; index < NumCacheFiles; ++index) {
+            if (files[index].IsOpen() && !files[index].Sync()) {
+                LOG_ERROR(Render_OpenGL, "Failed to synchronize shader cache file={}",
+                          paths[index]);
+            }
+        }
+        has_unsynced_writes = false;
+        last_sync = std::chrono::steady_clock::now();
+    }
+
+    const ShaderDiskCacheOpenGL& cache;
+    const std::array<std::string, NumCacheFiles> paths;
+
+    // Only accessed from the writer thread
+    std::array<FileUtil::IOFile, NumCacheFiles> files;
+    std::array<bool, NumCacheFiles> is_failed{};
+    bool has_unsynced_writes = false;
+    std::chrono::steady_clock::time_point last_sync;
+
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable idle_cv;
+    std::deque<Operation> queue;
+    bool is_busy = false;
+    bool is_stopping = false;
+
+    std::thread thread;
+};
 
 ShaderDiskCacheOpenGL::ShaderDiskCacheOpenGL(Core::System& system) : system{system} {}
 
@@ -130,7 +488,8 @@ ShaderDiskCacheOpenGL::LoadTransferable() {
         return {};
     }
 
-    FileUtil::IOFile file(GetTransferablePath(), "rb");
+    // Opened for writing too, a truncated last entry is cut off so new ones can be appended
+    FileUtil::IOFile file(GetTransferablePath(), "r+b");
     if (!file.IsOpen()) {
         LOG_INFO(Render_OpenGL, "No transferable shader cache found for game with title id={}",
                  GetTitleID());
@@ -160,73 +519,53 @@ ShaderDiskCacheOpenGL::LoadTransferable() {
     }
 
     // Version is valid, load the shaders
-    constexpr const char error_loading[] = "Failed to load transferable raw entry, skipping";
-    std::vector<ShaderDiskCacheRaw> raws;
-    std::vector<ShaderDiskCacheUsage> usages;
-    while (file.Tell() < file.GetSize()) {
-        TransferableEntryKind kind{};
-        if (file.ReadBytes(&kind, sizeof(u32)) != sizeof(u32)) {
-            LOG_ERROR(Render_OpenGL, "Failed to read transferable file, skipping");
-            return {};
-        }
+    auto entries = LoadTransferableEntries(file);
+    if (!entries) {
+        return {};
+    }
+    for (const auto& entry : entries->first) {
+        transferable.insert({entry.GetUniqueIdentifier(), {}});
+    }
 
-        switch (kind) {
-        case TransferableEntryKind::Raw: {
-            ShaderDiskCacheRaw entry;
-            if (!entry.Load(file)) {
-                LOG_ERROR(Render_OpenGL, error_loading);
-                return {};
-            }
-            transferable.insert({entry.GetUniqueIdentifier(), {}});
-            raws.push_back(std::move(entry));
-            break;
-        }
-        case TransferableEntryKind::Usage: {
-            ShaderDiskCacheUsage usage;
-
-            u32 num_keys{};
-            u32 num_bound_samplers{};
-            u32 num_bindless_samplers{};
-            if (file.ReadArray(&usage.unique_identifier, 1) != 1 ||
-                file.ReadArray(&usage.variant, 1) != 1 || file.ReadArray(&num_keys, 1) != 1 ||
-                file.ReadArray(&num_bound_samplers, 1) != 1 ||
-                file.ReadArray(&num_bindless_samplers, 1) != 1) {
-                LOG_ERROR(Render_OpenGL, error_loading);
-                return {};
-            }
+    is_usable = true;
+    return entries;
+}
 
-            std::vector<ConstBufferKey> keys(num_keys);
-            std::vector<BoundSamplerKey> bound_samplers(num_bound_samplers);
-            std::vector<BindlessSamplerKey> bindless_samplers(num_bindless_samplers);
-            if (file.ReadArray(keys.data(), keys.size()) != keys.size() ||
-                file.ReadArray(bound_samplers.data(), bound_samplers.size()) !=
-                    bound_samplers.size() ||
-                file.ReadArray(bindless_samplers.data(), bindless_samplers.size()) !=
-                    bindless_samplers.size()) {
-                LOG_ERROR(Render_OpenGL, error_loading);
-                return {};
-            }
-            for (const auto& key : keys) {
-                usage.keys.insert({{key.cbuf, key.offset}, key.value});
-            }
-            for (const auto& key : bound_samplers) {
-                usage.bound_samplers.emplace(key.offset, key.sampler);
-            }
-            for (const auto& key : bindless_samplers) {
-                usage.bindless_samplers.insert({{key.cbuf, key.offset}, key.sampler});
-            }
+std::optional<std::pair<std::vector<ShaderDiskCacheRaw>, std::vector<ShaderDiskCacheUsage>>>
+ShaderDiskCacheOpenGL::LoadTransferableFile(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render_OpenGL, "Failed to open transferable shader cache file={}", path);
+        return {};
+    }
+    u32 version{};
+    if (file.ReadBytes(&version, sizeof(version)) != sizeof(version) || version != NativeVersion) {
+        LOG_ERROR(Render_OpenGL, "Transferable shader cache file={} has an unsupported version",
+                  path);
+        return {};
+    }
+    return LoadTransferableEntries(file);
+}
 
-            usages.push_back(std::move(usage));
-            break;
+std::optional<std::pair<std::vector<ShaderDiskCacheRaw>, std::vector<ShaderDiskCacheUsage>>>
+ShaderDiskCacheOpenGL::LoadTransferableEntries(FileUtil::IOFile& file) {
+    std::vector<ShaderDiskCacheRaw> raws;
+    std::vector<ShaderDiskCacheUsage> usages;
+    while (file.Tell() < file.GetSize()) {
+        const u64 entry_start = file.Tell();
+        if (LoadTransferableEntry(file, raws, usages)) {
+            continue;
         }
-        default:
-            LOG_ERROR(Render_OpenGL, "Unknown transferable shader cache entry kind={}, skipping",
-                      static_cast<u32>(kind));
+        if (file.Tell() < file.GetSize()) {
+            LOG_ERROR(Render_OpenGL, "Failed to load transferable cache entry, skipping");
             return {};
         }
+        // Entries are appended whole, one running past the end was cut off while it was written
+        LOG_WARNING(Render_OpenGL, "Transferable cache is truncated, removing its last entry");
+        file.Resize(entry_start);
+        break;
     }
 
-    is_usable = true;
     return {{std::move(raws), std::move(usages)}};
 }
 
@@ -236,8 +575,9 @@ ShaderDiskCacheOpenGL::LoadPrecompiled() {
         return {};
     }
 
+    // Opened for writing too, a truncated last entry is cut off so new ones can be appended
     std::string path = GetPrecompiledPath();
-    FileUtil::IOFile file(path, "rb");
+    FileUtil::IOFile file(path, "r+b");
     if (!file.IsOpen()) {
         LOG_INFO(Render_OpenGL, "No precompiled shader cache found for game with title id={}",
                  GetTitleID());
@@ -258,44 +598,58 @@ ShaderDiskCacheOpenGL::LoadPrecompiled() {
 
 std::optional<std::unordered_map<ShaderDiskCacheUsage, ShaderDiskCacheDump>>
 ShaderDiskCacheOpenGL::LoadPrecompiledFile(FileUtil::IOFile& file) {
-    // Read compressed file from disk and decompress to virtual precompiled cache file
-    std::vector<u8> compressed(file.GetSize());
-    file.ReadBytes(compressed.data(), compressed.size());
-    const std::vector<u8> decompressed = Common::Compression::DecompressDataZSTD(compressed);
-    SaveArrayToPrecompiled(decompressed.data(), decompressed.size());
-    precompiled_cache_virtual_file_offset = 0;
-
+    u32 version{};
     ShaderCacheVersionHash file_hash{};
-    if (!LoadArrayFromPrecompiled(file_hash.data(), file_hash.size())) {
-        precompiled_cache_virtual_file_offset = 0;
+    if (file.ReadBytes(&version, sizeof(version)) != sizeof(version) ||
+        file.ReadArray(file_hash.data(), file_hash.size()) != file_hash.size()) {
         return {};
     }
-    if (GetShaderCacheVersionHash() != file_hash) {
+    if (version != PrecompiledVersion || GetShaderCacheVersionHash() != file_hash) {
         LOG_INFO(Render_OpenGL, "Precompiled cache is from another version of the emulator");
-        precompiled_cache_virtual_file_offset = 0;
         return {};
     }
 
     ShaderDumpsMap dumps;
-    while (precompiled_cache_virtual_file_offset < precompiled_cache_virtual_file.GetSize()) {
+    std::vector<u8> compressed;
+    const u64 file_size = file.GetSize();
+    u64 offset = sizeof(version) + file_hash.size();
+    while (offset < file_size) {
+        PrecompiledEntryHeader header{};
+        const bool is_complete = offset + sizeof(header) <= file_size &&
+                                 file.ReadBytes(&header, sizeof(header)) == sizeof(header) &&
+                                 header.compressed_size <= file_size - offset - sizeof(header);
+        if (!is_complete) {
+            // Left truncated while it was appended, keep the entries before it
+            LOG_WARNING(Render_OpenGL, "Precompiled cache is truncated, removing its last entry");
+            file.Resize(offset);
+            break;
+        }
+        compressed.resize(header.compressed_size);
+        if (file.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+            return {};
+        }
+        const std::vector<u8> data = Common::Compression::DecompressDataZSTD(compressed);
+        if (data.size() != header.size) {
+            return {};
+        }
+        offset += sizeof(header) + header.compressed_size;
+
+        EntryReader reader{data};
         u32 num_keys{};
         u32 num_bound_samplers{};
         u32 num_bindless_samplers{};
         ShaderDiskCacheUsage usage;
-        if (!LoadObjectFromPrecompiled(usage.unique_identifier) ||
-            !LoadObjectFromPrecompiled(usage.variant) || !LoadObjectFromPrecompiled(num_keys) ||
-            !LoadObjectFromPrecompiled(num_bound_samplers) ||
-            !LoadObjectFromPrecompiled(num_bindless_samplers)) {
+        if (!reader.ReadObject(usage.unique_identifier) || !reader.ReadObject(usage.variant) ||
+            !reader.ReadObject(num_keys) || !reader.ReadObject(num_bound_samplers) ||
+            !reader.ReadObject(num_bindless_samplers)) {
             return {};
         }
-        std::vector<ConstBufferKey> keys(num_keys);
-        std::vector<BoundSamplerKey> bound_samplers(num_bound_samplers);
-        std::vector<BindlessSamplerKey> bindless_samplers(num_bindless_samplers);
-        if (!LoadArrayFromPrecompiled(keys.data(), keys.size()) ||
-            !LoadArrayFromPrecompiled(bound_samplers.data(), bound_samplers.size()) !=
-                bound_samplers.size() ||
-            !LoadArrayFromPrecompiled(bindless_samplers.data(), bindless_samplers.size()) !=
-                bindless_samplers.size()) {
+        std::vector<ConstBufferKey> keys;
+        std::vector<BoundSamplerKey> bound_samplers;
+        std::vector<BindlessSamplerKey> bindless_samplers;
+        if (!reader.ReadContainer(keys, num_keys) ||
+            !reader.ReadContainer(bound_samplers, num_bound_samplers) ||
+            !reader.ReadContainer(bindless_samplers, num_bindless_samplers)) {
             return {};
         }
         for (const auto& key : keys) {
@@ -309,40 +663,29 @@ ShaderDiskCacheOpenGL::LoadPrecompiledFile(FileUtil::IOFile& file) {
         }
 
         ShaderDiskCacheDump dump;
-        if (!LoadObjectFromPrecompiled(dump.binary_format)) {
-            return {};
-        }
-
         u32 binary_length{};
-        if (!LoadObjectFromPrecompiled(binary_length)) {
+        if (!reader.ReadObject(dump.binary_format) || !reader.ReadObject(binary_length)) {
             return {};
         }
-
-        dump.binary.resize(binary_length);
-        if (!LoadArrayFromPrecompiled(dump.binary.data(), dump.binary.size())) {
+        u32 source_length{};
+        if (!reader.ReadContainer(dump.binary, binary_length) ||
+            !reader.ReadObject(source_length) ||
+            !reader.ReadContainer(dump.source, source_length)) {
             return {};
         }
 
-        dumps.emplace(std::move(usage), dump);
+        dumps.emplace(std::move(usage), std::move(dump));
     }
     return dumps;
 }
 
 void ShaderDiskCacheOpenGL::InvalidateTransferable() {
-    if (!FileUtil::Delete(GetTransferablePath())) {
-        LOG_ERROR(Render_OpenGL, "Failed to invalidate transferable file={}",
-                  GetTransferablePath());
-    }
+    GetWriter().Remove(CacheFile::Transferable);
     InvalidatePrecompiled();
 }
 
 void ShaderDiskCacheOpenGL::InvalidatePrecompiled() {
-    // Clear virtaul precompiled cache file
-    precompiled_cache_virtual_file.Resize(0);
-
-    if (!FileUtil::Delete(GetPrecompiledPath())) {
-        LOG_ERROR(Render_OpenGL, "Failed to invalidate precompiled file={}", GetPrecompiledPath());
-    }
+    GetWriter().Remove(CacheFile::Precompiled);
 }
 
 void ShaderDiskCacheOpenGL::SaveRaw(const ShaderDiskCacheRaw& entry) {
@@ -356,16 +699,10 @@ void ShaderDiskCacheOpenGL::SaveRaw(const ShaderDiskCacheRaw& entry) {
         return;
     }
 
-    FileUtil::IOFile file = AppendTransferableFile();
-    if (!file.IsOpen()) {
-        return;
-    }
-    if (file.WriteObject(TransferableEntryKind::Raw) != 1 || !entry.Save(file)) {
-        LOG_ERROR(Render_OpenGL, "Failed to save raw transferable cache entry, removing");
-        file.Close();
-        InvalidateTransferable();
-        return;
-    }
+    std::vector<u8> data;
+    AppendObject(data, TransferableEntryKind::Raw);
+    entry.Save(data);
+    GetWriter().Append(CacheFile::Transferable, std::move(data));
     transferable.insert({id, {}});
 }
 
@@ -384,57 +721,18 @@ void ShaderDiskCacheOpenGL::SaveUsage(const ShaderDiskCacheUsage& usage) {
     }
     usages.insert(usage);
 
-    FileUtil::IOFile file = AppendTransferableFile();
-    if (!file.IsOpen())
-        return;
-    const auto Close = [&] {
-        LOG_ERROR(Render_OpenGL, "Failed to save usage transferable cache entry, removing");
-        file.Close();
-        InvalidateTransferable();
-    };
-
-    if (file.WriteObject(TransferableEntryKind::Usage) != 1 ||
-        file.WriteObject(usage.unique_identifier) != 1 || file.WriteObject(usage.variant) != 1 ||
-        file.WriteObject(static_cast<u32>(usage.keys.size())) != 1 ||
-        file.WriteObject(static_cast<u32>(usage.bound_samplers.size())) != 1 ||
-        file.WriteObject(static_cast<u32>(usage.bindless_samplers.size())) != 1) {
-        Close();
-        return;
-    }
-    for (const auto& [pair, value] : usage.keys) {
-        const auto [cbuf, offset] = pair;
-        if (file.WriteObject(ConstBufferKey{cbuf, offset, value}) != 1) {
-            Close();
-            return;
-        }
-    }
-    for (const auto& [offset, sampler] : usage.bound_samplers) {
-        if (file.WriteObject(BoundSamplerKey{offset, sampler}) != 1) {
-            Close();
-            return;
-        }
-    }
-    for (const auto& [pair, sampler] : usage.bindless_samplers) {
-        const auto [cbuf, offset] = pair;
-        if (file.WriteObject(BindlessSamplerKey{cbuf, offset, sampler}) != 1) {
-            Close();
-            return;
-        }
-    }
+    std::vector<u8> data;
+    AppendObject(data, TransferableEntryKind::Usage);
+    AppendUsage(data, usage);
+    GetWriter().Append(CacheFile::Transferable, std::move(data));
 }
 
-void ShaderDiskCacheOpenGL::SaveDump(const ShaderDiskCacheUsage& usage, GLuint program) {
+void ShaderDiskCacheOpenGL::SaveDump(const ShaderDiskCacheUsage& usage, GLuint program,
+                                     const std::string& source) {
     if (!is_usable) {
         return;
     }
 
-    // TODO(Rodrigo): This is a design smell. I shouldn't be having to manually write the header
-    // when writing the dump. This should be done the moment I get access to write to the virtual
-    // file.
-    if (precompiled_cache_virtual_file.GetSize() == 0) {
-        SavePrecompiledHeaderToVirtualPrecompiledCache();
-    }
-
     GLint binary_length{};
     glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_length);
 
@@ -442,98 +740,21 @@ void ShaderDiskCacheOpenGL::SaveDump(const ShaderDiskCacheUsage& usage, GLuint p
     std::vector<u8> binary(binary_length);
     glGetProgramBinary(program, binary_length, nullptr, &binary_format, binary.data());
 
-    const auto Close = [&] {
-        LOG_ERROR(Render_OpenGL, "Failed to save binary program file in shader={:016X}, removing",
-                  usage.unique_identifier);
-        InvalidatePrecompiled();
-    };
-
-    if (!SaveObjectToPrecompiled(usage.unique_identifier) ||
-        !SaveObjectToPrecompiled(usage.variant) ||
-        !SaveObjectToPrecompiled(static_cast<u32>(usage.keys.size())) ||
-        !SaveObjectToPrecompiled(static_cast<u32>(usage.bound_samplers.size())) ||
-        !SaveObjectToPrecompiled(static_cast<u32>(usage.bindless_samplers.size()))) {
-        Close();
-        return;
-    }
-    for (const auto& [pair, value] : usage.keys) {
-        const auto [cbuf, offset] = pair;
-        if (SaveObjectToPrecompiled(ConstBufferKey{cbuf, offset, value}) != 1) {
-            Close();
-            return;
-        }
-    }
-    for (const auto& [offset, sampler] : usage.bound_samplers) {
-        if (SaveObjectToPrecompiled(BoundSamplerKey{offset, sampler}) != 1) {
-            Close();
-            return;
-        }
-    }
-    for (const auto& [pair, sampler] : usage.bindless_samplers) {
-        const auto [cbuf, offset] = pair;
-        if (SaveObjectToPrecompiled(BindlessSamplerKey{cbuf, offset, sampler}) != 1) {
-            Close();
-            return;
-        }
-    }
-    if (!SaveObjectToPrecompiled(static_cast<u32>(binary_format)) ||
-        !SaveObjectToPrecompiled(static_cast<u32>(binary_length)) ||
-        !SaveArrayToPrecompiled(binary.data(), binary.size())) {
-        Close();
-    }
-}
-
-FileUtil::IOFile ShaderDiskCacheOpenGL::AppendTransferableFile() const {
-    if (!EnsureDirectories()) {
-        return {};
-    }
-
-    const auto transferable_path{GetTransferablePath()};
-    const bool existed = FileUtil::Exists(transferable_path);
-
-    FileUtil::IOFile file(transferable_path, "ab");
-    if (!file.IsOpen()) {
-        LOG_ERROR(Render_OpenGL, "Failed to open transferable cache in path={}", transferable_path);
-        return {};
-    }
-    if (!existed || file.GetSize() == 0) {
-        // If the file didn't exist, write its version
-        if (file.WriteObject(NativeVersion) != 1) {
-            LOG_ERROR(Render_OpenGL, "Failed to write transferable cache version in path={}",
-                      transferable_path);
-            return {};
-        }
-    }
-    return file;
-}
-
-void ShaderDiskCacheOpenGL::SavePrecompiledHeaderToVirtualPrecompiledCache() {
-    const auto hash{GetShaderCacheVersionHash()};
-    if (!SaveArrayToPrecompiled(hash.data(), hash.size())) {
-        LOG_ERROR(
-            Render_OpenGL,
-            "Failed to write precompiled cache version hash to virtual precompiled cache file");
-    }
+    std::vector<u8> entry;
+    AppendUsage(entry, usage);
+    AppendObject(entry, static_cast<u32>(binary_format));
+    AppendObject(entry, static_cast<u32>(binary_length));
+    AppendArray(entry, binary.data(), binary.size());
+    AppendObject(entry, static_cast<u32>(source.size()));
+    AppendArray(entry, source.data(), source.size());
+    GetWriter().Append(CacheFile::Precompiled, std::move(entry));
 }
 
-void ShaderDiskCacheOpenGL::SaveVirtualPrecompiledFile() {
-    precompiled_cache_virtual_file_offset = 0;
-    const std::vector<u8> uncompressed = precompiled_cache_virtual_file.ReadAllBytes();
-    const std::vector<u8> compressed =
-        Common::Compression::CompressDataZSTDDefault(uncompressed.data(), uncompressed.size());
-
-    const auto precompiled_path{GetPrecompiledPath()};
-    FileUtil::IOFile file(precompiled_path, "wb");
-
-    if (!file.IsOpen()) {
-        LOG_ERROR(Render_OpenGL, "Failed to open precompiled cache in path={}", precompiled_path);
-        return;
-    }
-    if (file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
-        LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache version in path={}",
-                  precompiled_path);
-        return;
+ShaderDiskCacheOpenGL::Writer& ShaderDiskCacheOpenGL::GetWriter() {
+    if (!writer) {
+        writer = std::make_unique<Writer>(*this);
     }
+    return *writer;
 }
 
 bool ShaderDiskCacheOpenGL::EnsureDirectories() const {
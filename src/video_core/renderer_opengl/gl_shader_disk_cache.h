@@ -5,6 +5,7 @@
 #pragma once
 
 #include <bitset>
+#include <memory>
 #include <optional>
 #include <string>
 #include <tuple>
@@ -18,7 +19,6 @@
 
 #include "common/assert.h"
 #include "common/common_types.h"
-#include "core/file_sys/vfs_vector.h"
 #include "video_core/renderer_opengl/gl_shader_gen.h"
 #include "video_core/shader/const_buffer_locker.h"
 
@@ -139,7 +139,8 @@ public:
 
     bool Load(FileUtil::IOFile& file);
 
-    bool Save(FileUtil::IOFile& file) const;
+    /// Appends the serialized entry to buffer.
+    void Save(std::vector<u8>& buffer) const;
 
     u64 GetUniqueIdentifier() const {
         return unique_identifier;
@@ -173,6 +174,9 @@ private:
 struct ShaderDiskCacheDump {
     GLenum binary_format{};
     std::vector<u8> binary;
+
+    /// GLSL source the binary was built from, rebuilt when the driver rejects the binary
+    std::string source;
 };
 
 class ShaderDiskCacheOpenGL {
@@ -184,37 +188,44 @@ public:
     std::optional<std::pair<std::vector<ShaderDiskCacheRaw>, std::vector<ShaderDiskCacheUsage>>>
     LoadTransferable();
 
+    /// Loads the entries of a transferable file outside of a game, e.g. for offline tools.
+    static std::optional<
+        std::pair<std::vector<ShaderDiskCacheRaw>, std::vector<ShaderDiskCacheUsage>>>
+    LoadTransferableFile(const std::string& path);
+
     /// Loads current game's precompiled cache. Invalidates on failure.
     std::unordered_map<ShaderDiskCacheUsage, ShaderDiskCacheDump> LoadPrecompiled();
 
-    /// Removes the transferable (and precompiled) cache file.
+    /// Removes the transferable (and precompiled) cache file. Waits for the queued writes.
     void InvalidateTransferable();
 
-    /// Removes the precompiled cache file and clears virtual precompiled cache file.
+    /// Removes the precompiled cache file. Waits for the queued writes.
     void InvalidatePrecompiled();
 
-    /// Saves a raw dump to the transferable file. Checks for collisions.
+    /// Queues a raw dump to be saved to the transferable file. Checks for collisions.
     void SaveRaw(const ShaderDiskCacheRaw& entry);
 
-    /// Saves shader usage to the transferable file. Does not check for collisions.
+    /// Queues shader usage to be saved to the transferable file. Does not check for collisions.
     void SaveUsage(const ShaderDiskCacheUsage& usage);
 
-    /// Saves a dump entry to the precompiled file. Does not check for collisions.
-    void SaveDump(const ShaderDiskCacheUsage& usage, GLuint program);
-
-    /// Serializes virtual precompiled shader cache file to real file
-    void SaveVirtualPrecompiledFile();
+    /// Queues a dump entry to be appended to the precompiled file. Does not check for collisions.
+    void SaveDump(const ShaderDiskCacheUsage& usage, GLuint program, const std::string& source);
 
 private:
-    /// Loads the transferable cache. Returns empty on failure.
+    class Writer;
+
+    /// Loads the entries following the version of a transferable file. Returns empty on failure.
+    /// A truncated last entry is cut off when the file is writable.
+    static std::optional<
+        std::pair<std::vector<ShaderDiskCacheRaw>, std::vector<ShaderDiskCacheUsage>>>
+    LoadTransferableEntries(FileUtil::IOFile& file);
+
+    /// Loads the precompiled cache entry by entry. Returns empty on failure.
     std::optional<std::unordered_map<ShaderDiskCacheUsage, ShaderDiskCacheDump>>
     LoadPrecompiledFile(FileUtil::IOFile& file);
 
-    /// Opens current game's transferable file and write it's header if it doesn't exist
-    FileUtil::IOFile AppendTransferableFile() const;
-
-    /// Save precompiled header to precompiled_cache_in_memory
-    void SavePrecompiledHeaderToVirtualPrecompiledCache();
+    /// Returns the writer of current game's cache files, starting it on first use
+    Writer& GetWriter();
 
     /// Create shader disk cache directories. Returns true on success.
     bool EnsureDirectories() const;
@@ -237,44 +248,10 @@ private:
     /// Get current game's title id
     std::string GetTitleID() const;
 
-    template <typename T>
-    bool SaveArrayToPrecompiled(const T* data, std::size_t length) {
-        const std::size_t write_length = precompiled_cache_virtual_file.WriteArray(
-            data, length, precompiled_cache_virtual_file_offset);
-        precompiled_cache_virtual_file_offset += write_length;
-        return write_length == sizeof(T) * length;
-    }
-
-    template <typename T>
-    bool LoadArrayFromPrecompiled(T* data, std::size_t length) {
-        const std::size_t read_length = precompiled_cache_virtual_file.ReadArray(
-            data, length, precompiled_cache_virtual_file_offset);
-        precompiled_cache_virtual_file_offset += read_length;
-        return read_length == sizeof(T) * length;
-    }
-
-    template <typename T>
-    bool SaveObjectToPrecompiled(const T& object) {
-        return SaveArrayToPrecompiled(&object, 1);
-    }
-
-    bool SaveObjectToPrecompiled(bool object) {
-        const auto value = static_cast<u8>(object);
-        return SaveArrayToPrecompiled(&value, 1);
-    }
-
-    template <typename T>
-    bool LoadObjectFromPrecompiled(T& object) {
-        return LoadArrayFromPrecompiled(&object, 1);
-    }
-
     Core::System& system;
 
-    // Stores whole precompiled cache which will be read from or saved to the precompiled chache
-    // file
-    FileSys::VectorVfsFile precompiled_cache_virtual_file;
-    // Stores the current offset of the precompiled cache file for IO purposes
-    std::size_t precompiled_cache_virtual_file_offset = 0;
+    // Thread appending the saved entries to the cache files
+    std::unique_ptr<Writer> writer;
 
     // Stored transferable shaders
     std::unordered_map<u64, std::unordered_set<ShaderDiskCacheUsage>> transferable;
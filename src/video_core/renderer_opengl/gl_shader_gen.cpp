@@ -17,7 +17,7 @@ using VideoCommon::Shader::ProgramCode;
 using VideoCommon::Shader::ShaderIR;
 
 std::string GenerateVertexShader(const Device& device, const ShaderIR& ir, const ShaderIR* ir_b) {
-    std::string out = GetCommonDeclarations();
+    std::string out = GetCommonDeclarations(device);
     out += R"(
 layout (std140, binding = EMULATION_UBO_BINDING) uniform vs_config {
     vec4 viewport_flip;
@@ -56,7 +56,7 @@ void main() {
 }
 
 std::string GenerateGeometryShader(const Device& device, const ShaderIR& ir) {
-    std::string out = GetCommonDeclarations();
+    std::string out = GetCommonDeclarations(device);
     out += R"(
 layout (std140, binding = EMULATION_UBO_BINDING) uniform gs_config {
     vec4 viewport_flip;
@@ -75,7 +75,7 @@ void main() {
 }
 
 std::string GenerateFragmentShader(const Device& device, const ShaderIR& ir) {
-    std::string out = GetCommonDeclarations();
+    std::string out = GetCommonDeclarations(device);
     out += R"(
 layout (location = 0) out vec4 FragColor0;
 layout (location = 1) out vec4 FragColor1;
@@ -103,7 +103,7 @@ void main() {
 }
 
 std::string GenerateComputeShader(const Device& device, const ShaderIR& ir) {
-    std::string out = GetCommonDeclarations();
+    std::string out = GetCommonDeclarations(device);
     out += Decompile(device, ir, ProgramType::Compute, "compute");
     out += R"(
 void main() {
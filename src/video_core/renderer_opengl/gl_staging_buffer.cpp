@@ -0,0 +1,84 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/microprofile.h"
+#include "video_core/renderer_opengl/gl_staging_buffer.h"
+
+MICROPROFILE_DEFINE(OpenGL_StagingWait, "OpenGL", "Staging Buffer Wait", MP_RGB(128, 128, 192));
+
+namespace OpenGL {
+
+namespace {
+
+/// Alignment of the chunks, large enough for the offset requirements of any pixel transfer.
+constexpr std::size_t CHUNK_ALIGNMENT = 256;
+
+} // Anonymous namespace
+
+StagingBufferRing::StagingBufferRing(GLsizeiptr size)
+    : buffer_size{size}, segment_size{size / static_cast<GLsizeiptr>(NUM_SEGMENTS)} {
+    ASSERT(static_cast<std::size_t>(size) % (CHUNK_ALIGNMENT * NUM_SEGMENTS) == 0);
+
+    // Coherent mappings avoid explicit flushes for uploads and make downloads visible to the
+    // CPU as soon as their fence is signaled.
+    const GLbitfield flags =
+        GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    buffer.Create();
+    glNamedBufferStorage(buffer.handle, buffer_size, nullptr, flags);
+    mapped_ptr = static_cast<u8*>(glMapNamedBufferRange(buffer.handle, 0, buffer_size, flags));
+}
+
+StagingBufferRing::~StagingBufferRing() {
+    glUnmapNamedBuffer(buffer.handle);
+}
+
+std::optional<StagingRegion> StagingBufferRing::Map(std::size_t size) {
+    ASSERT(size > 0);
+    if (static_cast<GLsizeiptr>(size) > buffer_size) {
+        return {};
+    }
+    auto offset = static_cast<GLintptr>(
+        Common::AlignUp(static_cast<std::size_t>(buffer_pos), CHUNK_ALIGNMENT));
+    if (offset + static_cast<GLsizeiptr>(size) > buffer_size) {
+        offset = 0;
+    }
+
+    // The segment holding the current position was already waited on when it was entered,
+    // only the segments after it are still in use from the previous lap.
+    const std::size_t first_segment = offset == 0 ? 0 : GetSegment(buffer_pos - 1) + 1;
+    const std::size_t last_segment = GetSegment(offset + static_cast<GLintptr>(size) - 1);
+    for (std::size_t segment = first_segment; segment <= last_segment; ++segment) {
+        WaitSegment(segment);
+    }
+
+    buffer_pos = offset + static_cast<GLintptr>(size);
+    return StagingRegion{mapped_ptr + offset, offset, static_cast<GLsizeiptr>(size)};
+}
+
+void StagingBufferRing::Unmap(const StagingRegion& region) {
+    const std::size_t last_segment = GetSegment(region.offset + region.size - 1);
+    for (std::size_t segment = GetSegment(region.offset); segment <= last_segment; ++segment) {
+        fences.Signal(segment);
+    }
+}
+
+void StagingBufferRing::Wait(const StagingRegion& region) {
+    WaitSegment(GetSegment(region.offset + region.size - 1));
+}
+
+std::size_t StagingBufferRing::GetSegment(GLintptr offset) const {
+    return static_cast<std::size_t>(offset / segment_size);
+}
+
+void StagingBufferRing::WaitSegment(std::size_t segment) {
+    if (!fences.IsPending(segment)) {
+        return;
+    }
+    MICROPROFILE_SCOPE(OpenGL_StagingWait);
+    fences.Wait(segment);
+}
+
+} // namespace OpenGL
@@ -0,0 +1,69 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include <glad/glad.h>
+
+#include "common/common_types.h"
+#include "video_core/renderer_opengl/gl_fence_ring.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace OpenGL {
+
+/// Chunk of memory handed out by StagingBufferRing::Map.
+struct StagingRegion {
+    u8* pointer;     ///< Persistently mapped pointer to the chunk.
+    GLintptr offset; ///< Offset of the chunk in the buffer, to use with a bound PBO.
+    GLsizeiptr size; ///< Size of the chunk in bytes.
+};
+
+/**
+ * Ring of persistently mapped memory used as pixel pack and unpack buffer for texture transfers.
+ * The ring is split in segments guarded by fences, memory is only handed out again after the GPU
+ * is done with the commands that used it, so transfers don't have to synchronize with the driver.
+ */
+class StagingBufferRing : private NonCopyable {
+public:
+    explicit StagingBufferRing(GLsizeiptr size);
+    ~StagingBufferRing();
+
+    GLuint GetHandle() const {
+        return buffer.handle;
+    }
+
+    /**
+     * Allocates a chunk of at least size bytes, waiting for the GPU to release it if needed.
+     * Only one chunk can be mapped at a time.
+     * @returns The chunk, or nothing when the requested size doesn't fit in the ring.
+     */
+    std::optional<StagingRegion> Map(std::size_t size);
+
+    /// Fences the commands issued on the last mapped chunk, its memory is reused after them.
+    void Unmap(const StagingRegion& region);
+
+    /// Waits for the commands issued on an unmapped chunk, e.g. to read data downloaded into it.
+    void Wait(const StagingRegion& region);
+
+private:
+    static constexpr std::size_t NUM_SEGMENTS = 8;
+
+    std::size_t GetSegment(GLintptr offset) const;
+
+    void WaitSegment(std::size_t segment);
+
+    OGLBuffer buffer;
+    u8* mapped_ptr = nullptr;
+    GLsizeiptr buffer_size = 0;
+    GLsizeiptr segment_size = 0;
+    GLintptr buffer_pos = 0;
+
+    /// Fence of the last commands that used each segment of the ring.
+    FenceRing<NUM_SEGMENTS> fences;
+};
+
+} // namespace OpenGL
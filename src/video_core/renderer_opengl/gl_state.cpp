@@ -120,6 +120,10 @@ void OpenGLState::ApplyProgramPipeline() {
 }
 
 void OpenGLState::ApplyClipDistances() {
+    if (!ConsumeDirty(DirtyClipDistances)) {
+        return;
+    }
+
     for (std::size_t i = 0; i < clip_distance.size(); ++i) {
         Enable(GL_CLIP_DISTANCE0 + static_cast<GLenum>(i), cur_state.clip_distance[i],
                clip_distance[i]);
@@ -127,12 +131,20 @@ void OpenGLState::ApplyClipDistances() {
 }
 
 void OpenGLState::ApplyPointSize() {
+    if (!ConsumeDirty(DirtyPointSize)) {
+        return;
+    }
+
     if (UpdateValue(cur_state.point.size, point.size)) {
         glPointSize(point.size);
     }
 }
 
 void OpenGLState::ApplyFragmentColorClamp() {
+    if (!ConsumeDirty(DirtyFragmentColorClamp)) {
+        return;
+    }
+
     if (UpdateValue(cur_state.fragment_color_clamp.enabled, fragment_color_clamp.enabled)) {
         glClampColor(GL_CLAMP_FRAGMENT_COLOR_ARB,
                      fragment_color_clamp.enabled ? GL_TRUE : GL_FALSE);
@@ -140,6 +152,10 @@ void OpenGLState::ApplyFragmentColorClamp() {
 }
 
 void OpenGLState::ApplyMultisample() {
+    if (!ConsumeDirty(DirtyMultisample)) {
+        return;
+    }
+
     Enable(GL_SAMPLE_ALPHA_TO_COVERAGE, cur_state.multisample_control.alpha_to_coverage,
            multisample_control.alpha_to_coverage);
     Enable(GL_SAMPLE_ALPHA_TO_ONE, cur_state.multisample_control.alpha_to_one,
@@ -147,6 +163,10 @@ void OpenGLState::ApplyMultisample() {
 }
 
 void OpenGLState::ApplyDepthClamp() {
+    if (!ConsumeDirty(DirtyDepthClamp)) {
+        return;
+    }
+
     if (depth_clamp.far_plane == cur_state.depth_clamp.far_plane &&
         depth_clamp.near_plane == cur_state.depth_clamp.near_plane) {
         return;
@@ -160,6 +180,10 @@ void OpenGLState::ApplyDepthClamp() {
 }
 
 void OpenGLState::ApplySRgb() {
+    if (!ConsumeDirty(DirtySRgb)) {
+        return;
+    }
+
     if (cur_state.framebuffer_srgb.enabled == framebuffer_srgb.enabled)
         return;
     cur_state.framebuffer_srgb.enabled = framebuffer_srgb.enabled;
@@ -171,6 +195,10 @@ void OpenGLState::ApplySRgb() {
 }
 
 void OpenGLState::ApplyCulling() {
+    if (!ConsumeDirty(DirtyCulling)) {
+        return;
+    }
+
     Enable(GL_CULL_FACE, cur_state.cull.enabled, cull.enabled);
 
     if (UpdateValue(cur_state.cull.mode, cull.mode)) {
@@ -183,10 +211,9 @@ void OpenGLState::ApplyCulling() {
 }
 
 void OpenGLState::ApplyColorMask() {
-    if (!dirty.color_mask) {
+    if (!ConsumeDirty(DirtyColorMask)) {
         return;
     }
-    dirty.color_mask = false;
 
     for (std::size_t i = 0; i < Maxwell::NumRenderTargets; ++i) {
         const auto& updated = color_mask[i];
@@ -203,6 +230,10 @@ void OpenGLState::ApplyColorMask() {
 }
 
 void OpenGLState::ApplyDepth() {
+    if (!ConsumeDirty(DirtyDepth)) {
+        return;
+    }
+
     Enable(GL_DEPTH_TEST, cur_state.depth.test_enabled, depth.test_enabled);
 
     if (cur_state.depth.test_func != depth.test_func) {
@@ -217,6 +248,10 @@ void OpenGLState::ApplyDepth() {
 }
 
 void OpenGLState::ApplyPrimitiveRestart() {
+    if (!ConsumeDirty(DirtyPrimitiveRestart)) {
+        return;
+    }
+
     Enable(GL_PRIMITIVE_RESTART, cur_state.primitive_restart.enabled, primitive_restart.enabled);
 
     if (cur_state.primitive_restart.index != primitive_restart.index) {
@@ -226,10 +261,9 @@ void OpenGLState::ApplyPrimitiveRestart() {
 }
 
 void OpenGLState::ApplyStencilTest() {
-    if (!dirty.stencil_state) {
+    if (!ConsumeDirty(DirtyStencil)) {
         return;
     }
-    dirty.stencil_state = false;
 
     Enable(GL_STENCIL_TEST, cur_state.stencil.test_enabled, stencil.test_enabled);
 
@@ -260,6 +294,10 @@ void OpenGLState::ApplyStencilTest() {
 }
 
 void OpenGLState::ApplyViewport() {
+    if (!ConsumeDirty(DirtyViewport)) {
+        return;
+    }
+
     for (GLuint i = 0; i < static_cast<GLuint>(Maxwell::NumViewports); ++i) {
         const auto& updated = viewports[i];
         auto& current = cur_state.viewports[i];
@@ -345,10 +383,9 @@ void OpenGLState::ApplyTargetBlending(std::size_t target, bool force) {
 }
 
 void OpenGLState::ApplyBlending() {
-    if (!dirty.blend_state) {
+    if (!ConsumeDirty(DirtyBlend)) {
         return;
     }
-    dirty.blend_state = false;
 
     if (independant_blend.enabled) {
         const bool force = independant_blend.enabled != cur_state.independant_blend.enabled;
@@ -369,6 +406,10 @@ void OpenGLState::ApplyBlending() {
 }
 
 void OpenGLState::ApplyLogicOp() {
+    if (!ConsumeDirty(DirtyLogicOp)) {
+        return;
+    }
+
     Enable(GL_COLOR_LOGIC_OP, cur_state.logic_op.enabled, logic_op.enabled);
 
     if (UpdateValue(cur_state.logic_op.operation, logic_op.operation)) {
@@ -377,10 +418,9 @@ void OpenGLState::ApplyLogicOp() {
 }
 
 void OpenGLState::ApplyPolygonOffset() {
-    if (!dirty.polygon_offset) {
+    if (!ConsumeDirty(DirtyPolygonOffset)) {
         return;
     }
-    dirty.polygon_offset = false;
 
     Enable(GL_POLYGON_OFFSET_FILL, cur_state.polygon_offset.fill_enable,
            polygon_offset.fill_enable);
@@ -403,6 +443,10 @@ void OpenGLState::ApplyPolygonOffset() {
 }
 
 void OpenGLState::ApplyAlphaTest() {
+    if (!ConsumeDirty(DirtyAlphaTest)) {
+        return;
+    }
+
     Enable(GL_ALPHA_TEST, cur_state.alpha_test.enabled, alpha_test.enabled);
     if (UpdateTie(std::tie(cur_state.alpha_test.func, cur_state.alpha_test.ref),
                   std::tie(alpha_test.func, alpha_test.ref))) {
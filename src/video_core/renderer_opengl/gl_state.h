@@ -7,6 +7,7 @@
 #include <array>
 #include <type_traits>
 #include <glad/glad.h>
+#include "common/common_types.h"
 #include "video_core/engines/maxwell_3d.h"
 
 namespace OpenGL {
@@ -194,39 +195,107 @@ public:
     /// Viewport does not affects glClearBuffer so emulate viewport using scissor test
     void EmulateViewportWithScissor();
 
-    void MarkDirtyBlendState() {
-        dirty.blend_state = true;
+    void MarkDirtySRgb() {
+        dirty |= DirtySRgb;
+    }
+
+    void MarkDirtyMultisample() {
+        dirty |= DirtyMultisample;
+    }
+
+    void MarkDirtyFragmentColorClamp() {
+        dirty |= DirtyFragmentColorClamp;
+    }
+
+    void MarkDirtyDepthClamp() {
+        dirty |= DirtyDepthClamp;
+    }
+
+    void MarkDirtyCulling() {
+        dirty |= DirtyCulling;
+    }
+
+    void MarkDirtyColorMask() {
+        dirty |= DirtyColorMask;
+    }
+
+    void MarkDirtyDepth() {
+        dirty |= DirtyDepth;
+    }
+
+    void MarkDirtyPrimitiveRestart() {
+        dirty |= DirtyPrimitiveRestart;
     }
 
     void MarkDirtyStencilState() {
-        dirty.stencil_state = true;
+        dirty |= DirtyStencil;
+    }
+
+    void MarkDirtyViewport() {
+        dirty |= DirtyViewport;
+    }
+
+    void MarkDirtyBlendState() {
+        dirty |= DirtyBlend;
+    }
+
+    void MarkDirtyLogicOp() {
+        dirty |= DirtyLogicOp;
     }
 
     void MarkDirtyPolygonOffset() {
-        dirty.polygon_offset = true;
+        dirty |= DirtyPolygonOffset;
     }
 
-    void MarkDirtyColorMask() {
-        dirty.color_mask = true;
+    void MarkDirtyAlphaTest() {
+        dirty |= DirtyAlphaTest;
+    }
+
+    void MarkDirtyPointSize() {
+        dirty |= DirtyPointSize;
+    }
+
+    void MarkDirtyClipDistances() {
+        dirty |= DirtyClipDistances;
     }
 
     void AllDirty() {
-        dirty.blend_state = true;
-        dirty.stencil_state = true;
-        dirty.polygon_offset = true;
-        dirty.color_mask = true;
+        dirty = DirtyAll;
     }
 
 private:
+    /// Groups of fixed function state, a group is applied only when it's marked as dirty. Object
+    /// bindings are few and cheap to compare, they are always checked.
+    enum DirtyGroup : u32 {
+        DirtySRgb = 1U << 0,
+        DirtyMultisample = 1U << 1,
+        DirtyFragmentColorClamp = 1U << 2,
+        DirtyDepthClamp = 1U << 3,
+        DirtyCulling = 1U << 4,
+        DirtyColorMask = 1U << 5,
+        DirtyDepth = 1U << 6,
+        DirtyPrimitiveRestart = 1U << 7,
+        DirtyStencil = 1U << 8,
+        DirtyViewport = 1U << 9,
+        DirtyBlend = 1U << 10,
+        DirtyLogicOp = 1U << 11,
+        DirtyPolygonOffset = 1U << 12,
+        DirtyAlphaTest = 1U << 13,
+        DirtyPointSize = 1U << 14,
+        DirtyClipDistances = 1U << 15,
+        DirtyAll = (1U << 16) - 1,
+    };
+
+    /// Returns true when the group was marked as dirty, it's then considered as applied.
+    bool ConsumeDirty(u32 group) {
+        const bool is_dirty = (dirty & group) != 0;
+        dirty &= ~group;
+        return is_dirty;
+    }
+
     static OpenGLState cur_state;
 
-    struct {
-        bool blend_state;
-        bool stencil_state;
-        bool viewport_state;
-        bool polygon_offset;
-        bool color_mask;
-    } dirty{};
+    u32 dirty = 0; ///< Mask of the groups set since they were last applied.
 };
 static_assert(std::is_trivially_copyable_v<OpenGLState>);
 
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <deque>
 #include <vector>
 #include "common/alignment.h"
@@ -12,12 +13,16 @@
 
 MICROPROFILE_DEFINE(OpenGL_StreamBuffer, "OpenGL", "Stream Buffer Orphaning",
                     MP_RGB(128, 128, 192));
+MICROPROFILE_DEFINE(OpenGL_StreamBufferWait, "OpenGL", "Stream Buffer Wait",
+                    MP_RGB(128, 128, 192));
 
 namespace OpenGL {
 
 OGLStreamBuffer::OGLStreamBuffer(GLsizeiptr size, bool vertex_data_usage, bool prefer_coherent,
                                  bool use_persistent)
-    : buffer_size(size) {
+    : buffer_size(size),
+      region_size((size + static_cast<GLsizeiptr>(NUM_REGIONS) - 1) /
+                  static_cast<GLsizeiptr>(NUM_REGIONS)) {
     gl_buffer.Create();
 
     GLsizeiptr allocate_size = size;
@@ -67,25 +72,38 @@ std::tuple<u8*, GLintptr, bool> OGLStreamBuffer::Map(GLsizeiptr size, GLintptr a
         buffer_pos = Common::AlignUp<std::size_t>(buffer_pos, alignment);
     }
 
+    if (persistent) {
+        // Wrap around without orphaning, only the regions about to be written are waited on
+        u64 next_target;
+        if (buffer_pos + size > buffer_size) {
+            next_target = (lap + 1) * NUM_REGIONS;
+            ++lap;
+            buffer_pos = 0;
+            waited_region = 0;
+        } else {
+            next_target = lap * NUM_REGIONS + GetRegion(buffer_pos);
+        }
+        const std::size_t last = GetRegion(buffer_pos + std::max<GLsizeiptr>(size, 1) - 1);
+        // The regions about to be written may still hold unfenced data of the previous lap
+        FenceRegions(std::max(fence_target, (lap - 1) * NUM_REGIONS + last + 1));
+        WaitRegions(last);
+        fence_target = next_target;
+        return std::make_tuple(mapped_ptr + buffer_pos, buffer_pos, false);
+    }
+
     bool invalidate = false;
     if (buffer_pos + size > buffer_size) {
         buffer_pos = 0;
         invalidate = true;
-
-        if (persistent) {
-            glUnmapNamedBuffer(gl_buffer.handle);
-        }
     }
 
-    if (invalidate || !persistent) {
-        MICROPROFILE_SCOPE(OpenGL_StreamBuffer);
-        GLbitfield flags = GL_MAP_WRITE_BIT | (persistent ? GL_MAP_PERSISTENT_BIT : 0) |
-                           (coherent ? GL_MAP_COHERENT_BIT : GL_MAP_FLUSH_EXPLICIT_BIT) |
-                           (invalidate ? GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_UNSYNCHRONIZED_BIT);
-        mapped_ptr = static_cast<u8*>(
-            glMapNamedBufferRange(gl_buffer.handle, buffer_pos, buffer_size - buffer_pos, flags));
-        mapped_offset = buffer_pos;
-    }
+    MICROPROFILE_SCOPE(OpenGL_StreamBuffer);
+    const GLbitfield sync_flag =
+        invalidate ? GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_UNSYNCHRONIZED_BIT;
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT | sync_flag;
+    mapped_ptr = static_cast<u8*>(
+        glMapNamedBufferRange(gl_buffer.handle, buffer_pos, buffer_size - buffer_pos, flags));
+    mapped_offset = buffer_pos;
 
     return std::make_tuple(mapped_ptr + buffer_pos - mapped_offset, buffer_pos, invalidate);
 }
@@ -104,4 +122,24 @@ void OGLStreamBuffer::Unmap(GLsizeiptr size) {
     buffer_pos += size;
 }
 
+std::size_t OGLStreamBuffer::GetRegion(GLintptr offset) const {
+    return std::min(static_cast<std::size_t>(offset / region_size), NUM_REGIONS - 1);
+}
+
+void OGLStreamBuffer::FenceRegions(u64 end) {
+    for (; fenced_regions < end; ++fenced_regions) {
+        fences.Signal(fenced_regions % NUM_REGIONS);
+    }
+}
+
+void OGLStreamBuffer::WaitRegions(std::size_t last) {
+    for (; waited_region <= last; ++waited_region) {
+        if (!fences.IsPending(waited_region)) {
+            continue;
+        }
+        MICROPROFILE_SCOPE(OpenGL_StreamBufferWait);
+        fences.Wait(waited_region);
+    }
+}
+
 } // namespace OpenGL
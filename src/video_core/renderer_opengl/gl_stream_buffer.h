@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <cstddef>
 #include <tuple>
 #include <glad/glad.h>
 #include "common/common_types.h"
+#include "video_core/renderer_opengl/gl_fence_ring.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 
 namespace OpenGL {
@@ -23,7 +25,9 @@ public:
     /*
      * Allocates a linear chunk of memory in the GPU buffer with at least "size" bytes
      * and the optional alignment requirement.
-     * If the buffer is full, the whole buffer is reallocated which invalidates old chunks.
+     * Persistent buffers are split in regions guarded by fences, when the buffer is full it wraps
+     * around and waits for the GPU to release the regions it reuses. Otherwise the whole buffer
+     * is reallocated which invalidates old chunks.
      * The return values are the pointer to the new chunk, the offset within the buffer,
      * and the invalidation flag for previous chunks.
      * The actual used size must be specified on unmapping the chunk.
@@ -33,6 +37,17 @@ public:
     void Unmap(GLsizeiptr size);
 
 private:
+    static constexpr std::size_t NUM_REGIONS = 8;
+
+    std::size_t GetRegion(GLintptr offset) const;
+
+    /// Fences the regions before the given one, counted across laps. Regions are fenced one map
+    /// late, the commands reading the last chunk may not have been issued yet.
+    void FenceRegions(u64 end);
+
+    /// Waits for the GPU to release the regions up to the given one before writing them again.
+    void WaitRegions(std::size_t last);
+
     OGLBuffer gl_buffer;
 
     bool coherent = false;
@@ -43,6 +58,15 @@ private:
     GLintptr mapped_offset = 0;
     GLsizeiptr mapped_size = 0;
     u8* mapped_ptr = nullptr;
+
+    GLsizeiptr region_size = 0;
+    u64 lap = 1;                         ///< Number of times the buffer was started over.
+    u64 fenced_regions = NUM_REGIONS;    ///< First region without a fence, counted across laps.
+    u64 fence_target = NUM_REGIONS;      ///< Regions to fence on the next map.
+    std::size_t waited_region = 0;       ///< First region not waited on in this lap.
+
+    /// Fence of the last commands that used each region of a persistent buffer.
+    FenceRing<NUM_REGIONS> fences;
 };
 
 } // namespace OpenGL
@@ -2,9 +2,16 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
+#include <optional>
+#include <utility>
+
+#include "common/alignment.h"
 #include "common/assert.h"
 #include "common/bit_util.h"
 #include "common/common_types.h"
+#include "common/logging/log.h"
+#include "common/math_util.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "core/core.h"
@@ -36,6 +43,9 @@ MICROPROFILE_DEFINE(OpenGL_Texture_Buffer_Copy, "OpenGL", "Texture Buffer Copy",
 
 namespace {
 
+/// Size of the ring used to stage texture uploads and downloads, larger transfers bypass it.
+constexpr GLsizeiptr STAGING_RING_SIZE = 64 * 1024 * 1024;
+
 struct FormatTuple {
     GLint internal_format;
     GLenum format;
@@ -210,6 +220,53 @@ void ApplyTextureDefaults(const SurfaceParams& params, GLuint texture) {
     }
 }
 
+/// Returns true when uploading with the format and type of the tuple copies the guest texels to
+/// the texture without converting them, so they can be reinterpreted as integers instead.
+bool IsVerbatimUpload(const FormatTuple& tuple) {
+    if (tuple.compressed || tuple.format == GL_BGRA) {
+        return false;
+    }
+    switch (tuple.internal_format) {
+    case GL_RGBA8:
+        return tuple.type == GL_UNSIGNED_BYTE || tuple.type == GL_UNSIGNED_INT_8_8_8_8_REV;
+    case GL_RG8:
+    case GL_R8:
+    case GL_RGBA8UI:
+    case GL_R8UI:
+        return tuple.type == GL_UNSIGNED_BYTE;
+    case GL_RGBA16:
+    case GL_RG16:
+    case GL_R16:
+    case GL_RGBA16UI:
+    case GL_RG16UI:
+    case GL_R16UI:
+        return tuple.type == GL_UNSIGNED_SHORT;
+    case GL_RG16_SNORM:
+    case GL_R16_SNORM:
+    case GL_RG16I:
+    case GL_R16I:
+        return tuple.type == GL_SHORT;
+    case GL_RGBA16F:
+    case GL_RG16F:
+    case GL_R16F:
+        return tuple.type == GL_HALF_FLOAT;
+    case GL_RGBA32F:
+    case GL_RG32F:
+    case GL_R32F:
+        return tuple.type == GL_FLOAT;
+    case GL_RGBA32UI:
+    case GL_RG32UI:
+    case GL_R32UI:
+        return tuple.type == GL_UNSIGNED_INT;
+    case GL_RGB10_A2:
+        return tuple.type == GL_UNSIGNED_INT_2_10_10_10_REV;
+    case GL_R11F_G11F_B10F:
+        return tuple.type == GL_UNSIGNED_INT_10F_11F_11F_REV;
+    default:
+        return false;
+    }
+}
+
 OGLTexture CreateTexture(const SurfaceParams& params, GLenum target, GLenum internal_format,
                          OGLBuffer& texture_buffer) {
     OGLTexture texture;
@@ -227,8 +284,8 @@ OGLTexture CreateTexture(const SurfaceParams& params, GLenum target, GLenum inte
         break;
     case SurfaceTarget::Texture2D:
     case SurfaceTarget::TextureCubemap:
-        glTextureStorage2D(texture.handle, params.emulated_levels, internal_format, params.width,
-                           params.height);
+        glTextureStorage2D(texture.handle, params.emulated_levels, internal_format,
+                           params.GetScaledWidth(), params.GetScaledHeight());
         break;
     case SurfaceTarget::Texture3D:
     case SurfaceTarget::Texture2DArray:
@@ -245,10 +302,74 @@ OGLTexture CreateTexture(const SurfaceParams& params, GLenum target, GLenum inte
     return texture;
 }
 
+/// Returns the framebuffer attachment and the buffer mask used to blit surfaces of a type.
+std::pair<GLenum, GLbitfield> GetBlitAttachment(SurfaceType type) {
+    switch (type) {
+    case SurfaceType::ColorTexture:
+        return {GL_COLOR_ATTACHMENT0, GL_COLOR_BUFFER_BIT};
+    case SurfaceType::Depth:
+        return {GL_DEPTH_ATTACHMENT, GL_DEPTH_BUFFER_BIT};
+    case SurfaceType::DepthStencil:
+        return {GL_DEPTH_STENCIL_ATTACHMENT, GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT};
+    default:
+        UNREACHABLE();
+        return {GL_COLOR_ATTACHMENT0, GL_COLOR_BUFFER_BIT};
+    }
+}
+
+/// Level, layer and rectangle of a texture taking part in a blit.
+struct BlitRegion {
+    GLuint texture;
+    SurfaceTarget target;
+    u32 level;
+    u32 layer;
+    Common::Rectangle<u32> rect;
+};
+
+void AttachBlitRegion(GLenum framebuffer_target, GLenum attachment, const BlitRegion& region) {
+    if (region.target == SurfaceTarget::Texture1D || region.target == SurfaceTarget::Texture2D) {
+        glFramebufferTexture(framebuffer_target, attachment, region.texture, region.level);
+    } else {
+        glFramebufferTextureLayer(framebuffer_target, attachment, region.texture, region.level,
+                                  region.layer);
+    }
+}
+
+/// Blits between two textures of the same surface type through temporary framebuffers, used to
+/// move contents between different resolution scales.
+void BlitRegions(const BlitRegion& src, const BlitRegion& dst, SurfaceType type, bool is_linear) {
+    OpenGLState prev_state{OpenGLState::GetCurState()};
+    SCOPE_EXIT({
+        prev_state.AllDirty();
+        prev_state.Apply();
+    });
+
+    OGLFramebuffer read_framebuffer;
+    OGLFramebuffer draw_framebuffer;
+    read_framebuffer.Create();
+    draw_framebuffer.Create();
+
+    OpenGLState state;
+    state.draw.read_framebuffer = read_framebuffer.handle;
+    state.draw.draw_framebuffer = draw_framebuffer.handle;
+    state.AllDirty();
+    state.Apply();
+
+    const auto [attachment, buffers] = GetBlitAttachment(type);
+    AttachBlitRegion(GL_READ_FRAMEBUFFER, attachment, src);
+    AttachBlitRegion(GL_DRAW_FRAMEBUFFER, attachment, dst);
+
+    const bool linear = is_linear && buffers == GL_COLOR_BUFFER_BIT;
+    glBlitFramebuffer(src.rect.left, src.rect.top, src.rect.right, src.rect.bottom, dst.rect.left,
+                      dst.rect.top, dst.rect.right, dst.rect.bottom, buffers,
+                      linear ? GL_LINEAR : GL_NEAREST);
+}
+
 } // Anonymous namespace
 
-CachedSurface::CachedSurface(const GPUVAddr gpu_addr, const SurfaceParams& params)
-    : VideoCommon::SurfaceBase<View>(gpu_addr, params) {
+CachedSurface::CachedSurface(const GPUVAddr gpu_addr, const SurfaceParams& params,
+                             StagingBufferRing& staging_ring)
+    : VideoCommon::SurfaceBase<View>(gpu_addr, params), staging_ring{staging_ring} {
     const auto& tuple{GetFormatTuple(params.pixel_format, params.component_type)};
     internal_format = tuple.internal_format;
     format = tuple.format;
@@ -267,33 +388,184 @@ CachedSurface::~CachedSurface() = default;
 void CachedSurface::DownloadTexture(std::vector<u8>& staging_buffer) {
     MICROPROFILE_SCOPE(OpenGL_Texture_Download);
 
-    SCOPE_EXIT({ glPixelStorei(GL_PACK_ROW_LENGTH, 0); });
+    // Scaled surfaces are resolved to the guest's resolution before being read back
+    OGLTexture native_texture;
+    if (params.resolution_scale > 1) {
+        native_texture = CreateNativeTexture();
+        BlitScaled(native_texture.handle, true);
+    }
+    const GLuint handle = native_texture.handle != 0 ? native_texture.handle : texture.handle;
+
+    // Read back through the staging ring when the surface fits in it, waiting only for the
+    // fence of this download instead of stalling on a readback to client memory.
+    std::optional<StagingRegion> region;
+    if (params.target != SurfaceTarget::TextureBuffer) {
+        region = staging_ring.Map(staging_buffer.size());
+    }
+    u8* const base = region ? reinterpret_cast<u8*>(region->offset) : staging_buffer.data();
+    if (region) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, staging_ring.GetHandle());
+    }
+    SCOPE_EXIT({
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+        if (region) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+    });
 
     for (u32 level = 0; level < params.emulated_levels; ++level) {
+        if (!IsLevelDirty(level)) {
+            continue;
+        }
         glPixelStorei(GL_PACK_ALIGNMENT, std::min(8U, params.GetRowAlignment(level)));
         glPixelStorei(GL_PACK_ROW_LENGTH, static_cast<GLint>(params.GetMipWidth(level)));
         const std::size_t mip_offset = params.GetHostMipmapLevelOffset(level);
         if (is_compressed) {
-            glGetCompressedTextureImage(texture.handle, level,
+            glGetCompressedTextureImage(handle, level,
                                         static_cast<GLsizei>(params.GetHostMipmapSize(level)),
-                                        staging_buffer.data() + mip_offset);
+                                        base + mip_offset);
         } else {
-            glGetTextureImage(texture.handle, level, format, type,
+            glGetTextureImage(handle, level, format, type,
                               static_cast<GLsizei>(params.GetHostMipmapSize(level)),
-                              staging_buffer.data() + mip_offset);
+                              base + mip_offset);
         }
     }
+
+    if (region) {
+        staging_ring.Unmap(*region);
+        staging_ring.Wait(*region);
+        std::memcpy(staging_buffer.data(), region->pointer, staging_buffer.size());
+    }
 }
 
 void CachedSurface::UploadTexture(const std::vector<u8>& staging_buffer) {
     MICROPROFILE_SCOPE(OpenGL_Texture_Upload);
-    SCOPE_EXIT({ glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); });
+
+    // Texture buffers are written with buffer commands that don't read from the unpack buffer.
+    std::optional<StagingRegion> region;
+    if (params.target != SurfaceTarget::TextureBuffer) {
+        region = staging_ring.Map(staging_buffer.size());
+    }
+    const u8* base = staging_buffer.data();
+    if (region) {
+        std::memcpy(region->pointer, staging_buffer.data(), staging_buffer.size());
+        base = reinterpret_cast<const u8*>(region->offset);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_ring.GetHandle());
+    }
+    SCOPE_EXIT({
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        if (region) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            staging_ring.Unmap(*region);
+        }
+    });
+
+    // Scaled surfaces are uploaded at the guest's resolution and then scaled up
+    OGLTexture native_texture;
+    if (params.resolution_scale > 1) {
+        native_texture = CreateNativeTexture();
+    }
+    const GLuint handle = native_texture.handle != 0 ? native_texture.handle : texture.handle;
+    for (u32 level = 0; level < params.emulated_levels; ++level) {
+        if (IsLevelDirty(level)) {
+            UploadTextureMipmap(level, base, handle);
+        }
+    }
+    if (native_texture.handle != 0) {
+        BlitScaled(native_texture.handle, false);
+    }
+}
+
+bool CachedSurface::UploadSwizzled(const u8* guest_data, UnswizzlePass& unswizzle_pass) {
+    switch (params.target) {
+    case SurfaceTarget::Texture2D:
+    case SurfaceTarget::Texture3D:
+    case SurfaceTarget::Texture2DArray:
+    case SurfaceTarget::TextureCubemap:
+    case SurfaceTarget::TextureCubeArray:
+        break;
+    default:
+        return false;
+    }
+    const u32 bytes_per_pixel = params.GetBytesPerPixel();
+    if (!params.is_tiled || params.GetCompressionType() != SurfaceCompression::None ||
+        !IsVerbatimUpload(GetFormatTuple(params.pixel_format, params.component_type)) ||
+        !unswizzle_pass.IsSupported(internal_format, bytes_per_pixel, guest_memory_size)) {
+        return false;
+    }
+    MICROPROFILE_SCOPE(OpenGL_Texture_Upload);
+
+    OGLTexture native_texture;
+    if (params.resolution_scale > 1) {
+        native_texture = CreateNativeTexture();
+    }
+    const GLuint handle = native_texture.handle != 0 ? native_texture.handle : texture.handle;
+
+    unswizzle_pass.Upload(guest_data, guest_memory_size);
+    const u32 gob_width = 64 / bytes_per_pixel;
     for (u32 level = 0; level < params.emulated_levels; ++level) {
-        UploadTextureMipmap(level, staging_buffer);
+        UnswizzleParams unswizzle;
+        unswizzle.base_offset = static_cast<u32>(mipmap_offsets[level]);
+        unswizzle.bytes_per_pixel = bytes_per_pixel;
+        unswizzle.width = params.GetMipWidth(level);
+        unswizzle.height = params.GetMipHeight(level);
+        unswizzle.slice = 0;
+        unswizzle.block_height = 1U << params.GetMipBlockHeight(level);
+        unswizzle.block_depth = 1U << params.GetMipBlockDepth(level);
+        const u32 aligned_width =
+            Common::AlignUp(unswizzle.width, gob_width * params.tile_width_spacing);
+        const u32 block_rows = 8 * unswizzle.block_height;
+        unswizzle.blocks_x = aligned_width / gob_width;
+        unswizzle.blocks_y = Common::AlignUp(unswizzle.height, block_rows) / block_rows;
+
+        if (params.is_layered) {
+            for (u32 layer = 0; layer < params.depth; ++layer) {
+                unswizzle_pass.Unswizzle(handle, level, layer, unswizzle);
+                unswizzle.base_offset += static_cast<u32>(layer_size);
+            }
+        } else {
+            for (u32 slice = 0; slice < params.GetMipDepth(level); ++slice) {
+                unswizzle.slice = slice;
+                unswizzle_pass.Unswizzle(handle, level, slice, unswizzle);
+            }
+        }
+    }
+    unswizzle_pass.Finish();
+    if (native_texture.handle != 0) {
+        BlitScaled(native_texture.handle, false);
     }
+    return true;
+}
+
+void CachedSurface::DownloadRegion(GLuint buffer, std::size_t offset, std::size_t size, u32 pitch,
+                                   const Common::Rectangle<u32>& rect) {
+    MICROPROFILE_SCOPE(OpenGL_Texture_Download);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ROW_LENGTH, static_cast<GLint>(pitch / params.GetBytesPerPixel()));
+    glGetTextureSubImage(texture.handle, 0, static_cast<GLint>(rect.left),
+                         static_cast<GLint>(rect.top), 0, static_cast<GLsizei>(rect.GetWidth()),
+                         static_cast<GLsizei>(rect.GetHeight()), 1, format, type,
+                         static_cast<GLsizei>(size), reinterpret_cast<void*>(offset));
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void CachedSurface::UploadRegion(GLuint buffer, std::size_t offset, u32 pitch,
+                                 const Common::Rectangle<u32>& rect) {
+    MICROPROFILE_SCOPE(OpenGL_Texture_Upload);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(pitch / params.GetBytesPerPixel()));
+    glTextureSubImage2D(texture.handle, 0, static_cast<GLint>(rect.left),
+                        static_cast<GLint>(rect.top), static_cast<GLsizei>(rect.GetWidth()),
+                        static_cast<GLsizei>(rect.GetHeight()), format, type,
+                        reinterpret_cast<const void*>(offset));
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 }
 
-void CachedSurface::UploadTextureMipmap(u32 level, const std::vector<u8>& staging_buffer) {
+void CachedSurface::UploadTextureMipmap(u32 level, const u8* base, GLuint handle) {
     glPixelStorei(GL_UNPACK_ALIGNMENT, std::min(8U, params.GetRowAlignment(level)));
     glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(params.GetMipWidth(level)));
 
@@ -302,12 +574,12 @@ void CachedSurface::UploadTextureMipmap(u32 level, const std::vector<u8>& stagin
     const std::size_t mip_offset = compression_type == SurfaceCompression::Converted
                                        ? params.GetConvertedMipmapOffset(level)
                                        : params.GetHostMipmapLevelOffset(level);
-    const u8* buffer{staging_buffer.data() + mip_offset};
+    const u8* buffer{base + mip_offset};
     if (is_compressed) {
         const auto image_size{static_cast<GLsizei>(params.GetHostMipmapSize(level))};
         switch (params.target) {
         case SurfaceTarget::Texture2D:
-            glCompressedTextureSubImage2D(texture.handle, level, 0, 0,
+            glCompressedTextureSubImage2D(handle, level, 0, 0,
                                           static_cast<GLsizei>(params.GetMipWidth(level)),
                                           static_cast<GLsizei>(params.GetMipHeight(level)),
                                           internal_format, image_size, buffer);
@@ -315,7 +587,20 @@ void CachedSurface::UploadTextureMipmap(u32 level, const std::vector<u8>& stagin
         case SurfaceTarget::Texture3D:
         case SurfaceTarget::Texture2DArray:
         case SurfaceTarget::TextureCubeArray:
-            glCompressedTextureSubImage3D(texture.handle, level, 0, 0, 0,
+            if (params.is_layered && HasDirtySubresources()) {
+                const std::size_t layer_size{params.GetHostLayerSize(level)};
+                for (u32 layer = 0; layer < params.depth; ++layer) {
+                    if (IsSubresourceDirty(layer, level)) {
+                        glCompressedTextureSubImage3D(
+                            handle, level, 0, 0, static_cast<GLint>(layer),
+                            static_cast<GLsizei>(params.GetMipWidth(level)),
+                            static_cast<GLsizei>(params.GetMipHeight(level)), 1, internal_format,
+                            static_cast<GLsizei>(layer_size), buffer + layer * layer_size);
+                    }
+                }
+                break;
+            }
+            glCompressedTextureSubImage3D(handle, level, 0, 0, 0,
                                           static_cast<GLsizei>(params.GetMipWidth(level)),
                                           static_cast<GLsizei>(params.GetMipHeight(level)),
                                           static_cast<GLsizei>(params.GetMipDepth(level)),
@@ -323,12 +608,14 @@ void CachedSurface::UploadTextureMipmap(u32 level, const std::vector<u8>& stagin
             break;
         case SurfaceTarget::TextureCubemap: {
             const std::size_t layer_size{params.GetHostLayerSize(level)};
-            for (std::size_t face = 0; face < params.depth; ++face) {
-                glCompressedTextureSubImage3D(texture.handle, level, 0, 0, static_cast<GLint>(face),
-                                              static_cast<GLsizei>(params.GetMipWidth(level)),
-                                              static_cast<GLsizei>(params.GetMipHeight(level)), 1,
-                                              internal_format, static_cast<GLsizei>(layer_size),
-                                              buffer);
+            for (u32 face = 0; face < params.depth; ++face) {
+                if (IsSubresourceDirty(face, level)) {
+                    glCompressedTextureSubImage3D(
+                        handle, level, 0, 0, static_cast<GLint>(face),
+                        static_cast<GLsizei>(params.GetMipWidth(level)),
+                        static_cast<GLsizei>(params.GetMipHeight(level)), 1, internal_format,
+                        static_cast<GLsizei>(layer_size), buffer);
+                }
                 buffer += layer_size;
             }
             break;
@@ -339,7 +626,7 @@ void CachedSurface::UploadTextureMipmap(u32 level, const std::vector<u8>& stagin
     } else {
         switch (params.target) {
         case SurfaceTarget::Texture1D:
-            glTextureSubImage1D(texture.handle, level, 0, params.GetMipWidth(level), format, type,
+            glTextureSubImage1D(handle, level, 0, params.GetMipWidth(level), format, type,
                                 buffer);
             break;
         case SurfaceTarget::TextureBuffer:
@@ -349,22 +636,35 @@ void CachedSurface::UploadTextureMipmap(u32 level, const std::vector<u8>& stagin
             break;
         case SurfaceTarget::Texture1DArray:
         case SurfaceTarget::Texture2D:
-            glTextureSubImage2D(texture.handle, level, 0, 0, params.GetMipWidth(level),
+            glTextureSubImage2D(handle, level, 0, 0, params.GetMipWidth(level),
                                 params.GetMipHeight(level), format, type, buffer);
             break;
         case SurfaceTarget::Texture3D:
         case SurfaceTarget::Texture2DArray:
         case SurfaceTarget::TextureCubeArray:
+            if (params.is_layered && HasDirtySubresources()) {
+                const std::size_t layer_size{params.GetHostLayerSize(level)};
+                for (u32 layer = 0; layer < params.depth; ++layer) {
+                    if (IsSubresourceDirty(layer, level)) {
+                        glTextureSubImage3D(handle, level, 0, 0, static_cast<GLint>(layer),
+                                            params.GetMipWidth(level), params.GetMipHeight(level),
+                                            1, format, type, buffer + layer * layer_size);
+                    }
+                }
+                break;
+            }
             glTextureSubImage3D(
-                texture.handle, level, 0, 0, 0, static_cast<GLsizei>(params.GetMipWidth(level)),
+                handle, level, 0, 0, 0, static_cast<GLsizei>(params.GetMipWidth(level)),
                 static_cast<GLsizei>(params.GetMipHeight(level)),
                 static_cast<GLsizei>(params.GetMipDepth(level)), format, type, buffer);
             break;
         case SurfaceTarget::TextureCubemap:
-            for (std::size_t face = 0; face < params.depth; ++face) {
-                glTextureSubImage3D(texture.handle, level, 0, 0, static_cast<GLint>(face),
-                                    params.GetMipWidth(level), params.GetMipHeight(level), 1,
-                                    format, type, buffer);
+            for (u32 face = 0; face < params.depth; ++face) {
+                if (IsSubresourceDirty(face, level)) {
+                    glTextureSubImage3D(handle, level, 0, 0, static_cast<GLint>(face),
+                                        params.GetMipWidth(level), params.GetMipHeight(level), 1,
+                                        format, type, buffer);
+                }
                 buffer += params.GetHostLayerSize(level);
             }
             break;
@@ -374,6 +674,28 @@ void CachedSurface::UploadTextureMipmap(u32 level, const std::vector<u8>& stagin
     }
 }
 
+OGLTexture CachedSurface::CreateNativeTexture() const {
+    SurfaceParams native_params = params;
+    native_params.resolution_scale = 1;
+    OGLBuffer texture_buffer;
+    return CreateTexture(native_params, target, internal_format, texture_buffer);
+}
+
+void CachedSurface::BlitScaled(GLuint native_texture, bool downscale) {
+    const BlitRegion native{native_texture, params.target, 0, 0,
+                            {0, 0, params.width, params.height}};
+    const BlitRegion scaled{texture.handle, params.target, 0, 0,
+                            {0, 0, params.GetScaledWidth(), params.GetScaledHeight()}};
+    if (downscale) {
+        // Integer formats can't be filtered, they are resolved with the nearest texels
+        const bool is_linear = params.component_type != ComponentType::UInt &&
+                               params.component_type != ComponentType::SInt;
+        BlitRegions(scaled, native, params.type, is_linear);
+    } else {
+        BlitRegions(native, scaled, params.type, false);
+    }
+}
+
 void CachedSurface::DecorateSurfaceName() {
     LabelGLObject(GL_TEXTURE, texture.handle, GetGpuAddr(), params.TargetName());
 }
@@ -465,7 +787,7 @@ OGLTextureView CachedSurfaceView::CreateTextureView() const {
 TextureCacheOpenGL::TextureCacheOpenGL(Core::System& system,
                                        VideoCore::RasterizerInterface& rasterizer,
                                        const Device& device)
-    : TextureCacheBase{system, rasterizer} {
+    : TextureCacheBase{system, rasterizer}, staging_ring{STAGING_RING_SIZE} {
     src_framebuffer.Create();
     dst_framebuffer.Create();
 }
@@ -473,7 +795,7 @@ TextureCacheOpenGL::TextureCacheOpenGL(Core::System& system,
 TextureCacheOpenGL::~TextureCacheOpenGL() = default;
 
 Surface TextureCacheOpenGL::CreateSurface(GPUVAddr gpu_addr, const SurfaceParams& params) {
-    return std::make_shared<CachedSurface>(gpu_addr, params);
+    return std::make_shared<CachedSurface>(gpu_addr, params, staging_ring);
 }
 
 void TextureCacheOpenGL::ImageCopy(Surface& src_surface, Surface& dst_surface,
@@ -488,11 +810,38 @@ void TextureCacheOpenGL::ImageCopy(Surface& src_surface, Surface& dst_surface,
     const auto src_target = src_surface->GetTarget();
     const auto dst_handle = dst_surface->GetTexture();
     const auto dst_target = dst_surface->GetTarget();
-    glCopyImageSubData(src_handle, src_target, copy_params.source_level, copy_params.source_x,
-                       copy_params.source_y, copy_params.source_z, dst_handle, dst_target,
-                       copy_params.dest_level, copy_params.dest_x, copy_params.dest_y,
-                       copy_params.dest_z, copy_params.width, copy_params.height,
-                       copy_params.depth);
+    const u32 src_scale = src_params.resolution_scale;
+    const u32 dst_scale = dst_params.resolution_scale;
+    if (src_scale == dst_scale) {
+        // Scaled surfaces are single level 2D textures, scaling the extents is enough
+        glCopyImageSubData(src_handle, src_target, copy_params.source_level,
+                           copy_params.source_x * src_scale, copy_params.source_y * src_scale,
+                           copy_params.source_z, dst_handle, dst_target, copy_params.dest_level,
+                           copy_params.dest_x * dst_scale, copy_params.dest_y * dst_scale,
+                           copy_params.dest_z, copy_params.width * src_scale,
+                           copy_params.height * src_scale, copy_params.depth);
+        return;
+    }
+    // Copies between different resolution scales have to be resampled
+    const u32 src_right = copy_params.source_x + copy_params.width;
+    const u32 src_bottom = copy_params.source_y + copy_params.height;
+    const u32 dst_right = copy_params.dest_x + copy_params.width;
+    const u32 dst_bottom = copy_params.dest_y + copy_params.height;
+    for (u32 layer = 0; layer < copy_params.depth; ++layer) {
+        const BlitRegion src{src_handle,
+                             src_params.target,
+                             copy_params.source_level,
+                             copy_params.source_z + layer,
+                             {copy_params.source_x * src_scale, copy_params.source_y * src_scale,
+                              src_right * src_scale, src_bottom * src_scale}};
+        const BlitRegion dst{dst_handle,
+                             dst_params.target,
+                             copy_params.dest_level,
+                             copy_params.dest_z + layer,
+                             {copy_params.dest_x * dst_scale, copy_params.dest_y * dst_scale,
+                              dst_right * dst_scale, dst_bottom * dst_scale}};
+        BlitRegions(src, dst, src_params.type, false);
+    }
 }
 
 void TextureCacheOpenGL::ImageBlit(View& src_view, View& dst_view,
@@ -549,24 +898,43 @@ void TextureCacheOpenGL::ImageBlit(View& src_view, View& dst_view,
 
     const Common::Rectangle<u32>& src_rect = copy_config.src_rect;
     const Common::Rectangle<u32>& dst_rect = copy_config.dst_rect;
+    const u32 src_scale = src_params.resolution_scale;
+    const u32 dst_scale = dst_params.resolution_scale;
     const bool is_linear = copy_config.filter == Tegra::Engines::Fermi2D::Filter::Linear;
 
-    glBlitFramebuffer(src_rect.left, src_rect.top, src_rect.right, src_rect.bottom, dst_rect.left,
-                      dst_rect.top, dst_rect.right, dst_rect.bottom, buffers,
+    glBlitFramebuffer(src_rect.left * src_scale, src_rect.top * src_scale,
+                      src_rect.right * src_scale, src_rect.bottom * src_scale,
+                      dst_rect.left * dst_scale, dst_rect.top * dst_scale,
+                      dst_rect.right * dst_scale, dst_rect.bottom * dst_scale, buffers,
                       is_linear && (buffers == GL_COLOR_BUFFER_BIT) ? GL_LINEAR : GL_NEAREST);
 }
 
+bool TextureCacheOpenGL::AccelerateLoad(const Surface& surface, u8* guest_data) {
+    if (!surface->UploadSwizzled(guest_data, unswizzle_pass)) {
+        return false;
+    }
+    // The unswizzle pass reads the guest data through a shader storage buffer binding
+    storage_bindings_changed = true;
+    return true;
+}
+
 void TextureCacheOpenGL::BufferCopy(Surface& src_surface, Surface& dst_surface) {
     MICROPROFILE_SCOPE(OpenGL_Texture_Buffer_Copy);
     const auto& src_params = src_surface->GetSurfaceParams();
     const auto& dst_params = dst_surface->GetSurfaceParams();
     UNIMPLEMENTED_IF(src_params.num_levels > 1 || dst_params.num_levels > 1);
+    if (src_params.resolution_scale != dst_params.resolution_scale) {
+        LOG_ERROR(Render_OpenGL, "Buffer copy between resolution scales {} and {} is unimplemented",
+                  src_params.resolution_scale, dst_params.resolution_scale);
+        return;
+    }
+    const u32 scale = dst_params.resolution_scale;
 
     const auto source_format = GetFormatTuple(src_params.pixel_format, src_params.component_type);
     const auto dest_format = GetFormatTuple(dst_params.pixel_format, dst_params.component_type);
 
-    const std::size_t source_size = src_surface->GetHostSizeInBytes();
-    const std::size_t dest_size = dst_surface->GetHostSizeInBytes();
+    const std::size_t source_size = src_surface->GetHostSizeInBytes() * scale * scale;
+    const std::size_t dest_size = dst_surface->GetHostSizeInBytes() * scale * scale;
 
     const std::size_t buffer_size = std::max(source_size, dest_size);
 
@@ -585,8 +953,8 @@ void TextureCacheOpenGL::BufferCopy(Surface& src_surface, Surface& dst_surface)
 
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, copy_pbo_handle);
 
-    const GLsizei width = static_cast<GLsizei>(dst_params.width);
-    const GLsizei height = static_cast<GLsizei>(dst_params.height);
+    const GLsizei width = static_cast<GLsizei>(dst_params.width * scale);
+    const GLsizei height = static_cast<GLsizei>(dst_params.height * scale);
     const GLsizei depth = static_cast<GLsizei>(dst_params.depth);
     if (dest_format.compressed) {
         LOG_CRITICAL(HW_GPU, "Compressed buffer copy is unimplemented!");
@@ -622,6 +990,31 @@ void TextureCacheOpenGL::BufferCopy(Surface& src_surface, Surface& dst_surface)
     glTextureBarrier();
 }
 
+void TextureCacheOpenGL::ClearSurface(Surface& surface, const VideoCommon::ClearValue& value) {
+    const GLuint handle = surface->GetTexture();
+    switch (surface->GetSurfaceParams().type) {
+    case SurfaceType::ColorTexture:
+        glClearTexImage(handle, 0, GL_RGBA, GL_FLOAT, value.color.data());
+        break;
+    case SurfaceType::Depth:
+        glClearTexImage(handle, 0, GL_DEPTH_COMPONENT, GL_FLOAT, &value.depth);
+        break;
+    case SurfaceType::DepthStencil: {
+        // Layout of GL_FLOAT_32_UNSIGNED_INT_24_8_REV, the stencil is in the lowest bits
+        struct {
+            f32 depth;
+            u32 stencil;
+        } const data{value.depth, static_cast<u32>(value.stencil) & 0xFF};
+        glClearTexImage(handle, 0, GL_DEPTH_STENCIL, GL_FLOAT_32_UNSIGNED_INT_24_8_REV, &data);
+        break;
+    }
+    default:
+        UNIMPLEMENTED_MSG("Unimplemented clear of surface type {}",
+                          static_cast<u32>(surface->GetSurfaceParams().type));
+        break;
+    }
+}
+
 GLuint TextureCacheOpenGL::FetchPBO(std::size_t buffer_size) {
     ASSERT_OR_EXECUTE(buffer_size > 0, { return 0; });
     const u32 l2 = Common::Log2Ceil64(static_cast<u64>(buffer_size));
@@ -14,9 +14,12 @@
 #include <glad/glad.h>
 
 #include "common/common_types.h"
+#include "common/math_util.h"
 #include "video_core/engines/shader_bytecode.h"
 #include "video_core/renderer_opengl/gl_device.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
+#include "video_core/renderer_opengl/gl_staging_buffer.h"
+#include "video_core/renderer_opengl/gl_unswizzle_pass.h"
 #include "video_core/texture_cache/texture_cache.h"
 
 namespace OpenGL {
@@ -36,12 +39,25 @@ class CachedSurface final : public VideoCommon::SurfaceBase<View> {
     friend CachedSurfaceView;
 
 public:
-    explicit CachedSurface(GPUVAddr gpu_addr, const SurfaceParams& params);
+    explicit CachedSurface(GPUVAddr gpu_addr, const SurfaceParams& params,
+                           StagingBufferRing& staging_ring);
     ~CachedSurface();
 
     void UploadTexture(const std::vector<u8>& staging_buffer) override;
     void DownloadTexture(std::vector<u8>& staging_buffer) override;
 
+    /// Uploads the block-linear guest data and unswizzles it on the GPU. Returns false when the
+    /// surface can't be unswizzled this way, leaving it untouched.
+    bool UploadSwizzled(const u8* guest_data, UnswizzlePass& unswizzle_pass);
+
+    /// Copies a rectangle of the first level to a buffer, with rows pitch bytes apart.
+    void DownloadRegion(GLuint buffer, std::size_t offset, std::size_t size, u32 pitch,
+                        const Common::Rectangle<u32>& rect);
+
+    /// Copies a rectangle from a buffer, with rows pitch bytes apart, to the first level.
+    void UploadRegion(GLuint buffer, std::size_t offset, u32 pitch,
+                      const Common::Rectangle<u32>& rect);
+
     GLenum GetTarget() const {
         return target;
     }
@@ -57,7 +73,17 @@ protected:
     View CreateViewInner(const ViewParams& view_key, bool is_proxy);
 
 private:
-    void UploadTextureMipmap(u32 level, const std::vector<u8>& staging_buffer);
+    /// Uploads a mipmap from base, a client pointer or an offset in the bound unpack buffer, to
+    /// the given texture handle.
+    void UploadTextureMipmap(u32 level, const u8* base, GLuint handle);
+
+    /// Creates a texture of the surface at the guest's resolution, used to transfer the contents
+    /// of scaled surfaces.
+    OGLTexture CreateNativeTexture() const;
+
+    /// Blits a texture at the guest's resolution into the scaled texture, or the other way
+    /// around when downscale is true.
+    void BlitScaled(GLuint native_texture, bool downscale);
 
     GLenum internal_format{};
     GLenum format{};
@@ -66,6 +92,8 @@ private:
     GLenum target{};
     u32 view_count{};
 
+    StagingBufferRing& staging_ring;
+
     OGLTexture texture;
     OGLBuffer texture_buffer;
 };
@@ -125,6 +153,11 @@ public:
                                 const Device& device);
     ~TextureCacheOpenGL();
 
+    /// Returns true when a texture upload rebound shader storage buffers since the last call.
+    bool StorageBindingsChanged() {
+        return std::exchange(storage_bindings_changed, false);
+    }
+
 protected:
     Surface CreateSurface(GPUVAddr gpu_addr, const SurfaceParams& params) override;
 
@@ -136,12 +169,20 @@ protected:
 
     void BufferCopy(Surface& src_surface, Surface& dst_surface) override;
 
+    void ClearSurface(Surface& surface, const VideoCommon::ClearValue& value) override;
+
+    bool AccelerateLoad(const Surface& surface, u8* guest_data) override;
+
 private:
     GLuint FetchPBO(std::size_t buffer_size);
 
     OGLFramebuffer src_framebuffer;
     OGLFramebuffer dst_framebuffer;
     std::unordered_map<u32, OGLBuffer> copy_pbo_cache;
+
+    UnswizzlePass unswizzle_pass;
+    StagingBufferRing staging_ring;
+    bool storage_bindings_changed{};
 };
 
 } // namespace OpenGL
@@ -0,0 +1,189 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+
+#include <glad/glad.h>
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "common/scope_exit.h"
+#include "video_core/renderer_opengl/gl_state.h"
+#include "video_core/renderer_opengl/gl_unswizzle_pass.h"
+
+namespace OpenGL {
+
+namespace {
+
+constexpr u32 LOCAL_SIZE = 8;
+
+constexpr std::array<GLenum, 5> image_formats{GL_R8UI, GL_R16UI, GL_R32UI, GL_RG32UI,
+                                              GL_RGBA32UI};
+
+constexpr char UNSWIZZLE_SHADER[] = R"(#version 430 core
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (std430, binding = 0) readonly buffer InputBuffer {
+    uint swizzled_data[];
+};
+
+layout (binding = 0) writeonly uniform uimage2D output_image;
+
+layout (location = 0) uniform uint base_offset;
+layout (location = 1) uniform uint bytes_per_pixel;
+layout (location = 2) uniform uvec2 size;
+layout (location = 3) uniform uint slice;
+layout (location = 4) uniform uint block_height;
+layout (location = 5) uniform uint block_depth;
+layout (location = 6) uniform uvec2 blocks;
+
+// Same layout as Tegra::Texture::CopySwizzledData, GOBs are 64 bytes wide and 8 rows tall and
+// blocks are one GOB wide, block_height GOBs tall and block_depth GOBs deep.
+uint SwizzledOffset(uvec2 pos) {
+    uint x = pos.x * bytes_per_pixel;
+    uint block_index =
+        ((slice / block_depth) * blocks.y + pos.y / (8 * block_height)) * blocks.x + x / 64;
+    uint block_offset =
+        (slice % block_depth) * 512 * block_height + ((pos.y % (8 * block_height)) / 8) * 512;
+    uint gob_x = x % 64;
+    uint gob_y = pos.y % 8;
+    uint gob_offset = (gob_x / 32) * 256 + (gob_y / 2) * 64 + ((gob_x % 32) / 16) * 32 +
+                      (gob_y % 2) * 16 + gob_x % 16;
+    return base_offset + block_index * 512 * block_height * block_depth + block_offset +
+           gob_offset;
+}
+
+uvec4 ReadTexel(uint offset) {
+    uint word = offset / 4;
+    switch (bytes_per_pixel) {
+    case 1u:
+        return uvec4(bitfieldExtract(swizzled_data[word], int(offset % 4) * 8, 8), 0, 0, 0);
+    case 2u:
+        return uvec4(bitfieldExtract(swizzled_data[word], int(offset % 4) * 8, 16), 0, 0, 0);
+    case 4u:
+        return uvec4(swizzled_data[word], 0, 0, 0);
+    case 8u:
+        return uvec4(swizzled_data[word], swizzled_data[word + 1], 0, 0);
+    default:
+        return uvec4(swizzled_data[word], swizzled_data[word + 1], swizzled_data[word + 2],
+                     swizzled_data[word + 3]);
+    }
+}
+
+void main() {
+    uvec2 pos = gl_GlobalInvocationID.xy;
+    if (any(greaterThanEqual(pos, size))) {
+        return;
+    }
+    imageStore(output_image, ivec2(pos), ReadTexel(SwizzledOffset(pos)));
+}
+)";
+
+/// Returns the integer image format with the size of a texel, GL_NONE when there's none.
+GLenum GetImageFormat(u32 bytes_per_pixel) {
+    switch (bytes_per_pixel) {
+    case 1:
+        return image_formats[0];
+    case 2:
+        return image_formats[1];
+    case 4:
+        return image_formats[2];
+    case 8:
+        return image_formats[3];
+    case 16:
+        return image_formats[4];
+    default:
+        return GL_NONE;
+    }
+}
+
+} // Anonymous namespace
+
+UnswizzlePass::UnswizzlePass() {
+    OGLShader shader;
+    shader.Create(UNSWIZZLE_SHADER, GL_COMPUTE_SHADER);
+    program.Create(false, false, shader.handle);
+    input_buffer.Create();
+
+    GLint64 max_block_size = 0;
+    glGetInteger64v(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &max_block_size);
+    max_input_size = static_cast<std::size_t>(max_block_size);
+}
+
+UnswizzlePass::~UnswizzlePass() = default;
+
+bool UnswizzlePass::IsSupported(GLenum internal_format, u32 bytes_per_pixel,
+                                std::size_t size) {
+    if (GetImageFormat(bytes_per_pixel) == GL_NONE ||
+        Common::AlignUp(size, sizeof(u32)) > max_input_size) {
+        return false;
+    }
+    const auto [it, is_new] = compatible_formats.try_emplace(internal_format);
+    if (is_new) {
+        // Formats that are only compatible by class can't be reinterpreted as integers
+        GLint compatibility = GL_NONE;
+        glGetInternalformativ(GL_TEXTURE_2D, internal_format, GL_IMAGE_FORMAT_COMPATIBILITY_TYPE,
+                              1, &compatibility);
+        it->second = compatibility == GL_IMAGE_FORMAT_COMPATIBILITY_BY_SIZE;
+    }
+    return it->second;
+}
+
+void UnswizzlePass::Upload(const u8* data, std::size_t size) {
+    // Shaders read whole words, leave room for the last one
+    const std::size_t aligned_size = Common::AlignUp(size, sizeof(u32));
+    if (aligned_size > input_buffer_size) {
+        input_buffer.Release();
+        input_buffer.Create();
+        glNamedBufferStorage(input_buffer.handle, static_cast<GLsizeiptr>(aligned_size), nullptr,
+                             GL_DYNAMIC_STORAGE_BIT);
+        input_buffer_size = aligned_size;
+    }
+    glNamedBufferSubData(input_buffer.handle, 0, static_cast<GLsizeiptr>(size), data);
+}
+
+void UnswizzlePass::Unswizzle(GLuint texture, u32 level, u32 layer,
+                              const UnswizzleParams& params) {
+    const GLenum image_format = GetImageFormat(params.bytes_per_pixel);
+    ASSERT(image_format != GL_NONE);
+
+    OpenGLState prev_state{OpenGLState::GetCurState()};
+    SCOPE_EXIT({
+        // Restore the image unit as the state tracker left it
+        glBindImageTextures(0, 1, &prev_state.images[0]);
+        prev_state.ApplyShaderProgram();
+        prev_state.ApplyProgramPipeline();
+    });
+
+    OpenGLState state{prev_state};
+    state.draw.shader_program = program.handle;
+    state.draw.program_pipeline = 0;
+    state.ApplyShaderProgram();
+    state.ApplyProgramPipeline();
+
+    const GLuint handle = program.handle;
+    glProgramUniform1ui(handle, 0, params.base_offset);
+    glProgramUniform1ui(handle, 1, params.bytes_per_pixel);
+    glProgramUniform2ui(handle, 2, params.width, params.height);
+    glProgramUniform1ui(handle, 3, params.slice);
+    glProgramUniform1ui(handle, 4, params.block_height);
+    glProgramUniform1ui(handle, 5, params.block_depth);
+    glProgramUniform2ui(handle, 6, params.blocks_x, params.blocks_y);
+
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, input_buffer.handle, 0,
+                      static_cast<GLsizeiptr>(input_buffer_size));
+    glBindImageTexture(0, texture, static_cast<GLint>(level), GL_FALSE, static_cast<GLint>(layer),
+                       GL_WRITE_ONLY, image_format);
+
+    glDispatchCompute(Common::AlignUp(params.width, LOCAL_SIZE) / LOCAL_SIZE,
+                      Common::AlignUp(params.height, LOCAL_SIZE) / LOCAL_SIZE, 1);
+}
+
+void UnswizzlePass::Finish() {
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+                    GL_TEXTURE_UPDATE_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+}
+
+} // namespace OpenGL
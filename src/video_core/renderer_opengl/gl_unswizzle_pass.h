@@ -0,0 +1,63 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+
+#include <glad/glad.h>
+
+#include "common/common_types.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace OpenGL {
+
+/// Describes a 2D slice of a block-linear surface in the data uploaded to an UnswizzlePass.
+struct UnswizzleParams {
+    u32 base_offset;     ///< Offset in bytes of the mipmap or layer in the uploaded data.
+    u32 bytes_per_pixel; ///< Bytes per pixel, a power of two up to 16.
+    u32 width;           ///< Width of the slice in pixels.
+    u32 height;          ///< Height of the slice in pixels.
+    u32 slice;           ///< Depth of the slice inside a 3D mipmap, zero otherwise.
+    u32 block_height;    ///< Block height in GOBs.
+    u32 block_depth;     ///< Block depth in GOBs.
+    u32 blocks_x;        ///< Number of blocks on a row of the mipmap.
+    u32 blocks_y;        ///< Number of blocks on a column of the mipmap.
+};
+
+/**
+ * Converts block-linear guest textures to their host layout with a compute shader. The texels
+ * are written through image stores with an integer format of the same size, so only textures
+ * with a format that can be reinterpreted this way are supported.
+ */
+class UnswizzlePass {
+public:
+    explicit UnswizzlePass();
+    ~UnswizzlePass();
+
+    /// Returns true when a texture with the given internal format and guest size in bytes can be
+    /// written by this pass.
+    bool IsSupported(GLenum internal_format, u32 bytes_per_pixel, std::size_t size);
+
+    /// Uploads guest data to the buffer read by the next calls to Unswizzle.
+    void Upload(const u8* data, std::size_t size);
+
+    /// Unswizzles a 2D slice of the uploaded data into a layer of a texture mipmap.
+    void Unswizzle(GLuint texture, u32 level, u32 layer, const UnswizzleParams& params);
+
+    /// Makes the written textures visible to the commands issued after this call.
+    void Finish();
+
+private:
+    OGLProgram program;
+    OGLBuffer input_buffer;
+    std::size_t input_buffer_size = 0;
+    std::size_t max_input_size = 0;
+
+    /// Cached results of the image format compatibility queries.
+    std::unordered_map<GLenum, bool> compatible_formats;
+};
+
+} // namespace OpenGL
@@ -3,9 +3,15 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdlib>
 #include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include <glad/glad.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -62,6 +68,89 @@ void main() {
 }
 )";
 
+/// Time to wait for a presented frame before checking it again, in nanoseconds.
+constexpr GLuint64 FENCE_TIMEOUT = 1'000'000'000;
+
+/// Frames drawn by the renderer when the frontend presents them: one being drawn, one queued and
+/// one being presented.
+constexpr std::size_t SWAP_CHAIN_SIZE = 3;
+
+/// Frame drawn by the GPU thread and presented by the present thread of the frontend.
+struct Frame {
+    u32 width = 0;
+    u32 height = 0;
+    bool is_srgb = false;
+
+    OGLRenderbuffer color;  ///< Image of the frame, shared by the contexts of both threads.
+    OGLFramebuffer render;  ///< Framebuffer drawing to color, only valid in the renderer context.
+    OGLSync render_fence;   ///< Signaled when the host GPU finished drawing the frame.
+    OGLSync present_fence;  ///< Signaled when the host GPU finished presenting the frame.
+};
+
+/**
+ * Hands the frames drawn by the renderer to the present thread of the frontend. The renderer never
+ * waits for the present thread: when no frame is free, it draws over the queued frame that was not
+ * presented yet.
+ */
+class FrameMailbox {
+public:
+    FrameMailbox() {
+        for (Frame& frame : frames) {
+            free_frames.push_back(&frame);
+        }
+    }
+
+    /// Takes a frame to draw to, it may be one that was queued and not presented yet.
+    Frame* GetRenderFrame() {
+        std::lock_guard lock{mutex};
+        if (free_frames.empty()) {
+            ASSERT(queued_frame != nullptr);
+            return std::exchange(queued_frame, nullptr);
+        }
+        Frame* const frame = free_frames.back();
+        free_frames.pop_back();
+        return frame;
+    }
+
+    /// Queues a frame for presentation, returns true if it replaced one that was not presented.
+    bool ReleaseRenderFrame(Frame* frame) {
+        bool replaced = false;
+        {
+            std::lock_guard lock{mutex};
+            if (queued_frame != nullptr) {
+                free_frames.push_back(queued_frame);
+                replaced = true;
+            }
+            queued_frame = frame;
+        }
+        frame_cv.notify_one();
+        return replaced;
+    }
+
+    /// Takes the queued frame, or returns nullptr if none was queued within the timeout.
+    Frame* TryGetPresentFrame(std::chrono::milliseconds timeout) {
+        std::unique_lock lock{mutex};
+        if (!frame_cv.wait_for(lock, timeout, [this] { return queued_frame != nullptr; })) {
+            return nullptr;
+        }
+        return std::exchange(queued_frame, nullptr);
+    }
+
+    /// Returns a presented frame, the renderer may draw to it once its present fence is signaled.
+    void ReleasePresentFrame(Frame* frame) {
+        std::lock_guard lock{mutex};
+        free_frames.push_back(frame);
+    }
+
+private:
+    std::array<Frame, SWAP_CHAIN_SIZE> frames;
+
+    std::mutex mutex;
+    std::condition_variable frame_cv;
+    std::vector<Frame*> free_frames;
+    Frame* queued_frame = nullptr;
+};
+
 /**
  * Vertex structure that the drawn screen rectangles are composed of.
  */
@@ -124,11 +213,41 @@ void RendererOpenGL::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
         if (renderer_settings.screenshot_requested)
             CaptureScreenshot();
 
-        DrawScreen(render_window.GetFramebufferLayout());
+        const Layout::FramebufferLayout layout = render_window.GetFramebufferLayout();
+        Frame* const mailbox_frame = frame_mailbox ? GetMailboxFrame(layout) : nullptr;
 
-        rasterizer->TickFrame();
+        DrawScreen(layout);
 
-        render_window.SwapBuffers();
+        rasterizer->TickFrame();
+        system.GPU().Statistics().EndFrame();
+
+        // Paced presentation waits for the oldest frame, so the driver doesn't queue more than
+        // MAX_FRAMES_IN_FLIGHT frames ahead of the host GPU
+        PresentedFrame& frame = presented_frames[presented_index];
+        presented_index = (presented_index + 1) % MAX_FRAMES_IN_FLIGHT;
+        {
+            const Core::PerfTimer timer{system.GetPerfStats(), Core::PerfCategory::PresentWait};
+            RetirePresentedFrame(frame, Settings::values.use_mailbox_presentation);
+        }
+        glGetInteger64v(GL_TIMESTAMP, &frame.submit_time);
+        glQueryCounter(frame.timestamp.handle, GL_TIMESTAMP);
+        frame.fence.Create();
+
+        if (mailbox_frame != nullptr) {
+            // The present thread waits for the frame on the host GPU, the fence has to be flushed
+            // to reach it from another context
+            mailbox_frame->render_fence.Create();
+            glFlush();
+            state.draw.draw_framebuffer = 0;
+            state.Apply();
+            if (frame_mailbox->ReleaseRenderFrame(mailbox_frame)) {
+                system.GetPerfStats().AddDroppedFrame();
+            }
+        } else {
+            const Core::PerfTimer timer{system.GetPerfStats(), Core::PerfCategory::PresentWait};
+            render_window.SwapBuffers();
+        }
+        FinishFrame();
     }
 
     render_window.PollEvents();
@@ -138,6 +257,96 @@ void RendererOpenGL::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
     prev_state.Apply();
 }
 
+void RendererOpenGL::DropFrame(const Tegra::FramebufferConfig* framebuffer) {
+    if (framebuffer) {
+        rasterizer->TickFrame();
+        system.GPU().Statistics().EndFrame();
+        system.GetPerfStats().AddDroppedFrame();
+        FinishFrame();
+    }
+    render_window.PollEvents();
+}
+
+Frame* RendererOpenGL::GetMailboxFrame(const Layout::FramebufferLayout& layout) {
+    Frame* const frame = frame_mailbox->GetRenderFrame();
+    if (frame->present_fence.handle != 0) {
+        glWaitSync(frame->present_fence.handle, 0, GL_TIMEOUT_IGNORED);
+        frame->present_fence.Release();
+    }
+
+    if (frame->render.handle == 0) {
+        frame->color.Create();
+        frame->render.Create();
+    }
+    state.draw.draw_framebuffer = frame->render.handle;
+    state.Apply();
+
+    if (frame->width != layout.width || frame->height != layout.height ||
+        frame->is_srgb != screen_info.display_srgb) {
+        frame->width = layout.width;
+        frame->height = layout.height;
+        frame->is_srgb = screen_info.display_srgb;
+        glNamedRenderbufferStorage(frame->color.handle, frame->is_srgb ? GL_SRGB8 : GL_RGB8,
+                                   frame->width, frame->height);
+        glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                                  frame->color.handle);
+    }
+    return frame;
+}
+
+bool RendererOpenGL::TryPresent(std::chrono::milliseconds timeout) {
+    if (!frame_mailbox) {
+        return false;
+    }
+    Frame* const frame = frame_mailbox->TryGetPresentFrame(timeout);
+    if (frame == nullptr) {
+        return false;
+    }
+
+    // This runs in the context of the present thread, so it leaves the renderer state alone.
+    // Framebuffer objects aren't shared between contexts, the one reading the frame is made here.
+    glWaitSync(frame->render_fence.handle, 0, GL_TIMEOUT_IGNORED);
+    frame->render_fence.Release();
+
+    GLuint read_framebuffer;
+    glCreateFramebuffers(1, &read_framebuffer);
+    glNamedFramebufferRenderbuffer(read_framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                                   frame->color.handle);
+
+    static constexpr std::array<GLfloat, 4> clear_color{0.0f, 0.0f, 0.0f, 1.0f};
+    glClearNamedFramebufferfv(0, GL_COLOR, 0, clear_color.data());
+    // The frame is already encoded as sRGB if it has to be, the blit copies it as is
+    glBlitNamedFramebuffer(read_framebuffer, 0, 0, 0, frame->width, frame->height, 0, 0,
+                           frame->width, frame->height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glDeleteFramebuffers(1, &read_framebuffer);
+
+    frame->present_fence.Create();
+    glFlush();
+    frame_mailbox->ReleasePresentFrame(frame);
+    return true;
+}
+
+void RendererOpenGL::RetirePresentedFrame(PresentedFrame& frame, bool wait) {
+    if (frame.fence.handle == 0) {
+        return;
+    }
+    GLenum result;
+    do {
+        result = glClientWaitSync(frame.fence.handle, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                  wait ? FENCE_TIMEOUT : 0);
+    } while (wait && result == GL_TIMEOUT_EXPIRED);
+    frame.fence.Release();
+    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+        return;
+    }
+
+    GLint64 finish_time{};
+    glGetQueryObjecti64v(frame.timestamp.handle, GL_QUERY_RESULT, &finish_time);
+    const std::chrono::nanoseconds latency{std::max<GLint64>(finish_time - frame.submit_time, 0)};
+    system.GetPerfStats().AddPresentLatency(
+        std::chrono::duration_cast<Core::PerfStats::Clock::duration>(latency));
+}
+
 /**
  * Loads framebuffer from emulated memory into the active OpenGL texture.
  */
@@ -236,6 +445,10 @@ void RendererOpenGL::InitOpenGLObjects() {
 
     screen_info.display_texture = screen_info.texture.resource.handle;
 
+    for (PresentedFrame& frame : presented_frames) {
+        frame.timestamp.Create(GL_TIMESTAMP);
+    }
+
     // Clear screen to black
     LoadColorToActiveGLTexture(0, 0, 0, 0, screen_info.texture);
 }
@@ -457,7 +670,7 @@ static const char* GetType(GLenum type) {
 
 static void APIENTRY DebugHandler(GLenum source, GLenum type, GLuint id, GLenum severity,
                                   GLsizei length, const GLchar* message, const void* user_param) {
-    const char format[] = "{} {} {}: {}";
+    static constexpr char format[] = "{} {} {}: {}";
     const char* const str_source = GetSource(source);
     const char* const str_type = GetType(type);
 
@@ -492,6 +705,10 @@ bool RendererOpenGL::Init() {
     InitOpenGLObjects();
     CreateRasterizer();
 
+    if (render_window.IsPresentedSeparately()) {
+        frame_mailbox = std::make_unique<FrameMailbox>();
+    }
+
     return true;
 }
 
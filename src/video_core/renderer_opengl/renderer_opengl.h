@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
 #include <vector>
 #include <glad/glad.h>
 #include "common/common_types.h"
@@ -26,6 +30,9 @@ struct FramebufferLayout;
 
 namespace OpenGL {
 
+class FrameMailbox;
+struct Frame;
+
 /// Structure used for storing information about the textures for the Switch screen
 struct TextureInfo {
     OGLTexture resource;
@@ -52,6 +59,12 @@ public:
     /// Swap buffers (render frame)
     void SwapBuffers(const Tegra::FramebufferConfig* framebuffer) override;
 
+    /// Finishes a frame without presenting it
+    void DropFrame(const Tegra::FramebufferConfig* framebuffer) override;
+
+    /// Presents the newest frame from the present thread of the frontend
+    bool TryPresent(std::chrono::milliseconds timeout) override;
+
     /// Initialize the renderer
     bool Init() override;
 
@@ -59,6 +72,17 @@ public:
     void ShutDown() override;
 
 private:
+    /// Maximum number of presented frames the host GPU may be working on when presentation is
+    /// paced.
+    static constexpr std::size_t MAX_FRAMES_IN_FLIGHT = 2;
+
+    /// Frame presented to the window, tracked until the host GPU finishes it.
+    struct PresentedFrame {
+        OGLSync fence;         ///< Signaled when the host GPU finished the frame.
+        OGLQuery timestamp;    ///< Host GPU time when the frame was finished.
+        GLint64 submit_time{}; ///< Host GPU time when the frame was submitted.
+    };
+
     void InitOpenGLObjects();
     void AddTelemetryFields();
     void CreateRasterizer();
@@ -71,6 +95,13 @@ private:
 
     void CaptureScreenshot();
 
+    /// Takes a frame of the mailbox and binds it for drawing, resized to the layout.
+    Frame* GetMailboxFrame(const Layout::FramebufferLayout& layout);
+
+    /// Reports the latency of a presented frame once the host GPU has finished it. When wait is
+    /// true it blocks until then, otherwise unfinished frames are not measured.
+    void RetirePresentedFrame(PresentedFrame& frame, bool wait);
+
     // Loads framebuffer from emulated memory into the display information structure
     void LoadFBToScreenInfo(const Tegra::FramebufferConfig& framebuffer);
     // Fills active OpenGL texture with the given RGBA color.
@@ -91,6 +122,13 @@ private:
     /// Display information for Switch screen
     ScreenInfo screen_info;
 
+    /// Presented frames the host GPU may still be working on, reused in order
+    std::array<PresentedFrame, MAX_FRAMES_IN_FLIGHT> presented_frames;
+    std::size_t presented_index = 0;
+
+    /// Frames handed to the present thread, when the frontend presents them separately
+    std::unique_ptr<FrameMailbox> frame_mailbox;
+
     /// OpenGL framebuffer data
     std::vector<u8> gl_framebuffer_data;
 
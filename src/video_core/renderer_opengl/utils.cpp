@@ -74,10 +74,24 @@ void BindBuffersRangePushBuffer::Bind() {
     std::transform(buffer_pointers.begin(), buffer_pointers.end(), buffers.begin(),
                    [](const GLuint* pointer) { return *pointer; });
 
+    if (is_bound && first == bound_first && buffers == bound_buffers &&
+        offsets == bound_offsets && sizes == bound_sizes) {
+        return;
+    }
+    is_bound = true;
+    bound_first = first;
+    bound_buffers = buffers;
+    bound_offsets = offsets;
+    bound_sizes = sizes;
+
     glBindBuffersRange(target, first, static_cast<GLsizei>(count), buffers.data(), offsets.data(),
                        sizes.data());
 }
 
+void BindBuffersRangePushBuffer::Invalidate() {
+    is_bound = false;
+}
+
 void LabelGLObject(GLenum identifier, GLuint handle, VAddr addr, std::string_view extra_info) {
     if (!GLAD_GL_KHR_debug) {
         // We don't need to throw an error as this is just for debugging
@@ -47,8 +47,13 @@ public:
 
     void Push(const GLuint* buffer, GLintptr offset, GLsizeiptr size);
 
+    /// Binds the pushed buffers, skipped when they match the last bound range.
     void Bind();
 
+    /// Forgets the last bound range, for when something else rebinds these bindings or one of
+    /// the buffers may have been deleted.
+    void Invalidate();
+
 private:
     GLenum target{};
     GLuint first{};
@@ -57,6 +62,12 @@ private:
     std::vector<GLuint> buffers;
     std::vector<GLintptr> offsets;
     std::vector<GLsizeiptr> sizes;
+
+    bool is_bound{};
+    GLuint bound_first{};
+    std::vector<GLuint> bound_buffers;
+    std::vector<GLintptr> bound_offsets;
+    std::vector<GLsizeiptr> bound_sizes;
 };
 
 void LabelGLObject(GLenum identifier, GLuint handle, VAddr addr, std::string_view extra_info = {});
@@ -0,0 +1,157 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/cityhash.h"
+#include "common/common_types.h"
+#include "video_core/renderer_vulkan/fixed_pipeline_state.h"
+
+namespace Vulkan {
+
+namespace {
+
+FixedPipelineState::VertexInput GetVertexInputState(const Maxwell& regs) {
+    FixedPipelineState::VertexInput vertex_input{};
+    u32 num_bindings = 0;
+    for (std::size_t index = 0; index < Maxwell::NumVertexArrays; ++index) {
+        const auto& vertex_array = regs.vertex_array[index];
+        if (!vertex_array.IsEnabled()) {
+            continue;
+        }
+        auto& binding = vertex_input.bindings[index];
+        binding.stride = vertex_array.stride;
+        binding.divisor = regs.instanced_arrays.IsInstancingEnabled(static_cast<u32>(index))
+                              ? vertex_array.divisor
+                              : 0;
+        num_bindings = static_cast<u32>(index) + 1;
+    }
+    vertex_input.num_bindings = num_bindings;
+
+    for (std::size_t index = 0; index < Maxwell::NumVertexAttributes; ++index) {
+        const auto& attribute = regs.vertex_attrib_format[index];
+        // Constant attributes don't read from a binding, their value comes from the shader.
+        if (attribute.constant) {
+            continue;
+        }
+        vertex_input.attributes[index] = attribute.hex;
+    }
+    return vertex_input;
+}
+
+FixedPipelineState::InputAssembly GetInputAssemblyState(const Maxwell& regs) {
+    FixedPipelineState::InputAssembly input_assembly{};
+    input_assembly.topology = regs.draw.topology;
+    input_assembly.primitive_restart_enable = regs.primitive_restart.enabled != 0 ? 1 : 0;
+    return input_assembly;
+}
+
+FixedPipelineState::Rasterizer GetRasterizerState(const Maxwell& regs) {
+    FixedPipelineState::Rasterizer rasterizer{};
+    rasterizer.cull_enable = regs.cull.enabled != 0 ? 1 : 0;
+    if (rasterizer.cull_enable) {
+        rasterizer.cull_face = regs.cull.cull_face;
+        rasterizer.front_face = regs.cull.front_face;
+        rasterizer.flip_triangles = regs.screen_y_control.triangle_rast_flip == 0 ||
+                                            regs.viewport_transform[0].scale_y < 0.0f
+                                        ? 1
+                                        : 0;
+    }
+    const bool depth_bias_enable = regs.polygon_offset_point_enable != 0 ||
+                                   regs.polygon_offset_line_enable != 0 ||
+                                   regs.polygon_offset_fill_enable != 0;
+    rasterizer.depth_bias_enable = depth_bias_enable ? 1 : 0;
+    rasterizer.depth_clamp_near = regs.view_volume_clip_control.depth_clamp_near;
+    rasterizer.depth_clamp_far = regs.view_volume_clip_control.depth_clamp_far;
+    return rasterizer;
+}
+
+FixedPipelineState::DepthStencil GetDepthStencilState(const Maxwell& regs) {
+    FixedPipelineState::DepthStencil depth_stencil{};
+    depth_stencil.depth_test_enable = regs.depth_test_enable != 0 ? 1 : 0;
+    depth_stencil.depth_write_enable = regs.depth_write_enabled != 0 ? 1 : 0;
+    if (depth_stencil.depth_test_enable) {
+        depth_stencil.depth_test_func = regs.depth_test_func;
+    }
+
+    depth_stencil.stencil_enable = regs.stencil_enable != 0 ? 1 : 0;
+    if (!depth_stencil.stencil_enable) {
+        return depth_stencil;
+    }
+    auto& front = depth_stencil.front;
+    front.action_stencil_fail = regs.stencil_front_op_fail;
+    front.action_depth_fail = regs.stencil_front_op_zfail;
+    front.action_depth_pass = regs.stencil_front_op_zpass;
+    front.test_func = regs.stencil_front_func_func;
+    if (regs.stencil_two_side_enable) {
+        auto& back = depth_stencil.back;
+        back.action_stencil_fail = regs.stencil_back_op_fail;
+        back.action_depth_fail = regs.stencil_back_op_zfail;
+        back.action_depth_pass = regs.stencil_back_op_zpass;
+        back.test_func = regs.stencil_back_func_func;
+    } else {
+        depth_stencil.back = front;
+    }
+    return depth_stencil;
+}
+
+FixedPipelineState::ColorBlending GetColorBlendingState(const Maxwell& regs) {
+    FixedPipelineState::ColorBlending color_blending{};
+    const std::size_t num_attachments =
+        std::min<std::size_t>(regs.rt_control.count, Maxwell::NumRenderTargets);
+    color_blending.attachments_count = static_cast<u32>(num_attachments);
+
+    for (std::size_t index = 0; index < num_attachments; ++index) {
+        auto& attachment = color_blending.attachments[index];
+        attachment.color_mask = regs.color_mask[regs.color_mask_common ? 0 : index].raw;
+
+        const std::size_t blend_index = regs.independent_blend_enable ? index : 0;
+        attachment.enable = regs.blend.enable[blend_index] != 0 ? 1 : 0;
+        if (!attachment.enable) {
+            continue;
+        }
+        if (regs.independent_blend_enable) {
+            const auto& src = regs.independent_blend[index];
+            attachment.rgb_equation = src.equation_rgb;
+            attachment.src_rgb_func = src.factor_source_rgb;
+            attachment.dst_rgb_func = src.factor_dest_rgb;
+            attachment.a_equation = src.equation_a;
+            attachment.src_a_func = src.factor_source_a;
+            attachment.dst_a_func = src.factor_dest_a;
+        } else {
+            const auto& src = regs.blend;
+            attachment.rgb_equation = src.equation_rgb;
+            attachment.src_rgb_func = src.factor_source_rgb;
+            attachment.dst_rgb_func = src.factor_dest_rgb;
+            attachment.a_equation = src.equation_a;
+            attachment.src_a_func = src.factor_source_a;
+            attachment.dst_a_func = src.factor_dest_a;
+        }
+    }
+    return color_blending;
+}
+
+} // Anonymous namespace
+
+std::size_t FixedPipelineState::Hash() const noexcept {
+    return static_cast<std::size_t>(
+        Common::CityHash64(reinterpret_cast<const char*>(this), sizeof(*this)));
+}
+
+bool FixedPipelineState::operator==(const FixedPipelineState& rhs) const noexcept {
+    return std::memcmp(this, &rhs, sizeof(*this)) == 0;
+}
+
+FixedPipelineState GetFixedPipelineState(const Maxwell& regs) {
+    FixedPipelineState fixed_state;
+    fixed_state.vertex_input = GetVertexInputState(regs);
+    fixed_state.input_assembly = GetInputAssemblyState(regs);
+    fixed_state.rasterizer = GetRasterizerState(regs);
+    fixed_state.depth_stencil = GetDepthStencilState(regs);
+    fixed_state.color_blending = GetColorBlendingState(regs);
+    return fixed_state;
+}
+
+} // namespace Vulkan
@@ -0,0 +1,114 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "common/common_types.h"
+#include "video_core/engines/maxwell_3d.h"
+
+namespace Vulkan {
+
+using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+
+/**
+ * Fixed function state baked into a Vulkan graphics pipeline, packed from the Maxwell registers.
+ * It's made only of 32-bit words so it can be hashed and compared as raw memory, unused entries
+ * are left zeroed.
+ */
+struct FixedPipelineState {
+    struct VertexBinding {
+        u32 stride;
+        u32 divisor; ///< Zero when the binding is accessed per vertex.
+    };
+
+    struct VertexInput {
+        u32 num_bindings;
+        std::array<VertexBinding, Maxwell::NumVertexArrays> bindings;
+        std::array<u32, Maxwell::NumVertexAttributes> attributes; ///< Raw attribute formats.
+    };
+
+    struct InputAssembly {
+        Maxwell::PrimitiveTopology topology;
+        u32 primitive_restart_enable;
+    };
+
+    struct Rasterizer {
+        u32 cull_enable;
+        Maxwell::Cull::CullFace cull_face;
+        Maxwell::Cull::FrontFace front_face;
+        u32 flip_triangles;
+        u32 depth_bias_enable;
+        u32 depth_clamp_near;
+        u32 depth_clamp_far;
+    };
+
+    struct StencilFace {
+        Maxwell::StencilOp action_stencil_fail;
+        Maxwell::StencilOp action_depth_fail;
+        Maxwell::StencilOp action_depth_pass;
+        Maxwell::ComparisonOp test_func;
+    };
+
+    struct DepthStencil {
+        u32 depth_test_enable;
+        u32 depth_write_enable;
+        Maxwell::ComparisonOp depth_test_func;
+        u32 stencil_enable;
+        StencilFace front;
+        StencilFace back;
+    };
+
+    struct BlendingAttachment {
+        u32 enable;
+        Maxwell::Blend::Equation rgb_equation;
+        Maxwell::Blend::Factor src_rgb_func;
+        Maxwell::Blend::Factor dst_rgb_func;
+        Maxwell::Blend::Equation a_equation;
+        Maxwell::Blend::Factor src_a_func;
+        Maxwell::Blend::Factor dst_a_func;
+        u32 color_mask; ///< Raw Maxwell color mask.
+    };
+
+    struct ColorBlending {
+        u32 attachments_count;
+        std::array<BlendingAttachment, Maxwell::NumRenderTargets> attachments;
+    };
+
+    VertexInput vertex_input;
+    InputAssembly input_assembly;
+    Rasterizer rasterizer;
+    DepthStencil depth_stencil;
+    ColorBlending color_blending;
+
+    std::size_t Hash() const noexcept;
+
+    bool operator==(const FixedPipelineState& rhs) const noexcept;
+
+    bool operator!=(const FixedPipelineState& rhs) const noexcept {
+        return !operator==(rhs);
+    }
+};
+static_assert(std::is_trivially_copyable_v<FixedPipelineState>);
+static_assert(std::has_unique_object_representations_v<FixedPipelineState>);
+
+/// Packs the fixed function state of the current Maxwell registers.
+FixedPipelineState GetFixedPipelineState(const Maxwell& regs);
+
+} // namespace Vulkan
+
+namespace std {
+
+template <>
+struct hash<Vulkan::FixedPipelineState> {
+    std::size_t operator()(const Vulkan::FixedPipelineState& k) const noexcept {
+        return k.Hash();
+    }
+};
+
+} // namespace std
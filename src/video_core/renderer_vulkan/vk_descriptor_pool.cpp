@@ -0,0 +1,83 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/renderer_vulkan/declarations.h"
+#include "video_core/renderer_vulkan/vk_descriptor_pool.h"
+#include "video_core/renderer_vulkan/vk_device.h"
+#include "video_core/renderer_vulkan/vk_resource_manager.h"
+
+namespace Vulkan {
+
+namespace {
+
+/// Number of sets allocated at once when an allocator runs out of free sets.
+constexpr std::size_t SETS_GROW_STEP = 0x20;
+
+/// Number of sets a single descriptor pool can hold.
+constexpr u32 SETS_PER_POOL = 0x10000;
+
+} // Anonymous namespace
+
+DescriptorAllocator::DescriptorAllocator(VKDescriptorPool& descriptor_pool,
+                                         vk::DescriptorSetLayout layout)
+    : VKFencedPool{SETS_GROW_STEP}, descriptor_pool{descriptor_pool}, layout{layout} {}
+
+DescriptorAllocator::~DescriptorAllocator() = default;
+
+vk::DescriptorSet DescriptorAllocator::Commit(VKFence& fence) {
+    const std::size_t index = CommitResource(fence);
+    return descriptor_sets[index / SETS_GROW_STEP][index % SETS_GROW_STEP];
+}
+
+void DescriptorAllocator::Allocate(std::size_t begin, std::size_t end) {
+    descriptor_sets.push_back(descriptor_pool.AllocateDescriptors(layout, end - begin));
+}
+
+VKDescriptorPool::VKDescriptorPool(const VKDevice& device)
+    : device{device}, active_pool{AllocateNewPool()} {}
+
+VKDescriptorPool::~VKDescriptorPool() = default;
+
+vk::DescriptorPool VKDescriptorPool::AllocateNewPool() {
+    // Average number of descriptors of each type per set, a new pool is created when any of them
+    // runs out.
+    static constexpr std::array<vk::DescriptorPoolSize, 3> pool_sizes{{
+        {vk::DescriptorType::eUniformBuffer, SETS_PER_POOL * 90},
+        {vk::DescriptorType::eStorageBuffer, SETS_PER_POOL * 60},
+        {vk::DescriptorType::eCombinedImageSampler, SETS_PER_POOL * 64},
+    }};
+    const vk::DescriptorPoolCreateInfo pool_ci({}, SETS_PER_POOL,
+                                               static_cast<u32>(pool_sizes.size()),
+                                               pool_sizes.data());
+    const auto dev = device.GetLogical();
+    return *pools.emplace_back(
+        dev.createDescriptorPoolUnique(pool_ci, nullptr, device.GetDispatchLoader()));
+}
+
+std::vector<vk::DescriptorSet> VKDescriptorPool::AllocateDescriptors(
+    vk::DescriptorSetLayout layout, std::size_t count) {
+    const std::vector layouts(count, layout);
+    vk::DescriptorSetAllocateInfo allocate_info(active_pool, static_cast<u32>(count),
+                                                layouts.data());
+    std::vector<vk::DescriptorSet> sets(count);
+
+    const auto dev = device.GetLogical();
+    const auto& dld = device.GetDispatchLoader();
+    vk::Result result = dev.allocateDescriptorSets(&allocate_info, sets.data(), dld);
+    if (result == vk::Result::eErrorOutOfPoolMemory ||
+        result == vk::Result::eErrorFragmentedPool) {
+        allocate_info.descriptorPool = active_pool = AllocateNewPool();
+        result = dev.allocateDescriptorSets(&allocate_info, sets.data(), dld);
+    }
+    if (result != vk::Result::eSuccess) {
+        vk::throwResultException(result, "vk::Device::allocateDescriptorSets");
+    }
+    return sets;
+}
+
+} // namespace Vulkan
@@ -0,0 +1,68 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/renderer_vulkan/declarations.h"
+#include "video_core/renderer_vulkan/vk_resource_manager.h"
+
+namespace Vulkan {
+
+class VKDescriptorPool;
+class VKDevice;
+
+/**
+ * Hands out descriptor sets of a single layout. Sets are protected by the fence they are
+ * committed with and reused once it's signaled, so each draw takes a set without allocating.
+ */
+class DescriptorAllocator final : public VKFencedPool {
+public:
+    explicit DescriptorAllocator(VKDescriptorPool& descriptor_pool,
+                                 vk::DescriptorSetLayout layout);
+    ~DescriptorAllocator() override;
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    /// Commits a descriptor set that is free to be updated and protects it with a fence.
+    vk::DescriptorSet Commit(VKFence& fence);
+
+protected:
+    void Allocate(std::size_t begin, std::size_t end) override;
+
+private:
+    VKDescriptorPool& descriptor_pool;
+    const vk::DescriptorSetLayout layout;
+
+    std::vector<std::vector<vk::DescriptorSet>> descriptor_sets;
+};
+
+/// Owns the descriptor pools the sets of every allocator come from. Sets are never freed back to
+/// the pools, they live as long as the descriptor pool does.
+class VKDescriptorPool final {
+    friend DescriptorAllocator;
+
+public:
+    explicit VKDescriptorPool(const VKDevice& device);
+    ~VKDescriptorPool();
+
+private:
+    /// Creates a new pool and makes it the one sets are allocated from.
+    vk::DescriptorPool AllocateNewPool();
+
+    /// Allocates count sets of the given layout, creating a new pool if the active one ran out.
+    std::vector<vk::DescriptorSet> AllocateDescriptors(vk::DescriptorSetLayout layout,
+                                                       std::size_t count);
+
+    const VKDevice& device;
+
+    std::vector<UniqueDescriptorPool> pools;
+    vk::DescriptorPool active_pool;
+};
+
+} // namespace Vulkan
@@ -30,6 +30,9 @@ T GetFeatures(vk::PhysicalDevice physical, vk::DispatchLoaderDynamic dldi) {
     return extension_features;
 }
 
+/// Number of threads of the warps of the guest GPU.
+constexpr u32 GuestWarpSize = 32;
+
 } // Anonymous namespace
 
 namespace Alternatives {
@@ -148,6 +151,7 @@ bool VKDevice::Create(const vk::DispatchLoaderDynamic& dldi, vk::Instance instan
 
     graphics_queue = logical->getQueue(graphics_family, 0, dld);
     present_queue = logical->getQueue(present_family, 0, dld);
+    transfer_queue = logical->getQueue(transfer_family, 0, dld);
     return true;
 }
 
@@ -299,7 +303,7 @@ bool VKDevice::IsSuitable(const vk::DispatchLoaderDynamic& dldi, vk::PhysicalDev
 
 std::vector<const char*> VKDevice::LoadExtensions(const vk::DispatchLoaderDynamic& dldi) {
     std::vector<const char*> extensions;
-    extensions.reserve(7);
+    extensions.reserve(9);
     extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
     extensions.push_back(VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME);
 
@@ -318,12 +322,26 @@ std::vector<const char*> VKDevice::LoadExtensions(const vk::DispatchLoaderDynami
     };
 
     bool khr_shader_float16_int8{};
+    bool ext_shader_subgroup_ballot{};
+    bool ext_shader_subgroup_vote{};
     for (const auto& extension : physical.enumerateDeviceExtensionProperties(nullptr, dldi)) {
         Test(extension, khr_uniform_buffer_standard_layout,
              VK_KHR_UNIFORM_BUFFER_STANDARD_LAYOUT_EXTENSION_NAME, true);
         Test(extension, ext_index_type_uint8, VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME, true);
         Test(extension, khr_driver_properties, VK_KHR_DRIVER_PROPERTIES_EXTENSION_NAME, true);
         Test(extension, khr_shader_float16_int8, VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME, false);
+        Test(extension, ext_shader_subgroup_ballot, VK_EXT_SHADER_SUBGROUP_BALLOT_EXTENSION_NAME,
+             false);
+        Test(extension, ext_shader_subgroup_vote, VK_EXT_SHADER_SUBGROUP_VOTE_EXTENSION_NAME,
+             false);
+    }
+
+    // Narrower subgroups can't hold a warp of the guest, the decompiler stubs the intrinsics then
+    is_warp_intrinsics_supported =
+        ext_shader_subgroup_ballot && ext_shader_subgroup_vote && subgroup_size >= GuestWarpSize;
+    if (is_warp_intrinsics_supported) {
+        extensions.push_back(VK_EXT_SHADER_SUBGROUP_BALLOT_EXTENSION_NAME);
+        extensions.push_back(VK_EXT_SHADER_SUBGROUP_VOTE_EXTENSION_NAME);
     }
 
     if (khr_shader_float16_int8) {
@@ -356,6 +374,21 @@ void VKDevice::SetupFamilies(const vk::DispatchLoaderDynamic& dldi, vk::SurfaceK
 
     graphics_family = *graphics_family_;
     present_family = *present_family_;
+
+    // Families that only transfer are usually backed by DMA engines that run in parallel with the
+    // graphics queue
+    transfer_family = graphics_family;
+    for (u32 i = 0; i < static_cast<u32>(queue_family_properties.size()); ++i) {
+        const auto& queue_family = queue_family_properties[i];
+        const auto flags = queue_family.queueFlags;
+        if (queue_family.queueCount == 0 || !(flags & vk::QueueFlagBits::eTransfer) ||
+            (flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))) {
+            continue;
+        }
+        transfer_family = i;
+        LOG_INFO(Render_Vulkan, "Using dedicated transfer queue family {}", i);
+        break;
+    }
 }
 
 void VKDevice::SetupProperties(const vk::DispatchLoaderDynamic& dldi) {
@@ -364,6 +397,13 @@ void VKDevice::SetupProperties(const vk::DispatchLoaderDynamic& dldi) {
     uniform_buffer_alignment = static_cast<u64>(props.limits.minUniformBufferOffsetAlignment);
     storage_buffer_alignment = static_cast<u64>(props.limits.minStorageBufferOffsetAlignment);
     max_storage_buffer_range = static_cast<u64>(props.limits.maxStorageBufferRange);
+
+    vk::PhysicalDeviceSubgroupProperties subgroup_properties;
+    vk::PhysicalDeviceProperties2 properties2;
+    properties2.pNext = &subgroup_properties;
+    physical.getProperties2(&properties2, dldi);
+    subgroup_size = subgroup_properties.subgroupSize;
+    is_warp_potentially_bigger = subgroup_size > GuestWarpSize;
 }
 
 void VKDevice::SetupFeatures(const vk::DispatchLoaderDynamic& dldi) {
@@ -374,7 +414,7 @@ void VKDevice::SetupFeatures(const vk::DispatchLoaderDynamic& dldi) {
 std::vector<vk::DeviceQueueCreateInfo> VKDevice::GetDeviceQueueCreateInfos() const {
     static const float QUEUE_PRIORITY = 1.0f;
 
-    std::set<u32> unique_queue_families = {graphics_family, present_family};
+    std::set<u32> unique_queue_families = {graphics_family, present_family, transfer_family};
     std::vector<vk::DeviceQueueCreateInfo> queue_cis;
 
     for (u32 queue_family : unique_queue_families)
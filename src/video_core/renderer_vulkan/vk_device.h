@@ -59,6 +59,11 @@ public:
         return present_queue;
     }
 
+    /// Returns the transfer queue, the graphics queue when there's no dedicated one.
+    vk::Queue GetTransferQueue() const {
+        return transfer_queue;
+    }
+
     /// Returns main graphics queue family index.
     u32 GetGraphicsFamily() const {
         return graphics_family;
@@ -69,6 +74,17 @@ public:
         return present_family;
     }
 
+    /// Returns the transfer queue family index, the graphics one when there's no dedicated queue.
+    u32 GetTransferFamily() const {
+        return transfer_family;
+    }
+
+    /// Returns true if the device has a queue family specialized in transfers, so uploads can run
+    /// in parallel with the graphics queue.
+    bool HasDedicatedTransferQueue() const {
+        return transfer_family != graphics_family;
+    }
+
     /// Returns true if the device is integrated with the host CPU.
     bool IsIntegrated() const {
         return device_type == vk::PhysicalDeviceType::eIntegratedGpu;
@@ -114,6 +130,17 @@ public:
         return ext_index_type_uint8;
     }
 
+    /// Returns true if the subgroup ballot and vote extensions can implement the warp intrinsics
+    /// of the guest, with subgroups at least as wide as its warps.
+    bool IsWarpIntrinsicsSupported() const {
+        return is_warp_intrinsics_supported;
+    }
+
+    /// Returns true if subgroups are wider than the warps of the guest, spanning several of them.
+    bool IsWarpSizePotentiallyBiggerThanGuest() const {
+        return is_warp_potentially_bigger;
+    }
+
     /// Checks if the physical device is suitable.
     static bool IsSuitable(const vk::DispatchLoaderDynamic& dldi, vk::PhysicalDevice physical,
                            vk::SurfaceKHR surface);
@@ -151,8 +178,10 @@ private:
     UniqueDevice logical;                      ///< Logical device.
     vk::Queue graphics_queue;                  ///< Main graphics queue.
     vk::Queue present_queue;                   ///< Main present queue.
+    vk::Queue transfer_queue;                  ///< Transfer queue.
     u32 graphics_family{};                     ///< Main graphics queue family index.
     u32 present_family{};                      ///< Main present queue family index.
+    u32 transfer_family{};                     ///< Transfer queue family index.
     vk::PhysicalDeviceType device_type;        ///< Physical device type.
     vk::DriverIdKHR driver_id{};               ///< Driver ID.
     u64 uniform_buffer_alignment{};            ///< Uniform buffer alignment requeriment.
@@ -163,6 +192,9 @@ private:
     bool khr_uniform_buffer_standard_layout{}; ///< Support for std430 on UBOs.
     bool ext_index_type_uint8{};               ///< Support for VK_EXT_index_type_uint8.
     bool khr_driver_properties{};              ///< Support for VK_KHR_driver_properties.
+    bool is_warp_intrinsics_supported{};       ///< Support for the guest's warp intrinsics.
+    bool is_warp_potentially_bigger{};         ///< Host subgroups are wider than guest warps.
+    u32 subgroup_size{};                       ///< Size of the subgroups of the device.
     std::unordered_map<vk::Format, vk::FormatProperties>
         format_properties; ///< Format properties dictionary.
 };
@@ -3,11 +3,13 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <optional>
 #include <tuple>
+#include <unordered_set>
 #include <vector>
-#include "common/alignment.h"
 #include "common/assert.h"
+#include "common/bit_util.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "video_core/renderer_vulkan/declarations.h"
@@ -19,18 +21,33 @@ namespace Vulkan {
 // TODO(Rodrigo): Fine tune this number
 constexpr u64 ALLOC_CHUNK_SIZE = 64 * 1024 * 1024;
 
+/// Commits of this size or larger get an allocation of their own instead of a block of a chunk.
+constexpr u64 DEDICATED_COMMIT_SIZE = 16 * 1024 * 1024;
+
+/// Log2 of the size of the smallest and largest blocks chunks are split in.
+constexpr u32 MIN_BLOCK_ORDER = 8;
+constexpr u32 MAX_BLOCK_ORDER = 26;
+constexpr u32 NUM_BLOCK_ORDERS = MAX_BLOCK_ORDER - MIN_BLOCK_ORDER + 1;
+static_assert(ALLOC_CHUNK_SIZE == u64{1} << MAX_BLOCK_ORDER);
+
 class VKMemoryAllocation final {
 public:
-    explicit VKMemoryAllocation(const VKDevice& device, vk::DeviceMemory memory,
-                                vk::MemoryPropertyFlags properties, u64 alloc_size, u32 type)
-        : device{device}, memory{memory}, properties{properties}, alloc_size{alloc_size},
-          shifted_type{ShiftType(type)}, is_mappable{properties &
-                                                     vk::MemoryPropertyFlagBits::eHostVisible} {
+    explicit VKMemoryAllocation(VKMemoryManager& manager, const VKDevice& device,
+                                vk::DeviceMemory memory, vk::MemoryPropertyFlags properties,
+                                u64 alloc_size, u32 type, bool is_dedicated)
+        : manager{manager}, device{device}, memory{memory}, properties{properties},
+          alloc_size{alloc_size}, shifted_type{ShiftType(type)},
+          is_mappable{properties & vk::MemoryPropertyFlagBits::eHostVisible},
+          is_dedicated{is_dedicated} {
         if (is_mappable) {
             const auto dev = device.GetLogical();
             const auto& dld = device.GetDispatchLoader();
             base_address = static_cast<u8*>(dev.mapMemory(memory, 0, alloc_size, {}, dld));
         }
+        if (!is_dedicated) {
+            ASSERT(alloc_size == ALLOC_CHUNK_SIZE);
+            InsertFreeBlock(MAX_BLOCK_ORDER, 0);
+        }
     }
 
     ~VKMemoryAllocation() {
@@ -42,93 +59,138 @@ public:
     }
 
     VKMemoryCommit Commit(vk::DeviceSize commit_size, vk::DeviceSize alignment) {
-        auto found = TryFindFreeSection(free_iterator, alloc_size, static_cast<u64>(commit_size),
-                                        static_cast<u64>(alignment));
-        if (!found) {
-            found = TryFindFreeSection(0, free_iterator, static_cast<u64>(commit_size),
-                                       static_cast<u64>(alignment));
-            if (!found) {
-                // Signal out of memory, it'll try to do more allocations.
-                return nullptr;
-            }
+        const u64 size = static_cast<u64>(commit_size);
+        if (is_dedicated) {
+            ASSERT(num_commits == 0 && size <= alloc_size);
+            return MakeCommit(0, size, 0, alloc_size);
         }
-        u8* address = is_mappable ? base_address + *found : nullptr;
-        auto commit = std::make_unique<VKMemoryCommitImpl>(this, memory, address, *found,
-                                                           *found + commit_size);
-        commits.push_back(commit.get());
 
-        // Last commit's address is highly probable to be free.
-        free_iterator = *found + commit_size;
-
-        return commit;
+        // Blocks are aligned to their size, so the alignment is met rounding up to it
+        const u32 order = std::max({Common::Log2Ceil64(std::max<u64>(size, 1)),
+                                    Common::Log2Ceil64(std::max<u64>(alignment, 1)),
+                                    MIN_BLOCK_ORDER});
+        if (order > MAX_BLOCK_ORDER) {
+            return nullptr;
+        }
+        const auto offset = TakeFreeBlock(order);
+        if (!offset) {
+            // Signal out of memory, it'll try to do more allocations.
+            return nullptr;
+        }
+        return MakeCommit(*offset, size, order, u64{1} << order);
     }
 
     void Free(const VKMemoryCommitImpl* commit) {
         ASSERT(commit);
-        const auto it =
-            std::find_if(commits.begin(), commits.end(),
-                         [&](const auto& stored_commit) { return stored_commit == commit; });
-        if (it == commits.end()) {
-            LOG_CRITICAL(Render_Vulkan, "Freeing unallocated commit!");
-            UNREACHABLE();
+        ASSERT_MSG(num_commits > 0, "Freeing unallocated commit!");
+        --num_commits;
+
+        const auto [begin, end] = commit->interval;
+        const u64 block_size = is_dedicated ? alloc_size : u64{1} << commit->block_order;
+        VKMemoryStats& stats = manager.stats;
+        stats.committed_bytes -= end - begin;
+        stats.wasted_bytes -= block_size - (end - begin);
+
+        if (is_dedicated) {
+            // This destroys the allocation, nothing can be accessed after this call
+            manager.ReleaseAllocation(this);
             return;
         }
-        commits.erase(it);
+        FreeBlock(commit->block_order, begin);
     }
 
     /// Returns whether this allocation is compatible with the arguments.
     bool IsCompatible(vk::MemoryPropertyFlags wanted_properties, u32 type_mask) const {
-        return (wanted_properties & properties) != vk::MemoryPropertyFlagBits(0) &&
+        return !is_dedicated && (wanted_properties & properties) != vk::MemoryPropertyFlagBits(0) &&
                (type_mask & shifted_type) != 0;
     }
 
+    /// Returns the size in bytes of the device memory of this allocation.
+    u64 GetSize() const {
+        return alloc_size;
+    }
+
 private:
     static constexpr u32 ShiftType(u32 type) {
         return 1U << type;
     }
 
-    /// A memory allocator, it may return a free region between "start" and "end" with the solicited
-    /// requeriments.
-    std::optional<u64> TryFindFreeSection(u64 start, u64 end, u64 size, u64 alignment) const {
-        u64 iterator = start;
-        while (iterator + size < end) {
-            const u64 try_left = Common::AlignUp(iterator, alignment);
-            const u64 try_right = try_left + size;
-
-            bool overlap = false;
-            for (const auto& commit : commits) {
-                const auto [commit_left, commit_right] = commit->interval;
-                if (try_left < commit_right && commit_left < try_right) {
-                    // There's an overlap, continue the search where the overlapping commit ends.
-                    iterator = commit_right;
-                    overlap = true;
-                    break;
-                }
+    VKMemoryCommit MakeCommit(u64 offset, u64 size, u32 order, u64 block_size) {
+        u8* address = is_mappable ? base_address + offset : nullptr;
+        ++num_commits;
+        VKMemoryStats& stats = manager.stats;
+        stats.committed_bytes += size;
+        stats.wasted_bytes += block_size - size;
+        return std::make_unique<VKMemoryCommitImpl>(this, memory, address, offset, offset + size,
+                                                    order);
+    }
+
+    /// Takes a free block of the given order, splitting a larger one if needed. Buddy allocator.
+    std::optional<u64> TakeFreeBlock(u32 order) {
+        // Orders with free blocks are kept in a mask, so the smallest fitting one is a bit scan
+        const u32 candidates = free_orders >> (order - MIN_BLOCK_ORDER);
+        if (candidates == 0) {
+            return std::nullopt;
+        }
+        u32 found_order = order + Common::CountTrailingZeroes32(candidates);
+        auto& free_set = free_blocks[found_order - MIN_BLOCK_ORDER];
+        const auto it = free_set.begin();
+        const u64 offset = *it;
+        free_set.erase(it);
+        if (free_set.empty()) {
+            free_orders &= ~(1U << (found_order - MIN_BLOCK_ORDER));
+        }
+
+        // Return the upper halves of the block to the free lists until it has the wanted size
+        while (found_order > order) {
+            --found_order;
+            InsertFreeBlock(found_order, offset + (u64{1} << found_order));
+        }
+        return offset;
+    }
+
+    /// Returns a block to the free lists, merging it with its buddy while it's free.
+    void FreeBlock(u32 order, u64 offset) {
+        while (order < MAX_BLOCK_ORDER) {
+            const u64 buddy = offset ^ (u64{1} << order);
+            auto& free_set = free_blocks[order - MIN_BLOCK_ORDER];
+            if (free_set.erase(buddy) == 0) {
+                break;
             }
-            if (!overlap) {
-                // A free address has been found.
-                return try_left;
+            if (free_set.empty()) {
+                free_orders &= ~(1U << (order - MIN_BLOCK_ORDER));
             }
+            offset = std::min(offset, buddy);
+            ++order;
         }
-        // No free regions where found, return an empty optional.
-        return std::nullopt;
+        InsertFreeBlock(order, offset);
+    }
+
+    void InsertFreeBlock(u32 order, u64 offset) {
+        free_blocks[order - MIN_BLOCK_ORDER].insert(offset);
+        free_orders |= 1U << (order - MIN_BLOCK_ORDER);
     }
 
+    VKMemoryManager& manager;                 ///< Memory manager owning this allocation.
     const VKDevice& device;                   ///< Vulkan device.
     const vk::DeviceMemory memory;            ///< Vulkan memory allocation handler.
     const vk::MemoryPropertyFlags properties; ///< Vulkan properties.
     const u64 alloc_size;                     ///< Size of this allocation.
     const u32 shifted_type;                   ///< Stored Vulkan type of this allocation, shifted.
     const bool is_mappable;                   ///< Whether the allocation is mappable.
+    const bool is_dedicated;                  ///< Whether the allocation holds a single commit.
 
     /// Base address of the mapped pointer.
     u8* base_address{};
 
-    /// Hints where the next free region is likely going to be.
-    u64 free_iterator{};
+    /// Offsets of the free blocks of each order.
+    std::array<std::unordered_set<u64>, NUM_BLOCK_ORDERS> free_blocks;
+
+    /// Mask of the orders with free blocks, the lowest bit is MIN_BLOCK_ORDER.
+    u32 free_orders{};
 
-    /// Stores all commits done from this allocation.
-    std::vector<const VKMemoryCommitImpl*> commits;
+    /// Number of live commits done from this allocation.
+    std::size_t num_commits{};
 };
 
 VKMemoryManager::VKMemoryManager(const VKDevice& device)
@@ -138,8 +200,6 @@ VKMemoryManager::VKMemoryManager(const VKDevice& device)
 VKMemoryManager::~VKMemoryManager() = default;
 
 VKMemoryCommit VKMemoryManager::Commit(const vk::MemoryRequirements& reqs, bool host_visible) {
-    ASSERT(reqs.size < ALLOC_CHUNK_SIZE);
-
     // When a host visible commit is asked, search for host visible and coherent, otherwise search
     // for a fast device local type.
     const vk::MemoryPropertyFlags wanted_properties =
@@ -147,6 +207,18 @@ VKMemoryCommit VKMemoryManager::Commit(const vk::MemoryRequirements& reqs, bool
             ? vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
             : vk::MemoryPropertyFlagBits::eDeviceLocal;
 
+    if (reqs.size >= DEDICATED_COMMIT_SIZE) {
+        // Large commits (usually images) would split chunks in blocks they can't fill
+        VKMemoryAllocation* const alloc =
+            AllocMemory(wanted_properties, reqs.memoryTypeBits, reqs.size, true);
+        if (!alloc) {
+            LOG_CRITICAL(Render_Vulkan, "Ran out of memory!");
+            UNREACHABLE();
+            return {};
+        }
+        return alloc->Commit(reqs.size, reqs.alignment);
+    }
+
     const auto TryCommit = [&]() -> VKMemoryCommit {
         for (auto& alloc : allocs) {
             if (!alloc->IsCompatible(wanted_properties, reqs.memoryTypeBits))
@@ -164,7 +236,7 @@ VKMemoryCommit VKMemoryManager::Commit(const vk::MemoryRequirements& reqs, bool
     }
 
     // Commit has failed, allocate more memory.
-    if (!AllocMemory(wanted_properties, reqs.memoryTypeBits, ALLOC_CHUNK_SIZE)) {
+    if (!AllocMemory(wanted_properties, reqs.memoryTypeBits, ALLOC_CHUNK_SIZE, false)) {
         // TODO(Rodrigo): Try to use host memory.
         LOG_CRITICAL(Render_Vulkan, "Ran out of memory!");
         UNREACHABLE();
@@ -195,8 +267,8 @@ VKMemoryCommit VKMemoryManager::Commit(vk::Image image, bool host_visible) {
     return commit;
 }
 
-bool VKMemoryManager::AllocMemory(vk::MemoryPropertyFlags wanted_properties, u32 type_mask,
-                                  u64 size) {
+VKMemoryAllocation* VKMemoryManager::AllocMemory(vk::MemoryPropertyFlags wanted_properties,
+                                                 u32 type_mask, u64 size, bool is_dedicated) {
     const u32 type = [&]() {
         for (u32 type_index = 0; type_index < props.memoryTypeCount; ++type_index) {
             const auto flags = props.memoryTypes[type_index].propertyFlags;
@@ -219,11 +291,32 @@ bool VKMemoryManager::AllocMemory(vk::MemoryPropertyFlags wanted_properties, u32
     if (const vk::Result res = dev.allocateMemory(&memory_ai, nullptr, &memory, dld);
         res != vk::Result::eSuccess) {
         LOG_CRITICAL(Render_Vulkan, "Device allocation failed with code {}!", vk::to_string(res));
-        return false;
+        return nullptr;
     }
-    allocs.push_back(
-        std::make_unique<VKMemoryAllocation>(device, memory, wanted_properties, size, type));
-    return true;
+    allocs.push_back(std::make_unique<VKMemoryAllocation>(*this, device, memory, wanted_properties,
+                                                          size, type, is_dedicated));
+    stats.allocated_bytes += size;
+    ++stats.num_allocations;
+    if (is_dedicated) {
+        ++stats.num_dedicated;
+    }
+    LOG_DEBUG(Render_Vulkan,
+              "Allocated {} bytes, {} allocations hold {} bytes with {} committed and {} wasted",
+              size, stats.num_allocations, stats.allocated_bytes, stats.committed_bytes,
+              stats.wasted_bytes);
+    return allocs.back().get();
+}
+
+void VKMemoryManager::ReleaseAllocation(const VKMemoryAllocation* allocation) {
+    const auto it = std::find_if(allocs.begin(), allocs.end(), [allocation](const auto& alloc) {
+        return alloc.get() == allocation;
+    });
+    ASSERT(it != allocs.end());
+    std::unique_ptr<VKMemoryAllocation> released = std::move(*it);
+    allocs.erase(it);
+    stats.allocated_bytes -= released->GetSize();
+    --stats.num_allocations;
+    --stats.num_dedicated;
 }
 
 /*static*/ bool VKMemoryManager::GetMemoryUnified(const vk::PhysicalDeviceMemoryProperties& props) {
@@ -237,8 +330,9 @@ bool VKMemoryManager::AllocMemory(vk::MemoryPropertyFlags wanted_properties, u32
 }
 
 VKMemoryCommitImpl::VKMemoryCommitImpl(VKMemoryAllocation* allocation, vk::DeviceMemory memory,
-                                       u8* data, u64 begin, u64 end)
-    : interval(std::make_pair(begin, end)), memory{memory}, allocation{allocation}, data{data} {}
+                                       u8* data, u64 begin, u64 end, u32 block_order)
+    : interval(std::make_pair(begin, end)), memory{memory}, allocation{allocation}, data{data},
+      block_order{block_order} {}
 
 VKMemoryCommitImpl::~VKMemoryCommitImpl() {
     allocation->Free(this);
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -18,7 +19,18 @@ class VKMemoryCommitImpl;
 
 using VKMemoryCommit = std::unique_ptr<VKMemoryCommitImpl>;
 
+/// Usage statistics of the device memory handled by a memory manager.
+struct VKMemoryStats {
+    u64 committed_bytes = 0;         ///< Bytes requested by the live commits.
+    u64 wasted_bytes = 0;            ///< Bytes lost rounding the live commits up to their blocks.
+    u64 allocated_bytes = 0;         ///< Bytes of device memory allocated.
+    std::size_t num_allocations = 0; ///< Number of device memory allocations.
+    std::size_t num_dedicated = 0;   ///< Number of allocations dedicated to a single commit.
+};
+
 class VKMemoryManager final {
+    friend VKMemoryAllocation;
+
 public:
     explicit VKMemoryManager(const VKDevice& device);
     ~VKMemoryManager();
@@ -43,9 +55,19 @@ public:
         return is_memory_unified;
     }
 
+    /// Returns the usage statistics of the device memory.
+    const VKMemoryStats& GetStats() const {
+        return stats;
+    }
+
 private:
-    /// Allocates a chunk of memory.
-    bool AllocMemory(vk::MemoryPropertyFlags wanted_properties, u32 type_mask, u64 size);
+    /// Allocates a chunk of memory, dedicated allocations hold a single commit.
+    /// @returns The new allocation or null on failure.
+    VKMemoryAllocation* AllocMemory(vk::MemoryPropertyFlags wanted_properties, u32 type_mask,
+                                    u64 size, bool is_dedicated);
+
+    /// Frees an allocation, called by dedicated allocations when their commit is released.
+    void ReleaseAllocation(const VKMemoryAllocation* allocation);
 
     /// Returns true if the device uses an unified memory model.
     static bool GetMemoryUnified(const vk::PhysicalDeviceMemoryProperties& props);
@@ -54,6 +76,7 @@ private:
     const vk::PhysicalDeviceMemoryProperties props;          ///< Physical device properties.
     const bool is_memory_unified;                            ///< True if memory model is unified.
     std::vector<std::unique_ptr<VKMemoryAllocation>> allocs; ///< Current allocations.
+    VKMemoryStats stats;                                     ///< Memory usage statistics.
 };
 
 class VKMemoryCommitImpl final {
@@ -61,7 +84,7 @@ class VKMemoryCommitImpl final {
 
 public:
     explicit VKMemoryCommitImpl(VKMemoryAllocation* allocation, vk::DeviceMemory memory, u8* data,
-                                u64 begin, u64 end);
+                                u64 begin, u64 end, u32 block_order);
     ~VKMemoryCommitImpl();
 
     /// Returns the writeable memory map. The commit has to be mappable.
@@ -82,6 +105,7 @@ private:
     vk::DeviceMemory memory;          ///< Vulkan device memory handler.
     VKMemoryAllocation* allocation{}; ///< Pointer to the large memory allocation.
     u8* data{}; ///< Pointer to the host mapped memory, it has the commit offset included.
+    u32 block_order{};                ///< Log2 of the size of the block holding the commit.
 };
 
 } // namespace Vulkan
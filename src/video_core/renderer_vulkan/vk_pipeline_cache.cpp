@@ -0,0 +1,476 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "common/assert.h"
+#include "common/common_paths.h"
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "common/zstd_compression.h"
+#include "core/core.h"
+#include "core/hle/kernel/process.h"
+#include "core/settings.h"
+#include "video_core/renderer_vulkan/declarations.h"
+#include "video_core/renderer_vulkan/vk_device.h"
+#include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+
+namespace Vulkan {
+
+namespace {
+
+enum class TransferableEntryKind : u32 {
+    Shader,
+    GraphicsPipeline,
+};
+
+constexpr u32 NativeVersion = 1;
+
+/// Reads the contents of the decompressed precompiled cache in order.
+class PrecompiledReader {
+public:
+    explicit PrecompiledReader(const std::vector<u8>& contents) : contents{contents} {}
+
+    template <typename T>
+    bool ReadArray(T* data, std::size_t length) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const std::size_t num_bytes = length * sizeof(T);
+        if (contents.size() - offset < num_bytes) {
+            return false;
+        }
+        std::memcpy(data, contents.data() + offset, num_bytes);
+        offset += num_bytes;
+        return true;
+    }
+
+    template <typename T>
+    bool ReadObject(T& object) {
+        return ReadArray(&object, 1);
+    }
+
+    bool IsAtEnd() const {
+        return offset == contents.size();
+    }
+
+private:
+    const std::vector<u8>& contents;
+    std::size_t offset = 0;
+};
+
+template <typename T>
+void WriteArray(std::vector<u8>& contents, const T* data, std::size_t length) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto bytes = reinterpret_cast<const u8*>(data);
+    contents.insert(contents.end(), bytes, bytes + length * sizeof(T));
+}
+
+template <typename T>
+void WriteObject(std::vector<u8>& contents, const T& object) {
+    WriteArray(contents, &object, 1);
+}
+
+bool LoadShader(FileUtil::IOFile& file, PipelineCacheShader& shader) {
+    u32 program{};
+    u32 code_size{};
+    u32 code_size_b{};
+    if (file.ReadArray(&shader.unique_identifier, 1) != 1 || file.ReadArray(&program, 1) != 1 ||
+        file.ReadArray(&code_size, 1) != 1 || file.ReadArray(&code_size_b, 1) != 1) {
+        return false;
+    }
+    if (program >= static_cast<u32>(Maxwell::MaxShaderProgram)) {
+        return false;
+    }
+    shader.program = static_cast<Maxwell::ShaderProgram>(program);
+    shader.code.resize(code_size);
+    shader.code_b.resize(code_size_b);
+    return file.ReadArray(shader.code.data(), code_size) == code_size &&
+           file.ReadArray(shader.code_b.data(), code_size_b) == code_size_b;
+}
+
+bool SaveShader(FileUtil::IOFile& file, const PipelineCacheShader& shader) {
+    return file.WriteObject(TransferableEntryKind::Shader) == 1 &&
+           file.WriteObject(shader.unique_identifier) == 1 &&
+           file.WriteObject(static_cast<u32>(shader.program)) == 1 &&
+           file.WriteObject(static_cast<u32>(shader.code.size())) == 1 &&
+           file.WriteObject(static_cast<u32>(shader.code_b.size())) == 1 &&
+           file.WriteArray(shader.code.data(), shader.code.size()) == shader.code.size() &&
+           file.WriteArray(shader.code_b.data(), shader.code_b.size()) == shader.code_b.size();
+}
+
+} // Anonymous namespace
+
+std::size_t GraphicsPipelineCacheKey::Hash() const noexcept {
+    const u64 shaders_hash = Common::ComputeXXH3(shaders.data(), sizeof(shaders));
+    return fixed_state.Hash() ^ static_cast<std::size_t>(shaders_hash);
+}
+
+bool GraphicsPipelineCacheKey::operator==(const GraphicsPipelineCacheKey& rhs) const noexcept {
+    return fixed_state == rhs.fixed_state && shaders == rhs.shaders;
+}
+
+VKPipelineCache::VKPipelineCache(Core::System& system, const VKDevice& device)
+    : system{system}, device{device} {
+    const auto dev = device.GetLogical();
+    const auto& dld = device.GetDispatchLoader();
+    pipeline_cache = dev.createPipelineCacheUnique({}, nullptr, dld);
+}
+
+VKPipelineCache::~VKPipelineCache() {
+    SavePrecompiled();
+}
+
+std::optional<PipelineCacheEntries> VKPipelineCache::LoadDiskCache() {
+    std::optional<PipelineCacheEntries> entries = LoadTransferable();
+    const std::vector<u8> pipeline_data = LoadPrecompiled();
+    if (pipeline_data.empty()) {
+        return entries;
+    }
+
+    // The header was already checked against the device, recreate the cache with the stored data
+    const vk::PipelineCacheCreateInfo pipeline_cache_ci({}, pipeline_data.size(),
+                                                        pipeline_data.data());
+    const auto dev = device.GetLogical();
+    const auto& dld = device.GetDispatchLoader();
+    pipeline_cache = dev.createPipelineCacheUnique(pipeline_cache_ci, nullptr, dld);
+    return entries;
+}
+
+const std::vector<u32>* VKPipelineCache::TryGetModule(u64 unique_identifier) const {
+    const auto it = modules.find(unique_identifier);
+    return it != modules.end() ? &it->second : nullptr;
+}
+
+void VKPipelineCache::SaveShader(const PipelineCacheShader& shader) {
+    if (!is_usable || !stored_shaders.insert(shader.unique_identifier).second) {
+        return;
+    }
+    FileUtil::IOFile file = AppendTransferableFile();
+    if (!file.IsOpen()) {
+        return;
+    }
+    if (!Vulkan::SaveShader(file, shader)) {
+        LOG_ERROR(Render_Vulkan, "Failed to save shader transferable cache entry, removing");
+        file.Close();
+        InvalidateTransferable();
+    }
+}
+
+void VKPipelineCache::SaveGraphicsPipeline(const GraphicsPipelineCacheKey& key) {
+    if (!is_usable || !stored_pipelines.insert(key).second) {
+        return;
+    }
+    FileUtil::IOFile file = AppendTransferableFile();
+    if (!file.IsOpen()) {
+        return;
+    }
+    if (file.WriteObject(TransferableEntryKind::GraphicsPipeline) != 1 ||
+        file.WriteObject(key) != 1) {
+        LOG_ERROR(Render_Vulkan, "Failed to save pipeline transferable cache entry, removing");
+        file.Close();
+        InvalidateTransferable();
+    }
+}
+
+void VKPipelineCache::SaveModule(u64 unique_identifier, std::vector<u32> spirv) {
+    if (modules.emplace(unique_identifier, std::move(spirv)).second) {
+        precompiled_altered = true;
+    }
+}
+
+void VKPipelineCache::SavePrecompiled() {
+    if (!is_usable || !pipeline_cache) {
+        return;
+    }
+    // The driver pipeline cache grows with every new pipeline, write it even without new modules
+    const auto dev = device.GetLogical();
+    const auto& dld = device.GetDispatchLoader();
+    const std::vector<u8> pipeline_data = dev.getPipelineCacheData(*pipeline_cache, dld);
+    if (!precompiled_altered && pipeline_data.empty()) {
+        return;
+    }
+
+    std::vector<u8> contents = GetPrecompiledHeader();
+    WriteObject(contents, static_cast<u32>(modules.size()));
+    for (const auto& [unique_identifier, spirv] : modules) {
+        WriteObject(contents, unique_identifier);
+        WriteObject(contents, static_cast<u32>(spirv.size()));
+        WriteArray(contents, spirv.data(), spirv.size());
+    }
+    WriteObject(contents, static_cast<u64>(pipeline_data.size()));
+    WriteArray(contents, pipeline_data.data(), pipeline_data.size());
+
+    if (!EnsureDirectories()) {
+        return;
+    }
+    const std::vector<u8> compressed =
+        Common::Compression::CompressDataZSTDDefault(contents.data(), contents.size());
+    const std::string precompiled_path = GetPrecompiledPath();
+    FileUtil::IOFile file(precompiled_path, "wb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render_Vulkan, "Failed to open precompiled cache in path={}", precompiled_path);
+        return;
+    }
+    if (file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        LOG_ERROR(Render_Vulkan, "Failed to write precompiled cache in path={}", precompiled_path);
+        return;
+    }
+    precompiled_altered = false;
+}
+
+std::optional<PipelineCacheEntries> VKPipelineCache::LoadTransferable() {
+    if (!IsDiskCacheEnabled()) {
+        return {};
+    }
+
+    FileUtil::IOFile file(GetTransferablePath(), "rb");
+    if (!file.IsOpen()) {
+        LOG_INFO(Render_Vulkan, "No transferable pipeline cache found for game with title id={}",
+                 GetTitleID());
+        is_usable = true;
+        return {};
+    }
+
+    u32 version{};
+    if (file.ReadBytes(&version, sizeof(version)) != sizeof(version)) {
+        LOG_ERROR(Render_Vulkan,
+                  "Failed to get transferable cache version for title id={}, skipping",
+                  GetTitleID());
+        return {};
+    }
+    if (version < NativeVersion) {
+        LOG_INFO(Render_Vulkan, "Transferable pipeline cache is old, removing");
+        file.Close();
+        InvalidateTransferable();
+        is_usable = true;
+        return {};
+    }
+    if (version > NativeVersion) {
+        LOG_WARNING(Render_Vulkan, "Transferable pipeline cache was generated with a newer version "
+                                   "of the emulator, skipping");
+        return {};
+    }
+
+    PipelineCacheEntries entries;
+    while (file.Tell() < file.GetSize()) {
+        TransferableEntryKind kind{};
+        if (file.ReadBytes(&kind, sizeof(u32)) != sizeof(u32)) {
+            LOG_ERROR(Render_Vulkan, "Failed to read transferable file, skipping");
+            return {};
+        }
+        switch (kind) {
+        case TransferableEntryKind::Shader: {
+            PipelineCacheShader shader;
+            if (!LoadShader(file, shader)) {
+                LOG_ERROR(Render_Vulkan, "Failed to load transferable shader entry, skipping");
+                return {};
+            }
+            stored_shaders.insert(shader.unique_identifier);
+            entries.shaders.push_back(std::move(shader));
+            break;
+        }
+        case TransferableEntryKind::GraphicsPipeline: {
+            GraphicsPipelineCacheKey key;
+            if (file.ReadArray(&key, 1) != 1) {
+                LOG_ERROR(Render_Vulkan, "Failed to load transferable pipeline entry, skipping");
+                return {};
+            }
+            stored_pipelines.insert(key);
+            entries.pipelines.push_back(key);
+            break;
+        }
+        default:
+            LOG_ERROR(Render_Vulkan, "Unknown transferable pipeline cache entry kind={}, skipping",
+                      static_cast<u32>(kind));
+            return {};
+        }
+    }
+
+    is_usable = true;
+    return entries;
+}
+
+std::vector<u8> VKPipelineCache::LoadPrecompiled() {
+    if (!is_usable) {
+        return {};
+    }
+
+    FileUtil::IOFile file(GetPrecompiledPath(), "rb");
+    if (!file.IsOpen()) {
+        LOG_INFO(Render_Vulkan, "No precompiled pipeline cache found for game with title id={}",
+                 GetTitleID());
+        return {};
+    }
+    std::vector<u8> compressed(file.GetSize());
+    if (file.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        LOG_ERROR(Render_Vulkan, "Failed to read precompiled cache for title id={}", GetTitleID());
+        return {};
+    }
+    file.Close();
+
+    std::vector<u8> pipeline_data;
+    if (!ParsePrecompiled(Common::Compression::DecompressDataZSTD(compressed), pipeline_data)) {
+        LOG_INFO(Render_Vulkan,
+                 "Failed to load precompiled cache for game with title id={}, removing",
+                 GetTitleID());
+        InvalidatePrecompiled();
+        return {};
+    }
+    return pipeline_data;
+}
+
+bool VKPipelineCache::ParsePrecompiled(const std::vector<u8>& contents,
+                                       std::vector<u8>& pipeline_data) {
+    PrecompiledReader reader(contents);
+
+    const std::vector<u8> expected_header = GetPrecompiledHeader();
+    std::vector<u8> header(expected_header.size());
+    if (!reader.ReadArray(header.data(), header.size())) {
+        return false;
+    }
+    if (header != expected_header) {
+        LOG_INFO(Render_Vulkan, "Precompiled cache is from another device or emulator version");
+        return false;
+    }
+
+    u32 num_modules{};
+    if (!reader.ReadObject(num_modules)) {
+        return false;
+    }
+    std::unordered_map<u64, std::vector<u32>> loaded_modules;
+    for (u32 i = 0; i < num_modules; ++i) {
+        u64 unique_identifier{};
+        u32 num_words{};
+        if (!reader.ReadObject(unique_identifier) || !reader.ReadObject(num_words)) {
+            return false;
+        }
+        std::vector<u32> spirv(num_words);
+        if (!reader.ReadArray(spirv.data(), spirv.size())) {
+            return false;
+        }
+        loaded_modules.emplace(unique_identifier, std::move(spirv));
+    }
+
+    u64 data_size{};
+    if (!reader.ReadObject(data_size)) {
+        return false;
+    }
+    pipeline_data.resize(static_cast<std::size_t>(data_size));
+    if (!reader.ReadArray(pipeline_data.data(), pipeline_data.size()) || !reader.IsAtEnd()) {
+        return false;
+    }
+
+    modules = std::move(loaded_modules);
+    return true;
+}
+
+FileUtil::IOFile VKPipelineCache::AppendTransferableFile() const {
+    if (!EnsureDirectories()) {
+        return {};
+    }
+
+    const auto transferable_path{GetTransferablePath()};
+    const bool existed = FileUtil::Exists(transferable_path);
+
+    FileUtil::IOFile file(transferable_path, "ab");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render_Vulkan, "Failed to open transferable cache in path={}", transferable_path);
+        return {};
+    }
+    if (!existed || file.GetSize() == 0) {
+        // If the file didn't exist, write its version
+        if (file.WriteObject(NativeVersion) != 1) {
+            LOG_ERROR(Render_Vulkan, "Failed to write transferable cache version in path={}",
+                      transferable_path);
+            return {};
+        }
+    }
+    return file;
+}
+
+std::vector<u8> VKPipelineCache::GetPrecompiledHeader() const {
+    // Pipeline cache data and SPIR-V are only valid for the device and decompiler that made them
+    std::array<char, 64> version{};
+    const std::size_t length =
+        std::min(std::strlen(Common::g_shader_cache_version), version.size());
+    std::memcpy(version.data(), Common::g_shader_cache_version, length);
+
+    const auto properties = device.GetPhysical().getProperties(device.GetDispatchLoader());
+    std::vector<u8> header;
+    WriteArray(header, version.data(), version.size());
+    WriteObject(header, properties.vendorID);
+    WriteObject(header, properties.deviceID);
+    WriteObject(header, properties.driverVersion);
+    WriteArray(header, &properties.pipelineCacheUUID[0], VK_UUID_SIZE);
+    return header;
+}
+
+void VKPipelineCache::InvalidateTransferable() {
+    if (!FileUtil::Delete(GetTransferablePath())) {
+        LOG_ERROR(Render_Vulkan, "Failed to invalidate transferable file={}",
+                  GetTransferablePath());
+    }
+    stored_shaders.clear();
+    stored_pipelines.clear();
+    InvalidatePrecompiled();
+}
+
+void VKPipelineCache::InvalidatePrecompiled() {
+    modules.clear();
+    if (!FileUtil::Delete(GetPrecompiledPath())) {
+        LOG_ERROR(Render_Vulkan, "Failed to invalidate precompiled file={}", GetPrecompiledPath());
+    }
+}
+
+bool VKPipelineCache::IsDiskCacheEnabled() const {
+    // Skip games without title id
+    const bool has_title_id = system.CurrentProcess()->GetTitleID() != 0;
+    return Settings::values.use_disk_shader_cache && has_title_id;
+}
+
+bool VKPipelineCache::EnsureDirectories() const {
+    const auto CreateDir = [](const std::string& dir) {
+        if (!FileUtil::CreateDir(dir)) {
+            LOG_ERROR(Render_Vulkan, "Failed to create directory={}", dir);
+            return false;
+        }
+        return true;
+    };
+
+    return CreateDir(FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir)) &&
+           CreateDir(GetBaseDir()) && CreateDir(GetTransferableDir()) &&
+           CreateDir(GetPrecompiledDir());
+}
+
+std::string VKPipelineCache::GetTransferablePath() const {
+    return FileUtil::SanitizePath(GetTransferableDir() + DIR_SEP_CHR + GetTitleID() + ".bin");
+}
+
+std::string VKPipelineCache::GetPrecompiledPath() const {
+    return FileUtil::SanitizePath(GetPrecompiledDir() + DIR_SEP_CHR + GetTitleID() + ".bin");
+}
+
+std::string VKPipelineCache::GetTransferableDir() const {
+    return GetBaseDir() + DIR_SEP "transferable";
+}
+
+std::string VKPipelineCache::GetPrecompiledDir() const {
+    return GetBaseDir() + DIR_SEP "precompiled";
+}
+
+std::string VKPipelineCache::GetBaseDir() const {
+    return FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir) + DIR_SEP "vulkan";
+}
+
+std::string VKPipelineCache::GetTitleID() const {
+    return fmt::format("{:016X}", system.CurrentProcess()->GetTitleID());
+}
+
+} // namespace Vulkan
@@ -0,0 +1,172 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/renderer_vulkan/declarations.h"
+#include "video_core/renderer_vulkan/fixed_pipeline_state.h"
+
+namespace Core {
+class System;
+}
+
+namespace FileUtil {
+class IOFile;
+}
+
+namespace Vulkan {
+
+class VKDevice;
+
+using ProgramCode = std::vector<u64>;
+
+/**
+ * Identifies a graphics pipeline by its fixed function state and the shaders bound to it. It's
+ * written to the transferable cache as raw memory, so it must not have implicit padding.
+ */
+struct GraphicsPipelineCacheKey {
+    FixedPipelineState fixed_state;
+    u32 padding = 0; ///< Aligns the shader hashes, the fixed state has an odd number of words.
+    std::array<u64, Maxwell::MaxShaderProgram> shaders; ///< Zero for disabled stages.
+
+    std::size_t Hash() const noexcept;
+
+    bool operator==(const GraphicsPipelineCacheKey& rhs) const noexcept;
+
+    bool operator!=(const GraphicsPipelineCacheKey& rhs) const noexcept {
+        return !operator==(rhs);
+    }
+};
+static_assert(std::is_trivially_copyable_v<GraphicsPipelineCacheKey>);
+static_assert(std::has_unique_object_representations_v<GraphicsPipelineCacheKey>);
+
+} // namespace Vulkan
+
+namespace std {
+
+template <>
+struct hash<Vulkan::GraphicsPipelineCacheKey> {
+    std::size_t operator()(const Vulkan::GraphicsPipelineCacheKey& k) const noexcept {
+        return k.Hash();
+    }
+};
+
+} // namespace std
+
+namespace Vulkan {
+
+/// Guest shader code as read from GPU memory, it can be rebuilt on any host.
+struct PipelineCacheShader {
+    u64 unique_identifier{};
+    Maxwell::ShaderProgram program{};
+    ProgramCode code;
+    ProgramCode code_b; ///< Only used by VertexA programs.
+};
+
+/// Contents of the transferable pipeline cache of a title.
+struct PipelineCacheEntries {
+    std::vector<PipelineCacheShader> shaders;
+    std::vector<GraphicsPipelineCacheKey> pipelines;
+};
+
+/**
+ * Owns the driver pipeline cache and persists it to disk per title, following the split of the
+ * OpenGL shader disk cache:
+ * - The transferable cache stores guest shaders and the pipeline keys that used them. It doesn't
+ *   depend on the host, so pipelines can be rebuilt after a driver or GPU change.
+ * - The precompiled cache stores the SPIR-V modules and the VkPipelineCache data. It's only
+ *   valid for the device and emulator version that wrote it.
+ */
+class VKPipelineCache final {
+public:
+    explicit VKPipelineCache(Core::System& system, const VKDevice& device);
+    ~VKPipelineCache();
+
+    /// Loads the disk cache of the current title and creates the driver pipeline cache from it.
+    /// Returns the shaders and pipelines used in previous runs, if any.
+    std::optional<PipelineCacheEntries> LoadDiskCache();
+
+    /// Returns the SPIR-V module of a guest shader when it's known, nullptr otherwise.
+    const std::vector<u32>* TryGetModule(u64 unique_identifier) const;
+
+    /// Stores the guest code of a shader in the transferable cache.
+    void SaveShader(const PipelineCacheShader& shader);
+
+    /// Stores a pipeline key in the transferable cache.
+    void SaveGraphicsPipeline(const GraphicsPipelineCacheKey& key);
+
+    /// Stores the SPIR-V module built for a guest shader, written with the precompiled cache.
+    void SaveModule(u64 unique_identifier, std::vector<u32> spirv);
+
+    /// Writes the SPIR-V modules and the driver pipeline cache data to the precompiled cache.
+    void SavePrecompiled();
+
+    /// Returns the handle to pass when creating pipelines.
+    vk::PipelineCache GetHandle() const {
+        return *pipeline_cache;
+    }
+
+private:
+    /// Reads the transferable cache, returns an empty optional when it can't be used.
+    std::optional<PipelineCacheEntries> LoadTransferable();
+
+    /// Reads the precompiled cache, returns the driver pipeline cache data to start from.
+    std::vector<u8> LoadPrecompiled();
+
+    /// Parses the decompressed contents of the precompiled cache.
+    bool ParsePrecompiled(const std::vector<u8>& contents, std::vector<u8>& pipeline_data);
+
+    /// Opens the transferable cache for appending, writing its version when it's new.
+    FileUtil::IOFile AppendTransferableFile() const;
+
+    /// Returns the header that has to match for a precompiled cache to be loaded.
+    std::vector<u8> GetPrecompiledHeader() const;
+
+    void InvalidateTransferable();
+
+    void InvalidatePrecompiled();
+
+    /// Returns true when the disk cache can be used for the running title.
+    bool IsDiskCacheEnabled() const;
+
+    bool EnsureDirectories() const;
+
+    std::string GetTransferablePath() const;
+
+    std::string GetPrecompiledPath() const;
+
+    std::string GetTransferableDir() const;
+
+    std::string GetPrecompiledDir() const;
+
+    std::string GetBaseDir() const;
+
+    std::string GetTitleID() const;
+
+    Core::System& system;
+    const VKDevice& device;
+
+    UniquePipelineCache pipeline_cache;
+
+    std::unordered_map<u64, std::vector<u32>> modules;
+    std::unordered_set<u64> stored_shaders;
+    std::unordered_set<GraphicsPipelineCacheKey> stored_pipelines;
+
+    bool is_usable = false;           ///< The transferable cache was loaded or is new.
+    bool precompiled_altered = false; ///< New modules have to be written to disk.
+};
+
+} // namespace Vulkan
@@ -0,0 +1,114 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "common/cityhash.h"
+#include "video_core/renderer_vulkan/declarations.h"
+#include "video_core/renderer_vulkan/vk_device.h"
+#include "video_core/renderer_vulkan/vk_renderpass_cache.h"
+
+namespace Vulkan {
+
+namespace {
+
+/// Attachments stay in the general layout, the same one images are kept in outside render passes.
+vk::AttachmentDescription MakeAttachmentDescription(const RenderPassAttachment& attachment,
+                                                    bool has_stencil) {
+    return vk::AttachmentDescription(
+        {}, attachment.format, vk::SampleCountFlagBits::e1, attachment.load_op,
+        attachment.store_op, has_stencil ? attachment.load_op : vk::AttachmentLoadOp::eDontCare,
+        has_stencil ? attachment.store_op : vk::AttachmentStoreOp::eDontCare,
+        vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral);
+}
+
+bool HasStencil(vk::Format format) {
+    switch (format) {
+    case vk::Format::eS8Uint:
+    case vk::Format::eD16UnormS8Uint:
+    case vk::Format::eD24UnormS8Uint:
+    case vk::Format::eD32SfloatS8Uint:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // Anonymous namespace
+
+std::size_t RenderPassParams::Hash() const noexcept {
+    return static_cast<std::size_t>(
+        Common::CityHash64(reinterpret_cast<const char*>(this), sizeof(*this)));
+}
+
+bool RenderPassParams::operator==(const RenderPassParams& rhs) const noexcept {
+    return std::memcmp(this, &rhs, sizeof(*this)) == 0;
+}
+
+VKRenderPassCache::VKRenderPassCache(const VKDevice& device) : device{device} {}
+
+VKRenderPassCache::~VKRenderPassCache() = default;
+
+vk::RenderPass VKRenderPassCache::GetRenderPass(const RenderPassParams& params) {
+    const auto [pair, is_cache_miss] = cache.try_emplace(params);
+    auto& entry = pair->second;
+    if (is_cache_miss) {
+        entry = CreateRenderPass(params);
+    }
+    return *entry;
+}
+
+UniqueRenderPass VKRenderPassCache::CreateRenderPass(const RenderPassParams& params) const {
+    std::vector<vk::AttachmentDescription> descriptors;
+    std::vector<vk::AttachmentReference> color_references;
+    for (u32 rt = 0; rt < params.num_color_attachments; ++rt) {
+        descriptors.push_back(MakeAttachmentDescription(params.color_attachments[rt], false));
+        color_references.emplace_back(rt, vk::ImageLayout::eGeneral);
+    }
+
+    const vk::AttachmentReference zeta_reference(params.num_color_attachments,
+                                                 vk::ImageLayout::eGeneral);
+    vk::AccessFlags access;
+    vk::PipelineStageFlags stage;
+    if (params.num_color_attachments > 0) {
+        access |= vk::AccessFlagBits::eColorAttachmentRead |
+                  vk::AccessFlagBits::eColorAttachmentWrite;
+        stage |= vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    }
+    if (params.HasZeta()) {
+        descriptors.push_back(
+            MakeAttachmentDescription(params.zeta, HasStencil(params.zeta.format)));
+        access |= vk::AccessFlagBits::eDepthStencilAttachmentRead |
+                  vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+        stage |= vk::PipelineStageFlagBits::eLateFragmentTests;
+    }
+
+    const vk::SubpassDescription subpass_description(
+        {}, vk::PipelineBindPoint::eGraphics, 0, nullptr,
+        static_cast<u32>(color_references.size()), color_references.data(), nullptr,
+        params.HasZeta() ? &zeta_reference : nullptr, 0, nullptr);
+
+    // Transfers and previous passes writing to the attachments have to finish before this one
+    // loads them
+    const vk::SubpassDependency dependency(
+        VK_SUBPASS_EXTERNAL, 0,
+        vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eColorAttachmentOutput |
+            vk::PipelineStageFlagBits::eLateFragmentTests,
+        stage,
+        vk::AccessFlagBits::eTransferWrite | vk::AccessFlagBits::eColorAttachmentWrite |
+            vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+        access, {});
+
+    const vk::RenderPassCreateInfo create_info({}, static_cast<u32>(descriptors.size()),
+                                               descriptors.data(), 1, &subpass_description, 1,
+                                               &dependency);
+
+    const auto dev = device.GetLogical();
+    const auto& dld = device.GetDispatchLoader();
+    return dev.createRenderPassUnique(create_info, nullptr, dld);
+}
+
+} // namespace Vulkan
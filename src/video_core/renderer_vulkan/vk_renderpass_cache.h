@@ -0,0 +1,82 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+
+#include "common/common_types.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/renderer_vulkan/declarations.h"
+
+namespace Vulkan {
+
+class VKDevice;
+
+using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+
+/// Format and load/store operations of an attachment of a render pass.
+struct RenderPassAttachment {
+    vk::Format format = vk::Format::eUndefined;
+    vk::AttachmentLoadOp load_op = vk::AttachmentLoadOp::eLoad;
+    vk::AttachmentStoreOp store_op = vk::AttachmentStoreOp::eStore;
+};
+
+/// Identifies a render pass by the attachments it's compatible with and how they are loaded.
+struct RenderPassParams {
+    std::array<RenderPassAttachment, Maxwell::NumRenderTargets> color_attachments{};
+    RenderPassAttachment zeta{}; ///< Undefined format when there's no depth buffer.
+    u32 num_color_attachments = 0;
+
+    std::size_t Hash() const noexcept;
+
+    bool operator==(const RenderPassParams& rhs) const noexcept;
+
+    bool operator!=(const RenderPassParams& rhs) const noexcept {
+        return !operator==(rhs);
+    }
+
+    bool HasZeta() const noexcept {
+        return zeta.format != vk::Format::eUndefined;
+    }
+};
+static_assert(std::has_unique_object_representations_v<RenderPassParams>);
+static_assert(std::is_trivially_copyable_v<RenderPassParams>);
+
+} // namespace Vulkan
+
+namespace std {
+
+template <>
+struct hash<Vulkan::RenderPassParams> {
+    std::size_t operator()(const Vulkan::RenderPassParams& k) const noexcept {
+        return k.Hash();
+    }
+};
+
+} // namespace std
+
+namespace Vulkan {
+
+/// Creates render passes on demand and keeps them alive for the lifetime of the device.
+class VKRenderPassCache final {
+public:
+    explicit VKRenderPassCache(const VKDevice& device);
+    ~VKRenderPassCache();
+
+    /// Returns a render pass for the given attachments, creating it on the first request.
+    vk::RenderPass GetRenderPass(const RenderPassParams& params);
+
+private:
+    UniqueRenderPass CreateRenderPass(const RenderPassParams& params) const;
+
+    const VKDevice& device;
+    std::unordered_map<RenderPassParams, UniqueRenderPass> cache;
+};
+
+} // namespace Vulkan
@@ -2,8 +2,13 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <memory>
+#include <mutex>
+#include <utility>
+
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/thread.h"
 #include "video_core/renderer_vulkan/declarations.h"
 #include "video_core/renderer_vulkan/vk_device.h"
 #include "video_core/renderer_vulkan/vk_resource_manager.h"
@@ -11,16 +16,41 @@
 
 namespace Vulkan {
 
+void VKScheduler::CommandChunk::ExecuteAll(const vk::DispatchLoaderDynamic& dld) {
+    auto command = first;
+    while (command != nullptr) {
+        auto next = command->GetNext();
+        command->Execute(cmdbuf, dld);
+        command->~Command();
+        command = next;
+    }
+    first = nullptr;
+    last = nullptr;
+    command_offset = 0;
+}
+
 VKScheduler::VKScheduler(const VKDevice& device, VKResourceManager& resource_manager)
-    : device{device}, resource_manager{resource_manager} {
+    : device{device}, resource_manager{resource_manager}, chunk{std::make_unique<CommandChunk>()},
+      worker_thread{&VKScheduler::WorkerThread, this} {
     next_fence = &resource_manager.CommitFence();
     AllocateNewContext();
 }
 
-VKScheduler::~VKScheduler() = default;
+VKScheduler::~VKScheduler() {
+    {
+        std::lock_guard lock{mutex};
+        quit = true;
+    }
+    work_cv.notify_one();
+    worker_thread.join();
+}
 
 void VKScheduler::Flush(bool release_fence, vk::Semaphore semaphore) {
     SubmitExecution(semaphore);
+    if (semaphore) {
+        // The signal operation has to be submitted before anything can wait on the semaphore
+        WaitWorker();
+    }
     if (release_fence)
         current_fence->Release();
     AllocateNewContext();
@@ -28,20 +58,112 @@ void VKScheduler::Flush(bool release_fence, vk::Semaphore semaphore) {
 
 void VKScheduler::Finish(bool release_fence, vk::Semaphore semaphore) {
     SubmitExecution(semaphore);
+    WaitWorker();
     current_fence->Wait();
     if (release_fence)
         current_fence->Release();
     AllocateNewContext();
 }
 
-void VKScheduler::SubmitExecution(vk::Semaphore semaphore) {
+void VKScheduler::DispatchWork() {
+    if (chunk->IsEmpty()) {
+        return;
+    }
+    chunk->SetCommandBuffer(current_cmdbuf);
+    auto new_chunk = AcquireChunk();
+    {
+        std::lock_guard lock{mutex};
+        chunk_queue.push(std::move(chunk));
+    }
+    work_cv.notify_one();
+    chunk = std::move(new_chunk);
+}
+
+void VKScheduler::WaitWorker() {
+    DispatchWork();
+    std::unique_lock lock{mutex};
+    idle_cv.wait(lock, [this] { return chunk_queue.empty() && !is_worker_busy; });
+}
+
+void VKScheduler::RequestRenderpass(vk::RenderPass renderpass, vk::Framebuffer framebuffer,
+                                    vk::Extent2D render_area, u32 num_clear_values,
+                                    const RenderPassClearValues& clear_values) {
+    ASSERT(num_clear_values <= clear_values.size());
+    if (num_clear_values == 0 && renderpass == state.renderpass &&
+        framebuffer == state.framebuffer && render_area == state.render_area) {
+        return;
+    }
+    EndRenderPass();
+    state.renderpass = renderpass;
+    state.framebuffer = framebuffer;
+    state.render_area = render_area;
+
+    Record([renderpass, framebuffer, render_area, num_clear_values,
+            clear_values](auto cmdbuf, auto& dld) {
+        const vk::RenderPassBeginInfo renderpass_bi(renderpass, framebuffer, {{0, 0}, render_area},
+                                                    num_clear_values, clear_values.data());
+        cmdbuf.beginRenderPass(renderpass_bi, vk::SubpassContents::eInline, dld);
+    });
+}
+
+void VKScheduler::RequestOutsideRenderPassOperationContext() {
+    EndRenderPass();
+}
+
+void VKScheduler::WorkerThread() {
+    Common::SetCurrentThreadName("yuzu:VulkanWorker");
     const auto& dld = device.GetDispatchLoader();
-    current_cmdbuf.end(dld);
+    std::unique_lock lock{mutex};
+    while (true) {
+        work_cv.wait(lock, [this] { return !chunk_queue.empty() || quit; });
+        if (chunk_queue.empty()) {
+            // Quitting with every dispatched command replayed
+            return;
+        }
+        std::unique_ptr<CommandChunk> work = std::move(chunk_queue.front());
+        chunk_queue.pop();
+        is_worker_busy = true;
+
+        // Recording doesn't touch any state shared with the GPU thread, release the lock so it
+        // can keep dispatching
+        lock.unlock();
+        work->ExecuteAll(dld);
+        lock.lock();
+
+        chunk_reserve.push_back(std::move(work));
+        is_worker_busy = false;
+        if (chunk_queue.empty()) {
+            idle_cv.notify_all();
+        }
+    }
+}
+
+void VKScheduler::SubmitExecution(vk::Semaphore semaphore) {
+    EndRenderPass();
+
+    const vk::Fence fence = *current_fence;
+    const vk::Queue queue = device.GetGraphicsQueue();
+    Record([fence, queue, semaphore, wait_semaphores = std::move(wait_semaphores),
+            wait_stages = std::move(wait_stages)](auto cmdbuf, auto& dld) {
+        cmdbuf.end(dld);
+        const vk::SubmitInfo submit_info(static_cast<u32>(wait_semaphores.size()),
+                                         wait_semaphores.data(), wait_stages.data(), 1, &cmdbuf,
+                                         semaphore ? 1u : 0u, &semaphore);
+        queue.submit({submit_info}, fence, dld);
+    });
+    wait_semaphores.clear();
+    wait_stages.clear();
+    DispatchWork();
+}
 
-    const auto queue = device.GetGraphicsQueue();
-    const vk::SubmitInfo submit_info(0, nullptr, nullptr, 1, &current_cmdbuf, semaphore ? 1u : 0u,
-                                     &semaphore);
-    queue.submit({submit_info}, *current_fence, dld);
+void VKScheduler::EndRenderPass() {
+    if (!state.renderpass) {
+        return;
+    }
+    state.renderpass = nullptr;
+    state.framebuffer = nullptr;
+    state.render_area = vk::Extent2D{};
+    Record([](auto cmdbuf, auto& dld) { cmdbuf.endRenderPass(dld); });
 }
 
 void VKScheduler::AllocateNewContext() {
@@ -49,8 +171,22 @@ void VKScheduler::AllocateNewContext() {
     current_cmdbuf = resource_manager.CommitCommandBuffer(*current_fence);
     next_fence = &resource_manager.CommitFence();
 
-    const auto& dld = device.GetDispatchLoader();
-    current_cmdbuf.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit}, dld);
+    // Command buffers are only ever begun, recorded and submitted by the worker thread
+    Record([](auto cmdbuf, auto& dld) {
+        cmdbuf.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit}, dld);
+    });
+}
+
+std::unique_ptr<VKScheduler::CommandChunk> VKScheduler::AcquireChunk() {
+    {
+        std::lock_guard lock{mutex};
+        if (!chunk_reserve.empty()) {
+            auto reserved = std::move(chunk_reserve.back());
+            chunk_reserve.pop_back();
+            return reserved;
+        }
+    }
+    return std::make_unique<CommandChunk>();
 }
 
 } // namespace Vulkan
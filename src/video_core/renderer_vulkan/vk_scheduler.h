@@ -4,6 +4,18 @@
 
 #pragma once
 
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include "common/common_types.h"
 #include "video_core/renderer_vulkan/declarations.h"
 
@@ -13,6 +25,9 @@ class VKDevice;
 class VKFence;
 class VKResourceManager;
 
+/// Clear values of a render pass, one for each color attachment and one for the depth buffer.
+using RenderPassClearValues = std::array<vk::ClearValue, 9>;
+
 class VKFenceView {
 public:
     VKFenceView() = default;
@@ -30,25 +45,10 @@ private:
     VKFence* const& fence;
 };
 
-class VKCommandBufferView {
-public:
-    VKCommandBufferView() = default;
-    VKCommandBufferView(const vk::CommandBuffer& cmdbuf) : cmdbuf{cmdbuf} {}
-
-    const vk::CommandBuffer* operator->() const noexcept {
-        return &cmdbuf;
-    }
-
-    operator vk::CommandBuffer() const noexcept {
-        return cmdbuf;
-    }
-
-private:
-    const vk::CommandBuffer& cmdbuf;
-};
-
 /// The scheduler abstracts command buffer and fence management with an interface that's able to do
 /// OpenGL-like operations on Vulkan command buffers.
+/// Commands are recorded as callables into chunks of memory that a worker thread replays into the
+/// command buffers and submits, so the driver overhead runs in parallel with the GPU thread.
 class VKScheduler {
 public:
     explicit VKScheduler(const VKDevice& device, VKResourceManager& resource_manager);
@@ -59,27 +59,170 @@ public:
         return current_fence;
     }
 
-    /// Gets a reference to the current command buffer.
-    VKCommandBufferView GetCommandBuffer() const {
-        return current_cmdbuf;
-    }
-
-    /// Sends the current execution context to the GPU.
+    /// Sends the current execution context to the GPU. Waits for the worker to submit it when a
+    /// semaphore is signaled, so it can be waited on right after.
     void Flush(bool release_fence = true, vk::Semaphore semaphore = nullptr);
 
     /// Sends the current execution context to the GPU and waits for it to complete.
     void Finish(bool release_fence = true, vk::Semaphore semaphore = nullptr);
 
+    /// Sends the recorded commands to the worker thread without ending the command buffer.
+    void DispatchWork();
+
+    /// Waits for the worker thread to replay and submit every dispatched command.
+    void WaitWorker();
+
+    /// Begins a render pass on the framebuffer unless it's the one already being recorded, so
+    /// consecutive draws to the same targets share a single render pass. Render passes that clear
+    /// their attachments always begin a new one.
+    void RequestRenderpass(vk::RenderPass renderpass, vk::Framebuffer framebuffer,
+                           vk::Extent2D render_area, u32 num_clear_values = 0,
+                           const RenderPassClearValues& clear_values = {});
+
+    /// Ends the render pass being recorded, if any. Has to be called before recording clears,
+    /// blits, copies or readbacks, as those can't be recorded inside a render pass.
+    void RequestOutsideRenderPassOperationContext();
+
+    /// Makes the next submission wait for a semaphore before executing the given stages.
+    void AddWaitSemaphore(vk::Semaphore semaphore, vk::PipelineStageFlags stage) {
+        wait_semaphores.push_back(semaphore);
+        wait_stages.push_back(stage);
+    }
+
+    /// Records a command to be replayed on the worker thread. The command is invoked with the
+    /// current command buffer and the dispatch loader, and has to capture everything by value.
+    template <typename T>
+    void Record(T&& command) {
+        if (chunk->Record(command)) {
+            return;
+        }
+        DispatchWork();
+        [[maybe_unused]] const bool recorded = chunk->Record(command);
+    }
+
 private:
+    class Command {
+    public:
+        virtual ~Command() = default;
+
+        virtual void Execute(vk::CommandBuffer cmdbuf,
+                             const vk::DispatchLoaderDynamic& dld) const = 0;
+
+        Command* GetNext() const {
+            return next;
+        }
+
+        void SetNext(Command* next_) {
+            next = next_;
+        }
+
+    private:
+        Command* next = nullptr;
+    };
+
+    template <typename T>
+    class TypedCommand final : public Command {
+    public:
+        explicit TypedCommand(T&& command) : command{std::move(command)} {}
+        ~TypedCommand() override = default;
+
+        TypedCommand(TypedCommand&&) = delete;
+        TypedCommand& operator=(TypedCommand&&) = delete;
+
+        void Execute(vk::CommandBuffer cmdbuf,
+                     const vk::DispatchLoaderDynamic& dld) const override {
+            command(cmdbuf, dld);
+        }
+
+    private:
+        T command;
+    };
+
+    /// Preallocated block of memory that holds a list of commands for one command buffer.
+    class CommandChunk final {
+    public:
+        /// Replays the recorded commands and destroys them.
+        void ExecuteAll(const vk::DispatchLoaderDynamic& dld);
+
+        /// Records a command, returns false when it doesn't fit in the chunk.
+        template <typename T>
+        bool Record(T& command) {
+            using FuncType = TypedCommand<std::decay_t<T>>;
+            static_assert(sizeof(FuncType) < sizeof(data), "Command is too large");
+            static_assert(alignof(FuncType) <= alignof(std::max_align_t),
+                          "Command is overaligned");
+
+            constexpr std::size_t alignment = alignof(std::max_align_t);
+            const std::size_t offset = (command_offset + alignment - 1) & ~(alignment - 1);
+            if (offset + sizeof(FuncType) > sizeof(data)) {
+                return false;
+            }
+            Command* const current_last = last;
+            last = new (data.data() + offset) FuncType(std::move(command));
+            if (current_last != nullptr) {
+                current_last->SetNext(last);
+            } else {
+                first = last;
+            }
+            command_offset = offset + sizeof(FuncType);
+            return true;
+        }
+
+        void SetCommandBuffer(vk::CommandBuffer cmdbuf_) {
+            cmdbuf = cmdbuf_;
+        }
+
+        bool IsEmpty() const {
+            return command_offset == 0;
+        }
+
+    private:
+        vk::CommandBuffer cmdbuf;
+        Command* first = nullptr;
+        Command* last = nullptr;
+        std::size_t command_offset = 0;
+        alignas(std::max_align_t) std::array<u8, 0x8000> data{};
+    };
+
+    void WorkerThread();
+
     void SubmitExecution(vk::Semaphore semaphore);
 
+    void EndRenderPass();
+
     void AllocateNewContext();
 
+    /// Takes an empty chunk from the reserve, allocating a new one when there's none.
+    std::unique_ptr<CommandChunk> AcquireChunk();
+
     const VKDevice& device;
     VKResourceManager& resource_manager;
     vk::CommandBuffer current_cmdbuf;
     VKFence* current_fence = nullptr;
     VKFence* next_fence = nullptr;
+
+    std::unique_ptr<CommandChunk> chunk;
+
+    /// Render pass being recorded in the current command buffer, null when outside of one.
+    struct {
+        vk::RenderPass renderpass;
+        vk::Framebuffer framebuffer;
+        vk::Extent2D render_area;
+    } state;
+
+    /// Semaphores the current execution context waits for before executing.
+    std::vector<vk::Semaphore> wait_semaphores;
+    std::vector<vk::PipelineStageFlags> wait_stages;
+
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable idle_cv;
+    std::queue<std::unique_ptr<CommandChunk>> chunk_queue;
+    std::vector<std::unique_ptr<CommandChunk>> chunk_reserve;
+    bool is_worker_busy = false;
+    bool quit = false;
+
+    std::thread worker_thread;
 };
 
 } // namespace Vulkan
@@ -5,6 +5,7 @@
 #include <functional>
 #include <map>
 #include <set>
+#include <utility>
 
 #include <fmt/format.h>
 
@@ -37,10 +38,11 @@ using Operation = const OperationNode&;
 // TODO(Rodrigo): Use rasterizer's value
 constexpr u32 MAX_CONSTBUFFER_FLOATS = 0x4000;
 constexpr u32 MAX_CONSTBUFFER_ELEMENTS = MAX_CONSTBUFFER_FLOATS / 4;
-constexpr u32 STAGE_BINDING_STRIDE = 0x100;
 
 enum class Type { Bool, Bool2, Float, Int, Uint, HalfFloat };
 
+enum class ShuffleMode { Indexed, Up, Down, Butterfly };
+
 struct SamplerImage {
     Id image_type;
     Id sampled_image_type;
@@ -98,6 +100,9 @@ public:
         AddCapability(spv::Capability::Shader);
         AddExtension("SPV_KHR_storage_buffer_storage_class");
         AddExtension("SPV_KHR_variable_pointers");
+        if (device.IsFloat16Supported()) {
+            AddCapability(spv::Capability::Float16);
+        }
     }
 
     void DecompileBranchMode() {
@@ -183,6 +188,7 @@ public:
         DeclareConstantBuffers();
         DeclareGlobalBuffers();
         DeclareSamplers();
+        DeclareWarp();
 
         execute_function =
             Emit(OpFunction(t_void, spv::FunctionControlMask::Inline, TypeFunction(t_void)));
@@ -452,6 +458,22 @@ private:
         }
     }
 
+    void DeclareWarp() {
+        if (!ir.UsesWarps() || !device.IsWarpIntrinsicsSupported()) {
+            return;
+        }
+        AddCapability(spv::Capability::SubgroupBallotKHR);
+        AddCapability(spv::Capability::SubgroupVoteKHR);
+        AddExtension("SPV_KHR_shader_ballot");
+        AddExtension("SPV_KHR_subgroup_vote");
+
+        thread_id = DeclareBuiltIn(spv::BuiltIn::SubgroupLocalInvocationId,
+                                   spv::StorageClass::Input, t_in_uint, "thread_id");
+        if (stage == ShaderStage::Fragment) {
+            Decorate(thread_id, spv::Decoration::Flat);
+        }
+    }
+
     void DeclareVertexRedeclarations() {
         vertex_index = DeclareBuiltIn(spv::BuiltIn::VertexIndex, spv::StorageClass::Input,
                                       t_in_uint, "vertex_index");
@@ -774,53 +796,103 @@ private:
     }
 
     Id FCastHalf0(Operation operation) {
-        UNIMPLEMENTED();
-        return {};
+        const Id value = VisitOperand<Type::HalfFloat>(operation, 0);
+        return HalfToFloat(Emit(OpCompositeExtract(t_scalar_half, value, 0)));
     }
 
     Id FCastHalf1(Operation operation) {
-        UNIMPLEMENTED();
-        return {};
+        const Id value = VisitOperand<Type::HalfFloat>(operation, 0);
+        return HalfToFloat(Emit(OpCompositeExtract(t_scalar_half, value, 1)));
     }
 
     Id HNegate(Operation operation) {
-        UNIMPLEMENTED();
-        return {};
+        const Id value = VisitOperand<Type::HalfFloat>(operation, 0);
+        const Id negate = Emit(OpCompositeConstruct(t_bool2, VisitOperand<Type::Bool>(operation, 1),
+                                                    VisitOperand<Type::Bool>(operation, 2)));
+        const Id negated = Emit(OpFNegate(t_half, value));
+        return BitcastFrom<Type::HalfFloat>(Emit(OpSelect(t_half, negate, negated, value)));
     }
 
     Id HClamp(Operation operation) {
-        UNIMPLEMENTED();
-        return {};
+        const Id value = VisitOperand<Type::HalfFloat>(operation, 0);
+        const Id min = FloatToHalf2(VisitOperand<Type::Float>(operation, 1));
+        const Id max = FloatToHalf2(VisitOperand<Type::Float>(operation, 2));
+        const Id clamped = Emit(OpFClamp(t_half, value, min, max));
+        if (IsPrecise(operation)) {
+            Decorate(clamped, spv::Decoration::NoContraction);
+        }
+        return BitcastFrom<Type::HalfFloat>(clamped);
     }
 
     Id HCastFloat(Operation operation) {
-        UNIMPLEMENTED();
-        return {};
+        return BitcastFrom<Type::HalfFloat>(FloatToHalf2(VisitOperand<Type::Float>(operation, 0)));
     }
 
     Id HUnpack(Operation operation) {
-        UNIMPLEMENTED();
+        switch (std::get<Tegra::Shader::HalfType>(operation.GetMeta())) {
+        case Tegra::Shader::HalfType::H0_H1:
+            return Visit(operation[0]);
+        case Tegra::Shader::HalfType::F32:
+            return HCastFloat(operation);
+        case Tegra::Shader::HalfType::H0_H0:
+            return BitcastFrom<Type::HalfFloat>(BroadcastHalf(operation, 0));
+        case Tegra::Shader::HalfType::H1_H1:
+            return BitcastFrom<Type::HalfFloat>(BroadcastHalf(operation, 1));
+        }
+        UNREACHABLE();
         return {};
     }
 
     Id HMergeF32(Operation operation) {
-        UNIMPLEMENTED();
-        return {};
+        return FCastHalf0(operation);
     }
 
     Id HMergeH0(Operation operation) {
-        UNIMPLEMENTED();
-        return {};
+        const Id dest = VisitOperand<Type::Uint>(operation, 0);
+        const Id src = VisitOperand<Type::Uint>(operation, 1);
+        return BitcastFrom<Type::Uint>(MergeHalves(src, dest));
     }
 
     Id HMergeH1(Operation operation) {
-        UNIMPLEMENTED();
-        return {};
+        const Id dest = VisitOperand<Type::Uint>(operation, 0);
+        const Id src = VisitOperand<Type::Uint>(operation, 1);
+        return BitcastFrom<Type::Uint>(MergeHalves(dest, src));
     }
 
     Id HPack2(Operation operation) {
-        UNIMPLEMENTED();
-        return {};
+        const Id low = FloatToHalf(VisitOperand<Type::Float>(operation, 0));
+        const Id high = FloatToHalf(VisitOperand<Type::Float>(operation, 1));
+        return BitcastFrom<Type::HalfFloat>(Emit(OpCompositeConstruct(t_half, low, high)));
+    }
+
+    /// Converts a float to the scalar type of half pairs
+    Id FloatToHalf(Id value) {
+        return device.IsFloat16Supported() ? Emit(OpFConvert(t_scalar_half, value)) : value;
+    }
+
+    /// Converts a scalar of a half pair to a float
+    Id HalfToFloat(Id value) {
+        return device.IsFloat16Supported() ? Emit(OpFConvert(t_float, value)) : value;
+    }
+
+    /// Returns a half pair with both elements set to a float
+    Id FloatToHalf2(Id value) {
+        const Id half = FloatToHalf(value);
+        return Emit(OpCompositeConstruct(t_half, half, half));
+    }
+
+    /// Returns a half pair with both elements set to one element of the first operand
+    Id BroadcastHalf(Operation operation, u32 element) {
+        const Id value = VisitOperand<Type::HalfFloat>(operation, 0);
+        const Id half = Emit(OpCompositeExtract(t_scalar_half, value, element));
+        return Emit(OpCompositeConstruct(t_half, half, half));
+    }
+
+    /// Returns the low half of a pair merged with the high half of another
+    Id MergeHalves(Id low, Id high) {
+        const Id low_bits = Emit(OpBitwiseAnd(t_uint, low, Constant(t_uint, 0x0000FFFF)));
+        const Id high_bits = Emit(OpBitwiseAnd(t_uint, high, Constant(t_uint, 0xFFFF0000)));
+        return Emit(OpBitwiseOr(t_uint, low_bits, high_bits));
     }
 
     Id LogicalAssign(Operation operation) {
@@ -1175,64 +1247,137 @@ private:
         return {};
     }
 
-    Id BallotThread(Operation) {
-        UNIMPLEMENTED();
-        return {};
-    }
-
-    Id VoteAll(Operation) {
-        UNIMPLEMENTED();
-        return {};
+    Id BallotThread(Operation operation) {
+        const Id predicate = VisitOperand<Type::Bool>(operation, 0);
+        if (!device.IsWarpIntrinsicsSupported()) {
+            // Stub by simulating all threads voting the same as the active one
+            return BitcastFrom<Type::Uint>(Emit(OpSelect(
+                t_uint, predicate, Constant(t_uint, 0xFFFFFFFF), Constant(t_uint, 0))));
+        }
+        return BitcastFrom<Type::Uint>(WarpBallot(predicate));
     }
 
-    Id VoteAny(Operation) {
-        UNIMPLEMENTED();
-        return {};
+    Id VoteAll(Operation operation) {
+        const Id predicate = VisitOperand<Type::Bool>(operation, 0);
+        if (!device.IsWarpIntrinsicsSupported()) {
+            // Stub with a warp size of one
+            return predicate;
+        }
+        if (!device.IsWarpSizePotentiallyBiggerThanGuest()) {
+            return Emit(OpSubgroupAllKHR(t_bool, predicate));
+        }
+        return Emit(OpIEqual(t_bool, WarpBallot(predicate), WarpBallot(v_true)));
     }
 
-    Id VoteEqual(Operation) {
-        UNIMPLEMENTED();
-        return {};
+    Id VoteAny(Operation operation) {
+        const Id predicate = VisitOperand<Type::Bool>(operation, 0);
+        if (!device.IsWarpIntrinsicsSupported()) {
+            // Stub with a warp size of one
+            return predicate;
+        }
+        if (!device.IsWarpSizePotentiallyBiggerThanGuest()) {
+            return Emit(OpSubgroupAnyKHR(t_bool, predicate));
+        }
+        return Emit(OpINotEqual(t_bool, WarpBallot(predicate), Constant(t_uint, 0)));
     }
 
-    Id ShuffleIndexed(Operation) {
-        UNIMPLEMENTED();
-        return {};
-    }
+    Id VoteEqual(Operation operation) {
+        const Id predicate = VisitOperand<Type::Bool>(operation, 0);
+        if (!device.IsWarpIntrinsicsSupported()) {
+            // Stub with a warp size of one, always true
+            return v_true;
+        }
+        if (!device.IsWarpSizePotentiallyBiggerThanGuest()) {
+            return Emit(OpSubgroupAllEqualKHR(t_bool, predicate));
+        }
+        // The predicate is equal when no active thread or all of them voted it
+        const Id ballot = WarpBallot(predicate);
+        const Id is_none = Emit(OpIEqual(t_bool, ballot, Constant(t_uint, 0)));
+        const Id is_all = Emit(OpIEqual(t_bool, ballot, WarpBallot(v_true)));
+        return Emit(OpLogicalOr(t_bool, is_none, is_all));
+    }
+
+    template <ShuffleMode mode>
+    Id Shuffle(Operation operation) {
+        const Id value = VisitOperand<Type::Float>(operation, 0);
+        if (!device.IsWarpIntrinsicsSupported()) {
+            // On a "single-thread" device we are either on the same thread or out of bounds. Both
+            // cases return the passed value.
+            return value;
+        }
+        const Id index = VisitOperand<Type::Uint>(operation, 1);
+        const Id width = VisitOperand<Type::Uint>(operation, 2);
+        const auto [source, in_range] = GetShuffleSource<mode>(index, width);
 
-    Id ShuffleUp(Operation) {
-        UNIMPLEMENTED();
-        return {};
+        // Out of range threads read their own value
+        const Id lane = Emit(OpSelect(t_uint, in_range, source, GetWarpLane()));
+        return Emit(OpSubgroupReadInvocationKHR(t_float, value, GetSubgroupThread(lane)));
     }
 
-    Id ShuffleDown(Operation) {
-        UNIMPLEMENTED();
-        return {};
+    template <ShuffleMode mode>
+    Id InRangeShuffle(Operation operation) {
+        const Id index = VisitOperand<Type::Uint>(operation, 0);
+        if (!device.IsWarpIntrinsicsSupported()) {
+            // A warp size of one is only in range when the thread reads itself
+            return Emit(OpIEqual(t_bool, index, Constant(t_uint, 0)));
+        }
+        const Id width = VisitOperand<Type::Uint>(operation, 1);
+        return GetShuffleSource<mode>(index, width).second;
     }
 
-    Id ShuffleButterfly(Operation) {
-        UNIMPLEMENTED();
-        return {};
+    /// Returns the ballot of the 32 threads of the guest warp the invocation belongs to
+    Id WarpBallot(Id predicate) {
+        const Id ballot = Emit(OpSubgroupBallotKHR(t_uint4, predicate));
+        if (!device.IsWarpSizePotentiallyBiggerThanGuest()) {
+            return Emit(OpCompositeExtract(t_uint, ballot, 0));
+        }
+        const Id word = Emit(OpShiftRightLogical(t_uint, LoadThreadId(), Constant(t_uint, 5)));
+        return Emit(OpVectorExtractDynamic(t_uint, ballot, word));
     }
 
-    Id InRangeShuffleIndexed(Operation) {
-        UNIMPLEMENTED();
-        return {};
+    Id LoadThreadId() {
+        return Emit(OpLoad(t_uint, thread_id));
     }
 
-    Id InRangeShuffleUp(Operation) {
-        UNIMPLEMENTED();
-        return {};
+    /// Returns the index of the invocation inside its guest warp
+    Id GetWarpLane() {
+        if (!device.IsWarpSizePotentiallyBiggerThanGuest()) {
+            return LoadThreadId();
+        }
+        return Emit(OpBitwiseAnd(t_uint, LoadThreadId(), Constant(t_uint, 31)));
     }
 
-    Id InRangeShuffleDown(Operation) {
-        UNIMPLEMENTED();
-        return {};
-    }
+    /// Returns the subgroup invocation of a lane in the guest warp of the invocation
+    Id GetSubgroupThread(Id lane) {
+        if (!device.IsWarpSizePotentiallyBiggerThanGuest()) {
+            return lane;
+        }
+        const Id warp_base = Emit(OpBitwiseAnd(t_uint, LoadThreadId(), Constant(t_uint, ~31U)));
+        return Emit(OpIAdd(t_uint, warp_base, lane));
+    }
+
+    /// Returns the lane a shuffle reads from and whether it's inside the segment of the thread
+    template <ShuffleMode mode>
+    std::pair<Id, Id> GetShuffleSource(Id index, Id width) {
+        const Id lane = GetWarpLane();
+        const Id width_minus_one = Emit(OpISub(t_uint, width, Constant(t_uint, 1)));
+        const Id base = Emit(OpBitwiseAnd(t_uint, lane, Emit(OpNot(t_uint, width_minus_one))));
+
+        Id source;
+        if constexpr (mode == ShuffleMode::Indexed) {
+            source = Emit(OpIAdd(t_uint, base, index));
+        } else if constexpr (mode == ShuffleMode::Up) {
+            source = Emit(OpISub(t_uint, lane, index));
+        } else if constexpr (mode == ShuffleMode::Down) {
+            source = Emit(OpIAdd(t_uint, lane, index));
+        } else {
+            source = Emit(OpBitwiseXor(t_uint, lane, index));
+        }
 
-    Id InRangeShuffleButterfly(Operation) {
-        UNIMPLEMENTED();
-        return {};
+        const Id end = Emit(OpIAdd(t_uint, base, width));
+        const Id is_above_base = Emit(OpUGreaterThanEqual(t_bool, source, base));
+        const Id is_below_end = Emit(OpULessThan(t_bool, source, end));
+        return {source, Emit(OpLogicalAnd(t_bool, is_above_base, is_below_end))};
     }
 
     Id DeclareBuiltIn(spv::BuiltIn builtin, spv::StorageClass storage, Id type,
@@ -1278,7 +1423,7 @@ private:
         case Type::Uint:
             return Emit(OpBitcast(t_uint, value));
         case Type::HalfFloat:
-            UNIMPLEMENTED();
+            return UnpackHalf(value);
         }
         UNREACHABLE();
         return value;
@@ -1295,7 +1440,10 @@ private:
         case Type::Uint:
             return Emit(OpBitcast(t_float, value));
         case Type::HalfFloat:
-            UNIMPLEMENTED();
+            if (device.IsFloat16Supported()) {
+                return Emit(OpBitcast(t_float, value));
+            }
+            return Emit(OpBitcast(t_float, Emit(OpPackHalf2x16(t_uint, value))));
         }
         UNREACHABLE();
         return value;
@@ -1314,12 +1462,20 @@ private:
         case Type::Uint:
             return Emit(OpBitcast(t_uint, value));
         case Type::HalfFloat:
-            UNIMPLEMENTED();
+            return UnpackHalf(value);
         }
         UNREACHABLE();
         return value;
     }
 
+    /// Returns the half pair stored in the bits of a float, native halves are only a bitcast away
+    Id UnpackHalf(Id value) {
+        if (device.IsFloat16Supported()) {
+            return Emit(OpBitcast(t_half, value));
+        }
+        return Emit(OpUnpackHalf2x16(t_half, Emit(OpBitcast(t_uint, value))));
+    }
+
     Id GetTypeDefinition(Type type) {
         switch (type) {
         case Type::Bool:
@@ -1333,7 +1489,7 @@ private:
         case Type::Uint:
             return t_uint;
         case Type::HalfFloat:
-            UNIMPLEMENTED();
+            return t_half;
         }
         UNREACHABLE();
         return {};
@@ -1476,19 +1632,18 @@ private:
         &SPIRVDecompiler::Binary<&Module::OpINotEqual, Type::Bool, Type::Uint>,
         &SPIRVDecompiler::Binary<&Module::OpUGreaterThanEqual, Type::Bool, Type::Uint>,
 
-        &SPIRVDecompiler::Binary<&Module::OpFOrdLessThan, Type::Bool, Type::HalfFloat>,
-        &SPIRVDecompiler::Binary<&Module::OpFOrdEqual, Type::Bool, Type::HalfFloat>,
-        &SPIRVDecompiler::Binary<&Module::OpFOrdLessThanEqual, Type::Bool, Type::HalfFloat>,
-        &SPIRVDecompiler::Binary<&Module::OpFOrdGreaterThan, Type::Bool, Type::HalfFloat>,
-        &SPIRVDecompiler::Binary<&Module::OpFOrdNotEqual, Type::Bool, Type::HalfFloat>,
-        &SPIRVDecompiler::Binary<&Module::OpFOrdGreaterThanEqual, Type::Bool, Type::HalfFloat>,
-        // TODO(Rodrigo): Should these use the OpFUnord* variants?
-        &SPIRVDecompiler::Binary<&Module::OpFOrdLessThan, Type::Bool, Type::HalfFloat>,
-        &SPIRVDecompiler::Binary<&Module::OpFOrdEqual, Type::Bool, Type::HalfFloat>,
-        &SPIRVDecompiler::Binary<&Module::OpFOrdLessThanEqual, Type::Bool, Type::HalfFloat>,
-        &SPIRVDecompiler::Binary<&Module::OpFOrdGreaterThan, Type::Bool, Type::HalfFloat>,
-        &SPIRVDecompiler::Binary<&Module::OpFOrdNotEqual, Type::Bool, Type::HalfFloat>,
-        &SPIRVDecompiler::Binary<&Module::OpFOrdGreaterThanEqual, Type::Bool, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFOrdLessThan, Type::Bool2, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFOrdEqual, Type::Bool2, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFOrdLessThanEqual, Type::Bool2, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFOrdGreaterThan, Type::Bool2, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFOrdNotEqual, Type::Bool2, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFOrdGreaterThanEqual, Type::Bool2, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFUnordLessThan, Type::Bool2, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFUnordEqual, Type::Bool2, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFUnordLessThanEqual, Type::Bool2, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFUnordGreaterThan, Type::Bool2, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFUnordNotEqual, Type::Bool2, Type::HalfFloat>,
+        &SPIRVDecompiler::Binary<&Module::OpFUnordGreaterThanEqual, Type::Bool2, Type::HalfFloat>,
 
         &SPIRVDecompiler::Texture,
         &SPIRVDecompiler::TextureLod,
@@ -1528,15 +1683,15 @@ private:
         &SPIRVDecompiler::VoteAny,
         &SPIRVDecompiler::VoteEqual,
 
-        &SPIRVDecompiler::ShuffleIndexed,
-        &SPIRVDecompiler::ShuffleUp,
-        &SPIRVDecompiler::ShuffleDown,
-        &SPIRVDecompiler::ShuffleButterfly,
+        &SPIRVDecompiler::Shuffle<ShuffleMode::Indexed>,
+        &SPIRVDecompiler::Shuffle<ShuffleMode::Up>,
+        &SPIRVDecompiler::Shuffle<ShuffleMode::Down>,
+        &SPIRVDecompiler::Shuffle<ShuffleMode::Butterfly>,
 
-        &SPIRVDecompiler::InRangeShuffleIndexed,
-        &SPIRVDecompiler::InRangeShuffleUp,
-        &SPIRVDecompiler::InRangeShuffleDown,
-        &SPIRVDecompiler::InRangeShuffleButterfly,
+        &SPIRVDecompiler::InRangeShuffle<ShuffleMode::Indexed>,
+        &SPIRVDecompiler::InRangeShuffle<ShuffleMode::Up>,
+        &SPIRVDecompiler::InRangeShuffle<ShuffleMode::Down>,
+        &SPIRVDecompiler::InRangeShuffle<ShuffleMode::Butterfly>,
     };
     static_assert(operation_decompilers.size() == static_cast<std::size_t>(OperationCode::Amount));
 
@@ -1567,6 +1722,11 @@ private:
     const Id t_float3 = Name(TypeVector(t_float, 3), "float3");
     const Id t_float4 = Name(TypeVector(t_float, 4), "float4");
 
+    const Id t_scalar_half =
+        device.IsFloat16Supported() ? Name(TypeFloat(16), "scalar_half") : t_float;
+    const Id t_half =
+        device.IsFloat16Supported() ? Name(TypeVector(t_scalar_half, 2), "half") : t_float2;
+
     const Id t_prv_bool = Name(TypePointer(spv::StorageClass::Private, t_bool), "prv_bool");
     const Id t_prv_float = Name(TypePointer(spv::StorageClass::Private, t_float), "prv_float");
 
@@ -1623,6 +1783,7 @@ private:
     Id frag_depth{};
     Id frag_coord{};
     Id front_facing{};
+    Id thread_id{};
 
     u32 position_index{};
     u32 point_size_index{};
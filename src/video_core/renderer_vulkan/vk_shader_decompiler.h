@@ -31,6 +31,9 @@ using SamplerEntry = VideoCommon::Shader::Sampler;
 
 constexpr u32 DESCRIPTOR_SET = 0;
 
+/// Number of bindings reserved for each stage, stage bindings start at its multiples.
+constexpr u32 STAGE_BINDING_STRIDE = 0x100;
+
 class ConstBufferEntry : public VideoCommon::Shader::ConstBuffer {
 public:
     explicit constexpr ConstBufferEntry(const VideoCommon::Shader::ConstBuffer& entry, u32 index)
@@ -0,0 +1,203 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/assert.h"
+#include "common/bit_util.h"
+#include "video_core/renderer_vulkan/declarations.h"
+#include "video_core/renderer_vulkan/vk_device.h"
+#include "video_core/renderer_vulkan/vk_resource_manager.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_staging_buffer_pool.h"
+
+namespace Vulkan {
+
+constexpr std::size_t TRANSFER_POOL_GROW_STEP = 0x10;
+
+/// Command buffers of the transfer queue family and the semaphores their submissions signal.
+class TransferCommandPool final : public VKFencedPool {
+public:
+    explicit TransferCommandPool(const VKDevice& device)
+        : VKFencedPool(TRANSFER_POOL_GROW_STEP), device{device} {}
+
+    void Allocate(std::size_t begin, std::size_t end) override {
+        const auto dev = device.GetLogical();
+        const auto& dld = device.GetDispatchLoader();
+
+        const auto pool_flags = vk::CommandPoolCreateFlagBits::eTransient |
+                                vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+        const vk::CommandPoolCreateInfo pool_ci(pool_flags, device.GetTransferFamily());
+        pools.push_back(dev.createCommandPoolUnique(pool_ci, nullptr, dld));
+
+        const vk::CommandBufferAllocateInfo cmdbuf_ai(
+            *pools.back(), vk::CommandBufferLevel::ePrimary, static_cast<u32>(end - begin));
+        auto new_cmdbufs =
+            dev.allocateCommandBuffersUnique<std::allocator<UniqueCommandBuffer>>(cmdbuf_ai, dld);
+        for (auto& cmdbuf : new_cmdbufs) {
+            cmdbufs.push_back(std::move(cmdbuf));
+            semaphores.push_back(dev.createSemaphoreUnique({}, nullptr, dld));
+        }
+    }
+
+    /// Commits a command buffer and the semaphore its submission signals.
+    std::pair<vk::CommandBuffer, vk::Semaphore> Commit(VKFence& fence) {
+        const std::size_t index = CommitResource(fence);
+        return {*cmdbufs[index], *semaphores[index]};
+    }
+
+private:
+    const VKDevice& device;
+    std::vector<UniqueCommandPool> pools;
+    std::vector<UniqueCommandBuffer> cmdbufs;
+    std::vector<UniqueSemaphore> semaphores;
+};
+
+VKStagingBufferPool::VKStagingBufferPool(const VKDevice& device, VKMemoryManager& memory_manager,
+                                         VKScheduler& scheduler)
+    : device{device}, memory_manager{memory_manager}, scheduler{scheduler} {
+    if (device.HasDedicatedTransferQueue()) {
+        command_pool = std::make_unique<TransferCommandPool>(device);
+    }
+}
+
+VKStagingBufferPool::~VKStagingBufferPool() = default;
+
+VKStagingBuffer& VKStagingBufferPool::GetUnusedBuffer(std::size_t size) {
+    const u32 log2 = size <= 1 ? 0 : Common::MostSignificantBit64(size - 1) + 1;
+    ASSERT(log2 < buffers.size());
+
+    VKFence& fence = scheduler.GetFence();
+    auto& entries = buffers[log2];
+    for (auto& entry : entries) {
+        if (entry.watch->TryWatch(fence)) {
+            return entry.buffer;
+        }
+    }
+
+    const vk::BufferCreateInfo buffer_ci({}, 1ULL << log2, vk::BufferUsageFlagBits::eTransferSrc,
+                                         vk::SharingMode::eExclusive, 0, nullptr);
+    const auto dev = device.GetLogical();
+    const auto& dld = device.GetDispatchLoader();
+
+    StagingEntry& entry = entries.emplace_back();
+    entry.buffer.handle = dev.createBufferUnique(buffer_ci, nullptr, dld);
+    entry.buffer.commit = memory_manager.Commit(*entry.buffer.handle, true);
+    entry.watch = std::make_unique<VKFenceWatch>();
+    entry.watch->Watch(fence);
+    return entry.buffer;
+}
+
+void VKStagingBufferPool::UploadBuffer(const VKStagingBuffer& staging, vk::Buffer buffer,
+                                       std::vector<vk::BufferCopy> copies, vk::AccessFlags access,
+                                       vk::PipelineStageFlags stage) {
+    const vk::Buffer src = *staging.handle;
+    scheduler.RequestOutsideRenderPassOperationContext();
+    if (!command_pool) {
+        scheduler.Record([src, buffer, copies = std::move(copies), access,
+                          stage](auto cmdbuf, auto& dld) {
+            cmdbuf.copyBuffer(src, buffer, copies, dld);
+            const vk::BufferMemoryBarrier barrier(vk::AccessFlagBits::eTransferWrite, access,
+                                                  VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+                                                  buffer, 0, VK_WHOLE_SIZE);
+            cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, stage, {}, {}, barrier, {},
+                                   dld);
+        });
+        return;
+    }
+
+    // The transfer queue family releases the buffer and the graphics one acquires it
+    const u32 transfer_family = device.GetTransferFamily();
+    const u32 graphics_family = device.GetGraphicsFamily();
+    const auto& dld = device.GetDispatchLoader();
+    const vk::CommandBuffer cmdbuf = BeginTransfer();
+    cmdbuf.copyBuffer(src, buffer, copies, dld);
+    const vk::BufferMemoryBarrier release(vk::AccessFlagBits::eTransferWrite, {}, transfer_family,
+                                          graphics_family, buffer, 0, VK_WHOLE_SIZE);
+    cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                           vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, release, {}, dld);
+    SubmitTransfer(cmdbuf, stage);
+
+    scheduler.Record([buffer, access, stage, transfer_family,
+                      graphics_family](auto cmdbuf, auto& dld) {
+        const vk::BufferMemoryBarrier acquire({}, access, transfer_family, graphics_family, buffer,
+                                              0, VK_WHOLE_SIZE);
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, stage, {}, {}, acquire, {},
+                               dld);
+    });
+}
+
+void VKStagingBufferPool::UploadImage(const VKStagingBuffer& staging, vk::Image image,
+                                      const vk::ImageSubresourceRange& range,
+                                      std::vector<vk::BufferImageCopy> copies,
+                                      vk::ImageLayout layout, vk::AccessFlags access,
+                                      vk::PipelineStageFlags stage) {
+    const vk::Buffer src = *staging.handle;
+    const vk::ImageMemoryBarrier to_transfer(
+        {}, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eUndefined,
+        vk::ImageLayout::eTransferDstOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+        image, range);
+    scheduler.RequestOutsideRenderPassOperationContext();
+    if (!command_pool) {
+        scheduler.Record([src, image, range, copies = std::move(copies), layout, access, stage,
+                          to_transfer](auto cmdbuf, auto& dld) {
+            cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                                   vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, to_transfer,
+                                   dld);
+            cmdbuf.copyBufferToImage(src, image, vk::ImageLayout::eTransferDstOptimal, copies,
+                                     dld);
+            const vk::ImageMemoryBarrier barrier(
+                vk::AccessFlagBits::eTransferWrite, access, vk::ImageLayout::eTransferDstOptimal,
+                layout, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image, range);
+            cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, stage, {}, {}, {}, barrier,
+                                   dld);
+        });
+        return;
+    }
+
+    // The release and the acquire have to do the same layout transition
+    const u32 transfer_family = device.GetTransferFamily();
+    const u32 graphics_family = device.GetGraphicsFamily();
+    const auto& dld = device.GetDispatchLoader();
+    const vk::CommandBuffer cmdbuf = BeginTransfer();
+    cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                           vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, to_transfer, dld);
+    cmdbuf.copyBufferToImage(src, image, vk::ImageLayout::eTransferDstOptimal, copies, dld);
+    const vk::ImageMemoryBarrier release(vk::AccessFlagBits::eTransferWrite, {},
+                                         vk::ImageLayout::eTransferDstOptimal, layout,
+                                         transfer_family, graphics_family, image, range);
+    cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                           vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {}, release, dld);
+    SubmitTransfer(cmdbuf, stage);
+
+    scheduler.Record([image, range, layout, access, stage, transfer_family,
+                      graphics_family](auto cmdbuf, auto& dld) {
+        const vk::ImageMemoryBarrier acquire({}, access, vk::ImageLayout::eTransferDstOptimal,
+                                             layout, transfer_family, graphics_family, image,
+                                             range);
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, stage, {}, {}, {}, acquire,
+                               dld);
+    });
+}
+
+vk::CommandBuffer VKStagingBufferPool::BeginTransfer() {
+    // Transfer submissions are protected by the fence of the graphics submission waiting for them,
+    // once it's signaled both the command buffer and the semaphore can be reused
+    const auto [cmdbuf, semaphore] = command_pool->Commit(scheduler.GetFence());
+    transfer_semaphore = semaphore;
+    cmdbuf.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit}, device.GetDispatchLoader());
+    return cmdbuf;
+}
+
+void VKStagingBufferPool::SubmitTransfer(vk::CommandBuffer cmdbuf, vk::PipelineStageFlags stage) {
+    const auto& dld = device.GetDispatchLoader();
+    cmdbuf.end(dld);
+    const vk::SubmitInfo submit_info(0, nullptr, nullptr, 1, &cmdbuf, 1, &transfer_semaphore);
+    device.GetTransferQueue().submit({submit_info}, nullptr, dld);
+    scheduler.AddWaitSemaphore(transfer_semaphore, stage);
+}
+
+} // namespace Vulkan
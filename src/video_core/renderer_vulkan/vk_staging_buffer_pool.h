@@ -0,0 +1,98 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/renderer_vulkan/declarations.h"
+#include "video_core/renderer_vulkan/vk_memory_manager.h"
+
+namespace Vulkan {
+
+class TransferCommandPool;
+class VKDevice;
+class VKFenceWatch;
+class VKScheduler;
+
+/// Host visible buffer used as the source of uploads.
+struct VKStagingBuffer {
+    UniqueBuffer handle;
+    VKMemoryCommit commit;
+};
+
+/**
+ * Pool of staging buffers and the uploads from them to device local resources. When the device
+ * has a dedicated transfer queue the copies are submitted there, so streaming big resources runs
+ * in parallel with rendering, and the next submission of the scheduler waits on a semaphore for
+ * them. Otherwise they are recorded in the graphics command buffer.
+ */
+class VKStagingBufferPool final {
+public:
+    explicit VKStagingBufferPool(const VKDevice& device, VKMemoryManager& memory_manager,
+                                 VKScheduler& scheduler);
+    ~VKStagingBufferPool();
+
+    /// Returns a staging buffer of at least the requested size. It's protected by the current
+    /// fence of the scheduler, so it has to be uploaded before anything else is submitted.
+    VKStagingBuffer& GetUnusedBuffer(std::size_t size);
+
+    /**
+     * Copies regions of a staging buffer to a buffer the graphics queue hasn't used yet.
+     * @param staging Staging buffer returned by GetUnusedBuffer with the data to upload.
+     * @param buffer Destination buffer.
+     * @param copies Regions to copy.
+     * @param access Access of the graphics commands that will use the buffer.
+     * @param stage Pipeline stages that will use the buffer.
+     */
+    void UploadBuffer(const VKStagingBuffer& staging, vk::Buffer buffer,
+                      std::vector<vk::BufferCopy> copies, vk::AccessFlags access,
+                      vk::PipelineStageFlags stage);
+
+    /**
+     * Copies regions of a staging buffer to an image the graphics queue hasn't used yet, in the
+     * undefined layout.
+     * @param staging Staging buffer returned by GetUnusedBuffer with the data to upload.
+     * @param image Destination image.
+     * @param range Subresources of the image written by the copies.
+     * @param copies Regions to copy.
+     * @param layout Layout the image is left in.
+     * @param access Access of the graphics commands that will use the image.
+     * @param stage Pipeline stages that will use the image.
+     */
+    void UploadImage(const VKStagingBuffer& staging, vk::Image image,
+                     const vk::ImageSubresourceRange& range,
+                     std::vector<vk::BufferImageCopy> copies, vk::ImageLayout layout,
+                     vk::AccessFlags access, vk::PipelineStageFlags stage);
+
+private:
+    struct StagingEntry {
+        VKStagingBuffer buffer;
+        std::unique_ptr<VKFenceWatch> watch;
+    };
+
+    /// Begins a command buffer in the transfer queue.
+    vk::CommandBuffer BeginTransfer();
+
+    /// Submits the transfer command buffer and makes the scheduler wait for it.
+    void SubmitTransfer(vk::CommandBuffer cmdbuf, vk::PipelineStageFlags stage);
+
+    const VKDevice& device;
+    VKMemoryManager& memory_manager;
+    VKScheduler& scheduler;
+
+    std::unique_ptr<TransferCommandPool> command_pool;
+
+    /// Staging buffers sorted by the base two logarithm of their size.
+    std::array<std::deque<StagingEntry>, 48> buffers;
+
+    vk::Semaphore transfer_semaphore; ///< Signaled by the transfer being recorded.
+};
+
+} // namespace Vulkan
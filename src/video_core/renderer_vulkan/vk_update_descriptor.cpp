@@ -0,0 +1,115 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/renderer_vulkan/declarations.h"
+#include "video_core/renderer_vulkan/vk_device.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_shader_decompiler.h"
+#include "video_core/renderer_vulkan/vk_update_descriptor.h"
+
+namespace Vulkan {
+
+namespace {
+
+/// Number of descriptors the payload holds before the worker has to catch up.
+constexpr std::size_t PAYLOAD_SIZE = 0x10000;
+
+/// Upper bound of the descriptors of a set, every stage filling its binding range.
+constexpr std::size_t MAX_SET_DESCRIPTORS =
+    Tegra::Engines::Maxwell3D::Regs::MaxShaderStage * VKShader::STAGE_BINDING_STRIDE;
+
+constexpr u32 ENTRY_STRIDE = static_cast<u32>(sizeof(DescriptorUpdateEntry));
+
+void AddBindings(u32 base_binding, std::size_t count, vk::DescriptorType descriptor_type,
+                 vk::ShaderStageFlags stage_flags,
+                 std::vector<vk::DescriptorSetLayoutBinding>& bindings) {
+    for (std::size_t i = 0; i < count; ++i) {
+        bindings.emplace_back(base_binding + static_cast<u32>(i), descriptor_type, 1, stage_flags,
+                              nullptr);
+    }
+}
+
+void AddTemplateEntry(u32 base_binding, std::size_t count, vk::DescriptorType descriptor_type,
+                      u32& offset,
+                      std::vector<vk::DescriptorUpdateTemplateEntry>& template_entries) {
+    if (count == 0) {
+        return;
+    }
+    template_entries.emplace_back(base_binding, 0, static_cast<u32>(count), descriptor_type,
+                                  offset * ENTRY_STRIDE, ENTRY_STRIDE);
+    offset += static_cast<u32>(count);
+}
+
+} // Anonymous namespace
+
+VKUpdateDescriptorQueue::VKUpdateDescriptorQueue(const VKDevice& device, VKScheduler& scheduler)
+    : device{device}, scheduler{scheduler} {
+    payload.reserve(PAYLOAD_SIZE);
+}
+
+VKUpdateDescriptorQueue::~VKUpdateDescriptorQueue() = default;
+
+void VKUpdateDescriptorQueue::Acquire() {
+    if (payload.size() + MAX_SET_DESCRIPTORS > PAYLOAD_SIZE) {
+        // Recorded updates read the payload, they have to be replayed before it's reused
+        scheduler.DispatchWork();
+        scheduler.WaitWorker();
+        payload.clear();
+    }
+    upload_start = payload.size();
+}
+
+void VKUpdateDescriptorQueue::Send(vk::DescriptorUpdateTemplate update_template,
+                                   vk::DescriptorSet set) {
+    ASSERT(payload.size() - upload_start <= MAX_SET_DESCRIPTORS);
+    const DescriptorUpdateEntry* const data = payload.data() + upload_start;
+    scheduler.Record([dev = device.GetLogical(), update_template, set, data](auto, auto& dld) {
+        dev.updateDescriptorSetWithTemplate(set, update_template, data, dld);
+    });
+}
+
+void FillDescriptorSetLayoutBindings(const VKShader::ShaderEntries& entries,
+                                     vk::ShaderStageFlags stage_flags,
+                                     std::vector<vk::DescriptorSetLayoutBinding>& bindings) {
+    AddBindings(entries.const_buffers_base_binding, entries.const_buffers.size(),
+                vk::DescriptorType::eUniformBuffer, stage_flags, bindings);
+    AddBindings(entries.global_buffers_base_binding, entries.global_buffers.size(),
+                vk::DescriptorType::eStorageBuffer, stage_flags, bindings);
+    AddBindings(entries.samplers_base_binding, entries.samplers.size(),
+                vk::DescriptorType::eCombinedImageSampler, stage_flags, bindings);
+}
+
+void FillDescriptorUpdateTemplateEntries(
+    const VKShader::ShaderEntries& entries, u32& offset,
+    std::vector<vk::DescriptorUpdateTemplateEntry>& template_entries) {
+    AddTemplateEntry(entries.const_buffers_base_binding, entries.const_buffers.size(),
+                     vk::DescriptorType::eUniformBuffer, offset, template_entries);
+    AddTemplateEntry(entries.global_buffers_base_binding, entries.global_buffers.size(),
+                     vk::DescriptorType::eStorageBuffer, offset, template_entries);
+    AddTemplateEntry(entries.samplers_base_binding, entries.samplers.size(),
+                     vk::DescriptorType::eCombinedImageSampler, offset, template_entries);
+}
+
+UniqueDescriptorUpdateTemplate CreateDescriptorUpdateTemplate(
+    const VKDevice& device, const std::vector<vk::DescriptorUpdateTemplateEntry>& entries,
+    vk::DescriptorSetLayout set_layout, vk::PipelineBindPoint bind_point,
+    vk::PipelineLayout pipeline_layout) {
+    if (entries.empty()) {
+        return {};
+    }
+    const vk::DescriptorUpdateTemplateCreateInfo template_ci(
+        {}, static_cast<u32>(entries.size()), entries.data(),
+        vk::DescriptorUpdateTemplateType::eDescriptorSet, set_layout, bind_point, pipeline_layout,
+        VKShader::DESCRIPTOR_SET);
+    const auto dev = device.GetLogical();
+    return dev.createDescriptorUpdateTemplateUnique(template_ci, nullptr,
+                                                    device.GetDispatchLoader());
+}
+
+} // namespace Vulkan
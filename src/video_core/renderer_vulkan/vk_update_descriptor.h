@@ -0,0 +1,98 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/renderer_vulkan/declarations.h"
+
+namespace Vulkan {
+
+namespace VKShader {
+struct ShaderEntries;
+}
+
+class VKDevice;
+class VKScheduler;
+
+/// Descriptor as read by vkUpdateDescriptorSetWithTemplate, entries are packed with a fixed
+/// stride in the update payload.
+class DescriptorUpdateEntry {
+public:
+    explicit DescriptorUpdateEntry() : image{} {}
+
+    DescriptorUpdateEntry(vk::DescriptorImageInfo image) : image{image} {}
+
+    DescriptorUpdateEntry(vk::DescriptorBufferInfo buffer) : buffer{buffer} {}
+
+private:
+    union {
+        vk::DescriptorImageInfo image;
+        vk::DescriptorBufferInfo buffer;
+    };
+};
+static_assert(std::is_trivially_copyable_v<DescriptorUpdateEntry>);
+
+/**
+ * Packs the descriptors of each draw in a payload and updates their set with a template on the
+ * worker thread, making a draw's descriptor update a single call. Usage is: Acquire, add the
+ * descriptors in the order of the template entries and Send.
+ */
+class VKUpdateDescriptorQueue final {
+public:
+    explicit VKUpdateDescriptorQueue(const VKDevice& device, VKScheduler& scheduler);
+    ~VKUpdateDescriptorQueue();
+
+    /// Starts the descriptors of a new set. Waits for the worker to be done with the payload
+    /// when there's no room left in it.
+    void Acquire();
+
+    /// Records the update of a set with the descriptors added since the last Acquire.
+    void Send(vk::DescriptorUpdateTemplate update_template, vk::DescriptorSet set);
+
+    void AddSampledImage(vk::Sampler sampler, vk::ImageView image_view) {
+        payload.emplace_back(
+            vk::DescriptorImageInfo(sampler, image_view, vk::ImageLayout::eGeneral));
+    }
+
+    void AddBuffer(vk::Buffer buffer, u64 offset, std::size_t size) {
+        payload.emplace_back(vk::DescriptorBufferInfo(buffer, offset, size));
+    }
+
+private:
+    const VKDevice& device;
+    VKScheduler& scheduler;
+
+    std::size_t upload_start = 0;
+    /// Capacity is reserved once, the worker reads entries through pointers into it.
+    std::vector<DescriptorUpdateEntry> payload;
+};
+
+/// Appends the descriptor set layout bindings of a shader stage.
+void FillDescriptorSetLayoutBindings(const VKShader::ShaderEntries& entries,
+                                     vk::ShaderStageFlags stage_flags,
+                                     std::vector<vk::DescriptorSetLayoutBinding>& bindings);
+
+/**
+ * Appends the template entries of a shader stage, one per kind of descriptor as consecutive
+ * bindings roll over. Descriptors have to be added to the update queue in the same order:
+ * constant buffers, global buffers and then samplers.
+ * @param offset Index of the first descriptor of the stage in the payload, advanced past them.
+ */
+void FillDescriptorUpdateTemplateEntries(
+    const VKShader::ShaderEntries& entries, u32& offset,
+    std::vector<vk::DescriptorUpdateTemplateEntry>& template_entries);
+
+/// Creates an update template for the descriptor set of a pipeline. Returns a null template when
+/// there are no entries, the set doesn't have to be updated then.
+UniqueDescriptorUpdateTemplate CreateDescriptorUpdateTemplate(
+    const VKDevice& device, const std::vector<vk::DescriptorUpdateTemplateEntry>& entries,
+    vk::DescriptorSetLayout set_layout, vk::PipelineBindPoint bind_point,
+    vk::PipelineLayout pipeline_layout);
+
+} // namespace Vulkan
@@ -2,20 +2,60 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
+
 #include "common/cityhash.h"
 #include "common/common_types.h"
 #include "video_core/sampler_cache.h"
 
 namespace VideoCommon {
 
-std::size_t SamplerCacheKey::Hash() const {
-    static_assert(sizeof(raw) % sizeof(u64) == 0);
-    return static_cast<std::size_t>(
-        Common::CityHash64(reinterpret_cast<const char*>(raw.data()), sizeof(raw) / sizeof(u64)));
+namespace {
+
+using Tegra::Texture::WrapMode;
+
+/// Returns true when a wrap mode may sample the border color.
+bool UsesBorderColor(WrapMode wrap) {
+    switch (wrap) {
+    case WrapMode::Border:
+    case WrapMode::Clamp:
+    case WrapMode::MirrorOnceBorder:
+    case WrapMode::MirrorOnceClampOGL:
+        return true;
+    default:
+        return false;
+    }
 }
 
-bool SamplerCacheKey::operator==(const SamplerCacheKey& rhs) const {
-    return raw == rhs.raw;
+} // Anonymous namespace
+
+SamplerCacheKey::SamplerCacheKey(const Tegra::Texture::TSCEntry& tsc) {
+    const bool depth_compare = tsc.depth_compare_enabled != 0;
+    packed = static_cast<u64>(tsc.wrap_u.Value()) | (static_cast<u64>(tsc.wrap_v.Value()) << 3) |
+             (static_cast<u64>(tsc.wrap_p.Value()) << 6) |
+             (static_cast<u64>(depth_compare) << 9) |
+             ((depth_compare ? static_cast<u64>(tsc.depth_compare_func.Value()) : 0) << 10) |
+             (static_cast<u64>(tsc.max_anisotropy.Value()) << 13) |
+             (static_cast<u64>(tsc.mag_filter.Value()) << 16) |
+             (static_cast<u64>(tsc.min_filter.Value()) << 18) |
+             (static_cast<u64>(tsc.mipmap_filter.Value()) << 20) |
+             (static_cast<u64>(tsc.cubemap_interface_filtering.Value()) << 22) |
+             (static_cast<u64>(tsc.mip_lod_bias.Value()) << 23) |
+             (static_cast<u64>(tsc.min_lod_clamp.Value()) << 36) |
+             (static_cast<u64>(tsc.max_lod_clamp.Value()) << 48);
+
+    // The sRGB conversion flag only selects which border color is used
+    if (UsesBorderColor(tsc.wrap_u) || UsesBorderColor(tsc.wrap_v) ||
+        UsesBorderColor(tsc.wrap_p)) {
+        const std::array<float, 4> color = tsc.GetBorderColor();
+        static_assert(sizeof(color) == sizeof(border_color));
+        std::memcpy(border_color.data(), color.data(), sizeof(border_color));
+    }
+}
+
+std::size_t SamplerCacheKey::Hash() const {
+    return static_cast<std::size_t>(Common::CityHash64WithSeed(
+        reinterpret_cast<const char*>(border_color.data()), sizeof(border_color), packed));
 }
 
 } // namespace VideoCommon
@@ -4,21 +4,34 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <unordered_map>
 
+#include "common/common_types.h"
 #include "video_core/textures/texture.h"
 
 namespace VideoCommon {
 
-struct SamplerCacheKey final : public Tegra::Texture::TSCEntry {
+/// Canonical form of a TSC entry. Fields that don't change how a texture is sampled are dropped
+/// so entries that only differ on them share the same host sampler.
+struct SamplerCacheKey final {
+    SamplerCacheKey() = default;
+
+    explicit SamplerCacheKey(const Tegra::Texture::TSCEntry& tsc);
+
     std::size_t Hash() const;
 
-    bool operator==(const SamplerCacheKey& rhs) const;
+    bool operator==(const SamplerCacheKey& rhs) const {
+        return packed == rhs.packed && border_color == rhs.border_color;
+    }
 
     bool operator!=(const SamplerCacheKey& rhs) const {
         return !operator==(rhs);
     }
+
+    u64 packed = 0;                    ///< Filtering, wrapping, comparison and LOD state.
+    std::array<u32, 4> border_color{}; ///< Border color bits, zero when no wrap mode uses it.
 };
 
 } // namespace VideoCommon
@@ -40,12 +53,25 @@ template <typename SamplerType, typename SamplerStorageType>
 class SamplerCache {
 public:
     SamplerType GetSampler(const Tegra::Texture::TSCEntry& tsc) {
-        const auto [entry, is_cache_miss] = cache.try_emplace(SamplerCacheKey{tsc});
+        const SamplerCacheKey key{tsc};
+        const std::size_t hash = key.Hash();
+
+        // Most draws sample with the same few samplers, look them up without hashing into the map
+        FrontEntry& front = front_cache[hash % FRONT_CACHE_SIZE];
+        if (front.is_valid && front.key == key) {
+            return front.sampler;
+        }
+
+        const auto [entry, is_cache_miss] = cache.try_emplace(key);
         auto& sampler = entry->second;
         if (is_cache_miss) {
             sampler = CreateSampler(tsc);
         }
-        return ToSamplerType(sampler);
+        // Storage is never erased, the host handle stays valid for the lifetime of the cache
+        front.key = key;
+        front.sampler = ToSamplerType(sampler);
+        front.is_valid = true;
+        return front.sampler;
     }
 
 protected:
@@ -54,7 +80,16 @@ protected:
     virtual SamplerType ToSamplerType(const SamplerStorageType& sampler) const = 0;
 
 private:
+    static constexpr std::size_t FRONT_CACHE_SIZE = 64;
+
+    struct FrontEntry {
+        SamplerCacheKey key;
+        SamplerType sampler{};
+        bool is_valid = false;
+    };
+
+    std::array<FrontEntry, FRONT_CACHE_SIZE> front_cache{};
     std::unordered_map<SamplerCacheKey, SamplerStorageType> cache;
 };
 
-} // namespace VideoCommon
\ No newline at end of file
+} // namespace VideoCommon
@@ -5,9 +5,12 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <memory>
+#include <type_traits>
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/shader/const_buffer_locker.h"
 
@@ -15,6 +18,55 @@ namespace VideoCommon::Shader {
 
 using Tegra::Engines::SamplerDescriptor;
 
+namespace {
+
+/// Kinds of keys, hashed with their entries so equal entries of different databases differ.
+constexpr u64 CONST_BUFFER_KEY = 1;
+constexpr u64 BOUND_SAMPLER_KEY = 2;
+constexpr u64 BINDLESS_SAMPLER_KEY = 3;
+
+u32 ToWord(u32 value) {
+    return value;
+}
+
+u32 ToWord(SamplerDescriptor sampler) {
+    return sampler.raw;
+}
+
+/// Returns the hash of an entry. Entries are combined with a xor, so the hash of a locker doesn't
+/// depend on the order its keys were obtained in and replaced entries can be removed from it.
+template <typename Address, typename Value>
+u64 HashEntry(u64 kind, const Address& address, const Value& value) {
+    std::array<u32, 4> words{static_cast<u32>(kind), 0, 0, ToWord(value)};
+    if constexpr (std::is_same_v<Address, u32>) {
+        words[1] = address;
+    } else {
+        words[1] = address.first;
+        words[2] = address.second;
+    }
+    return Common::ComputeXXH3(words.data(), sizeof(words));
+}
+
+/// Returns the first entry of a sorted database whose address is not less than the given one.
+template <typename Database, typename Address>
+auto LowerBound(Database& database, const Address& address) {
+    return std::lower_bound(
+        database.begin(), database.end(), address,
+        [](const auto& entry, const Address& key) { return entry.first < key; });
+}
+
+/// Returns the entry of a database with the given address, or null if there is none.
+template <typename Database, typename Address>
+auto Find(const Database& database, const Address& address) -> decltype(&*database.begin()) {
+    const auto it = LowerBound(database, address);
+    if (it == database.end() || it->first != address) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+} // Anonymous namespace
+
 ConstBufferLocker::ConstBufferLocker(Tegra::Engines::ShaderType shader_stage)
     : stage{shader_stage} {}
 
@@ -26,63 +78,61 @@ ConstBufferLocker::~ConstBufferLocker() = default;
 
 std::optional<u32> ConstBufferLocker::ObtainKey(u32 buffer, u32 offset) {
     const std::pair<u32, u32> key = {buffer, offset};
-    const auto iter = keys.find(key);
-    if (iter != keys.end()) {
-        return iter->second;
+    if (const auto entry = Find(keys, key)) {
+        return entry->second;
     }
     if (!engine) {
         return std::nullopt;
     }
     const u32 value = engine->AccessConstBuffer32(stage, buffer, offset);
-    keys.emplace(key, value);
+    Insert(keys, CONST_BUFFER_KEY, key, value);
     return value;
 }
 
 std::optional<SamplerDescriptor> ConstBufferLocker::ObtainBoundSampler(u32 offset) {
     const u32 key = offset;
-    const auto iter = bound_samplers.find(key);
-    if (iter != bound_samplers.end()) {
-        return iter->second;
+    if (const auto entry = Find(bound_samplers, key)) {
+        return entry->second;
     }
     if (!engine) {
         return std::nullopt;
     }
     const SamplerDescriptor value = engine->AccessBoundSampler(stage, offset);
-    bound_samplers.emplace(key, value);
+    Insert(bound_samplers, BOUND_SAMPLER_KEY, key, value);
     return value;
 }
 
 std::optional<Tegra::Engines::SamplerDescriptor> ConstBufferLocker::ObtainBindlessSampler(
     u32 buffer, u32 offset) {
-    const std::pair key = {buffer, offset};
-    const auto iter = bindless_samplers.find(key);
-    if (iter != bindless_samplers.end()) {
-        return iter->second;
+    const std::pair<u32, u32> key = {buffer, offset};
+    if (const auto entry = Find(bindless_samplers, key)) {
+        return entry->second;
     }
     if (!engine) {
         return std::nullopt;
     }
     const SamplerDescriptor value = engine->AccessBindlessSampler(stage, buffer, offset);
-    bindless_samplers.emplace(key, value);
+    Insert(bindless_samplers, BINDLESS_SAMPLER_KEY, key, value);
     return value;
 }
 
 void ConstBufferLocker::InsertKey(u32 buffer, u32 offset, u32 value) {
-    keys.insert_or_assign({buffer, offset}, value);
+    Insert(keys, CONST_BUFFER_KEY, std::pair{buffer, offset}, value);
 }
 
 void ConstBufferLocker::InsertBoundSampler(u32 offset, SamplerDescriptor sampler) {
-    bound_samplers.insert_or_assign(offset, sampler);
+    Insert(bound_samplers, BOUND_SAMPLER_KEY, offset, sampler);
 }
 
 void ConstBufferLocker::InsertBindlessSampler(u32 buffer, u32 offset, SamplerDescriptor sampler) {
-    bindless_samplers.insert_or_assign({buffer, offset}, sampler);
+    Insert(bindless_samplers, BINDLESS_SAMPLER_KEY, std::pair{buffer, offset}, sampler);
 }
 
 bool ConstBufferLocker::IsConsistent() const {
     if (!engine) {
         return false;
     }
+    // Const buffer words are the cheapest to read back, samplers have to decode their textures
     return std::all_of(keys.begin(), keys.end(),
                        [this](const auto& pair) {
                            const auto [cbuf, offset] = pair.first;
@@ -103,8 +153,33 @@ bool ConstBufferLocker::IsConsistent() const {
 }
 
 bool ConstBufferLocker::HasEqualKeys(const ConstBufferLocker& rhs) const {
-    return keys == rhs.keys && bound_samplers == rhs.bound_samplers &&
+    return hash == rhs.hash && keys == rhs.keys && bound_samplers == rhs.bound_samplers &&
            bindless_samplers == rhs.bindless_samplers;
 }
 
+KeyMap ConstBufferLocker::GetKeys() const {
+    return KeyMap(keys.begin(), keys.end());
+}
+
+BoundSamplerMap ConstBufferLocker::GetBoundSamplers() const {
+    return BoundSamplerMap(bound_samplers.begin(), bound_samplers.end());
+}
+
+BindlessSamplerMap ConstBufferLocker::GetBindlessSamplers() const {
+    return BindlessSamplerMap(bindless_samplers.begin(), bindless_samplers.end());
+}
+
+template <typename Address, typename Value>
+void ConstBufferLocker::Insert(Database<Address, Value>& database, u64 kind, Address address,
+                               Value value) {
+    hash ^= HashEntry(kind, address, value);
+    const auto it = LowerBound(database, address);
+    if (it != database.end() && it->first == address) {
+        hash ^= HashEntry(kind, address, it->second);
+        it->second = value;
+        return;
+    }
+    database.insert(it, {address, value});
+}
+
 } // namespace VideoCommon::Shader
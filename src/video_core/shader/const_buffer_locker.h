@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <optional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include "common/common_types.h"
 #include "common/hash.h"
 #include "video_core/engines/const_buffer_engine_interface.h"
@@ -20,6 +23,10 @@ using BindlessSamplerMap =
  * The ConstBufferLocker is a class use to interface the 3D and compute engines with the shader
  * compiler. with it, the shader can obtain required data from GPU state and store it for disk
  * shader compilation.
+ *
+ * Keys are few and checked on every draw, so they are kept in flat arrays sorted by address with
+ * a hash of their contents updated on insertion. Checking them against the engine walks
+ * contiguous memory, and lockers with different keys are told apart by their hash.
  **/
 class ConstBufferLocker {
 public:
@@ -54,27 +61,35 @@ public:
     /// Returns true if the keys are equal to the other ones in the locker.
     bool HasEqualKeys(const ConstBufferLocker& rhs) const;
 
-    /// Gives an getter to the const buffer keys in the database.
-    const KeyMap& GetKeys() const {
-        return keys;
+    /// Returns a hash of the keys and samplers, equal keys have equal hashes.
+    u64 GetHash() const {
+        return hash;
     }
 
+    /// Gives an getter to the const buffer keys in the database.
+    KeyMap GetKeys() const;
+
     /// Gets samplers database.
-    const BoundSamplerMap& GetBoundSamplers() const {
-        return bound_samplers;
-    }
+    BoundSamplerMap GetBoundSamplers() const;
 
     /// Gets bindless samplers database.
-    const BindlessSamplerMap& GetBindlessSamplers() const {
-        return bindless_samplers;
-    }
+    BindlessSamplerMap GetBindlessSamplers() const;
 
 private:
+    /// Key entries sorted by address.
+    template <typename Address, typename Value>
+    using Database = std::vector<std::pair<Address, Value>>;
+
+    /// Inserts or replaces an entry of a database, keeping the hash up to date.
+    template <typename Address, typename Value>
+    void Insert(Database<Address, Value>& database, u64 kind, Address address, Value value);
+
     const Tegra::Engines::ShaderType stage;
     Tegra::Engines::ConstBufferEngineInterface* engine = nullptr;
-    KeyMap keys;
-    BoundSamplerMap bound_samplers;
-    BindlessSamplerMap bindless_samplers;
+    Database<std::pair<u32, u32>, u32> keys;
+    Database<u32, Tegra::Engines::SamplerDescriptor> bound_samplers;
+    Database<std::pair<u32, u32>, Tegra::Engines::SamplerDescriptor> bindless_samplers;
+    u64 hash = 0;
 };
 
 } // namespace VideoCommon::Shader
@@ -13,6 +13,7 @@
 #include "video_core/engines/shader_header.h"
 #include "video_core/shader/control_flow.h"
 #include "video_core/shader/node_helper.h"
+#include "video_core/shader/optimizer.h"
 #include "video_core/shader/shader_ir.h"
 
 namespace VideoCommon::Shader {
@@ -177,9 +178,11 @@ NodeBlock ShaderIR::DecodeRange(u32 begin, u32 end) {
 }
 
 void ShaderIR::DecodeRangeInner(NodeBlock& bb, u32 begin, u32 end) {
+    const std::size_t first_node = bb.size();
     for (u32 pc = begin; pc < (begin > end ? MAX_PROGRAM_LENGTH : end);) {
         pc = DecodeInstr(bb, pc);
     }
+    OptimizeCode(bb, first_node);
 }
 
 void ShaderIR::InsertControlFlow(NodeBlock& bb, const ShaderBlock& block) {
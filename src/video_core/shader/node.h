@@ -223,7 +223,8 @@ class CommentNode;
 using NodeData =
     std::variant<OperationNode, ConditionalNode, GprNode, ImmediateNode, InternalFlagNode,
                  PredicateNode, AbufNode, CbufNode, LmemNode, SmemNode, GmemNode, CommentNode>;
-using Node = std::shared_ptr<NodeData>;
+/// Nodes are owned by the NodeArena of their shader and live as long as it.
+using Node = NodeData*;
 using Node4 = std::array<Node, 4>;
 using NodeBlock = std::vector<Node>;
 
@@ -0,0 +1,59 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/assert.h"
+#include "video_core/shader/node_arena.h"
+
+namespace VideoCommon::Shader {
+
+namespace {
+
+thread_local NodeArena* current_arena = nullptr;
+
+} // Anonymous namespace
+
+NodeArena::Scope::Scope(NodeArena& arena) : previous{current_arena} {
+    current_arena = &arena;
+}
+
+NodeArena::Scope::~Scope() {
+    current_arena = previous;
+}
+
+NodeArena::NodeArena() = default;
+
+NodeArena::~NodeArena() {
+    Release();
+}
+
+NodeArena::NodeArena(NodeArena&& other) noexcept
+    : chunks{std::move(other.chunks)}, chunk_used{std::exchange(other.chunk_used, CHUNK_SIZE)} {
+    other.chunks.clear();
+}
+
+NodeArena& NodeArena::operator=(NodeArena&& other) noexcept {
+    Release();
+    chunks = std::move(other.chunks);
+    chunk_used = std::exchange(other.chunk_used, CHUNK_SIZE);
+    other.chunks.clear();
+    return *this;
+}
+
+NodeArena& NodeArena::GetCurrent() {
+    ASSERT_MSG(current_arena != nullptr, "Nodes made outside of a node arena scope");
+    return *current_arena;
+}
+
+void NodeArena::Release() {
+    for (std::size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+        const std::size_t count = chunk + 1 == chunks.size() ? chunk_used : CHUNK_SIZE;
+        for (std::size_t slot = 0; slot < count; ++slot) {
+            std::launder(reinterpret_cast<NodeData*>(&chunks[chunk][slot]))->~NodeData();
+        }
+    }
+    chunks.clear();
+    chunk_used = CHUNK_SIZE;
+}
+
+} // namespace VideoCommon::Shader
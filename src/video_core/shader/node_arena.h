@@ -0,0 +1,77 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "video_core/shader/node.h"
+
+namespace VideoCommon::Shader {
+
+/**
+ * Owns the nodes of a shader. Nodes are bump allocated in chunks and released together when the
+ * arena is destroyed, so the IR can refer to them with plain pointers.
+ */
+class NodeArena final {
+public:
+    /// Makes an arena receive the nodes made by the current thread while the scope is alive.
+    class Scope final {
+    public:
+        explicit Scope(NodeArena& arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        NodeArena* previous;
+    };
+
+    NodeArena();
+    ~NodeArena();
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    NodeArena(NodeArena&& other) noexcept;
+    NodeArena& operator=(NodeArena&& other) noexcept;
+
+    /// Returns the arena of the innermost scope of the current thread.
+    static NodeArena& GetCurrent();
+
+    /// Creates a node holding a T constructed from the given arguments.
+    template <typename T, typename... Args>
+    Node Create(Args&&... args) {
+        return new (AllocateSlot()) NodeData(std::in_place_type<T>, std::forward<Args>(args)...);
+    }
+
+private:
+    /// Number of nodes allocated at once.
+    static constexpr std::size_t CHUNK_SIZE = 1024;
+
+    using Slot = std::aligned_storage_t<sizeof(NodeData), alignof(NodeData)>;
+
+    void* AllocateSlot() {
+        if (chunk_used == CHUNK_SIZE) {
+            chunks.push_back(std::make_unique<Slot[]>(CHUNK_SIZE));
+            chunk_used = 0;
+        }
+        return &chunks.back()[chunk_used++];
+    }
+
+    /// Destroys the nodes of every chunk.
+    void Release();
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    std::size_t chunk_used = CHUNK_SIZE;
+};
+
+} // namespace VideoCommon::Shader
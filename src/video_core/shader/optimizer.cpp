@@ -0,0 +1,315 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+
+#include "common/common_types.h"
+#include "video_core/shader/node.h"
+#include "video_core/shader/optimizer.h"
+
+namespace VideoCommon::Shader {
+
+using Tegra::Shader::Pred;
+
+namespace {
+
+/// Largest number of operands of the operations that can be folded.
+constexpr std::size_t MAX_FOLDED_OPERANDS = 4;
+
+std::optional<u32> GetImmediate(const Node& node) {
+    if (const auto immediate = std::get_if<ImmediateNode>(node)) {
+        return immediate->GetValue();
+    }
+    return std::nullopt;
+}
+
+/// Returns the value of a predicate that is always true or always false.
+std::optional<bool> GetConstantPredicate(const Node& node) {
+    const auto predicate = std::get_if<PredicateNode>(node);
+    if (!predicate) {
+        return std::nullopt;
+    }
+    switch (predicate->GetIndex()) {
+    case Pred::UnusedIndex:
+        return !predicate->IsNegated();
+    case Pred::NeverExecute:
+        return predicate->IsNegated();
+    default:
+        return std::nullopt;
+    }
+}
+
+u32 ExtractBits(u32 value, u32 offset, u32 bits) {
+    return bits == 32 ? value : (value >> offset) & ((1U << bits) - 1);
+}
+
+/// Evaluates an integer operation on immediates, returns nothing when it can't be folded.
+std::optional<u32> Evaluate(OperationCode code, const std::array<u32, MAX_FOLDED_OPERANDS>& v) {
+    const auto as_signed = [&v](std::size_t index) { return static_cast<s32>(v[index]); };
+    switch (code) {
+    case OperationCode::IAdd:
+    case OperationCode::UAdd:
+        return v[0] + v[1];
+    case OperationCode::IMul:
+    case OperationCode::UMul:
+        return v[0] * v[1];
+    case OperationCode::INegate:
+        return 0U - v[0];
+    case OperationCode::IAbsolute:
+        return as_signed(0) < 0 ? 0U - v[0] : v[0];
+    case OperationCode::IMin:
+        return static_cast<u32>(std::min(as_signed(0), as_signed(1)));
+    case OperationCode::IMax:
+        return static_cast<u32>(std::max(as_signed(0), as_signed(1)));
+    case OperationCode::UMin:
+        return std::min(v[0], v[1]);
+    case OperationCode::UMax:
+        return std::max(v[0], v[1]);
+    case OperationCode::ICastUnsigned:
+    case OperationCode::UCastSigned:
+        return v[0];
+    case OperationCode::ILogicalShiftLeft:
+    case OperationCode::ULogicalShiftLeft:
+        // Shifting by the width or more is undefined on the host, leave it to its compiler
+        if (v[1] >= 32) {
+            return std::nullopt;
+        }
+        return v[0] << v[1];
+    case OperationCode::ILogicalShiftRight:
+    case OperationCode::ULogicalShiftRight:
+        if (v[1] >= 32) {
+            return std::nullopt;
+        }
+        return v[0] >> v[1];
+    case OperationCode::IArithmeticShiftRight:
+        if (v[1] >= 32) {
+            return std::nullopt;
+        }
+        return static_cast<u32>(as_signed(0) >> v[1]);
+    case OperationCode::IBitwiseAnd:
+    case OperationCode::UBitwiseAnd:
+        return v[0] & v[1];
+    case OperationCode::IBitwiseOr:
+    case OperationCode::UBitwiseOr:
+        return v[0] | v[1];
+    case OperationCode::IBitwiseXor:
+    case OperationCode::UBitwiseXor:
+        return v[0] ^ v[1];
+    case OperationCode::IBitwiseNot:
+    case OperationCode::UBitwiseNot:
+        return ~v[0];
+    case OperationCode::IBitfieldInsert:
+    case OperationCode::UBitfieldInsert: {
+        const u32 offset = v[2];
+        const u32 bits = v[3];
+        if (offset > 32 || bits > 32 - offset) {
+            return std::nullopt;
+        }
+        if (bits == 0) {
+            return v[0];
+        }
+        const u32 mask = (bits == 32 ? ~0U : (1U << bits) - 1) << offset;
+        return (v[0] & ~mask) | ((v[1] << offset) & mask);
+    }
+    case OperationCode::IBitfieldExtract:
+    case OperationCode::UBitfieldExtract: {
+        const u32 offset = v[1];
+        const u32 bits = v[2];
+        if (offset > 32 || bits > 32 - offset) {
+            return std::nullopt;
+        }
+        if (bits == 0) {
+            return 0U;
+        }
+        const u32 value = ExtractBits(v[0], offset, bits);
+        if (code == OperationCode::UBitfieldExtract || bits == 32) {
+            return value;
+        }
+        const u32 sign_bit = 1U << (bits - 1);
+        return (value ^ sign_bit) - sign_bit;
+    }
+    case OperationCode::IBitCount:
+    case OperationCode::UBitCount: {
+        u32 ones = 0;
+        for (u32 value = v[0]; value != 0; value &= value - 1) {
+            ++ones;
+        }
+        return ones;
+    }
+    default:
+        return std::nullopt;
+    }
+}
+
+class Optimizer final {
+public:
+    void Visit(const Node& node) {
+        if (!node || !visited.insert(node).second) {
+            return;
+        }
+        if (const auto operation = std::get_if<OperationNode>(node)) {
+            for (std::size_t i = 0; i < operation->GetOperandsCount(); ++i) {
+                Visit((*operation)[i]);
+            }
+            Simplify(node, *operation);
+        } else if (const auto conditional = std::get_if<ConditionalNode>(node)) {
+            Visit(conditional->GetCondition());
+            for (const Node& child : conditional->GetCode()) {
+                Visit(child);
+            }
+        } else if (const auto abuf = std::get_if<AbufNode>(node)) {
+            Visit(abuf->GetPhysicalAddress());
+            Visit(abuf->GetBuffer());
+        } else if (const auto cbuf = std::get_if<CbufNode>(node)) {
+            Visit(cbuf->GetOffset());
+        } else if (const auto lmem = std::get_if<LmemNode>(node)) {
+            Visit(lmem->GetAddress());
+        } else if (const auto smem = std::get_if<SmemNode>(node)) {
+            Visit(smem->GetAddress());
+        } else if (const auto gmem = std::get_if<GmemNode>(node)) {
+            Visit(gmem->GetRealAddress());
+            Visit(gmem->GetBaseAddress());
+        }
+    }
+
+private:
+    /// Rewrites an operation in place, nodes are shared so every user sees the simpler form.
+    void Simplify(const Node& node, const OperationNode& operation) {
+        const OperationCode code = operation.GetCode();
+        const std::size_t count = operation.GetOperandsCount();
+
+        if (count <= MAX_FOLDED_OPERANDS) {
+            std::array<u32, MAX_FOLDED_OPERANDS> values{};
+            bool is_constant = true;
+            for (std::size_t i = 0; i < count && is_constant; ++i) {
+                const auto value = GetImmediate(operation[i]);
+                is_constant = value.has_value();
+                values[i] = value.value_or(0);
+            }
+            if (is_constant) {
+                if (const auto result = Evaluate(code, values)) {
+                    node->emplace<ImmediateNode>(*result);
+                    return;
+                }
+            }
+        }
+
+        switch (code) {
+        case OperationCode::IAdd:
+        case OperationCode::UAdd:
+        case OperationCode::IBitwiseOr:
+        case OperationCode::UBitwiseOr:
+        case OperationCode::IBitwiseXor:
+        case OperationCode::UBitwiseXor:
+            SimplifyIdentity(node, operation, 0);
+            break;
+        case OperationCode::IMul:
+        case OperationCode::UMul:
+            if (!SimplifyAbsorbing(node, operation, 0)) {
+                SimplifyIdentity(node, operation, 1);
+            }
+            break;
+        case OperationCode::IBitwiseAnd:
+        case OperationCode::UBitwiseAnd:
+            if (!SimplifyAbsorbing(node, operation, 0)) {
+                SimplifyIdentity(node, operation, ~0U);
+            }
+            break;
+        case OperationCode::ILogicalShiftLeft:
+        case OperationCode::ULogicalShiftLeft:
+        case OperationCode::ILogicalShiftRight:
+        case OperationCode::ULogicalShiftRight:
+        case OperationCode::IArithmeticShiftRight:
+            if (GetImmediate(operation[1]) == 0U) {
+                Replace(node, operation[0]);
+            }
+            break;
+        case OperationCode::LogicalAnd:
+            SimplifyLogical(node, operation, true);
+            break;
+        case OperationCode::LogicalOr:
+            SimplifyLogical(node, operation, false);
+            break;
+        case OperationCode::LogicalNegate:
+            SimplifyNegate(node, operation);
+            break;
+        default:
+            break;
+        }
+    }
+
+    /// Replaces a binary operation with one of its operands when the other is its identity.
+    void SimplifyIdentity(const Node& node, const OperationNode& operation, u32 identity) {
+        if (GetImmediate(operation[1]) == identity) {
+            Replace(node, operation[0]);
+        } else if (GetImmediate(operation[0]) == identity) {
+            Replace(node, operation[1]);
+        }
+    }
+
+    /// Replaces a binary operation with a value that absorbs any other operand.
+    bool SimplifyAbsorbing(const Node& node, const OperationNode& operation, u32 absorbing) {
+        if (GetImmediate(operation[0]) != absorbing && GetImmediate(operation[1]) != absorbing) {
+            return false;
+        }
+        node->emplace<ImmediateNode>(absorbing);
+        return true;
+    }
+
+    /// Simplifies and'ing (or or'ing) with a constant predicate.
+    void SimplifyLogical(const Node& node, const OperationNode& operation, bool identity) {
+        for (std::size_t i = 0; i < 2; ++i) {
+            const auto constant = GetConstantPredicate(operation[i]);
+            if (!constant) {
+                continue;
+            }
+            if (*constant == identity) {
+                Replace(node, operation[1 - i]);
+            } else {
+                Replace(node, operation[i]);
+            }
+            return;
+        }
+    }
+
+    void SimplifyNegate(const Node& node, const OperationNode& operation) {
+        const Node& operand = operation[0];
+        if (const auto predicate = std::get_if<PredicateNode>(operand)) {
+            node->emplace<PredicateNode>(predicate->GetIndex(), !predicate->IsNegated());
+            return;
+        }
+        const auto inner = std::get_if<OperationNode>(operand);
+        if (inner && inner->GetCode() == OperationCode::LogicalNegate) {
+            Replace(node, (*inner)[0]);
+        }
+    }
+
+    /// Makes a node hold a copy of another one. Nodes are emplaced as operations aren't
+    /// assignable, and the copy is taken first as the other node may be owned by this one.
+    static void Replace(const Node& node, const Node& value) {
+        NodeData copy = *value;
+        std::visit(
+            [&node](auto&& data) { node->emplace<std::decay_t<decltype(data)>>(std::move(data)); },
+            std::move(copy));
+    }
+
+    std::unordered_set<const NodeData*> visited;
+};
+
+} // Anonymous namespace
+
+void OptimizeCode(NodeBlock& code, std::size_t begin) {
+    Optimizer optimizer;
+    for (std::size_t i = begin; i < code.size(); ++i) {
+        optimizer.Visit(code[i]);
+    }
+}
+
+} // namespace VideoCommon::Shader
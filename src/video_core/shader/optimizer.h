@@ -0,0 +1,23 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+
+#include "video_core/shader/node.h"
+
+namespace VideoCommon::Shader {
+
+/**
+ * Simplifies the expressions of decoded code in place, shared by every backend. Integer
+ * operations on immediates are folded, algebraic identities (e.g. adding zero, masking with all
+ * ones, and'ing with a true predicate) are removed and double negations are collapsed. Floating
+ * point operations are left untouched as host rounding may differ from the guest's.
+ * @param code  Block holding the code to simplify.
+ * @param begin Index of the first node of the block to simplify.
+ */
+void OptimizeCode(NodeBlock& code, std::size_t begin = 0);
+
+} // namespace VideoCommon::Shader
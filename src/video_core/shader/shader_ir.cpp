@@ -26,6 +26,7 @@ using Tegra::Shader::Register;
 ShaderIR::ShaderIR(const ProgramCode& program_code, u32 main_offset, CompilerSettings settings,
                    ConstBufferLocker& locker)
     : program_code{program_code}, main_offset{main_offset}, settings{settings}, locker{locker} {
+    NodeArena::Scope scope{node_arena};
     Decode();
 }
 
@@ -383,6 +384,7 @@ OperationCode ShaderIR::GetPredicateCombiner(PredOperation operation) {
 }
 
 Node ShaderIR::GetConditionCode(Tegra::Shader::ConditionCode cc) const {
+    NodeArena::Scope scope{node_arena};
     switch (cc) {
     case Tegra::Shader::ConditionCode::NEU:
         return GetInternalFlag(InternalFlag::Zero, true);
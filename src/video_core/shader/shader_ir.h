@@ -20,6 +20,7 @@
 #include "video_core/shader/compiler_settings.h"
 #include "video_core/shader/const_buffer_locker.h"
 #include "video_core/shader/node.h"
+#include "video_core/shader/node_arena.h"
 
 namespace VideoCommon::Shader {
 
@@ -141,6 +142,10 @@ public:
         return uses_physical_attributes;
     }
 
+    bool UsesWarps() const {
+        return uses_warps;
+    }
+
     const Tegra::Shader::Header& GetHeader() const {
         return header;
     }
@@ -391,6 +396,9 @@ private:
     u32 coverage_begin{};
     u32 coverage_end{};
 
+    /// Owner of every node of the shader, mutable for the nodes made by const queries
+    mutable NodeArena node_arena;
+
     std::map<u32, NodeBlock> basic_blocks;
     NodeBlock global_code;
     ASTManager program_manager{true, true};
@@ -410,6 +418,7 @@ private:
     bool uses_physical_attributes{}; // Shader uses AL2P or physical attribute read/writes
     bool uses_instance_id{};
     bool uses_vertex_id{};
+    bool uses_warps{}; // Shader uses VOTE or SHFL
 
     Tegra::Shader::Header header;
 };
@@ -0,0 +1,126 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/gpu.h"
+#include "video_core/memory_manager.h"
+#include "video_core/rasterizer_interface.h"
+
+namespace VideoCommon {
+
+/**
+ * Caches the entries of a guest descriptor table (TIC or TSC). The pages of the table are marked
+ * as cached so guest writes to them go through the rasterizer, which invalidates the written
+ * entries. Reading a descriptor that wasn't written since it was last read is an array lookup.
+ */
+template <typename Descriptor>
+class DescriptorTable {
+public:
+    explicit DescriptorTable(VideoCore::RasterizerInterface& rasterizer,
+                             Tegra::MemoryManager& memory_manager)
+        : rasterizer{rasterizer}, memory_manager{memory_manager} {}
+
+    ~DescriptorTable() {
+        Release();
+    }
+
+    /// Points the table at the given guest address, dropping the cached entries when it moved.
+    /// The limit is the index of the last entry, as programmed in the engine registers.
+    void Refresh(GPUVAddr gpu_addr, u32 limit) {
+        if (gpu_addr == current_gpu_addr && limit == current_limit &&
+            ToCacheAddr(memory_manager.GetPointer(gpu_addr)) == base_addr) {
+            return;
+        }
+        Release();
+        current_gpu_addr = gpu_addr;
+        current_limit = limit;
+        // Remembered to notice when the guest maps other memory at the same address
+        base_addr = ToCacheAddr(memory_manager.GetPointer(gpu_addr));
+
+        const std::size_t size = (static_cast<std::size_t>(limit) + 1) * sizeof(Descriptor);
+        const u8* const host_ptr = memory_manager.GetContiguousSpan(gpu_addr, size);
+        const std::optional<VAddr> cpu_addr = memory_manager.GpuToCpuAddress(gpu_addr);
+        if (!host_ptr || !cpu_addr) {
+            // Tables spanning discontiguous memory are read on each access
+            return;
+        }
+        cache_addr = ToCacheAddr(host_ptr);
+        cache_size = size;
+        cached_cpu_addr = *cpu_addr;
+        rasterizer.UpdatePagesCachedCount(cached_cpu_addr, cache_size, 1);
+    }
+
+    /// Returns the descriptor at the given index, reading it from guest memory when not cached.
+    Descriptor Read(u32 index) {
+        if (cache_addr == 0 || index > current_limit) {
+            return ReadGuest(index);
+        }
+        if (index >= descriptors.size()) {
+            descriptors.resize(static_cast<std::size_t>(index) + 1);
+            valid.resize(static_cast<std::size_t>(index) + 1, false);
+        }
+        if (!valid[index]) {
+            descriptors[index] = ReadGuest(index);
+            valid[index] = true;
+        }
+        return descriptors[index];
+    }
+
+    /// Drops the cached entries overlapping a region written by the guest.
+    void InvalidateRegion(CacheAddr addr, u64 size) {
+        const CacheAddr cache_end = cache_addr + cache_size;
+        if (cache_addr == 0 || addr >= cache_end || addr + size <= cache_addr) {
+            return;
+        }
+        const std::size_t first = (std::max(addr, cache_addr) - cache_addr) / sizeof(Descriptor);
+        const std::size_t last =
+            (std::min<CacheAddr>(addr + size, cache_end) - cache_addr - 1) / sizeof(Descriptor);
+        if (first >= valid.size()) {
+            return;
+        }
+        const std::size_t end = std::min(last + 1, valid.size());
+        std::fill(valid.begin() + first, valid.begin() + end, false);
+    }
+
+private:
+    Descriptor ReadGuest(u32 index) const {
+        Descriptor descriptor;
+        memory_manager.ReadBlockUnsafe(current_gpu_addr + index * sizeof(Descriptor), &descriptor,
+                                       sizeof(Descriptor));
+        return descriptor;
+    }
+
+    void Release() {
+        if (cache_addr != 0) {
+            rasterizer.UpdatePagesCachedCount(cached_cpu_addr, cache_size, -1);
+        }
+        cache_addr = 0;
+        cache_size = 0;
+        descriptors.clear();
+        valid.clear();
+    }
+
+    VideoCore::RasterizerInterface& rasterizer;
+    Tegra::MemoryManager& memory_manager;
+
+    GPUVAddr current_gpu_addr{};
+    u32 current_limit{};
+    CacheAddr base_addr{};
+
+    CacheAddr cache_addr{};
+    std::size_t cache_size{};
+    VAddr cached_cpu_addr{};
+
+    std::vector<Descriptor> descriptors;
+    std::vector<bool> valid;
+};
+
+} // namespace VideoCommon
@@ -26,7 +26,8 @@ StagingCache::~StagingCache() = default;
 
 SurfaceBaseImpl::SurfaceBaseImpl(GPUVAddr gpu_addr, const SurfaceParams& params)
     : params{params}, host_memory_size{params.GetHostSizeInBytes()}, gpu_addr{gpu_addr},
-      mipmap_sizes(params.num_levels), mipmap_offsets(params.num_levels) {
+      mipmap_sizes(params.num_levels), mipmap_offsets(params.num_levels),
+      dirty_subresources((params.is_layered ? params.depth : 1) * params.num_levels) {
     std::size_t offset = 0;
     for (u32 level = 0; level < params.num_levels; ++level) {
         const std::size_t mipmap_size{params.GetGuestMipmapSize(level)};
@@ -125,6 +126,42 @@ std::optional<std::pair<u32, u32>> SurfaceBaseImpl::GetLayerMipmap(
     return std::make_pair(layer, level);
 }
 
+bool SurfaceBaseImpl::MarkRegionAsDirty(const CacheAddr start, const CacheAddr end) {
+    if (end <= cache_addr || start >= cache_addr_end) {
+        return num_dirty_subresources == dirty_subresources.size();
+    }
+    const std::size_t begin_offset = start > cache_addr ? start - cache_addr : 0;
+    const std::size_t end_offset = std::min<std::size_t>(end - cache_addr, guest_memory_size);
+    const u32 num_layers = params.is_layered ? params.depth : 1;
+    for (u32 layer = static_cast<u32>(begin_offset / layer_size);
+         layer < num_layers && layer * layer_size < end_offset; ++layer) {
+        const std::size_t layer_offset = layer * layer_size;
+        for (u32 level = 0; level < params.num_levels; ++level) {
+            const std::size_t level_begin = layer_offset + mipmap_offsets[level];
+            const std::size_t level_end = level_begin + mipmap_sizes[level];
+            if (level_begin >= end_offset || level_end <= begin_offset) {
+                continue;
+            }
+            const std::size_t index = static_cast<std::size_t>(layer) * params.num_levels + level;
+            if (!dirty_subresources[index]) {
+                dirty_subresources[index] = true;
+                ++num_dirty_subresources;
+            }
+        }
+    }
+    return num_dirty_subresources == dirty_subresources.size();
+}
+
+bool SurfaceBaseImpl::IsLevelDirty(const u32 level) const {
+    const u32 num_layers = params.is_layered ? params.depth : 1;
+    for (u32 layer = 0; layer < num_layers; ++layer) {
+        if (IsSubresourceDirty(layer, level)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::vector<CopyParams> SurfaceBaseImpl::BreakDownLayered(const SurfaceParams& in_params) const {
     const u32 layers{params.depth};
     const u32 mipmaps{params.num_levels};
@@ -168,39 +205,44 @@ void SurfaceBaseImpl::SwizzleFunc(MortonSwizzleMode mode, u8* memory, const Surf
         const std::size_t guest_stride = layer_size;
         const std::size_t host_stride = params.GetHostLayerSize(level);
         for (u32 layer = 0; layer < params.depth; ++layer) {
-            MortonSwizzle(mode, params.pixel_format, width, block_height, height, block_depth, 1,
-                          params.tile_width_spacing, buffer + host_offset, memory + guest_offset);
+            if (IsSubresourceDirty(layer, level)) {
+                MortonSwizzle(mode, params.pixel_format, width, block_height, height, block_depth,
+                              1, params.tile_width_spacing, buffer + host_offset,
+                              memory + guest_offset);
+            }
             guest_offset += guest_stride;
             host_offset += host_stride;
         }
-    } else {
+    } else if (IsSubresourceDirty(0, level)) {
         MortonSwizzle(mode, params.pixel_format, width, block_height, height, block_depth,
                       params.GetMipDepth(level), params.tile_width_spacing, buffer,
                       memory + guest_offset);
     }
 }
 
-void SurfaceBaseImpl::LoadBuffer(Tegra::MemoryManager& memory_manager,
-                                 StagingCache& staging_cache) {
-    MICROPROFILE_SCOPE(GPU_Load_Texture);
-    auto& staging_buffer = staging_cache.GetBuffer(0);
-    u8* host_ptr;
-    is_continuous = memory_manager.IsBlockContinuous(gpu_addr, guest_memory_size);
+u8* SurfaceBaseImpl::GetGuestData(Tegra::MemoryManager& memory_manager,
+                                  StagingCache& staging_cache) {
+    u8* const host_ptr = memory_manager.GetContiguousSpan(gpu_addr, guest_memory_size);
+    is_continuous = host_ptr != nullptr;
 
     // Handle continuouty
     if (is_continuous) {
         // Use physical memory directly
-        host_ptr = memory_manager.GetPointer(gpu_addr);
-        if (!host_ptr) {
-            return;
-        }
-    } else {
-        // Use an extra temporal buffer
-        auto& tmp_buffer = staging_cache.GetBuffer(1);
-        tmp_buffer.resize(guest_memory_size);
-        host_ptr = tmp_buffer.data();
-        memory_manager.ReadBlockUnsafe(gpu_addr, host_ptr, guest_memory_size);
+        return host_ptr;
     }
+    // Use an extra temporal buffer
+    auto& tmp_buffer = staging_cache.GetBuffer(1);
+    tmp_buffer.resize(guest_memory_size);
+    memory_manager.ReadBlockUnsafe(gpu_addr, tmp_buffer.data(), guest_memory_size);
+    return tmp_buffer.data();
+}
+
+void SurfaceBaseImpl::LoadBuffer(u8* host_ptr, StagingCache& staging_cache) {
+    MICROPROFILE_SCOPE(GPU_Load_Texture);
+    if (!host_ptr) {
+        return;
+    }
+    auto& staging_buffer = staging_cache.GetBuffer(0);
 
     if (params.is_tiled) {
         ASSERT_MSG(params.block_width == 0, "Block width is defined as {} on texture target {}",
@@ -238,6 +280,9 @@ void SurfaceBaseImpl::LoadBuffer(Tegra::MemoryManager& memory_manager,
 
     for (u32 level_up = params.num_levels; level_up > 0; --level_up) {
         const u32 level = level_up - 1;
+        if (!IsLevelDirty(level)) {
+            continue;
+        }
         const std::size_t in_host_offset{params.GetHostMipmapLevelOffset(level)};
         const std::size_t out_host_offset = compression_type == SurfaceCompression::Rearranged
                                                 ? in_host_offset
@@ -268,6 +313,10 @@ void SurfaceBaseImpl::FlushBuffer(Tegra::MemoryManager& memory_manager,
         auto& tmp_buffer = staging_cache.GetBuffer(1);
         tmp_buffer.resize(guest_memory_size);
         host_ptr = tmp_buffer.data();
+        if (HasDirtySubresources()) {
+            // Only dirty subresources are written, keep the guest data of the others
+            memory_manager.ReadBlockUnsafe(gpu_addr, host_ptr, guest_memory_size);
+        }
     }
 
     if (params.is_tiled) {
@@ -4,12 +4,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <optional>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
 
 #include "common/common_types.h"
+#include "common/math_util.h"
 #include "video_core/gpu.h"
 #include "video_core/morton.h"
 #include "video_core/texture_cache/copy_params.h"
@@ -37,6 +40,17 @@ enum class MatchTopologyResult : u32 {
     None = 2,
 };
 
+/// Value a surface is cleared to, color surfaces use the color and depth surfaces the rest.
+struct ClearValue {
+    std::array<float, 4> color{};
+    float depth{};
+    s32 stencil{};
+
+    bool operator==(const ClearValue& rhs) const {
+        return std::tie(color, depth, stencil) == std::tie(rhs.color, rhs.depth, rhs.stencil);
+    }
+};
+
 class StagingCache {
 public:
     explicit StagingCache();
@@ -60,10 +74,43 @@ private:
 
 class SurfaceBaseImpl {
 public:
-    void LoadBuffer(Tegra::MemoryManager& memory_manager, StagingCache& staging_cache);
+    /**
+     * Returns a pointer to the guest memory of the surface, reading it into the second staging
+     * buffer when it isn't contiguous in GPU memory. Returns nullptr when it isn't mapped.
+     */
+    u8* GetGuestData(Tegra::MemoryManager& memory_manager, StagingCache& staging_cache);
+
+    /// Converts the guest data returned by GetGuestData into the first staging buffer.
+    void LoadBuffer(u8* host_ptr, StagingCache& staging_cache);
 
     void FlushBuffer(Tegra::MemoryManager& memory_manager, StagingCache& staging_cache);
 
+    /**
+     * Marks the subresources overlapping the given region as dirty. Once a subresource is dirty,
+     * loads and flushes only process the dirty ones until ClearDirtySubresources is called.
+     * @returns True when every subresource of the surface is dirty.
+     */
+    bool MarkRegionAsDirty(CacheAddr start, CacheAddr end);
+
+    void ClearDirtySubresources() {
+        std::fill(dirty_subresources.begin(), dirty_subresources.end(), false);
+        num_dirty_subresources = 0;
+    }
+
+    bool HasDirtySubresources() const {
+        return num_dirty_subresources != 0;
+    }
+
+    /// Returns true when the given subresource has to be processed, that is when it's dirty or
+    /// when no subresource is.
+    bool IsSubresourceDirty(u32 layer, u32 level) const {
+        return num_dirty_subresources == 0 ||
+               dirty_subresources[static_cast<std::size_t>(layer) * params.num_levels + level];
+    }
+
+    /// Returns true when any layer of the given level has to be processed.
+    bool IsLevelDirty(u32 level) const;
+
     GPUVAddr GetGpuAddr() const {
         return gpu_addr;
     }
@@ -178,6 +225,10 @@ protected:
     std::vector<std::size_t> mipmap_sizes;
     std::vector<std::size_t> mipmap_offsets;
 
+    /// Dirty state of each subresource, indexed by layer and then by level.
+    std::vector<bool> dirty_subresources;
+    std::size_t num_dirty_subresources{};
+
 private:
     void SwizzleFunc(MortonSwizzleMode mode, u8* memory, const SurfaceParams& params, u8* buffer,
                      u32 level);
@@ -197,6 +248,42 @@ public:
     void MarkAsModified(bool is_modified_, u64 tick) {
         is_modified = is_modified_ || is_target;
         modification_tick = tick;
+        InvalidateClear();
+    }
+
+    /// Records that the given rectangle of the first level, in guest texels, holds the value of
+    /// a clear. It replaces the previous record unless it's a part of it cleared to the same value.
+    void MarkAsCleared(const ClearValue& value, const Common::Rectangle<u32>& rect) {
+        const Common::Rectangle<u32> clamped{std::min(rect.left, params.width),
+                                             std::min(rect.top, params.height),
+                                             std::min(rect.right, params.width),
+                                             std::min(rect.bottom, params.height)};
+        if (IsClearedTo(value, clamped)) {
+            return;
+        }
+        clear_value = value;
+        clear_rect = clamped;
+    }
+
+    /// Forgets the clear record, the contents of the surface are no longer known.
+    void InvalidateClear() {
+        clear_value.reset();
+    }
+
+    /// Returns true when the given rectangle is known to hold the given clear value.
+    bool IsClearedTo(const ClearValue& value, const Common::Rectangle<u32>& rect) const {
+        return clear_value && *clear_value == value && clear_rect.left <= rect.left &&
+               clear_rect.top <= rect.top && rect.right <= clear_rect.right &&
+               rect.bottom <= clear_rect.bottom;
+    }
+
+    /// Returns the value the whole surface was cleared to, if there is one.
+    std::optional<ClearValue> GetFullClearValue() const {
+        if (!clear_value || params.num_levels != 1 ||
+            !IsClearedTo(*clear_value, {0, 0, params.width, params.height})) {
+            return std::nullopt;
+        }
+        return clear_value;
     }
 
     void MarkAsRenderTarget(bool is_target_, u32 index_) {
@@ -204,10 +291,6 @@ public:
         index = index_;
     }
 
-    void MarkAsPicked(bool is_picked_) {
-        is_picked = is_picked_;
-    }
-
     bool IsModified() const {
         return is_modified;
     }
@@ -229,10 +312,6 @@ public:
         return is_registered;
     }
 
-    bool IsPicked() const {
-        return is_picked;
-    }
-
     void MarkAsRegistered(bool is_reg) {
         is_registered = is_reg;
     }
@@ -241,6 +320,14 @@ public:
         return modification_tick;
     }
 
+    void MarkAsUsed(u64 frame) {
+        last_frame_used = frame;
+    }
+
+    u64 GetLastFrameUsed() const {
+        return last_frame_used;
+    }
+
     TView EmplaceOverview(const SurfaceParams& overview_params) {
         const u32 num_layers{(params.is_layered && !overview_params.is_layered) ? 1 : params.depth};
         return GetView(ViewParams(overview_params.target, 0, num_layers, 0, params.num_levels));
@@ -316,9 +403,12 @@ private:
     bool is_modified{};
     bool is_target{};
     bool is_registered{};
-    bool is_picked{};
     u32 index{NO_RT};
     u64 modification_tick{};
+    u64 last_frame_used{};
+
+    std::optional<ClearValue> clear_value;
+    Common::Rectangle<u32> clear_rect;
 };
 
 } // namespace VideoCommon
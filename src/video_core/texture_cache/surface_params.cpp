@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <map>
 
 #include "common/alignment.h"
@@ -10,14 +11,17 @@
 #include "video_core/engines/shader_bytecode.h"
 #include "video_core/surface.h"
 #include "video_core/texture_cache/surface_params.h"
+#include "video_core/video_core.h"
 
 namespace VideoCommon {
 
+using VideoCore::Surface::ComponentType;
 using VideoCore::Surface::ComponentTypeFromDepthFormat;
 using VideoCore::Surface::ComponentTypeFromRenderTarget;
 using VideoCore::Surface::ComponentTypeFromTexture;
 using VideoCore::Surface::PixelFormat;
 using VideoCore::Surface::PixelFormatFromDepthFormat;
+using VideoCore::Surface::PixelFormatFromGPUPixelFormat;
 using VideoCore::Surface::PixelFormatFromRenderTargetFormat;
 using VideoCore::Surface::PixelFormatFromTextureFormat;
 using VideoCore::Surface::SurfaceTarget;
@@ -26,6 +30,15 @@ using VideoCore::Surface::SurfaceType;
 
 namespace {
 
+/// Highest factor render targets are scaled by, the largest option offered by the frontends.
+constexpr u32 MAX_RESOLUTION_SCALE = 4;
+
+/// Returns the factor render targets are scaled by, 1 when they are drawn at native resolution.
+u32 GetResolutionScale(Core::System& system) {
+    const u32 factor = VideoCore::GetResolutionScaleFactor(system.Renderer());
+    return std::clamp(factor, 1U, MAX_RESOLUTION_SCALE);
+}
+
 SurfaceTarget TextureTypeToSurfaceTarget(Tegra::Shader::TextureType type, bool is_array) {
     switch (type) {
     case Tegra::Shader::TextureType::Texture1D:
@@ -110,6 +123,7 @@ SurfaceParams SurfaceParams::CreateForTexture(const Tegra::Texture::TICEntry& ti
         params.depth = 1;
         params.num_levels = 1;
         params.emulated_levels = 1;
+        params.resolution_scale = 1;
         params.is_layered = false;
     } else {
         params.target = TextureTypeToSurfaceTarget(entry.GetType(), entry.IsArray());
@@ -123,6 +137,7 @@ SurfaceParams SurfaceParams::CreateForTexture(const Tegra::Texture::TICEntry& ti
         }
         params.num_levels = tic.max_mip_level + 1;
         params.emulated_levels = std::min(params.num_levels, params.MaxPossibleMipmap());
+        params.resolution_scale = 1;
         params.is_layered = params.IsLayered();
     }
     return params;
@@ -152,6 +167,7 @@ SurfaceParams SurfaceParams::CreateForImage(const Tegra::Texture::TICEntry& tic,
         params.depth = 1;
         params.num_levels = 1;
         params.emulated_levels = 1;
+        params.resolution_scale = 1;
         params.is_layered = false;
     } else {
         params.width = tic.Width();
@@ -164,6 +180,7 @@ SurfaceParams SurfaceParams::CreateForImage(const Tegra::Texture::TICEntry& tic,
         }
         params.num_levels = tic.max_mip_level + 1;
         params.emulated_levels = std::min(params.num_levels, params.MaxPossibleMipmap());
+        params.resolution_scale = 1;
         params.is_layered = params.IsLayered();
     }
     return params;
@@ -191,6 +208,7 @@ SurfaceParams SurfaceParams::CreateForDepthBuffer(
     params.num_levels = 1;
     params.emulated_levels = 1;
     params.is_layered = false;
+    params.resolution_scale = params.IsScalable() ? GetResolutionScale(system) : 1;
     return params;
 }
 
@@ -222,6 +240,7 @@ SurfaceParams SurfaceParams::CreateForFramebuffer(Core::System& system, std::siz
     params.num_levels = 1;
     params.emulated_levels = 1;
     params.is_layered = false;
+    params.resolution_scale = params.IsScalable() ? GetResolutionScale(system) : 1;
     return params;
 }
 
@@ -246,10 +265,35 @@ SurfaceParams SurfaceParams::CreateForFermiCopySurface(
     params.depth = 1;
     params.num_levels = 1;
     params.emulated_levels = 1;
+    params.resolution_scale = 1;
     params.is_layered = params.IsLayered();
     return params;
 }
 
+SurfaceParams SurfaceParams::CreateForDisplay(const Tegra::FramebufferConfig& config) {
+    SurfaceParams params{};
+    params.is_tiled = true;
+    params.srgb_conversion = false;
+    // TODO(Rodrigo): Read this from HLE
+    params.block_width = 0;
+    params.block_height = 4;
+    params.block_depth = 0;
+    params.tile_width_spacing = 1;
+    params.pixel_format = PixelFormatFromGPUPixelFormat(config.pixel_format);
+    params.component_type = ComponentType::UNorm;
+    params.type = GetFormatType(params.pixel_format);
+    params.width = config.width;
+    params.height = config.height;
+    params.pitch = 0;
+    params.target = SurfaceTarget::Texture2D;
+    params.depth = 1;
+    params.num_levels = 1;
+    params.emulated_levels = 1;
+    params.resolution_scale = 1;
+    params.is_layered = false;
+    return params;
+}
+
 bool SurfaceParams::IsLayered() const {
     switch (target) {
     case SurfaceTarget::Texture1DArray:
@@ -355,10 +399,12 @@ std::size_t SurfaceParams::GetInnerMipmapMemorySize(u32 level, bool as_host_size
 
 bool SurfaceParams::operator==(const SurfaceParams& rhs) const {
     return std::tie(is_tiled, block_width, block_height, block_depth, tile_width_spacing, width,
-                    height, depth, pitch, num_levels, pixel_format, component_type, type, target) ==
+                    height, depth, pitch, num_levels, resolution_scale, pixel_format,
+                    component_type, type, target) ==
            std::tie(rhs.is_tiled, rhs.block_width, rhs.block_height, rhs.block_depth,
                     rhs.tile_width_spacing, rhs.width, rhs.height, rhs.depth, rhs.pitch,
-                    rhs.num_levels, rhs.pixel_format, rhs.component_type, rhs.type, rhs.target);
+                    rhs.num_levels, rhs.resolution_scale, rhs.pixel_format, rhs.component_type,
+                    rhs.type, rhs.target);
 }
 
 std::string SurfaceParams::TargetName() const {
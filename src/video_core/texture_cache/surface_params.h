@@ -41,6 +41,9 @@ public:
     static SurfaceParams CreateForFermiCopySurface(
         const Tegra::Engines::Fermi2D::Regs::Surface& config);
 
+    /// Creates SurfaceCachedParams from a framebuffer presented to a display.
+    static SurfaceParams CreateForDisplay(const Tegra::FramebufferConfig& config);
+
     std::size_t Hash() const {
         return static_cast<std::size_t>(
             Common::CityHash64(reinterpret_cast<const char*>(this), sizeof(*this)));
@@ -186,6 +189,28 @@ public:
         return target == VideoCore::Surface::SurfaceTarget::TextureBuffer;
     }
 
+    /// Returns true if the surface can be rendered at a higher resolution than the guest's.
+    bool IsScalable() const {
+        return target == VideoCore::Surface::SurfaceTarget::Texture2D && is_tiled &&
+               num_levels == 1 && !IsCompressed() &&
+               GetCompressionType() == SurfaceCompression::None;
+    }
+
+    /// Returns the resolution scale of a surface replacing another one with the given scale.
+    u32 GetInheritedResolutionScale(u32 replaced_scale) const {
+        return IsScalable() ? std::max(resolution_scale, replaced_scale) : 1;
+    }
+
+    /// Returns the width of the host texture, scaled by the resolution scale.
+    u32 GetScaledWidth() const {
+        return width * resolution_scale;
+    }
+
+    /// Returns the height of the host texture, scaled by the resolution scale.
+    u32 GetScaledHeight() const {
+        return height * resolution_scale;
+    }
+
     /// Returns the debug name of the texture for use in graphic debuggers.
     std::string TargetName() const;
 
@@ -247,6 +272,7 @@ public:
     u32 pitch;
     u32 num_levels;
     u32 emulated_levels;
+    u32 resolution_scale; ///< Factor the host texture is scaled by, 1 at native resolution.
     VideoCore::Surface::PixelFormat pixel_format;
     VideoCore::Surface::ComponentType component_type;
     VideoCore::Surface::SurfaceType type;
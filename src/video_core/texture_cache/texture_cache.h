@@ -7,31 +7,31 @@
 #include <algorithm>
 #include <array>
 #include <memory>
-#include <mutex>
-#include <set>
+#include <optional>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
 
-#include <boost/icl/interval_map.hpp>
-#include <boost/range/iterator_range.hpp>
-
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/math_util.h"
+#include "common/thread_pool.h"
 #include "core/core.h"
 #include "core/memory.h"
 #include "core/settings.h"
 #include "video_core/engines/fermi_2d.h"
 #include "video_core/engines/maxwell_3d.h"
+#include "video_core/engines/maxwell_dma.h"
 #include "video_core/gpu.h"
 #include "video_core/memory_manager.h"
+#include "video_core/page_index.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/surface.h"
 #include "video_core/texture_cache/copy_params.h"
 #include "video_core/texture_cache/surface_base.h"
 #include "video_core/texture_cache/surface_params.h"
 #include "video_core/texture_cache/surface_view.h"
+#include "video_core/texture_cache/texture_disk_cache.h"
 
 namespace Tegra::Texture {
 struct FullTextureInfo;
@@ -43,21 +43,47 @@ class RasterizerInterface;
 
 namespace VideoCommon {
 
+using VideoCore::Surface::ComponentType;
 using VideoCore::Surface::PixelFormat;
 
+using VideoCore::Surface::SurfaceCompression;
 using VideoCore::Surface::SurfaceTarget;
+using VideoCore::Surface::SurfaceType;
 using RenderTargetConfig = Tegra::Engines::Maxwell3D::Regs::RenderTargetConfig;
 
+/// Guest texture decoded on a worker thread before a draw samples it, see PrefetchTextureSurface.
+class PrefetchedSurface final : public SurfaceBaseImpl {
+public:
+    explicit PrefetchedSurface(GPUVAddr gpu_addr, const SurfaceParams& params)
+        : SurfaceBaseImpl{gpu_addr, params} {
+        staging_cache.SetSize(2);
+    }
+
+    StagingCache staging_cache;
+    Common::TaskHandle task;
+    u64 disk_cache_key{};
+
+protected:
+    void DecorateSurfaceName() override {}
+};
+
 template <typename TSurface, typename TView>
 class TextureCache {
-    using IntervalMap = boost::icl::interval_map<CacheAddr, std::set<TSurface>>;
-    using IntervalType = typename IntervalMap::interval_type;
-
 public:
     void InvalidateRegion(CacheAddr addr, std::size_t size) {
-        std::lock_guard lock{mutex};
-
         for (const auto& surface : GetSurfacesInRegion(addr, size)) {
+            // Surfaces only holding guest data reload the written subresources on their next use.
+            // Scaled surfaces are blitted whole from a native copy and can't be reloaded partially.
+            if (!surface->IsModified() && surface->IsContinuous() &&
+                surface->GetSurfaceParams().resolution_scale <= 1) {
+                const bool was_dirty = surface->HasDirtySubresources();
+                if (!surface->MarkRegionAsDirty(addr, addr + size)) {
+                    if (!was_dirty && surface->HasDirtySubresources()) {
+                        dirty_surfaces.push_back(surface);
+                    }
+                    continue;
+                }
+            }
             Unregister(surface);
         }
     }
@@ -75,8 +101,6 @@ public:
     }
 
     void FlushRegion(CacheAddr addr, std::size_t size) {
-        std::lock_guard lock{mutex};
-
         auto surfaces = GetSurfacesInRegion(addr, size);
         if (surfaces.empty()) {
             return;
@@ -85,13 +109,30 @@ public:
             return a->GetModificationTick() < b->GetModificationTick();
         });
         for (const auto& surface : surfaces) {
-            FlushSurface(surface);
+            FlushSurfaceRegion(surface, addr, size);
+        }
+    }
+
+    /**
+     * Advances the frame counter used to age surfaces. When the surfaces of the cache take more
+     * host memory than the configured budget, evicts the ones unused for the longest time.
+     */
+    void TickFrame() {
+        ++frame_tick;
+        const u64 budget = static_cast<u64>(Settings::values.texture_memory_budget) << 20;
+        if (budget != 0 && memory_usage > budget) {
+            EvictSurfaces(budget);
         }
     }
 
+    /// Returns the host memory in bytes taken by the surfaces of the cache, including reserved
+    /// ones.
+    u64 GetMemoryUsage() const {
+        return memory_usage;
+    }
+
     TView GetTextureSurface(const Tegra::Texture::TICEntry& tic,
                             const VideoCommon::Shader::Sampler& entry) {
-        std::lock_guard lock{mutex};
         const auto gpu_addr{tic.Address()};
         if (!gpu_addr) {
             return {};
@@ -104,9 +145,68 @@ public:
         return view;
     }
 
+    /**
+     * Starts decoding on the shared thread pool a texture that would miss the cache, so that
+     * GetTextureSurface finds its host data ready instead of decoding it in the middle of the
+     * draw. Only textures decoded on the CPU that don't overlap cached surfaces are prefetched.
+     * Prefetches are valid until DiscardPrefetches is called, once the textures of the draw are
+     * set up.
+     */
+    void PrefetchTextureSurface(const Tegra::Texture::TICEntry& tic,
+                                const VideoCommon::Shader::Sampler& entry) {
+        const GPUVAddr gpu_addr{tic.Address()};
+        if (!gpu_addr || prefetches.size() >= MAX_PREFETCHES) {
+            return;
+        }
+        auto& memory_manager = system.GPU().MemoryManager();
+        const CacheAddr cache_addr{ToCacheAddr(memory_manager.GetPointer(gpu_addr))};
+        if (!cache_addr || l1_cache.count(cache_addr) != 0) {
+            return;
+        }
+        // Textures without a conversion are unswizzled on the host GPU when possible
+        const auto params{SurfaceParams::CreateForTexture(tic, entry)};
+        const auto compression_type = params.GetCompressionType();
+        if (compression_type == SurfaceCompression::None ||
+            FindPrefetch(gpu_addr, params) != prefetches.end() ||
+            !GetSurfacesInRegion(cache_addr, params.GetGuestSizeInBytes()).empty()) {
+            return;
+        }
+
+        auto prefetch = std::make_unique<PrefetchedSurface>(gpu_addr, params);
+        u8* const guest_data = prefetch->GetGuestData(memory_manager, prefetch->staging_cache);
+        if (!guest_data) {
+            return;
+        }
+        if (compression_type == SurfaceCompression::Converted) {
+            prefetch->disk_cache_key =
+                TextureDiskCache::ComputeKey(params, guest_data, prefetch->GetSizeInBytes());
+            if (disk_cache.Contains(prefetch->disk_cache_key)) {
+                return;
+            }
+        }
+        prefetch->staging_cache.GetBuffer(0).resize(prefetch->GetHostSizeInBytes());
+
+        // The prefetch outlives its task, DiscardPrefetches waits for it
+        PrefetchedSurface* const raw_prefetch = prefetch.get();
+        prefetch->task = Common::GetThreadPool().Submit(
+            [raw_prefetch, guest_data] {
+                raw_prefetch->LoadBuffer(guest_data, raw_prefetch->staging_cache);
+            },
+            Common::TaskPriority::High);
+        prefetches.push_back(std::move(prefetch));
+    }
+
+    /// Drops the prefetches no draw has taken. Guest memory may be written after a draw, so the
+    /// decoded data can't be kept for later ones.
+    void DiscardPrefetches() {
+        for (const auto& prefetch : prefetches) {
+            prefetch->task.Wait();
+        }
+        prefetches.clear();
+    }
+
     TView GetImageSurface(const Tegra::Texture::TICEntry& tic,
                           const VideoCommon::Shader::Image& entry) {
-        std::lock_guard lock{mutex};
         const auto gpu_addr{tic.Address()};
         if (!gpu_addr) {
             return {};
@@ -128,7 +228,6 @@ public:
     }
 
     TView GetDepthBufferSurface(bool preserve_contents) {
-        std::lock_guard lock{mutex};
         auto& maxwell3d = system.GPU().Maxwell3D();
 
         if (!maxwell3d.dirty.depth_buffer) {
@@ -157,7 +256,6 @@ public:
     }
 
     TView GetColorBufferSurface(std::size_t index, bool preserve_contents) {
-        std::lock_guard lock{mutex};
         ASSERT(index < Tegra::Engines::Maxwell3D::Regs::NumRenderTargets);
         auto& maxwell3d = system.GPU().Maxwell3D();
         if (!maxwell3d.dirty.render_target[index]) {
@@ -202,6 +300,23 @@ public:
         }
     }
 
+    /**
+     * Records a clear of every component of the bound color buffer. Clears of a part of the
+     * components have to mark the buffer in use instead.
+     * @returns True when the rectangle already holds the value, the clear can be skipped then.
+     */
+    bool MarkColorBufferCleared(std::size_t index, const ClearValue& value,
+                                const Common::Rectangle<u32>& rect) {
+        return MarkTargetAsCleared(render_targets[index].target, render_targets[index].view, value,
+                                   rect);
+    }
+
+    /// Same as MarkColorBufferCleared for the depth buffer, both depth and stencil have to be
+    /// cleared when it has stencil.
+    bool MarkDepthBufferCleared(const ClearValue& value, const Common::Rectangle<u32>& rect) {
+        return MarkTargetAsCleared(depth_buffer.target, depth_buffer.view, value, rect);
+    }
+
     void SetEmptyDepthBuffer() {
         if (depth_buffer.target == nullptr) {
             return;
@@ -223,7 +338,6 @@ public:
     void DoFermiCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src_config,
                      const Tegra::Engines::Fermi2D::Regs::Surface& dst_config,
                      const Tegra::Engines::Fermi2D::Config& copy_config) {
-        std::lock_guard lock{mutex};
         SurfaceParams src_params = SurfaceParams::CreateForFermiCopySurface(src_config);
         SurfaceParams dst_params = SurfaceParams::CreateForFermiCopySurface(dst_config);
         const GPUVAddr src_gpu_addr = src_config.Address();
@@ -231,7 +345,11 @@ public:
         DeduceBestBlit(src_params, dst_params, src_gpu_addr, dst_gpu_addr);
         std::pair<TSurface, TView> dst_surface = GetSurface(dst_gpu_addr, dst_params, true, false);
         std::pair<TSurface, TView> src_surface = GetSurface(src_gpu_addr, src_params, true, false);
-        ImageBlit(src_surface.second, dst_surface.second, copy_config);
+        if (const auto copy_params = GetExactFermiCopy(src_surface, dst_surface, copy_config)) {
+            ImageCopy(src_surface.first, dst_surface.first, *copy_params);
+        } else {
+            ImageBlit(src_surface.second, dst_surface.second, copy_config);
+        }
         dst_surface.first->MarkAsModified(true, Tick());
     }
 
@@ -240,14 +358,56 @@ public:
         if (!cache_addr) {
             return nullptr;
         }
-        const CacheAddr page = cache_addr >> registry_page_bits;
-        std::vector<TSurface>& list = registry[page];
-        for (auto& surface : list) {
-            if (surface->GetCacheAddr() == cache_addr) {
-                return surface;
+        ReloadDirtySurfaces();
+        TSurface found{};
+        registry.ForEachInRange(cache_addr, cache_addr + 1, [&](const TSurface& surface) {
+            if (!found && surface->GetCacheAddr() == cache_addr) {
+                found = surface;
             }
+        });
+        return found;
+    }
+
+    /**
+     * Returns the surface of a framebuffer presented to a display, creating it from guest memory
+     * when no surface holds the framebuffer yet. Frames rendered by the GPU are presented from
+     * their render target without a round trip through guest memory.
+     */
+    TSurface GetDisplaySurface(GPUVAddr gpu_addr, const SurfaceParams& params) {
+        const u8* host_ptr = system.GPU().MemoryManager().GetPointer(gpu_addr);
+        if (!host_ptr) {
+            return nullptr;
         }
-        return nullptr;
+        if (TSurface surface = TryFindFramebufferSurface(host_ptr)) {
+            return surface;
+        }
+        return GetSurface(gpu_addr, params, true, false).first;
+    }
+
+    /**
+     * Returns the surface holding the block linear image of a DMA copy when the copy can be done on
+     * it directly: the image must start at the surface, share its layout and bytes per pixel, and
+     * the copied rectangle must be inside its first level and layer.
+     */
+    TSurface TryFindDMASurface(GPUVAddr gpu_addr,
+                               const Tegra::Engines::MaxwellDMA::Regs::Parameters& image,
+                               u32 bytes_per_pixel, u32 width, u32 height) {
+        const u8* host_ptr = system.GPU().MemoryManager().GetPointer(gpu_addr);
+        TSurface surface = TryFindFramebufferSurface(host_ptr);
+        if (!surface) {
+            return nullptr;
+        }
+        const SurfaceParams& params = surface->GetSurfaceParams();
+        const bool is_compatible =
+            params.target == SurfaceTarget::Texture2D && params.is_tiled &&
+            params.resolution_scale == 1 && !params.IsCompressed() &&
+            params.GetCompressionType() == SurfaceCompression::None &&
+            params.GetBytesPerPixel() == bytes_per_pixel &&
+            params.block_height == image.BlockHeight() &&
+            params.block_depth == image.BlockDepth() && params.width == image.size_x &&
+            params.height == image.size_y && image.size_z <= 1 && image.pos_z == 0 &&
+            image.pos_x + width <= params.width && image.pos_y + height <= params.height;
+        return is_compatible ? surface : nullptr;
     }
 
     u64 Tick() {
@@ -256,7 +416,7 @@ public:
 
 protected:
     TextureCache(Core::System& system, VideoCore::RasterizerInterface& rasterizer)
-        : system{system}, rasterizer{rasterizer} {
+        : system{system}, rasterizer{rasterizer}, disk_cache{system} {
         for (std::size_t i = 0; i < Tegra::Engines::Maxwell3D::Regs::NumRenderTargets; i++) {
             SetEmptyColorBuffer(i);
         }
@@ -276,7 +436,9 @@ protected:
         sampled_textures.reserve(64);
     }
 
-    ~TextureCache() = default;
+    ~TextureCache() {
+        DiscardPrefetches();
+    }
 
     virtual TSurface CreateSurface(GPUVAddr gpu_addr, const SurfaceParams& params) = 0;
 
@@ -290,6 +452,15 @@ protected:
     // and reading it from a separate buffer.
     virtual void BufferCopy(TSurface& src_surface, TSurface& dst_surface) = 0;
 
+    /// Clears every texel of the surface to the given value.
+    virtual void ClearSurface(TSurface& surface, const ClearValue& value) = 0;
+
+    /// Uploads a surface straight from its guest data, skipping the conversion to the staging
+    /// buffer on the CPU. Returns false when the backend can't handle the surface.
+    virtual bool AccelerateLoad(const TSurface& surface, u8* guest_data) {
+        return false;
+    }
+
     void ManageRenderTargetUnregister(TSurface& surface) {
         auto& maxwell3d = system.GPU().Maxwell3D();
         const u32 index = surface->GetRenderTarget();
@@ -310,12 +481,16 @@ protected:
         if (!cache_ptr || !cpu_addr) {
             LOG_CRITICAL(HW_GPU, "Failed to register surface with unmapped gpu_address 0x{:016x}",
                          gpu_addr);
+            // Keep it in the reserve, it would be lost to the memory accounting otherwise.
+            ReserveSurface(surface->GetSurfaceParams(), surface);
             return;
         }
         const bool continuous = system.GPU().MemoryManager().IsBlockContinuous(gpu_addr, size);
         surface->MarkAsContinuous(continuous);
         surface->SetCacheAddr(cache_ptr);
         surface->SetCpuAddr(*cpu_addr);
+        surface->ClearDirtySubresources();
+        surface->InvalidateClear();
         RegisterInnerCache(surface);
         surface->MarkAsRegistered(true);
         rasterizer.UpdatePagesCachedCount(*cpu_addr, size, 1);
@@ -343,6 +518,7 @@ protected:
         }
         // No reserved surface available, create a new one and reserve it
         auto new_surface{CreateSurface(gpu_addr, params)};
+        memory_usage += new_surface->GetHostSizeInBytes();
         return new_surface;
     }
 
@@ -438,12 +614,22 @@ private:
                                               const SurfaceParams& params, const GPUVAddr gpu_addr,
                                               const bool preserve_contents,
                                               const MatchTopologyResult untopological) {
+        surface_recycled = true;
+        if (preserve_contents && overlaps.size() == 1 && overlaps[0]->GetGpuAddr() == gpu_addr &&
+            CanReinterpret(overlaps[0]->GetSurfaceParams(), params)) {
+            return ReinterpretSurface(overlaps[0], params);
+        }
         const bool do_load = preserve_contents && Settings::values.use_accurate_gpu_emulation;
+        // Flushing forgets the clear, take it before
+        const auto clear_value = GetInheritableClear(overlaps, params, gpu_addr);
         for (auto& surface : overlaps) {
             Unregister(surface);
         }
         switch (PickStrategy(overlaps, params, gpu_addr, untopological)) {
         case RecycleStrategy::Ignore: {
+            if (do_load && clear_value) {
+                return InitializeClearedSurface(gpu_addr, params, *clear_value, true);
+            }
             return InitializeSurface(gpu_addr, params, do_load);
         }
         case RecycleStrategy::Flush: {
@@ -454,6 +640,10 @@ private:
             for (auto& surface : overlaps) {
                 FlushSurface(surface);
             }
+            if (preserve_contents && clear_value) {
+                // Guest memory holds the flushed clear, the surface matches it
+                return InitializeClearedSurface(gpu_addr, params, *clear_value, false);
+            }
             return InitializeSurface(gpu_addr, params, preserve_contents);
         }
         case RecycleStrategy::BufferCopy: {
@@ -468,6 +658,148 @@ private:
         }
     }
 
+    /**
+     * Returns the clear value a new surface can take instead of being loaded from guest memory.
+     * This is the case when it lies inside a single overlap of the same format that was cleared
+     * whole, it then holds nothing but the clear value.
+     **/
+    std::optional<ClearValue> GetInheritableClear(const std::vector<TSurface>& overlaps,
+                                                  const SurfaceParams& params,
+                                                  const GPUVAddr gpu_addr) const {
+        if (overlaps.size() != 1 || !overlaps[0]->MatchFormat(params.pixel_format) ||
+            !overlaps[0]->IsInside(gpu_addr, gpu_addr + params.GetGuestSizeInBytes())) {
+            return std::nullopt;
+        }
+        return overlaps[0]->GetFullClearValue();
+    }
+
+    /// Creates a surface and clears it whole instead of loading it from guest memory.
+    std::pair<TSurface, TView> InitializeClearedSurface(GPUVAddr gpu_addr,
+                                                        const SurfaceParams& params,
+                                                        const ClearValue& value, bool is_modified) {
+        auto result = InitializeSurface(gpu_addr, params, false);
+        ClearSurface(result.first, value);
+        result.first->MarkAsModified(is_modified, Tick());
+        result.first->MarkAsCleared(value, {0, 0, params.width, params.height});
+        return result;
+    }
+
+    /// Implements MarkColorBufferCleared and MarkDepthBufferCleared.
+    bool MarkTargetAsCleared(const TSurface& surface, const TView& view, const ClearValue& value,
+                             const Common::Rectangle<u32>& rect) {
+        if (!surface) {
+            return false;
+        }
+        // Only clears through the whole surface are tracked, integer color buffers are cleared
+        // with float values that don't translate to their texels.
+        const auto& params = surface->GetSurfaceParams();
+        const bool is_integer = params.type == SurfaceType::ColorTexture &&
+                                (params.component_type == ComponentType::UInt ||
+                                 params.component_type == ComponentType::SInt);
+        if (view != surface->GetMainView() || params.num_levels != 1 || is_integer) {
+            surface->MarkAsModified(true, Tick());
+            return false;
+        }
+        if (surface->IsClearedTo(value, rect)) {
+            return true;
+        }
+        surface->MarkAsModified(true, Tick());
+        surface->MarkAsCleared(value, rect);
+        // Draws forget the clear when they mark the targets in use, make the next one do it
+        system.GPU().Maxwell3D().dirty.render_settings = true;
+        return false;
+    }
+
+    /**
+     * Checks if the host data of a surface can be reinterpreted bit for bit as a surface with
+     * other parameters at the same address, without going through guest memory. This is the case
+     * when both have the same memory layout and either the same block size in bytes, e.g. a
+     * Z32F depth buffer read as R32F or a BC1 texture written as RG32UI, or the same row size in
+     * bytes on a single level, e.g. RGBA8 written as RG32F at half the width.
+     *
+     * @param src_params The parameters of the registered surface.
+     * @param dst_params The parameters of the candidate surface.
+     **/
+    static bool CanReinterpret(const SurfaceParams& src_params, const SurfaceParams& dst_params) {
+        // Converted formats are stored in a different format on the host.
+        if (src_params.GetCompressionType() == SurfaceCompression::Converted ||
+            dst_params.GetCompressionType() == SurfaceCompression::Converted) {
+            return false;
+        }
+        if (src_params.IsBuffer() || dst_params.IsBuffer() ||
+            std::tie(src_params.target, src_params.is_tiled, src_params.depth,
+                     src_params.num_levels) != std::tie(dst_params.target, dst_params.is_tiled,
+                                                        dst_params.depth, dst_params.num_levels)) {
+            return false;
+        }
+        if (src_params.is_tiled) {
+            if (std::tie(src_params.block_height, src_params.block_depth,
+                         src_params.tile_width_spacing) !=
+                std::tie(dst_params.block_height, dst_params.block_depth,
+                         dst_params.tile_width_spacing)) {
+                return false;
+            }
+        } else if (src_params.pitch != dst_params.pitch) {
+            return false;
+        }
+
+        const bool is_color = src_params.type == SurfaceType::ColorTexture &&
+                              dst_params.type == SurfaceType::ColorTexture;
+        const bool is_compressed = src_params.IsCompressed() || dst_params.IsCompressed();
+        // Copies between color and depth go through a buffer and are limited to one level.
+        if (!is_color && (is_compressed || src_params.num_levels > 1)) {
+            return false;
+        }
+        const auto blocks = [](u32 size, u32 block_size) {
+            return (size + block_size - 1) / block_size;
+        };
+        const u32 src_bpp = src_params.GetBytesPerPixel();
+        const u32 dst_bpp = dst_params.GetBytesPerPixel();
+        if (src_bpp == dst_bpp) {
+            return blocks(src_params.width, src_params.GetDefaultBlockWidth()) ==
+                       blocks(dst_params.width, dst_params.GetDefaultBlockWidth()) &&
+                   blocks(src_params.height, src_params.GetDefaultBlockHeight()) ==
+                       blocks(dst_params.height, dst_params.GetDefaultBlockHeight());
+        }
+        return !is_compressed && src_params.num_levels == 1 &&
+               src_params.width * src_bpp == dst_params.width * dst_bpp &&
+               src_params.height == dst_params.height;
+    }
+
+    /**
+     * Replaces a surface with one that reinterprets its contents with other parameters, copying
+     * them on the GPU. Only valid when CanReinterpret passes.
+     *
+     * @param current_surface The registered surface in the cache which we want to reinterpret.
+     * @param params          The parameters of the new surface.
+     **/
+    std::pair<TSurface, TView> ReinterpretSurface(TSurface current_surface,
+                                                  const SurfaceParams& params) {
+        const auto& src_params = current_surface->GetSurfaceParams();
+        SurfaceParams new_params = params;
+        new_params.resolution_scale =
+            params.GetInheritedResolutionScale(src_params.resolution_scale);
+        TSurface new_surface = GetUncachedSurface(current_surface->GetGpuAddr(), new_params);
+        const bool is_color = src_params.type == SurfaceType::ColorTexture &&
+                              params.type == SurfaceType::ColorTexture;
+        if (is_color && src_params.GetBytesPerPixel() == params.GetBytesPerPixel()) {
+            // Image copies between formats of the same block size are bit casts, the extents are
+            // given in texels of the source.
+            for (u32 level = 0; level < src_params.num_levels; ++level) {
+                const CopyParams copy_params(src_params.GetMipWidth(level),
+                                             src_params.GetMipHeight(level),
+                                             src_params.GetMipDepth(level), level);
+                ImageCopy(current_surface, new_surface, copy_params);
+            }
+        } else {
+            BufferCopy(current_surface, new_surface);
+        }
+        Unregister(current_surface);
+        Register(new_surface);
+        new_surface->MarkAsModified(current_surface->IsModified(), Tick());
+        return {new_surface, new_surface->GetMainView()};
+    }
+
     /**
      * Takes a single surface and recreates into another that may differ in
      * format, target or width alignment.
@@ -480,17 +812,17 @@ private:
                                               bool is_render) {
         const auto gpu_addr = current_surface->GetGpuAddr();
         const auto& cr_params = current_surface->GetSurfaceParams();
-        TSurface new_surface;
+        SurfaceParams new_params = params;
         if (cr_params.pixel_format != params.pixel_format && !is_render &&
             GetSiblingFormat(cr_params.pixel_format) == params.pixel_format) {
-            SurfaceParams new_params = params;
             new_params.pixel_format = cr_params.pixel_format;
             new_params.component_type = cr_params.component_type;
             new_params.type = cr_params.type;
-            new_surface = GetUncachedSurface(gpu_addr, new_params);
-        } else {
-            new_surface = GetUncachedSurface(gpu_addr, params);
         }
+        // Rebuilding a scaled render target must not drop it back to native resolution
+        new_params.resolution_scale =
+            new_params.GetInheritedResolutionScale(cr_params.resolution_scale);
+        TSurface new_surface = GetUncachedSurface(gpu_addr, new_params);
         const auto& final_params = new_surface->GetSurfaceParams();
         if (cr_params.type != final_params.type ||
             (cr_params.component_type != final_params.component_type)) {
@@ -617,6 +949,26 @@ private:
      **/
     std::pair<TSurface, TView> GetSurface(const GPUVAddr gpu_addr, const SurfaceParams& params,
                                           bool preserve_contents, bool is_render) {
+        surface_created = false;
+        surface_recycled = false;
+        ReloadDirtySurfaces();
+        auto result = LookupSurface(gpu_addr, params, preserve_contents, is_render);
+        result.first->MarkAsUsed(frame_tick);
+
+        auto& statistics = system.GPU().Statistics();
+        if (surface_recycled) {
+            statistics.Add(VideoCore::GPUCounter::TextureCacheRecycles);
+        } else if (surface_created) {
+            statistics.Add(VideoCore::GPUCounter::TextureCacheMisses);
+        } else {
+            statistics.Add(VideoCore::GPUCounter::TextureCacheHits);
+        }
+        return result;
+    }
+
+    /// Implements GetSurface, see its documentation.
+    std::pair<TSurface, TView> LookupSurface(const GPUVAddr gpu_addr, const SurfaceParams& params,
+                                             bool preserve_contents, bool is_render) {
         const auto host_ptr{system.GPU().MemoryManager().GetPointer(gpu_addr)};
         const auto cache_addr{ToCacheAddr(host_ptr)};
 
@@ -804,6 +1156,50 @@ private:
      * @param src_gpu_addr The starting address of the candidate surface.
      * @param dst_gpu_addr The starting address of the destination surface.
      **/
+    /**
+     * Returns the parameters of an image copy doing the same as a Fermi copy, when it copies
+     * between surfaces of the same format and resolution scale without stretching or flipping.
+     * Backends can then skip the framebuffer blit.
+     */
+    static std::optional<CopyParams> GetExactFermiCopy(
+        const std::pair<TSurface, TView>& src, const std::pair<TSurface, TView>& dst,
+        const Tegra::Engines::Fermi2D::Config& copy_config) {
+        const SurfaceParams& src_params = src.first->GetSurfaceParams();
+        const SurfaceParams& dst_params = dst.first->GetSurfaceParams();
+        const ViewParams& src_view = src.second->GetViewParams();
+        const ViewParams& dst_view = dst.second->GetViewParams();
+        const Common::Rectangle<u32>& src_rect = copy_config.src_rect;
+        const Common::Rectangle<u32>& dst_rect = copy_config.dst_rect;
+        const bool is_exact =
+            src_params.pixel_format == dst_params.pixel_format &&
+            src_params.resolution_scale == dst_params.resolution_scale &&
+            !src_params.IsCompressed() &&
+            src_params.GetCompressionType() == SurfaceCompression::None &&
+            src_params.target != SurfaceTarget::Texture3D &&
+            dst_params.target != SurfaceTarget::Texture3D && src_rect.left <= src_rect.right &&
+            src_rect.top <= src_rect.bottom && dst_rect.left <= dst_rect.right &&
+            dst_rect.top <= dst_rect.bottom && src_rect.GetWidth() == dst_rect.GetWidth() &&
+            src_rect.GetHeight() == dst_rect.GetHeight() &&
+            src_rect.right <= src_params.GetMipWidth(src_view.base_level) &&
+            src_rect.bottom <= src_params.GetMipHeight(src_view.base_level) &&
+            dst_rect.right <= dst_params.GetMipWidth(dst_view.base_level) &&
+            dst_rect.bottom <= dst_params.GetMipHeight(dst_view.base_level);
+        if (!is_exact) {
+            return std::nullopt;
+        }
+        // Image copies within the same image can't overlap
+        const bool is_same_image = src.first == dst.first &&
+                                   src_view.base_layer == dst_view.base_layer &&
+                                   src_view.base_level == dst_view.base_level;
+        if (is_same_image && src_rect.left < dst_rect.right && dst_rect.left < src_rect.right &&
+            src_rect.top < dst_rect.bottom && dst_rect.top < src_rect.bottom) {
+            return std::nullopt;
+        }
+        return CopyParams(src_rect.left, src_rect.top, src_view.base_layer, dst_rect.left,
+                          dst_rect.top, dst_view.base_layer, src_view.base_level,
+                          dst_view.base_level, src_rect.GetWidth(), src_rect.GetHeight(), 1);
+    }
+
     void DeduceBestBlit(SurfaceParams& src_params, SurfaceParams& dst_params,
                         const GPUVAddr src_gpu_addr, const GPUVAddr dst_gpu_addr) {
         auto deduced_src = DeduceSurface(src_gpu_addr, src_params);
@@ -856,6 +1252,7 @@ private:
 
     std::pair<TSurface, TView> InitializeSurface(GPUVAddr gpu_addr, const SurfaceParams& params,
                                                  bool preserve_contents) {
+        surface_created = true;
         auto new_surface{GetUncachedSurface(gpu_addr, params)};
         Register(new_surface);
         if (preserve_contents) {
@@ -865,12 +1262,65 @@ private:
     }
 
     void LoadSurface(const TSurface& surface) {
-        staging_cache.GetBuffer(0).resize(surface->GetHostSizeInBytes());
-        surface->LoadBuffer(system.GPU().MemoryManager(), staging_cache);
-        surface->UploadTexture(staging_cache.GetBuffer(0));
+        u8* const guest_data = surface->GetGuestData(system.GPU().MemoryManager(), staging_cache);
+        if (surface->HasDirtySubresources()) {
+            // The disk cache and accelerated loads only handle whole surfaces
+            if (guest_data) {
+                staging_cache.GetBuffer(0).resize(surface->GetHostSizeInBytes());
+                surface->LoadBuffer(guest_data, staging_cache);
+                surface->UploadTexture(staging_cache.GetBuffer(0));
+            }
+            surface->ClearDirtySubresources();
+        } else if (!guest_data || !AccelerateLoad(surface, guest_data)) {
+            auto& buffer = staging_cache.GetBuffer(0);
+            buffer.resize(surface->GetHostSizeInBytes());
+
+            // Textures decoded on the CPU are looked up in the disk cache before decoding them
+            const auto& params = surface->GetSurfaceParams();
+            const bool use_disk_cache =
+                guest_data && params.GetCompressionType() == SurfaceCompression::Converted;
+            if (const auto prefetch = TakePrefetch(surface)) {
+                std::swap(buffer, prefetch->staging_cache.GetBuffer(0));
+                if (use_disk_cache) {
+                    disk_cache.Store(prefetch->disk_cache_key, buffer.data(), buffer.size());
+                }
+            } else {
+                const u64 key = use_disk_cache ? TextureDiskCache::ComputeKey(
+                                                     params, guest_data, surface->GetSizeInBytes())
+                                               : 0;
+                if (!use_disk_cache || !disk_cache.Load(key, buffer)) {
+                    surface->LoadBuffer(guest_data, staging_cache);
+                    if (use_disk_cache) {
+                        disk_cache.Store(key, buffer.data(), buffer.size());
+                    }
+                }
+            }
+            surface->UploadTexture(buffer);
+        }
         surface->MarkAsModified(false, Tick());
     }
 
+    using PrefetchList = std::vector<std::unique_ptr<PrefetchedSurface>>;
+
+    typename PrefetchList::iterator FindPrefetch(GPUVAddr gpu_addr, const SurfaceParams& params) {
+        return std::find_if(prefetches.begin(), prefetches.end(), [&](const auto& prefetch) {
+            return prefetch->GetGpuAddr() == gpu_addr && prefetch->GetSurfaceParams() == params;
+        });
+    }
+
+    /// Returns the finished prefetch of a surface and removes it, or null when it wasn't
+    /// prefetched.
+    std::unique_ptr<PrefetchedSurface> TakePrefetch(const TSurface& surface) {
+        const auto it = FindPrefetch(surface->GetGpuAddr(), surface->GetSurfaceParams());
+        if (it == prefetches.end()) {
+            return nullptr;
+        }
+        std::unique_ptr<PrefetchedSurface> prefetch = std::move(*it);
+        prefetches.erase(it);
+        prefetch->task.Wait();
+        return prefetch;
+    }
+
     void FlushSurface(const TSurface& surface) {
         if (!surface->IsModified()) {
             return;
@@ -881,55 +1331,125 @@ private:
         surface->MarkAsModified(false, Tick());
     }
 
+    /// Flushes only the subresources of the surface overlapping the given region. The surface
+    /// stays modified when some of its subresources were not written back.
+    void FlushSurfaceRegion(const TSurface& surface, CacheAddr addr, std::size_t size) {
+        if (!surface->IsModified()) {
+            return;
+        }
+        if (surface->MarkRegionAsDirty(addr, addr + size)) {
+            surface->ClearDirtySubresources();
+            FlushSurface(surface);
+            return;
+        }
+        staging_cache.GetBuffer(0).resize(surface->GetHostSizeInBytes());
+        surface->DownloadTexture(staging_cache.GetBuffer(0));
+        surface->FlushBuffer(system.GPU().MemoryManager(), staging_cache);
+        surface->ClearDirtySubresources();
+    }
+
+    /// Reloads the subresources written by the guest of the surfaces that are still registered.
+    void ReloadDirtySurfaces() {
+        if (dirty_surfaces.empty()) {
+            return;
+        }
+        for (const auto& surface : dirty_surfaces) {
+            if (surface->IsRegistered() && surface->HasDirtySubresources()) {
+                LoadSurface(surface);
+            }
+        }
+        dirty_surfaces.clear();
+    }
+
     void RegisterInnerCache(TSurface& surface) {
         const CacheAddr cache_addr = surface->GetCacheAddr();
-        CacheAddr start = cache_addr >> registry_page_bits;
-        const CacheAddr end = (surface->GetCacheAddrEnd() - 1) >> registry_page_bits;
         l1_cache[cache_addr] = surface;
-        while (start <= end) {
-            registry[start].push_back(surface);
-            start++;
-        }
+        registry.Insert(cache_addr, surface->GetCacheAddrEnd(), surface);
     }
 
     void UnregisterInnerCache(TSurface& surface) {
         const CacheAddr cache_addr = surface->GetCacheAddr();
-        CacheAddr start = cache_addr >> registry_page_bits;
-        const CacheAddr end = (surface->GetCacheAddrEnd() - 1) >> registry_page_bits;
         l1_cache.erase(cache_addr);
-        while (start <= end) {
-            auto& reg{registry[start]};
-            reg.erase(std::find(reg.begin(), reg.end(), surface));
-            start++;
-        }
+        registry.Erase(cache_addr, surface->GetCacheAddrEnd(), surface);
     }
 
     std::vector<TSurface> GetSurfacesInRegion(const CacheAddr cache_addr, const std::size_t size) {
         if (size == 0) {
             return {};
         }
-        const CacheAddr cache_addr_end = cache_addr + size;
-        CacheAddr start = cache_addr >> registry_page_bits;
-        const CacheAddr end = (cache_addr_end - 1) >> registry_page_bits;
         std::vector<TSurface> surfaces;
-        while (start <= end) {
-            std::vector<TSurface>& list = registry[start];
-            for (auto& surface : list) {
-                if (!surface->IsPicked() && surface->Overlaps(cache_addr, cache_addr_end)) {
-                    surface->MarkAsPicked(true);
-                    surfaces.push_back(surface);
+        const auto push = [&surfaces](const TSurface& surface) { surfaces.push_back(surface); };
+        registry.ForEachInRange(cache_addr, cache_addr + size, push);
+        return surfaces;
+    }
+
+    void ReserveSurface(const SurfaceParams& params, TSurface surface) {
+        auto& reserve = surface_reserve[params];
+        // Surfaces taken from the reserve stay in it, don't add them twice.
+        if (std::find(reserve.begin(), reserve.end(), surface) == reserve.end()) {
+            reserve.push_back(std::move(surface));
+        }
+    }
+
+    /// Evicts surfaces, least recently used first, until the memory usage fits in the budget.
+    /// Reserved surfaces go first, then registered surfaces that haven't been used recently.
+    void EvictSurfaces(u64 budget) {
+        const u64 usage_before = memory_usage;
+        std::size_t num_evicted = 0;
+        std::vector<TSurface> candidates;
+        for (const auto& [params, surfaces] : surface_reserve) {
+            for (const auto& surface : surfaces) {
+                if (!surface->IsRegistered()) {
+                    candidates.push_back(surface);
                 }
             }
-            start++;
         }
-        for (auto& surface : surfaces) {
-            surface->MarkAsPicked(false);
+        num_evicted += EvictCandidates(candidates, budget);
+
+        if (memory_usage > budget) {
+            candidates.clear();
+            registry.ForEach([&](const TSurface& surface) {
+                if (surface->IsRenderTarget() || surface->IsProtected() ||
+                    surface->GetLastFrameUsed() + MIN_FRAMES_BEFORE_EVICTION > frame_tick) {
+                    return;
+                }
+                candidates.push_back(surface);
+            });
+            num_evicted += EvictCandidates(candidates, budget);
         }
-        return surfaces;
+        LOG_DEBUG(HW_GPU, "Evicted {} surfaces ({} MiB), {} MiB used of a {} MiB budget",
+                  num_evicted, (usage_before - memory_usage) >> 20, memory_usage >> 20,
+                  budget >> 20);
     }
 
-    void ReserveSurface(const SurfaceParams& params, TSurface surface) {
-        surface_reserve[params].push_back(std::move(surface));
+    /// Evicts candidates from the oldest to the newest until the budget is met.
+    /// Returns the number of evicted surfaces.
+    std::size_t EvictCandidates(std::vector<TSurface>& candidates, u64 budget) {
+        std::sort(candidates.begin(), candidates.end(), [](const TSurface& a, const TSurface& b) {
+            return std::make_pair(a->GetLastFrameUsed(), a->GetModificationTick()) <
+                   std::make_pair(b->GetLastFrameUsed(), b->GetModificationTick());
+        });
+        std::size_t num_evicted = 0;
+        for (const auto& surface : candidates) {
+            if (memory_usage <= budget) {
+                break;
+            }
+            if (surface->IsRegistered()) {
+                FlushSurface(surface);
+                Unregister(surface);
+            }
+            const auto it = surface_reserve.find(surface->GetSurfaceParams());
+            if (it != surface_reserve.end()) {
+                auto& reserve = it->second;
+                reserve.erase(std::remove(reserve.begin(), reserve.end(), surface), reserve.end());
+                if (reserve.empty()) {
+                    surface_reserve.erase(it);
+                }
+            }
+            memory_usage -= surface->GetHostSizeInBytes();
+            ++num_evicted;
+        }
+        return num_evicted;
     }
 
     TSurface TryGetReservedSurface(const SurfaceParams& params) {
@@ -958,6 +1478,16 @@ private:
 
     u64 ticks{};
 
+    // Frames a registered surface has to stay unused before it can be evicted.
+    static constexpr u64 MIN_FRAMES_BEFORE_EVICTION = 3;
+
+    u64 frame_tick{};
+
+    /// Outcome of the current surface lookup, for the cache statistics
+    bool surface_created{};
+    bool surface_recycled{};
+    u64 memory_usage{};
+
     // Guards the cache for protection conflicts.
     bool guard_render_targets{};
     bool guard_samplers{};
@@ -971,8 +1501,7 @@ private:
     // of 1MB. This fits better for the purpose of this cache as textures are normaly
     // large in size.
     static constexpr u64 registry_page_bits{20};
-    static constexpr u64 registry_page_size{1 << registry_page_bits};
-    std::unordered_map<CacheAddr, std::vector<TSurface>> registry;
+    PageIndex<TSurface, registry_page_bits> registry;
 
     static constexpr u32 DEPTH_RT = 8;
     static constexpr u32 NO_RT = 0xFFFFFFFF;
@@ -991,8 +1520,16 @@ private:
 
     std::vector<TSurface> sampled_textures;
 
+    /// Registered surfaces with subresources written by the guest since they were loaded.
+    std::vector<TSurface> dirty_surfaces;
+
     StagingCache staging_cache;
-    std::recursive_mutex mutex;
+
+    TextureDiskCache disk_cache;
+
+    /// Textures being decoded in the background for the current draw.
+    static constexpr std::size_t MAX_PREFETCHES = 16;
+    PrefetchList prefetches;
 };
 
 } // namespace VideoCommon
@@ -0,0 +1,203 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include "common/common_paths.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/zstd_compression.h"
+#include "core/core.h"
+#include "core/hle/kernel/process.h"
+#include "core/settings.h"
+#include "video_core/texture_cache/surface_params.h"
+#include "video_core/texture_cache/texture_disk_cache.h"
+
+namespace VideoCommon {
+
+MICROPROFILE_DEFINE(GPU_Texture_Disk_Cache, "GPU", "Texture Disk Cache", MP_RGB(128, 192, 128));
+
+namespace {
+
+/// Version of the file format and of the decoders, bump it when either changes.
+constexpr u32 NativeVersion = 2;
+
+/// Zstandard level used on new entries, favors speed as entries are written while loading.
+constexpr s32 COMPRESSION_LEVEL = 3;
+
+struct EntryHeader {
+    u64 key;
+    u64 size;
+    u64 compressed_size;
+};
+static_assert(sizeof(EntryHeader) == 24, "EntryHeader has padding");
+
+} // Anonymous namespace
+
+TextureDiskCache::TextureDiskCache(Core::System& system) : system{system} {}
+
+TextureDiskCache::~TextureDiskCache() = default;
+
+u64 TextureDiskCache::ComputeKey(const SurfaceParams& params, const u8* guest_data,
+                                 std::size_t guest_size) {
+    // Hash the fields one by one, the padding of SurfaceParams isn't stable across runs
+    const std::array<u32, 14> layout{
+        static_cast<u32>(params.pixel_format),
+        static_cast<u32>(params.target),
+        params.is_tiled ? 1U : 0U,
+        params.is_layered ? 1U : 0U,
+        params.block_width,
+        params.block_height,
+        params.block_depth,
+        params.tile_width_spacing,
+        params.width,
+        params.height,
+        params.depth,
+        params.pitch,
+        params.num_levels,
+        params.emulated_levels,
+    };
+    const u64 layout_hash = Common::ComputeXXH3(layout.data(), sizeof(layout));
+    return Common::ComputeXXH3(guest_data, guest_size, layout_hash);
+}
+
+bool TextureDiskCache::Load(u64 key, std::vector<u8>& buffer) {
+    if (!EnsureOpen()) {
+        return false;
+    }
+    const auto it = entries.find(key);
+    if (it == entries.end() || it->second.size != buffer.size()) {
+        return false;
+    }
+    MICROPROFILE_SCOPE(GPU_Texture_Disk_Cache);
+
+    const Entry& entry = it->second;
+    compressed_buffer.resize(entry.compressed_size);
+    if (!file.Seek(static_cast<s64>(entry.offset), SEEK_SET) ||
+        file.ReadBytes(compressed_buffer.data(), compressed_buffer.size()) !=
+            compressed_buffer.size()) {
+        LOG_ERROR(HW_GPU, "Failed to read texture cache entry {:016X}", key);
+        entries.erase(it);
+        return false;
+    }
+    const std::vector<u8> data = Common::Compression::DecompressDataZSTD(compressed_buffer);
+    if (data.size() != buffer.size()) {
+        LOG_ERROR(HW_GPU, "Texture cache entry {:016X} is corrupted", key);
+        entries.erase(it);
+        return false;
+    }
+    std::memcpy(buffer.data(), data.data(), data.size());
+    return true;
+}
+
+bool TextureDiskCache::Contains(u64 key) {
+    return EnsureOpen() && entries.find(key) != entries.end();
+}
+
+void TextureDiskCache::Store(u64 key, const u8* data, std::size_t size) {
+    if (!EnsureOpen() || entries.find(key) != entries.end()) {
+        return;
+    }
+    MICROPROFILE_SCOPE(GPU_Texture_Disk_Cache);
+
+    const std::vector<u8> compressed =
+        Common::Compression::CompressDataZSTD(data, size, COMPRESSION_LEVEL);
+    if (compressed.empty()) {
+        return;
+    }
+    const EntryHeader header{key, size, compressed.size()};
+    if (!file.Seek(0, SEEK_END)) {
+        return;
+    }
+    const u64 offset = file.Tell() + sizeof(header);
+    if (file.WriteObject(header) != 1 ||
+        file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        LOG_ERROR(HW_GPU, "Failed to write texture cache entry, disabling the cache");
+        is_usable = false;
+        return;
+    }
+    entries.emplace(key, Entry{offset, compressed.size(), size});
+}
+
+bool TextureDiskCache::EnsureOpen() {
+    if (is_opened) {
+        return is_usable;
+    }
+    is_opened = true;
+
+    // Skip games without title id
+    if (!Settings::values.use_disk_texture_cache ||
+        system.CurrentProcess()->GetTitleID() == 0) {
+        return false;
+    }
+    if (!FileUtil::CreateFullPath(GetBaseDir() + DIR_SEP)) {
+        LOG_ERROR(HW_GPU, "Failed to create directory={}", GetBaseDir());
+        return false;
+    }
+    const std::string path = GetPath();
+    if (FileUtil::Exists(path)) {
+        FileUtil::IOFile version_file(path, "rb");
+        u32 version{};
+        if (version_file.ReadBytes(&version, sizeof(version)) != sizeof(version) ||
+            version != NativeVersion) {
+            LOG_INFO(HW_GPU, "Texture disk cache is from another version, removing");
+            version_file.Close();
+            FileUtil::Delete(path);
+        }
+    }
+
+    // Opened for appending, writes always go to the end of the file
+    if (!file.Open(path, "a+b")) {
+        LOG_ERROR(HW_GPU, "Failed to open texture disk cache file={}", path);
+        return false;
+    }
+    if (file.GetSize() == 0) {
+        if (file.WriteObject(NativeVersion) != 1) {
+            LOG_ERROR(HW_GPU, "Failed to write texture disk cache version");
+            return false;
+        }
+    } else {
+        ReadIndex();
+    }
+    LOG_INFO(HW_GPU, "Loaded {} entries from the texture disk cache", entries.size());
+    is_usable = true;
+    return true;
+}
+
+void TextureDiskCache::ReadIndex() {
+    const u64 file_size = file.GetSize();
+    u64 offset = sizeof(NativeVersion);
+    while (offset < file_size) {
+        EntryHeader header;
+        const bool is_valid = offset + sizeof(header) <= file_size &&
+                              file.Seek(static_cast<s64>(offset), SEEK_SET) &&
+                              file.ReadBytes(&header, sizeof(header)) == sizeof(header) &&
+                              offset + sizeof(header) + header.compressed_size <= file_size;
+        if (!is_valid) {
+            // Left truncated by a crash while it was written, drop it so new entries can be
+            // appended after the valid ones
+            LOG_WARNING(HW_GPU, "Texture disk cache is truncated, removing its last entry");
+            file.Resize(offset);
+            break;
+        }
+        offset += sizeof(header);
+        entries.insert_or_assign(header.key, Entry{offset, header.compressed_size, header.size});
+        offset += header.compressed_size;
+    }
+}
+
+std::string TextureDiskCache::GetPath() const {
+    const std::string title_id = fmt::format("{:016X}", system.CurrentProcess()->GetTitleID());
+    return FileUtil::SanitizePath(GetBaseDir() + DIR_SEP_CHR + title_id + ".bin");
+}
+
+std::string TextureDiskCache::GetBaseDir() const {
+    return FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + DIR_SEP "texture";
+}
+
+} // namespace VideoCommon
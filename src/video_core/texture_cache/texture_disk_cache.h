@@ -0,0 +1,79 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace Core {
+class System;
+}
+
+namespace VideoCommon {
+
+class SurfaceParams;
+
+/**
+ * Per title cache on disk of the host data of textures that have to be decoded on the CPU, e.g.
+ * ASTC. Entries are keyed by a hash of the guest data and the surface parameters, and stored
+ * compressed with Zstandard in a single file per title that's only ever appended to.
+ */
+class TextureDiskCache {
+public:
+    explicit TextureDiskCache(Core::System& system);
+    ~TextureDiskCache();
+
+    /// Returns the key of a surface with the given parameters and guest data.
+    static u64 ComputeKey(const SurfaceParams& params, const u8* guest_data,
+                          std::size_t guest_size);
+
+    /**
+     * Reads the host data stored for a key.
+     * @param key    Key of the surface, see ComputeKey.
+     * @param buffer Buffer receiving the data, its size is the expected size of the data.
+     * @returns True if the data was found, false leaves the buffer in an undefined state.
+     */
+    bool Load(u64 key, std::vector<u8>& buffer);
+
+    /// Returns true when there's host data stored for a key.
+    bool Contains(u64 key);
+
+    /// Stores the host data of a key.
+    void Store(u64 key, const u8* data, std::size_t size);
+
+private:
+    struct Entry {
+        u64 offset;          ///< Offset of the compressed data in the file.
+        u64 compressed_size; ///< Size in bytes of the compressed data.
+        u64 size;            ///< Size in bytes of the decompressed data.
+    };
+
+    /// Opens the cache file of the running title and reads its index. Returns true when the
+    /// cache can be used.
+    bool EnsureOpen();
+
+    /// Reads the entries of the opened file, stopping at the first truncated one.
+    void ReadIndex();
+
+    std::string GetPath() const;
+
+    std::string GetBaseDir() const;
+
+    Core::System& system;
+
+    FileUtil::IOFile file;
+    bool is_opened = false;
+    bool is_usable = false;
+
+    std::unordered_map<u64, Entry> entries;
+    std::vector<u8> compressed_buffer;
+};
+
+} // namespace VideoCommon
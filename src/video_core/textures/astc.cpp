@@ -16,11 +16,13 @@
 // <http://gamma.cs.unc.edu/FasTC/>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
 #include <vector>
 
+#include "common/thread_pool.h"
 #include "video_core/textures/astc.h"
 
 class InputBitStream {
@@ -390,6 +392,19 @@ private:
 
 namespace ASTCC {
 
+/// Storage reused across the blocks decoded by a thread, avoids allocating on every block.
+struct DecodeScratch {
+    explicit DecodeScratch() {
+        // Dual plane 12x12 texel weights and four partitions of color values, with room for the
+        // values decoded past the end of the last trit block.
+        texel_weight_values.reserve(2 * 144 + 5);
+        color_values.reserve(32 + 5);
+    }
+
+    std::vector<IntegerEncodedValue> texel_weight_values;
+    std::vector<IntegerEncodedValue> color_values;
+};
+
 struct TexelWeightParams {
     uint32_t m_Width = 0;
     uint32_t m_Height = 0;
@@ -803,7 +818,8 @@ public:
     }
 };
 
-static void DecodeColorValues(uint32_t* out, uint8_t* data, const uint32_t* modes,
+static void DecodeColorValues(std::vector<IntegerEncodedValue>& decodedColorValues,
+                              uint32_t* out, uint8_t* data, const uint32_t* modes,
                               const uint32_t nPartitions, const uint32_t nBitsForColorData) {
     // First figure out how many color values we have
     uint32_t nValues = 0;
@@ -833,7 +849,7 @@ static void DecodeColorValues(uint32_t* out, uint8_t* data, const uint32_t* mode
     }
 
     // We now have enough to decode our integer sequence.
-    std::vector<IntegerEncodedValue> decodedColorValues;
+    decodedColorValues.clear();
     InputBitStream colorStream(data);
     IntegerEncodedValue::DecodeIntegerSequence(decodedColorValues, colorStream, range, nValues);
 
@@ -1378,8 +1394,9 @@ static void ComputeEndpoints(Pixel& ep1, Pixel& ep2, const uint32_t*& colorValue
 #undef READ_INT_VALUES
 }
 
-static void DecompressBlock(const uint8_t inBuf[16], const uint32_t blockWidth,
-                            const uint32_t blockHeight, uint32_t* outBuf) {
+static void DecompressBlock(DecodeScratch& scratch, const uint8_t inBuf[16],
+                            const uint32_t blockWidth, const uint32_t blockHeight,
+                            uint32_t* outBuf) {
     InputBitStream strm(inBuf);
     TexelWeightParams weightParams = DecodeBlockInfo(strm);
 
@@ -1531,8 +1548,8 @@ static void DecompressBlock(const uint8_t inBuf[16], const uint32_t blockWidth,
 
     // Decode both color data and texel weight data
     uint32_t colorValues[32]; // Four values, two endpoints, four maximum paritions
-    DecodeColorValues(colorValues, colorEndpointData, colorEndpointMode, nPartitions,
-                      colorDataBits);
+    DecodeColorValues(scratch.color_values, colorValues, colorEndpointData, colorEndpointMode,
+                      nPartitions, colorDataBits);
 
     Pixel endpoints[4][2];
     const uint32_t* colorValuesPtr = colorValues;
@@ -1561,7 +1578,8 @@ static void DecompressBlock(const uint8_t inBuf[16], const uint32_t blockWidth,
     texelWeightData[clearByteStart - 1] &= (1 << (weightParams.GetPackedBitSize() % 8)) - 1;
     memset(texelWeightData + clearByteStart, 0, 16 - clearByteStart);
 
-    std::vector<IntegerEncodedValue> texelWeightValues;
+    std::vector<IntegerEncodedValue>& texelWeightValues = scratch.texel_weight_values;
+    texelWeightValues.clear();
     InputBitStream weightStream(texelWeightData);
 
     IntegerEncodedValue::DecodeIntegerSequence(texelWeightValues, weightStream,
@@ -1610,36 +1628,80 @@ static void DecompressBlock(const uint8_t inBuf[16], const uint32_t blockWidth,
 
 namespace Tegra::Texture::ASTC {
 
-std::vector<uint8_t> Decompress(const uint8_t* data, uint32_t width, uint32_t height,
-                                uint32_t depth, uint32_t block_width, uint32_t block_height) {
-    uint32_t blockIdx = 0;
-    std::size_t depth_offset = 0;
-    std::vector<uint8_t> outData(height * width * depth * 4);
-    for (uint32_t k = 0; k < depth; k++) {
-        for (uint32_t j = 0; j < height; j += block_height) {
-            for (uint32_t i = 0; i < width; i += block_width) {
-
-                const uint8_t* blockPtr = data + blockIdx * 16;
+namespace {
+
+/// Minimum number of blocks in a texture before its decoding is split across threads, smaller
+/// textures decode faster than they are handed to other threads.
+constexpr uint32_t MIN_BLOCKS_PER_THREAD = 256;
+
+void DecompressRow(ASTCC::DecodeScratch& scratch, const uint8_t* data, uint8_t* out_data,
+                   uint32_t width, uint32_t height, uint32_t block_width, uint32_t block_height,
+                   uint32_t row, uint32_t rows_per_slice) {
+    const uint32_t blocks_per_row = (width + block_width - 1) / block_width;
+    const uint32_t slice = row / rows_per_slice;
+    const uint32_t j = (row % rows_per_slice) * block_height;
+    const uint8_t* block_ptr = data + static_cast<std::size_t>(row) * blocks_per_row * 16;
+    uint8_t* const slice_out = out_data + static_cast<std::size_t>(slice) * height * width * 4;
+    const uint32_t decomp_height = std::min(block_height, height - j);
+
+    for (uint32_t i = 0; i < width; i += block_width) {
+        // Blocks can be at most 12x12
+        uint32_t uncomp_data[144];
+        ASTCC::DecompressBlock(scratch, block_ptr, block_width, block_height, uncomp_data);
+
+        const uint32_t decomp_width = std::min(block_width, width - i);
+        uint8_t* const out_row = slice_out + (static_cast<std::size_t>(j) * width + i) * 4;
+        for (uint32_t jj = 0; jj < decomp_height; jj++) {
+            std::memcpy(out_row + jj * width * 4, uncomp_data + jj * block_width,
+                        decomp_width * 4);
+        }
+        block_ptr += 16;
+    }
+}
 
-                // Blocks can be at most 12x12
-                uint32_t uncompData[144];
-                ASTCC::DecompressBlock(blockPtr, block_width, block_height, uncompData);
+} // Anonymous namespace
 
-                uint32_t decompWidth = std::min(block_width, width - i);
-                uint32_t decompHeight = std::min(block_height, height - j);
+std::vector<uint8_t> Decompress(const uint8_t* data, uint32_t width, uint32_t height,
+                                uint32_t depth, uint32_t block_width, uint32_t block_height) {
+    std::vector<uint8_t> out_data(static_cast<std::size_t>(height) * width * depth * 4);
+
+    const uint32_t blocks_per_row = (width + block_width - 1) / block_width;
+    const uint32_t rows_per_slice = (height + block_height - 1) / block_height;
+    const uint32_t num_rows = rows_per_slice * depth;
+    const uint32_t num_blocks = num_rows * blocks_per_row;
+    if (num_blocks == 0) {
+        return out_data;
+    }
+
+    // Blocks don't depend on each other, rows of blocks are handed out to the threads one at a
+    // time so they stay balanced even when some blocks are more expensive to decode.
+    std::atomic<uint32_t> next_row{0};
+    const auto worker = [&] {
+        ASTCC::DecodeScratch scratch;
+        uint32_t row;
+        while ((row = next_row.fetch_add(1, std::memory_order_relaxed)) < num_rows) {
+            DecompressRow(scratch, data, out_data.data(), width, height, block_width,
+                          block_height, row, rows_per_slice);
+        }
+    };
 
-                uint8_t* outRow = depth_offset + outData.data() + (j * width + i) * 4;
-                for (uint32_t jj = 0; jj < decompHeight; jj++) {
-                    memcpy(outRow + jj * width * 4, uncompData + jj * block_width, decompWidth * 4);
-                }
+    // The calling thread decodes too, it is helped by up to every worker of the shared pool.
+    Common::ThreadPool& pool = Common::GetThreadPool();
+    const auto max_threads = static_cast<uint32_t>(pool.GetNumActiveThreads() + 1);
+    const uint32_t num_threads =
+        std::clamp(num_blocks / MIN_BLOCKS_PER_THREAD, 1U, std::min(max_threads, num_rows));
 
-                blockIdx++;
-            }
-        }
-        depth_offset += height * width * 4;
+    std::vector<Common::TaskHandle> helpers;
+    helpers.reserve(num_threads - 1);
+    for (uint32_t i = 1; i < num_threads; ++i) {
+        helpers.push_back(pool.Submit(worker));
+    }
+    worker();
+    for (const auto& helper : helpers) {
+        helper.Wait();
     }
 
-    return outData;
+    return out_data;
 }
 
 } // namespace Tegra::Texture::ASTC
@@ -14,54 +14,103 @@
 #include "video_core/textures/astc.h"
 #include "video_core/textures/convert.h"
 
+#ifdef ARCHITECTURE_x86_64
+#include <immintrin.h>
+#include "common/x64/cpu_detect.h"
+#endif
+
 namespace Tegra::Texture {
 
 using VideoCore::Surface::PixelFormat;
 
+namespace {
+
+// S8Z24 keeps the depth in the low 24 bits and the stencil in the high byte, Z24S8 keeps the
+// stencil in the low byte. Converting between them rotates every pixel by a byte.
+
+template <bool reverse>
+void SwapS8Z24ToZ24S8Scalar(u8* data, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels; ++i) {
+        u32 pixel;
+        std::memcpy(&pixel, data + i * sizeof(u32), sizeof(u32));
+        pixel = reverse ? (pixel >> 8) | (pixel << 24) : (pixel << 8) | (pixel >> 24);
+        std::memcpy(data + i * sizeof(u32), &pixel, sizeof(u32));
+    }
+}
+
+#ifdef ARCHITECTURE_x86_64
+
+// The rest of the build targets plain x86-64, only these functions use the newer instructions
+#if defined(__GNUC__) || defined(__clang__)
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define SSSE3_TARGET
+#define AVX2_TARGET
+#endif
+
+/// Byte shuffle of the rotation of four pixels.
+template <bool reverse>
+SSSE3_TARGET __m128i MakeSwapShuffle() {
+    if constexpr (reverse) {
+        return _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+    } else {
+        return _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    }
+}
+
+template <bool reverse>
+SSSE3_TARGET void SwapS8Z24ToZ24S8SSSE3(u8* data, std::size_t num_pixels) {
+    const __m128i shuffle = MakeSwapShuffle<reverse>();
+    std::size_t i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        auto* const pointer = reinterpret_cast<__m128i*>(data + i * sizeof(u32));
+        _mm_storeu_si128(pointer, _mm_shuffle_epi8(_mm_loadu_si128(pointer), shuffle));
+    }
+    SwapS8Z24ToZ24S8Scalar<reverse>(data + i * sizeof(u32), num_pixels - i);
+}
+
+template <bool reverse>
+AVX2_TARGET void SwapS8Z24ToZ24S8AVX2(u8* data, std::size_t num_pixels) {
+    const __m128i lane_shuffle = MakeSwapShuffle<reverse>();
+    const __m256i shuffle = _mm256_broadcastsi128_si256(lane_shuffle);
+    std::size_t i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        auto* const pointer = reinterpret_cast<__m256i*>(data + i * sizeof(u32));
+        _mm256_storeu_si256(pointer, _mm256_shuffle_epi8(_mm256_loadu_si256(pointer), shuffle));
+    }
+    SwapS8Z24ToZ24S8SSSE3<reverse>(data + i * sizeof(u32), num_pixels - i);
+}
+
+#endif
+
 template <bool reverse>
 void SwapS8Z24ToZ24S8(u8* data, u32 width, u32 height) {
-    union S8Z24 {
-        BitField<0, 24, u32> z24;
-        BitField<24, 8, u32> s8;
-    };
-    static_assert(sizeof(S8Z24) == 4, "S8Z24 is incorrect size");
-
-    union Z24S8 {
-        BitField<0, 8, u32> s8;
-        BitField<8, 24, u32> z24;
-    };
-    static_assert(sizeof(Z24S8) == 4, "Z24S8 is incorrect size");
-
-    S8Z24 s8z24_pixel{};
-    Z24S8 z24s8_pixel{};
-    constexpr auto bpp{
-        VideoCore::Surface::GetBytesPerPixel(VideoCore::Surface::PixelFormat::S8Z24)};
-    for (std::size_t y = 0; y < height; ++y) {
-        for (std::size_t x = 0; x < width; ++x) {
-            const std::size_t offset{bpp * (y * width + x)};
-            if constexpr (reverse) {
-                std::memcpy(&z24s8_pixel, &data[offset], sizeof(Z24S8));
-                s8z24_pixel.s8.Assign(z24s8_pixel.s8);
-                s8z24_pixel.z24.Assign(z24s8_pixel.z24);
-                std::memcpy(&data[offset], &s8z24_pixel, sizeof(S8Z24));
-            } else {
-                std::memcpy(&s8z24_pixel, &data[offset], sizeof(S8Z24));
-                z24s8_pixel.s8.Assign(s8z24_pixel.s8);
-                z24s8_pixel.z24.Assign(s8z24_pixel.z24);
-                std::memcpy(&data[offset], &z24s8_pixel, sizeof(Z24S8));
-            }
-        }
+    const std::size_t num_pixels = static_cast<std::size_t>(width) * height;
+#ifdef ARCHITECTURE_x86_64
+    const auto& caps = Common::GetCPUCaps();
+    if (caps.avx2) {
+        SwapS8Z24ToZ24S8AVX2<reverse>(data, num_pixels);
+        return;
+    }
+    if (caps.ssse3) {
+        SwapS8Z24ToZ24S8SSSE3<reverse>(data, num_pixels);
+        return;
     }
+#endif
+    SwapS8Z24ToZ24S8Scalar<reverse>(data, num_pixels);
 }
 
-static void ConvertS8Z24ToZ24S8(u8* data, u32 width, u32 height) {
+void ConvertS8Z24ToZ24S8(u8* data, u32 width, u32 height) {
     SwapS8Z24ToZ24S8<false>(data, width, height);
 }
 
-static void ConvertZ24S8ToS8Z24(u8* data, u32 width, u32 height) {
+void ConvertZ24S8ToS8Z24(u8* data, u32 width, u32 height) {
     SwapS8Z24ToZ24S8<true>(data, width, height);
 }
 
+} // Anonymous namespace
+
 void ConvertFromGuestToHost(u8* in_data, u8* out_data, PixelFormat pixel_format, u32 width,
                             u32 height, u32 depth, bool convert_astc, bool convert_s8z24) {
     if (convert_astc && IsPixelFormatASTC(pixel_format)) {
@@ -74,7 +123,7 @@ void ConvertFromGuestToHost(u8* in_data, u8* out_data, PixelFormat pixel_format,
         std::copy(rgba8_data.begin(), rgba8_data.end(), out_data);
 
     } else if (convert_s8z24 && pixel_format == PixelFormat::S8Z24) {
-        Tegra::Texture::ConvertS8Z24ToZ24S8(in_data, width, height);
+        ConvertS8Z24ToZ24S8(in_data, width, height);
     }
 }
 
@@ -86,7 +135,7 @@ void ConvertFromHostToGuest(u8* data, PixelFormat pixel_format, u32 width, u32 h
         UNREACHABLE();
 
     } else if (convert_s8z24 && pixel_format == PixelFormat::S8Z24) {
-        Tegra::Texture::ConvertZ24S8ToS8Z24(data, width, height);
+        ConvertZ24S8ToS8Z24(data, width, height);
     }
 }
 
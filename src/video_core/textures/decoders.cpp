@@ -51,6 +51,30 @@ constexpr u32 fast_swizzle_align = 16;
 constexpr auto legacy_swizzle_table = SwizzleTable<gob_size_y, gob_size_x, gob_size_z>();
 constexpr auto fast_swizzle_table = SwizzleTable<gob_size_y, 4, fast_swizzle_align>();
 
+/**
+ * Copies a whole GOB between its swizzled layout and a linear surface. Each row of a GOB is split
+ * in four 16 bytes chunks, the longest runs that are contiguous in both layouts.
+ * @param gob Pointer to the first byte of the GOB in the swizzled surface.
+ * @param linear Pointer to the top-left byte of the GOB in the linear surface.
+ * @param pitch Distance in bytes between two rows of the linear surface.
+ */
+template <bool unswizzle>
+void CopyGob(u8* const gob, u8* const linear, const u32 pitch) {
+    for (u32 y = 0; y < gob_size_y; ++y) {
+        const auto& table = fast_swizzle_table[y];
+        u8* const row = linear + y * pitch;
+        for (u32 chunk = 0; chunk < 4; ++chunk) {
+            u8* const swizzled = gob + table[chunk];
+            u8* const unswizzled = row + chunk * fast_swizzle_align;
+            if constexpr (unswizzle) {
+                std::memcpy(unswizzled, swizzled, fast_swizzle_align);
+            } else {
+                std::memcpy(swizzled, unswizzled, fast_swizzle_align);
+            }
+        }
+    }
+}
+
 /**
  * This function manages ALL the GOBs(Group of Bytes) Inside a single block.
  * Instead of going gob by gob, we map the coordinates inside a block and manage from
@@ -99,10 +123,28 @@ void FastProcessBlock(u8* const swizzled_data, u8* const unswizzled_data, const
     const u32 x_startb = x_start * bytes_per_pixel;
     const u32 x_endb = x_end * bytes_per_pixel;
 
+    // Blocks spanning the whole GOB width are copied a GOB at a time
+    const bool whole_gobs =
+        x_endb - x_startb == gob_size_x && bytes_per_pixel == out_bytes_per_pixel;
+
     for (u32 z = z_start; z < z_end; z++) {
         u32 y_address = z_address;
         u32 pixel_base = layer_z * z + y_start * stride_x;
-        for (u32 y = y_start; y < y_end; y++) {
+        u32 y = y_start;
+        if (whole_gobs) {
+            for (; y + gob_size_y <= y_end; y += gob_size_y) {
+                u8* const gob = swizzled_data + y_address;
+                u8* const linear = unswizzled_data + pixel_base + x_startb;
+                if (unswizzle) {
+                    CopyGob<true>(gob, linear, stride_x);
+                } else {
+                    CopyGob<false>(gob, linear, stride_x);
+                }
+                pixel_base += gob_size_y * stride_x;
+                y_address += gob_size;
+            }
+        }
+        for (; y < y_end; y++) {
             const auto& table = fast_swizzle_table[y % gob_size_y];
             for (u32 xb = x_startb; xb < x_endb; xb += fast_swizzle_align) {
                 const u32 swizzle_offset{y_address + table[(xb / fast_swizzle_align) % 4]};
@@ -261,23 +303,50 @@ void SwizzleSubrect(u32 subrect_width, u32 subrect_height, u32 source_pitch, u32
     const u32 block_height = 1U << block_height_bit;
     const u32 image_width_in_gobs{(swizzled_width * bytes_per_pixel + (gob_size_x - 1)) /
                                   gob_size_x};
-    for (u32 line = 0; line < subrect_height; ++line) {
-        const u32 dst_y = line + offset_y;
-        const u32 gob_address_y =
-            (dst_y / (gob_size_y * block_height)) * gob_size * block_height * image_width_in_gobs +
-            ((dst_y % (gob_size_y * block_height)) / gob_size_y) * gob_size;
-        const auto& table = legacy_swizzle_table[dst_y % gob_size_y];
-        for (u32 x = 0; x < subrect_width; ++x) {
-            const u32 dst_x = x + offset_x;
-            const u32 gob_address =
-                gob_address_y + (dst_x * bytes_per_pixel / gob_size_x) * gob_size * block_height;
-            const u32 swizzled_offset = gob_address + table[(dst_x * bytes_per_pixel) % gob_size_x];
-            u8* source_line = unswizzled_data + line * source_pitch + x * bytes_per_pixel;
-            u8* dest_addr = swizzled_data + swizzled_offset;
+    const auto gob_address_y = [block_height, image_width_in_gobs](u32 dst_y) {
+        return (dst_y / (gob_size_y * block_height)) * gob_size * block_height *
+                   image_width_in_gobs +
+               ((dst_y % (gob_size_y * block_height)) / gob_size_y) * gob_size;
+    };
+    const auto swizzle_pixels = [&](u32 line_begin, u32 line_end, u32 x_begin, u32 x_end) {
+        for (u32 line = line_begin; line < line_end; ++line) {
+            const u32 dst_y = line + offset_y;
+            const u32 line_address = gob_address_y(dst_y);
+            const auto& table = legacy_swizzle_table[dst_y % gob_size_y];
+            for (u32 x = x_begin; x < x_end; ++x) {
+                const u32 dst_x = x + offset_x;
+                const u32 gob_address = line_address + (dst_x * bytes_per_pixel / gob_size_x) *
+                                                           gob_size * block_height;
+                const u32 swizzled_offset =
+                    gob_address + table[(dst_x * bytes_per_pixel) % gob_size_x];
+                u8* source_line = unswizzled_data + line * source_pitch + x * bytes_per_pixel;
+                u8* dest_addr = swizzled_data + swizzled_offset;
 
-            std::memcpy(dest_addr, source_line, bytes_per_pixel);
+                std::memcpy(dest_addr, source_line, bytes_per_pixel);
+            }
+        }
+    };
+
+    // Copy the GOBs fully covered by the subrect when it starts on a GOB boundary
+    u32 gob_lines = 0;
+    u32 gob_pixels = 0;
+    if (gob_size_x % bytes_per_pixel == 0 && (offset_x * bytes_per_pixel) % gob_size_x == 0 &&
+        offset_y % gob_size_y == 0) {
+        gob_lines = Common::AlignDown(subrect_height, gob_size_y);
+        gob_pixels = Common::AlignDown(subrect_width * bytes_per_pixel, gob_size_x) /
+                     bytes_per_pixel;
+    }
+    const u32 first_gob_x = offset_x * bytes_per_pixel / gob_size_x;
+    for (u32 line = 0; line < gob_lines; line += gob_size_y) {
+        const u32 line_address = gob_address_y(line + offset_y);
+        for (u32 x = 0; x < gob_pixels * bytes_per_pixel; x += gob_size_x) {
+            const u32 gob_x = first_gob_x + x / gob_size_x;
+            CopyGob<false>(swizzled_data + line_address + gob_x * gob_size * block_height,
+                           unswizzled_data + line * source_pitch + x, source_pitch);
         }
     }
+    swizzle_pixels(0, gob_lines, gob_pixels, subrect_width);
+    swizzle_pixels(gob_lines, subrect_height, 0, subrect_width);
 }
 
 void UnswizzleSubrect(u32 subrect_width, u32 subrect_height, u32 dest_pitch, u32 swizzled_width,
@@ -13,7 +13,6 @@
 #include "common/file_util.h"
 #include "common/string_util.h"
 #include "core/constants.h"
-#include "core/hle/lock.h"
 #include "yuzu/applets/profile_select.h"
 #include "yuzu/main.h"
 
@@ -145,7 +144,5 @@ void QtProfileSelector::SelectProfile(
 }
 
 void QtProfileSelector::MainWindowFinishedSelection(std::optional<Common::UUID> uuid) {
-    // Acquire the HLE mutex
-    std::lock_guard lock{HLE::g_hle_lock};
     callback(uuid);
 }
@@ -9,7 +9,6 @@
 #include <QLabel>
 #include <QLineEdit>
 #include <QVBoxLayout>
-#include "core/hle/lock.h"
 #include "yuzu/applets/software_keyboard.h"
 #include "yuzu/main.h"
 
@@ -141,13 +140,9 @@ void QtSoftwareKeyboard::SendTextCheckDialog(std::u16string error_message,
 }
 
 void QtSoftwareKeyboard::MainWindowFinishedText(std::optional<std::u16string> text) {
-    // Acquire the HLE mutex
-    std::lock_guard lock{HLE::g_hle_lock};
     text_output(std::move(text));
 }
 
 void QtSoftwareKeyboard::MainWindowFinishedCheckDialog() {
-    // Acquire the HLE mutex
-    std::lock_guard lock{HLE::g_hle_lock};
     finished_check();
 }
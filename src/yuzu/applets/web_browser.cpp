@@ -6,7 +6,6 @@
 
 #include <QKeyEvent>
 
-#include "core/hle/lock.h"
 #include "yuzu/applets/web_browser.h"
 #include "yuzu/main.h"
 
@@ -103,13 +102,9 @@ void QtWebBrowser::OpenPageLocal(std::string_view url, std::function<void()> unp
 }
 
 void QtWebBrowser::MainWindowUnpackRomFS() {
-    // Acquire the HLE mutex
-    std::lock_guard lock{HLE::g_hle_lock};
     unpack_romfs_callback();
 }
 
 void QtWebBrowser::MainWindowFinishedBrowsing() {
-    // Acquire the HLE mutex
-    std::lock_guard lock{HLE::g_hle_lock};
     finished_callback();
 }
@@ -6,8 +6,7 @@
 #include <QHBoxLayout>
 #include <QKeyEvent>
 #include <QOffscreenSurface>
-#include <QOpenGLWindow>
-#include <QPainter>
+#include <QOpenGLContext>
 #include <QScreen>
 #include <QWindow>
 #include <fmt/format.h>
@@ -33,6 +32,8 @@ void EmuThread::run() {
 
     MicroProfileOnThreadCreate("EmuThread");
 
+    render_window->StartPresenting();
+
     emit LoadProgress(VideoCore::LoadCallbackStage::Prepare, 0, 0);
 
     Core::System::GetInstance().Renderer().Rasterizer().LoadDiskResources(
@@ -82,6 +83,7 @@ void EmuThread::run() {
     }
 
     // Shutdown the core emulation
+    render_window->StopPresenting();
     Core::System::GetInstance().Shutdown();
 
 #if MICROPROFILE_ENABLED
@@ -114,18 +116,49 @@ private:
     QOpenGLContext context;
 };
 
-// This class overrides paintEvent and resizeEvent to prevent the GUI thread from stealing GL
-// context.
-// The corresponding functionality is handled in EmuThread instead
-class GGLWidgetInternal : public QOpenGLWindow {
+/// Presents the frames of the renderer, so the GUI thread only ever handles the user interface.
+class PresentThread final : public QThread {
 public:
-    GGLWidgetInternal(GRenderWindow* parent, QOpenGLContext* shared_context)
-        : QOpenGLWindow(shared_context), parent(parent) {}
+    explicit PresentThread(GRenderWindow* render_window) : render_window{render_window} {}
 
-    void paintEvent(QPaintEvent* ev) override {
-        if (do_painting) {
-            QPainter painter(this);
-        }
+    void run() override {
+        MicroProfileOnThreadCreate("PresentThread");
+
+        render_window->RunPresentLoop(stop_run);
+
+#if MICROPROFILE_ENABLED
+        MicroProfileOnThreadExit();
+#endif
+    }
+
+    void RequestStop() {
+        stop_run = true;
+    }
+
+    void Reset() {
+        stop_run = false;
+    }
+
+private:
+    GRenderWindow* render_window;
+    std::atomic_bool stop_run{false};
+};
+
+// A native window that the GUI thread never paints, only the present thread draws to it.
+class GGLWidgetInternal : public QWindow {
+public:
+    explicit GGLWidgetInternal(GRenderWindow* parent) : parent(parent) {
+        setSurfaceType(QSurface::OpenGLSurface);
+    }
+
+    void exposeEvent(QExposeEvent* event) override {
+        is_exposed = isExposed();
+        QWindow::exposeEvent(event);
+    }
+
+    /// Returns whether the window is visible, it may be called from any thread
+    bool IsExposed() const {
+        return is_exposed;
     }
 
     void resizeEvent(QResizeEvent* ev) override {
@@ -174,17 +207,9 @@ public:
             InputCommon::GetMotionEmu()->EndTilt();
     }
 
-    void DisablePainting() {
-        do_painting = false;
-    }
-
-    void EnablePainting() {
-        do_painting = true;
-    }
-
 private:
     GRenderWindow* parent;
-    bool do_painting;
+    std::atomic_bool is_exposed{false};
 };
 
 GRenderWindow::GRenderWindow(GMainWindow* parent, EmuThread* emu_thread)
@@ -197,6 +222,8 @@ GRenderWindow::GRenderWindow(GMainWindow* parent, EmuThread* emu_thread)
 
     InputCommon::Init();
     connect(this, &GRenderWindow::FirstFrameDisplayed, parent, &GMainWindow::OnLoadComplete);
+
+    present_thread = std::make_unique<PresentThread>(this);
 }
 
 GRenderWindow::~GRenderWindow() {
@@ -215,23 +242,11 @@ void GRenderWindow::moveContext() {
 }
 
 void GRenderWindow::SwapBuffers() {
-    // In our multi-threaded QWidget use case we shouldn't need to call `makeCurrent`,
-    // since we never call `doneCurrent` in this thread.
-    // However:
-    // - The Qt debug runtime prints a bogus warning on the console if `makeCurrent` wasn't called
-    // since the last time `swapBuffers` was executed;
-    // - On macOS, if `makeCurrent` isn't called explicitly, resizing the buffer breaks.
-    context->makeCurrent(child);
-
-    context->swapBuffers(child);
-    if (!first_frame) {
-        emit FirstFrameDisplayed();
-        first_frame = true;
-    }
+    // The renderer hands its frames to the present thread instead
 }
 
 void GRenderWindow::MakeCurrent() {
-    context->makeCurrent(child);
+    context->makeCurrent(offscreen_surface.get());
 }
 
 void GRenderWindow::DoneCurrent() {
@@ -249,8 +264,8 @@ void GRenderWindow::OnFramebufferSizeChanged() {
     // Screen changes potentially incur a change in screen DPI, hence we should update the
     // framebuffer size
     const qreal pixel_ratio = GetWindowPixelRatio();
-    const u32 width = child->QPaintDevice::width() * pixel_ratio;
-    const u32 height = child->QPaintDevice::height() * pixel_ratio;
+    const u32 width = child->width() * pixel_ratio;
+    const u32 height = child->height() * pixel_ratio;
     UpdateCurrentFramebufferLayout(width, height);
 }
 
@@ -363,7 +378,52 @@ std::unique_ptr<Core::Frontend::GraphicsContext> GRenderWindow::CreateSharedCont
     return std::make_unique<GGLContext>(context.get());
 }
 
+bool GRenderWindow::IsPresentedSeparately() const {
+    return true;
+}
+
+void GRenderWindow::StartPresenting() {
+    present_thread->Reset();
+    present_thread->start();
+}
+
+void GRenderWindow::StopPresenting() {
+    present_thread->RequestStop();
+    present_thread->wait();
+}
+
+void GRenderWindow::RunPresentLoop(const std::atomic_bool& stop_run) {
+    // Time to wait for a new frame before checking whether the thread should stop
+    static constexpr std::chrono::milliseconds present_timeout{100};
+
+    auto& renderer = Core::System::GetInstance().Renderer();
+    while (!stop_run) {
+        if (!child->IsExposed()) {
+            // Swapping the buffers of a hidden window may block until it's shown again
+            QThread::msleep(present_timeout.count());
+            continue;
+        }
+
+        // makeCurrent is called before every swap, on macOS resizing the window breaks otherwise
+        present_context->makeCurrent(child);
+        if (!renderer.TryPresent(present_timeout)) {
+            continue;
+        }
+        present_context->swapBuffers(child);
+
+        if (!first_frame.exchange(true)) {
+            emit FirstFrameDisplayed();
+        }
+    }
+
+    // Hand the context back to the GUI thread, which recreates it with the render target
+    present_context->doneCurrent();
+    present_context->moveToThread(qApp->thread());
+}
+
 void GRenderWindow::InitRenderTarget() {
+    present_context.reset();
+    offscreen_surface.reset();
     shared_context.reset();
     context.reset();
 
@@ -392,9 +452,18 @@ void GRenderWindow::InitRenderTarget() {
     context->setShareContext(shared_context.get());
     context->setFormat(fmt);
     context->create();
-    fmt.setSwapInterval(0);
-
-    child = new GGLWidgetInternal(this, shared_context.get());
+    offscreen_surface = std::make_unique<QOffscreenSurface>();
+    offscreen_surface->setFormat(fmt);
+    offscreen_surface->create();
+    // The present thread waits for the vertical blank, the renderer never does
+    present_context = std::make_unique<QOpenGLContext>();
+    present_context->setShareContext(shared_context.get());
+    present_context->setFormat(fmt);
+    present_context->create();
+    present_context->moveToThread(present_thread.get());
+
+    child = new GGLWidgetInternal(this);
+    child->setFormat(fmt);
     container = QWidget::createWindowContainer(child, this);
 
     QBoxLayout* layout = new QHBoxLayout(this);
@@ -450,12 +519,10 @@ void GRenderWindow::OnMinimalClientAreaChangeRequest(std::pair<u32, u32> minimal
 
 void GRenderWindow::OnEmulationStarting(EmuThread* emu_thread) {
     this->emu_thread = emu_thread;
-    child->DisablePainting();
 }
 
 void GRenderWindow::OnEmulationStopping() {
     emu_thread = nullptr;
-    child->EnablePainting();
 }
 
 void GRenderWindow::showEvent(QShowEvent* event) {
@@ -20,6 +20,8 @@ class QTouchEvent;
 class GGLWidgetInternal;
 class GMainWindow;
 class GRenderWindow;
+class PresentThread;
+class QOffscreenSurface;
 class QSurface;
 class QOpenGLContext;
 
@@ -124,6 +126,7 @@ public:
     void DoneCurrent() override;
     void PollEvents() override;
     std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const override;
+    bool IsPresentedSeparately() const override;
 
     void ForwardKeyPressEvent(QKeyEvent* event);
     void ForwardKeyReleaseEvent(QKeyEvent* event);
@@ -146,6 +149,16 @@ public:
 
     void CaptureScreenshot(u32 res_scale, const QString& screenshot_path);
 
+    /**
+     * Starts presenting the frames of the renderer on the present thread. It must be called
+     * while a renderer exists, and stopped before it's shut down.
+     */
+    void StartPresenting();
+    void StopPresenting();
+
+    /// Presents the frames of the renderer until stop_run is set, called by the present thread
+    void RunPresentLoop(const std::atomic_bool& stop_run);
+
 public slots:
     void moveContext(); // overridden
 
@@ -171,16 +184,22 @@ private:
     QByteArray geometry;
 
     EmuThread* emu_thread;
-    // Context that backs the GGLWidgetInternal (and will be used by core to render)
+    // Context used by core to render, current on the offscreen surface
     std::unique_ptr<QOpenGLContext> context;
+    std::unique_ptr<QOffscreenSurface> offscreen_surface;
+    // Context that backs the GGLWidgetInternal, only current on the present thread
+    std::unique_ptr<QOpenGLContext> present_context;
     // Context that will be shared between all newly created contexts. This should never be made
     // current
     std::unique_ptr<QOpenGLContext> shared_context;
 
+    /// Thread swapping the buffers of the GGLWidgetInternal, so the GUI thread never delays them
+    std::unique_ptr<PresentThread> present_thread;
+
     /// Temporary storage of the screenshot taken
     QImage screenshot_image;
 
-    bool first_frame = false;
+    std::atomic_bool first_frame{false};
 
 protected:
     void showEvent(QShowEvent* event) override;
@@ -211,7 +211,7 @@ const std::array<int, Settings::NativeKeyboard::NumKeyboardMods> Config::default
 // This must be in alphabetical order according to action name as it must have the same order as
 // UISetting::values.shortcuts, which is alphabetically ordered.
 // clang-format off
-const std::array<UISettings::Shortcut, 15> default_hotkeys{{
+const std::array<UISettings::Shortcut, 16> default_hotkeys{{
     {QStringLiteral("Capture Screenshot"),       QStringLiteral("Main Window"), {QStringLiteral("Ctrl+P"), Qt::ApplicationShortcut}},
     {QStringLiteral("Continue/Pause Emulation"), QStringLiteral("Main Window"), {QStringLiteral("F4"), Qt::WindowShortcut}},
     {QStringLiteral("Decrease Speed Limit"),     QStringLiteral("Main Window"), {QStringLiteral("-"), Qt::ApplicationShortcut}},
@@ -224,6 +224,7 @@ const std::array<UISettings::Shortcut, 15> default_hotkeys{{
     {QStringLiteral("Restart Emulation"),        QStringLiteral("Main Window"), {QStringLiteral("F6"), Qt::WindowShortcut}},
     {QStringLiteral("Stop Emulation"),           QStringLiteral("Main Window"), {QStringLiteral("F5"), Qt::WindowShortcut}},
     {QStringLiteral("Toggle Filter Bar"),        QStringLiteral("Main Window"), {QStringLiteral("Ctrl+F"), Qt::WindowShortcut}},
+    {QStringLiteral("Toggle Profile Trace"),     QStringLiteral("Main Window"), {QStringLiteral("Ctrl+T"), Qt::ApplicationShortcut}},
     {QStringLiteral("Toggle Speed Limit"),       QStringLiteral("Main Window"), {QStringLiteral("Ctrl+Z"), Qt::ApplicationShortcut}},
     {QStringLiteral("Toggle Status Bar"),        QStringLiteral("Main Window"), {QStringLiteral("Ctrl+S"), Qt::WindowShortcut}},
     {QStringLiteral("Change Docked Mode"),       QStringLiteral("Main Window"), {QStringLiteral("F10"), Qt::ApplicationShortcut}},
@@ -429,6 +430,8 @@ void Config::ReadControlValues() {
                     QStringLiteral("engine:motion_emu,update_period:100,sensitivity:0.01"))
             .toString()
             .toStdString();
+    Settings::values.sample_input_on_vsync =
+        ReadSetting(QStringLiteral("sample_input_on_vsync"), false).toBool();
 
     qt_config->endGroup();
 }
@@ -437,6 +440,23 @@ void Config::ReadCoreValues() {
     qt_config->beginGroup(QStringLiteral("Core"));
 
     Settings::values.use_multi_core = ReadSetting(QStringLiteral("use_multi_core"), false).toBool();
+    Settings::values.use_host_timing =
+        ReadSetting(QStringLiteral("use_host_timing"), false).toBool();
+    Settings::values.thread_placement =
+        ReadSetting(QStringLiteral("thread_placement"), QString{}).toString().toStdString();
+    Settings::values.cpu_accuracy = static_cast<Settings::CpuAccuracy>(
+        ReadSetting(QStringLiteral("cpu_accuracy"), 0).toUInt());
+
+    Settings::values.cpu_accuracy_overrides.clear();
+    const auto size = qt_config->beginReadArray(QStringLiteral("cpu_accuracy_overrides"));
+    for (int i = 0; i < size; ++i) {
+        qt_config->setArrayIndex(i);
+        const auto title_id = ReadSetting(QStringLiteral("title_id"), 0).toULongLong();
+        const auto accuracy = ReadSetting(QStringLiteral("accuracy"), 0).toUInt();
+        Settings::values.cpu_accuracy_overrides.insert_or_assign(
+            title_id, static_cast<Settings::CpuAccuracy>(accuracy));
+    }
+    qt_config->endArray();
 
     qt_config->endGroup();
 }
@@ -512,6 +532,10 @@ void Config::ReadDebuggingValues() {
     // Intentionally not using the QT default setting as this is intended to be changed in the ini
     Settings::values.record_frame_times =
         qt_config->value(QStringLiteral("record_frame_times"), false).toBool();
+    Settings::values.record_guest_profile =
+        qt_config->value(QStringLiteral("record_guest_profile"), false).toBool();
+    Settings::values.record_ipc_trace =
+        qt_config->value(QStringLiteral("record_ipc_trace"), false).toBool();
     Settings::values.use_gdbstub = ReadSetting(QStringLiteral("use_gdbstub"), false).toBool();
     Settings::values.gdbstub_port = ReadSetting(QStringLiteral("gdbstub_port"), 24689).toInt();
     Settings::values.program_args =
@@ -521,6 +545,12 @@ void Config::ReadDebuggingValues() {
     Settings::values.reporting_services =
         ReadSetting(QStringLiteral("reporting_services"), false).toBool();
     Settings::values.quest_flag = ReadSetting(QStringLiteral("quest_flag"), false).toBool();
+    Settings::values.disable_macro_jit =
+        ReadSetting(QStringLiteral("disable_macro_jit"), false).toBool();
+    Settings::values.validate_macro_jit =
+        ReadSetting(QStringLiteral("validate_macro_jit"), false).toBool();
+    Settings::values.disable_macro_hle =
+        ReadSetting(QStringLiteral("disable_macro_hle"), false).toBool();
 
     qt_config->endGroup();
 }
@@ -620,10 +650,24 @@ void Config::ReadRendererValues() {
     Settings::values.frame_limit = ReadSetting(QStringLiteral("frame_limit"), 100).toInt();
     Settings::values.use_disk_shader_cache =
         ReadSetting(QStringLiteral("use_disk_shader_cache"), true).toBool();
+    Settings::values.use_disk_texture_cache =
+        ReadSetting(QStringLiteral("use_disk_texture_cache"), false).toBool();
     Settings::values.use_accurate_gpu_emulation =
         ReadSetting(QStringLiteral("use_accurate_gpu_emulation"), false).toBool();
+    Settings::values.use_host_page_protection =
+        ReadSetting(QStringLiteral("use_host_page_protection"), false).toBool();
     Settings::values.use_asynchronous_gpu_emulation =
         ReadSetting(QStringLiteral("use_asynchronous_gpu_emulation"), false).toBool();
+    Settings::values.use_asynchronous_shaders =
+        ReadSetting(QStringLiteral("use_asynchronous_shaders"), false).toBool();
+    Settings::values.use_shader_warmup =
+        ReadSetting(QStringLiteral("use_shader_warmup"), false).toBool();
+    Settings::values.use_mailbox_presentation =
+        ReadSetting(QStringLiteral("use_mailbox_presentation"), false).toBool();
+    Settings::values.use_host_vsync =
+        ReadSetting(QStringLiteral("use_host_vsync"), false).toBool();
+    Settings::values.texture_memory_budget =
+        ReadSetting(QStringLiteral("texture_memory_budget"), 0).toUInt();
     Settings::values.force_30fps_mode =
         ReadSetting(QStringLiteral("force_30fps_mode"), false).toBool();
 
@@ -911,6 +955,8 @@ void Config::SaveControlValues() {
                  QString::fromStdString(Settings::values.motion_device),
                  QStringLiteral("engine:motion_emu,update_period:100,sensitivity:0.01"));
     WriteSetting(QStringLiteral("keyboard_enabled"), Settings::values.keyboard_enabled, false);
+    WriteSetting(QStringLiteral("sample_input_on_vsync"), Settings::values.sample_input_on_vsync,
+                 false);
 
     qt_config->endGroup();
 }
@@ -919,6 +965,20 @@ void Config::SaveCoreValues() {
     qt_config->beginGroup(QStringLiteral("Core"));
 
     WriteSetting(QStringLiteral("use_multi_core"), Settings::values.use_multi_core, false);
+    WriteSetting(QStringLiteral("use_host_timing"), Settings::values.use_host_timing, false);
+    WriteSetting(QStringLiteral("thread_placement"),
+                 QString::fromStdString(Settings::values.thread_placement), QStringLiteral(""));
+    WriteSetting(QStringLiteral("cpu_accuracy"), static_cast<u32>(Settings::values.cpu_accuracy),
+                 0);
+
+    qt_config->beginWriteArray(QStringLiteral("cpu_accuracy_overrides"));
+    int i = 0;
+    for (const auto& [title_id, accuracy] : Settings::values.cpu_accuracy_overrides) {
+        qt_config->setArrayIndex(i++);
+        WriteSetting(QStringLiteral("title_id"), QVariant::fromValue<u64>(title_id), 0);
+        WriteSetting(QStringLiteral("accuracy"), static_cast<u32>(accuracy), 0);
+    }
+    qt_config->endArray();
 
     qt_config->endGroup();
 }
@@ -967,6 +1027,9 @@ void Config::SaveDebuggingValues() {
 
     // Intentionally not using the QT default setting as this is intended to be changed in the ini
     qt_config->setValue(QStringLiteral("record_frame_times"), Settings::values.record_frame_times);
+    qt_config->setValue(QStringLiteral("record_guest_profile"),
+                        Settings::values.record_guest_profile);
+    qt_config->setValue(QStringLiteral("record_ipc_trace"), Settings::values.record_ipc_trace);
     WriteSetting(QStringLiteral("use_gdbstub"), Settings::values.use_gdbstub, false);
     WriteSetting(QStringLiteral("gdbstub_port"), Settings::values.gdbstub_port, 24689);
     WriteSetting(QStringLiteral("program_args"),
@@ -974,6 +1037,9 @@ void Config::SaveDebuggingValues() {
     WriteSetting(QStringLiteral("dump_exefs"), Settings::values.dump_exefs, false);
     WriteSetting(QStringLiteral("dump_nso"), Settings::values.dump_nso, false);
     WriteSetting(QStringLiteral("quest_flag"), Settings::values.quest_flag, false);
+    WriteSetting(QStringLiteral("disable_macro_jit"), Settings::values.disable_macro_jit, false);
+    WriteSetting(QStringLiteral("validate_macro_jit"), Settings::values.validate_macro_jit, false);
+    WriteSetting(QStringLiteral("disable_macro_hle"), Settings::values.disable_macro_hle, false);
 
     qt_config->endGroup();
 }
@@ -1045,10 +1111,22 @@ void Config::SaveRendererValues() {
     WriteSetting(QStringLiteral("frame_limit"), Settings::values.frame_limit, 100);
     WriteSetting(QStringLiteral("use_disk_shader_cache"), Settings::values.use_disk_shader_cache,
                  true);
+    WriteSetting(QStringLiteral("use_disk_texture_cache"), Settings::values.use_disk_texture_cache,
+                 false);
     WriteSetting(QStringLiteral("use_accurate_gpu_emulation"),
                  Settings::values.use_accurate_gpu_emulation, false);
+    WriteSetting(QStringLiteral("use_host_page_protection"),
+                 Settings::values.use_host_page_protection, false);
     WriteSetting(QStringLiteral("use_asynchronous_gpu_emulation"),
                  Settings::values.use_asynchronous_gpu_emulation, false);
+    WriteSetting(QStringLiteral("use_asynchronous_shaders"),
+                 Settings::values.use_asynchronous_shaders, false);
+    WriteSetting(QStringLiteral("use_shader_warmup"), Settings::values.use_shader_warmup, false);
+    WriteSetting(QStringLiteral("use_mailbox_presentation"),
+                 Settings::values.use_mailbox_presentation, false);
+    WriteSetting(QStringLiteral("use_host_vsync"), Settings::values.use_host_vsync, false);
+    WriteSetting(QStringLiteral("texture_memory_budget"), Settings::values.texture_memory_budget,
+                 0);
     WriteSetting(QStringLiteral("force_30fps_mode"), Settings::values.force_30fps_mode, false);
 
     // Cast to double because Qt's written float values are not human-readable
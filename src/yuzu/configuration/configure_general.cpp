@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <QCheckBox>
+#include <QComboBox>
 #include <QSpinBox>
 #include "core/core.h"
 #include "core/settings.h"
@@ -23,6 +24,8 @@ ConfigureGeneral::ConfigureGeneral(QWidget* parent)
     SetConfiguration();
 
     connect(ui->toggle_frame_limit, &QCheckBox::toggled, ui->frame_limit, &QSpinBox::setEnabled);
+    connect(ui->cpu_accuracy, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+            &ConfigureGeneral::UpdateCpuAccuracyDescription);
 }
 
 ConfigureGeneral::~ConfigureGeneral() = default;
@@ -36,6 +39,27 @@ void ConfigureGeneral::SetConfiguration() {
     ui->toggle_frame_limit->setChecked(Settings::values.use_frame_limit);
     ui->frame_limit->setEnabled(ui->toggle_frame_limit->isChecked());
     ui->frame_limit->setValue(Settings::values.frame_limit);
+
+    // The JIT is configured when the title boots
+    ui->cpu_accuracy->setEnabled(!Core::System::GetInstance().IsPoweredOn());
+    ui->cpu_accuracy->setCurrentIndex(static_cast<int>(Settings::values.cpu_accuracy));
+    UpdateCpuAccuracyDescription();
+}
+
+void ConfigureGeneral::UpdateCpuAccuracyDescription() {
+    switch (static_cast<Settings::CpuAccuracy>(ui->cpu_accuracy->currentIndex())) {
+    case Settings::CpuAccuracy::Accurate:
+        ui->cpu_accuracy_description->setText(
+            tr("Checks the bounds of every memory access of the title. Recommended when a title "
+               "misbehaves."));
+        break;
+    case Settings::CpuAccuracy::Unsafe:
+        ui->cpu_accuracy_description->setText(
+            tr("Skips the bounds checks of memory accesses, accesses past the address space of "
+               "the title wrap around instead of failing. Faster, but some titles misbehave or "
+               "crash."));
+        break;
+    }
 }
 
 void ConfigureGeneral::ApplyConfiguration() {
@@ -47,6 +71,8 @@ void ConfigureGeneral::ApplyConfiguration() {
 
     Settings::values.use_frame_limit = ui->toggle_frame_limit->isChecked();
     Settings::values.frame_limit = ui->frame_limit->value();
+    Settings::values.cpu_accuracy =
+        static_cast<Settings::CpuAccuracy>(ui->cpu_accuracy->currentIndex());
 }
 
 void ConfigureGeneral::changeEvent(QEvent* event) {
@@ -59,4 +85,5 @@ void ConfigureGeneral::changeEvent(QEvent* event) {
 
 void ConfigureGeneral::RetranslateUI() {
     ui->retranslateUi(this);
+    UpdateCpuAccuracyDescription();
 }
@@ -27,6 +27,7 @@ private:
     void RetranslateUI();
 
     void SetConfiguration();
+    void UpdateCpuAccuracyDescription();
 
     std::unique_ptr<Ui::ConfigureGeneral> ui;
 };
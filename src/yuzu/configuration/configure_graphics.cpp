@@ -73,9 +73,18 @@ void ConfigureGraphics::SetConfiguration() {
         static_cast<int>(FromResolutionFactor(Settings::values.resolution_factor)));
     ui->use_disk_shader_cache->setEnabled(runtime_lock);
     ui->use_disk_shader_cache->setChecked(Settings::values.use_disk_shader_cache);
+    ui->use_disk_texture_cache->setEnabled(runtime_lock);
+    ui->use_disk_texture_cache->setChecked(Settings::values.use_disk_texture_cache);
     ui->use_accurate_gpu_emulation->setChecked(Settings::values.use_accurate_gpu_emulation);
+    ui->use_host_page_protection->setEnabled(runtime_lock);
+    ui->use_host_page_protection->setChecked(Settings::values.use_host_page_protection);
     ui->use_asynchronous_gpu_emulation->setEnabled(runtime_lock);
     ui->use_asynchronous_gpu_emulation->setChecked(Settings::values.use_asynchronous_gpu_emulation);
+    ui->use_asynchronous_shaders->setEnabled(runtime_lock);
+    ui->use_asynchronous_shaders->setChecked(Settings::values.use_asynchronous_shaders);
+    ui->use_shader_warmup->setEnabled(runtime_lock);
+    ui->use_shader_warmup->setChecked(Settings::values.use_shader_warmup);
+    ui->texture_memory_budget->setValue(static_cast<int>(Settings::values.texture_memory_budget));
     ui->force_30fps_mode->setEnabled(runtime_lock);
     ui->force_30fps_mode->setChecked(Settings::values.force_30fps_mode);
     UpdateBackgroundColorButton(QColor::fromRgbF(Settings::values.bg_red, Settings::values.bg_green,
@@ -86,9 +95,14 @@ void ConfigureGraphics::ApplyConfiguration() {
     Settings::values.resolution_factor =
         ToResolutionFactor(static_cast<Resolution>(ui->resolution_factor_combobox->currentIndex()));
     Settings::values.use_disk_shader_cache = ui->use_disk_shader_cache->isChecked();
+    Settings::values.use_disk_texture_cache = ui->use_disk_texture_cache->isChecked();
     Settings::values.use_accurate_gpu_emulation = ui->use_accurate_gpu_emulation->isChecked();
+    Settings::values.use_host_page_protection = ui->use_host_page_protection->isChecked();
     Settings::values.use_asynchronous_gpu_emulation =
         ui->use_asynchronous_gpu_emulation->isChecked();
+    Settings::values.use_asynchronous_shaders = ui->use_asynchronous_shaders->isChecked();
+    Settings::values.use_shader_warmup = ui->use_shader_warmup->isChecked();
+    Settings::values.texture_memory_budget = static_cast<u32>(ui->texture_memory_budget->value());
     Settings::values.force_30fps_mode = ui->force_30fps_mode->isChecked();
     Settings::values.bg_red = static_cast<float>(bg_color.redF());
     Settings::values.bg_green = static_cast<float>(bg_color.greenF());
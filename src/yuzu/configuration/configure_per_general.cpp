@@ -90,6 +90,15 @@ void ConfigurePerGameGeneral::ApplyConfiguration() {
     }
 
     Settings::values.disabled_addons[title_id] = disabled_addons;
+
+    // The first entry uses the global setting, the others are the accuracies in order
+    const int accuracy_index = ui->cpu_accuracy->currentIndex();
+    if (accuracy_index == 0) {
+        Settings::values.cpu_accuracy_overrides.erase(title_id);
+    } else {
+        Settings::values.cpu_accuracy_overrides.insert_or_assign(
+            title_id, static_cast<Settings::CpuAccuracy>(accuracy_index - 1));
+    }
 }
 
 void ConfigurePerGameGeneral::changeEvent(QEvent* event) {
@@ -116,6 +125,10 @@ void ConfigurePerGameGeneral::LoadConfiguration() {
 
     ui->display_title_id->setText(QString::fromStdString(fmt::format("{:016X}", title_id)));
 
+    const auto accuracy = Settings::values.cpu_accuracy_overrides.find(title_id);
+    const bool uses_global = accuracy == Settings::values.cpu_accuracy_overrides.end();
+    ui->cpu_accuracy->setCurrentIndex(uses_global ? 0 : static_cast<int>(accuracy->second) + 1);
+
     FileSys::PatchManager pm{title_id};
     const auto control = pm.GetControlMetadata();
     const auto loader = Loader::GetLoader(file);
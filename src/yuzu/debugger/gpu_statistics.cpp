@@ -0,0 +1,69 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <QHeaderView>
+#include <QTableWidget>
+#include <QTimer>
+
+#include "core/core.h"
+#include "video_core/gpu.h"
+#include "video_core/gpu_statistics.h"
+#include "yuzu/debugger/gpu_statistics.h"
+
+namespace {
+
+/// Interval between refreshes of the table, in milliseconds.
+constexpr int REFRESH_INTERVAL = 500;
+
+} // Anonymous namespace
+
+GPUStatisticsWidget::GPUStatisticsWidget(QWidget* parent)
+    : QDockWidget(tr("GPU Statistics"), parent) {
+    setObjectName(QStringLiteral("GPUStatisticsWidget"));
+
+    table = new QTableWidget(static_cast<int>(VideoCore::NumGPUCounters), 2, this);
+    table->setHorizontalHeaderLabels({tr("Counter"), tr("Last Frame")});
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->verticalHeader()->hide();
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionMode(QAbstractItemView::NoSelection);
+    for (std::size_t i = 0; i < VideoCore::NumGPUCounters; ++i) {
+        const auto counter = static_cast<VideoCore::GPUCounter>(i);
+        const int row = static_cast<int>(i);
+        table->setItem(row, 0,
+                       new QTableWidgetItem(QString::fromUtf8(GetGPUCounterName(counter))));
+        auto* const value = new QTableWidgetItem(QStringLiteral("0"));
+        value->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        table->setItem(row, 1, value);
+    }
+    setWidget(table);
+
+    update_timer = new QTimer(this);
+    update_timer->setInterval(REFRESH_INTERVAL);
+    connect(update_timer, &QTimer::timeout, this, &GPUStatisticsWidget::Refresh);
+}
+
+GPUStatisticsWidget::~GPUStatisticsWidget() = default;
+
+void GPUStatisticsWidget::showEvent(QShowEvent* event) {
+    QDockWidget::showEvent(event);
+    Refresh();
+    update_timer->start();
+}
+
+void GPUStatisticsWidget::hideEvent(QHideEvent* event) {
+    QDockWidget::hideEvent(event);
+    update_timer->stop();
+}
+
+void GPUStatisticsWidget::Refresh() {
+    auto& system = Core::System::GetInstance();
+    if (!system.IsPoweredOn()) {
+        return;
+    }
+    const auto frame = system.GPU().Statistics().GetLastFrame();
+    for (std::size_t i = 0; i < VideoCore::NumGPUCounters; ++i) {
+        table->item(static_cast<int>(i), 1)->setText(QString::number(frame.values[i]));
+    }
+}
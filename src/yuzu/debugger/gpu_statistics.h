@@ -0,0 +1,29 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <QDockWidget>
+
+class QTableWidget;
+class QTimer;
+
+/// Shows the GPU counters of the last emulated frame, refreshed while the widget is visible.
+class GPUStatisticsWidget : public QDockWidget {
+    Q_OBJECT
+
+public:
+    explicit GPUStatisticsWidget(QWidget* parent = nullptr);
+    ~GPUStatisticsWidget() override;
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    void Refresh();
+
+    QTableWidget* table;
+    QTimer* update_timer;
+};
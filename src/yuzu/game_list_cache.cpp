@@ -0,0 +1,147 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+
+#include "common/common_funcs.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "yuzu/game_list_cache.h"
+
+namespace {
+
+constexpr u32 CACHE_MAGIC = Common::MakeMagic('Y', 'G', 'L', 'C');
+/// Bump when the layout of the entries changes, older files are then ignored.
+constexpr u32 CACHE_VERSION = 1;
+
+std::string GetCachePath() {
+    return FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + DIR_SEP "game_list" DIR_SEP
+           "files.bin";
+}
+
+template <typename T>
+bool ReadValue(FileUtil::IOFile& file, T& value) {
+    return file.ReadArray(&value, 1) == 1;
+}
+
+template <typename Container>
+bool ReadSized(FileUtil::IOFile& file, Container& container) {
+    u32 size;
+    if (!ReadValue(file, size) || size > file.GetSize()) {
+        return false;
+    }
+    container.resize(size);
+    return file.ReadArray(container.data(), size) == size;
+}
+
+template <typename T>
+bool WriteValue(FileUtil::IOFile& file, const T& value) {
+    return file.WriteObject(value) == 1;
+}
+
+template <typename Container>
+bool WriteSized(FileUtil::IOFile& file, const Container& container) {
+    return WriteValue(file, static_cast<u32>(container.size())) &&
+           file.WriteArray(container.data(), container.size()) == container.size();
+}
+
+} // Anonymous namespace
+
+GameListFileCache::GameListFileCache() = default;
+
+GameListFileCache::~GameListFileCache() = default;
+
+void GameListFileCache::Load() {
+    FileUtil::IOFile file(GetCachePath(), "rb");
+    if (!file.IsOpen()) {
+        return;
+    }
+
+    u32 magic;
+    u32 version;
+    u32 num_entries;
+    if (!ReadValue(file, magic) || !ReadValue(file, version) || !ReadValue(file, num_entries) ||
+        magic != CACHE_MAGIC || version != CACHE_VERSION) {
+        LOG_INFO(Frontend, "Game list file cache is invalid or outdated, ignoring it");
+        return;
+    }
+
+    for (u32 i = 0; i < num_entries; ++i) {
+        std::string path;
+        Entry entry;
+        u32 file_type;
+        if (!ReadSized(file, path) || !ReadValue(file, entry.size) ||
+            !ReadValue(file, entry.modification_time) || !ReadValue(file, file_type) ||
+            !ReadValue(file, entry.program_id) || !ReadSized(file, entry.name) ||
+            !ReadSized(file, entry.icon)) {
+            LOG_ERROR(Frontend, "Game list file cache is truncated, ignoring it");
+            stored_entries.clear();
+            return;
+        }
+        entry.file_type = static_cast<Loader::FileType>(file_type);
+        stored_entries.insert_or_assign(std::move(path), std::move(entry));
+    }
+}
+
+void GameListFileCache::Save() const {
+    if (!is_modified && entries.size() == stored_entries.size()) {
+        return;
+    }
+
+    // Written next to the cache and renamed over it, other scans never see a partial file
+    const std::string path = GetCachePath();
+    const std::string temp_path = path + ".tmp";
+    FileUtil::CreateFullPath(path);
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        if (!file.IsOpen()) {
+            LOG_ERROR(Frontend, "Failed to open the game list file cache for writing");
+            return;
+        }
+
+        bool is_written = WriteValue(file, CACHE_MAGIC) && WriteValue(file, CACHE_VERSION) &&
+                          WriteValue(file, static_cast<u32>(entries.size()));
+        for (const auto& [file_path, entry] : entries) {
+            is_written = is_written && WriteSized(file, file_path) &&
+                         WriteValue(file, entry.size) &&
+                         WriteValue(file, entry.modification_time) &&
+                         WriteValue(file, static_cast<u32>(entry.file_type)) &&
+                         WriteValue(file, entry.program_id) && WriteSized(file, entry.name) &&
+                         WriteSized(file, entry.icon);
+        }
+        if (!is_written || !file.Close()) {
+            LOG_ERROR(Frontend, "Failed to write the game list file cache");
+            return;
+        }
+    }
+
+    FileUtil::Delete(path);
+    if (!FileUtil::Rename(temp_path, path)) {
+        LOG_ERROR(Frontend, "Failed to replace the game list file cache");
+    }
+}
+
+const GameListFileCache::Entry* GameListFileCache::Find(const std::string& path, u64 size,
+                                                        s64 modification_time) {
+    auto iter = entries.find(path);
+    if (iter == entries.end()) {
+        const auto stored = stored_entries.find(path);
+        if (stored == stored_entries.end()) {
+            return nullptr;
+        }
+        iter = entries.insert_or_assign(path, stored->second).first;
+    }
+
+    const Entry& entry = iter->second;
+    if (entry.size != size || entry.modification_time != modification_time) {
+        return nullptr;
+    }
+    return &entry;
+}
+
+void GameListFileCache::Insert(const std::string& path, Entry entry) {
+    entries.insert_or_assign(path, std::move(entry));
+    is_modified = true;
+}
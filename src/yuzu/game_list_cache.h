@@ -0,0 +1,51 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/loader/loader.h"
+
+/**
+ * Metadata of the files found when scanning the game directories, kept across launches in a single
+ * file of the game list cache directory. Entries are keyed by path and only used while the size
+ * and modification time of their file are unchanged, so a rescan only opens the files that changed.
+ */
+class GameListFileCache {
+public:
+    struct Entry {
+        u64 size = 0;
+        s64 modification_time = 0;
+        Loader::FileType file_type = Loader::FileType::Unknown;
+        u64 program_id = 0;
+        std::string name;
+        std::vector<u8> icon;
+    };
+
+    GameListFileCache();
+    ~GameListFileCache();
+
+    /// Loads the entries stored by the previous scan.
+    void Load();
+
+    /// Stores the entries found or added since Load, the others belong to files that are gone.
+    void Save() const;
+
+    /// Returns the entry of a file if it didn't change since it was added, nullptr otherwise.
+    const Entry* Find(const std::string& path, u64 size, s64 modification_time);
+
+    /// Adds or replaces the entry of a file.
+    void Insert(const std::string& path, Entry entry);
+
+private:
+    /// Entries loaded from the cache file
+    std::unordered_map<std::string, Entry> stored_entries;
+    /// Entries of the files seen by this scan
+    std::unordered_map<std::string, Entry> entries;
+    bool is_modified = false;
+};
@@ -7,6 +7,7 @@
 #include <utility>
 #include <vector>
 
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -27,6 +28,7 @@
 #include "core/loader/loader.h"
 #include "yuzu/compatibility_list.h"
 #include "yuzu/game_list.h"
+#include "yuzu/game_list_cache.h"
 #include "yuzu/game_list_p.h"
 #include "yuzu/game_list_worker.h"
 #include "yuzu/uisettings.h"
@@ -187,10 +189,23 @@ QString FormatPatchNameVersions(const FileSys::PatchManager& patch_manager,
     return out;
 }
 
+/// Whether the contents of files of this type are added to the manual content provider.
+bool HasContentProviderEntries(Loader::FileType file_type) {
+    return file_type == Loader::FileType::NCA || file_type == Loader::FileType::XCI ||
+           file_type == Loader::FileType::NSP;
+}
+
+bool IsShownFileType(Loader::FileType file_type) {
+    return UISettings::values.show_unknown ||
+           (file_type != Loader::FileType::Unknown && file_type != Loader::FileType::Error);
+}
+
+/// patch_versions is only called when the add-ons of the title aren't cached yet
 QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::string& name,
-                                        const std::vector<u8>& icon, Loader::AppLoader& loader,
+                                        const std::vector<u8>& icon, Loader::FileType file_type,
                                         u64 program_id, const CompatibilityList& compatibility_list,
-                                        const FileSys::PatchManager& patch) {
+                                        const FileSys::PatchManager& patch,
+                                        const std::function<QString()>& patch_versions) {
     const auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
 
     // The game list uses this as compatibility number for untested games
@@ -199,7 +214,6 @@ QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::stri
         compatibility = it->second.first;
     }
 
-    const auto file_type = loader.GetFileType();
     const auto file_type_string = QString::fromStdString(Loader::GetFileTypeString(file_type));
 
     QList<QStandardItem*> list{
@@ -211,11 +225,9 @@ QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::stri
     };
 
     if (UISettings::values.show_add_ons) {
-        const auto patch_versions = GetGameListCachedObject(
-            fmt::format("{:016X}", patch.GetTitleID()), "pv.txt", [&patch, &loader] {
-                return FormatPatchNameVersions(patch, loader, loader.IsRomFSUpdatable());
-            });
-        list.insert(2, new GameListItem(patch_versions));
+        const auto versions = GetGameListCachedObject(fmt::format("{:016X}", patch.GetTitleID()),
+                                                      "pv.txt", patch_versions);
+        list.insert(2, new GameListItem(versions));
     }
 
     return list;
@@ -271,8 +283,12 @@ void GameListWorker::AddTitlesToGameList(GameListDir* parent_dir) {
         if (control != nullptr)
             GetMetadataFromControlNCA(patch, *control, icon, name);
 
-        emit EntryReady(MakeGameListEntry(file->GetFullPath(), name, icon, *loader, program_id,
-                                          compatibility_list, patch),
+        emit EntryReady(MakeGameListEntry(file->GetFullPath(), name, icon, loader->GetFileType(),
+                                          program_id, compatibility_list, patch,
+                                          [&patch, &loader] {
+                                              return FormatPatchNameVersions(
+                                                  patch, *loader, loader->IsRomFSUpdatable());
+                                          }),
                         parent_dir);
     }
 }
@@ -291,6 +307,39 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
         const bool is_dir = FileUtil::IsDirectory(physical_name);
         if (!is_dir &&
             (HasSupportedFileExtension(physical_name) || IsExtractedNCAMain(physical_name))) {
+            // Unchanged files are listed from the cache without opening them
+            const QFileInfo file_info(QString::fromStdString(physical_name));
+            const auto file_size = static_cast<u64>(file_info.size());
+            const s64 modification_time = file_info.lastModified().toMSecsSinceEpoch();
+            const GameListFileCache::Entry* const cached =
+                UISettings::values.cache_game_list
+                    ? file_cache.Find(physical_name, file_size, modification_time)
+                    : nullptr;
+            if (cached != nullptr) {
+                if (!IsShownFileType(cached->file_type)) {
+                    return true;
+                }
+                if (target == ScanTarget::PopulateGameList) {
+                    const FileSys::PatchManager patch{cached->program_id};
+                    const auto patch_versions = [this, &physical_name, &patch] {
+                        const auto loader =
+                            Loader::GetLoader(vfs->OpenFile(physical_name, FileSys::Mode::Read));
+                        if (!loader) {
+                            return QString{};
+                        }
+                        return FormatPatchNameVersions(patch, *loader, loader->IsRomFSUpdatable());
+                    };
+                    emit EntryReady(MakeGameListEntry(physical_name, cached->name, cached->icon,
+                                                      cached->file_type, cached->program_id,
+                                                      compatibility_list, patch, patch_versions),
+                                    parent_dir);
+                    return true;
+                }
+                if (!HasContentProviderEntries(cached->file_type)) {
+                    return true;
+                }
+            }
+
             const auto file = vfs->OpenFile(physical_name, FileSys::Mode::Read);
             auto loader = Loader::GetLoader(file);
             if (!loader) {
@@ -298,8 +347,8 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
             }
 
             const auto file_type = loader->GetFileType();
-            if ((file_type == Loader::FileType::Unknown || file_type == Loader::FileType::Error) &&
-                !UISettings::values.show_unknown) {
+            if (!IsShownFileType(file_type)) {
+                file_cache.Insert(physical_name, {file_size, modification_time, file_type});
                 return true;
             }
 
@@ -333,9 +382,17 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
 
                 const FileSys::PatchManager patch{program_id};
 
-                emit EntryReady(MakeGameListEntry(physical_name, name, icon, *loader, program_id,
-                                                  compatibility_list, patch),
+                emit EntryReady(MakeGameListEntry(physical_name, name, icon, file_type, program_id,
+                                                  compatibility_list, patch,
+                                                  [&patch, &loader] {
+                                                      return FormatPatchNameVersions(
+                                                          patch, *loader,
+                                                          loader->IsRomFSUpdatable());
+                                                  }),
                                 parent_dir);
+
+                file_cache.Insert(physical_name, {file_size, modification_time, file_type,
+                                                  program_id, std::move(name), std::move(icon)});
             }
         } else if (is_dir && recursion > 0) {
             watch_list.append(QString::fromStdString(physical_name));
@@ -350,6 +407,9 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
 
 void GameListWorker::run() {
     stop_processing = false;
+    if (UISettings::values.cache_game_list) {
+        file_cache.Load();
+    }
 
     for (UISettings::GameDir& game_dir : game_dirs) {
         if (game_dir.path == QStringLiteral("SDMC")) {
@@ -376,6 +436,11 @@ void GameListWorker::run() {
         }
     };
 
+    // A cancelled scan hasn't seen all the files, saving would drop the entries of the others
+    if (UISettings::values.cache_game_list && !stop_processing) {
+        file_cache.Save();
+    }
+
     emit Finished(watch_list);
 }
 
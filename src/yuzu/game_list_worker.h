@@ -18,6 +18,7 @@
 
 #include "common/common_types.h"
 #include "yuzu/compatibility_list.h"
+#include "yuzu/game_list_cache.h"
 
 class QStandardItem;
 
@@ -79,5 +80,6 @@ private:
     const CompatibilityList& compatibility_list;
 
     QStringList watch_list;
+    GameListFileCache file_cache;
     std::atomic_bool stop_processing;
 };
@@ -67,6 +67,7 @@ static FileSys::VirtualFile VfsDirectoryCreateFileWrapper(const FileSys::Virtual
 #include "common/logging/filter.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "common/microprofile_trace.h"
 #include "common/scm_rev.h"
 #include "common/scope_exit.h"
 #ifdef ARCHITECTURE_x86_64
@@ -101,6 +102,7 @@ static FileSys::VirtualFile VfsDirectoryCreateFileWrapper(const FileSys::Virtual
 #include "yuzu/configuration/config.h"
 #include "yuzu/configuration/configure_dialog.h"
 #include "yuzu/debugger/console.h"
+#include "yuzu/debugger/gpu_statistics.h"
 #include "yuzu/debugger/graphics/graphics_breakpoints.h"
 #include "yuzu/debugger/profiler.h"
 #include "yuzu/debugger/wait_tree.h"
@@ -508,6 +510,11 @@ void GMainWindow::InitializeDebugWidgets() {
             &WaitTreeWidget::OnEmulationStarting);
     connect(this, &GMainWindow::EmulationStopping, waitTreeWidget,
             &WaitTreeWidget::OnEmulationStopping);
+
+    gpuStatisticsWidget = new GPUStatisticsWidget(this);
+    addDockWidget(Qt::RightDockWidgetArea, gpuStatisticsWidget);
+    gpuStatisticsWidget->hide();
+    debug_menu->addAction(gpuStatisticsWidget->toggleViewAction());
 }
 
 void GMainWindow::InitializeRecentFileMenuActions() {
@@ -634,6 +641,8 @@ void GMainWindow::InitializeHotkeys() {
                 OnDockedModeChanged(!Settings::values.use_docked_mode,
                                     Settings::values.use_docked_mode);
             });
+    connect(hotkey_registry.GetHotkey(main_window, QStringLiteral("Toggle Profile Trace"), this),
+            &QShortcut::activated, this, &GMainWindow::OnToggleProfileTrace);
 }
 
 void GMainWindow::SetDefaultUIGeometry() {
@@ -1030,6 +1039,8 @@ void GMainWindow::ShutdownGame() {
     emu_thread->wait();
     emu_thread = nullptr;
 
+    Common::StopProfileTrace();
+
     discord_rpc->Update();
 
     // The emulation is stopped, so closing the window or not does not matter anymore
@@ -1457,34 +1468,30 @@ void GMainWindow::OnMenuInstallToNAND() {
     }
 
     const auto qt_raw_copy = [this](const FileSys::VirtualFile& src,
-                                    const FileSys::VirtualFile& dest, std::size_t block_size) {
+                                    const FileSys::VirtualFile& dest, std::size_t block_size,
+                                    const FileSys::VfsCopyBlockCallback& on_block) {
         if (src == nullptr || dest == nullptr)
             return false;
-        if (!dest->Resize(src->GetSize()))
-            return false;
 
-        std::array<u8, 0x1000> buffer{};
-        const int progress_maximum = static_cast<int>(src->GetSize() / buffer.size());
+        // In MiB, so the maximum still fits into an int for large files
+        constexpr std::size_t progress_unit = 0x100000;
+        const int progress_maximum =
+            static_cast<int>((src->GetSize() + progress_unit - 1) / progress_unit);
 
         QProgressDialog progress(
             tr("Installing file \"%1\"...").arg(QString::fromStdString(src->GetName())),
             tr("Cancel"), 0, progress_maximum, this);
         progress.setWindowModality(Qt::WindowModal);
 
-        for (std::size_t i = 0; i < src->GetSize(); i += buffer.size()) {
-            if (progress.wasCanceled()) {
-                dest->Resize(0);
-                return false;
-            }
-
-            const int progress_value = static_cast<int>(i / buffer.size());
-            progress.setValue(progress_value);
-
-            const auto read = src->Read(buffer.data(), buffer.size(), i);
-            dest->Write(buffer.data(), read, i);
+        const bool copied = FileSys::VfsPipelinedCopy(
+            src, dest, block_size, on_block, [&progress](std::size_t written) {
+                progress.setValue(static_cast<int>(written / progress_unit));
+                return !progress.wasCanceled();
+            });
+        if (!copied) {
+            dest->Resize(0);
         }
-
-        return true;
+        return copied;
     };
 
     const auto success = [this]() {
@@ -1910,6 +1917,25 @@ void GMainWindow::OnCaptureScreenshot() {
     OnStartGame();
 }
 
+void GMainWindow::OnToggleProfileTrace() {
+    if (Common::IsProfileTraceRunning()) {
+        Common::StopProfileTrace();
+        LOG_INFO(Frontend, "Stopped the profile trace");
+        return;
+    }
+
+    const auto date = QDateTime::currentDateTime()
+                          .toString(QStringLiteral("yyyy-MM-dd_hh-mm-ss"))
+                          .toStdString();
+    const std::string path =
+        FileUtil::GetUserPath(FileUtil::UserPath::LogDir) + "trace_" + date + ".json";
+    if (!Common::StartProfileTrace(path)) {
+        LOG_ERROR(Frontend, "Failed to open trace file {}", path);
+        return;
+    }
+    LOG_INFO(Frontend, "Writing the profile trace to {}", path);
+}
+
 void GMainWindow::UpdateWindowTitle(const QString& title_name) {
     const auto full_name = std::string(Common::g_build_fullname);
     const auto branch_name = std::string(Common::g_scm_branch);
@@ -1948,7 +1974,35 @@ void GMainWindow::UpdateStatusBar() {
         emu_speed_label->setText(tr("Speed: %1%").arg(results.emulation_speed * 100.0, 0, 'f', 0));
     }
     game_fps_label->setText(tr("Game: %1 FPS").arg(results.game_fps, 0, 'f', 0));
-    emu_frametime_label->setText(tr("Frame: %1 ms").arg(results.frametime * 1000.0, 0, 'f', 2));
+    emu_frametime_label->setText(tr("Frame: %1 ms (p99: %2 ms)")
+                                     .arg(results.frametime * 1000.0, 0, 'f', 2)
+                                     .arg(results.breakdown.frametime.p99 * 1000.0, 0, 'f', 2));
+
+    // The tooltip breaks the frame time down, as p50 / p95 / p99 over the recent frames
+    const auto format_percentiles = [](const Core::PerfPercentiles& percentiles) {
+        return QStringLiteral("%1 / %2 / %3 ms")
+            .arg(percentiles.p50 * 1000.0, 0, 'f', 2)
+            .arg(percentiles.p95 * 1000.0, 0, 'f', 2)
+            .arg(percentiles.p99 * 1000.0, 0, 'f', 2);
+    };
+    QString breakdown =
+        tr("Time taken to emulate a Switch frame, not counting framelimiting or v-sync. For "
+           "full-speed emulation this should be at most 16.67 ms.");
+    breakdown += QLatin1Char{'\n'};
+    breakdown += tr("p50 / p95 / p99 over the last %1 frames:")
+                     .arg(results.breakdown.window_frames);
+    breakdown += QStringLiteral("\nframe: ") + format_percentiles(results.breakdown.frametime);
+    for (std::size_t i = 0; i < Core::NumPerfCategories; ++i) {
+        breakdown += QStringLiteral("\n%1: %2")
+                         .arg(QString::fromUtf8(
+                             Core::GetPerfCategoryName(static_cast<Core::PerfCategory>(i))))
+                         .arg(format_percentiles(results.breakdown.categories[i]));
+    }
+    if (Settings::values.use_frame_limit) {
+        breakdown += tr("\nFrame limiter overshoot: %1 ms")
+                         .arg(results.frame_limiter_overshoot * 1000.0, 0, 'f', 3);
+    }
+    emu_frametime_label->setToolTip(breakdown);
 
     emu_speed_label->setVisible(true);
     game_fps_label->setVisible(true);
@@ -23,6 +23,7 @@ class EmuThread;
 class GameList;
 class GImageInfo;
 class GraphicsBreakPointsWidget;
+class GPUStatisticsWidget;
 class GRenderWindow;
 class LoadingScreen;
 class MicroProfileDialog;
@@ -213,6 +214,8 @@ private slots:
     void HideFullscreen();
     void ToggleWindowMode();
     void OnCaptureScreenshot();
+    /// Starts writing a Chrome trace of the profiled scopes to the log directory, or finishes it.
+    void OnToggleProfileTrace();
     void OnCoreError(Core::System::ResultStatus, std::string);
     void OnReinitializeKeys(ReinitializeKeyBehavior behavior);
 
@@ -257,6 +260,7 @@ private:
     MicroProfileDialog* microProfileDialog;
     GraphicsBreakPointsWidget* graphicsBreakpointsWidget;
     WaitTreeWidget* waitTreeWidget;
+    GPUStatisticsWidget* gpuStatisticsWidget;
 
     QAction* actions_recent_files[max_recent_files_item];
 
@@ -0,0 +1,283 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <fmt/format.h>
+#include <glad/glad.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "core/frontend/framebuffer_layout.h"
+#include "core/settings.h"
+#include "input_common/main.h"
+#include "yuzu_cmd/emu_window/emu_window_headless_egl.h"
+#include "yuzu_cmd/emu_window/emu_window_sdl2_gl.h"
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+namespace {
+
+volatile std::sig_atomic_t stop_requested = 0;
+
+void OnStopSignal(int) {
+    stop_requested = 1;
+}
+
+bool HasExtension(const char* extensions, const char* name) {
+    if (extensions == nullptr) {
+        return false;
+    }
+    const std::size_t length = std::strlen(name);
+    for (const char* it = std::strstr(extensions, name); it != nullptr;
+         it = std::strstr(it + length, name)) {
+        const bool starts = it == extensions || it[-1] == ' ';
+        const bool ends = it[length] == '\0' || it[length] == ' ';
+        if (starts && ends) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Opens a display that needs no display server: the surfaceless platform of Mesa, or the first
+/// device of drivers that enumerate them, falling back to the default display.
+EGLDisplay OpenDisplay() {
+    const char* const client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    const auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (get_platform_display != nullptr) {
+        if (HasExtension(client_extensions, "EGL_MESA_platform_surfaceless")) {
+            const EGLDisplay display =
+                get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (display != EGL_NO_DISPLAY) {
+                return display;
+            }
+        }
+        const auto query_devices =
+            reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+        if (query_devices != nullptr &&
+            HasExtension(client_extensions, "EGL_EXT_platform_device")) {
+            EGLDeviceEXT device;
+            EGLint num_devices = 0;
+            if (query_devices(1, &device, &num_devices) == EGL_TRUE && num_devices > 0) {
+                const EGLDisplay display =
+                    get_platform_display(EGL_PLATFORM_DEVICE_EXT, device, nullptr);
+                if (display != EGL_NO_DISPLAY) {
+                    return display;
+                }
+            }
+        }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+EGLContext CreateContext(EGLDisplay display, EGLConfig config, EGLContext share_context) {
+    static constexpr EGLint attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION,
+        4,
+        EGL_CONTEXT_MINOR_VERSION,
+        3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK,
+        EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+        EGL_NONE,
+    };
+    return eglCreateContext(display, config, share_context, attributes);
+}
+
+EGLSurface CreateSurface(EGLDisplay display, EGLConfig config, u32 width, u32 height) {
+    const EGLint attributes[] = {
+        EGL_WIDTH, static_cast<EGLint>(width), EGL_HEIGHT, static_cast<EGLint>(height), EGL_NONE,
+    };
+    return eglCreatePbufferSurface(display, config, attributes);
+}
+
+void* GetProcAddress(const char* name) {
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+[[noreturn]] void Fail(const char* what) {
+    LOG_CRITICAL(Frontend, "{}! EGL error 0x{:04X}", what, eglGetError());
+    std::exit(1);
+}
+
+} // Anonymous namespace
+
+class EGLSharedContext : public Core::Frontend::GraphicsContext {
+public:
+    explicit EGLSharedContext(EGLDisplay display, EGLConfig config, EGLContext share_context,
+                              bool surfaceless)
+        : display{display} {
+        context = CreateContext(display, config, share_context);
+        // Contexts of other threads never draw to their surface, it can be as small as it gets
+        surface = surfaceless ? EGL_NO_SURFACE : CreateSurface(display, config, 1, 1);
+    }
+
+    ~EGLSharedContext() {
+        if (surface != EGL_NO_SURFACE) {
+            eglDestroySurface(display, surface);
+        }
+        eglDestroyContext(display, context);
+    }
+
+    void MakeCurrent() override {
+        eglMakeCurrent(display, surface, surface, context);
+    }
+
+    void DoneCurrent() override {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+    void SwapBuffers() override {}
+
+private:
+    EGLDisplay display;
+    EGLContext context;
+    EGLSurface surface;
+};
+
+EmuWindow_Headless_EGL::EmuWindow_Headless_EGL(std::string dump_path_, u32 dump_interval)
+    : dump_path{std::move(dump_path_)}, dump_interval{dump_interval} {
+    std::signal(SIGINT, OnStopSignal);
+    std::signal(SIGTERM, OnStopSignal);
+    InputCommon::Init();
+
+    display = OpenDisplay();
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || eglInitialize(display, &major, &minor) != EGL_TRUE) {
+        Fail("Failed to initialize EGL");
+    }
+    LOG_INFO(Frontend, "EGL {}.{} by {}", major, minor, eglQueryString(display, EGL_VENDOR));
+    surfaceless = HasExtension(eglQueryString(display, EGL_EXTENSIONS),
+                               "EGL_KHR_surfaceless_context");
+
+    if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE) {
+        Fail("Failed to bind the OpenGL API");
+    }
+    static constexpr EGLint config_attributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE,     8,               EGL_GREEN_SIZE,      8,
+        EGL_BLUE_SIZE,    8,               EGL_NONE,
+    };
+    EGLint num_configs = 0;
+    if (eglChooseConfig(display, config_attributes, &config, 1, &num_configs) != EGL_TRUE ||
+        num_configs == 0) {
+        Fail("Failed to find an EGL config for offscreen OpenGL rendering");
+    }
+
+    context = CreateContext(display, config, EGL_NO_CONTEXT);
+    if (context == EGL_NO_CONTEXT) {
+        Fail("Failed to create EGL GL context");
+    }
+
+    // The surface matches the resolution the console outputs in its current mode
+    u32 width = Layout::ScreenUndocked::Width;
+    u32 height = Layout::ScreenUndocked::Height;
+    if (Settings::values.use_docked_mode) {
+        width = Layout::ScreenDocked::WidthDocked;
+        height = Layout::ScreenDocked::HeightDocked;
+    }
+    surface = CreateSurface(display, config, width, height);
+    if (surface == EGL_NO_SURFACE) {
+        Fail("Failed to create EGL offscreen surface");
+    }
+    UpdateCurrentFramebufferLayout(width, height);
+
+    MakeCurrent();
+    if (!gladLoadGLLoader(GetProcAddress)) {
+        Fail("Failed to initialize GL functions");
+    }
+    if (!EmuWindow_SDL2_GL::SupportsRequiredGLExtensions()) {
+        LOG_CRITICAL(Frontend, "GPU does not support all required OpenGL extensions! Exiting...");
+        std::exit(1);
+    }
+    if (!dump_path.empty() && !FileUtil::CreateFullPath(dump_path + '/')) {
+        LOG_ERROR(Frontend, "Failed to create frame dump directory {}", dump_path);
+        this->dump_path.clear();
+    }
+
+    LOG_INFO(Frontend, "yuzu Version: {} | {}-{}", Common::g_build_fullname, Common::g_scm_branch,
+             Common::g_scm_desc);
+    Settings::LogSettings();
+
+    DoneCurrent();
+}
+
+EmuWindow_Headless_EGL::~EmuWindow_Headless_EGL() {
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroySurface(display, surface);
+    eglDestroyContext(display, context);
+    eglTerminate(display);
+    InputCommon::Shutdown();
+}
+
+void EmuWindow_Headless_EGL::PollEvents() {}
+
+bool EmuWindow_Headless_EGL::IsOpen() const {
+    return stop_requested == 0;
+}
+
+void EmuWindow_Headless_EGL::SwapBuffers() {
+    // Nothing is shown, but swapping still flushes the frame like on a window
+    eglSwapBuffers(display, surface);
+    ++frame_count;
+    if (!dump_path.empty() && dump_interval != 0 && frame_count % dump_interval == 0) {
+        DumpFrame();
+    }
+}
+
+void EmuWindow_Headless_EGL::MakeCurrent() {
+    eglMakeCurrent(display, surface, surface, context);
+}
+
+void EmuWindow_Headless_EGL::DoneCurrent() {
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
+std::unique_ptr<Core::Frontend::GraphicsContext> EmuWindow_Headless_EGL::CreateSharedContext()
+    const {
+    return std::make_unique<EGLSharedContext>(display, config, context, surfaceless);
+}
+
+void EmuWindow_Headless_EGL::DumpFrame() {
+    const auto& layout = GetFramebufferLayout();
+    const u32 width = layout.width;
+    const u32 height = layout.height;
+
+    // The renderer caches its bindings, restore the ones reading the surface changes
+    GLint read_framebuffer, pack_buffer, pack_alignment;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read_framebuffer);
+    glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pack_buffer);
+    glGetIntegerv(GL_PACK_ALIGNMENT, &pack_alignment);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    const std::size_t row_size = width * 3;
+    std::vector<u8> pixels(row_size * height);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, read_framebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pack_buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, pack_alignment);
+
+    // Rows are read bottom up, images are stored top down
+    const std::string filename = fmt::format("{}/frame_{:08}.ppm", dump_path, frame_count);
+    FileUtil::IOFile file(filename, "wb");
+    const std::string header = fmt::format("P6\n{} {}\n255\n", width, height);
+    bool written = file.WriteString(header) == header.size();
+    for (u32 y = height; y-- > 0;) {
+        written &= file.WriteBytes(pixels.data() + y * row_size, row_size) == row_size;
+    }
+    if (!written) {
+        LOG_ERROR(Frontend, "Failed to write frame dump {}", filename);
+    }
+}
@@ -0,0 +1,64 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "common/common_types.h"
+#include "core/frontend/emu_window.h"
+
+/**
+ * Window without a display server, rendering to an offscreen surface of an EGL context. Runs until
+ * the process is asked to stop with SIGINT or SIGTERM, and optionally writes every few presented
+ * frames to a directory as PPM images.
+ */
+class EmuWindow_Headless_EGL final : public Core::Frontend::EmuWindow {
+public:
+    /**
+     * @param dump_path     Directory the presented frames are written to, none when empty
+     * @param dump_interval Number of presented frames between two written ones
+     */
+    explicit EmuWindow_Headless_EGL(std::string dump_path, u32 dump_interval);
+    ~EmuWindow_Headless_EGL();
+
+    /// Polls window events, of which there are none
+    void PollEvents() override;
+
+    /// Whether the process wasn't asked to stop yet
+    bool IsOpen() const;
+
+    /// Presents the next frame, writing it out when it's due
+    void SwapBuffers() override;
+
+    /// Makes the graphics context current for the caller thread
+    void MakeCurrent() override;
+
+    /// Releases the GL context from the caller thread
+    void DoneCurrent() override;
+
+    std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const override;
+
+private:
+    /// Writes the frame in the offscreen surface to the dump directory.
+    void DumpFrame();
+
+    using EGLDisplay = void*;
+    using EGLConfig = void*;
+    using EGLContext = void*;
+    using EGLSurface = void*;
+
+    EGLDisplay display;
+    EGLConfig config;
+    /// The OpenGL context the renderer presents with
+    EGLContext context;
+    /// The offscreen surface frames are presented to
+    EGLSurface surface;
+    /// Whether contexts can be made current without a surface
+    bool surfaceless;
+
+    std::string dump_path;
+    u32 dump_interval;
+    u64 frame_count = 0;
+};
@@ -24,9 +24,10 @@ public:
 
     std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const override;
 
+    /// Whether the GPU and driver of the current context support the OpenGL extensions required
+    static bool SupportsRequiredGLExtensions();
+
 private:
-    /// Whether the GPU and driver supports the OpenGL extension required
-    bool SupportsRequiredGLExtensions();
 
     using SDL_GLContext = void*;
     /// The OpenGL context associated with the window
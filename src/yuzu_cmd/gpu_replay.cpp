@@ -0,0 +1,235 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/percentile.h"
+#include "common/scm_rev.h"
+#include "common/scope_exit.h"
+#include "common/string_util.h"
+#include "core/core.h"
+#include "core/settings.h"
+#include "video_core/gpu.h"
+#include "video_core/gpu_replay.h"
+#include "yuzu_cmd/config.h"
+#include "yuzu_cmd/emu_window/emu_window_sdl2.h"
+#include "yuzu_cmd/emu_window/emu_window_sdl2_gl.h"
+
+#ifdef _WIN32
+// windows.h needs to be included before shellapi.h
+#include <windows.h>
+
+#include <shellapi.h>
+#endif
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+extern "C" {
+// tells Nvidia and AMD drivers to use the dedicated GPU by default on laptops with switchable
+// graphics
+__declspec(dllexport) unsigned long NvOptimusEnablement = 0x00000001;
+__declspec(dllexport) int AmdPowerXpressRequestHighPerformance = 1;
+}
+#endif
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <capture>\n"
+                 "Replays a GPU capture written by yuzu-cmd --gpu-capture, without emulating the "
+                 "CPU.\n"
+                 "-l, --loops=NUMBER    Replay the capture NUMBER times, 1 by default\n"
+                 "-o, --output=FILE     Write the time of each replayed frame to FILE as CSV\n"
+                 "-f, --fullscreen      Start in fullscreen mode\n"
+                 "-h, --help            Display this help and exit\n"
+                 "-v, --version         Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "yuzu " << Common::g_scm_branch << " " << Common::g_scm_desc << std::endl;
+}
+
+static void InitializeLogging() {
+    Log::Filter log_filter(Log::Level::Debug);
+    log_filter.ParseFilterString(Settings::values.log_filter);
+    Log::SetGlobalFilter(log_filter);
+
+    Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
+
+    const std::string& log_dir = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
+    FileUtil::CreateFullPath(log_dir);
+    Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+#ifdef _WIN32
+    Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
+#endif
+}
+
+/// Prints the frame time percentiles of the replayed frames, in milliseconds.
+static void PrintSummary(std::vector<double> frame_times, double total_time) {
+    std::sort(frame_times.begin(), frame_times.end());
+    const auto frames = frame_times.size();
+    std::cout << fmt::format("{} frames in {:.3f} s, {:.2f} FPS", frames, total_time,
+                             total_time > 0.0 ? frames / total_time : 0.0)
+              << std::endl
+              << fmt::format("Frame time (ms) | p50 {:.3f} | p95 {:.3f} | p99 {:.3f} | max {:.3f}",
+                             Common::GetPercentile(frame_times, 0.50) * 1000.0,
+                             Common::GetPercentile(frame_times, 0.95) * 1000.0,
+                             Common::GetPercentile(frame_times, 0.99) * 1000.0,
+                             (frame_times.empty() ? 0.0 : frame_times.back()) * 1000.0)
+              << std::endl;
+}
+
+/// Application entry point
+int main(int argc, char** argv) {
+    Config config;
+
+    int option_index = 0;
+
+    InitializeLogging();
+
+    char* endarg;
+#ifdef _WIN32
+    int argc_w;
+    auto argv_w = CommandLineToArgvW(GetCommandLineW(), &argc_w);
+
+    if (argv_w == nullptr) {
+        LOG_CRITICAL(Frontend, "Failed to get command line arguments");
+        return -1;
+    }
+#endif
+    std::string filepath;
+
+    bool fullscreen = false;
+    u32 loops = 1;
+    std::string output_path;
+
+    static struct option long_options[] = {
+        {"loops", required_argument, 0, 'l'},   {"output", required_argument, 0, 'o'},
+        {"fullscreen", no_argument, 0, 'f'},    {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},       {0, 0, 0, 0},
+    };
+
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "l:o:fhv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'l':
+                errno = 0;
+                loops = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg || loops == 0)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--loops");
+                    exit(1);
+                }
+                break;
+            case 'o':
+                output_path = optarg;
+                break;
+            case 'f':
+                fullscreen = true;
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+#ifdef _WIN32
+            filepath = Common::UTF16ToUTF8(argv_w[optind]);
+#else
+            filepath = argv[optind];
+#endif
+            optind++;
+        }
+    }
+
+#ifdef _WIN32
+    LocalFree(argv_w);
+#endif
+
+    MicroProfileOnThreadCreate("EmuThread");
+    SCOPE_EXIT({ MicroProfileShutdown(); });
+
+    if (filepath.empty()) {
+        LOG_CRITICAL(Frontend, "No GPU capture specified");
+        return -1;
+    }
+
+    const auto replay = VideoCommon::GPUReplay::Open(filepath);
+    if (replay == nullptr) {
+        return -1;
+    }
+
+    // Frames are presented as fast as they are rendered
+    Settings::values.use_frame_limit = false;
+    Settings::Apply();
+
+    std::unique_ptr<EmuWindow_SDL2> emu_window{std::make_unique<EmuWindow_SDL2_GL>(fullscreen)};
+    emu_window->MakeCurrent();
+
+    Core::System& system{Core::System::GetInstance()};
+    if (system.LoadWithoutApplication(*emu_window) != Core::System::ResultStatus::Success) {
+        LOG_CRITICAL(Frontend, "Failed to initialize VideoCore!");
+        return -1;
+    }
+    SCOPE_EXIT({ system.Shutdown(); });
+
+    if (!replay->Initialize(system)) {
+        return -1;
+    }
+
+    FileUtil::IOFile output;
+    if (!output_path.empty()) {
+        if (output.Open(output_path, "w")) {
+            output.WriteString("loop,frame,time_ms\n");
+        } else {
+            LOG_ERROR(Frontend, "Failed to open output file {}", output_path);
+        }
+    }
+
+    // The time of a frame spans from its first command to the end of its presentation
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> frame_times;
+    frame_times.reserve(replay->GetNumFrames() * loops);
+    const auto start_time = Clock::now();
+    for (u32 loop = 0; loop < loops && emu_window->IsOpen(); ++loop) {
+        for (std::size_t frame = 0; emu_window->IsOpen(); ++frame) {
+            const auto frame_start = Clock::now();
+            if (!replay->ReplayFrame()) {
+                break;
+            }
+            system.GPU().WaitIdle();
+            const double frame_time =
+                std::chrono::duration<double>(Clock::now() - frame_start).count();
+            frame_times.push_back(frame_time);
+            if (output.IsOpen()) {
+                output.WriteString(fmt::format("{},{},{:.3f}\n", loop, frame, frame_time * 1000.0));
+            }
+        }
+    }
+    const double total_time = std::chrono::duration<double>(Clock::now() - start_time).count();
+
+    PrintSummary(std::move(frame_times), total_time);
+    return 0;
+}
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -16,6 +17,7 @@
 #include "common/logging/filter.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "common/microprofile_trace.h"
 #include "common/scm_rev.h"
 #include "common/scope_exit.h"
 #include "common/string_util.h"
@@ -26,12 +28,19 @@
 #include "core/gdbstub/gdbstub.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/loader/loader.h"
+#include "core/perf_stats.h"
 #include "core/settings.h"
 #include "core/telemetry_session.h"
+#include "video_core/gpu.h"
+#include "video_core/gpu_capture.h"
+#include "video_core/gpu_statistics.h"
 #include "video_core/renderer_base.h"
 #include "yuzu_cmd/config.h"
 #include "yuzu_cmd/emu_window/emu_window_sdl2.h"
 #include "yuzu_cmd/emu_window/emu_window_sdl2_gl.h"
+#ifdef HAS_EGL
+#include "yuzu_cmd/emu_window/emu_window_headless_egl.h"
+#endif
 
 #include "core/file_sys/registered_cache.h"
 
@@ -64,13 +73,71 @@ static void PrintHelp(const char* argv0) {
                  "-f, --fullscreen      Start in fullscreen mode\n"
                  "-h, --help            Display this help and exit\n"
                  "-v, --version         Output version information and exit\n"
-                 "-p, --program         Pass following string as arguments to executable\n";
+                 "-p, --program         Pass following string as arguments to executable\n"
+                 "-s, --gpu-stats=FILE  Write the GPU counters of each frame to FILE as CSV\n"
+                 "-t, --perf-stats=FILE Write the frame time breakdown to FILE as CSV\n"
+                 "-r, --trace=FILE      Write the profiled scopes of all threads to FILE as a "
+                 "Chrome trace\n"
+                 "-i, --record-input=FILE Record the controller input to FILE, to be replayed "
+                 "by yuzu-tester\n"
+                 "-c, --gpu-capture=FILE Capture the GPU command streams to FILE, to be replayed "
+                 "by gpu-replay\n"
+                 "-b, --gpu-capture-start=NUMBER Start the GPU capture after NUMBER frames, 0 by "
+                 "default\n"
+                 "-n, --gpu-capture-frames=NUMBER Capture NUMBER frames, 60 by default\n"
+                 "-H, --headless        Render offscreen without a window, until interrupted\n"
+                 "-d, --dump-frames=DIR Write presented frames to DIR as PPM images when "
+                 "headless\n"
+                 "-e, --dump-interval=NUMBER Write every NUMBERth frame, 60 by default\n";
 }
 
 static void PrintVersion() {
     std::cout << "yuzu " << Common::g_scm_branch << " " << Common::g_scm_desc << std::endl;
 }
 
+/// Writes the GPU counters of each frame that ends to a CSV file, one row per frame.
+static void DumpGPUStatistics(VideoCore::GPUStatistics& statistics,
+                              std::shared_ptr<FileUtil::IOFile> file) {
+    std::string header = "frame";
+    for (std::size_t i = 0; i < VideoCore::NumGPUCounters; ++i) {
+        header += fmt::format(",{}", GetGPUCounterName(static_cast<VideoCore::GPUCounter>(i)));
+    }
+    file->WriteString(header + '\n');
+
+    statistics.SetFrameCallback([file](const VideoCore::GPUStatistics::Frame& frame) {
+        std::string row = std::to_string(frame.number);
+        for (const u64 value : frame.values) {
+            row += fmt::format(",{}", value);
+        }
+        file->WriteString(row + '\n');
+    });
+}
+
+/// Writes the percentiles of the frame time breakdown to a CSV file whenever they are updated, in
+/// milliseconds.
+static void DumpFrameBreakdown(Core::PerfStats& perf_stats,
+                               std::shared_ptr<FileUtil::IOFile> file) {
+    std::string header = "frame,window_frames,frametime_p50,frametime_p95,frametime_p99";
+    for (std::size_t i = 0; i < Core::NumPerfCategories; ++i) {
+        const char* const name = Core::GetPerfCategoryName(static_cast<Core::PerfCategory>(i));
+        header += fmt::format(",{0}_p50,{0}_p95,{0}_p99", name);
+    }
+    file->WriteString(header + '\n');
+
+    perf_stats.SetBreakdownCallback([file](const Core::FrameBreakdown& breakdown) {
+        const auto format = [](const Core::PerfPercentiles& percentiles) {
+            return fmt::format(",{:.3f},{:.3f},{:.3f}", percentiles.p50 * 1000.0,
+                               percentiles.p95 * 1000.0, percentiles.p99 * 1000.0);
+        };
+        std::string row = fmt::format("{},{}", breakdown.frame, breakdown.window_frames);
+        row += format(breakdown.frametime);
+        for (const auto& percentiles : breakdown.categories) {
+            row += format(percentiles);
+        }
+        file->WriteString(row + '\n');
+    });
+}
+
 static void InitializeLogging() {
     Log::Filter log_filter(Log::Level::Debug);
     log_filter.ParseFilterString(Settings::values.log_filter);
@@ -110,15 +177,33 @@ int main(int argc, char** argv) {
     std::string filepath;
 
     bool fullscreen = false;
+    std::string gpu_stats_path;
+    std::string perf_stats_path;
+    std::string trace_path;
+    std::string gpu_capture_path;
+    u32 gpu_capture_start = 0;
+    u32 gpu_capture_frames = 60;
+    bool headless = false;
+#ifdef HAS_EGL
+    std::string frame_dump_path;
+    u32 frame_dump_interval = 60;
+#endif
 
     static struct option long_options[] = {
         {"gdbport", required_argument, 0, 'g'}, {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},          {"version", no_argument, 0, 'v'},
-        {"program", optional_argument, 0, 'p'}, {0, 0, 0, 0},
+        {"program", optional_argument, 0, 'p'}, {"gpu-stats", required_argument, 0, 's'},
+        {"perf-stats", required_argument, 0, 't'}, {"trace", required_argument, 0, 'r'},
+        {"record-input", required_argument, 0, 'i'}, {"gpu-capture", required_argument, 0, 'c'},
+        {"gpu-capture-start", required_argument, 0, 'b'},
+        {"gpu-capture-frames", required_argument, 0, 'n'}, {"headless", no_argument, 0, 'H'},
+        {"dump-frames", required_argument, 0, 'd'}, {"dump-interval", required_argument, 0, 'e'},
+        {0, 0, 0, 0},
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "g:fhvp::", long_options, &option_index);
+        int arg =
+            getopt_long(argc, argv, "g:fhvp::s:t:r:i:c:b:n:Hd:e:", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'g':
@@ -146,6 +231,57 @@ int main(int argc, char** argv) {
                 Settings::values.program_args = argv[optind];
                 ++optind;
                 break;
+            case 's':
+                gpu_stats_path = optarg;
+                break;
+            case 't':
+                perf_stats_path = optarg;
+                break;
+            case 'r':
+                trace_path = optarg;
+                break;
+            case 'i':
+                Settings::values.input_record_path = optarg;
+                break;
+            case 'c':
+                gpu_capture_path = optarg;
+                break;
+            case 'b':
+            case 'n': {
+                errno = 0;
+                const u32 value = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror(arg == 'b' ? "--gpu-capture-start" : "--gpu-capture-frames");
+                    exit(1);
+                }
+                (arg == 'b' ? gpu_capture_start : gpu_capture_frames) = value;
+                break;
+            }
+            case 'H':
+                headless = true;
+                break;
+#ifdef HAS_EGL
+            case 'd':
+                frame_dump_path = optarg;
+                break;
+            case 'e':
+                errno = 0;
+                frame_dump_interval = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--dump-interval");
+                    exit(1);
+                }
+                break;
+#else
+            case 'd':
+            case 'e':
+                LOG_CRITICAL(Frontend, "Dumping frames requires a build with EGL");
+                return -1;
+#endif
             }
         } else {
 #ifdef _WIN32
@@ -174,7 +310,27 @@ int main(int argc, char** argv) {
     Settings::values.use_gdbstub = use_gdbstub;
     Settings::Apply();
 
-    std::unique_ptr<EmuWindow_SDL2> emu_window{std::make_unique<EmuWindow_SDL2_GL>(fullscreen)};
+    std::unique_ptr<EmuWindow_SDL2> sdl_window;
+#ifdef HAS_EGL
+    std::unique_ptr<EmuWindow_Headless_EGL> headless_window;
+#endif
+    Core::Frontend::EmuWindow* emu_window;
+    std::function<bool()> is_open;
+    if (headless) {
+#ifdef HAS_EGL
+        headless_window =
+            std::make_unique<EmuWindow_Headless_EGL>(frame_dump_path, frame_dump_interval);
+        emu_window = headless_window.get();
+        is_open = [&headless_window] { return headless_window->IsOpen(); };
+#else
+        LOG_CRITICAL(Frontend, "Headless rendering requires a build with EGL");
+        return -1;
+#endif
+    } else {
+        sdl_window = std::make_unique<EmuWindow_SDL2_GL>(fullscreen);
+        emu_window = sdl_window.get();
+        is_open = [&sdl_window] { return sdl_window->IsOpen(); };
+    }
 
     if (!Settings::values.use_multi_core) {
         // Single core mode must acquire OpenGL context for entire emulation session
@@ -221,10 +377,40 @@ int main(int argc, char** argv) {
     emu_window->MakeCurrent();
     system.Renderer().Rasterizer().LoadDiskResources();
 
-    while (emu_window->IsOpen()) {
+    if (!gpu_stats_path.empty()) {
+        auto file = std::make_shared<FileUtil::IOFile>(gpu_stats_path, "w");
+        if (file->IsOpen()) {
+            DumpGPUStatistics(system.GPU().Statistics(), std::move(file));
+        } else {
+            LOG_ERROR(Frontend, "Failed to open GPU statistics file {}", gpu_stats_path);
+        }
+    }
+
+    if (!perf_stats_path.empty()) {
+        auto file = std::make_shared<FileUtil::IOFile>(perf_stats_path, "w");
+        if (file->IsOpen()) {
+            DumpFrameBreakdown(system.GetPerfStats(), std::move(file));
+        } else {
+            LOG_ERROR(Frontend, "Failed to open performance statistics file {}", perf_stats_path);
+        }
+    }
+
+    if (!trace_path.empty() && !Common::StartProfileTrace(trace_path)) {
+        LOG_ERROR(Frontend, "Failed to open trace file {}", trace_path);
+    }
+
+    if (!gpu_capture_path.empty() &&
+        !system.GPU().Capture().Start(gpu_capture_path, gpu_capture_start, gpu_capture_frames)) {
+        LOG_ERROR(Frontend, "Failed to start the GPU capture to {}", gpu_capture_path);
+    }
+
+    while (is_open()) {
         system.RunLoop();
     }
 
+    system.GPU().Capture().Stop();
+    Common::StopProfileTrace();
+
     system.Shutdown();
 
     detached_tasks.WaitForAllTasks();
@@ -0,0 +1,107 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <iostream>
+
+#include <fmt/format.h>
+
+#include "common/percentile.h"
+#include "core/perf_stats.h"
+#include "yuzu_tester/benchmark.h"
+
+Benchmark::Benchmark(u64 num_frames)
+    : num_frames(num_frames), start_time(Clock::now()), last_frame_time(start_time) {
+    frame_times.reserve(num_frames);
+}
+
+Benchmark::~Benchmark() = default;
+
+bool Benchmark::OpenOutput(const std::string& path) {
+    std::lock_guard lock{mutex};
+    if (!output.Open(path, "w")) {
+        return false;
+    }
+
+    std::string header = "frame,time_ms";
+    for (std::size_t i = 0; i < VideoCore::NumGPUCounters; ++i) {
+        header += fmt::format(",{}", GetGPUCounterName(static_cast<VideoCore::GPUCounter>(i)));
+    }
+    output.WriteString(header + '\n');
+    return true;
+}
+
+void Benchmark::OnFrame(const VideoCore::GPUStatistics::Frame& frame) {
+    std::lock_guard lock{mutex};
+    if (finished) {
+        return;
+    }
+
+    const auto now = Clock::now();
+    const double frame_time = std::chrono::duration<double>(now - last_frame_time).count();
+    last_frame_time = now;
+    frame_times.push_back(frame_time);
+    for (std::size_t i = 0; i < counter_totals.size(); ++i) {
+        counter_totals[i] += frame.values[i];
+    }
+
+    if (output.IsOpen()) {
+        std::string row = fmt::format("{},{:.3f}", frame_times.size(), frame_time * 1000.0);
+        for (const u64 value : frame.values) {
+            row += fmt::format(",{}", value);
+        }
+        output.WriteString(row + '\n');
+    }
+
+    if (frame_times.size() >= num_frames) {
+        output.Close();
+        finished = true;
+    }
+}
+
+bool Benchmark::IsFinished() const {
+    return finished;
+}
+
+void Benchmark::PrintSummary(const Core::FrameBreakdown& breakdown) const {
+    std::lock_guard lock{mutex};
+    const auto frames = frame_times.size();
+    const double total_time = std::chrono::duration<double>(last_frame_time - start_time).count();
+
+    std::vector<double> sorted = frame_times;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::cout << fmt::format("{} frames in {:.3f} s, {:.2f} FPS", frames, total_time,
+                             total_time > 0.0 ? frames / total_time : 0.0)
+              << std::endl
+              << fmt::format("Frame time (ms) | p50 {:.3f} | p95 {:.3f} | p99 {:.3f} | max {:.3f}",
+                             Common::GetPercentile(sorted, 0.50) * 1000.0,
+                             Common::GetPercentile(sorted, 0.95) * 1000.0,
+                             Common::GetPercentile(sorted, 0.99) * 1000.0,
+                             (sorted.empty() ? 0.0 : sorted.back()) * 1000.0)
+              << std::endl
+              << std::endl
+              << "Counter              | Mean per frame" << std::endl;
+    for (std::size_t i = 0; i < counter_totals.size(); ++i) {
+        const char* const name = GetGPUCounterName(static_cast<VideoCore::GPUCounter>(i));
+        const double mean = frames > 0 ? static_cast<double>(counter_totals[i]) / frames : 0.0;
+        std::cout << fmt::format("{:<20} | {:.2f}", name, mean) << std::endl;
+    }
+
+    std::cout << std::endl
+              << fmt::format("Breakdown of the last {} system frames (ms) | p50 | p95 | p99",
+                             breakdown.window_frames)
+              << std::endl;
+    const auto print_row = [](const char* name, const Core::PerfPercentiles& percentiles) {
+        std::cout << fmt::format("{:<20} | {:.3f} | {:.3f} | {:.3f}", name,
+                                 percentiles.p50 * 1000.0, percentiles.p95 * 1000.0,
+                                 percentiles.p99 * 1000.0)
+                  << std::endl;
+    };
+    print_row("frametime", breakdown.frametime);
+    for (std::size_t i = 0; i < Core::NumPerfCategories; ++i) {
+        print_row(Core::GetPerfCategoryName(static_cast<Core::PerfCategory>(i)),
+                  breakdown.categories[i]);
+    }
+}
@@ -0,0 +1,54 @@
+// Copyright 2019 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "video_core/gpu_statistics.h"
+
+namespace Core {
+struct FrameBreakdown;
+}
+
+/// Measures the frames of a title run as a benchmark, which ends once enough frames were emulated.
+class Benchmark {
+public:
+    explicit Benchmark(u64 num_frames);
+    ~Benchmark();
+
+    /// Writes a row with the time and the GPU counters of each frame to a CSV file.
+    bool OpenOutput(const std::string& path);
+
+    /// Called from the GPU statistics whenever a frame ends.
+    void OnFrame(const VideoCore::GPUStatistics::Frame& frame);
+
+    /// Whether all frames of the benchmark were emulated.
+    bool IsFinished() const;
+
+    /// Prints the frame time percentiles, the mean of each counter per frame and the breakdown of
+    /// the most recent frames.
+    void PrintSummary(const Core::FrameBreakdown& breakdown) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const u64 num_frames;
+    std::atomic_bool finished{false};
+
+    mutable std::mutex mutex;
+    FileUtil::IOFile output;
+    Clock::time_point start_time;
+    Clock::time_point last_frame_time;
+    /// Walltime of each frame, in seconds
+    std::vector<double> frame_times;
+    std::array<u64, VideoCore::NumGPUCounters> counter_totals{};
+};
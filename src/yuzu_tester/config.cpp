@@ -57,6 +57,7 @@ void Config::ReadValues() {
     }
 
     Settings::values.mouse_enabled = false;
+    Settings::values.sample_input_on_vsync = false;
     for (int i = 0; i < Settings::NativeMouseButton::NumMouseButtons; ++i) {
         Settings::values.mouse_buttons[i] = "";
     }
@@ -114,6 +115,10 @@ void Config::ReadValues() {
 
     // Core
     Settings::values.use_multi_core = sdl2_config->GetBoolean("Core", "use_multi_core", false);
+    Settings::values.use_host_timing = sdl2_config->GetBoolean("Core", "use_host_timing", false);
+    Settings::values.thread_placement = sdl2_config->Get("Core", "thread_placement", "");
+    Settings::values.cpu_accuracy =
+        static_cast<Settings::CpuAccuracy>(sdl2_config->GetInteger("Core", "cpu_accuracy", 0));
 
     // Renderer
     Settings::values.resolution_factor =
@@ -122,10 +127,23 @@ void Config::ReadValues() {
     Settings::values.frame_limit = 100;
     Settings::values.use_disk_shader_cache =
         sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", false);
+    Settings::values.use_disk_texture_cache =
+        sdl2_config->GetBoolean("Renderer", "use_disk_texture_cache", false);
     Settings::values.use_accurate_gpu_emulation =
         sdl2_config->GetBoolean("Renderer", "use_accurate_gpu_emulation", false);
+    Settings::values.use_host_page_protection =
+        sdl2_config->GetBoolean("Renderer", "use_host_page_protection", false);
     Settings::values.use_asynchronous_gpu_emulation =
         sdl2_config->GetBoolean("Renderer", "use_asynchronous_gpu_emulation", false);
+    Settings::values.use_asynchronous_shaders =
+        sdl2_config->GetBoolean("Renderer", "use_asynchronous_shaders", false);
+    Settings::values.use_shader_warmup =
+        sdl2_config->GetBoolean("Renderer", "use_shader_warmup", false);
+    Settings::values.use_mailbox_presentation =
+        sdl2_config->GetBoolean("Renderer", "use_mailbox_presentation", false);
+    Settings::values.use_host_vsync = sdl2_config->GetBoolean("Renderer", "use_host_vsync", false);
+    Settings::values.texture_memory_budget =
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "texture_memory_budget", 0));
 
     Settings::values.bg_red = static_cast<float>(sdl2_config->GetReal("Renderer", "bg_red", 0.0));
     Settings::values.bg_green =
@@ -149,6 +167,12 @@ void Config::ReadValues() {
     Settings::values.program_args = "";
     Settings::values.dump_exefs = sdl2_config->GetBoolean("Debugging", "dump_exefs", false);
     Settings::values.dump_nso = sdl2_config->GetBoolean("Debugging", "dump_nso", false);
+    Settings::values.disable_macro_jit =
+        sdl2_config->GetBoolean("Debugging", "disable_macro_jit", false);
+    Settings::values.validate_macro_jit =
+        sdl2_config->GetBoolean("Debugging", "validate_macro_jit", false);
+    Settings::values.disable_macro_hle =
+        sdl2_config->GetBoolean("Debugging", "disable_macro_hle", false);
 
     const auto title_list = sdl2_config->Get("AddOns", "title_ids", "");
     std::stringstream ss(title_list);
@@ -12,6 +12,22 @@ const char* sdl2_config_file = R"(
 # 0 (default): Disabled, 1: Enabled
 use_multi_core=
 
+# Whether guest time follows the host clock instead of the emulated CPU cycles
+# 0 (default): Disabled, 1: Enabled
+use_host_timing=
+
+# Placement of the host threads of each role (cpu, gpu, audio, logging, worker) on the host cores,
+# as comma separated role:placement pairs. dedicated: a physical core of its own, whose SMT
+# siblings are left idle, shared: the cores that are not dedicated, os: left to the OS scheduler.
+# The priority of a role is set with role_priority:low|normal|high|veryhigh.
+# e.g. cpu:dedicated,gpu:dedicated,audio:shared,gpu_priority:high
+# (default): cpu and gpu dedicated when the host has enough cores, everything else shared
+thread_placement=
+
+# Trade-off between the accuracy of the emulated CPU and the speed of its JIT
+# 0 (default): Accurate, 1: Unsafe
+cpu_accuracy=
+
 [Renderer]
 # Whether to use software or hardware rendering.
 # 0: Software, 1 (default): Hardware
@@ -34,14 +50,45 @@ use_vsync =
 # 0 (default): Off, 1 : On
 use_disk_shader_cache =
 
+# Whether to store decoded ASTC textures on disk to skip decoding them on later loads
+# 0 (default): Off, 1 : On
+use_disk_texture_cache =
+
 # Whether to use accurate GPU emulation
 # 0 (default): Off (fast), 1 : On (slow)
 use_accurate_gpu_emulation =
 
+# Whether to detect CPU writes to GPU cached memory by write protecting its host pages
+# 0 (default): Off, 1 : On (experimental)
+use_host_page_protection =
+
 # Whether to use asynchronous GPU emulation
 # 0 : Off (slow), 1 (default): On (fast)
 use_asynchronous_gpu_emulation =
 
+# Whether to build shaders in the background, skipping draws until their shaders are ready
+# 0 (default): Off, 1 : On
+use_asynchronous_shaders =
+
+# Whether to draw with every program loaded from the shader cache before the game starts, so the
+# driver finishes building them instead of stuttering on their first use
+# 0 (default): Off, 1 : On
+use_shader_warmup =
+
+# Whether to skip presenting frames that a newer queued frame replaces, and to limit the frames
+# waiting on the host GPU. Requires asynchronous GPU emulation.
+# 0 (default): Off, 1 : On
+use_mailbox_presentation =
+
+# Whether the vsync of the guest waits for the host to present the last frame, instead of
+# following emulated time alone. Smoother on variable refresh rate displays.
+# 0 (default): Off, 1 : On
+use_host_vsync =
+
+# Memory in MiB the texture cache may use before evicting the textures that haven't been used
+# recently. 0 (default): Unlimited
+texture_memory_budget =
+
 # The clear color for the renderer. What shows up on the sides of the bottom screen.
 # Must be in range of 0.0-1.0. Defaults to 1.0 for all.
 bg_red =
@@ -124,6 +171,14 @@ program_args=
 dump_exefs=false
 # Determines whether or not yuzu will dump all NSOs it attempts to load while loading them
 dump_nso=false
+# Determines whether or not GPU macros are executed by the interpreter instead of the JIT
+# false (default): Use the JIT if the host supports it, true: Always use the interpreter
+disable_macro_jit =
+# Runs every JIT compiled macro through the interpreter too and logs when the results differ
+validate_macro_jit =
+# Determines whether or not known GPU macros are replaced with native implementations
+# false (default): Replace known macros, true: Always execute the macro code
+disable_macro_hle =
 
 [WebService]
 # Whether or not to enable telemetry
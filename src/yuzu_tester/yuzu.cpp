@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -26,9 +28,12 @@
 #include "core/file_sys/vfs_real.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/loader/loader.h"
+#include "core/perf_stats.h"
 #include "core/settings.h"
 #include "core/telemetry_session.h"
+#include "video_core/gpu.h"
 #include "video_core/renderer_base.h"
+#include "yuzu_tester/benchmark.h"
 #include "yuzu_tester/config.h"
 #include "yuzu_tester/emu_window/emu_window_sdl2_hide.h"
 #include "yuzu_tester/service/yuzutest.h"
@@ -55,6 +60,9 @@ __declspec(dllexport) int AmdPowerXpressRequestHighPerformance = 1;
 }
 #endif
 
+/// Clock of the guest during benchmarks, in seconds since epoch
+constexpr s64 BENCHMARK_RTC = 1577836800;
+
 static void PrintHelp(const char* argv0) {
     std::cout << "Usage: " << argv0
               << " [options] <filename>\n"
@@ -62,7 +70,12 @@ static void PrintHelp(const char* argv0) {
                  "-v, --version         Output version information and exit\n"
                  "-d, --datastring      Pass following string as data to test service command #2\n"
                  "-l, --log             Log to console in addition to file (will log to file only "
-                 "by default)\n";
+                 "by default)\n"
+                 "-b, --benchmark=FRAMES Run the application for FRAMES frames with a fixed RNG "
+                 "seed and clock, then print the frame times and GPU counters\n"
+                 "-i, --replay-input=FILE Replay the controller input recorded by yuzu-cmd\n"
+                 "-o, --output=FILE     Write the time and GPU counters of each benchmark frame "
+                 "to FILE as CSV\n";
 }
 
 static void PrintVersion() {
@@ -109,14 +122,19 @@ int main(int argc, char** argv) {
         {"version", no_argument, 0, 'v'},
         {"datastring", optional_argument, 0, 'd'},
         {"log", no_argument, 0, 'l'},
+        {"benchmark", required_argument, 0, 'b'},
+        {"replay-input", required_argument, 0, 'i'},
+        {"output", required_argument, 0, 'o'},
         {0, 0, 0, 0},
     };
 
     bool console_log = false;
     std::string datastring;
+    u64 benchmark_frames = 0;
+    std::string benchmark_output;
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "hvdl::", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "hvdl::b:i:o:", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'h':
@@ -132,6 +150,19 @@ int main(int argc, char** argv) {
             case 'l':
                 console_log = true;
                 break;
+            case 'b':
+                benchmark_frames = std::strtoull(optarg, nullptr, 0);
+                if (benchmark_frames == 0) {
+                    std::cout << "--benchmark needs a number of frames" << std::endl;
+                    return -1;
+                }
+                break;
+            case 'i':
+                Settings::values.input_replay_path = optarg;
+                break;
+            case 'o':
+                benchmark_output = optarg;
+                break;
             }
         } else {
 #ifdef _WIN32
@@ -160,6 +191,16 @@ int main(int argc, char** argv) {
     }
 
     Settings::values.use_gdbstub = false;
+    if (benchmark_frames != 0) {
+        // Runs have to be repeatable to be compared, the guest gets the same random numbers and
+        // clock every time, and asynchronous shaders would skip a varying number of draws
+        Settings::values.rng_seed = Settings::values.rng_seed.value_or(0);
+        Settings::values.custom_rtc =
+            Settings::values.custom_rtc.value_or(std::chrono::seconds(BENCHMARK_RTC));
+        Settings::values.use_host_timing = false;
+        Settings::values.use_asynchronous_shaders = false;
+        Settings::values.use_frame_limit = false;
+    }
     Settings::Apply();
 
     std::unique_ptr<EmuWindow_SDL2_Hide> emu_window{std::make_unique<EmuWindow_SDL2_Hide>()};
@@ -259,8 +300,26 @@ int main(int argc, char** argv) {
 
     system.Renderer().Rasterizer().LoadDiskResources();
 
-    while (!finished) {
-        system.RunLoop();
+    if (benchmark_frames == 0) {
+        while (!finished) {
+            system.RunLoop();
+        }
+    } else {
+        Benchmark benchmark(benchmark_frames);
+        if (!benchmark_output.empty() && !benchmark.OpenOutput(benchmark_output)) {
+            LOG_ERROR(Frontend, "Failed to open benchmark output {}", benchmark_output);
+        }
+
+        auto& statistics = system.GPU().Statistics();
+        statistics.SetFrameCallback([&benchmark](const VideoCore::GPUStatistics::Frame& frame) {
+            benchmark.OnFrame(frame);
+        });
+        while (!finished && !benchmark.IsFinished()) {
+            system.RunLoop();
+        }
+        statistics.SetFrameCallback({});
+
+        benchmark.PrintSummary(system.GetPerfStats().GetFrameBreakdown());
     }
 
     detached_tasks.WaitForAllTasks();